@@ -9,16 +9,17 @@
 #include <gflags/gflags.h>
 
 #include <utils/default_flags.hpp>
+#include <utils_gapi/kernel_package.hpp>
+#include <utils_gapi/streaming.hpp>
 
 DEFINE_INPUT_FLAGS
 DEFINE_OUTPUT_FLAGS
+DEFINE_STREAMING_FLAGS
 
 static const char help_message[] = "Print a usage message.";
 static const char camera_resolution_message[] = "Optional. Set camera resolution in format WxH.";
 static const char at_message[] = "Required. Architecture type: maskrcnn, background-matting.";
 static const char model_message[] = "Required. Path to an .xml file with a trained model.";
-static const char kernel_package_message[] =
-    "Optional. G-API kernel package type: opencv, fluid (by default opencv is used).";
 static const char device_message[] =
     "Optional. Target device for network (the list of available devices is shown below). "
     "The demo will look for a suitable plugin for a specified device. Default value is \"CPU\".";
@@ -32,6 +33,10 @@ static const char no_show_message[] = "Optional. Don't show output.";
 static const char blur_bgr_message[] = "Optional. Blur background.";
 static const char target_bgr_message[] =
     "Optional. Background onto which to composite the output (by default to green field).";
+static const char net_res_mask_message[] =
+    "Optional. Compute the mask at the resolution of the network desynchronized from the frames: the mask is smoothed "
+    "in time, kept for the frames the network skips while it is busy and upsampled by the guided filter at the blending "
+    "with the background. -latest has no effect in this mode.";
 static const char utilization_monitors_message[] = "Optional. List of monitors to show initially.";
 
 DEFINE_bool(h, false, help_message);
@@ -46,6 +51,7 @@ DEFINE_string(nstreams, "", num_streams_message);
 DEFINE_bool(no_show, false, no_show_message);
 DEFINE_string(target_bgr, "", target_bgr_message);
 DEFINE_uint32(blur_bgr, 0, blur_bgr_message);
+DEFINE_bool(net_res_mask, false, net_res_mask_message);
 DEFINE_string(u, "", utilization_monitors_message);
 
 /**
@@ -70,8 +76,11 @@ static void showUsage() {
     std::cout << "    -nireq \"<integer>\"         " << nireq_message << std::endl;
     std::cout << "    -nthreads \"<integer>\"      " << num_threads_message << std::endl;
     std::cout << "    -nstreams                  " << num_streams_message << std::endl;
+    std::cout << "    -qc \"<integer>\"            " << queue_capacity_message << std::endl;
+    std::cout << "    -latest                    " << latest_result_message << std::endl;
     std::cout << "    -no_show                   " << no_show_message << std::endl;
     std::cout << "    -blur_bgr \"<integer>\"      " << blur_bgr_message << std::endl;
     std::cout << "    -target_bgr                " << target_bgr_message << std::endl;
+    std::cout << "    -net_res_mask              " << net_res_mask_message << std::endl;
     std::cout << "    -u                         " << utilization_monitors_message << std::endl;
 }
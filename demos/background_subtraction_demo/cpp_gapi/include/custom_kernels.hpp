@@ -37,6 +37,21 @@ G_API_OP(GCalculateMaskRCNNBGMask,
         return cv::GMatDesc{CV_8U, 1, in_sz};
     }
 };
+
+/** Per-pixel ops, which have Fluid implementations to run in rows together with the neighbouring ops **/
+G_API_OP(GAlphaBlend, <cv::GMat(cv::GMat, cv::GMat, cv::GMat)>, "custom.alphaBlend") {
+    // NB: Blends 8UC3 foreground and background by 32FC1 alpha of the foreground.
+    static cv::GMatDesc outMeta(const cv::GMatDesc& fg, const cv::GMatDesc&, const cv::GMatDesc&) {
+        return fg;
+    }
+};
+
+G_API_OP(GSelectByMask, <cv::GMat(cv::GMat, cv::GMat, cv::GMat)>, "custom.selectByMask") {
+    // NB: Takes the bits of 8UC3 foreground set in 8UC1 mask and the rest from background.
+    static cv::GMatDesc outMeta(const cv::GMatDesc& fg, const cv::GMatDesc&, const cv::GMatDesc&) {
+        return fg;
+    }
+};
 // clang-format on
 class NNBGReplacer {
 public:
@@ -44,6 +59,8 @@ public:
     virtual ~NNBGReplacer() = default;
     NNBGReplacer(const std::string& model_path);
     virtual cv::GMat replace(cv::GMat, const cv::Size&, cv::GMat) = 0;
+    /// Alpha of the foreground at the resolution of the network, 32FC1 in [0, 1]
+    virtual cv::GMat alpha(cv::GMat) = 0;
     const std::string& getName() {
         return m_tag;
     }
@@ -59,8 +76,11 @@ class MaskRCNNBGReplacer : public NNBGReplacer {
 public:
     MaskRCNNBGReplacer(const std::string& model_path);
     cv::GMat replace(cv::GMat, const cv::Size&, cv::GMat) override;
+    cv::GMat alpha(cv::GMat) override;
 
 private:
+    cv::GMat mask(cv::GMat, const cv::Size&);
+
     std::string m_input_name;
     std::string m_labels_name;
     std::string m_boxes_name;
@@ -71,12 +91,35 @@ class BGMattingReplacer : public NNBGReplacer {
 public:
     BGMattingReplacer(const std::string& model_path);
     cv::GMat replace(cv::GMat, const cv::Size&, cv::GMat) override;
+    cv::GMat alpha(cv::GMat) override;
 
 private:
     std::string m_input_name;
     std::string m_output_name;
 };
 
+/// Blends the frames by the alpha of the foreground computed at the resolution of the network. The alpha is smoothed
+/// in time and kept for the frames the network skips. It is upsampled to the frame by the guided filter, which takes
+/// the edges of the frame, in the same pass with the blending.
+class GuidedMaskBlender {
+public:
+    GuidedMaskBlender(int radius = 2, float eps = 1e-3f, float smoothing = 0.5f);
+    /// Takes the new alpha from the network, the previous one contributes by the smoothing factor
+    void update(const cv::Mat& alpha);
+    /// Keeps the frame as is until the first alpha comes
+    void blend(const cv::Mat& frame, const cv::Mat& background, cv::Mat& out);
+
+private:
+    int m_radius;
+    float m_eps;
+    float m_smoothing;
+    cv::Mat m_alpha;
+    cv::Mat m_small, m_gray, m_guide;
+    cv::Mat m_coef_a, m_coef_b;
+};
+
 cv::gapi::GKernelPackage kernels();
+/// Fluid kernels for the per-pixel ops, to be combined after kernels()
+cv::gapi::GKernelPackage fluidKernels();
 
 }  // namespace custom
@@ -18,10 +18,6 @@
 #include <gflags/gflags.h>
 #include <opencv2/core.hpp>
 #include <opencv2/gapi/core.hpp>
-#include <opencv2/gapi/cpu/core.hpp>
-#include <opencv2/gapi/cpu/imgproc.hpp>
-#include <opencv2/gapi/fluid/core.hpp>
-#include <opencv2/gapi/fluid/imgproc.hpp>
 #include <opencv2/gapi/garg.hpp>
 #include <opencv2/gapi/gcommon.hpp>
 #include <opencv2/gapi/gcomputation.hpp>
@@ -32,7 +28,7 @@
 #include <opencv2/gapi/imgproc.hpp>
 #include <opencv2/gapi/infer.hpp>
 #include <opencv2/gapi/infer/ie.hpp>
-#include <opencv2/gapi/own/assert.hpp>
+#include <opencv2/gapi/streaming/desync.hpp>
 #include <opencv2/gapi/streaming/source.hpp>
 #include <opencv2/gapi/util/optional.hpp>
 #include <opencv2/highgui.hpp>
@@ -47,7 +43,9 @@
 #include <utils/ocv_common.hpp>
 #include <utils/performance_metrics.hpp>
 #include <utils/slog.hpp>
+#include <utils_gapi/kernel_package.hpp>
 #include <utils_gapi/stream_source.hpp>
+#include <utils_gapi/streaming.hpp>
 
 #include "background_subtraction_demo_gapi.hpp"
 #include "custom_kernels.hpp"
@@ -72,14 +70,12 @@ bool ParseAndCheckCommandLine(int argc, char* argv[]) {
 }
 
 static cv::gapi::GKernelPackage getKernelPackage(const std::string& type) {
-    if (type == "opencv") {
-        return cv::gapi::combine(cv::gapi::core::cpu::kernels(), cv::gapi::imgproc::cpu::kernels());
-    } else if (type == "fluid") {
-        return cv::gapi::combine(cv::gapi::core::fluid::kernels(), cv::gapi::imgproc::fluid::kernels());
-    } else {
-        throw std::logic_error("Unsupported kernel package type: " + type);
+    /** The custom composition kernels have a Fluid version to stay in the Fluid island with the standard ones **/
+    auto kernels = custom::getKernelPackage(type);
+    if (type == "fluid") {
+        kernels = cv::gapi::combine(kernels, custom::fluidKernels());
     }
-    GAPI_Assert(false && "Unreachable code!");
+    return kernels;
 }
 
 }  // namespace util
@@ -137,37 +133,67 @@ int main(int argc, char* argv[]) {
             auto background =
                 is_blur ? cv::gapi::blur(bgr_resized, cv::Size(FLAGS_blur_bgr, FLAGS_blur_bgr)) : bgr_resized;
 
-            auto result = model->replace(in, frame_size, background);
-
             auto graph_inputs = cv::GIn(in);
             if (target_bgr.has_value()) {
                 graph_inputs += cv::GIn(target_bgr.value());
             }
 
+            if (FLAGS_net_res_mask) {
+                /** The network takes the latest frame when it is free, the frames are blended outside the graph **/
+                auto alpha = model->alpha(cv::gapi::streaming::desync(in));
+                return cv::GComputation(std::move(graph_inputs), cv::GOut(cv::gapi::copy(in), background, alpha));
+            }
+            auto result = model->replace(in, frame_size, background);
             return cv::GComputation(std::move(graph_inputs), cv::GOut(result));
         });
 
         /** Configure network **/
         auto config = ConfigFactory::getUserConfig(FLAGS_d, FLAGS_nireq, FLAGS_nstreams, FLAGS_nthreads);
         // clang-format off
-        const auto net =
+        auto net =
             cv::gapi::ie::Params<cv::gapi::Generic>{
                 model->getName(),
                 FLAGS_m,  // path to topology IR
                 fileNameNoExt(FLAGS_m) + ".bin",  // path to weights
                 FLAGS_d  // device specifier
-            }.cfgNumRequests(config.maxAsyncRequests)
-             .pluginConfig(config.getLegacyConfig());
+            };
         // clang-format on
+        custom::applyModelConfig(net, config);
 
         slog::info << "The background matting model " << FLAGS_m << " is loaded to " << FLAGS_d << " device."
                    << slog::endl;
 
         auto kernels = cv::gapi::combine(custom::kernels(), util::getKernelPackage(FLAGS_kernel_package));
-        auto pipeline = comp.compileStreaming(cv::compile_args(kernels, cv::gapi::networks(net)));
+        auto compile_args = cv::compile_args(kernels, cv::gapi::networks(net));
+        custom::addQueueCapacity(compile_args, FLAGS_qc);
+        auto pipeline = comp.compileStreaming(std::move(compile_args));
 
         /** Output container for result **/
         cv::Mat output;
+        /** With -net_res_mask the frame and the background come with every result, the alpha comes apart **/
+        custom::GuidedMaskBlender blender;
+        cv::util::optional<cv::Mat> opt_frame, opt_background, opt_alpha;
+        /** Returns false when the stream is over, newFrame tells if the frame is pulled **/
+        auto pullResult = [&](bool& newFrame) {
+            newFrame = true;
+            if (!FLAGS_net_res_mask) {
+                return custom::pull(pipeline, cv::gout(output), FLAGS_latest);
+            }
+            if (!pipeline.pull(cv::gout(opt_frame, opt_background, opt_alpha))) {
+                return false;
+            }
+            if (opt_alpha.has_value()) {
+                blender.update(opt_alpha.value());
+                opt_alpha.reset();
+            }
+            newFrame = opt_frame.has_value() && opt_background.has_value();
+            if (newFrame) {
+                blender.blend(opt_frame.value(), opt_background.value(), output);
+                opt_frame.reset();
+                opt_background.reset();
+            }
+            return true;
+        };
 
         /** ---------------- The execution part ---------------- **/
         cap = openImagesCapture(FLAGS_i,
@@ -176,14 +202,15 @@ int main(int argc, char* argv[]) {
                                 0,
                                 std::numeric_limits<size_t>::max(),
                                 stringToSize(FLAGS_res));
-        auto pipeline_inputs = cv::gin(cv::gapi::wip::make_src<custom::CommonCapSrc>(cap));
+        LazyVideoWriter videoWriter{FLAGS_o, cap->fps(), FLAGS_limit};
+        auto pipeline_inputs = cv::gin(cv::gapi::wip::make_src<custom::PrefetchingCapSrc>(cap));
         if (!is_blur && FLAGS_target_bgr.empty()) {
             cv::Scalar default_color(155, 255, 120);
             pipeline_inputs += cv::gin(cv::Mat(frame_size, CV_8UC3, default_color));
         } else if (!FLAGS_target_bgr.empty()) {
             std::shared_ptr<ImagesCapture> target_bgr_cap =
                 openImagesCapture(FLAGS_target_bgr, true, read_type::safe, 0, std::numeric_limits<size_t>::max());
-            pipeline_inputs += cv::gin(cv::gapi::wip::make_src<custom::CommonCapSrc>(target_bgr_cap));
+            pipeline_inputs += cv::gin(cv::gapi::wip::make_src<custom::PrefetchingCapSrc>(target_bgr_cap));
         }
 
         pipeline.setSource(std::move(pipeline_inputs));
@@ -193,13 +220,15 @@ int main(int argc, char* argv[]) {
         cv::Size graphSize{static_cast<int>(frame_size.width / 4), 60};
         Presenter presenter(FLAGS_u, frame_size.height - graphSize.height - 10, graphSize);
 
-        LazyVideoWriter videoWriter{FLAGS_o, cap->fps(), FLAGS_limit};
-
         bool isStart = true;
         const auto startTime = std::chrono::steady_clock::now();
         pipeline.start();
 
-        while (pipeline.pull(cv::gout(output))) {
+        bool newFrame = false;
+        while (pullResult(newFrame)) {
+            if (!newFrame) {
+                continue;
+            }
             presenter.drawGraphs(output);
             if (isStart) {
                 metrics.update(startTime,
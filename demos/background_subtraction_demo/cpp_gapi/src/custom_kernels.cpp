@@ -9,16 +9,17 @@
 #include <memory>
 #include <stdexcept>
 #include <utility>
+#include <vector>
 
 #include <ie_core.hpp>
 #include <ie_data.h>
 #include <ie_layouts.h>
 #include <opencv2/gapi/core.hpp>
 #include <opencv2/gapi/cpu/gcpukernel.hpp>
-#include <opencv2/gapi/gscalar.hpp>
+#include <opencv2/gapi/fluid/gfluidbuffer.hpp>
+#include <opencv2/gapi/fluid/gfluidkernel.hpp>
 #include <opencv2/gapi/imgproc.hpp>
 #include <opencv2/gapi/infer.hpp>
-#include <opencv2/gapi/operators.hpp>
 #include <opencv2/gapi/own/assert.hpp>
 #include <opencv2/imgproc.hpp>
 
@@ -33,6 +34,120 @@ GAPI_OCV_KERNEL(OCVTensorToImg, custom::GTensorToImg) {
 };
 // clang-format on
 
+namespace {
+void alphaBlendRow(const uchar* fg, const uchar* bg, const float* alpha, uchar* out, int width) {
+    for (int x = 0; x < width; ++x) {
+        const float a = alpha[x];
+        for (int c = 0; c < 3; ++c) {
+            out[3 * x + c] = cv::saturate_cast<uchar>(a * fg[3 * x + c] + (1.f - a) * bg[3 * x + c]);
+        }
+    }
+}
+
+void selectByMaskRow(const uchar* fg, const uchar* bg, const uchar* mask, uchar* out, int width) {
+    for (int x = 0; x < width; ++x) {
+        const uchar m = mask[x];
+        for (int c = 0; c < 3; ++c) {
+            out[3 * x + c] = static_cast<uchar>((m & fg[3 * x + c]) | (~m & bg[3 * x + c]));
+        }
+    }
+}
+
+/** Samples of the bilinear upsampling of the guided filter coefficients along one axis **/
+struct LerpTaps {
+    std::vector<int> i0, i1;
+    std::vector<float> w;
+
+    LerpTaps(int src_len, int dst_len) : i0(dst_len), i1(dst_len), w(dst_len) {
+        const float scale = static_cast<float>(src_len) / dst_len;
+        for (int i = 0; i < dst_len; ++i) {
+            const float src = std::max(0.f, (i + 0.5f) * scale - 0.5f);
+            i0[i] = std::min(static_cast<int>(src), src_len - 1);
+            i1[i] = std::min(i0[i] + 1, src_len - 1);
+            w[i] = src - i0[i];
+        }
+    }
+};
+
+/** Upsamples the coefficients of the guided filter and blends the frame by the filtered alpha row by row, so the
+ *  full resolution alpha is never stored **/
+void guidedBlend(const cv::Mat& fg, const cv::Mat& bg, const cv::Mat& coef_a, const cv::Mat& coef_b, cv::Mat& out) {
+    const LerpTaps xs(coef_a.cols, fg.cols);
+    const LerpTaps ys(coef_a.rows, fg.rows);
+    std::vector<float> alpha(fg.cols);
+    for (int y = 0; y < fg.rows; ++y) {
+        const float wy = ys.w[y];
+        const float* a0 = coef_a.ptr<float>(ys.i0[y]);
+        const float* a1 = coef_a.ptr<float>(ys.i1[y]);
+        const float* b0 = coef_b.ptr<float>(ys.i0[y]);
+        const float* b1 = coef_b.ptr<float>(ys.i1[y]);
+        const uchar* fg_row = fg.ptr<uchar>(y);
+        for (int x = 0; x < fg.cols; ++x) {
+            const int x0 = xs.i0[x], x1 = xs.i1[x];
+            const float wx = xs.w[x];
+            const float a = (1.f - wy) * ((1.f - wx) * a0[x0] + wx * a0[x1]) + wy * ((1.f - wx) * a1[x0] + wx * a1[x1]);
+            const float b = (1.f - wy) * ((1.f - wx) * b0[x0] + wx * b0[x1]) + wy * ((1.f - wx) * b1[x0] + wx * b1[x1]);
+            const uchar* px = fg_row + 3 * x;
+            const float guide = (0.114f * px[0] + 0.587f * px[1] + 0.299f * px[2]) / 255.f;
+            alpha[x] = std::min(1.f, std::max(0.f, a * guide + b));
+        }
+        alphaBlendRow(fg_row, bg.ptr<uchar>(y), alpha.data(), out.ptr<uchar>(y), fg.cols);
+    }
+}
+}  // namespace
+
+// clang-format off
+GAPI_OCV_KERNEL(OCVAlphaBlend, custom::GAlphaBlend) {
+    static void run(const cv::Mat &fg,
+                    const cv::Mat &bg,
+                    const cv::Mat &alpha,
+                    cv::Mat &out) {
+        GAPI_Assert(fg.type() == CV_8UC3 && bg.type() == CV_8UC3 && alpha.type() == CV_32FC1);
+        for (int y = 0; y < fg.rows; ++y) {
+            alphaBlendRow(fg.ptr<uchar>(y), bg.ptr<uchar>(y), alpha.ptr<float>(y), out.ptr<uchar>(y), fg.cols);
+        }
+    }
+};
+
+GAPI_OCV_KERNEL(OCVSelectByMask, custom::GSelectByMask) {
+    static void run(const cv::Mat &fg,
+                    const cv::Mat &bg,
+                    const cv::Mat &mask,
+                    cv::Mat &out) {
+        GAPI_Assert(fg.type() == CV_8UC3 && bg.type() == CV_8UC3 && mask.type() == CV_8UC1);
+        for (int y = 0; y < fg.rows; ++y) {
+            selectByMaskRow(fg.ptr<uchar>(y), bg.ptr<uchar>(y), mask.ptr<uchar>(y), out.ptr<uchar>(y), fg.cols);
+        }
+    }
+};
+
+GAPI_FLUID_KERNEL(FAlphaBlend, custom::GAlphaBlend, false) {
+    static const int Window = 1;
+
+    static void run(const cv::gapi::fluid::View &fg,
+                    const cv::gapi::fluid::View &bg,
+                    const cv::gapi::fluid::View &alpha,
+                    cv::gapi::fluid::Buffer &out) {
+        GAPI_Assert(fg.meta().chan == 3 && alpha.meta().depth == CV_32F);
+        alphaBlendRow(fg.InLine<uchar>(0), bg.InLine<uchar>(0), alpha.InLine<float>(0),
+                      out.OutLine<uchar>(), out.length());
+    }
+};
+
+GAPI_FLUID_KERNEL(FSelectByMask, custom::GSelectByMask, false) {
+    static const int Window = 1;
+
+    static void run(const cv::gapi::fluid::View &fg,
+                    const cv::gapi::fluid::View &bg,
+                    const cv::gapi::fluid::View &mask,
+                    cv::gapi::fluid::Buffer &out) {
+        GAPI_Assert(fg.meta().chan == 3 && mask.meta().chan == 1);
+        selectByMaskRow(fg.InLine<uchar>(0), bg.InLine<uchar>(0), mask.InLine<uchar>(0),
+                        out.OutLine<uchar>(), out.length());
+    }
+};
+// clang-format on
+
 static cv::Rect expandBox(const float x0, const float y0, const float x1, const float y1, const float scale) {
     const float w_half = ((x1 - x0) * 0.5f) * scale;
     const float h_half = ((y1 - y0) * 0.5f) * scale;
@@ -169,7 +284,7 @@ custom::MaskRCNNBGReplacer::MaskRCNNBGReplacer(const std::string& model_path) :
     }
 }
 
-cv::GMat custom::MaskRCNNBGReplacer::replace(cv::GMat in, const cv::Size& in_size, cv::GMat background) {
+cv::GMat custom::MaskRCNNBGReplacer::mask(cv::GMat in, const cv::Size& mask_size) {
     cv::GInferInputs inputs;
     inputs[m_input_name] = in;
     auto outputs = cv::gapi::infer<cv::gapi::Generic>(m_tag, inputs);
@@ -179,9 +294,21 @@ cv::GMat custom::MaskRCNNBGReplacer::replace(cv::GMat in, const cv::Size& in_siz
 
     const auto& dims = m_inputs.at(m_input_name)->getTensorDesc().getDims();
     GAPI_Assert(dims.size() == 4u);
-    auto mask = custom::GCalculateMaskRCNNBGMask::on(in_size, cv::Size(dims[3], dims[2]), labels, boxes, masks);
-    auto mask3ch = cv::gapi::medianBlur(cv::gapi::merge3(mask, mask, mask), 11);
-    return (mask3ch & in) + (~mask3ch & background);
+    const cv::Size model_in_size(static_cast<int>(dims[3]), static_cast<int>(dims[2]));
+    return custom::GCalculateMaskRCNNBGMask::on(mask_size.empty() ? model_in_size : mask_size,
+                                                model_in_size,
+                                                labels,
+                                                boxes,
+                                                masks);
+}
+
+cv::GMat custom::MaskRCNNBGReplacer::replace(cv::GMat in, const cv::Size& in_size, cv::GMat background) {
+    // NB: The channels of the merged mask were blurred the same, so the single channel one is blurred instead.
+    return custom::GSelectByMask::on(in, background, cv::gapi::medianBlur(mask(in, in_size), 11));
+}
+
+cv::GMat custom::MaskRCNNBGReplacer::alpha(cv::GMat in) {
+    return cv::gapi::convertTo(mask(in, cv::Size()), CV_32F, 1. / 255);
 }
 
 custom::BGMattingReplacer::BGMattingReplacer(const std::string& model_path) : NNBGReplacer(model_path) {
@@ -202,15 +329,62 @@ cv::GMat custom::BGMattingReplacer::replace(cv::GMat in, const cv::Size& in_size
     auto outputs = cv::gapi::infer<cv::gapi::Generic>(m_tag, inputs);
 
     auto alpha = cv::gapi::resize(custom::GTensorToImg::on(outputs.at(m_output_name)), in_size);
-    auto alpha3ch = cv::gapi::merge3(alpha, alpha, alpha);
-    auto in_fp = cv::gapi::convertTo(in, CV_32F);
-    auto bgr_fp = cv::gapi::convertTo(background, CV_32F);
+    return custom::GAlphaBlend::on(in, background, alpha);
+}
 
-    cv::GScalar one(cv::Scalar::all(1.));
-    auto out = cv::gapi::mul(alpha3ch, in_fp) + cv::gapi::mul((one - alpha3ch), bgr_fp);
-    return cv::gapi::convertTo(out, CV_8U);
+cv::GMat custom::BGMattingReplacer::alpha(cv::GMat in) {
+    cv::GInferInputs inputs;
+    inputs[m_input_name] = in;
+    auto outputs = cv::gapi::infer<cv::gapi::Generic>(m_tag, inputs);
+    return custom::GTensorToImg::on(outputs.at(m_output_name));
+}
+
+custom::GuidedMaskBlender::GuidedMaskBlender(int radius, float eps, float smoothing)
+    : m_radius(radius),
+      m_eps(eps),
+      m_smoothing(smoothing) {}
+
+void custom::GuidedMaskBlender::update(const cv::Mat& alpha) {
+    GAPI_Assert(alpha.type() == CV_32FC1);
+    if (m_alpha.size() != alpha.size()) {
+        alpha.copyTo(m_alpha);
+    } else {
+        cv::addWeighted(alpha, 1. - m_smoothing, m_alpha, m_smoothing, 0., m_alpha);
+    }
+}
+
+void custom::GuidedMaskBlender::blend(const cv::Mat& frame, const cv::Mat& background, cv::Mat& out) {
+    GAPI_Assert(frame.type() == CV_8UC3 && background.type() == CV_8UC3 && frame.size() == background.size());
+    if (m_alpha.empty()) {
+        frame.copyTo(out);
+        return;
+    }
+    /** The coefficients of the guided filter are found over the frame downscaled to the alpha **/
+    cv::resize(frame, m_small, m_alpha.size(), 0, 0, cv::INTER_AREA);
+    cv::cvtColor(m_small, m_gray, cv::COLOR_BGR2GRAY);
+    m_gray.convertTo(m_guide, CV_32F, 1. / 255);
+
+    const cv::Size ksize(2 * m_radius + 1, 2 * m_radius + 1);
+    cv::Mat mean_i, mean_p, corr_ip, corr_ii;
+    cv::boxFilter(m_guide, mean_i, CV_32F, ksize);
+    cv::boxFilter(m_alpha, mean_p, CV_32F, ksize);
+    cv::boxFilter(m_guide.mul(m_alpha), corr_ip, CV_32F, ksize);
+    cv::boxFilter(m_guide.mul(m_guide), corr_ii, CV_32F, ksize);
+
+    const cv::Mat var_i = corr_ii - mean_i.mul(mean_i);
+    const cv::Mat coef_a = (corr_ip - mean_i.mul(mean_p)) / (var_i + m_eps);
+    const cv::Mat coef_b = mean_p - coef_a.mul(mean_i);
+    cv::boxFilter(coef_a, m_coef_a, CV_32F, ksize);
+    cv::boxFilter(coef_b, m_coef_b, CV_32F, ksize);
+
+    out.create(frame.size(), CV_8UC3);
+    guidedBlend(frame, background, m_coef_a, m_coef_b, out);
 }
 
 cv::gapi::GKernelPackage custom::kernels() {
-    return cv::gapi::kernels<OCVTensorToImg, OCVCalculateMaskRCNNBGMask>();
+    return cv::gapi::kernels<OCVTensorToImg, OCVCalculateMaskRCNNBGMask, OCVAlphaBlend, OCVSelectByMask>();
+}
+
+cv::gapi::GKernelPackage custom::fluidKernels() {
+    return cv::gapi::kernels<FAlphaBlend, FSelectByMask>();
 }
@@ -15,6 +15,7 @@
 
 #include <monitors/presenter.h>
 #include <utils/ocv_common.hpp>
+#include <utils/performance_metrics.hpp>
 
 enum class PredictionResult { Correct, Incorrect, Unknown };
 
@@ -22,16 +23,15 @@ class GridMat {
 public:
     cv::Mat outImg;
 
-    explicit GridMat(Presenter& presenter,
-                     const cv::Size maxDisp = cv::Size{1920, 1080},
-                     const cv::Size aspectRatio = cv::Size{16, 9},
-                     double targetFPS = 60)
+    /// @param images - images shown in the cells, they are resized to the cell size once here, so showing a result
+    /// only copies its thumbnail
+    GridMat(Presenter& presenter,
+            const std::vector<cv::Mat>& images,
+            const cv::Size maxDisp = cv::Size{1920, 1080},
+            const cv::Size aspectRatio = cv::Size{16, 9},
+            double targetFPS = 60)
         : currSourceId{0} {
-        cv::Size size(static_cast<int>(std::round(sqrt(1. * targetFPS * aspectRatio.width / aspectRatio.height))),
-                      static_cast<int>(std::round(sqrt(1. * targetFPS * aspectRatio.height / aspectRatio.width))));
-        if (size.width == 0 || size.height == 0) {
-            size = {1, 1};  // set minimum possible grid size
-        }
+        cv::Size size = getGridSize(aspectRatio, targetFPS);
         int minCellSize = std::min(maxDisp.width / size.width, maxDisp.height / size.height);
         cellSize = cv::Size(minCellSize, minCellSize);
 
@@ -49,10 +49,24 @@ public:
         textSize = cv::getTextSize("", fontType, fontScale, thickness, &baseline);
         accuracyMessageSize = cv::getTextSize("Accuracy (top 0): 0.000", fontType, fontScale, thickness, &baseline);
         testMessageSize = cv::getTextSize(GridMat::testMessage, fontType, fontScale, thickness, &baseline);
+
+        thumbnails.resize(images.size());
+        for (size_t i = 0; i < images.size(); i++) {
+            cv::resize(images[i], thumbnails[i], cellSize);
+        }
+    }
+
+    /// @returns numbers of columns and rows of the grid showing about targetFPS images
+    static cv::Size getGridSize(const cv::Size aspectRatio, double targetFPS) {
+        cv::Size size(static_cast<int>(std::round(sqrt(1. * targetFPS * aspectRatio.width / aspectRatio.height))),
+                      static_cast<int>(std::round(sqrt(1. * targetFPS * aspectRatio.height / aspectRatio.width))));
+        if (size.width == 0 || size.height == 0) {
+            size = {1, 1};  // set minimum possible grid size
+        }
+        return size;
     }
 
-    void textUpdate(PerformanceMetrics& metrics,
-                    PerformanceMetrics::TimePoint lastRequestStartTime,
+    void textUpdate(const PerformanceMetrics::Metrics& metrics,
                     double accuracy,
                     unsigned int nTop,
                     bool isFpsTest,
@@ -62,13 +76,13 @@ public:
 
         presenter.drawGraphs(outImg);
 
-        metrics.update(lastRequestStartTime,
-                       outImg,
-                       cv::Point(textPadding, textSize.height + textPadding),
-                       fontType,
-                       fontScale,
-                       cv::Scalar(255, 100, 100),
-                       thickness);
+        PerformanceMetrics::paintMetrics(metrics,
+                                         outImg,
+                                         cv::Point(textPadding, textSize.height + textPadding),
+                                         fontType,
+                                         fontScale,
+                                         cv::Scalar(255, 100, 100),
+                                         thickness);
 
         if (showAccuracy) {
             cv::putText(outImg,
@@ -92,7 +106,9 @@ public:
         }
     }
 
-    void updateMat(const cv::Mat& mat, const std::string& label, PredictionResult predictionResul) {
+    /// Shows the image in the next cell
+    /// @param imageIdx - index of the image passed to the constructor
+    void updateMat(size_t imageIdx, const std::string& label, PredictionResult predictionResul) {
         if (!prevImg.empty()) {
             size_t prevSourceId = currSourceId - 1;
             prevSourceId = std::min(prevSourceId, points.size() - 1);
@@ -115,7 +131,7 @@ public:
         int labelThickness = cellSize.width / 20;
         cv::Size labelTextSize = cv::getTextSize(label, fontType, 1, 2, &baseline);
         double labelFontScale = static_cast<double>(cellSize.width - 2 * labelThickness) / labelTextSize.width;
-        cv::resize(mat, prevImg, cellSize);
+        thumbnails.at(imageIdx).copyTo(prevImg);
         putHighlightedText(prevImg,
                            label,
                            cv::Point(labelThickness, cellSize.height - labelThickness - labelTextSize.height),
@@ -135,6 +151,7 @@ public:
     }
 
 private:
+    std::vector<cv::Mat> thumbnails;
     cv::Mat prevImg;
     cv::Size cellSize;
     size_t currSourceId;
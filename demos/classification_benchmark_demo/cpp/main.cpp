@@ -5,13 +5,18 @@
 #include <stddef.h>
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cmath>
+#include <deque>
 #include <exception>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <limits>
 #include <map>
 #include <memory>
+#include <numeric>
 #include <ratio>
 #include <stdexcept>
 #include <string>
@@ -28,13 +33,20 @@
 #include <models/input_data.h>
 #include <models/model_base.h>
 #include <models/results.h>
+#include <monitors/cpu_monitor.h>
 #include <monitors/presenter.h>
 #include <pipelines/async_pipeline.h>
 #include <pipelines/metadata.h>
+#include <pipelines/results_publisher.h>
 #include <utils/args_helper.hpp>
 #include <utils/common.hpp>
 #include <utils/config_factory.h>
+#include <utils/default_flags.hpp>
+#include <utils/itt.hpp>
+#include <utils/memory_accounting.hpp>
+#include <utils/metrics_sink.hpp>
 #include <utils/performance_metrics.hpp>
+#include <utils/render_thread.hpp>
 #include <utils/slog.hpp>
 
 #include "grid_mat.hpp"
@@ -60,6 +72,18 @@ static const char no_show_message[] = "Optional. Disable showing of processed im
 static const char execution_time_message[] = "Optional. Time in seconds to execute program. "
                                              "Default is -1 (infinite time).";
 static const char utilization_monitors_message[] = "Optional. List of monitors to show initially.";
+static const char sweep_message[] = "Optional. Run headless benchmark over all combinations of -sweep_b, -sweep_nireq "
+                                    "and -sweep_nstreams instead of showing the images and write the table of results "
+                                    "to the file: JSON if the file name ends with .json, CSV otherwise.";
+static const char sweep_b_message[] = "Optional. Comma separated list of batch sizes for -sweep. Default value is 1.";
+static const char sweep_nireq_message[] = "Optional. Comma separated list of numbers of infer requests for -sweep. "
+                                          "0 means optimal number for the device. Default value is 0.";
+static const char sweep_nstreams_message[] = "Optional. Comma separated list of numbers of streams for -sweep. "
+                                             "Empty list means the value of -nstreams.";
+static const char sweep_time_message[] = "Optional. Time in seconds to measure every configuration of -sweep. "
+                                         "Default value is 10.";
+static const char sweep_warmup_message[] = "Optional. Time in seconds to run every configuration of -sweep before "
+                                           "the measurement. Default value is 2.";
 
 DEFINE_bool(h, false, help_message);
 DEFINE_string(i, "", image_message);
@@ -77,6 +101,18 @@ DEFINE_bool(auto_resize, false, input_resizable_message);
 DEFINE_bool(no_show, false, no_show_message);
 DEFINE_uint32(time, std::numeric_limits<gflags::uint32>::max(), execution_time_message);
 DEFINE_string(u, "", utilization_monitors_message);
+DEFINE_string(sweep, "", sweep_message);
+DEFINE_string(sweep_b, "1", sweep_b_message);
+DEFINE_string(sweep_nireq, "0", sweep_nireq_message);
+DEFINE_string(sweep_nstreams, "", sweep_nstreams_message);
+DEFINE_uint32(sweep_time, 10, sweep_time_message);
+DEFINE_uint32(sweep_warmup, 2, sweep_warmup_message);
+DEFINE_METRICS_FLAGS
+DEFINE_TUNING_FLAGS
+DEFINE_WARMUP_FLAGS
+DEFINE_LAYERS_PROFILE_FLAGS
+DEFINE_REMOTE_FLAGS
+DEFINE_RESULTS_FLAGS
 
 static void showUsage() {
     std::cout << std::endl;
@@ -99,6 +135,20 @@ static void showUsage() {
     std::cout << "    -no_show                  " << no_show_message << std::endl;
     std::cout << "    -time \"<integer>\"         " << execution_time_message << std::endl;
     std::cout << "    -u                        " << utilization_monitors_message << std::endl;
+    std::cout << "    -metrics_file \"<path>\"    " << metrics_file_message << std::endl;
+    std::cout << "    -tune \"<objective>\"       " << tune_message << std::endl;
+    std::cout << "    -tune_latency \"<double>\"  " << tune_latency_message << std::endl;
+    std::cout << "    -tune_cache \"<path>\"      " << tune_cache_message << std::endl;
+    std::cout << "    -warmup \"<integer>\"     " << warmup_message << std::endl;
+    std::cout << "    -profile_layers \"<integer>\" " << profile_layers_message << std::endl;
+    std::cout << "    -remote \"<host:port>\"   " << remote_message << std::endl;
+    std::cout << "    -results \"<host:port>\"  " << results_message << std::endl;
+    std::cout << "    -sweep \"<path>\"           " << sweep_message << std::endl;
+    std::cout << "    -sweep_b \"<list>\"         " << sweep_b_message << std::endl;
+    std::cout << "    -sweep_nireq \"<list>\"     " << sweep_nireq_message << std::endl;
+    std::cout << "    -sweep_nstreams \"<list>\"  " << sweep_nstreams_message << std::endl;
+    std::cout << "    -sweep_time \"<integer>\"   " << sweep_time_message << std::endl;
+    std::cout << "    -sweep_warmup \"<integer>\" " << sweep_warmup_message << std::endl;
 }
 
 bool ParseAndCheckCommandLine(int argc, char* argv[]) {
@@ -122,6 +172,10 @@ bool ParseAndCheckCommandLine(int argc, char* argv[]) {
         throw std::logic_error("Parameter -labels is not set");
     }
 
+    if (!FLAGS_sweep.empty() && FLAGS_sweep_time == 0) {
+        throw std::logic_error("Parameter -sweep_time should be positive");
+    }
+
     return true;
 }
 
@@ -132,9 +186,170 @@ cv::Mat centerSquareCrop(const cv::Mat& image) {
     return image(cv::Rect(0, (image.rows - image.cols) / 2, image.cols, image.cols));
 }
 
+/// Keeps index of the preloaded image, so the grid shows its thumbnail
+struct GridImageMetaData : public ClassificationImageMetaData {
+    size_t imageIdx;
+
+    GridImageMetaData(cv::Mat img,
+                      std::chrono::steady_clock::time_point timeStamp,
+                      unsigned int groundTruthId,
+                      size_t imageIdx)
+        : ClassificationImageMetaData(img, timeStamp, groundTruthId),
+          imageIdx(imageIdx) {}
+};
+
+struct GridCell {
+    size_t imageIdx;
+    std::string label;
+    PredictionResult predictionResult;
+};
+
+/// Results gathered since the previous redraw of the grid, only the latest ones which fit the grid are kept
+struct GridRenderItem {
+    std::deque<GridCell> cells;
+    PerformanceMetrics::Metrics metrics;
+    double accuracy;
+    bool isTestMode;
+    double gridFps;  ///< FPS the grid is sized for
+};
+
+struct SweepPoint {
+    size_t batchSize;
+    std::string nstreams;
+    unsigned int nireq;
+    double fps;
+    double latency;  // ms
+    double latencyP50;  // ms
+    double latencyP99;  // ms
+    double cpuLoad;  // percent of all cores
+};
+
+SweepPoint measureSweepPoint(ov::Core& core,
+                             const std::vector<std::string>& labels,
+                             const std::vector<cv::Mat>& images,
+                             size_t batchSize,
+                             const std::string& nstreams,
+                             unsigned int nireq) {
+    AsyncPipeline pipeline(std::unique_ptr<ModelBase>(
+                               new ClassificationModel(FLAGS_m, FLAGS_nt, FLAGS_auto_resize, labels, FLAGS_layout)),
+                           ConfigFactory::getUserConfig(FLAGS_d, nireq, nstreams, FLAGS_nthreads),
+                           core,
+                           BatchingConfig(batchSize));
+
+    PerformanceMetrics metrics;
+    std::unique_ptr<CpuMonitor> cpuMonitor;
+    unsigned int framesNum = 0;
+    std::size_t nextImageIndex = 0;
+    bool isWarmUp = true;
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    const std::chrono::steady_clock::time_point warmUpEnd = startTime + std::chrono::seconds(FLAGS_sweep_warmup);
+    const std::chrono::steady_clock::time_point endTime = warmUpEnd + std::chrono::seconds(FLAGS_sweep_time);
+    std::chrono::steady_clock::time_point now = startTime;
+    while (now < endTime) {
+        if (isWarmUp && now >= warmUpEnd) {
+            isWarmUp = false;
+            metrics = PerformanceMetrics();
+            cpuMonitor.reset(new CpuMonitor());
+            framesNum = 0;
+            startTime = now;
+        }
+        // images are submitted without rendering anything, so every free request is fed right away
+        while (pipeline.isReadyToProcess()) {
+            const cv::Mat& image = images[nextImageIndex];
+            pipeline.submitData(ImageInputData(image),
+                                std::make_shared<ImageMetaData>(image, std::chrono::steady_clock::now()));
+            nextImageIndex = (nextImageIndex + 1) % images.size();
+        }
+        pipeline.waitForData(false);
+        std::unique_ptr<ResultBase> result;
+        while ((result = pipeline.getResult(false))) {
+            metrics.update(result->metaData->asRef<ImageMetaData>().timeStamp);
+            framesNum++;
+        }
+        now = std::chrono::steady_clock::now();
+    }
+    cpuMonitor->collectData();
+
+    SweepPoint point;
+    point.batchSize = batchSize;
+    point.nstreams = nstreams.empty() ? "default" : nstreams;
+    point.nireq = pipeline.getRequestsNum();
+    point.fps = framesNum / std::chrono::duration_cast<PerformanceMetrics::Sec>(now - startTime).count();
+    PerformanceMetrics::Metrics total = metrics.getTotal();
+    point.latency = total.latency;
+    point.latencyP50 = total.latencyP50;
+    point.latencyP99 = total.latencyP99;
+    std::vector<double> cpuLoad = cpuMonitor->getMeanCpuLoad();
+    point.cpuLoad = cpuLoad.empty() ? 0 : 100 * std::accumulate(cpuLoad.begin(), cpuLoad.end(), 0.0) / cpuLoad.size();
+    return point;
+}
+
+void writeSweepReport(const std::string& path, const std::vector<SweepPoint>& points) {
+    std::ofstream report(path);
+    if (!report.is_open()) {
+        throw std::runtime_error("Can't open sweep report file " + path);
+    }
+    report << std::fixed << std::setprecision(2);
+    const std::string jsonExtension = ".json";
+    if (path.size() >= jsonExtension.size() &&
+        path.compare(path.size() - jsonExtension.size(), jsonExtension.size(), jsonExtension) == 0) {
+        report << "[\n";
+        for (size_t i = 0; i < points.size(); ++i) {
+            const SweepPoint& point = points[i];
+            report << "  {\"batch\": " << point.batchSize << ", \"nstreams\": \"" << point.nstreams
+                   << "\", \"nireq\": " << point.nireq << ", \"fps\": " << point.fps
+                   << ", \"latency\": " << point.latency << ", \"p50\": " << point.latencyP50
+                   << ", \"p99\": " << point.latencyP99 << ", \"cpu_load\": " << point.cpuLoad << '}'
+                   << (i + 1 < points.size() ? "," : "") << '\n';
+        }
+        report << "]\n";
+    } else {
+        report << "batch,nstreams,nireq,fps,latency,p50,p99,cpu_load\n";
+        for (const SweepPoint& point : points) {
+            report << point.batchSize << ',' << point.nstreams << ',' << point.nireq << ',' << point.fps << ','
+                   << point.latency << ',' << point.latencyP50 << ',' << point.latencyP99 << ',' << point.cpuLoad
+                   << '\n';
+        }
+    }
+    if (!report) {
+        throw std::runtime_error("Can't write sweep report file " + path);
+    }
+}
+
+/// Measures throughput, latency and CPU load for every combination of batch size, number of streams and infer
+/// requests on the preloaded images, nothing is rendered
+void runSweep(ov::Core& core, const std::vector<std::string>& labels, const std::vector<cv::Mat>& images) {
+    std::vector<size_t> batchSizes;
+    for (const std::string& batchSize : split(FLAGS_sweep_b, ',')) {
+        batchSizes.push_back(std::stoul(batchSize));
+    }
+    std::vector<unsigned int> nireqs;
+    for (const std::string& nireq : split(FLAGS_sweep_nireq, ',')) {
+        nireqs.push_back(static_cast<unsigned int>(std::stoul(nireq)));
+    }
+    std::vector<std::string> nstreamsList =
+        FLAGS_sweep_nstreams.empty() ? std::vector<std::string>{FLAGS_nstreams} : split(FLAGS_sweep_nstreams, ',');
+
+    std::vector<SweepPoint> points;
+    for (size_t batchSize : batchSizes) {
+        for (const std::string& nstreams : nstreamsList) {
+            for (unsigned int nireq : nireqs) {
+                points.push_back(measureSweepPoint(core, labels, images, batchSize, nstreams, nireq));
+                const SweepPoint& point = points.back();
+                slog::info << "Batch " << point.batchSize << ", streams " << point.nstreams << ", requests "
+                           << point.nireq << ": " << std::fixed << std::setprecision(1) << point.fps
+                           << " FPS, latency " << point.latency << " ms, p50 " << point.latencyP50 << " ms, p99 "
+                           << point.latencyP99 << " ms, CPU " << point.cpuLoad << "%" << slog::endl;
+                // the report is rewritten after every configuration to keep the results if the sweep is interrupted
+                writeSweepReport(FLAGS_sweep, points);
+            }
+        }
+    }
+}
+
 int main(int argc, char* argv[]) {
     try {
-        PerformanceMetrics metrics, readerMetrics, renderMetrics;
+        PerformanceMetrics metrics, readerMetrics;
 
         // ------------------------------ Parsing and validation of input args ---------------------------------
         if (!ParseAndCheckCommandLine(argc, argv)) {
@@ -218,12 +433,30 @@ int main(int argc, char* argv[]) {
         slog::info << ov::get_openvino_version() << slog::endl;
         ov::Core core;
 
+        if (!FLAGS_sweep.empty()) {
+            runSweep(core, labels, inputImages);
+            return 0;
+        }
+
+        ModelConfig config = ConfigFactory::getUserConfig(FLAGS_d, FLAGS_nireq, FLAGS_nstreams, FLAGS_nthreads);
+        config.tuning = ConfigFactory::getTuningConfig(FLAGS_tune, FLAGS_tune_latency, FLAGS_tune_cache);
+        config.warmupInferences = FLAGS_warmup;
+        config.profiledLayers = FLAGS_profile_layers;
+        config.remoteWorker = FLAGS_remote;
         AsyncPipeline pipeline(std::unique_ptr<ModelBase>(
                                    new ClassificationModel(FLAGS_m, FLAGS_nt, FLAGS_auto_resize, labels, FLAGS_layout)),
-                               ConfigFactory::getUserConfig(FLAGS_d, FLAGS_nireq, FLAGS_nstreams, FLAGS_nthreads),
+                               config,
                                core);
 
         Presenter presenter(FLAGS_u, 0);
+        std::unique_ptr<MetricsSink> metricsSink;
+        if (!FLAGS_metrics_file.empty()) {
+            metricsSink.reset(new MetricsSink(FLAGS_metrics_file));
+        }
+        std::unique_ptr<ResultsPublisher> resultsPublisher;
+        if (!FLAGS_results.empty()) {
+            resultsPublisher.reset(new ResultsPublisher(FLAGS_results));
+        }
         int width;
         int height;
         std::vector<std::string> gridMatRowsCols = split(FLAGS_res, 'x');
@@ -233,7 +466,48 @@ int main(int argc, char* argv[]) {
             width = std::stoi(gridMatRowsCols[0]);
             height = std::stoi(gridMatRowsCols[1]);
         }
-        GridMat gridMat(presenter, cv::Size(width, height));
+        const cv::Size gridResolution(width, height);
+        const cv::Size gridAspectRatio(16, 9);
+        double gridFps = 60;
+        size_t gridCellsNum = GridMat::getGridSize(gridAspectRatio, gridFps).area();
+        PerformanceMetrics renderMetrics;
+        // Thumbnails of the grid of the test mode are resized before the benchmark starts
+        std::unique_ptr<GridMat> gridMat;
+        double shownGridFps = gridFps;
+        std::atomic<bool> isRestartRequested{false};
+        // The grid is composed and shown by the render thread at display rate, so the thread submitting images only
+        // counts results and FPS reflects inference rather than HighGUI
+        auto render = [&](GridRenderItem& item) -> bool {
+            ITT_SCOPED_TASK("render");
+            if (item.gridFps != shownGridFps) {
+                gridMat.reset(new GridMat(presenter, inputImages, gridResolution, gridAspectRatio, item.gridFps));
+                shownGridFps = item.gridFps;
+            }
+            for (const GridCell& cell : item.cells) {
+                gridMat->updateMat(cell.imageIdx, cell.label, cell.predictionResult);
+            }
+            gridMat->textUpdate(item.metrics, item.accuracy, FLAGS_nt, item.isTestMode, !FLAGS_gt.empty(), presenter);
+            cv::imshow("classification_demo", gridMat->outImg);
+            //--- Processing keyboard events
+            int key = cv::waitKey(1);
+            if (27 == key || 'q' == key || 'Q' == key) {  // Esc
+                return false;
+            } else if (32 == key || 'r' == key || 'R' == key) {  // press space or r to restart testing if needed
+                isRestartRequested = true;
+            } else {
+                presenter.handleKey(key);
+            }
+            return true;
+        };
+        std::unique_ptr<RenderThread<GridRenderItem>> renderThread;
+        if (!FLAGS_no_show) {
+            gridMat.reset(new GridMat(presenter, inputImages, gridResolution, gridAspectRatio, gridFps));
+            // A redraw which isn't started when the next one is due is replaced by it
+            renderThread.reset(new RenderThread<GridRenderItem>(render, 1, true));
+        }
+        const std::chrono::steady_clock::duration redrawPeriod = std::chrono::milliseconds(16);
+        std::chrono::steady_clock::time_point lastRedrawTime;
+        GridRenderItem pendingItem;
         bool keepRunning = true;
         std::unique_ptr<ResultBase> result;
         double accuracy = 0;
@@ -248,17 +522,25 @@ int main(int argc, char* argv[]) {
         std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
 
         while (keepRunning && elapsedSeconds < std::chrono::seconds(FLAGS_time)) {
+            if (isRestartRequested.exchange(false)) {
+                isTestMode = true;
+                framesNum = 0;
+                framesNumOnCalculationStart = 0;
+                correctPredictionsCount = 0;
+                accuracy = 0;
+                elapsedSeconds = std::chrono::steady_clock::duration(0);
+                startTime = std::chrono::steady_clock::now();
+            }
             if (elapsedSeconds >= testDuration - fpsCalculationDuration && framesNumOnCalculationStart == 0) {
                 framesNumOnCalculationStart = framesNum;
             }
             if (isTestMode && elapsedSeconds >= testDuration) {
                 isTestMode = false;
                 typedef std::chrono::duration<double, std::chrono::seconds::period> Sec;
-                gridMat = GridMat(presenter,
-                                  cv::Size(width, height),
-                                  cv::Size(16, 9),
-                                  (framesNum - framesNumOnCalculationStart) /
-                                      std::chrono::duration_cast<Sec>(fpsCalculationDuration).count());
+                gridFps = (framesNum - framesNumOnCalculationStart) /
+                          std::chrono::duration_cast<Sec>(fpsCalculationDuration).count();
+                gridCellsNum = GridMat::getGridSize(gridAspectRatio, gridFps).area();
+                pendingItem.cells.clear();
                 metrics = PerformanceMetrics();
                 startTime = std::chrono::steady_clock::now();
                 framesNum = 0;
@@ -270,9 +552,10 @@ int main(int argc, char* argv[]) {
                 auto imageStartTime = std::chrono::steady_clock::now();
 
                 pipeline.submitData(ImageInputData(inputImages[nextImageIndex]),
-                                    std::make_shared<ClassificationImageMetaData>(inputImages[nextImageIndex],
-                                                                                  imageStartTime,
-                                                                                  classIndices[nextImageIndex]));
+                                    std::make_shared<GridImageMetaData>(inputImages[nextImageIndex],
+                                                                        imageStartTime,
+                                                                        classIndices[nextImageIndex],
+                                                                        nextImageIndex));
                 nextImageIndex++;
                 if (nextImageIndex == imageNames.size()) {
                     nextImageIndex = 0;
@@ -283,27 +566,24 @@ int main(int argc, char* argv[]) {
             // are available.
             pipeline.waitForData(false);
 
-            //--- Checking for results and rendering data if it's ready
+            //--- Checking for results, they are only counted here and shown by the render thread
             while ((result = pipeline.getResult(false)) && keepRunning) {
-                auto renderingStart = std::chrono::steady_clock::now();
+                if (resultsPublisher) {
+                    resultsPublisher->publish(*result);
+                }
                 const ClassificationResult& classificationResult = result->asRef<ClassificationResult>();
                 if (!classificationResult.metaData) {
                     throw std::invalid_argument("Renderer: metadata is null");
                 }
-                const ClassificationImageMetaData& classificationImageMetaData =
-                    classificationResult.metaData->asRef<const ClassificationImageMetaData>();
-
-                auto outputImg = classificationImageMetaData.img;
+                const GridImageMetaData& gridImageMetaData =
+                    classificationResult.metaData->asRef<const GridImageMetaData>();
 
-                if (outputImg.empty()) {
-                    throw std::invalid_argument("Renderer: image provided in metadata is empty");
-                }
                 PredictionResult predictionResult = PredictionResult::Incorrect;
                 std::string label = classificationResult.topLabels.front().label;
                 if (!FLAGS_gt.empty()) {
                     for (size_t i = 0; i < FLAGS_nt; i++) {
                         unsigned predictedClass = classificationResult.topLabels[i].id;
-                        if (predictedClass == classificationImageMetaData.groundTruthId) {
+                        if (predictedClass == gridImageMetaData.groundTruthId) {
                             predictionResult = PredictionResult::Correct;
                             correctPredictionsCount++;
                             label = classificationResult.topLabels[i].label;
@@ -314,38 +594,53 @@ int main(int argc, char* argv[]) {
                     predictionResult = PredictionResult::Unknown;
                 }
                 framesNum++;
-                gridMat.updateMat(outputImg, label, predictionResult);
                 accuracy = static_cast<double>(correctPredictionsCount) / framesNum;
-                gridMat.textUpdate(metrics,
-                                   classificationResult.metaData->asRef<ImageMetaData>().timeStamp,
-                                   accuracy,
-                                   FLAGS_nt,
-                                   isTestMode,
-                                   !FLAGS_gt.empty(),
-                                   presenter);
-                renderMetrics.update(renderingStart);
-                elapsedSeconds = std::chrono::steady_clock::now() - startTime;
-                if (!FLAGS_no_show) {
-                    cv::imshow("classification_demo", gridMat.outImg);
-                    //--- Processing keyboard events
-                    int key = cv::waitKey(1);
-                    if (27 == key || 'q' == key || 'Q' == key) {  // Esc
-                        keepRunning = false;
-                    } else if (32 == key || 'r' == key ||
-                               'R' == key) {  // press space or r to restart testing if needed
-                        isTestMode = true;
-                        framesNum = 0;
-                        framesNumOnCalculationStart = 0;
-                        correctPredictionsCount = 0;
-                        accuracy = 0;
-                        elapsedSeconds = std::chrono::steady_clock::duration(0);
-                        startTime = std::chrono::steady_clock::now();
-                    } else {
-                        presenter.handleKey(key);
+                metrics.update(gridImageMetaData.timeStamp);
+                if (renderThread) {
+                    // Older results would be overwritten in the grid before it's shown
+                    if (pendingItem.cells.size() == gridCellsNum) {
+                        pendingItem.cells.pop_front();
                     }
+                    pendingItem.cells.push_back({gridImageMetaData.imageIdx, label, predictionResult});
+                }
+                elapsedSeconds = std::chrono::steady_clock::now() - startTime;
+            }
+
+            const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            if (renderThread && keepRunning && now - lastRedrawTime >= redrawPeriod) {
+                pendingItem.metrics = metrics.getLast();
+                pendingItem.accuracy = accuracy;
+                pendingItem.isTestMode = isTestMode;
+                pendingItem.gridFps = gridFps;
+                keepRunning = renderThread->push(std::move(pendingItem));
+                pendingItem = GridRenderItem();
+                lastRedrawTime = now;
+            }
+
+            if (metricsSink && metricsSink->isDue()) {
+                if (renderThread) {
+                    renderMetrics = renderThread->getMetrics();
                 }
+                pipeline.reportMetrics(*metricsSink);
+                const std::pair<double, double> memSwapUsage = presenter.getLastMemSwapUsage();
+                const std::pair<double, double> gpuUsage = presenter.getLastGpuUsage();
+                const double power = presenter.getLastPower();
+                metricsSink->stage("rendering", renderMetrics.getLast())
+                    .stage("total", metrics.getLast())
+                    .value("cpu_load", presenter.getLastCpuLoad())
+                    .value("memory_gib", memSwapUsage.first)
+                    .value("swap_gib", memSwapUsage.second)
+                    .value("power_w", power)
+                    .value("fps_per_watt", metrics.getLast().fps / power)
+                    .value("gpu_utilization", gpuUsage.first)
+                    .value("gpu_frequency_mhz", gpuUsage.second);
+                metricsSink->publish();
             }
         }
+        if (renderThread) {
+            renderThread->finish();
+            renderMetrics = renderThread->getMetrics();
+        }
 
         if (!FLAGS_gt.empty()) {
             slog::info << "Accuracy (top " << FLAGS_nt << "): " << accuracy << slog::endl;
@@ -353,12 +648,18 @@ int main(int argc, char* argv[]) {
 
         slog::info << "Metrics report:" << slog::endl;
         metrics.logTotal();
-        logLatencyPerStage(readerMetrics.getTotal().latency,
-                           pipeline.getPreprocessMetrics().getTotal().latency,
-                           pipeline.getInferenceMetircs().getTotal().latency,
-                           pipeline.getPostprocessMetrics().getTotal().latency,
-                           renderMetrics.getTotal().latency);
+        logLatencyPerStage(readerMetrics.getTotal(),
+                           pipeline.getPreprocessMetrics().getTotal(),
+                           pipeline.getInferenceMetircs().getTotal(),
+                           pipeline.getPostprocessMetrics().getTotal(),
+                           renderMetrics.getTotal());
+        pipeline.logLayersProfile();
         slog::info << presenter.reportMeans() << slog::endl;
+        const double meanPower = presenter.getMeanPower();
+        if (!std::isnan(meanPower)) {
+            slog::info << "\tFPS/W: " << metrics.getTotal().fps / meanPower << slog::endl;
+        }
+        logMemoryUsage();
     } catch (const std::exception& error) {
         slog::err << error.what() << slog::endl;
         return 1;
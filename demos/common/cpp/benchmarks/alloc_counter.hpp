@@ -0,0 +1,26 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+#include <stddef.h>
+
+#include <benchmark/benchmark.h>
+
+/// Number of the allocations made by operator new in the benchmark binary so far
+size_t allocationsCount();
+
+/// Counts the allocations made during the benchmark loop and reports their mean number per iteration as "allocs"
+class AllocationsCounter {
+public:
+    explicit AllocationsCounter(benchmark::State& state) : state(state), start(allocationsCount()) {}
+
+    ~AllocationsCounter() {
+        state.counters["allocs"] = benchmark::Counter(static_cast<double>(allocationsCount() - start),
+                                                      benchmark::Counter::kAvgIterations);
+    }
+
+private:
+    benchmark::State& state;
+    size_t start;
+};
@@ -0,0 +1,59 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <stddef.h>
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include <models/associative_embedding_decoder.h>
+
+#include "alloc_counter.hpp"
+#include "hpe_benchmarks.hpp"
+
+namespace {
+/** Parameters of HpeAssociativeEmbedding, the maps are the 128x128 output for the 512x512 input **/
+constexpr size_t numJoints = 17;
+constexpr size_t maxNumPeople = 30;
+constexpr float detectionThreshold = 0.1f;
+constexpr float tagThreshold = 1.0f;
+constexpr float delta = 0.0f;
+const cv::Size mapSize(128, 128);
+
+/** HpeAssociativeEmbedding::extractPoses() over the maps of the scene of range(0) people **/
+void BM_AssociativeEmbeddingExtractPoses(benchmark::State& state) {
+    cv::Mat heats, nmsHeats, aembds;
+    std::vector<cv::Mat> heatMaps = makeMaps(heats, numJoints, mapSize);
+    std::vector<cv::Mat> nmsHeatMaps = makeMaps(nmsHeats, numJoints, mapSize);
+    std::vector<cv::Mat> aembdsMaps = makeMaps(aembds, numJoints, mapSize);
+    const auto people = makePeople(static_cast<int>(state.range(0)), numJoints, mapSize);
+    for (size_t p = 0; p < people.size(); ++p) {
+        for (size_t k = 0; k < numJoints; ++k) {
+            const cv::Point2f& pos = people[p][k];
+            drawBlob(heatMaps[k], pos);
+            /** The peaks stay after the NMS of the heat maps, all the keypoints of a person share the tag **/
+            nmsHeatMaps[k].at<float>(cv::Point(pos)) = heatMaps[k].at<float>(cv::Point(pos));
+            cv::circle(aembdsMaps[k], pos, 3, cv::Scalar(static_cast<double>(p) * 2 * tagThreshold), -1);
+        }
+    }
+
+    AllocationsCounter allocations(state);
+    AssociativeEmbeddingBuffers buffers;
+    for (auto _ : state) {
+        buffers.reset(numJoints, maxNumPeople);
+        for (size_t i = 0; i < numJoints; ++i) {
+            findPeaks(nmsHeatMaps, aembdsMaps, buffers, i, maxNumPeople, detectionThreshold);
+        }
+        matchByTag(buffers, maxNumPeople, numJoints, tagThreshold);
+        for (size_t i = 0; i < buffers.posesNum; ++i) {
+            adjustAndRefine(buffers.poses, heatMaps, aembdsMaps, static_cast<int>(i), delta);
+        }
+        benchmark::DoNotOptimize(buffers.poses.data());
+    }
+}
+BENCHMARK(BM_AssociativeEmbeddingExtractPoses)->Arg(1)->Arg(5)->Arg(20);
+}  // namespace
@@ -0,0 +1,479 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <opencv2/core.hpp>
+#include <opencv2/core/utils/filesystem.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/videoio.hpp>
+
+#include <monitors/cpu_monitor.h>
+#include <monitors/memory_monitor.h>
+#include <utils/args_helper.hpp>
+#include <utils/images_capture.h>
+#include <utils/memory_accounting.hpp>
+#include <utils/slog.hpp>
+
+static const char help_message[] = "Print a usage message.";
+static const char input_message[] = "Optional. Comma separated inputs of openImagesCapture(): images, folders of "
+                                    "images, videos, camera indices, packed frames files, shm://<name>, "
+                                    "gst://<pipeline> or RTSP URLs. Every input is benchmarked separately.";
+static const char generate_message[] = "Optional. Comma separated resolutions of synthetic inputs, e.g. "
+                                       "1280x720,1920x1080. For every resolution an image, a folder of JPEG images "
+                                       "and a video of every codec of -codecs are written and benchmarked.";
+static const char codecs_message[] = "Optional. Comma separated FourCC codes of the synthetic videos. Codecs which "
+                                     "the OpenCV build can't encode are skipped. Default is MJPG,mp4v.";
+static const char generate_frames_message[] = "Optional. Number of frames of every synthetic input. Default is 300.";
+static const char generate_dir_message[] = "Optional. Folder the synthetic inputs are written to. Default is the "
+                                           "current folder.";
+static const char streams_message[] = "Optional. Comma separated numbers of streams reading an input at once. Every "
+                                      "stream opens its own capture and reads it by its own thread. Default is 1.";
+static const char prefetch_message[] = "Optional. Comma separated queue sizes of PrefetchingCapture, 0 reads frames "
+                                       "without prefetching. Default is 0.";
+static const char dir_threads_message[] = "Optional. If positive, folders of images are also read by "
+                                          "openParallelDirReader() with this number of decoding threads.";
+static const char frame_step_message[] = "Optional. Every frame_step-th frame of videos and cameras is decoded, the "
+                                         "rest are grabbed only. Default is 1.";
+static const char low_latency_message[] = "Optional. Read videos and network streams keeping only the newest frame.";
+static const char camera_resolution_message[] = "Optional. Resolution requested from cameras. Default is 1280x720.";
+static const char time_message[] = "Optional. Duration of every run in seconds. Default is 5.";
+static const char csv_message[] = "Optional. Path of a CSV file the results of all runs are written to.";
+
+DEFINE_bool(h, false, help_message);
+DEFINE_string(i, "", input_message);
+DEFINE_string(generate, "", generate_message);
+DEFINE_string(codecs, "MJPG,mp4v", codecs_message);
+DEFINE_uint32(generate_frames, 300, generate_frames_message);
+DEFINE_string(generate_dir, ".", generate_dir_message);
+DEFINE_string(streams, "1", streams_message);
+DEFINE_string(prefetch, "0", prefetch_message);
+DEFINE_uint32(dir_threads, 0, dir_threads_message);
+DEFINE_uint32(frame_step, 1, frame_step_message);
+DEFINE_bool(low_latency, false, low_latency_message);
+DEFINE_string(camera_resolution, "1280x720", camera_resolution_message);
+DEFINE_uint32(t, 5, time_message);
+DEFINE_string(csv, "", csv_message);
+
+static void showUsage() {
+    std::cout << std::endl;
+    std::cout << "capture_benchmark [OPTION]" << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << std::endl;
+    std::cout << "    -h                             " << help_message << std::endl;
+    std::cout << "    -i \"<inputs>\"                  " << input_message << std::endl;
+    std::cout << "    -generate \"<WxH,...>\"          " << generate_message << std::endl;
+    std::cout << "    -codecs \"<FourCC,...>\"         " << codecs_message << std::endl;
+    std::cout << "    -generate_frames \"<integer>\"   " << generate_frames_message << std::endl;
+    std::cout << "    -generate_dir \"<path>\"         " << generate_dir_message << std::endl;
+    std::cout << "    -streams \"<integers>\"          " << streams_message << std::endl;
+    std::cout << "    -prefetch \"<integers>\"         " << prefetch_message << std::endl;
+    std::cout << "    -dir_threads \"<integer>\"       " << dir_threads_message << std::endl;
+    std::cout << "    -frame_step \"<integer>\"        " << frame_step_message << std::endl;
+    std::cout << "    -low_latency                   " << low_latency_message << std::endl;
+    std::cout << "    -camera_resolution \"<WxH>\"     " << camera_resolution_message << std::endl;
+    std::cout << "    -t \"<integer>\"                 " << time_message << std::endl;
+    std::cout << "    -csv \"<path>\"                  " << csv_message << std::endl;
+}
+
+namespace {
+/// Configuration of a run: every stream opens the input by the same backend
+struct RunConfig {
+    std::string input;
+    size_t streams;
+    size_t prefetch;
+    size_t dirThreads;  ///< 0 opens the input by openImagesCapture()
+};
+
+struct StreamStats {
+    std::vector<double> latencies;  ///< read time of every frame, in milliseconds
+    double elapsed = 0;  ///< seconds from the start of the run till the stream stopped reading
+    cv::Size resolution;
+    bool ended = false;  ///< the input had no more frames before the end of the run
+    std::exception_ptr exception;
+};
+
+struct RunResult {
+    RunConfig config;
+    std::string type;
+    std::string error;
+    cv::Size resolution;
+    size_t frames = 0;
+    size_t endedStreams = 0;
+    double openTime = 0;  ///< mean time of opening of a capture, in milliseconds
+    double fps = 0;  ///< frames of all streams per second
+    double minStreamFps = 0;
+    double latencyP50 = 0, latencyP90 = 0, latencyP99 = 0, latencyMax = 0;
+    double cpuCores = 0;  ///< mean load of the host during the run, 1 is one core fully loaded
+    double rssPeak = 0, rssGrowth = 0;  ///< in MiB
+};
+
+std::vector<size_t> parseSizes(const std::string& list, const char* flag) {
+    std::vector<size_t> values;
+    for (const std::string& value : split(list, ',')) {
+        try {
+            values.push_back(static_cast<size_t>(std::stoul(value)));
+        } catch (const std::logic_error&) {
+            throw std::invalid_argument(std::string("Can't parse -") + flag + " value: " + value);
+        }
+    }
+    return values;
+}
+
+/// A scene which is compressed like a camera picture rather than a still image or noise: a moving gradient with
+/// moving boxes and mild noise
+cv::Mat makeSyntheticFrame(const cv::Size& size, size_t frameIdx, cv::RNG& rng) {
+    cv::Mat frame(size, CV_8UC3);
+    for (int y = 0; y < size.height; ++y) {
+        const int shade = static_cast<int>((y * 255 / std::max(size.height - 1, 1) + frameIdx * 2) % 256);
+        frame.row(y).setTo(cv::Scalar(shade, 255 - shade, (shade + 128) % 256));
+    }
+    const int boxSide = std::max(size.height / 8, 4);
+    for (int box = 0; box < 8; ++box) {
+        const int x = static_cast<int>((box * size.width / 8 + frameIdx * (box + 1) * 3) % size.width);
+        const int y = static_cast<int>((box * size.height / 8 + frameIdx * (8 - box)) % size.height);
+        cv::rectangle(frame, cv::Rect(x, y, boxSide, boxSide), cv::Scalar(box * 32, 255 - box * 32, 128), cv::FILLED);
+    }
+    cv::Mat noise(size, CV_8UC3);
+    rng.fill(noise, cv::RNG::UNIFORM, 0, 16);
+    frame += noise;
+    return frame;
+}
+
+std::string getVideoExtension(const std::string& fourcc) {
+    static const char* const mp4Codecs[] = {"mp4v", "avc1", "H264", "h264", "hev1", "hvc1", "HEVC"};
+    for (const char* codec : mp4Codecs) {
+        if (fourcc == codec) {
+            return ".mp4";
+        }
+    }
+    return ".avi";
+}
+
+/// Writes synthetic inputs of the resolution
+/// @returns paths of the image, the folder of images and the videos
+std::vector<std::string> generateInputs(const cv::Size& size,
+                                        const std::vector<std::string>& codecs,
+                                        size_t framesNum,
+                                        const std::string& dir) {
+    std::vector<std::string> inputs;
+    const std::string name = std::to_string(size.width) + "x" + std::to_string(size.height);
+    const std::string imagesDir = cv::utils::fs::join(dir, "capture_benchmark_" + name + "_jpg");
+    cv::utils::fs::createDirectories(imagesDir);
+    std::vector<cv::VideoWriter> writers;
+    std::vector<std::string> videos;
+    for (const std::string& codec : codecs) {
+        if (codec.size() != 4) {
+            throw std::invalid_argument("FourCC code should be of 4 characters: " + codec);
+        }
+        const std::string path = cv::utils::fs::join(dir, "capture_benchmark_" + name + "_" + codec) +
+                                 getVideoExtension(codec);
+        cv::VideoWriter writer(path, cv::VideoWriter::fourcc(codec[0], codec[1], codec[2], codec[3]), 30, size);
+        if (!writer.isOpened()) {
+            slog::warn << "OpenCV can't encode " << codec << " videos, the codec is skipped" << slog::endl;
+            continue;
+        }
+        writers.push_back(writer);
+        videos.push_back(path);
+    }
+    cv::RNG rng(0xC0FFEE);
+    std::string firstImage;
+    for (size_t frameIdx = 0; frameIdx < framesNum; ++frameIdx) {
+        const cv::Mat frame = makeSyntheticFrame(size, frameIdx, rng);
+        std::ostringstream imageName;
+        imageName << "frame_" << std::setw(5) << std::setfill('0') << frameIdx << ".jpg";
+        const std::string imagePath = cv::utils::fs::join(imagesDir, imageName.str());
+        if (!cv::imwrite(imagePath, frame)) {
+            throw std::runtime_error("Can't write " + imagePath);
+        }
+        if (firstImage.empty()) {
+            firstImage = imagePath;
+        }
+        for (cv::VideoWriter& writer : writers) {
+            writer.write(frame);
+        }
+    }
+    slog::info << "Synthetic " << name << " inputs are written to " << dir << slog::endl;
+    inputs.push_back(firstImage);
+    inputs.push_back(imagesDir);
+    inputs.insert(inputs.end(), videos.begin(), videos.end());
+    return inputs;
+}
+
+std::unique_ptr<ImagesCapture> openStream(const RunConfig& config) {
+    // Inputs are looped, so short files are read for the whole run
+    if (config.dirThreads > 0) {
+        return openParallelDirReader(config.input, true, config.dirThreads);
+    }
+    return openImagesCapture(config.input,
+                             true,
+                             read_type::efficient,
+                             0,
+                             std::numeric_limits<size_t>::max(),
+                             stringToSize(FLAGS_camera_resolution),
+                             config.prefetch,
+                             FLAGS_frame_step,
+                             0,
+                             -1,
+                             FLAGS_low_latency);
+}
+
+void readStream(ImagesCapture& capture,
+                std::chrono::steady_clock::time_point startTime,
+                std::chrono::steady_clock::time_point deadline,
+                StreamStats& stats,
+                std::atomic<size_t>& stoppedStreams) {
+    try {
+        cv::Mat frame;
+        while (std::chrono::steady_clock::now() < deadline) {
+            const auto readStart = std::chrono::steady_clock::now();
+            if (!capture.readInto(frame)) {
+                stats.ended = true;
+                break;
+            }
+            stats.latencies.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+                                                                                readStart)
+                                          .count());
+            stats.resolution = frame.size();
+        }
+    } catch (...) {
+        stats.exception = std::current_exception();
+    }
+    stats.elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    ++stoppedStreams;
+}
+
+/// @returns the q-th quantile of the values, the values are reordered
+double quantile(std::vector<double>& values, double q) {
+    if (values.empty()) {
+        return 0;
+    }
+    const auto nth = values.begin() + static_cast<std::ptrdiff_t>(q * (values.size() - 1));
+    std::nth_element(values.begin(), nth, values.end());
+    return *nth;
+}
+
+RunResult run(const RunConfig& config) {
+    RunResult result;
+    result.config = config;
+    MemoryMonitor memoryMonitor;
+    memoryMonitor.setHistorySize(1);
+    memoryMonitor.collectData();
+    const double rssBefore = memoryMonitor.getLastRss();
+
+    std::vector<std::unique_ptr<ImagesCapture>> captures;
+    try {
+        const auto openStart = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < config.streams; ++i) {
+            captures.push_back(openStream(config));
+        }
+        result.openTime =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - openStart).count() /
+            config.streams;
+    } catch (const std::exception& error) {
+        result.error = error.what();
+        return result;
+    }
+    result.type = captures.front()->getType();
+
+    CpuMonitor cpuMonitor;
+    cpuMonitor.setHistorySize(1);
+    std::vector<StreamStats> stats(config.streams);
+    std::atomic<size_t> stoppedStreams{0};
+    const auto startTime = std::chrono::steady_clock::now();
+    const auto deadline = startTime + std::chrono::seconds(FLAGS_t);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < config.streams; ++i) {
+        threads.emplace_back(readStream,
+                             std::ref(*captures[i]),
+                             startTime,
+                             deadline,
+                             std::ref(stats[i]),
+                             std::ref(stoppedStreams));
+    }
+    // The monitors are sampled by this thread while the streams are read
+    while (stoppedStreams < config.streams) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+        cpuMonitor.collectData();
+        memoryMonitor.collectData();
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    cpuMonitor.collectData();
+    memoryMonitor.collectData();
+
+    std::vector<double> latencies;
+    result.minStreamFps = std::numeric_limits<double>::max();
+    for (const StreamStats& stream : stats) {
+        if (stream.exception) {
+            try {
+                std::rethrow_exception(stream.exception);
+            } catch (const std::exception& error) {
+                result.error = error.what();
+            } catch (...) {
+                result.error = "Unknown exception";
+            }
+        }
+        const double streamFps = stream.elapsed > 0 ? stream.latencies.size() / stream.elapsed : 0;
+        result.fps += streamFps;
+        result.minStreamFps = std::min(result.minStreamFps, streamFps);
+        result.frames += stream.latencies.size();
+        result.endedStreams += stream.ended ? 1 : 0;
+        if (result.resolution.area() == 0) {
+            result.resolution = stream.resolution;
+        }
+        latencies.insert(latencies.end(), stream.latencies.begin(), stream.latencies.end());
+    }
+    result.latencyP50 = quantile(latencies, 0.5);
+    result.latencyP90 = quantile(latencies, 0.9);
+    result.latencyP99 = quantile(latencies, 0.99);
+    result.latencyMax = latencies.empty() ? 0 : *std::max_element(latencies.begin(), latencies.end());
+    for (double coreLoad : cpuMonitor.getMeanCpuLoad()) {
+        result.cpuCores += coreLoad;
+    }
+    result.rssPeak = memoryMonitor.getMaxRss() * 1024;
+    result.rssGrowth = std::max(memoryMonitor.getMaxRss() - rssBefore, 0.0) * 1024;
+    return result;
+}
+
+void logResult(const RunResult& result) {
+    const RunConfig& config = result.config;
+    slog::info << config.input << ": " << config.streams << " streams";
+    if (config.dirThreads > 0) {
+        slog::info << ", parallel folder reader of " << config.dirThreads << " threads";
+    } else if (config.prefetch > 0) {
+        slog::info << ", prefetching " << config.prefetch << " frames";
+    }
+    slog::info << slog::endl;
+    if (result.type.empty()) {
+        slog::err << "\tCan't open the input: " << result.error << slog::endl;
+        return;
+    }
+    slog::info << "\tBackend: " << result.type << ", " << result.resolution.width << "x" << result.resolution.height
+               << slog::endl;
+    slog::info << std::fixed << std::setprecision(1) << "\tOpening: " << result.openTime << " ms per stream"
+               << slog::endl;
+    slog::info << "\tThroughput: " << result.fps << " FPS, " << result.minStreamFps << " FPS of the slowest stream, "
+               << result.frames << " frames" << slog::endl;
+    slog::info << "\tRead latency: " << std::setprecision(2) << result.latencyP50 << " ms p50, " << result.latencyP90
+               << " ms p90, " << result.latencyP99 << " ms p99, " << result.latencyMax << " ms max" << slog::endl;
+    slog::info << std::setprecision(2) << "\tHost CPU: " << result.cpuCores << " cores, "
+               << result.cpuCores / config.streams << " cores per stream" << slog::endl;
+    slog::info << std::setprecision(1) << "\tMemory: " << result.rssPeak << " MiB peak RSS, " << result.rssGrowth
+               << " MiB grown during the run" << slog::endl;
+    if (result.endedStreams > 0) {
+        slog::warn << "\t" << result.endedStreams << " streams ran out of frames before the end of the run"
+                   << slog::endl;
+    }
+    if (!result.error.empty()) {
+        slog::err << "\tReading failed: " << result.error << slog::endl;
+    }
+}
+
+void writeCsv(const std::string& path, const std::vector<RunResult>& results) {
+    std::ofstream csv(path);
+    if (!csv) {
+        throw std::runtime_error("Can't open " + path);
+    }
+    csv << "input,backend,streams,prefetch,dir_threads,width,height,frames,open_ms,fps,min_stream_fps,p50_ms,p90_ms,"
+           "p99_ms,max_ms,cpu_cores,cpu_cores_per_stream,rss_peak_mib,rss_growth_mib,error\n";
+    for (const RunResult& result : results) {
+        const RunConfig& config = result.config;
+        std::string error = result.error;
+        std::replace(error.begin(), error.end(), '"', '\'');
+        csv << '"' << config.input << "\"," << result.type << ',' << config.streams << ',' << config.prefetch << ','
+            << config.dirThreads << ',' << result.resolution.width << ',' << result.resolution.height << ','
+            << result.frames << ',' << result.openTime << ',' << result.fps << ',' << result.minStreamFps << ','
+            << result.latencyP50 << ',' << result.latencyP90 << ',' << result.latencyP99 << ',' << result.latencyMax
+            << ',' << result.cpuCores << ',' << result.cpuCores / config.streams << ',' << result.rssPeak << ','
+            << result.rssGrowth << ",\"" << error << "\"\n";
+    }
+}
+}  // namespace
+
+bool ParseAndCheckCommandLine(int argc, char* argv[]) {
+    gflags::ParseCommandLineNonHelpFlags(&argc, &argv, true);
+    if (FLAGS_h) {
+        showUsage();
+        return false;
+    }
+    if (FLAGS_i.empty() && FLAGS_generate.empty()) {
+        throw std::logic_error("Either -i or -generate should be set");
+    }
+    if (FLAGS_t == 0) {
+        throw std::logic_error("Parameter -t should be positive");
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        if (!ParseAndCheckCommandLine(argc, argv)) {
+            return 0;
+        }
+
+        std::vector<std::string> inputs = FLAGS_i.empty() ? std::vector<std::string>() : split(FLAGS_i, ',');
+        if (!FLAGS_generate.empty()) {
+            const std::vector<std::string> codecs = split(FLAGS_codecs, ',');
+            for (const std::string& resolution : split(FLAGS_generate, ',')) {
+                const std::vector<std::string> generated =
+                    generateInputs(stringToSize(resolution), codecs, FLAGS_generate_frames, FLAGS_generate_dir);
+                inputs.insert(inputs.end(), generated.begin(), generated.end());
+            }
+        }
+        const std::vector<size_t> streamsNums = parseSizes(FLAGS_streams, "streams");
+        const std::vector<size_t> prefetchSizes = parseSizes(FLAGS_prefetch, "prefetch");
+        if (std::find(streamsNums.begin(), streamsNums.end(), 0) != streamsNums.end()) {
+            throw std::invalid_argument("Number of streams should be positive");
+        }
+
+        std::vector<RunResult> results;
+        for (const std::string& input : inputs) {
+            std::vector<RunConfig> configs;
+            for (size_t streams : streamsNums) {
+                for (size_t prefetch : prefetchSizes) {
+                    configs.push_back({input, streams, prefetch, 0});
+                }
+                if (FLAGS_dir_threads > 0 && cv::utils::fs::isDirectory(input)) {
+                    configs.push_back({input, streams, 0, FLAGS_dir_threads});
+                }
+            }
+            for (const RunConfig& config : configs) {
+                results.push_back(run(config));
+                logResult(results.back());
+            }
+        }
+        // Peaks of the tagged memory, e.g. of the prefetching queues, over all runs
+        logMemoryUsage();
+        if (!FLAGS_csv.empty()) {
+            writeCsv(FLAGS_csv, results);
+        }
+    } catch (const std::exception& error) {
+        slog::err << error.what() << slog::endl;
+        return 1;
+    } catch (...) {
+        slog::err << "Unknown/internal exception happened." << slog::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,54 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+/// Keypoints of the people of a synthetic scene: a person is a random center with the same skeleton offsets
+inline std::vector<std::vector<cv::Point2f>> makePeople(int people, int keypoints, const cv::Size& size) {
+    cv::RNG rng(0xC0FFEE);
+    std::vector<cv::Point2f> skeleton(keypoints);
+    for (auto& offset : skeleton) {
+        offset = {rng.uniform(-8.f, 8.f), rng.uniform(-16.f, 16.f)};
+    }
+    std::vector<std::vector<cv::Point2f>> scene(people);
+    for (auto& person : scene) {
+        const cv::Point2f center(rng.uniform(16.f, size.width - 16.f), rng.uniform(24.f, size.height - 24.f));
+        for (const auto& offset : skeleton) {
+            person.push_back(center + offset);
+        }
+    }
+    return scene;
+}
+
+/// Draws the Gaussian blob of a keypoint on the heat map, keeping the maximum of the overlapping blobs
+inline void drawBlob(cv::Mat& heatMap, const cv::Point2f& pos, float sigma = 1.5f) {
+    const int radius = static_cast<int>(3 * sigma);
+    for (int y = std::max(0, static_cast<int>(pos.y) - radius);
+         y <= std::min(heatMap.rows - 1, static_cast<int>(pos.y) + radius);
+         ++y) {
+        float* row = heatMap.ptr<float>(y);
+        for (int x = std::max(0, static_cast<int>(pos.x) - radius);
+             x <= std::min(heatMap.cols - 1, static_cast<int>(pos.x) + radius);
+             ++x) {
+            const float d2 = (x - pos.x) * (x - pos.x) + (y - pos.y) * (y - pos.y);
+            row[x] = std::max(row[x], std::exp(-d2 / (2 * sigma * sigma)));
+        }
+    }
+}
+
+/// Feature maps of the channels of a CHW tensor stored in one buffer, like the outputs of the networks
+inline std::vector<cv::Mat> makeMaps(cv::Mat& tensor, int channels, const cv::Size& size) {
+    tensor = cv::Mat::zeros(channels * size.height, size.width, CV_32F);
+    std::vector<cv::Mat> maps;
+    for (int c = 0; c < channels; ++c) {
+        maps.push_back(tensor.rowRange(c * size.height, (c + 1) * size.height));
+    }
+    return maps;
+}
@@ -0,0 +1,66 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <stddef.h>
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <opencv2/core.hpp>
+
+#include <models/openpose_decoder.h>
+#include <models/results.h>
+
+#include "alloc_counter.hpp"
+#include "hpe_benchmarks.hpp"
+
+namespace {
+/** Parameters of HPEOpenPose, the maps are upsampled from the 32x57 output of the network **/
+constexpr size_t keypointsNumber = 18;
+constexpr int pafsNumber = 38;
+constexpr float minPeaksDistance = 3.0f;
+constexpr float confidenceThreshold = 0.1f;
+constexpr float midPointsScoreThreshold = 0.05f;
+constexpr float foundMidPointsRatioThreshold = 0.8f;
+constexpr int minJointsNumber = 3;
+constexpr float minSubsetScore = 0.2f;
+const cv::Size mapSize(228, 128);
+
+/** HPEOpenPose::extractPoses() over the maps of the scene of range(0) people **/
+void BM_OpenPoseExtractPoses(benchmark::State& state) {
+    cv::Mat heats, predictions;
+    std::vector<cv::Mat> heatMaps = makeMaps(heats, keypointsNumber, mapSize);
+    std::vector<cv::Mat> pafs = makeMaps(predictions, pafsNumber, mapSize);
+    for (const auto& person : makePeople(static_cast<int>(state.range(0)), keypointsNumber, mapSize)) {
+        for (size_t k = 0; k < keypointsNumber; ++k) {
+            drawBlob(heatMaps[k], person[k]);
+        }
+    }
+    cv::RNG rng(0xC0FFEE);
+    rng.fill(predictions, cv::RNG::UNIFORM, -1.f, 1.f);
+
+    AllocationsCounter allocations(state);
+    for (auto _ : state) {
+        std::vector<std::vector<Peak>> peaksFromHeatMap(heatMaps.size());
+        for (size_t i = 0; i < heatMaps.size(); ++i) {
+            findPeaks(heatMaps, minPeaksDistance, peaksFromHeatMap, static_cast<int>(i), confidenceThreshold);
+        }
+        int peaksBefore = 0;
+        for (size_t heatmapId = 1; heatmapId < heatMaps.size(); heatmapId++) {
+            peaksBefore += static_cast<int>(peaksFromHeatMap[heatmapId - 1].size());
+            for (auto& peak : peaksFromHeatMap[heatmapId]) {
+                peak.id += peaksBefore;
+            }
+        }
+        benchmark::DoNotOptimize(groupPeaksToPoses(peaksFromHeatMap,
+                                                   pafs,
+                                                   keypointsNumber,
+                                                   midPointsScoreThreshold,
+                                                   foundMidPointsRatioThreshold,
+                                                   minJointsNumber,
+                                                   minSubsetScore));
+    }
+}
+BENCHMARK(BM_OpenPoseExtractPoses)->Arg(1)->Arg(5)->Arg(20);
+}  // namespace
@@ -0,0 +1,81 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <stddef.h>
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <opencv2/core.hpp>
+
+#include <utils/image_utils.h>
+#include <utils/kuhn_munkres.hpp>
+#include <utils/nms.hpp>
+
+#include "alloc_counter.hpp"
+
+namespace {
+/** Candidates of a detector output: every object is found by several overlapping boxes around it **/
+NmsBoxes makeCandidates(int objects, int boxesPerObject, int classes) {
+    cv::RNG rng(0xC0FFEE);
+    NmsBoxes boxes;
+    boxes.reserve(static_cast<size_t>(objects * boxesPerObject));
+    for (int i = 0; i < objects; ++i) {
+        const float w = rng.uniform(20.f, 200.f), h = rng.uniform(20.f, 200.f);
+        const float x = rng.uniform(0.f, 1920.f - w), y = rng.uniform(0.f, 1080.f - h);
+        const int classId = rng.uniform(0, classes);
+        for (int j = 0; j < boxesPerObject; ++j) {
+            const float dx = rng.uniform(-0.1f, 0.1f) * w, dy = rng.uniform(-0.1f, 0.1f) * h;
+            boxes.add(x + dx, y + dy, x + dx + w, y + dy + h, rng.uniform(0.05f, 1.f), classId);
+        }
+    }
+    return boxes;
+}
+
+void BM_Nms(benchmark::State& state) {
+    const NmsBoxes boxes = makeCandidates(static_cast<int>(state.range(0)), 8, 20);
+    NmsParams params(0.5f);
+    params.method = static_cast<NmsMethod>(state.range(1));
+    params.perClass = true;
+    AllocationsCounter allocations(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(nms(boxes, params));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(boxes.size()));
+}
+BENCHMARK(BM_Nms)->ArgsProduct({{4, 32, 256}, {static_cast<int>(NmsMethod::Hard), static_cast<int>(NmsMethod::Soft)}});
+
+/** Distances between the tracks and the detections of a scene, a detection is close to one track only **/
+void BM_KuhnMunkres(benchmark::State& state) {
+    const int tracks = static_cast<int>(state.range(0));
+    const int detections = tracks + tracks / 4;
+    cv::RNG rng(0xC0FFEE);
+    cv::Mat dissimilarity(tracks, detections, CV_32F);
+    rng.fill(dissimilarity, cv::RNG::UNIFORM, 0.5f, 1.f);
+    for (int i = 0; i < tracks; ++i) {
+        dissimilarity.at<float>(i, rng.uniform(0, detections)) = rng.uniform(0.f, 0.2f);
+    }
+    KuhnMunkres solver(state.range(1) != 0);
+    AllocationsCounter allocations(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(solver.Solve(dissimilarity));
+    }
+}
+BENCHMARK(BM_KuhnMunkres)->ArgsProduct({{4, 16, 64}, {0, 1}});
+
+void BM_ResizeImageExt(benchmark::State& state) {
+    cv::Mat frame(1080, 1920, CV_8UC3);
+    cv::randu(frame, 0, 255);
+    const int side = static_cast<int>(state.range(0));
+    const auto mode = static_cast<RESIZE_MODE>(state.range(1));
+    cv::Mat dst(side, side, CV_8UC3);
+    AllocationsCounter allocations(state);
+    for (auto _ : state) {
+        resizeImageExt(frame, dst, mode);
+        benchmark::DoNotOptimize(dst.data);
+    }
+}
+BENCHMARK(BM_ResizeImageExt)
+    ->ArgsProduct({{224, 416, 640}, {RESIZE_FILL, RESIZE_KEEP_ASPECT, RESIZE_KEEP_ASPECT_LETTERBOX}});
+}  // namespace
@@ -0,0 +1,69 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+/**
+ * @brief a header file for CTC decoding of network outputs shared by the demos
+ * @file ctc_decoder.hpp
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class CtcDecoderState;
+class ScorerBase;
+
+/// Greedy and prefix beam search CTC decoders over raw (not softmaxed) per-frame logits.
+/// The beam search runs on the PathTrie decoder core of ctcdecode-numpy, optionally with a KenLM language model.
+/// The object keeps its buffers and the prefix trie between calls, so reuse it to decode many sequences.
+/// It is not thread safe, use one object per thread.
+class CtcDecoder {
+public:
+    /// @param alphabet - symbols corresponding to the classes of the network output
+    /// @param blankIndex - index of the CTC blank in alphabet
+    /// @param beamSize - number of prefixes kept by beamSearchDecode()
+    /// @param lmPath - KenLM v5 binary language model for beamSearchDecode(), empty for no language model.
+    ///                 Words are separated by the " " symbol of the alphabet.
+    CtcDecoder(const std::vector<std::string>& alphabet,
+               size_t blankIndex,
+               size_t beamSize,
+               const std::string& lmPath = "",
+               double lmAlpha = 0.75,
+               double lmBeta = 1.85);
+    ~CtcDecoder();
+
+    /// @param logits - numFrames x alphabet.size() row-major array
+    /// @param conf - receives the probability of the best path
+    /// @returns the collapsed best path without blanks, as indices into alphabet
+    std::vector<int> greedyDecode(const float* logits, size_t numFrames, double* conf) const;
+
+    /// @param logits - numFrames x alphabet.size() row-major array
+    /// @param conf - receives the probability of the best prefix (and its language model score, if any)
+    /// @returns the best prefix, as indices into alphabet
+    std::vector<int> beamSearchDecode(const float* logits, size_t numFrames, double* conf);
+
+    std::string toString(const std::vector<int>& tokens) const;
+
+    const std::vector<std::string>& getAlphabet() const {
+        return alphabet;
+    }
+    size_t getBlankIndex() const {
+        return blankIndex;
+    }
+    size_t getBeamSize() const {
+        return beamSize;
+    }
+
+private:
+    std::vector<std::string> alphabet;
+    size_t blankIndex;
+    size_t beamSize;
+    std::unique_ptr<ScorerBase> scorer;
+    std::unique_ptr<CtcDecoderState> state;
+    std::vector<float> logProbs;  // log-softmax of the last beamSearchDecode() input
+};
@@ -0,0 +1,120 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "ctc_decoder/ctc_decoder.hpp"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ctc_beam_search_decoder.h"
+#include "scorer_yoklm.h"
+
+namespace {
+// Finds the argmax of a frame and the sum of exp(logit - max) over it in a single pass,
+// which is all the greedy decoder needs from the softmax
+double maxAndExpSum(const float* frame, size_t numClasses, size_t* argmax) {
+    size_t best = 0;
+    float maxVal = frame[0];
+    double sum = 1.;
+    for (size_t i = 1; i < numClasses; ++i) {
+        if (frame[i] > maxVal) {
+            sum = sum * std::exp(static_cast<double>(maxVal) - frame[i]) + 1.;
+            maxVal = frame[i];
+            best = i;
+        } else {
+            sum += std::exp(static_cast<double>(frame[i]) - maxVal);
+        }
+    }
+    *argmax = best;
+    return sum;
+}
+}  // namespace
+
+CtcDecoder::CtcDecoder(const std::vector<std::string>& alphabet,
+                       size_t blankIndex,
+                       size_t beamSize,
+                       const std::string& lmPath,
+                       double lmAlpha,
+                       double lmBeta)
+    : alphabet(alphabet),
+      blankIndex(blankIndex),
+      beamSize(beamSize),
+      state(new CtcDecoderState) {
+    if (alphabet.empty() || blankIndex >= alphabet.size()) {
+        throw std::invalid_argument("CtcDecoder: blank index is out of the alphabet");
+    }
+    if (beamSize == 0) {
+        throw std::invalid_argument("CtcDecoder: beam size must be positive");
+    }
+    if (!lmPath.empty()) {
+        scorer.reset(new ScorerYoklm(lmAlpha, lmBeta, lmPath, alphabet));
+    }
+    state->init(alphabet, blankIndex, beamSize, scorer.get());
+    // every class is tried at every frame, same as in the textbook prefix beam search
+    state->set_config("cutoff_top_n", static_cast<double>(alphabet.size()), true);
+}
+
+CtcDecoder::~CtcDecoder() = default;
+
+std::vector<int> CtcDecoder::greedyDecode(const float* logits, size_t numFrames, double* conf) const {
+    const size_t numClasses = alphabet.size();
+    std::vector<int> tokens;
+    size_t prev = blankIndex;
+    double prob = 1.;
+    for (size_t t = 0; t < numFrames; ++t) {
+        size_t argmax;
+        prob /= maxAndExpSum(logits + t * numClasses, numClasses, &argmax);
+        if (argmax != blankIndex && argmax != prev) {
+            tokens.push_back(static_cast<int>(argmax));
+        }
+        prev = argmax;
+    }
+    *conf = prob;
+    return tokens;
+}
+
+std::vector<int> CtcDecoder::beamSearchDecode(const float* logits, size_t numFrames, double* conf) {
+    const size_t numClasses = alphabet.size();
+    logProbs.resize(numFrames * numClasses);
+    for (size_t t = 0; t < numFrames; ++t) {
+        const float* frame = logits + t * numClasses;
+        float* out = logProbs.data() + t * numClasses;
+        const float maxVal = *std::max_element(frame, frame + numClasses);
+        double sum = 0.;
+        for (size_t i = 0; i < numClasses; ++i) {
+            sum += std::exp(static_cast<double>(frame[i]) - maxVal);
+        }
+        const float logSum = maxVal + static_cast<float>(std::log(sum));
+        for (size_t i = 0; i < numClasses; ++i) {
+            out[i] = frame[i] - logSum;
+        }
+    }
+
+    state->new_sequence();
+    state->append(logProbs.data(), numFrames, numClasses, 1, true);
+    std::vector<std::pair<float, Output>> candidates = state->decode(1);
+    if (candidates.empty()) {
+        *conf = 0.;
+        return {};
+    }
+    // the score is -log of the prefix probability
+    *conf = std::exp(-static_cast<double>(candidates[0].first));
+    return std::move(candidates[0].second.tokens);
+}
+
+std::string CtcDecoder::toString(const std::vector<int>& tokens) const {
+    std::string result;
+    for (int token : tokens) {
+        result += alphabet[token];
+    }
+    return result;
+}
@@ -0,0 +1,93 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+#include <stddef.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// Anchors of a detection model stored by components in the form the predicted deltas are decoded with
+struct AnchorTable {
+    void resize(size_t size) {
+        xCenters.resize(size);
+        yCenters.resize(size);
+        widths.resize(size);
+        heights.resize(size);
+    }
+
+    size_t size() const {
+        return xCenters.size();
+    }
+
+    /// Stores an anchor which provides getXCenter(), getYCenter(), getWidth() and getHeight()
+    template <typename Anchor>
+    void set(size_t index, const Anchor& anchor) {
+        xCenters[index] = anchor.getXCenter();
+        yCenters[index] = anchor.getYCenter();
+        widths[index] = anchor.getWidth();
+        heights[index] = anchor.getHeight();
+    }
+
+    template <typename Anchor>
+    void add(const Anchor& anchor) {
+        resize(size() + 1);
+        set(size() - 1, anchor);
+    }
+
+    std::vector<float> xCenters;
+    std::vector<float> yCenters;
+    std::vector<float> widths;
+    std::vector<float> heights;
+};
+
+/// Returns the anchor table stored for the key or builds it with build() if there is none. Tables are shared by all
+/// the model instances, so the models with the same input size keep a single copy, which is freed together with the
+/// last model using it.
+/// @param key - has to describe everything the anchors depend on, e.g. the model type and the input size
+std::shared_ptr<const AnchorTable> getSharedAnchorTable(const std::string& key,
+                                                        const std::function<void(AnchorTable&)>& build);
+
+/// Calls visit(i) for every i in [0, count) for which isValid(scores[i * step]) is true, in increasing order of i.
+/// The scores are checked by blocks: the checks of a block don't depend on each other, so the compiler vectorizes them
+/// and blocks without valid scores, which are most of the detection outputs, are skipped without branching.
+template <typename IsValid, typename Visitor>
+void forEachValidScore(const float* scores, size_t count, size_t step, IsValid isValid, Visitor visit) {
+    const size_t blockSize = 16;
+    size_t i = 0;
+    for (; i + blockSize <= count; i += blockSize) {
+        const float* block = scores + i * step;
+        bool hasValid = false;
+        for (size_t j = 0; j < blockSize; ++j) {
+            hasValid |= isValid(block[j * step]);
+        }
+        if (!hasValid) {
+            continue;
+        }
+        for (size_t j = 0; j < blockSize; ++j) {
+            if (isValid(block[j * step])) {
+                visit(i + j);
+            }
+        }
+    }
+    for (; i < count; ++i) {
+        if (isValid(scores[i * step])) {
+            visit(i);
+        }
+    }
+}
@@ -16,7 +16,9 @@
 
 #pragma once
 #include <stddef.h>
+#include <stdint.h>
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -37,6 +39,15 @@ class Pose {
 public:
     explicit Pose(size_t numJoints) : peaks(numJoints) {}
 
+    /// Makes the pose empty keeping the storage of its peaks
+    void reset() {
+        std::fill(peaks.begin(), peaks.end(), Peak());
+        poseCenter = cv::Point2f(0.f, 0.f);
+        validPointsNum = 0;
+        poseTag = 0;
+        sum = 0;
+    }
+
     void add(size_t index, Peak peak) {
         peaks[index] = peak;
         sum += peak.score;
@@ -75,20 +86,73 @@ private:
     float sum = 0;
 };
 
+/// Storage of the decoder which is kept between frames, so decoding of a frame doesn't allocate memory once the
+/// buffers have grown to the size of the scene
+struct AssociativeEmbeddingBuffers {
+    /// Prepares the buffers for the peaks of a new frame
+    void reset(size_t numJoints, size_t maxNumPeople);
+
+    Peak* jointPeaks(size_t jointId) {
+        return peaks.data() + jointId * maxNumPeople;
+    }
+
+    /// Peaks of joint jointId take maxNumPeople slots starting from jointId * maxNumPeople
+    std::vector<Peak> peaks;
+    std::vector<size_t> peaksNum;
+    size_t maxNumPeople = 0;
+
+    /// Only first posesNum poses are valid, the rest keep their storage for next frames
+    std::vector<Pose> poses;
+    size_t posesNum = 0;
+
+    /// Per joint data of matchByTag()
+    std::vector<float> tags;
+    std::vector<float> scores;
+    std::vector<float> peaksX;
+    std::vector<float> peaksY;
+    std::vector<float> dists;
+    std::vector<float> tagsDiff;
+    std::vector<float> matchingCost;
+};
+
+/// Finds maxNumPeople highest peaks above detectionThreshold on the heat map of joint jointId. Peaks of different
+/// joints are stored separately, so the function can be called for all the joints in parallel.
 void findPeaks(const std::vector<cv::Mat>& nmsHeatMaps,
                const std::vector<cv::Mat>& aembdsMaps,
-               std::vector<std::vector<Peak>>& allPeaks,
+               AssociativeEmbeddingBuffers& buffers,
                size_t jointId,
                size_t maxNumPeople,
                float detectionThreshold);
 
-std::vector<Pose> matchByTag(std::vector<std::vector<Peak>>& allPeaks,
-                             size_t maxNumPeople,
-                             size_t numJoints,
-                             float tagThreshold);
+/// Takes the peaks of joint jointId from the candidates found on the device, which come in descending order of the
+/// scores, like findPeaks() does.
+/// @param indices - positions of the candidates in the heat map, row * mapWidth + col
+/// @param tags - embeddings sampled at the candidates
+void collectPeaks(const float* scores,
+                  const int32_t* indices,
+                  const float* tags,
+                  size_t candidatesNum,
+                  int mapWidth,
+                  AssociativeEmbeddingBuffers& buffers,
+                  size_t jointId,
+                  size_t maxNumPeople,
+                  float detectionThreshold);
+
+/// Groups the peaks found by findPeaks() into buffers.poses
+void matchByTag(AssociativeEmbeddingBuffers& buffers, size_t maxNumPeople, size_t numJoints, float tagThreshold);
 
 void adjustAndRefine(std::vector<Pose>& allPoses,
                      const std::vector<cv::Mat>& heatMaps,
                      const std::vector<cv::Mat>& aembdsMaps,
                      int poseId,
                      float delta);
+
+/// Adjusts the peaks of the pose like adjustAndRefine() does, by the heat map values to the left, right, above and
+/// below of the candidates of collectPeaks(). Missing joints of the pose aren't refined, as it needs the whole maps.
+/// @param indices, neighbours - candidates of all joints, candidatesNum per joint
+void adjustPeaks(Pose& pose,
+                 const int32_t* indices,
+                 const float* neighbours,
+                 size_t candidatesNum,
+                 const cv::Size& mapSize,
+                 float delta);
@@ -46,6 +46,9 @@ public:
                         const std::string& layout = "");
 
     std::unique_ptr<ResultBase> postprocess(InferenceResult& infResult) override;
+    std::unique_ptr<ModelBase> clone() const override {
+        return cloneAs(*this);
+    }
 
     static std::vector<std::string> loadLabels(const std::string& labelFilename);
 
@@ -17,6 +17,7 @@
 #pragma once
 #include <stddef.h>
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -41,11 +42,26 @@ public:
 
     static std::vector<std::string> loadLabels(const std::string& labelFilename);
 
+    /// Enables interning of labels. Detected objects carry only labelID and their label strings are left empty, so
+    /// no strings are copied per detection. Labels are resolved by DetectionResult::getLabelName() from the label
+    /// table shared by the model and its results, which is available regardless of this option.
+    void setLabelsInterning(bool interning) {
+        labelsInterning = interning;
+    }
+
+    void onLoadCompleted(const std::vector<ov::InferRequest>& requests) override;
+
 protected:
     float confidenceThreshold;
     std::vector<std::string> labels;
+    /// Immutable copy of labels made when loading is completed, once models finished adjusting them
+    std::shared_ptr<const std::vector<std::string>> labelsTable;
+    bool labelsInterning = false;
 
     std::string getLabelName(int labelID) {
+        if (labelsInterning) {
+            return std::string();
+        }
         return (size_t)labelID < labels.size() ? labels[labelID] : std::string("Label #") + std::to_string(labelID);
     }
 };
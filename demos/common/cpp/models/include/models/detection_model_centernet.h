@@ -15,10 +15,16 @@
 */
 
 #pragma once
+#include <stddef.h>
+
+#include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include <opencv2/core.hpp>
+
 #include "models/detection_model.h"
 
 namespace ov {
@@ -46,14 +52,50 @@ public:
         }
     };
     static const int INIT_VECTOR_SIZE = 200;
+    /// Maximal number of detections of a frame, the highest peaks of the heat map are kept like in the reference
+    /// CenterNet decoder
+    static const size_t MAX_DETECTIONS_NUM = 100;
 
     ModelCenterNet(const std::string& modelFileName,
                    float confidenceThreshold,
                    const std::vector<std::string>& labels = std::vector<std::string>(),
                    const std::string& layout = "");
     std::shared_ptr<InternalModelData> preprocess(const InputData& inputData, ov::InferRequest& request) override;
+    std::shared_ptr<InternalModelData> preprocessBatchItem(const InputData& inputData,
+                                                           ov::InferRequest& request,
+                                                           size_t batchIdx) override {
+        return ModelBase::preprocessBatchItem(inputData, request, batchIdx);
+    }
     std::unique_ptr<ResultBase> postprocess(InferenceResult& infResult) override;
+    std::unique_ptr<ModelBase> clone() const override {
+        return cloneAs(*this);
+    }
+
+    /// Makes the model take every frame in the input size of the aspect ratio (width / height) closest to the frame's
+    /// one, at the area of the model input, so letterboxing pads wide and portrait frames less. The model is reshaped
+    /// to dynamic spatial dims and compiled once, the device should support dynamic shapes, e.g. CPU. Batched
+    /// inference and preallocated inputs aren't supported. Should be called before the model is loaded.
+    /// Example: {16.0 / 9, 4.0 / 3, 1, 9.0 / 16}
+    void setAspectBuckets(const std::vector<double>& aspectRatios);
 
 protected:
+    bool supportsDevicePreprocessing() const override {
+        return false;  // preprocess() resizes images itself
+    }
     void prepareInputsOutputs(std::shared_ptr<ov::Model>& model) override;
+    /// @returns the input shape of every bucket, if there are buckets
+    std::vector<std::map<std::string, ov::Shape>> getWarmupShapes() const override;
+
+    /// @returns the input size of the bucket for the image, or the model input size if there are no buckets
+    cv::Size getInputSize(const cv::Size& imageSize) const;
+
+    /// Aspect ratios requested by setAspectBuckets() and the input sizes of them
+    std::vector<double> aspectRatios;
+    std::vector<cv::Size> bucketSizes;
+    /// Sizes of the images last letterboxed into input tensors and sizes of the tensors, keyed by memory of the tensors
+    std::map<const void*, std::pair<cv::Size, cv::Size>> letterboxedSizes;
+    /// Buffers of postprocess() kept between frames
+    std::vector<std::pair<size_t, float>> scores;
+    std::vector<float> columnsMax;
+    std::vector<BBox> boxes;
 };
@@ -27,6 +27,7 @@
 namespace ov {
 class Model;
 }  // namespace ov
+struct AnchorTable;
 struct InferenceResult;
 struct ResultBase;
 
@@ -59,6 +60,9 @@ public:
                    float boxIOUThreshold,
                    const std::string& layout = "");
     std::unique_ptr<ResultBase> postprocess(InferenceResult& infResult) override;
+    std::unique_ptr<ModelBase> clone() const override {
+        return cloneAs(*this);
+    }
 
 protected:
     size_t maxProposalsCount;
@@ -66,7 +70,14 @@ protected:
     const std::vector<float> variance;
     const std::vector<int> steps;
     const std::vector<std::vector<int>> minSizes;
-    std::vector<Anchor> anchors;
+    /// Prior boxes, shared with other models of the same input size
+    std::shared_ptr<const AnchorTable> anchors;
+
+    /// Buffers of postprocess() kept between frames
+    std::vector<size_t> validIndices;
+    std::vector<float> scores;
+    std::vector<Anchor> boxes;
+
     void prepareInputsOutputs(std::shared_ptr<ov::Model>& model) override;
-    void priorBoxes(const std::vector<std::pair<size_t, size_t>>& featureMaps);
+    void priorBoxes(const std::vector<std::pair<size_t, size_t>>& featureMaps, AnchorTable& table) const;
 };
@@ -20,11 +20,14 @@
 #include <string>
 #include <vector>
 
+#include <opencv2/core.hpp>
+
 #include "models/detection_model.h"
 
 namespace ov {
 class Model;
 }  // namespace ov
+struct AnchorTable;
 struct InferenceResult;
 struct ResultBase;
 
@@ -65,6 +68,9 @@ public:
                     float boxIOUThreshold,
                     const std::string& layout = "");
     std::unique_ptr<ResultBase> postprocess(InferenceResult& infResult) override;
+    std::unique_ptr<ModelBase> clone() const override {
+        return cloneAs(*this);
+    }
 
 protected:
     struct AnchorCfgLine {
@@ -82,10 +88,19 @@ protected:
 
     enum OutputType { OUT_BOXES, OUT_SCORES, OUT_LANDMARKS, OUT_MASKSCORES, OUT_MAX };
 
-    std::vector<std::string> separateOutputsNames[OUT_MAX];
+    /// Indices of outputs of every type in outputsNames, ordered by the size of the output
+    std::vector<size_t> separateOutputsIndices[OUT_MAX];
     const std::vector<AnchorCfgLine> anchorCfg;
     std::map<int, std::vector<Anchor>> anchorsFpn;
-    std::vector<std::vector<Anchor>> anchors;
+    /// Anchors of every output level, shared with other models of the same input size
+    std::vector<std::shared_ptr<const AnchorTable>> anchors;
+
+    /// Buffers of postprocess() kept between frames
+    std::vector<size_t> validIndices;
+    std::vector<float> scores;
+    std::vector<Anchor> boxes;
+    std::vector<cv::Point2f> landmarks;
+    std::vector<float> masks;
 
     void generateAnchorsFpn();
     void prepareInputsOutputs(std::shared_ptr<ov::Model>& model) override;
@@ -74,6 +74,9 @@ public:
                       float boxIOUThreshold,
                       const std::string& layout = "");
     std::unique_ptr<ResultBase> postprocess(InferenceResult& infResult) override;
+    std::unique_ptr<ModelBase> clone() const override {
+        return cloneAs(*this);
+    }
 
 protected:
     size_t landmarksNum;
@@ -50,14 +50,26 @@ public:
              const std::string& layout = "");
 
     std::shared_ptr<InternalModelData> preprocess(const InputData& inputData, ov::InferRequest& request) override;
+    std::shared_ptr<InternalModelData> preprocessBatchItem(const InputData& inputData,
+                                                           ov::InferRequest& request,
+                                                           size_t batchIdx) override {
+        return ModelBase::preprocessBatchItem(inputData, request, batchIdx);
+    }
     std::unique_ptr<ResultBase> postprocess(InferenceResult& infResult) override;
+    std::unique_ptr<ModelBase> clone() const override {
+        return cloneAs(*this);
+    }
 
 protected:
     std::unique_ptr<ResultBase> postprocessSingleOutput(InferenceResult& infResult);
+    /// Decodes boxes of boxSize elements, with confidences in the separate scores output if hasScores is true or
+    /// in the 5th element of boxes otherwise. The instance matching the outputs is picked by prepareMultipleOutputs().
+    template <size_t boxSize, bool hasScores>
     std::unique_ptr<ResultBase> postprocessMultipleOutputs(InferenceResult& infResult);
     void prepareInputsOutputs(std::shared_ptr<ov::Model>& model) override;
     void prepareSingleOutput(std::shared_ptr<ov::Model>& model);
     void prepareMultipleOutputs(std::shared_ptr<ov::Model>& model);
     size_t objectSize = 0;
     size_t detectionsNumId = 0;
+    std::unique_ptr<ResultBase> (ModelSSD::*multipleOutputsDecoder)(InferenceResult& infResult) = nullptr;
 };
@@ -23,12 +23,14 @@
 #include <string>
 #include <vector>
 
+#include <opencv2/core.hpp>
 #include <openvino/op/region_yolo.hpp>
 #include <openvino/openvino.hpp>
 
 #include "models/detection_model.h"
 
 struct DetectedObject;
+class OutputsData;
 struct InferenceResult;
 struct ResultBase;
 
@@ -81,10 +83,26 @@ public:
               const std::string& layout = "");
 
     std::unique_ptr<ResultBase> postprocess(InferenceResult& infResult) override;
+    std::unique_ptr<ModelBase> clone() const override {
+        return cloneAs(*this);
+    }
+
+    /// Detects objects in one slot of batched output tensors, so demos running the model prepared by prepareModel()
+    /// themselves share decoding and NMS of postprocess(). Boxes are scaled to imageSize.
+    /// @param request - request whose output tensors hold the results
+    /// @param batchIdx - index of the slot in the batch
+    std::vector<DetectedObject> detectInBatchItem(ov::InferRequest& request,
+                                                  size_t batchIdx,
+                                                  const cv::Size& imageSize);
 
 protected:
     void prepareInputsOutputs(std::shared_ptr<ov::Model>& model) override;
 
+    /// Decodes the outputs of a single image and applies NMS to the boxes
+    std::vector<DetectedObject> detectObjects(const OutputsData& outputs,
+                                              unsigned long imageHeight,
+                                              unsigned long imageWidth);
+
     void parseYOLOOutput(const std::string& output_name,
                          const ov::Tensor& tensor,
                          const unsigned long resized_im_h,
@@ -92,9 +110,35 @@ protected:
                          const unsigned long original_im_h,
                          const unsigned long original_im_w,
                          std::vector<DetectedObject>& objects);
+    /// Decodes boxes of the region from the output data of element type T. The kernel is instantiated for every
+    /// decoding a YOLO version needs and for common numbers of classes, classesNum 0 reads the number from the
+    /// region. See selectRegionParser().
+    template <typename T, bool isSigmoidApplied, bool isYolof, bool hasObjectness, size_t classesNum>
+    void parseYOLORegion(const void* data,
+                         const Region& region,
+                         int sideH,
+                         int sideW,
+                         unsigned long scaleH,
+                         unsigned long scaleW,
+                         unsigned long original_im_h,
+                         unsigned long original_im_w,
+                         std::vector<DetectedObject>& objects);
+    using RegionParser = void (ModelYolo::*)(const void* data,
+                                             const Region& region,
+                                             int sideH,
+                                             int sideW,
+                                             unsigned long scaleH,
+                                             unsigned long scaleW,
+                                             unsigned long original_im_h,
+                                             unsigned long original_im_w,
+                                             std::vector<DetectedObject>& objects);
+    template <typename T, bool isSigmoidApplied, bool isYolof, bool hasObjectness>
+    static RegionParser getRegionParser(size_t classesNum);
+    /// Picks the kernel matching the YOLO version, the outputs precision and the number of classes of the regions,
+    /// so postprocess() doesn't branch on them for every element
+    void selectRegionParser();
 
     static int calculateEntryIndex(int entriesNum, int lcoords, size_t lclasses, int location, int entry);
-    static double intersectionOverUnion(const DetectedObject& o1, const DetectedObject& o2);
 
     std::map<std::string, Region> regions;
     double boxIOUThreshold;
@@ -104,4 +148,5 @@ protected:
     const std::vector<float> presetAnchors;
     const std::vector<int64_t> presetMasks;
     ov::Layout yoloRegionLayout = "NCHW";
+    RegionParser regionParser = nullptr;
 };
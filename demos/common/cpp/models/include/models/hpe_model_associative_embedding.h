@@ -30,6 +30,7 @@ class InferRequest;
 class Model;
 class Shape;
 }  // namespace ov
+struct AssociativeEmbeddingBuffers;
 struct HumanPose;
 struct InferenceResult;
 struct InputData;
@@ -52,12 +53,26 @@ public:
                             const std::string& layout = "",
                             float delta = 0.0,
                             RESIZE_MODE resizeMode = RESIZE_KEEP_ASPECT);
+    /// Copies parameters of the model, the copy gets its own buffers for grouping of the peaks
+    HpeAssociativeEmbedding(const HpeAssociativeEmbedding& other);
+    ~HpeAssociativeEmbedding() override;
 
     std::unique_ptr<ResultBase> postprocess(InferenceResult& infResult) override;
+    std::unique_ptr<ModelBase> clone() const override {
+        return cloneAs(*this);
+    }
 
     std::shared_ptr<InternalModelData> preprocess(const InputData& inputData, ov::InferRequest& request) override;
+    std::shared_ptr<InternalModelData> preprocessBatchItem(const InputData& inputData,
+                                                           ov::InferRequest& request,
+                                                           size_t batchIdx) override {
+        return ModelBase::preprocessBatchItem(inputData, request, batchIdx);
+    }
 
 protected:
+    bool supportsDevicePreprocessing() const override {
+        return false;  // preprocess() resizes images itself
+    }
     void prepareInputsOutputs(std::shared_ptr<ov::Model>& model) override;
 
     cv::Size inputLayerSize;
@@ -67,9 +82,14 @@ protected:
     float delta;
     RESIZE_MODE resizeMode;
 
-    std::string embeddingsTensorName;
-    std::string heatmapsTensorName;
-    std::string nmsHeatmapsTensorName;
+    /// Indices of the outputs in outputsNames
+    size_t embeddingsTensorIdx = 0;
+    size_t heatmapsTensorIdx = 0;
+    size_t nmsHeatmapsTensorIdx = 0;
+
+    std::unique_ptr<AssociativeEmbeddingBuffers> buffers;
+    /// Size of the heat maps the device searches peaks in, see setDevicePostprocessing()
+    cv::Size peaksMapSize;
 
     static const int numJoints = 17;
     static const int stride = 32;
@@ -86,5 +106,7 @@ protected:
 
     std::vector<HumanPose> extractPoses(std::vector<cv::Mat>& heatMaps,
                                         const std::vector<cv::Mat>& aembdsMaps,
-                                        const std::vector<cv::Mat>& nmsHeatMaps) const;
+                                        const std::vector<cv::Mat>& nmsHeatMaps);
+    /// Groups the peaks found on the device to poses
+    std::vector<HumanPose> extractDevicePoses(const InferenceResult& infResult);
 };
@@ -30,6 +30,7 @@ class InferRequest;
 class Model;
 }  // namespace ov
 struct HumanPose;
+struct Peak;
 struct InferenceResult;
 struct InputData;
 struct InternalModelData;
@@ -43,19 +44,34 @@ public:
     /// @param targetSize - the height used for model reshaping.
     /// @param confidenceThreshold - threshold to eliminate low-confidence keypoints.
     /// @param layout - model input layout
+    /// @param decodeAtNativeResolution - if true, peaks and limbs are found on the output feature maps instead of
+    /// the maps upsampled by upsampleRatio, and the peaks are refined to sub-pixel positions. It saves the upsampling,
+    /// which dominates the decoding, and makes the search upsampleRatio^2 times cheaper for a small loss of accuracy.
     HPEOpenPose(const std::string& modelFileName,
                 double aspectRatio,
                 int targetSize,
                 float confidenceThreshold,
-                const std::string& layout = "");
+                const std::string& layout = "",
+                bool decodeAtNativeResolution = false);
 
     std::unique_ptr<ResultBase> postprocess(InferenceResult& infResult) override;
+    std::unique_ptr<ModelBase> clone() const override {
+        return cloneAs(*this);
+    }
 
     std::shared_ptr<InternalModelData> preprocess(const InputData& inputData, ov::InferRequest& request) override;
+    std::shared_ptr<InternalModelData> preprocessBatchItem(const InputData& inputData,
+                                                           ov::InferRequest& request,
+                                                           size_t batchIdx) override {
+        return ModelBase::preprocessBatchItem(inputData, request, batchIdx);
+    }
 
     static const size_t keypointsNumber = 18;
 
 protected:
+    bool supportsDevicePreprocessing() const override {
+        return false;  // preprocess() resizes images itself
+    }
     void prepareInputsOutputs(std::shared_ptr<ov::Model>& model) override;
 
     static const int minJointsNumber = 3;
@@ -66,12 +82,22 @@ protected:
     static const float midPointsScoreThreshold;
     static const float foundMidPointsRatioThreshold;
     static const float minSubsetScore;
+    /// Candidate peaks of every heat map found on the device, see setDevicePostprocessing()
+    static const size_t maxPeaksNum = 64;
     cv::Size inputLayerSize;
     double aspectRatio;
     int targetSize;
     float confidenceThreshold;
+    bool decodeAtNativeResolution;
+    /// Size of the heat maps the device searches peaks in
+    cv::Size peaksMapSize;
 
     std::vector<HumanPose> extractPoses(const std::vector<cv::Mat>& heatMaps, const std::vector<cv::Mat>& pafs) const;
+    /// Numbers the peaks through all heat maps and groups them to poses by the pafs
+    std::vector<HumanPose> groupPoses(std::vector<std::vector<Peak>>& peaksFromHeatMap,
+                                      const std::vector<cv::Mat>& pafs) const;
+    /// Selects the peaks among the candidates found on the device
+    std::vector<std::vector<Peak>> selectDevicePeaks(const InferenceResult& infResult) const;
     void resizeFeatureMaps(std::vector<cv::Mat>& featureMaps) const;
 
     void changeInputSize(std::shared_ptr<ov::Model>& model);
@@ -17,13 +17,23 @@
 #pragma once
 #include <stddef.h>
 
+#include <stdint.h>
+
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
+
+#include <opencv2/core.hpp>
 
 #include "models/model_base.h"
 
 namespace ov {
 class InferRequest;
+class Tensor;
+namespace preprocess {
+class PrePostProcessor;
+}  // namespace preprocess
 }  // namespace ov
 struct InputData;
 struct InternalModelData;
@@ -37,9 +47,125 @@ public:
     ImageModel(const std::string& modelFileName, bool useAutoResize, const std::string& layout = "");
 
     std::shared_ptr<InternalModelData> preprocess(const InputData& inputData, ov::InferRequest& request) override;
+    /// Resizes the image to the model input size and copies it into the batch slot of the first input tensor.
+    /// Derived classes which have their own preprocess() should override this function as well.
+    std::shared_ptr<InternalModelData> preprocessBatchItem(const InputData& inputData,
+                                                           ov::InferRequest& request,
+                                                           size_t batchIdx) override;
+    /// Checks the input tensor once and fills its slots by images of the inputs.
+    std::vector<std::shared_ptr<InternalModelData>> preprocessBatch(const std::vector<const InputData*>& inputs,
+                                                                    ov::InferRequest& request) override;
+    void onLoadCompleted(const std::vector<ov::InferRequest>& requests) override;
+
+    /// Enables writing of preprocessed images straight into input tensors allocated once per infer request in
+    /// onLoadCompleted(), instead of wrapping a newly allocated image into a new tensor for every frame.
+    /// Should be called before the model is loaded. Not supported together with auto resize.
+    /// Input transform (if any) is applied after resize in this mode.
+    void setPreallocatedInputs(bool preallocated);
+
+    /// Chooses memory of the input tensors: "" - a new tensor wraps every preprocessed image, "host" - preallocated
+    /// inputs, "device" - preallocated inputs in host memory of the device's remote context, e.g. USM host memory of
+    /// GPU, which the device reads without a staging copy. Falls back to "host" if the device has no such memory.
+    /// Should be called before the model is loaded.
+    void setInputsMemory(const std::string& memory);
+
+    /// Embeds resize to the model input size, color conversion and the input transform into the model, so the CPU
+    /// only wraps frames into input tensors and the inference device does all per-pixel work. Replaces auto resize,
+    /// letterboxing isn't supported, so it throws for models which prepare inputs in their own way. Should be called
+    /// before the model is loaded.
+    /// @param nv12Input - if true, frames are NV12 images in one plane: CV_8UC1 Mat of height * 3 / 2 rows, e.g.
+    /// produced by hardware decoders, otherwise BGR
+    void setDevicePreprocessing(bool onDevice, bool nv12Input = false);
+
+    /// Makes the models which support it append their postprocessing to the model, so it is run on the inference
+    /// device and smaller outputs are transferred: argmax for segmentation, conversion to NHWC u8 image for
+    /// image-to-image models, search of heat map peaks for CenterNet, OpenPose and Associative Embedding models,
+    /// which transfer the highest peaks and the maps sampled at them instead of the maps. Resize to the input image
+    /// size is still done by postprocess(), because it depends on the frame. Should be called before the model is
+    /// loaded.
+    void setDevicePostprocessing(bool onDevice) {
+        devicePostprocessing = onDevice;
+    }
+
+    /// Makes the models which support it (YOLO, segmentation, OpenPose) get their outputs in f16 instead of f32 and
+    /// decode them in that precision, so half as much output data is transferred from the inference device and read
+    /// by postprocess(). Outputs computed on the device by setDevicePostprocessing() keep their precision. Should be
+    /// called before the model is loaded.
+    void setHalfPrecisionOutputs(bool halfPrecision) {
+        halfPrecisionOutputs = halfPrecision;
+    }
+
+    /// @returns number of input image buffers allocated by preprocess(). With preallocated inputs it stays constant
+    /// after the first frame of every input resolution, otherwise it grows with every frame.
+    size_t getInputAllocationsCount() const {
+        return inputAllocationsCount;
+    }
 
 protected:
+    /// Copies the model for clone() of the derived classes, the copy allocates its own buffer for resized images
+    template <class Model>
+    static std::unique_ptr<ModelBase> cloneAs(const Model& model) {
+        std::unique_ptr<Model> copy(new Model(model));
+        copy->resizedImage = cv::Mat();
+        return std::unique_ptr<ModelBase>(copy.release());
+    }
+    /// @returns false if the model has its own preprocess() which doesn't rely on setDevicePreprocessing()
+    virtual bool supportsDevicePreprocessing() const {
+        return true;
+    }
+    void embedPreprocessing(std::shared_ptr<ov::Model>& model) override;
+    /// Resizes the image and writes it into the batch slot of the tensor, applying the input transform
+    void fillBatchSlot(const cv::Mat& origImg, const ov::Tensor& frameTensor, size_t batchIdx);
+    /// Makes the only output of the model a NHWC u8 image: NCHW output is multiplied by scale, rounded and saturated.
+    /// @param reverseChannels - if true, order of channels is reversed, e.g. RGB output is converted to BGR
+    /// @param binarize - if true, the output is thresholded by 0.5 before scaling
+    static void addU8ImageOutput(ov::preprocess::PrePostProcessor& ppp,
+                                 float scale,
+                                 bool reverseChannels = false,
+                                 bool binarize = false);
+
+    /// Finds peaks of NCHW heat maps on the device: positions equal to the maximum of their 3x3 neighbourhoods, like
+    /// max pooling NMS of the decoders. peaksNum of the highest peaks are taken from every channel, or from all
+    /// channels together if acrossChannels, sorted by descending values. If there are fewer peaks, the rest of the
+    /// positions are reported with the lowest float value.
+    /// @returns values of the peaks and their i32 indices in the channel, [N, C, peaksNum], or [N, peaksNum] indices
+    /// in the whole heat map if acrossChannels
+    static ov::OutputVector addHeatmapPeaks(const ov::Output<ov::Node>& heatMaps,
+                                            size_t peaksNum,
+                                            bool acrossChannels = false);
+    /// Samples maps of N x C x spatial dims at positions in the channel: indices [N, C, K] sample every channel at its
+    /// own positions, indices [N, K] sample all channels at the same ones.
+    /// @param shift - added to the positions, which are clamped to the map then. Requires static shape of the maps.
+    /// @returns [N, C, K] samples
+    static ov::Output<ov::Node> gatherAtPeaks(const ov::Output<ov::Node>& maps,
+                                              const ov::Output<ov::Node>& indices,
+                                              int64_t shift = 0);
+    /// Samples NCHW maps to the left, right, above and below of the peaks of addHeatmapPeaks(), at the positions
+    /// clamped to the map, for sub-pixel refinement of the peaks.
+    /// @returns [N, C, K, 4] samples
+    static ov::Output<ov::Node> gatherPeaksNeighbours(const ov::Output<ov::Node>& heatMaps,
+                                                      const ov::Output<ov::Node>& indices);
+    /// @returns the tensor the output of the model is computed as, so a subgraph consuming it can be appended
+    static ov::Output<ov::Node> getOutputSource(const std::shared_ptr<ov::Model>& model, const std::string& name);
+    /// Makes the given tensors the outputs of the model, in place of its current outputs, and outputsNames their names
+    void replaceOutputs(std::shared_ptr<ov::Model>& model,
+                        const std::vector<std::pair<std::string, ov::Output<ov::Node>>>& outputs);
+
+    /// @returns element type of the outputs decoded by postprocess() of the models supporting half precision outputs
+    ov::element::Type getOutputsPrecision() const {
+        return halfPrecisionOutputs ? ov::element::f16 : ov::element::f32;
+    }
+
     bool useAutoResize;
+    bool preallocatedInputs = false;
+    bool deviceHostInputs = false;
+    bool devicePostprocessing = false;
+    bool halfPrecisionOutputs = false;
+    bool devicePreprocessing = false;
+    bool nv12Input = false;
+    size_t inputAllocationsCount = 0;
+    /// Buffer for the resized image, if the input transform can't be done in place
+    cv::Mat resizedImage;
 
     size_t netInputHeight = 0;
     size_t netInputWidth = 0;
@@ -39,3 +39,13 @@ struct ImageInputData : public InputData {
         inputImage = img;
     }
 };
+
+/// Region of interest of a frame. inputImage is a view of the region, so the region isn't copied and preprocessing
+/// reads it from the memory of the frame. Results of models are given in coordinates of the region.
+struct ImageROIInputData : public ImageInputData {
+    cv::Mat frame;
+    cv::Rect roi;
+
+    ImageROIInputData() {}
+    ImageROIInputData(const cv::Mat& frame, const cv::Rect& roi) : ImageInputData(frame(roi)), frame(frame), roi(roi) {}
+};
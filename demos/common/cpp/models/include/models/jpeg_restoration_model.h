@@ -44,9 +44,20 @@ public:
                          const std::string& layout = "");
 
     std::shared_ptr<InternalModelData> preprocess(const InputData& inputData, ov::InferRequest& request) override;
+    std::shared_ptr<InternalModelData> preprocessBatchItem(const InputData& inputData,
+                                                           ov::InferRequest& request,
+                                                           size_t batchIdx) override {
+        return ModelBase::preprocessBatchItem(inputData, request, batchIdx);
+    }
     std::unique_ptr<ResultBase> postprocess(InferenceResult& infResult) override;
+    std::unique_ptr<ModelBase> clone() const override {
+        return cloneAs(*this);
+    }
 
 protected:
+    bool supportsDevicePreprocessing() const override {
+        return false;  // preprocess() resizes images itself
+    }
     void prepareInputsOutputs(std::shared_ptr<ov::Model>& model) override;
     void changeInputSize(std::shared_ptr<ov::Model>& model);
 
@@ -15,6 +15,9 @@
 */
 
 #pragma once
+#include <stddef.h>
+
+#include <chrono>
 #include <map>
 #include <memory>
 #include <string>
@@ -30,6 +33,7 @@ struct InferenceResult;
 struct InputData;
 struct InternalModelData;
 struct ResultBase;
+class RemoteInferenceClient;
 
 class ModelBase {
 public:
@@ -40,38 +44,102 @@ public:
     virtual ~ModelBase() {}
 
     virtual std::shared_ptr<InternalModelData> preprocess(const InputData& inputData, ov::InferRequest& request) = 0;
+    /// Preprocesses input data into particular slot of batched input tensors of the request.
+    /// Default implementation supports only batch of size 1 and falls back to preprocess().
+    /// @param inputData - input data to be preprocessed
+    /// @param request - request which input tensors should be filled
+    /// @param batchIdx - index of the slot in the batch to be filled
+    virtual std::shared_ptr<InternalModelData> preprocessBatchItem(const InputData& inputData,
+                                                                   ov::InferRequest& request,
+                                                                   size_t batchIdx);
+    /// Preprocesses several inputs into consecutive slots of batched input tensors of the request.
+    /// Default implementation calls preprocessBatchItem() for every input.
+    /// @param inputs - input data to be preprocessed, slot b is filled from inputs[b]. The number of inputs
+    /// shouldn't exceed the batch size, remaining slots are left untouched.
+    /// @param request - request which input tensors should be filled
+    /// @returns internal model data of every slot, which should be passed to postprocess() of the slot results
+    virtual std::vector<std::shared_ptr<InternalModelData>> preprocessBatch(const std::vector<const InputData*>& inputs,
+                                                                            ov::InferRequest& request);
     virtual ov::CompiledModel compileModel(const ModelConfig& config, ov::Core& core);
     virtual void onLoadCompleted(const std::vector<ov::InferRequest>& requests) {}
+    /// Runs inferencesNum inferences of zero inputs of every shape returned by getWarmupShapes() on all requests at
+    /// once, so the device compiles its kernels and allocates its memory before the first frame. Input tensors of the
+    /// requests are restored afterwards. Should be called after onLoadCompleted().
+    void warmUp(const std::vector<ov::InferRequest>& requests, unsigned int inferencesNum);
     virtual std::unique_ptr<ResultBase> postprocess(InferenceResult& infResult) = 0;
+    /// @returns a copy of the wrapper for another pipeline running the same compiled model, see SharedCompiledModel.
+    /// The copy doesn't share scratch buffers of preprocessing and postprocessing with the original, so both may be
+    /// used at the same time, and its postprocessing parameters may be changed. The default implementation throws.
+    virtual std::unique_ptr<ModelBase> clone() const;
 
     const std::vector<std::string>& getOutputsNames() const {
         return outputsNames;
     }
+    /// @returns the outputs names set up by prepareModel(), shared by OutputsData of results without copying
+    const std::shared_ptr<const std::vector<std::string>>& getSharedOutputsNames() const {
+        return sharedOutputsNames;
+    }
     const std::vector<std::string>& getInputsNames() const {
         return inputsNames;
     }
 
+    /// @returns configuration the model was compiled with, it differs from the one passed to compileModel() if it
+    /// was tuned
+    const ModelConfig& getConfig() const {
+        return config;
+    }
+
+    /// @returns the client inferring the model on ModelConfig::remoteWorker, nullptr for local inference. Infer
+    /// requests of a remotely inferred model should be started by the client.
+    const std::shared_ptr<RemoteInferenceClient>& getRemoteClient() const {
+        return remoteClient;
+    }
+
     std::string getModelFileName() {
         return modelFileName;
     }
 
+    /// Sets batch size the model is reshaped to. Should be called before compileModel().
+    void setBatch(size_t batch) {
+        batchSize = batch;
+    }
+    size_t getBatch() const {
+        return batchSize;
+    }
+
     void setInputsPreprocessing(bool reverseInputChannels,
                                 const std::string& meanValues,
                                 const std::string& scaleValues) {
         this->inputTransform = InputTransform(reverseInputChannels, meanValues, scaleValues);
     }
 
+    /// Reads the model and sets up its inputs and outputs like compileModel() does before compilation. Demos which
+    /// compile the model themselves, e.g. to share it between channels, use it together with postprocessing methods
+    /// of the wrapper.
+    std::shared_ptr<ov::Model> prepareModel(ov::Core& core);
+
 protected:
     virtual void prepareInputsOutputs(std::shared_ptr<ov::Model>& model) = 0;
-
-    std::shared_ptr<ov::Model> prepareModel(ov::Core& core);
+    /// Moves preprocessing the wrapper does on CPU into the model, so the inference device does it. Called by
+    /// prepareModel() after prepareInputsOutputs(), the default implementation does nothing.
+    virtual void embedPreprocessing(std::shared_ptr<ov::Model>& model) {}
+    /// @returns shapes of inputs the model is expected to be inferred with, a map of shapes by input names for every
+    /// representative input size. The default implementation returns static shapes of the compiled model, or nothing
+    /// if some of them are dynamic.
+    virtual std::vector<std::map<std::string, ov::Shape>> getWarmupShapes() const;
 
     InputTransform inputTransform = InputTransform();
     std::vector<std::string> inputsNames;
     std::vector<std::string> outputsNames;
+    std::shared_ptr<const std::vector<std::string>> sharedOutputsNames;
     ov::CompiledModel compiledModel;
+    std::shared_ptr<RemoteInferenceClient> remoteClient;
     std::string modelFileName;
     ModelConfig config = {};
+    size_t batchSize = 1;
     std::map<std::string, ov::Layout> inputsLayouts;
+    /// Time spent by prepareModel() for reading the model and for setting up its inputs and outputs
+    std::chrono::duration<double, std::milli> readModelTime{0};
+    std::chrono::duration<double, std::milli> prepareModelTime{0};
     ov::Layout getInputLayout(const ov::Output<ov::Node>& input);
 };
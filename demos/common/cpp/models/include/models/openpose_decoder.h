@@ -16,6 +16,7 @@
 
 #pragma once
 #include <stddef.h>
+#include <stdint.h>
 
 #include <vector>
 
@@ -53,6 +54,24 @@ void findPeaks(const std::vector<cv::Mat>& heatMaps,
                int heatMapId,
                float confidenceThreshold);
 
+/// Moves every peak to the vertex of the parabolas fitted to the heat map values at the peak and its neighbours along
+/// both axes, which restores sub-pixel positions of the peaks found on a heat map of low resolution.
+void refinePeaks(const cv::Mat& heatMap, std::vector<Peak>& peaks);
+
+/// Selects the peaks of a heat map among the candidates found on the device, which come in descending order of the
+/// scores: the candidates below the threshold and the ones closer than minPeaksDistance to a higher peak are dropped.
+/// @param indices - positions of the candidates in the map, y * width + x
+/// @param neighbours - if not null, the heat map values to the left, right, above and below of every candidate, which
+/// refine the peaks like refinePeaks()
+void selectPeaks(const float* scores,
+                 const int32_t* indices,
+                 const float* neighbours,
+                 size_t candidatesNum,
+                 const cv::Size& mapSize,
+                 float minPeaksDistance,
+                 float confidenceThreshold,
+                 std::vector<Peak>& peaks);
+
 std::vector<HumanPose> groupPeaksToPoses(const std::vector<std::vector<Peak>>& allPeaks,
                                          const std::vector<cv::Mat>& pafs,
                                          const size_t keypointsNumber,
@@ -15,12 +15,18 @@
 */
 
 #pragma once
+#include <stddef.h>
+#include <stdint.h>
+
 #include <map>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
 #include <openvino/openvino.hpp>
 
 #include "internal_model_data.h"
@@ -35,6 +41,10 @@ struct ResultBase {
     int64_t frameId;
 
     std::shared_ptr<MetaData> metaData;
+    /// True if the frame wasn't inferred and got the result of the last inferred frame, see
+    /// AsyncPipeline::setMotionGate()
+    bool isCached = false;
+
     bool IsEmpty() {
         return frameId < 0;
     }
@@ -50,9 +60,69 @@ struct ResultBase {
     }
 };
 
+/// Output tensors of an infer request in the order of ModelBase::getOutputsNames(), so postprocessing takes them by
+/// index. The names are shared by all results of a model, lookups by name search them linearly and are a convenience
+/// for code off the hot path.
+class OutputsData {
+public:
+    using Names = std::shared_ptr<const std::vector<std::string>>;
+
+    OutputsData() = default;
+    explicit OutputsData(const Names& names) : names(names), tensors(names->size()) {}
+
+    ov::Tensor& operator[](size_t idx) {
+        return tensors[idx];
+    }
+    const ov::Tensor& operator[](size_t idx) const {
+        return tensors[idx];
+    }
+
+    /// @throws std::out_of_range if there is no output with the name
+    ov::Tensor& at(const std::string& name) {
+        return tensors[indexOf(name)];
+    }
+    const ov::Tensor& at(const std::string& name) const {
+        return tensors[indexOf(name)];
+    }
+
+    const std::string& getName(size_t idx) const {
+        return (*names)[idx];
+    }
+
+    size_t size() const {
+        return tensors.size();
+    }
+    bool empty() const {
+        return tensors.empty();
+    }
+
+    /// Appends an output, the names are copied if they are shared. Meant for results which aren't produced by
+    /// AsyncPipeline, e.g. replayed ones.
+    void emplace(const std::string& name, const ov::Tensor& tensor) {
+        auto ownNames = names ? std::make_shared<std::vector<std::string>>(*names)
+                              : std::make_shared<std::vector<std::string>>();
+        ownNames->push_back(name);
+        names = std::move(ownNames);
+        tensors.push_back(tensor);
+    }
+
+private:
+    size_t indexOf(const std::string& name) const {
+        for (size_t i = 0; i < tensors.size(); ++i) {
+            if ((*names)[i] == name) {
+                return i;
+            }
+        }
+        throw std::out_of_range("There is no output " + name);
+    }
+
+    Names names;
+    std::vector<ov::Tensor> tensors;
+};
+
 struct InferenceResult : public ResultBase {
     std::shared_ptr<InternalModelData> internalModelData;
-    std::map<std::string, ov::Tensor> outputsData;
+    OutputsData outputsData;
 
     /// Returns the first output tensor
     /// This function is a useful addition to direct access to outputs list as many models have only one output
@@ -61,7 +131,7 @@ struct InferenceResult : public ResultBase {
         if (outputsData.empty()) {
             throw std::out_of_range("Outputs map is empty.");
         }
-        return outputsData.begin()->second;
+        return outputsData[0];
     }
 
     /// Returns true if object contains no valid data
@@ -88,6 +158,7 @@ struct ClassificationResult : public ResultBase {
 
 struct DetectedObject : public cv::Rect2f {
     unsigned int labelID;
+    /// Empty if the model interns labels, see DetectionResult::getLabelName()
     std::string label;
     float confidence;
 };
@@ -96,6 +167,17 @@ struct DetectionResult : public ResultBase {
     DetectionResult(int64_t frameId = -1, const std::shared_ptr<MetaData>& metaData = nullptr)
         : ResultBase(frameId, metaData) {}
     std::vector<DetectedObject> objects;
+    /// Labels of the model for every class. The table is shared by the model and all its results and never changes.
+    std::shared_ptr<const std::vector<std::string>> labels;
+    /// True if the objects weren't detected on this frame, but predicted from the latest keyframe by KeyframePipeline
+    bool isPropagated = false;
+
+    /// Resolves the label of an object by its ID
+    /// @returns label from the model table or default "Label #N" if the table has no label for the ID
+    std::string getLabelName(unsigned int labelID) const {
+        return labels && labelID < labels->size() ? (*labels)[labelID]
+                                                  : std::string("Label #") + std::to_string(labelID);
+    }
 };
 
 struct RetinaFaceDetectionResult : public DetectionResult {
@@ -110,6 +192,40 @@ struct ImageResult : public ResultBase {
     cv::Mat resultImage;
 };
 
+/// Segmentation result at the resolution of the model output. Class map is upscaled to the input image size only if
+/// it is requested by upscaleClassMap().
+struct SegmentationResult : public ResultBase {
+    SegmentationResult(int64_t frameId = -1, const std::shared_ptr<MetaData>& metaData = nullptr)
+        : ResultBase(frameId, metaData) {}
+
+    /// Class of every pixel (CV_8UC1)
+    cv::Mat classMap;
+    /// Probability of the class of every pixel (CV_32FC1). Empty, unless it's requested from the model.
+    cv::Mat confidenceMap;
+    cv::Size inputImageSize;
+
+    /// @returns class map resized to the input image size, the same as ImageResult::resultImage of SegmentationModel
+    cv::Mat upscaleClassMap() const {
+        cv::Mat upscaled;
+        cv::resize(classMap, upscaled, inputImageSize, 0, 0, cv::INTER_NEAREST);
+        return upscaled;
+    }
+
+    /// @returns number of pixels of the class map occupied by every class
+    std::vector<size_t> getClassAreas(size_t classesCount) const {
+        std::vector<size_t> areas(classesCount);
+        for (int row = 0; row < classMap.rows; ++row) {
+            const uint8_t* classes = classMap.ptr<uint8_t>(row);
+            for (int col = 0; col < classMap.cols; ++col) {
+                if (classes[col] < classesCount) {
+                    ++areas[classes[col]];
+                }
+            }
+        }
+        return areas;
+    }
+};
+
 struct HumanPose {
     std::vector<cv::Point2f> keypoints;
     float score;
@@ -40,6 +40,18 @@ public:
     static std::vector<std::string> loadLabels(const std::string& labelFilename);
 
     std::unique_ptr<ResultBase> postprocess(InferenceResult& infResult) override;
+    std::unique_ptr<ModelBase> clone() const override {
+        return cloneAs(*this);
+    }
+
+    /// Makes postprocess() return SegmentationResult with the class map at the model output resolution instead of
+    /// ImageResult with the class map upscaled to the input image size, so upscale is done only if it is needed.
+    /// @param lazyUpscale - if true, SegmentationResult is returned
+    /// @param computeConfidence - if true, SegmentationResult also keeps probability of the class of every pixel
+    void setLazyUpscale(bool lazyUpscale, bool computeConfidence = false) {
+        this->lazyUpscale = lazyUpscale;
+        this->computeConfidence = computeConfidence;
+    }
 
 protected:
     void prepareInputsOutputs(std::shared_ptr<ov::Model>& model) override;
@@ -47,4 +59,6 @@ protected:
     int outHeight = 0;
     int outWidth = 0;
     int outChannels = 0;
+    bool lazyUpscale = false;
+    bool computeConfidence = false;
 };
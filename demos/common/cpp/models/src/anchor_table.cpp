@@ -0,0 +1,37 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "models/anchor_table.h"
+
+#include <map>
+#include <mutex>
+
+std::shared_ptr<const AnchorTable> getSharedAnchorTable(const std::string& key,
+                                                        const std::function<void(AnchorTable&)>& build) {
+    static std::mutex mtx;
+    static std::map<std::string, std::weak_ptr<const AnchorTable>> tables;
+
+    const std::lock_guard<std::mutex> lock(mtx);
+    std::weak_ptr<const AnchorTable>& cached = tables[key];
+    std::shared_ptr<const AnchorTable> table = cached.lock();
+    if (!table) {
+        std::shared_ptr<AnchorTable> newTable = std::make_shared<AnchorTable>();
+        build(*newTable);
+        table = newTable;
+        cached = table;
+    }
+    return table;
+}
@@ -17,127 +17,166 @@
 #include "models/associative_embedding_decoder.h"
 
 #include <algorithm>
-#include <iterator>
+#include <cmath>
 #include <limits>
-#include <numeric>
 #include <vector>
 
 #include <utils/kuhn_munkres.hpp>
 
+void AssociativeEmbeddingBuffers::reset(size_t numJoints, size_t maxNumPeople) {
+    this->maxNumPeople = maxNumPeople;
+    peaks.resize(numJoints * maxNumPeople);
+    peaksNum.assign(numJoints, 0);
+    posesNum = 0;
+}
+
+namespace {
+bool isHigher(const Peak& l, const Peak& r) {
+    return l.score > r.score;
+}
+}  // namespace
+
 void findPeaks(const std::vector<cv::Mat>& nmsHeatMaps,
                const std::vector<cv::Mat>& aembdsMaps,
-               std::vector<std::vector<Peak>>& allPeaks,
+               AssociativeEmbeddingBuffers& buffers,
                size_t jointId,
                size_t maxNumPeople,
                float detectionThreshold) {
     const cv::Mat& nmsHeatMap = nmsHeatMaps[jointId];
-    const float* heatMapData = nmsHeatMap.ptr<float>();
-    cv::Size outputSize = nmsHeatMap.size();
-
-    std::vector<int> indices(outputSize.area());
-    std::iota(std::begin(indices), std::end(indices), 0);
-    std::partial_sort(std::begin(indices),
-                      std::begin(indices) + maxNumPeople,
-                      std::end(indices),
-                      [heatMapData](int l, int r) {
-                          return heatMapData[l] > heatMapData[r];
-                      });
+    const cv::Mat& aembds = aembdsMaps[jointId];
 
-    for (size_t personId = 0; personId < maxNumPeople; personId++) {
-        int index = indices[personId];
-        int x = index / outputSize.width;
-        int y = index % outputSize.width;
-        float tag = aembdsMaps[jointId].at<float>(x, y);
-        float score = heatMapData[index];
-        allPeaks[jointId].reserve(maxNumPeople);
-        if (score > detectionThreshold) {
-            allPeaks[jointId].emplace_back(Peak{cv::Point2f(static_cast<float>(x), static_cast<float>(y)), score, tag});
+    // The highest peaks are kept in a heap with the lowest of them on top, so the map is scanned once
+    // instead of sorting all its pixels
+    Peak* const peaks = buffers.jointPeaks(jointId);
+    size_t peaksNum = 0;
+    for (int row = 0; row < nmsHeatMap.rows; row++) {
+        const float* heatMapRow = nmsHeatMap.ptr<float>(row);
+        for (int col = 0; col < nmsHeatMap.cols; col++) {
+            const float score = heatMapRow[col];
+            if (score <= detectionThreshold || (peaksNum == maxNumPeople && score <= peaks[0].score)) {
+                continue;
+            }
+            if (peaksNum == maxNumPeople) {
+                std::pop_heap(peaks, peaks + peaksNum, isHigher);
+                peaksNum--;
+            }
+            // The keypoint is (row, col), the coordinates are swapped after the matching
+            peaks[peaksNum++] = Peak{cv::Point2f(static_cast<float>(row), static_cast<float>(col)),
+                                     score,
+                                     aembds.at<float>(row, col)};
+            std::push_heap(peaks, peaks + peaksNum, isHigher);
         }
     }
+    std::sort_heap(peaks, peaks + peaksNum, isHigher);
+    buffers.peaksNum[jointId] = peaksNum;
 }
 
-std::vector<Pose> matchByTag(std::vector<std::vector<Peak>>& allPeaks,
-                             size_t maxNumPeople,
-                             size_t numJoints,
-                             float tagThreshold) {
+void collectPeaks(const float* scores,
+                  const int32_t* indices,
+                  const float* tags,
+                  size_t candidatesNum,
+                  int mapWidth,
+                  AssociativeEmbeddingBuffers& buffers,
+                  size_t jointId,
+                  size_t maxNumPeople,
+                  float detectionThreshold) {
+    Peak* const peaks = buffers.jointPeaks(jointId);
+    size_t peaksNum = 0;
+    for (size_t i = 0; i < candidatesNum && peaksNum < maxNumPeople && scores[i] > detectionThreshold; i++) {
+        // The keypoint is (row, col), the coordinates are swapped after the matching
+        peaks[peaksNum++] = Peak{cv::Point2f(static_cast<float>(indices[i] / mapWidth),
+                                             static_cast<float>(indices[i] % mapWidth)),
+                                 scores[i],
+                                 tags[i]};
+    }
+    buffers.peaksNum[jointId] = peaksNum;
+}
+
+void matchByTag(AssociativeEmbeddingBuffers& buffers, size_t maxNumPeople, size_t numJoints, float tagThreshold) {
     size_t jointOrder[]{0, 1, 2, 3, 4, 5, 6, 11, 12, 7, 8, 9, 10, 13, 14, 15, 16};
-    std::vector<Pose> allPoses;
-    for (size_t jointId : jointOrder) {
-        std::vector<Peak>& jointPeaks = allPeaks[jointId];
-        std::vector<float> tags;
-        for (auto& peak : jointPeaks) {
-            tags.push_back(peak.tag);
+    std::vector<Pose>& allPoses = buffers.poses;
+    size_t& posesNum = buffers.posesNum;
+    auto addPose = [&](size_t jointId, const Peak& peak) {
+        if (posesNum == allPoses.size()) {
+            allPoses.emplace_back(numJoints);
+        } else {
+            allPoses[posesNum].reset();
         }
-        if (allPoses.empty()) {
-            for (size_t personId = 0; personId < jointPeaks.size(); personId++) {
-                Peak peak = jointPeaks[personId];
-                Pose pose = Pose(numJoints);
-                pose.add(jointId, peak);
-                allPoses.push_back(pose);
+        allPoses[posesNum++].add(jointId, peak);
+    };
+
+    for (size_t jointId : jointOrder) {
+        const Peak* jointPeaks = buffers.jointPeaks(jointId);
+        const size_t numAdded = buffers.peaksNum[jointId];
+        if (posesNum == 0) {
+            for (size_t personId = 0; personId < numAdded; personId++) {
+                addPose(jointId, jointPeaks[personId]);
             }
             continue;
         }
-        if (jointPeaks.empty() || (allPoses.size() == maxNumPeople)) {
+        if (numAdded == 0 || (posesNum == maxNumPeople)) {
             continue;
         }
-        std::vector<float> posesTags;
-        std::vector<cv::Point2f> posesCenters;
-        for (auto& pose : allPoses) {
-            posesTags.push_back(pose.getPoseTag());
-            posesCenters.push_back(pose.getPoseCenter());
+        const size_t numGrouped = posesNum;
+        // Peaks are copied to separate arrays, so the distances are computed by plain loops over them
+        buffers.tags.resize(numAdded);
+        buffers.scores.resize(numAdded);
+        buffers.peaksX.resize(numAdded);
+        buffers.peaksY.resize(numAdded);
+        buffers.dists.resize(numAdded);
+        float* const tags = buffers.tags.data();
+        float* const scores = buffers.scores.data();
+        float* const peaksX = buffers.peaksX.data();
+        float* const peaksY = buffers.peaksY.data();
+        float* const dists = buffers.dists.data();
+        for (size_t i = 0; i < numAdded; i++) {
+            tags[i] = jointPeaks[i].tag;
+            scores[i] = jointPeaks[i].score;
+            peaksX[i] = jointPeaks[i].keypoint.x;
+            peaksY[i] = jointPeaks[i].keypoint.y;
         }
-        size_t numAdded = tags.size();
-        size_t numGrouped = posesTags.size();
-        cv::Mat tagsDiff(numAdded, numGrouped, CV_32F);
-        cv::Mat matchingCost(numAdded, numGrouped, CV_32F);
-        std::vector<float> dists(numAdded);
+        // tagsDiff is stored by columns, matchingCost is stored by rows and padded with columns of high cost if
+        // there are more joints than poses
+        const size_t numCols = std::max(numAdded, numGrouped);
+        buffers.tagsDiff.resize(numAdded * numGrouped);
+        buffers.matchingCost.assign(numAdded * numCols, 10000000.0f);
+        float* const tagsDiff = buffers.tagsDiff.data();
+        float* const matchingCost = buffers.matchingCost.data();
         for (size_t j = 0; j < numGrouped; j++) {
-            float minDist = std::numeric_limits<float>::max();
             // Compute euclidean distance (in spatial space) between the pose center and all joints.
-            const cv::Point2f center = posesCenters.at(j);
+            const cv::Point2f center = allPoses[j].getPoseCenter();
             for (size_t i = 0; i < numAdded; i++) {
-                cv::Point2f v = jointPeaks.at(i).keypoint - center;
-                float dist = std::sqrt(v.x * v.x + v.y * v.y);
-                dists[i] = dist;
-                minDist = std::min(dist, minDist);
+                const float dx = peaksX[i] - center.x;
+                const float dy = peaksY[i] - center.y;
+                dists[i] = std::sqrt(dx * dx + dy * dy);
             }
+            const float minDist = *std::min_element(dists, dists + numAdded);
             // Compute semantic distance (in embedding space) between the pose tag and all joints
             // and corresponding matching costs.
-            auto poseTag = posesTags[j];
+            const float poseTag = allPoses[j].getPoseTag();
+            float* const tagsDiffCol = tagsDiff + j * numAdded;
             for (size_t i = 0; i < numAdded; i++) {
-                float diff = static_cast<float>(cv::norm(tags[i] - poseTag));
-                tagsDiff.at<float>(i, j) = diff;
+                float diff = std::abs(tags[i] - poseTag);
+                tagsDiffCol[i] = diff;
                 if (diff < tagThreshold) {
                     diff *= dists[i] / (minDist + 1e-10f);
                 }
-                matchingCost.at<float>(i, j) = std::round(diff) * 100 - jointPeaks[i].score;
+                matchingCost[i * numCols + j] = std::round(diff) * 100 - scores[i];
             }
         }
 
-        if (numAdded > numGrouped) {
-            cv::copyMakeBorder(matchingCost,
-                               matchingCost,
-                               0,
-                               0,
-                               0,
-                               numAdded - numGrouped,
-                               cv::BORDER_CONSTANT,
-                               10000000);
-        }
         // Get pairs
-        auto res = KuhnMunkres().Solve(matchingCost);
+        auto res = KuhnMunkres().Solve(
+            cv::Mat(static_cast<int>(numAdded), static_cast<int>(numCols), CV_32F, matchingCost));
         for (size_t row = 0; row < res.size(); row++) {
             size_t col = res[row];
-            if (row < numAdded && col < numGrouped && tagsDiff.at<float>(row, col) < tagThreshold) {
+            if (row < numAdded && col < numGrouped && tagsDiff[col * numAdded + row] < tagThreshold) {
                 allPoses[col].add(jointId, jointPeaks[row]);
             } else {
-                Pose pose = Pose(numJoints);
-                pose.add(jointId, jointPeaks[row]);
-                allPoses.push_back(pose);
+                addPose(jointId, jointPeaks[row]);
             }
         }
     }
-    return allPoses;
 }
 
 namespace {
@@ -178,16 +217,24 @@ void adjustAndRefine(std::vector<Pose>& allPoses,
             }
         } else {
             // Refine
-            // Get position with the closest tag value to the pose tag
-            cv::Mat diff = cv::abs(aembds - poseTag);
-            diff.convertTo(diff, CV_32S, 1.0, 0.0);
-            diff.convertTo(diff, CV_32F);
-            diff -= heatMap;
-            double min;
-            cv::Point2i minLoc;
-            cv::minMaxLoc(diff, &min, 0, &minLoc);
-            int x = minLoc.x;
-            int y = minLoc.y;
+            // Get position with the closest tag value to the pose tag, the tag difference is rounded before the heat
+            // map value is subtracted. The minimum is searched in a single pass without temporary maps.
+            float minDiff = std::numeric_limits<float>::infinity();
+            int x = 0;
+            int y = 0;
+            for (int row = 0; row < aembds.rows; row++) {
+                const float* aembdsRow = aembds.ptr<float>(row);
+                const float* heatMapRow = heatMap.ptr<float>(row);
+                for (int col = 0; col < aembds.cols; col++) {
+                    const float diff =
+                        static_cast<float>(cvRound(std::abs(aembdsRow[col] - poseTag))) - heatMapRow[col];
+                    if (diff < minDiff) {
+                        minDiff = diff;
+                        x = col;
+                        y = row;
+                    }
+                }
+            }
             float val = heatMap.at<float>(y, x);
             if (val > 0) {
                 peak.keypoint.x = static_cast<float>(x);
@@ -199,3 +246,32 @@ void adjustAndRefine(std::vector<Pose>& allPoses,
         }
     }
 }
+
+void adjustPeaks(Pose& pose,
+                 const int32_t* indices,
+                 const float* neighbours,
+                 size_t candidatesNum,
+                 const cv::Size& mapSize,
+                 float delta) {
+    for (size_t jointId = 0; jointId < pose.size(); jointId++) {
+        Peak& peak = pose.getPeak(jointId);
+        if (peak.score <= 0) {
+            continue;
+        }
+        const int x = static_cast<int>(peak.keypoint.x);
+        const int y = static_cast<int>(peak.keypoint.y);
+        const int32_t* jointIndices = indices + jointId * candidatesNum;
+        const int32_t* candidate = std::find(jointIndices, jointIndices + candidatesNum, y * mapSize.width + x);
+        if ((1 < x) && (x < mapSize.width - 1) && (1 < y) && (y < mapSize.height - 1) &&
+            candidate != jointIndices + candidatesNum) {
+            // The decoder compares absolute values of the heat map
+            const float* around = neighbours + (candidate - indices) * 4;
+            peak.keypoint.x += std::abs(around[1]) - std::abs(around[0]) > 0 ? 0.25f : -0.25f;
+            peak.keypoint.y += std::abs(around[3]) - std::abs(around[2]) > 0 ? 0.25f : -0.25f;
+        }
+        if (delta) {
+            peak.keypoint.x += delta;
+            peak.keypoint.y += delta;
+        }
+    }
+}
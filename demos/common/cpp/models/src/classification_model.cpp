@@ -43,9 +43,9 @@ ClassificationModel::ClassificationModel(const std::string& modelFileName,
       labels(labels) {}
 
 std::unique_ptr<ResultBase> ClassificationModel::postprocess(InferenceResult& infResult) {
-    const ov::Tensor& indicesTensor = infResult.outputsData.find(outputsNames[0])->second;
+    const ov::Tensor& indicesTensor = infResult.outputsData[0];
     const int* indicesPtr = indicesTensor.data<int>();
-    const ov::Tensor& scoresTensor = infResult.outputsData.find(outputsNames[1])->second;
+    const ov::Tensor& scoresTensor = infResult.outputsData[1];
     const float* scoresPtr = scoresTensor.data<float>();
 
     ClassificationResult* result = new ClassificationResult(infResult.frameId, infResult.metaData);
@@ -75,7 +75,11 @@ void DeblurringModel::prepareInputsOutputs(std::shared_ptr<ov::Model>& model) {
         throw std::logic_error("3-channel 4-dimensional model's output is expected");
     }
 
-    ppp.output().tensor().set_element_type(ov::element::f32);
+    if (devicePostprocessing) {
+        addU8ImageOutput(ppp, 255.0f);
+    } else {
+        ppp.output().tensor().set_element_type(ov::element::f32);
+    }
     model = ppp.build();
 
     changeInputSize(model);
@@ -129,10 +133,30 @@ std::unique_ptr<ResultBase> DeblurringModel::postprocess(InferenceResult& infRes
     *static_cast<ResultBase*>(result) = static_cast<ResultBase&>(infResult);
 
     const auto& inputImgSize = infResult.internalModelData->asRef<InternalImageModelData>();
-    const auto outputData = infResult.getFirstOutputTensor().data<float>();
+    const ov::Tensor& outTensor = infResult.getFirstOutputTensor();
+    const bool isPadded = netInputHeight - stride < static_cast<size_t>(inputImgSize.inputImgHeight) &&
+                          static_cast<size_t>(inputImgSize.inputImgHeight) <= netInputHeight &&
+                          netInputWidth - stride < static_cast<size_t>(inputImgSize.inputImgWidth) &&
+                          static_cast<size_t>(inputImgSize.inputImgWidth) <= netInputWidth;
+    if (outTensor.get_element_type() == ov::element::u8) {
+        const ov::Layout layout("NHWC");
+        const cv::Mat outImg(static_cast<int>(outTensor.get_shape()[ov::layout::height_idx(layout)]),
+                             static_cast<int>(outTensor.get_shape()[ov::layout::width_idx(layout)]),
+                             CV_8UC3,
+                             outTensor.data());
+        if (isPadded) {
+            // The tensor is reused by next inferences, so the image is copied
+            const cv::Rect inputImgRect(0, 0, inputImgSize.inputImgWidth, inputImgSize.inputImgHeight);
+            result->resultImage = outImg(inputImgRect).clone();
+        } else {
+            cv::resize(outImg, result->resultImage, cv::Size(inputImgSize.inputImgWidth, inputImgSize.inputImgHeight));
+        }
+        return std::unique_ptr<ResultBase>(result);
+    }
+    const auto outputData = outTensor.data<float>();
 
     std::vector<cv::Mat> imgPlanes;
-    const ov::Shape& outputShape = infResult.getFirstOutputTensor().get_shape();
+    const ov::Shape& outputShape = outTensor.get_shape();
     const ov::Layout outputLayout("NCHW");
     size_t outHeight = static_cast<int>((outputShape[ov::layout::height_idx(outputLayout)]));
     size_t outWidth = static_cast<int>((outputShape[ov::layout::width_idx(outputLayout)]));
@@ -143,10 +167,7 @@ std::unique_ptr<ResultBase> DeblurringModel::postprocess(InferenceResult& infRes
     cv::Mat resultImg;
     cv::merge(imgPlanes, resultImg);
 
-    if (netInputHeight - stride < static_cast<size_t>(inputImgSize.inputImgHeight) &&
-        static_cast<size_t>(inputImgSize.inputImgHeight) <= netInputHeight &&
-        netInputWidth - stride < static_cast<size_t>(inputImgSize.inputImgWidth) &&
-        static_cast<size_t>(inputImgSize.inputImgWidth) <= netInputWidth) {
+    if (isPadded) {
         result->resultImage = resultImg(cv::Rect(0, 0, inputImgSize.inputImgWidth, inputImgSize.inputImgHeight));
     } else {
         cv::resize(resultImg, result->resultImage, cv::Size(inputImgSize.inputImgWidth, inputImgSize.inputImgHeight));
@@ -17,6 +17,7 @@
 #include "models/detection_model.h"
 
 #include <fstream>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -32,6 +33,11 @@ DetectionModel::DetectionModel(const std::string& modelFileName,
       confidenceThreshold(confidenceThreshold),
       labels(labels) {}
 
+void DetectionModel::onLoadCompleted(const std::vector<ov::InferRequest>& requests) {
+    ImageModel::onLoadCompleted(requests);
+    labelsTable = std::make_shared<const std::vector<std::string>>(labels);
+}
+
 std::vector<std::string> DetectionModel::loadLabels(const std::string& labelFilename) {
     std::vector<std::string> labelsList;
 
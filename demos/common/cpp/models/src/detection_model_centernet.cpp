@@ -17,16 +17,18 @@
 #include "models/detection_model_centernet.h"
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <map>
 #include <stdexcept>
 #include <utility>
 
 #include <opencv2/core.hpp>
-#include <opencv2/imgproc.hpp>
 #include <openvino/openvino.hpp>
+#include <openvino/opsets/opset8.hpp>
 
 #include <utils/common.hpp>
 #include <utils/image_utils.h>
@@ -42,6 +44,41 @@ ModelCenterNet::ModelCenterNet(const std::string& modelFileName,
                                const std::string& layout)
     : DetectionModel(modelFileName, confidenceThreshold, false, labels, layout) {}
 
+void ModelCenterNet::setAspectBuckets(const std::vector<double>& ratios) {
+    for (double ratio : ratios) {
+        if (!(ratio > 0)) {
+            throw std::invalid_argument("Aspect ratios of input buckets should be positive");
+        }
+    }
+    aspectRatios = ratios;
+}
+
+std::vector<std::map<std::string, ov::Shape>> ModelCenterNet::getWarmupShapes() const {
+    if (bucketSizes.empty()) {
+        return ModelBase::getWarmupShapes();
+    }
+    std::vector<std::map<std::string, ov::Shape>> shapesList;
+    for (const cv::Size& size : bucketSizes) {
+        const ov::Shape shape{1, static_cast<size_t>(size.height), static_cast<size_t>(size.width), 3};
+        shapesList.push_back({{inputsNames[0], shape}});
+    }
+    return shapesList;
+}
+
+cv::Size ModelCenterNet::getInputSize(const cv::Size& imageSize) const {
+    if (bucketSizes.empty()) {
+        return cv::Size(static_cast<int>(netInputWidth), static_cast<int>(netInputHeight));
+    }
+    const double imageRatio = static_cast<double>(imageSize.width) / imageSize.height;
+    size_t closest = 0;
+    for (size_t i = 1; i < aspectRatios.size(); ++i) {
+        if (std::abs(std::log(aspectRatios[i] / imageRatio)) < std::abs(std::log(aspectRatios[closest] / imageRatio))) {
+            closest = i;
+        }
+    }
+    return bucketSizes[closest];
+}
+
 void ModelCenterNet::prepareInputsOutputs(std::shared_ptr<ov::Model>& model) {
     // --------------------------- Configure input & output -------------------------------------------------
     // --------------------------- Prepare input  ------------------------------------------------------
@@ -49,13 +86,34 @@ void ModelCenterNet::prepareInputsOutputs(std::shared_ptr<ov::Model>& model) {
         throw std::logic_error("CenterNet model wrapper expects models that have only 1 input");
     }
 
-    const ov::Shape& inputShape = model->input().get_shape();
+    const ov::Shape inputShape = model->input().get_shape();
     const ov::Layout& inputLayout = getInputLayout(model->input());
 
     if (inputShape[ov::layout::channels_idx(inputLayout)] != 3) {
         throw std::logic_error("Expected 3-channel input");
     }
 
+    netInputWidth = inputShape[ov::layout::width_idx(inputLayout)];
+    netInputHeight = inputShape[ov::layout::height_idx(inputLayout)];
+    bucketSizes.clear();
+    if (!aspectRatios.empty()) {
+        if (batchSize != 1 || preallocatedInputs) {
+            throw std::logic_error("Input buckets aren't supported with batched inference and preallocated inputs");
+        }
+        // Sides of the buckets are rounded to the total stride of the backbone, so the heat map covers them exactly
+        const int stride = 32;
+        const double area = static_cast<double>(netInputWidth * netInputHeight);
+        for (double ratio : aspectRatios) {
+            const int width = std::max(static_cast<int>(std::round(std::sqrt(area * ratio) / stride)), 1) * stride;
+            const int height = std::max(static_cast<int>(std::round(std::sqrt(area / ratio) / stride)), 1) * stride;
+            bucketSizes.emplace_back(width, height);
+        }
+        ov::PartialShape dynamicShape(inputShape);
+        dynamicShape[ov::layout::width_idx(inputLayout)] = ov::Dimension::dynamic();
+        dynamicShape[ov::layout::height_idx(inputLayout)] = ov::Dimension::dynamic();
+        model->reshape(dynamicShape);
+    }
+
     ov::preprocess::PrePostProcessor ppp(model);
     inputTransform.setPrecision(ppp, model->input().get_any_name());
     ppp.input().tensor().set_layout("NHWC");
@@ -64,8 +122,6 @@ void ModelCenterNet::prepareInputsOutputs(std::shared_ptr<ov::Model>& model) {
 
     // --------------------------- Reading image input parameters -------------------------------------------
     inputsNames.push_back(model->input().get_any_name());
-    netInputWidth = inputShape[ov::layout::width_idx(inputLayout)];
-    netInputHeight = inputShape[ov::layout::height_idx(inputLayout)];
 
     // --------------------------- Prepare output  -----------------------------------------------------
     if (model->outputs().size() != 3) {
@@ -80,209 +136,252 @@ void ModelCenterNet::prepareInputsOutputs(std::shared_ptr<ov::Model>& model) {
     }
     std::sort(outputsNames.begin(), outputsNames.end());
     model = ppp.build();
-}
-
-cv::Point2f getDir(const cv::Point2f& srcPoint, float rotRadius) {
-    float sn = sinf(rotRadius);
-    float cs = cosf(rotRadius);
-
-    cv::Point2f srcResult(0.0f, 0.0f);
-    srcResult.x = srcPoint.x * cs - srcPoint.y * sn;
-    srcResult.y = srcPoint.x * sn + srcPoint.y * cs;
-
-    return srcResult;
-}
 
-cv::Point2f get3rdPoint(const cv::Point2f& a, const cv::Point2f& b) {
-    cv::Point2f direct = a - b;
-    return b + cv::Point2f(-direct.y, direct.x);
-}
-
-cv::Mat getAffineTransform(float centerX,
-                           float centerY,
-                           int srcW,
-                           float rot,
-                           size_t outputWidth,
-                           size_t outputHeight,
-                           bool inv = false) {
-    float rotRad = static_cast<float>(CV_PI) * rot / 180.0f;
-    auto srcDir = getDir({0.0f, -0.5f * srcW}, rotRad);
-    cv::Point2f dstDir(0.0f, -0.5f * outputWidth);
-    std::vector<cv::Point2f> src(3, {0.0f, 0.0f});
-    std::vector<cv::Point2f> dst(3, {0.0f, 0.0f});
-
-    src[0] = {centerX, centerY};
-    src[1] = srcDir + src[0];
-    src[2] = get3rdPoint(src[0], src[1]);
-
-    dst[0] = {outputWidth * 0.5f, outputHeight * 0.5f};
-    dst[1] = dst[0] + dstDir;
-    dst[2] = get3rdPoint(dst[0], dst[1]);
-
-    cv::Mat trans;
-    if (inv) {
-        trans = cv::getAffineTransform(dst, src);
-    } else {
-        trans = cv::getAffineTransform(src, dst);
+    if (devicePostprocessing) {
+        // The highest peaks of all classes are found on the device, and the offsets and sizes of the boxes are sampled
+        // at them, so outputs of a few kilobytes are transferred instead of the maps
+        const ov::Output<ov::Node> heatMaps = getOutputSource(model, outputsNames[0]);
+        const ov::Output<ov::Node> offsets = getOutputSource(model, outputsNames[1]);
+        const ov::Output<ov::Node> sizes = getOutputSource(model, outputsNames[2]);
+        const ov::OutputVector peaks = addHeatmapPeaks(heatMaps, MAX_DETECTIONS_NUM, true);
+        // The shape is an output too, as spatial dims of the heat map are dynamic with input buckets
+        const auto shape = std::make_shared<ov::opset8::ShapeOf>(heatMaps, ov::element::i32);
+        const auto mapSize = std::make_shared<ov::opset8::ReduceProd>(
+            std::make_shared<ov::opset8::Gather>(shape,
+                                                 ov::opset8::Constant::create(ov::element::i64, ov::Shape{2}, {2, 3}),
+                                                 ov::opset8::Constant::create(ov::element::i64, ov::Shape{}, {0})),
+            ov::opset8::Constant::create(ov::element::i64, ov::Shape{1}, {0}),
+            false);
+        const auto positions = std::make_shared<ov::opset8::FloorMod>(peaks[1], mapSize);
+        replaceOutputs(model,
+                       {{"peak_scores", peaks[0]},
+                        {"peak_indices", peaks[1]},
+                        {"peak_offsets", gatherAtPeaks(offsets, positions)},
+                        {"peak_sizes", gatherAtPeaks(sizes, positions)},
+                        {"heatmap_shape", shape}});
     }
-
-    return trans;
 }
 
 std::shared_ptr<InternalModelData> ModelCenterNet::preprocess(const InputData& inputData, ov::InferRequest& request) {
     auto& img = inputData.asRef<ImageInputData>().inputImage;
-    const auto& resizedImg = resizeImageExt(img, netInputWidth, netInputHeight, RESIZE_KEEP_ASPECT_LETTERBOX);
+    const cv::Size inputSize = getInputSize(img.size());
+    if (inputTransform.isTrivialTransform() && img.type() == CV_8UC3) {
+        // The image is letterboxed right into the input tensor of the request. The padding stays in the tensor, so it
+        // is filled again only if the size of the image or of the tensor changes.
+        ov::Tensor tensor = request.get_input_tensor();
+        if (!bucketSizes.empty()) {
+            tensor.set_shape({1, static_cast<size_t>(inputSize.height), static_cast<size_t>(inputSize.width), 3});
+        }
+        cv::Mat tensorMat(inputSize, CV_8UC3, tensor.data());
+        const std::pair<cv::Size, cv::Size> sizes(img.size(), inputSize);
+        std::pair<cv::Size, cv::Size>& letterboxedSize = letterboxedSizes[tensor.data()];
+        resizeImageExt(img, tensorMat, RESIZE_KEEP_ASPECT_LETTERBOX, false, nullptr, letterboxedSize == sizes);
+        letterboxedSize = sizes;
+        return std::make_shared<InternalImageModelData>(img.cols, img.rows);
+    }
+    const auto& resizedImg = resizeImageExt(img, inputSize.width, inputSize.height, RESIZE_KEEP_ASPECT_LETTERBOX);
 
     request.set_input_tensor(wrapMat2Tensor(inputTransform(resizedImg)));
     return std::make_shared<InternalImageModelData>(img.cols, img.rows);
 }
 
-std::vector<std::pair<size_t, float>> nms(float* scoresPtr, const ov::Shape& shape, float threshold, int kernel = 3) {
-    std::vector<std::pair<size_t, float>> scores;
-    scores.reserve(ModelCenterNet::INIT_VECTOR_SIZE);
-    auto chSize = shape[2] * shape[3];
+namespace {
+float sigmoid(float x) {
+    return expf(x) / (1 + expf(x));
+}
 
-    for (size_t i = 0; i < shape[1] * shape[2] * shape[3]; ++i) {
-        scoresPtr[i] = expf(scoresPtr[i]) / (1 + expf(scoresPtr[i]));
+bool isHigher(const std::pair<size_t, float>& l, const std::pair<size_t, float>& r) {
+    return l.second > r.second;
+}
+}  // namespace
+
+/// Finds the peaks of the heat map which pass the threshold and are the maxima of their 3x3 neighbourhoods, at most
+/// maxNum of the highest ones are returned in descending order of the scores. The heat map holds logits and sigmoid is
+/// monotonic, so the pixels are thresholded by the logit first and scores are calculated only for the candidates.
+/// Only the rows having candidates are max pooled: maxima of the row and its neighbours are found for every column
+/// into columnsMax, and a candidate is compared with the maximum of three its elements.
+void nms(std::vector<std::pair<size_t, float>>& scores,
+         std::vector<float>& columnsMax,
+         const float* logitsPtr,
+         const ov::Shape& shape,
+         float threshold,
+         size_t maxNum) {
+    scores.clear();
+    const size_t height = shape[2];
+    const size_t width = shape[3];
+    const size_t chSize = height * width;
+    // The logit threshold is loosened to keep the candidates whose rounded score still passes the threshold
+    const double looseThreshold = threshold - 1e-4;
+    float logitThreshold = -std::numeric_limits<float>::infinity();
+    if (looseThreshold >= 1) {
+        logitThreshold = std::numeric_limits<float>::infinity();
+    } else if (looseThreshold > 0) {
+        logitThreshold = static_cast<float>(std::log(looseThreshold / (1 - looseThreshold)));
     }
+    columnsMax.resize(width);
 
     for (size_t ch = 0; ch < shape[1]; ++ch) {
-        for (size_t w = 0; w < shape[2]; ++w) {
-            for (size_t h = 0; h < shape[3]; ++h) {
-                float max = scoresPtr[chSize * ch + shape[2] * w + h];
+        const float* logits = logitsPtr + ch * chSize;
+        for (size_t y = 0; y < height; ++y) {
+            const float* row = logits + y * width;
+            // ---------------------  filter on threshold--------------------------------------
+            bool hasCandidates = false;
+            for (size_t x = 0; x < width; ++x) {
+                hasCandidates |= row[x] >= logitThreshold;
+            }
+            if (!hasCandidates) {
+                continue;
+            }
 
-                // ---------------------  filter on threshold--------------------------------------
-                if (max < threshold) {
+            // ---------------------- maxpool2d -----------------------------------------------
+            const float* upperRow = y > 0 ? row - width : row;
+            const float* lowerRow = y + 1 < height ? row + width : row;
+            for (size_t x = 0; x < width; ++x) {
+                columnsMax[x] = std::max(std::max(upperRow[x], row[x]), lowerRow[x]);
+            }
+            for (size_t x = 0; x < width; ++x) {
+                if (row[x] < logitThreshold) {
+                    continue;
+                }
+                float neighboursMax = columnsMax[x];
+                if (x > 0) {
+                    neighboursMax = std::max(neighboursMax, columnsMax[x - 1]);
+                }
+                if (x + 1 < width) {
+                    neighboursMax = std::max(neighboursMax, columnsMax[x + 1]);
+                }
+                const float score = sigmoid(row[x]);
+                if (score < threshold) {
+                    continue;
+                }
+                // Different logits may have equal rounded scores, the peak is suppressed only by a higher score
+                if (neighboursMax > row[x] && sigmoid(neighboursMax) > score) {
                     continue;
                 }
 
                 // ---------------------  store index and score------------------------------------
-                scores.push_back({chSize * ch + shape[2] * w + h, max});
-
-                bool next = true;
-                // ---------------------- maxpool2d -----------------------------------------------
-                for (int i = -kernel / 2; i < kernel / 2 + 1 && next; ++i) {
-                    for (int j = -kernel / 2; j < kernel / 2 + 1; ++j) {
-                        if (w + i >= 0 && w + i < shape[2] && h + j >= 0 && h + j < shape[3]) {
-                            if (scoresPtr[chSize * ch + shape[2] * (w + i) + h + j] > max) {
-                                scores.pop_back();
-                                next = false;
-                                break;
-                            }
-                        } else {
-                            if (max < 0) {
-                                scores.pop_back();
-                                next = false;
-                                break;
-                            }
-                        }
+                if (scores.size() == maxNum) {
+                    if (score <= scores.front().second) {
+                        continue;
                     }
+                    std::pop_heap(scores.begin(), scores.end(), isHigher);
+                    scores.pop_back();
                 }
+                scores.push_back({chSize * ch + y * width + x, score});
+                std::push_heap(scores.begin(), scores.end(), isHigher);
             }
         }
     }
-
-    return scores;
-}
-
-static std::vector<std::pair<size_t, float>> filterScores(const ov::Tensor& scoresTensor, float threshold) {
-    auto shape = scoresTensor.get_shape();
-    float* scoresPtr = scoresTensor.data<float>();
-
-    return nms(scoresPtr, shape, threshold);
+    std::sort_heap(scores.begin(), scores.end(), isHigher);
 }
 
-std::vector<std::pair<float, float>> filterReg(const ov::Tensor& regressionTensor,
-                                               const std::vector<std::pair<size_t, float>>& scores,
-                                               size_t chSize) {
+/// Gathers the offsets and sizes of the detections and calculates their boxes in one pass
+void calcBoxes(std::vector<ModelCenterNet::BBox>& boxes,
+               const std::vector<std::pair<size_t, float>>& scores,
+               const ov::Tensor& regressionTensor,
+               const ov::Tensor& whTensor,
+               const ov::Shape& shape) {
+    const size_t chSize = shape[2] * shape[3];
     const float* regPtr = regressionTensor.data<float>();
-    std::vector<std::pair<float, float>> reg;
-
-    for (auto s : scores) {
-        reg.push_back({regPtr[s.first % chSize], regPtr[chSize + s.first % chSize]});
-    }
-
-    return reg;
-}
-
-std::vector<std::pair<float, float>> filterWH(const ov::Tensor& whTensor,
-                                              const std::vector<std::pair<size_t, float>>& scores,
-                                              size_t chSize) {
     const float* whPtr = whTensor.data<float>();
-    std::vector<std::pair<float, float>> wh;
-
-    for (auto s : scores) {
-        wh.push_back({whPtr[s.first % chSize], whPtr[chSize + s.first % chSize]});
-    }
-
-    return wh;
-}
-
-std::vector<ModelCenterNet::BBox> calcBoxes(const std::vector<std::pair<size_t, float>>& scores,
-                                            const std::vector<std::pair<float, float>>& reg,
-                                            const std::vector<std::pair<float, float>>& wh,
-                                            const ov::Shape& shape) {
-    std::vector<ModelCenterNet::BBox> boxes(scores.size());
+    boxes.resize(scores.size());
 
     for (size_t i = 0; i < boxes.size(); ++i) {
-        size_t chIdx = scores[i].first % (shape[2] * shape[3]);
+        size_t chIdx = scores[i].first % chSize;
         auto xCenter = chIdx % shape[3];
         auto yCenter = chIdx / shape[3];
-
-        boxes[i].left = xCenter + reg[i].first - wh[i].first / 2.0f;
-        boxes[i].top = yCenter + reg[i].second - wh[i].second / 2.0f;
-        boxes[i].right = xCenter + reg[i].first + wh[i].first / 2.0f;
-        boxes[i].bottom = yCenter + reg[i].second + wh[i].second / 2.0f;
+        const float regX = regPtr[chIdx];
+        const float regY = regPtr[chSize + chIdx];
+        const float w = whPtr[chIdx];
+        const float h = whPtr[chSize + chIdx];
+
+        boxes[i].left = xCenter + regX - w / 2.0f;
+        boxes[i].top = yCenter + regY - h / 2.0f;
+        boxes[i].right = xCenter + regX + w / 2.0f;
+        boxes[i].bottom = yCenter + regY + h / 2.0f;
     }
+}
 
-    return boxes;
+/// Takes the peaks found on the device (see ModelCenterNet::setDevicePostprocessing()) which pass the threshold and
+/// calculates their boxes from the offsets and sizes sampled at them. The peaks come in descending order of the logits.
+void calcPeaksBoxes(std::vector<ModelCenterNet::BBox>& boxes,
+                    std::vector<std::pair<size_t, float>>& scores,
+                    const InferenceResult& infResult,
+                    const ov::Shape& shape,
+                    float threshold) {
+    const ov::Tensor& logitsTensor = infResult.outputsData[0];
+    const size_t peaksNum = logitsTensor.get_size();
+    const float* logits = logitsTensor.data<float>();
+    const int32_t* indices = infResult.outputsData[1].data<int32_t>();
+    const float* offsets = infResult.outputsData[2].data<float>();
+    const float* sizes = infResult.outputsData[3].data<float>();
+    const size_t chSize = shape[2] * shape[3];
+    scores.clear();
+    boxes.clear();
+    for (size_t i = 0; i < peaksNum; ++i) {
+        const float score = sigmoid(logits[i]);
+        if (score < threshold) {
+            break;
+        }
+        const size_t idx = static_cast<size_t>(indices[i]);
+        scores.push_back({idx, score});
+
+        const float xCenter = static_cast<float>(idx % chSize % shape[3]) + offsets[i];
+        const float yCenter = static_cast<float>(idx % chSize / shape[3]) + offsets[peaksNum + i];
+        const float w = sizes[i];
+        const float h = sizes[peaksNum + i];
+        boxes.push_back({xCenter - w / 2.0f, yCenter - h / 2.0f, xCenter + w / 2.0f, yCenter + h / 2.0f});
+    }
 }
 
-void transform(std::vector<ModelCenterNet::BBox>& boxes,
-               const ov::Shape& shape,
-               int scale,
-               float centerX,
-               float centerY) {
-    cv::Mat1f trans = getAffineTransform(centerX, centerY, scale, 0, shape[2], shape[3], true);
+/// Maps the boxes from the heat map to the image letterboxed into the model input: the image is scaled to fit the
+/// heat map and centered in it
+void transform(std::vector<ModelCenterNet::BBox>& boxes, const ov::Shape& shape, int imgWidth, int imgHeight) {
+    const float scale = std::min(static_cast<float>(shape[3]) / imgWidth, static_cast<float>(shape[2]) / imgHeight);
+    const float dx = (shape[3] - imgWidth * scale) / 2.0f;
+    const float dy = (shape[2] - imgHeight * scale) / 2.0f;
 
     for (auto& b : boxes) {
-        ModelCenterNet::BBox newbb;
-
-        newbb.left = trans.at<float>(0, 0) * b.left + trans.at<float>(0, 1) * b.top + trans.at<float>(0, 2);
-        newbb.top = trans.at<float>(1, 0) * b.left + trans.at<float>(1, 1) * b.top + trans.at<float>(1, 2);
-        newbb.right = trans.at<float>(0, 0) * b.right + trans.at<float>(0, 1) * b.bottom + trans.at<float>(0, 2);
-        newbb.bottom = trans.at<float>(1, 0) * b.right + trans.at<float>(1, 1) * b.bottom + trans.at<float>(1, 2);
-
-        b = newbb;
+        b.left = (b.left - dx) / scale;
+        b.top = (b.top - dy) / scale;
+        b.right = (b.right - dx) / scale;
+        b.bottom = (b.bottom - dy) / scale;
     }
 }
 
 std::unique_ptr<ResultBase> ModelCenterNet::postprocess(InferenceResult& infResult) {
-    // --------------------------- Filter data and get valid indices ---------------------------------
-    const auto& heatmapTensor = infResult.outputsData[outputsNames[0]];
-    const auto& heatmapTensorShape = heatmapTensor.get_shape();
+    ov::Shape heatmapTensorShape;
+    if (devicePostprocessing) {
+        const int32_t* shape = infResult.outputsData[4].data<int32_t>();
+        heatmapTensorShape = ov::Shape(shape, shape + infResult.outputsData[4].get_size());
+        calcPeaksBoxes(boxes, scores, infResult, heatmapTensorShape, confidenceThreshold);
+    } else {
+        // --------------------------- Filter data and get valid indices ---------------------------------
+        const auto& heatmapTensor = infResult.outputsData[0];
+        heatmapTensorShape = heatmapTensor.get_shape();
+        nms(scores,
+            columnsMax,
+            heatmapTensor.data<float>(),
+            heatmapTensorShape,
+            confidenceThreshold,
+            MAX_DETECTIONS_NUM);
+
+        // --------------------------- Calculate bounding boxes ------------------------------------------
+        const auto& regressionTensor = infResult.outputsData[1];
+        const auto& whTensor = infResult.outputsData[2];
+        calcBoxes(boxes, scores, regressionTensor, whTensor, heatmapTensorShape);
+    }
     const auto chSize = heatmapTensorShape[2] * heatmapTensorShape[3];
-    const auto scores = filterScores(heatmapTensor, confidenceThreshold);
-
-    const auto& regressionTensor = infResult.outputsData[outputsNames[1]];
-    const auto reg = filterReg(regressionTensor, scores, chSize);
 
-    const auto& whTensor = infResult.outputsData[outputsNames[2]];
-    const auto wh = filterWH(whTensor, scores, chSize);
-
-    // --------------------------- Calculate bounding boxes & apply inverse affine transform ----------
-    auto boxes = calcBoxes(scores, reg, wh, heatmapTensorShape);
+    // --------------------------- Map bounding boxes to the image -----------------------------------
 
     const auto imgWidth = infResult.internalModelData->asRef<InternalImageModelData>().inputImgWidth;
     const auto imgHeight = infResult.internalModelData->asRef<InternalImageModelData>().inputImgHeight;
-    const auto scale = std::max(imgWidth, imgHeight);
-    const float centerX = imgWidth / 2.0f;
-    const float centerY = imgHeight / 2.0f;
-
-    transform(boxes, heatmapTensorShape, scale, centerX, centerY);
+    transform(boxes, heatmapTensorShape, imgWidth, imgHeight);
 
     // --------------------------- Create detection result objects ------------------------------------
     DetectionResult* result = new DetectionResult(infResult.frameId, infResult.metaData);
+    result->labels = labelsTable;
 
     result->objects.reserve(scores.size());
     for (size_t i = 0; i < scores.size(); ++i) {
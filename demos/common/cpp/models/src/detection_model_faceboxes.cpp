@@ -20,6 +20,7 @@
 #include <cmath>
 #include <map>
 #include <stdexcept>
+#include <string>
 
 #include <openvino/openvino.hpp>
 
@@ -27,6 +28,7 @@
 #include <utils/nms.hpp>
 #include <utils/ocv_common.hpp>
 
+#include "models/anchor_table.h"
 #include "models/internal_model_data.h"
 #include "models/results.h"
 
@@ -97,10 +99,14 @@ void ModelFaceBoxes::prepareInputsOutputs(std::shared_ptr<ov::Model>& model) {
         featureMaps.push_back({netInputHeight / s, netInputWidth / s});
     }
 
-    priorBoxes(featureMaps);
+    anchors = getSharedAnchorTable(
+        "FaceBoxes " + std::to_string(netInputWidth) + "x" + std::to_string(netInputHeight),
+        [&](AnchorTable& table) {
+            priorBoxes(featureMaps, table);
+        });
 }
 
-void calculateAnchors(std::vector<ModelFaceBoxes::Anchor>& anchors,
+void calculateAnchors(AnchorTable& anchors,
                       const std::vector<float>& vx,
                       const std::vector<float>& vy,
                       const int minSize,
@@ -120,13 +126,15 @@ void calculateAnchors(std::vector<ModelFaceBoxes::Anchor>& anchors,
 
     for (auto cy : dense_cy) {
         for (auto cx : dense_cx) {
-            anchors.push_back(
-                {cx - 0.5f * skx, cy - 0.5f * sky, cx + 0.5f * skx, cy + 0.5f * sky});  // left top right bottom
+            anchors.add(ModelFaceBoxes::Anchor{cx - 0.5f * skx,
+                                               cy - 0.5f * sky,
+                                               cx + 0.5f * skx,
+                                               cy + 0.5f * sky});  // left top right bottom
         }
     }
 }
 
-void calculateAnchorsZeroLevel(std::vector<ModelFaceBoxes::Anchor>& anchors,
+void calculateAnchorsZeroLevel(AnchorTable& anchors,
                                const int fx,
                                const int fy,
                                const std::vector<int>& minSizes,
@@ -157,50 +165,60 @@ void calculateAnchorsZeroLevel(std::vector<ModelFaceBoxes::Anchor>& anchors,
     }
 }
 
-void ModelFaceBoxes::priorBoxes(const std::vector<std::pair<size_t, size_t>>& featureMaps) {
-    anchors.reserve(maxProposalsCount);
+void ModelFaceBoxes::priorBoxes(const std::vector<std::pair<size_t, size_t>>& featureMaps, AnchorTable& table) const {
+    table.xCenters.reserve(maxProposalsCount);
+    table.yCenters.reserve(maxProposalsCount);
+    table.widths.reserve(maxProposalsCount);
+    table.heights.reserve(maxProposalsCount);
 
     for (size_t k = 0; k < featureMaps.size(); ++k) {
         std::vector<float> a;
         for (size_t i = 0; i < featureMaps[k].first; ++i) {
             for (size_t j = 0; j < featureMaps[k].second; ++j) {
                 if (k == 0) {
-                    calculateAnchorsZeroLevel(anchors, j, i, minSizes[k], steps[k]);
+                    calculateAnchorsZeroLevel(table, j, i, minSizes[k], steps[k]);
                 } else {
-                    calculateAnchors(anchors, {j + 0.5f}, {i + 0.5f}, minSizes[k][0], steps[k]);
+                    calculateAnchors(table, {j + 0.5f}, {i + 0.5f}, minSizes[k][0], steps[k]);
                 }
             }
         }
     }
 }
 
-std::pair<std::vector<size_t>, std::vector<float>> filterScores(const ov::Tensor& scoresTensor,
-                                                                const float confidenceThreshold) {
+void filterScores(std::vector<size_t>& indices,
+                  std::vector<float>& scores,
+                  const ov::Tensor& scoresTensor,
+                  const float confidenceThreshold) {
     auto shape = scoresTensor.get_shape();
-    const float* scoresPtr = scoresTensor.data<float>();
+    // Every proposal has background and face scores, only the face ones are checked
+    const float* faceScoresPtr = scoresTensor.data<float>() + 1;
 
-    std::vector<size_t> indices;
-    std::vector<float> scores;
+    indices.clear();
+    scores.clear();
     scores.reserve(ModelFaceBoxes::INIT_VECTOR_SIZE);
     indices.reserve(ModelFaceBoxes::INIT_VECTOR_SIZE);
-    for (size_t i = 1; i < shape[1] * shape[2]; i = i + 2) {
-        if (scoresPtr[i] > confidenceThreshold) {
-            indices.push_back(i / 2);
-            scores.push_back(scoresPtr[i]);
-        }
-    }
-
-    return {indices, scores};
+    forEachValidScore(
+        faceScoresPtr,
+        shape[1] * shape[2] / 2,
+        2,
+        [confidenceThreshold](float score) {
+            return score > confidenceThreshold;
+        },
+        [&](size_t i) {
+            indices.push_back(i);
+            scores.push_back(faceScoresPtr[i * 2]);
+        });
 }
 
-std::vector<ModelFaceBoxes::Anchor> filterBoxes(const ov::Tensor& boxesTensor,
-                                                const std::vector<ModelFaceBoxes::Anchor>& anchors,
-                                                const std::vector<size_t>& validIndices,
-                                                const std::vector<float>& variance) {
+void filterBoxes(std::vector<ModelFaceBoxes::Anchor>& boxes,
+                 const ov::Tensor& boxesTensor,
+                 const AnchorTable& anchors,
+                 const std::vector<size_t>& validIndices,
+                 const std::vector<float>& variance) {
     auto shape = boxesTensor.get_shape();
     const float* boxesPtr = boxesTensor.data<float>();
 
-    std::vector<ModelFaceBoxes::Anchor> boxes;
+    boxes.clear();
     boxes.reserve(ModelFaceBoxes::INIT_VECTOR_SIZE);
     for (auto i : validIndices) {
         auto objStart = shape[2] * i;
@@ -210,34 +228,33 @@ std::vector<ModelFaceBoxes::Anchor> filterBoxes(const ov::Tensor& boxesTensor,
         auto dw = boxesPtr[objStart + 2];
         auto dh = boxesPtr[objStart + 3];
 
-        auto predCtrX = dx * variance[0] * anchors[i].getWidth() + anchors[i].getXCenter();
-        auto predCtrY = dy * variance[0] * anchors[i].getHeight() + anchors[i].getYCenter();
-        auto predW = exp(dw * variance[1]) * anchors[i].getWidth();
-        auto predH = exp(dh * variance[1]) * anchors[i].getHeight();
+        auto predCtrX = dx * variance[0] * anchors.widths[i] + anchors.xCenters[i];
+        auto predCtrY = dy * variance[0] * anchors.heights[i] + anchors.yCenters[i];
+        auto predW = exp(dw * variance[1]) * anchors.widths[i];
+        auto predH = exp(dh * variance[1]) * anchors.heights[i];
 
         boxes.push_back({static_cast<float>(predCtrX - 0.5f * predW),
                          static_cast<float>(predCtrY - 0.5f * predH),
                          static_cast<float>(predCtrX + 0.5f * predW),
                          static_cast<float>(predCtrY + 0.5f * predH)});
     }
-
-    return boxes;
 }
 
 std::unique_ptr<ResultBase> ModelFaceBoxes::postprocess(InferenceResult& infResult) {
     // Filter scores and get valid indices for bounding boxes
-    const auto scoresTensor = infResult.outputsData[outputsNames[1]];
-    const auto scores = filterScores(scoresTensor, confidenceThreshold);
+    const auto scoresTensor = infResult.outputsData[1];
+    filterScores(validIndices, scores, scoresTensor, confidenceThreshold);
 
     // Filter bounding boxes on indices
-    auto boxesTensor = infResult.outputsData[outputsNames[0]];
-    std::vector<Anchor> boxes = filterBoxes(boxesTensor, anchors, scores.first, variance);
+    auto boxesTensor = infResult.outputsData[0];
+    filterBoxes(boxes, boxesTensor, *anchors, validIndices, variance);
 
     // Apply Non-maximum Suppression
-    const std::vector<int> keep = nms(boxes, scores.second, boxIOUThreshold);
+    const std::vector<int> keep = nms(boxes, scores, boxIOUThreshold);
 
     // Create detection result objects
     DetectionResult* result = new DetectionResult(infResult.frameId, infResult.metaData);
+    result->labels = labelsTable;
     const auto imgWidth = infResult.internalModelData->asRef<InternalImageModelData>().inputImgWidth;
     const auto imgHeight = infResult.internalModelData->asRef<InternalImageModelData>().inputImgHeight;
     const float scaleX = static_cast<float>(netInputWidth) / imgWidth;
@@ -246,13 +263,13 @@ std::unique_ptr<ResultBase> ModelFaceBoxes::postprocess(InferenceResult& infResu
     result->objects.reserve(keep.size());
     for (auto i : keep) {
         DetectedObject desc;
-        desc.confidence = scores.second[i];
+        desc.confidence = scores[i];
         desc.x = clamp(boxes[i].left / scaleX, 0.f, static_cast<float>(imgWidth));
         desc.y = clamp(boxes[i].top / scaleY, 0.f, static_cast<float>(imgHeight));
         desc.width = clamp(boxes[i].getWidth() / scaleX, 0.f, static_cast<float>(imgWidth));
         desc.height = clamp(boxes[i].getHeight() / scaleY, 0.f, static_cast<float>(imgHeight));
         desc.labelID = 0;
-        desc.label = labels[0];
+        desc.label = getLabelName(0);
 
         result->objects.push_back(desc);
     }
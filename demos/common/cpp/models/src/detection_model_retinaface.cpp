@@ -21,6 +21,7 @@
 #include <algorithm>
 #include <cmath>
 #include <stdexcept>
+#include <string>
 
 #include <opencv2/core.hpp>
 #include <openvino/openvino.hpp>
@@ -28,6 +29,7 @@
 #include <utils/common.hpp>
 #include <utils/nms.hpp>
 
+#include "models/anchor_table.h"
 #include "models/internal_model_data.h"
 #include "models/results.h"
 
@@ -87,6 +89,7 @@ void ModelRetinaFace::prepareInputsOutputs(std::shared_ptr<ov::Model>& model) {
 
     const ov::Layout outputLayout{"NCHW"};
     std::vector<size_t> outputsSizes[OUT_MAX];
+    std::vector<size_t> boxesWidths;
     for (const auto& output : model->outputs()) {
         auto outTensorName = output.get_any_name();
         outputsNames.push_back(outTensorName);
@@ -118,31 +121,36 @@ void ModelRetinaFace::prepareInputsOutputs(std::shared_ptr<ov::Model>& model) {
                 break;
             }
         }
-        separateOutputsNames[type].insert(separateOutputsNames[type].begin() + i, outTensorName);
+        separateOutputsIndices[type].insert(separateOutputsIndices[type].begin() + i, outputsNames.size() - 1);
         outputsSizes[type].insert(outputsSizes[type].begin() + i, num);
+        if (type == OUT_BOXES) {
+            boxesWidths.insert(boxesWidths.begin() + i, output.get_shape()[ov::layout::width_idx(outputLayout)]);
+        }
     }
     model = ppp.build();
 
     for (size_t idx = 0; idx < outputsSizes[OUT_BOXES].size(); ++idx) {
-        size_t width = outputsSizes[OUT_BOXES][idx];
-        size_t height = outputsSizes[OUT_BOXES][idx];
-        auto s = anchorCfg[idx].stride;
-        auto anchorNum = anchorsFpn[s].size();
-
-        anchors.push_back(std::vector<ModelRetinaFace::Anchor>(height * width * anchorNum));
-        for (size_t iw = 0; iw < width; ++iw) {
-            size_t sw = iw * s;
+        const size_t width = boxesWidths[idx];
+        const size_t height = outputsSizes[OUT_BOXES][idx];
+        const int s = anchorCfg[idx].stride;
+        const std::vector<Anchor>& anchorsBase = anchorsFpn[s];
+        const std::string key = "RetinaFace " + std::to_string(s) + " " + std::to_string(width) + "x" +
+                                std::to_string(height);
+        anchors.push_back(getSharedAnchorTable(key, [&](AnchorTable& table) {
+            const size_t anchorNum = anchorsBase.size();
+            table.resize(height * width * anchorNum);
             for (size_t ih = 0; ih < height; ++ih) {
-                size_t sh = ih * s;
-                for (size_t k = 0; k < anchorNum; ++k) {
-                    Anchor& anc = anchors[idx][(ih * width + iw) * anchorNum + k];
-                    anc.left = anchorsFpn[s][k].left + sw;
-                    anc.top = anchorsFpn[s][k].top + sh;
-                    anc.right = anchorsFpn[s][k].right + sw;
-                    anc.bottom = anchorsFpn[s][k].bottom + sh;
+                float sh = static_cast<float>(ih * s);
+                for (size_t iw = 0; iw < width; ++iw) {
+                    float sw = static_cast<float>(iw * s);
+                    for (size_t k = 0; k < anchorNum; ++k) {
+                        const Anchor& base = anchorsBase[k];
+                        table.set((ih * width + iw) * anchorNum + k,
+                                  Anchor{base.left + sw, base.top + sh, base.right + sw, base.bottom + sh});
+                    }
                 }
             }
-        }
+        }));
     }
 }
 
@@ -209,26 +217,28 @@ void ModelRetinaFace::generateAnchorsFpn() {
     }
 }
 
-std::vector<size_t> thresholding(const ov::Tensor& scoresTensor, const int anchorNum, const float confidenceThreshold) {
-    std::vector<size_t> indices;
-    indices.reserve(ModelRetinaFace::INIT_VECTOR_SIZE);
+void thresholding(std::vector<size_t>& indices,
+                  const ov::Tensor& scoresTensor,
+                  const size_t anchorNum,
+                  const float confidenceThreshold) {
+    indices.clear();
     auto shape = scoresTensor.get_shape();
-    size_t restAnchors = shape[1] - anchorNum;
+    const size_t restAnchors = shape[1] - anchorNum;
+    const size_t planeSize = shape[2] * shape[3];
     const float* scoresPtr = scoresTensor.data<float>();
 
     for (size_t x = anchorNum; x < shape[1]; ++x) {
-        for (size_t y = 0; y < shape[2]; ++y) {
-            for (size_t z = 0; z < shape[3]; ++z) {
-                auto idx = (x * shape[2] + y) * shape[3] + z;
-                auto score = scoresPtr[idx];
-                if (score >= confidenceThreshold) {
-                    indices.push_back((y * shape[3] + z) * restAnchors + (x - anchorNum));
-                }
-            }
-        }
+        forEachValidScore(
+            scoresPtr + x * planeSize,
+            planeSize,
+            1,
+            [confidenceThreshold](float score) {
+                return score >= confidenceThreshold;
+            },
+            [&](size_t position) {
+                indices.push_back(position * restAnchors + (x - anchorNum));
+            });
     }
-
-    return indices;
 }
 
 void filterScores(std::vector<float>& scores,
@@ -249,7 +259,7 @@ void filterBoxes(std::vector<ModelRetinaFace::Anchor>& boxes,
                  const std::vector<size_t>& indices,
                  const ov::Tensor& boxesTensor,
                  int anchorNum,
-                 const std::vector<ModelRetinaFace::Anchor>& anchors) {
+                 const AnchorTable& anchors) {
     const auto& shape = boxesTensor.get_shape();
     const float* boxesPtr = boxesTensor.data<float>();
     const auto boxPredLen = shape[1] / anchorNum;
@@ -263,10 +273,10 @@ void filterBoxes(std::vector<ModelRetinaFace::Anchor>& boxes,
         const auto dw = boxesPtr[offset + blockWidth * 2];
         const auto dh = boxesPtr[offset + blockWidth * 3];
 
-        const auto predCtrX = dx * anchors[i].getWidth() + anchors[i].getXCenter();
-        const auto predCtrY = dy * anchors[i].getHeight() + anchors[i].getYCenter();
-        const auto predW = exp(dw) * anchors[i].getWidth();
-        const auto predH = exp(dh) * anchors[i].getHeight();
+        const auto predCtrX = dx * anchors.widths[i] + anchors.xCenters[i];
+        const auto predCtrY = dy * anchors.heights[i] + anchors.yCenters[i];
+        const auto predW = exp(dw) * anchors.widths[i];
+        const auto predH = exp(dh) * anchors.heights[i];
 
         boxes.push_back({static_cast<float>(predCtrX - 0.5f * (predW - 1.0f)),
                          static_cast<float>(predCtrY - 0.5f * (predH - 1.0f)),
@@ -279,7 +289,7 @@ void filterLandmarks(std::vector<cv::Point2f>& landmarks,
                      const std::vector<size_t>& indices,
                      const ov::Tensor& landmarksTensor,
                      int anchorNum,
-                     const std::vector<ModelRetinaFace::Anchor>& anchors,
+                     const AnchorTable& anchors,
                      const float landmarkStd) {
     const auto& shape = landmarksTensor.get_shape();
     const float* landmarksPtr = landmarksTensor.data<float>();
@@ -287,12 +297,12 @@ void filterLandmarks(std::vector<cv::Point2f>& landmarks,
     const auto blockWidth = shape[2] * shape[3];
 
     for (auto i : indices) {
+        const auto offset = (i % anchorNum) * landmarkPredLen * shape[2] * shape[3] + i / anchorNum;
         for (int j = 0; j < ModelRetinaFace::LANDMARKS_NUM; ++j) {
-            auto offset = (i % anchorNum) * landmarkPredLen * shape[2] * shape[3] + i / anchorNum;
             auto deltaX = landmarksPtr[offset + j * 2 * blockWidth] * landmarkStd;
             auto deltaY = landmarksPtr[offset + (j * 2 + 1) * blockWidth] * landmarkStd;
-            landmarks.push_back({deltaX * anchors[i].getWidth() + anchors[i].getXCenter(),
-                                 deltaY * anchors[i].getHeight() + anchors[i].getYCenter()});
+            landmarks.push_back({deltaX * anchors.widths[i] + anchors.xCenters[i],
+                                 deltaY * anchors.heights[i] + anchors.yCenters[i]});
         }
     }
 }
@@ -312,12 +322,13 @@ void filterMasksScores(std::vector<float>& masks,
 }
 
 std::unique_ptr<ResultBase> ModelRetinaFace::postprocess(InferenceResult& infResult) {
-    std::vector<float> scores;
+    // The buffers keep their capacity, so the frames with the usual number of faces don't allocate them
+    scores.clear();
     scores.reserve(INIT_VECTOR_SIZE);
-    std::vector<Anchor> boxes;
+    boxes.clear();
     boxes.reserve(INIT_VECTOR_SIZE);
-    std::vector<cv::Point2f> landmarks;
-    std::vector<float> masks;
+    landmarks.clear();
+    masks.clear();
 
     if (shouldDetectLandmarks) {
         landmarks.reserve(INIT_VECTOR_SIZE);
@@ -325,24 +336,25 @@ std::unique_ptr<ResultBase> ModelRetinaFace::postprocess(InferenceResult& infRes
     if (shouldDetectMasks) {
         masks.reserve(INIT_VECTOR_SIZE);
     }
+    validIndices.reserve(INIT_VECTOR_SIZE);
 
     // --------------------------- Gather & Filter output from all levels
     // ----------------------------------------------------------
     for (size_t idx = 0; idx < anchorCfg.size(); ++idx) {
-        const auto boxRaw = infResult.outputsData[separateOutputsNames[OUT_BOXES][idx]];
-        const auto scoresRaw = infResult.outputsData[separateOutputsNames[OUT_SCORES][idx]];
+        const auto boxRaw = infResult.outputsData[separateOutputsIndices[OUT_BOXES][idx]];
+        const auto scoresRaw = infResult.outputsData[separateOutputsIndices[OUT_SCORES][idx]];
         auto s = anchorCfg[idx].stride;
         auto anchorNum = anchorsFpn[s].size();
 
-        auto validIndices = thresholding(scoresRaw, anchorNum, confidenceThreshold);
+        thresholding(validIndices, scoresRaw, anchorNum, confidenceThreshold);
         filterScores(scores, validIndices, scoresRaw, anchorNum);
-        filterBoxes(boxes, validIndices, boxRaw, anchorNum, anchors[idx]);
+        filterBoxes(boxes, validIndices, boxRaw, anchorNum, *anchors[idx]);
         if (shouldDetectLandmarks) {
-            const auto landmarksRaw = infResult.outputsData[separateOutputsNames[OUT_LANDMARKS][idx]];
-            filterLandmarks(landmarks, validIndices, landmarksRaw, anchorNum, anchors[idx], landmarkStd);
+            const auto landmarksRaw = infResult.outputsData[separateOutputsIndices[OUT_LANDMARKS][idx]];
+            filterLandmarks(landmarks, validIndices, landmarksRaw, anchorNum, *anchors[idx], landmarkStd);
         }
         if (shouldDetectMasks) {
-            const auto masksRaw = infResult.outputsData[separateOutputsNames[OUT_MASKSCORES][idx]];
+            const auto masksRaw = infResult.outputsData[separateOutputsIndices[OUT_MASKSCORES][idx]];
             filterMasksScores(masks, validIndices, masksRaw, anchorNum);
         }
     }
@@ -354,6 +366,7 @@ std::unique_ptr<ResultBase> ModelRetinaFace::postprocess(InferenceResult& infRes
     // --------------------------- Create detection result objects
     // --------------------------------------------------------
     RetinaFaceDetectionResult* result = new RetinaFaceDetectionResult(infResult.frameId, infResult.metaData);
+    result->labels = labelsTable;
 
     const auto imgWidth = infResult.internalModelData->asRef<InternalImageModelData>().inputImgWidth;
     const auto imgHeight = infResult.internalModelData->asRef<InternalImageModelData>().inputImgHeight;
@@ -377,7 +390,7 @@ std::unique_ptr<ResultBase> ModelRetinaFace::postprocess(InferenceResult& infRes
         desc.height = clamp(boxes[i].getHeight(), 0.f, static_cast<float>(imgHeight));
         //--- Default label 0 - Face. If detecting masks then labels would be 0 - No Mask, 1 - Mask
         desc.labelID = shouldDetectMasks ? (masks[i] > maskThreshold) : 0;
-        desc.label = labels[desc.labelID];
+        desc.label = getLabelName(desc.labelID);
         result->objects.push_back(desc);
 
         //--- Scaling landmarks coordinates
@@ -229,14 +229,14 @@ std::vector<ModelRetinaFacePT::Rect> ModelRetinaFacePT::getFilteredProposals(con
 
 std::unique_ptr<ResultBase> ModelRetinaFacePT::postprocess(InferenceResult& infResult) {
     // (raw_output, scale_x, scale_y, face_prob_threshold, image_size):
-    const auto boxesTensor = infResult.outputsData[outputsNames[OUT_BOXES]];
-    const auto scoresTensor = infResult.outputsData[outputsNames[OUT_SCORES]];
+    const auto boxesTensor = infResult.outputsData[OUT_BOXES];
+    const auto scoresTensor = infResult.outputsData[OUT_SCORES];
 
     const auto& validIndicies = filterByScore(scoresTensor, confidenceThreshold);
     const auto& scores = getFilteredScores(scoresTensor, validIndicies);
 
     const auto& internalData = infResult.internalModelData->asRef<InternalImageModelData>();
-    const auto& landmarks = landmarksNum ? getFilteredLandmarks(infResult.outputsData[outputsNames[OUT_LANDMARKS]],
+    const auto& landmarks = landmarksNum ? getFilteredLandmarks(infResult.outputsData[OUT_LANDMARKS],
                                                                 validIndicies,
                                                                 internalData.inputImgWidth,
                                                                 internalData.inputImgHeight)
@@ -250,6 +250,7 @@ std::unique_ptr<ResultBase> ModelRetinaFacePT::postprocess(InferenceResult& infR
     // --------------------------- Create detection result objects
     // --------------------------------------------------------
     RetinaFaceDetectionResult* result = new RetinaFaceDetectionResult(infResult.frameId, infResult.metaData);
+    result->labels = labelsTable;
 
     result->objects.reserve(keptIndicies.size());
     result->landmarks.reserve(keptIndicies.size() * landmarksNum);
@@ -264,7 +265,7 @@ std::unique_ptr<ResultBase> ModelRetinaFacePT::postprocess(InferenceResult& infR
         desc.height = proposals[i].getHeight();
 
         desc.labelID = 0;
-        desc.label = labels[desc.labelID];
+        desc.label = getLabelName(desc.labelID);
         result->objects.push_back(desc);
 
         //--- Filtering landmarks coordinates
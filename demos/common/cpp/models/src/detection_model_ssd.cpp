@@ -21,6 +21,7 @@
 #include <stdexcept>
 #include <string>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include <openvino/openvino.hpp>
@@ -33,6 +34,11 @@
 
 struct InputData;
 
+namespace {
+// Size of a detection of the single output: image ID, label, confidence and box corners
+const size_t detectionSize = 7;
+}  // namespace
+
 ModelSSD::ModelSSD(const std::string& modelFileName,
                    float confidenceThreshold,
                    bool useAutoResize,
@@ -54,7 +60,7 @@ std::shared_ptr<InternalModelData> ModelSSD::preprocess(const InputData& inputDa
 }
 
 std::unique_ptr<ResultBase> ModelSSD::postprocess(InferenceResult& infResult) {
-    return outputsNames.size() > 1 ? postprocessMultipleOutputs(infResult) : postprocessSingleOutput(infResult);
+    return outputsNames.size() > 1 ? (this->*multipleOutputsDecoder)(infResult) : postprocessSingleOutput(infResult);
 }
 
 std::unique_ptr<ResultBase> ModelSSD::postprocessSingleOutput(InferenceResult& infResult) {
@@ -63,66 +69,83 @@ std::unique_ptr<ResultBase> ModelSSD::postprocessSingleOutput(InferenceResult& i
     const float* detections = detectionsTensor.data<float>();
 
     DetectionResult* result = new DetectionResult(infResult.frameId, infResult.metaData);
+
+    result->labels = labelsTable;
     auto retVal = std::unique_ptr<ResultBase>(result);
 
     const auto& internalData = infResult.internalModelData->asRef<InternalImageModelData>();
 
-    for (size_t i = 0; i < detectionsNum; i++) {
-        float image_id = detections[i * objectSize + 0];
-        if (image_id < 0) {
+    // Detections are filtered by confidence before decoding, so memory for objects is reserved once
+    size_t validDetectionsNum = 0;
+    size_t objectsNum = 0;
+    for (; validDetectionsNum < detectionsNum; validDetectionsNum++) {
+        if (detections[validDetectionsNum * detectionSize + 0] < 0) {
             break;
         }
+        objectsNum += detections[validDetectionsNum * detectionSize + 2] > confidenceThreshold;
+    }
+    result->objects.reserve(objectsNum);
 
-        float confidence = detections[i * objectSize + 2];
+    for (size_t i = 0; i < validDetectionsNum; i++) {
+        float confidence = detections[i * detectionSize + 2];
 
         /** Filtering out objects with confidence < confidence_threshold probability **/
         if (confidence > confidenceThreshold) {
             DetectedObject desc;
 
             desc.confidence = confidence;
-            desc.labelID = static_cast<int>(detections[i * objectSize + 1]);
+            desc.labelID = static_cast<int>(detections[i * detectionSize + 1]);
             desc.label = getLabelName(desc.labelID);
 
-            desc.x = clamp(detections[i * objectSize + 3] * internalData.inputImgWidth,
+            desc.x = clamp(detections[i * detectionSize + 3] * internalData.inputImgWidth,
                            0.f,
                            static_cast<float>(internalData.inputImgWidth));
-            desc.y = clamp(detections[i * objectSize + 4] * internalData.inputImgHeight,
+            desc.y = clamp(detections[i * detectionSize + 4] * internalData.inputImgHeight,
                            0.f,
                            static_cast<float>(internalData.inputImgHeight));
-            desc.width = clamp(detections[i * objectSize + 5] * internalData.inputImgWidth,
+            desc.width = clamp(detections[i * detectionSize + 5] * internalData.inputImgWidth,
                                0.f,
                                static_cast<float>(internalData.inputImgWidth)) -
                          desc.x;
-            desc.height = clamp(detections[i * objectSize + 6] * internalData.inputImgHeight,
+            desc.height = clamp(detections[i * detectionSize + 6] * internalData.inputImgHeight,
                                 0.f,
                                 static_cast<float>(internalData.inputImgHeight)) -
                           desc.y;
 
-            result->objects.push_back(desc);
+            result->objects.push_back(std::move(desc));
         }
     }
 
     return retVal;
 }
 
+template <size_t boxSize, bool hasScores>
 std::unique_ptr<ResultBase> ModelSSD::postprocessMultipleOutputs(InferenceResult& infResult) {
-    const float* boxes = infResult.outputsData[outputsNames[0]].data<float>();
-    size_t detectionsNum = infResult.outputsData[outputsNames[0]].get_shape()[detectionsNumId];
-    const float* labels = infResult.outputsData[outputsNames[1]].data<float>();
-    const float* scores = outputsNames.size() > 2 ? infResult.outputsData[outputsNames[2]].data<float>() : nullptr;
+    const float* boxes = infResult.outputsData[0].data<float>();
+    size_t detectionsNum = infResult.outputsData[0].get_shape()[detectionsNumId];
+    const float* labels = infResult.outputsData[1].data<float>();
+    const float* scores = hasScores ? infResult.outputsData[2].data<float>() : nullptr;
 
     DetectionResult* result = new DetectionResult(infResult.frameId, infResult.metaData);
+
+    result->labels = labelsTable;
     auto retVal = std::unique_ptr<ResultBase>(result);
 
     const auto& internalData = infResult.internalModelData->asRef<InternalImageModelData>();
 
     // In models with scores are stored in separate output, coordinates are normalized to [0,1]
     // In other multiple-outputs models coordinates are normalized to [0,netInputWidth] and [0,netInputHeight]
-    float widthScale = static_cast<float>(internalData.inputImgWidth) / (scores ? 1 : netInputWidth);
-    float heightScale = static_cast<float>(internalData.inputImgHeight) / (scores ? 1 : netInputHeight);
+    float widthScale = static_cast<float>(internalData.inputImgWidth) / (hasScores ? 1 : netInputWidth);
+    float heightScale = static_cast<float>(internalData.inputImgHeight) / (hasScores ? 1 : netInputHeight);
 
+    size_t objectsNum = 0;
     for (size_t i = 0; i < detectionsNum; i++) {
-        float confidence = scores ? scores[i] : boxes[i * objectSize + 4];
+        objectsNum += (hasScores ? scores[i] : boxes[i * boxSize + 4]) > confidenceThreshold;
+    }
+    result->objects.reserve(objectsNum);
+
+    for (size_t i = 0; i < detectionsNum; i++) {
+        float confidence = hasScores ? scores[i] : boxes[i * boxSize + 4];
 
         /** Filtering out objects with confidence < confidence_threshold probability **/
         if (confidence > confidenceThreshold) {
@@ -132,17 +155,17 @@ std::unique_ptr<ResultBase> ModelSSD::postprocessMultipleOutputs(InferenceResult
             desc.labelID = static_cast<int>(labels[i]);
             desc.label = getLabelName(desc.labelID);
 
-            desc.x = clamp(boxes[i * objectSize] * widthScale, 0.f, static_cast<float>(internalData.inputImgWidth));
+            desc.x = clamp(boxes[i * boxSize] * widthScale, 0.f, static_cast<float>(internalData.inputImgWidth));
             desc.y =
-                clamp(boxes[i * objectSize + 1] * heightScale, 0.f, static_cast<float>(internalData.inputImgHeight));
+                clamp(boxes[i * boxSize + 1] * heightScale, 0.f, static_cast<float>(internalData.inputImgHeight));
             desc.width =
-                clamp(boxes[i * objectSize + 2] * widthScale, 0.f, static_cast<float>(internalData.inputImgWidth)) -
+                clamp(boxes[i * boxSize + 2] * widthScale, 0.f, static_cast<float>(internalData.inputImgWidth)) -
                 desc.x;
             desc.height =
-                clamp(boxes[i * objectSize + 3] * heightScale, 0.f, static_cast<float>(internalData.inputImgHeight)) -
+                clamp(boxes[i * boxSize + 3] * heightScale, 0.f, static_cast<float>(internalData.inputImgHeight)) -
                 desc.y;
 
-            result->objects.push_back(desc);
+            result->objects.push_back(std::move(desc));
         }
     }
 
@@ -274,6 +297,16 @@ void ModelSSD::prepareMultipleOutputs(std::shared_ptr<ov::Model>& model) {
 
     ppp.output(outputsNames[0]).tensor().set_layout(boxesLayout);
 
+    // The decoder is specialized for the box size and presence of scores, so boxes are decoded without branches
+    const bool hasScores = outputsNames.size() > 2;
+    if (objectSize == 4) {
+        multipleOutputsDecoder = hasScores ? &ModelSSD::postprocessMultipleOutputs<4, true>
+                                           : &ModelSSD::postprocessMultipleOutputs<4, false>;
+    } else {
+        multipleOutputsDecoder = hasScores ? &ModelSSD::postprocessMultipleOutputs<5, true>
+                                           : &ModelSSD::postprocessMultipleOutputs<5, false>;
+    }
+
     for (const auto& outName : outputsNames) {
         ppp.output(outName).tensor().set_element_type(ov::element::f32);
     }
@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <limits>
 #include <stdexcept>
 #include <string>
 #include <utility>
@@ -27,6 +28,7 @@
 #include <openvino/openvino.hpp>
 
 #include <utils/common.hpp>
+#include <utils/nms.hpp>
 #include <utils/slog.hpp>
 
 #include "models/internal_model_data.h"
@@ -94,8 +96,14 @@ static inline float sigmoid(float x) {
     return 1.f / (1.f + exp(-x));
 }
 
-static inline float linear(float x) {
-    return x;
+static inline float inverseSigmoid(float y) {
+    if (y <= 0.f) {
+        return -std::numeric_limits<float>::infinity();
+    }
+    if (y >= 1.f) {
+        return std::numeric_limits<float>::infinity();
+    }
+    return std::log(y / (1.f - y));
 }
 
 ModelYolo::ModelYolo(const std::string& modelFileName,
@@ -152,7 +160,7 @@ void ModelYolo::prepareInputsOutputs(std::shared_ptr<ov::Model>& model) {
     const ov::OutputVector& outputs = model->outputs();
     std::map<std::string, ov::Shape> outShapes;
     for (auto& out : outputs) {
-        ppp.output(out.get_any_name()).tensor().set_element_type(ov::element::f32);
+        ppp.output(out.get_any_name()).tensor().set_element_type(getOutputsPrecision());
         if (out.get_shape().size() == 4) {
             if (out.get_shape()[ov::layout::height_idx(yoloRegionLayout)] !=
                     out.get_shape()[ov::layout::width_idx(yoloRegionLayout)] &&
@@ -243,60 +251,74 @@ void ModelYolo::prepareInputsOutputs(std::shared_ptr<ov::Model>& model) {
                        << slog::endl;
         }
     }
+    selectRegionParser();
 }
 
 std::unique_ptr<ResultBase> ModelYolo::postprocess(InferenceResult& infResult) {
     DetectionResult* result = new DetectionResult(infResult.frameId, infResult.metaData);
+    result->labels = labelsTable;
+    const auto& internalData = infResult.internalModelData->asRef<InternalImageModelData>();
+    result->objects = detectObjects(infResult.outputsData, internalData.inputImgHeight, internalData.inputImgWidth);
+    return std::unique_ptr<ResultBase>(result);
+}
+
+std::vector<DetectedObject> ModelYolo::detectInBatchItem(ov::InferRequest& request,
+                                                         size_t batchIdx,
+                                                         const cv::Size& imageSize) {
+    // A slot of a batched tensor is wrapped without copying, regions are laid out with the batch dimension first
+    OutputsData outputs(sharedOutputsNames);
+    for (size_t i = 0; i < outputsNames.size(); ++i) {
+        const std::string& name = outputsNames[i];
+        ov::Tensor tensor = request.get_tensor(name);
+        ov::Shape shape = tensor.get_shape();
+        if (shape.empty() || batchIdx >= shape[0]) {
+            throw std::out_of_range("Batch index " + std::to_string(batchIdx) + " is out of output " + name);
+        }
+        const size_t slotSize = tensor.get_size() / shape[0];
+        shape[0] = 1;
+        char* const slot = static_cast<char*>(tensor.data()) + batchIdx * slotSize * tensor.get_element_type().size();
+        outputs[i] = ov::Tensor(tensor.get_element_type(), shape, slot);
+    }
+    return detectObjects(outputs, imageSize.height, imageSize.width);
+}
+
+std::vector<DetectedObject> ModelYolo::detectObjects(const OutputsData& outputs,
+                                                     unsigned long imageHeight,
+                                                     unsigned long imageWidth) {
     std::vector<DetectedObject> objects;
 
     // Parsing outputs
-    const auto& internalData = infResult.internalModelData->asRef<InternalImageModelData>();
-
-    for (auto& output : infResult.outputsData) {
-        this->parseYOLOOutput(output.first,
-                              output.second,
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        this->parseYOLOOutput(outputs.getName(i),
+                              outputs[i],
                               netInputHeight,
                               netInputWidth,
-                              internalData.inputImgHeight,
-                              internalData.inputImgWidth,
+                              imageHeight,
+                              imageWidth,
                               objects);
     }
 
-    if (useAdvancedPostprocessing) {
-        // Advanced postprocessing
-        // Checking IOU threshold conformance
-        // For every i-th object we're finding all objects it intersects with, and comparing confidence
-        // If i-th object has greater confidence than all others, we include it into result
-        for (const auto& obj1 : objects) {
-            bool isGoodResult = true;
-            for (const auto& obj2 : objects) {
-                if (obj1.labelID == obj2.labelID && obj1.confidence < obj2.confidence &&
-                    intersectionOverUnion(obj1, obj2) >= boxIOUThreshold) {  // if obj1 is the same as obj2, condition
-                                                                             // expression will evaluate to false anyway
-                    isGoodResult = false;
-                    break;
-                }
-            }
-            if (isGoodResult) {
-                result->objects.push_back(obj1);
-            }
-        }
-    } else {
-        // Classic postprocessing
-        std::sort(objects.begin(), objects.end(), [](const DetectedObject& x, const DetectedObject& y) {
-            return x.confidence > y.confidence;
-        });
-        for (size_t i = 0; i < objects.size(); ++i) {
-            if (objects[i].confidence == 0)
-                continue;
-            for (size_t j = i + 1; j < objects.size(); ++j)
-                if (intersectionOverUnion(objects[i], objects[j]) >= boxIOUThreshold)
-                    objects[j].confidence = 0;
-            result->objects.push_back(objects[i]);
-        }
+    NmsBoxes candidates;
+    candidates.reserve(objects.size());
+    for (const auto& obj : objects) {
+        candidates.add(obj.x,
+                       obj.y,
+                       obj.x + obj.width,
+                       obj.y + obj.height,
+                       obj.confidence,
+                       static_cast<int>(obj.labelID));
     }
-
-    return std::unique_ptr<ResultBase>(result);
+    NmsParams params(static_cast<float>(boxIOUThreshold));
+    // Advanced postprocessing suppresses only boxes of the same class, classic one - boxes of any class
+    params.perClass = useAdvancedPostprocessing;
+    const std::vector<int> keep = nms(candidates, params);
+
+    std::vector<DetectedObject> keptObjects;
+    keptObjects.reserve(keep.size());
+    for (int i : keep) {
+        keptObjects.push_back(std::move(objects[i]));
+    }
+    return keptObjects;
 }
 
 void ModelYolo::parseYOLOOutput(const std::string& output_name,
@@ -335,70 +357,173 @@ void ModelYolo::parseYOLOOutput(const std::string& output_name,
             break;
     }
 
-    auto entriesNum = sideW * sideH;
-    const float* outData = tensor.data<float>();
+    if (tensor.get_element_type() != getOutputsPrecision()) {
+        throw std::logic_error("Output " + output_name + " has unexpected element type");
+    }
+    (this->*regionParser)(tensor.data(),
+                          region,
+                          sideH,
+                          sideW,
+                          scaleH,
+                          scaleW,
+                          original_im_h,
+                          original_im_w,
+                          objects);
+}
 
-    auto postprocessRawData =
-        (yoloVersion == YOLO_V4 || yoloVersion == YOLO_V4_TINY || yoloVersion == YOLOF) ? sigmoid : linear;
+template <typename T, bool isSigmoidApplied, bool isYolof, bool hasObjectness>
+ModelYolo::RegionParser ModelYolo::getRegionParser(size_t classesNum) {
+    switch (classesNum) {
+        case 1:
+            return &ModelYolo::parseYOLORegion<T, isSigmoidApplied, isYolof, hasObjectness, 1>;
+        case 80:
+            return &ModelYolo::parseYOLORegion<T, isSigmoidApplied, isYolof, hasObjectness, 80>;
+        default:
+            return &ModelYolo::parseYOLORegion<T, isSigmoidApplied, isYolof, hasObjectness, 0>;
+    }
+}
+
+void ModelYolo::selectRegionParser() {
+    // Regions of different classes numbers are decoded by the kernel reading the number from the region
+    size_t classesNum = regions.empty() ? 0 : regions.begin()->second.classes;
+    for (const auto& region : regions) {
+        if (region.second.classes != classesNum) {
+            classesNum = 0;
+        }
+    }
+    const bool isHalf = getOutputsPrecision() == ov::element::f16;
+    switch (yoloVersion) {
+        case YOLO_V1V2:
+        case YOLO_V3:
+            regionParser = isHalf ? getRegionParser<ov::float16, false, false, true>(classesNum)
+                                  : getRegionParser<float, false, false, true>(classesNum);
+            break;
+        case YOLO_V4:
+        case YOLO_V4_TINY:
+            regionParser = isHalf ? getRegionParser<ov::float16, true, false, true>(classesNum)
+                                  : getRegionParser<float, true, false, true>(classesNum);
+            break;
+        case YOLOF:
+            regionParser = isHalf ? getRegionParser<ov::float16, true, true, false>(classesNum)
+                                  : getRegionParser<float, true, true, false>(classesNum);
+            break;
+    }
+}
+
+template <typename T, bool isSigmoidApplied, bool isYolof, bool hasObjectness, size_t classesNum>
+void ModelYolo::parseYOLORegion(const void* data,
+                                const Region& region,
+                                int sideH,
+                                int sideW,
+                                unsigned long scaleH,
+                                unsigned long scaleW,
+                                unsigned long original_im_h,
+                                unsigned long original_im_w,
+                                std::vector<DetectedObject>& objects) {
+    const T* outData = static_cast<const T*>(data);
+    const int entriesNum = sideW * sideH;
+    // The kernel is specialized for common numbers of classes, so loops over classes have constant bounds
+    const size_t classes = classesNum != 0 ? classesNum : region.classes;
+    // f16 elements are converted one by one when they are read, the output isn't converted as a whole
+    auto value = [outData](size_t idx) {
+        return static_cast<float>(outData[idx]);
+    };
+    auto postprocessRawData = [](float x) {
+        return isSigmoidApplied ? sigmoid(x) : x;
+    };
+    // Both functions are monotonic, so raw data is compared with the threshold mapped back by the inverse function.
+    // The margin covers rounding, exact checks are done after the functions are applied.
+    auto unpostprocessThreshold = [](float threshold) {
+        const float rawThreshold = isSigmoidApplied ? inverseSigmoid(threshold) : threshold;
+        return rawThreshold - 1e-4f * (1.f + std::fabs(rawThreshold));
+    };
+    const float rawThreshold = unpostprocessThreshold(confidenceThreshold);
+
+    std::vector<float> maxClassLogits(hasObjectness ? 0 : entriesNum);
+    std::vector<int> candidates;
+    candidates.reserve(entriesNum);
 
     // --------------------------- Parsing YOLO Region output -------------------------------------
-    for (int i = 0; i < entriesNum; ++i) {
-        int row = i / sideW;
-        int col = i % sideW;
-        for (int n = 0; n < region.num; ++n) {
-            //--- Getting region data
-            int obj_index = calculateEntryIndex(entriesNum,
-                                                region.coords,
-                                                region.classes + isObjConf,
-                                                n * entriesNum + i,
-                                                region.coords);
-            int box_index =
-                calculateEntryIndex(entriesNum, region.coords, region.classes + isObjConf, n * entriesNum + i, 0);
-            float scale = isObjConf ? postprocessRawData(outData[obj_index]) : 1;
-
-            //--- Preliminary check for confidence threshold conformance
-            if (scale >= confidenceThreshold) {
-                //--- Calculating scaled region's coordinates
-                float x, y;
-                if (yoloVersion == YOLOF) {
-                    x = (static_cast<float>(col) / sideW +
-                         outData[box_index + 0 * entriesNum] * region.anchors[2 * n] / scaleW) *
-                        original_im_w;
-                    y = (static_cast<float>(row) / sideH +
-                         outData[box_index + 1 * entriesNum] * region.anchors[2 * n + 1] / scaleH) *
-                        original_im_h;
-                } else {
-                    x = static_cast<float>((col + postprocessRawData(outData[box_index + 0 * entriesNum])) / sideW *
-                                           original_im_w);
-                    y = static_cast<float>((row + postprocessRawData(outData[box_index + 1 * entriesNum])) / sideH *
-                                           original_im_h);
+    for (int n = 0; n < region.num; ++n) {
+        const int box_index =
+            calculateEntryIndex(entriesNum, region.coords, classes + hasObjectness, n * entriesNum, 0);
+        const int obj_index = box_index + region.coords * entriesNum;
+        const int classes_index = obj_index + hasObjectness * entriesNum;
+
+        //--- Preliminary check for confidence threshold conformance over contiguous entries of the anchor
+        candidates.clear();
+        if (hasObjectness) {
+            const T* scores = outData + obj_index;
+            for (int i = 0; i < entriesNum; ++i) {
+                if (static_cast<float>(scores[i]) >= rawThreshold) {
+                    candidates.push_back(i);
                 }
-                float height = static_cast<float>(std::exp(outData[box_index + 3 * entriesNum]) *
-                                                  region.anchors[2 * n + 1] * original_im_h / scaleH);
-                float width = static_cast<float>(std::exp(outData[box_index + 2 * entriesNum]) * region.anchors[2 * n] *
-                                                 original_im_w / scaleW);
-
-                DetectedObject obj;
-                obj.x = clamp(x - width / 2, 0.f, static_cast<float>(original_im_w));
-                obj.y = clamp(y - height / 2, 0.f, static_cast<float>(original_im_h));
-                obj.width = clamp(width, 0.f, static_cast<float>(original_im_w - obj.x));
-                obj.height = clamp(height, 0.f, static_cast<float>(original_im_h - obj.y));
-
-                for (size_t j = 0; j < region.classes; ++j) {
-                    int class_index = calculateEntryIndex(entriesNum,
-                                                          region.coords,
-                                                          region.classes + isObjConf,
-                                                          n * entriesNum + i,
-                                                          region.coords + isObjConf + j);
-                    float prob = scale * postprocessRawData(outData[class_index]);
-
-                    //--- Checking confidence threshold conformance and adding region to the list
-                    if (prob >= confidenceThreshold) {
-                        obj.confidence = prob;
-                        obj.labelID = j;
-                        obj.label = getLabelName(obj.labelID);
-                        objects.push_back(obj);
-                    }
+            }
+        } else {
+            // Box confidence is the best class probability if there is no objectness
+            std::copy(outData + classes_index, outData + classes_index + entriesNum, maxClassLogits.begin());
+            for (size_t j = 1; j < classes; ++j) {
+                const T* classLogits = outData + classes_index + j * entriesNum;
+                for (int i = 0; i < entriesNum; ++i) {
+                    maxClassLogits[i] = std::max(maxClassLogits[i], static_cast<float>(classLogits[i]));
+                }
+            }
+            for (int i = 0; i < entriesNum; ++i) {
+                if (maxClassLogits[i] >= rawThreshold) {
+                    candidates.push_back(i);
+                }
+            }
+        }
+
+        for (int i : candidates) {
+            int row = i / sideW;
+            int col = i % sideW;
+            float scale = hasObjectness ? postprocessRawData(value(obj_index + i)) : 1;
+            if (scale < confidenceThreshold) {
+                continue;
+            }
+
+            //--- Calculating scaled region's coordinates
+            float x, y;
+            if (isYolof) {
+                x = (static_cast<float>(col) / sideW +
+                     value(box_index + i + 0 * entriesNum) * region.anchors[2 * n] / scaleW) *
+                    original_im_w;
+                y = (static_cast<float>(row) / sideH +
+                     value(box_index + i + 1 * entriesNum) * region.anchors[2 * n + 1] / scaleH) *
+                    original_im_h;
+            } else {
+                x = static_cast<float>((col + postprocessRawData(value(box_index + i + 0 * entriesNum))) / sideW *
+                                       original_im_w);
+                y = static_cast<float>((row + postprocessRawData(value(box_index + i + 1 * entriesNum))) / sideH *
+                                       original_im_h);
+            }
+            float height = static_cast<float>(std::exp(value(box_index + i + 3 * entriesNum)) *
+                                              region.anchors[2 * n + 1] * original_im_h / scaleH);
+            float width = static_cast<float>(std::exp(value(box_index + i + 2 * entriesNum)) *
+                                             region.anchors[2 * n] * original_im_w / scaleW);
+
+            DetectedObject obj;
+            obj.x = clamp(x - width / 2, 0.f, static_cast<float>(original_im_w));
+            obj.y = clamp(y - height / 2, 0.f, static_cast<float>(original_im_h));
+            obj.width = clamp(width, 0.f, static_cast<float>(original_im_w - obj.x));
+            obj.height = clamp(height, 0.f, static_cast<float>(original_im_h - obj.y));
+
+            //--- Classes which can't pass the threshold are rejected without applying the function
+            const float rawClassThreshold = unpostprocessThreshold(confidenceThreshold / scale);
+            for (size_t j = 0; j < classes; ++j) {
+                const float classLogit = value(classes_index + j * entriesNum + i);
+                if (classLogit < rawClassThreshold) {
+                    continue;
+                }
+                float prob = scale * postprocessRawData(classLogit);
+
+                //--- Checking confidence threshold conformance and adding region to the list
+                if (prob >= confidenceThreshold) {
+                    obj.confidence = prob;
+                    obj.labelID = j;
+                    obj.label = getLabelName(obj.labelID);
+                    objects.push_back(obj);
                 }
             }
         }
@@ -411,15 +536,6 @@ int ModelYolo::calculateEntryIndex(int totalCells, int lcoords, size_t lclasses,
     return (n * (lcoords + lclasses) + entry) * totalCells + loc;
 }
 
-double ModelYolo::intersectionOverUnion(const DetectedObject& o1, const DetectedObject& o2) {
-    double overlappingWidth = fmin(o1.x + o1.width, o2.x + o2.width) - fmax(o1.x, o2.x);
-    double overlappingHeight = fmin(o1.y + o1.height, o2.y + o2.height) - fmax(o1.y, o2.y);
-    double intersectionArea =
-        (overlappingWidth < 0 || overlappingHeight < 0) ? 0 : overlappingHeight * overlappingWidth;
-    double unionArea = o1.width * o1.height + o2.width * o2.height - intersectionArea;
-    return intersectionArea / unionArea;
-}
-
 ModelYolo::Region::Region(const std::shared_ptr<ov::op::v0::RegionYolo>& regionYolo) {
     coords = regionYolo->get_num_coords();
     classes = regionYolo->get_num_classes();
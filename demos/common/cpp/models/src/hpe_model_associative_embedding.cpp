@@ -17,6 +17,7 @@
 #include "models/hpe_model_associative_embedding.h"
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <algorithm>
 #include <cmath>
@@ -28,6 +29,7 @@
 #include <vector>
 
 #include <openvino/openvino.hpp>
+#include <openvino/opsets/opset8.hpp>
 
 #include <utils/image_utils.h>
 #include <utils/ocv_common.hpp>
@@ -54,7 +56,24 @@ HpeAssociativeEmbedding::HpeAssociativeEmbedding(const std::string& modelFileNam
       targetSize(targetSize),
       confidenceThreshold(confidenceThreshold),
       delta(delta),
-      resizeMode(resizeMode) {}
+      resizeMode(resizeMode),
+      buffers(new AssociativeEmbeddingBuffers()) {}
+
+HpeAssociativeEmbedding::HpeAssociativeEmbedding(const HpeAssociativeEmbedding& other)
+    : ImageModel(other),
+      inputLayerSize(other.inputLayerSize),
+      aspectRatio(other.aspectRatio),
+      targetSize(other.targetSize),
+      confidenceThreshold(other.confidenceThreshold),
+      delta(other.delta),
+      resizeMode(other.resizeMode),
+      embeddingsTensorIdx(other.embeddingsTensorIdx),
+      heatmapsTensorIdx(other.heatmapsTensorIdx),
+      nmsHeatmapsTensorIdx(other.nmsHeatmapsTensorIdx),
+      buffers(new AssociativeEmbeddingBuffers()),
+      peaksMapSize(other.peaksMapSize) {}
+
+HpeAssociativeEmbedding::~HpeAssociativeEmbedding() = default;
 
 void HpeAssociativeEmbedding::prepareInputsOutputs(std::shared_ptr<ov::Model>& model) {
     // --------------------------- Configure input & output -------------------------------------------------
@@ -101,13 +120,32 @@ void HpeAssociativeEmbedding::prepareInputsOutputs(std::shared_ptr<ov::Model>& m
     }
     model = ppp.build();
 
-    embeddingsTensorName = findTensorByName("embeddings", outputsNames);
-    heatmapsTensorName = findTensorByName("heatmaps", outputsNames);
+    auto outputIdx = [this](const std::string& name) {
+        return static_cast<size_t>(std::find(outputsNames.begin(), outputsNames.end(), name) - outputsNames.begin());
+    };
+    embeddingsTensorIdx = outputIdx(findTensorByName("embeddings", outputsNames));
+    heatmapsTensorIdx = outputIdx(findTensorByName("heatmaps", outputsNames));
     try {
-        nmsHeatmapsTensorName = findTensorByName("nms_heatmaps", outputsNames);
-    } catch (const std::runtime_error&) { nmsHeatmapsTensorName = heatmapsTensorName; }
+        nmsHeatmapsTensorIdx = outputIdx(findTensorByName("nms_heatmaps", outputsNames));
+    } catch (const std::runtime_error&) { nmsHeatmapsTensorIdx = heatmapsTensorIdx; }
 
     changeInputSize(model);
+
+    if (devicePostprocessing) {
+        // Only the highest peaks of every joint are transferred, with their tags and neighbours for the adjustment.
+        // Peaks are found after max pooling NMS also for models without NMS output.
+        const ov::Output<ov::Node> heatMaps = getOutputSource(model, outputsNames[heatmapsTensorIdx]);
+        const ov::Output<ov::Node> nmsHeatMaps = getOutputSource(model, outputsNames[nmsHeatmapsTensorIdx]);
+        const ov::Output<ov::Node> embeddings = getOutputSource(model, outputsNames[embeddingsTensorIdx]);
+        const ov::Shape& mapsShape = heatMaps.get_shape();
+        peaksMapSize = cv::Size(static_cast<int>(mapsShape[3]), static_cast<int>(mapsShape[2]));
+        const ov::OutputVector peaks = addHeatmapPeaks(nmsHeatMaps, maxNumPeople);
+        replaceOutputs(model,
+                       {{"peak_scores", peaks[0]},
+                        {"peak_indices", peaks[1]},
+                        {"peak_tags", gatherAtPeaks(embeddings, peaks[1])},
+                        {"peak_neighbours", gatherPeaksNeighbours(heatMaps, peaks[1])}});
+    }
 }
 
 void HpeAssociativeEmbedding::changeInputSize(std::shared_ptr<ov::Model>& model) {
@@ -151,28 +189,35 @@ std::shared_ptr<InternalModelData> HpeAssociativeEmbedding::preprocess(const Inp
 std::unique_ptr<ResultBase> HpeAssociativeEmbedding::postprocess(InferenceResult& infResult) {
     HumanPoseResult* result = new HumanPoseResult(infResult.frameId, infResult.metaData);
 
-    const auto& aembds = infResult.outputsData[embeddingsTensorName];
-    const ov::Shape& aembdsShape = aembds.get_shape();
-    float* const aembdsMapped = aembds.data<float>();
-    std::vector<cv::Mat> aembdsMaps = split(aembdsMapped, aembdsShape);
-
-    const auto& heats = infResult.outputsData[heatmapsTensorName];
-    const ov::Shape& heatMapsShape = heats.get_shape();
-    float* const heatMapsMapped = heats.data<float>();
-    std::vector<cv::Mat> heatMaps = split(heatMapsMapped, heatMapsShape);
-
-    std::vector<cv::Mat> nmsHeatMaps = heatMaps;
-    if (nmsHeatmapsTensorName != heatmapsTensorName) {
-        const auto& nmsHeats = infResult.outputsData[nmsHeatmapsTensorName];
-        const ov::Shape& nmsHeatMapsShape = nmsHeats.get_shape();
-        float* const nmsHeatMapsMapped = nmsHeats.data<float>();
-        nmsHeatMaps = split(nmsHeatMapsMapped, nmsHeatMapsShape);
+    std::vector<HumanPose> poses;
+    float mapWidth = static_cast<float>(peaksMapSize.width);
+    if (devicePostprocessing) {
+        poses = extractDevicePoses(infResult);
+    } else {
+        const auto& aembds = infResult.outputsData[embeddingsTensorIdx];
+        const ov::Shape& aembdsShape = aembds.get_shape();
+        float* const aembdsMapped = aembds.data<float>();
+        std::vector<cv::Mat> aembdsMaps = split(aembdsMapped, aembdsShape);
+
+        const auto& heats = infResult.outputsData[heatmapsTensorIdx];
+        const ov::Shape& heatMapsShape = heats.get_shape();
+        float* const heatMapsMapped = heats.data<float>();
+        std::vector<cv::Mat> heatMaps = split(heatMapsMapped, heatMapsShape);
+
+        std::vector<cv::Mat> nmsHeatMaps = heatMaps;
+        if (nmsHeatmapsTensorIdx != heatmapsTensorIdx) {
+            const auto& nmsHeats = infResult.outputsData[nmsHeatmapsTensorIdx];
+            const ov::Shape& nmsHeatMapsShape = nmsHeats.get_shape();
+            float* const nmsHeatMapsMapped = nmsHeats.data<float>();
+            nmsHeatMaps = split(nmsHeatMapsMapped, nmsHeatMapsShape);
+        }
+        poses = extractPoses(heatMaps, aembdsMaps, nmsHeatMaps);
+        mapWidth = static_cast<float>(heatMapsShape[3]);
     }
-    std::vector<HumanPose> poses = extractPoses(heatMaps, aembdsMaps, nmsHeatMaps);
 
     // Rescale poses to the original image
     const auto& scale = infResult.internalModelData->asRef<InternalScaleData>();
-    const float outputScale = inputLayerSize.width / static_cast<float>(heatMapsShape[3]);
+    const float outputScale = inputLayerSize.width / mapWidth;
     float shiftX = 0.0, shiftY = 0.0;
     float scaleX = 1.0, scaleY = 1.0;
 
@@ -227,30 +272,39 @@ std::vector<cv::Mat> HpeAssociativeEmbedding::split(float* data, const ov::Shape
 
 std::vector<HumanPose> HpeAssociativeEmbedding::extractPoses(std::vector<cv::Mat>& heatMaps,
                                                              const std::vector<cv::Mat>& aembdsMaps,
-                                                             const std::vector<cv::Mat>& nmsHeatMaps) const {
-    std::vector<std::vector<Peak>> allPeaks(numJoints);
-    for (int i = 0; i < numJoints; i++) {
-        findPeaks(nmsHeatMaps, aembdsMaps, allPeaks, i, maxNumPeople, detectionThreshold);
-    }
-    std::vector<Pose> allPoses = matchByTag(allPeaks, maxNumPeople, numJoints, tagThreshold);
+                                                             const std::vector<cv::Mat>& nmsHeatMaps) {
+    buffers->reset(numJoints, maxNumPeople);
+    // Peaks of every joint are written to their own slots of the buffers
+    cv::parallel_for_(cv::Range(0, numJoints), [&](const cv::Range& range) {
+        for (int i = range.start; i < range.end; i++) {
+            findPeaks(nmsHeatMaps, aembdsMaps, *buffers, i, maxNumPeople, detectionThreshold);
+        }
+    });
+    matchByTag(*buffers, maxNumPeople, numJoints, tagThreshold);
+    std::vector<Pose>& allPoses = buffers->poses;
+    const size_t posesNum = buffers->posesNum;
     // swap for all poses
-    for (auto& pose : allPoses) {
+    for (size_t i = 0; i < posesNum; i++) {
         for (size_t j = 0; j < numJoints; j++) {
-            Peak& peak = pose.getPeak(j);
+            Peak& peak = allPoses[i].getPeak(j);
             std::swap(peak.keypoint.x, peak.keypoint.y);
         }
     }
     std::vector<HumanPose> poses;
-    for (size_t i = 0; i < allPoses.size(); i++) {
+    bool heatMapsAbs = false;
+    for (size_t i = 0; i < posesNum; i++) {
         Pose& pose = allPoses[i];
         // Filtering poses with low mean scores
         if (pose.getMeanScore() <= confidenceThreshold) {
             continue;
         }
-        for (size_t j = 0; j < heatMaps.size(); j++) {
-            heatMaps[j] = cv::abs(heatMaps[j]);
+        if (!heatMapsAbs) {
+            for (size_t j = 0; j < heatMaps.size(); j++) {
+                heatMaps[j] = cv::abs(heatMaps[j]);
+            }
+            heatMapsAbs = true;
         }
-        adjustAndRefine(allPoses, heatMaps, aembdsMaps, i, delta);
+        adjustAndRefine(allPoses, heatMaps, aembdsMaps, static_cast<int>(i), delta);
         std::vector<cv::Point2f> keypoints;
         for (size_t j = 0; j < numJoints; j++) {
             Peak& peak = pose.getPeak(j);
@@ -260,3 +314,45 @@ std::vector<HumanPose> HpeAssociativeEmbedding::extractPoses(std::vector<cv::Mat
     }
     return poses;
 }
+
+std::vector<HumanPose> HpeAssociativeEmbedding::extractDevicePoses(const InferenceResult& infResult) {
+    const ov::Tensor& scoresTensor = infResult.outputsData[0];
+    const size_t candidatesNum = scoresTensor.get_shape()[2];
+    const float* scores = scoresTensor.data<float>();
+    const int32_t* indices = infResult.outputsData[1].data<int32_t>();
+    const float* tags = infResult.outputsData[2].data<float>();
+    const float* neighbours = infResult.outputsData[3].data<float>();
+
+    buffers->reset(numJoints, maxNumPeople);
+    for (size_t i = 0; i < numJoints; i++) {
+        const size_t offset = i * candidatesNum;
+        collectPeaks(scores + offset,
+                     indices + offset,
+                     tags + offset,
+                     candidatesNum,
+                     peaksMapSize.width,
+                     *buffers,
+                     i,
+                     maxNumPeople,
+                     detectionThreshold);
+    }
+    matchByTag(*buffers, maxNumPeople, numJoints, tagThreshold);
+    std::vector<HumanPose> poses;
+    for (size_t i = 0; i < buffers->posesNum; i++) {
+        Pose& pose = buffers->poses[i];
+        if (pose.getMeanScore() <= confidenceThreshold) {
+            continue;
+        }
+        std::vector<cv::Point2f> keypoints;
+        for (size_t j = 0; j < numJoints; j++) {
+            Peak& peak = pose.getPeak(j);
+            std::swap(peak.keypoint.x, peak.keypoint.y);
+        }
+        adjustPeaks(pose, indices, neighbours, candidatesNum, peaksMapSize, delta);
+        for (size_t j = 0; j < numJoints; j++) {
+            keypoints.push_back(pose.getPeak(j).keypoint);
+        }
+        poses.push_back({keypoints, pose.getMeanScore()});
+    }
+    return poses;
+}
@@ -16,6 +16,8 @@
 
 #include "models/hpe_model_openpose.h"
 
+#include <stdint.h>
+
 #include <algorithm>
 #include <cmath>
 #include <map>
@@ -26,6 +28,7 @@
 
 #include <opencv2/imgproc.hpp>
 #include <openvino/openvino.hpp>
+#include <openvino/opsets/opset8.hpp>
 
 #include <utils/image_utils.h>
 #include <utils/ocv_common.hpp>
@@ -36,6 +39,27 @@
 #include "models/openpose_decoder.h"
 #include "models/results.h"
 
+namespace {
+// Maps of f32 outputs refer to the tensor. Maps of f16 outputs are converted one by one, at the output resolution,
+// as OpenCV doesn't resize and search peaks in f16.
+std::vector<cv::Mat> wrapFeatureMaps(const ov::Tensor& tensor, size_t mapsNum) {
+    const ov::Shape& shape = tensor.get_shape();
+    const int height = static_cast<int>(shape[2]);
+    const int width = static_cast<int>(shape[3]);
+    const size_t mapSize = shape[2] * shape[3];
+    std::vector<cv::Mat> featureMaps(mapsNum);
+    for (size_t i = 0; i < mapsNum; i++) {
+        if (tensor.get_element_type() == ov::element::f16) {
+            const cv::Mat halfMap(height, width, CV_16FC1, tensor.data<ov::float16>() + i * mapSize);
+            halfMap.convertTo(featureMaps[i], CV_32F);
+        } else {
+            featureMaps[i] = cv::Mat(height, width, CV_32FC1, tensor.data<float>() + i * mapSize);
+        }
+    }
+    return featureMaps;
+}
+}  // namespace
+
 const cv::Vec3f HPEOpenPose::meanPixel = cv::Vec3f::all(128);
 const float HPEOpenPose::minPeaksDistance = 3.0f;
 const float HPEOpenPose::midPointsScoreThreshold = 0.05f;
@@ -46,11 +70,13 @@ HPEOpenPose::HPEOpenPose(const std::string& modelFileName,
                          double aspectRatio,
                          int targetSize,
                          float confidenceThreshold,
-                         const std::string& layout)
+                         const std::string& layout,
+                         bool decodeAtNativeResolution)
     : ImageModel(modelFileName, false, layout),
       aspectRatio(aspectRatio),
       targetSize(targetSize),
-      confidenceThreshold(confidenceThreshold) {}
+      confidenceThreshold(confidenceThreshold),
+      decodeAtNativeResolution(decodeAtNativeResolution) {}
 
 void HPEOpenPose::prepareInputsOutputs(std::shared_ptr<ov::Model>& model) {
     // --------------------------- Configure input & output -------------------------------------------------
@@ -80,7 +106,7 @@ void HPEOpenPose::prepareInputsOutputs(std::shared_ptr<ov::Model>& model) {
     const ov::Layout outputLayout("NCHW");
     for (const auto& output : model->outputs()) {
         const auto& outTensorName = output.get_any_name();
-        ppp.output(outTensorName).tensor().set_element_type(ov::element::f32).set_layout(outputLayout);
+        ppp.output(outTensorName).tensor().set_element_type(getOutputsPrecision()).set_layout(outputLayout);
         outputsNames.push_back(outTensorName);
     }
     model = ppp.build();
@@ -113,6 +139,45 @@ void HPEOpenPose::prepareInputsOutputs(std::shared_ptr<ov::Model>& model) {
     }
 
     changeInputSize(model);
+
+    if (devicePostprocessing) {
+        // Only candidate peaks are transferred instead of the heat maps. Pafs are still transferred, because limbs are
+        // scored by sampling them along the lines between the peaks.
+        ov::Output<ov::Node> heatMaps = getOutputSource(model, outputsNames[0]);
+        if (heatMaps.get_element_type() != ov::element::f32) {
+            heatMaps = std::make_shared<ov::opset8::Convert>(heatMaps, ov::element::f32);
+        }
+        const ov::Shape& mapsShape = heatMaps.get_shape();
+        peaksMapSize = cv::Size(static_cast<int>(mapsShape[widthId]), static_cast<int>(mapsShape[heightId]));
+        if (!decodeAtNativeResolution) {
+            // The same upsampling as resizeFeatureMaps() does
+            peaksMapSize = cv::Size(peaksMapSize.width * upsampleRatio, peaksMapSize.height * upsampleRatio);
+            ov::opset8::Interpolate::InterpolateAttrs attrs;
+            attrs.mode = ov::opset8::Interpolate::InterpolateMode::CUBIC;
+            attrs.shape_calculation_mode = ov::opset8::Interpolate::ShapeCalcMode::SIZES;
+            attrs.coordinate_transformation_mode = ov::opset8::Interpolate::CoordinateTransformMode::HALF_PIXEL;
+            attrs.cube_coeff = -0.75;
+            heatMaps = std::make_shared<ov::opset8::Interpolate>(
+                heatMaps,
+                ov::opset8::Constant::create(ov::element::i64,
+                                             ov::Shape{2},
+                                             {peaksMapSize.height, peaksMapSize.width}),
+                ov::opset8::Constant::create(ov::element::f32,
+                                             ov::Shape{2},
+                                             {static_cast<float>(upsampleRatio), static_cast<float>(upsampleRatio)}),
+                ov::opset8::Constant::create(ov::element::i64, ov::Shape{2}, {2, 3}),
+                attrs);
+        }
+        const ov::OutputVector peaks = addHeatmapPeaks(heatMaps, maxPeaksNum);
+        std::vector<std::pair<std::string, ov::Output<ov::Node>>> outputs{
+            {"peak_scores", peaks[0]},
+            {"peak_indices", peaks[1]},
+            {outputsNames[1], getOutputSource(model, outputsNames[1])}};
+        if (decodeAtNativeResolution) {
+            outputs.push_back({"peak_neighbours", gatherPeaksNeighbours(heatMaps, peaks[1])});
+        }
+        replaceOutputs(model, outputs);
+    }
 }
 
 void HPEOpenPose::changeInputSize(std::shared_ptr<ov::Model>& model) {
@@ -157,30 +222,25 @@ std::shared_ptr<InternalModelData> HPEOpenPose::preprocess(const InputData& inpu
 std::unique_ptr<ResultBase> HPEOpenPose::postprocess(InferenceResult& infResult) {
     HumanPoseResult* result = new HumanPoseResult(infResult.frameId, infResult.metaData);
 
-    const auto& heatMapsMapped = infResult.outputsData[outputsNames[0]];
-    const auto& outputMapped = infResult.outputsData[outputsNames[1]];
-
+    const auto& outputMapped = infResult.outputsData[devicePostprocessing ? 2 : 1];
     const ov::Shape& outputShape = outputMapped.get_shape();
-    const ov::Shape& heatMapShape = heatMapsMapped.get_shape();
-
-    float* const predictions = outputMapped.data<float>();
-    float* const heats = heatMapsMapped.data<float>();
 
-    std::vector<cv::Mat> heatMaps(keypointsNumber);
-    for (size_t i = 0; i < heatMaps.size(); i++) {
-        heatMaps[i] =
-            cv::Mat(heatMapShape[2], heatMapShape[3], CV_32FC1, heats + i * heatMapShape[2] * heatMapShape[3]);
+    std::vector<cv::Mat> pafs = wrapFeatureMaps(outputMapped, outputShape[1]);
+    if (!decodeAtNativeResolution) {
+        resizeFeatureMaps(pafs);
     }
-    resizeFeatureMaps(heatMaps);
 
-    std::vector<cv::Mat> pafs(outputShape[1]);
-    for (size_t i = 0; i < pafs.size(); i++) {
-        pafs[i] =
-            cv::Mat(heatMapShape[2], heatMapShape[3], CV_32FC1, predictions + i * heatMapShape[2] * heatMapShape[3]);
+    std::vector<HumanPose> poses;
+    if (devicePostprocessing) {
+        std::vector<std::vector<Peak>> peaksFromHeatMap = selectDevicePeaks(infResult);
+        poses = groupPoses(peaksFromHeatMap, pafs);
+    } else {
+        std::vector<cv::Mat> heatMaps = wrapFeatureMaps(infResult.outputsData[0], keypointsNumber);
+        if (!decodeAtNativeResolution) {
+            resizeFeatureMaps(heatMaps);
+        }
+        poses = extractPoses(heatMaps, pafs);
     }
-    resizeFeatureMaps(pafs);
-
-    std::vector<HumanPose> poses = extractPoses(heatMaps, pafs);
 
     const auto& scale = infResult.internalModelData->asRef<InternalScaleData>();
     float scaleX = stride / upsampleRatio * scale.scaleX;
@@ -188,6 +248,10 @@ std::unique_ptr<ResultBase> HPEOpenPose::postprocess(InferenceResult& infResult)
     for (auto& pose : poses) {
         for (auto& keypoint : pose.keypoints) {
             if (keypoint != cv::Point2f(-1, -1)) {
+                if (decodeAtNativeResolution) {
+                    // position of the pixel of the output in the upsampled map, as cv::resize() maps the pixels
+                    keypoint = (keypoint + cv::Point2f(0.5f, 0.5f)) * upsampleRatio - cv::Point2f(0.5f, 0.5f);
+                }
                 keypoint.x *= scaleX;
                 keypoint.y *= scaleY;
             }
@@ -211,15 +275,20 @@ public:
     FindPeaksBody(const std::vector<cv::Mat>& heatMaps,
                   float minPeaksDistance,
                   std::vector<std::vector<Peak>>& peaksFromHeatMap,
-                  float confidenceThreshold)
+                  float confidenceThreshold,
+                  bool refine)
         : heatMaps(heatMaps),
           minPeaksDistance(minPeaksDistance),
           peaksFromHeatMap(peaksFromHeatMap),
-          confidenceThreshold(confidenceThreshold) {}
+          confidenceThreshold(confidenceThreshold),
+          refine(refine) {}
 
     void operator()(const cv::Range& range) const override {
         for (int i = range.start; i < range.end; i++) {
             findPeaks(heatMaps, minPeaksDistance, peaksFromHeatMap, i, confidenceThreshold);
+            if (refine) {
+                refinePeaks(heatMaps[i], peaksFromHeatMap[i]);
+            }
         }
     }
 
@@ -228,15 +297,49 @@ private:
     float minPeaksDistance;
     std::vector<std::vector<Peak>>& peaksFromHeatMap;
     float confidenceThreshold;
+    bool refine;
 };
 
 std::vector<HumanPose> HPEOpenPose::extractPoses(const std::vector<cv::Mat>& heatMaps,
                                                  const std::vector<cv::Mat>& pafs) const {
     std::vector<std::vector<Peak>> peaksFromHeatMap(heatMaps.size());
-    FindPeaksBody findPeaksBody(heatMaps, minPeaksDistance, peaksFromHeatMap, confidenceThreshold);
+    // the distance is set for the upsampled maps
+    const float peaksDistance = decodeAtNativeResolution ? minPeaksDistance / upsampleRatio : minPeaksDistance;
+    FindPeaksBody findPeaksBody(heatMaps,
+                                peaksDistance,
+                                peaksFromHeatMap,
+                                confidenceThreshold,
+                                decodeAtNativeResolution);
     cv::parallel_for_(cv::Range(0, static_cast<int>(heatMaps.size())), findPeaksBody);
+    return groupPoses(peaksFromHeatMap, pafs);
+}
+
+std::vector<std::vector<Peak>> HPEOpenPose::selectDevicePeaks(const InferenceResult& infResult) const {
+    const ov::Tensor& scoresTensor = infResult.outputsData[0];
+    const size_t candidatesNum = scoresTensor.get_shape()[2];
+    const float* scores = scoresTensor.data<float>();
+    const int32_t* indices = infResult.outputsData[1].data<int32_t>();
+    const float* neighbours = decodeAtNativeResolution ? infResult.outputsData[3].data<float>() : nullptr;
+    const float peaksDistance = decodeAtNativeResolution ? minPeaksDistance / upsampleRatio : minPeaksDistance;
+    std::vector<std::vector<Peak>> peaksFromHeatMap(keypointsNumber);
+    for (size_t i = 0; i < keypointsNumber; i++) {
+        const size_t offset = i * candidatesNum;
+        selectPeaks(scores + offset,
+                    indices + offset,
+                    neighbours ? neighbours + offset * 4 : nullptr,
+                    candidatesNum,
+                    peaksMapSize,
+                    peaksDistance,
+                    confidenceThreshold,
+                    peaksFromHeatMap[i]);
+    }
+    return peaksFromHeatMap;
+}
+
+std::vector<HumanPose> HPEOpenPose::groupPoses(std::vector<std::vector<Peak>>& peaksFromHeatMap,
+                                               const std::vector<cv::Mat>& pafs) const {
     int peaksBefore = 0;
-    for (size_t heatmapId = 1; heatmapId < heatMaps.size(); heatmapId++) {
+    for (size_t heatmapId = 1; heatmapId < peaksFromHeatMap.size(); heatmapId++) {
         peaksBefore += static_cast<int>(peaksFromHeatMap[heatmapId - 1].size());
         for (auto& peak : peaksFromHeatMap[heatmapId]) {
             peak.id += peaksBefore;
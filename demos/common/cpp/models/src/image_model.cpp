@@ -16,14 +16,21 @@
 
 #include "models/image_model.h"
 
+#include <stdint.h>
+
+#include <limits>
 #include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include <opencv2/core.hpp>
 #include <openvino/openvino.hpp>
+#include <openvino/opsets/opset8.hpp>
 
 #include <utils/image_utils.h>
 #include <utils/ocv_common.hpp>
+#include <utils/slog.hpp>
 
 #include "models/input_data.h"
 #include "models/internal_model_data.h"
@@ -32,8 +39,258 @@ ImageModel::ImageModel(const std::string& modelFileName, bool useAutoResize, con
     : ModelBase(modelFileName, layout),
       useAutoResize(useAutoResize) {}
 
+void ImageModel::setPreallocatedInputs(bool preallocated) {
+    if (preallocated && (useAutoResize || devicePreprocessing)) {
+        throw std::logic_error("Preallocated inputs can't be used with auto resize or preprocessing on the device");
+    }
+    preallocatedInputs = preallocated;
+}
+
+void ImageModel::setDevicePreprocessing(bool onDevice, bool nv12) {
+    if (onDevice && !supportsDevicePreprocessing()) {
+        throw std::logic_error("The model wrapper doesn't support preprocessing on the device");
+    }
+    if (onDevice && (useAutoResize || preallocatedInputs)) {
+        throw std::logic_error("Preprocessing on the device can't be used with auto resize or preallocated inputs");
+    }
+    devicePreprocessing = onDevice;
+    nv12Input = onDevice && nv12;
+}
+
+void ImageModel::embedPreprocessing(std::shared_ptr<ov::Model>& model) {
+    if (!devicePreprocessing) {
+        return;
+    }
+    if (batchSize != 1) {
+        throw std::logic_error("Preprocessing on the device supports batch size 1 only");
+    }
+    // The model already takes NHWC images of the network size, u8 or f32 if the input transform isn't trivial. The
+    // frames are resized to it, the transform is moved before the resize, where CPU would have done it as well.
+    ov::preprocess::PrePostProcessor ppp(model);
+    ov::preprocess::InputInfo& input = ppp.input(inputsNames[0]);  // first input should be image
+    input.tensor().set_element_type(ov::element::u8).set_layout("NHWC").set_spatial_dynamic_shape();
+    if (nv12Input) {
+        input.tensor().set_color_format(ov::preprocess::ColorFormat::NV12_SINGLE_PLANE);
+        input.preprocess().convert_color(ov::preprocess::ColorFormat::BGR);
+    }
+    inputTransform.embed(input.preprocess());
+    input.preprocess().resize(ov::preprocess::ResizeAlgorithm::RESIZE_LINEAR);
+    input.model().set_layout("NHWC");
+    model = ppp.build();
+
+    // From now on frames are wrapped into input tensors as they are
+    inputTransform = InputTransform();
+    useAutoResize = true;
+}
+
+void ImageModel::setInputsMemory(const std::string& memory) {
+    if (memory.empty()) {
+        return;
+    }
+    if (memory != "host" && memory != "device") {
+        throw std::invalid_argument("Unknown inputs memory " + memory + ", expected host or device");
+    }
+    setPreallocatedInputs(true);
+    deviceHostInputs = memory == "device";
+}
+
+void ImageModel::addU8ImageOutput(ov::preprocess::PrePostProcessor& ppp,
+                                  float scale,
+                                  bool reverseChannels,
+                                  bool binarize) {
+    ppp.output().model().set_layout("NCHW");
+    ppp.output().postprocess().convert_element_type(ov::element::f32);
+    ppp.output().postprocess().custom([scale, reverseChannels, binarize](const ov::Output<ov::Node>& node)
+                                          -> ov::Output<ov::Node> {
+        ov::Output<ov::Node> image = node;
+        if (binarize) {
+            const auto threshold = ov::opset8::Constant::create(ov::element::f32, ov::Shape{}, {0.5f});
+            image = std::make_shared<ov::opset8::Convert>(std::make_shared<ov::opset8::Greater>(image, threshold),
+                                                          ov::element::f32);
+        }
+        if (reverseChannels) {
+            const auto indices = ov::opset8::Constant::create(ov::element::i64, ov::Shape{3}, {2, 1, 0});
+            const auto axis = ov::opset8::Constant::create(ov::element::i64, ov::Shape{}, {1});
+            image = std::make_shared<ov::opset8::Gather>(image, indices, axis);
+        }
+        if (scale != 1.0f) {
+            image = std::make_shared<ov::opset8::Multiply>(
+                image,
+                ov::opset8::Constant::create(ov::element::f32, ov::Shape{}, {scale}));
+        }
+        // Rounding is explicit, because conversion to integer type may truncate. It matches cv::saturate_cast
+        image = std::make_shared<ov::opset8::Round>(image, ov::opset8::Round::RoundMode::HALF_TO_EVEN);
+        return std::make_shared<ov::opset8::Clamp>(image, 0.0, 255.0)->output(0);
+    });
+    ppp.output().tensor().set_element_type(ov::element::u8).set_layout("NHWC");
+}
+
+ov::OutputVector ImageModel::addHeatmapPeaks(const ov::Output<ov::Node>& heatMaps,
+                                             size_t peaksNum,
+                                             bool acrossChannels) {
+    const auto pooled = std::make_shared<ov::opset8::MaxPool>(heatMaps,
+                                                              ov::Strides{1, 1},
+                                                              ov::Strides{1, 1},
+                                                              ov::Shape{1, 1},
+                                                              ov::Shape{1, 1},
+                                                              ov::Shape{3, 3});
+    const auto isPeak = std::make_shared<ov::opset8::Equal>(pooled->output(0), heatMaps);
+    const auto lowest = ov::opset8::Constant::create(heatMaps.get_element_type(),
+                                                     ov::Shape{},
+                                                     {std::numeric_limits<float>::lowest()});
+    const auto peaks = std::make_shared<ov::opset8::Select>(isPeak, heatMaps, lowest);
+    const std::vector<int64_t> flatShape = acrossChannels ? std::vector<int64_t>{0, -1}
+                                                          : std::vector<int64_t>{0, 0, -1};
+    const auto flatPeaks = std::make_shared<ov::opset8::Reshape>(
+        peaks,
+        ov::opset8::Constant::create(ov::element::i64, ov::Shape{flatShape.size()}, flatShape),
+        true);
+    const auto k = ov::opset8::Constant::create(ov::element::i64, ov::Shape{}, {static_cast<int64_t>(peaksNum)});
+    const auto topK = std::make_shared<ov::opset8::TopK>(flatPeaks,
+                                                         k,
+                                                         -1,
+                                                         ov::opset8::TopK::Mode::MAX,
+                                                         ov::opset8::TopK::SortType::SORT_VALUES,
+                                                         ov::element::i32);
+    return {topK->output(0), topK->output(1)};
+}
+
+ov::Output<ov::Node> ImageModel::gatherAtPeaks(const ov::Output<ov::Node>& maps,
+                                               const ov::Output<ov::Node>& indices,
+                                               int64_t shift) {
+    const auto flatMaps = std::make_shared<ov::opset8::Reshape>(
+        maps,
+        ov::opset8::Constant::create(ov::element::i64, ov::Shape{3}, {0, 0, -1}),
+        true);
+    ov::Output<ov::Node> positions = indices;
+    if (shift != 0) {
+        const ov::Shape& shape = maps.get_shape();
+        size_t mapSize = 1;
+        for (size_t i = 2; i < shape.size(); ++i) {
+            mapSize *= shape[i];
+        }
+        positions = std::make_shared<ov::opset8::Add>(
+            positions,
+            ov::opset8::Constant::create(ov::element::i32, ov::Shape{}, {static_cast<int32_t>(shift)}));
+        positions = std::make_shared<ov::opset8::Clamp>(positions, 0.0, static_cast<double>(mapSize - 1));
+    }
+    const int64_t batchDims = static_cast<int64_t>(indices.get_partial_shape().rank().get_length()) - 1;
+    const auto axis = ov::opset8::Constant::create(ov::element::i64, ov::Shape{}, {2});
+    return std::make_shared<ov::opset8::Gather>(flatMaps, positions, axis, batchDims)->output(0);
+}
+
+ov::Output<ov::Node> ImageModel::gatherPeaksNeighbours(const ov::Output<ov::Node>& heatMaps,
+                                                       const ov::Output<ov::Node>& indices) {
+    const int64_t width = static_cast<int64_t>(heatMaps.get_shape()[3]);
+    const auto lastAxis = ov::opset8::Constant::create(ov::element::i64, ov::Shape{1}, {-1});
+    ov::OutputVector neighbours;
+    for (int64_t shift : {int64_t{-1}, int64_t{1}, -width, width}) {
+        neighbours.push_back(
+            std::make_shared<ov::opset8::Unsqueeze>(gatherAtPeaks(heatMaps, indices, shift), lastAxis));
+    }
+    return std::make_shared<ov::opset8::Concat>(neighbours, -1)->output(0);
+}
+
+ov::Output<ov::Node> ImageModel::getOutputSource(const std::shared_ptr<ov::Model>& model, const std::string& name) {
+    return model->output(name).get_node()->input_value(0);
+}
+
+void ImageModel::replaceOutputs(std::shared_ptr<ov::Model>& model,
+                                const std::vector<std::pair<std::string, ov::Output<ov::Node>>>& outputs) {
+    ov::OutputVector results;
+    outputsNames.clear();
+    for (const auto& output : outputs) {
+        ov::Output<ov::Node> tensor = output.second;
+        tensor.set_names({output.first});
+        results.push_back(tensor);
+        outputsNames.push_back(output.first);
+    }
+    model = std::make_shared<ov::Model>(results, model->get_parameters(), model->get_friendly_name());
+}
+
+void ImageModel::onLoadCompleted(const std::vector<ov::InferRequest>& requests) {
+    if (!preallocatedInputs) {
+        return;
+    }
+    bool useDeviceHostMemory = deviceHostInputs;
+    for (auto request : requests) {
+        const ov::Tensor& frameTensor = request.get_tensor(inputsNames[0]);  // first input should be image
+        if (useDeviceHostMemory) {
+            // Host memory of the device, e.g. USM host memory of GPU, is uploaded without a staging copy
+            try {
+                request.set_tensor(inputsNames[0],
+                                   compiledModel.get_context().create_host_tensor(frameTensor.get_element_type(),
+                                                                                  frameTensor.get_shape()));
+                continue;
+            } catch (const ov::Exception&) {
+                slog::warn << "The device can't allocate host memory, inputs are preallocated in ordinary memory"
+                           << slog::endl;
+                useDeviceHostMemory = false;
+            }
+        }
+        request.set_tensor(inputsNames[0], ov::Tensor(frameTensor.get_element_type(), frameTensor.get_shape()));
+    }
+}
+
 std::shared_ptr<InternalModelData> ImageModel::preprocess(const InputData& inputData, ov::InferRequest& request) {
     const auto& origImg = inputData.asRef<ImageInputData>().inputImage;
+    if (preallocatedInputs) {
+        const ov::Tensor& frameTensor = request.get_tensor(inputsNames[0]);  // first input should be image
+        const ov::Shape& tensorShape = frameTensor.get_shape();
+        const ov::Layout layout("NHWC");
+        const int width = static_cast<int>(tensorShape[ov::layout::width_idx(layout)]);
+        const int height = static_cast<int>(tensorShape[ov::layout::height_idx(layout)]);
+        const int channels = static_cast<int>(tensorShape[ov::layout::channels_idx(layout)]);
+        if (origImg.channels() != channels) {
+            throw std::runtime_error("The number of channels for model input and image must match");
+        }
+        if (channels != 1 && channels != 3) {
+            throw std::runtime_error("Unsupported number of channels");
+        }
+        const int depth = frameTensor.get_element_type() == ov::element::f32 ? CV_32F : CV_8U;
+        if ((inputTransform.isTrivialTransform() ? origImg.depth() : CV_32F) != depth) {
+            throw std::runtime_error("The precision of model input and image must match");
+        }
+
+#ifdef USE_FUSED_PREPROCESSING
+        if (origImg.depth() == CV_8U) {
+            // Resize, input transform and conversion to tensor precision are done reading the frame once
+            resizeNormalizeToTensor(origImg, frameTensor, layout, 0, inputTransform.getNormalizationParams());
+            return std::make_shared<InternalImageModelData>(origImg.cols, origImg.rows);
+        }
+#endif
+        cv::Mat tensorMat(height, width, CV_MAKETYPE(depth, channels), frameTensor.data());
+        if (inputTransform.isTrivialTransform()) {
+            resizeImageExt(origImg, tensorMat);
+        } else {
+            const uint8_t* resizedImageData = resizedImage.data;
+            resizedImage.create(height, width, origImg.type());
+            if (resizedImage.data != resizedImageData) {
+                ++inputAllocationsCount;
+            }
+            resizeImageExt(origImg, resizedImage);
+            inputTransform(resizedImage, tensorMat);
+        }
+        if (tensorMat.data != frameTensor.data()) {
+            throw std::logic_error("Preprocessed image wasn't written into the input tensor");
+        }
+        return std::make_shared<InternalImageModelData>(origImg.cols, origImg.rows);
+    }
+
+    const auto* roiData = dynamic_cast<const ImageROIInputData*>(&inputData);
+    if (roiData && useAutoResize && inputTransform.isTrivialTransform() && !nv12Input) {
+        // OpenVINO reads the region from the frame memory and resizes it
+        const cv::Rect& roi = roiData->roi;
+        const ov::Coordinate begin{0, static_cast<size_t>(roi.y), static_cast<size_t>(roi.x), 0};
+        const ov::Coordinate end{1,
+                                 static_cast<size_t>(roi.br().y),
+                                 static_cast<size_t>(roi.br().x),
+                                 static_cast<size_t>(roiData->frame.channels())};
+        request.set_tensor(inputsNames[0], ov::Tensor(wrapMat2Tensor(roiData->frame), begin, end));
+        return std::make_shared<InternalImageModelData>(origImg.cols, origImg.rows);
+    }
+
+    ++inputAllocationsCount;
     auto img = inputTransform(origImg);
 
     if (!useAutoResize) {
@@ -52,6 +309,76 @@ std::shared_ptr<InternalModelData> ImageModel::preprocess(const InputData& input
         }
         img = resizeImageExt(img, width, height);
     }
+    if (!img.isContinuous()) {
+        // Region of a frame which wasn't resized
+        img = img.clone();
+    }
     request.set_tensor(inputsNames[0], wrapMat2Tensor(img));
+    // Chroma of NV12 frames follows luma in the same plane
+    return std::make_shared<InternalImageModelData>(origImg.cols, nv12Input ? origImg.rows * 2 / 3 : origImg.rows);
+}
+
+std::shared_ptr<InternalModelData> ImageModel::preprocessBatchItem(const InputData& inputData,
+                                                                  ov::InferRequest& request,
+                                                                  size_t batchIdx) {
+    if (batchSize == 1) {
+        return ModelBase::preprocessBatchItem(inputData, request, batchIdx);
+    }
+    const auto& origImg = inputData.asRef<ImageInputData>().inputImage;
+    fillBatchSlot(origImg, request.get_tensor(inputsNames[0]), batchIdx);  // first input should be image
     return std::make_shared<InternalImageModelData>(origImg.cols, origImg.rows);
 }
+
+std::vector<std::shared_ptr<InternalModelData>> ImageModel::preprocessBatch(const std::vector<const InputData*>& inputs,
+                                                                            ov::InferRequest& request) {
+    if (batchSize == 1) {
+        return ModelBase::preprocessBatch(inputs, request);
+    }
+    if (inputs.empty() || inputs.size() > batchSize) {
+        throw std::invalid_argument("The number of inputs should be in range [1, batch size]");
+    }
+    const ov::Tensor& frameTensor = request.get_tensor(inputsNames[0]);  // first input should be image
+    std::vector<std::shared_ptr<InternalModelData>> internalData;
+    internalData.reserve(inputs.size());
+    for (size_t batchIdx = 0; batchIdx < inputs.size(); ++batchIdx) {
+        const auto& origImg = inputs[batchIdx]->asRef<ImageInputData>().inputImage;
+        fillBatchSlot(origImg, frameTensor, batchIdx);
+        internalData.push_back(std::make_shared<InternalImageModelData>(origImg.cols, origImg.rows));
+    }
+    return internalData;
+}
+
+void ImageModel::fillBatchSlot(const cv::Mat& origImg, const ov::Tensor& frameTensor, size_t batchIdx) {
+    if (useAutoResize) {
+        throw std::logic_error("Batched inference doesn't support resizing by openvino, disable auto resize");
+    }
+    const ov::Shape& tensorShape = frameTensor.get_shape();
+    const ov::Layout layout("NHWC");
+    const size_t width = tensorShape[ov::layout::width_idx(layout)];
+    const size_t height = tensorShape[ov::layout::height_idx(layout)];
+    const size_t channels = tensorShape[ov::layout::channels_idx(layout)];
+    if (static_cast<size_t>(origImg.channels()) != channels) {
+        throw std::runtime_error("The number of channels for model input and image must match");
+    }
+    if (channels != 1 && channels != 3) {
+        throw std::runtime_error("Unsupported number of channels");
+    }
+    const int depth = frameTensor.get_element_type() == ov::element::f32 ? CV_32F : CV_8U;
+    if ((inputTransform.isTrivialTransform() ? origImg.depth() : CV_32F) != depth) {
+        throw std::runtime_error("The precision of model input and image must match");
+    }
+
+#ifdef USE_FUSED_PREPROCESSING
+    if (origImg.depth() == CV_8U) {
+        resizeNormalizeToTensor(origImg, frameTensor, layout, batchIdx, inputTransform.getNormalizationParams());
+        return;
+    }
+#endif
+    auto img = inputTransform(origImg);
+    const size_t itemByteSize = frameTensor.get_byte_size() / tensorShape[ov::layout::batch_idx(layout)];
+    cv::Mat batchSlot(static_cast<int>(height),
+                      static_cast<int>(width),
+                      CV_MAKETYPE(depth, static_cast<int>(channels)),
+                      static_cast<uint8_t*>(frameTensor.data()) + batchIdx * itemByteSize);
+    resizeImageExt(img, batchSlot);
+}
@@ -80,7 +80,11 @@ void JPEGRestorationModel::prepareInputsOutputs(std::shared_ptr<ov::Model>& mode
     }
 
     outputsNames.push_back(model->output().get_any_name());
-    ppp.output().tensor().set_element_type(ov::element::f32);
+    if (devicePostprocessing) {
+        addU8ImageOutput(ppp, 255.0f);
+    } else {
+        ppp.output().tensor().set_element_type(ov::element::f32);
+    }
     model = ppp.build();
 
     changeInputSize(model);
@@ -139,10 +143,30 @@ std::unique_ptr<ResultBase> JPEGRestorationModel::postprocess(InferenceResult& i
     *static_cast<ResultBase*>(result) = static_cast<ResultBase&>(infResult);
 
     const auto& inputImgSize = infResult.internalModelData->asRef<InternalImageModelData>();
-    const auto outputData = infResult.getFirstOutputTensor().data<float>();
+    const ov::Tensor& outTensor = infResult.getFirstOutputTensor();
+    const bool isPadded = netInputHeight - stride < static_cast<size_t>(inputImgSize.inputImgHeight) &&
+                          static_cast<size_t>(inputImgSize.inputImgHeight) <= netInputHeight &&
+                          netInputWidth - stride < static_cast<size_t>(inputImgSize.inputImgWidth) &&
+                          static_cast<size_t>(inputImgSize.inputImgWidth) <= netInputWidth;
+    if (outTensor.get_element_type() == ov::element::u8) {
+        const ov::Layout layout("NHWC");
+        const cv::Mat outImg(static_cast<int>(outTensor.get_shape()[ov::layout::height_idx(layout)]),
+                             static_cast<int>(outTensor.get_shape()[ov::layout::width_idx(layout)]),
+                             CV_8UC3,
+                             outTensor.data());
+        if (isPadded) {
+            // The tensor is reused by next inferences, so the image is copied
+            const cv::Rect inputImgRect(0, 0, inputImgSize.inputImgWidth, inputImgSize.inputImgHeight);
+            result->resultImage = outImg(inputImgRect).clone();
+        } else {
+            cv::resize(outImg, result->resultImage, cv::Size(inputImgSize.inputImgWidth, inputImgSize.inputImgHeight));
+        }
+        return std::unique_ptr<ResultBase>(result);
+    }
+    const auto outputData = outTensor.data<float>();
 
     std::vector<cv::Mat> imgPlanes;
-    const ov::Shape& outputShape = infResult.getFirstOutputTensor().get_shape();
+    const ov::Shape& outputShape = outTensor.get_shape();
     const size_t outHeight = static_cast<int>(outputShape[2]);
     const size_t outWidth = static_cast<int>(outputShape[3]);
     const size_t numOfPixels = outWidth * outHeight;
@@ -152,10 +176,7 @@ std::unique_ptr<ResultBase> JPEGRestorationModel::postprocess(InferenceResult& i
     cv::Mat resultImg;
     cv::merge(imgPlanes, resultImg);
 
-    if (netInputHeight - stride < static_cast<size_t>(inputImgSize.inputImgHeight) &&
-        static_cast<size_t>(inputImgSize.inputImgHeight) <= netInputHeight &&
-        netInputWidth - stride < static_cast<size_t>(inputImgSize.inputImgWidth) &&
-        static_cast<size_t>(inputImgSize.inputImgWidth) <= netInputWidth) {
+    if (isPadded) {
         result->resultImage = resultImg(cv::Rect(0, 0, inputImgSize.inputImgWidth, inputImgSize.inputImgHeight));
     } else {
         cv::resize(resultImg, result->resultImage, cv::Size(inputImgSize.inputImgWidth, inputImgSize.inputImgHeight));
@@ -16,26 +16,46 @@
 
 #include "models/model_base.h"
 
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include <openvino/openvino.hpp>
 
 #include <utils/common.hpp>
 #include <utils/config_factory.h>
+#include <utils/config_tuner.h>
 #include <utils/ocv_common.hpp>
+#include <utils/remote_inference.hpp>
 #include <utils/slog.hpp>
 
+std::unique_ptr<ModelBase> ModelBase::clone() const {
+    throw std::logic_error("The model wrapper doesn't support cloning");
+}
+
 std::shared_ptr<ov::Model> ModelBase::prepareModel(ov::Core& core) {
     // --------------------------- Read IR Generated by ModelOptimizer (.xml and .bin files) ------------
     /** Read model **/
     slog::info << "Reading model " << modelFileName << slog::endl;
+    auto startTime = std::chrono::steady_clock::now();
     std::shared_ptr<ov::Model> model = core.read_model(modelFileName);
+    readModelTime = std::chrono::steady_clock::now() - startTime;
     logBasicModelInfo(model);
     // -------------------------- Reading all outputs names and customizing I/O tensors (in inherited classes)
+    startTime = std::chrono::steady_clock::now();
     prepareInputsOutputs(model);
+    embedPreprocessing(model);
+    sharedOutputsNames = std::make_shared<const std::vector<std::string>>(outputsNames);
 
-    /** Set batch size to 1 **/
-    ov::set_batch(model, 1);
+    /** Set batch size (1 unless batched inference is requested) **/
+    ov::set_batch(model, batchSize);
+    prepareModelTime = std::chrono::steady_clock::now() - startTime;
 
     return model;
 }
@@ -43,11 +63,124 @@ std::shared_ptr<ov::Model> ModelBase::prepareModel(ov::Core& core) {
 ov::CompiledModel ModelBase::compileModel(const ModelConfig& config, ov::Core& core) {
     this->config = config;
     auto model = prepareModel(core);
-    compiledModel = core.compile_model(model, config.deviceName, config.compiledModelConfig);
+    if (!config.remoteWorker.empty()) {
+        if (config.tuning.objective != TuningConfig::None) {
+            throw std::invalid_argument("Tuning of remotely inferred models isn't supported");
+        }
+        auto startTime = std::chrono::steady_clock::now();
+        remoteClient = std::make_shared<RemoteInferenceClient>(config.remoteWorker);
+        compiledModel = remoteClient->compileModel(model, config, core);
+        std::chrono::duration<double, std::milli> compileTime = std::chrono::steady_clock::now() - startTime;
+        slog::info << "\tStartup time: reading " << std::fixed << std::setprecision(1) << readModelTime.count()
+                   << " ms, inputs/outputs setup " << prepareModelTime.count() << " ms, remote compilation "
+                   << compileTime.count() << " ms" << slog::endl;
+        return compiledModel;
+    }
+    if (config.tuning.objective != TuningConfig::None) {
+        this->config = ConfigTuner(config.tuning).tune(model, modelFileName, config, core);
+    }
+    if (!config.cacheDir.empty()) {
+        // The cache is keyed by the model, device and compilation config, so the same directory serves all models
+        core.set_property(ov::cache_dir(config.cacheDir));
+        slog::info << "\tModel cache directory: " << config.cacheDir << slog::endl;
+    }
+    auto startTime = std::chrono::steady_clock::now();
+    compiledModel = core.compile_model(model, this->config.deviceName, this->config.compiledModelConfig);
+    std::chrono::duration<double, std::milli> compileTime = std::chrono::steady_clock::now() - startTime;
     logCompiledModelInfo(compiledModel, modelFileName, config.deviceName);
+    slog::info << "\tStartup time: reading " << std::fixed << std::setprecision(1) << readModelTime.count()
+               << " ms, inputs/outputs setup " << prepareModelTime.count() << " ms, "
+               << (config.cacheDir.empty() ? "compilation " : "compilation or import from cache ")
+               << compileTime.count() << " ms" << slog::endl;
     return compiledModel;
 }
 
+std::vector<std::map<std::string, ov::Shape>> ModelBase::getWarmupShapes() const {
+    std::map<std::string, ov::Shape> shapes;
+    for (const auto& input : compiledModel.inputs()) {
+        if (input.get_partial_shape().is_dynamic()) {
+            return {};
+        }
+        shapes.emplace(input.get_any_name(), input.get_shape());
+    }
+    return {shapes};
+}
+
+void ModelBase::warmUp(const std::vector<ov::InferRequest>& requests, unsigned int inferencesNum) {
+    if (inferencesNum == 0 || requests.empty()) {
+        return;
+    }
+    const std::vector<std::map<std::string, ov::Shape>> shapesList = getWarmupShapes();
+    if (shapesList.empty()) {
+        slog::warn << "\tWarm-up is skipped, shapes of the model inputs are unknown" << slog::endl;
+        return;
+    }
+    auto startTime = std::chrono::steady_clock::now();
+    std::vector<ov::InferRequest> warmupRequests = requests;
+    // Tensors of static inputs are restored, dynamic inputs are reshaped by preprocessing anyway
+    std::vector<std::map<std::string, ov::Tensor>> ownTensors(warmupRequests.size());
+    for (size_t i = 0; i < warmupRequests.size(); ++i) {
+        for (const auto& input : compiledModel.inputs()) {
+            if (input.get_partial_shape().is_static()) {
+                ownTensors[i].emplace(input.get_any_name(), warmupRequests[i].get_tensor(input));
+            }
+        }
+    }
+    for (const auto& shapes : shapesList) {
+        for (size_t i = 0; i < warmupRequests.size(); ++i) {
+            for (const auto& shape : shapes) {
+                // Own tensors of the requests are used if they fit, so e.g. preallocated device memory is warmed up
+                auto ownTensor = ownTensors[i].find(shape.first);
+                ov::Tensor tensor = ownTensor != ownTensors[i].end() && ownTensor->second.get_shape() == shape.second
+                                        ? ownTensor->second
+                                        : ov::Tensor(compiledModel.input(shape.first).get_element_type(),
+                                                     shape.second);
+                std::memset(tensor.data(), 0, tensor.get_byte_size());
+                warmupRequests[i].set_tensor(shape.first, tensor);
+            }
+        }
+        for (unsigned int iteration = 0; iteration < inferencesNum; ++iteration) {
+            for (ov::InferRequest& request : warmupRequests) {
+                request.start_async();
+            }
+            for (ov::InferRequest& request : warmupRequests) {
+                request.wait();
+            }
+        }
+    }
+    for (size_t i = 0; i < warmupRequests.size(); ++i) {
+        for (const auto& tensor : ownTensors[i]) {
+            warmupRequests[i].set_tensor(tensor.first, tensor.second);
+        }
+    }
+    std::chrono::duration<double, std::milli> warmupTime = std::chrono::steady_clock::now() - startTime;
+    slog::info << "\tWarm-up: " << inferencesNum * shapesList.size() << " inferences of every of "
+               << warmupRequests.size() << " infer requests, " << std::fixed << std::setprecision(1)
+               << warmupTime.count() << " ms" << slog::endl;
+}
+
+std::shared_ptr<InternalModelData> ModelBase::preprocessBatchItem(const InputData& inputData,
+                                                                 ov::InferRequest& request,
+                                                                 size_t batchIdx) {
+    if (batchSize != 1 || batchIdx != 0) {
+        throw std::logic_error("The model wrapper doesn't support batched inference");
+    }
+    return preprocess(inputData, request);
+}
+
+std::vector<std::shared_ptr<InternalModelData>> ModelBase::preprocessBatch(const std::vector<const InputData*>& inputs,
+                                                                           ov::InferRequest& request) {
+    if (inputs.empty() || inputs.size() > batchSize) {
+        throw std::invalid_argument("The number of inputs should be in range [1, batch size]");
+    }
+    std::vector<std::shared_ptr<InternalModelData>> internalData;
+    internalData.reserve(inputs.size());
+    for (size_t batchIdx = 0; batchIdx < inputs.size(); ++batchIdx) {
+        internalData.push_back(preprocessBatchItem(*inputs[batchIdx], request, batchIdx));
+    }
+    return internalData;
+}
+
 ov::Layout ModelBase::getInputLayout(const ov::Output<ov::Node>& input) {
     const ov::Shape& inputShape = input.get_shape();
     ov::Layout layout = ov::layout::get_layout(input);
@@ -16,9 +16,13 @@
 
 #include "models/openpose_decoder.h"
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <algorithm>
 #include <cmath>
 #include <memory>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
@@ -45,42 +49,34 @@ void findPeaks(const std::vector<cv::Mat>& heatMaps,
                float confidenceThreshold) {
     std::vector<cv::Point> peaks;
     const cv::Mat& heatMap = heatMaps[heatMapId];
-    const float* heatMapData = heatMap.ptr<float>();
-    size_t heatMapStep = heatMap.step1();
-    for (int y = -1; y < heatMap.rows + 1; y++) {
-        for (int x = -1; x < heatMap.cols + 1; x++) {
-            float val = 0;
-            if (x >= 0 && y >= 0 && x < heatMap.cols && y < heatMap.rows) {
-                val = heatMapData[y * heatMapStep + x];
-                val = val >= confidenceThreshold ? val : 0;
-            }
-
-            float left_val = 0;
-            if (y >= 0 && x < (heatMap.cols - 1) && y < heatMap.rows) {
-                left_val = heatMapData[y * heatMapStep + x + 1];
-                left_val = left_val >= confidenceThreshold ? left_val : 0;
-            }
-
-            float right_val = 0;
-            if (x > 0 && y >= 0 && y < heatMap.rows) {
-                right_val = heatMapData[y * heatMapStep + x - 1];
-                right_val = right_val >= confidenceThreshold ? right_val : 0;
-            }
-
-            float top_val = 0;
-            if (x >= 0 && x < heatMap.cols && y < (heatMap.rows - 1)) {
-                top_val = heatMapData[(y + 1) * heatMapStep + x];
-                top_val = top_val >= confidenceThreshold ? top_val : 0;
-            }
 
-            float bottom_val = 0;
-            if (x >= 0 && y > 0 && x < heatMap.cols) {
-                bottom_val = heatMapData[(y - 1) * heatMapStep + x];
-                bottom_val = bottom_val >= confidenceThreshold ? bottom_val : 0;
-            }
+    // Values below the threshold are zeroed. Zero border of 2 pixels makes neighbours of positions just outside the
+    // map available, so the local maximum test is the same branchless loop for every position.
+    const int padding = 2;
+    const int paddedWidth = heatMap.cols + 2 * padding;
+    std::vector<float> paddedMap(static_cast<size_t>(paddedWidth) * (heatMap.rows + 2 * padding), 0.0f);
+    for (int y = 0; y < heatMap.rows; y++) {
+        const float* heatMapRow = heatMap.ptr<float>(y);
+        float* paddedRow = &paddedMap[(y + padding) * paddedWidth + padding];
+        for (int x = 0; x < heatMap.cols; x++) {
+            paddedRow[x] = heatMapRow[x] >= confidenceThreshold ? heatMapRow[x] : 0;
+        }
+    }
 
-            if ((val > left_val) && (val > right_val) && (val > top_val) && (val > bottom_val)) {
-                peaks.push_back(cv::Point(x, y));
+    // Positions are tested in range [-1, size] along both axes
+    const int testedWidth = heatMap.cols + 2;
+    std::vector<uint8_t> isPeak(testedWidth);
+    for (int y = -1; y < heatMap.rows + 1; y++) {
+        const float* row = &paddedMap[(y + padding) * paddedWidth + padding - 1];
+        const float* rowAbove = row - paddedWidth;
+        const float* rowBelow = row + paddedWidth;
+        for (int i = 0; i < testedWidth; i++) {
+            const float val = row[i];
+            isPeak[i] = (val > row[i + 1]) & (val > row[i - 1]) & (val > rowBelow[i]) & (val > rowAbove[i]);
+        }
+        for (int i = 0; i < testedWidth; i++) {
+            if (isPeak[i]) {
+                peaks.push_back(cv::Point(i - 1, y));
             }
         }
     }
@@ -93,6 +89,10 @@ void findPeaks(const std::vector<cv::Mat>& heatMaps,
     for (size_t i = 0; i < peaks.size(); i++) {
         if (isActualPeak[i]) {
             for (size_t j = i + 1; j < peaks.size(); j++) {
+                // Peaks are sorted by x, so the rest of them are too far
+                if (peaks[j].x - peaks[i].x >= minPeaksDistance) {
+                    break;
+                }
                 if (sqrt((peaks[i].x - peaks[j].x) * (peaks[i].x - peaks[j].x) +
                          (peaks[i].y - peaks[j].y) * (peaks[i].y - peaks[j].y)) < minPeaksDistance) {
                     isActualPeak[j] = false;
@@ -103,6 +103,70 @@ void findPeaks(const std::vector<cv::Mat>& heatMaps,
     }
 }
 
+namespace {
+// Offset of the vertex of the parabola through (-1, prev), (0, val) and (1, next), it is within 0.5 for a peak
+float parabolaVertexOffset(float prev, float val, float next) {
+    const float curvature = prev - 2 * val + next;
+    return curvature < 0 ? clamp(0.5f * (prev - next) / curvature, -0.5f, 0.5f) : 0.0f;
+}
+}  // namespace
+
+void refinePeaks(const cv::Mat& heatMap, std::vector<Peak>& peaks) {
+    for (Peak& peak : peaks) {
+        const int x = static_cast<int>(peak.pos.x);
+        const int y = static_cast<int>(peak.pos.y);
+        const float val = heatMap.at<float>(y, x);
+        if (x > 0 && x < heatMap.cols - 1) {
+            peak.pos.x += parabolaVertexOffset(heatMap.at<float>(y, x - 1), val, heatMap.at<float>(y, x + 1));
+        }
+        if (y > 0 && y < heatMap.rows - 1) {
+            peak.pos.y += parabolaVertexOffset(heatMap.at<float>(y - 1, x), val, heatMap.at<float>(y + 1, x));
+        }
+    }
+}
+
+void selectPeaks(const float* scores,
+                 const int32_t* indices,
+                 const float* neighbours,
+                 size_t candidatesNum,
+                 const cv::Size& mapSize,
+                 float minPeaksDistance,
+                 float confidenceThreshold,
+                 std::vector<Peak>& peaks) {
+    peaks.clear();
+    std::vector<cv::Point> positions;
+    std::vector<size_t> candidates;
+    for (size_t i = 0; i < candidatesNum && scores[i] >= confidenceThreshold; i++) {
+        const cv::Point pos(indices[i] % mapSize.width, indices[i] / mapSize.width);
+        bool isSuppressed = false;
+        for (const cv::Point& higherPos : positions) {
+            const cv::Point diff = pos - higherPos;
+            if (std::sqrt(static_cast<float>(diff.x * diff.x + diff.y * diff.y)) < minPeaksDistance) {
+                isSuppressed = true;
+                break;
+            }
+        }
+        if (!isSuppressed) {
+            positions.push_back(pos);
+            candidates.push_back(i);
+        }
+    }
+    for (size_t i = 0; i < positions.size(); i++) {
+        cv::Point2f pos = positions[i];
+        const float val = scores[candidates[i]];
+        if (neighbours) {
+            const float* around = neighbours + candidates[i] * 4;
+            if (positions[i].x > 0 && positions[i].x < mapSize.width - 1) {
+                pos.x += parabolaVertexOffset(around[0], val, around[1]);
+            }
+            if (positions[i].y > 0 && positions[i].y < mapSize.height - 1) {
+                pos.y += parabolaVertexOffset(around[2], val, around[3]);
+            }
+        }
+        peaks.push_back(Peak(static_cast<int>(i), pos, val));
+    }
+}
+
 std::vector<HumanPose> groupPeaksToPoses(const std::vector<std::vector<Peak>>& allPeaks,
                                          const std::vector<cv::Mat>& pafs,
                                          const size_t keypointsNumber,
@@ -154,6 +218,8 @@ std::vector<HumanPose> groupPeaksToPoses(const std::vector<std::vector<Peak>>& a
         candidates.insert(candidates.end(), peaks.begin(), peaks.end());
     }
     std::vector<HumanPoseByPeaksIndices> subset(0, HumanPoseByPeaksIndices(keypointsNumber));
+    const int height_n = pafs[0].rows / 2;
+    const int mid_num = 10;
     for (size_t k = 0; k < arraySize(limbIdsPaf); k++) {
         std::vector<TwoJointsConnection> connections;
         const int mapIdxOffset = keypointsNumber + 1;
@@ -206,6 +272,12 @@ std::vector<HumanPose> groupPeaksToPoses(const std::vector<std::vector<Peak>>& a
         }
 
         std::vector<TwoJointsConnection> tempJointConnections;
+        const float* pafXData = scoreMid.first.ptr<float>();
+        const float* pafYData = scoreMid.second.ptr<float>();
+        const size_t pafStep = scoreMid.first.step1();
+        if (scoreMid.second.step1() != pafStep) {
+            throw std::logic_error("PAF planes of a limb should have the same layout");
+        }
         for (size_t i = 0; i < nJointsA; i++) {
             for (size_t j = 0; j < nJointsB; j++) {
                 cv::Point2f pt = candA[i].pos * 0.5 + candB[j].pos * 0.5;
@@ -217,25 +289,28 @@ std::vector<HumanPose> groupPeaksToPoses(const std::vector<std::vector<Peak>>& a
                 }
                 vec /= norm_vec;
                 float score = vec.x * scoreMid.first.at<float>(mid) + vec.y * scoreMid.second.at<float>(mid);
-                int height_n = pafs[0].rows / 2;
                 float suc_ratio = 0.0f;
                 float mid_score = 0.0f;
-                const int mid_num = 10;
                 const float scoreThreshold = -100.0f;
                 if (score > scoreThreshold) {
                     float p_sum = 0;
                     int p_count = 0;
                     cv::Size2f step((candB[j].pos.x - candA[i].pos.x) / (mid_num - 1),
                                     (candB[j].pos.y - candA[i].pos.y) / (mid_num - 1));
+                    // Both PAF planes are sampled at the same offsets, then scores are accumulated without branches
+                    float predX[mid_num];
+                    float predY[mid_num];
+                    for (int n = 0; n < mid_num; n++) {
+                        const size_t offset = cvRound(candA[i].pos.y + n * step.height) * pafStep +
+                                              cvRound(candA[i].pos.x + n * step.width);
+                        predX[n] = pafXData[offset];
+                        predY[n] = pafYData[offset];
+                    }
                     for (int n = 0; n < mid_num; n++) {
-                        cv::Point midPoint(cvRound(candA[i].pos.x + n * step.width),
-                                           cvRound(candA[i].pos.y + n * step.height));
-                        cv::Point2f pred(scoreMid.first.at<float>(midPoint), scoreMid.second.at<float>(midPoint));
-                        score = vec.x * pred.x + vec.y * pred.y;
-                        if (score > midPointsScoreThreshold) {
-                            p_sum += score;
-                            p_count++;
-                        }
+                        score = vec.x * predX[n] + vec.y * predY[n];
+                        const bool isAboveThreshold = score > midPointsScoreThreshold;
+                        p_sum += isAboveThreshold ? score : 0.0f;
+                        p_count += isAboveThreshold;
                     }
                     suc_ratio = static_cast<float>(p_count / mid_num);
                     float ratio = p_count > 0 ? p_sum / p_count : 0.0f;
@@ -19,6 +19,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <fstream>
 #include <stdexcept>
 #include <string>
@@ -27,10 +28,35 @@
 #include <opencv2/core.hpp>
 #include <opencv2/imgproc.hpp>
 #include <openvino/openvino.hpp>
+#include <openvino/opsets/opset8.hpp>
 
 #include "models/internal_model_data.h"
 #include "models/results.h"
 
+namespace {
+// Channels are the outermost dimension, so maximums of all pixels are updated by contiguous channel planes in a loop
+// which compilers vectorize. f16 probabilities are compared after conversion of every element, so the tensor isn't
+// converted as a whole.
+template <typename T>
+void argmaxChannels(const T* data, int channels, cv::Mat& classMap, cv::Mat& maxProbs) {
+    const size_t pixelsCount = classMap.total();
+    uint8_t* classes = classMap.ptr<uint8_t>();
+    float* probs = maxProbs.ptr<float>();
+    std::fill(classes, classes + pixelsCount, uint8_t(0));
+    std::fill(probs, probs + pixelsCount, -1.0f);
+    for (int chId = 0; chId < channels; ++chId) {
+        const T* plane = data + chId * pixelsCount;
+        const uint8_t classId = static_cast<uint8_t>(chId);
+        for (size_t i = 0; i < pixelsCount; ++i) {
+            const float prob = static_cast<float>(plane[i]);
+            const bool isMax = prob > probs[i];
+            probs[i] = isMax ? prob : probs[i];
+            classes[i] = isMax ? classId : classes[i];
+        }
+    }
+}
+}  // namespace
+
 SegmentationModel::SegmentationModel(const std::string& modelFileName, bool useAutoResize, const std::string& layout)
     : ImageModel(modelFileName, useAutoResize, layout) {}
 
@@ -108,45 +134,69 @@ void SegmentationModel::prepareInputsOutputs(std::shared_ptr<ov::Model>& model)
         default:
             throw std::logic_error("Unexpected output tensor shape. Only 4D and 3D outputs are supported.");
     }
+
+    // Confidence requires probabilities of the classes, so argmax on the device is used without it only
+    if (devicePostprocessing && !computeConfidence && outChannels > 1) {
+        ov::preprocess::PrePostProcessor outputPpp(model);
+        outputPpp.output().postprocess().custom([](const ov::Output<ov::Node>& node) {
+            const auto k = ov::opset8::Constant::create(ov::element::i64, ov::Shape{}, {1});
+            return std::make_shared<ov::opset8::TopK>(node,
+                                                      k,
+                                                      ov::layout::channels_idx(ov::Layout("NCHW")),
+                                                      ov::opset8::TopK::Mode::MAX,
+                                                      ov::opset8::TopK::SortType::NONE,
+                                                      ov::element::i32)
+                ->output(1);
+        });
+        outputPpp.output().tensor().set_element_type(ov::element::u8);
+        model = outputPpp.build();
+        outChannels = 1;
+    } else if (outChannels > 1) {
+        ov::preprocess::PrePostProcessor outputPpp(model);
+        outputPpp.output().tensor().set_element_type(getOutputsPrecision());
+        model = outputPpp.build();
+    }
 }
 
 std::unique_ptr<ResultBase> SegmentationModel::postprocess(InferenceResult& infResult) {
-    ImageResult* result = new ImageResult(infResult.frameId, infResult.metaData);
     const auto& inputImgSize = infResult.internalModelData->asRef<InternalImageModelData>();
     const auto& outTensor = infResult.getFirstOutputTensor();
 
-    result->resultImage = cv::Mat(outHeight, outWidth, CV_8UC1);
-
-    if (outChannels == 1 && outTensor.get_element_type() == ov::element::i32) {
+    cv::Mat classMap(outHeight, outWidth, CV_8UC1);
+    cv::Mat confidenceMap;
+    if (outChannels == 1 && outTensor.get_element_type() == ov::element::u8) {
+        // The tensor is reused by next inferences, so the class map is copied
+        cv::Mat(outHeight, outWidth, CV_8UC1, outTensor.data()).copyTo(classMap);
+    } else if (outChannels == 1 && outTensor.get_element_type() == ov::element::i32) {
         cv::Mat predictions(outHeight, outWidth, CV_32SC1, outTensor.data<int32_t>());
-        predictions.convertTo(result->resultImage, CV_8UC1);
+        predictions.convertTo(classMap, CV_8UC1);
     } else if (outChannels == 1 && outTensor.get_element_type() == ov::element::i64) {
         cv::Mat predictions(outHeight, outWidth, CV_32SC1);
         const auto data = outTensor.data<int64_t>();
         for (size_t i = 0; i < predictions.total(); ++i) {
             reinterpret_cast<int32_t*>(predictions.data)[i] = int32_t(data[i]);
         }
-        predictions.convertTo(result->resultImage, CV_8UC1);
+        predictions.convertTo(classMap, CV_8UC1);
     } else if (outTensor.get_element_type() == ov::element::f32) {
-        const float* data = outTensor.data<float>();
-        for (int rowId = 0; rowId < outHeight; ++rowId) {
-            for (int colId = 0; colId < outWidth; ++colId) {
-                int classId = 0;
-                float maxProb = -1.0f;
-                for (int chId = 0; chId < outChannels; ++chId) {
-                    float prob = data[chId * outHeight * outWidth + rowId * outWidth + colId];
-                    if (prob > maxProb) {
-                        classId = chId;
-                        maxProb = prob;
-                    }
-                }  // nChannels
-
-                result->resultImage.at<uint8_t>(rowId, colId) = classId;
-            }  // width
-        }  // height
+        confidenceMap.create(outHeight, outWidth, CV_32FC1);
+        argmaxChannels(outTensor.data<float>(), outChannels, classMap, confidenceMap);
+    } else if (outTensor.get_element_type() == ov::element::f16) {
+        confidenceMap.create(outHeight, outWidth, CV_32FC1);
+        argmaxChannels(outTensor.data<ov::float16>(), outChannels, classMap, confidenceMap);
+    }
+
+    if (lazyUpscale) {
+        SegmentationResult* result = new SegmentationResult(infResult.frameId, infResult.metaData);
+        result->classMap = classMap;
+        if (computeConfidence) {
+            result->confidenceMap = confidenceMap;
+        }
+        result->inputImageSize = cv::Size(inputImgSize.inputImgWidth, inputImgSize.inputImgHeight);
+        return std::unique_ptr<ResultBase>(result);
     }
 
-    cv::resize(result->resultImage,
+    ImageResult* result = new ImageResult(infResult.frameId, infResult.metaData);
+    cv::resize(classMap,
                result->resultImage,
                cv::Size(inputImgSize.inputImgWidth, inputImgSize.inputImgHeight),
                0,
@@ -77,7 +77,12 @@ void StyleTransferModel::prepareInputsOutputs(std::shared_ptr<ov::Model>& model)
         throw std::logic_error("3-channel 4-dimensional model's output is expected");
     }
 
-    ppp.output().tensor().set_element_type(ov::element::f32);
+    if (devicePostprocessing) {
+        // The model output is RGB image in range [0, 255]
+        addU8ImageOutput(ppp, 1.0f, true);
+    } else {
+        ppp.output().tensor().set_element_type(ov::element::f32);
+    }
     model = ppp.build();
 }
 
@@ -97,9 +102,19 @@ std::unique_ptr<ResultBase> StyleTransferModel::postprocess(InferenceResult& inf
     *static_cast<ResultBase*>(result) = static_cast<ResultBase&>(infResult);
 
     const auto& inputImgSize = infResult.internalModelData->asRef<InternalImageModelData>();
-    const auto outputData = infResult.getFirstOutputTensor().data<float>();
+    const ov::Tensor& outTensor = infResult.getFirstOutputTensor();
+    if (outTensor.get_element_type() == ov::element::u8) {
+        const ov::Layout layout("NHWC");
+        const int outHeight = static_cast<int>(outTensor.get_shape()[ov::layout::height_idx(layout)]);
+        const int outWidth = static_cast<int>(outTensor.get_shape()[ov::layout::width_idx(layout)]);
+        cv::resize(cv::Mat(outHeight, outWidth, CV_8UC3, outTensor.data()),
+                   result->resultImage,
+                   cv::Size(inputImgSize.inputImgWidth, inputImgSize.inputImgHeight));
+        return std::unique_ptr<ResultBase>(result);
+    }
+    const auto outputData = outTensor.data<float>();
 
-    const ov::Shape& outputShape = infResult.getFirstOutputTensor().get_shape();
+    const ov::Shape& outputShape = outTensor.get_shape();
     size_t outHeight = static_cast<int>(outputShape[2]);
     size_t outWidth = static_cast<int>(outputShape[3]);
     size_t numOfPixels = outWidth * outHeight;
@@ -100,14 +100,20 @@ void SuperResolutionModel::prepareInputsOutputs(std::shared_ptr<ov::Model>& mode
     }
 
     outputsNames.push_back(outputs.begin()->get_any_name());
-    ppp.output().tensor().set_element_type(ov::element::f32);
+    if (devicePostprocessing) {
+        // Output of text-image-super-resolution models is a single channel which is binarized
+        const bool isTextModel = outputs.begin()->get_shape()[ov::layout::channels_idx(ov::Layout("NCHW"))] == 1;
+        addU8ImageOutput(ppp, 255.0f, false, isTextModel);
+    } else {
+        ppp.output().tensor().set_element_type(ov::element::f32);
+    }
     model = ppp.build();
 
     const ov::Shape& outShape = model->output().get_shape();
 
-    const ov::Layout outputLayout("NCHW");
+    const ov::Layout outputLayout(devicePostprocessing ? "NHWC" : "NCHW");
     const auto outWidth = outShape[ov::layout::width_idx(outputLayout)];
-    const auto inWidth = lrShape[ov::layout::width_idx(outputLayout)];
+    const auto inWidth = lrShape[widthId];
     changeInputSize(model, static_cast<int>(outWidth / inWidth));
 }
 
@@ -161,6 +167,10 @@ std::shared_ptr<InternalModelData> SuperResolutionModel::preprocess(const InputD
     const size_t height = lrInputTensor.get_shape()[ov::layout::height_idx(layout)];
     const size_t width = lrInputTensor.get_shape()[ov::layout::width_idx(layout)];
     img = resizeImageExt(img, width, height);
+    if (!img.isContinuous()) {
+        // Tile of an image which wasn't resized
+        img = img.clone();
+    }
     request.set_tensor(inputsNames[0], wrapMat2Tensor(img));
 
     if (inputsNames.size() == 2) {
@@ -178,10 +188,22 @@ std::shared_ptr<InternalModelData> SuperResolutionModel::preprocess(const InputD
 std::unique_ptr<ResultBase> SuperResolutionModel::postprocess(InferenceResult& infResult) {
     ImageResult* result = new ImageResult;
     *static_cast<ResultBase*>(result) = static_cast<ResultBase&>(infResult);
-    const auto outputData = infResult.getFirstOutputTensor().data<float>();
+    const ov::Tensor& outTensor = infResult.getFirstOutputTensor();
+    if (outTensor.get_element_type() == ov::element::u8) {
+        const ov::Shape& outShape = outTensor.get_shape();
+        const ov::Layout layout("NHWC");
+        // The tensor is reused by next inferences, so the image is copied
+        result->resultImage = cv::Mat(static_cast<int>(outShape[ov::layout::height_idx(layout)]),
+                                      static_cast<int>(outShape[ov::layout::width_idx(layout)]),
+                                      CV_8UC(static_cast<int>(outShape[ov::layout::channels_idx(layout)])),
+                                      outTensor.data())
+                                  .clone();
+        return std::unique_ptr<ResultBase>(result);
+    }
+    const auto outputData = outTensor.data<float>();
 
     std::vector<cv::Mat> imgPlanes;
-    const ov::Shape& outShape = infResult.getFirstOutputTensor().get_shape();
+    const ov::Shape& outShape = outTensor.get_shape();
     const size_t outChannels = static_cast<int>(outShape[1]);
     const size_t outHeight = static_cast<int>(outShape[2]);
     const size_t outWidth = static_cast<int>(outShape[3]);
@@ -6,10 +6,18 @@
 
 #include <deque>
 #include <memory>
+#include <string>
 #include <vector>
 
 class CpuMonitor {
 public:
+    struct ThreadLoad {
+        long id;
+        std::string name;
+        double load;  // during the last sample, 1 is one core fully loaded
+        double meanLoad;  // since the thread was sampled first time
+    };
+
     CpuMonitor();
     ~CpuMonitor();
     void setHistorySize(std::size_t size);
@@ -17,12 +25,15 @@ public:
     void collectData();
     std::deque<std::vector<double>> getLastHistory() const;
     std::vector<double> getMeanCpuLoad() const;
+    // threads of the process alive at the last sample, empty if it isn't supported on the platform
+    std::vector<ThreadLoad> getThreadsLoad() const;
 
 private:
     unsigned samplesNumber;
     unsigned historySize;
     std::vector<double> cpuLoadSum;
     std::deque<std::vector<double>> cpuLoadHistory;
+    std::vector<ThreadLoad> threadsLoad;
     class PerformanceCounter;
     std::unique_ptr<PerformanceCounter> performanceCounter;
 };
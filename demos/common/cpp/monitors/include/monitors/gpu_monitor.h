@@ -0,0 +1,37 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <utility>
+
+/// Samples utilization and frequency of an Intel GPU driven by i915 or xe. The GPU is busy while it isn't in its idle
+/// power state (RC6), so the utilization is one minus the share of time the idle residency counter of sysfs grows by.
+/// Linux only, the monitor is unavailable on other platforms and without an Intel GPU.
+class GpuMonitor {
+public:
+    GpuMonitor();
+    ~GpuMonitor();
+    void setHistorySize(std::size_t size);
+    std::size_t getHistorySize() const;
+    /// @returns false if no Intel GPU is found, history stays empty then
+    bool isAvailable() const;
+    void collectData();
+    /// @returns utilization in range [0, 1] between two samples and actual frequency in MHz at the sample, the
+    /// frequency is 0 while the GPU is idle
+    std::deque<std::pair<double, double>> getLastHistory() const;
+    double getMeanUtilization() const;
+    double getMeanFrequency() const;  // in MHz
+    double getMaxFrequency() const;  // the highest frequency the GPU may run at
+private:
+    unsigned samplesNumber;
+    std::size_t historySize;
+    double utilizationSum, frequencySum;
+    double maxFrequency;
+    std::deque<std::pair<double, double>> usageHistory;
+    class PerformanceCounter;
+    std::unique_ptr<PerformanceCounter> performanceCounter;
+};
@@ -21,6 +21,8 @@ public:
     double getMaxSwap() const;
     double getMemTotal() const;
     double getMaxMemTotal() const; // a system may have hotpluggable memory
+    double getLastRss() const; // resident set size of the process in GiB
+    double getMaxRss() const;
 private:
     unsigned samplesNumber;
     std::size_t historySize;
@@ -28,6 +30,7 @@ private:
     double maxMem, maxSwap;
     double memTotal;
     double maxMemTotal;
+    double lastRss, maxRss;
     std::deque<std::pair<double, double>> memSwapUsageHistory;
     class PerformanceCounter;
     std::unique_ptr<PerformanceCounter> performanceCounter;
@@ -0,0 +1,39 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <utility>
+
+/// Samples power of CPU packages and DRAM from the energy counters of RAPL (Running Average Power Limit), which Linux
+/// exposes by powercap sysfs. The counters are readable by root only on most distributions, the monitor is unavailable
+/// then, as on other platforms.
+class PowerMonitor {
+public:
+    PowerMonitor();
+    ~PowerMonitor();
+    void setHistorySize(std::size_t size);
+    std::size_t getHistorySize() const;
+    /// @returns false if no energy counter can be read, history stays empty then
+    bool isAvailable() const;
+    void collectData();
+    /// @returns package and DRAM power in W between two samples
+    std::deque<std::pair<double, double>> getLastHistory() const;
+    double getMeanPackagePower() const;
+    double getMeanDramPower() const;
+    /// @returns mean of package and DRAM power, the power the throughput per watt is estimated by
+    double getMeanPower() const;
+    double getMaxPower() const;
+
+private:
+    unsigned samplesNumber;
+    std::size_t historySize;
+    double packagePowerSum, dramPowerSum;
+    double maxPower;
+    std::deque<std::pair<double, double>> powerHistory;
+    class PerformanceCounter;
+    std::unique_ptr<PerformanceCounter> performanceCounter;
+};
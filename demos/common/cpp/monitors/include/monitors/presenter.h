@@ -5,17 +5,30 @@
 #pragma once
 
 #include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <ostream>
 #include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <opencv2/imgproc.hpp>
 
 #include "cpu_monitor.h"
+#include "gpu_monitor.h"
 #include "memory_monitor.h"
+#include "power_monitor.h"
 
-enum class MonitorType{CpuAverage, DistributionCpu, Memory};
+enum class MonitorType{CpuAverage, DistributionCpu, Memory, Power, Gpu};
 
+/// Draws graphs of the monitors over frames. The monitors are sampled every second by a thread of the presenter, so
+/// drawGraphs() only takes the last snapshot of their data and never waits for the system to be queried. Graphs of a
+/// snapshot are rasterized once and then blended over every frame.
 class Presenter {
 public:
     explicit Presenter(std::set<MonitorType> enabledMonitors = {},
@@ -26,19 +39,66 @@ public:
         int yPos = 20,
         cv::Size graphSize = {150, 60},
         std::size_t historySize = 20);
+    ~Presenter();
+    Presenter(const Presenter&) = delete;
+    Presenter& operator=(const Presenter&) = delete;
     void addRemoveMonitor(MonitorType monitor);
-    void handleKey(int key); // handles C, D, M, H keys
+    void handleKey(int key); // handles C, D, M, P, G, H keys
     void drawGraphs(const cv::Mat& frame);
     std::vector<std::string> reportMeans() const;
+    /// @returns mean load of all cores in range [0, 1] collected last, NaN if CPU monitors are hidden
+    double getLastCpuLoad() const;
+    /// @returns memory and swap usage in GiB collected last, NaNs if the memory monitor is hidden
+    std::pair<double, double> getLastMemSwapUsage() const;
+    /// @returns package and DRAM power in W collected last, NaN if the power monitor is hidden or unavailable
+    double getLastPower() const;
+    /// @returns mean package and DRAM power in W since the power monitor is shown, NaN if there are no samples. Divide
+    /// the FPS of the run by it to get its throughput per watt.
+    double getMeanPower() const;
+    /// @returns GPU utilization in range [0, 1] and frequency in MHz collected last, NaNs if the GPU monitor is hidden
+    /// or unavailable
+    std::pair<double, double> getLastGpuUsage() const;
 
     const int yPos;
     const cv::Size graphSize;
     const int graphPadding;
 private:
-    std::chrono::steady_clock::time_point prevTimeStamp;
+    struct Snapshot {
+        std::deque<std::vector<double>> cpuLoadHistory;
+        std::deque<std::pair<double, double>> memSwapUsageHistory;
+        double memTotal, maxMemTotal, maxMem, maxSwap;
+        std::deque<std::pair<double, double>> powerHistory;
+        std::deque<std::pair<double, double>> gpuUsageHistory;
+        double maxPower, maxGpuFrequency;
+        bool powerAvailable, gpuAvailable;
+    };
+
+    struct GraphOverlay {
+        cv::Rect rect; // position on the frame
+        cv::Mat image;
+        cv::Mat mask; // 255 for the drawn pixels, 0 for the pixels where the frame is dimmed only
+    };
+
+    // rasterizes graphs of the snapshot for frames of frameSize
+    void renderOverlay(const Snapshot& data, const cv::Size& frameSize);
+    void addGraphOverlay(const cv::Rect& graphRect, const cv::Mat& graph);
+    void samplingThreadFunc();
+    // copies data of the monitors for drawGraphs(), should be called with mtx locked
+    void publishSnapshot();
+
     std::size_t historySize;
     CpuMonitor cpuMonitor;
     bool distributionCpuEnabled;
     MemoryMonitor memoryMonitor;
+    PowerMonitor powerMonitor;
+    GpuMonitor gpuMonitor;
     std::ostringstream strStream;
+    std::vector<GraphOverlay> overlay;
+    std::shared_ptr<const Snapshot> overlaySnapshot;
+    cv::Size overlayFrameSize;
+    mutable std::mutex mtx; // guards the monitors, which are sampled by samplingThread
+    std::shared_ptr<const Snapshot> snapshot; // accessed with std::atomic_load() and std::atomic_store() only
+    std::condition_variable samplingCondVar;
+    bool stopSampling;
+    std::thread samplingThread;
 };
@@ -69,56 +69,95 @@ public:
         return cpuLoad;
     }
 
+    // not implemented
+    std::vector<ThreadLoad> getThreadsLoad() {return {};}
+
 private:
     QueryWrapper query;
     std::vector<PDH_HCOUNTER> coreTimeCounters;
 };
 
 #elif __linux__
+#include <cctype>
 #include <chrono>
-#include <regex>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <tuple>
 #include <utility>
-#include <fstream>
+#include <dirent.h>
 #include <unistd.h>
 
+#include "proc_file.h"
+
 namespace {
 const long clockTicks = sysconf(_SC_CLK_TCK);
 
 const std::size_t nCores = sysconf(_SC_NPROCESSORS_CONF);
 
-std::vector<unsigned long> getIdleCpuStat() {
+typedef std::chrono::duration<double, std::chrono::seconds::period> Sec;
+
+std::vector<unsigned long> getIdleCpuStat(ProcFile& procStat) {
+    if (!procStat.read()) {
+        throw std::runtime_error("Can't read /proc/stat");
+    }
     std::vector<unsigned long> idleCpuStat(nCores);
-    std::ifstream procStat("/proc/stat");
-    std::string line;
-    std::smatch match;
-    std::regex coreJiffies("^cpu(\\d+)\\s+"
-        "(\\d+)\\s+"
-        "(\\d+)\\s+"
-        "(\\d+)\\s+"
-        "(\\d+)\\s+" // idle
-        "(\\d+)"); // iowait
-
-    while (std::getline(procStat, line)) {
-        if (std::regex_search(line, match, coreJiffies)) {
-            // it doesn't handle overflow of sum and overflows of /proc/stat values
-            unsigned long idleInfo = stoul(match[5]) + stoul(match[6]),
-                coreId = stoul(match[1]);
+    // lines of cores go first, so the rest of the file (interrupts, etc.) isn't parsed
+    const char* line = procStat.begin();
+    while (line < procStat.end() && 0 == std::strncmp(line, "cpu", 3)) {
+        if (std::isdigit(static_cast<unsigned char>(line[3]))) {
+            char* pos;
+            unsigned long coreId = std::strtoul(line + 3, &pos, 10);
             if (nCores <= coreId) {
                 throw std::runtime_error("The number of cores has changed");
             }
-            idleCpuStat[coreId] = idleInfo;
+            unsigned long jiffies[5];  // user, nice, system, idle, iowait
+            for (unsigned long& value : jiffies) {
+                value = std::strtoul(pos, &pos, 10);
+            }
+            // it doesn't handle overflow of sum and overflows of /proc/stat values
+            idleCpuStat[coreId] = jiffies[3] + jiffies[4];
         }
+        line = std::find(line, procStat.end(), '\n') + 1;
     }
     return idleCpuStat;
 }
+
+/// Parses name of the thread and its user and system time in clock ticks from /proc/self/task/<tid>/stat
+bool parseThreadStat(const ProcFile& stat, std::string& name, unsigned long& ticks) {
+    const char* nameBegin = std::find(stat.begin(), stat.end(), '(');
+    // the name may contain parentheses itself, so it ends at the last one
+    const char* nameEnd = stat.end();
+    while (nameEnd > nameBegin && *(nameEnd - 1) != ')') {
+        --nameEnd;
+    }
+    if (nameBegin == stat.end() || nameEnd <= nameBegin + 1) {
+        return false;
+    }
+    name.assign(nameBegin + 1, nameEnd - 1);
+    // utime and stime are the 14th and 15th fields, the state (3rd field) follows the name
+    char* pos = const_cast<char*>(nameEnd);
+    for (int field = 3; field < 14; ++field) {
+        pos += std::strspn(pos, " ");
+        pos += std::strcspn(pos, " ");
+    }
+    unsigned long utime = std::strtoul(pos, &pos, 10);
+    unsigned long stime = std::strtoul(pos, &pos, 10);
+    ticks = utime + stime;
+    return true;
+}
 }
 
 class CpuMonitor::PerformanceCounter {
 public:
-    PerformanceCounter() : prevIdleCpuStat{getIdleCpuStat()}, prevTimePoint{std::chrono::steady_clock::now()} {}
+    PerformanceCounter() : procStat{"/proc/stat"}, prevTimePoint{std::chrono::steady_clock::now()} {
+        prevIdleCpuStat = getIdleCpuStat(procStat);
+    }
 
     std::vector<double> getCpuLoad() {
-        std::vector<unsigned long> idleCpuStat = getIdleCpuStat();
+        std::vector<unsigned long> idleCpuStat = getIdleCpuStat(procStat);
         auto timePoint = std::chrono::steady_clock::now();
         // don't update data too frequently which may result in negative values for cpuLoad.
         // It may happen when collectData() is called just after setHistorySize().
@@ -126,7 +165,6 @@ public:
             std::vector<double> cpuLoad(nCores);
             for (std::size_t i = 0; i < idleCpuStat.size(); ++i) {
                 double idleDiff = idleCpuStat[i] - prevIdleCpuStat[i];
-                typedef std::chrono::duration<double, std::chrono::seconds::period> Sec;
                 cpuLoad[i] = 1.0
                     - idleDiff / clockTicks / std::chrono::duration_cast<Sec>(timePoint - prevTimePoint).count();
             }
@@ -136,9 +174,76 @@ public:
         }
         return {};
     }
+
+    std::vector<ThreadLoad> getThreadsLoad() {
+        std::vector<ThreadLoad> threadsLoad;
+        DIR* taskDir = opendir("/proc/self/task");
+        if (!taskDir) {
+            return threadsLoad;
+        }
+        auto timePoint = std::chrono::steady_clock::now();
+        for (auto& thread : threads) {
+            thread.second.alive = false;
+        }
+        while (dirent* entry = readdir(taskDir)) {
+            char* idEnd;
+            long id = std::strtol(entry->d_name, &idEnd, 10);
+            if (idEnd == entry->d_name || *idEnd != '\0') {
+                continue;  // "." and ".."
+            }
+            auto it = threads.find(id);
+            if (threads.end() == it) {
+                it = threads.emplace(std::piecewise_construct,
+                    std::forward_as_tuple(id),
+                    std::forward_as_tuple("/proc/self/task/" + std::string{entry->d_name} + "/stat")).first;
+            }
+            ThreadStat& thread = it->second;
+            std::string name;
+            unsigned long ticks;
+            if (!thread.stat.isOpen() || !thread.stat.read() || !parseThreadStat(thread.stat, name, ticks)) {
+                continue;
+            }
+            thread.alive = true;
+            if (!thread.sampled) {
+                // the first sample only sets the starting point
+                thread.sampled = true;
+                thread.firstTicks = thread.prevTicks = ticks;
+                thread.firstTimePoint = thread.prevTimePoint = timePoint;
+                continue;
+            }
+            double interval = std::chrono::duration_cast<Sec>(timePoint - thread.prevTimePoint).count();
+            double lifetime = std::chrono::duration_cast<Sec>(timePoint - thread.firstTimePoint).count();
+            if (interval > 0) {
+                threadsLoad.push_back({id,
+                    name,
+                    static_cast<double>(ticks - thread.prevTicks) / clockTicks / interval,
+                    static_cast<double>(ticks - thread.firstTicks) / clockTicks / lifetime});
+            }
+            thread.prevTicks = ticks;
+            thread.prevTimePoint = timePoint;
+        }
+        closedir(taskDir);
+        for (auto it = threads.begin(); it != threads.end();) {
+            it = it->second.alive ? std::next(it) : threads.erase(it);
+        }
+        return threadsLoad;
+    }
+
 private:
+    struct ThreadStat {
+        explicit ThreadStat(const std::string& path) : stat{path} {}
+
+        ProcFile stat;
+        bool alive = true;
+        bool sampled = false;
+        unsigned long firstTicks = 0, prevTicks = 0;
+        std::chrono::steady_clock::time_point firstTimePoint, prevTimePoint;
+    };
+
+    ProcFile procStat;
     std::vector<unsigned long> prevIdleCpuStat;
     std::chrono::steady_clock::time_point prevTimePoint;
+    std::map<long, ThreadStat> threads;
 };
 
 #else
@@ -150,6 +255,7 @@ const std::size_t nCores{0};
 class CpuMonitor::PerformanceCounter {
 public:
     std::vector<double> getCpuLoad() {return {};};
+    std::vector<ThreadLoad> getThreadsLoad() {return {};};
 };
 #endif
 
@@ -166,6 +272,7 @@ void CpuMonitor::setHistorySize(std::size_t size) {
         performanceCounter.reset(new PerformanceCounter);
     } else if (0 != historySize && 0 == size) {
         performanceCounter.reset();
+        threadsLoad.clear();
     }
     historySize = size;
     std::ptrdiff_t newSize = static_cast<std::ptrdiff_t>(std::min(size, cpuLoadHistory.size()));
@@ -186,6 +293,7 @@ void CpuMonitor::collectData() {
             cpuLoadHistory.pop_front();
         }
     }
+    threadsLoad = performanceCounter->getThreadsLoad();
 }
 
 std::size_t CpuMonitor::getHistorySize() const {
@@ -204,3 +312,7 @@ std::vector<double> CpuMonitor::getMeanCpuLoad() const {
     }
     return meanCpuLoad;
 }
+
+std::vector<CpuMonitor::ThreadLoad> CpuMonitor::getThreadsLoad() const {
+    return threadsLoad;
+}
@@ -0,0 +1,196 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "monitors/gpu_monitor.h"
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <dirent.h>
+#include <limits.h>
+#include <unistd.h>
+
+#include "proc_file.h"
+
+namespace {
+const std::string DRM_PATH = "/sys/class/drm/";
+
+bool readNumber(ProcFile& file, double& value) {
+    if (!file.read()) {
+        return false;
+    }
+    char* end;
+    value = std::strtod(file.begin(), &end);
+    return end != file.begin();
+}
+
+double readNumber(const std::string& path) {
+    ProcFile file{path};
+    double value = 0.0;
+    readNumber(file, value);
+    return value;
+}
+
+std::string getDriverName(const std::string& cardPath) {
+    char target[PATH_MAX];
+    const ssize_t length = readlink((cardPath + "/device/driver").c_str(), target, sizeof(target) - 1);
+    if (length <= 0) {
+        return {};
+    }
+    target[length] = '\0';
+    const char* name = std::strrchr(target, '/');
+    return name ? name + 1 : target;
+}
+}
+
+class GpuMonitor::PerformanceCounter {
+public:
+    PerformanceCounter() : idleResidency{nullptr}, frequency{nullptr}, maxFrequency{0.0}, lastIdleTime{0.0} {
+        // cards are card<N>, their connectors card<N>-<connector>
+        DIR* dir = opendir(DRM_PATH.c_str());
+        if (!dir) {
+            return;
+        }
+        while (const dirent* entry = readdir(dir)) {
+            const std::string card = entry->d_name;
+            if (0 != card.compare(0, std::strlen("card"), "card") || std::string::npos != card.find('-')) {
+                continue;
+            }
+            const std::string cardPath = DRM_PATH + card;
+            const std::string driver = getDriverName(cardPath);
+            if ("i915" == driver) {
+                open(cardPath + "/gt/gt0/rc6_residency_ms", cardPath + "/gt_act_freq_mhz");
+                if (!isAvailable()) {  // kernels before 5.13 have a single GT
+                    open(cardPath + "/power/rc6_residency_ms", cardPath + "/gt_act_freq_mhz");
+                }
+                maxFrequency = readNumber(cardPath + "/gt_max_freq_mhz");
+            } else if ("xe" == driver) {
+                const std::string gtPath = cardPath + "/device/tile0/gt0";
+                open(gtPath + "/gtidle/idle_residency_ms", gtPath + "/freq0/act_freq");
+                maxFrequency = readNumber(gtPath + "/freq0/max_freq");
+            }
+            if (isAvailable()) {
+                break;
+            }
+        }
+        closedir(dir);
+        if (isAvailable()) {
+            readNumber(*idleResidency, lastIdleTime);
+            lastSampleTime = std::chrono::steady_clock::now();
+        }
+    }
+
+    bool isAvailable() const {
+        return idleResidency && frequency;
+    }
+
+    std::pair<double, double> getUsage() {
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        double idleTime = lastIdleTime, currentFrequency = 0.0;
+        readNumber(*idleResidency, idleTime);
+        readNumber(*frequency, currentFrequency);
+        const double elapsedTime = std::chrono::duration<double, std::milli>(now - lastSampleTime).count();
+        const double utilization = elapsedTime > 0 ? 1 - (idleTime - lastIdleTime) / elapsedTime : 0.0;
+        lastIdleTime = idleTime;
+        lastSampleTime = now;
+        return {std::min(1.0, std::max(0.0, utilization)), currentFrequency};
+    }
+
+    double getMaxFrequency() const {
+        return maxFrequency;
+    }
+
+private:
+    void open(const std::string& idleResidencyPath, const std::string& frequencyPath) {
+        idleResidency.reset(new ProcFile{idleResidencyPath});
+        frequency.reset(new ProcFile{frequencyPath});
+        if (!idleResidency->isOpen() || !frequency->isOpen()) {
+            idleResidency.reset();
+            frequency.reset();
+        }
+    }
+
+    std::unique_ptr<ProcFile> idleResidency;  // in ms
+    std::unique_ptr<ProcFile> frequency;  // in MHz
+    double maxFrequency;
+    double lastIdleTime;
+    std::chrono::steady_clock::time_point lastSampleTime;
+};
+
+#else
+// not implemented
+class GpuMonitor::PerformanceCounter {
+public:
+    bool isAvailable() const {return false;}
+    std::pair<double, double> getUsage() {return {0.0, 0.0};}
+    double getMaxFrequency() const {return 0.0;}
+};
+#endif
+
+GpuMonitor::GpuMonitor() :
+    samplesNumber{0},
+    historySize{0},
+    utilizationSum{0.0},
+    frequencySum{0.0},
+    maxFrequency{0.0} {}
+
+// PerformanceCounter is incomplete in header and destructor can't be defined implicitly
+GpuMonitor::~GpuMonitor() = default;
+
+void GpuMonitor::setHistorySize(std::size_t size) {
+    if (0 == historySize && 0 != size) {
+        performanceCounter.reset(new GpuMonitor::PerformanceCounter);
+        maxFrequency = performanceCounter->getMaxFrequency();
+    } else if (0 != historySize && 0 == size) {
+        performanceCounter.reset();
+    }
+    historySize = size;
+    std::size_t newSize = std::min(size, usageHistory.size());
+    usageHistory.erase(usageHistory.begin(), usageHistory.end() - newSize);
+}
+
+std::size_t GpuMonitor::getHistorySize() const {
+    return historySize;
+}
+
+bool GpuMonitor::isAvailable() const {
+    return performanceCounter && performanceCounter->isAvailable();
+}
+
+void GpuMonitor::collectData() {
+    if (!isAvailable()) {
+        return;
+    }
+    std::pair<double, double> usage = performanceCounter->getUsage();
+    utilizationSum += usage.first;
+    frequencySum += usage.second;
+    ++samplesNumber;
+    maxFrequency = std::max(maxFrequency, usage.second);
+
+    usageHistory.push_back(usage);
+    if (usageHistory.size() > historySize) {
+        usageHistory.pop_front();
+    }
+}
+
+std::deque<std::pair<double, double>> GpuMonitor::getLastHistory() const {
+    return usageHistory;
+}
+
+double GpuMonitor::getMeanUtilization() const {
+    return samplesNumber ? utilizationSum / samplesNumber : 0;
+}
+
+double GpuMonitor::getMeanFrequency() const {
+    return samplesNumber ? frequencySum / samplesNumber : 0;
+}
+
+double GpuMonitor::getMaxFrequency() const {
+    return maxFrequency;
+}
@@ -71,35 +71,50 @@ public:
                 * performanceInformation.PageSize) / (1024 * 1024 * 1024),
             pagingFilesSize * displayValue.doubleValue};
     }
+    double getRss() {
+        PROCESS_MEMORY_COUNTERS memoryCounters;
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &memoryCounters, sizeof(memoryCounters))) {
+            throw std::runtime_error("GetProcessMemoryInfo() failed");
+        }
+        return static_cast<double>(memoryCounters.WorkingSetSize) / (1024 * 1024 * 1024);
+    }
 private:
     QueryWrapper query;
     PDH_HCOUNTER pagingFileUsageCounter;
 };
 
 #elif __linux__
-#include <fstream>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
 #include <utility>
-#include <vector>
-#include <regex>
+#include <unistd.h>
+
+#include "proc_file.h"
 
 namespace {
-std::pair<std::pair<double, double>, std::pair<double, double>> getAvailableMemSwapTotalMemSwap() {
+std::pair<std::pair<double, double>, std::pair<double, double>> getAvailableMemSwapTotalMemSwap(ProcFile& meminfo) {
+    if (!meminfo.read()) {
+        throw std::runtime_error("Can't read /proc/meminfo");
+    }
     double memAvailable = 0, swapFree = 0, memTotal = 0, swapTotal = 0;
-    std::regex memRegex("^(.+):\\s+(\\d+) kB$");
-    std::string line;
-    std::smatch match;
-    std::ifstream meminfo("/proc/meminfo");
-    while (std::getline(meminfo, line)) {
-        if (std::regex_match(line, match, memRegex)) {
-            if ("MemAvailable" == match[1]) {
-                memAvailable = stod(match[2]) / (1024 * 1024);
-            } else if ("SwapFree" == match[1]) {
-                swapFree = stod(match[2]) / (1024 * 1024);
-            } else if ("MemTotal" == match[1]) {
-                memTotal = stod(match[2]) / (1024 * 1024);
-            } else if ("SwapTotal" == match[1]) {
-                swapTotal = stod(match[2]) / (1024 * 1024);
-            }
+    // lines have format "<name>:   <value> kB"
+    for (const char* line = meminfo.begin(); line < meminfo.end(); line += std::strcspn(line, "\n") + 1) {
+        const char* colon = line + std::strcspn(line, ":\n");
+        if (':' != *colon) {
+            continue;
+        }
+        const std::size_t nameLength = colon - line;
+        const double value = std::strtod(colon + 1, nullptr) / (1024 * 1024);
+        if (0 == std::strncmp(line, "MemAvailable", nameLength) && std::strlen("MemAvailable") == nameLength) {
+            memAvailable = value;
+        } else if (0 == std::strncmp(line, "SwapFree", nameLength) && std::strlen("SwapFree") == nameLength) {
+            swapFree = value;
+        } else if (0 == std::strncmp(line, "MemTotal", nameLength) && std::strlen("MemTotal") == nameLength) {
+            memTotal = value;
+        } else if (0 == std::strncmp(line, "SwapTotal", nameLength) && std::strlen("SwapTotal") == nameLength) {
+            swapTotal = value;
         }
     }
     if (0 == memTotal) {
@@ -109,19 +124,36 @@ std::pair<std::pair<double, double>, std::pair<double, double>> getAvailableMemS
 }
 
 double getMemTotal() {
-    return getAvailableMemSwapTotalMemSwap().second.first;
+    ProcFile meminfo{"/proc/meminfo"};
+    return getAvailableMemSwapTotalMemSwap(meminfo).second.first;
 }
 }
 
 class MemoryMonitor::PerformanceCounter {
 public:
+    PerformanceCounter() : meminfo{"/proc/meminfo"}, statm{"/proc/self/statm"} {}
+
     MemState getMemState() {
         std::pair<std::pair<double, double>, std::pair<double, double>> availableMemSwapTotalMemSwap
-            = getAvailableMemSwapTotalMemSwap();
+            = getAvailableMemSwapTotalMemSwap(meminfo);
         double memTotal = availableMemSwapTotalMemSwap.second.first;
         double swapTotal = availableMemSwapTotalMemSwap.second.second;
         return {memTotal, memTotal - availableMemSwapTotalMemSwap.first.first, swapTotal - availableMemSwapTotalMemSwap.first.second};
     }
+
+    double getRss() {
+        if (!statm.read()) {
+            return 0.0;
+        }
+        // the second field is the number of resident pages
+        char* pos;
+        std::strtoul(statm.begin(), &pos, 10);
+        return static_cast<double>(std::strtoul(pos, nullptr, 10)) * sysconf(_SC_PAGESIZE) / (1024 * 1024 * 1024);
+    }
+
+private:
+    ProcFile meminfo;
+    ProcFile statm;
 };
 
 #else
@@ -133,6 +165,7 @@ double getMemTotal() {return 0.0;}
 class MemoryMonitor::PerformanceCounter {
 public:
     MemState getMemState() {return {0.0, 0.0, 0.0};}
+    double getRss() {return 0.0;}
 };
 #endif
 
@@ -144,7 +177,9 @@ MemoryMonitor::MemoryMonitor() :
     maxMem{0.0},
     maxSwap{0.0},
     memTotal{0.0},
-    maxMemTotal{0.0} {}
+    maxMemTotal{0.0},
+    lastRss{0.0},
+    maxRss{0.0} {}
 
 // PerformanceCounter is incomplete in header and destructor can't be defined implicitly
 MemoryMonitor::~MemoryMonitor() = default;
@@ -152,10 +187,7 @@ MemoryMonitor::~MemoryMonitor() = default;
 void MemoryMonitor::setHistorySize(std::size_t size) {
     if (0 == historySize && 0 != size) {
         performanceCounter.reset(new MemoryMonitor::PerformanceCounter);
-        // memTotal is not initialized in constructor because for linux its initialization involves constructing
-        // std::regex which is unimplemented and throws an exception for gcc 4.8.5 (default for CentOS 7.4).
-        // Delaying initialization triggers the error only when the monitor is used
-        // https://gcc.gnu.org/bugzilla/show_bug.cgi?id=53631
+        // memTotal is not initialized in constructor, so system memory isn't queried if the monitor is never used
         memTotal = ::getMemTotal();
     } else if (0 != historySize && 0 == size) {
         performanceCounter.reset();
@@ -173,6 +205,8 @@ void MemoryMonitor::collectData() {
     ++samplesNumber;
     maxMem = std::max(maxMem, memState.usedMem);
     maxSwap = std::max(maxSwap, memState.usedSwap);
+    lastRss = performanceCounter->getRss();
+    maxRss = std::max(maxRss, lastRss);
 
     memSwapUsageHistory.emplace_back(memState.usedMem, memState.usedSwap);
     if (memSwapUsageHistory.size() > historySize) {
@@ -211,3 +245,11 @@ double MemoryMonitor::getMemTotal() const {
 double MemoryMonitor::getMaxMemTotal() const {
     return maxMemTotal;
 }
+
+double MemoryMonitor::getLastRss() const {
+    return lastRss;
+}
+
+double MemoryMonitor::getMaxRss() const {
+    return maxRss;
+}
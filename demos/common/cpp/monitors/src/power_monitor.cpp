@@ -0,0 +1,186 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "monitors/power_monitor.h"
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+
+#include "proc_file.h"
+
+namespace {
+const std::string POWERCAP_PATH = "/sys/class/powercap/";
+
+bool readNumber(ProcFile& file, double& value) {
+    if (!file.read()) {
+        return false;
+    }
+    char* end;
+    value = std::strtod(file.begin(), &end);
+    return end != file.begin();
+}
+
+std::string readName(const std::string& path) {
+    ProcFile file{path};
+    if (!file.read()) {
+        return {};
+    }
+    return std::string(file.begin(), std::strcspn(file.begin(), "\n"));
+}
+}
+
+class PowerMonitor::PerformanceCounter {
+public:
+    PerformanceCounter() : hasLastSample{false} {
+        // package domains are intel-rapl:<package>, their subdomains intel-rapl:<package>:<subdomain>; psys and the
+        // core and uncore subdomains are parts of or include the packages, so they aren't summed up
+        DIR* dir = opendir(POWERCAP_PATH.c_str());
+        if (!dir) {
+            return;
+        }
+        while (const dirent* entry = readdir(dir)) {
+            const std::string domain = entry->d_name;
+            if (0 != domain.compare(0, std::strlen("intel-rapl:"), "intel-rapl:")) {
+                continue;
+            }
+            const std::string name = readName(POWERCAP_PATH + domain + "/name");
+            const bool isPackage = 0 == name.compare(0, std::strlen("package"), "package");
+            if (!isPackage && name != "dram") {
+                continue;
+            }
+            std::unique_ptr<EnergyCounter> counter{new EnergyCounter{POWERCAP_PATH + domain + "/energy_uj", !isPackage}};
+            ProcFile maxEnergy{POWERCAP_PATH + domain + "/max_energy_range_uj"};
+            if (readNumber(counter->energy, counter->lastEnergy) && readNumber(maxEnergy, counter->maxEnergy)) {
+                counters.push_back(std::move(counter));
+            }
+        }
+        closedir(dir);
+    }
+
+    bool isAvailable() const {
+        return !counters.empty();
+    }
+
+    /// @returns false if there is no previous sample to compute power since
+    bool getPower(std::pair<double, double>& power) {
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        double packageEnergy = 0, dramEnergy = 0;  // in uJ
+        for (const std::unique_ptr<EnergyCounter>& counter : counters) {
+            double energy;
+            if (!readNumber(counter->energy, energy)) {
+                continue;
+            }
+            double delta = energy - counter->lastEnergy;
+            if (delta < 0) {  // the counter has wrapped around
+                delta += counter->maxEnergy;
+            }
+            counter->lastEnergy = energy;
+            (counter->isDram ? dramEnergy : packageEnergy) += delta;
+        }
+        const double seconds = std::chrono::duration<double>(now - lastSampleTime).count();
+        const bool isValid = hasLastSample && seconds > 0;
+        lastSampleTime = now;
+        hasLastSample = true;
+        if (isValid) {
+            power = {packageEnergy / 1e6 / seconds, dramEnergy / 1e6 / seconds};
+        }
+        return isValid;
+    }
+
+private:
+    struct EnergyCounter {
+        EnergyCounter(const std::string& path, bool isDram) :
+            energy{path}, maxEnergy{0.0}, lastEnergy{0.0}, isDram{isDram} {}
+
+        ProcFile energy;
+        double maxEnergy, lastEnergy;  // in uJ
+        bool isDram;
+    };
+
+    std::vector<std::unique_ptr<EnergyCounter>> counters;
+    std::chrono::steady_clock::time_point lastSampleTime;
+    bool hasLastSample;
+};
+
+#else
+// not implemented
+class PowerMonitor::PerformanceCounter {
+public:
+    bool isAvailable() const {return false;}
+    bool getPower(std::pair<double, double>&) {return false;}
+};
+#endif
+
+PowerMonitor::PowerMonitor() :
+    samplesNumber{0},
+    historySize{0},
+    packagePowerSum{0.0},
+    dramPowerSum{0.0},
+    maxPower{0.0} {}
+
+// PerformanceCounter is incomplete in header and destructor can't be defined implicitly
+PowerMonitor::~PowerMonitor() = default;
+
+void PowerMonitor::setHistorySize(std::size_t size) {
+    if (0 == historySize && 0 != size) {
+        performanceCounter.reset(new PowerMonitor::PerformanceCounter);
+    } else if (0 != historySize && 0 == size) {
+        performanceCounter.reset();
+    }
+    historySize = size;
+    std::size_t newSize = std::min(size, powerHistory.size());
+    powerHistory.erase(powerHistory.begin(), powerHistory.end() - newSize);
+}
+
+std::size_t PowerMonitor::getHistorySize() const {
+    return historySize;
+}
+
+bool PowerMonitor::isAvailable() const {
+    return performanceCounter && performanceCounter->isAvailable();
+}
+
+void PowerMonitor::collectData() {
+    std::pair<double, double> power;
+    if (!isAvailable() || !performanceCounter->getPower(power)) {
+        return;
+    }
+    packagePowerSum += power.first;
+    dramPowerSum += power.second;
+    ++samplesNumber;
+    maxPower = std::max(maxPower, power.first + power.second);
+
+    powerHistory.push_back(power);
+    if (powerHistory.size() > historySize) {
+        powerHistory.pop_front();
+    }
+}
+
+std::deque<std::pair<double, double>> PowerMonitor::getLastHistory() const {
+    return powerHistory;
+}
+
+double PowerMonitor::getMeanPackagePower() const {
+    return samplesNumber ? packagePowerSum / samplesNumber : 0;
+}
+
+double PowerMonitor::getMeanDramPower() const {
+    return samplesNumber ? dramPowerSum / samplesNumber : 0;
+}
+
+double PowerMonitor::getMeanPower() const {
+    return getMeanPackagePower() + getMeanDramPower();
+}
+
+double PowerMonitor::getMaxPower() const {
+    return maxPower;
+}
@@ -2,9 +2,11 @@
 // SPDX-License-Identifier: Apache-2.0
 //
 
+#include <algorithm>
 #include <cctype>
 #include <chrono>
 #include <iomanip>
+#include <limits>
 #include <numeric>
 #include <string>
 #include <vector>
@@ -12,10 +14,15 @@
 #include "monitors/presenter.h"
 
 namespace {
+// background of rasterized graphs, the color isn't used by the graphs themselves
+const cv::Scalar KEY_COLOR{127, 127, 127};
+
 const std::map<int, MonitorType> keyToMonitorType{
     {'C', MonitorType::CpuAverage},
     {'D', MonitorType::DistributionCpu},
-    {'M', MonitorType::Memory}};
+    {'M', MonitorType::Memory},
+    {'P', MonitorType::Power},
+    {'G', MonitorType::Gpu}};
 
 std::set<MonitorType> strKeysToMonitorSet(const std::string& keys) {
     std::set<MonitorType> enabledMonitors;
@@ -35,6 +42,39 @@ std::set<MonitorType> strKeysToMonitorSet(const std::string& keys) {
     }
     return enabledMonitors;
 }
+
+void drawGraphTitle(cv::Mat& graph, const std::string& title, int textGraphSplittingLine, const cv::Scalar& color) {
+    int baseline;
+    int textWidth = cv::getTextSize(title,
+        cv::FONT_HERSHEY_SIMPLEX,
+        textGraphSplittingLine * 0.04,
+        1,
+        &baseline).width;
+    cv::putText(graph,
+        title,
+        cv::Point{(graph.cols - textWidth) / 2, textGraphSplittingLine - 1},
+        cv::FONT_HERSHEY_SIMPLEX,
+        textGraphSplittingLine * 0.04,
+        color);
+}
+
+// the last value is at the right edge of the graph, values are scaled by range to the height of the graph
+template<typename Value>
+std::vector<cv::Point> makePolyline(const std::deque<Value>& history,
+        double range,
+        int sampleStep,
+        int graphRectHeight,
+        const cv::Size& graphSize,
+        double (*getValue)(const Value&)) {
+    std::vector<cv::Point> points(history.size());
+    int lineXPos = graphSize.width - 1;
+    for (int i = static_cast<int>(history.size()) - 1; i >= 0; --i) {
+        const double value = range > 0 ? std::min(1.0, getValue(history[i]) / range) : 0.0;
+        points[i] = {lineXPos, graphSize.height - static_cast<int>(value * graphRectHeight)};
+        lineXPos -= sampleStep;
+    }
+    return points;
+}
 }
 
 Presenter::Presenter(std::set<MonitorType> enabledMonitors,
@@ -46,16 +86,68 @@ Presenter::Presenter(std::set<MonitorType> enabledMonitors,
             graphPadding{std::max(1, static_cast<int>(graphSize.width * 0.05))},
             historySize{historySize},
             distributionCpuEnabled{false},
-            strStream{std::ios_base::app} {
+            strStream{std::ios_base::app},
+            stopSampling{false} {
     for (MonitorType monitor : enabledMonitors) {
         addRemoveMonitor(monitor);
     }
+    {
+        const std::lock_guard<std::mutex> lock(mtx);
+        publishSnapshot();
+    }
+    samplingThread = std::thread(&Presenter::samplingThreadFunc, this);
 }
 
 Presenter::Presenter(const std::string& keys, int yPos, cv::Size graphSize, std::size_t historySize) :
     Presenter{strKeysToMonitorSet(keys), yPos, graphSize, historySize} {}
 
+Presenter::~Presenter() {
+    {
+        const std::lock_guard<std::mutex> lock(mtx);
+        stopSampling = true;
+    }
+    samplingCondVar.notify_one();
+    samplingThread.join();
+}
+
+void Presenter::samplingThreadFunc() {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (!samplingCondVar.wait_for(lock, std::chrono::milliseconds{1000}, [this] { return stopSampling; })) {
+        if (0 != cpuMonitor.getHistorySize()) {
+            cpuMonitor.collectData();
+        }
+        if (memoryMonitor.getHistorySize() > 1) {
+            memoryMonitor.collectData();
+        }
+        if (powerMonitor.getHistorySize() > 1) {
+            powerMonitor.collectData();
+        }
+        if (gpuMonitor.getHistorySize() > 1) {
+            gpuMonitor.collectData();
+        }
+        publishSnapshot();
+    }
+}
+
+void Presenter::publishSnapshot() {
+    std::shared_ptr<Snapshot> data = std::make_shared<Snapshot>();
+    data->cpuLoadHistory = cpuMonitor.getLastHistory();
+    data->memSwapUsageHistory = memoryMonitor.getLastHistory();
+    data->memTotal = memoryMonitor.getMemTotal();
+    data->maxMemTotal = memoryMonitor.getMaxMemTotal();
+    data->maxMem = memoryMonitor.getMaxMem();
+    data->maxSwap = memoryMonitor.getMaxSwap();
+    data->powerHistory = powerMonitor.getLastHistory();
+    data->gpuUsageHistory = gpuMonitor.getLastHistory();
+    data->maxPower = powerMonitor.getMaxPower();
+    data->maxGpuFrequency = gpuMonitor.getMaxFrequency();
+    data->powerAvailable = powerMonitor.isAvailable();
+    data->gpuAvailable = gpuMonitor.isAvailable();
+    std::atomic_store(&snapshot, std::shared_ptr<const Snapshot>{std::move(data)});
+}
+
 void Presenter::addRemoveMonitor(MonitorType monitor) {
+    const std::lock_guard<std::mutex> lock(mtx);
     unsigned updatedHistorySize = 1;
     if (historySize > 1) {
         int sampleStep = std::max(1, static_cast<int>(graphSize.width / (historySize - 1)));
@@ -94,20 +186,36 @@ void Presenter::addRemoveMonitor(MonitorType monitor) {
             }
             break;
         }
+        case MonitorType::Power: {
+            powerMonitor.setHistorySize(powerMonitor.getHistorySize() > 1 ? 0 : updatedHistorySize);
+            break;
+        }
+        case MonitorType::Gpu: {
+            gpuMonitor.setHistorySize(gpuMonitor.getHistorySize() > 1 ? 0 : updatedHistorySize);
+            break;
+        }
     }
+    publishSnapshot();
 }
 
 void Presenter::handleKey(int key) {
     key = std::toupper(key);
     if ('H' == key) {
-        if (0 == cpuMonitor.getHistorySize() && memoryMonitor.getHistorySize() <= 1) {
+        if (0 == cpuMonitor.getHistorySize() && memoryMonitor.getHistorySize() <= 1
+                && powerMonitor.getHistorySize() <= 1 && gpuMonitor.getHistorySize() <= 1) {
             addRemoveMonitor(MonitorType::CpuAverage);
             addRemoveMonitor(MonitorType::DistributionCpu);
             addRemoveMonitor(MonitorType::Memory);
+            addRemoveMonitor(MonitorType::Power);
+            addRemoveMonitor(MonitorType::Gpu);
         } else {
+            const std::lock_guard<std::mutex> lock(mtx);
             cpuMonitor.setHistorySize(0);
             distributionCpuEnabled = false;
             memoryMonitor.setHistorySize(0);
+            powerMonitor.setHistorySize(0);
+            gpuMonitor.setHistorySize(0);
+            publishSnapshot();
         }
     } else {
         auto iter = keyToMonitorType.find(key);
@@ -117,27 +225,18 @@ void Presenter::handleKey(int key) {
     }
 }
 
-void Presenter::drawGraphs(const cv::Mat& frame) {
-    const std::chrono::steady_clock::time_point curTimeStamp = std::chrono::steady_clock::now();
-    if (curTimeStamp - prevTimeStamp >= std::chrono::milliseconds{1000}) {
-        prevTimeStamp = curTimeStamp;
-        if (0 != cpuMonitor.getHistorySize()) {
-            cpuMonitor.collectData();
-        }
-        if (memoryMonitor.getHistorySize() > 1) {
-            memoryMonitor.collectData();
-        }
-    }
-
+void Presenter::renderOverlay(const Snapshot& data, const cv::Size& frameSize) {
+    overlay.clear();
     int numberOfEnabledMonitors = (cpuMonitor.getHistorySize() > 1) + distributionCpuEnabled
-        + (memoryMonitor.getHistorySize() > 1);
+        + (memoryMonitor.getHistorySize() > 1) + (powerMonitor.getHistorySize() > 1)
+        + (gpuMonitor.getHistorySize() > 1);
     int panelWidth = graphSize.width * numberOfEnabledMonitors
         + std::max(0, numberOfEnabledMonitors - 1) * graphPadding;
-    while (panelWidth > frame.cols) {
+    while (panelWidth > frameSize.width) {
         panelWidth = std::max(0, panelWidth - graphSize.width - graphPadding);
         --numberOfEnabledMonitors; // can't draw all monitors
     }
-    int graphPos = std::max(0, (frame.cols - 1 - panelWidth) / 2);
+    int graphPos = std::max(0, (frameSize.width - 1 - panelWidth) / 2);
     int textGraphSplittingLine = graphSize.height / 5;
     int graphRectHeight = graphSize.height - textGraphSplittingLine;
     int sampleStep = 1;
@@ -148,13 +247,12 @@ void Presenter::drawGraphs(const cv::Mat& frame) {
     }
 
     if (cpuMonitor.getHistorySize() > 1 && possibleHistorySize > 1 && --numberOfEnabledMonitors >= 0) {
-        std::deque<std::vector<double>> lastHistory = cpuMonitor.getLastHistory();
-        cv::Rect intersection = cv::Rect{cv::Point(graphPos, yPos), graphSize} & cv::Rect{0, 0, frame.cols, frame.rows};
-        if (!intersection.area()) {
+        const std::deque<std::vector<double>>& lastHistory = data.cpuLoadHistory;
+        const cv::Rect graphRect{cv::Point(graphPos, yPos), graphSize};
+        if (!(graphRect & cv::Rect{cv::Point{}, frameSize}).area()) {
             return;
         }
-        cv::Mat graph = frame(intersection);
-        graph = graph / 2 + cv::Scalar{127, 127, 127};
+        cv::Mat graph(graphSize, CV_8UC3, KEY_COLOR);
 
         int lineXPos = graph.cols - 1;
         std::vector<cv::Point> averageLoad(lastHistory.size());
@@ -166,8 +264,8 @@ void Presenter::drawGraphs(const cv::Mat& frame) {
         }
 
         cv::polylines(graph, averageLoad, false, {255, 0, 0}, 2);
-        cv::rectangle(frame, cv::Rect{
-                cv::Point{graphPos, yPos + textGraphSplittingLine},
+        cv::rectangle(graph, cv::Rect{
+                cv::Point{0, textGraphSplittingLine},
                 cv::Size{graphSize.width, graphSize.height - textGraphSplittingLine}
             }, {0, 0, 0});
         strStream.str("CPU");
@@ -189,17 +287,17 @@ void Presenter::drawGraphs(const cv::Mat& frame) {
             textGraphSplittingLine * 0.04,
             {70, 0, 0},
             1);
+        addGraphOverlay(graphRect, graph);
         graphPos += graphSize.width + graphPadding;
     }
 
     if (distributionCpuEnabled && --numberOfEnabledMonitors >= 0) {
-        std::deque<std::vector<double>> lastHistory = cpuMonitor.getLastHistory();
-        cv::Rect intersection = cv::Rect{cv::Point(graphPos, yPos), graphSize} & cv::Rect{0, 0, frame.cols, frame.rows};
-        if (!intersection.area()) {
+        const std::deque<std::vector<double>>& lastHistory = data.cpuLoadHistory;
+        const cv::Rect graphRect{cv::Point(graphPos, yPos), graphSize};
+        if (!(graphRect & cv::Rect{cv::Point{}, frameSize}).area()) {
             return;
         }
-        cv::Mat graph = frame(intersection);
-        graph = graph / 2 + cv::Scalar{127, 127, 127};
+        cv::Mat graph(graphSize, CV_8UC3, KEY_COLOR);
 
         if (!lastHistory.empty()) {
             int rectXPos = 0;
@@ -217,9 +315,9 @@ void Presenter::drawGraphs(const cv::Mat& frame) {
             int yLine = graph.rows - static_cast<int>(graphRectHeight * sum);
             cv::line(graph, cv::Point{0, yLine}, cv::Point{graph.cols, yLine}, {0, 255, 0}, 2);
         }
-        cv::Rect border{cv::Point{graphPos, yPos + textGraphSplittingLine},
+        cv::Rect border{cv::Point{0, textGraphSplittingLine},
             cv::Size{graphSize.width, graphSize.height - textGraphSplittingLine}};
-        cv::rectangle(frame, border, {0, 0, 0});
+        cv::rectangle(graph, border, {0, 0, 0});
         strStream.str("Core load");
         if (!lastHistory.empty()) {
             strStream << ": " << std::fixed << std::setprecision(1)
@@ -238,25 +336,24 @@ void Presenter::drawGraphs(const cv::Mat& frame) {
             cv::FONT_HERSHEY_SIMPLEX,
             textGraphSplittingLine * 0.04,
             {0, 70, 0});
+        addGraphOverlay(graphRect, graph);
         graphPos += graphSize.width + graphPadding;
     }
 
     if (memoryMonitor.getHistorySize() > 1 && possibleHistorySize > 1 && --numberOfEnabledMonitors >= 0) {
-        std::deque<std::pair<double, double>> lastHistory = memoryMonitor.getLastHistory();
-        cv::Rect intersection = cv::Rect{cv::Point(graphPos, yPos), graphSize} & cv::Rect{0, 0, frame.cols, frame.rows};
-        if (!intersection.area()) {
+        const std::deque<std::pair<double, double>>& lastHistory = data.memSwapUsageHistory;
+        const cv::Rect graphRect{cv::Point(graphPos, yPos), graphSize};
+        if (!(graphRect & cv::Rect{cv::Point{}, frameSize}).area()) {
             return;
         }
-        cv::Mat graph = frame(intersection);
-        graph = graph / 2 + cv::Scalar{127, 127, 127};
+        cv::Mat graph(graphSize, CV_8UC3, KEY_COLOR);
         int histxPos = graph.cols - 1;
-        double range = std::min(memoryMonitor.getMaxMemTotal() + memoryMonitor.getMaxSwap(),
-            (memoryMonitor.getMaxMem() + memoryMonitor.getMaxSwap()) * 1.2);
+        double range = std::min(data.maxMemTotal + data.maxSwap, (data.maxMem + data.maxSwap) * 1.2);
         if (lastHistory.size() > 1) {
             for (auto memUsageIt = lastHistory.rbegin(); memUsageIt != lastHistory.rend() - 1; ++memUsageIt) {
                 constexpr double SWAP_THRESHOLD = 10.0 / 1024; // 10 MiB
                 cv::Vec3b color =
-                    (memoryMonitor.getMemTotal() * 0.95 > memUsageIt->first) || (memUsageIt->second < SWAP_THRESHOLD) ?
+                    (data.memTotal * 0.95 > memUsageIt->first) || (memUsageIt->second < SWAP_THRESHOLD) ?
                         cv::Vec3b{0, 255, 255} :
                         cv::Vec3b{0, 0, 255};
                 cv::Point right{histxPos,
@@ -269,9 +366,9 @@ void Presenter::drawGraphs(const cv::Mat& frame) {
             }
         }
 
-        cv::Rect border{cv::Point{graphPos, yPos + textGraphSplittingLine},
+        cv::Rect border{cv::Point{0, textGraphSplittingLine},
             cv::Size{graphSize.width, graphSize.height - textGraphSplittingLine}};
-        cv::rectangle(frame, {border}, {0, 0, 0});
+        cv::rectangle(graph, {border}, {0, 0, 0});
         if (lastHistory.empty()) {
             strStream.str("Memory");
         } else {
@@ -291,12 +388,114 @@ void Presenter::drawGraphs(const cv::Mat& frame) {
             cv::FONT_HERSHEY_SIMPLEX,
             textGraphSplittingLine * 0.04,
             {0, 35, 35});
+        addGraphOverlay(graphRect, graph);
+        graphPos += graphSize.width + graphPadding;
+    }
+
+    if (powerMonitor.getHistorySize() > 1 && possibleHistorySize > 1 && --numberOfEnabledMonitors >= 0) {
+        const std::deque<std::pair<double, double>>& lastHistory = data.powerHistory;
+        const cv::Rect graphRect{cv::Point(graphPos, yPos), graphSize};
+        if (!(graphRect & cv::Rect{cv::Point{}, frameSize}).area()) {
+            return;
+        }
+        cv::Mat graph(graphSize, CV_8UC3, KEY_COLOR);
+        if (lastHistory.size() > 1) {
+            cv::polylines(graph,
+                makePolyline<std::pair<double, double>>(lastHistory, data.maxPower * 1.2, sampleStep,
+                    graphRectHeight, graphSize,
+                    [](const std::pair<double, double>& power) { return power.first + power.second; }),
+                false, {0, 128, 255}, 2);
+        }
+        cv::rectangle(graph, cv::Rect{
+                cv::Point{0, textGraphSplittingLine},
+                cv::Size{graphSize.width, graphSize.height - textGraphSplittingLine}
+            }, {0, 0, 0});
+        strStream.str("Power");
+        if (!data.powerAvailable) {
+            strStream << ": n/a";
+        } else if (!lastHistory.empty()) {
+            strStream << ": " << std::fixed << std::setprecision(1)
+                << lastHistory.back().first + lastHistory.back().second << " W";
+        }
+        drawGraphTitle(graph, strStream.str(), textGraphSplittingLine, {0, 50, 100});
+        addGraphOverlay(graphRect, graph);
+        graphPos += graphSize.width + graphPadding;
+    }
+
+    if (gpuMonitor.getHistorySize() > 1 && possibleHistorySize > 1 && --numberOfEnabledMonitors >= 0) {
+        const std::deque<std::pair<double, double>>& lastHistory = data.gpuUsageHistory;
+        const cv::Rect graphRect{cv::Point(graphPos, yPos), graphSize};
+        if (!(graphRect & cv::Rect{cv::Point{}, frameSize}).area()) {
+            return;
+        }
+        cv::Mat graph(graphSize, CV_8UC3, KEY_COLOR);
+        if (lastHistory.size() > 1) {
+            // the frequency is drawn relative to the maximal one under the utilization
+            cv::polylines(graph,
+                makePolyline<std::pair<double, double>>(lastHistory, data.maxGpuFrequency, sampleStep,
+                    graphRectHeight, graphSize,
+                    [](const std::pair<double, double>& usage) { return usage.second; }),
+                false, {0, 160, 0}, 1);
+            cv::polylines(graph,
+                makePolyline<std::pair<double, double>>(lastHistory, 1.0, sampleStep, graphRectHeight, graphSize,
+                    [](const std::pair<double, double>& usage) { return usage.first; }),
+                false, {255, 0, 255}, 2);
+        }
+        cv::rectangle(graph, cv::Rect{
+                cv::Point{0, textGraphSplittingLine},
+                cv::Size{graphSize.width, graphSize.height - textGraphSplittingLine}
+            }, {0, 0, 0});
+        strStream.str("GPU");
+        if (!data.gpuAvailable) {
+            strStream << ": n/a";
+        } else if (!lastHistory.empty()) {
+            strStream << ": " << std::fixed << std::setprecision(1) << lastHistory.back().first * 100 << "% "
+                << std::setprecision(0) << lastHistory.back().second << " MHz";
+        }
+        drawGraphTitle(graph, strStream.str(), textGraphSplittingLine, {70, 0, 70});
+        addGraphOverlay(graphRect, graph);
+    }
+}
+
+void Presenter::addGraphOverlay(const cv::Rect& graphRect, const cv::Mat& graph) {
+    cv::Mat keyMask, mask;
+    cv::inRange(graph, KEY_COLOR, KEY_COLOR, keyMask);
+    cv::bitwise_not(keyMask, keyMask);
+    cv::cvtColor(keyMask, mask, cv::COLOR_GRAY2BGR);
+    overlay.push_back({graphRect, graph, mask});
+}
+
+void Presenter::drawGraphs(const cv::Mat& frame) {
+    CV_Assert(CV_8UC3 == frame.type());
+    const std::shared_ptr<const Snapshot> data = std::atomic_load(&snapshot);
+    // graphs are rasterized only when there is a new sample or the layout changes, then they are just blended
+    if (data != overlaySnapshot || frame.size() != overlayFrameSize) {
+        renderOverlay(*data, frame.size());
+        overlaySnapshot = data;
+        overlayFrameSize = frame.size();
+    }
+    for (const GraphOverlay& graph : overlay) {
+        const cv::Rect roi = graph.rect & cv::Rect{cv::Point{}, frame.size()};
+        const cv::Rect graphRoi = roi - graph.rect.tl();
+        cv::Mat frameRoi = frame(roi);
+        for (int y = 0; y < roi.height; ++y) {
+            uchar* dst = frameRoi.ptr<uchar>(y);
+            const uchar* image = graph.image.ptr<uchar>(graphRoi.y + y, graphRoi.x);
+            const uchar* mask = graph.mask.ptr<uchar>(graphRoi.y + y, graphRoi.x);
+            // the frame is dimmed under the graph and covered by the drawn pixels, select is branchless to vectorize
+            for (int x = 0; x < roi.width * 3; ++x) {
+                const uchar dimmed = static_cast<uchar>(((dst[x] + 1) >> 1) + 127);
+                dst[x] = static_cast<uchar>((dimmed & ~mask[x]) | (image[x] & mask[x]));
+            }
+        }
     }
 }
 
 std::vector<std::string> Presenter::reportMeans() const {
+    const std::lock_guard<std::mutex> lock(mtx);
     std::vector<std::string> collectedData;
-    if (cpuMonitor.getHistorySize() > 1 || distributionCpuEnabled || memoryMonitor.getHistorySize() > 1) {
+    if (cpuMonitor.getHistorySize() > 1 || distributionCpuEnabled || memoryMonitor.getHistorySize() > 1
+            || powerMonitor.getHistorySize() > 1 || gpuMonitor.getHistorySize() > 1) {
         collectedData.push_back("Resources usage:");
     }
     if (cpuMonitor.getHistorySize() > 1) {
@@ -316,6 +515,23 @@ std::vector<std::string> Presenter::reportMeans() const {
         collectedDataStream << "\tMean CPU utilization: " << mean * 100 << "%";
         collectedData.push_back(collectedDataStream.str());
     }
+    std::vector<CpuMonitor::ThreadLoad> threadsLoad = cpuMonitor.getThreadsLoad();
+    if (!threadsLoad.empty()) {
+        constexpr std::size_t REPORTED_THREADS = 5;
+        std::size_t reportedThreads = std::min(REPORTED_THREADS, threadsLoad.size());
+        std::partial_sort(threadsLoad.begin(), threadsLoad.begin() + reportedThreads, threadsLoad.end(),
+            [](const CpuMonitor::ThreadLoad& lhs, const CpuMonitor::ThreadLoad& rhs) {
+                return lhs.meanLoad > rhs.meanLoad;
+            });
+        std::ostringstream collectedDataStream;
+        collectedDataStream << std::fixed << std::setprecision(1);
+        collectedDataStream << "\tBusiest threads:";
+        for (std::size_t i = 0; i < reportedThreads; ++i) {
+            collectedDataStream << ' ' << threadsLoad[i].name << " (" << threadsLoad[i].id << "): "
+                << threadsLoad[i].meanLoad * 100 << '%';
+        }
+        collectedData.push_back(collectedDataStream.str());
+    }
     if (memoryMonitor.getHistorySize() > 1) {
         std::ostringstream collectedDataStream;
         collectedDataStream << std::fixed << std::setprecision(1);
@@ -324,7 +540,75 @@ std::vector<std::string> Presenter::reportMeans() const {
         collectedDataStream.str("");
         collectedDataStream << "\tMean swap usage: " << memoryMonitor.getMeanSwap() << " GiB";
         collectedData.push_back(collectedDataStream.str());
+        collectedDataStream.str("");
+        collectedDataStream << "\tMax process memory (RSS): " << memoryMonitor.getMaxRss() << " GiB";
+        collectedData.push_back(collectedDataStream.str());
+    }
+    if (powerMonitor.getHistorySize() > 1) {
+        std::ostringstream collectedDataStream;
+        collectedDataStream << std::fixed << std::setprecision(1);
+        if (powerMonitor.isAvailable()) {
+            collectedDataStream << "\tMean power: " << powerMonitor.getMeanPower() << " W (package "
+                << powerMonitor.getMeanPackagePower() << " W, DRAM " << powerMonitor.getMeanDramPower() << " W)";
+        } else {
+            collectedDataStream << "\tPower isn't available: RAPL energy counters can't be read";
+        }
+        collectedData.push_back(collectedDataStream.str());
+    }
+    if (gpuMonitor.getHistorySize() > 1) {
+        std::ostringstream collectedDataStream;
+        collectedDataStream << std::fixed << std::setprecision(1);
+        if (gpuMonitor.isAvailable()) {
+            collectedDataStream << "\tMean GPU utilization: " << gpuMonitor.getMeanUtilization() * 100
+                << "%, mean frequency: " << std::setprecision(0) << gpuMonitor.getMeanFrequency() << " MHz";
+        } else {
+            collectedDataStream << "\tGPU utilization isn't available: no Intel GPU is found";
+        }
+        collectedData.push_back(collectedDataStream.str());
     }
 
     return collectedData;
 }
+
+double Presenter::getLastCpuLoad() const {
+    const std::shared_ptr<const Snapshot> data = std::atomic_load(&snapshot);
+    const std::deque<std::vector<double>>& history = data->cpuLoadHistory;
+    if (history.empty() || history.back().empty()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    const std::vector<double>& lastLoad = history.back();
+    return std::accumulate(lastLoad.begin(), lastLoad.end(), 0.0) / lastLoad.size();
+}
+
+std::pair<double, double> Presenter::getLastMemSwapUsage() const {
+    const std::shared_ptr<const Snapshot> data = std::atomic_load(&snapshot);
+    const std::deque<std::pair<double, double>>& history = data->memSwapUsageHistory;
+    if (history.empty()) {
+        return {std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN()};
+    }
+    return history.back();
+}
+
+double Presenter::getLastPower() const {
+    const std::shared_ptr<const Snapshot> data = std::atomic_load(&snapshot);
+    const std::deque<std::pair<double, double>>& history = data->powerHistory;
+    if (history.empty()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return history.back().first + history.back().second;
+}
+
+double Presenter::getMeanPower() const {
+    const std::lock_guard<std::mutex> lock(mtx);
+    const double meanPower = powerMonitor.getMeanPower();
+    return meanPower > 0 ? meanPower : std::numeric_limits<double>::quiet_NaN();
+}
+
+std::pair<double, double> Presenter::getLastGpuUsage() const {
+    const std::shared_ptr<const Snapshot> data = std::atomic_load(&snapshot);
+    const std::deque<std::pair<double, double>>& history = data->gpuUsageHistory;
+    if (history.empty()) {
+        return {std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN()};
+    }
+    return history.back();
+}
@@ -0,0 +1,42 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "proc_file.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+ProcFile::ProcFile(const std::string& path) : fd{open(path.c_str(), O_RDONLY | O_CLOEXEC)}, buffer(4096), length{0} {}
+
+ProcFile::~ProcFile() {
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+bool ProcFile::read() {
+    length = 0;
+    while (fd >= 0) {
+        if (length + 1 >= buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+        }
+        // keep one byte for the terminating null
+        ssize_t count = pread(fd, buffer.data() + length, buffer.size() - length - 1, static_cast<off_t>(length));
+        if (count < 0 && EINTR == errno) {
+            continue;
+        }
+        if (count < 0) {
+            length = 0;
+            break;
+        }
+        if (0 == count) {
+            buffer[length] = '\0';
+            return true;
+        }
+        length += static_cast<size_t>(count);
+    }
+    buffer[0] = '\0';
+    return false;
+}
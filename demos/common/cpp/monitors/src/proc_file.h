@@ -0,0 +1,40 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+/// File of procfs which is kept open between samples. procfs regenerates the content on every read from the start, so
+/// it is read with pread() into the same buffer instead of opening and parsing it with std::ifstream every time.
+class ProcFile {
+public:
+    explicit ProcFile(const std::string& path);
+    ~ProcFile();
+    ProcFile(const ProcFile&) = delete;
+    ProcFile& operator=(const ProcFile&) = delete;
+
+    bool isOpen() const {
+        return fd >= 0;
+    }
+
+    /// Reads the whole file. The content is null-terminated and valid until the next read().
+    /// @returns false if the file can't be read, e.g. the thread it describes has exited
+    bool read();
+
+    const char* begin() const {
+        return buffer.data();
+    }
+    const char* end() const {
+        return buffer.data() + length;
+    }
+
+private:
+    int fd;
+    std::vector<char> buffer;
+    size_t length;
+};
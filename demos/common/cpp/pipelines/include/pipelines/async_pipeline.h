@@ -15,106 +15,490 @@
 */
 
 #pragma once
+#include <stddef.h>
 #include <stdint.h>
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <exception>
+#include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
-#include <unordered_map>
+#include <thread>
+#include <vector>
 
+#include <opencv2/core.hpp>
 #include <openvino/openvino.hpp>
 
 #include <models/results.h>
+#include <utils/config_factory.h>
+#include <utils/layers_profile.hpp>
+#include <utils/memory_accounting.hpp>
 #include <utils/performance_metrics.hpp>
 
+#include "pipelines/reorder_queue.h"
 #include "pipelines/requests_pool.h"
+#include "pipelines/shared_compiled_model.h"
 
 class ModelBase;
 struct InputData;
+struct InternalModelData;
 struct MetaData;
-struct ModelConfig;
+class MetricsSink;
+class TensorRecorder;
+
+/// Configuration of dynamic batching mode of the pipeline
+struct BatchingConfig {
+    /// @param batchSize - maximal number of frames gathered into one infer request. 1 disables batching.
+    /// @param timeout - maximal time to wait for the batch to be filled since its first frame was submitted.
+    /// Zero means that partially filled batch is sent only when pipeline is asked for total completion.
+    BatchingConfig(size_t batchSize = 1, std::chrono::microseconds timeout = std::chrono::microseconds::zero())
+        : batchSize(batchSize),
+          timeout(timeout) {}
+
+    size_t batchSize;
+    std::chrono::microseconds timeout;
+};
+
+/// Configuration of motion gating of the pipeline
+struct MotionGateConfig {
+    /// @param threshold - image frames which differ from the last inferred frame less than the threshold aren't
+    /// inferred, output tensors of the last inferred frame are postprocessed for them instead. The difference is the
+    /// mean absolute difference of downscaled grayscale images, in range [0, 1]. 0 disables the gate.
+    /// @param maxSkippedFrames - maximal number of consecutive frames which aren't inferred, so slow changes of the
+    /// scene still reach the model
+    MotionGateConfig(double threshold = 0, size_t maxSkippedFrames = 30)
+        : threshold(threshold),
+          maxSkippedFrames(maxSkippedFrames) {}
+
+    double threshold;
+    size_t maxSkippedFrames;
+};
+
+/// Defines what happens with a frame submitted when no infer request is available
+enum class AdmissionPolicy {
+    Block,              ///< submitData() waits for an idle request
+    DropNewest,         ///< submitData() rejects the frame (default)
+    DropOldestPending,  ///< the frame is queued, the oldest queued frame is dropped if the queue is full
+    LatestOnly,         ///< the frame replaces the queued one, so only the latest frame waits for a request
+    EarliestDeadline    ///< the frame is queued, queued frames are started by MetaData::priority and then by
+                        ///< MetaData::deadline. Frames which can't be inferred by the deadline, as estimated by the
+                        ///< measured inference latency, are dropped. If the queue is full, the least urgent frame is
+                        ///< dropped.
+};
 
 /// This is base class for asynchronous pipeline
 /// Derived classes should add functions for data submission and output processing
+/// Data can be submitted by several threads at once. Results are taken by one thread, either by getResult() or by the
+/// callback set by setResultCallback(). The model can be replaced by swapModel() while frames are processed.
+/// Several pipelines may run one compiled model, see SharedCompiledModel.
 class AsyncPipeline {
 public:
+    /// Receives postprocessed results, see setResultCallback()
+    using ResultCallback = std::function<void(std::unique_ptr<ResultBase>)>;
+    /// Receives frames dropped by admission policy, see setDropCallback()
+    using DropCallback = std::function<void(int64_t frameId, const std::shared_ptr<MetaData>& metaData)>;
+
     /// Loads model and performs required initialization
     /// @param modelInstance pointer to model object. Object it points to should not be destroyed manually after passing
     /// pointer to this function.
     /// @param config - fine tuning configuration for model
     /// @param core - reference to ov::Core instance to use.
     /// If it is omitted, new instance of  ov::Core will be created inside.
-    AsyncPipeline(std::unique_ptr<ModelBase>&& modelInstance, const ModelConfig& config, ov::Core& core);
+    /// @param batching - dynamic batching configuration. If batch size is greater than 1, the model is reshaped to
+    /// this batch and submitted frames are gathered into batches, results are still delivered per frame.
+    AsyncPipeline(std::unique_ptr<ModelBase>&& modelInstance,
+                  const ModelConfig& config,
+                  ov::Core& core,
+                  const BatchingConfig& batching = BatchingConfig());
+    /// Runs a clone of the model compiled once for several pipelines, so the compiled model isn't duplicated
+    /// @param sharedModel - the compiled model, it's kept alive by the pipeline
+    /// @param sharing - whether infer requests are taken from the pool shared by the pipelines or created by this one
+    /// @param modelInstance - clone of the shared model made by SharedCompiledModel::cloneModel(), its postprocessing
+    /// parameters may be changed. If it's null, the pipeline clones the model itself.
+    /// @param nireq - number of infer requests of the pipeline, or of the shared pool if it isn't created yet. 0 means
+    /// the one configured for the model or optimal for the device.
+    /// @param batchTimeout - see BatchingConfig, the batch size is the one the shared model is compiled with
+    AsyncPipeline(const std::shared_ptr<SharedCompiledModel>& sharedModel,
+                  RequestsSharing sharing,
+                  std::unique_ptr<ModelBase>&& modelInstance,
+                  unsigned int nireq = 0,
+                  std::chrono::microseconds batchTimeout = std::chrono::microseconds::zero());
     virtual ~AsyncPipeline();
 
     /// Waits until either output data becomes available or pipeline allows to submit more input data.
     /// @param shouldKeepOrder if true, function will treat results as ready only if next sequential result (frame) is
     /// ready (so results can be extracted in the same order as they were submitted). Otherwise, function will return if
     /// any result is ready.
-    void waitForData(bool shouldKeepOrder = true);
+    virtual void waitForData(bool shouldKeepOrder = true);
 
-    /// @returns true if there's available infer requests in the pool
-    /// and next frame can be submitted for processing, false otherwise.
-    bool isReadyToProcess() {
-        return requestsPool->isIdleRequestAvailable();
+    /// @returns true if next frame can be submitted for processing, false otherwise.
+    /// Unless admission policy is DropNewest, frames are accepted even if all infer requests are in use.
+    virtual bool isReadyToProcess() {
+        return !isOutputQueueFull() && (admissionPolicy != AdmissionPolicy::DropNewest || canStartFrame());
     }
 
-    /// Waits for all currently submitted requests to be completed.
-    ///
-    void waitForTotalCompletion() {
-        if (requestsPool)
-            requestsPool->waitForTotalCompletion();
+    /// Sets admission policy for frames submitted when no infer request is available.
+    /// Frames dropped by the policy are counted in getPreprocessMetrics(), their frame IDs are skipped by getResult().
+    /// @param policy - admission policy
+    /// @param maxPendingFrames - number of frames which can wait for a request with DropOldestPending and
+    /// EarliestDeadline policies
+    void setAdmissionPolicy(AdmissionPolicy policy, size_t maxPendingFrames = 1);
+
+    /// Sets the callback notified about frames which got frame IDs from submitData() and were dropped by admission
+    /// policy later, so their results never come. It's called by threads submitting data or taking results while
+    /// data submission is locked, so it must not submit data. Should be called before any data is submitted.
+    void setDropCallback(const DropCallback& callback);
+
+    /// Backpressure signal: results of submitted frames aren't taken out by getResult() fast enough and the reorder
+    /// queue has no room for the next frame. No data can be submitted until more results are taken.
+    /// @returns true if the next frame can't be submitted because the reorder queue is full
+    bool isOutputQueueFull() const {
+        return postprocessingThreads.empty() ? !completedInferenceResults.isReservable(inputFrameId)
+                                             : !postprocessedResults.isReservable(inputFrameId);
     }
 
+    /// Waits for all currently submitted requests to be completed (and postprocessed if postprocessing threads are
+    /// enabled, and delivered if the result callback is set). Partially filled batch (if any) is sent for inference
+    /// first. No data should be submitted while it waits.
+    virtual void waitForTotalCompletion();
+
+    /// Enables postprocessing of inference results on a pool of threads instead of the thread calling getResult().
+    /// Should be called before any data is submitted. Model's postprocess() must be safe to be called concurrently.
+    /// getResult() still honors shouldKeepOrder, as results are reordered after postprocessing.
+    /// @param threadsNum - number of postprocessing threads, 0 disables the pool
+    void setPostprocessingThreads(size_t threadsNum);
+
+    /// Lets threads submitting data preprocess their frames into their infer requests at the same time, instead of
+    /// one by one. Used only without batching and with Block and DropNewest admission policies. Model's preprocess()
+    /// must be safe to be called concurrently for different infer requests. Should be called before any data is
+    /// submitted.
+    void setConcurrentPreprocessing(bool concurrent);
+
+    /// Makes the pipeline push postprocessed results to the callback instead of keeping them for getResult(), which
+    /// can't be used then. Results are postprocessed and delivered by the postprocessing threads, one thread is
+    /// started if they aren't enabled. Calls of the callback don't overlap. An exception thrown by the callback stops
+    /// the delivery and is rethrown by waitForData(). Should be called before any data is submitted.
+    /// @param shouldKeepOrder - if true, results are delivered in the order the frames were submitted, otherwise as
+    /// soon as they are postprocessed
+    void setResultCallback(const ResultCallback& callback, bool shouldKeepOrder = true);
+
+    /// Makes results ordered within every stream of frames (MetaData::streamId, 0 for frames without metadata)
+    /// instead of all frames, so results of a stream aren't held back by a late frame of another stream, when
+    /// getResult(), waitForData() or the result callback are asked to keep order. Latencies of streams from submission
+    /// to taking the result out are measured, see getStreamsMetrics(). Not supported with the motion gate, as it
+    /// compares consecutive frames. Should be called before any data is submitted.
+    void setPerStreamOrder(bool perStream);
+
+    /// @returns metrics of results of every stream taken out of the pipeline, if per-stream order is set
+    std::map<size_t, PerformanceMetrics> getStreamsMetrics();
+
+    /// Records the tensors of every frame after its inference, so they can be replayed by ReplayModel.
+    /// Should be called before any data is submitted. Null disables the recording.
+    void setRecorder(const std::shared_ptr<TensorRecorder>& recorder);
+
+    /// Enables skipping of inference for image frames which are almost the same as the last inferred frame. Results
+    /// of skipped frames are flagged by ResultBase::isCached and counted in getPreprocessMetrics().
+    /// Should be called before any data is submitted.
+    void setMotionGate(const MotionGateConfig& gate);
+
+    /// Sends partially filled batch (if any) for inference without waiting for more frames.
+    void flushBatch();
+
     /// Submits data to the model for inference
     /// @param inputData - input data to be submitted
     /// @param metaData - shared pointer to metadata container.
     /// Might be null. This pointer will be passed through pipeline and put to the final result structure.
-    /// @returns -1 if image cannot be scheduled for processing (there's no free InferRequest available).
+    /// @returns -1 if image cannot be scheduled for processing (there's no free InferRequest available or reorder queue
+    /// is full).
     /// Otherwise returns unique sequential frame ID for this particular request. Same frame ID will be written in the
     /// result structure.
     virtual int64_t submitData(const InputData& inputData, const std::shared_ptr<MetaData>& metaData);
 
+    /// Submits data to the model for inference. Unlike the overload above, the pipeline may keep input data until an
+    /// infer request becomes available, so this overload is required by DropOldestPending and LatestOnly policies.
+    /// @returns -1 if image cannot be scheduled for processing. Otherwise returns unique sequential frame ID, but the
+    /// frame still may be dropped later by the admission policy.
+    virtual int64_t submitData(const std::shared_ptr<InputData>& inputData, const std::shared_ptr<MetaData>& metaData);
+
     /// Gets available data from the queue
     /// @param shouldKeepOrder if true, function will treat results as ready only if next sequential result (frame) is
     /// ready (so results can be extracted in the same order as they were submitted). Otherwise, function will return if
     /// any result is ready.
     virtual std::unique_ptr<ResultBase> getResult(bool shouldKeepOrder = true);
 
+    /// @returns number of infer requests the pipeline runs, either configured or optimal for the device
+    unsigned int getRequestsNum() const {
+        return requestsNum;
+    }
+
     PerformanceMetrics getInferenceMetircs() {
         return inferenceMetrics;
     }
     PerformanceMetrics getPreprocessMetrics() {
+        const std::lock_guard<std::mutex> lock(submitMtx);
         return preprocessMetrics;
     }
     PerformanceMetrics getPostprocessMetrics() {
         return postprocessMetrics;
     }
 
+    /// Adds metrics of the last time window of preprocessing, inference and postprocessing stages, number of infer
+    /// requests in use and depths of the pipeline queues to the next publication of the sink. If layers are
+    /// profiled, mean times of the slowest layers per inference since the start are added as "layer_ms.<name>".
+    void reportMetrics(MetricsSink& sink);
+
+    /// @returns execution times of layers summed over inferences of all infer requests, or null if profiling isn't
+    /// enabled on the compiled model, see ModelConfig::profiledLayers. Warm-up inferences aren't counted. It's the
+    /// profile of the model in use, it's valid until the model is swapped.
+    const LayersProfile* getLayersProfile() const {
+        return activeModel->layersProfile.get();
+    }
+
+    /// Logs the slowest layers of the profile, if layers are profiled
+    void logLayersProfile() const;
+
+    /// Replaces the model without stopping the pipeline. The new model is compiled with the config and the number of
+    /// infer requests of the current one, set up and warmed up by a background thread while frames are still
+    /// submitted to the current model. Once it's ready, next frames are inferred by the new model, and frames which
+    /// are already submitted are inferred and postprocessed by the old one, which is released when they are done.
+    /// The new model should produce results of the same type. Layers profile of the new model starts from scratch.
+    /// @throws std::logic_error if the previous swap isn't completed, see isModelSwapping(), or if the pipeline shares
+    /// infer requests of a SharedCompiledModel with other pipelines
+    void swapModel(std::unique_ptr<ModelBase>&& modelInstance);
+
+    /// @returns true while a model passed to swapModel() is being loaded
+    bool isModelSwapping() const {
+        return modelSwapping;
+    }
+
+    /// Waits until the model passed to swapModel() is loaded and next frames are submitted to it
+    /// @throws the exception the model failed to load with, the previous model stays in use then
+    void waitForModelSwap();
+
 protected:
+    /// Model with its compiled model and infer requests. The pipeline submits frames to the active one, models replaced
+    /// by swapModel() are retired until their requests complete and their results are postprocessed.
+    struct LoadedModel : std::enable_shared_from_this<LoadedModel> {
+        std::unique_ptr<ModelBase> model;
+        ov::CompiledModel compiledModel;
+        /// outputs of the compiled model in the order of ModelBase::getOutputsNames(), they are resolved once, so
+        /// completed requests don't look their tensors up by names
+        OutputsData::Names outputsNames;
+        std::vector<ov::Output<const ov::Node>> outputs;
+        std::shared_ptr<RequestsPool> requestsPool;
+        std::unique_ptr<LayersProfile> layersProfile;
+        /// The compiled model the model is a clone of, if the pipeline is built from a shared one
+        std::shared_ptr<SharedCompiledModel> sharedModel;
+        /// true if requests are taken from the pool of the shared model, which other pipelines use too
+        bool sharesRequests = false;
+        /// Requests started by the pipeline and not completed yet, changed under mtx
+        std::atomic<size_t> requestsInFlight{0};
+
+        /// @returns number of requests in use by the pipeline
+        size_t getRequestsInUse() const {
+            return sharesRequests ? requestsInFlight.load() : requestsPool->getInUseRequestsCount();
+        }
+    };
+
+    /// Compiles the model, creates its infer requests and warms them up
+    /// @param nireq - number of infer requests, 0 means the one configured for the model or optimal for the device
+    std::shared_ptr<LoadedModel> loadModel(std::unique_ptr<ModelBase>&& modelInstance, unsigned int nireq);
+    /// Resolves outputs of the compiled model of the loaded model and creates its infer requests, or takes the shared
+    /// ones, which are set up by the shared model
+    /// @param nireq - see loadModel()
+    /// @param shareRequests - if true, requests are taken from the pool of LoadedModel::sharedModel
+    void setUpRequests(LoadedModel& loaded, unsigned int nireq, bool shareRequests);
+    /// Sizes the queues of the pipeline by the number of infer requests of the active model, once it's loaded
+    void initialize();
+    /// Loads the model passed to swapModel() and makes it active, runs in swapThread
+    void swapModelThreadFunc(ModelBase* modelInstance);
+    /// Makes the model infer next frames and retires the active one
+    void activateModel(const std::shared_ptr<LoadedModel>& loaded);
+    /// Releases retired models which have neither requests in flight nor results waiting for postprocessing,
+    /// mtx should be unlocked
+    void releaseRetiredModels();
+    /// @returns the model which postprocesses the result of the frame, mtx should be locked. It's taken once, when
+    /// the result is taken for postprocessing.
+    std::shared_ptr<LoadedModel> takeFrameModel(int64_t frameId);
+
     /// Returns processed result, if available
     /// @param shouldKeepOrder if true, function will return processed data sequentially,
     /// keeping original frames order (as they were submitted). Otherwise, function will return processed data in random
     /// order.
+    /// @param loadedModel - receives the model which should postprocess the result
     /// @returns InferenceResult with processed information or empty InferenceResult (with negative frameID) if there's
     /// no any results yet.
-    virtual InferenceResult getInferenceResult(bool shouldKeepOrder);
+    virtual InferenceResult getInferenceResult(bool shouldKeepOrder, std::shared_ptr<LoadedModel>& loadedModel);
+
+    /// Returns result postprocessed by the pool, if available. Order is the same as in getInferenceResult().
+    std::unique_ptr<ResultBase> getPostprocessedResult(bool shouldKeepOrder);
+
+    /// Updates output frame ID after result with frameId is taken out of the pipeline
+    void advanceOutputFrameId(int64_t frameId);
+
+    /// @returns true if result is available for getResult()
+    bool isResultReady(bool shouldKeepOrder) const;
+
+    /// @returns true if next frame can be put to infer request right away
+    bool canStartFrame() const {
+        return !pendingBatch.empty() || activeModel->requestsPool->isIdleRequestAvailable();
+    }
 
-    std::unique_ptr<RequestsPool> requestsPool;
-    std::unordered_map<int64_t, InferenceResult> completedInferenceResults;
+    /// Assigns frame ID to the next frame and reserves its slot in the reorder queue, in the frame's stream if results
+    /// are ordered per stream
+    int64_t reserveFrameId(const std::shared_ptr<MetaData>& metaData);
+    /// Updates metrics of the stream of the result taken out of the pipeline, mtx should be locked
+    void registerStreamResult(const ResultBase& result);
+    /// Takes an idle infer request of the active model for the next frame, unless the pending batch has one,
+    /// submitMtx should be locked. The taken request should be used by the frame before submitMtx is unlocked.
+    /// @returns false if all requests are in use, which may happen after canStartFrame() returned true if requests
+    /// are shared with other pipelines
+    bool takeIdleRequest();
+    /// Preprocesses the frame into infer request and starts inference if the batch is complete
+    void startFrame(int64_t frameId, const InputData& inputData, const std::shared_ptr<MetaData>& metaData);
+    /// Takes the infer request taken by takeIdleRequest(), unlocks submitMtx so other threads can submit data,
+    /// preprocesses the frame into the request and starts its inference
+    void startFrameConcurrently(std::unique_lock<std::mutex>& submitLock,
+                                int64_t frameId,
+                                const InputData& inputData,
+                                const std::shared_ptr<MetaData>& metaData);
+    /// Starts inference of frames queued by admission policy while infer requests are available
+    void startPendingFrames();
+    /// @returns time by which a frame started now is expected to be inferred
+    std::chrono::steady_clock::time_point getExpectedCompletion();
+    /// Drops queued frames which can't be inferred by their deadlines
+    void dropLateFrames();
+    /// Sends partially filled batch (if any) for inference, submitMtx should be locked
+    void flushPendingBatch();
+    /// Marks frame as dropped in the reorder queue, so getResult() skips it, and notifies the drop callback
+    void dropFrame(int64_t frameId, const std::shared_ptr<MetaData>& metaData);
+    /// Computes the thumbnail of the frame for the motion gate
+    /// @returns empty thumbnail if the gate is disabled or the frame isn't an image
+    cv::Mat makeGateThumbnail(const InputData& inputData) const;
+    /// Puts the result of the last inferred frame for the frame if the frame hardly differs from it
+    /// @returns frame ID or -1 if the frame should be inferred
+    int64_t submitCachedResult(const cv::Mat& thumbnail, const std::shared_ptr<MetaData>& metaData);
+    /// Makes the started frame the one the next frames are compared with
+    void setGateReference(int64_t frameId, const cv::Mat& thumbnail);
+    /// Waits until next frame can be put to infer request
+    void waitForIdleRequest();
+    /// Updates memory counters of infer requests and devices of the model
+    void updateMemoryUsage(const LoadedModel& loaded);
 
-    ov::CompiledModel compiledModel;
+    void postprocessingThreadFunc();
+    void stopPostprocessingThreads();
+    /// @returns true if a result can be delivered to the callback, mtx should be locked
+    bool canDeliverResults() const;
+    /// Delivers ready results to the callback, mtx is unlocked while the callback is called
+    void deliverResults(std::unique_lock<std::mutex>& lock);
 
+    struct PendingBatchItem {
+        int64_t frameId;
+        std::shared_ptr<InternalModelData> internalModelData;
+        std::shared_ptr<MetaData> metaData;
+        std::chrono::steady_clock::time_point startTime;
+    };
+
+    /// Sets completion callback gathering results of all frames of the request and starts inference
+    void startRequest(LoadedModel& loaded,
+                      ov::InferRequest& request,
+                      size_t requestSlot,
+                      const std::vector<PendingBatchItem>& items);
+
+    struct PendingFrame {
+        int64_t frameId;
+        std::shared_ptr<InputData> inputData;
+        std::shared_ptr<MetaData> metaData;
+        cv::Mat gateThumbnail;
+    };
+
+    /// @returns the queued frame to be started next
+    std::deque<PendingFrame>::iterator findNextPendingFrame();
+
+    AdmissionPolicy admissionPolicy = AdmissionPolicy::DropNewest;
+    size_t maxPendingFrames = 1;
+    std::deque<PendingFrame> pendingFrames;
+    DropCallback dropCallback;
+    /// Moving average of the time from preprocessing of a frame to completion of its inference, guarded by mtx
+    std::chrono::steady_clock::duration expectedLatency = std::chrono::steady_clock::duration::zero();
+
+    BatchingConfig batchingConfig;
+    ov::InferRequest pendingRequest;
+    size_t pendingRequestSlot = 0;
+    std::vector<PendingBatchItem> pendingBatch;
+    std::chrono::steady_clock::time_point pendingBatchDeadline;
+
+    ov::Core& core;
+    /// config the model was compiled with, models passed to swapModel() are compiled with it too
+    ModelConfig modelConfig;
+    /// The model next frames are submitted to and the models replaced by swapModel() which are still in use. Active
+    /// model is changed under both submitMtx and mtx, retired models are guarded by mtx.
+    std::shared_ptr<LoadedModel> activeModel;
+    std::vector<std::shared_ptr<LoadedModel>> retiredModels;
+    std::atomic<bool> hasRetiredModels{false};
+    /// Models which postprocess results of frames in slots of the reorder queue, guarded by mtx. The slot is set when
+    /// the result is completed and cleared when it's taken for postprocessing.
+    std::vector<std::shared_ptr<LoadedModel>> frameModels;
+    std::thread swapThread;
+    std::atomic<bool> modelSwapping{false};
+    std::exception_ptr swapException = nullptr;
+    unsigned int requestsNum = 0;
+    /// input and output tensors of all infer requests
+    MemoryCounter requestsMemory{"AsyncPipeline.requests"};
+    /// memory of GPU devices, it's queried once the model is compiled and infer requests are created. The plugin
+    /// reports usage of the whole device, so every pipeline on the same device counts memory of all of them.
+    MemoryCounter deviceMemory{"AsyncPipeline.device"};
+    ReorderQueue<InferenceResult> completedInferenceResults;
+
+    /// Serializes submission of data: guards pending frames, pending batch (it's also guarded by mtx, as
+    /// canStartFrame() is checked under mtx), motion gate state of the submitting threads and preprocessing metrics.
+    /// It's always locked before mtx.
+    std::mutex submitMtx;
     std::mutex mtx;
     std::condition_variable condVar;
 
-    int64_t inputFrameId = 0;
+    /// Changed under submitMtx, but read by any thread
+    std::atomic<int64_t> inputFrameId{0};
     int64_t outputFrameId = 0;
+    bool concurrentPreprocessing = false;
+    bool perStreamOrder = false;
+    /// Submission times of frames in slots of the reorder queue and metrics of the streams, guarded by mtx
+    std::vector<std::chrono::steady_clock::time_point> submitTimes;
+    std::map<size_t, PerformanceMetrics> streamsMetrics;
 
     std::exception_ptr callbackException = nullptr;
 
-    std::unique_ptr<ModelBase> model;
+    std::vector<std::thread> postprocessingThreads;
+    std::deque<InferenceResult> postprocessingQueue;
+    ReorderQueue<std::unique_ptr<ResultBase>> postprocessedResults;
+    size_t postprocessingInFlight = 0;
+    bool stopPostprocessing = false;
+    std::condition_variable postprocessingCondVar;
+
+    ResultCallback resultCallback;
+    bool callbackKeepsOrder = true;
+    /// true while a postprocessing thread delivers results, so calls of the callback don't overlap
+    bool isDelivering = false;
+
+    std::shared_ptr<TensorRecorder> recorder;
+
+    /// number of the slowest layers which are reported
+    size_t profiledLayersNum = 0;
+
+    MotionGateConfig motionGate;
+    /// Thumbnail of the last started frame and number of frames skipped since it, guarded by submitMtx
+    cv::Mat gateThumbnail;
+    size_t skippedFramesInRow = 0;
+    /// Last started frame, copy of its inference result once it's completed and the model which inferred it,
+    /// guarded by mtx
+    int64_t gateFrameId = -1;
+    InferenceResult cachedResult;
+    std::shared_ptr<LoadedModel> cachedResultModel;
+
     PerformanceMetrics inferenceMetrics;
     PerformanceMetrics preprocessMetrics;
     PerformanceMetrics postprocessMetrics;
@@ -0,0 +1,118 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <models/results.h>
+
+#include "pipelines/async_pipeline.h"
+#include "pipelines/metadata.h"
+
+struct InputData;
+
+/// Result of the cascade: result of the primary stage and results of every secondary stage for every input produced
+/// from the primary result by this stage's fan-out function
+struct CascadeResult : public ResultBase {
+    CascadeResult(int64_t frameId = -1, const std::shared_ptr<MetaData>& metaData = nullptr)
+        : ResultBase(frameId, metaData) {}
+
+    std::unique_ptr<ResultBase> primaryResult;
+    /// stageResults[i][j] is result of the stage i for the j-th input produced from the primary result
+    std::vector<std::vector<std::unique_ptr<ResultBase>>> stageResults;
+};
+
+/// Metadata attached to inputs of secondary stages to route their results back to the primary frame
+struct CascadeMetaData : public MetaData {
+    CascadeMetaData(int64_t parentFrameId, size_t inputIdx) : parentFrameId(parentFrameId), inputIdx(inputIdx) {}
+
+    int64_t parentFrameId;
+    size_t inputIdx;
+};
+
+/// This is pipeline running a primary model (e.g. detector) and several secondary models fed by inputs derived
+/// from the primary result (e.g. crops of detected objects).
+/// Every stage is a separate AsyncPipeline with its own requests pool, so the primary model can process next frames
+/// while secondary models are still processing objects of previous ones.
+class CascadePipeline {
+public:
+    /// Produces inputs of a secondary stage from the primary result. Null inputs are skipped, their results in
+    /// CascadeResult::stageResults stay null.
+    using FanOut = std::function<std::vector<std::shared_ptr<InputData>>(const ResultBase&)>;
+
+    /// @param primaryPipeline - pipeline of the primary stage. Submitted data goes there.
+    explicit CascadePipeline(std::unique_ptr<AsyncPipeline>&& primaryPipeline);
+    virtual ~CascadePipeline();
+
+    /// Adds secondary stage. Should be called before any data is submitted.
+    /// @param pipeline - pipeline of the stage
+    /// @param fanOut - function producing inputs of the stage from the primary result
+    void addStage(std::unique_ptr<AsyncPipeline>&& pipeline, const FanOut& fanOut);
+
+    /// @returns true if the primary stage can accept the next frame
+    bool isReadyToProcess() {
+        return primary->isReadyToProcess();
+    }
+
+    /// Submits data to the primary stage, see AsyncPipeline::submitData()
+    int64_t submitData(const InputData& inputData, const std::shared_ptr<MetaData>& metaData);
+
+    /// Waits until some of stages is able to make progress: either a result is available or more data can be
+    /// submitted.
+    void waitForData();
+
+    /// Gets next result of the cascade. Results are returned in the order frames were submitted.
+    /// @returns CascadeResult or nullptr if the next frame isn't processed completely yet.
+    std::unique_ptr<ResultBase> getResult();
+
+    /// Waits for all currently submitted frames to be processed by every stage.
+    void waitForTotalCompletion();
+
+    /// Fan-out function producing crops of detected objects from DetectionResult. Crops are ROIs of the frame
+    /// stored in ImageMetaData of the result, so no image data is copied. Crops are produced in the order of
+    /// DetectionResult::objects, objects lying outside of the frame get null input.
+    static std::vector<std::shared_ptr<InputData>> cropDetections(const ResultBase& result);
+
+protected:
+    struct Stage {
+        std::unique_ptr<AsyncPipeline> pipeline;
+        FanOut fanOut;
+        std::deque<std::pair<std::shared_ptr<InputData>, std::shared_ptr<MetaData>>> queuedInputs;
+        size_t inFlight = 0;
+    };
+
+    struct FrameState {
+        std::unique_ptr<CascadeResult> result;
+        size_t remaining = 0;
+    };
+
+    /// Moves data between stages without blocking: fans out available primary results, submits queued inputs of
+    /// secondary stages and gathers their results.
+    void pump();
+
+    std::unique_ptr<AsyncPipeline> primary;
+    std::vector<Stage> stages;
+    std::map<int64_t, FrameState> frames;
+    int64_t submittedFramesCount = 0;
+};
@@ -0,0 +1,117 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <models/results.h>
+
+#include "pipelines/async_pipeline.h"
+#include "pipelines/metadata.h"
+
+struct InputData;
+
+/// Pipeline passing the result of every submitted frame to the continuation given with the frame, so per-frame logic
+/// over several models is written as a chain of continuations instead of polling of pipelines and routing of their
+/// results through shared context. No thread waits for a frame: a continuation runs when its result is ready and may
+/// submit the next inference of the frame, to this or another ContinuationPipeline.
+///
+///     detector.infer(frame, meta, [&](std::unique_ptr<ResultBase> detections) {
+///         auto join = ResultsJoin::create(crops.size(), [](std::vector<std::unique_ptr<ResultBase>> labels) {...});
+///         for (size_t i = 0; i < crops.size(); ++i) {
+///             classifier.infer(crops[i], nullptr, join->slot(i));
+///         }
+///     });
+///
+/// Continuations are called by the delivery thread of the pipeline, one at a time, so they should be short and must
+/// not wait for other results. A continuation submitting to the pipeline it's called by must not block, so its
+/// admission policy shouldn't be Block. Continuations of dropped frames are called by threads submitting data.
+class ContinuationPipeline {
+public:
+    /// Receives the result of the frame or null if the frame was rejected or dropped by admission policy
+    using Continuation = std::function<void(std::unique_ptr<ResultBase>)>;
+
+    /// Takes over the pipeline and its result and drop callbacks, no data should be submitted to it before
+    explicit ContinuationPipeline(std::unique_ptr<AsyncPipeline>&& pipeline);
+
+    /// Submits the frame, the continuation is called exactly once. If the frame is rejected, the continuation is
+    /// called before infer() returns. The result comes with the given metadata.
+    /// @returns frame ID of the submitted frame or -1 if it was rejected
+    int64_t infer(const std::shared_ptr<InputData>& inputData,
+                  const std::shared_ptr<MetaData>& metaData,
+                  const Continuation& then);
+
+    AsyncPipeline& getPipeline() {
+        return *pipeline;
+    }
+
+    /// @returns number of frames whose continuations aren't called yet
+    size_t getPendingFramesNum() const {
+        return pendingFramesNum;
+    }
+
+    /// Waits until continuations of all submitted frames are called. Frames submitted to other pipelines by the
+    /// continuations aren't waited for, so the pipelines of a cascade are completed in the order of the stages.
+    /// Exceptions thrown by continuations are rethrown.
+    void waitForTotalCompletion();
+
+private:
+    /// Wraps metadata of the frame to carry its continuation through the pipeline
+    struct ContinuationMetaData : public MetaData {
+        ContinuationMetaData(const std::shared_ptr<MetaData>& userMetaData, const Continuation& then);
+
+        std::shared_ptr<MetaData> userMetaData;
+        Continuation then;
+    };
+
+    void deliver(std::unique_ptr<ResultBase> result);
+    void drop(const std::shared_ptr<MetaData>& metaData);
+
+    std::atomic<size_t> pendingFramesNum{0};
+    // Destroyed first, as the pipeline completes submitted frames on destruction
+    std::unique_ptr<AsyncPipeline> pipeline;
+};
+
+/// Gathers results of several inferences (e.g. of every crop of a frame) and passes them to the continuation once
+/// the last one comes. Results come in any order and from any threads, the continuation is called by the thread
+/// delivering the last result.
+class ResultsJoin : public std::enable_shared_from_this<ResultsJoin> {
+public:
+    using Continuation = std::function<void(std::vector<std::unique_ptr<ResultBase>>)>;
+
+    /// If resultsNum is 0, the continuation is called by create()
+    static std::shared_ptr<ResultsJoin> create(size_t resultsNum, const Continuation& then);
+
+    /// @returns continuation putting the result to the idx-th place, it keeps the join alive
+    ContinuationPipeline::Continuation slot(size_t idx);
+
+private:
+    ResultsJoin(size_t resultsNum, const Continuation& then);
+
+    void put(size_t idx, std::unique_ptr<ResultBase> result);
+
+    std::mutex mtx;
+    std::vector<std::unique_ptr<ResultBase>> results;
+    size_t remaining;
+    Continuation then;
+};
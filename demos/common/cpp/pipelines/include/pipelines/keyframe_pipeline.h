@@ -0,0 +1,132 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include <models/results.h>
+
+#include "pipelines/async_pipeline.h"
+
+struct ImageInputData;
+struct MetaData;
+
+/// Configuration of keyframe detection
+struct KeyframeConfig {
+    /// @param maxInterval - the detector runs at least on every maxInterval-th frame. 1 runs it on every frame.
+    /// @param motionBudget - a keyframe is also taken as soon as the scene motion accumulated since the previous
+    /// keyframe reaches the budget. Motion of a frame is the mean absolute difference of its downscaled grayscale
+    /// image from the previous frame, in range [0, 1]. 0 disables the motion adaptation.
+    KeyframeConfig(size_t maxInterval = 1, double motionBudget = 0)
+        : maxInterval(maxInterval),
+          motionBudget(motionBudget) {}
+
+    size_t maxInterval;
+    double motionBudget;
+};
+
+/// This is pipeline running a detection model on keyframes only. Results of other frames are propagated from the
+/// latest keyframe: objects of consecutive keyframes are matched by IoU and every object keeps moving with its
+/// measured velocity. The keyframe interval shrinks when the scene moves, so static cameras are detected rarely and
+/// busy scenes often. Results of all frames are delivered in the submission order as DetectionResult, propagated
+/// ones are flagged by DetectionResult::isPropagated.
+class KeyframePipeline {
+public:
+    /// @param pipeline - pipeline with a detection model. It should use Block or DropNewest admission policy, so it
+    /// never drops accepted frames.
+    KeyframePipeline(std::unique_ptr<AsyncPipeline>&& pipeline, const KeyframeConfig& config);
+    virtual ~KeyframePipeline();
+
+    /// @returns true if the next frame can be submitted, either as a keyframe or not
+    bool isReadyToProcess();
+
+    /// Submits the frame to the detector if it is a keyframe, otherwise only queues it for propagation
+    /// @returns -1 if the frame can't be accepted (see isReadyToProcess()). Otherwise returns unique sequential frame
+    /// ID, it is written in the result structure.
+    int64_t submitData(const ImageInputData& inputData, const std::shared_ptr<MetaData>& metaData);
+
+    /// Waits until either the next result becomes available or the pipeline allows to submit more frames.
+    void waitForData();
+
+    /// @returns DetectionResult of the next frame in the submission order, if it's ready. Otherwise returns nullptr.
+    std::unique_ptr<ResultBase> getResult();
+
+    /// Waits for all submitted keyframes to be processed.
+    void waitForTotalCompletion();
+
+    /// Gives access to the underlying pipeline, e.g. to its performance metrics
+    AsyncPipeline& getDetectionPipeline() {
+        return *pipeline;
+    }
+
+    /// @returns number of frames submitted to the detector
+    size_t getKeyframesNum() const {
+        return keyframesNum;
+    }
+
+    /// @returns number of frames which results were propagated
+    size_t getPropagatedNum() const {
+        return propagatedNum;
+    }
+
+protected:
+    struct Frame {
+        int64_t frameId;
+        std::shared_ptr<MetaData> metaData;
+        bool isKeyframe;
+        /// Detection result of a keyframe, once it's received
+        std::unique_ptr<ResultBase> result;
+    };
+
+    struct Track {
+        DetectedObject object;
+        /// Shift of the object per frame
+        cv::Point2f velocity;
+    };
+
+    /// Takes all available results of keyframes out of the underlying pipeline without blocking
+    void gatherResults();
+    /// Matches objects of the keyframe to the tracks of the previous keyframe and measures their velocities
+    void updateTracks(int64_t frameId, const DetectionResult& result);
+    /// Moves objects of the latest keyframe to the frame
+    std::unique_ptr<ResultBase> propagate(int64_t frameId, const std::shared_ptr<MetaData>& metaData);
+
+    std::unique_ptr<AsyncPipeline> pipeline;
+    KeyframeConfig config;
+    size_t maxQueuedFrames;
+    /// Frames which results haven't been taken out yet, in the submission order
+    std::deque<Frame> frames;
+
+    cv::Mat prevThumbnail;
+    double accumulatedMotion = 0;
+    size_t framesSinceKeyframe = 0;
+
+    std::vector<Track> tracks;
+    std::shared_ptr<const std::vector<std::string>> labels;
+    int64_t lastKeyframeId = -1;
+
+    int64_t inputFrameId = 0;
+    size_t keyframesNum = 0;
+    size_t propagatedNum = 0;
+};
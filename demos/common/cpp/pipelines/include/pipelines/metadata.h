@@ -15,11 +15,27 @@
 */
 
 #pragma once
+#include <stddef.h>
+
+#include <chrono>
+
 #include <utils/ocv_common.hpp>
 
 struct MetaData {
     virtual ~MetaData() {}
 
+    /// Source of the frame, e.g. a camera, if frames of several sources are submitted to one pipeline. Results are
+    /// ordered within every stream if the pipeline is asked for it, see AsyncPipeline::setPerStreamOrder().
+    size_t streamId = 0;
+    /// Urgency of the frame for AdmissionPolicy::EarliestDeadline: frames of higher priority are started first,
+    /// frames of the same priority are started in the order of their deadlines. A frame which can't be inferred by its
+    /// deadline is dropped.
+    int priority = 0;
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    /// Index of the model variant which inferred the frame, set in results of ModelLadderPipeline. 0 is the most
+    /// accurate variant.
+    size_t modelVariant = 0;
+
     template <class T>
     T& asRef() {
         return dynamic_cast<T&>(*this);
@@ -0,0 +1,160 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <models/results.h>
+
+#include "pipelines/async_pipeline.h"
+
+struct InputData;
+struct MetaData;
+
+/// This is pipeline running one of several variants of the same model (e.g. a detector of lower input resolution or
+/// INT8 precision) for every stream of frames, to keep latency within a budget when the host is overloaded. Every
+/// variant is a separate AsyncPipeline, compiled before frames are submitted, so switching costs nothing.
+/// Streams start on the most accurate variant. A stream whose moving average latency from submission till result
+/// exceeds the budget moves to the next cheaper variant, and moves back once its latency drops below the headroom
+/// part of the budget. A stream which has to move back down right after moving up waits twice as long before the
+/// next attempt, so it doesn't oscillate between variants when only the cheaper one meets the budget.
+/// Results of all variants are merged back in the order frames were submitted, MetaData::modelVariant of a result
+/// tells which variant inferred it.
+class ModelLadderPipeline {
+public:
+    struct Config {
+        /// Latency from frame submission till its result is received allowed to a stream, in milliseconds
+        double latencyBudget = 100;
+        /// A stream moves to a more accurate variant if its latency is below this part of the budget
+        double headroom = 0.6;
+        /// Weight of the latest frame in moving average latency of a stream, in range (0, 1]
+        double latencySmoothing = 0.1;
+        /// Frames a stream processes on a variant before it may switch again
+        size_t switchInterval = 30;
+    };
+
+    /// Statistics of a single variant
+    struct VariantStats {
+        std::string name;
+        /// Exponential moving average of latency of the variant's frames, in milliseconds. NaN if no frames have
+        /// been processed by the variant yet.
+        double averageLatency;
+        size_t framesProcessed;
+        /// Streams which are currently submitted to the variant
+        size_t streamsNum;
+    };
+
+    explicit ModelLadderPipeline(const Config& config);
+    virtual ~ModelLadderPipeline();
+
+    /// Adds variant, variants are added from the most accurate to the cheapest one. Should be called before any data
+    /// is submitted.
+    /// Variant pipeline should use Block or DropNewest admission policy, so it never drops accepted frames.
+    /// @param pipeline - pipeline of the variant, results of all variants should be of the same type
+    /// @param name - name of the variant used in statistics
+    void addVariant(std::unique_ptr<AsyncPipeline>&& pipeline, const std::string& name);
+
+    /// @returns true if the variant of the stream can accept the next frame
+    bool isReadyToProcess(size_t streamId = 0);
+
+    /// Submits data to the variant of its stream, see MetaData::streamId
+    /// @returns -1 if the variant can't accept the frame. Otherwise returns unique sequential frame ID, it is written
+    /// in the result structure.
+    int64_t submitData(const InputData& inputData, const std::shared_ptr<MetaData>& metaData);
+
+    /// Waits until either output data becomes available or some of variants allows to submit more input data.
+    /// @param shouldKeepOrder - see AsyncPipeline::waitForData()
+    void waitForData(bool shouldKeepOrder = true);
+
+    /// Gets available result of any variant
+    /// @param shouldKeepOrder - see AsyncPipeline::getResult()
+    /// @returns result or nullptr if there's no result ready yet
+    std::unique_ptr<ResultBase> getResult(bool shouldKeepOrder = true);
+
+    /// Waits for all currently submitted frames to be processed by every variant.
+    void waitForTotalCompletion();
+
+    /// @returns index of the variant frames of the stream are submitted to
+    size_t getStreamVariant(size_t streamId = 0) const;
+
+    /// @returns number of switches of streams between variants
+    size_t getSwitchesCount() const {
+        return switchesCount;
+    }
+
+    std::vector<VariantStats> getVariantStats() const;
+    /// Prints statistics of every variant
+    void logVariantStats() const;
+
+    /// Gives access to the variant pipeline, e.g. to its performance metrics
+    AsyncPipeline& getVariantPipeline(size_t variantIdx) {
+        return *variants.at(variantIdx).pipeline;
+    }
+
+    size_t getVariantsCount() const {
+        return variants.size();
+    }
+
+protected:
+    struct InFlightFrame {
+        int64_t frameId;
+        size_t streamId;
+        std::chrono::steady_clock::time_point submitTime;
+    };
+
+    struct Variant {
+        std::unique_ptr<AsyncPipeline> pipeline;
+        std::string name;
+        /// Frames submitted to the variant by its frame IDs
+        std::map<int64_t, InFlightFrame> inFlight;
+        double averageLatency = 0;
+        size_t framesProcessed = 0;
+    };
+
+    struct StreamState {
+        size_t variant = 0;
+        /// Moving average latency of the frames of the current variant
+        double averageLatency = 0;
+        size_t framesSinceSwitch = 0;
+        /// Frames to process before moving to a more accurate variant
+        size_t upgradeInterval = 0;
+        bool isUpgradePending = false;  ///< the last switch was to a more accurate variant
+    };
+
+    /// Gathers results of all variants without blocking and switches variants of streams
+    void pump();
+    /// Accounts the latency of the stream's frame inferred by the variant and switches the stream if needed
+    void updateStream(size_t streamId, size_t variantIdx, double latency);
+    void switchStream(StreamState& stream, size_t variantIdx);
+    /// @returns index of the variant holding the oldest frame in flight or variants.size() if there're no such frames
+    size_t findOldestFrameVariant() const;
+
+    const Config config;
+    std::vector<Variant> variants;
+    std::map<size_t, StreamState> streams;
+    std::map<int64_t, std::unique_ptr<ResultBase>> completedResults;
+    size_t switchesCount = 0;
+
+    int64_t inputFrameId = 0;
+    int64_t outputFrameId = 0;
+};
@@ -0,0 +1,121 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <models/results.h>
+
+#include "pipelines/async_pipeline.h"
+
+struct InputData;
+struct MetaData;
+
+/// This is pipeline running the same model on several devices (e.g. CPU, integrated and discrete GPU) at once.
+/// Every device is a separate AsyncPipeline with its own compiled model and requests pool. Every frame goes to
+/// the device which is able to accept it and has the lowest moving average latency, results of all devices are merged
+/// back in the order frames were submitted.
+/// Unlike MULTI plugin, the scheduler keeps per-device statistics available through getDeviceStats().
+class MultiDevicePipeline {
+public:
+    /// Statistics of a single device
+    struct DeviceStats {
+        std::string name;
+        /// Exponential moving average of time from frame submission till its result is received, in milliseconds.
+        /// NaN if no frames have been processed by the device yet.
+        double averageLatency;
+        size_t framesInFlight;
+        size_t framesProcessed;
+    };
+
+    /// @param latencySmoothing - weight of the latest frame in moving average latency, in range (0, 1]
+    explicit MultiDevicePipeline(double latencySmoothing = 0.1);
+    virtual ~MultiDevicePipeline();
+
+    /// Adds device. Should be called before any data is submitted.
+    /// Device pipeline should use Block or DropNewest admission policy, so it never drops accepted frames.
+    /// @param pipeline - pipeline of the device, it owns its own model instance compiled for the device
+    /// @param name - name of the device used in statistics
+    void addDevice(std::unique_ptr<AsyncPipeline>&& pipeline, const std::string& name);
+
+    /// @returns true if some of devices can accept the next frame
+    bool isReadyToProcess();
+
+    /// Submits data to the device with an idle infer request and the lowest moving average latency.
+    /// Devices which haven't processed any frame yet are preferred, so all of them get measured.
+    /// @returns -1 if no device can accept the frame. Otherwise returns unique sequential frame ID, it is written in
+    /// the result structure.
+    int64_t submitData(const InputData& inputData, const std::shared_ptr<MetaData>& metaData);
+
+    /// Waits until either output data becomes available or some of devices allows to submit more input data.
+    /// @param shouldKeepOrder - see AsyncPipeline::waitForData()
+    void waitForData(bool shouldKeepOrder = true);
+
+    /// Gets available result of any device
+    /// @param shouldKeepOrder - see AsyncPipeline::getResult()
+    /// @returns result or nullptr if there's no result ready yet
+    std::unique_ptr<ResultBase> getResult(bool shouldKeepOrder = true);
+
+    /// Waits for all currently submitted frames to be processed by every device.
+    void waitForTotalCompletion();
+
+    std::vector<DeviceStats> getDeviceStats() const;
+    /// Prints statistics of every device
+    void logDeviceStats() const;
+
+    /// Gives access to the device pipeline, e.g. to its performance metrics
+    AsyncPipeline& getDevicePipeline(size_t deviceIdx) {
+        return *devices.at(deviceIdx).pipeline;
+    }
+
+    size_t getDevicesCount() const {
+        return devices.size();
+    }
+
+protected:
+    struct InFlightFrame {
+        int64_t frameId;
+        std::chrono::steady_clock::time_point submitTime;
+    };
+
+    struct Device {
+        std::unique_ptr<AsyncPipeline> pipeline;
+        std::string name;
+        /// Frames submitted to the device by its frame IDs
+        std::map<int64_t, InFlightFrame> inFlight;
+        double averageLatency = 0;
+        size_t framesProcessed = 0;
+    };
+
+    /// Gathers results of all devices without blocking
+    void pump();
+    /// @returns index of the device holding the oldest frame in flight or devices.size() if there're no such frames
+    size_t findOldestFrameDevice() const;
+
+    double latencySmoothing;
+    std::vector<Device> devices;
+    std::map<int64_t, std::unique_ptr<ResultBase>> completedResults;
+
+    int64_t inputFrameId = 0;
+    int64_t outputFrameId = 0;
+};
@@ -0,0 +1,196 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/// Fixed-capacity ring buffer restoring order of values completed out of order.
+/// Value of frame frameId occupies slot frameId % capacity, the slot has to be reserved when frame is submitted and is
+/// released when the value is taken out. Frames may belong to streams, then values can be taken in the order of frames
+/// within every stream, so a late frame of one stream doesn't hold back values of others. This class is not thread
+/// safe.
+template <class T>
+class ReorderQueue {
+public:
+    explicit ReorderQueue(size_t capacity = 1) : slots(capacity), readyCount(0) {
+        if (capacity == 0) {
+            throw std::invalid_argument("Capacity of reorder queue should be positive");
+        }
+    }
+
+    size_t capacity() const {
+        return slots.size();
+    }
+
+    /// @returns true if slot for frameId can be reserved, false if it's still occupied by an older frame
+    bool isReservable(int64_t frameId) const {
+        return slotFor(frameId).frameId < 0;
+    }
+
+    /// Reserves slot for frameId
+    /// @returns false if the slot is still occupied by an older frame
+    bool reserve(int64_t frameId) {
+        Slot& slot = slotFor(frameId);
+        if (slot.frameId >= 0) {
+            return false;
+        }
+        slot.frameId = frameId;
+        slot.ready = false;
+        slot.streamFrameId = -1;
+        return true;
+    }
+
+    /// Reserves slot for frameId of the stream, frames of the stream are numbered in the order of the reservation
+    /// @returns false if the slot is still occupied by an older frame
+    bool reserve(int64_t frameId, size_t streamId) {
+        if (!reserve(frameId)) {
+            return false;
+        }
+        Slot& slot = slotFor(frameId);
+        slot.streamId = streamId;
+        slot.streamFrameId = streams[streamId].reservedNum++;
+        return true;
+    }
+
+    /// Stores value of previously reserved frame
+    void put(int64_t frameId, T&& value) {
+        Slot& slot = slotFor(frameId);
+        if (slot.frameId != frameId || slot.ready) {
+            throw std::logic_error("Slot of reorder queue isn't reserved for the frame");
+        }
+        slot.value = std::move(value);
+        slot.ready = true;
+        ++readyCount;
+    }
+
+    /// @returns true if value of frameId is stored
+    bool isReady(int64_t frameId) const {
+        const Slot& slot = slotFor(frameId);
+        return slot.frameId == frameId && slot.ready;
+    }
+
+    /// @returns true if value of any frame is stored
+    bool isAnyReady() const {
+        return readyCount != 0;
+    }
+
+    /// @returns true if value of the oldest frame still in the queue of any stream is stored
+    bool isNextOfAnyStreamReady() const {
+        return findNextOfAnyStream(0) < slots.size();
+    }
+
+    /// Takes value of frameId out of the queue and releases its slot
+    /// @returns false if value of frameId isn't stored
+    bool take(int64_t frameId, T& value) {
+        if (!isReady(frameId)) {
+            return false;
+        }
+        release(slotFor(frameId), value);
+        return true;
+    }
+
+    /// Takes value of any frame out of the queue and releases its slot. Search starts from slot of firstFrameId.
+    /// @returns false if no value is stored
+    bool takeAny(int64_t firstFrameId, T& value) {
+        if (readyCount == 0) {
+            return false;
+        }
+        const size_t first = static_cast<size_t>(firstFrameId) % slots.size();
+        for (size_t i = 0; i < slots.size(); ++i) {
+            Slot& slot = slots[(first + i) % slots.size()];
+            if (slot.ready) {
+                release(slot, value);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Takes value of the oldest frame still in the queue of any stream, if it's stored, and releases its slot. Search
+    /// starts from slot of firstFrameId, so streams are served in turns.
+    /// @returns false if no such value is stored
+    bool takeNextOfAnyStream(int64_t firstFrameId, T& value) {
+        const size_t index = findNextOfAnyStream(static_cast<size_t>(firstFrameId) % slots.size());
+        if (index == slots.size()) {
+            return false;
+        }
+        Slot& slot = slots[index];
+        auto stream = streams.find(slot.streamId);
+        ++stream->second.takenNum;
+        if (stream->second.takenNum == stream->second.reservedNum) {
+            streams.erase(stream);  // the stream has no frames in the queue
+        }
+        release(slot, value);
+        return true;
+    }
+
+private:
+    struct Slot {
+        Slot() : frameId(-1), ready(false), streamId(0), streamFrameId(-1) {}
+
+        int64_t frameId;
+        bool ready;
+        size_t streamId;
+        int64_t streamFrameId;  // -1 if the frame doesn't belong to a stream
+        T value;
+    };
+
+    struct Stream {
+        int64_t reservedNum = 0;
+        int64_t takenNum = 0;
+    };
+
+    /// @returns index of the slot of the oldest frame of a stream if the value is stored, slots.size() otherwise
+    size_t findNextOfAnyStream(size_t first) const {
+        if (readyCount == 0) {
+            return slots.size();
+        }
+        for (size_t i = 0; i < slots.size(); ++i) {
+            const size_t index = (first + i) % slots.size();
+            const Slot& slot = slots[index];
+            if (slot.ready && slot.streamFrameId >= 0 && slot.streamFrameId == streams.at(slot.streamId).takenNum) {
+                return index;
+            }
+        }
+        return slots.size();
+    }
+
+    Slot& slotFor(int64_t frameId) {
+        return slots[static_cast<size_t>(frameId) % slots.size()];
+    }
+    const Slot& slotFor(int64_t frameId) const {
+        return slots[static_cast<size_t>(frameId) % slots.size()];
+    }
+
+    void release(Slot& slot, T& value) {
+        value = std::move(slot.value);
+        slot.value = T();
+        slot.frameId = -1;
+        slot.ready = false;
+        --readyCount;
+    }
+
+    std::vector<Slot> slots;
+    size_t readyCount;
+    /// Numbers of reserved and taken frames of streams having frames in the queue
+    std::map<size_t, Stream> streams;
+};
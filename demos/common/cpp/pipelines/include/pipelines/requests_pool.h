@@ -18,14 +18,15 @@
 
 #include <stddef.h>
 
-#include <mutex>
-#include <utility>
+#include <atomic>
+#include <memory>
 #include <vector>
 
 #include <openvino/openvino.hpp>
 
 /// This is class storing requests pool for asynchronous pipeline
-///
+/// Every request occupies a stable slot (its index in the pool). Indexes of idle slots are kept in a bounded lock-free
+/// queue, so both acquiring and releasing a request are O(1) and don't take any lock.
 class RequestsPool {
 public:
     RequestsPool(ov::CompiledModel& compiledModel, unsigned int size);
@@ -37,11 +38,22 @@ public:
     /// @returns pointer to request with idle state or nullptr if all requests are in use.
     ov::InferRequest getIdleRequest();
 
+    /// Same as getIdleRequest(), but also reports slot of returned request, which can be passed to
+    /// setRequestIdle(size_t) later to avoid searching for the request in the pool.
+    /// @param slot - receives slot of returned request. It is left unchanged if no idle request is available.
+    /// @returns idle request or empty request if all requests are in use.
+    ov::InferRequest getIdleRequest(size_t& slot);
+
     /// Sets particular request to Idle state
     /// This function is thread safe as long as request provided is not used after call to this function
     /// @param request - request to be returned to idle state
     void setRequestIdle(const ov::InferRequest& request);
 
+    /// Sets request occupying particular slot to Idle state
+    /// This function is thread safe as long as request provided is not used after call to this function
+    /// @param slot - slot of request to be returned to idle state, as reported by getIdleRequest(size_t&)
+    void setRequestIdle(size_t slot);
+
     /// Returns number of requests in use. This function is thread safe.
     /// @returns number of requests in use
     size_t getInUseRequestsCount();
@@ -60,8 +72,25 @@ public:
     /// @returns list of all infer requests in the pool.
     std::vector<ov::InferRequest> getInferRequestsList();
 
+    /// @returns bytes of input and output tensors of all infer requests in the pool
+    size_t getTensorsByteSize(const ov::CompiledModel& compiledModel);
+
 private:
-    std::vector<std::pair<ov::InferRequest, bool>> requests;
-    size_t numRequestsInUse;
-    std::mutex mtx;
+    struct IdleSlotCell {
+        std::atomic<size_t> sequence;
+        size_t slot;
+    };
+
+    // Bounded MPMC queue of idle slots (D. Vyukov's algorithm). Its capacity is never smaller than number of requests,
+    // so pushing a slot which was previously popped always succeeds.
+    bool pushIdleSlot(size_t slot);
+    bool popIdleSlot(size_t& slot);
+
+    std::vector<ov::InferRequest> requests;
+    std::unique_ptr<std::atomic<bool>[]> requestsInUse;
+    std::unique_ptr<IdleSlotCell[]> idleSlots;
+    size_t idleSlotsMask;
+    std::atomic<size_t> enqueuePos;
+    std::atomic<size_t> dequeuePos;
+    std::atomic<size_t> numRequestsInUse;
 };
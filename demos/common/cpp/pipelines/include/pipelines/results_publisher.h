@@ -0,0 +1,96 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+struct ResultBase;
+
+/// Object of a tracker output published by ResultsPublisher::publishTracks()
+struct TrackedBox {
+    int64_t trackId;
+    cv::Rect2f box;
+    unsigned int labelID;
+    float confidence;
+};
+
+/// Publishes results of frames to a downstream consumer in a compact binary format, so results are consumed without
+/// parsing the logs. publish() appends fixed-layout records to a batch buffer without allocations once the buffer has
+/// grown, the batches are written by a thread of the publisher, so a slow consumer doesn't slow down processing:
+/// records which don't fit into the capacity of the buffer are dropped and counted by getDroppedRecords().
+///
+/// The stream starts with the 8 bytes "OMZRES01", followed by records. Fields are in the byte order of the host,
+/// sizes are in bytes. A record starts with the 32 bytes header:
+///     uint32 size of the record including the header, uint16 type, uint16 flags (1 - the result is cached by the
+///     motion gate, 2 - the objects are propagated from a keyframe), int64 frame ID, int64 unix time in microseconds
+///     the result was published at, uint32 number of items, uint32 reserved
+/// followed by the items of the type:
+///     1 - detections, 24 bytes each: float x, y, width, height, float confidence, uint32 label ID
+///     2 - classifications, 8 bytes each: uint32 label ID, float score
+///     3 - poses: float score, uint32 number of keypoints N, N pairs of float x, y
+///     4 - tracks, 32 bytes each: int64 track ID, float x, y, width, height, float confidence, uint32 label ID
+/// Readers skip records of unknown types by their size. Labels aren't sent, consumers resolve label IDs by the label
+/// file of the model.
+class ResultsPublisher {
+public:
+    enum RecordType : uint16_t { Detections = 1, Classifications = 2, Poses = 3, Tracks = 4 };
+
+    /// @param destination - "<host>:<port>" of a TCP consumer or path to a file or a named pipe to append to
+    /// @param capacity - maximal size of the records waiting to be written
+    explicit ResultsPublisher(const std::string& destination, size_t capacity = 16 << 20);
+    /// Writes the remaining records
+    ~ResultsPublisher();
+    ResultsPublisher(const ResultsPublisher&) = delete;
+    ResultsPublisher& operator=(const ResultsPublisher&) = delete;
+
+    /// Appends a record of DetectionResult, ClassificationResult or HumanPoseResult, safe to be called concurrently
+    /// @throws std::invalid_argument for results of other types
+    void publish(const ResultBase& result);
+    /// Appends a record of the tracker output of the frame
+    void publishTracks(int64_t frameId, const std::vector<TrackedBox>& tracks);
+
+    /// @returns number of records dropped because the consumer was too slow or disconnected
+    uint64_t getDroppedRecords() const;
+
+private:
+    /// Reserves room for the record in the pending batch and writes its header, mtx should be locked
+    /// @returns memory of the items of the record or nullptr if the record is dropped
+    uint8_t* reserveRecord(RecordType type, uint16_t flags, int64_t frameId, uint32_t itemsNum, size_t itemsSize);
+    void sendingThreadFunc();
+    bool write(const uint8_t* data, size_t size);
+
+    std::FILE* file = nullptr;
+    int socketFd = -1;
+    const size_t capacity;
+    mutable std::mutex mtx;
+    std::condition_variable condVar;
+    std::vector<uint8_t> pendingBatch;
+    size_t pendingSize = 0;
+    uint64_t droppedRecords = 0;
+    bool isFailed = false;
+    bool isStopped = false;
+    std::thread sendingThread;
+};
@@ -0,0 +1,104 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+#include <stddef.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <openvino/openvino.hpp>
+
+#include <utils/config_factory.h>
+#include <utils/memory_accounting.hpp>
+
+#include "pipelines/requests_pool.h"
+
+class ModelBase;
+
+/// Defines infer requests of the pipelines built from a SharedCompiledModel
+enum class RequestsSharing {
+    Shared,      ///< all pipelines take requests from one pool, so requests are busy while any pipeline has frames
+    Partitioned  ///< every pipeline creates its own requests, so its throughput doesn't depend on the others
+};
+
+/// Model compiled once for several pipelines of the same network, e.g. one per group of cameras or with different
+/// postprocessing parameters, so its weights and compiled kernels are held once and it's compiled once. Every
+/// pipeline runs its own clone of the model wrapper (see ModelBase::clone()) for preprocessing and postprocessing.
+/// The shared compiled model is kept alive by the pipelines built from it.
+class SharedCompiledModel {
+public:
+    /// Compiles the model
+    /// @param modelInstance - the model, it's the prototype of the clones of the pipelines
+    /// @param config - fine tuning configuration for model
+    /// @param core - reference to ov::Core instance to use, it should outlive the pipelines
+    /// @param batchSize - batch size the model is reshaped to, pipelines should gather the same number of frames
+    SharedCompiledModel(std::unique_ptr<ModelBase>&& modelInstance,
+                        const ModelConfig& config,
+                        ov::Core& core,
+                        size_t batchSize = 1);
+    ~SharedCompiledModel();
+
+    /// @returns new clone of the model for a pipeline. Its postprocessing parameters may be changed before it's
+    /// passed to the pipeline.
+    std::unique_ptr<ModelBase> cloneModel() const;
+
+    const ModelBase& getModel() const {
+        return *model;
+    }
+    ov::CompiledModel& getCompiledModel() {
+        return compiledModel;
+    }
+    ov::Core& getCore() const {
+        return core;
+    }
+    /// @returns config the model was compiled with, it differs from the one passed to the constructor if it was tuned
+    const ModelConfig& getConfig() const {
+        return config;
+    }
+    size_t getBatchSize() const {
+        return batchSize;
+    }
+
+    /// @returns the pool of infer requests shared by pipelines. It's created, set up and warmed up by the first call.
+    /// @param nireq - number of requests, used by the first call only
+    std::shared_ptr<RequestsPool> getSharedRequests(unsigned int nireq);
+
+    /// Registers the function notified when a request of the shared pool becomes idle, so a pipeline waiting for a
+    /// request wakes up when another pipeline releases one. It's called by threads completing inferences.
+    /// @param owner - the pipeline, the function is called for requests released by other pipelines only
+    void addIdleListener(const void* owner, const std::function<void()>& listener);
+    void removeIdleListener(const void* owner);
+    /// Notifies listeners of other pipelines about a request released by the owner
+    void notifyRequestIdle(const void* owner);
+
+private:
+    std::unique_ptr<ModelBase> model;
+    ModelConfig config;
+    ov::Core& core;
+    size_t batchSize;
+    ov::CompiledModel compiledModel;
+
+    std::mutex requestsMtx;
+    std::shared_ptr<RequestsPool> sharedRequests;
+    /// input and output tensors of the shared infer requests, pipelines sharing them don't count them
+    MemoryCounter requestsMemory{"SharedCompiledModel.requests"};
+
+    std::mutex listenersMtx;
+    std::map<const void*, std::function<void()>> idleListeners;
+};
@@ -0,0 +1,106 @@
+/*
+// Copyright (C) 2020-2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <opencv2/core.hpp>
+#include <openvino/openvino.hpp>
+
+#include <models/model_base.h>
+
+struct InferenceResult;
+struct InputData;
+struct InternalModelData;
+
+/// Record of the tensor log: the tensors of one frame and the data needed to postprocess them
+struct TensorLogRecord {
+    int64_t frameId = -1;
+    std::shared_ptr<InternalModelData> internalModelData;
+    /// Input tensors of the frame, empty if the log was recorded without them
+    std::map<std::string, ov::Tensor> inputsData;
+    std::map<std::string, ov::Tensor> outputsData;
+    /// Image of ImageMetaData of the frame, empty if the log was recorded without frames
+    cv::Mat frame;
+};
+
+/// Writes the tensors of the frames processed by AsyncPipeline to a binary log, which is read by TensorLogReader.
+/// Only InternalImageModelData and InternalScaleData are stored, other internal model data are recorded as empty.
+class TensorRecorder {
+public:
+    /// @param path - path to the log file, it is overwritten
+    /// @param recordInputs - if true, input tensors are recorded besides the output ones
+    /// @param recordFrames - if true, images of ImageMetaData are recorded, so the frames can be rendered from the log
+    explicit TensorRecorder(const std::string& path, bool recordInputs = false, bool recordFrames = false);
+
+    bool recordsInputs() const {
+        return recordInputs;
+    }
+
+    /// Appends the result of the inference, safe to be called concurrently
+    /// @param result - result of the inference of the frame taken before postprocessing
+    /// @param inputsData - input tensors of the frame, not used if the inputs aren't recorded
+    void record(const InferenceResult& result, const std::map<std::string, ov::Tensor>& inputsData);
+
+private:
+    std::ofstream stream;
+    bool recordInputs;
+    bool recordFrames;
+    std::mutex mtx;
+};
+
+/// Reads the records of the log written by TensorRecorder one by one
+class TensorLogReader {
+public:
+    explicit TensorLogReader(const std::string& path);
+
+    /// @returns false if the log is over
+    bool read(TensorLogRecord& record);
+
+private:
+    std::ifstream stream;
+};
+
+/// Model serving the outputs recorded to a tensor log instead of running the inference, so the postprocessing and
+/// everything after it can be profiled and debugged on a machine without the device the log was recorded on.
+/// The wrapped model is compiled for CPU to set up its postprocessing, but it doesn't infer. A trivial network is
+/// inferred instead, so AsyncPipeline keeps its usual flow. Every submitted frame takes the next record of the log.
+/// Batch size of the pipeline should be 1, a batched log is replayed frame by frame.
+class ReplayModel : public ModelBase {
+public:
+    /// @param model - model the log was recorded with
+    /// @param logPath - path to the log written by TensorRecorder
+    ReplayModel(std::unique_ptr<ModelBase>&& model, const std::string& logPath);
+
+    /// Takes the next record of the log, throws if the log is over
+    std::shared_ptr<InternalModelData> preprocess(const InputData& inputData, ov::InferRequest& request) override;
+    ov::CompiledModel compileModel(const ModelConfig& config, ov::Core& core) override;
+    std::unique_ptr<ResultBase> postprocess(InferenceResult& infResult) override;
+
+protected:
+    void prepareInputsOutputs(std::shared_ptr<ov::Model>& model) override;
+
+    std::unique_ptr<ModelBase> model;
+    TensorLogReader reader;
+    std::mutex mtx;
+};
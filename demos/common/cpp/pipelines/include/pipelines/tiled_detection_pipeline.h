@@ -0,0 +1,117 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include <models/results.h>
+#include <utils/nms.hpp>
+
+#include "pipelines/async_pipeline.h"
+
+class ModelBase;
+struct InputData;
+struct MetaData;
+struct ModelConfig;
+
+/// Configuration of sliced detection
+struct TilingConfig {
+    /// @param tileSize - size of tiles, usually the input size of the model, so tiles aren't scaled
+    /// @param overlap - number of pixels shared by neighbour tiles, objects smaller than the overlap are seen whole by
+    /// at least one tile
+    /// @param addGlobalView - also detect on the whole downscaled frame, so objects larger than tiles are found
+    /// @param iouThreshold - threshold of class-aware NMS merging detections of all tiles
+    TilingConfig(const cv::Size& tileSize, int overlap = 0, bool addGlobalView = false, float iouThreshold = 0.5f)
+        : tileSize(tileSize),
+          overlap(overlap),
+          addGlobalView(addGlobalView),
+          iouThreshold(iouThreshold) {}
+
+    cv::Size tileSize;
+    int overlap;
+    bool addGlobalView;
+    float iouThreshold;
+};
+
+/// This is pipeline detecting objects on high resolution frames by overlapping tiles instead of the whole frame
+/// downscaled to the model input size, so small objects stay visible for the model. Tiles of a frame are inferred
+/// across all infer requests, or in batches if batching is configured. Detections of the tiles are moved to the frame
+/// coordinates and merged by class-aware NMS into one DetectionResult of the frame. Since it is AsyncPipeline itself,
+/// it can replace it in demos and be wrapped by other pipelines, e.g. KeyframePipeline.
+class TiledDetectionPipeline : public AsyncPipeline {
+public:
+    /// @param modelInstance - detection model, see AsyncPipeline::AsyncPipeline()
+    TiledDetectionPipeline(std::unique_ptr<ModelBase>&& modelInstance,
+                           const ModelConfig& config,
+                           ov::Core& core,
+                           const TilingConfig& tiling,
+                           const BatchingConfig& batching = BatchingConfig());
+    ~TiledDetectionPipeline() override;
+
+    /// @returns true if all tiles of previously submitted frames have been started and a request can take more
+    bool isReadyToProcess() override;
+
+    /// Waits until either the next frame is completely processed or more tiles can be submitted
+    void waitForData(bool shouldKeepOrder = true) override;
+
+    /// Waits for all tiles of submitted frames to be processed
+    void waitForTotalCompletion() override;
+
+    /// Splits the frame into tiles and submits as many of them as requests accept, the rest are submitted by
+    /// subsequent calls. The frame isn't copied, so it shouldn't be modified until its result is received.
+    /// @returns -1 if the frame can't be accepted (see isReadyToProcess()). Otherwise returns unique sequential frame
+    /// ID, it is written in the result structure.
+    int64_t submitData(const InputData& inputData, const std::shared_ptr<MetaData>& metaData) override;
+    int64_t submitData(const std::shared_ptr<InputData>& inputData, const std::shared_ptr<MetaData>& metaData) override;
+
+    /// @returns DetectionResult of the next frame in the submission order if all its tiles have been processed,
+    /// otherwise nullptr. Results are always in order.
+    std::unique_ptr<ResultBase> getResult(bool shouldKeepOrder = true) override;
+
+protected:
+    struct TiledFrame {
+        int64_t frameId;
+        cv::Mat image;
+        std::shared_ptr<MetaData> metaData;
+        std::vector<cv::Rect> tiles;
+        size_t submittedTiles;
+        size_t processedTiles;
+        /// Detections of processed tiles in frame coordinates
+        std::vector<DetectedObject> objects;
+        NmsBoxes boxes;
+        std::shared_ptr<const std::vector<std::string>> labels;
+    };
+
+    /// Submits pending tiles while requests accept them
+    void submitTiles();
+    /// Moves all available tiles results into their frames without blocking
+    void gatherTiles();
+    bool hasPendingTiles() const;
+    bool isFrontFrameReady() const;
+
+    TilingConfig tiling;
+    /// Frames which results haven't been taken out yet, in the submission order
+    std::deque<TiledFrame> frames;
+    int64_t tiledFrameId = 0;
+};
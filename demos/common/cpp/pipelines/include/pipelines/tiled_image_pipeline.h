@@ -0,0 +1,107 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include <models/results.h>
+
+#include "pipelines/async_pipeline.h"
+
+struct ImageInputData;
+struct MetaData;
+
+/// This is pipeline processing large images by fixed-size overlapping tiles with image-to-image models
+/// (SuperResolutionModel, DeblurringModel, JPEGRestorationModel). Tiles of an image are inferred in parallel by all
+/// infer requests of the underlying pipeline, their results are blended over the overlapping bands into ImageResult of
+/// the whole image. Memory used by the model is bounded by the tile size instead of the image size.
+class TiledImagePipeline {
+public:
+    /// @param pipeline - pipeline with the model created for tiles of tileSize. It should use Block or DropNewest
+    /// admission policy, so it never drops accepted tiles.
+    /// @param tileSize - size of tiles. Images which are smaller than the tile are processed as a single tile.
+    /// @param overlap - number of pixels shared by neighbour tiles, seams are blended over this band
+    TiledImagePipeline(std::unique_ptr<AsyncPipeline>&& pipeline, const cv::Size& tileSize, int overlap);
+    virtual ~TiledImagePipeline();
+
+    /// @returns true if all tiles of previously submitted images have been passed to the underlying pipeline and it
+    /// can accept more
+    bool isReadyToProcess();
+
+    /// Splits the image into tiles and submits as many of them as the underlying pipeline accepts, the rest are
+    /// submitted by subsequent calls of waitForData() and getResult(). The image isn't copied, tiles are read from its
+    /// memory, so it shouldn't be modified until its result is received.
+    /// @returns -1 if the image can't be accepted (see isReadyToProcess()). Otherwise returns unique sequential frame
+    /// ID, it is written in the result structure.
+    int64_t submitData(const ImageInputData& inputData, const std::shared_ptr<MetaData>& metaData);
+
+    /// Waits until either a tile result becomes available or the underlying pipeline allows to submit more tiles.
+    void waitForData();
+
+    /// @returns ImageResult of the next image in the submission order, if all its tiles have been processed.
+    /// Otherwise returns nullptr.
+    std::unique_ptr<ResultBase> getResult();
+
+    /// Waits for all tiles of submitted images to be processed.
+    void waitForTotalCompletion();
+
+    /// Gives access to the underlying pipeline, e.g. to its performance metrics
+    AsyncPipeline& getTilesPipeline() {
+        return *pipeline;
+    }
+
+    /// Splits the image into tiles of tileSize (or less if the image is smaller) overlapping by at least overlap
+    /// pixels. Tiles at the right and bottom borders are shifted inwards, so all tiles have the same size.
+    static std::vector<cv::Rect> splitIntoTiles(const cv::Size& imageSize, const cv::Size& tileSize, int overlap);
+
+protected:
+    struct TiledImage {
+        int64_t frameId;
+        cv::Mat image;
+        std::shared_ptr<MetaData> metaData;
+        std::vector<cv::Rect> tiles;
+        size_t submittedTiles;
+        size_t processedTiles;
+        /// Result of the only tile, if the image isn't split
+        cv::Mat resultImage;
+        /// Weighted sum of tiles results and sum of their weights
+        cv::Mat accumulator;
+        cv::Mat weights;
+    };
+
+    /// Submits pending tiles while the underlying pipeline accepts them
+    void submitTiles();
+    /// Blends all available tiles results into their images without blocking
+    void gatherTiles();
+    /// Adds result of the next unprocessed tile to its image
+    void blendTile(const cv::Mat& tileResult);
+    bool hasPendingTiles() const;
+
+    std::unique_ptr<AsyncPipeline> pipeline;
+    cv::Size tileSize;
+    int overlap;
+    /// Images which results haven't been taken out yet, in the submission order
+    std::deque<TiledImage> images;
+
+    int64_t inputFrameId = 0;
+};
@@ -18,6 +18,8 @@
 
 #include <chrono>
 #include <cstdint>
+#include <cstring>
+#include <iomanip>
 #include <map>
 #include <memory>
 #include <stdexcept>
@@ -26,25 +28,168 @@
 #include <vector>
 
 #include <openvino/openvino.hpp>
+#include <openvino/runtime/intel_gpu/properties.hpp>
 
+#include <models/input_data.h>
 #include <models/model_base.h>
 #include <models/results.h>
 #include <utils/config_factory.h>
+#include <utils/image_utils.h>
+#include <utils/itt.hpp>
+#include <utils/metrics_sink.hpp>
 #include <utils/performance_metrics.hpp>
+#include <utils/remote_inference.hpp>
 #include <utils/slog.hpp>
 
+#include "pipelines/metadata.h"
+#include "pipelines/tensor_log.h"
+
 struct InputData;
-struct MetaData;
 
-AsyncPipeline::AsyncPipeline(std::unique_ptr<ModelBase>&& modelInstance, const ModelConfig& config, ov::Core& core)
-    : model(std::move(modelInstance)) {
-    compiledModel = model->compileModel(config, core);
+namespace {
+// Makes a tensor sharing memory with the slot of batched tensor
+ov::Tensor getBatchItemTensor(const ov::Tensor& tensor, size_t batchIdx, size_t batchSize) {
+    ov::Shape shape = tensor.get_shape();
+    if (shape.empty() || shape[0] != batchSize) {
+        throw std::runtime_error("Batched inference requires batch to be the first dimension of every model output");
+    }
+    shape[0] = 1;
+    const size_t itemByteSize = tensor.get_byte_size() / batchSize;
+    return ov::Tensor(tensor.get_element_type(), shape, static_cast<uint8_t*>(tensor.data()) + batchIdx * itemByteSize);
+}
+
+/// @returns true if the frame expected to be inferred by completion misses its deadline
+bool missesDeadline(const std::shared_ptr<MetaData>& metaData, std::chrono::steady_clock::time_point completion) {
+    return metaData && metaData->deadline < completion;
+}
+
+/// @returns true if the frame of metaData a should be started before the one of b
+bool isMoreUrgent(const std::shared_ptr<MetaData>& a, const std::shared_ptr<MetaData>& b) {
+    const int priorityA = a ? a->priority : 0;
+    const int priorityB = b ? b->priority : 0;
+    if (priorityA != priorityB) {
+        return priorityA > priorityB;
+    }
+    const auto noDeadline = std::chrono::steady_clock::time_point::max();
+    return (a ? a->deadline : noDeadline) < (b ? b->deadline : noDeadline);
+}
+
+/// Checks the queue for the next result: of frame outputFrameId, of any stream or any result
+template <class T>
+bool isNextReady(const ReorderQueue<T>& queue, int64_t outputFrameId, bool shouldKeepOrder, bool perStreamOrder) {
+    if (!shouldKeepOrder) {
+        return queue.isAnyReady();
+    }
+    return perStreamOrder ? queue.isNextOfAnyStreamReady() : queue.isReady(outputFrameId);
+}
+
+template <class T>
+bool takeNext(ReorderQueue<T>& queue, int64_t outputFrameId, bool shouldKeepOrder, bool perStreamOrder, T& value) {
+    if (!shouldKeepOrder) {
+        return queue.takeAny(outputFrameId, value);
+    }
+    return perStreamOrder ? queue.takeNextOfAnyStream(outputFrameId, value) : queue.take(outputFrameId, value);
+}
+}  // namespace
+
+AsyncPipeline::AsyncPipeline(std::unique_ptr<ModelBase>&& modelInstance,
+                             const ModelConfig& config,
+                             ov::Core& core,
+                             const BatchingConfig& batching)
+    : batchingConfig(batching),
+      core(core),
+      modelConfig(config) {
+    if (batchingConfig.batchSize == 0) {
+        throw std::invalid_argument("Batch size should be positive");
+    }
+    if (modelConfig.profiledLayers > 0) {
+        modelConfig.compiledModelConfig[ov::enable_profiling.name()] = true;
+    }
+    if (batchingConfig.batchSize > 1) {
+        pendingBatch.reserve(batchingConfig.batchSize);
+    }
+    activeModel = loadModel(std::move(modelInstance), 0);
+    initialize();
+}
+
+AsyncPipeline::AsyncPipeline(const std::shared_ptr<SharedCompiledModel>& sharedModel,
+                             RequestsSharing sharing,
+                             std::unique_ptr<ModelBase>&& modelInstance,
+                             unsigned int nireq,
+                             std::chrono::microseconds batchTimeout)
+    : batchingConfig(sharedModel->getBatchSize(), batchTimeout),
+      core(sharedModel->getCore()),
+      modelConfig(sharedModel->getConfig()) {
+    if (!modelInstance) {
+        modelInstance = sharedModel->cloneModel();
+    } else if (modelInstance->getSharedOutputsNames() != sharedModel->getModel().getSharedOutputsNames()) {
+        // Clones share the outputs names of the prototype
+        throw std::invalid_argument("The model should be a clone of the shared model");
+    }
+    if (batchingConfig.batchSize > 1) {
+        pendingBatch.reserve(batchingConfig.batchSize);
+    }
+    std::shared_ptr<LoadedModel> loaded = std::make_shared<LoadedModel>();
+    loaded->model = std::move(modelInstance);
+    loaded->compiledModel = sharedModel->getCompiledModel();
+    loaded->sharedModel = sharedModel;
+    setUpRequests(*loaded, nireq, sharing == RequestsSharing::Shared);
+    activeModel = loaded;
+    if (activeModel->sharesRequests) {
+        // Threads submitting data to this pipeline may wait for requests released by other pipelines. Notifying
+        // under the lock, the notification isn't missed by a thread which has checked the requests and is about
+        // to wait.
+        sharedModel->addIdleListener(this, [this]() {
+            const std::lock_guard<std::mutex> lock(mtx);
+            condVar.notify_all();
+        });
+    }
+    initialize();
+}
+
+void AsyncPipeline::initialize() {
+    requestsNum = static_cast<unsigned int>(activeModel->requestsPool->getInferRequestsList().size());
+    updateMemoryUsage(*activeModel);
+    if (activeModel->layersProfile) {
+        profiledLayersNum = modelConfig.profiledLayers > 0 ? modelConfig.profiledLayers : 10;
+    }
+    // Room for results of all frames in flight and the same number of results waiting to be taken by getResult()
+    const size_t reorderQueueCapacity = 2 * requestsNum * batchingConfig.batchSize;
+    completedInferenceResults = ReorderQueue<InferenceResult>(reorderQueueCapacity);
+    postprocessedResults = ReorderQueue<std::unique_ptr<ResultBase>>(reorderQueueCapacity);
+    submitTimes.resize(reorderQueueCapacity);
+    frameModels.resize(reorderQueueCapacity);
+}
+
+std::shared_ptr<AsyncPipeline::LoadedModel> AsyncPipeline::loadModel(std::unique_ptr<ModelBase>&& modelInstance,
+                                                                     unsigned int nireq) {
+    std::shared_ptr<LoadedModel> loaded = std::make_shared<LoadedModel>();
+    loaded->model = std::move(modelInstance);
+    ModelBase& model = *loaded->model;
+    model.setBatch(batchingConfig.batchSize);
+    loaded->compiledModel = model.compileModel(modelConfig, core);
+    setUpRequests(*loaded, nireq, false);
+    return loaded;
+}
+
+void AsyncPipeline::setUpRequests(LoadedModel& loaded, unsigned int nireq, bool shareRequests) {
+    ModelBase& model = *loaded.model;
+    loaded.outputsNames = model.getSharedOutputsNames();
+    for (const std::string& outName : *loaded.outputsNames) {
+        loaded.outputs.push_back(loaded.compiledModel.output(outName));
+    }
     // --------------------------- Create infer requests ------------------------------------------------
-    unsigned int nireq = config.maxAsyncRequests;
+    const std::shared_ptr<RemoteInferenceClient>& remoteClient = model.getRemoteClient();
     if (nireq == 0) {
+        nireq = model.getConfig().maxAsyncRequests;
+    }
+    if (nireq == 0 && remoteClient) {
+        // +1 covers sending inputs and receiving outputs besides the requests inferred by the worker
+        nireq = remoteClient->getOptimalRequestsNum() + 1;
+    } else if (nireq == 0) {
         try {
             // +1 to use it as a buffer of the pipeline
-            nireq = compiledModel.get_property(ov::optimal_number_of_infer_requests) + 1;
+            nireq = loaded.compiledModel.get_property(ov::optimal_number_of_infer_requests) + 1;
         } catch (const ov::Exception& ex) {
             throw std::runtime_error(
                 std::string("Every device used with the demo should support compiled model's property "
@@ -52,23 +197,456 @@ AsyncPipeline::AsyncPipeline(std::unique_ptr<ModelBase>&& modelInstance, const M
                 ex.what());
         }
     }
-    slog::info << "\tNumber of inference requests: " << nireq << slog::endl;
-    requestsPool.reset(new RequestsPool(compiledModel, nireq));
+    auto startTime = std::chrono::steady_clock::now();
+    if (shareRequests) {
+        // Requests of the pool are set up and warmed up by the shared model once, when the first pipeline takes it
+        loaded.requestsPool = loaded.sharedModel->getSharedRequests(nireq);
+        loaded.sharesRequests = true;
+        slog::info << "\tNumber of shared inference requests: " << loaded.requestsPool->getInferRequestsList().size()
+                   << slog::endl;
+    } else {
+        slog::info << "\tNumber of inference requests: " << nireq << slog::endl;
+        loaded.requestsPool = std::make_shared<RequestsPool>(loaded.compiledModel, nireq);
+    }
+    if (batchingConfig.batchSize > 1) {
+        slog::info << "\tBatch size: " << batchingConfig.batchSize << slog::endl;
+    }
+    // Profiling may also be enabled by the compiled model config, then the default number of layers is reported
+    bool isProfilingEnabled = false;
+    try {
+        isProfilingEnabled = loaded.compiledModel.get_property(ov::enable_profiling);
+    } catch (const ov::Exception&) {
+        // the device doesn't report the property, so the profiling is off
+    }
+    if (isProfilingEnabled) {
+        loaded.layersProfile.reset(new LayersProfile(loaded.compiledModel));
+    }
+    PerformanceMetrics::Ms requestsCreationTime = std::chrono::steady_clock::now() - startTime;
+    slog::info << "\tInfer requests creation: " << std::fixed << std::setprecision(1) << requestsCreationTime.count()
+               << " ms" << slog::endl;
+    if (shareRequests) {
+        return;
+    }
     // --------------------------- Call onLoadCompleted to complete initialization of model -------------
-    model->onLoadCompleted(requestsPool->getInferRequestsList());
+    model.onLoadCompleted(loaded.requestsPool->getInferRequestsList());
+    // Warm-up inferences don't go through the pipeline, so they aren't counted by its metrics. Requests of the proxy
+    // of a remote model can't be inferred locally, the worker warms up on the first frames.
+    if (!remoteClient) {
+        model.warmUp(loaded.requestsPool->getInferRequestsList(), model.getConfig().warmupInferences);
+    }
+}
+
+void AsyncPipeline::updateMemoryUsage(const LoadedModel& loaded) {
+    // Shared requests are counted once, by the shared model
+    requestsMemory.set(loaded.sharesRequests ? 0 : loaded.requestsPool->getTensorsByteSize(loaded.compiledModel));
+
+    size_t deviceBytes = 0;
+    ModelConfig config = loaded.model->getConfig();
+    if (loaded.model->getRemoteClient()) {
+        // devices of the worker aren't visible to the local core
+        deviceMemory.set(deviceBytes);
+        return;
+    }
+    for (const std::string& device : config.getDevices()) {
+        if (device.find("GPU") != 0) {
+            continue;
+        }
+        try {
+            for (const auto& allocation : core.get_property(device, ov::intel_gpu::memory_statistics)) {
+                deviceBytes += static_cast<size_t>(allocation.second);
+            }
+        } catch (const ov::Exception&) {
+            // older plugins don't report the statistics
+        }
+    }
+    deviceMemory.set(deviceBytes);
+}
+
+void AsyncPipeline::swapModel(std::unique_ptr<ModelBase>&& modelInstance) {
+    if (modelSwapping) {
+        throw std::logic_error("The previous model swap isn't completed");
+    }
+    if (activeModel->sharesRequests) {
+        throw std::logic_error("Model of a pipeline sharing infer requests with other pipelines can't be swapped");
+    }
+    if (swapThread.joinable()) {
+        swapThread.join();
+    }
+    {
+        const std::lock_guard<std::mutex> lock(mtx);
+        swapException = nullptr;
+    }
+    modelSwapping = true;
+    // The thread owns the model, it's passed by raw pointer, as lambdas of C++11 can't capture by move
+    swapThread = std::thread(&AsyncPipeline::swapModelThreadFunc, this, modelInstance.release());
+}
+
+void AsyncPipeline::swapModelThreadFunc(ModelBase* modelInstance) {
+    std::unique_ptr<ModelBase> model(modelInstance);
+    try {
+        slog::info << "Loading the model to swap to" << slog::endl;
+        activateModel(loadModel(std::move(model), requestsNum));
+    } catch (...) {
+        const std::lock_guard<std::mutex> lock(mtx);
+        swapException = std::current_exception();
+    }
+    modelSwapping = false;
+    releaseRetiredModels();
+}
+
+void AsyncPipeline::activateModel(const std::shared_ptr<LoadedModel>& loaded) {
+    // Requests of the active model are in flight, so only the ones of the new model are counted
+    updateMemoryUsage(*loaded);
+    {
+        const std::lock_guard<std::mutex> submitLock(submitMtx);
+        // Frames of the partially filled batch are preprocessed into the request of the previous model
+        flushPendingBatch();
+        // The motion gate reference is inferred by the previous model, its outputs can't be reused by the new one
+        gateThumbnail.release();
+        skippedFramesInRow = 0;
+        {
+            const std::lock_guard<std::mutex> lock(mtx);
+            retiredModels.push_back(std::move(activeModel));
+            hasRetiredModels = true;
+            activeModel = loaded;
+            gateFrameId = -1;
+            cachedResult = InferenceResult();
+            cachedResultModel.reset();
+        }
+    }
+    // Submitting threads may wait for idle requests, the new model has all of them idle
+    condVar.notify_all();
+    slog::info << "Frames are submitted to the swapped model" << slog::endl;
+}
+
+void AsyncPipeline::waitForModelSwap() {
+    if (swapThread.joinable()) {
+        swapThread.join();
+    }
+    std::exception_ptr exception;
+    {
+        const std::lock_guard<std::mutex> lock(mtx);
+        std::swap(exception, swapException);
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+void AsyncPipeline::releaseRetiredModels() {
+    std::vector<std::shared_ptr<LoadedModel>> released;
+    {
+        const std::lock_guard<std::mutex> lock(mtx);
+        for (auto it = retiredModels.begin(); it != retiredModels.end();) {
+            // Only the list refers to the model if no result of it waits for postprocessing. New references aren't
+            // made once the model is retired and has no requests in use.
+            if ((*it)->getRequestsInUse() == 0 && it->use_count() == 1) {
+                released.push_back(std::move(*it));
+                it = retiredModels.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        hasRetiredModels = !retiredModels.empty();
+    }
+    for (const std::shared_ptr<LoadedModel>& loaded : released) {
+        // Requests are marked idle by their callbacks, which may still be returning
+        for (ov::InferRequest request : loaded->requestsPool->getInferRequestsList()) {
+            request.wait();
+        }
+        slog::info << "The swapped out model is released" << slog::endl;
+    }
+}
+
+std::shared_ptr<AsyncPipeline::LoadedModel> AsyncPipeline::takeFrameModel(int64_t frameId) {
+    std::shared_ptr<LoadedModel> loaded;
+    std::swap(loaded, frameModels[static_cast<size_t>(frameId) % frameModels.size()]);
+    return loaded;
 }
 
 AsyncPipeline::~AsyncPipeline() {
+    if (swapThread.joinable()) {
+        swapThread.join();
+    }
     waitForTotalCompletion();
+    stopPostprocessingThreads();
+    if (activeModel && activeModel->sharesRequests) {
+        activeModel->sharedModel->removeIdleListener(this);
+    }
+}
+
+void AsyncPipeline::waitForTotalCompletion() {
+    if (activeModel) {
+        {
+            const std::lock_guard<std::mutex> submitLock(submitMtx);
+            while (!pendingFrames.empty()) {
+                waitForIdleRequest();
+                startPendingFrames();
+            }
+            flushPendingBatch();
+        }
+        std::vector<std::shared_ptr<LoadedModel>> models;
+        {
+            const std::lock_guard<std::mutex> lock(mtx);
+            models = retiredModels;
+            models.push_back(activeModel);
+        }
+        for (const std::shared_ptr<LoadedModel>& loaded : models) {
+            if (loaded->model->getRemoteClient()) {
+                loaded->model->getRemoteClient()->waitForTotalCompletion();
+            }
+            if (loaded->sharesRequests) {
+                // Other pipelines keep using the requests, only the ones started by this pipeline are waited for
+                std::unique_lock<std::mutex> lock(mtx);
+                condVar.wait(lock, [&]() {
+                    return loaded->requestsInFlight == 0;
+                });
+            } else {
+                loaded->requestsPool->waitForTotalCompletion();
+            }
+        }
+    }
+    if (!postprocessingThreads.empty()) {
+        std::unique_lock<std::mutex> lock(mtx);
+        condVar.wait(lock, [&]() {
+            return callbackException != nullptr ||
+                   (postprocessingInFlight == 0 && !isDelivering && !canDeliverResults());
+        });
+    }
+    if (hasRetiredModels) {
+        releaseRetiredModels();
+    }
+}
+
+void AsyncPipeline::setPostprocessingThreads(size_t threadsNum) {
+    if (inputFrameId != 0) {
+        throw std::logic_error("Postprocessing threads should be set before any data is submitted");
+    }
+    if (resultCallback && threadsNum == 0) {
+        throw std::logic_error("Results are delivered to the result callback by postprocessing threads");
+    }
+    stopPostprocessingThreads();
+    stopPostprocessing = false;
+    for (size_t i = 0; i < threadsNum; ++i) {
+        postprocessingThreads.emplace_back(&AsyncPipeline::postprocessingThreadFunc, this);
+    }
+}
+
+void AsyncPipeline::setConcurrentPreprocessing(bool concurrent) {
+    if (inputFrameId != 0) {
+        throw std::logic_error("Concurrent preprocessing should be set before any data is submitted");
+    }
+    concurrentPreprocessing = concurrent;
+}
+
+void AsyncPipeline::setResultCallback(const ResultCallback& callback, bool shouldKeepOrder) {
+    if (inputFrameId != 0) {
+        throw std::logic_error("Result callback should be set before any data is submitted");
+    }
+    {
+        const std::lock_guard<std::mutex> lock(mtx);
+        resultCallback = callback;
+        callbackKeepsOrder = shouldKeepOrder;
+    }
+    if (resultCallback && postprocessingThreads.empty()) {
+        setPostprocessingThreads(1);
+    }
+}
+
+void AsyncPipeline::setPerStreamOrder(bool perStream) {
+    if (inputFrameId != 0) {
+        throw std::logic_error("Per-stream order should be set before any data is submitted");
+    }
+    if (perStream && motionGate.threshold > 0) {
+        throw std::logic_error("Motion gate isn't supported with per-stream order");
+    }
+    perStreamOrder = perStream;
+}
+
+std::map<size_t, PerformanceMetrics> AsyncPipeline::getStreamsMetrics() {
+    const std::lock_guard<std::mutex> lock(mtx);
+    return streamsMetrics;
+}
+
+void AsyncPipeline::registerStreamResult(const ResultBase& result) {
+    if (perStreamOrder) {
+        const size_t streamId = result.metaData ? result.metaData->streamId : 0;
+        streamsMetrics[streamId].update(submitTimes[static_cast<size_t>(result.frameId) % submitTimes.size()]);
+    }
+}
+
+void AsyncPipeline::setRecorder(const std::shared_ptr<TensorRecorder>& recorder) {
+    if (inputFrameId != 0) {
+        throw std::logic_error("Recorder should be set before any data is submitted");
+    }
+    this->recorder = recorder;
+}
+
+void AsyncPipeline::setMotionGate(const MotionGateConfig& gate) {
+    if (inputFrameId != 0) {
+        throw std::logic_error("Motion gate should be set before any data is submitted");
+    }
+    if (gate.threshold < 0) {
+        throw std::invalid_argument("Motion gate threshold should be non-negative");
+    }
+    if (gate.threshold > 0 && perStreamOrder) {
+        throw std::logic_error("Motion gate isn't supported with per-stream order");
+    }
+    motionGate = gate;
+}
+
+void AsyncPipeline::reportMetrics(MetricsSink& sink) {
+    // Pending frames and batch are guarded by the submission lock, inference and pool postprocessing metrics are
+    // updated by callbacks and threads of the pool under the lock
+    const std::lock_guard<std::mutex> submitLock(submitMtx);
+    const std::lock_guard<std::mutex> lock(mtx);
+    // Requests of models replaced by swapModel() are still in use until their frames are inferred
+    size_t requestsInUse = activeModel->getRequestsInUse();
+    for (const std::shared_ptr<LoadedModel>& loaded : retiredModels) {
+        requestsInUse += loaded->getRequestsInUse();
+    }
+    sink.stage("preprocessing", preprocessMetrics.getLast())
+        .value("pending_frames", static_cast<double>(pendingFrames.size()))
+        .value("pending_batch_frames", static_cast<double>(pendingBatch.size()))
+        .value("requests_in_use", static_cast<double>(requestsInUse));
+    sink.stage("inference", inferenceMetrics.getLast())
+        .stage("postprocessing", postprocessMetrics.getLast())
+        .value("postprocessing_queue", static_cast<double>(postprocessingQueue.size() + postprocessingInFlight));
+    if (const LayersProfile* layersProfile = activeModel->layersProfile.get()) {
+        // Layers are taken first, so their times don't include inferences which aren't counted
+        const std::vector<LayersProfile::Layer> top = layersProfile->getTop(profiledLayersNum);
+        const size_t inferencesNum = layersProfile->getInferencesNum();
+        for (const LayersProfile::Layer& layer : top) {
+            sink.value("layer_ms." + layer.name, layer.totalTime.count() / 1000.0 / inferencesNum);
+        }
+    }
+}
+
+void AsyncPipeline::logLayersProfile() const {
+    if (const LayersProfile* layersProfile = getLayersProfile()) {
+        layersProfile->logTop(profiledLayersNum);
+    }
+}
+
+void AsyncPipeline::stopPostprocessingThreads() {
+    {
+        const std::lock_guard<std::mutex> lock(mtx);
+        stopPostprocessing = true;
+    }
+    postprocessingCondVar.notify_all();
+    for (auto& thread : postprocessingThreads) {
+        thread.join();
+    }
+    postprocessingThreads.clear();
+}
+
+void AsyncPipeline::postprocessingThreadFunc() {
+    std::unique_lock<std::mutex> lock(mtx);
+    for (;;) {
+        postprocessingCondVar.wait(lock, [&]() {
+            return stopPostprocessing || !postprocessingQueue.empty() || canDeliverResults();
+        });
+        if (stopPostprocessing) {
+            return;
+        }
+        if (postprocessingQueue.empty()) {
+            deliverResults(lock);
+            continue;
+        }
+        InferenceResult infResult = std::move(postprocessingQueue.front());
+        postprocessingQueue.pop_front();
+        std::shared_ptr<LoadedModel> loaded = takeFrameModel(infResult.frameId);
+        lock.unlock();
+
+        std::unique_ptr<ResultBase> result;
+        std::exception_ptr postprocessingException = nullptr;
+        auto startTime = std::chrono::steady_clock::now();
+        try {
+            ITT_SCOPED_FRAME_TASK("ModelBase::postprocess", infResult.frameId);
+            result = loaded->model->postprocess(infResult);
+            *result = static_cast<ResultBase&>(infResult);
+        } catch (...) {
+            postprocessingException = std::current_exception();
+        }
+        loaded.reset();
+        if (hasRetiredModels) {
+            releaseRetiredModels();
+        }
+
+        lock.lock();
+        postprocessMetrics.update(startTime);
+        if (postprocessingException) {
+            if (!callbackException) {
+                callbackException = postprocessingException;
+            }
+        } else {
+            postprocessedResults.put(infResult.frameId, std::move(result));
+        }
+        --postprocessingInFlight;
+        condVar.notify_all();
+        if (canDeliverResults()) {
+            deliverResults(lock);
+        }
+    }
+}
+
+bool AsyncPipeline::canDeliverResults() const {
+    return resultCallback && !isDelivering && !callbackException &&
+           isNextReady(postprocessedResults, outputFrameId, callbackKeepsOrder, perStreamOrder);
+}
+
+void AsyncPipeline::deliverResults(std::unique_lock<std::mutex>& lock) {
+    isDelivering = true;
+    while (!callbackException) {
+        std::unique_ptr<ResultBase> result;
+        const bool isTaken = takeNext(postprocessedResults, outputFrameId, callbackKeepsOrder, perStreamOrder, result);
+        if (!isTaken) {
+            break;
+        }
+        if (!result) {
+            // The frame was dropped by admission policy, skip it
+            if (callbackKeepsOrder && !perStreamOrder) {
+                advanceOutputFrameId(outputFrameId);
+            }
+            continue;
+        }
+        advanceOutputFrameId(result->frameId);
+        registerStreamResult(*result);
+        // Slot of the result is released, so a frame waiting for the reorder queue can be submitted
+        condVar.notify_all();
+
+        lock.unlock();
+        std::exception_ptr deliveryException = nullptr;
+        try {
+            resultCallback(std::move(result));
+        } catch (...) {
+            deliveryException = std::current_exception();
+        }
+        lock.lock();
+        if (deliveryException && !callbackException) {
+            callbackException = deliveryException;
+        }
+    }
+    isDelivering = false;
+    condVar.notify_all();
+}
+
+bool AsyncPipeline::isResultReady(bool shouldKeepOrder) const {
+    if (resultCallback) {
+        return false;  // results are delivered to the callback
+    }
+    if (!postprocessingThreads.empty()) {
+        return isNextReady(postprocessedResults, outputFrameId, shouldKeepOrder, perStreamOrder);
+    }
+    return isNextReady(completedInferenceResults, outputFrameId, shouldKeepOrder, perStreamOrder);
 }
 
 void AsyncPipeline::waitForData(bool shouldKeepOrder) {
     std::unique_lock<std::mutex> lock(mtx);
 
     condVar.wait(lock, [&]() {
-        return callbackException != nullptr || requestsPool->isIdleRequestAvailable() ||
-               (shouldKeepOrder ? completedInferenceResults.find(outputFrameId) != completedInferenceResults.end()
-                                : !completedInferenceResults.empty());
+        // Overrides may submit data, so they can't be called under the lock
+        return callbackException != nullptr || AsyncPipeline::isReadyToProcess() || isResultReady(shouldKeepOrder);
     });
 
     if (callbackException) {
@@ -76,92 +654,568 @@ void AsyncPipeline::waitForData(bool shouldKeepOrder) {
     }
 }
 
+void AsyncPipeline::setAdmissionPolicy(AdmissionPolicy policy, size_t maxPendingFrames) {
+    if (maxPendingFrames == 0) {
+        throw std::invalid_argument("At least one frame should be allowed to wait for infer request");
+    }
+    admissionPolicy = policy;
+    this->maxPendingFrames = policy == AdmissionPolicy::LatestOnly ? 1 : maxPendingFrames;
+}
+
+void AsyncPipeline::setDropCallback(const DropCallback& callback) {
+    if (inputFrameId != 0) {
+        throw std::logic_error("Drop callback should be set before any data is submitted");
+    }
+    dropCallback = callback;
+}
+
 int64_t AsyncPipeline::submitData(const InputData& inputData, const std::shared_ptr<MetaData>& metaData) {
-    auto frameID = inputFrameId;
+    if (admissionPolicy == AdmissionPolicy::DropOldestPending || admissionPolicy == AdmissionPolicy::LatestOnly ||
+        admissionPolicy == AdmissionPolicy::EarliestDeadline) {
+        throw std::logic_error("Admission policy requires input data to be submitted by shared pointer");
+    }
+    const cv::Mat thumbnail = makeGateThumbnail(inputData);
+    std::unique_lock<std::mutex> submitLock(submitMtx);
+    const int64_t cachedFrameId = submitCachedResult(thumbnail, metaData);
+    if (cachedFrameId >= 0) {
+        return cachedFrameId;
+    }
+    if (admissionPolicy == AdmissionPolicy::Block) {
+        // Pipelines sharing the infer requests may take the idle one first, then the wait is repeated
+        do {
+            waitForIdleRequest();
+        } while (!isOutputQueueFull() && !takeIdleRequest());
+    }
+    if (isOutputQueueFull() || !takeIdleRequest()) {
+        preprocessMetrics.registerDroppedFrame();
+        return -1;
+    }
+
+    auto frameID = reserveFrameId(metaData);
+    if (concurrentPreprocessing && batchingConfig.batchSize == 1) {
+        // The gate reference is set first, as the submission lock is released for preprocessing
+        setGateReference(frameID, thumbnail);
+        startFrameConcurrently(submitLock, frameID, inputData, metaData);
+        return frameID;
+    }
+    startFrame(frameID, inputData, metaData);
+    setGateReference(frameID, thumbnail);
+    return frameID;
+}
+
+int64_t AsyncPipeline::submitData(const std::shared_ptr<InputData>& inputData,
+                                  const std::shared_ptr<MetaData>& metaData) {
+    if (admissionPolicy == AdmissionPolicy::Block || admissionPolicy == AdmissionPolicy::DropNewest) {
+        return submitData(*inputData, metaData);
+    }
 
-    auto request = requestsPool->getIdleRequest();
-    if (!request) {
+    const cv::Mat thumbnail = makeGateThumbnail(*inputData);
+    const std::lock_guard<std::mutex> submitLock(submitMtx);
+    startPendingFrames();
+    const int64_t cachedFrameId = submitCachedResult(thumbnail, metaData);
+    if (cachedFrameId >= 0) {
+        return cachedFrameId;
+    }
+    if (isOutputQueueFull() ||
+        (admissionPolicy == AdmissionPolicy::EarliestDeadline && missesDeadline(metaData, getExpectedCompletion()))) {
+        preprocessMetrics.registerDroppedFrame();
         return -1;
     }
 
+    auto frameID = reserveFrameId(metaData);
+    if (pendingFrames.empty() && takeIdleRequest()) {
+        startFrame(frameID, *inputData, metaData);
+        setGateReference(frameID, thumbnail);
+        return frameID;
+    }
+
+    if (pendingFrames.size() >= maxPendingFrames) {
+        auto droppedFrame = pendingFrames.begin();
+        if (admissionPolicy == AdmissionPolicy::EarliestDeadline) {
+            for (auto it = pendingFrames.begin(); it != pendingFrames.end(); ++it) {
+                if (!isMoreUrgent(it->metaData, droppedFrame->metaData)) {
+                    droppedFrame = it;  // the latest of equally urgent frames is dropped
+                }
+            }
+            if (!isMoreUrgent(metaData, droppedFrame->metaData)) {
+                dropFrame(frameID, metaData);
+                return frameID;
+            }
+        }
+        dropFrame(droppedFrame->frameId, droppedFrame->metaData);
+        pendingFrames.erase(droppedFrame);
+    }
+    PendingFrame frame = {frameID, inputData, metaData, thumbnail};
+    pendingFrames.push_back(frame);
+    return frameID;
+}
+
+int64_t AsyncPipeline::reserveFrameId(const std::shared_ptr<MetaData>& metaData) {
+    const int64_t frameID = inputFrameId;
+    {
+        const std::lock_guard<std::mutex> lock(mtx);
+        if (perStreamOrder) {
+            const size_t streamId = metaData ? metaData->streamId : 0;
+            if (postprocessingThreads.empty()) {
+                completedInferenceResults.reserve(frameID, streamId);
+            } else {
+                postprocessedResults.reserve(frameID, streamId);
+            }
+            submitTimes[static_cast<size_t>(frameID) % submitTimes.size()] = std::chrono::steady_clock::now();
+        } else if (postprocessingThreads.empty()) {
+            completedInferenceResults.reserve(frameID);
+        } else {
+            postprocessedResults.reserve(frameID);
+        }
+    }
+
+    inputFrameId++;
+    if (inputFrameId < 0)
+        inputFrameId = 0;
+
+    return frameID;
+}
+
+bool AsyncPipeline::takeIdleRequest() {
+    if (!pendingRequest) {
+        pendingRequest = activeModel->requestsPool->getIdleRequest(pendingRequestSlot);
+    }
+    return static_cast<bool>(pendingRequest);
+}
+
+void AsyncPipeline::startFrame(int64_t frameId, const InputData& inputData, const std::shared_ptr<MetaData>& metaData) {
+    ModelBase& model = *activeModel->model;
+    if (!takeIdleRequest()) {
+        throw std::logic_error("No idle infer request to start the frame");
+    }
+
     auto startTime = std::chrono::steady_clock::now();
-    auto internalModelData = model->preprocess(inputData, request);
+    std::shared_ptr<InternalModelData> internalModelData;
+    try {
+        ITT_SCOPED_FRAME_TASK("ModelBase::preprocess", frameId);
+        internalModelData = model.preprocessBatchItem(inputData, pendingRequest, pendingBatch.size());
+    } catch (...) {
+        if (pendingBatch.empty()) {
+            // The request isn't used by any frame, so it's returned for the next one
+            activeModel->requestsPool->setRequestIdle(pendingRequestSlot);
+            pendingRequest = ov::InferRequest();
+        }
+        throw;
+    }
     preprocessMetrics.update(startTime);
 
-    request.set_callback(
-        [this, request, frameID, internalModelData, metaData, startTime](std::exception_ptr ex) mutable {
-            {
-                const std::lock_guard<std::mutex> lock(mtx);
-                inferenceMetrics.update(startTime);
-                try {
-                    if (ex) {
-                        std::rethrow_exception(ex);
-                    }
+    if (pendingBatch.empty()) {
+        pendingBatchDeadline = startTime + batchingConfig.timeout;
+    }
+    PendingBatchItem item = {frameId, internalModelData, metaData, startTime};
+    {
+        const std::lock_guard<std::mutex> lock(mtx);
+        pendingBatch.push_back(item);
+    }
+
+    if (pendingBatch.size() == batchingConfig.batchSize ||
+        (batchingConfig.timeout != std::chrono::microseconds::zero() &&
+         std::chrono::steady_clock::now() >= pendingBatchDeadline)) {
+        flushPendingBatch();
+    }
+}
+
+void AsyncPipeline::startFrameConcurrently(std::unique_lock<std::mutex>& submitLock,
+                                           int64_t frameId,
+                                           const InputData& inputData,
+                                           const std::shared_ptr<MetaData>& metaData) {
+    // The model isn't released while its request is in use, even if it's swapped while the frame is preprocessed
+    LoadedModel& loaded = *activeModel;
+    if (!takeIdleRequest()) {
+        throw std::logic_error("No idle infer request to start the frame");
+    }
+    ov::InferRequest request = pendingRequest;
+    const size_t requestSlot = pendingRequestSlot;
+    pendingRequest = ov::InferRequest();
+    submitLock.unlock();
+
+    auto startTime = std::chrono::steady_clock::now();
+    std::shared_ptr<InternalModelData> internalModelData;
+    try {
+        ITT_SCOPED_FRAME_TASK("ModelBase::preprocess", frameId);
+        internalModelData = loaded.model->preprocessBatchItem(inputData, request, 0);
+    } catch (...) {
+        loaded.requestsPool->setRequestIdle(requestSlot);
+        submitLock.lock();
+        dropFrame(frameId, metaData);
+        throw;
+    }
+    submitLock.lock();
+    preprocessMetrics.update(startTime);
+    submitLock.unlock();
+
+    const std::vector<PendingBatchItem> items = {{frameId, internalModelData, metaData, startTime}};
+    startRequest(loaded, request, requestSlot, items);
+}
+
+void AsyncPipeline::startPendingFrames() {
+    if (admissionPolicy == AdmissionPolicy::EarliestDeadline && !pendingFrames.empty()) {
+        dropLateFrames();
+    }
+    while (!pendingFrames.empty() && takeIdleRequest()) {
+        auto nextFrame = findNextPendingFrame();
+        PendingFrame frame = std::move(*nextFrame);
+        pendingFrames.erase(nextFrame);
+        startFrame(frame.frameId, *frame.inputData, frame.metaData);
+        setGateReference(frame.frameId, frame.gateThumbnail);
+    }
+}
+
+std::chrono::steady_clock::time_point AsyncPipeline::getExpectedCompletion() {
+    const std::lock_guard<std::mutex> lock(mtx);
+    return std::chrono::steady_clock::now() + expectedLatency;
+}
+
+void AsyncPipeline::dropLateFrames() {
+    const auto completion = getExpectedCompletion();
+    for (auto it = pendingFrames.begin(); it != pendingFrames.end();) {
+        if (missesDeadline(it->metaData, completion)) {
+            dropFrame(it->frameId, it->metaData);
+            it = pendingFrames.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+std::deque<AsyncPipeline::PendingFrame>::iterator AsyncPipeline::findNextPendingFrame() {
+    auto nextFrame = pendingFrames.begin();
+    if (admissionPolicy != AdmissionPolicy::EarliestDeadline) {
+        return nextFrame;
+    }
+    for (auto it = pendingFrames.begin(); it != pendingFrames.end(); ++it) {
+        if (isMoreUrgent(it->metaData, nextFrame->metaData)) {
+            nextFrame = it;
+        }
+    }
+    return nextFrame;
+}
+
+cv::Mat AsyncPipeline::makeGateThumbnail(const InputData& inputData) const {
+    if (motionGate.threshold <= 0) {
+        return cv::Mat();
+    }
+    const auto* imageData = dynamic_cast<const ImageInputData*>(&inputData);
+    return imageData ? makeMotionThumbnail(imageData->inputImage) : cv::Mat();
+}
+
+int64_t AsyncPipeline::submitCachedResult(const cv::Mat& thumbnail, const std::shared_ptr<MetaData>& metaData) {
+    if (thumbnail.empty() || gateThumbnail.empty() || skippedFramesInRow >= motionGate.maxSkippedFrames ||
+        isOutputQueueFull() || getMotion(thumbnail, gateThumbnail) >= motionGate.threshold) {
+        return -1;
+    }
+    InferenceResult result;
+    std::shared_ptr<LoadedModel> resultModel;
+    {
+        const std::lock_guard<std::mutex> lock(mtx);
+        // The reference frame is still being inferred, its result can't be reused yet
+        if (cachedResult.IsEmpty() || cachedResult.frameId != gateFrameId) {
+            return -1;
+        }
+        result = cachedResult;
+        resultModel = cachedResultModel;
+    }
+    const int64_t frameId = reserveFrameId(metaData);
+    result.frameId = frameId;
+    result.metaData = metaData;
+    result.isCached = true;
+    ++skippedFramesInRow;
+    preprocessMetrics.registerSkippedFrame();
+    {
+        const std::lock_guard<std::mutex> lock(mtx);
+        frameModels[static_cast<size_t>(frameId) % frameModels.size()] = std::move(resultModel);
+        if (postprocessingThreads.empty()) {
+            completedInferenceResults.put(result.frameId, std::move(result));
+        } else {
+            postprocessingQueue.push_back(std::move(result));
+            ++postprocessingInFlight;
+            postprocessingCondVar.notify_one();
+        }
+    }
+    condVar.notify_one();
+    return frameId;
+}
+
+void AsyncPipeline::setGateReference(int64_t frameId, const cv::Mat& thumbnail) {
+    if (thumbnail.empty()) {
+        return;
+    }
+    gateThumbnail = thumbnail;
+    skippedFramesInRow = 0;
+    const std::lock_guard<std::mutex> lock(mtx);
+    gateFrameId = frameId;
+}
+
+void AsyncPipeline::dropFrame(int64_t frameId, const std::shared_ptr<MetaData>& metaData) {
+    preprocessMetrics.registerDroppedFrame();
+    if (dropCallback) {
+        dropCallback(frameId, metaData);
+    }
+    const std::lock_guard<std::mutex> lock(mtx);
+    // Empty value marks dropped frame
+    if (postprocessingThreads.empty()) {
+        completedInferenceResults.put(frameId, InferenceResult());
+    } else {
+        postprocessedResults.put(frameId, std::unique_ptr<ResultBase>());
+        if (canDeliverResults()) {
+            // Results of next frames may wait for the dropped one
+            postprocessingCondVar.notify_one();
+        }
+    }
+}
+
+void AsyncPipeline::waitForIdleRequest() {
+    std::unique_lock<std::mutex> lock(mtx);
+    condVar.wait(lock, [&]() {
+        return callbackException != nullptr || canStartFrame();
+    });
+    if (callbackException) {
+        std::rethrow_exception(callbackException);
+    }
+}
+
+void AsyncPipeline::flushBatch() {
+    const std::lock_guard<std::mutex> submitLock(submitMtx);
+    flushPendingBatch();
+}
+
+void AsyncPipeline::flushPendingBatch() {
+    if (pendingBatch.empty()) {
+        return;
+    }
+    startRequest(*activeModel, pendingRequest, pendingRequestSlot, pendingBatch);
+    {
+        const std::lock_guard<std::mutex> lock(mtx);
+        pendingBatch.clear();
+    }
+    pendingRequest = ov::InferRequest();
+}
+
+void AsyncPipeline::startRequest(LoadedModel& loaded,
+                                 ov::InferRequest& request,
+                                 size_t requestSlot,
+                                 const std::vector<PendingBatchItem>& items) {
+    const size_t batchSize = batchingConfig.batchSize;
+    // The model is captured by pointer, as it owns the request. It outlives the callback: retired models are released
+    // only once their requests complete.
+    LoadedModel* loadedModel = &loaded;
+    // The shared model owns the requests, so the request keeps it by weak pointer to avoid a reference cycle
+    std::weak_ptr<SharedCompiledModel> weakSharedModel;
+    if (loaded.sharesRequests) {
+        weakSharedModel = loaded.sharedModel;
+    }
+    std::function<void(std::exception_ptr)> callback = [this, loadedModel, request, requestSlot, items, batchSize,
+                                                        weakSharedModel](std::exception_ptr ex) mutable {
+        ITT_END_FRAME_TASK(this, items.front().frameId);
+        // The pipeline sharing the requests may be destroyed as soon as the request is counted as completed, but
+        // other pipelines are notified afterwards
+        const std::shared_ptr<SharedCompiledModel> sharedModel = weakSharedModel.lock();
+        const std::vector<ov::Output<const ov::Node>>& outputs = loadedModel->outputs;
+        if (loadedModel->layersProfile && !ex) {
+            // Profiling info of the request is overwritten by its next inference, so it's taken right away
+            loadedModel->layersProfile->add(request);
+        }
+        {
+            const std::lock_guard<std::mutex> lock(mtx);
+            for (const auto& item : items) {
+                inferenceMetrics.update(item.startTime);
+            }
+            const auto latency = std::chrono::steady_clock::now() - items.front().startTime;
+            expectedLatency = expectedLatency == std::chrono::steady_clock::duration::zero()
+                                  ? latency
+                                  : expectedLatency + (latency - expectedLatency) / 8;
+            try {
+                if (ex) {
+                    std::rethrow_exception(ex);
+                }
+                for (size_t batchIdx = 0; batchIdx < items.size(); ++batchIdx) {
                     InferenceResult result;
 
-                    result.frameId = frameID;
-                    result.metaData = std::move(metaData);
-                    result.internalModelData = std::move(internalModelData);
+                    result.frameId = items[batchIdx].frameId;
+                    result.metaData = std::move(items[batchIdx].metaData);
+                    result.internalModelData = std::move(items[batchIdx].internalModelData);
 
-                    for (const auto& outName : model->getOutputsNames()) {
-                        auto tensor = request.get_tensor(outName);
-                        result.outputsData.emplace(outName, tensor);
+                    result.outputsData = OutputsData(loadedModel->outputsNames);
+                    for (size_t outIdx = 0; outIdx < outputs.size(); ++outIdx) {
+                        ov::Tensor tensor = request.get_tensor(outputs[outIdx]);
+                        result.outputsData[outIdx] =
+                            batchSize > 1 ? getBatchItemTensor(tensor, batchIdx, batchSize) : tensor;
+                    }
+                    if (recorder) {
+                        std::map<std::string, ov::Tensor> inputsData;
+                        if (recorder->recordsInputs()) {
+                            for (const auto& inName : loadedModel->model->getInputsNames()) {
+                                auto tensor = request.get_tensor(inName);
+                                inputsData.emplace(inName,
+                                                   batchSize > 1 ? getBatchItemTensor(tensor, batchIdx, batchSize)
+                                                                 : tensor);
+                            }
+                        }
+                        recorder->record(result, inputsData);
+                    }
+
+                    if (result.frameId == gateFrameId) {
+                        // Tensors of the request are overwritten by next frames, so the cached ones are copies
+                        cachedResult = result;
+                        cachedResult.metaData = nullptr;
+                        cachedResult.outputsData = OutputsData(loadedModel->outputsNames);
+                        for (size_t outIdx = 0; outIdx < outputs.size(); ++outIdx) {
+                            const ov::Tensor& tensor = result.outputsData[outIdx];
+                            ov::Tensor copy(tensor.get_element_type(), tensor.get_shape());
+                            std::memcpy(copy.data(), tensor.data(), tensor.get_byte_size());
+                            cachedResult.outputsData[outIdx] = copy;
+                        }
+                        cachedResultModel = loadedModel->shared_from_this();
                     }
 
-                    completedInferenceResults.emplace(frameID, result);
-                    requestsPool->setRequestIdle(request);
-                } catch (...) {
-                    if (!callbackException) {
-                        callbackException = std::current_exception();
+                    const size_t slot = static_cast<size_t>(result.frameId) % frameModels.size();
+                    frameModels[slot] = loadedModel->shared_from_this();
+
+                    if (postprocessingThreads.empty()) {
+                        completedInferenceResults.put(result.frameId, std::move(result));
+                    } else {
+                        postprocessingQueue.push_back(result);
+                        ++postprocessingInFlight;
+                        postprocessingCondVar.notify_one();
                     }
                 }
+                loadedModel->requestsPool->setRequestIdle(requestSlot);
+            } catch (...) {
+                if (!callbackException) {
+                    callbackException = std::current_exception();
+                }
+            }
+            --loadedModel->requestsInFlight;
+            if (sharedModel) {
+                condVar.notify_all();
             }
+        }
+        if (sharedModel) {
+            // Only the key of the pipeline is used, it isn't accessed after the lock is released
+            sharedModel->notifyRequestIdle(this);
+        } else {
             condVar.notify_one();
-        });
-
-    inputFrameId++;
-    if (inputFrameId < 0)
-        inputFrameId = 0;
-
-    request.start_async();
+        }
+    };
 
-    return frameID;
+    // the task spans the inference of the whole batch, it is identified by the first frame
+    ITT_BEGIN_FRAME_TASK("AsyncPipeline::infer", this, items.front().frameId);
+    ++loaded.requestsInFlight;
+    if (loaded.model->getRemoteClient()) {
+        loaded.model->getRemoteClient()->startAsync(request, callback);
+    } else {
+        request.set_callback(callback);
+        request.start_async();
+    }
 }
 
 std::unique_ptr<ResultBase> AsyncPipeline::getResult(bool shouldKeepOrder) {
-    auto infResult = AsyncPipeline::getInferenceResult(shouldKeepOrder);
+    if (resultCallback) {
+        throw std::logic_error("Results are delivered to the result callback");
+    }
+    {
+        const std::lock_guard<std::mutex> submitLock(submitMtx);
+        if (!pendingBatch.empty() && batchingConfig.timeout != std::chrono::microseconds::zero() &&
+            std::chrono::steady_clock::now() >= pendingBatchDeadline) {
+            flushPendingBatch();
+        }
+        startPendingFrames();
+    }
+    if (!postprocessingThreads.empty()) {
+        return getPostprocessedResult(shouldKeepOrder);
+    }
+    std::shared_ptr<LoadedModel> loaded;
+    auto infResult = AsyncPipeline::getInferenceResult(shouldKeepOrder, loaded);
     if (infResult.IsEmpty()) {
         return std::unique_ptr<ResultBase>();
     }
     auto startTime = std::chrono::steady_clock::now();
-    auto result = model->postprocess(infResult);
+    std::unique_ptr<ResultBase> result;
+    {
+        ITT_SCOPED_FRAME_TASK("ModelBase::postprocess", infResult.frameId);
+        result = loaded->model->postprocess(infResult);
+    }
     postprocessMetrics.update(startTime);
+    loaded.reset();
+    if (hasRetiredModels) {
+        releaseRetiredModels();
+    }
 
     *result = static_cast<ResultBase&>(infResult);
+    if (perStreamOrder) {
+        const std::lock_guard<std::mutex> lock(mtx);
+        registerStreamResult(*result);
+    }
     return result;
 }
 
-InferenceResult AsyncPipeline::getInferenceResult(bool shouldKeepOrder) {
-    InferenceResult retVal;
-    {
-        const std::lock_guard<std::mutex> lock(mtx);
+InferenceResult AsyncPipeline::getInferenceResult(bool shouldKeepOrder, std::shared_ptr<LoadedModel>& loadedModel) {
+    for (;;) {
+        InferenceResult retVal;
+        bool isTaken;
+        {
+            const std::lock_guard<std::mutex> lock(mtx);
 
-        const auto& it =
-            shouldKeepOrder ? completedInferenceResults.find(outputFrameId) : completedInferenceResults.begin();
+            isTaken = takeNext(completedInferenceResults, outputFrameId, shouldKeepOrder, perStreamOrder, retVal);
+            if (isTaken && !retVal.IsEmpty()) {
+                // The slot is taken under the same lock, as it's reused by the next frame once the result is taken
+                loadedModel = takeFrameModel(retVal.frameId);
+            }
+        }
+        if (!isTaken) {
+            return InferenceResult();
+        }
 
-        if (it != completedInferenceResults.end()) {
-            retVal = std::move(it->second);
-            completedInferenceResults.erase(it);
+        if (!retVal.IsEmpty()) {
+            advanceOutputFrameId(retVal.frameId);
+            return retVal;
+        }
+        // The frame was dropped by admission policy, skip it
+        if (shouldKeepOrder && !perStreamOrder) {
+            advanceOutputFrameId(outputFrameId);
         }
     }
+}
+
+std::unique_ptr<ResultBase> AsyncPipeline::getPostprocessedResult(bool shouldKeepOrder) {
+    for (;;) {
+        std::unique_ptr<ResultBase> retVal;
+        bool isTaken;
+        {
+            const std::lock_guard<std::mutex> lock(mtx);
+            if (callbackException) {
+                std::rethrow_exception(callbackException);
+            }
+
+            isTaken = takeNext(postprocessedResults, outputFrameId, shouldKeepOrder, perStreamOrder, retVal);
+            if (isTaken && retVal) {
+                registerStreamResult(*retVal);
+            }
+        }
+        if (!isTaken) {
+            return std::unique_ptr<ResultBase>();
+        }
 
-    if (!retVal.IsEmpty()) {
-        outputFrameId = retVal.frameId;
-        outputFrameId++;
-        if (outputFrameId < 0) {
-            outputFrameId = 0;
+        if (retVal) {
+            advanceOutputFrameId(retVal->frameId);
+            return retVal;
+        }
+        // The frame was dropped by admission policy, skip it
+        if (shouldKeepOrder && !perStreamOrder) {
+            advanceOutputFrameId(outputFrameId);
         }
     }
+}
 
-    return retVal;
+void AsyncPipeline::advanceOutputFrameId(int64_t frameId) {
+    outputFrameId = frameId;
+    outputFrameId++;
+    if (outputFrameId < 0) {
+        outputFrameId = 0;
+    }
 }
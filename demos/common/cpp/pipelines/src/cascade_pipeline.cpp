@@ -0,0 +1,154 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "pipelines/cascade_pipeline.h"
+
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include <models/input_data.h>
+#include <models/results.h>
+
+#include "pipelines/metadata.h"
+
+CascadePipeline::CascadePipeline(std::unique_ptr<AsyncPipeline>&& primaryPipeline)
+    : primary(std::move(primaryPipeline)) {}
+
+CascadePipeline::~CascadePipeline() {
+    waitForTotalCompletion();
+}
+
+void CascadePipeline::addStage(std::unique_ptr<AsyncPipeline>&& pipeline, const FanOut& fanOut) {
+    if (submittedFramesCount != 0) {
+        throw std::logic_error("Stages should be added before any data is submitted");
+    }
+    stages.emplace_back();
+    stages.back().pipeline = std::move(pipeline);
+    stages.back().fanOut = fanOut;
+}
+
+int64_t CascadePipeline::submitData(const InputData& inputData, const std::shared_ptr<MetaData>& metaData) {
+    int64_t frameId = primary->submitData(inputData, metaData);
+    if (frameId >= 0) {
+        ++submittedFramesCount;
+    }
+    return frameId;
+}
+
+void CascadePipeline::pump() {
+    while (std::unique_ptr<ResultBase> primaryResult = primary->getResult()) {
+        FrameState& frame = frames[primaryResult->frameId];
+        frame.result.reset(new CascadeResult(primaryResult->frameId, primaryResult->metaData));
+        frame.result->stageResults.resize(stages.size());
+        for (size_t stageIdx = 0; stageIdx < stages.size(); ++stageIdx) {
+            Stage& stage = stages[stageIdx];
+            std::vector<std::shared_ptr<InputData>> inputs = stage.fanOut(*primaryResult);
+            frame.result->stageResults[stageIdx].resize(inputs.size());
+            for (size_t inputIdx = 0; inputIdx < inputs.size(); ++inputIdx) {
+                if (!inputs[inputIdx]) {
+                    continue;
+                }
+                ++frame.remaining;
+                stage.queuedInputs.emplace_back(
+                    std::move(inputs[inputIdx]),
+                    std::make_shared<CascadeMetaData>(primaryResult->frameId, inputIdx));
+            }
+        }
+        frame.result->primaryResult = std::move(primaryResult);
+    }
+
+    for (size_t stageIdx = 0; stageIdx < stages.size(); ++stageIdx) {
+        Stage& stage = stages[stageIdx];
+        while (!stage.queuedInputs.empty() && stage.pipeline->isReadyToProcess()) {
+            const auto& input = stage.queuedInputs.front();
+            if (stage.pipeline->submitData(*input.first, input.second) < 0) {
+                break;
+            }
+            stage.queuedInputs.pop_front();
+            ++stage.inFlight;
+        }
+
+        while (std::unique_ptr<ResultBase> stageResult = stage.pipeline->getResult(false)) {
+            --stage.inFlight;
+            const auto& routing = stageResult->metaData->asRef<CascadeMetaData>();
+            auto frameIt = frames.find(routing.parentFrameId);
+            if (frameIt == frames.end()) {
+                throw std::logic_error("Result of secondary stage doesn't belong to any frame");
+            }
+            frameIt->second.result->stageResults[stageIdx][routing.inputIdx] = std::move(stageResult);
+            --frameIt->second.remaining;
+        }
+    }
+}
+
+void CascadePipeline::waitForData() {
+    pump();
+    if (!frames.empty() && frames.begin()->second.remaining == 0) {
+        return;
+    }
+    for (auto& stage : stages) {
+        if (!stage.queuedInputs.empty() || stage.inFlight != 0) {
+            stage.pipeline->waitForData(false);
+            return;
+        }
+    }
+    primary->waitForData();
+}
+
+std::unique_ptr<ResultBase> CascadePipeline::getResult() {
+    pump();
+    if (frames.empty() || frames.begin()->second.remaining != 0) {
+        return std::unique_ptr<ResultBase>();
+    }
+    std::unique_ptr<ResultBase> result = std::move(frames.begin()->second.result);
+    frames.erase(frames.begin());
+    return result;
+}
+
+void CascadePipeline::waitForTotalCompletion() {
+    if (!primary) {
+        return;
+    }
+    primary->waitForTotalCompletion();
+    pump();
+    for (auto& stage : stages) {
+        while (!stage.queuedInputs.empty()) {
+            stage.pipeline->waitForData(false);
+            pump();
+        }
+        stage.pipeline->waitForTotalCompletion();
+    }
+    pump();
+}
+
+std::vector<std::shared_ptr<InputData>> CascadePipeline::cropDetections(const ResultBase& result) {
+    const auto& detections = result.asRef<DetectionResult>();
+    const cv::Mat& frame = detections.metaData->asRef<ImageMetaData>().img;
+    const cv::Rect frameRect(0, 0, frame.cols, frame.rows);
+
+    std::vector<std::shared_ptr<InputData>> crops(detections.objects.size());
+    for (size_t i = 0; i < detections.objects.size(); ++i) {
+        cv::Rect roi = cv::Rect(detections.objects[i]) & frameRect;
+        if (roi.area() > 0) {
+            crops[i] = std::make_shared<ImageInputData>(frame(roi));
+        }
+    }
+    return crops;
+}
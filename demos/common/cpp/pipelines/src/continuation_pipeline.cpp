@@ -0,0 +1,122 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "pipelines/continuation_pipeline.h"
+
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <models/input_data.h>
+#include <models/results.h>
+
+#include "pipelines/metadata.h"
+
+ContinuationPipeline::ContinuationMetaData::ContinuationMetaData(const std::shared_ptr<MetaData>& userMetaData,
+                                                                 const Continuation& then)
+    : userMetaData(userMetaData),
+      then(then) {
+    // Admission policies and per-stream order look at the metadata the pipeline gets
+    if (userMetaData) {
+        streamId = userMetaData->streamId;
+        priority = userMetaData->priority;
+        deadline = userMetaData->deadline;
+    }
+}
+
+ContinuationPipeline::ContinuationPipeline(std::unique_ptr<AsyncPipeline>&& asyncPipeline)
+    : pipeline(std::move(asyncPipeline)) {
+    // Continuations are carried by metadata of the frames rather than looked up by frame IDs, so a result delivered
+    // before submitData() returns its frame ID still finds its continuation
+    pipeline->setResultCallback(
+        [this](std::unique_ptr<ResultBase> result) {
+            deliver(std::move(result));
+        },
+        false);
+    pipeline->setDropCallback([this](int64_t, const std::shared_ptr<MetaData>& metaData) {
+        drop(metaData);
+    });
+}
+
+int64_t ContinuationPipeline::infer(const std::shared_ptr<InputData>& inputData,
+                                    const std::shared_ptr<MetaData>& metaData,
+                                    const Continuation& then) {
+    if (!then) {
+        throw std::invalid_argument("Continuation of the frame is empty");
+    }
+    ++pendingFramesNum;
+    const int64_t frameId = pipeline->submitData(inputData, std::make_shared<ContinuationMetaData>(metaData, then));
+    if (frameId < 0) {
+        --pendingFramesNum;
+        then(std::unique_ptr<ResultBase>());
+    }
+    return frameId;
+}
+
+void ContinuationPipeline::deliver(std::unique_ptr<ResultBase> result) {
+    const std::shared_ptr<MetaData> metaData = std::move(result->metaData);
+    ContinuationMetaData& continuation = metaData->asRef<ContinuationMetaData>();
+    result->metaData = continuation.userMetaData;
+    --pendingFramesNum;
+    continuation.then(std::move(result));
+}
+
+void ContinuationPipeline::drop(const std::shared_ptr<MetaData>& metaData) {
+    --pendingFramesNum;
+    metaData->asRef<ContinuationMetaData>().then(std::unique_ptr<ResultBase>());
+}
+
+void ContinuationPipeline::waitForTotalCompletion() {
+    pipeline->waitForTotalCompletion();
+    // Returns at once when the pipeline is idle, rethrows an exception which stopped the delivery
+    pipeline->waitForData(false);
+}
+
+std::shared_ptr<ResultsJoin> ResultsJoin::create(size_t resultsNum, const Continuation& then) {
+    if (resultsNum == 0) {
+        then(std::vector<std::unique_ptr<ResultBase>>());
+    }
+    return std::shared_ptr<ResultsJoin>(new ResultsJoin(resultsNum, then));
+}
+
+ResultsJoin::ResultsJoin(size_t resultsNum, const Continuation& then)
+    : results(resultsNum),
+      remaining(resultsNum),
+      then(then) {}
+
+ContinuationPipeline::Continuation ResultsJoin::slot(size_t idx) {
+    if (idx >= results.size()) {
+        throw std::out_of_range("Slot index exceeds the number of joined results");
+    }
+    std::shared_ptr<ResultsJoin> self = shared_from_this();
+    return [self, idx](std::unique_ptr<ResultBase> result) {
+        self->put(idx, std::move(result));
+    };
+}
+
+void ResultsJoin::put(size_t idx, std::unique_ptr<ResultBase> result) {
+    std::vector<std::unique_ptr<ResultBase>> gathered;
+    {
+        const std::lock_guard<std::mutex> lock(mtx);
+        results[idx] = std::move(result);
+        if (--remaining != 0) {
+            return;
+        }
+        gathered = std::move(results);
+    }
+    then(std::move(gathered));
+}
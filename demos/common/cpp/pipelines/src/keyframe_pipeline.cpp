@@ -0,0 +1,189 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "pipelines/keyframe_pipeline.h"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include <models/input_data.h>
+#include <models/results.h>
+#include <utils/image_utils.h>
+
+namespace {
+// Objects of consecutive keyframes overlapping less are considered different
+constexpr float minMatchIou = 0.3f;
+
+float iou(const cv::Rect2f& a, const cv::Rect2f& b) {
+    const float intersection = (a & b).area();
+    const float unionArea = a.area() + b.area() - intersection;
+    return unionArea > 0 ? intersection / unionArea : 0;
+}
+
+cv::Point2f center(const cv::Rect2f& rect) {
+    return {rect.x + rect.width / 2, rect.y + rect.height / 2};
+}
+}  // namespace
+
+KeyframePipeline::KeyframePipeline(std::unique_ptr<AsyncPipeline>&& pipeline, const KeyframeConfig& config)
+    : pipeline(std::move(pipeline)),
+      config(config),
+      maxQueuedFrames(2 * (this->pipeline->getRequestsNum() + config.maxInterval)) {
+    if (config.maxInterval == 0) {
+        throw std::invalid_argument("Keyframe interval should be positive");
+    }
+    if (config.motionBudget < 0) {
+        throw std::invalid_argument("Motion budget of keyframes should be non-negative");
+    }
+}
+
+KeyframePipeline::~KeyframePipeline() {
+    waitForTotalCompletion();
+}
+
+bool KeyframePipeline::isReadyToProcess() {
+    gatherResults();
+    return frames.size() < maxQueuedFrames && pipeline->isReadyToProcess();
+}
+
+int64_t KeyframePipeline::submitData(const ImageInputData& inputData, const std::shared_ptr<MetaData>& metaData) {
+    if (!isReadyToProcess()) {
+        return -1;
+    }
+    // The state is updated only after the frame is accepted
+    cv::Mat thumbnail;
+    double motion = 0;
+    if (config.maxInterval > 1 && config.motionBudget > 0) {
+        thumbnail = makeMotionThumbnail(inputData.inputImage);
+        motion = prevThumbnail.empty() ? 0 : getMotion(thumbnail, prevThumbnail);
+    }
+    const bool isKeyframe = inputFrameId == 0 || framesSinceKeyframe + 1 >= config.maxInterval ||
+                            (config.motionBudget > 0 && accumulatedMotion + motion >= config.motionBudget);
+    if (isKeyframe && pipeline->submitData(inputData, metaData) < 0) {
+        return -1;
+    }
+
+    prevThumbnail = thumbnail;
+    if (isKeyframe) {
+        accumulatedMotion = 0;
+        framesSinceKeyframe = 0;
+        ++keyframesNum;
+    } else {
+        accumulatedMotion += motion;
+        ++framesSinceKeyframe;
+    }
+    frames.push_back({inputFrameId, metaData, isKeyframe, nullptr});
+    return inputFrameId++;
+}
+
+void KeyframePipeline::waitForData() {
+    gatherResults();
+    if (!frames.empty() && (!frames.front().isKeyframe || frames.front().result)) {
+        return;
+    }
+    pipeline->waitForData();
+}
+
+std::unique_ptr<ResultBase> KeyframePipeline::getResult() {
+    gatherResults();
+    if (frames.empty()) {
+        return nullptr;
+    }
+    Frame& frame = frames.front();
+    std::unique_ptr<ResultBase> result;
+    if (frame.isKeyframe) {
+        if (!frame.result) {
+            return nullptr;
+        }
+        result = std::move(frame.result);
+        result->frameId = frame.frameId;
+        updateTracks(frame.frameId, result->asRef<DetectionResult>());
+    } else {
+        result = propagate(frame.frameId, frame.metaData);
+    }
+    frames.pop_front();
+    return result;
+}
+
+void KeyframePipeline::waitForTotalCompletion() {
+    pipeline->waitForTotalCompletion();
+    gatherResults();
+}
+
+void KeyframePipeline::gatherResults() {
+    while (std::unique_ptr<ResultBase> result = pipeline->getResult()) {
+        // Results of keyframes come in the submission order
+        auto frameIt = std::find_if(frames.begin(), frames.end(), [](const Frame& frame) {
+            return frame.isKeyframe && !frame.result;
+        });
+        if (frameIt == frames.end()) {
+            throw std::logic_error("Result of a keyframe which wasn't submitted is received");
+        }
+        frameIt->result = std::move(result);
+    }
+}
+
+void KeyframePipeline::updateTracks(int64_t frameId, const DetectionResult& result) {
+    const float elapsed = lastKeyframeId < 0 ? 0.0f : static_cast<float>(frameId - lastKeyframeId);
+    std::vector<bool> isMatched(tracks.size(), false);
+    std::vector<Track> newTracks;
+    newTracks.reserve(result.objects.size());
+    for (const DetectedObject& object : result.objects) {
+        // The object is the same as the one of the previous keyframe, which predicted box overlaps it most
+        int bestTrack = -1;
+        float bestIou = minMatchIou;
+        for (size_t i = 0; i < tracks.size(); ++i) {
+            if (isMatched[i] || tracks[i].object.labelID != object.labelID) {
+                continue;
+            }
+            const float overlap = iou(tracks[i].object + tracks[i].velocity * elapsed, object);
+            if (overlap >= bestIou) {
+                bestIou = overlap;
+                bestTrack = static_cast<int>(i);
+            }
+        }
+        Track track{object, cv::Point2f()};
+        if (bestTrack >= 0 && elapsed > 0) {
+            isMatched[bestTrack] = true;
+            track.velocity = (center(object) - center(tracks[bestTrack].object)) / elapsed;
+        }
+        newTracks.push_back(std::move(track));
+    }
+    tracks.swap(newTracks);
+    labels = result.labels;
+    lastKeyframeId = frameId;
+}
+
+std::unique_ptr<ResultBase> KeyframePipeline::propagate(int64_t frameId, const std::shared_ptr<MetaData>& metaData) {
+    std::unique_ptr<DetectionResult> result(new DetectionResult(frameId, metaData));
+    result->labels = labels;
+    result->isPropagated = true;
+    const float elapsed = static_cast<float>(frameId - lastKeyframeId);
+    result->objects.reserve(tracks.size());
+    for (const Track& track : tracks) {
+        DetectedObject object = track.object;
+        object.x += track.velocity.x * elapsed;
+        object.y += track.velocity.y * elapsed;
+        result->objects.push_back(std::move(object));
+    }
+    ++propagatedNum;
+    return std::unique_ptr<ResultBase>(result.release());
+}
@@ -0,0 +1,255 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "pipelines/model_ladder_pipeline.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <models/results.h>
+#include <utils/slog.hpp>
+
+#include "pipelines/metadata.h"
+
+namespace {
+// Upgrade attempts which fail are retried after doubling intervals, up to this number of switch intervals
+const size_t maxUpgradeBackoff = 64;
+}  // namespace
+
+ModelLadderPipeline::ModelLadderPipeline(const Config& config) : config(config) {
+    if (!(config.latencyBudget > 0)) {
+        throw std::invalid_argument("Latency budget should be positive");
+    }
+    if (!(config.headroom > 0 && config.headroom < 1)) {
+        throw std::invalid_argument("Latency headroom should be in range (0, 1)");
+    }
+    if (!(config.latencySmoothing > 0 && config.latencySmoothing <= 1)) {
+        throw std::invalid_argument("Latency smoothing factor should be in range (0, 1]");
+    }
+    if (config.switchInterval == 0) {
+        throw std::invalid_argument("Switch interval should be positive");
+    }
+}
+
+ModelLadderPipeline::~ModelLadderPipeline() {
+    waitForTotalCompletion();
+}
+
+void ModelLadderPipeline::addVariant(std::unique_ptr<AsyncPipeline>&& pipeline, const std::string& name) {
+    if (inputFrameId != 0) {
+        throw std::logic_error("Variants should be added before any data is submitted");
+    }
+    variants.emplace_back();
+    variants.back().pipeline = std::move(pipeline);
+    variants.back().name = name;
+}
+
+bool ModelLadderPipeline::isReadyToProcess(size_t streamId) {
+    return variants.at(getStreamVariant(streamId)).pipeline->isReadyToProcess();
+}
+
+int64_t ModelLadderPipeline::submitData(const InputData& inputData, const std::shared_ptr<MetaData>& metaData) {
+    const size_t streamId = metaData ? metaData->streamId : 0;
+    auto streamIt = streams.find(streamId);
+    if (streamIt == streams.end()) {
+        streamIt = streams.emplace(streamId, StreamState()).first;
+        streamIt->second.upgradeInterval = config.switchInterval;
+    }
+    Variant& variant = variants.at(streamIt->second.variant);
+
+    auto startTime = std::chrono::steady_clock::now();
+    int64_t variantFrameId = variant.pipeline->submitData(inputData, metaData);
+    if (variantFrameId < 0) {
+        return -1;
+    }
+
+    auto frameID = inputFrameId;
+    InFlightFrame frame = {frameID, streamId, startTime};
+    variant.inFlight.emplace(variantFrameId, frame);
+
+    inputFrameId++;
+    if (inputFrameId < 0)
+        inputFrameId = 0;
+
+    return frameID;
+}
+
+void ModelLadderPipeline::pump() {
+    for (size_t variantIdx = 0; variantIdx < variants.size(); ++variantIdx) {
+        Variant& variant = variants[variantIdx];
+        while (std::unique_ptr<ResultBase> result = variant.pipeline->getResult(false)) {
+            auto frameIt = variant.inFlight.find(result->frameId);
+            if (frameIt == variant.inFlight.end()) {
+                throw std::logic_error("Result of variant " + variant.name + " doesn't belong to any frame");
+            }
+            double latency = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(
+                                 std::chrono::steady_clock::now() - frameIt->second.submitTime)
+                                 .count();
+            variant.averageLatency =
+                variant.framesProcessed == 0
+                    ? latency
+                    : variant.averageLatency + config.latencySmoothing * (latency - variant.averageLatency);
+            ++variant.framesProcessed;
+            updateStream(frameIt->second.streamId, variantIdx, latency);
+
+            if (result->metaData) {
+                result->metaData->modelVariant = variantIdx;
+            }
+            result->frameId = frameIt->second.frameId;
+            variant.inFlight.erase(frameIt);
+            int64_t frameId = result->frameId;
+            completedResults.emplace(frameId, std::move(result));
+        }
+    }
+}
+
+void ModelLadderPipeline::updateStream(size_t streamId, size_t variantIdx, double latency) {
+    StreamState& stream = streams.at(streamId);
+    // Frames submitted before the last switch don't tell anything about the current variant
+    if (stream.variant != variantIdx) {
+        return;
+    }
+    stream.averageLatency = stream.framesSinceSwitch == 0
+                                ? latency
+                                : stream.averageLatency + config.latencySmoothing * (latency - stream.averageLatency);
+    ++stream.framesSinceSwitch;
+    if (stream.framesSinceSwitch < config.switchInterval) {
+        return;
+    }
+
+    if (stream.averageLatency > config.latencyBudget) {
+        if (stream.variant + 1 < variants.size()) {
+            if (stream.isUpgradePending) {
+                stream.upgradeInterval =
+                    std::min(stream.upgradeInterval * 2, config.switchInterval * maxUpgradeBackoff);
+            }
+            switchStream(stream, stream.variant + 1);
+        }
+        return;
+    }
+    if (stream.isUpgradePending) {
+        // The more accurate variant met the budget for the whole switch interval
+        stream.isUpgradePending = false;
+        stream.upgradeInterval = config.switchInterval;
+    }
+    if (stream.averageLatency < config.latencyBudget * config.headroom && stream.variant > 0 &&
+        stream.framesSinceSwitch >= stream.upgradeInterval) {
+        switchStream(stream, stream.variant - 1);
+        stream.isUpgradePending = true;
+    }
+}
+
+void ModelLadderPipeline::switchStream(StreamState& stream, size_t variantIdx) {
+    stream.variant = variantIdx;
+    stream.averageLatency = 0;
+    stream.framesSinceSwitch = 0;
+    stream.isUpgradePending = false;
+    ++switchesCount;
+}
+
+size_t ModelLadderPipeline::getStreamVariant(size_t streamId) const {
+    auto streamIt = streams.find(streamId);
+    return streamIt != streams.end() ? streamIt->second.variant : 0;
+}
+
+size_t ModelLadderPipeline::findOldestFrameVariant() const {
+    size_t oldestVariantIdx = variants.size();
+    int64_t oldestFrameId = std::numeric_limits<int64_t>::max();
+    for (size_t variantIdx = 0; variantIdx < variants.size(); ++variantIdx) {
+        const auto& inFlight = variants[variantIdx].inFlight;
+        // Variant frame IDs are sequential, so the first frame of the variant is its oldest one
+        if (!inFlight.empty() && inFlight.begin()->second.frameId < oldestFrameId) {
+            oldestFrameId = inFlight.begin()->second.frameId;
+            oldestVariantIdx = variantIdx;
+        }
+    }
+    return oldestVariantIdx;
+}
+
+void ModelLadderPipeline::waitForData(bool shouldKeepOrder) {
+    pump();
+    if (shouldKeepOrder ? completedResults.count(outputFrameId) != 0 : !completedResults.empty()) {
+        return;
+    }
+    for (auto& variant : variants) {
+        if (variant.pipeline->isReadyToProcess()) {
+            return;
+        }
+    }
+    // Every variant is busy. The oldest frame is the one ordered output waits for and the most likely to be
+    // completed first, so wait for its variant.
+    size_t variantIdx = findOldestFrameVariant();
+    if (variantIdx != variants.size()) {
+        variants[variantIdx].pipeline->waitForData(false);
+    }
+}
+
+std::unique_ptr<ResultBase> ModelLadderPipeline::getResult(bool shouldKeepOrder) {
+    pump();
+    auto resultIt = shouldKeepOrder ? completedResults.find(outputFrameId) : completedResults.begin();
+    if (resultIt == completedResults.end()) {
+        return std::unique_ptr<ResultBase>();
+    }
+    std::unique_ptr<ResultBase> result = std::move(resultIt->second);
+    completedResults.erase(resultIt);
+
+    outputFrameId = result->frameId;
+    outputFrameId++;
+    if (outputFrameId < 0) {
+        outputFrameId = 0;
+    }
+    return result;
+}
+
+void ModelLadderPipeline::waitForTotalCompletion() {
+    for (auto& variant : variants) {
+        variant.pipeline->waitForTotalCompletion();
+    }
+    pump();
+}
+
+std::vector<ModelLadderPipeline::VariantStats> ModelLadderPipeline::getVariantStats() const {
+    std::vector<VariantStats> stats;
+    stats.reserve(variants.size());
+    for (const auto& variant : variants) {
+        VariantStats variantStats = {variant.name,
+                                     variant.framesProcessed != 0 ? variant.averageLatency
+                                                                  : std::numeric_limits<double>::quiet_NaN(),
+                                     variant.framesProcessed,
+                                     0};
+        stats.push_back(variantStats);
+    }
+    for (const auto& stream : streams) {
+        ++stats[stream.second.variant].streamsNum;
+    }
+    return stats;
+}
+
+void ModelLadderPipeline::logVariantStats() const {
+    slog::info << "Model ladder: " << switchesCount << " switches of streams between variants" << slog::endl;
+    for (const auto& stats : getVariantStats()) {
+        slog::info << "\t" << stats.name << ": " << stats.framesProcessed << " frames, average latency " << std::fixed
+                   << std::setprecision(1) << stats.averageLatency << " ms, " << stats.streamsNum << " streams"
+                   << slog::endl;
+    }
+}
@@ -0,0 +1,199 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "pipelines/multi_device_pipeline.h"
+
+#include <chrono>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <models/results.h>
+#include <utils/slog.hpp>
+
+namespace {
+// Devices which haven't processed any frame yet go first, the least loaded of them is preferred. After that, the
+// device with the lowest moving average latency is preferred.
+template <class Device>
+bool isPreferred(const Device& device, const Device& other) {
+    if (device.framesProcessed == 0 || other.framesProcessed == 0) {
+        return other.framesProcessed != 0 ||
+               (device.framesProcessed == 0 && device.inFlight.size() < other.inFlight.size());
+    }
+    return device.averageLatency < other.averageLatency;
+}
+}  // namespace
+
+MultiDevicePipeline::MultiDevicePipeline(double latencySmoothing) : latencySmoothing(latencySmoothing) {
+    if (!(latencySmoothing > 0 && latencySmoothing <= 1)) {
+        throw std::invalid_argument("Latency smoothing factor should be in range (0, 1]");
+    }
+}
+
+MultiDevicePipeline::~MultiDevicePipeline() {
+    waitForTotalCompletion();
+}
+
+void MultiDevicePipeline::addDevice(std::unique_ptr<AsyncPipeline>&& pipeline, const std::string& name) {
+    if (inputFrameId != 0) {
+        throw std::logic_error("Devices should be added before any data is submitted");
+    }
+    devices.emplace_back();
+    devices.back().pipeline = std::move(pipeline);
+    devices.back().name = name;
+}
+
+bool MultiDevicePipeline::isReadyToProcess() {
+    for (auto& device : devices) {
+        if (device.pipeline->isReadyToProcess()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int64_t MultiDevicePipeline::submitData(const InputData& inputData, const std::shared_ptr<MetaData>& metaData) {
+    Device* bestDevice = nullptr;
+    for (auto& device : devices) {
+        if (!device.pipeline->isReadyToProcess()) {
+            continue;
+        }
+        if (!bestDevice || isPreferred(device, *bestDevice)) {
+            bestDevice = &device;
+        }
+    }
+    if (!bestDevice) {
+        return -1;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    int64_t deviceFrameId = bestDevice->pipeline->submitData(inputData, metaData);
+    if (deviceFrameId < 0) {
+        return -1;
+    }
+
+    auto frameID = inputFrameId;
+    InFlightFrame frame = {frameID, startTime};
+    bestDevice->inFlight.emplace(deviceFrameId, frame);
+
+    inputFrameId++;
+    if (inputFrameId < 0)
+        inputFrameId = 0;
+
+    return frameID;
+}
+
+void MultiDevicePipeline::pump() {
+    for (auto& device : devices) {
+        while (std::unique_ptr<ResultBase> result = device.pipeline->getResult(false)) {
+            auto frameIt = device.inFlight.find(result->frameId);
+            if (frameIt == device.inFlight.end()) {
+                throw std::logic_error("Result of device " + device.name + " doesn't belong to any frame");
+            }
+            double latency = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(
+                                 std::chrono::steady_clock::now() - frameIt->second.submitTime)
+                                 .count();
+            device.averageLatency = device.framesProcessed == 0
+                                        ? latency
+                                        : device.averageLatency + latencySmoothing * (latency - device.averageLatency);
+            ++device.framesProcessed;
+
+            result->frameId = frameIt->second.frameId;
+            device.inFlight.erase(frameIt);
+            int64_t frameId = result->frameId;
+            completedResults.emplace(frameId, std::move(result));
+        }
+    }
+}
+
+size_t MultiDevicePipeline::findOldestFrameDevice() const {
+    size_t oldestDeviceIdx = devices.size();
+    int64_t oldestFrameId = std::numeric_limits<int64_t>::max();
+    for (size_t deviceIdx = 0; deviceIdx < devices.size(); ++deviceIdx) {
+        const auto& inFlight = devices[deviceIdx].inFlight;
+        // Device frame IDs are sequential, so the first frame of the device is its oldest one
+        if (!inFlight.empty() && inFlight.begin()->second.frameId < oldestFrameId) {
+            oldestFrameId = inFlight.begin()->second.frameId;
+            oldestDeviceIdx = deviceIdx;
+        }
+    }
+    return oldestDeviceIdx;
+}
+
+void MultiDevicePipeline::waitForData(bool shouldKeepOrder) {
+    pump();
+    if (shouldKeepOrder ? completedResults.count(outputFrameId) != 0 : !completedResults.empty()) {
+        return;
+    }
+    if (isReadyToProcess()) {
+        return;
+    }
+    // Every device is busy. The oldest frame is the one ordered output waits for and the most likely to be completed
+    // first, so wait for its device.
+    size_t deviceIdx = findOldestFrameDevice();
+    if (deviceIdx != devices.size()) {
+        devices[deviceIdx].pipeline->waitForData(false);
+    }
+}
+
+std::unique_ptr<ResultBase> MultiDevicePipeline::getResult(bool shouldKeepOrder) {
+    pump();
+    auto resultIt = shouldKeepOrder ? completedResults.find(outputFrameId) : completedResults.begin();
+    if (resultIt == completedResults.end()) {
+        return std::unique_ptr<ResultBase>();
+    }
+    std::unique_ptr<ResultBase> result = std::move(resultIt->second);
+    completedResults.erase(resultIt);
+
+    outputFrameId = result->frameId;
+    outputFrameId++;
+    if (outputFrameId < 0) {
+        outputFrameId = 0;
+    }
+    return result;
+}
+
+void MultiDevicePipeline::waitForTotalCompletion() {
+    for (auto& device : devices) {
+        device.pipeline->waitForTotalCompletion();
+    }
+    pump();
+}
+
+std::vector<MultiDevicePipeline::DeviceStats> MultiDevicePipeline::getDeviceStats() const {
+    std::vector<DeviceStats> stats;
+    stats.reserve(devices.size());
+    for (const auto& device : devices) {
+        DeviceStats deviceStats = {device.name,
+                                   device.framesProcessed != 0 ? device.averageLatency
+                                                               : std::numeric_limits<double>::quiet_NaN(),
+                                   device.inFlight.size(),
+                                   device.framesProcessed};
+        stats.push_back(deviceStats);
+    }
+    return stats;
+}
+
+void MultiDevicePipeline::logDeviceStats() const {
+    for (const auto& stats : getDeviceStats()) {
+        slog::info << "\t" << stats.name << ": " << stats.framesProcessed << " frames, average latency " << std::fixed
+                   << std::setprecision(1) << stats.averageLatency << " ms" << slog::endl;
+    }
+}
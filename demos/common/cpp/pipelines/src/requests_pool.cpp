@@ -16,79 +16,150 @@
 
 #include "pipelines/requests_pool.h"
 
+#include <stdint.h>
+
 #include <algorithm>
 #include <exception>
+#include <stdexcept>
 #include <vector>
 
 #include <openvino/openvino.hpp>
 
-RequestsPool::RequestsPool(ov::CompiledModel& compiledModel, unsigned int size) : numRequestsInUse(0) {
+RequestsPool::RequestsPool(ov::CompiledModel& compiledModel, unsigned int size)
+    : requestsInUse(new std::atomic<bool>[size]),
+      enqueuePos(0),
+      dequeuePos(0),
+      numRequestsInUse(0) {
+    size_t capacity = 2;
+    while (capacity < size) {
+        capacity <<= 1;
+    }
+    idleSlots.reset(new IdleSlotCell[capacity]);
+    idleSlotsMask = capacity - 1;
+    for (size_t i = 0; i < capacity; ++i) {
+        idleSlots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    requests.reserve(size);
     for (unsigned int infReqId = 0; infReqId < size; ++infReqId) {
-        requests.emplace_back(compiledModel.create_infer_request(), false);
+        requests.push_back(compiledModel.create_infer_request());
+        requestsInUse[infReqId].store(false, std::memory_order_relaxed);
+        pushIdleSlot(infReqId);
     }
 }
 
 RequestsPool::~RequestsPool() {
     // Setting empty callback to free resources allocated for previously assigned lambdas
-    for (auto& pair : requests) {
-        pair.first.set_callback([](std::exception_ptr) {});
+    for (auto& request : requests) {
+        request.set_callback([](std::exception_ptr) {});
     }
 }
 
 ov::InferRequest RequestsPool::getIdleRequest() {
-    std::lock_guard<std::mutex> lock(mtx);
+    size_t slot;
+    return getIdleRequest(slot);
+}
 
-    const auto& it = std::find_if(requests.begin(), requests.end(), [](const std::pair<ov::InferRequest, bool>& x) {
-        return !x.second;
-    });
-    if (it == requests.end()) {
+ov::InferRequest RequestsPool::getIdleRequest(size_t& slot) {
+    size_t idleSlot;
+    if (!popIdleSlot(idleSlot)) {
         return ov::InferRequest();
-    } else {
-        it->second = true;
-        numRequestsInUse++;
-        return it->first;
     }
+    requestsInUse[idleSlot].store(true, std::memory_order_relaxed);
+    numRequestsInUse.fetch_add(1, std::memory_order_relaxed);
+    slot = idleSlot;
+    return requests[idleSlot];
 }
 
 void RequestsPool::setRequestIdle(const ov::InferRequest& request) {
-    std::lock_guard<std::mutex> lock(mtx);
-    const auto& it = std::find_if(this->requests.begin(),
-                                  this->requests.end(),
-                                  [&request](const std::pair<ov::InferRequest, bool>& x) {
-                                      return x.first == request;
-                                  });
-    it->second = false;
-    numRequestsInUse--;
+    const auto& it = std::find(requests.begin(), requests.end(), request);
+    if (it == requests.end()) {
+        throw std::invalid_argument("The request doesn't belong to the pool");
+    }
+    setRequestIdle(static_cast<size_t>(it - requests.begin()));
+}
+
+void RequestsPool::setRequestIdle(size_t slot) {
+    requestsInUse[slot].store(false, std::memory_order_relaxed);
+    pushIdleSlot(slot);
+    numRequestsInUse.fetch_sub(1, std::memory_order_relaxed);
 }
 
 size_t RequestsPool::getInUseRequestsCount() {
-    std::lock_guard<std::mutex> lock(mtx);
-    return numRequestsInUse;
+    return numRequestsInUse.load(std::memory_order_relaxed);
 }
 
 bool RequestsPool::isIdleRequestAvailable() {
-    std::lock_guard<std::mutex> lock(mtx);
-    return numRequestsInUse < requests.size();
+    return numRequestsInUse.load(std::memory_order_relaxed) < requests.size();
 }
 
 void RequestsPool::waitForTotalCompletion() {
-    // Do not synchronize here to avoid deadlock (despite synchronization in other functions)
     // Request status will be changed to idle in callback,
-    // upon completion of request we're waiting for. Synchronization is applied there
-    for (auto pair : requests) {
-        if (pair.second) {
-            pair.first.wait();
+    // upon completion of request we're waiting for
+    for (size_t slot = 0; slot < requests.size(); ++slot) {
+        if (requestsInUse[slot].load(std::memory_order_acquire)) {
+            requests[slot].wait();
         }
     }
 }
 
 std::vector<ov::InferRequest> RequestsPool::getInferRequestsList() {
-    std::lock_guard<std::mutex> lock(mtx);
-    std::vector<ov::InferRequest> retVal;
-    retVal.reserve(requests.size());
-    for (auto& pair : requests) {
-        retVal.push_back(pair.first);
+    return requests;
+}
+
+size_t RequestsPool::getTensorsByteSize(const ov::CompiledModel& compiledModel) {
+    size_t bytes = 0;
+    for (ov::InferRequest& request : requests) {
+        for (const auto& input : compiledModel.inputs()) {
+            bytes += request.get_tensor(input).get_byte_size();
+        }
+        for (const auto& output : compiledModel.outputs()) {
+            bytes += request.get_tensor(output).get_byte_size();
+        }
+    }
+    return bytes;
+}
+
+bool RequestsPool::pushIdleSlot(size_t slot) {
+    IdleSlotCell* cell;
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        cell = &idleSlots[pos & idleSlotsMask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;  // queue is full
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
     }
+    cell->slot = slot;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
 
-    return retVal;
+bool RequestsPool::popIdleSlot(size_t& slot) {
+    IdleSlotCell* cell;
+    size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        cell = &idleSlots[pos & idleSlotsMask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+        if (diff == 0) {
+            if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;  // queue is empty
+        } else {
+            pos = dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+    slot = cell->slot;
+    cell->sequence.store(pos + idleSlotsMask + 1, std::memory_order_release);
+    return true;
 }
@@ -0,0 +1,313 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "pipelines/results_publisher.h"
+
+#include <errno.h>
+
+#ifndef _WIN32
+#    include <netdb.h>
+#    include <netinet/in.h>
+#    include <netinet/tcp.h>
+#    include <sys/socket.h>
+#    include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <models/results.h>
+#include <utils/slog.hpp>
+
+namespace {
+const char resultsStreamSignature[8] = {'O', 'M', 'Z', 'R', 'E', 'S', '0', '1'};
+
+struct RecordHeader {
+    uint32_t size;
+    uint16_t type;
+    uint16_t flags;
+    int64_t frameId;
+    int64_t timestamp;
+    uint32_t itemsNum;
+    uint32_t reserved;
+};
+
+struct DetectionItem {
+    float x, y, width, height;
+    float confidence;
+    uint32_t labelID;
+};
+
+struct ClassificationItem {
+    uint32_t labelID;
+    float score;
+};
+
+struct PoseItemHeader {
+    float score;
+    uint32_t keypointsNum;
+};
+
+struct TrackItem {
+    int64_t trackId;
+    float x, y, width, height;
+    float confidence;
+    uint32_t labelID;
+};
+
+// The structures are the wire format, so they must have no padding
+static_assert(sizeof(RecordHeader) == 32, "Unexpected padding of RecordHeader");
+static_assert(sizeof(DetectionItem) == 24, "Unexpected padding of DetectionItem");
+static_assert(sizeof(ClassificationItem) == 8, "Unexpected padding of ClassificationItem");
+static_assert(sizeof(PoseItemHeader) == 8, "Unexpected padding of PoseItemHeader");
+static_assert(sizeof(TrackItem) == 32, "Unexpected padding of TrackItem");
+
+enum RecordFlags : uint16_t { Cached = 1, Propagated = 2 };
+
+// The batch isn't aligned for the items, so they are copied into it
+template <typename T>
+uint8_t* put(uint8_t* dst, const T& value) {
+    std::memcpy(dst, &value, sizeof(value));
+    return dst + sizeof(value);
+}
+
+uint16_t getFlags(const ResultBase& result) {
+    return result.isCached ? Cached : 0;
+}
+
+#ifndef _WIN32
+#    ifndef MSG_NOSIGNAL
+#        define MSG_NOSIGNAL 0
+#    endif
+
+int connectTo(const std::string& host, const std::string& port) {
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses) != 0) {
+        return -1;
+    }
+    int fd = -1;
+    for (addrinfo* it = addresses; it && fd < 0; it = it->ai_next) {
+        fd = socket(it->ai_family, it->ai_socktype, it->ai_protocol);
+        if (fd >= 0 && connect(fd, it->ai_addr, it->ai_addrlen) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    return fd;
+}
+#endif
+}  // namespace
+
+ResultsPublisher::ResultsPublisher(const std::string& destination, size_t capacity) : capacity(capacity) {
+    const size_t colon = destination.rfind(':');
+    const bool isTcp = colon != std::string::npos && colon > 0 && colon + 1 < destination.size() &&
+                       destination.find_first_not_of("0123456789", colon + 1) == std::string::npos;
+    if (isTcp) {
+#ifdef _WIN32
+        throw std::runtime_error("Publishing results over TCP isn't supported on Windows");
+#else
+        socketFd = connectTo(destination.substr(0, colon), destination.substr(colon + 1));
+        if (socketFd < 0) {
+            throw std::runtime_error("Can't connect to the results consumer " + destination);
+        }
+#endif
+    } else {
+        file = std::fopen(destination.c_str(), "ab");
+        if (!file) {
+            throw std::runtime_error("Can't open " + destination + " to publish results to");
+        }
+    }
+    pendingBatch.resize(sizeof(resultsStreamSignature));
+    std::memcpy(pendingBatch.data(), resultsStreamSignature, sizeof(resultsStreamSignature));
+    pendingSize = sizeof(resultsStreamSignature);
+    sendingThread = std::thread(&ResultsPublisher::sendingThreadFunc, this);
+}
+
+ResultsPublisher::~ResultsPublisher() {
+    {
+        const std::lock_guard<std::mutex> lock(mtx);
+        isStopped = true;
+    }
+    condVar.notify_one();
+    sendingThread.join();
+    if (droppedRecords > 0) {
+        slog::warn << droppedRecords << " records of results weren't published" << slog::endl;
+    }
+    if (file) {
+        std::fclose(file);
+    }
+#ifndef _WIN32
+    if (socketFd >= 0) {
+        close(socketFd);
+    }
+#endif
+}
+
+uint8_t* ResultsPublisher::reserveRecord(RecordType type,
+                                         uint16_t flags,
+                                         int64_t frameId,
+                                         uint32_t itemsNum,
+                                         size_t itemsSize) {
+    const size_t recordSize = sizeof(RecordHeader) + itemsSize;
+    if (isFailed || pendingSize + recordSize > capacity) {
+        ++droppedRecords;
+        return nullptr;
+    }
+    if (pendingBatch.size() < pendingSize + recordSize) {
+        // The batch grows to the size of the largest backlog once, then it's reused
+        pendingBatch.resize(std::max(pendingSize + recordSize, 2 * pendingBatch.size()));
+    }
+    RecordHeader header;
+    header.size = static_cast<uint32_t>(recordSize);
+    header.type = type;
+    header.flags = flags;
+    header.frameId = frameId;
+    header.timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
+                           std::chrono::system_clock::now().time_since_epoch())
+                           .count();
+    header.itemsNum = itemsNum;
+    header.reserved = 0;
+    uint8_t* record = pendingBatch.data() + pendingSize;
+    pendingSize += recordSize;
+    return put(record, header);
+}
+
+void ResultsPublisher::publish(const ResultBase& result) {
+    {
+        const std::lock_guard<std::mutex> lock(mtx);
+        if (const DetectionResult* detections = dynamic_cast<const DetectionResult*>(&result)) {
+            const uint16_t flags = getFlags(result) | (detections->isPropagated ? Propagated : 0);
+            const uint32_t itemsNum = static_cast<uint32_t>(detections->objects.size());
+            uint8_t* dst = reserveRecord(Detections, flags, result.frameId, itemsNum, itemsNum * sizeof(DetectionItem));
+            if (!dst) {
+                return;
+            }
+            for (const DetectedObject& object : detections->objects) {
+                dst = put(dst, DetectionItem{object.x, object.y, object.width, object.height, object.confidence,
+                                             object.labelID});
+            }
+        } else if (const ClassificationResult* classes = dynamic_cast<const ClassificationResult*>(&result)) {
+            const uint32_t itemsNum = static_cast<uint32_t>(classes->topLabels.size());
+            uint8_t* dst = reserveRecord(Classifications,
+                                         getFlags(result),
+                                         result.frameId,
+                                         itemsNum,
+                                         itemsNum * sizeof(ClassificationItem));
+            if (!dst) {
+                return;
+            }
+            for (const auto& classification : classes->topLabels) {
+                dst = put(dst, ClassificationItem{classification.id, classification.score});
+            }
+        } else if (const HumanPoseResult* poses = dynamic_cast<const HumanPoseResult*>(&result)) {
+            size_t itemsSize = 0;
+            for (const HumanPose& pose : poses->poses) {
+                itemsSize += sizeof(PoseItemHeader) + pose.keypoints.size() * 2 * sizeof(float);
+            }
+            uint8_t* dst = reserveRecord(Poses,
+                                         getFlags(result),
+                                         result.frameId,
+                                         static_cast<uint32_t>(poses->poses.size()),
+                                         itemsSize);
+            if (!dst) {
+                return;
+            }
+            for (const HumanPose& pose : poses->poses) {
+                dst = put(dst, PoseItemHeader{pose.score, static_cast<uint32_t>(pose.keypoints.size())});
+                for (const cv::Point2f& keypoint : pose.keypoints) {
+                    dst = put(put(dst, keypoint.x), keypoint.y);
+                }
+            }
+        } else {
+            throw std::invalid_argument("Results of this type can't be published");
+        }
+    }
+    condVar.notify_one();
+}
+
+void ResultsPublisher::publishTracks(int64_t frameId, const std::vector<TrackedBox>& tracks) {
+    {
+        const std::lock_guard<std::mutex> lock(mtx);
+        const uint32_t itemsNum = static_cast<uint32_t>(tracks.size());
+        uint8_t* dst = reserveRecord(Tracks, 0, frameId, itemsNum, itemsNum * sizeof(TrackItem));
+        if (!dst) {
+            return;
+        }
+        for (const TrackedBox& track : tracks) {
+            dst = put(dst, TrackItem{track.trackId, track.box.x, track.box.y, track.box.width, track.box.height,
+                                     track.confidence, track.labelID});
+        }
+    }
+    condVar.notify_one();
+}
+
+uint64_t ResultsPublisher::getDroppedRecords() const {
+    const std::lock_guard<std::mutex> lock(mtx);
+    return droppedRecords;
+}
+
+bool ResultsPublisher::write(const uint8_t* data, size_t size) {
+    if (file) {
+        return std::fwrite(data, 1, size, file) == size && std::fflush(file) == 0;
+    }
+#ifndef _WIN32
+    while (size > 0) {
+        const ssize_t sent = send(socketFd, data, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+#endif
+    return true;
+}
+
+void ResultsPublisher::sendingThreadFunc() {
+    std::vector<uint8_t> sendingBatch;
+    std::unique_lock<std::mutex> lock(mtx);
+    for (;;) {
+        condVar.wait(lock, [&]() {
+            return pendingSize > 0 || isStopped;
+        });
+        if (pendingSize == 0) {
+            return;
+        }
+        // Records published while the batch is written go to the other buffer
+        std::swap(sendingBatch, pendingBatch);
+        const size_t sendingSize = pendingSize;
+        pendingSize = 0;
+        lock.unlock();
+        const bool isWritten = write(sendingBatch.data(), sendingSize);
+        lock.lock();
+        if (!isWritten && !isFailed) {
+            isFailed = true;
+            slog::warn << "The results consumer is disconnected, next results are dropped" << slog::endl;
+        }
+    }
+}
@@ -0,0 +1,94 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "pipelines/shared_compiled_model.h"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <openvino/openvino.hpp>
+
+#include <models/model_base.h>
+#include <utils/config_factory.h>
+
+#include "pipelines/requests_pool.h"
+
+SharedCompiledModel::SharedCompiledModel(std::unique_ptr<ModelBase>&& modelInstance,
+                                         const ModelConfig& config,
+                                         ov::Core& core,
+                                         size_t batchSize)
+    : model(std::move(modelInstance)),
+      config(config),
+      core(core),
+      batchSize(batchSize) {
+    if (batchSize == 0) {
+        throw std::invalid_argument("Batch size should be positive");
+    }
+    if (this->config.profiledLayers > 0) {
+        this->config.compiledModelConfig[ov::enable_profiling.name()] = true;
+    }
+    model->setBatch(batchSize);
+    compiledModel = model->compileModel(this->config, core);
+    this->config = model->getConfig();
+    // State the models set up once they are loaded, e.g. labels of detection models, is copied by the clones. Infer
+    // requests are set up when they are created.
+    model->onLoadCompleted(std::vector<ov::InferRequest>());
+}
+
+SharedCompiledModel::~SharedCompiledModel() = default;
+
+std::unique_ptr<ModelBase> SharedCompiledModel::cloneModel() const {
+    return model->clone();
+}
+
+std::shared_ptr<RequestsPool> SharedCompiledModel::getSharedRequests(unsigned int nireq) {
+    const std::lock_guard<std::mutex> lock(requestsMtx);
+    if (!sharedRequests) {
+        std::shared_ptr<RequestsPool> requests = std::make_shared<RequestsPool>(compiledModel, nireq);
+        // The prototype sets up the requests for all clones, as no pipeline uses them yet
+        model->onLoadCompleted(requests->getInferRequestsList());
+        if (!model->getRemoteClient()) {
+            model->warmUp(requests->getInferRequestsList(), config.warmupInferences);
+        }
+        requestsMemory.set(requests->getTensorsByteSize(compiledModel));
+        sharedRequests = requests;
+    }
+    return sharedRequests;
+}
+
+void SharedCompiledModel::addIdleListener(const void* owner, const std::function<void()>& listener) {
+    const std::lock_guard<std::mutex> lock(listenersMtx);
+    idleListeners[owner] = listener;
+}
+
+void SharedCompiledModel::removeIdleListener(const void* owner) {
+    const std::lock_guard<std::mutex> lock(listenersMtx);
+    idleListeners.erase(owner);
+}
+
+void SharedCompiledModel::notifyRequestIdle(const void* owner) {
+    // Listeners are called under the lock, so a pipeline isn't destroyed while it's notified
+    const std::lock_guard<std::mutex> lock(listenersMtx);
+    for (const auto& listener : idleListeners) {
+        if (listener.first != owner) {
+            listener.second();
+        }
+    }
+}
@@ -0,0 +1,277 @@
+/*
+// Copyright (C) 2020-2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "pipelines/tensor_log.h"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <openvino/op/parameter.hpp>
+#include <openvino/op/relu.hpp>
+#include <openvino/op/result.hpp>
+#include <openvino/openvino.hpp>
+
+#include <models/internal_model_data.h>
+#include <models/results.h>
+#include <utils/config_factory.h>
+
+#include "pipelines/metadata.h"
+
+struct InputData;
+
+namespace {
+const char logSignature[] = "OMZTLOG1";
+
+enum class InternalDataType : uint8_t { None, Image, Scale };
+
+template <typename T>
+void writeValue(std::ofstream& stream, const T& value) {
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void writeString(std::ofstream& stream, const std::string& str) {
+    writeValue(stream, static_cast<uint32_t>(str.size()));
+    stream.write(str.data(), str.size());
+}
+
+void writeTensor(std::ofstream& stream, const std::string& name, const ov::Tensor& tensor) {
+    writeString(stream, name);
+    writeValue(stream, static_cast<uint32_t>(static_cast<ov::element::Type_t>(tensor.get_element_type())));
+    const ov::Shape& shape = tensor.get_shape();
+    writeValue(stream, static_cast<uint32_t>(shape.size()));
+    for (size_t dim : shape) {
+        writeValue(stream, static_cast<uint64_t>(dim));
+    }
+    writeValue(stream, static_cast<uint64_t>(tensor.get_byte_size()));
+    stream.write(static_cast<const char*>(tensor.data()), tensor.get_byte_size());
+}
+
+void writeTensors(std::ofstream& stream, const std::map<std::string, ov::Tensor>& tensors) {
+    writeValue(stream, static_cast<uint32_t>(tensors.size()));
+    for (const auto& item : tensors) {
+        writeTensor(stream, item.first, item.second);
+    }
+}
+
+void writeTensors(std::ofstream& stream, const OutputsData& tensors) {
+    writeValue(stream, static_cast<uint32_t>(tensors.size()));
+    for (size_t i = 0; i < tensors.size(); ++i) {
+        writeTensor(stream, tensors.getName(i), tensors[i]);
+    }
+}
+
+template <typename T>
+T readValue(std::ifstream& stream) {
+    T value{};
+    stream.read(reinterpret_cast<char*>(&value), sizeof(value));
+    return value;
+}
+
+std::string readString(std::ifstream& stream) {
+    std::string str(readValue<uint32_t>(stream), '\0');
+    stream.read(&str[0], str.size());
+    return str;
+}
+
+std::map<std::string, ov::Tensor> readTensors(std::ifstream& stream) {
+    std::map<std::string, ov::Tensor> tensors;
+    const uint32_t count = readValue<uint32_t>(stream);
+    for (uint32_t i = 0; i < count && stream; ++i) {
+        std::string name = readString(stream);
+        const ov::element::Type type(static_cast<ov::element::Type_t>(readValue<uint32_t>(stream)));
+        ov::Shape shape(readValue<uint32_t>(stream));
+        for (auto& dim : shape) {
+            dim = static_cast<size_t>(readValue<uint64_t>(stream));
+        }
+        ov::Tensor tensor(type, shape);
+        if (readValue<uint64_t>(stream) != tensor.get_byte_size()) {
+            throw std::runtime_error("The size of tensor " + name + " in the tensor log doesn't match its shape");
+        }
+        stream.read(static_cast<char*>(tensor.data()), tensor.get_byte_size());
+        tensors.emplace(std::move(name), std::move(tensor));
+    }
+    return tensors;
+}
+
+struct ReplayModelData : public InternalModelData {
+    explicit ReplayModelData(TensorLogRecord&& record) : record(std::move(record)) {}
+
+    TensorLogRecord record;
+};
+}  // namespace
+
+TensorRecorder::TensorRecorder(const std::string& path, bool recordInputs, bool recordFrames)
+    : stream(path, std::ios::binary),
+      recordInputs(recordInputs),
+      recordFrames(recordFrames) {
+    if (!stream) {
+        throw std::runtime_error("Can't open tensor log " + path + " for writing");
+    }
+    stream.write(logSignature, sizeof(logSignature) - 1);
+}
+
+void TensorRecorder::record(const InferenceResult& result, const std::map<std::string, ov::Tensor>& inputsData) {
+    const std::lock_guard<std::mutex> lock(mtx);
+    writeValue(stream, static_cast<int64_t>(result.frameId));
+
+    // InternalScaleData is derived from InternalImageModelData, so it is checked first
+    const InternalModelData* internalData = result.internalModelData.get();
+    if (const auto* scaleData = dynamic_cast<const InternalScaleData*>(internalData)) {
+        writeValue(stream, InternalDataType::Scale);
+        writeValue(stream, static_cast<int32_t>(scaleData->inputImgWidth));
+        writeValue(stream, static_cast<int32_t>(scaleData->inputImgHeight));
+        writeValue(stream, scaleData->scaleX);
+        writeValue(stream, scaleData->scaleY);
+    } else if (const auto* imageData = dynamic_cast<const InternalImageModelData*>(internalData)) {
+        writeValue(stream, InternalDataType::Image);
+        writeValue(stream, static_cast<int32_t>(imageData->inputImgWidth));
+        writeValue(stream, static_cast<int32_t>(imageData->inputImgHeight));
+    } else {
+        writeValue(stream, InternalDataType::None);
+    }
+
+    writeTensors(stream, recordInputs ? inputsData : std::map<std::string, ov::Tensor>());
+    writeTensors(stream, result.outputsData);
+
+    const auto* imageMetaData = dynamic_cast<const ImageMetaData*>(result.metaData.get());
+    const bool hasFrame = recordFrames && imageMetaData && !imageMetaData->img.empty();
+    writeValue(stream, static_cast<uint8_t>(hasFrame));
+    if (hasFrame) {
+        const cv::Mat frame = imageMetaData->img.isContinuous() ? imageMetaData->img : imageMetaData->img.clone();
+        writeValue(stream, static_cast<int32_t>(frame.rows));
+        writeValue(stream, static_cast<int32_t>(frame.cols));
+        writeValue(stream, static_cast<int32_t>(frame.type()));
+        stream.write(reinterpret_cast<const char*>(frame.data), frame.total() * frame.elemSize());
+    }
+    if (!stream) {
+        throw std::runtime_error("Failed to write the tensor log");
+    }
+}
+
+TensorLogReader::TensorLogReader(const std::string& path) : stream(path, std::ios::binary) {
+    std::string signature(sizeof(logSignature) - 1, '\0');
+    stream.read(&signature[0], signature.size());
+    if (!stream || signature != logSignature) {
+        throw std::runtime_error("Can't read tensor log " + path);
+    }
+}
+
+bool TensorLogReader::read(TensorLogRecord& record) {
+    record = TensorLogRecord();
+    record.frameId = readValue<int64_t>(stream);
+    if (!stream) {
+        return false;
+    }
+    switch (readValue<InternalDataType>(stream)) {
+    case InternalDataType::Scale: {
+        const int32_t width = readValue<int32_t>(stream);
+        const int32_t height = readValue<int32_t>(stream);
+        const float scaleX = readValue<float>(stream);
+        const float scaleY = readValue<float>(stream);
+        record.internalModelData = std::make_shared<InternalScaleData>(width, height, scaleX, scaleY);
+        break;
+    }
+    case InternalDataType::Image: {
+        const int32_t width = readValue<int32_t>(stream);
+        const int32_t height = readValue<int32_t>(stream);
+        record.internalModelData = std::make_shared<InternalImageModelData>(width, height);
+        break;
+    }
+    default:
+        record.internalModelData = std::make_shared<InternalModelData>();
+    }
+
+    record.inputsData = readTensors(stream);
+    record.outputsData = readTensors(stream);
+
+    if (readValue<uint8_t>(stream)) {
+        const int32_t rows = readValue<int32_t>(stream);
+        const int32_t cols = readValue<int32_t>(stream);
+        const int32_t type = readValue<int32_t>(stream);
+        record.frame.create(rows, cols, type);
+        stream.read(reinterpret_cast<char*>(record.frame.data), record.frame.total() * record.frame.elemSize());
+    }
+    if (!stream) {
+        throw std::runtime_error("The tensor log is truncated");
+    }
+    return true;
+}
+
+ReplayModel::ReplayModel(std::unique_ptr<ModelBase>&& model, const std::string& logPath)
+    : ModelBase(model->getModelFileName()),
+      model(std::move(model)),
+      reader(logPath) {}
+
+void ReplayModel::prepareInputsOutputs(std::shared_ptr<ov::Model>& model) {
+    inputsNames = {model->input().get_any_name()};
+    outputsNames = {model->output().get_any_name()};
+}
+
+ov::CompiledModel ReplayModel::compileModel(const ModelConfig& config, ov::Core& core) {
+    if (batchSize != 1) {
+        throw std::logic_error("The tensor log is replayed with batch size 1 only");
+    }
+    // The wrapped model is set up as usual, but on CPU, which is available everywhere
+    ModelConfig cpuConfig = config;
+    cpuConfig.deviceName = "CPU";
+    cpuConfig.compiledModelConfig.clear();
+    cpuConfig.remoteWorker.clear();
+    model->compileModel(cpuConfig, core);
+
+    auto input = std::make_shared<ov::op::v0::Parameter>(ov::element::f32, ov::Shape{1});
+    input->output(0).set_names({"replay_input"});
+    auto relu = std::make_shared<ov::op::v0::Relu>(input);
+    relu->output(0).set_names({"replay_output"});
+    auto output = std::make_shared<ov::op::v0::Result>(relu);
+    std::shared_ptr<ov::Model> replay =
+        std::make_shared<ov::Model>(ov::ResultVector{output}, ov::ParameterVector{input}, "replay");
+    prepareInputsOutputs(replay);
+    sharedOutputsNames = std::make_shared<const std::vector<std::string>>(outputsNames);
+    compiledModel = core.compile_model(replay, "CPU");
+    return compiledModel;
+}
+
+std::shared_ptr<InternalModelData> ReplayModel::preprocess(const InputData&, ov::InferRequest&) {
+    TensorLogRecord record;
+    {
+        const std::lock_guard<std::mutex> lock(mtx);
+        if (!reader.read(record)) {
+            throw std::runtime_error("The tensor log is over");
+        }
+    }
+    return std::make_shared<ReplayModelData>(std::move(record));
+}
+
+std::unique_ptr<ResultBase> ReplayModel::postprocess(InferenceResult& infResult) {
+    auto& replayData = infResult.internalModelData->asRef<ReplayModelData>();
+    // The recorded outputs are put in the order the wrapped model takes them in
+    infResult.outputsData = OutputsData(model->getSharedOutputsNames());
+    for (size_t i = 0; i < infResult.outputsData.size(); ++i) {
+        const std::string& name = infResult.outputsData.getName(i);
+        auto recordedOutput = replayData.record.outputsData.find(name);
+        if (recordedOutput == replayData.record.outputsData.end()) {
+            throw std::runtime_error("There is no output " + name + " in the tensor log");
+        }
+        infResult.outputsData[i] = std::move(recordedOutput->second);
+    }
+    // The replay data is owned by the result, so the recorded internal data is taken out of it before the reset
+    std::shared_ptr<InternalModelData> internalModelData = std::move(replayData.record.internalModelData);
+    infResult.internalModelData = std::move(internalModelData);
+    return model->postprocess(infResult);
+}
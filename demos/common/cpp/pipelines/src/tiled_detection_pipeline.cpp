@@ -0,0 +1,181 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "pipelines/tiled_detection_pipeline.h"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include <models/input_data.h>
+#include <models/model_base.h>
+#include <models/results.h>
+#include <utils/nms.hpp>
+
+#include "pipelines/tiled_image_pipeline.h"
+
+TiledDetectionPipeline::TiledDetectionPipeline(std::unique_ptr<ModelBase>&& modelInstance,
+                                               const ModelConfig& config,
+                                               ov::Core& core,
+                                               const TilingConfig& tiling,
+                                               const BatchingConfig& batching)
+    : AsyncPipeline(std::move(modelInstance), config, core, batching),
+      tiling(tiling) {
+    if (tiling.tileSize.width <= 0 || tiling.tileSize.height <= 0) {
+        throw std::invalid_argument("Tile size should be positive");
+    }
+    if (tiling.overlap < 0 || tiling.overlap >= std::min(tiling.tileSize.width, tiling.tileSize.height)) {
+        throw std::invalid_argument("Tiles overlap should be non-negative and less than the tile size");
+    }
+}
+
+TiledDetectionPipeline::~TiledDetectionPipeline() {
+    waitForTotalCompletion();
+}
+
+bool TiledDetectionPipeline::isReadyToProcess() {
+    submitTiles();
+    return !hasPendingTiles() && AsyncPipeline::isReadyToProcess();
+}
+
+int64_t TiledDetectionPipeline::submitData(const InputData& inputData, const std::shared_ptr<MetaData>& metaData) {
+    const auto* imageData = dynamic_cast<const ImageInputData*>(&inputData);
+    if (!imageData) {
+        throw std::invalid_argument("Tiled detection requires image input data");
+    }
+    // Tiles of a frame are compared with each other by the gate and the dropped ones would be lost
+    if (motionGate.threshold > 0 ||
+        (admissionPolicy != AdmissionPolicy::Block && admissionPolicy != AdmissionPolicy::DropNewest)) {
+        throw std::logic_error("Tiled detection supports neither motion gate nor dropping of accepted frames");
+    }
+    if (!isReadyToProcess()) {
+        return -1;
+    }
+    TiledFrame frame;
+    frame.frameId = tiledFrameId;
+    frame.image = imageData->inputImage;
+    frame.metaData = metaData;
+    frame.tiles = TiledImagePipeline::splitIntoTiles(frame.image.size(), tiling.tileSize, tiling.overlap);
+    if (tiling.addGlobalView && frame.tiles.size() > 1) {
+        frame.tiles.emplace_back(cv::Point(), frame.image.size());
+    }
+    frame.submittedTiles = 0;
+    frame.processedTiles = 0;
+    frames.push_back(std::move(frame));
+    submitTiles();
+    return tiledFrameId++;
+}
+
+int64_t TiledDetectionPipeline::submitData(const std::shared_ptr<InputData>& inputData,
+                                           const std::shared_ptr<MetaData>& metaData) {
+    return submitData(*inputData, metaData);
+}
+
+void TiledDetectionPipeline::waitForData(bool) {
+    submitTiles();
+    gatherTiles();
+    if (isFrontFrameReady()) {
+        return;
+    }
+    AsyncPipeline::waitForData();
+}
+
+std::unique_ptr<ResultBase> TiledDetectionPipeline::getResult(bool) {
+    gatherTiles();
+    submitTiles();
+    if (!isFrontFrameReady()) {
+        return nullptr;
+    }
+
+    TiledFrame& frame = frames.front();
+    std::unique_ptr<DetectionResult> result(new DetectionResult(frame.frameId, frame.metaData));
+    result->labels = frame.labels;
+    // Objects found by several tiles, e.g. in their overlaps or by the global view, are merged
+    NmsParams params(tiling.iouThreshold);
+    params.perClass = true;
+    for (int idx : nms(frame.boxes, params)) {
+        result->objects.push_back(std::move(frame.objects[idx]));
+    }
+    frames.pop_front();
+    return std::unique_ptr<ResultBase>(result.release());
+}
+
+void TiledDetectionPipeline::waitForTotalCompletion() {
+    submitTiles();
+    gatherTiles();
+    while (hasPendingTiles()) {
+        // Tiles results should be taken out, so requests accept more tiles
+        AsyncPipeline::waitForData();
+        submitTiles();
+        gatherTiles();
+    }
+    AsyncPipeline::waitForTotalCompletion();
+    gatherTiles();
+}
+
+void TiledDetectionPipeline::submitTiles() {
+    for (auto& frame : frames) {
+        while (frame.submittedTiles < frame.tiles.size()) {
+            const ImageROIInputData tile(frame.image, frame.tiles[frame.submittedTiles]);
+            if (!AsyncPipeline::isReadyToProcess() || AsyncPipeline::submitData(tile, nullptr) < 0) {
+                return;
+            }
+            if (++frame.submittedTiles == frame.tiles.size()) {
+                // The frame doesn't wait for tiles of the next one to fill the batch
+                flushBatch();
+            }
+        }
+    }
+}
+
+void TiledDetectionPipeline::gatherTiles() {
+    while (std::unique_ptr<ResultBase> result = AsyncPipeline::getResult()) {
+        // Results of tiles come in the submission order
+        auto frameIt = std::find_if(frames.begin(), frames.end(), [](const TiledFrame& frame) {
+            return frame.processedTiles < frame.tiles.size();
+        });
+        if (frameIt == frames.end()) {
+            throw std::logic_error("Result of a tile which wasn't submitted is received");
+        }
+        TiledFrame& frame = *frameIt;
+        const cv::Rect& tile = frame.tiles[frame.processedTiles++];
+        DetectionResult& tileResult = result->asRef<DetectionResult>();
+        frame.labels = tileResult.labels;
+        for (DetectedObject& object : tileResult.objects) {
+            object.x += tile.x;
+            object.y += tile.y;
+            frame.boxes.add(object.x,
+                            object.y,
+                            object.x + object.width,
+                            object.y + object.height,
+                            object.confidence,
+                            static_cast<int>(object.labelID));
+            frame.objects.push_back(std::move(object));
+        }
+    }
+}
+
+bool TiledDetectionPipeline::hasPendingTiles() const {
+    return !frames.empty() && frames.back().submittedTiles < frames.back().tiles.size();
+}
+
+bool TiledDetectionPipeline::isFrontFrameReady() const {
+    return !frames.empty() && frames.front().processedTiles == frames.front().tiles.size();
+}
@@ -0,0 +1,231 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "pipelines/tiled_image_pipeline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include <models/input_data.h>
+#include <models/results.h>
+
+namespace {
+// Positions of tiles along one axis, the last tile is shifted inwards to fit the image
+std::vector<int> splitAxis(int size, int tileSize, int overlap) {
+    std::vector<int> positions;
+    if (size <= tileSize) {
+        positions.push_back(0);
+        return positions;
+    }
+    for (int pos = 0; pos + tileSize < size; pos += tileSize - overlap) {
+        positions.push_back(pos);
+    }
+    positions.push_back(size - tileSize);
+    return positions;
+}
+
+// Weights of a tile along one axis: 1 in the middle, linear ramps over the bands shared with neighbours
+cv::Mat getAxisWeights(int size, int rampSize, bool hasPrevious, bool hasNext) {
+    cv::Mat weights(1, size, CV_32FC1, cv::Scalar(1));
+    float* data = weights.ptr<float>();
+    for (int i = 0; i < std::min(rampSize, size); ++i) {
+        const float weight = (i + 0.5f) / rampSize;
+        if (hasPrevious) {
+            data[i] = std::min(data[i], weight);
+        }
+        if (hasNext) {
+            data[size - 1 - i] = std::min(data[size - 1 - i], weight);
+        }
+    }
+    return weights;
+}
+}  // namespace
+
+TiledImagePipeline::TiledImagePipeline(std::unique_ptr<AsyncPipeline>&& pipeline,
+                                       const cv::Size& tileSize,
+                                       int overlap)
+    : pipeline(std::move(pipeline)),
+      tileSize(tileSize),
+      overlap(overlap) {
+    if (tileSize.width <= 0 || tileSize.height <= 0) {
+        throw std::invalid_argument("Tile size should be positive");
+    }
+    if (overlap < 0 || overlap >= std::min(tileSize.width, tileSize.height)) {
+        throw std::invalid_argument("Tiles overlap should be non-negative and less than the tile size");
+    }
+}
+
+TiledImagePipeline::~TiledImagePipeline() {
+    waitForTotalCompletion();
+}
+
+std::vector<cv::Rect> TiledImagePipeline::splitIntoTiles(const cv::Size& imageSize,
+                                                         const cv::Size& tileSize,
+                                                         int overlap) {
+    const int width = std::min(imageSize.width, tileSize.width);
+    const int height = std::min(imageSize.height, tileSize.height);
+    std::vector<cv::Rect> tiles;
+    for (int y : splitAxis(imageSize.height, tileSize.height, overlap)) {
+        for (int x : splitAxis(imageSize.width, tileSize.width, overlap)) {
+            tiles.emplace_back(x, y, width, height);
+        }
+    }
+    return tiles;
+}
+
+bool TiledImagePipeline::isReadyToProcess() {
+    submitTiles();
+    return !hasPendingTiles() && pipeline->isReadyToProcess();
+}
+
+int64_t TiledImagePipeline::submitData(const ImageInputData& inputData, const std::shared_ptr<MetaData>& metaData) {
+    if (!isReadyToProcess()) {
+        return -1;
+    }
+    TiledImage image;
+    image.frameId = inputFrameId;
+    image.image = inputData.inputImage;
+    image.metaData = metaData;
+    image.tiles = splitIntoTiles(image.image.size(), tileSize, overlap);
+    image.submittedTiles = 0;
+    image.processedTiles = 0;
+    images.push_back(std::move(image));
+    submitTiles();
+    return inputFrameId++;
+}
+
+void TiledImagePipeline::waitForData() {
+    submitTiles();
+    gatherTiles();
+    if (!images.empty() && images.front().processedTiles == images.front().tiles.size()) {
+        return;
+    }
+    pipeline->waitForData();
+}
+
+std::unique_ptr<ResultBase> TiledImagePipeline::getResult() {
+    gatherTiles();
+    submitTiles();
+    if (images.empty() || images.front().processedTiles != images.front().tiles.size()) {
+        return nullptr;
+    }
+
+    TiledImage& image = images.front();
+    std::unique_ptr<ImageResult> result(new ImageResult(image.frameId, image.metaData));
+    if (image.tiles.size() == 1) {
+        result->resultImage = image.resultImage;
+    } else {
+        std::vector<cv::Mat> weights(image.accumulator.channels(), image.weights);
+        cv::Mat channelsWeights;
+        cv::merge(weights, channelsWeights);
+        cv::divide(image.accumulator, channelsWeights, image.accumulator);
+        image.accumulator.convertTo(result->resultImage, CV_8U);
+    }
+    images.pop_front();
+    return std::unique_ptr<ResultBase>(result.release());
+}
+
+void TiledImagePipeline::waitForTotalCompletion() {
+    submitTiles();
+    gatherTiles();
+    while (hasPendingTiles()) {
+        // Tiles results should be taken out, so the pipeline accepts more tiles
+        pipeline->waitForData();
+        submitTiles();
+        gatherTiles();
+    }
+    pipeline->waitForTotalCompletion();
+    gatherTiles();
+}
+
+void TiledImagePipeline::submitTiles() {
+    for (auto& image : images) {
+        while (image.submittedTiles < image.tiles.size()) {
+            if (!pipeline->isReadyToProcess() ||
+                pipeline->submitData(ImageROIInputData(image.image, image.tiles[image.submittedTiles]), nullptr) < 0) {
+                return;
+            }
+            ++image.submittedTiles;
+        }
+    }
+}
+
+void TiledImagePipeline::gatherTiles() {
+    while (std::unique_ptr<ResultBase> result = pipeline->getResult()) {
+        blendTile(result->asRef<ImageResult>().resultImage);
+    }
+}
+
+void TiledImagePipeline::blendTile(const cv::Mat& tileResult) {
+    // Results of tiles come in the submission order
+    auto imageIt = std::find_if(images.begin(), images.end(), [](const TiledImage& image) {
+        return image.processedTiles < image.tiles.size();
+    });
+    if (imageIt == images.end()) {
+        throw std::logic_error("Result of a tile which wasn't submitted is received");
+    }
+    TiledImage& image = *imageIt;
+    const cv::Rect& tile = image.tiles[image.processedTiles++];
+    if (image.tiles.size() == 1) {
+        image.resultImage = tileResult;
+        return;
+    }
+
+    // Models like super resolution change the size of the image
+    const double scaleX = static_cast<double>(tileResult.cols) / tile.width;
+    const double scaleY = static_cast<double>(tileResult.rows) / tile.height;
+    if (image.accumulator.empty()) {
+        const cv::Size resultSize(static_cast<int>(std::lround(image.image.cols * scaleX)),
+                                  static_cast<int>(std::lround(image.image.rows * scaleY)));
+        image.accumulator = cv::Mat(resultSize, CV_MAKETYPE(CV_32F, tileResult.channels()), cv::Scalar::all(0));
+        image.weights = cv::Mat(resultSize, CV_32FC1, cv::Scalar(0));
+    }
+    const cv::Rect resultRect = cv::Rect(static_cast<int>(std::lround(tile.x * scaleX)),
+                                         static_cast<int>(std::lround(tile.y * scaleY)),
+                                         tileResult.cols,
+                                         tileResult.rows) &
+                                cv::Rect(cv::Point(), image.accumulator.size());
+
+    const cv::Mat weightsX = getAxisWeights(resultRect.width,
+                                            static_cast<int>(std::lround(overlap * scaleX)),
+                                            tile.x > 0,
+                                            tile.br().x < image.image.cols);
+    const cv::Mat weightsY = getAxisWeights(resultRect.height,
+                                            static_cast<int>(std::lround(overlap * scaleY)),
+                                            tile.y > 0,
+                                            tile.br().y < image.image.rows);
+    const cv::Mat tileWeights = weightsY.t() * weightsX;
+
+    cv::Mat weightedTile;
+    tileResult(cv::Rect(cv::Point(), resultRect.size())).convertTo(weightedTile, CV_32F);
+    std::vector<cv::Mat> weights(weightedTile.channels(), tileWeights);
+    cv::Mat channelsWeights;
+    cv::merge(weights, channelsWeights);
+    cv::Mat accumulatorRoi = image.accumulator(resultRect);
+    accumulatorRoi += weightedTile.mul(channelsWeights);
+    cv::Mat weightsRoi = image.weights(resultRect);
+    weightsRoi += tileWeights;
+}
+
+bool TiledImagePipeline::hasPendingTiles() const {
+    return !images.empty() && images.back().submittedTiles < images.back().tiles.size();
+}
@@ -0,0 +1,53 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+/**
+ * @brief a header file for batched inference of image sequences on a pool of infer requests
+ * @file batch_infer_engine.hpp
+ */
+
+#pragma once
+#include <stddef.h>
+
+#include <functional>
+#include <vector>
+
+#include <opencv2/core.hpp>
+#include <openvino/openvino.hpp>
+
+/// Infers a sequence of images, e.g. crops of one frame, in batches spread over a pool of infer requests. A batch is
+/// filled while the previous ones are inferred and the results are fetched in the order of the images. Batch i goes
+/// to request i % number of requests, which is free once batch i - number of requests is fetched. Should be used by
+/// one thread at a time.
+class BatchInferEngine {
+public:
+    /// Fills the part of the input tensor corresponding to one image, the part has batch size 1
+    using FillItem = std::function<void(const cv::Mat& image, const ov::Tensor& itemTensor)>;
+    /// Gets results of a completed batch from the request
+    using FetchResults = std::function<void(ov::InferRequest& request, size_t batchSize)>;
+
+    /// @param compiledModel - model with a single input, whose batch dimension covers 1...maximum batch size
+    /// @param numRequests - number of infer requests, up to this number of batches are in flight
+    /// @param inputShape - shape of the input tensor with the maximum batch size
+    /// @param inputLayout - layout of the input tensor, defines the batch dimension
+    BatchInferEngine(ov::CompiledModel& compiledModel, size_t numRequests, const ov::Shape& inputShape,
+                     const ov::Layout& inputLayout);
+
+    /// Splits the images into batches and infers them, fetchResults() is called for the batches in the order of
+    /// the images
+    void infer(const std::vector<cv::Mat>& images, const FillItem& fillItem, const FetchResults& fetchResults);
+
+    size_t getMaxBatchSize() const {
+        return inputShape[batchIdx];
+    }
+
+private:
+    /// @returns a view of images [begin, end) of the input tensor of the request
+    ov::Tensor batchView(size_t requestIdx, size_t begin, size_t end) const;
+
+    std::vector<ov::InferRequest> requests;
+    std::vector<ov::Tensor> inputTensors;  // of the maximum batch size, batches are views of their beginnings
+    ov::Shape inputShape;
+    size_t batchIdx;
+};
@@ -23,12 +23,43 @@
 
 #include <openvino/openvino.hpp>
 
+/// Calibration of the number of streams and infer requests on the model and device, see ConfigTuner
+struct TuningConfig {
+    enum Objective {
+        None,        ///< tuning is disabled, the configuration is used as is
+        Throughput,  ///< maximal FPS, with p95 latency under latencyBudget if the budget is set
+        Latency      ///< minimal mean latency
+    };
+
+    Objective objective = None;
+    /// p95 latency in milliseconds the Throughput objective shouldn't exceed. Zero means no budget.
+    double latencyBudget = 0;
+    /// File keeping tuned configurations per model, input shapes, device and host, so the sweep runs once for them.
+    /// Empty string disables the cache.
+    std::string cacheFile;
+};
+
 struct ModelConfig {
     std::string deviceName;
     std::string cpuExtensionsPath;
     std::string clKernelsConfigPath;
     unsigned int maxAsyncRequests;
+    /// Directory for OpenVINO model cache, compiled models are imported from it instead of being compiled again if
+    /// the model, device and its config are the same. Empty string disables the cache.
+    std::string cacheDir;
     ov::AnyMap compiledModelConfig;
+    /// If enabled, number of streams and maxAsyncRequests are chosen by calibration when the model is compiled
+    TuningConfig tuning;
+    /// Number of inferences of dummy inputs run on every infer request once the pipeline creates them, so lazy
+    /// compilation of kernels and allocations on the device happen before the first frame. 0 disables the warm-up.
+    unsigned int warmupInferences = 0;
+    /// Number of the slowest layers reported by AsyncPipeline from per-layer profiling of its infer requests. If it's
+    /// positive, profiling is enabled on the compiled model. 0 disables the report, unless profiling is enabled by
+    /// compiledModelConfig.
+    unsigned int profiledLayers = 0;
+    /// "<host>:<port>" of a RemoteInferenceWorker the model is compiled and inferred by, the model is compiled on
+    /// deviceName of the worker host then. Empty string means local inference.
+    std::string remoteWorker;
 
     std::set<std::string> getDevices();
     std::map<std::string, std::string> getLegacyConfig();
@@ -42,9 +73,20 @@ public:
     static ModelConfig getUserConfig(const std::string& flags_d,
                                      uint32_t flags_nireq,
                                      const std::string& flags_nstreams,
-                                     uint32_t flags_nthreads);
-    static ModelConfig getMinLatencyConfig(const std::string& flags_d, uint32_t flags_nireq);
+                                     uint32_t flags_nthreads,
+                                     const std::string& flags_cache_dir = "");
+    /// @param flags_tune - tuning objective: "throughput", "latency" or empty string to disable tuning
+    /// @param flags_tune_latency - p95 latency budget in milliseconds for the throughput objective, 0 for no budget
+    /// @param flags_tune_cache - file caching tuned configurations, empty string disables the cache
+    static TuningConfig getTuningConfig(const std::string& flags_tune,
+                                        double flags_tune_latency,
+                                        const std::string& flags_tune_cache);
+    static ModelConfig getMinLatencyConfig(const std::string& flags_d,
+                                           uint32_t flags_nireq,
+                                           const std::string& flags_cache_dir = "");
 
 protected:
-    static ModelConfig getCommonConfig(const std::string& flags_d, uint32_t flags_nireq);
+    static ModelConfig getCommonConfig(const std::string& flags_d,
+                                       uint32_t flags_nireq,
+                                       const std::string& flags_cache_dir);
 };
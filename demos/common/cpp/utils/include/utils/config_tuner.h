@@ -0,0 +1,70 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+#include <stddef.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <openvino/openvino.hpp>
+
+#include "utils/config_factory.h"
+
+/// Chooses number of streams and infer requests for the model by a short calibration sweep: the model is compiled with
+/// each candidate configuration and infer requests are run on it for a fixed time. Chosen configuration is stored in
+/// the cache file of TuningConfig, so next runs with the same model, input shapes, device and host skip the sweep.
+class ConfigTuner {
+public:
+    struct Candidate {
+        int nstreams;
+        unsigned int nireq;
+        double fps;
+        double latency;  ///< mean latency, ms
+        double latencyP95;  ///< ms
+    };
+
+    /// @param measureTime - time the requests are run for every candidate
+    explicit ConfigTuner(const TuningConfig& tuning,
+                         std::chrono::milliseconds measureTime = std::chrono::milliseconds(1000));
+
+    /// @param model - model prepared for compilation (inputs and outputs are set up)
+    /// @param modelName - name of the model in the cache, e.g. its file name
+    /// @param config - configuration to tune, it should target single CPU or GPU device
+    /// @returns config with number of streams and maxAsyncRequests set to the best found values. If the device can't
+    /// be tuned, config is returned unchanged.
+    ModelConfig tune(const std::shared_ptr<ov::Model>& model,
+                     const std::string& modelName,
+                     const ModelConfig& config,
+                     ov::Core& core);
+
+protected:
+    Candidate measure(const std::shared_ptr<ov::Model>& model,
+                      const ModelConfig& config,
+                      ov::Core& core,
+                      int nstreams,
+                      unsigned int nireq);
+    /// @returns index of the best candidate according to the objective
+    size_t choose(const std::vector<Candidate>& candidates) const;
+
+    bool loadFromCache(const std::string& key, int& nstreams, unsigned int& nireq) const;
+    void saveToCache(const std::string& key, int nstreams, unsigned int nireq) const;
+
+    TuningConfig tuning;
+    std::chrono::milliseconds measureTime;
+};
@@ -14,8 +14,92 @@ DEFINE_bool(loop, false, loop_message);
 DEFINE_string(o, "", output_message); \
 DEFINE_uint32(limit, 1000, limit_message);
 
+#define DEFINE_OUTPUT_ENCODER_FLAGS \
+DEFINE_string(o_encoder, "mjpeg", o_encoder_message);
+
+#define DEFINE_METRICS_FLAGS \
+DEFINE_string(metrics_file, "", metrics_file_message);
+
+#define DEFINE_INPUTS_MEMORY_FLAGS \
+DEFINE_string(inputs_memory, "", inputs_memory_message);
+
+#define DEFINE_DEVICE_PREPROCESSING_FLAGS \
+DEFINE_bool(preprocess_on_device, false, preprocess_on_device_message);
+
+#define DEFINE_MOTION_GATE_FLAGS \
+DEFINE_double(motion_gate, 0, motion_gate_message); \
+DEFINE_uint32(motion_gate_max_skip, 30, motion_gate_max_skip_message);
+
+#define DEFINE_WARMUP_FLAGS \
+DEFINE_uint32(warmup, 0, warmup_message);
+
+#define DEFINE_LAYERS_PROFILE_FLAGS \
+DEFINE_uint32(profile_layers, 0, profile_layers_message);
+
+#define DEFINE_REMOTE_FLAGS \
+DEFINE_string(remote, "", remote_message);
+
+#define DEFINE_RESULTS_FLAGS \
+DEFINE_string(results, "", results_message);
+
+#define DEFINE_MAT_ALLOCATOR_FLAGS \
+DEFINE_uint32(mat_pool, 0, mat_pool_message); \
+DEFINE_bool(mat_pool_huge_pages, false, mat_pool_huge_pages_message);
+
+#define DEFINE_HALF_PRECISION_OUTPUTS_FLAGS \
+DEFINE_bool(fp16_outputs, false, fp16_outputs_message);
+
+#define DEFINE_DEVICE_PEAKS_FLAGS \
+DEFINE_bool(peaks_on_device, false, peaks_on_device_message);
+
+#define DEFINE_TUNING_FLAGS \
+DEFINE_string(tune, "", tune_message); \
+DEFINE_double(tune_latency, 0, tune_latency_message); \
+DEFINE_string(tune_cache, "tuning_cache.txt", tune_cache_message);
+
 static const char input_message[] = "Required. An input to process. The input must be a single image, a folder of "
     "images, video file or camera id.";
 static const char loop_message[] = "Optional. Enable reading the input in a loop.";
 static const char output_message[] = "Optional. Name of the output file(s) to save.";
 static const char limit_message[] = "Optional. Number of frames to store in output. If 0 is set, all frames are stored.";
+static const char o_encoder_message[] = "Optional. Encoder of -o video. Possible values: mjpeg, hw, vaapi, qsv. hw "
+    "encodes H.264 by the hardware accelerated backend of OpenCV, vaapi and qsv encode H.264 by a GStreamer pipeline "
+    "with VA-API or Intel Media SDK encoder, the extension of -o selects the container: .mp4, .mkv or .avi. Default "
+    "is mjpeg.";
+static const char metrics_file_message[] = "Optional. Path to a file to append performance metrics to every second as "
+    "JSON lines.";
+static const char inputs_memory_message[] = "Optional. Preallocate input tensors of infer requests once and write "
+    "preprocessed frames straight into them. Possible values: host, device. device allocates them in host memory of "
+    "the device, e.g. USM host memory of GPU, so the upload needs no staging copy. Not compatible with -auto_resize.";
+static const char preprocess_on_device_message[] = "Optional. Resize frames and apply -mean_values, -scale_values "
+    "and -reverse_input_channels on the inference device. The CPU only wraps frames into input tensors. Not "
+    "compatible with -auto_resize and -inputs_memory.";
+static const char motion_gate_message[] = "Optional. Don't infer frames which differ from the last inferred frame "
+    "less than this threshold, the result of the last inferred frame is reused for them. The difference is the mean "
+    "absolute difference of downscaled grayscale frames, in range [0, 1]. Default is 0, every frame is inferred.";
+static const char motion_gate_max_skip_message[] = "Optional. Maximal number of consecutive frames which aren't "
+    "inferred because of -motion_gate. Default is 30.";
+static const char warmup_message[] = "Optional. Number of inferences of dummy inputs run on every infer request "
+    "before processing, so lazy initialization of the device doesn't slow down the first frames. Default is 0.";
+static const char profile_layers_message[] = "Optional. Number of the slowest layers to report at exit and in "
+    "-metrics_file. Layers are profiled on every inference, so it slows the inference down. Default is 0, "
+    "profiling is disabled.";
+static const char remote_message[] = "Optional. Address <host>:<port> of an inference_worker_demo to infer the model "
+    "on, -d selects the device of the worker host. Capture, preprocessing and postprocessing stay local.";
+static const char results_message[] = "Optional. Address <host>:<port> of a TCP consumer or path to a file or a named "
+    "pipe to publish results of every frame to in a compact binary format.";
+static const char mat_pool_message[] = "Optional. Keep up to this many MB of freed image buffers for reuse by the next "
+    "images of the same size, so frames, crops and masks don't allocate fresh memory every frame. Statistics of the "
+    "pool are logged at the end of the run. Default is 0, the pool is disabled.";
+static const char mat_pool_huge_pages_message[] = "Optional. Back pooled image buffers of 2 MB and more by "
+    "transparent huge pages. Linux only, requires -mat_pool.";
+static const char fp16_outputs_message[] = "Optional. Get outputs of the model in FP16 instead of FP32, halving the "
+    "output data transferred from the device and read by postprocessing.";
+static const char peaks_on_device_message[] = "Optional. Find peaks of the heat maps on the inference device, so "
+    "only the highest peaks and the outputs sampled at them are transferred instead of the whole maps.";
+static const char tune_message[] = "Optional. Choose number of streams and infer requests by a short calibration run "
+    "before processing. Possible values: throughput, latency. -nstreams and -nireq are ignored if it is set.";
+static const char tune_latency_message[] = "Optional. Latency budget in ms for -tune throughput: the fastest "
+    "configuration with p95 latency below it is chosen. 0 means no budget.";
+static const char tune_cache_message[] = "Optional. File to store tuned configurations in, so the calibration is run "
+    "once per model, device and host. Empty value disables the cache.";
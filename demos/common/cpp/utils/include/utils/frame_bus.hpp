@@ -0,0 +1,87 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+/**
+ * @brief a header file for sharing decoded frames between processes of one host through shared memory
+ * @file frame_bus.hpp
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+#include <opencv2/core.hpp>
+
+#include "utils/images_capture.h"
+
+struct FrameBusHeader;
+
+/// Publishes decoded frames of one stream to a ring of slots in POSIX shared memory, so processes analyzing the same
+/// stream read the frames by FrameBusReader instead of decoding the stream themselves. Every frame gets the next
+/// sequence number and a timestamp of the steady clock, which is shared by processes of the host. The ring has a
+/// fixed number of slots and the producer never waits for consumers: the oldest frame is overwritten, so consumers
+/// which are slower than the stream skip frames. Not supported on Windows.
+class FrameBusWriter {
+public:
+    /// Creates the bus, a bus of the same name left by a crashed producer is replaced
+    /// @param name - name of the bus, consumers open it as "shm://<name>"
+    /// @param frameSize, type - size and OpenCV type of all frames of the stream
+    /// @param slotsNum - number of frames kept in the ring, should be at least 2
+    /// @param fps - frame rate reported by readers
+    FrameBusWriter(const std::string& name, cv::Size frameSize, int type, size_t slotsNum, double fps);
+    /// Marks the end of the stream and removes the name of the bus. Readers which have mapped it read the remaining
+    /// frames.
+    ~FrameBusWriter();
+    FrameBusWriter(const FrameBusWriter&) = delete;
+    FrameBusWriter& operator=(const FrameBusWriter&) = delete;
+
+    /// Copies the frame into the slot of the oldest frame
+    /// @returns sequence number of the frame
+    uint64_t publish(const cv::Mat& frame);
+
+private:
+    uint8_t* getSlot(uint64_t sequence) const;
+
+    std::string shmName;
+    FrameBusHeader* header;
+    size_t mappedSize;
+};
+
+/// Reads frames of a FrameBusWriter, see openImagesCapture() with "shm://<name>" input. Reading starts from the
+/// newest frame of the bus. Every frame is copied out of its slot once and checked to be not overwritten during the
+/// copy, frames overwritten before they are read are skipped and counted by getSkippedFrames(). read() waits for the
+/// next frame to be published and returns an empty frame once the producer has finished and the frames are read.
+/// getMetrics() reports latency from the publication of frames to their reading.
+class FrameBusReader : public ImagesCapture {
+public:
+    /// @param frameStep - every frameStep-th frame is returned, the others are skipped without copying
+    FrameBusReader(const std::string& name, size_t readLengthLimit, size_t frameStep);
+    ~FrameBusReader() override;
+
+    double fps() const override;
+
+    std::string getType() const override {
+        return "SHM";
+    }
+
+    cv::Mat read() override;
+    bool readInto(cv::Mat& frame) override;
+
+    /// @returns number of frames overwritten by the producer before they were read
+    uint64_t getSkippedFrames() const {
+        return skippedFrames;
+    }
+
+private:
+    const FrameBusHeader* header;
+    size_t mappedSize;
+    const size_t readLengthLimit;
+    const size_t frameStep;
+    size_t readFramesNum = 0;
+    uint64_t nextSequence;
+    uint64_t skippedFrames = 0;
+};
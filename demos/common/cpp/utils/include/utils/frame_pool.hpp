@@ -0,0 +1,51 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+#include <stddef.h>
+
+#include <deque>
+
+#include <opencv2/core.hpp>
+
+#include "utils/memory_accounting.hpp"
+
+class ImagesCapture;
+
+/// Recycles frame buffers of an input, so reading frames of the same size doesn't allocate and page fault memory once
+/// the pool has warmed up. A buffer returns to the pool when the last cv::Mat referring to it outside the pool is
+/// released, so frames are passed around as usual. Should be used by one thread. Memory of the pooled buffers is
+/// reported under the "FramePool" tag.
+class FramePool final {
+public:
+    /// @param capacity - maximum number of recycled buffers, frames read when all of them are busy get their own
+    /// buffers
+    explicit FramePool(size_t capacity);
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    /// Changes the maximum number of recycled buffers, e.g. once the number of infer requests is known. Buffers above
+    /// a reduced capacity stay in the pool.
+    void setCapacity(size_t newCapacity) {
+        capacity = newCapacity;
+    }
+
+    /// Returns a Mat whose buffer isn't referenced outside the pool, a frame should be read into it with
+    /// ImagesCapture::readInto() or cv::Mat::create() and copied out. The returned reference is valid until the next
+    /// call.
+    cv::Mat& acquire();
+
+    /// Reads the next frame of the capture into a pooled buffer and leases it: the buffer is reused only after every
+    /// copy of the returned Mat, e.g. in ImageInputData of an infer request and in ImageMetaData of a result being
+    /// rendered, is released. So the frame can be submitted to AsyncPipeline and rendered without cloning and the
+    /// capture can be opened with read_type::efficient. Frames left in memory the capture owns, e.g. in a buffer of a
+    /// video backend, are copied into the pooled buffer. Returns an empty Mat if there are no more frames.
+    cv::Mat read(ImagesCapture& capture);
+
+private:
+    size_t capacity;
+    std::deque<cv::Mat> buffers;  // deque keeps references to acquired buffers valid while it grows
+    cv::Mat overflow;
+    MemoryCounter buffersMemory{"FramePool"};
+};
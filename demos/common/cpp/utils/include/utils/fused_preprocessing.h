@@ -0,0 +1,49 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+#include <stddef.h>
+
+#include <opencv2/core.hpp>
+#include <openvino/openvino.hpp>
+
+/// Normalization applied to every pixel after resize: value = (pixel - means[c]) / scales[c].
+/// If reverseChannels is set, BGR image is written as RGB, means and scales are given for the written channels.
+struct NormalizationParams {
+    NormalizationParams() : reverseChannels(false), means(0, 0, 0), scales(1, 1, 1) {}
+    NormalizationParams(bool reverseChannels, const cv::Scalar& means, const cv::Scalar& scales)
+        : reverseChannels(reverseChannels),
+          means(means),
+          scales(scales) {}
+
+    bool reverseChannels;
+    cv::Scalar means;
+    cv::Scalar scales;
+};
+
+/// Resizes 8-bit image (1 or 3 channels) with bilinear interpolation, normalizes it and writes the result into the
+/// batch slot of the tensor in tensor's layout (NHWC or NCHW) and precision (u8, f32 or f16) in a single pass.
+/// Every source row is read once, no intermediate images are allocated.
+/// @param image - source image, may be a ROI
+/// @param tensor - destination tensor
+/// @param layout - layout of the tensor, NHWC or NCHW
+/// @param batchIdx - index of the batch slot to be filled
+/// @param params - normalization parameters
+void resizeNormalizeToTensor(const cv::Mat& image,
+                             const ov::Tensor& tensor,
+                             const ov::Layout& layout,
+                             size_t batchIdx = 0,
+                             const NormalizationParams& params = NormalizationParams());
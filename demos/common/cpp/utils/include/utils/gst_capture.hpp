@@ -0,0 +1,68 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+/**
+ * @brief a header file for reading frames by a native GStreamer pipeline with hardware decoding
+ * @file gst_capture.hpp
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#include <string>
+
+#include <opencv2/core.hpp>
+
+#include "utils/images_capture.h"
+
+struct _GstElement;
+struct _GstSample;
+
+/// Reads frames of a GStreamer pipeline from an appsink, see openImagesCapture() with "gst://<pipeline>" and
+/// "rtsp://" inputs. It's available if the demos are built with DEMOS_USE_GSTREAMER, otherwise the constructor throws.
+///
+/// "gst://" is followed by a pipeline description in gst-launch-1.0 syntax. If it has no appsink named "sink", the
+/// pipeline is completed by conversion to BGR and an appsink keeping all frames. RTSP URLs are decoded by uridecodebin
+/// and the appsink drops frames the demo is too slow for, so the latest frames are read. Hardware decoders (VA-API,
+/// Media SDK, NVDEC) which are installed are preferred over software ones.
+///
+/// With read_type::efficient frames are views of the decoded GstBuffers, mapped without copying. A buffer returns to
+/// the decoder once every copy of the cv::Mat referring to it is released, so frames shouldn't be kept longer than
+/// their processing takes: the decoder stalls once it runs out of buffers. With read_type::safe frames are copied.
+class GstCapture : public ImagesCapture {
+public:
+    /// @param frameStep - every frameStep-th frame is returned, the others are released without mapping
+    GstCapture(const std::string& input, bool loop, read_type type, size_t readLengthLimit, size_t frameStep);
+    ~GstCapture() override;
+    GstCapture(const GstCapture&) = delete;
+    GstCapture& operator=(const GstCapture&) = delete;
+
+    double fps() const override {
+        return captureFps;
+    }
+
+    std::string getType() const override {
+        return "VIDEO";
+    }
+
+    cv::Mat read() override;
+    bool readInto(cv::Mat& frame) override;
+
+private:
+    /// @returns the next sample of the appsink or null at the end of the stream, takes the preroll sample first
+    _GstSample* pullSample();
+    /// Rethrows the error posted on the bus of the pipeline, if any
+    void checkBusErrors();
+
+    _GstElement* pipeline = nullptr;
+    _GstElement* sink = nullptr;
+    // The first sample is pulled by the constructor to find out the frame rate and fail early
+    _GstSample* prerolledSample = nullptr;
+    const read_type type;
+    const size_t readLengthLimit;
+    const size_t frameStep;
+    size_t readFramesNum = 0;
+    double captureFps = 0;
+};
@@ -25,3 +25,17 @@ enum RESIZE_MODE {
 };
 
 cv::Mat resizeImageExt(const cv::Mat& mat, int width, int height, RESIZE_MODE resizeMode = RESIZE_FILL, bool hqResize = false, cv::Rect* roi = nullptr);
+
+/// Same as above, but writes the result into dst, which keeps its size. If dst already has the type of mat, no memory
+/// is allocated, so dst may be a view of externally allocated memory (e.g. of an input tensor).
+/// @param bordersFilled - true if dst keeps the padding of a previous call for an image of the same size, e.g. if dst
+/// is a reused input tensor, so only the image is resized into its ROI
+void resizeImageExt(const cv::Mat& mat, cv::Mat& dst, RESIZE_MODE resizeMode = RESIZE_FILL, bool hqResize = false,
+                    cv::Rect* roi = nullptr, bool bordersFilled = false);
+
+/// Downscales the image to a small grayscale thumbnail, motion of a scene is measured on thumbnails cheaply and
+/// insensitively to noise
+cv::Mat makeMotionThumbnail(const cv::Mat& image);
+
+/// @returns mean absolute difference of two thumbnails made by makeMotionThumbnail(), in range [0, 1]
+double getMotion(const cv::Mat& thumbnail, const cv::Mat& prevThumbnail);
@@ -5,12 +5,18 @@
 #pragma once
 #include <stddef.h>
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 
 #include <opencv2/core.hpp>
 
+#include "utils/memory_accounting.hpp"
 #include "utils/performance_metrics.hpp"
 
 enum class read_type { efficient, safe };
@@ -22,8 +28,14 @@ public:
     ImagesCapture(bool loop) : loop{loop} {}
     virtual double fps() const = 0;
     virtual cv::Mat read() = 0;
+    /// Reads the next frame into frame. The buffer of frame is reused if it has the size and the type of the read
+    /// frame, so callers recycling buffers avoid allocations. Returns false if there are no more frames.
+    virtual bool readInto(cv::Mat& frame) {
+        frame = read();
+        return frame.data != nullptr;
+    }
     virtual std::string getType() const = 0;
-    const PerformanceMetrics& getMetrics() {
+    virtual const PerformanceMetrics& getMetrics() {
         return readerMetrics;
     }
     virtual ~ImagesCapture() = default;
@@ -32,6 +44,59 @@ protected:
     PerformanceMetrics readerMetrics;
 };
 
+/// Decorator decoding frames of another capture on a background thread ahead of read() calls, so decoding overlaps
+/// with processing of previous frames. Up to queueSize decoded frames wait in the queue. getMetrics() reports decoding
+/// latency of the wrapped capture, time read() spent waiting for the decoder is reported by getStallTime().
+class PrefetchingCapture : public ImagesCapture {
+public:
+    /// @param capture - capture to read frames from. It should return copies of frames (read_type::safe), because
+    /// several frames are kept in the queue.
+    /// @param queueSize - maximum number of decoded frames waiting to be read, should be positive
+    PrefetchingCapture(std::unique_ptr<ImagesCapture>&& capture, size_t queueSize);
+    ~PrefetchingCapture() override;
+
+    double fps() const override {
+        return captureFps;
+    }
+
+    std::string getType() const override {
+        return captureType;
+    }
+
+    /// Returns the next decoded frame, waits for it if the queue is empty. Rethrows exceptions of the wrapped capture.
+    cv::Mat read() override;
+
+    const PerformanceMetrics& getMetrics() override;
+
+    /// @returns number of decoded frames waiting in the queue
+    size_t getQueueDepth();
+
+    /// @returns total time read() waited for frames to be decoded
+    PerformanceMetrics::Duration getStallTime();
+
+private:
+    void prefetchingThreadFunc();
+
+    std::unique_ptr<ImagesCapture> capture;
+    const size_t queueSize;
+    // fps() and getType() of the wrapped capture aren't called concurrently with its read()
+    const double captureFps;
+    const std::string captureType;
+
+    std::mutex mtx;
+    std::condition_variable condVar;
+    std::deque<cv::Mat> frames;
+    MemoryCounter framesMemory{"ImagesCapture.prefetch"};
+    bool endOfStream = false;
+    bool stopPrefetching = false;
+    std::exception_ptr prefetchingException;
+    // Copy of metrics of the wrapped capture updated after every decoded frame
+    PerformanceMetrics captureMetrics;
+    PerformanceMetrics::Duration stallTime = PerformanceMetrics::Duration::zero();
+
+    std::thread prefetchingThread;
+};
+
 // An advanced version of
 // try {
 //     return cv::VideoCapture(std::stoi(input));
@@ -43,10 +108,42 @@ protected:
 // Some VideoCapture backends continue owning the video buffer under cv::Mat. safe_copy forses to return a copy from
 // read()
 // https://github.com/opencv/opencv/blob/46e1560678dba83d25d309d8fbce01c40f21b7be/modules/gapi/include/opencv2/gapi/streaming/cap.hpp#L72-L76
+// Files of frames packed by demos/common/python/pack_frames.py are memory mapped and read without decoding.
+// "shm://<name>" inputs read frames published by another process to the FrameBusWriter of the name, see
+// demos/frame_bus_demo.
+// "gst://<pipeline>" inputs and, if the demos are built with DEMOS_USE_GSTREAMER, RTSP URLs are read by GstCapture with
+// hardware decoding.
+// If prefetchQueueSize is positive, the capture is wrapped into PrefetchingCapture decoding up to prefetchQueueSize
+// frames ahead, frames are always copied then
+// Videos and cameras return every frameStep-th frame, the frames between them are grabbed without decoding.
+// videoAcceleration and videoAccelerationDevice are values of cv::CAP_PROP_HW_ACCELERATION (cv::VideoAccelerationType)
+// and cv::CAP_PROP_HW_DEVICE for decoding of videos, they require OpenCV 4.5.2 or newer.
+// If lowLatency is true, videos and network streams are read with the minimal buffering of the backend by a background
+// thread which keeps only the newest frame, so read() returns the freshest frame of a live stream instead of the
+// frames buffered while the previous ones were processed. Replaced frames are counted as dropped by getMetrics().
+// It isn't compatible with prefetchQueueSize, read frames are always copies then.
 std::unique_ptr<ImagesCapture> openImagesCapture(
     const std::string& input,
     bool loop,
     read_type type = read_type::efficient,
     size_t initialImageId = 0,
     size_t readLengthLimit = std::numeric_limits<size_t>::max(),  // General option
-    cv::Size cameraResolution = {1280, 720});
+    cv::Size cameraResolution = {1280, 720},
+    size_t prefetchQueueSize = 0,
+    size_t frameStep = 1,
+    int videoAcceleration = 0,  // cv::VIDEO_ACCELERATION_NONE
+    int videoAccelerationDevice = -1,
+    bool lowLatency = false);
+
+/// Opens a directory of images like openImagesCapture(), but decodes images by a pool of threads ahead of read() calls.
+/// Images are returned in the same order as files are read by openImagesCapture(), undecodable files are skipped.
+/// @param decodingThreads - number of threads decoding images, should be positive
+/// @param cacheSizeLimit - memory limit in bytes for decoded images kept for next passes over the directory if loop is
+/// true. The least recently used images are evicted if the limit is exceeded. 0 disables caching.
+std::unique_ptr<ImagesCapture> openParallelDirReader(
+    const std::string& input,
+    bool loop,
+    size_t decodingThreads,
+    size_t cacheSizeLimit = 0,
+    size_t initialImageId = 0,
+    size_t readLengthLimit = std::numeric_limits<size_t>::max());
@@ -0,0 +1,62 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <stdint.h>
+
+// Named tasks on the hot paths of the demos for Intel VTune Profiler. They are compiled only if the demos are built
+// with DEMOS_USE_ITT CMake option, otherwise the macros expand to nothing. All tasks belong to "omz_demos" domain, so
+// they are shown next to OpenVINO's own tasks. Frame ID is attached to a task as "frame_id" metadata, so stages of the
+// same frame can be found on all threads.
+#ifdef USE_ITT
+#include <ittnotify.h>
+
+namespace itt {
+__itt_domain* getDomain();
+
+/// @param name - name of the task, it should live until the end of the program, e.g. be a string literal
+__itt_string_handle* getHandle(const char* name);
+
+/// Task running on the calling thread until the end of the scope
+class ScopedTask {
+public:
+    explicit ScopedTask(__itt_string_handle* name) {
+        __itt_task_begin(getDomain(), __itt_null, __itt_null, name);
+    }
+    ScopedTask(__itt_string_handle* name, int64_t frameId);
+    ~ScopedTask() {
+        __itt_task_end(getDomain());
+    }
+    ScopedTask(const ScopedTask&) = delete;
+    ScopedTask& operator=(const ScopedTask&) = delete;
+};
+
+/// Begins task which may end on another thread, e.g. inference started on the submitting thread and completed in the
+/// callback. The task is identified by the owner (any object unique among running tasks) and frame ID.
+void beginOverlappedTask(__itt_string_handle* name, const void* owner, int64_t frameId);
+void endOverlappedTask(const void* owner, int64_t frameId);
+}  // namespace itt
+
+#define ITT_CONCAT_IMPL(a, b) a##b
+#define ITT_CONCAT(a, b) ITT_CONCAT_IMPL(a, b)
+#define ITT_HANDLE(name) \
+    static __itt_string_handle* const ITT_CONCAT(ittHandle, __LINE__) = ::itt::getHandle(name)
+
+#define ITT_SCOPED_TASK(name) \
+    ITT_HANDLE(name); \
+    ::itt::ScopedTask ITT_CONCAT(ittTask, __LINE__)(ITT_CONCAT(ittHandle, __LINE__))
+#define ITT_SCOPED_FRAME_TASK(name, frameId) \
+    ITT_HANDLE(name); \
+    ::itt::ScopedTask ITT_CONCAT(ittTask, __LINE__)(ITT_CONCAT(ittHandle, __LINE__), frameId)
+#define ITT_BEGIN_FRAME_TASK(name, owner, frameId) \
+    ITT_HANDLE(name); \
+    ::itt::beginOverlappedTask(ITT_CONCAT(ittHandle, __LINE__), owner, frameId)
+#define ITT_END_FRAME_TASK(owner, frameId) ::itt::endOverlappedTask(owner, frameId)
+#else
+#define ITT_SCOPED_TASK(name)
+#define ITT_SCOPED_FRAME_TASK(name, frameId)
+#define ITT_BEGIN_FRAME_TASK(name, owner, frameId)
+#define ITT_END_FRAME_TASK(owner, frameId)
+#endif
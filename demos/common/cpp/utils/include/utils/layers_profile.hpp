@@ -0,0 +1,58 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+/**
+ * @brief a header file for aggregation of per-layer profiling info of infer requests
+ * @file layers_profile.hpp
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <openvino/openvino.hpp>
+
+/// Sums execution times of layers reported by ov::InferRequest::get_profiling_info() over inferences of all infer
+/// requests of a compiled model, so the slowest layers of a model can be found in the running pipeline. The compiled
+/// model must have ov::enable_profiling set. Layers are keyed by names, so layers of requests of the same compiled
+/// model are summed up. The profile is thread safe.
+class LayersProfile {
+public:
+    struct Layer {
+        std::string name;
+        std::string nodeType;
+        std::string execType;  // implementation chosen by the device, e.g. jit_avx2_I8
+        std::string precision;  // runtime precision, empty if the device doesn't report it
+        std::chrono::microseconds totalTime{0};
+        size_t executionsNum = 0;
+    };
+
+    /// Takes runtime precisions of layers from the runtime model of compiledModel, if the device provides it
+    explicit LayersProfile(const ov::CompiledModel& compiledModel);
+
+    /// Adds times of layers executed by the last inference of the request, which must be completed
+    void add(const ov::InferRequest& request);
+
+    /// @returns layers sorted by total time, at most layersNum of them
+    std::vector<Layer> getTop(size_t layersNum) const;
+
+    size_t getInferencesNum() const;
+
+    /// Logs the top layers with mean times per inference and their shares of the time of all layers
+    void logTop(size_t layersNum) const;
+
+private:
+    std::map<std::string, std::string> precisions;
+
+    mutable std::mutex mtx;
+    std::map<std::string, Layer> layers;
+    std::chrono::microseconds totalTime{0};
+    size_t inferencesNum = 0;
+};
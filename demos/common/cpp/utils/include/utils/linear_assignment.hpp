@@ -0,0 +1,51 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include "opencv2/core.hpp"
+
+#include <vector>
+
+///
+/// \brief The LinearAssignment class
+///
+/// Solves the assignment problem by the shortest augmenting paths of the
+/// Jonker-Volgenant algorithm. Results are compatible with KuhnMunkres, but
+/// the matrix isn't rescanned on every step, and the sparse version visits
+/// only the given candidate pairs.
+///
+class LinearAssignment {
+public:
+    ///
+    /// \brief A candidate pair for the sparse assignment problem.
+    ///
+    struct Edge {
+        int row;
+        int col;
+        float cost;
+    };
+
+    ///
+    /// \brief Solves the assignment problem for given dissimilarity matrix.
+    /// \param dissimilarity_matrix CV_32F dissimilarity matrix.
+    /// \return Optimal column index for each row. -1 means that there is no
+    /// column for row, it happens only if there are more rows than columns.
+    ///
+    std::vector<size_t> Solve(const cv::Mat &dissimilarity_matrix);
+
+    ///
+    /// \brief Solves the assignment problem over the candidate pairs only,
+    /// pairs which aren't given can't be matched. A row may stay unmatched
+    /// for unmatched_cost, so the total cost of the matched pairs and the
+    /// unmatched rows is minimized.
+    /// \param rows Number of rows.
+    /// \param cols Number of columns.
+    /// \param edges Candidate pairs.
+    /// \param unmatched_cost The cost of leaving a row unmatched.
+    /// \return Optimal column index for each row. -1 means that there is no
+    /// column for row.
+    ///
+    std::vector<size_t> Solve(int rows, int cols, const std::vector<Edge> &edges, float unmatched_cost);
+};
@@ -0,0 +1,63 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+/**
+ * @brief a header file for accounting of memory held by components of the demos
+ * @file memory_accounting.hpp
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+/// Bytes held by a component of the demos, e.g. tensors of infer requests or decoded frames waiting in a queue.
+/// Counters are summed per tag in a process-wide registry, which keeps current and peak bytes of every tag after its
+/// counters are destroyed. Tags are reported by logMemoryUsage() and by every MetricsSink publication, so they can be
+/// compared with the process memory reported by MemoryMonitor. The counters are thread safe.
+class MemoryCounter {
+public:
+    explicit MemoryCounter(const std::string& tag);
+    /// Subtracts bytes still held by the counter from its tag
+    ~MemoryCounter();
+    MemoryCounter(const MemoryCounter&) = delete;
+    MemoryCounter& operator=(const MemoryCounter&) = delete;
+
+    void add(size_t bytes);
+    void subtract(size_t bytes);
+    /// Replaces bytes of the counter, for components which estimate their memory instead of tracking every change
+    void set(size_t bytes);
+
+    size_t get() const {
+        return bytes;
+    }
+
+    struct TagUsage;
+
+private:
+    TagUsage* tagUsage;
+    std::atomic<size_t> bytes;
+};
+
+struct MemoryUsage {
+    std::string tag;
+    size_t bytes;
+    size_t peakBytes;
+};
+
+/// @returns memory of every tag which had a counter, sorted by tag
+std::vector<MemoryUsage> getMemoryUsage();
+
+/// Logs current and peak memory of every tag
+void logMemoryUsage();
+
+/// @returns bytes of pixels of the image. Memory shared by several images is counted for each of them.
+inline size_t getMatBytes(const cv::Mat& mat) {
+    return mat.total() * mat.elemSize();
+}
@@ -0,0 +1,50 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+/**
+ * @brief a header file for periodic export of performance metrics in machine-readable form
+ * @file metrics_sink.hpp
+ */
+
+#pragma once
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "utils/performance_metrics.hpp"
+
+/// Appends metrics to a file as JSON lines, one object per publish() call:
+/// {"timestamp": <unix time, s>, "stages": {"<name>": {"fps", "latency", "p50", "p95", "p99", "dropped"}, ...},
+///  "values": {"<name>": <number>, ...}, "memory": {"<tag>": {"bytes", "peak"}, ...}}
+/// Latencies are in milliseconds, metrics which aren't available yet are written as null. Memory is reported for all
+/// tags of MemoryCounter.
+/// Every line is flushed, so the file can be tailed by a scraper while the demo runs.
+class MetricsSink {
+public:
+    /// @param path - file to append metrics to
+    /// @param period - minimal time between publications reported by isDue()
+    explicit MetricsSink(const std::string& path,
+                         PerformanceMetrics::Duration period = std::chrono::seconds(1));
+
+    /// @returns true if the period has passed since the last publication
+    bool isDue() const;
+
+    /// Adds metrics of a pipeline stage to the next publication
+    MetricsSink& stage(const std::string& name, const PerformanceMetrics::Metrics& metrics);
+    /// Adds a named value (queue depth, resource usage, etc.) to the next publication
+    MetricsSink& value(const std::string& name, double value);
+
+    /// Writes accumulated stages and values as one line and clears them
+    void publish();
+
+private:
+    std::ofstream file;
+    PerformanceMetrics::Duration period;
+    PerformanceMetrics::TimePoint lastPublishTime;
+    std::vector<std::pair<std::string, PerformanceMetrics::Metrics>> stages;
+    std::vector<std::pair<std::string, double>> values;
+};
@@ -0,0 +1,105 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+/**
+ * @brief a header file for association of tracks of several cameras into global identities
+ * @file multi_camera_association.hpp
+ */
+
+#pragma once
+#include <stddef.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+/// Assigns global identities to tracks of several cameras by their ReID embeddings. Trackers of the cameras, each on
+/// its own thread, post embeddings of their tracks, and a matching step associates the tracks posted since the
+/// previous step in one batch: similarities of all new tracks to all identities are computed by one matrix product
+/// and the gated pairs are matched by the sparse LinearAssignment solver for each camera, so a camera never has two
+/// tracks of the same identity at a time. Identities are represented by normalized mean embeddings of their tracks.
+/// If the store of identities is full, the least recently seen identity without live tracks is forgotten.
+class MultiCameraAssociator {
+public:
+    struct Params {
+        /// Tracks less similar to every identity get new identities
+        float minSimilarity = 0.6f;
+        /// Weight of the previous mean embedding of an identity when a new embedding of its track is averaged in
+        float momentum = 0.9f;
+        /// Maximum number of remembered identities, 0 means no limit
+        size_t maxIdentities = 10000;
+    };
+
+    struct Stats {
+        size_t matched = 0;  // new tracks associated with known identities
+        size_t created = 0;  // new tracks which got new identities
+        size_t forgotten = 0;  // identities forgotten because the store was full
+    };
+
+    explicit MultiCameraAssociator(const Params& params);
+    MultiCameraAssociator(const MultiCameraAssociator&) = delete;
+    MultiCameraAssociator& operator=(const MultiCameraAssociator&) = delete;
+    /// Stops the periodic matching, embeddings which weren't matched yet are discarded
+    ~MultiCameraAssociator();
+
+    /// Posts the latest embedding of a track, can be called by several threads. Only the last embedding of a track
+    /// posted between two matching steps is used.
+    void post(size_t camera, size_t track, const cv::Mat& embedding);
+
+    /// Reports the end of a track, its identity may be given to a new track of the camera after the next matching step
+    void finish(size_t camera, size_t track);
+
+    /// @returns the global identity of the track, or -1 if the track wasn't matched yet
+    int getIdentity(size_t camera, size_t track) const;
+
+    /// Matches the tracks posted since the previous step
+    void associate();
+
+    /// Runs associate() on a background thread every period until the destruction
+    void startPeriodicAssociation(std::chrono::milliseconds period);
+
+    Stats getStats() const;
+
+private:
+    struct Post {
+        std::pair<size_t, size_t> key;  // camera and track
+        cv::Mat embedding;  // empty if the track finished
+    };
+
+    struct TrackState {
+        int row;  // row of the identity in the store
+        int identity;
+    };
+
+    void update(int row, const cv::Mat& embedding);
+    int addIdentity(const cv::Mat& embedding);
+    void periodicAssociationFunc(std::chrono::milliseconds period);
+
+    const Params params;
+
+    std::mutex postsMtx;
+    std::vector<Post> posts;
+
+    mutable std::mutex stateMtx;
+    std::map<std::pair<size_t, size_t>, TrackState> tracks;
+    // Normalized mean embeddings, rows above identities.size() are preallocated
+    cv::Mat embeddings;
+    std::vector<int> identities;  // identity of every row
+    std::vector<size_t> liveTracksNum;  // tracks of every row, rows with live tracks are never forgotten
+    std::vector<size_t> lastSeen;  // step which updated every row last
+    size_t stepsNum = 0;
+    int nextIdentity = 0;
+    Stats stats;
+
+    std::mutex threadMtx;
+    std::condition_variable condVar;
+    bool stopAssociation = false;
+    std::thread associationThread;
+};
@@ -1,5 +1,5 @@
 /*
-// Copyright (C) 2021 Intel Corporation
+// Copyright (C) 2021-2022 Intel Corporation
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -15,47 +15,99 @@
 */
 
 #pragma once
+#include <stddef.h>
 
-#include "opencv2/core.hpp"
 #include <vector>
 
+enum class NmsMethod {
+    Hard,  ///< boxes overlapping a kept box with IoU >= threshold are removed
+    Soft,  ///< scores of overlapping boxes are decayed by exp(-IoU^2 / sigma) (Gaussian Soft-NMS)
+    DIoU   ///< like Hard, but IoU is penalized by normalized distance between box centers
+};
+
+struct NmsParams {
+    NmsParams(float iouThreshold = 0.5f)
+        : iouThreshold(iouThreshold),
+          scoreThreshold(0.0f),
+          topK(0),
+          includeBoundaries(false),
+          perClass(false),
+          method(NmsMethod::Hard),
+          softNmsSigma(0.5f) {}
+
+    float iouThreshold;
+    /// Boxes with lower scores are dropped before sorting. With Soft-NMS boxes are also dropped when their
+    /// decayed score falls below the threshold.
+    float scoreThreshold;
+    /// Number of the best boxes taking part in NMS, 0 means all of them
+    size_t topK;
+    /// If true, 1 is added to width and height of boxes when their areas are computed
+    bool includeBoundaries;
+    /// If true, only boxes of the same class suppress each other
+    bool perClass;
+    NmsMethod method;
+    float softNmsSigma;
+};
+
+/// Candidate boxes of NMS stored as structure of arrays, so overlaps of a box with all the others are computed in
+/// loops over contiguous arrays which compilers vectorize.
+struct NmsBoxes {
+    void reserve(size_t size) {
+        left.reserve(size);
+        top.reserve(size);
+        right.reserve(size);
+        bottom.reserve(size);
+        scores.reserve(size);
+        classIds.reserve(size);
+    }
+
+    void add(float boxLeft, float boxTop, float boxRight, float boxBottom, float score, int classId = 0) {
+        left.push_back(boxLeft);
+        top.push_back(boxTop);
+        right.push_back(boxRight);
+        bottom.push_back(boxBottom);
+        scores.push_back(score);
+        classIds.push_back(classId);
+    }
+
+    /// Removes the boxes but keeps the memory, so the object can be reused as a scratch buffer
+    void clear() {
+        left.clear();
+        top.clear();
+        right.clear();
+        bottom.clear();
+        scores.clear();
+        classIds.clear();
+    }
+
+    size_t size() const {
+        return scores.size();
+    }
+
+    std::vector<float> left;
+    std::vector<float> top;
+    std::vector<float> right;
+    std::vector<float> bottom;
+    std::vector<float> scores;
+    std::vector<int> classIds;
+};
+
+/// Non-maximum suppression
+/// @param boxes - candidate boxes
+/// @param params - parameters of NMS
+/// @param keptScores - if not null, receives scores of the kept boxes, which differ from the original ones for Soft-NMS
+/// @returns indices of kept boxes in the order of decreasing score
+std::vector<int> nms(const NmsBoxes& boxes, const NmsParams& params, std::vector<float>* keptScores = nullptr);
 
 template <typename Anchor>
 std::vector<int> nms(const std::vector<Anchor>& boxes, const std::vector<float>& scores,
                      const float thresh, bool includeBoundaries=false) {
-    std::vector<float> areas(boxes.size());
+    NmsBoxes candidates;
+    candidates.reserve(boxes.size());
     for (size_t i = 0; i < boxes.size(); ++i) {
-        areas[i] = (boxes[i].right - boxes[i].left + includeBoundaries) * (boxes[i].bottom - boxes[i].top + includeBoundaries);
-    }
-    std::vector<int> order(scores.size());
-    std::iota(order.begin(), order.end(), 0);
-    std::sort(order.begin(), order.end(), [&scores](int o1, int o2) { return scores[o1] > scores[o2]; });
-
-    size_t ordersNum = 0;
-    for (; ordersNum < order.size() && scores[order[ordersNum]] >= 0; ordersNum++);
-
-    std::vector<int> keep;
-    bool shouldContinue = true;
-    for (size_t i = 0; shouldContinue && i < ordersNum; ++i) {
-        auto idx1 = order[i];
-        if (idx1 >= 0) {
-            keep.push_back(idx1);
-            shouldContinue = false;
-            for (size_t j = i + 1; j < ordersNum; ++j) {
-                auto idx2 = order[j];
-                if (idx2 >= 0) {
-                    shouldContinue = true;
-                    auto overlappingWidth = std::fminf(boxes[idx1].right, boxes[idx2].right) - std::fmaxf(boxes[idx1].left, boxes[idx2].left);
-                    auto overlappingHeight = std::fminf(boxes[idx1].bottom, boxes[idx2].bottom) - std::fmaxf(boxes[idx1].top, boxes[idx2].top);
-                    auto intersection = overlappingWidth > 0 && overlappingHeight > 0 ? overlappingWidth * overlappingHeight : 0;
-                    auto overlap = intersection / (areas[idx1] + areas[idx2] - intersection);
-
-                    if (overlap >= thresh) {
-                        order[j] = -1;
-                    }
-                }
-            }
-        }
+        candidates.add(boxes[i].left, boxes[i].top, boxes[i].right, boxes[i].bottom, scores[i]);
     }
-    return keep;
+    NmsParams params(thresh);
+    params.includeBoundaries = includeBoundaries;
+    return nms(candidates, params);
 }
@@ -9,11 +9,23 @@
 
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include <opencv2/opencv.hpp>
 #include <openvino/openvino.hpp>
 
 #include "utils/common.hpp"
+#include "utils/itt.hpp"
 #include "utils/shared_tensor_allocator.hpp"
+#ifdef USE_FUSED_PREPROCESSING
+#include "utils/fused_preprocessing.h"
+#endif
 
 /**
 * @brief Get cv::Mat value in the correct format.
@@ -47,6 +59,12 @@ static UNUSED void matToTensor(const cv::Mat& mat, const ov::Tensor& tensor, int
     if (channels != 1 && channels != 3) {
         throw std::runtime_error("Unsupported number of channels");
     }
+#ifdef USE_FUSED_PREPROCESSING
+    if (mat.depth() == CV_8U) {
+        resizeNormalizeToTensor(mat, tensor, layout, batchIndex);
+        return;
+    }
+#endif
     int batchOffset = batchIndex * width * height * channels;
 
     cv::Mat resizedMat;
@@ -103,12 +121,16 @@ static UNUSED ov::Tensor wrapMat2Tensor(const cv::Mat& mat) {
 static inline void resize2tensor(const cv::Mat& mat, const ov::Tensor& tensor) {
     static const ov::Layout layout{"NHWC"};
     const ov::Shape& shape = tensor.get_shape();
-    cv::Size size{int(shape[ov::layout::width_idx(layout)]), int(shape[ov::layout::height_idx(layout)])};
     assert(tensor.get_element_type() == ov::element::u8);
     assert(shape.size() == 4);
     assert(shape[ov::layout::batch_idx(layout)] == 1);
     assert(shape[ov::layout::channels_idx(layout)] == 3);
+#ifdef USE_FUSED_PREPROCESSING
+    resizeNormalizeToTensor(mat, tensor, layout);
+#else
+    cv::Size size{int(shape[ov::layout::width_idx(layout)]), int(shape[ov::layout::height_idx(layout)])};
     cv::resize(mat, cv::Mat{size, CV_8UC3, tensor.data()}, size);
+#endif
 }
 
 static inline ov::Layout getLayoutFromShape(const ov::Shape& shape) {
@@ -166,14 +188,30 @@ public:
     }
 
     void resize(cv::Mat& image) {
-        if (!doResize) { return; }
-        cv::Size currSize = image.size();
-        if (currSize != inputSize) {
-            inputSize = currSize;
+        resize(image, image);
+    }
+
+    /// Resizes the image to the output resolution into dst, the buffer of dst is reused if it has the output size
+    /// already. The image itself isn't modified, dst refers to it if it doesn't need to be resized.
+    void resize(const cv::Mat& image, cv::Mat& dst, int interpolation = cv::INTER_LINEAR) {
+        const cv::Size outputSize = getOutputSize(image.size());
+        if (outputSize == image.size()) {
+            dst = image;
+            return;
+        }
+        ITT_SCOPED_TASK("OutputTransform::resize");
+        cv::resize(image, dst, outputSize, 0, 0, interpolation);
+    }
+
+    /// @returns size of a frame of frameSize after the transform. Results can be kept in input coordinates and
+    /// rendered straight at this size, e.g. a mask can be resized to it once instead of to the frame first.
+    cv::Size getOutputSize(const cv::Size& frameSize) {
+        if (!doResize) { return frameSize; }
+        if (frameSize != inputSize) {
+            inputSize = frameSize;
             computeResolution();
         }
-        if (scaleFactor == 1) { return; }
-        cv::resize(image, image, newResolution);
+        return scaleFactor == 1 ? frameSize : newResolution;
     }
 
     template<typename T>
@@ -243,11 +281,55 @@ public:
         return (result - means) / stdScales;
     }
 
+    /// Writes transformed inputs into outputs, which keep their size and memory if they already have the type of the
+    /// result (CV_32F if the transform isn't trivial). Buffer for channels reversal is allocated once and reused.
+    void operator()(const cv::Mat& inputs, cv::Mat& outputs) {
+        if (isTrivial) {
+            inputs.copyTo(outputs);
+            return;
+        }
+        const cv::Mat* source = &inputs;
+        if (reverseInputChannels) {
+            cv::cvtColor(inputs, reversedInputs, cv::COLOR_BGR2RGB);
+            source = &reversedInputs;
+        }
+        source->convertTo(outputs, CV_32F);
+        cv::subtract(outputs, means, outputs);
+        cv::divide(outputs, stdScales, outputs);
+    }
+
+    bool isTrivialTransform() const {
+        return isTrivial;
+    }
+
+    /// Appends the transform to preprocessing steps of a model input, so the inference device does it. The input
+    /// tensor should have the channels dimension in its layout.
+    void embed(ov::preprocess::PreProcessSteps& steps) const {
+        if (isTrivial) {
+            return;
+        }
+        steps.convert_element_type(ov::element::f32);
+        if (reverseInputChannels) {
+            steps.reverse_channels();
+        }
+        steps.mean({static_cast<float>(means[0]), static_cast<float>(means[1]), static_cast<float>(means[2])});
+        steps.scale({static_cast<float>(stdScales[0]),
+                     static_cast<float>(stdScales[1]),
+                     static_cast<float>(stdScales[2])});
+    }
+
+#ifdef USE_FUSED_PREPROCESSING
+    NormalizationParams getNormalizationParams() const {
+        return NormalizationParams(reverseInputChannels, means, stdScales);
+    }
+#endif
+
 private:
     bool reverseInputChannels;
     bool isTrivial;
     cv::Scalar means;
     cv::Scalar stdScales;
+    cv::Mat reversedInputs;
 };
 
 class LazyVideoWriter {
@@ -258,19 +340,226 @@ public:
     const double fps;
     const unsigned lim;
 
+    /// What write() does in the asynchronous mode if all buffers are waiting to be encoded
+    enum class QueuePolicy {
+        Block,  ///< waits for the encoder to release a buffer
+        Drop    ///< drops the frame
+    };
+
+    /// Encoder of the output video
+    enum class Encoder {
+        Mjpeg,     ///< software Motion JPEG (default)
+        Hardware,  ///< H.264 by the hardware accelerated backend of cv::VideoWriter, requires OpenCV 4.5.2 or newer.
+                   ///< The backend falls back to software encoding if no accelerator is available.
+        Vaapi,     ///< H.264 by a GStreamer pipeline with VA-API encoder, requires OpenCV built with GStreamer
+        Qsv        ///< H.264 by a GStreamer pipeline with Intel Media SDK encoder, requires OpenCV built with GStreamer
+    };
+
+    /// @param name - mjpeg, hw, vaapi or qsv, empty name means mjpeg
+    static Encoder parseEncoder(const std::string& name) {
+        if (name.empty() || name == "mjpeg") {
+            return Encoder::Mjpeg;
+        } else if (name == "hw") {
+            return Encoder::Hardware;
+        } else if (name == "vaapi") {
+            return Encoder::Vaapi;
+        } else if (name == "qsv") {
+            return Encoder::Qsv;
+        }
+        throw std::invalid_argument("Unknown video encoder " + name + ", possible values: mjpeg, hw, vaapi, qsv");
+    }
+
     LazyVideoWriter(const std::string& filenames, double fps, unsigned lim) :
-        nwritten{1}, filenames{filenames}, fps{fps}, lim{lim} {}
+        nwritten{1}, filenames{filenames}, fps{fps}, lim{lim}, nsubmitted{0}, isAsync{false} {}
+
+    /// Creates the writer encoding frames on a dedicated thread. write() copies frames into one of queueSize reusable
+    /// buffers and returns, so encoding doesn't slow down the caller.
+    LazyVideoWriter(const std::string& filenames, double fps, unsigned lim, size_t queueSize,
+                    QueuePolicy policy = QueuePolicy::Block) :
+        nwritten{1}, filenames{filenames}, fps{fps}, lim{lim}, nsubmitted{0}, isAsync{true}, policy{policy},
+        freeBuffers(queueSize) {
+        if (queueSize == 0) {
+            throw std::invalid_argument("Queue size of video writer must be positive");
+        }
+        if (!filenames.empty()) {
+            encoderThread = std::thread(&LazyVideoWriter::encoderThreadFunc, this);
+        }
+    }
+
+    LazyVideoWriter(const LazyVideoWriter&) = delete;
+    LazyVideoWriter& operator=(const LazyVideoWriter&) = delete;
+
+    /// Selects the encoder, should be called before the first frame is written. H.264 encoders put the video into
+    /// the container chosen by the extension of the file: GStreamer pipelines support .mp4, .mkv and .avi.
+    void setEncoder(Encoder newEncoder) {
+        const std::lock_guard<std::mutex> lock(mtx);
+        encoder = newEncoder;
+    }
+
+    /// Waits for queued frames to be encoded
+    ~LazyVideoWriter() {
+        if (encoderThread.joinable()) {
+            {
+                const std::lock_guard<std::mutex> lock(mtx);
+                stopEncoding = true;
+            }
+            condVar.notify_all();
+            encoderThread.join();
+        }
+    }
+
     void write(cv::InputArray im) {
+        if (!isAsync) {
+            writeFrame(im);
+            return;
+        }
+        // Frames above the limit aren't written anyway, don't copy them
+        if (filenames.empty() || (lim != 0 && nsubmitted >= lim)) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mtx);
+        if (encoderException) {
+            std::rethrow_exception(encoderException);
+        }
+        if (freeBuffers.empty()) {
+            if (policy == QueuePolicy::Drop) {
+                ++droppedFrames;
+                return;
+            }
+            condVar.wait(lock, [&]() {
+                return !freeBuffers.empty() || encoderException;
+            });
+            if (encoderException) {
+                std::rethrow_exception(encoderException);
+            }
+        }
+        cv::Mat buffer = std::move(freeBuffers.back());
+        freeBuffers.pop_back();
+        lock.unlock();
+        // Keeps the memory of the buffer if the frame size doesn't change
+        im.copyTo(buffer);
+        lock.lock();
+        queuedFrames.push_back(std::move(buffer));
+        ++nsubmitted;
+        condVar.notify_all();
+    }
+
+    /// @returns total time spent on encoding
+    std::chrono::steady_clock::duration getEncodingTime() {
+        const std::lock_guard<std::mutex> lock(mtx);
+        return encodingTime;
+    }
+
+    /// @returns number of frames dropped because all buffers were waiting to be encoded
+    size_t getDroppedFramesNum() {
+        const std::lock_guard<std::mutex> lock(mtx);
+        return droppedFrames;
+    }
+
+private:
+    void writeFrame(cv::InputArray im) {
+        auto startTime = std::chrono::steady_clock::now();
         if (writer.isOpened() && (nwritten < lim || 0 == lim)) {
             writer.write(im);
             ++nwritten;
-            return;
-        }
-        if (!writer.isOpened() && !filenames.empty()) {
-            if (!writer.open(filenames, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'), fps, im.size())) {
+        } else if (!writer.isOpened() && !filenames.empty()) {
+            if (!openWriter(im.size())) {
                 throw std::runtime_error("Can't open video writer");
             }
             writer.write(im);
         }
+        encodingTime += std::chrono::steady_clock::now() - startTime;
+    }
+
+    bool openWriter(cv::Size frameSize) {
+        Encoder selectedEncoder;
+        {
+            const std::lock_guard<std::mutex> lock(mtx);
+            selectedEncoder = encoder;
+        }
+        switch (selectedEncoder) {
+        case Encoder::Hardware:
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && (CV_VERSION_MINOR > 5 || \
+                                                        (CV_VERSION_MINOR == 5 && CV_VERSION_REVISION >= 2)))
+            return writer.open(filenames,
+                               cv::CAP_ANY,
+                               cv::VideoWriter::fourcc('a', 'v', 'c', '1'),
+                               fps,
+                               frameSize,
+                               {cv::VIDEOWRITER_PROP_HW_ACCELERATION, cv::VIDEO_ACCELERATION_ANY});
+#else
+            throw std::runtime_error("Hardware accelerated encoding requires OpenCV 4.5.2 or newer");
+#endif
+        case Encoder::Vaapi:
+        case Encoder::Qsv:
+            return writer.open(makeGstPipeline(selectedEncoder == Encoder::Vaapi ? "vaapih264enc" : "msdkh264enc"),
+                               cv::CAP_GSTREAMER,
+                               0,
+                               fps,
+                               frameSize,
+                               true);
+        default:
+            return writer.open(filenames, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'), fps, frameSize);
+        }
+    }
+
+    /// @returns pipeline converting BGR frames for the encoder and writing its output to the file
+    std::string makeGstPipeline(const std::string& encoderElement) const {
+        const size_t dot = filenames.rfind('.');
+        const std::string extension = dot == std::string::npos ? "" : filenames.substr(dot);
+        std::string muxer;
+        if (extension == ".mp4") {
+            muxer = "mp4mux";
+        } else if (extension == ".mkv") {
+            muxer = "matroskamux";
+        } else if (extension == ".avi") {
+            muxer = "avimux";
+        } else {
+            throw std::invalid_argument("GStreamer encoders write .mp4, .mkv or .avi files, not " + filenames);
+        }
+        return "appsrc ! videoconvert ! video/x-raw,format=NV12 ! " + encoderElement + " ! h264parse ! " + muxer +
+               " ! filesink location=\"" + filenames + "\"";
     }
+
+    void encoderThreadFunc() {
+        std::unique_lock<std::mutex> lock(mtx);
+        for (;;) {
+            condVar.wait(lock, [&]() {
+                return stopEncoding || !queuedFrames.empty();
+            });
+            if (queuedFrames.empty()) {
+                return;  // stopEncoding is set and all frames are written
+            }
+            cv::Mat frame = std::move(queuedFrames.front());
+            queuedFrames.pop_front();
+            lock.unlock();
+            try {
+                writeFrame(frame);
+            } catch (...) {
+                lock.lock();
+                encoderException = std::current_exception();
+                condVar.notify_all();
+                return;
+            }
+            lock.lock();
+            freeBuffers.push_back(std::move(frame));
+            condVar.notify_all();
+        }
+    }
+
+    unsigned nsubmitted;
+    const bool isAsync;
+    const QueuePolicy policy = QueuePolicy::Block;
+    // Guarded by mtx, as the asynchronous writer opens the video on the encoder thread
+    Encoder encoder = Encoder::Mjpeg;
+    std::chrono::steady_clock::duration encodingTime = std::chrono::steady_clock::duration::zero();
+
+    std::mutex mtx;
+    std::condition_variable condVar;
+    std::vector<cv::Mat> freeBuffers;
+    std::deque<cv::Mat> queuedFrames;
+    size_t droppedFrames = 0;
+    bool stopEncoding = false;
+    std::exception_ptr encoderException;
+    std::thread encoderThread;
 };
@@ -9,6 +9,10 @@
 
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
 #include <chrono>
 #include <iomanip>
 #include <iostream>
@@ -16,6 +20,31 @@
 
 #include "utils/ocv_common.hpp"
 
+/// Fixed-memory log-linear (HDR-style) histogram of latencies. Latencies are counted with microsecond resolution and
+/// relative error below 1/32, latencies above 2^36 microseconds (about 19 hours) are counted as the maximal one.
+class LatencyHistogram {
+public:
+    LatencyHistogram() : counts(), totalCount(0) {}
+
+    void record(std::chrono::steady_clock::duration latency);
+    void combine(const LatencyHistogram& other);
+
+    /// @param percentile - percentile in range [0, 100]
+    /// @returns latency in milliseconds or NaN if nothing was recorded
+    double getPercentile(double percentile) const;
+
+    uint64_t getCount() const {
+        return totalCount;
+    }
+
+private:
+    // 32 linear buckets for latencies below 32 us and 16 buckets for every next power of 2 up to 2^36 us
+    static constexpr size_t bucketsCount = 32 + 31 * 16;
+
+    std::array<uint32_t, bucketsCount> counts;
+    uint64_t totalCount;
+};
+
 class PerformanceMetrics {
 public:
     using Clock = std::chrono::steady_clock;
@@ -27,6 +56,11 @@ public:
     struct Metrics {
         double latency;
         double fps;
+        int droppedFrames;
+        int skippedFrames;  ///< frames which results were reused instead of being inferred
+        double latencyP50;
+        double latencyP95;
+        double latencyP99;
     };
 
     enum MetricTypes {
@@ -45,6 +79,12 @@ public:
                 int thickness = 2, MetricTypes metricType = ALL);
     void update(TimePoint lastRequestStartTime);
 
+    /// Counts a frame which was dropped instead of being processed
+    void registerDroppedFrame();
+
+    /// Counts a frame which got the result of another frame instead of being inferred
+    void registerSkippedFrame();
+
     /// Paints metrics over provided mat
     /// @param frame frame to paint over
     /// @param position left top corner of text block
@@ -58,29 +98,55 @@ public:
         cv::Scalar color = { 200, 10, 10 },
         int thickness = 2, MetricTypes metricType = ALL) const;
 
+    /// Paints given metrics over provided mat, e.g. metrics taken from another thread
+    static void paintMetrics(const Metrics& metrics,
+        const cv::Mat& frame,
+        cv::Point position = { 15, 30 },
+        int fontFace = cv::FONT_HERSHEY_COMPLEX,
+        double fontScale = 0.75,
+        cv::Scalar color = { 200, 10, 10 },
+        int thickness = 2, MetricTypes metricType = ALL);
+
+    /// @returns metrics of the last time window
     Metrics getLast() const;
     Metrics getTotal() const;
     void logTotal() const;
 
+    /// @param percentile - percentile in range [0, 100]
+    /// @returns latency percentile of the last time window in milliseconds, NaN if there's no frames in the window
+    double getLastPercentile(double percentile) const;
+    /// @returns latency percentile over all frames in milliseconds, NaN if there's no frames processed
+    double getTotalPercentile(double percentile) const;
+
 private:
     struct Statistic {
         Duration latency;
         Duration period;
         int frameCount;
+        int droppedFrameCount;
+        int skippedFrameCount;
+        LatencyHistogram latencyHistogram;
 
         Statistic() {
             latency = Duration::zero();
             period = Duration::zero();
             frameCount = 0;
+            droppedFrameCount = 0;
+            skippedFrameCount = 0;
         }
 
         void combine(const Statistic& other) {
             latency += other.latency;
             period += other.period;
             frameCount += other.frameCount;
+            droppedFrameCount += other.droppedFrameCount;
+            skippedFrameCount += other.skippedFrameCount;
+            latencyHistogram.combine(other.latencyHistogram);
         }
     };
 
+    LatencyHistogram getTotalHistogram() const;
+
     Duration timeWindowSize;
     Statistic lastMovingStatistic;
     Statistic currentMovingStatistic;
@@ -90,3 +156,9 @@ private:
 };
 
 void logLatencyPerStage(double readLat, double preprocLat, double inferLat, double postprocLat, double renderLat);
+/// Prints mean and p50/p95/p99 latencies of every stage
+void logLatencyPerStage(const PerformanceMetrics::Metrics& read,
+                        const PerformanceMetrics::Metrics& preproc,
+                        const PerformanceMetrics::Metrics& infer,
+                        const PerformanceMetrics::Metrics& postproc,
+                        const PerformanceMetrics::Metrics& render);
@@ -0,0 +1,95 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+/**
+ * @brief a header file for the pooling allocator of cv::Mat buffers
+ * @file pooled_mat_allocator.hpp
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "utils/memory_accounting.hpp"
+
+/// Allocator of cv::Mat buffers keeping freed large buffers for the next allocations of the same size class, so
+/// frames, crops, resized images and masks of recurring sizes don't go through malloc, page faults and zeroing of
+/// fresh pages on every frame. Buffers smaller than minPooledBytes are allocated by cv::fastMalloc() as usual.
+/// Freed buffers are kept in the arena of the NUMA node the releasing thread runs on and are reused by threads running
+/// on that node, so reused memory tends to stay local. Buffers held by the pool are reported under the "MatAllocator.cached" tag
+/// of memory accounting, pooled buffers in use under "MatAllocator.used". The allocator is thread safe.
+class PooledMatAllocator final : public cv::MatAllocator {
+public:
+    struct Config {
+        /// maximal bytes of free buffers kept by the pool, buffers freed above it are released
+        size_t capacity = size_t(256) << 20;
+        /// smaller buffers aren't pooled
+        size_t minPooledBytes = size_t(64) << 10;
+        /// back buffers of 2 MB and more by transparent huge pages, so they take fewer TLB entries. Linux only.
+        bool hugePages = false;
+    };
+
+    struct Stats {
+        uint64_t hits;    ///< pooled allocations which reused a free buffer
+        uint64_t misses;  ///< pooled allocations which allocated a new buffer
+        size_t cachedBytes;
+        size_t usedBytes;
+        size_t peakBytes;  ///< peak of cached and used bytes
+    };
+
+    /// Makes the allocator the default allocator of cv::Mat. Mats allocated before keep their allocator. The allocator
+    /// isn't destroyed, as Mats may outlive any scope. Should be called once, at startup.
+    static PooledMatAllocator& install(const Config& config);
+
+    explicit PooledMatAllocator(const Config& config);
+
+    cv::UMatData* allocate(int dims,
+                           const int* sizes,
+                           int type,
+                           void* data,
+                           size_t* step,
+                           cv::AccessFlag flags,
+                           cv::UMatUsageFlags usageFlags) const override;
+    bool allocate(cv::UMatData* data, cv::AccessFlag accessFlags, cv::UMatUsageFlags usageFlags) const override;
+    void deallocate(cv::UMatData* data) const override;
+
+    Stats getStats() const;
+    /// Logs hit rate and footprint of the pool
+    void logStats() const;
+
+private:
+    struct Arena {
+        std::mutex mtx;
+        /// free buffers by size class
+        std::map<size_t, std::vector<void*>> freeBuffers;
+    };
+
+    void* acquire(size_t bytes) const;
+    void release(void* data, size_t bytes) const;
+    /// @returns size of the buffer serving allocations of the size
+    size_t getSizeClass(size_t bytes) const;
+    Arena& getLocalArena() const;
+    void* allocateBuffer(size_t sizeClass) const;
+    void freeBuffer(void* buffer, size_t sizeClass) const;
+    void updatePeak() const;
+
+    const Config config;
+    /// arenas of NUMA nodes, nodes above the number of arenas share the last one
+    mutable std::vector<Arena> arenas;
+    mutable std::atomic<uint64_t> hits{0};
+    mutable std::atomic<uint64_t> misses{0};
+    mutable std::atomic<size_t> cachedBytes{0};
+    mutable std::atomic<size_t> usedBytes{0};
+    mutable std::atomic<size_t> peakBytes{0};
+    mutable MemoryCounter cachedMemory{"MatAllocator.cached"};
+    mutable MemoryCounter usedMemory{"MatAllocator.used"};
+};
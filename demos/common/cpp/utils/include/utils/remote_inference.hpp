@@ -0,0 +1,111 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+/**
+ * @brief a header file for offloading inference of a model to a worker on another host
+ * @file remote_inference.hpp
+ */
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <openvino/openvino.hpp>
+
+struct ModelConfig;
+
+/// Infers a model on a RemoteInferenceWorker over TCP, so a host without a suitable device runs capture,
+/// preprocessing and postprocessing and sends only tensors to the worker. The model with the preprocessing embedded
+/// into it is sent to the worker once, which compiles it on the device of the config. Locally a proxy model with the
+/// same inputs and outputs is compiled on CPU, its infer requests hold the input tensors to be sent and receive the
+/// output tensors, so callers use them as usual but start them by startAsync(). Every infer request started by
+/// startAsync() is in flight until the worker returns its outputs, so the number of local requests is the window of
+/// requests in flight. Tensors are sent and received from and to their memory without staging copies. Not supported
+/// on Windows.
+class RemoteInferenceClient {
+public:
+    using Callback = std::function<void(std::exception_ptr)>;
+
+    /// Connects to the worker
+    /// @param address - "<host>:<port>" of the worker
+    explicit RemoteInferenceClient(const std::string& address);
+    /// Disconnects from the worker, callbacks of requests in flight get the error of the lost connection
+    ~RemoteInferenceClient();
+    RemoteInferenceClient(const RemoteInferenceClient&) = delete;
+    RemoteInferenceClient& operator=(const RemoteInferenceClient&) = delete;
+
+    /// Sends the model to the worker to be compiled with deviceName and compiledModelConfig of the config
+    /// @returns the proxy model compiled on CPU of the core
+    ov::CompiledModel compileModel(const std::shared_ptr<ov::Model>& model, const ModelConfig& config, ov::Core& core);
+
+    /// @returns optimal number of infer requests of the model compiled by the worker
+    unsigned int getOptimalRequestsNum() const {
+        return optimalRequestsNum;
+    }
+
+    /// Sends input tensors of the request of the proxy model to the worker. The callback is called by the receiving
+    /// thread once outputs of the request are set, with an exception if the inference or the connection failed.
+    /// @throws std::runtime_error if the connection is lost
+    void startAsync(ov::InferRequest& request, const Callback& callback);
+
+    /// Waits until all started requests complete
+    void waitForTotalCompletion();
+
+private:
+    struct InFlightRequest {
+        ov::InferRequest request;
+        Callback callback;
+    };
+
+    void receivingThreadFunc();
+    void failInFlightRequests(std::exception_ptr error);
+
+    int socketFd = -1;
+    const std::string address;
+    unsigned int optimalRequestsNum = 1;
+    std::vector<std::string> inputsNames;
+    // outputs of the proxy model by all names of every output
+    std::map<std::string, ov::Output<const ov::Node>> outputs;
+
+    std::mutex sendMtx;
+    std::mutex mtx;
+    std::condition_variable condVar;
+    std::map<uint64_t, InFlightRequest> inFlightRequests;
+    uint64_t nextRequestId = 0;
+    std::exception_ptr connectionError;
+    std::thread receivingThread;
+};
+
+/// Serves inference of models sent by RemoteInferenceClient instances. Every connection gets its own compiled model
+/// and pool of infer requests, requests of a connection are inferred in parallel and their outputs are sent back as
+/// soon as they complete.
+class RemoteInferenceWorker {
+public:
+    /// Listens on the port of all interfaces
+    /// @param requestsNum - number of infer requests of every connection, 0 means optimal for the compiled model
+    RemoteInferenceWorker(ov::Core& core, uint16_t port, unsigned int requestsNum = 0);
+    ~RemoteInferenceWorker();
+    RemoteInferenceWorker(const RemoteInferenceWorker&) = delete;
+    RemoteInferenceWorker& operator=(const RemoteInferenceWorker&) = delete;
+
+    /// Accepts connections and serves every one on its own detached thread, never returns unless accepting fails
+    void run();
+
+private:
+    void serveConnection(int connectionFd);
+
+    ov::Core& core;
+    const unsigned int requestsNum;
+    int listeningFd = -1;
+};
@@ -0,0 +1,150 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+#include <stddef.h>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "utils/performance_metrics.hpp"
+
+/// Renders items on a dedicated thread, so the thread which submits frames and gets results never waits for drawing,
+/// HighGUI or the video writer. Up to queueSize items wait to be rendered. If the queue is full, push() either drops
+/// the oldest item, so only the latest results are shown, or waits for the renderer, so every item is rendered, e.g.
+/// if the results are written to a video.
+template <typename Item>
+class RenderThread {
+public:
+    /// @param render - renders the item, returns false if rendering should be stopped, e.g. a user closed the window
+    RenderThread(std::function<bool(Item&)> render, size_t queueSize, bool dropOldest)
+        : render(std::move(render)),
+          queueSize(queueSize),
+          dropOldest(dropOldest) {
+        if (queueSize == 0) {
+            throw std::invalid_argument("Queue size of render thread must be positive");
+        }
+        renderingThread = std::thread(&RenderThread::renderingThreadFunc, this);
+    }
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    /// Stops the thread, items which weren't rendered yet are discarded
+    ~RenderThread() {
+        if (renderingThread.joinable()) {
+            {
+                const std::lock_guard<std::mutex> lock(mtx);
+                stopRendering = true;
+            }
+            condVar.notify_all();
+            renderingThread.join();
+        }
+    }
+
+    /// Queues the item for rendering. Rethrows exceptions of render().
+    /// @returns false if rendering was stopped by render(), the item is discarded then
+    bool push(Item&& item) {
+        std::unique_lock<std::mutex> lock(mtx);
+        condVar.wait(lock, [&]() {
+            return dropOldest || items.size() < queueSize || stopRendering || renderingException;
+        });
+        if (renderingException) {
+            std::rethrow_exception(renderingException);
+        }
+        if (stopRendering) {
+            return false;
+        }
+        if (items.size() == queueSize) {
+            items.pop_front();
+            ++droppedNum;
+        }
+        items.push_back(std::move(item));
+        condVar.notify_all();
+        return true;
+    }
+
+    /// Waits for the queued items to be rendered and stops the thread. Rethrows exceptions of render().
+    void finish() {
+        {
+            const std::lock_guard<std::mutex> lock(mtx);
+            endOfItems = true;
+        }
+        condVar.notify_all();
+        renderingThread.join();
+        if (renderingException) {
+            std::rethrow_exception(renderingException);
+        }
+    }
+
+    /// @returns number of items dropped because the queue was full
+    size_t getDroppedNum() {
+        const std::lock_guard<std::mutex> lock(mtx);
+        return droppedNum;
+    }
+
+    /// @returns latency of render() calls
+    PerformanceMetrics getMetrics() {
+        const std::lock_guard<std::mutex> lock(mtx);
+        return metrics;
+    }
+
+private:
+    void renderingThreadFunc() {
+        for (;;) {
+            Item item;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                condVar.wait(lock, [&]() {
+                    return !items.empty() || endOfItems || stopRendering;
+                });
+                if (stopRendering || items.empty()) {
+                    return;
+                }
+                item = std::move(items.front());
+                items.pop_front();
+                condVar.notify_all();
+            }
+            const PerformanceMetrics::TimePoint startTime = PerformanceMetrics::Clock::now();
+            bool keepRendering = false;
+            try {
+                keepRendering = render(item);
+            } catch (...) {
+                const std::lock_guard<std::mutex> lock(mtx);
+                renderingException = std::current_exception();
+                condVar.notify_all();
+                return;
+            }
+            const std::lock_guard<std::mutex> lock(mtx);
+            metrics.update(startTime);
+            if (!keepRendering) {
+                stopRendering = true;
+                items.clear();
+                condVar.notify_all();
+                return;
+            }
+        }
+    }
+
+    std::function<bool(Item&)> render;
+    const size_t queueSize;
+    const bool dropOldest;
+
+    std::mutex mtx;
+    std::condition_variable condVar;
+    std::deque<Item> items;
+    size_t droppedNum = 0;
+    bool endOfItems = false;
+    bool stopRendering = false;
+    std::exception_ptr renderingException;
+    PerformanceMetrics metrics;
+
+    std::thread renderingThread;
+};
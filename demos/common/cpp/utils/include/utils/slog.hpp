@@ -9,8 +9,18 @@
 
 #pragma once
 
+#include <stddef.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
 #include <iostream>
+#include <mutex>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace slog {
 
@@ -31,23 +41,163 @@ class LogStreamBoolAlpha { };
 
 static constexpr LogStreamBoolAlpha boolalpha;
 
+enum class Level { debug, info, warning, error };
+
+namespace detail {
+/**
+ * @brief Writes complete lines of all log streams. Lines are written either by the logging thread, one write and
+ * flush per line, or by a background thread in batches if asynchronous mode is enabled.
+ */
+class Backend {
+public:
+    /// The backend is never destroyed, so static objects can log from their destructors
+    static Backend& get() {
+        static Backend* backend = new Backend;
+        return *backend;
+    }
+
+    bool isEnabled(Level level) const {
+        return static_cast<int>(level) >= minLevel.load(std::memory_order_relaxed);
+    }
+
+    void setLevel(Level level) {
+        minLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+    }
+
+    void setAsync(bool async) {
+        std::unique_lock<std::mutex> lock(mtx);
+        if (async == flushingThread.joinable()) {
+            return;
+        }
+        if (async) {
+            stopFlushing = false;
+            flushingThread = std::thread(&Backend::flushingThreadFunc, this);
+            if (!isAtExitRegistered) {
+                // Lines queued before the exit are written, next ones are written by the logging threads
+                std::atexit([]() {
+                    Backend::get().setAsync(false);
+                });
+                isAtExitRegistered = true;
+            }
+        } else {
+            stopFlushing = true;
+            condVar.notify_one();
+            std::thread stoppedThread = std::move(flushingThread);
+            lock.unlock();
+            stoppedThread.join();
+        }
+    }
+
+    void write(std::ostream& stream, std::string&& line) {
+        std::unique_lock<std::mutex> lock(mtx);
+        if (flushingThread.joinable()) {
+            lines.emplace_back(&stream, std::move(line));
+            lock.unlock();
+            condVar.notify_one();
+            return;
+        }
+        stream.write(line.data(), line.size());
+        stream.flush();
+    }
+
+private:
+    Backend() = default;
+
+    void flushingThreadFunc() {
+        std::vector<std::pair<std::ostream*, std::string>> batch;
+        std::unique_lock<std::mutex> lock(mtx);
+        for (;;) {
+            condVar.wait(lock, [&]() {
+                return !lines.empty() || stopFlushing;
+            });
+            if (lines.empty()) {
+                return;
+            }
+            batch.swap(lines);
+            lock.unlock();
+            std::ostream* lastStream = nullptr;
+            for (const std::pair<std::ostream*, std::string>& line : batch) {
+                if (lastStream && lastStream != line.first) {
+                    lastStream->flush();  // keeps the order of lines written to different streams of a terminal
+                }
+                line.first->write(line.second.data(), line.second.size());
+                lastStream = line.first;
+            }
+            lastStream->flush();
+            batch.clear();
+            lock.lock();
+        }
+    }
+
+    std::atomic<int> minLevel{static_cast<int>(Level::debug)};
+    std::mutex mtx;
+    std::condition_variable condVar;
+    std::vector<std::pair<std::ostream*, std::string>> lines;
+    bool stopFlushing = false;
+    bool isAtExitRegistered = false;
+    std::thread flushingThread;
+};
+
+/// A line being formatted by the calling thread
+struct ThreadLine {
+    std::ostringstream stream;
+    bool newLine = true;
+};
+
+inline bool& areThreadLinesDestroyed() {
+    thread_local bool destroyed = false;  // trivially destructible, so it's valid until the thread ends
+    return destroyed;
+}
+
+struct ThreadLines {
+    ThreadLine lines[static_cast<size_t>(Level::error) + 1];
+
+    ~ThreadLines() {
+        areThreadLinesDestroyed() = true;
+    }
+};
+
+/// @returns nullptr if the lines of the thread were destroyed, e.g. if destructors of static objects log after the
+/// exit from main()
+inline ThreadLine* getThreadLine(Level level) {
+    if (areThreadLinesDestroyed()) {
+        return nullptr;
+    }
+    thread_local ThreadLines threadLines;
+    return &threadLines.lines[static_cast<size_t>(level)];
+}
+}  // namespace detail
+
+/// Messages of streams below the level are skipped without formatting
+inline void setLevel(Level level) {
+    detail::Backend::get().setLevel(level);
+}
+
+/// Enables writing of log lines by a background thread, so logging threads only format lines and queue them.
+/// Lines queued before the exit from the program are written. Lines of crashed programs may be lost.
+inline void setAsync(bool async) {
+    detail::Backend::get().setAsync(async);
+}
 
 /**
  * @class LogStream
- * @brief The LogStream class implements a stream for sample logging
+ * @brief The LogStream class implements a stream for sample logging. Lines are formatted in a buffer of the calling
+ * thread, so lines of different threads don't interleave.
  */
 class LogStream {
     std::string _prefix;
     std::ostream* _log_stream;
-    bool _new_line;
+    Level _level;
+    bool _new_line;  // used if the thread has no line buffer
 
 public:
     /**
      * @brief A constructor. Creates a LogStream object
      * @param prefix The prefix to print
+     * @param level Level of the messages, streams of the same level share the line buffer of a thread
      */
-    LogStream(const std::string &prefix, std::ostream& log_stream)
-            : _prefix(prefix), _new_line(true) {
+    LogStream(const std::string &prefix, std::ostream& log_stream, Level level = Level::info)
+            : _prefix(prefix), _level(level), _new_line(true) {
         _log_stream = &log_stream;
     }
 
@@ -57,26 +207,48 @@ public:
      */
     template<class T>
     LogStream &operator<<(const T &arg) {
-        if (_new_line) {
-            (*_log_stream) << "[ " << _prefix << " ] ";
-            _new_line = false;
+        if (!detail::Backend::get().isEnabled(_level)) {
+            return *this;
         }
-
-        (*_log_stream) << arg;
+        detail::ThreadLine* line = detail::getThreadLine(_level);
+        if (!line) {
+            if (_new_line) {
+                (*_log_stream) << "[ " << _prefix << " ] ";
+                _new_line = false;
+            }
+            (*_log_stream) << arg;
+            return *this;
+        }
+        if (line->newLine) {
+            line->stream << "[ " << _prefix << " ] ";
+            line->newLine = false;
+        }
+        line->stream << arg;
         return *this;
     }
 
     // Specializing for LogStreamEndLine to support slog::endl
     LogStream& operator<< (const LogStreamEndLine &/*arg*/) {
-        _new_line = true;
-
-        (*_log_stream) << std::endl;
+        if (!detail::Backend::get().isEnabled(_level)) {
+            return *this;
+        }
+        detail::ThreadLine* line = detail::getThreadLine(_level);
+        if (!line) {
+            _new_line = true;
+            (*_log_stream) << std::endl;
+            return *this;
+        }
+        line->newLine = true;
+        line->stream << '\n';
+        detail::Backend::get().write(*_log_stream, line->stream.str());
+        line->stream.str(std::string());
         return *this;
     }
 
     // Specializing for LogStreamBoolAlpha to support slog::boolalpha
     LogStream& operator<< (const LogStreamBoolAlpha &/*arg*/) {
-        (*_log_stream) << std::boolalpha;
+        detail::ThreadLine* line = detail::getThreadLine(_level);
+        (line ? line->stream : *_log_stream) << std::boolalpha;
         return *this;
     }
 
@@ -91,9 +263,9 @@ public:
 };
 
 
-static LogStream info("INFO", std::cout);
-static LogStream debug("DEBUG", std::cout);
-static LogStream warn("WARNING", std::cout);
-static LogStream err("ERROR", std::cerr);
+static LogStream info("INFO", std::cout, Level::info);
+static LogStream debug("DEBUG", std::cout, Level::debug);
+static LogStream warn("WARNING", std::cout, Level::warning);
+static LogStream err("ERROR", std::cerr, Level::error);
 
 }  // namespace slog
@@ -0,0 +1,70 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+/**
+ * @brief a header file for measuring of the startup of the demos
+ * @file startup_profiler.hpp
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// Measures phases of the startup of a demo, e.g. reading and compiling of every model and opening of the inputs, and
+/// the time to the first result. Times are counted from construction of the profiler, so it should be created first in
+/// main(). Phases run on several threads overlap, the report shows when every phase began to make it visible. The
+/// profiler is thread safe.
+class StartupProfiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// Records the phase from its construction to its destruction
+    class Phase {
+    public:
+        Phase(StartupProfiler& profiler, const std::string& name);
+        ~Phase();
+        Phase(const Phase&) = delete;
+        Phase& operator=(const Phase&) = delete;
+
+    private:
+        StartupProfiler& profiler;
+        std::string name;
+        Clock::time_point begin;
+    };
+
+    StartupProfiler();
+
+    void record(const std::string& name, Clock::time_point begin, Clock::time_point end);
+
+    /// Records the time to the first result, e.g. the first shown frame, and logs the report. Later calls are ignored,
+    /// so it can be called for every result.
+    void markFirstResult();
+
+    /// Logs the phases in order of their beginning and the time to the first result if it is marked
+    void logReport() const;
+
+private:
+    struct PhaseTime {
+        std::string name;
+        Clock::duration begin;
+        Clock::duration duration;
+    };
+
+    const Clock::time_point startTime;
+    mutable std::mutex mtx;
+    std::vector<PhaseTime> phases;
+    bool firstResultMarked;
+    Clock::duration timeToFirstResult;
+};
+
+/// Runs the tasks on threadsNum threads and waits for all of them, 0 means a thread per task and 1 runs the tasks one
+/// by one on the calling thread. The tasks are started in their order. If some of them throw, the rest still complete
+/// and the first exception is rethrown.
+void runInParallel(const std::vector<std::function<void()>>& tasks, size_t threadsNum = 0);
@@ -6,15 +6,27 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
 #include <memory>
 #include <mutex>
+#include <ostream>
 #include <utility>
 #include <set>
 #include <string>
 #include <thread>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
 #include <vector>
 
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
 #include <opencv2/core/core.hpp>
 #include "utils/performance_metrics.hpp"
 
@@ -42,11 +54,17 @@ public:
         sharedVideoFrame{sharedVideoFrame}, priority{priority} {}
     virtual bool isReady() = 0;
     virtual void process() = 0;
+    // The moment the task may become ready without any event, e.g. the next frame's show time. Worker rechecks the
+    // task at that moment, other not ready tasks are rechecked when Worker::notify() is called.
+    virtual std::chrono::steady_clock::time_point readyTime() {
+        return std::chrono::steady_clock::time_point::max();
+    }
     virtual ~Task() = default;
 
     std::string name;
     VideoFrame::Ptr sharedVideoFrame;  // it is possible that two tasks try to draw on the same cvMat
     const float priority;
+    std::chrono::steady_clock::time_point pushTime;  // set by Worker::push()
 };
 
 struct HigherPriority {
@@ -57,10 +75,26 @@ struct HigherPriority {
     }
 };
 
+// Runs tasks in the order of their priorities. Threads don't poll tasks which aren't ready: they sleep until a task
+// is pushed, a task is processed, notify() is called or a task's readyTime() comes.
 class Worker {
 public:
+    // Limits of the tasks of one class, 0 means no limit
+    struct TaskLimits {
+        size_t maxRunning;  // the tasks of the class processed at the same time
+        size_t maxQueued;  // producers aren't started while this number of tasks of the class are queued
+    };
+
+    struct TaskClassStats {
+        std::string name;
+        size_t queued;  // the current queue depth
+        size_t maxQueued;  // the deepest queue seen
+        size_t processed;
+        std::chrono::steady_clock::duration meanWaitTime;  // from push() to the start of processing
+    };
+
     explicit Worker(unsigned threadNum):
-        threadPool(threadNum), running{false} {}
+        threadPool(threadNum), running{false}, generation{0} {}
     ~Worker() {
         stop();
     }
@@ -70,12 +104,51 @@ public:
             t = std::thread(&Worker::threadFunc, this);
         }
     }
+    // Must be called before runThreads()
+    void setLimits(const std::type_info& taskClass, TaskLimits limits) {
+        classes[std::type_index(taskClass)].limits = limits;
+    }
+    // Producers are tasks bringing new work, e.g. Readers. They aren't started while a queue limited by
+    // TaskLimits::maxQueued is full, so overload holds the frames back instead of buffering them. Must be called
+    // before runThreads().
+    void setProducer(const std::type_info& taskClass) {
+        classes[std::type_index(taskClass)].isProducer = true;
+    }
+    std::vector<TaskClassStats> getStats() {
+        std::vector<TaskClassStats> stats;
+        std::lock_guard<std::mutex> lock{tasksMutex};
+        for (const auto& typeAndClass : classes) {
+            const TaskClass& taskClass = typeAndClass.second;
+            const std::chrono::steady_clock::duration meanWaitTime = taskClass.processed > 0
+                ? taskClass.totalWaitTime / static_cast<std::chrono::steady_clock::rep>(taskClass.processed)
+                : std::chrono::steady_clock::duration::zero();
+            stats.push_back({typeName(typeAndClass.first), taskClass.queued, taskClass.maxQueued, taskClass.processed, meanWaitTime});
+        }
+        return stats;
+    }
     void push(std::shared_ptr<Task> task) {
+        task->pushTime = std::chrono::steady_clock::now();
         tasksMutex.lock();
+        TaskClass& taskClass = classOf(*task);
+        taskClass.maxQueued = std::max(taskClass.maxQueued, ++taskClass.queued);
         tasks.insert(task);
+        ++generation;
         tasksMutex.unlock();
         tasksCondVar.notify_one();
     }
+    // Wakes the threads to recheck the tasks. Must be called after a change which can make a task ready other than
+    // processing of a task, e.g. when an infer request callback returns the request. It is allowed to call it from
+    // isReady().
+    void notify() {
+        if (this == scanningWorker()) {
+            ++generation;  // the scanning thread holds tasksMutex and rechecks the tasks itself
+            return;
+        }
+        tasksMutex.lock();
+        ++generation;
+        tasksMutex.unlock();
+        tasksCondVar.notify_all();
+    }
     void threadFunc() {
         while (running) {
             std::unique_lock<std::mutex> lk(tasksMutex);
@@ -83,14 +156,71 @@ public:
                 tasksCondVar.wait(lk);
             }
             try {
-                auto it = std::find_if(tasks.begin(), tasks.end(), [](const std::shared_ptr<Task>& task){return task->isReady();});
+                const uint64_t scannedGeneration = generation;
+                std::chrono::steady_clock::time_point wakeTime = std::chrono::steady_clock::time_point::max();
+                const auto now = std::chrono::steady_clock::now();
+                const bool isQueueFull = std::any_of(classes.begin(), classes.end(),
+                    [](const std::pair<const std::type_index, TaskClass>& typeAndClass) {
+                        const TaskClass& taskClass = typeAndClass.second;
+                        return 0 != taskClass.limits.maxQueued && taskClass.queued >= taskClass.limits.maxQueued;
+                    });
+                scanningWorker() = this;
+                auto it = tasks.begin();
+                TaskClass* chosenClass = nullptr;
+                for (; tasks.end() != it; ++it) {
+                    TaskClass& taskClass = classOf(**it);
+                    // limited tasks aren't checked because isReady() may reserve resources for process()
+                    if ((0 != taskClass.limits.maxRunning && taskClass.running >= taskClass.limits.maxRunning)
+                            || (taskClass.isProducer && isQueueFull)) {
+                        continue;
+                    }
+                    if ((*it)->isReady()) {
+                        chosenClass = &taskClass;
+                        break;
+                    }
+                    const std::chrono::steady_clock::time_point readyTime = (*it)->readyTime();
+                    if (readyTime > now) {  // a past readyTime means the task waits for something else
+                        wakeTime = std::min(wakeTime, readyTime);
+                    }
+                }
+                scanningWorker() = nullptr;
                 if (tasks.end() != it) {
                     const std::shared_ptr<Task> task = std::move(*it);
                     tasks.erase(it);
+                    --chosenClass->queued;
+                    ++chosenClass->running;
+                    ++chosenClass->processed;
+                    chosenClass->totalWaitTime += now - task->pushTime;
+                    lk.unlock();
+                    if (0 == traceCapacity) {
+                        task->process();
+                    } else {
+                        const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+                        task->process();
+                        traceBuffer().record({&typeid(*task), task->sharedVideoFrame->sourceID, task->sharedVideoFrame->frameId,
+                                              begin, std::chrono::steady_clock::now()});
+                    }
+                    // processed task may release what other tasks wait for
+                    lk.lock();
+                    --chosenClass->running;
+                    ++generation;
                     lk.unlock();
-                    task->process();
+                    tasksCondVar.notify_all();
+                } else {
+                    const auto isChanged = [&]() {
+                        return !running || generation != scannedGeneration;
+                    };
+                    if (std::chrono::steady_clock::time_point::max() == wakeTime) {
+                        tasksCondVar.wait(lk, isChanged);
+                    } else {
+                        tasksCondVar.wait_until(lk, wakeTime, isChanged);
+                    }
                 }
             } catch (...) {
+                scanningWorker() = nullptr;
+                if (lk.owns_lock()) {
+                    lk.unlock();  // stop() takes tasksMutex
+                }
                 std::lock_guard<std::mutex> lock{exceptionMutex};
                 if (nullptr == currentException) {
                     currentException = std::current_exception();
@@ -100,7 +230,9 @@ public:
         }
     }
     void stop() {
+        tasksMutex.lock();
         running = false;
+        tasksMutex.unlock();
         tasksCondVar.notify_all();
     }
     void join() {
@@ -111,15 +243,113 @@ public:
             std::rethrow_exception(currentException);
         }
     }
+    // Records every processed task to the ring buffer of the thread which processed it. A buffer keeps the last
+    // eventsPerThread tasks. Must be called before runThreads().
+    void enableTracing(size_t eventsPerThread) {
+        traceCapacity = eventsPerThread;
+        traceStart = std::chrono::steady_clock::now();
+    }
+    // Writes the recorded tasks in Chrome Trace Event format which chrome://tracing and Perfetto open. Must be called
+    // after join().
+    void writeTrace(std::ostream& stream) const {
+        const auto toUs = [this](std::chrono::steady_clock::time_point time) {
+            return std::chrono::duration_cast<std::chrono::microseconds>(time - traceStart).count();
+        };
+        stream << "{\"traceEvents\":[";
+        const char* separator = "\n";
+        for (size_t tid = 0; tid < traceBuffers.size(); ++tid) {
+            stream << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << tid
+                << ",\"args\":{\"name\":\"Worker thread " << tid << "\"}}";
+            separator = ",\n";
+            const TraceBuffer& buffer = *traceBuffers[tid];
+            const size_t eventsNum = std::min(buffer.recorded, buffer.events.size());
+            for (size_t i = buffer.recorded - eventsNum; i < buffer.recorded; ++i) {
+                const TraceEvent& event = buffer.events[i % buffer.events.size()];
+                stream << separator << "{\"name\":\"" << typeName(std::type_index(*event.type)) << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << tid
+                    << ",\"ts\":" << toUs(event.begin) << ",\"dur\":" << toUs(event.end) - toUs(event.begin)
+                    << ",\"args\":{\"source\":" << event.sourceID << ",\"frame\":" << event.frameId << "}}";
+            }
+        }
+        stream << "\n]}\n";
+    }
 
 private:
+    struct TaskClass {
+        TaskLimits limits = {0, 0};
+        bool isProducer = false;
+        size_t queued = 0;
+        size_t maxQueued = 0;
+        size_t running = 0;
+        size_t processed = 0;
+        std::chrono::steady_clock::duration totalWaitTime = std::chrono::steady_clock::duration::zero();
+    };
+
+    TaskClass& classOf(const Task& task) {
+        return classes[std::type_index(typeid(task))];
+    }
+
+    struct TraceEvent {
+        const std::type_info* type;
+        unsigned sourceID;
+        int64_t frameId;
+        std::chrono::steady_clock::time_point begin;
+        std::chrono::steady_clock::time_point end;
+    };
+
+    // Written by its thread only, so recording doesn't lock
+    struct TraceBuffer {
+        explicit TraceBuffer(size_t capacity) : events(capacity) {}
+        void record(const TraceEvent& event) {
+            events[recorded++ % events.size()] = event;
+        }
+        std::vector<TraceEvent> events;
+        size_t recorded = 0;
+    };
+
+    TraceBuffer& traceBuffer() {
+        thread_local Worker* owner = nullptr;
+        thread_local TraceBuffer* buffer = nullptr;
+        if (this != owner) {
+            std::lock_guard<std::mutex> lock{traceMutex};
+            traceBuffers.emplace_back(new TraceBuffer(traceCapacity));
+            owner = this;
+            buffer = traceBuffers.back().get();
+        }
+        return *buffer;
+    }
+
+    static std::string typeName(const std::type_index& type) {
+#ifdef __GNUG__
+        int status;
+        char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+        if (0 == status) {
+            std::string name = demangled;
+            std::free(demangled);
+            return name;
+        }
+#endif
+        return type.name();
+    }
+
+    // The worker whose tasks the current thread checks with isReady()
+    static Worker*& scanningWorker() {
+        thread_local Worker* worker = nullptr;
+        return worker;
+    }
+
     std::condition_variable tasksCondVar;
     std::set<std::shared_ptr<Task>, HigherPriority> tasks;
+    std::unordered_map<std::type_index, TaskClass> classes;  // guarded by tasksMutex
     std::mutex tasksMutex;
     std::vector<std::thread> threadPool;
     std::atomic<bool> running;
+    std::atomic<uint64_t> generation;
     std::exception_ptr currentException;
     std::mutex exceptionMutex;
+    size_t traceCapacity = 0;
+    std::chrono::steady_clock::time_point traceStart;
+    std::vector<std::unique_ptr<TraceBuffer>> traceBuffers;
+    std::mutex traceMutex;
 };
 
 void tryPush(const std::weak_ptr<Worker>& worker, std::shared_ptr<Task>&& task) {
@@ -128,6 +358,12 @@ void tryPush(const std::weak_ptr<Worker>& worker, std::shared_ptr<Task>&& task)
     } catch (const std::bad_weak_ptr&) {}
 }
 
+void tryNotify(const std::weak_ptr<Worker>& worker) {
+    try {
+        std::shared_ptr<Worker>(worker)->notify();
+    } catch (const std::bad_weak_ptr&) {}
+}
+
 template <class C> class ConcurrentContainer {
 public:
     C container;
@@ -163,3 +399,164 @@ public:
         return container;
     }
 };
+
+// Bounded lock-free multi-producer multi-consumer pool of free resources like InferRequests (D. Vyukov's bounded
+// queue). A Worker whose tasks wait for the resources may be attached to be notified when a resource is released.
+template <class T> class ConcurrentPool {
+public:
+    ConcurrentPool() = default;
+    ConcurrentPool(const ConcurrentPool&) = delete;
+    ConcurrentPool& operator=(const ConcurrentPool&) = delete;
+
+    // Removes all the values and makes room for at least capacity values. It isn't thread safe.
+    void reset(size_t capacity) {
+        size_t cellsNum = 1;
+        while (cellsNum < capacity) {
+            cellsNum <<= 1;
+        }
+        cells.reset(new Cell[cellsNum]);
+        mask = cellsNum - 1;
+        for (size_t i = 0; i < cellsNum; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        pushPos.store(0, std::memory_order_relaxed);
+        popPos.store(0, std::memory_order_relaxed);
+    }
+
+    void setWorker(const std::weak_ptr<Worker>& worker) {
+        this->worker = worker;
+    }
+
+    // Returns false if the pool is full
+    bool tryPush(const T& value) {
+        Cell* cell;
+        size_t pos = pushPos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells[pos & mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+            if (0 == diff) {
+                if (pushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = pushPos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = value;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        if (const std::shared_ptr<Worker> waitingWorker = worker.lock()) {
+            waitingWorker->notify();
+        }
+        return true;
+    }
+
+    // Returns false if the pool is empty
+    bool tryPop(T& value) {
+        Cell* cell;
+        size_t pos = popPos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells[pos & mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (0 == diff) {
+                if (popPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = popPos.load(std::memory_order_relaxed);
+            }
+        }
+        value = cell->value;
+        cell->sequence.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // The number of values, it is approximate if the pool is being changed concurrently
+    size_t size() const {
+        const size_t popped = popPos.load(std::memory_order_relaxed);
+        const size_t pushed = pushPos.load(std::memory_order_relaxed);
+        return pushed > popped ? pushed - popped : 0;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask = 0;
+    std::atomic<size_t> pushPos{0};
+    std::atomic<size_t> popPos{0};
+    std::weak_ptr<Worker> worker;
+};
+
+// Recycles memory blocks of one size, e.g. for objects which are created for every frame. A block is taken by the
+// first allocation's size, the allocations of other sizes and the blocks which don't fit into the pool go to the heap.
+class BlockPool {
+public:
+    explicit BlockPool(size_t capacity) : blockSize{0} {
+        blocks.reset(capacity);
+    }
+    BlockPool(const BlockPool&) = delete;
+    BlockPool& operator=(const BlockPool&) = delete;
+    ~BlockPool() {
+        void* block;
+        while (blocks.tryPop(block)) {
+            ::operator delete(block);
+        }
+    }
+
+    void* allocate(size_t size) {
+        size_t noSize = 0;
+        blockSize.compare_exchange_strong(noSize, size);
+        void* block;
+        if (size == blockSize && blocks.tryPop(block)) {
+            return block;
+        }
+        return ::operator new(size);
+    }
+
+    void deallocate(void* block, size_t size) {
+        if (size != blockSize || !blocks.tryPush(block)) {
+            ::operator delete(block);
+        }
+    }
+
+private:
+    ConcurrentPool<void*> blocks;
+    std::atomic<size_t> blockSize;
+};
+
+// Allocator for std::allocate_shared() taking the object together with its control block from BlockPool
+template <class T> class PoolAllocator {
+public:
+    typedef T value_type;
+
+    explicit PoolAllocator(BlockPool& pool) : pool{&pool} {}
+    template <class U> PoolAllocator(const PoolAllocator<U>& other) : pool{other.pool} {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(pool->allocate(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t n) {
+        pool->deallocate(p, n * sizeof(T));
+    }
+
+    template <class U> bool operator==(const PoolAllocator<U>& other) const {
+        return pool == other.pool;
+    }
+    template <class U> bool operator!=(const PoolAllocator<U>& other) const {
+        return pool != other.pool;
+    }
+
+private:
+    template <class U> friend class PoolAllocator;
+
+    BlockPool* pool;
+};
@@ -0,0 +1,70 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <stddef.h>
+
+#include <functional>
+#include <vector>
+
+#include "opencv2/core.hpp"
+
+#include "utils/linear_assignment.hpp"
+
+///
+/// \brief Shape affinity of a track box and a detection box: exp(-weight * relative size difference).
+///
+float ShapeAffinity(float weight, const cv::Rect& trk, const cv::Rect& det);
+
+///
+/// \brief Motion affinity of a track box and a detection box:
+/// exp(-weight * squared shift relative to the detection size).
+///
+float MotionAffinity(float weight, const cv::Rect& trk, const cv::Rect& det);
+
+///
+/// \brief Intersection over union of two boxes.
+///
+float IoU(const cv::Rect& r1, const cv::Rect& r2);
+
+///
+/// \brief The TrackAssociator class matches tracks to detections.
+///
+/// The affinity of a pair is the product of pluggable affinity terms. Pairs
+/// whose affinity is less than the threshold are gated out: the rest of the
+/// terms isn't computed for them and they are never matched. The gated pairs
+/// are matched by the sparse LinearAssignment solver maximizing the total
+/// affinity. Scratch buffers are kept between calls, so a tracker doesn't
+/// allocate them every frame.
+///
+class TrackAssociator {
+public:
+    ///
+    /// \brief An affinity term in [0, 1] of a track and a detection.
+    ///
+    using Affinity = std::function<float(size_t track, size_t detection)>;
+
+    struct Match {
+        size_t track;
+        size_t detection;
+        float affinity;
+    };
+
+    ///
+    /// \brief Matches tracks to detections.
+    /// \param tracks_num Number of tracks.
+    /// \param detections_num Number of detections.
+    /// \param affinities Affinity terms, the cheapest ones should go first.
+    /// \param min_affinity Pairs with a lower affinity aren't matched.
+    /// \return Matches sorted by track, the reference is valid until the next call.
+    ///
+    const std::vector<Match>& Associate(size_t tracks_num, size_t detections_num,
+                                        const std::vector<Affinity>& affinities, float min_affinity);
+
+private:
+    std::vector<LinearAssignment::Edge> edges_;
+    std::vector<float> affinities_;
+    std::vector<Match> matches_;
+};
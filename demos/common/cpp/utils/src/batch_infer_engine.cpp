@@ -0,0 +1,65 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "utils/batch_infer_engine.hpp"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+BatchInferEngine::BatchInferEngine(ov::CompiledModel& compiledModel, size_t numRequests,
+                                   const ov::Shape& inputShape, const ov::Layout& inputLayout)
+    : inputShape(inputShape),
+      batchIdx(ov::layout::batch_idx(inputLayout)) {
+    if (numRequests == 0) {
+        throw std::invalid_argument("Number of infer requests must be positive");
+    }
+    if (getMaxBatchSize() == 0) {
+        throw std::invalid_argument("Maximum batch size must be positive");
+    }
+    for (size_t i = 0; i < numRequests; ++i) {
+        requests.push_back(compiledModel.create_infer_request());
+        // The tensors are allocated once for the maximum batch, smaller batches don't reallocate them
+        inputTensors.emplace_back(compiledModel.input().get_element_type(), inputShape);
+    }
+}
+
+ov::Tensor BatchInferEngine::batchView(size_t requestIdx, size_t begin, size_t end) const {
+    ov::Coordinate beginCoord(inputShape.size(), 0);
+    ov::Coordinate endCoord(inputShape);
+    beginCoord[batchIdx] = begin;
+    endCoord[batchIdx] = end;
+    return ov::Tensor(inputTensors[requestIdx], beginCoord, endCoord);
+}
+
+void BatchInferEngine::infer(const std::vector<cv::Mat>& images, const FillItem& fillItem,
+                             const FetchResults& fetchResults) {
+    const size_t maxBatchSize = getMaxBatchSize();
+    std::vector<size_t> batchSizes;
+    for (size_t start = 0; start < images.size(); start += maxBatchSize) {
+        const size_t batch = batchSizes.size();
+        const size_t requestIdx = batch % requests.size();
+        ov::InferRequest& request = requests[requestIdx];
+        if (batch >= requests.size()) {
+            request.wait();
+            fetchResults(request, batchSizes[batch - requests.size()]);
+        }
+
+        const size_t batchSize = std::min(maxBatchSize, images.size() - start);
+        for (size_t i = 0; i < batchSize; ++i) {
+            fillItem(images[start + i], batchView(requestIdx, i, i + 1));
+        }
+        request.set_input_tensor(batchView(requestIdx, 0, batchSize));
+        request.start_async();
+        batchSizes.push_back(batchSize);
+    }
+
+    const size_t firstInFlight = batchSizes.size() > requests.size() ? batchSizes.size() - requests.size() : 0;
+    for (size_t batch = firstInFlight; batch < batchSizes.size(); ++batch) {
+        ov::InferRequest& request = requests[batch % requests.size()];
+        request.wait();
+        fetchResults(request, batchSizes[batch]);
+    }
+}
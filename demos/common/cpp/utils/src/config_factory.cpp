@@ -17,6 +17,7 @@
 #include "utils/config_factory.h"
 
 #include <set>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
@@ -38,8 +39,9 @@ std::set<std::string> ModelConfig::getDevices() {
 ModelConfig ConfigFactory::getUserConfig(const std::string& flags_d,
                                          uint32_t flags_nireq,
                                          const std::string& flags_nstreams,
-                                         uint32_t flags_nthreads) {
-    auto config = getCommonConfig(flags_d, flags_nireq);
+                                         uint32_t flags_nthreads,
+                                         const std::string& flags_cache_dir) {
+    auto config = getCommonConfig(flags_d, flags_nireq, flags_cache_dir);
 
     std::map<std::string, int> deviceNstreams = parseValuePerDevice(config.getDevices(), flags_nstreams);
     for (const auto& device : config.getDevices()) {
@@ -69,8 +71,29 @@ ModelConfig ConfigFactory::getUserConfig(const std::string& flags_d,
     return config;
 }
 
-ModelConfig ConfigFactory::getMinLatencyConfig(const std::string& flags_d, uint32_t flags_nireq) {
-    auto config = getCommonConfig(flags_d, flags_nireq);
+TuningConfig ConfigFactory::getTuningConfig(const std::string& flags_tune,
+                                            double flags_tune_latency,
+                                            const std::string& flags_tune_cache) {
+    TuningConfig tuning;
+    if (flags_tune == "throughput") {
+        tuning.objective = TuningConfig::Throughput;
+    } else if (flags_tune == "latency") {
+        tuning.objective = TuningConfig::Latency;
+    } else if (!flags_tune.empty()) {
+        throw std::invalid_argument("Unknown tuning objective '" + flags_tune + "', expected throughput or latency");
+    }
+    if (flags_tune_latency < 0) {
+        throw std::invalid_argument("Latency budget can't be negative");
+    }
+    tuning.latencyBudget = flags_tune_latency;
+    tuning.cacheFile = flags_tune_cache;
+    return tuning;
+}
+
+ModelConfig ConfigFactory::getMinLatencyConfig(const std::string& flags_d,
+                                               uint32_t flags_nireq,
+                                               const std::string& flags_cache_dir) {
+    auto config = getCommonConfig(flags_d, flags_nireq, flags_cache_dir);
     for (const auto& device : config.getDevices()) {
         if (device == "CPU") {  // CPU supports a few special performance-oriented keys
             config.compiledModelConfig.emplace(ov::streams::num.name(), 1);
@@ -81,7 +104,9 @@ ModelConfig ConfigFactory::getMinLatencyConfig(const std::string& flags_d, uint3
     return config;
 }
 
-ModelConfig ConfigFactory::getCommonConfig(const std::string& flags_d, uint32_t flags_nireq) {
+ModelConfig ConfigFactory::getCommonConfig(const std::string& flags_d,
+                                           uint32_t flags_nireq,
+                                           const std::string& flags_cache_dir) {
     ModelConfig config;
 
     if (!flags_d.empty()) {
@@ -89,6 +114,7 @@ ModelConfig ConfigFactory::getCommonConfig(const std::string& flags_d, uint32_t
     }
 
     config.maxAsyncRequests = flags_nireq;
+    config.cacheDir = flags_cache_dir;
 
     return config;
 }
@@ -0,0 +1,273 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "utils/config_tuner.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "utils/performance_metrics.hpp"
+#include "utils/slog.hpp"
+
+namespace {
+std::string getHostName() {
+#ifdef _WIN32
+    const char* name = std::getenv("COMPUTERNAME");
+    return name ? name : "";
+#else
+    char name[256] = {};
+    return gethostname(name, sizeof(name) - 1) == 0 ? name : "";
+#endif
+}
+
+std::string getCacheKey(const std::shared_ptr<ov::Model>& model,
+                        const std::string& modelName,
+                        const std::string& device,
+                        ov::Core& core,
+                        const TuningConfig& tuning) {
+    std::ostringstream key;
+    key << modelName;
+    for (const ov::Output<ov::Node>& input : model->inputs()) {
+        key << '|' << input.get_any_name() << input.get_partial_shape().to_string();
+    }
+    key << '|' << device << '|' << core.get_property(device, ov::device::full_name) << '|' << getHostName() << '|'
+        << (tuning.objective == TuningConfig::Latency ? "latency" : "throughput") << '|' << tuning.latencyBudget;
+    std::string result = key.str();
+    std::replace(result.begin(), result.end(), '\t', ' ');
+    return result;
+}
+}  // namespace
+
+ConfigTuner::ConfigTuner(const TuningConfig& tuning, std::chrono::milliseconds measureTime)
+    : tuning(tuning),
+      measureTime(measureTime) {}
+
+ModelConfig ConfigTuner::tune(const std::shared_ptr<ov::Model>& model,
+                              const std::string& modelName,
+                              const ModelConfig& config,
+                              ov::Core& core) {
+    ModelConfig tunedConfig = config;
+    if (tuning.objective == TuningConfig::None) {
+        return tunedConfig;
+    }
+    const std::set<std::string> devices = tunedConfig.getDevices();
+    const std::string device = devices.size() == 1 ? *devices.begin() : "";
+    if (tunedConfig.deviceName != device || (device != "CPU" && device != "GPU")) {
+        slog::warn << "Tuning is supported only for a single CPU or GPU device, the configuration is used as is"
+                   << slog::endl;
+        return tunedConfig;
+    }
+
+    const std::string key = getCacheKey(model, modelName, device, core, tuning);
+    int nstreams = 0;
+    unsigned int nireq = 0;
+    if (loadFromCache(key, nstreams, nireq)) {
+        slog::info << "\tTuned configuration is loaded from " << tuning.cacheFile << slog::endl;
+    } else {
+        std::vector<Candidate> candidates;
+        const unsigned int maxStreams = device == "CPU" ? std::max(1u, std::thread::hardware_concurrency()) : 4;
+        for (unsigned int streams = 1; streams <= maxStreams; streams *= 2) {
+            // requests which wait for a stream only add latency, so they are tried for throughput only
+            std::vector<unsigned int> requests{streams};
+            if (tuning.objective == TuningConfig::Throughput) {
+                requests.push_back(2 * streams);
+            }
+            for (unsigned int requestsNum : requests) {
+                candidates.push_back(measure(model, tunedConfig, core, static_cast<int>(streams), requestsNum));
+                const Candidate& candidate = candidates.back();
+                slog::info << "\tTuning: " << candidate.nstreams << " streams, " << candidate.nireq << " requests: "
+                           << std::fixed << std::setprecision(1) << candidate.fps << " FPS, latency "
+                           << candidate.latency << " ms, p95 " << candidate.latencyP95 << " ms" << slog::endl;
+            }
+        }
+        const Candidate& best = candidates[choose(candidates)];
+        nstreams = best.nstreams;
+        nireq = best.nireq;
+        saveToCache(key, nstreams, nireq);
+    }
+
+    tunedConfig.compiledModelConfig[ov::streams::num.name()] = ov::streams::Num(nstreams);
+    tunedConfig.maxAsyncRequests = nireq;
+    slog::info << "\tTuned configuration: " << nstreams << " streams, " << nireq << " infer requests" << slog::endl;
+    return tunedConfig;
+}
+
+ConfigTuner::Candidate ConfigTuner::measure(const std::shared_ptr<ov::Model>& model,
+                                            const ModelConfig& config,
+                                            ov::Core& core,
+                                            int nstreams,
+                                            unsigned int nireq) {
+    ov::AnyMap compiledModelConfig = config.compiledModelConfig;
+    compiledModelConfig[ov::streams::num.name()] = ov::streams::Num(nstreams);
+    ov::CompiledModel compiledModel = core.compile_model(model, config.deviceName, compiledModelConfig);
+
+    std::vector<ov::InferRequest> requests;
+    for (unsigned int i = 0; i < nireq; ++i) {
+        requests.push_back(compiledModel.create_infer_request());
+        // uninitialized inputs may contain NaNs or denormals, which slow down some devices
+        for (const auto& input : compiledModel.inputs()) {
+            ov::Tensor tensor = requests.back().get_tensor(input);
+            memset(tensor.data(), 0, tensor.get_byte_size());
+        }
+        requests.back().infer();  // warm-up
+    }
+
+    std::mutex mtx;
+    std::condition_variable condVar;
+    std::vector<size_t> completedRequests;
+    std::exception_ptr callbackException = nullptr;
+    for (size_t i = 0; i < requests.size(); ++i) {
+        requests[i].set_callback([&, i](std::exception_ptr ex) {
+            // notified under the lock, so the waiting thread can't leave the function and destroy condVar before
+            const std::lock_guard<std::mutex> lock(mtx);
+            completedRequests.push_back(i);
+            if (ex && !callbackException) {
+                callbackException = ex;
+            }
+            condVar.notify_one();
+        });
+    }
+
+    LatencyHistogram histogram;
+    PerformanceMetrics::Duration totalLatency = PerformanceMetrics::Duration::zero();
+    std::vector<PerformanceMetrics::TimePoint> startTimes(requests.size());
+    const PerformanceMetrics::TimePoint startTime = PerformanceMetrics::Clock::now();
+    const PerformanceMetrics::TimePoint deadline = startTime + measureTime;
+    PerformanceMetrics::TimePoint endTime = startTime;
+    for (size_t i = 0; i < requests.size(); ++i) {
+        startTimes[i] = PerformanceMetrics::Clock::now();
+        requests[i].start_async();
+    }
+    size_t runningRequests = requests.size();
+    std::unique_lock<std::mutex> lock(mtx);
+    while (runningRequests > 0) {
+        condVar.wait(lock, [&]() {
+            return !completedRequests.empty();
+        });
+        const size_t i = completedRequests.back();
+        completedRequests.pop_back();
+        endTime = PerformanceMetrics::Clock::now();
+        histogram.record(endTime - startTimes[i]);
+        totalLatency += endTime - startTimes[i];
+        if (endTime < deadline && !callbackException) {
+            startTimes[i] = endTime;
+            lock.unlock();
+            requests[i].start_async();
+            lock.lock();
+        } else {
+            --runningRequests;
+        }
+    }
+    lock.unlock();
+    for (ov::InferRequest& request : requests) {
+        request.wait();
+    }
+    if (callbackException) {
+        std::rethrow_exception(callbackException);
+    }
+
+    Candidate candidate;
+    candidate.nstreams = nstreams;
+    candidate.nireq = nireq;
+    candidate.fps = histogram.getCount() / std::chrono::duration_cast<PerformanceMetrics::Sec>(endTime - startTime).count();
+    candidate.latency = std::chrono::duration_cast<PerformanceMetrics::Ms>(totalLatency).count() / histogram.getCount();
+    candidate.latencyP95 = histogram.getPercentile(95);
+    return candidate;
+}
+
+size_t ConfigTuner::choose(const std::vector<Candidate>& candidates) const {
+    size_t best = 0;
+    if (tuning.objective == TuningConfig::Latency) {
+        for (size_t i = 1; i < candidates.size(); ++i) {
+            if (candidates[i].latency < candidates[best].latency) {
+                best = i;
+            }
+        }
+        return best;
+    }
+    bool found = false;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (tuning.latencyBudget > 0 && candidates[i].latencyP95 > tuning.latencyBudget) {
+            continue;
+        }
+        if (!found || candidates[i].fps > candidates[best].fps) {
+            best = i;
+            found = true;
+        }
+    }
+    if (!found) {
+        slog::warn << "No configuration meets the latency budget of " << tuning.latencyBudget
+                   << " ms, the one with minimal p95 latency is used" << slog::endl;
+        for (size_t i = 1; i < candidates.size(); ++i) {
+            if (candidates[i].latencyP95 < candidates[best].latencyP95) {
+                best = i;
+            }
+        }
+    }
+    return best;
+}
+
+bool ConfigTuner::loadFromCache(const std::string& key, int& nstreams, unsigned int& nireq) const {
+    if (tuning.cacheFile.empty()) {
+        return false;
+    }
+    std::ifstream cache(tuning.cacheFile);
+    std::string line;
+    bool found = false;
+    // every line is "<key>\t<nstreams>\t<nireq>", later lines override earlier ones
+    while (std::getline(cache, line)) {
+        const size_t keyEnd = line.find('\t');
+        if (keyEnd == std::string::npos || line.compare(0, keyEnd, key) != 0) {
+            continue;
+        }
+        std::istringstream values(line.substr(keyEnd + 1));
+        int streams = 0;
+        unsigned int requests = 0;
+        if (values >> streams >> requests && streams > 0 && requests > 0) {
+            nstreams = streams;
+            nireq = requests;
+            found = true;
+        }
+    }
+    return found;
+}
+
+void ConfigTuner::saveToCache(const std::string& key, int nstreams, unsigned int nireq) const {
+    if (tuning.cacheFile.empty()) {
+        return;
+    }
+    std::ofstream cache(tuning.cacheFile, std::ios::app);
+    if (!cache) {
+        slog::warn << "Can't write tuned configuration to " << tuning.cacheFile << slog::endl;
+        return;
+    }
+    cache << key << '\t' << nstreams << '\t' << nireq << '\n';
+}
@@ -0,0 +1,260 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "utils/frame_bus.hpp"
+
+#include <string.h>
+
+#ifndef _WIN32
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+#include "utils/itt.hpp"
+
+namespace {
+const char frameBusMagic[8] = {'O', 'M', 'Z', 'F', 'B', 'U', 'S', '\0'};
+const uint32_t frameBusVersion = 1;
+// Slots and their data are aligned to cache lines, so the producer and consumers don't share lines of other slots
+const size_t frameBusAlignment = 64;
+
+enum FrameBusState : uint32_t { Initializing = 0, Streaming = 1, Finished = 2 };
+
+// Header of a slot, the frame follows it at offset frameBusAlignment. The slot is a sequence lock: its version is
+// odd while the frame is written, so readers detect frames overwritten during their copying.
+struct FrameBusSlot {
+    std::atomic<uint64_t> version;
+    std::atomic<uint64_t> sequence;
+    std::atomic<int64_t> timestamp;  // nanoseconds of the steady clock
+};
+
+size_t alignUp(size_t size) {
+    return (size + frameBusAlignment - 1) / frameBusAlignment * frameBusAlignment;
+}
+
+int64_t getTimestamp() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+std::chrono::steady_clock::time_point toTimePoint(int64_t timestamp) {
+    return std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(timestamp)));
+}
+}  // namespace
+
+// The header is followed by slotsNum slots of slotStride bytes at offset alignUp(sizeof(FrameBusHeader)). The
+// atomics are lock free, so they work across processes.
+struct FrameBusHeader {
+    char magic[8];
+    uint32_t version;
+    int32_t width;
+    int32_t height;
+    int32_t type;
+    uint64_t slotsNum;
+    uint64_t slotStride;
+    double fps;
+    std::atomic<uint32_t> state;
+    std::atomic<uint64_t> published;  // number of published frames, the next frame gets it as its sequence number
+};
+
+FrameBusWriter::FrameBusWriter(const std::string& name, cv::Size frameSize, int type, size_t slotsNum, double fps)
+    : shmName("/" + name) {
+#ifdef _WIN32
+    throw std::runtime_error("The frame bus isn't supported on Windows");
+#else
+    if (slotsNum < 2) {
+        throw std::invalid_argument("The frame bus should have at least 2 slots");
+    }
+    if (frameSize.width <= 0 || frameSize.height <= 0) {
+        throw std::invalid_argument("Frames of the frame bus should not be empty");
+    }
+    const size_t slotStride = alignUp(frameBusAlignment + frameSize.area() * CV_ELEM_SIZE(type));
+    mappedSize = alignUp(sizeof(FrameBusHeader)) + slotsNum * slotStride;
+
+    shm_unlink(shmName.c_str());  // left by a crashed producer
+    const int fd = shm_open(shmName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Can't create the frame bus " + name);
+    }
+    if (ftruncate(fd, static_cast<off_t>(mappedSize)) != 0) {
+        close(fd);
+        shm_unlink(shmName.c_str());
+        throw std::runtime_error("Can't allocate " + std::to_string(mappedSize) + " bytes for the frame bus " + name);
+    }
+    void* mapped = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        shm_unlink(shmName.c_str());
+        throw std::runtime_error("Can't map the frame bus " + name);
+    }
+
+    // The memory is zeroed by ftruncate(), so readers see the Initializing state until the header is filled
+    header = new (mapped) FrameBusHeader();
+    if (!header->published.is_lock_free() || !header->state.is_lock_free()) {
+        munmap(mapped, mappedSize);
+        shm_unlink(shmName.c_str());
+        throw std::runtime_error("The frame bus requires lock free atomics");
+    }
+    memcpy(header->magic, frameBusMagic, sizeof(frameBusMagic));
+    header->version = frameBusVersion;
+    header->width = frameSize.width;
+    header->height = frameSize.height;
+    header->type = type;
+    header->slotsNum = slotsNum;
+    header->slotStride = slotStride;
+    header->fps = fps;
+    header->published.store(0, std::memory_order_relaxed);
+    for (size_t i = 0; i < slotsNum; ++i) {
+        FrameBusSlot* slot = new (getSlot(i)) FrameBusSlot();
+        slot->version.store(0, std::memory_order_relaxed);
+        slot->sequence.store(0, std::memory_order_relaxed);
+        slot->timestamp.store(0, std::memory_order_relaxed);
+    }
+    header->state.store(Streaming, std::memory_order_release);
+#endif
+}
+
+FrameBusWriter::~FrameBusWriter() {
+#ifndef _WIN32
+    header->state.store(Finished, std::memory_order_release);
+    munmap(header, mappedSize);
+    shm_unlink(shmName.c_str());
+#endif
+}
+
+uint8_t* FrameBusWriter::getSlot(uint64_t sequence) const {
+    return reinterpret_cast<uint8_t*>(header) + alignUp(sizeof(FrameBusHeader)) +
+           sequence % header->slotsNum * header->slotStride;
+}
+
+uint64_t FrameBusWriter::publish(const cv::Mat& frame) {
+    ITT_SCOPED_TASK("FrameBusWriter::publish");
+    if (frame.cols != header->width || frame.rows != header->height || frame.type() != header->type) {
+        throw std::invalid_argument("The frame doesn't match the size or the type of frames of the frame bus");
+    }
+    const uint64_t sequence = header->published.load(std::memory_order_relaxed);
+    uint8_t* slotData = getSlot(sequence);
+    FrameBusSlot* slot = reinterpret_cast<FrameBusSlot*>(slotData);
+    const uint64_t version = slot->version.load(std::memory_order_relaxed);
+    slot->version.store(version + 1, std::memory_order_relaxed);
+    // The odd version is visible before any byte of the frame is changed
+    std::atomic_thread_fence(std::memory_order_release);
+    slot->sequence.store(sequence, std::memory_order_relaxed);
+    slot->timestamp.store(getTimestamp(), std::memory_order_relaxed);
+    cv::Mat slotFrame(frame.rows, frame.cols, frame.type(), slotData + frameBusAlignment);
+    frame.copyTo(slotFrame);
+    slot->version.store(version + 2, std::memory_order_release);
+    header->published.store(sequence + 1, std::memory_order_release);
+    return sequence;
+}
+
+FrameBusReader::FrameBusReader(const std::string& name, size_t readLengthLimit, size_t frameStep)
+    : ImagesCapture{false},
+      readLengthLimit{readLengthLimit},
+      frameStep{frameStep} {
+#ifdef _WIN32
+    throw std::runtime_error("The frame bus isn't supported on Windows");
+#else
+    const std::string shmName = "/" + name;
+    const int fd = shm_open(shmName.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        throw std::runtime_error("Can't find the frame bus " + name);
+    }
+    struct stat shmStat;
+    if (fstat(fd, &shmStat) != 0 || static_cast<size_t>(shmStat.st_size) < sizeof(FrameBusHeader)) {
+        close(fd);
+        throw std::runtime_error("The frame bus " + name + " isn't initialized yet");
+    }
+    mappedSize = static_cast<size_t>(shmStat.st_size);
+    void* mapped = mmap(nullptr, mappedSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error("Can't map the frame bus " + name);
+    }
+    header = static_cast<const FrameBusHeader*>(mapped);
+
+    std::string error;
+    if (header->state.load(std::memory_order_acquire) == Initializing) {
+        error = "The frame bus " + name + " isn't initialized yet";
+    } else if (memcmp(header->magic, frameBusMagic, sizeof(frameBusMagic)) || header->version != frameBusVersion) {
+        error = name + " isn't a frame bus of a supported version";
+    } else if (alignUp(sizeof(FrameBusHeader)) + header->slotsNum * header->slotStride != mappedSize) {
+        error = "The frame bus " + name + " is truncated";
+    }
+    if (!error.empty()) {
+        munmap(mapped, mappedSize);
+        throw std::runtime_error(error);
+    }
+    const uint64_t published = header->published.load(std::memory_order_acquire);
+    nextSequence = published > 0 ? published - 1 : 0;
+#endif
+}
+
+FrameBusReader::~FrameBusReader() {
+#ifndef _WIN32
+    munmap(const_cast<FrameBusHeader*>(header), mappedSize);
+#endif
+}
+
+double FrameBusReader::fps() const {
+    return header->fps;
+}
+
+cv::Mat FrameBusReader::read() {
+    cv::Mat frame;
+    readInto(frame);
+    return frame;
+}
+
+bool FrameBusReader::readInto(cv::Mat& frame) {
+    ITT_SCOPED_TASK("ImagesCapture::readInto");
+    if (readFramesNum >= readLengthLimit) {
+        return false;
+    }
+    const uint8_t* slots = reinterpret_cast<const uint8_t*>(header) + alignUp(sizeof(FrameBusHeader));
+    for (;;) {
+        // The state is loaded first, so frames published before the producer finished are seen
+        const bool isFinished = header->state.load(std::memory_order_acquire) == Finished;
+        const uint64_t published = header->published.load(std::memory_order_acquire);
+        if (nextSequence >= published) {
+            if (isFinished) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        if (published - nextSequence > header->slotsNum) {
+            skippedFrames += published - header->slotsNum - nextSequence;
+            nextSequence = published - header->slotsNum;
+        }
+        const uint8_t* slotData = slots + nextSequence % header->slotsNum * header->slotStride;
+        const FrameBusSlot* slot = reinterpret_cast<const FrameBusSlot*>(slotData);
+        const uint64_t version = slot->version.load(std::memory_order_acquire);
+        if (version % 2 == 0 && slot->sequence.load(std::memory_order_relaxed) == nextSequence) {
+            const int64_t timestamp = slot->timestamp.load(std::memory_order_relaxed);
+            cv::Mat(header->height, header->width, header->type, const_cast<uint8_t*>(slotData) + frameBusAlignment)
+                .copyTo(frame);
+            // The copy is complete before the version is checked again
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot->version.load(std::memory_order_relaxed) == version) {
+                ++readFramesNum;
+                nextSequence += frameStep;
+                readerMetrics.update(toTimePoint(timestamp));
+                return true;
+            }
+        }
+        // The producer has overwritten the frame with a newer one
+        ++skippedFrames;
+        ++nextSequence;
+    }
+}
@@ -0,0 +1,55 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "utils/frame_pool.hpp"
+
+#include <stddef.h>
+
+#include "utils/images_capture.h"
+
+FramePool::FramePool(size_t capacity) : capacity(capacity) {}
+
+cv::Mat& FramePool::acquire() {
+    size_t bytes = 0;
+    for (const cv::Mat& buffer : buffers) {
+        bytes += buffer.u ? getMatBytes(buffer) : 0;
+    }
+    buffersMemory.set(bytes);
+
+    for (cv::Mat& buffer : buffers) {
+        if (nullptr == buffer.u) {
+            // Empty, or the reading left a header of memory the pool doesn't own, e.g. a buffer of a capture backend
+            buffer.release();
+            return buffer;
+        }
+        // The pool's Mat is the only reference left, frames sharing the buffer were released. Only this thread can
+        // create new references, so the buffer stays free.
+        if (1 == buffer.u->refcount) {
+            return buffer;
+        }
+    }
+    if (buffers.size() < capacity) {
+        buffers.emplace_back();
+        return buffers.back();
+    }
+    overflow.release();
+    return overflow;
+}
+
+cv::Mat FramePool::read(ImagesCapture& capture) {
+    cv::Mat& buffer = acquire();
+    // The frame shares the buffer, so the buffer survives if the capture replaces the header of the frame
+    cv::Mat frame = buffer;
+    if (!capture.readInto(frame)) {
+        return cv::Mat{};
+    }
+    if (nullptr != frame.u && (frame.u == buffer.u || 1 == frame.u->refcount)) {
+        // The frame was read into the buffer or into new memory nothing else refers to, the pool takes it over
+        buffer = frame;
+    } else {
+        // Memory of the capture can be overwritten by the next read or shared with its cache
+        frame.copyTo(buffer);
+    }
+    return buffer;
+}
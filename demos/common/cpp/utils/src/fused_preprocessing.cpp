@@ -0,0 +1,200 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "utils/fused_preprocessing.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <opencv2/core.hpp>
+#include <openvino/openvino.hpp>
+
+namespace {
+// Source offsets and weight of the second one for a destination coordinate
+struct ResizeTap {
+    size_t offset0;
+    size_t offset1;
+    float alpha;
+};
+
+// Computes taps with the same pixel centers alignment as cv::INTER_LINEAR
+void computeTaps(size_t srcSize, size_t dstSize, size_t stride, std::vector<ResizeTap>& taps) {
+    taps.resize(dstSize);
+    const float scale = static_cast<float>(srcSize) / dstSize;
+    for (size_t i = 0; i < dstSize; ++i) {
+        float pos = std::max((i + 0.5f) * scale - 0.5f, 0.0f);
+        size_t pos0 = static_cast<size_t>(pos);
+        float alpha = pos - pos0;
+        if (pos0 >= srcSize - 1) {
+            pos0 = srcSize - 1;
+            alpha = 0;
+        }
+        size_t pos1 = std::min(pos0 + 1, srcSize - 1);
+        taps[i].offset0 = pos0 * stride;
+        taps[i].offset1 = pos1 * stride;
+        taps[i].alpha = alpha;
+    }
+}
+
+template <int C>
+void interpolateRow(const uint8_t* src, const std::vector<ResizeTap>& xTaps, float* dst) {
+    for (size_t x = 0; x < xTaps.size(); ++x) {
+        const uint8_t* pixel0 = src + xTaps[x].offset0;
+        const uint8_t* pixel1 = src + xTaps[x].offset1;
+        const float alpha = xTaps[x].alpha;
+        for (int c = 0; c < C; ++c) {
+            dst[x * C + c] = pixel0[c] + alpha * (pixel1[c] - pixel0[c]);
+        }
+    }
+}
+
+template <class T>
+T convertValue(float value) {
+    return static_cast<T>(value);
+}
+
+template <>
+uint8_t convertValue<uint8_t>(float value) {
+    return cv::saturate_cast<uint8_t>(value);
+}
+
+template <>
+ov::float16 convertValue<ov::float16>(float value) {
+    return ov::float16(value);
+}
+
+template <int C, class T>
+void resizeNormalize(const cv::Mat& image,
+                     T* dst,
+                     size_t width,
+                     size_t height,
+                     bool isPlanar,
+                     const NormalizationParams& params) {
+    // Buffers are reused by subsequent calls from the same thread
+    thread_local std::vector<ResizeTap> xTaps;
+    thread_local std::vector<ResizeTap> yTaps;
+    thread_local std::vector<float> rows[2];
+    computeTaps(image.cols, width, C, xTaps);
+    computeTaps(image.rows, height, 1, yTaps);
+    rows[0].resize(width * C);
+    rows[1].resize(width * C);
+    // Source rows interpolated horizontally into the buffers
+    size_t bufferedRows[2] = {std::numeric_limits<size_t>::max(), std::numeric_limits<size_t>::max()};
+
+    int srcChannels[C];
+    float means[C];
+    float invScales[C];
+    for (int c = 0; c < C; ++c) {
+        srcChannels[c] = params.reverseChannels ? C - 1 - c : c;
+        means[c] = static_cast<float>(params.means[c]);
+        invScales[c] = 1.0f / static_cast<float>(params.scales[c]);
+    }
+    const size_t pixelStride = isPlanar ? 1 : C;
+    const size_t channelStride = isPlanar ? width * height : 1;
+
+    for (size_t y = 0; y < height; ++y) {
+        const size_t srcRows[2] = {yTaps[y].offset0, yTaps[y].offset1};
+        size_t bufferIdx[2];
+        for (size_t i = 0; i < 2; ++i) {
+            if (bufferedRows[0] == srcRows[i]) {
+                bufferIdx[i] = 0;
+            } else if (bufferedRows[1] == srcRows[i]) {
+                bufferIdx[i] = 1;
+            } else {
+                // Keep the row which is needed for the other tap
+                bufferIdx[i] = i == 1 ? 1 - bufferIdx[0] : (bufferedRows[0] == srcRows[1] ? 1 : 0);
+                interpolateRow<C>(image.ptr<uint8_t>(static_cast<int>(srcRows[i])), xTaps, rows[bufferIdx[i]].data());
+                bufferedRows[bufferIdx[i]] = srcRows[i];
+            }
+        }
+
+        const float* row0 = rows[bufferIdx[0]].data();
+        const float* row1 = rows[bufferIdx[1]].data();
+        const float beta = yTaps[y].alpha;
+        T* dstRow = dst + y * width * pixelStride;
+        for (size_t x = 0; x < width; ++x) {
+            for (int c = 0; c < C; ++c) {
+                const size_t srcIdx = x * C + srcChannels[c];
+                const float value = row0[srcIdx] + beta * (row1[srcIdx] - row0[srcIdx]);
+                dstRow[x * pixelStride + c * channelStride] = convertValue<T>((value - means[c]) * invScales[c]);
+            }
+        }
+    }
+}
+
+template <class T>
+void resizeNormalize(const cv::Mat& image,
+                     T* dst,
+                     size_t width,
+                     size_t height,
+                     size_t channels,
+                     bool isPlanar,
+                     const NormalizationParams& params) {
+    if (channels == 3) {
+        resizeNormalize<3>(image, dst, width, height, isPlanar, params);
+    } else {
+        resizeNormalize<1>(image, dst, width, height, isPlanar, params);
+    }
+}
+}  // namespace
+
+void resizeNormalizeToTensor(const cv::Mat& image,
+                             const ov::Tensor& tensor,
+                             const ov::Layout& layout,
+                             size_t batchIdx,
+                             const NormalizationParams& params) {
+    const ov::Shape& shape = tensor.get_shape();
+    if (shape.size() != 4) {
+        throw std::runtime_error("Only 4D tensors are supported by fused preprocessing");
+    }
+    const size_t channelsIdx = ov::layout::channels_idx(layout);
+    if (channelsIdx != 1 && channelsIdx != 3) {
+        throw std::runtime_error("Only NCHW and NHWC layouts are supported by fused preprocessing");
+    }
+    const size_t width = shape[ov::layout::width_idx(layout)];
+    const size_t height = shape[ov::layout::height_idx(layout)];
+    const size_t channels = shape[channelsIdx];
+    if (image.depth() != CV_8U) {
+        throw std::runtime_error("Only 8-bit images are supported by fused preprocessing");
+    }
+    if (static_cast<size_t>(image.channels()) != channels) {
+        throw std::runtime_error("The number of channels for model input and image must match");
+    }
+    if (channels != 1 && channels != 3) {
+        throw std::runtime_error("Unsupported number of channels");
+    }
+    if (batchIdx >= shape[ov::layout::batch_idx(layout)]) {
+        throw std::out_of_range("Batch index is out of the tensor");
+    }
+
+    const bool isPlanar = channelsIdx == 1;
+    const size_t itemOffset = batchIdx * width * height * channels;
+    const ov::element::Type& type = tensor.get_element_type();
+    if (type == ov::element::u8) {
+        resizeNormalize(image, tensor.data<uint8_t>() + itemOffset, width, height, channels, isPlanar, params);
+    } else if (type == ov::element::f32) {
+        resizeNormalize(image, tensor.data<float>() + itemOffset, width, height, channels, isPlanar, params);
+    } else if (type == ov::element::f16) {
+        resizeNormalize(image, tensor.data<ov::float16>() + itemOffset, width, height, channels, isPlanar, params);
+    } else {
+        throw std::runtime_error("Only u8, f32 and f16 tensors are supported by fused preprocessing");
+    }
+}
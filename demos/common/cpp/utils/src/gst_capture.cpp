@@ -0,0 +1,310 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "utils/gst_capture.hpp"
+
+#include <stddef.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+#ifdef USE_GSTREAMER
+#    include <gst/app/gstappsink.h>
+#    include <gst/gst.h>
+#    include <gst/video/video.h>
+
+#    include <mutex>
+#endif
+
+#include "utils/itt.hpp"
+
+#ifdef USE_GSTREAMER
+namespace {
+const char gstSchemePrefix[] = "gst://";
+// Time to wait for the first frame, RTSP cameras take a while to negotiate the stream
+const GstClockTime prerollTimeout = 20 * GST_SECOND;
+
+// Mapped frame of a sample, the sample keeps its buffer alive until the frame is unmapped
+struct MappedSample {
+    GstSample* sample;
+    GstVideoFrame frame;
+};
+
+// Allocator of cv::Mat views of mapped samples: the sample is unmapped and released with the last copy of the Mat
+class MappedSampleAllocator final : public cv::MatAllocator {
+public:
+    cv::UMatData* allocate(int, const int*, int, void*, size_t*, cv::AccessFlag, cv::UMatUsageFlags) const override {
+        return nullptr;  // views are made by makeView() only
+    }
+
+    bool allocate(cv::UMatData*, cv::AccessFlag, cv::UMatUsageFlags) const override {
+        return false;
+    }
+
+    void deallocate(cv::UMatData* data) const override {
+        MappedSample* mapped = static_cast<MappedSample*>(data->handle);
+        gst_video_frame_unmap(&mapped->frame);
+        gst_sample_unref(mapped->sample);
+        delete mapped;
+        delete data;
+    }
+
+    /// Makes a Mat referring to the mapped BGR frame, takes over the sample
+    cv::Mat makeView(MappedSample* mapped) const {
+        GstVideoFrame& frame = mapped->frame;
+        cv::Mat view(GST_VIDEO_FRAME_HEIGHT(&frame),
+                     GST_VIDEO_FRAME_WIDTH(&frame),
+                     CV_8UC3,
+                     GST_VIDEO_FRAME_PLANE_DATA(&frame, 0),
+                     static_cast<size_t>(GST_VIDEO_FRAME_PLANE_STRIDE(&frame, 0)));
+        cv::UMatData* data = new cv::UMatData(this);
+        data->data = data->origdata = view.data;
+        data->size = view.step[0] * view.rows;
+        data->handle = mapped;
+        data->refcount = 1;
+        view.u = data;
+        return view;
+    }
+};
+
+const MappedSampleAllocator& getMappedSampleAllocator() {
+    static const MappedSampleAllocator allocator;
+    return allocator;
+}
+
+std::string takeErrorMessage(GError* error) {
+    const std::string message = error && error->message ? error->message : "unknown error";
+    if (error) {
+        g_error_free(error);
+    }
+    return message;
+}
+
+// Raises ranks of hardware decoders which are installed above the software ones, so decodebin picks them
+void preferHardwareDecoders() {
+    static const char* const decoders[] = {"vah264dec",
+                                           "vah265dec",
+                                           "vaapih264dec",
+                                           "vaapih265dec",
+                                           "msdkh264dec",
+                                           "msdkh265dec",
+                                           "nvh264dec",
+                                           "nvh265dec",
+                                           "nvh264sldec",
+                                           "nvh265sldec"};
+    GstRegistry* registry = gst_registry_get();
+    for (const char* name : decoders) {
+        GstPluginFeature* feature = gst_registry_lookup_feature(registry, name);
+        if (feature) {
+            gst_plugin_feature_set_rank(feature, GST_RANK_PRIMARY + 1);
+            gst_object_unref(feature);
+        }
+    }
+}
+
+void initGstreamer() {
+    static std::once_flag initFlag;
+    std::call_once(initFlag, []() {
+        GError* error = nullptr;
+        if (!gst_init_check(nullptr, nullptr, &error)) {
+            throw std::runtime_error("Can't initialize GStreamer: " + takeErrorMessage(error));
+        }
+        preferHardwareDecoders();
+    });
+}
+
+std::string makePipelineDescription(const std::string& input) {
+    // Frames are converted to BGR after decoding, the hardware decoders output NV12
+    const std::string toBgr = " ! videoconvert ! video/x-raw,format=BGR ! appsink name=sink sync=false";
+    if (input.compare(0, sizeof(gstSchemePrefix) - 1, gstSchemePrefix) == 0) {
+        const std::string description = input.substr(sizeof(gstSchemePrefix) - 1);
+        return description.find("name=sink") != std::string::npos ? description
+                                                                   : description + toBgr + " max-buffers=2";
+    }
+    // Live cameras shouldn't be slowed down, so frames the demo doesn't keep up with are dropped by the sink
+    return "uridecodebin uri=\"" + input + "\"" + toBgr + " max-buffers=1 drop=true";
+}
+}  // namespace
+
+GstCapture::GstCapture(const std::string& input,
+                       bool loop,
+                       read_type type,
+                       size_t readLengthLimit,
+                       size_t frameStep)
+    : ImagesCapture{loop},
+      type{type},
+      readLengthLimit{readLengthLimit},
+      frameStep{frameStep} {
+    if (0 == frameStep) {
+        throw std::runtime_error("frameStep must be positive");
+    }
+    initGstreamer();
+    GError* error = nullptr;
+    pipeline = gst_parse_launch(makePipelineDescription(input).c_str(), &error);
+    if (!pipeline) {
+        throw std::runtime_error("Can't create GStreamer pipeline for " + input + ": " + takeErrorMessage(error));
+    }
+    if (error) {
+        // The pipeline is created, but some of its elements may be missing
+        const std::string message = takeErrorMessage(error);
+        gst_object_unref(pipeline);
+        throw std::runtime_error("Can't create GStreamer pipeline for " + input + ": " + message);
+    }
+    sink = gst_bin_get_by_name(GST_BIN(pipeline), "sink");
+    if (!sink || !GST_IS_APP_SINK(sink)) {
+        if (sink) {
+            gst_object_unref(sink);
+        }
+        gst_object_unref(pipeline);
+        throw std::runtime_error("GStreamer pipeline of " + input + " should end with an appsink named \"sink\"");
+    }
+    try {
+        if (gst_element_set_state(pipeline, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+            checkBusErrors();
+            throw std::runtime_error("Can't start GStreamer pipeline");
+        }
+        prerolledSample = gst_app_sink_try_pull_sample(GST_APP_SINK(sink), prerollTimeout);
+        if (!prerolledSample) {
+            checkBusErrors();
+            throw std::runtime_error("The first frame can't be read");
+        }
+        GstVideoInfo info;
+        if (!gst_video_info_from_caps(&info, gst_sample_get_caps(prerolledSample)) ||
+            GST_VIDEO_INFO_FORMAT(&info) != GST_VIDEO_FORMAT_BGR) {
+            throw std::runtime_error("The appsink should receive BGR frames");
+        }
+        captureFps = GST_VIDEO_INFO_FPS_D(&info) > 0 && GST_VIDEO_INFO_FPS_N(&info) > 0
+                         ? static_cast<double>(GST_VIDEO_INFO_FPS_N(&info)) / GST_VIDEO_INFO_FPS_D(&info)
+                         : 30;
+    } catch (const std::exception& e) {
+        if (prerolledSample) {
+            gst_sample_unref(prerolledSample);
+        }
+        gst_element_set_state(pipeline, GST_STATE_NULL);
+        gst_object_unref(sink);
+        gst_object_unref(pipeline);
+        throw std::runtime_error("Can't read " + input + " by GStreamer: " + e.what());
+    }
+}
+
+GstCapture::~GstCapture() {
+    if (prerolledSample) {
+        gst_sample_unref(prerolledSample);
+    }
+    // Frames which are still referred to keep their samples, the buffers outlive the pipeline
+    gst_element_set_state(pipeline, GST_STATE_NULL);
+    gst_object_unref(sink);
+    gst_object_unref(pipeline);
+}
+
+void GstCapture::checkBusErrors() {
+    GstBus* bus = gst_element_get_bus(pipeline);
+    GstMessage* message = gst_bus_pop_filtered(bus, GST_MESSAGE_ERROR);
+    gst_object_unref(bus);
+    if (!message) {
+        return;
+    }
+    GError* error = nullptr;
+    gchar* debugInfo = nullptr;
+    gst_message_parse_error(message, &error, &debugInfo);
+    g_free(debugInfo);
+    gst_message_unref(message);
+    throw std::runtime_error("GStreamer error: " + takeErrorMessage(error));
+}
+
+GstSample* GstCapture::pullSample() {
+    if (prerolledSample) {
+        GstSample* sample = prerolledSample;
+        prerolledSample = nullptr;
+        return sample;
+    }
+    for (;;) {
+        GstSample* sample = gst_app_sink_pull_sample(GST_APP_SINK(sink));
+        if (sample) {
+            return sample;
+        }
+        checkBusErrors();
+        if (!loop || !gst_app_sink_is_eos(GST_APP_SINK(sink)) ||
+            !gst_element_seek_simple(pipeline,
+                                     GST_FORMAT_TIME,
+                                     static_cast<GstSeekFlags>(GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_KEY_UNIT),
+                                     0)) {
+            return nullptr;
+        }
+    }
+}
+
+cv::Mat GstCapture::read() {
+    ITT_SCOPED_TASK("ImagesCapture::read");
+    cv::Mat frame;
+    readInto(frame);
+    return frame;
+}
+
+bool GstCapture::readInto(cv::Mat& frame) {
+    ITT_SCOPED_TASK("ImagesCapture::readInto");
+    auto startTime = std::chrono::steady_clock::now();
+    if (readFramesNum >= readLengthLimit) {
+        frame.release();
+        return false;
+    }
+    GstSample* sample = pullSample();
+    for (size_t i = 1; sample && readFramesNum > 0 && i < frameStep; ++i) {
+        gst_sample_unref(sample);
+        sample = pullSample();
+    }
+    if (!sample) {
+        frame.release();
+        return false;
+    }
+    MappedSample* mapped = new MappedSample{sample, GstVideoFrame()};
+    GstVideoInfo info;
+    GstBuffer* buffer = gst_sample_get_buffer(sample);
+    // Demos draw on frames, so the buffer is mapped for writing if nothing else refers to it
+    const bool isViewWritable = type == read_type::efficient && gst_buffer_is_writable(buffer);
+    if (!gst_video_info_from_caps(&info, gst_sample_get_caps(sample)) ||
+        !gst_video_frame_map(&mapped->frame,
+                             &info,
+                             buffer,
+                             isViewWritable ? static_cast<GstMapFlags>(GST_MAP_READWRITE) : GST_MAP_READ)) {
+        gst_sample_unref(sample);
+        delete mapped;
+        throw std::runtime_error("Can't map the frame of GStreamer pipeline");
+    }
+    cv::Mat view = getMappedSampleAllocator().makeView(mapped);
+    if (isViewWritable) {
+        frame = view;
+    } else {
+        view.copyTo(frame);
+    }
+    ++readFramesNum;
+    readerMetrics.update(startTime);
+    return true;
+}
+#else
+GstCapture::GstCapture(const std::string&, bool loop, read_type type, size_t readLengthLimit, size_t frameStep)
+    : ImagesCapture{loop},
+      type{type},
+      readLengthLimit{readLengthLimit},
+      frameStep{frameStep} {
+    throw std::runtime_error("GStreamer inputs require the demos to be built with DEMOS_USE_GSTREAMER");
+}
+
+GstCapture::~GstCapture() {}
+
+_GstSample* GstCapture::pullSample() {
+    return nullptr;
+}
+
+void GstCapture::checkBusErrors() {}
+
+cv::Mat GstCapture::read() {
+    return cv::Mat{};
+}
+
+bool GstCapture::readInto(cv::Mat&) {
+    return false;
+}
+#endif
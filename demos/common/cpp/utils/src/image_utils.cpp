@@ -24,6 +24,42 @@ cv::Mat resizeImageExt(const cv::Mat& mat, int width, int height, RESIZE_MODE re
     cv::Mat dst;
     int interpMode = hqResize ? cv::INTER_LINEAR : cv::INTER_CUBIC;
 
+    switch (resizeMode) {
+    case RESIZE_FILL:
+    {
+        cv::resize(mat, dst, cv::Size(width, height), interpMode);
+        if (roi) {
+            *roi = cv::Rect(0, 0, width, height);
+        }
+        break;
+    }
+    case RESIZE_KEEP_ASPECT:
+    case RESIZE_KEEP_ASPECT_LETTERBOX:
+    {
+        // The image is resized right into the padded result, so it isn't copied into it from a temporary image
+        dst.create(height, width, mat.type());
+        resizeImageExt(mat, dst, resizeMode, hqResize, roi);
+        break;
+    }
+    }
+    return dst;
+}
+
+void resizeImageExt(const cv::Mat& mat, cv::Mat& dst, RESIZE_MODE resizeMode, bool hqResize, cv::Rect* roi,
+                    bool bordersFilled) {
+    const int width = dst.cols;
+    const int height = dst.rows;
+    dst.create(height, width, mat.type());
+    if (width == mat.cols && height == mat.rows) {
+        mat.copyTo(dst);
+        if (roi) {
+            *roi = cv::Rect(0, 0, width, height);
+        }
+        return;
+    }
+
+    int interpMode = hqResize ? cv::INTER_LINEAR : cv::INTER_CUBIC;
+
     switch (resizeMode) {
     case RESIZE_FILL:
     {
@@ -37,19 +73,43 @@ cv::Mat resizeImageExt(const cv::Mat& mat, int width, int height, RESIZE_MODE re
     case RESIZE_KEEP_ASPECT_LETTERBOX:
     {
         double scale = std::min(static_cast<double>(width) / mat.cols, static_cast<double>(height) / mat.rows);
-        cv::Mat resizedImage;
-        cv::resize(mat, resizedImage, cv::Size(0, 0), scale, scale, interpMode);
+        cv::Size resizedSize(std::min(cv::saturate_cast<int>(mat.cols * scale), width),
+            std::min(cv::saturate_cast<int>(mat.rows * scale), height));
 
-        int dx = resizeMode == RESIZE_KEEP_ASPECT ? 0 : (width - resizedImage.cols) / 2;
-        int dy = resizeMode == RESIZE_KEEP_ASPECT ? 0 : (height - resizedImage.rows) / 2;
+        int dx = resizeMode == RESIZE_KEEP_ASPECT ? 0 : (width - resizedSize.width) / 2;
+        int dy = resizeMode == RESIZE_KEEP_ASPECT ? 0 : (height - resizedSize.height) / 2;
+        cv::Rect resizedRoi(dx, dy, resizedSize.width, resizedSize.height);
 
-        cv::copyMakeBorder(resizedImage, dst, dy, height - resizedImage.rows - dy,
-            dx, width - resizedImage.cols - dx, cv::BORDER_CONSTANT, cv::Scalar(0, 0, 0));
+        // Fill the borders only, the rest is overwritten by the resized image
+        if (!bordersFilled) {
+            dst.rowRange(0, dy).setTo(cv::Scalar(0, 0, 0));
+            dst.rowRange(resizedRoi.br().y, height).setTo(cv::Scalar(0, 0, 0));
+            dst(cv::Rect(0, dy, dx, resizedSize.height)).setTo(cv::Scalar(0, 0, 0));
+            dst(cv::Rect(resizedRoi.br().x, dy, width - resizedRoi.br().x, resizedSize.height))
+                .setTo(cv::Scalar(0, 0, 0));
+        }
+
+        cv::Mat resizedImage = dst(resizedRoi);
+        cv::resize(mat, resizedImage, resizedSize, 0, 0, interpMode);
         if (roi) {
-            *roi = cv::Rect(dx, dy, resizedImage.cols, resizedImage.rows);
+            *roi = resizedRoi;
         }
         break;
     }
     }
-    return dst;
+}
+
+cv::Mat makeMotionThumbnail(const cv::Mat& image) {
+    cv::Mat resized;
+    cv::resize(image, resized, cv::Size(64, 48), 0, 0, cv::INTER_AREA);
+    if (resized.channels() == 1) {
+        return resized;
+    }
+    cv::Mat thumbnail;
+    cv::cvtColor(resized, thumbnail, resized.channels() == 4 ? cv::COLOR_BGRA2GRAY : cv::COLOR_BGR2GRAY);
+    return thumbnail;
+}
+
+double getMotion(const cv::Mat& thumbnail, const cv::Mat& prevThumbnail) {
+    return cv::norm(thumbnail, prevThumbnail, cv::NORM_L1) / (thumbnail.total() * 255.0);
 }
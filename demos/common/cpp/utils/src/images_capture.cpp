@@ -5,23 +5,41 @@
 
 #include <string.h>
 
+#include <stdint.h>
+
 #ifdef _WIN32
 #    include "w_dirent.hpp"
 #else
 #    include <dirent.h>  // for closedir, dirent, opendir, readdir, DIR
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
 #endif
 
 #include <algorithm>
 #include <chrono>
+#include <condition_variable>
 #include <fstream>
+#include <list>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
 #include <opencv2/videoio.hpp>
 
+#include "utils/frame_bus.hpp"
+#include "utils/gst_capture.hpp"
+#include "utils/itt.hpp"
+
 class InvalidInput : public std::runtime_error {
 public:
     explicit InvalidInput(const std::string& message) noexcept : std::runtime_error(message) {}
@@ -32,6 +50,135 @@ public:
     explicit OpenError(const std::string& message) noexcept : std::runtime_error(message) {}
 };
 
+namespace {
+// Sorted names of files in the directory
+std::vector<std::string> readDirNames(const std::string& input) {
+    std::vector<std::string> names;
+    DIR* dir = opendir(input.c_str());
+    if (!dir)
+        throw InvalidInput("Can't find the dir by " + input);
+    while (struct dirent* ent = readdir(dir))
+        if (strcmp(ent->d_name, ".") && strcmp(ent->d_name, ".."))
+            names.emplace_back(ent->d_name);
+    closedir(dir);
+    if (names.empty())
+        throw OpenError("The dir " + input + " is empty");
+    sort(names.begin(), names.end());
+    return names;
+}
+
+// Index of the file containing the image number initialImageId, counting only decodable files
+size_t findFirstFileId(const std::string& input, const std::vector<std::string>& names, size_t initialImageId) {
+    size_t readImgs = 0;
+    for (size_t fileId = 0; fileId < names.size(); ++fileId) {
+        cv::Mat img = cv::imread(input + '/' + names[fileId]);
+        if (img.data) {
+            ++readImgs;
+            if (readImgs - 1 >= initialImageId)
+                return fileId;
+        }
+    }
+    throw OpenError("Can't read the first image from " + input);
+}
+
+// Read-only file mapping. Pages are mapped copy-on-write, so views of frames can be modified by callers without
+// changing the file or frames seen by other processes.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& fileName) {
+#ifdef _WIN32
+        file = CreateFileA(fileName.c_str(),
+                           GENERIC_READ,
+                           FILE_SHARE_READ,
+                           nullptr,
+                           OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL,
+                           nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Can't open " + fileName);
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize)) {
+            CloseHandle(file);
+            throw std::runtime_error("Can't get the size of " + fileName);
+        }
+        size = static_cast<size_t>(fileSize.QuadPart);
+        mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        if (!mapping) {
+            CloseHandle(file);
+            throw std::runtime_error("Can't map " + fileName);
+        }
+        data = static_cast<uint8_t*>(MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0));
+        if (!data) {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            throw std::runtime_error("Can't map " + fileName);
+        }
+#else
+        const int fd = open(fileName.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Can't open " + fileName);
+        }
+        struct stat fileStat;
+        if (fstat(fd, &fileStat) != 0) {
+            close(fd);
+            throw std::runtime_error("Can't get the size of " + fileName);
+        }
+        size = static_cast<size_t>(fileStat.st_size);
+        void* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED) {
+            throw std::runtime_error("Can't map " + fileName);
+        }
+        data = static_cast<uint8_t*>(mapped);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+        CloseHandle(mapping);
+        CloseHandle(file);
+#else
+        munmap(data, size);
+#endif
+    }
+
+    uint8_t* data;
+    size_t size;
+
+private:
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+};
+
+// Header of a packed frames file, all fields are little endian. It is followed by frames, which begin at offsets
+// listed in the index, and the index itself: framesNum uint64_t offsets.
+#pragma pack(push, 1)
+struct PackedFramesHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t format;
+    uint32_t width;
+    uint32_t height;
+    uint64_t framesNum;
+    uint64_t frameStride;
+    uint64_t dataOffset;
+    uint64_t indexOffset;
+    double fps;
+};
+#pragma pack(pop)
+
+const char packedFramesMagic[8] = {'O', 'M', 'Z', 'F', 'R', 'M', 'S', '\0'};
+const uint32_t packedFramesVersion = 1;
+enum PackedFramesFormat : uint32_t { BGR = 0, NV12 = 1 };
+}  // namespace
+
 class ImreadWrapper : public ImagesCapture {
     cv::Mat img;
     bool canRead;
@@ -60,6 +207,7 @@ public:
     }
 
     cv::Mat read() override {
+        ITT_SCOPED_TASK("ImagesCapture::read");
         if (loop)
             return img.clone();
         if (canRead) {
@@ -68,6 +216,17 @@ public:
         }
         return cv::Mat{};
     }
+
+    bool readInto(cv::Mat& frame) override {
+        ITT_SCOPED_TASK("ImagesCapture::readInto");
+        if (loop || canRead) {
+            canRead = false;
+            img.copyTo(frame);
+            return true;
+        }
+        frame.release();
+        return false;
+    }
 };
 
 class DirReader : public ImagesCapture {
@@ -86,27 +245,8 @@ public:
           initialImageId{initialImageId},
           readLengthLimit{readLengthLimit},
           input{input} {
-        DIR* dir = opendir(input.c_str());
-        if (!dir)
-            throw InvalidInput("Can't find the dir by " + input);
-        while (struct dirent* ent = readdir(dir))
-            if (strcmp(ent->d_name, ".") && strcmp(ent->d_name, ".."))
-                names.emplace_back(ent->d_name);
-        closedir(dir);
-        if (names.empty())
-            throw OpenError("The dir " + input + " is empty");
-        sort(names.begin(), names.end());
-        size_t readImgs = 0;
-        while (fileId < names.size()) {
-            cv::Mat img = cv::imread(input + '/' + names[fileId]);
-            if (img.data) {
-                ++readImgs;
-                if (readImgs - 1 >= initialImageId)
-                    return;
-            }
-            ++fileId;
-        }
-        throw OpenError("Can't read the first image from " + input);
+        names = readDirNames(input);
+        fileId = findFirstFileId(input, names, initialImageId);
     }
 
     double fps() const override {
@@ -118,15 +258,22 @@ public:
     }
 
     cv::Mat read() override {
+        cv::Mat img;
+        readInto(img);
+        return img;
+    }
+
+    bool readInto(cv::Mat& frame) override {
+        ITT_SCOPED_TASK("ImagesCapture::readInto");
         auto startTime = std::chrono::steady_clock::now();
 
         while (fileId < names.size() && nextImgId < readLengthLimit) {
-            cv::Mat img = cv::imread(input + '/' + names[fileId]);
+            const bool decoded = decode(input + '/' + names[fileId], frame);
             ++fileId;
-            if (img.data) {
+            if (decoded) {
                 ++nextImgId;
                 readerMetrics.update(startTime);
-                return img;
+                return true;
             }
         }
 
@@ -134,22 +281,331 @@ public:
             fileId = 0;
             size_t readImgs = 0;
             while (fileId < names.size()) {
-                cv::Mat img = cv::imread(input + '/' + names[fileId]);
+                const bool decoded = decode(input + '/' + names[fileId], frame);
                 ++fileId;
-                if (img.data) {
+                if (decoded) {
                     ++readImgs;
                     if (readImgs - 1 >= initialImageId) {
                         nextImgId = 1;
                         readerMetrics.update(startTime);
-                        return img;
+                        return true;
                     }
                 }
             }
         }
+        frame.release();
+        return false;
+    }
+
+private:
+    // Unlike cv::imread(), cv::imdecode() reuses the buffer of img if the image has the same size
+    bool decode(const std::string& path, cv::Mat& img) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            return false;
+        }
+        fileBytes.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        if (fileBytes.empty() || !file.read(reinterpret_cast<char*>(fileBytes.data()), fileBytes.size())) {
+            return false;
+        }
+        // Returns an empty Mat if the file isn't an image, img may keep a previous image then
+        return !cv::imdecode(fileBytes, cv::IMREAD_COLOR, &img).empty();
+    }
+
+    std::vector<uchar> fileBytes;
+};
+
+// Decodes files of a directory by a pool of threads. Files are numbered by positions in the sequence of passes over
+// the directory, every pass starts from the first file. Threads decode positions in a window following the next one
+// to be read, results are read in the order of positions, so the order of images is the same as of DirReader.
+class ParallelDirReader : public ImagesCapture {
+    struct CachedImage {
+        size_t fileId;
+        cv::Mat img;
+    };
+
+    const std::string input;
+    std::vector<std::string> names;
+    size_t firstFileId;
+    size_t passLength;
+    const size_t readLengthLimit;
+    const size_t windowSize;
+
+    std::mutex mtx;
+    std::condition_variable condVar;
+    // Position of the next image to return from read() and the next position to decode
+    size_t nextPosition;
+    size_t nextDecodePosition;
+    // Images read during the current pass, the pass ends when it reaches readLengthLimit
+    size_t passImages;
+    // Decoded images waiting to be read, empty Mat represents a file which can't be decoded
+    std::map<size_t, cv::Mat> decodedImages;
+    bool stopDecoding;
+
+    const size_t cacheSizeLimit;
+    size_t cacheSize;
+    // Cached images from the most recently used to the least one
+    std::list<CachedImage> cache;
+    std::unordered_map<size_t, std::list<CachedImage>::iterator> cacheIndex;
+
+    std::vector<std::thread> decodingThreads;
+
+public:
+    ParallelDirReader(const std::string& input,
+                      bool loop,
+                      size_t decodingThreadsNum,
+                      size_t cacheSizeLimit,
+                      size_t initialImageId,
+                      size_t readLengthLimit)
+        : ImagesCapture{loop},
+          input{input},
+          readLengthLimit{readLengthLimit},
+          windowSize{2 * decodingThreadsNum},
+          nextPosition{0},
+          nextDecodePosition{0},
+          passImages{0},
+          stopDecoding{false},
+          cacheSizeLimit{loop ? cacheSizeLimit : 0},
+          cacheSize{0} {
+        if (0 == decodingThreadsNum) {
+            throw std::invalid_argument("Number of decoding threads must be positive");
+        }
+        names = readDirNames(input);
+        firstFileId = findFirstFileId(input, names, initialImageId);
+        passLength = names.size() - firstFileId;
+        for (size_t i = 0; i < decodingThreadsNum; ++i) {
+            decodingThreads.emplace_back(&ParallelDirReader::decodingThreadFunc, this);
+        }
+    }
+
+    ~ParallelDirReader() override {
+        {
+            const std::lock_guard<std::mutex> lock(mtx);
+            stopDecoding = true;
+        }
+        condVar.notify_all();
+        for (auto& thread : decodingThreads) {
+            thread.join();
+        }
+    }
+
+    double fps() const override {
+        return 1.0;
+    }
+
+    std::string getType() const override {
+        return "DIR";
+    }
+
+    cv::Mat read() override {
+        ITT_SCOPED_TASK("ImagesCapture::read");
+        auto startTime = std::chrono::steady_clock::now();
+
+        std::unique_lock<std::mutex> lock(mtx);
+        while (loop || nextPosition < passLength) {
+            condVar.wait(lock, [&]() {
+                return decodedImages.count(nextPosition) != 0;
+            });
+            auto imgIt = decodedImages.find(nextPosition);
+            cv::Mat img = std::move(imgIt->second);
+            decodedImages.erase(imgIt);
+            ++nextPosition;
+            if (img.data && ++passImages == readLengthLimit) {
+                // Skip the rest of the pass
+                nextPosition = (nextPosition + passLength - 1) / passLength * passLength;
+                nextDecodePosition = std::max(nextDecodePosition, nextPosition);
+                decodedImages.erase(decodedImages.begin(), decodedImages.lower_bound(nextPosition));
+            }
+            if (nextPosition % passLength == 0) {
+                passImages = 0;
+            }
+            condVar.notify_all();
+            if (img.data) {
+                readerMetrics.update(startTime);
+                return img;
+            }
+        }
         return cv::Mat{};
     }
+
+private:
+    bool shouldDecode(size_t position) const {
+        return position < nextPosition + windowSize && (loop || position < passLength);
+    }
+
+    void decodingThreadFunc() {
+        std::unique_lock<std::mutex> lock(mtx);
+        for (;;) {
+            condVar.wait(lock, [&]() {
+                return stopDecoding || shouldDecode(nextDecodePosition);
+            });
+            if (stopDecoding) {
+                return;
+            }
+            const size_t position = nextDecodePosition++;
+            const size_t fileId = firstFileId + position % passLength;
+
+            cv::Mat img = findInCache(fileId);
+            bool isCached = !img.empty();
+            if (!isCached) {
+                lock.unlock();
+                img = cv::imread(input + '/' + names[fileId]);
+                lock.lock();
+                isCached = addToCache(fileId, img);
+            }
+            if (isCached) {
+                // Cached images are shared, a copy is returned because the caller may modify it
+                lock.unlock();
+                img = img.clone();
+                lock.lock();
+            }
+            // The position could be skipped while the image was decoded
+            if (position >= nextPosition) {
+                decodedImages.emplace(position, std::move(img));
+                condVar.notify_all();
+            }
+        }
+    }
+
+    cv::Mat findInCache(size_t fileId) {
+        auto indexIt = cacheIndex.find(fileId);
+        if (indexIt == cacheIndex.end()) {
+            return cv::Mat{};
+        }
+        cache.splice(cache.begin(), cache, indexIt->second);
+        return indexIt->second->img;
+    }
+
+    // @returns true if the image is added to the cache
+    bool addToCache(size_t fileId, const cv::Mat& img) {
+        const size_t imgSize = img.total() * img.elemSize();
+        if (!img.data || imgSize > cacheSizeLimit || cacheIndex.count(fileId) != 0) {
+            return false;
+        }
+        while (cacheSize + imgSize > cacheSizeLimit) {
+            const CachedImage& evicted = cache.back();
+            cacheSize -= evicted.img.total() * evicted.img.elemSize();
+            cacheIndex.erase(evicted.fileId);
+            cache.pop_back();
+        }
+        cache.push_front(CachedImage{fileId, img});
+        cacheIndex[fileId] = cache.begin();
+        cacheSize += imgSize;
+        return true;
+    }
 };
 
+// Reads frames packed by demos/common/python/pack_frames.py. The file is memory mapped and BGR frames are returned as
+// views of the mapped pages, so reading doesn't decode or copy anything and the page cache is shared by processes.
+// Frames are copied if they are requested to be safe or loop is true, because callers may draw on the frames and the
+// drawing would be visible on the next pass otherwise. NV12 frames are converted to BGR.
+class PackedFramesReader : public ImagesCapture {
+    std::unique_ptr<MappedFile> file;
+    PackedFramesHeader header;
+    const uint64_t* frameOffsets;
+    const read_type type;
+    const size_t initialImageId;
+    size_t endImageId;
+    size_t nextImgId;
+
+public:
+    PackedFramesReader(const std::string& input,
+                       bool loop,
+                       read_type type,
+                       size_t initialImageId,
+                       size_t readLengthLimit)
+        : ImagesCapture{loop},
+          type{type},
+          initialImageId{initialImageId},
+          nextImgId{initialImageId} {
+        {
+            std::ifstream inputFile(input, std::ios::binary);
+            if (!inputFile.good())
+                throw InvalidInput("Can't find the packed frames by " + input);
+            char magic[sizeof(packedFramesMagic)] = {};
+            inputFile.read(magic, sizeof(magic));
+            if (!inputFile.good() || memcmp(magic, packedFramesMagic, sizeof(magic)))
+                throw InvalidInput(input + " isn't a packed frames file");
+        }
+        file.reset(new MappedFile(input));
+        if (file->size < sizeof(PackedFramesHeader))
+            throw OpenError("The header of " + input + " is truncated");
+        memcpy(&header, file->data, sizeof(header));
+        if (header.version != packedFramesVersion)
+            throw OpenError("Unsupported version of packed frames " + std::to_string(header.version));
+        if (header.format != PackedFramesFormat::BGR && header.format != PackedFramesFormat::NV12)
+            throw OpenError("Unsupported format of packed frames " + std::to_string(header.format));
+        if (header.format == PackedFramesFormat::NV12 && (header.width % 2 || header.height % 2))
+            throw OpenError("NV12 frames should have even sizes");
+        if (header.indexOffset % sizeof(uint64_t) ||
+            header.indexOffset + header.framesNum * sizeof(uint64_t) > file->size)
+            throw OpenError("The index of " + input + " is truncated");
+        frameOffsets = reinterpret_cast<const uint64_t*>(file->data + header.indexOffset);
+        for (size_t i = 0; i < header.framesNum; ++i) {
+            if (frameOffsets[i] + getFrameSize() > file->size)
+                throw OpenError("The frame " + std::to_string(i) + " of " + input + " is truncated");
+        }
+        if (initialImageId >= header.framesNum)
+            throw OpenError("Can't read the first image from " + input);
+        endImageId = initialImageId + std::min<size_t>(readLengthLimit, header.framesNum - initialImageId);
+    }
+
+    double fps() const override {
+        return header.fps;
+    }
+
+    std::string getType() const override {
+        return "PACKED";
+    }
+
+    cv::Mat read() override {
+        ITT_SCOPED_TASK("ImagesCapture::read");
+        auto startTime = std::chrono::steady_clock::now();
+
+        if (nextImgId >= endImageId) {
+            if (!loop)
+                return cv::Mat{};
+            nextImgId = initialImageId;
+        }
+        const int width = static_cast<int>(header.width);
+        const int height = static_cast<int>(header.height);
+        uint8_t* frameData = file->data + frameOffsets[nextImgId++];
+        cv::Mat img;
+        if (header.format == PackedFramesFormat::NV12) {
+            cv::cvtColor(cv::Mat(height * 3 / 2, width, CV_8UC1, frameData), img, cv::COLOR_YUV2BGR_NV12);
+        } else {
+            img = cv::Mat(height, width, CV_8UC3, frameData);
+            if (type == read_type::safe || loop) {
+                img = img.clone();
+            }
+        }
+        readerMetrics.update(startTime);
+        return img;
+    }
+
+private:
+    size_t getFrameSize() const {
+        const size_t pixels = static_cast<size_t>(header.width) * header.height;
+        return header.format == PackedFramesFormat::NV12 ? pixels * 3 / 2 : pixels * 3;
+    }
+};
+
+namespace {
+// Frames which aren't returned are grabbed without decoding
+bool skipFrames(cv::VideoCapture& cap, size_t framesNum) {
+    for (size_t i = 0; i < framesNum; ++i) {
+        if (!cap.grab()) {
+            return false;
+        }
+    }
+    return true;
+}
+}  // namespace
+
+// In low latency mode frames are grabbed by a background thread as fast as the stream delivers them and only the
+// newest one is kept, so read() doesn't return frames which waited in the buffers of the backend while previous frames
+// were processed. Frames replaced before they are read are counted as dropped by getMetrics().
 class VideoCapWrapper : public ImagesCapture {
     cv::VideoCapture cap;
     bool first_read;
@@ -157,28 +613,95 @@ class VideoCapWrapper : public ImagesCapture {
     size_t nextImgId;
     const double initialImageId;
     size_t readLengthLimit;
+    const size_t frameStep;
+    const bool lowLatency;
+    // cap isn't queried while the grabbing thread reads from it
+    double captureFps = 0;
+
+    std::mutex mtx;
+    std::condition_variable condVar;
+    // The newest grabbed frame which isn't read yet, it's empty once it's read
+    cv::Mat latestFrame;
+    bool endOfStream = false;
+    bool stopGrabbing = false;
+    std::exception_ptr grabbingException;
+    // Copy of the metrics of the grabbing thread updated after every grabbed frame
+    PerformanceMetrics captureMetrics;
+    std::thread grabbingThread;
 
 public:
-    VideoCapWrapper(const std::string& input, bool loop, read_type type, size_t initialImageId, size_t readLengthLimit)
+    VideoCapWrapper(const std::string& input,
+                    bool loop,
+                    read_type type,
+                    size_t initialImageId,
+                    size_t readLengthLimit,
+                    size_t frameStep,
+                    int videoAcceleration,
+                    int videoAccelerationDevice,
+                    bool lowLatency)
         : ImagesCapture{loop},
           first_read{true},
           type{type},
           nextImgId{0},
-          initialImageId{static_cast<double>(initialImageId)} {
+          initialImageId{static_cast<double>(initialImageId)},
+          frameStep{frameStep},
+          lowLatency{lowLatency} {
         if (0 == readLengthLimit) {
             throw std::runtime_error("readLengthLimit must be positive");
         }
-        if (cap.open(input)) {
+        if (0 == frameStep) {
+            throw std::runtime_error("frameStep must be positive");
+        }
+        bool isOpened;
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && (CV_VERSION_MINOR > 5 || \
+                                                        (CV_VERSION_MINOR == 5 && CV_VERSION_REVISION >= 2)))
+        isOpened = cap.open(input,
+                            cv::CAP_ANY,
+                            {cv::CAP_PROP_HW_ACCELERATION,
+                             videoAcceleration,
+                             cv::CAP_PROP_HW_DEVICE,
+                             videoAccelerationDevice});
+#else
+        if (videoAcceleration != 0) {
+            throw std::runtime_error("Hardware accelerated decoding requires OpenCV 4.5.2 or newer");
+        }
+        isOpened = cap.open(input);
+#endif
+        if (isOpened) {
             this->readLengthLimit = readLengthLimit;
             if (!cap.set(cv::CAP_PROP_POS_FRAMES, this->initialImageId))
                 throw OpenError("Can't set the frame to begin with");
+            if (lowLatency) {
+                // Backends which don't support the property keep their default buffering
+                cap.set(cv::CAP_PROP_BUFFERSIZE, 1);
+                captureFps = cap.get(cv::CAP_PROP_FPS);
+                grabbingThread = std::thread(&VideoCapWrapper::grabbingThreadFunc, this);
+            }
             return;
         }
         throw InvalidInput("Can't open the video from " + input);
     }
 
+    ~VideoCapWrapper() override {
+        if (grabbingThread.joinable()) {
+            {
+                const std::lock_guard<std::mutex> lock(mtx);
+                stopGrabbing = true;
+            }
+            grabbingThread.join();
+        }
+    }
+
     double fps() const override {
-        return cap.get(cv::CAP_PROP_FPS);
+        return lowLatency ? captureFps : cap.get(cv::CAP_PROP_FPS);
+    }
+
+    const PerformanceMetrics& getMetrics() override {
+        if (lowLatency) {
+            const std::lock_guard<std::mutex> lock(mtx);
+            readerMetrics = captureMetrics;
+        }
+        return readerMetrics;
     }
 
     std::string getType() const override {
@@ -186,38 +709,122 @@ public:
     }
 
     cv::Mat read() override {
+        ITT_SCOPED_TASK("ImagesCapture::read");
+        cv::Mat img;
+        if (lowLatency) {
+            takeLatestFrame(img);
+            return img;
+        }
+        if (readFrame(img, readerMetrics) && type == read_type::safe) {
+            img = img.clone();
+        }
+        return img;
+    }
+
+    bool readInto(cv::Mat& frame) override {
+        ITT_SCOPED_TASK("ImagesCapture::readInto");
+        if (lowLatency) {
+            // Grabbed frames are copies, the buffer of frame is given to the grabbing thread in exchange
+            return takeLatestFrame(frame);
+        }
+        if (type == read_type::safe) {
+            // The backend may own the buffer of the read frame, so it is copied to the frame's buffer
+            cv::Mat img;
+            if (!readFrame(img, readerMetrics)) {
+                frame.release();
+                return false;
+            }
+            img.copyTo(frame);
+            return true;
+        }
+        return readFrame(frame, readerMetrics);
+    }
+
+private:
+    // Waits for a frame newer than the last read one, doesn't wait if it's already grabbed
+    bool takeLatestFrame(cv::Mat& frame) {
+        std::unique_lock<std::mutex> lock(mtx);
+        condVar.wait(lock, [&]() {
+            return !latestFrame.empty() || endOfStream || grabbingException;
+        });
+        if (grabbingException) {
+            std::rethrow_exception(grabbingException);
+        }
+        if (latestFrame.empty()) {
+            frame.release();
+            return false;
+        }
+        std::swap(frame, latestFrame);
+        latestFrame.release();
+        return true;
+    }
+
+    void grabbingThreadFunc() {
+        // The backend may own the buffer of the grabbed frame, so it's copied to a spare buffer, which is swapped with
+        // the latest frame. Buffers of the frames which aren't read are reused.
+        cv::Mat grabbed, spare;
+        PerformanceMetrics metrics;
+        for (;;) {
+            bool isGrabbed;
+            try {
+                isGrabbed = readFrame(grabbed, metrics);
+                if (isGrabbed) {
+                    grabbed.copyTo(spare);
+                }
+            } catch (...) {
+                const std::lock_guard<std::mutex> lock(mtx);
+                grabbingException = std::current_exception();
+                condVar.notify_all();
+                return;
+            }
+            const std::lock_guard<std::mutex> lock(mtx);
+            if (!isGrabbed) {
+                endOfStream = true;
+                captureMetrics = metrics;
+                condVar.notify_all();
+                return;
+            }
+            if (!latestFrame.empty()) {
+                metrics.registerDroppedFrame();
+            }
+            std::swap(latestFrame, spare);
+            captureMetrics = metrics;
+            condVar.notify_all();
+            if (stopGrabbing) {
+                return;
+            }
+        }
+    }
+
+    bool readFrame(cv::Mat& img, PerformanceMetrics& metrics) {
         auto startTime = std::chrono::steady_clock::now();
 
         if (nextImgId >= readLengthLimit) {
             if (loop && cap.set(cv::CAP_PROP_POS_FRAMES, initialImageId)) {
                 nextImgId = 1;
-                cv::Mat img;
                 cap.read(img);
-                if (type == read_type::safe) {
-                    img = img.clone();
-                }
-                readerMetrics.update(startTime);
-                return img;
+                metrics.update(startTime);
+                return img.data != nullptr;
             }
-            return cv::Mat{};
+            img.release();
+            return false;
         }
-        cv::Mat img;
-        bool success = cap.read(img);
+        bool success = (first_read || skipFrames(cap, frameStep - 1)) && cap.read(img);
         if (!success && first_read) {
             throw std::runtime_error("The first image can't be read");
         }
         first_read = false;
         if (!success && loop && cap.set(cv::CAP_PROP_POS_FRAMES, initialImageId)) {
             nextImgId = 1;
-            cap.read(img);
+            success = cap.read(img);
         } else {
             ++nextImgId;
         }
-        if (type == read_type::safe) {
-            img = img.clone();
+        if (!success) {
+            img.release();  // skipped frames fail without touching img, which may hold a recycled buffer
         }
-        readerMetrics.update(startTime);
-        return img;
+        metrics.update(startTime);
+        return success;
     }
 };
 
@@ -226,19 +833,25 @@ class CameraCapWrapper : public ImagesCapture {
     const read_type type;
     size_t nextImgId;
     size_t readLengthLimit;
+    const size_t frameStep;
 
 public:
     CameraCapWrapper(const std::string& input,
                      bool loop,
                      read_type type,
                      size_t readLengthLimit,
-                     cv::Size cameraResolution)
+                     cv::Size cameraResolution,
+                     size_t frameStep)
         : ImagesCapture{loop},
           type{type},
-          nextImgId{0} {
+          nextImgId{0},
+          frameStep{frameStep} {
         if (0 == readLengthLimit) {
             throw std::runtime_error("readLengthLimit must be positive");
         }
+        if (0 == frameStep) {
+            throw std::runtime_error("frameStep must be positive");
+        }
         try {
             if (cap.open(std::stoi(input))) {
                 this->readLengthLimit = loop ? std::numeric_limits<size_t>::max() : readLengthLimit;
@@ -264,13 +877,14 @@ public:
     }
 
     cv::Mat read() override {
+        ITT_SCOPED_TASK("ImagesCapture::read");
         auto startTime = std::chrono::steady_clock::now();
 
         if (nextImgId >= readLengthLimit) {
             return cv::Mat{};
         }
         cv::Mat img;
-        if (!cap.read(img)) {
+        if ((nextImgId != 0 && !skipFrames(cap, frameStep - 1)) || !cap.read(img)) {
             throw std::runtime_error("The image can't be captured from the camera");
         }
         if (type == read_type::safe) {
@@ -283,15 +897,133 @@ public:
     }
 };
 
-std::unique_ptr<ImagesCapture> openImagesCapture(const std::string& input,
-                                                 bool loop,
-                                                 read_type type,
-                                                 size_t initialImageId,
-                                                 size_t readLengthLimit,
-                                                 cv::Size cameraResolution) {
+PrefetchingCapture::PrefetchingCapture(std::unique_ptr<ImagesCapture>&& capture, size_t queueSize)
+    : ImagesCapture{capture->loop},
+      capture{std::move(capture)},
+      queueSize{queueSize},
+      captureFps{this->capture->fps()},
+      captureType{this->capture->getType()},
+      captureMetrics{this->capture->getMetrics()} {
+    if (0 == queueSize) {
+        throw std::invalid_argument("Prefetching queue size must be positive");
+    }
+    prefetchingThread = std::thread(&PrefetchingCapture::prefetchingThreadFunc, this);
+}
+
+PrefetchingCapture::~PrefetchingCapture() {
+    {
+        const std::lock_guard<std::mutex> lock(mtx);
+        stopPrefetching = true;
+    }
+    condVar.notify_all();
+    prefetchingThread.join();
+}
+
+cv::Mat PrefetchingCapture::read() {
+    ITT_SCOPED_TASK("ImagesCapture::read");
+    std::unique_lock<std::mutex> lock(mtx);
+    if (frames.empty() && !endOfStream && !prefetchingException) {
+        auto startTime = std::chrono::steady_clock::now();
+        condVar.wait(lock, [&]() {
+            return !frames.empty() || endOfStream || prefetchingException;
+        });
+        stallTime += std::chrono::steady_clock::now() - startTime;
+    }
+    if (prefetchingException) {
+        std::rethrow_exception(prefetchingException);
+    }
+    if (frames.empty()) {
+        return cv::Mat{};
+    }
+    cv::Mat frame = std::move(frames.front());
+    frames.pop_front();
+    framesMemory.subtract(getMatBytes(frame));
+    condVar.notify_all();
+    return frame;
+}
+
+const PerformanceMetrics& PrefetchingCapture::getMetrics() {
+    const std::lock_guard<std::mutex> lock(mtx);
+    readerMetrics = captureMetrics;
+    return readerMetrics;
+}
+
+size_t PrefetchingCapture::getQueueDepth() {
+    const std::lock_guard<std::mutex> lock(mtx);
+    return frames.size();
+}
+
+PerformanceMetrics::Duration PrefetchingCapture::getStallTime() {
+    const std::lock_guard<std::mutex> lock(mtx);
+    return stallTime;
+}
+
+void PrefetchingCapture::prefetchingThreadFunc() {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            condVar.wait(lock, [&]() {
+                return stopPrefetching || frames.size() < queueSize;
+            });
+            if (stopPrefetching) {
+                return;
+            }
+        }
+        cv::Mat frame;
+        try {
+            frame = capture->read();
+        } catch (...) {
+            const std::lock_guard<std::mutex> lock(mtx);
+            prefetchingException = std::current_exception();
+            condVar.notify_all();
+            return;
+        }
+        const std::lock_guard<std::mutex> lock(mtx);
+        captureMetrics = capture->getMetrics();
+        if (frame.empty()) {
+            endOfStream = true;
+            condVar.notify_all();
+            return;
+        }
+        framesMemory.add(getMatBytes(frame));
+        frames.push_back(std::move(frame));
+        condVar.notify_all();
+    }
+}
+
+namespace {
+std::unique_ptr<ImagesCapture> openCapture(const std::string& input,
+                                           bool loop,
+                                           read_type type,
+                                           size_t initialImageId,
+                                           size_t readLengthLimit,
+                                           cv::Size cameraResolution,
+                                           size_t frameStep,
+                                           int videoAcceleration,
+                                           int videoAccelerationDevice,
+                                           bool lowLatency) {
     if (readLengthLimit == 0)
         throw std::runtime_error{"Read length limit must be positive"};
+    const std::string frameBusScheme = "shm://";
+    if (input.compare(0, frameBusScheme.size(), frameBusScheme) == 0)
+        return std::unique_ptr<ImagesCapture>(
+            new FrameBusReader{input.substr(frameBusScheme.size()), readLengthLimit, frameStep});
+    const std::string gstScheme = "gst://";
+    if (input.compare(0, gstScheme.size(), gstScheme) == 0)
+        return std::unique_ptr<ImagesCapture>(new GstCapture{input, loop, type, readLengthLimit, frameStep});
+#ifdef USE_GSTREAMER
+    // Without the native backend RTSP streams are read by cv::VideoCapture
+    if (input.compare(0, 7, "rtsp://") == 0 || input.compare(0, 8, "rtsps://") == 0)
+        return std::unique_ptr<ImagesCapture>(new GstCapture{input, loop, type, readLengthLimit, frameStep});
+#endif
     std::vector<std::string> invalidInputs, openErrors;
+    try {
+        return std::unique_ptr<ImagesCapture>(
+            new PackedFramesReader{input, loop, type, initialImageId, readLengthLimit});
+    } catch (const InvalidInput& e) { invalidInputs.push_back(e.what()); } catch (const OpenError& e) {
+        openErrors.push_back(e.what());
+    }
+
     try {
         return std::unique_ptr<ImagesCapture>(new ImreadWrapper{input, loop});
     } catch (const InvalidInput& e) { invalidInputs.push_back(e.what()); } catch (const OpenError& e) {
@@ -305,14 +1037,22 @@ std::unique_ptr<ImagesCapture> openImagesCapture(const std::string& input,
     }
 
     try {
-        return std::unique_ptr<ImagesCapture>(new VideoCapWrapper{input, loop, type, initialImageId, readLengthLimit});
+        return std::unique_ptr<ImagesCapture>(new VideoCapWrapper{input,
+                                                                  loop,
+                                                                  type,
+                                                                  initialImageId,
+                                                                  readLengthLimit,
+                                                                  frameStep,
+                                                                  videoAcceleration,
+                                                                  videoAccelerationDevice,
+                                                                  lowLatency});
     } catch (const InvalidInput& e) { invalidInputs.push_back(e.what()); } catch (const OpenError& e) {
         openErrors.push_back(e.what());
     }
 
     try {
         return std::unique_ptr<ImagesCapture>(
-            new CameraCapWrapper{input, loop, type, readLengthLimit, cameraResolution});
+            new CameraCapWrapper{input, loop, type, readLengthLimit, cameraResolution, frameStep});
     } catch (const InvalidInput& e) { invalidInputs.push_back(e.what()); } catch (const OpenError& e) {
         openErrors.push_back(e.what());
     }
@@ -324,3 +1064,56 @@ std::unique_ptr<ImagesCapture> openImagesCapture(const std::string& input,
     }
     throw std::runtime_error(errorsInfo);
 }
+}  // namespace
+
+std::unique_ptr<ImagesCapture> openImagesCapture(const std::string& input,
+                                                 bool loop,
+                                                 read_type type,
+                                                 size_t initialImageId,
+                                                 size_t readLengthLimit,
+                                                 cv::Size cameraResolution,
+                                                 size_t prefetchQueueSize,
+                                                 size_t frameStep,
+                                                 int videoAcceleration,
+                                                 int videoAccelerationDevice,
+                                                 bool lowLatency) {
+    if (0 == prefetchQueueSize) {
+        return openCapture(input,
+                           loop,
+                           type,
+                           initialImageId,
+                           readLengthLimit,
+                           cameraResolution,
+                           frameStep,
+                           videoAcceleration,
+                           videoAccelerationDevice,
+                           lowLatency);
+    }
+    if (lowLatency) {
+        throw std::invalid_argument("Low latency mode keeps only the newest frame, it can't be prefetched");
+    }
+    // Queued frames must not share buffers owned by the decoder
+    return std::unique_ptr<ImagesCapture>(new PrefetchingCapture(openCapture(input,
+                                                                             loop,
+                                                                             read_type::safe,
+                                                                             initialImageId,
+                                                                             readLengthLimit,
+                                                                             cameraResolution,
+                                                                             frameStep,
+                                                                             videoAcceleration,
+                                                                             videoAccelerationDevice,
+                                                                             false),
+                                                                 prefetchQueueSize));
+}
+
+std::unique_ptr<ImagesCapture> openParallelDirReader(const std::string& input,
+                                                     bool loop,
+                                                     size_t decodingThreads,
+                                                     size_t cacheSizeLimit,
+                                                     size_t initialImageId,
+                                                     size_t readLengthLimit) {
+    if (readLengthLimit == 0)
+        throw std::runtime_error{"Read length limit must be positive"};
+    return std::unique_ptr<ImagesCapture>(
+        new ParallelDirReader{input, loop, decodingThreads, cacheSizeLimit, initialImageId, readLengthLimit});
+}
@@ -0,0 +1,48 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "utils/itt.hpp"
+
+#ifdef USE_ITT
+namespace {
+__itt_string_handle* getFrameIdKey() {
+    static __itt_string_handle* const key = __itt_string_handle_create("frame_id");
+    return key;
+}
+
+__itt_id makeId(const void* owner, int64_t frameId) {
+    return __itt_id_make(const_cast<void*>(owner), static_cast<unsigned long long>(frameId));
+}
+}  // namespace
+
+namespace itt {
+__itt_domain* getDomain() {
+    static __itt_domain* const domain = __itt_domain_create("omz_demos");
+    return domain;
+}
+
+__itt_string_handle* getHandle(const char* name) {
+    return __itt_string_handle_create(name);
+}
+
+ScopedTask::ScopedTask(__itt_string_handle* name, int64_t frameId) {
+    __itt_task_begin(getDomain(), __itt_null, __itt_null, name);
+    // null ID attaches the metadata to the current task of the thread
+    __itt_metadata_add(getDomain(), __itt_null, getFrameIdKey(), __itt_metadata_s64, 1, &frameId);
+}
+
+void beginOverlappedTask(__itt_string_handle* name, const void* owner, int64_t frameId) {
+    const __itt_id id = makeId(owner, frameId);
+    __itt_id_create(getDomain(), id);
+    __itt_task_begin_overlapped(getDomain(), id, __itt_null, name);
+    __itt_metadata_add(getDomain(), id, getFrameIdKey(), __itt_metadata_s64, 1, &frameId);
+}
+
+void endOverlappedTask(const void* owner, int64_t frameId) {
+    const __itt_id id = makeId(owner, frameId);
+    __itt_task_end_overlapped(getDomain(), id);
+    __itt_id_destroy(getDomain(), id);
+}
+}  // namespace itt
+#endif
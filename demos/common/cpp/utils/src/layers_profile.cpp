@@ -0,0 +1,93 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "utils/layers_profile.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+#include "utils/slog.hpp"
+
+LayersProfile::LayersProfile(const ov::CompiledModel& compiledModel) {
+    try {
+        for (const auto& op : compiledModel.get_runtime_model()->get_ops()) {
+            const auto& rtInfo = op->get_rt_info();
+            auto precision = rtInfo.find("runtimePrecision");
+            if (precision != rtInfo.end()) {
+                precisions.emplace(op->get_friendly_name(), precision->second.as<std::string>());
+            }
+        }
+    } catch (const ov::Exception&) {
+        // not every device provides the runtime model, layers are reported without precisions then
+    }
+}
+
+void LayersProfile::add(const ov::InferRequest& request) {
+    const std::vector<ov::ProfilingInfo> profilingInfo = request.get_profiling_info();
+    const std::lock_guard<std::mutex> lock(mtx);
+    for (const ov::ProfilingInfo& info : profilingInfo) {
+        if (info.status != ov::ProfilingInfo::Status::EXECUTED) {
+            continue;
+        }
+        Layer& layer = layers[info.node_name];
+        if (0 == layer.executionsNum) {
+            layer.name = info.node_name;
+            layer.nodeType = info.node_type;
+            layer.execType = info.exec_type;
+            auto precision = precisions.find(info.node_name);
+            if (precision != precisions.end()) {
+                layer.precision = precision->second;
+            }
+        }
+        layer.totalTime += info.real_time;
+        ++layer.executionsNum;
+        totalTime += info.real_time;
+    }
+    ++inferencesNum;
+}
+
+std::vector<LayersProfile::Layer> LayersProfile::getTop(size_t layersNum) const {
+    std::vector<Layer> top;
+    {
+        const std::lock_guard<std::mutex> lock(mtx);
+        top.reserve(layers.size());
+        for (const auto& layer : layers) {
+            top.push_back(layer.second);
+        }
+    }
+    layersNum = std::min(layersNum, top.size());
+    std::partial_sort(top.begin(), top.begin() + layersNum, top.end(), [](const Layer& a, const Layer& b) {
+        return a.totalTime > b.totalTime;
+    });
+    top.resize(layersNum);
+    return top;
+}
+
+size_t LayersProfile::getInferencesNum() const {
+    const std::lock_guard<std::mutex> lock(mtx);
+    return inferencesNum;
+}
+
+void LayersProfile::logTop(size_t layersNum) const {
+    const std::vector<Layer> top = getTop(layersNum);
+    std::chrono::microseconds allLayersTime;
+    size_t inferences;
+    {
+        const std::lock_guard<std::mutex> lock(mtx);
+        allLayersTime = totalTime;
+        inferences = inferencesNum;
+    }
+    if (0 == inferences || allLayersTime.count() == 0) {
+        return;
+    }
+    slog::info << "Slowest layers over " << inferences << " inferences:" << slog::endl;
+    for (const Layer& layer : top) {
+        const double meanTime = layer.totalTime.count() / 1000.0 / inferences;
+        const double share = 100.0 * layer.totalTime.count() / allLayersTime.count();
+        slog::info << "\t" << layer.name << " (" << layer.nodeType << ", " << layer.execType
+                   << (layer.precision.empty() ? "" : ", " + layer.precision) << "): " << std::fixed
+                   << std::setprecision(3) << meanTime << " ms, " << std::setprecision(1) << share << "%"
+                   << slog::endl;
+    }
+}
@@ -0,0 +1,173 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <utils/linear_assignment.hpp>
+
+namespace {
+// Every row is a full row of the matrix
+struct DenseRows {
+    const cv::Mat& dm;
+
+    int Size(int) const { return dm.cols; }
+    int Col(int, int k) const { return k; }
+    float Cost(int row, int k) const { return dm.at<float>(row, k); }
+};
+
+// Rows of the matrix are columns of the transposed problem
+struct DenseCols {
+    const cv::Mat& dm;
+
+    int Size(int) const { return dm.rows; }
+    int Col(int, int k) const { return k; }
+    float Cost(int col, int k) const { return dm.at<float>(k, col); }
+};
+
+// Compressed sparse rows
+struct SparseRows {
+    std::vector<int> offsets;
+    std::vector<int> cols;
+    std::vector<float> costs;
+
+    int Size(int row) const { return offsets[row + 1] - offsets[row]; }
+    int Col(int row, int k) const { return cols[offsets[row] + k]; }
+    float Cost(int row, int k) const { return costs[offsets[row] + k]; }
+};
+
+// Assigns rows one by one along the shortest augmenting paths keeping the dual
+// potentials feasible. Every row must have an augmenting path, so rows <= cols.
+// Columns are indexed from 1, column 0 is the root of the current path.
+template <class Rows>
+std::vector<int> AssignRows(int rows, int cols, const Rows& edges) {
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<double> u(rows + 1, 0.0), v(cols + 1, 0.0), min_dist(cols + 1, inf);
+    std::vector<int> col_to_row(cols + 1, 0), path(cols + 1, 0);
+    std::vector<char> visited(cols + 1, 0);
+    std::vector<int> reached;
+
+    for (int row = 1; row <= rows; row++) {
+        col_to_row[0] = row;
+        int col = 0;
+        reached.clear();
+        do {
+            visited[col] = 1;
+            const int cur_row = col_to_row[col];
+            for (int k = 0; k < edges.Size(cur_row - 1); k++) {
+                const int j = edges.Col(cur_row - 1, k) + 1;
+                if (visited[j])
+                    continue;
+                const double dist = edges.Cost(cur_row - 1, k) - u[cur_row] - v[j];
+                if (dist < min_dist[j]) {
+                    if (min_dist[j] == inf)
+                        reached.push_back(j);
+                    min_dist[j] = dist;
+                    path[j] = col;
+                }
+            }
+
+            double delta = inf;
+            int next_col = -1;
+            for (int j : reached) {
+                if (!visited[j] && min_dist[j] < delta) {
+                    delta = min_dist[j];
+                    next_col = j;
+                }
+            }
+            if (next_col < 0)
+                throw std::logic_error("The assignment problem has no solution");
+
+            u[row] += delta;
+            for (int j : reached) {
+                if (visited[j]) {
+                    u[col_to_row[j]] += delta;
+                    v[j] -= delta;
+                } else {
+                    min_dist[j] -= delta;
+                }
+            }
+            col = next_col;
+        } while (col_to_row[col] != 0);
+
+        do {
+            const int prev_col = path[col];
+            col_to_row[col] = col_to_row[prev_col];
+            col = prev_col;
+        } while (col != 0);
+
+        for (int j : reached) {
+            min_dist[j] = inf;
+            visited[j] = 0;
+        }
+        visited[0] = 0;
+    }
+
+    std::vector<int> row_to_col(rows, -1);
+    for (int j = 1; j <= cols; j++) {
+        if (col_to_row[j] != 0)
+            row_to_col[col_to_row[j] - 1] = j - 1;
+    }
+    return row_to_col;
+}
+}  // namespace
+
+std::vector<size_t> LinearAssignment::Solve(const cv::Mat& dissimilarity_matrix) {
+    CV_Assert(dissimilarity_matrix.type() == CV_32F);
+    const int rows = dissimilarity_matrix.rows;
+    const int cols = dissimilarity_matrix.cols;
+    std::vector<size_t> results(rows, -1);
+    if (rows == 0 || cols == 0)
+        return results;
+
+    if (rows <= cols) {
+        const auto row_to_col = AssignRows(rows, cols, DenseRows{dissimilarity_matrix});
+        for (int i = 0; i < rows; i++)
+            results[i] = static_cast<size_t>(row_to_col[i]);
+    } else {
+        const auto col_to_row = AssignRows(cols, rows, DenseCols{dissimilarity_matrix});
+        for (int j = 0; j < cols; j++)
+            results[col_to_row[j]] = static_cast<size_t>(j);
+    }
+    return results;
+}
+
+std::vector<size_t> LinearAssignment::Solve(int rows, int cols, const std::vector<Edge>& edges,
+                                            float unmatched_cost) {
+    CV_Assert(rows >= 0 && cols >= 0);
+    std::vector<size_t> results(rows, -1);
+    if (rows == 0 || cols == 0)
+        return results;
+
+    // Every row gets its own dummy column the row is left unmatched with,
+    // so there is always a solution
+    SparseRows sparse;
+    sparse.offsets.assign(rows + 1, 0);
+    for (const auto& edge : edges) {
+        CV_Assert(edge.row >= 0 && edge.row < rows && edge.col >= 0 && edge.col < cols);
+        sparse.offsets[edge.row + 1]++;
+    }
+    for (int i = 0; i < rows; i++)
+        sparse.offsets[i + 1] += sparse.offsets[i] + 1;
+    sparse.cols.resize(edges.size() + rows);
+    sparse.costs.resize(edges.size() + rows);
+    std::vector<int> next(sparse.offsets.begin(), sparse.offsets.end() - 1);
+    for (const auto& edge : edges) {
+        sparse.cols[next[edge.row]] = edge.col;
+        sparse.costs[next[edge.row]] = edge.cost;
+        next[edge.row]++;
+    }
+    for (int i = 0; i < rows; i++) {
+        sparse.cols[next[i]] = cols + i;
+        sparse.costs[next[i]] = unmatched_cost;
+    }
+
+    const auto row_to_col = AssignRows(rows, cols + rows, sparse);
+    for (int i = 0; i < rows; i++) {
+        if (row_to_col[i] < cols)
+            results[i] = static_cast<size_t>(row_to_col[i]);
+    }
+    return results;
+}
@@ -0,0 +1,79 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <iomanip>
+#include <map>
+#include <mutex>
+
+#include "utils/memory_accounting.hpp"
+#include "utils/slog.hpp"
+
+struct MemoryCounter::TagUsage {
+    std::atomic<size_t> bytes{0};
+    std::atomic<size_t> peakBytes{0};
+};
+
+namespace {
+std::mutex& getRegistryMutex() {
+    static std::mutex mtx;
+    return mtx;
+}
+
+// Nodes of std::map aren't moved by insertions, so counters keep pointers to their tags
+std::map<std::string, MemoryCounter::TagUsage>& getRegistry() {
+    static std::map<std::string, MemoryCounter::TagUsage> registry;
+    return registry;
+}
+
+void addToTag(MemoryCounter::TagUsage& tagUsage, size_t addedBytes) {
+    const size_t tagBytes = tagUsage.bytes += addedBytes;
+    size_t peakBytes = tagUsage.peakBytes;
+    while (tagBytes > peakBytes && !tagUsage.peakBytes.compare_exchange_weak(peakBytes, tagBytes)) {}
+}
+}  // namespace
+
+MemoryCounter::MemoryCounter(const std::string& tag) : bytes{0} {
+    const std::lock_guard<std::mutex> lock(getRegistryMutex());
+    tagUsage = &getRegistry()[tag];
+}
+
+MemoryCounter::~MemoryCounter() {
+    tagUsage->bytes -= bytes;
+}
+
+void MemoryCounter::add(size_t addedBytes) {
+    bytes += addedBytes;
+    addToTag(*tagUsage, addedBytes);
+}
+
+void MemoryCounter::subtract(size_t subtractedBytes) {
+    bytes -= subtractedBytes;
+    tagUsage->bytes -= subtractedBytes;
+}
+
+void MemoryCounter::set(size_t newBytes) {
+    const size_t oldBytes = bytes.exchange(newBytes);
+    if (newBytes >= oldBytes) {
+        addToTag(*tagUsage, newBytes - oldBytes);
+    } else {
+        tagUsage->bytes -= oldBytes - newBytes;
+    }
+}
+
+std::vector<MemoryUsage> getMemoryUsage() {
+    const std::lock_guard<std::mutex> lock(getRegistryMutex());
+    std::vector<MemoryUsage> usage;
+    for (const auto& tag : getRegistry()) {
+        usage.push_back({tag.first, tag.second.bytes, tag.second.peakBytes});
+    }
+    return usage;
+}
+
+void logMemoryUsage() {
+    const double mib = 1024 * 1024;
+    for (const MemoryUsage& usage : getMemoryUsage()) {
+        slog::info << "\tMemory of " << usage.tag << ": " << std::fixed << std::setprecision(1)
+                   << usage.bytes / mib << " MiB, peak " << usage.peakBytes / mib << " MiB" << slog::endl;
+    }
+}
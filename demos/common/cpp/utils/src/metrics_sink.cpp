@@ -0,0 +1,101 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#include "utils/memory_accounting.hpp"
+#include "utils/metrics_sink.hpp"
+
+namespace {
+void writeNumber(std::ostream& out, double value) {
+    if (std::isfinite(value)) {
+        out << value;
+    } else {
+        out << "null";  // JSON has no NaN
+    }
+}
+
+void writeString(std::ostream& out, const std::string& str) {
+    out << '"';
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            out << '\\';
+        }
+        out << c;
+    }
+    out << '"';
+}
+}  // namespace
+
+MetricsSink::MetricsSink(const std::string& path, PerformanceMetrics::Duration period)
+    : file(path, std::ios::out | std::ios::app),
+      period(period),
+      lastPublishTime(PerformanceMetrics::Clock::now()) {
+    if (!file.is_open()) {
+        throw std::runtime_error("Can't open metrics file " + path);
+    }
+}
+
+bool MetricsSink::isDue() const {
+    return PerformanceMetrics::Clock::now() - lastPublishTime >= period;
+}
+
+MetricsSink& MetricsSink::stage(const std::string& name, const PerformanceMetrics::Metrics& metrics) {
+    stages.emplace_back(name, metrics);
+    return *this;
+}
+
+MetricsSink& MetricsSink::value(const std::string& name, double value) {
+    values.emplace_back(name, value);
+    return *this;
+}
+
+void MetricsSink::publish() {
+    lastPublishTime = PerformanceMetrics::Clock::now();
+    const double timestamp =
+        std::chrono::duration_cast<PerformanceMetrics::Ms>(std::chrono::system_clock::now().time_since_epoch())
+            .count() / 1000;
+
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(3) << "{\"timestamp\": " << timestamp << ", \"stages\": {";
+    for (size_t i = 0; i < stages.size(); ++i) {
+        const PerformanceMetrics::Metrics& metrics = stages[i].second;
+        line << (i ? ", " : "");
+        writeString(line, stages[i].first);
+        line << ": {\"fps\": ";
+        writeNumber(line, metrics.fps);
+        line << ", \"latency\": ";
+        writeNumber(line, metrics.latency);
+        line << ", \"p50\": ";
+        writeNumber(line, metrics.latencyP50);
+        line << ", \"p95\": ";
+        writeNumber(line, metrics.latencyP95);
+        line << ", \"p99\": ";
+        writeNumber(line, metrics.latencyP99);
+        line << ", \"dropped\": " << metrics.droppedFrames << ", \"skipped\": " << metrics.skippedFrames << '}';
+    }
+    line << "}, \"values\": {";
+    for (size_t i = 0; i < values.size(); ++i) {
+        line << (i ? ", " : "");
+        writeString(line, values[i].first);
+        line << ": ";
+        writeNumber(line, values[i].second);
+    }
+    line << "}, \"memory\": {";
+    const std::vector<MemoryUsage> memoryUsage = getMemoryUsage();
+    for (size_t i = 0; i < memoryUsage.size(); ++i) {
+        line << (i ? ", " : "");
+        writeString(line, memoryUsage[i].tag);
+        line << ": {\"bytes\": " << memoryUsage[i].bytes << ", \"peak\": " << memoryUsage[i].peakBytes << '}';
+    }
+    line << "}}\n";
+
+    file << line.str();
+    file.flush();
+    stages.clear();
+    values.clear();
+}
@@ -0,0 +1,220 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "utils/multi_camera_association.hpp"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "utils/linear_assignment.hpp"
+
+MultiCameraAssociator::MultiCameraAssociator(const Params& params) : params(params) {}
+
+MultiCameraAssociator::~MultiCameraAssociator() {
+    if (associationThread.joinable()) {
+        {
+            const std::lock_guard<std::mutex> lock(threadMtx);
+            stopAssociation = true;
+        }
+        condVar.notify_all();
+        associationThread.join();
+    }
+}
+
+void MultiCameraAssociator::post(size_t camera, size_t track, const cv::Mat& embedding) {
+    if (embedding.empty()) {
+        throw std::invalid_argument("Embedding of a track must not be empty");
+    }
+    Post newPost{{camera, track}, {}};
+    embedding.reshape(1, 1).convertTo(newPost.embedding, CV_32F);
+    const std::lock_guard<std::mutex> lock(postsMtx);
+    posts.push_back(std::move(newPost));
+}
+
+void MultiCameraAssociator::finish(size_t camera, size_t track) {
+    const std::lock_guard<std::mutex> lock(postsMtx);
+    posts.push_back({{camera, track}, {}});
+}
+
+int MultiCameraAssociator::getIdentity(size_t camera, size_t track) const {
+    const std::lock_guard<std::mutex> lock(stateMtx);
+    auto it = tracks.find({camera, track});
+    return it == tracks.end() ? -1 : it->second.identity;
+}
+
+MultiCameraAssociator::Stats MultiCameraAssociator::getStats() const {
+    const std::lock_guard<std::mutex> lock(stateMtx);
+    return stats;
+}
+
+void MultiCameraAssociator::associate() {
+    std::vector<Post> batch;
+    {
+        const std::lock_guard<std::mutex> lock(postsMtx);
+        batch.swap(posts);
+    }
+    const std::lock_guard<std::mutex> lock(stateMtx);
+    ++stepsNum;
+
+    // Only the last post of a track counts. The map is ordered by camera, so new tracks of a camera are contiguous.
+    std::map<std::pair<size_t, size_t>, size_t> lastPosts;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        lastPosts[batch[i].key] = i;
+    }
+    std::vector<size_t> newPosts;
+    for (const auto& lastPost : lastPosts) {
+        Post& post = batch[lastPost.second];
+        auto trackIt = tracks.find(post.key);
+        if (post.embedding.empty()) {
+            if (trackIt != tracks.end()) {
+                --liveTracksNum[trackIt->second.row];
+                tracks.erase(trackIt);
+            }
+            continue;
+        }
+        if (!embeddings.empty() && embeddings.cols != post.embedding.cols) {
+            throw std::invalid_argument("Embeddings of tracks have different lengths: " +
+                                        std::to_string(embeddings.cols) + " and " +
+                                        std::to_string(post.embedding.cols));
+        }
+        const double norm = cv::norm(post.embedding);
+        if (norm == 0) {
+            continue;
+        }
+        post.embedding /= norm;
+        if (trackIt != tracks.end()) {
+            update(trackIt->second.row, post.embedding);
+        } else {
+            newPosts.push_back(lastPost.second);
+        }
+    }
+    if (newPosts.empty()) {
+        return;
+    }
+
+    // All new tracks are compared with all identities by one matrix product
+    const int rows = static_cast<int>(identities.size());
+    cv::Mat similarities;
+    if (rows > 0) {
+        cv::Mat queries(static_cast<int>(newPosts.size()), embeddings.cols, CV_32F);
+        for (size_t i = 0; i < newPosts.size(); ++i) {
+            batch[newPosts[i]].embedding.copyTo(queries.row(static_cast<int>(i)));
+        }
+        similarities = queries * embeddings.rowRange(0, rows).t();
+    }
+
+    // Every camera is matched separately, identities of its live tracks are excluded. Identities are added only after
+    // all cameras are matched, so a forgotten row can't be matched.
+    std::vector<size_t> matchedRows(newPosts.size(), static_cast<size_t>(-1));
+    std::vector<bool> isHeld;
+    std::vector<LinearAssignment::Edge> edges;
+    LinearAssignment solver;
+    for (size_t begin = 0, end = 0; rows > 0 && begin < newPosts.size(); begin = end) {
+        const size_t camera = batch[newPosts[begin]].key.first;
+        for (end = begin; end < newPosts.size() && batch[newPosts[end]].key.first == camera; ++end) {}
+
+        isHeld.assign(rows, false);
+        for (auto it = tracks.lower_bound({camera, 0}); it != tracks.end() && it->first.first == camera; ++it) {
+            isHeld[it->second.row] = true;
+        }
+        edges.clear();
+        for (size_t i = begin; i < end; ++i) {
+            const float* similarity = similarities.ptr<float>(static_cast<int>(i));
+            for (int row = 0; row < rows; ++row) {
+                if (!isHeld[row] && similarity[row] >= params.minSimilarity) {
+                    edges.push_back({static_cast<int>(i - begin), row, 1.0f - similarity[row]});
+                }
+            }
+        }
+        if (edges.empty()) {
+            continue;
+        }
+        const std::vector<size_t> res =
+            solver.Solve(static_cast<int>(end - begin), rows, edges, 1.0f - params.minSimilarity);
+        std::copy(res.begin(), res.end(), matchedRows.begin() + begin);
+    }
+
+    for (size_t i = 0; i < newPosts.size(); ++i) {
+        if (matchedRows[i] < static_cast<size_t>(rows)) {
+            const int row = static_cast<int>(matchedRows[i]);
+            update(row, batch[newPosts[i]].embedding);
+            tracks[batch[newPosts[i]].key] = {row, identities[row]};
+            ++liveTracksNum[row];
+            ++stats.matched;
+        }
+    }
+    for (size_t i = 0; i < newPosts.size(); ++i) {
+        if (matchedRows[i] >= static_cast<size_t>(rows)) {
+            const int row = addIdentity(batch[newPosts[i]].embedding);
+            tracks[batch[newPosts[i]].key] = {row, identities[row]};
+            ++liveTracksNum[row];
+            ++stats.created;
+        }
+    }
+}
+
+void MultiCameraAssociator::startPeriodicAssociation(std::chrono::milliseconds period) {
+    if (associationThread.joinable()) {
+        throw std::logic_error("Periodic association is already started");
+    }
+    associationThread = std::thread(&MultiCameraAssociator::periodicAssociationFunc, this, period);
+}
+
+void MultiCameraAssociator::update(int row, const cv::Mat& embedding) {
+    cv::Mat mean = embeddings.row(row);
+    cv::addWeighted(mean, params.momentum, embedding, 1.0f - params.momentum, 0, mean);
+    const double norm = cv::norm(mean);
+    if (norm > 0) {
+        mean /= norm;
+    } else {
+        embedding.copyTo(mean);
+    }
+    lastSeen[row] = stepsNum;
+}
+
+int MultiCameraAssociator::addIdentity(const cv::Mat& embedding) {
+    if (params.maxIdentities > 0 && identities.size() >= params.maxIdentities) {
+        int oldest = -1;
+        for (size_t row = 0; row < identities.size(); ++row) {
+            if (liveTracksNum[row] == 0 && (oldest < 0 || lastSeen[row] < lastSeen[oldest])) {
+                oldest = static_cast<int>(row);
+            }
+        }
+        // If every identity has live tracks, the store grows over the limit
+        if (oldest >= 0) {
+            ++stats.forgotten;
+            identities[oldest] = nextIdentity++;
+            embedding.copyTo(embeddings.row(oldest));
+            lastSeen[oldest] = stepsNum;
+            return oldest;
+        }
+    }
+    const int row = static_cast<int>(identities.size());
+    if (row == embeddings.rows) {
+        cv::Mat grownEmbeddings(std::max(2 * embeddings.rows, 64), embedding.cols, CV_32F);
+        if (!embeddings.empty()) {
+            embeddings.copyTo(grownEmbeddings.rowRange(0, embeddings.rows));
+        }
+        embeddings = grownEmbeddings;
+    }
+    embedding.copyTo(embeddings.row(row));
+    identities.push_back(nextIdentity++);
+    liveTracksNum.push_back(0);
+    lastSeen.push_back(stepsNum);
+    return row;
+}
+
+void MultiCameraAssociator::periodicAssociationFunc(std::chrono::milliseconds period) {
+    std::unique_lock<std::mutex> lock(threadMtx);
+    while (!condVar.wait_for(lock, period, [&]() {
+        return stopAssociation;
+    })) {
+        lock.unlock();
+        associate();
+        lock.lock();
+    }
+}
@@ -0,0 +1,179 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "utils/nms.hpp"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace {
+// Remaining candidates in the order of processing. Coordinates are shifted by class offsets for per-class NMS.
+struct Candidates {
+    explicit Candidates(size_t size)
+        : left(size),
+          top(size),
+          right(size),
+          bottom(size),
+          areas(size),
+          scores(size),
+          indices(size) {}
+
+    void move(size_t from, size_t to) {
+        left[to] = left[from];
+        top[to] = top[from];
+        right[to] = right[from];
+        bottom[to] = bottom[from];
+        areas[to] = areas[from];
+        scores[to] = scores[from];
+        indices[to] = indices[from];
+    }
+
+    void swap(size_t i, size_t j) {
+        std::swap(left[i], left[j]);
+        std::swap(top[i], top[j]);
+        std::swap(right[i], right[j]);
+        std::swap(bottom[i], bottom[j]);
+        std::swap(areas[i], areas[j]);
+        std::swap(scores[i], scores[j]);
+        std::swap(indices[i], indices[j]);
+    }
+
+    std::vector<float> left;
+    std::vector<float> top;
+    std::vector<float> right;
+    std::vector<float> bottom;
+    std::vector<float> areas;
+    std::vector<float> scores;
+    std::vector<int> indices;
+};
+
+// Computes overlaps of the box with candidates in range [begin, end)
+void computeOverlaps(const Candidates& c, size_t box, size_t begin, size_t end, NmsMethod method, float* overlaps) {
+    const float left = c.left[box];
+    const float top = c.top[box];
+    const float right = c.right[box];
+    const float bottom = c.bottom[box];
+    const float area = c.areas[box];
+    for (size_t j = begin; j < end; ++j) {
+        const float width = std::max(std::min(right, c.right[j]) - std::max(left, c.left[j]), 0.0f);
+        const float height = std::max(std::min(bottom, c.bottom[j]) - std::max(top, c.top[j]), 0.0f);
+        const float intersection = width * height;
+        overlaps[j] = intersection / (area + c.areas[j] - intersection);
+    }
+    if (method == NmsMethod::DIoU) {
+        const float centerX = left + right;
+        const float centerY = top + bottom;
+        for (size_t j = begin; j < end; ++j) {
+            // Doubled centers and sizes, the factor is cancelled in the ratio
+            const float dx = centerX - (c.left[j] + c.right[j]);
+            const float dy = centerY - (c.top[j] + c.bottom[j]);
+            const float enclosingWidth = 2 * (std::max(right, c.right[j]) - std::min(left, c.left[j]));
+            const float enclosingHeight = 2 * (std::max(bottom, c.bottom[j]) - std::min(top, c.top[j]));
+            const float diagonal = enclosingWidth * enclosingWidth + enclosingHeight * enclosingHeight;
+            overlaps[j] -= diagonal > 0 ? (dx * dx + dy * dy) / diagonal : 0.0f;
+        }
+    }
+}
+}  // namespace
+
+std::vector<int> nms(const NmsBoxes& boxes, const NmsParams& params, std::vector<float>* keptScores) {
+    std::vector<int> order;
+    order.reserve(boxes.size());
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        if (boxes.scores[i] >= params.scoreThreshold) {
+            order.push_back(static_cast<int>(i));
+        }
+    }
+    auto isBetter = [&boxes](int i1, int i2) {
+        return boxes.scores[i1] > boxes.scores[i2];
+    };
+    if (params.topK != 0 && params.topK < order.size()) {
+        std::partial_sort(order.begin(), order.begin() + params.topK, order.end(), isBetter);
+        order.resize(params.topK);
+    } else {
+        std::sort(order.begin(), order.end(), isBetter);
+    }
+
+    // Boxes of different classes are moved apart, so they never overlap
+    float classOffset = 0;
+    if (params.perClass && !order.empty()) {
+        float minCoord = boxes.left[order[0]];
+        float maxCoord = minCoord;
+        for (int i : order) {
+            minCoord = std::min(minCoord, std::min(boxes.left[i], boxes.top[i]));
+            maxCoord = std::max(maxCoord, std::max(boxes.right[i], boxes.bottom[i]));
+        }
+        classOffset = maxCoord - minCoord + 1;
+    }
+
+    const float boundary = params.includeBoundaries ? 1.0f : 0.0f;
+    Candidates c(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        const int idx = order[i];
+        const float offset = params.perClass ? boxes.classIds[idx] * classOffset : 0.0f;
+        c.left[i] = boxes.left[idx] + offset;
+        c.top[i] = boxes.top[idx] + offset;
+        c.right[i] = boxes.right[idx] + offset;
+        c.bottom[i] = boxes.bottom[idx] + offset;
+        c.areas[i] = (boxes.right[idx] - boxes.left[idx] + boundary) * (boxes.bottom[idx] - boxes.top[idx] + boundary);
+        c.scores[i] = boxes.scores[idx];
+        c.indices[i] = idx;
+    }
+
+    std::vector<int> keep;
+    if (keptScores) {
+        keptScores->clear();
+    }
+    std::vector<float> overlaps(order.size());
+    size_t end = order.size();
+    for (size_t begin = 0; begin < end; ++begin) {
+        if (params.method == NmsMethod::Soft) {
+            // Decayed scores aren't sorted anymore
+            size_t best = begin;
+            for (size_t j = begin + 1; j < end; ++j) {
+                if (c.scores[j] > c.scores[best]) {
+                    best = j;
+                }
+            }
+            c.swap(begin, best);
+        }
+        keep.push_back(c.indices[begin]);
+        if (keptScores) {
+            keptScores->push_back(c.scores[begin]);
+        }
+
+        computeOverlaps(c, begin, begin + 1, end, params.method, overlaps.data());
+        size_t remaining = begin + 1;
+        for (size_t j = begin + 1; j < end; ++j) {
+            bool isKept;
+            if (params.method == NmsMethod::Soft) {
+                c.scores[j] *= std::exp(-overlaps[j] * overlaps[j] / params.softNmsSigma);
+                isKept = c.scores[j] >= params.scoreThreshold;
+            } else {
+                isKept = overlaps[j] < params.iouThreshold;
+            }
+            if (isKept) {
+                c.move(j, remaining++);
+            }
+        }
+        end = remaining;
+    }
+    return keep;
+}
@@ -2,10 +2,69 @@
 // SPDX-License-Identifier: Apache-2.0
 //
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
 #include "utils/performance_metrics.hpp"
 #include "utils/slog.hpp"
 
+namespace {
+const int subBucketBits = 4;  // every power of 2 range is split into 2^subBucketBits buckets
+const uint64_t maxLatencyUs = (uint64_t(1) << 36) - 1;
+
+size_t getBucketIndex(uint64_t value) {
+    if (value < (2u << subBucketBits)) {
+        return static_cast<size_t>(value);
+    }
+    int msb = 0;
+    while ((value >> (msb + 1)) != 0) {
+        ++msb;
+    }
+    const int magnitude = msb - subBucketBits;
+    return (size_t(magnitude) << subBucketBits) + static_cast<size_t>(value >> magnitude);
+}
+
+// Returns middle of the bucket in microseconds
+double getBucketValue(size_t index) {
+    if (index < (2u << subBucketBits)) {
+        return static_cast<double>(index);
+    }
+    const int magnitude = static_cast<int>(index >> subBucketBits) - 1;
+    const uint64_t lowerBound = uint64_t(index - (size_t(magnitude) << subBucketBits)) << magnitude;
+    return lowerBound + (uint64_t(1) << magnitude) / 2.0;
+}
+}  // namespace
+
+void LatencyHistogram::record(std::chrono::steady_clock::duration latency) {
+    auto latencyUs = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+    uint64_t value = latencyUs > 0 ? static_cast<uint64_t>(latencyUs) : 0;
+    ++counts[getBucketIndex(std::min(value, maxLatencyUs))];
+    ++totalCount;
+}
+
+void LatencyHistogram::combine(const LatencyHistogram& other) {
+    for (size_t i = 0; i < bucketsCount; ++i) {
+        counts[i] += other.counts[i];
+    }
+    totalCount += other.totalCount;
+}
+
+double LatencyHistogram::getPercentile(double percentile) const {
+    if (totalCount == 0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    percentile = std::min(std::max(percentile, 0.0), 100.0);
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100 * totalCount)));
+    uint64_t count = 0;
+    for (size_t i = 0; i < bucketsCount; ++i) {
+        count += counts[i];
+        if (count >= rank) {
+            return getBucketValue(i) / 1000;
+        }
+    }
+    return getBucketValue(bucketsCount - 1) / 1000;
+}
+
 // timeWindow defines the length of the timespan over which the 'current fps' value is calculated
 PerformanceMetrics::PerformanceMetrics(Duration timeWindow)
     : timeWindowSize(timeWindow)
@@ -33,6 +92,7 @@ void PerformanceMetrics::update(TimePoint lastRequestStartTime) {
     }
 
     currentMovingStatistic.latency += currentTime - lastRequestStartTime;
+    currentMovingStatistic.latencyHistogram.record(currentTime - lastRequestStartTime);
     currentMovingStatistic.period = currentTime - lastUpdateTime;
     currentMovingStatistic.frameCount++;
 
@@ -45,11 +105,22 @@ void PerformanceMetrics::update(TimePoint lastRequestStartTime) {
     }
 }
 
+void PerformanceMetrics::registerDroppedFrame() {
+    currentMovingStatistic.droppedFrameCount++;
+}
+
+void PerformanceMetrics::registerSkippedFrame() {
+    currentMovingStatistic.skippedFrameCount++;
+}
+
 void PerformanceMetrics::paintMetrics(const cv::Mat& frame, cv::Point position, int fontFace,
     double fontScale, cv::Scalar color, int thickness, MetricTypes metricType) const {
-    // Draw performance stats over frame
-    Metrics metrics = getLast();
+    paintMetrics(getLast(), frame, position, fontFace, fontScale, color, thickness, metricType);
+}
 
+void PerformanceMetrics::paintMetrics(const Metrics& metrics, const cv::Mat& frame, cv::Point position, int fontFace,
+    double fontScale, cv::Scalar color, int thickness, MetricTypes metricType) {
+    // Draw performance stats over frame
     std::ostringstream out;
     if (!std::isnan(metrics.latency) &&
         (metricType == PerformanceMetrics::MetricTypes::LATENCY || metricType == PerformanceMetrics::MetricTypes::ALL)) {
@@ -76,6 +147,11 @@ PerformanceMetrics::Metrics PerformanceMetrics::getLast() const {
                   ? lastMovingStatistic.frameCount
                     / std::chrono::duration_cast<Sec>(lastMovingStatistic.period).count()
                   : std::numeric_limits<double>::signaling_NaN();
+    metrics.droppedFrames = lastMovingStatistic.droppedFrameCount;
+    metrics.skippedFrames = lastMovingStatistic.skippedFrameCount;
+    metrics.latencyP50 = lastMovingStatistic.latencyHistogram.getPercentile(50);
+    metrics.latencyP95 = lastMovingStatistic.latencyHistogram.getPercentile(95);
+    metrics.latencyP99 = lastMovingStatistic.latencyHistogram.getPercentile(99);
 
     return metrics;
 }
@@ -93,15 +169,43 @@ PerformanceMetrics::Metrics PerformanceMetrics::getTotal() const {
         metrics.latency = std::numeric_limits<double>::signaling_NaN();
         metrics.fps = std::numeric_limits<double>::signaling_NaN();
     }
+    metrics.droppedFrames = totalStatistic.droppedFrameCount + currentMovingStatistic.droppedFrameCount;
+    metrics.skippedFrames = totalStatistic.skippedFrameCount + currentMovingStatistic.skippedFrameCount;
+    LatencyHistogram histogram = getTotalHistogram();
+    metrics.latencyP50 = histogram.getPercentile(50);
+    metrics.latencyP95 = histogram.getPercentile(95);
+    metrics.latencyP99 = histogram.getPercentile(99);
 
     return metrics;
 }
 
+LatencyHistogram PerformanceMetrics::getTotalHistogram() const {
+    LatencyHistogram histogram = totalStatistic.latencyHistogram;
+    histogram.combine(currentMovingStatistic.latencyHistogram);
+    return histogram;
+}
+
+double PerformanceMetrics::getLastPercentile(double percentile) const {
+    return lastMovingStatistic.latencyHistogram.getPercentile(percentile);
+}
+
+double PerformanceMetrics::getTotalPercentile(double percentile) const {
+    return getTotalHistogram().getPercentile(percentile);
+}
+
 void PerformanceMetrics::logTotal() const {
     Metrics metrics = getTotal();
 
     slog::info << "\tLatency: " << std::fixed << std::setprecision(1) << metrics.latency << " ms" << slog::endl;
+    slog::info << "\tLatency p50/p95/p99: " << metrics.latencyP50 << " / " << metrics.latencyP95 << " / "
+               << metrics.latencyP99 << " ms" << slog::endl;
     slog::info << "\tFPS: " << metrics.fps << slog::endl;
+    if (metrics.droppedFrames != 0) {
+        slog::info << "\tDropped frames: " << metrics.droppedFrames << slog::endl;
+    }
+    if (metrics.skippedFrames != 0) {
+        slog::info << "\tSkipped frames: " << metrics.skippedFrames << slog::endl;
+    }
 }
 
 void logLatencyPerStage(double readLat, double preprocLat, double inferLat, double postprocLat, double renderLat) {
@@ -112,3 +216,21 @@ void logLatencyPerStage(double readLat, double preprocLat, double inferLat, doub
     slog::info << "\tPostprocessing:\t" << postprocLat << " ms" << slog::endl;
     slog::info << "\tRendering:\t" << renderLat << " ms" << slog::endl;
 }
+
+static void logStageLatency(const char* stageName, const PerformanceMetrics::Metrics& metrics) {
+    slog::info << "\t" << stageName << std::fixed << std::setprecision(1) << metrics.latency << " ms (p50 "
+               << metrics.latencyP50 << ", p95 " << metrics.latencyP95 << ", p99 " << metrics.latencyP99 << " ms)"
+               << slog::endl;
+}
+
+void logLatencyPerStage(const PerformanceMetrics::Metrics& read,
+                        const PerformanceMetrics::Metrics& preproc,
+                        const PerformanceMetrics::Metrics& infer,
+                        const PerformanceMetrics::Metrics& postproc,
+                        const PerformanceMetrics::Metrics& render) {
+    logStageLatency("Decoding:\t", read);
+    logStageLatency("Preprocessing:\t", preproc);
+    logStageLatency("Inference:\t", infer);
+    logStageLatency("Postprocessing:\t", postproc);
+    logStageLatency("Rendering:\t", render);
+}
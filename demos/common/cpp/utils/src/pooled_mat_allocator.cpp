@@ -0,0 +1,213 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "utils/pooled_mat_allocator.hpp"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef __linux__
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <iomanip>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "utils/slog.hpp"
+
+namespace {
+const size_t pageSize = size_t(4) << 10;
+const size_t hugePageSize = size_t(2) << 20;
+
+size_t roundUp(size_t bytes, size_t alignment) {
+    return (bytes + alignment - 1) / alignment * alignment;
+}
+
+size_t getNumaNodesNum() {
+    size_t nodesNum = 0;
+#ifdef __linux__
+    struct stat info;
+    while (stat(("/sys/devices/system/node/node" + std::to_string(nodesNum)).c_str(), &info) == 0) {
+        ++nodesNum;
+    }
+#endif
+    return std::max<size_t>(nodesNum, 1);
+}
+
+size_t getCurrentNumaNode() {
+#ifdef __linux__
+    unsigned int cpu = 0;
+    unsigned int node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+        return node;
+    }
+#endif
+    return 0;
+}
+}  // namespace
+
+PooledMatAllocator& PooledMatAllocator::install(const Config& config) {
+    PooledMatAllocator* allocator = new PooledMatAllocator(config);
+    cv::Mat::setDefaultAllocator(allocator);
+    return *allocator;
+}
+
+PooledMatAllocator::PooledMatAllocator(const Config& config) : config(config), arenas(getNumaNodesNum()) {}
+
+cv::UMatData* PooledMatAllocator::allocate(int dims,
+                                           const int* sizes,
+                                           int type,
+                                           void* data0,
+                                           size_t* step,
+                                           cv::AccessFlag,
+                                           cv::UMatUsageFlags) const {
+    // Steps are computed the same way cv::Mat's standard allocator does
+    size_t total = CV_ELEM_SIZE(type);
+    for (int i = dims - 1; i >= 0; i--) {
+        if (step) {
+            if (data0 && step[i] != CV_AUTOSTEP) {
+                CV_Assert(total <= step[i]);
+                total = step[i];
+            } else {
+                step[i] = total;
+            }
+        }
+        total *= sizes[i];
+    }
+    cv::UMatData* u = new cv::UMatData(this);
+    u->data = u->origdata = data0 ? static_cast<uchar*>(data0) : static_cast<uchar*>(acquire(total));
+    u->size = total;
+    if (data0) {
+        u->flags |= cv::UMatData::USER_ALLOCATED;
+    }
+    return u;
+}
+
+bool PooledMatAllocator::allocate(cv::UMatData* u, cv::AccessFlag, cv::UMatUsageFlags) const {
+    return u != nullptr;
+}
+
+void PooledMatAllocator::deallocate(cv::UMatData* u) const {
+    if (!u) {
+        return;
+    }
+    CV_Assert(u->urefcount == 0);
+    CV_Assert(u->refcount == 0);
+    if (!(u->flags & cv::UMatData::USER_ALLOCATED)) {
+        release(u->origdata, u->size);
+        u->origdata = nullptr;
+    }
+    delete u;
+}
+
+size_t PooledMatAllocator::getSizeClass(size_t bytes) const {
+    return config.hugePages && bytes >= hugePageSize ? roundUp(bytes, hugePageSize) : roundUp(bytes, pageSize);
+}
+
+PooledMatAllocator::Arena& PooledMatAllocator::getLocalArena() const {
+    return arenas[std::min(getCurrentNumaNode(), arenas.size() - 1)];
+}
+
+void* PooledMatAllocator::acquire(size_t bytes) const {
+    if (bytes < config.minPooledBytes) {
+        return cv::fastMalloc(bytes);
+    }
+    const size_t sizeClass = getSizeClass(bytes);
+    Arena& arena = getLocalArena();
+    void* buffer = nullptr;
+    {
+        const std::lock_guard<std::mutex> lock(arena.mtx);
+        auto it = arena.freeBuffers.find(sizeClass);
+        if (it != arena.freeBuffers.end() && !it->second.empty()) {
+            buffer = it->second.back();
+            it->second.pop_back();
+        }
+    }
+    if (buffer) {
+        ++hits;
+        cachedBytes -= sizeClass;
+        cachedMemory.subtract(sizeClass);
+    } else {
+        ++misses;
+        buffer = allocateBuffer(sizeClass);
+    }
+    usedBytes += sizeClass;
+    usedMemory.add(sizeClass);
+    updatePeak();
+    return buffer;
+}
+
+void PooledMatAllocator::release(void* data, size_t bytes) const {
+    if (bytes < config.minPooledBytes) {
+        cv::fastFree(data);
+        return;
+    }
+    const size_t sizeClass = getSizeClass(bytes);
+    usedBytes -= sizeClass;
+    usedMemory.subtract(sizeClass);
+    // The capacity is checked loosely, concurrent releases may exceed it by their buffers
+    if (cachedBytes + sizeClass > config.capacity) {
+        freeBuffer(data, sizeClass);
+        return;
+    }
+    cachedBytes += sizeClass;
+    cachedMemory.add(sizeClass);
+    // The buffer goes to the arena of the releasing thread: the threads processing a frame usually run on the node
+    // of the thread which allocated it
+    Arena& arena = getLocalArena();
+    const std::lock_guard<std::mutex> lock(arena.mtx);
+    arena.freeBuffers[sizeClass].push_back(data);
+}
+
+void* PooledMatAllocator::allocateBuffer(size_t sizeClass) const {
+#ifdef __linux__
+    if (config.hugePages && sizeClass >= hugePageSize) {
+        void* buffer = nullptr;
+        if (posix_memalign(&buffer, hugePageSize, sizeClass) != 0) {
+            throw std::bad_alloc();
+        }
+        // Not every kernel enables transparent huge pages on request, the buffer is still usable then
+        madvise(buffer, sizeClass, MADV_HUGEPAGE);
+        return buffer;
+    }
+#endif
+    return cv::fastMalloc(sizeClass);
+}
+
+void PooledMatAllocator::freeBuffer(void* buffer, size_t sizeClass) const {
+#ifdef __linux__
+    if (config.hugePages && sizeClass >= hugePageSize) {
+        free(buffer);
+        return;
+    }
+#endif
+    cv::fastFree(buffer);
+}
+
+void PooledMatAllocator::updatePeak() const {
+    const size_t bytes = cachedBytes + usedBytes;
+    size_t peak = peakBytes;
+    while (bytes > peak && !peakBytes.compare_exchange_weak(peak, bytes)) {
+    }
+}
+
+PooledMatAllocator::Stats PooledMatAllocator::getStats() const {
+    return {hits, misses, cachedBytes, usedBytes, peakBytes};
+}
+
+void PooledMatAllocator::logStats() const {
+    const Stats stats = getStats();
+    const uint64_t allocations = stats.hits + stats.misses;
+    slog::info << "Pooled Mat allocator: " << allocations << " pooled allocations, hit rate " << std::fixed
+               << std::setprecision(1) << (allocations > 0 ? 100.0 * stats.hits / allocations : 0.0) << "%, peak "
+               << (stats.peakBytes >> 20) << " MB, cached " << (stats.cachedBytes >> 20) << " MB" << slog::endl;
+}
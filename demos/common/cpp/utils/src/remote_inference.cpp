@@ -0,0 +1,536 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "utils/remote_inference.hpp"
+
+#include <errno.h>
+#include <string.h>
+
+#ifndef _WIN32
+#    include <netdb.h>
+#    include <netinet/in.h>
+#    include <netinet/tcp.h>
+#    include <sys/socket.h>
+#    include <unistd.h>
+#endif
+
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include <openvino/op/parameter.hpp>
+#include <openvino/op/result.hpp>
+#include <openvino/pass/manager.hpp>
+#include <openvino/pass/serialize.hpp>
+
+#include "utils/config_factory.h"
+#include "utils/slog.hpp"
+
+#ifndef _WIN32
+namespace {
+// Every message starts with its type and the ID of the request it belongs to, 0 for messages of the connection.
+// Load carries the signature, the model and its compilation config, Infer and Result carry tensors.
+const char protocolSignature[] = "OMZRINF1";
+
+enum class MessageType : uint32_t { Load = 1, Loaded = 2, Infer = 3, Result = 4, Error = 5 };
+
+#    ifndef MSG_NOSIGNAL
+#        define MSG_NOSIGNAL 0
+#    endif
+
+void sendAll(int fd, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        const ssize_t sent = send(fd, bytes, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            throw std::runtime_error("The connection of remote inference is lost");
+        }
+        bytes += sent;
+        size -= static_cast<size_t>(sent);
+    }
+}
+
+void receiveAll(int fd, void* data, size_t size) {
+    char* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        const ssize_t received = recv(fd, bytes, size, 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            throw std::runtime_error("The connection of remote inference is lost");
+        }
+        bytes += received;
+        size -= static_cast<size_t>(received);
+    }
+}
+
+template <typename T>
+T receiveValue(int fd) {
+    T value{};
+    receiveAll(fd, &value, sizeof(value));
+    return value;
+}
+
+std::string receiveString(int fd) {
+    std::string str(receiveValue<uint64_t>(fd), '\0');
+    if (!str.empty()) {
+        receiveAll(fd, &str[0], str.size());
+    }
+    return str;
+}
+
+/// Gathers small fields of a message and sends them together, tensor data is sent right from the tensors
+class MessageWriter {
+public:
+    MessageWriter(int fd, MessageType type, uint64_t requestId) : fd(fd) {
+        value(type).value(requestId);
+    }
+
+    template <typename T>
+    MessageWriter& value(const T& value) {
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        return *this;
+    }
+
+    MessageWriter& string(const std::string& str) {
+        value(static_cast<uint64_t>(str.size()));
+        buffer.append(str);
+        return *this;
+    }
+
+    MessageWriter& tensor(const std::string& name, const ov::Tensor& tensor) {
+        string(name);
+        value(static_cast<uint32_t>(static_cast<ov::element::Type_t>(tensor.get_element_type())));
+        const ov::Shape& shape = tensor.get_shape();
+        value(static_cast<uint32_t>(shape.size()));
+        for (size_t dim : shape) {
+            value(static_cast<uint64_t>(dim));
+        }
+        value(static_cast<uint64_t>(tensor.get_byte_size()));
+        send();
+        sendAll(fd, tensor.data(), tensor.get_byte_size());
+        return *this;
+    }
+
+    void send() {
+        sendAll(fd, buffer.data(), buffer.size());
+        buffer.clear();
+    }
+
+private:
+    const int fd;
+    std::string buffer;
+};
+
+struct TensorHeader {
+    std::string name;
+    ov::element::Type type;
+    ov::Shape shape;
+    uint64_t byteSize;
+};
+
+TensorHeader receiveTensorHeader(int fd) {
+    TensorHeader header;
+    header.name = receiveString(fd);
+    header.type = ov::element::Type(static_cast<ov::element::Type_t>(receiveValue<uint32_t>(fd)));
+    header.shape.resize(receiveValue<uint32_t>(fd));
+    for (auto& dim : header.shape) {
+        dim = static_cast<size_t>(receiveValue<uint64_t>(fd));
+    }
+    header.byteSize = receiveValue<uint64_t>(fd);
+    return header;
+}
+
+/// Receives the tensor data into the tensor of the request if it fits, so no memory is allocated for it. Otherwise
+/// a new tensor is set to the request.
+template <typename Port>
+void receiveTensor(int fd, const TensorHeader& header, ov::InferRequest& request, const Port& port) {
+    ov::Tensor tensor = request.get_tensor(port);
+    if (tensor.get_element_type() != header.type || tensor.get_shape() != header.shape) {
+        tensor = ov::Tensor(header.type, header.shape);
+        request.set_tensor(port, tensor);
+    }
+    if (tensor.get_byte_size() != header.byteSize) {
+        throw std::runtime_error("The size of the tensor " + header.name + " doesn't match its shape");
+    }
+    receiveAll(fd, tensor.data(), tensor.get_byte_size());
+}
+
+void setNoDelay(int fd) {
+    // Messages are written in a few sends each, they shouldn't wait for acknowledgements of the previous ones
+    const int noDelay = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+}
+}  // namespace
+
+RemoteInferenceClient::RemoteInferenceClient(const std::string& address) : address(address) {
+    const size_t colon = address.rfind(':');
+    if (colon == std::string::npos || colon == 0 || colon + 1 == address.size()) {
+        throw std::invalid_argument("Address of the remote worker should be <host>:<port>, got " + address);
+    }
+    const std::string host = address.substr(0, colon);
+    const std::string port = address.substr(colon + 1);
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses) != 0) {
+        throw std::runtime_error("Can't resolve the remote worker " + address);
+    }
+    for (addrinfo* it = addresses; it && socketFd < 0; it = it->ai_next) {
+        socketFd = socket(it->ai_family, it->ai_socktype, it->ai_protocol);
+        if (socketFd >= 0 && connect(socketFd, it->ai_addr, it->ai_addrlen) != 0) {
+            close(socketFd);
+            socketFd = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    if (socketFd < 0) {
+        throw std::runtime_error("Can't connect to the remote worker " + address);
+    }
+    setNoDelay(socketFd);
+}
+
+RemoteInferenceClient::~RemoteInferenceClient() {
+    // The receiving thread fails on the closed connection
+    shutdown(socketFd, SHUT_RDWR);
+    if (receivingThread.joinable()) {
+        receivingThread.join();
+    }
+    close(socketFd);
+}
+
+ov::CompiledModel RemoteInferenceClient::compileModel(const std::shared_ptr<ov::Model>& model,
+                                                      const ModelConfig& config,
+                                                      ov::Core& core) {
+    if (receivingThread.joinable()) {
+        throw std::logic_error("The model is already sent to the remote worker");
+    }
+    std::ostringstream xml, weights;
+    ov::pass::Manager manager;
+    manager.register_pass<ov::pass::Serialize>(xml, weights);
+    manager.run_passes(model);
+
+    MessageWriter message(socketFd, MessageType::Load, 0);
+    message.value(protocolSignature).string(xml.str()).string(weights.str()).string(config.deviceName);
+    message.value(static_cast<uint32_t>(config.compiledModelConfig.size()));
+    for (const auto& property : config.compiledModelConfig) {
+        message.string(property.first).string(property.second.as<std::string>());
+    }
+    message.send();
+
+    const MessageType reply = receiveValue<MessageType>(socketFd);
+    receiveValue<uint64_t>(socketFd);
+    if (reply == MessageType::Error) {
+        throw std::runtime_error("The remote worker " + address + " failed to compile the model: " +
+                                 receiveString(socketFd));
+    }
+    if (reply != MessageType::Loaded) {
+        throw std::runtime_error("The remote worker " + address + " replied with an unexpected message");
+    }
+    optimalRequestsNum = receiveValue<uint32_t>(socketFd);
+
+    // Outputs of the proxy are its parameters passed through, so it's compiled quickly and never inferred
+    ov::ParameterVector parameters;
+    for (const auto& input : model->inputs()) {
+        auto parameter = std::make_shared<ov::op::v0::Parameter>(input.get_element_type(), input.get_partial_shape());
+        parameter->output(0).set_names(input.get_names());
+        parameters.push_back(parameter);
+        inputsNames.push_back(input.get_any_name());
+    }
+    ov::ResultVector results;
+    for (const auto& output : model->outputs()) {
+        auto parameter =
+            std::make_shared<ov::op::v0::Parameter>(output.get_element_type(), output.get_partial_shape());
+        parameter->output(0).set_names(output.get_names());
+        parameters.push_back(parameter);
+        results.push_back(std::make_shared<ov::op::v0::Result>(parameter));
+    }
+    auto proxy = std::make_shared<ov::Model>(results, parameters, model->get_friendly_name() + "_remote_proxy");
+    ov::CompiledModel compiledProxy = core.compile_model(proxy, "CPU");
+    for (const auto& output : compiledProxy.outputs()) {
+        for (const std::string& name : output.get_names()) {
+            outputs.emplace(name, output);
+        }
+    }
+    slog::info << "\tRemote worker: " << address << ", device " << config.deviceName << ", optimal number of infer "
+               << "requests " << optimalRequestsNum << slog::endl;
+
+    receivingThread = std::thread(&RemoteInferenceClient::receivingThreadFunc, this);
+    return compiledProxy;
+}
+
+void RemoteInferenceClient::startAsync(ov::InferRequest& request, const Callback& callback) {
+    uint64_t requestId;
+    {
+        const std::lock_guard<std::mutex> lock(mtx);
+        if (connectionError) {
+            std::rethrow_exception(connectionError);
+        }
+        // The request is registered before it's sent, as the outputs may come before the sending returns
+        requestId = ++nextRequestId;
+        inFlightRequests.emplace(requestId, InFlightRequest{request, callback});
+    }
+    try {
+        const std::lock_guard<std::mutex> sendLock(sendMtx);
+        MessageWriter message(socketFd, MessageType::Infer, requestId);
+        message.value(static_cast<uint32_t>(inputsNames.size()));
+        for (const std::string& name : inputsNames) {
+            message.tensor(name, request.get_tensor(name));
+        }
+        message.send();
+    } catch (...) {
+        // Other requests in flight are failed by the receiving thread, as the connection is lost for it too
+        const std::lock_guard<std::mutex> lock(mtx);
+        inFlightRequests.erase(requestId);
+        condVar.notify_all();
+        throw;
+    }
+}
+
+void RemoteInferenceClient::waitForTotalCompletion() {
+    std::unique_lock<std::mutex> lock(mtx);
+    condVar.wait(lock, [&]() {
+        return inFlightRequests.empty();
+    });
+}
+
+void RemoteInferenceClient::receivingThreadFunc() {
+    try {
+        for (;;) {
+            const MessageType type = receiveValue<MessageType>(socketFd);
+            const uint64_t requestId = receiveValue<uint64_t>(socketFd);
+            InFlightRequest inFlightRequest;
+            {
+                const std::lock_guard<std::mutex> lock(mtx);
+                auto it = inFlightRequests.find(requestId);
+                if (it == inFlightRequests.end()) {
+                    throw std::runtime_error("The remote worker " + address + " replied to an unknown request");
+                }
+                inFlightRequest = it->second;
+            }
+            std::exception_ptr error;
+            if (type == MessageType::Result) {
+                const uint32_t outputsNum = receiveValue<uint32_t>(socketFd);
+                for (uint32_t i = 0; i < outputsNum; ++i) {
+                    const TensorHeader header = receiveTensorHeader(socketFd);
+                    auto output = outputs.find(header.name);
+                    if (output == outputs.end()) {
+                        throw std::runtime_error("The remote worker " + address + " sent unknown output " +
+                                                 header.name);
+                    }
+                    receiveTensor(socketFd, header, inFlightRequest.request, output->second);
+                }
+            } else if (type == MessageType::Error) {
+                error = std::make_exception_ptr(std::runtime_error("Remote inference failed: " +
+                                                                   receiveString(socketFd)));
+            } else {
+                throw std::runtime_error("The remote worker " + address + " sent an unexpected message");
+            }
+            inFlightRequest.callback(error);
+            const std::lock_guard<std::mutex> lock(mtx);
+            inFlightRequests.erase(requestId);
+            condVar.notify_all();
+        }
+    } catch (...) {
+        failInFlightRequests(std::current_exception());
+    }
+}
+
+void RemoteInferenceClient::failInFlightRequests(std::exception_ptr error) {
+    std::map<uint64_t, InFlightRequest> failedRequests;
+    {
+        const std::lock_guard<std::mutex> lock(mtx);
+        connectionError = error;
+        failedRequests = inFlightRequests;
+    }
+    for (auto& failedRequest : failedRequests) {
+        failedRequest.second.callback(error);
+    }
+    const std::lock_guard<std::mutex> lock(mtx);
+    for (const auto& failedRequest : failedRequests) {
+        inFlightRequests.erase(failedRequest.first);
+    }
+    condVar.notify_all();
+}
+
+RemoteInferenceWorker::RemoteInferenceWorker(ov::Core& core, uint16_t port, unsigned int requestsNum)
+    : core(core),
+      requestsNum(requestsNum) {
+    listeningFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listeningFd < 0) {
+        throw std::runtime_error("Can't create a socket for remote inference");
+    }
+    const int reuseAddress = 1;
+    setsockopt(listeningFd, SOL_SOCKET, SO_REUSEADDR, &reuseAddress, sizeof(reuseAddress));
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (bind(listeningFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listeningFd, SOMAXCONN) != 0) {
+        close(listeningFd);
+        throw std::runtime_error("Can't listen on the port " + std::to_string(port));
+    }
+}
+
+RemoteInferenceWorker::~RemoteInferenceWorker() {
+    close(listeningFd);
+}
+
+void RemoteInferenceWorker::run() {
+    for (;;) {
+        const int connectionFd = accept(listeningFd, nullptr, nullptr);
+        if (connectionFd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Can't accept connections of remote inference");
+        }
+        setNoDelay(connectionFd);
+        std::thread(&RemoteInferenceWorker::serveConnection, this, connectionFd).detach();
+    }
+}
+
+void RemoteInferenceWorker::serveConnection(int connectionFd) {
+    std::vector<ov::InferRequest> requests;
+    std::vector<size_t> idleSlots;
+    std::mutex idleMtx;
+    std::condition_variable idleCondVar;
+    std::mutex sendMtx;
+    try {
+        if (receiveValue<MessageType>(connectionFd) != MessageType::Load) {
+            throw std::runtime_error("A client didn't start with loading a model");
+        }
+        receiveValue<uint64_t>(connectionFd);
+        char signature[sizeof(protocolSignature)];
+        receiveAll(connectionFd, signature, sizeof(signature));
+        if (memcmp(signature, protocolSignature, sizeof(signature))) {
+            throw std::runtime_error("A client of unsupported protocol connected");
+        }
+        const std::string xml = receiveString(connectionFd);
+        std::string weights = receiveString(connectionFd);
+        const std::string device = receiveString(connectionFd);
+        ov::AnyMap config;
+        for (uint32_t propertiesNum = receiveValue<uint32_t>(connectionFd); propertiesNum > 0; --propertiesNum) {
+            std::string key = receiveString(connectionFd);
+            config.emplace(std::move(key), receiveString(connectionFd));
+        }
+
+        ov::CompiledModel compiledModel;
+        try {
+            ov::Tensor weightsTensor(ov::element::u8, {weights.size()}, weights.empty() ? nullptr : &weights[0]);
+            compiledModel = core.compile_model(core.read_model(xml, weightsTensor), device, config);
+        } catch (const std::exception& error) {
+            MessageWriter(connectionFd, MessageType::Error, 0).string(error.what()).send();
+            throw;
+        }
+        const unsigned int nireq =
+            requestsNum > 0 ? requestsNum : compiledModel.get_property(ov::optimal_number_of_infer_requests);
+        for (unsigned int slot = 0; slot < nireq; ++slot) {
+            requests.push_back(compiledModel.create_infer_request());
+            idleSlots.push_back(slot);
+        }
+        MessageWriter(connectionFd, MessageType::Loaded, 0).value(static_cast<uint32_t>(nireq)).send();
+        slog::info << "Serving a model on " << device << " with " << nireq << " infer requests" << slog::endl;
+
+        for (;;) {
+            const MessageType type = receiveValue<MessageType>(connectionFd);
+            const uint64_t requestId = receiveValue<uint64_t>(connectionFd);
+            if (type != MessageType::Infer) {
+                throw std::runtime_error("A client sent an unexpected message");
+            }
+            size_t slot;
+            {
+                // The client keeps as many requests in flight as it has, so it waits for one of them here
+                std::unique_lock<std::mutex> lock(idleMtx);
+                idleCondVar.wait(lock, [&]() {
+                    return !idleSlots.empty();
+                });
+                slot = idleSlots.back();
+                idleSlots.pop_back();
+            }
+            ov::InferRequest& request = requests[slot];
+            try {
+                for (uint32_t inputsNum = receiveValue<uint32_t>(connectionFd); inputsNum > 0; --inputsNum) {
+                    const TensorHeader header = receiveTensorHeader(connectionFd);
+                    receiveTensor(connectionFd, header, request, header.name);
+                }
+            } catch (...) {
+                const std::lock_guard<std::mutex> lock(idleMtx);
+                idleSlots.push_back(slot);
+                throw;
+            }
+            request.set_callback([&, slot, requestId](std::exception_ptr ex) {
+                try {
+                    const std::lock_guard<std::mutex> sendLock(sendMtx);
+                    if (ex) {
+                        std::string message = "unknown error";
+                        try {
+                            std::rethrow_exception(ex);
+                        } catch (const std::exception& error) {
+                            message = error.what();
+                        } catch (...) {}
+                        MessageWriter(connectionFd, MessageType::Error, requestId).string(message).send();
+                    } else {
+                        MessageWriter message(connectionFd, MessageType::Result, requestId);
+                        message.value(static_cast<uint32_t>(compiledModel.outputs().size()));
+                        for (const auto& output : compiledModel.outputs()) {
+                            message.tensor(output.get_any_name(), requests[slot].get_tensor(output));
+                        }
+                        message.send();
+                    }
+                } catch (...) {
+                    // the connection is lost, the receiving loop stops on it too
+                }
+                {
+                    const std::lock_guard<std::mutex> lock(idleMtx);
+                    idleSlots.push_back(slot);
+                }
+                idleCondVar.notify_one();
+            });
+            request.start_async();
+        }
+    } catch (const std::exception& error) {
+        slog::info << "A client disconnected: " << error.what() << slog::endl;
+    }
+    // Callbacks of the requests refer to the state of the connection
+    std::unique_lock<std::mutex> lock(idleMtx);
+    idleCondVar.wait(lock, [&]() {
+        return idleSlots.size() == requests.size();
+    });
+    lock.unlock();
+    close(connectionFd);
+}
+#else
+RemoteInferenceClient::RemoteInferenceClient(const std::string& address) : address(address) {
+    throw std::runtime_error("Remote inference isn't supported on Windows");
+}
+
+RemoteInferenceClient::~RemoteInferenceClient() {}
+
+ov::CompiledModel RemoteInferenceClient::compileModel(const std::shared_ptr<ov::Model>&,
+                                                      const ModelConfig&,
+                                                      ov::Core&) {
+    return ov::CompiledModel();
+}
+
+void RemoteInferenceClient::startAsync(ov::InferRequest&, const Callback&) {}
+
+void RemoteInferenceClient::waitForTotalCompletion() {}
+
+RemoteInferenceWorker::RemoteInferenceWorker(ov::Core& core, uint16_t, unsigned int requestsNum)
+    : core(core),
+      requestsNum(requestsNum) {
+    throw std::runtime_error("Remote inference isn't supported on Windows");
+}
+
+RemoteInferenceWorker::~RemoteInferenceWorker() {}
+
+void RemoteInferenceWorker::run() {}
+#endif
@@ -0,0 +1,108 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <iomanip>
+#include <thread>
+
+#include "utils/slog.hpp"
+#include "utils/startup_profiler.hpp"
+
+namespace {
+double toMs(StartupProfiler::Clock::duration duration) {
+    return std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(duration).count();
+}
+}  // namespace
+
+StartupProfiler::Phase::Phase(StartupProfiler& profiler, const std::string& name)
+    : profiler(profiler),
+      name(name),
+      begin(Clock::now()) {}
+
+StartupProfiler::Phase::~Phase() {
+    profiler.record(name, begin, Clock::now());
+}
+
+StartupProfiler::StartupProfiler()
+    : startTime(Clock::now()),
+      firstResultMarked(false),
+      timeToFirstResult(Clock::duration::zero()) {}
+
+void StartupProfiler::record(const std::string& name, Clock::time_point begin, Clock::time_point end) {
+    const std::lock_guard<std::mutex> lock(mtx);
+    phases.push_back({name, begin - startTime, end - begin});
+}
+
+void StartupProfiler::markFirstResult() {
+    {
+        const std::lock_guard<std::mutex> lock(mtx);
+        if (firstResultMarked) {
+            return;
+        }
+        firstResultMarked = true;
+        timeToFirstResult = Clock::now() - startTime;
+    }
+    logReport();
+}
+
+void StartupProfiler::logReport() const {
+    std::vector<PhaseTime> sortedPhases;
+    bool hasFirstResult;
+    Clock::duration firstResultTime;
+    {
+        const std::lock_guard<std::mutex> lock(mtx);
+        sortedPhases = phases;
+        hasFirstResult = firstResultMarked;
+        firstResultTime = timeToFirstResult;
+    }
+    std::stable_sort(sortedPhases.begin(), sortedPhases.end(), [](const PhaseTime& lhs, const PhaseTime& rhs) {
+        return lhs.begin < rhs.begin;
+    });
+
+    slog::info << "Startup report:" << slog::endl;
+    for (const PhaseTime& phase : sortedPhases) {
+        slog::info << "\t" << phase.name << ": " << std::fixed << std::setprecision(1) << toMs(phase.duration)
+                   << " ms, began at " << toMs(phase.begin) << " ms" << slog::endl;
+    }
+    if (hasFirstResult) {
+        slog::info << "\tTime to first result: " << std::fixed << std::setprecision(1) << toMs(firstResultTime)
+                   << " ms" << slog::endl;
+    }
+}
+
+void runInParallel(const std::vector<std::function<void()>>& tasks, size_t threadsNum) {
+    if (threadsNum == 0 || threadsNum > tasks.size()) {
+        threadsNum = tasks.size();
+    }
+    std::atomic<size_t> nextTask{0};
+    std::mutex mtx;
+    std::exception_ptr firstException = nullptr;
+    auto runTasks = [&]() {
+        for (size_t i = nextTask++; i < tasks.size(); i = nextTask++) {
+            try {
+                tasks[i]();
+            } catch (...) {
+                const std::lock_guard<std::mutex> lock(mtx);
+                if (!firstException) {
+                    firstException = std::current_exception();
+                }
+            }
+        }
+    };
+
+    // the calling thread is one of the threads
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < threadsNum; ++i) {
+        threads.emplace_back(runTasks);
+    }
+    runTasks();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    if (firstException) {
+        std::rethrow_exception(firstException);
+    }
+}
@@ -0,0 +1,63 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <cmath>
+#include <vector>
+
+#include <utils/track_association.hpp>
+
+float ShapeAffinity(float weight, const cv::Rect& trk, const cv::Rect& det) {
+    float w_dist = static_cast<float>(std::abs(trk.width - det.width)) / static_cast<float>(trk.width + det.width);
+    float h_dist = static_cast<float>(std::abs(trk.height - det.height)) / static_cast<float>(trk.height + det.height);
+    return std::exp(-weight * (w_dist + h_dist));
+}
+
+float MotionAffinity(float weight, const cv::Rect& trk, const cv::Rect& det) {
+    float x_dist = static_cast<float>(trk.x - det.x) * (trk.x - det.x) / (det.width * det.width);
+    float y_dist = static_cast<float>(trk.y - det.y) * (trk.y - det.y) / (det.height * det.height);
+    return std::exp(-weight * (x_dist + y_dist));
+}
+
+float IoU(const cv::Rect& r1, const cv::Rect& r2) {
+    const int intersection = (r1 & r2).area();
+    const int union_area = r1.area() + r2.area() - intersection;
+    return union_area > 0 ? static_cast<float>(intersection) / union_area : 0.0f;
+}
+
+const std::vector<TrackAssociator::Match>& TrackAssociator::Associate(
+        size_t tracks_num, size_t detections_num, const std::vector<Affinity>& affinities, float min_affinity) {
+    edges_.clear();
+    matches_.clear();
+    if (tracks_num == 0 || detections_num == 0)
+        return matches_;
+
+    for (size_t i = 0; i < tracks_num; i++) {
+        for (size_t j = 0; j < detections_num; j++) {
+            float affinity = 1.0f;
+            for (const auto& term : affinities) {
+                affinity *= term(i, j);
+                if (affinity < min_affinity)
+                    break;
+            }
+            if (affinity >= min_affinity)
+                edges_.push_back({static_cast<int>(i), static_cast<int>(j), 1.0f - affinity});
+        }
+    }
+
+    LinearAssignment solver;
+    const auto res = solver.Solve(static_cast<int>(tracks_num), static_cast<int>(detections_num), edges_,
+                                  1.0f - min_affinity);
+
+    // Affinities of the matched pairs are looked up in the gated edges
+    affinities_.assign(tracks_num, 0.0f);
+    for (const auto& edge : edges_) {
+        if (res[edge.row] == static_cast<size_t>(edge.col))
+            affinities_[edge.row] = 1.0f - edge.cost;
+    }
+    for (size_t i = 0; i < tracks_num; i++) {
+        if (res[i] < detections_num)
+            matches_.push_back({i, res[i], affinities_[i]});
+    }
+    return matches_;
+}
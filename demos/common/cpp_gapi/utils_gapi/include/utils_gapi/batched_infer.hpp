@@ -0,0 +1,91 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <stddef.h>
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <opencv2/core.hpp>
+#include <opencv2/gapi/garray.hpp>
+#include <opencv2/gapi/gkernel.hpp>
+#include <opencv2/gapi/gmat.hpp>
+#include <opencv2/gapi/infer.hpp>
+#include <opencv2/gapi/util/util.hpp>
+
+namespace custom {
+// clang-format off
+G_API_OP(GBatchROIs, <cv::GArray<cv::GMat>(cv::GMat, cv::GArray<cv::Rect>, cv::Size, int)>, "custom.batch_rois") {
+    static cv::GArrayDesc outMeta(const cv::GMatDesc&, const cv::GArrayDesc&, const cv::Size&, int) {
+        return cv::empty_array_desc();
+    }
+};
+
+G_API_OP(GUnbatch, <cv::GArray<cv::GMat>(cv::GArray<cv::GMat>, cv::GArray<cv::Rect>)>, "custom.unbatch") {
+    static cv::GArrayDesc outMeta(const cv::GArrayDesc&, const cv::GArrayDesc&) {
+        return cv::empty_array_desc();
+    }
+};
+// clang-format on
+
+/// Resizes the ROIs of the frame to the input size of the network and packs them into FP32 NCHW tensors of batchSize.
+/// The slots of the last tensor, which are left without ROIs, are zero.
+cv::GArray<cv::GMat> batchROIs(const cv::GMat& in,
+                               const cv::GArray<cv::Rect>& rois,
+                               const cv::Size& inputSize,
+                               int batchSize);
+
+/// Splits the batched outputs of the network into the outputs for each ROI
+cv::GArray<cv::GMat> unbatch(const cv::GArray<cv::GMat>& outs, const cv::GArray<cv::Rect>& rois);
+
+cv::gapi::GKernelPackage batchedInferKernels();
+
+struct NetInput {
+    std::string name;  // name of the input layer
+    std::vector<size_t> shape;  // NCHW shape of the input
+
+    cv::Size size() const {
+        return cv::Size(static_cast<int>(shape[3]), static_cast<int>(shape[2]));
+    }
+};
+
+/// Reads the single image input of the model
+NetInput readNetInput(const std::string& modelPath);
+
+/// Reshapes the input of the network to the batch size
+template <typename Params>
+Params& cfgBatch(Params& params, const NetInput& input, size_t batchSize) {
+    std::vector<size_t> shape = input.shape;
+    shape[0] = batchSize;
+    params.cfgInputReshape(input.name, shape);
+    return params;
+}
+
+namespace detail {
+template <typename... Outs, int... IIs>
+std::tuple<Outs...> unbatch(const std::tuple<Outs...>& outs,
+                            const cv::GArray<cv::Rect>& rois,
+                            cv::detail::Seq<IIs...>) {
+    return std::make_tuple(custom::unbatch(std::get<IIs>(outs), rois)...);
+}
+}  // namespace detail
+
+template <typename... Outs>
+std::tuple<Outs...> unbatch(const std::tuple<Outs...>& outs, const cv::GArray<cv::Rect>& rois) {
+    return detail::unbatch(outs, rois, typename cv::detail::MkSeq<sizeof...(Outs)>::type());
+}
+
+/// Replaces cv::gapi::infer<Net>(rois, in) for the network reshaped to the batch size with cfgBatch(). The ROIs are
+/// packed into the tensors of the batch, so that N ROIs take ceil(N / batchSize) inferences instead of N.
+template <typename Net>
+typename Net::ResultL inferBatched(const cv::GMat& in,
+                                   const cv::GArray<cv::Rect>& rois,
+                                   const NetInput& input,
+                                   int batchSize) {
+    return unbatch(cv::gapi::infer2<Net>(in, batchROIs(in, rois, input.size(), batchSize)), rois);
+}
+}  // namespace custom
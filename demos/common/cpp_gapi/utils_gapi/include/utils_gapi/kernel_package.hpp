@@ -0,0 +1,20 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <string>
+
+#include <opencv2/gapi/gkernel.hpp>
+
+static const char kernel_package_message[] =
+    "Optional. G-API kernel package type for the operations of the graph outside the inference: opencv, fluid, "
+    "gpu (by default opencv is used).";
+
+namespace custom {
+/// Returns the kernels of the standard G-API operations for the backend type: "opencv", "fluid" or "gpu".
+/// The "gpu" package runs the operations with OpenCL, so the preprocessing of the frames is done on the same device
+/// as the inference on GPU. The operations, which the package doesn't implement, stay on the OpenCV backend.
+cv::gapi::GKernelPackage getKernelPackage(const std::string& type);
+}  // namespace custom
@@ -0,0 +1,44 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <stddef.h>
+
+#include <deque>
+#include <utility>
+
+#include <opencv2/gapi/garg.hpp>
+#include <opencv2/gapi/gcommon.hpp>
+#include <opencv2/gapi/gcomputation.hpp>
+#include <opencv2/gapi/gmetaarg.hpp>
+#include <opencv2/gapi/gstreaming.hpp>
+
+namespace custom {
+/// Keeps the streaming graph compiled for each input description (size and type of the frames) which it has been
+/// run with. Switching to a source, which is described the same way as one of the previous ones, reuses the compiled
+/// graph with its loaded networks instead of compiling the graph again.
+class PipelineCache {
+public:
+    PipelineCache(cv::GComputation computation, cv::GCompileArgs args);
+
+    /// Stops the running pipeline, if any, and sets the inputs to the pipeline compiled for their description.
+    /// The pipeline isn't started.
+    cv::GStreamingCompiled& setSource(cv::GRunArgs&& ins);
+    /// The pipeline which the last inputs have been set to
+    cv::GStreamingCompiled& current();
+
+    size_t size() const {
+        return pipelines.size();
+    }
+
+private:
+    cv::GComputation computation;
+    cv::GCompileArgs args;
+    std::deque<std::pair<cv::GMetaArgs, cv::GStreamingCompiled>> pipelines;  // push_back keeps the references valid
+    cv::GStreamingCompiled* active = nullptr;
+
+    cv::GStreamingCompiled& get(const cv::GMetaArgs& metas);
+};
+}  // namespace custom
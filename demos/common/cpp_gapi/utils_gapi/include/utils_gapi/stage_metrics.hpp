@@ -0,0 +1,92 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <stdint.h>
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <opencv2/gapi/garray.hpp>
+#include <opencv2/gapi/gkernel.hpp>
+#include <opencv2/gapi/gmat.hpp>
+#include <opencv2/gapi/gopaque.hpp>
+
+#include <utils/performance_metrics.hpp>
+
+namespace custom {
+/// Latencies of the stages of the graph. Stages may be recorded from the threads of the streaming executor.
+class StageMetrics {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void record(const std::string& stage, Clock::duration latency);
+
+    /// Prints mean and p50/p95/p99 latencies of every stage in the order the stages were first recorded
+    void logTotal() const;
+    /// The same as a JSON object: {"<stage>": {"count": n, "mean": ms, "p50": ms, "p95": ms, "p99": ms}, ...}
+    std::string toJson() const;
+
+private:
+    struct Stage {
+        std::string name;
+        Clock::duration total;
+        LatencyHistogram histogram;
+    };
+
+    mutable std::mutex mtx;
+    std::vector<Stage> stages;
+};
+
+/// Metrics of the stages shared by the kernels of the demo
+StageMetrics& stageMetrics();
+
+/// Records the time of the scope to the stage, e.g. of run() of a custom kernel:
+///     custom::ScopedStageTimer timer("postprocessing");
+class ScopedStageTimer {
+public:
+    explicit ScopedStageTimer(std::string stage, StageMetrics& metrics = stageMetrics())
+        : stage(std::move(stage)),
+          metrics(metrics),
+          start(StageMetrics::Clock::now()) {}
+    ~ScopedStageTimer() {
+        metrics.record(stage, StageMetrics::Clock::now() - start);
+    }
+
+private:
+    std::string stage;
+    StageMetrics& metrics;
+    StageMetrics::Clock::time_point start;
+};
+
+// clang-format off
+G_API_OP(GSourceLatency, <cv::GOpaque<int64_t>(cv::GMat, cv::GOpaque<int64_t>)>, "custom.source_latency") {
+    static cv::GOpaqueDesc outMeta(const cv::GMatDesc&, const cv::GOpaqueDesc&) {
+        return cv::empty_gopaque_desc();
+    }
+};
+
+G_API_OP(GSourceLatencyList, <cv::GOpaque<int64_t>(cv::GArray<cv::GMat>, cv::GOpaque<int64_t>)>,
+         "custom.source_latency_list") {
+    static cv::GOpaqueDesc outMeta(const cv::GArrayDesc&, const cv::GOpaqueDesc&) {
+        return cv::empty_gopaque_desc();
+    }
+};
+// clang-format on
+
+/// Time in microseconds since the frame was read by the source till the data is computed by the graph, e.g. by an
+/// inference. The timestamp is cv::gapi::streaming::timestamp() of the source frame, which PrefetchingCapSrc sets.
+/// The data isn't copied, the latency is meant to be an output of the graph to be recorded after pull().
+cv::GOpaque<int64_t> sourceLatency(const cv::GMat& data, const cv::GOpaque<int64_t>& timestamp);
+cv::GOpaque<int64_t> sourceLatency(const cv::GArray<cv::GMat>& data, const cv::GOpaque<int64_t>& timestamp);
+
+/// Time in microseconds since the frame of the timestamp was read by the source till now
+int64_t sourceLatency(int64_t timestamp);
+
+cv::gapi::GKernelPackage stageMetricsKernels();
+}  // namespace custom
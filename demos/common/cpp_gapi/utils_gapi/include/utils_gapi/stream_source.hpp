@@ -4,7 +4,15 @@
 
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 #include <opencv2/core.hpp>
 #include <opencv2/gapi/gmetaarg.hpp>
@@ -34,4 +42,38 @@ protected:
     cv::GMetaArg descr_of() const override;
 };
 
+/// Reads frames on its own thread ahead of pull() calls, so decoding doesn't run in the source island of the
+/// streaming executor. Frames are passed to the graph without cloning, so the capture should return copies of frames
+/// (read_type::safe) and shouldn't be read by others while the source exists. Data of every frame has timestamp
+/// (microseconds since the system clock epoch taken before reading the frame) and seq_id meta, see
+/// cv::gapi::streaming::meta_tag.
+class PrefetchingCapSrc : public cv::gapi::wip::IStreamSource {
+public:
+    /// @param queueSize - maximum number of read frames waiting to be pulled, should be positive
+    explicit PrefetchingCapSrc(const std::shared_ptr<ImagesCapture>& cap, size_t queueSize = 4);
+    ~PrefetchingCapSrc() override;
+
+protected:
+    struct Frame {
+        cv::Mat mat;
+        int64_t timestamp;
+    };
+
+    std::shared_ptr<ImagesCapture> cap;
+    const size_t queueSize;
+    cv::GMatDesc desc;
+    int64_t seqId = 0;
+
+    std::mutex mtx;
+    std::condition_variable condVar;
+    std::deque<Frame> frames;
+    bool finished = false;  // the capture is out of frames or failed
+    bool stopped = false;
+    std::exception_ptr error;
+    std::thread prefetchingThread;
+
+    void prefetchingThreadFunc();
+    bool pull(cv::gapi::wip::Data& data) override;
+    cv::GMetaArg descr_of() const override;
+};
 }  // namespace custom
@@ -0,0 +1,56 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <stdint.h>
+
+#include <utility>
+
+#include <gflags/gflags.h>
+#include <opencv2/gapi/garg.hpp>
+#include <opencv2/gapi/gcommon.hpp>
+#include <opencv2/gapi/gstreaming.hpp>
+#include <opencv2/gapi/util/optional.hpp>
+
+#include <utils/config_factory.h>
+
+#define DEFINE_STREAMING_FLAGS \
+DEFINE_uint32(qc, 0, queue_capacity_message); \
+DEFINE_bool(latest, false, latest_result_message);
+
+static const char queue_capacity_message[] = "Optional. Capacity of the queues between the nodes of the streaming "
+    "graph. If 0 is set, the G-API default is used.";
+static const char latest_result_message[] = "Optional. Take only the newest result of the graph, dropping the older ones "
+    "which are ready, if the results are shown slower than they are produced.";
+
+namespace custom {
+/// Adds the capacity of the queues of the streaming executor to the compile args, 0 keeps the G-API default.
+/// Smaller queues keep fewer frames in flight between the source and the slowest node, which lowers the latency.
+void addQueueCapacity(cv::GCompileArgs& args, uint32_t queueCapacity);
+
+/// Configures the inference of a network with the number of infer requests and the plugin config of the model
+/// config, the same way as the models of AsyncPipeline are compiled.
+template <typename Params>
+Params& applyModelConfig(Params& params, ModelConfig& config) {
+    params.cfgNumRequests(config.maxAsyncRequests);
+    params.pluginConfig(config.getLegacyConfig());
+    return params;
+}
+
+/// Pulls the next result of the pipeline. If latestOnly is set, the result is then replaced by the newer ones, which
+/// are ready already, so that a consumer slower than the graph shows the latest frame instead of falling behind.
+/// Graphs with desynchronized outputs are pulled by GStreamingCompiled::pull(cv::GOptRunArgsP&&) instead.
+/// @returns false when the stream is over
+bool pull(cv::GStreamingCompiled& pipeline, cv::GRunArgsP&& outs, bool latestOnly);
+
+/// Keeps the last value of a desynchronized output of the graph, which is empty for the frames it isn't computed for
+template <typename T>
+void updateLatest(T& latest, cv::util::optional<T>& result) {
+    if (result.has_value()) {
+        latest = std::move(result.value());
+        result.reset();
+    }
+}
+}  // namespace custom
@@ -0,0 +1,94 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "utils_gapi/batched_infer.hpp"
+
+#include <memory>
+#include <stdexcept>
+
+#include <opencv2/gapi/cpu/gcpukernel.hpp>
+#include <opencv2/imgproc.hpp>
+#include <openvino/openvino.hpp>
+
+namespace custom {
+namespace {
+// clang-format off
+GAPI_OCV_KERNEL(OCVBatchROIs, GBatchROIs) {
+    static void run(const cv::Mat& in,
+                    const std::vector<cv::Rect>& rois,
+                    const cv::Size& input_size,
+                    int batch_size,
+                    std::vector<cv::Mat>& batches) {
+        batches.clear();
+        const int channels = in.channels();
+        const size_t plane_size = input_size.area();
+        cv::Mat resized, converted;
+        std::vector<cv::Mat> planes(channels);
+        for (size_t i = 0; i < rois.size(); ++i) {
+            const int slot = static_cast<int>(i % batch_size);
+            if (slot == 0) {
+                batches.emplace_back(std::vector<int>{batch_size, channels, input_size.height, input_size.width},
+                                     CV_32F,
+                                     cv::Scalar(0));
+            }
+            cv::resize(in(rois[i]), resized, input_size);
+            resized.convertTo(converted, CV_32F);
+            /** HWC image is split right into the CHW planes of the tensor **/
+            float* slot_data = batches.back().ptr<float>() + slot * channels * plane_size;
+            for (int ch = 0; ch < channels; ++ch) {
+                planes[ch] = cv::Mat(input_size, CV_32F, slot_data + ch * plane_size);
+            }
+            cv::split(converted, planes);
+        }
+    }
+};
+
+GAPI_OCV_KERNEL(OCVUnbatch, GUnbatch) {
+    static void run(const std::vector<cv::Mat>& batches,
+                    const std::vector<cv::Rect>& rois,
+                    std::vector<cv::Mat>& outs) {
+        outs.clear();
+        if (batches.empty()) {
+            return;
+        }
+        const int batch_size = batches[0].size[0];
+        std::vector<cv::Range> ranges(batches[0].dims, cv::Range::all());
+        for (size_t i = 0; i < rois.size(); ++i) {
+            const int slot = static_cast<int>(i % batch_size);
+            ranges[0] = cv::Range(slot, slot + 1);
+            outs.push_back(batches[i / batch_size](ranges).clone());
+        }
+    }
+};
+// clang-format on
+}  // namespace
+
+cv::GArray<cv::GMat> batchROIs(const cv::GMat& in,
+                               const cv::GArray<cv::Rect>& rois,
+                               const cv::Size& inputSize,
+                               int batchSize) {
+    return GBatchROIs::on(in, rois, inputSize, batchSize);
+}
+
+cv::GArray<cv::GMat> unbatch(const cv::GArray<cv::GMat>& outs, const cv::GArray<cv::Rect>& rois) {
+    return GUnbatch::on(outs, rois);
+}
+
+cv::gapi::GKernelPackage batchedInferKernels() {
+    return cv::gapi::kernels<OCVBatchROIs, OCVUnbatch>();
+}
+
+NetInput readNetInput(const std::string& modelPath) {
+    std::shared_ptr<ov::Model> model = ov::Core{}.read_model(modelPath);
+    if (model->get_parameters().size() != 1) {
+        throw std::logic_error("The model " + modelPath + " should have a single input to be batched");
+    }
+    const auto& parameter = model->get_parameters()[0];
+    NetInput input{parameter->get_friendly_name(), parameter->get_shape()};
+    if (input.shape.size() != 4) {
+        throw std::logic_error("The input of the model " + modelPath + " should be an NCHW image to be batched");
+    }
+    return input;
+}
+}  // namespace custom
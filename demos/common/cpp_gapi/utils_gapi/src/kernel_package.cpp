@@ -0,0 +1,27 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "utils_gapi/kernel_package.hpp"
+
+#include <stdexcept>
+
+#include <opencv2/gapi/cpu/core.hpp>
+#include <opencv2/gapi/cpu/imgproc.hpp>
+#include <opencv2/gapi/fluid/core.hpp>
+#include <opencv2/gapi/fluid/imgproc.hpp>
+#include <opencv2/gapi/gpu/core.hpp>
+#include <opencv2/gapi/gpu/imgproc.hpp>
+
+namespace custom {
+cv::gapi::GKernelPackage getKernelPackage(const std::string& type) {
+    if (type == "opencv") {
+        return cv::gapi::combine(cv::gapi::core::cpu::kernels(), cv::gapi::imgproc::cpu::kernels());
+    } else if (type == "fluid") {
+        return cv::gapi::combine(cv::gapi::core::fluid::kernels(), cv::gapi::imgproc::fluid::kernels());
+    } else if (type == "gpu") {
+        return cv::gapi::combine(cv::gapi::core::gpu::kernels(), cv::gapi::imgproc::gpu::kernels());
+    }
+    throw std::logic_error("Unsupported kernel package type: " + type);
+}
+}  // namespace custom
@@ -0,0 +1,42 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "utils_gapi/pipeline_cache.hpp"
+
+#include <utility>
+
+#include <opencv2/gapi/gproto.hpp>
+#include <opencv2/gapi/own/assert.hpp>
+
+namespace custom {
+PipelineCache::PipelineCache(cv::GComputation computation, cv::GCompileArgs args)
+    : computation(std::move(computation)),
+      args(std::move(args)) {}
+
+cv::GStreamingCompiled& PipelineCache::setSource(cv::GRunArgs&& ins) {
+    // sources are described by their first frame, so it's known before the pipeline is chosen
+    const cv::GMetaArgs metas = cv::descr_of(ins);
+    if (active != nullptr && active->running()) {
+        active->stop();
+    }
+    active = &get(metas);
+    active->setSource(std::move(ins));
+    return *active;
+}
+
+cv::GStreamingCompiled& PipelineCache::current() {
+    GAPI_Assert(active != nullptr && "The source of the pipeline isn't set");
+    return *active;
+}
+
+cv::GStreamingCompiled& PipelineCache::get(const cv::GMetaArgs& metas) {
+    for (auto& pipeline : pipelines) {
+        if (pipeline.first == metas) {
+            return pipeline.second;
+        }
+    }
+    pipelines.emplace_back(metas, computation.compileStreaming(cv::GMetaArgs(metas), cv::GCompileArgs(args)));
+    return pipelines.back().second;
+}
+}  // namespace custom
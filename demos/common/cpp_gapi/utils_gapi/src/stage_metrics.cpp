@@ -0,0 +1,97 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "utils_gapi/stage_metrics.hpp"
+
+#include <iomanip>
+#include <sstream>
+
+#include <opencv2/gapi/cpu/gcpukernel.hpp>
+
+#include <utils/slog.hpp>
+
+namespace custom {
+void StageMetrics::record(const std::string& stage, Clock::duration latency) {
+    std::lock_guard<std::mutex> lock(mtx);
+    for (auto& s : stages) {
+        if (s.name == stage) {
+            s.total += latency;
+            s.histogram.record(latency);
+            return;
+        }
+    }
+    stages.push_back({stage, latency, {}});
+    stages.back().histogram.record(latency);
+}
+
+namespace {
+double meanMs(StageMetrics::Clock::duration total, uint64_t count) {
+    return std::chrono::duration_cast<PerformanceMetrics::Ms>(total).count() / count;
+}
+}  // namespace
+
+void StageMetrics::logTotal() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    for (const auto& s : stages) {
+        slog::info << "\t" << s.name << ":\t" << std::fixed << std::setprecision(1)
+                   << meanMs(s.total, s.histogram.getCount()) << " ms (p50 " << s.histogram.getPercentile(50)
+                   << ", p95 " << s.histogram.getPercentile(95) << ", p99 " << s.histogram.getPercentile(99) << " ms)"
+                   << slog::endl;
+    }
+}
+
+std::string StageMetrics::toJson() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3) << "{";
+    for (size_t i = 0; i < stages.size(); ++i) {
+        const Stage& s = stages[i];
+        json << (i == 0 ? "" : ", ") << "\"" << s.name << "\": {\"count\": " << s.histogram.getCount()
+             << ", \"mean\": " << meanMs(s.total, s.histogram.getCount())
+             << ", \"p50\": " << s.histogram.getPercentile(50) << ", \"p95\": " << s.histogram.getPercentile(95)
+             << ", \"p99\": " << s.histogram.getPercentile(99) << "}";
+    }
+    json << "}";
+    return json.str();
+}
+
+StageMetrics& stageMetrics() {
+    static StageMetrics metrics;
+    return metrics;
+}
+
+int64_t sourceLatency(int64_t timestamp) {
+    // the timestamps of the sources are taken from the system clock in microseconds
+    const auto now = std::chrono::system_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::microseconds>(now).count() - timestamp;
+}
+
+namespace {
+// clang-format off
+GAPI_OCV_KERNEL(OCVSourceLatency, GSourceLatency) {
+    static void run(const cv::Mat&, const int64_t& timestamp, int64_t& latency) {
+        latency = sourceLatency(timestamp);
+    }
+};
+
+GAPI_OCV_KERNEL(OCVSourceLatencyList, GSourceLatencyList) {
+    static void run(const std::vector<cv::Mat>&, const int64_t& timestamp, int64_t& latency) {
+        latency = sourceLatency(timestamp);
+    }
+};
+// clang-format on
+}  // namespace
+
+cv::GOpaque<int64_t> sourceLatency(const cv::GMat& data, const cv::GOpaque<int64_t>& timestamp) {
+    return GSourceLatency::on(data, timestamp);
+}
+
+cv::GOpaque<int64_t> sourceLatency(const cv::GArray<cv::GMat>& data, const cv::GOpaque<int64_t>& timestamp) {
+    return GSourceLatencyList::on(data, timestamp);
+}
+
+cv::gapi::GKernelPackage stageMetricsKernels() {
+    return cv::gapi::kernels<OCVSourceLatency, OCVSourceLatencyList>();
+}
+}  // namespace custom
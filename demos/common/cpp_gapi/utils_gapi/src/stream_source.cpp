@@ -4,9 +4,13 @@
 
 #include "utils_gapi/stream_source.hpp"
 
+#include <chrono>
+#include <utility>
+
 #include <opencv2/gapi/garg.hpp>
 #include <opencv2/gapi/gmat.hpp>
 #include <opencv2/gapi/own/assert.hpp>
+#include <opencv2/gapi/streaming/meta.hpp>
 
 #include <utils/images_capture.h>
 
@@ -43,4 +47,97 @@ cv::GMetaArg CommonCapSrc::descr_of() const {
     GAPI_Assert(!first.empty());
     return cv::GMetaArg{cv::descr_of(first)};
 }
+
+namespace {
+int64_t getTimestamp() {
+    const auto now = std::chrono::system_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+}
+}  // namespace
+
+PrefetchingCapSrc::PrefetchingCapSrc(const std::shared_ptr<ImagesCapture>& imagesCapture, size_t queueSize)
+    : cap(imagesCapture),
+      queueSize(queueSize) {
+    GAPI_Assert(queueSize > 0);
+    // The first frame is read here to describe the input
+    const int64_t timestamp = getTimestamp();
+    cv::Mat first = cap->read();
+    if (!first.data) {
+        GAPI_Assert(false && "Couldn't grab the first frame");
+    }
+    desc = cv::descr_of(first);
+    frames.push_back({std::move(first), timestamp});
+    prefetchingThread = std::thread(&PrefetchingCapSrc::prefetchingThreadFunc, this);
+}
+
+PrefetchingCapSrc::~PrefetchingCapSrc() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopped = true;
+    }
+    condVar.notify_all();
+    prefetchingThread.join();
+}
+
+void PrefetchingCapSrc::prefetchingThreadFunc() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            condVar.wait(lock, [&] {
+                return frames.size() < queueSize || stopped;
+            });
+            if (stopped) {
+                return;
+            }
+        }
+        Frame frame;
+        try {
+            frame.timestamp = getTimestamp();
+            frame.mat = cap->read();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mtx);
+            error = std::current_exception();
+            finished = true;
+            condVar.notify_all();
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!frame.mat.data) {
+            finished = true;
+        } else {
+            frames.push_back(std::move(frame));
+        }
+        condVar.notify_all();
+        if (finished) {
+            return;
+        }
+    }
+}
+
+bool PrefetchingCapSrc::pull(cv::gapi::wip::Data& data) {
+    Frame frame;
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        condVar.wait(lock, [&] {
+            return !frames.empty() || finished;
+        });
+        if (frames.empty()) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+            return false;
+        }
+        frame = std::move(frames.front());
+        frames.pop_front();
+    }
+    condVar.notify_all();
+    data = std::move(frame.mat);
+    data.meta[cv::gapi::streaming::meta_tag::timestamp] = frame.timestamp;
+    data.meta[cv::gapi::streaming::meta_tag::seq_id] = seqId++;
+    return true;
+}
+
+cv::GMetaArg PrefetchingCapSrc::descr_of() const {
+    return cv::GMetaArg{desc};
+}
 }  // namespace custom
@@ -0,0 +1,25 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "utils_gapi/streaming.hpp"
+
+namespace custom {
+void addQueueCapacity(cv::GCompileArgs& args, uint32_t queueCapacity) {
+    if (queueCapacity != 0) {
+        args += cv::compile_args(cv::gapi::streaming::queue_capacity{queueCapacity});
+    }
+}
+
+bool pull(cv::GStreamingCompiled& pipeline, cv::GRunArgsP&& outs, bool latestOnly) {
+    // pull() and try_pull() consume the output pointers, so each call gets its own copy of them
+    if (!pipeline.pull(cv::GRunArgsP(outs))) {
+        return false;
+    }
+    if (latestOnly) {
+        while (pipeline.try_pull(cv::GRunArgsP(outs))) {
+        }
+    }
+    return true;
+}
+}  // namespace custom
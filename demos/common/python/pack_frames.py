@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""
+ Copyright (C) 2022 Intel Corporation
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+"""
+
+"""
+Decodes an input once and writes its frames into a packed raw frames file.
+C++ demos accept the file as the input (-i) and read frames from the memory
+mapped file instead of decoding them, see openImagesCapture() in
+demos/common/cpp/utils/src/images_capture.cpp.
+
+File layout, all values are little endian:
+    header       magic "OMZFRMS\\0", uint32 version, uint32 format (0 - BGR, 1 - NV12),
+                 uint32 width, uint32 height, uint64 frames number, uint64 frame stride,
+                 uint64 data offset, uint64 index offset, float64 fps
+    frames       frames of the same size starting at page aligned offsets
+    index        uint64 offset of every frame
+"""
+
+import struct
+import sys
+from argparse import ArgumentParser
+
+import cv2
+import numpy as np
+
+from images_capture import open_images_capture
+
+HEADER_FORMAT = '<8sIIIIQQQQd'
+MAGIC = b'OMZFRMS\0'
+VERSION = 1
+FORMATS = {'bgr': 0, 'nv12': 1}
+PAGE_SIZE = 4096
+
+
+def align(value, alignment=PAGE_SIZE):
+    return (value + alignment - 1) // alignment * alignment
+
+
+def to_nv12(frame):
+    height, width = frame.shape[:2]
+    i420 = cv2.cvtColor(frame, cv2.COLOR_BGR2YUV_I420).reshape(-1)
+    luma_size = width * height
+    chroma_size = luma_size // 4
+    nv12 = np.empty_like(i420)
+    nv12[:luma_size] = i420[:luma_size]
+    nv12[luma_size::2] = i420[luma_size:luma_size + chroma_size]
+    nv12[luma_size + 1::2] = i420[luma_size + chroma_size:]
+    return nv12
+
+
+def build_argparser():
+    parser = ArgumentParser()
+    parser.add_argument('-i', '--input', required=True,
+                        help='Required. An input to pack. Can be a single image, a folder of images or a video file.')
+    parser.add_argument('-o', '--output', required=True, help='Required. Name of the packed frames file to write.')
+    parser.add_argument('--format', default='bgr', choices=FORMATS.keys(),
+                        help='Optional. Format of packed frames. BGR frames are read without copying, NV12 frames '
+                             'take half of the space and are converted to BGR on reading.')
+    parser.add_argument('--limit', default=0, type=int,
+                        help='Optional. Maximum number of frames to pack. 0 means all frames.')
+    return parser
+
+
+def main():
+    args = build_argparser().parse_args()
+
+    cap = open_images_capture(args.input, False)
+    frame = cap.read()
+    if frame is None:
+        raise RuntimeError("Can't read an image from the input")
+    height, width = frame.shape[:2]
+    if args.format == 'nv12' and (width % 2 or height % 2):
+        raise RuntimeError('NV12 frames should have even sizes')
+    frame_size = width * height * 3 // 2 if args.format == 'nv12' else width * height * 3
+    frame_stride = align(frame_size)
+    data_offset = align(struct.calcsize(HEADER_FORMAT))
+
+    offsets = []
+    with open(args.output, 'wb') as output:
+        while frame is not None and (args.limit == 0 or len(offsets) < args.limit):
+            if frame.shape[:2] != (height, width) or frame.ndim != 3 or frame.shape[2] != 3:
+                raise RuntimeError('All frames should be BGR images of the same size, the frame {} is {}'
+                                   .format(len(offsets), frame.shape))
+            offset = data_offset + len(offsets) * frame_stride
+            data = to_nv12(frame) if args.format == 'nv12' else np.ascontiguousarray(frame)
+            output.seek(offset)
+            output.write(data.tobytes())
+            offsets.append(offset)
+            frame = cap.read()
+
+        index_offset = data_offset + len(offsets) * frame_stride
+        output.seek(index_offset)
+        output.write(struct.pack('<{}Q'.format(len(offsets)), *offsets))
+        output.seek(0)
+        output.write(struct.pack(HEADER_FORMAT, MAGIC, VERSION, FORMATS[args.format], width, height, len(offsets),
+                                 frame_stride, data_offset, index_offset, cap.fps()))
+    print('{} frames of {}x{} are packed into {}'.format(len(offsets), width, height, args.output))
+
+
+if __name__ == '__main__':
+    sys.exit(main() or 0)
@@ -29,6 +29,9 @@ static const char target_device_message_person_reid[] = "Optional. Specify the t
                                                         "The application looks for a suitable plugin for the specified device.";
 static const char threshold_output_message[] = "Optional. Probability threshold for person/vehicle/bike crossroad detections.";
 static const char threshold_output_message_person_reid[] = "Optional. Cosine similarity threshold between two vectors for person reidentification.";
+static const char reid_gallery_size_message[] = "Optional. Maximum number of persons remembered for reidentification. "
+                                                "If the limit is reached, the person seen least recently is forgotten. "
+                                                "0 means no limit. The default value is 1000.";
 static const char raw_output_message[] = "Optional. Output Inference results as raw values.";
 static const char no_show_message[] = "Optional. Don't show output.";
 static const char input_resizable_message[] = "Optional. Enables resizable input with support of ROI crop & auto resize.";
@@ -48,6 +51,7 @@ DEFINE_string(d_reid, "CPU", target_device_message_person_reid);
 DEFINE_bool(r, false, raw_output_message);
 DEFINE_double(t, 0.5, threshold_output_message);
 DEFINE_double(t_reid, 0.7, threshold_output_message_person_reid);
+DEFINE_uint32(reid_gallery_size, 1000, reid_gallery_size_message);
 DEFINE_bool(no_show, false, no_show_message);
 DEFINE_bool(auto_resize, false, input_resizable_message);
 DEFINE_string(u, "", utilization_monitors_message);
@@ -76,6 +80,7 @@ static void showUsage() {
     std::cout << "    -r                           " << raw_output_message << std::endl;
     std::cout << "    -t                           " << threshold_output_message << std::endl;
     std::cout << "    -t_reid                      " << threshold_output_message_person_reid << std::endl;
+    std::cout << "    -reid_gallery_size           " << reid_gallery_size_message << std::endl;
     std::cout << "    -no_show                     " << no_show_message << std::endl;
     std::cout << "    -auto_resize                 " << input_resizable_message << std::endl;
     std::cout << "    -u                           " << utilization_monitors_message << std::endl;
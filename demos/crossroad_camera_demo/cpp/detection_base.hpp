@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: Apache-2.0
 //
 
+#include <chrono>
 #include <string>
 #include "openvino/openvino.hpp"
 #include "utils/slog.hpp"
@@ -16,6 +17,9 @@ struct BaseDetection {
     ov::Tensor m_input_tensor;
     std::string m_inputName;
     std::string m_outputName;
+    // the completion time is stored by the callback, so latency() doesn't include the time the result waits for wait()
+    std::chrono::steady_clock::time_point m_submitTime;
+    std::chrono::steady_clock::time_point m_completionTime;
 
     BaseDetection(std::string& commandLineFlag, const std::string& detectorName) :
         m_commandLineFlag(commandLineFlag), m_detectorName(detectorName) {}
@@ -49,6 +53,10 @@ struct BaseDetection {
         if (!enabled() || !m_infer_request)
             return;
 
+        m_infer_request.set_callback([this](std::exception_ptr) {
+            m_completionTime = std::chrono::steady_clock::now();
+        });
+        m_submitTime = std::chrono::steady_clock::now();
         m_infer_request.start_async();
     }
 
@@ -59,6 +67,11 @@ struct BaseDetection {
         m_infer_request.wait();
     }
 
+    // Inference time of the last completed request, valid after wait()
+    std::chrono::steady_clock::duration latency() const {
+        return m_completionTime - m_submitTime;
+    }
+
     mutable bool m_enablingChecked = false;
     mutable bool m_enabled = false;
 
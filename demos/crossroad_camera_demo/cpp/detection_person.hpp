@@ -26,9 +26,10 @@ struct PersonDetection : BaseDetection {
 
     std::vector<Result> results;
 
+    // results of the previous request are kept until fetchResults(), so they can be processed while the next frame is
+    // inferred
     void submitRequest() override {
         resultsFetched = false;
-        results.clear();
         BaseDetection::submitRequest();
     }
 
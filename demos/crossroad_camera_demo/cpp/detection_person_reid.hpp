@@ -2,37 +2,86 @@
 // SPDX-License-Identifier: Apache-2.0
 //
 
+#include <algorithm>
 #include <string>
+#include <vector>
 
 #include "openvino/openvino.hpp"
+#include <opencv2/core.hpp>
 
 #include "gflags/gflags.h"
 #include "utils/slog.hpp"
 #include "detection_base.hpp"
 
 struct PersonReIdentification : BaseDetection {
-    std::vector<std::vector<float>> globalReIdVec; // contains vectors characterising all detected persons
+    // Normalized vectors characterising detected persons, a row per person, so cosine similarities of a new vector
+    // with all of them are computed by one matrix product. Rows above galleryIds.size() are preallocated.
+    cv::Mat gallery;
+    std::vector<unsigned long int> galleryIds;  // global ID of the person of every row
+    std::vector<size_t> lastSeen;  // number of the query which matched or added the row last
+    size_t queriesNum = 0;
+    unsigned long int nextId = 0;
+
+    size_t hits = 0;  // queries matched with a person of the gallery
+    size_t misses = 0;  // queries which added a new person
+    size_t evictions = 0;  // persons forgotten because the gallery was full
 
     PersonReIdentification() : BaseDetection(FLAGS_m_reid, "Person Re-Identification Retail") {}
 
     unsigned long int findMatchingPerson(const std::vector<float>& newReIdVec) {
-        auto size = globalReIdVec.size();
-
-        // assigned REID is index of the matched vector from the globalReIdVec
-        for (size_t i = 0; i < size; ++i) {
-            float cosSim = cosineSimilarity(newReIdVec, globalReIdVec[i]);
+        cv::Mat query = cv::Mat(newReIdVec, true).reshape(1, 1);
+        const double norm = cv::norm(query);
+        if (norm == 0) {
+            throw std::logic_error("cosine similarity is not defined for zero reidentification vectors");
+        }
+        query /= norm;
+        if (!gallery.empty() && gallery.cols != query.cols) {
+            throw std::logic_error("reidentification vectors have different lengths: " +
+                                   std::to_string(gallery.cols) + " and " + std::to_string(query.cols));
+        }
+        ++queriesNum;
+
+        const size_t size = galleryIds.size();
+        if (size > 0) {
+            cv::Mat similarities = gallery.rowRange(0, static_cast<int>(size)) * query.t();
+            double maxSimilarity;
+            cv::Point maxLoc;
+            cv::minMaxLoc(similarities, nullptr, &maxSimilarity, nullptr, &maxLoc);
             if (FLAGS_r) {
-                slog::debug << "cosineSimilarity: " << cosSim << slog::endl;
+                slog::debug << "cosineSimilarity: " << maxSimilarity << slog::endl;
             }
-            if (cosSim > FLAGS_t_reid) {
-                // We substitute previous person's vector by a new one characterising
+            if (maxSimilarity > FLAGS_t_reid) {
+                // We substitute the best matched person's vector by a new one characterising
                 // last person's position
-                globalReIdVec[i] = newReIdVec;
-                return i;
+                const size_t row = static_cast<size_t>(maxLoc.y);
+                query.copyTo(gallery.row(maxLoc.y));
+                lastSeen[row] = queriesNum;
+                ++hits;
+                return galleryIds[row];
+            }
+        }
+
+        ++misses;
+        size_t row = size;
+        if (FLAGS_reid_gallery_size > 0 && size >= FLAGS_reid_gallery_size) {
+            // The person seen least recently is replaced
+            row = std::min_element(lastSeen.begin(), lastSeen.end()) - lastSeen.begin();
+            galleryIds[row] = nextId;
+            lastSeen[row] = queriesNum;
+            ++evictions;
+        } else {
+            if (static_cast<int>(size) == gallery.rows) {
+                cv::Mat grownGallery(std::max(2 * gallery.rows, 64), query.cols, CV_32F);
+                if (!gallery.empty()) {
+                    gallery.copyTo(grownGallery.rowRange(0, gallery.rows));
+                }
+                gallery = grownGallery;
             }
+            galleryIds.push_back(nextId);
+            lastSeen.push_back(queriesNum);
         }
-        globalReIdVec.push_back(newReIdVec);
-        return size;
+        query.copyTo(gallery.row(static_cast<int>(row)));
+        return nextId++;
     }
 
     std::vector<float> getReidVec() {
@@ -44,30 +93,6 @@ struct PersonReIdentification : BaseDetection {
         return std::vector<float>(outputValues, outputValues + numOfChannels);
     }
 
-    template <typename T>
-    float cosineSimilarity(const std::vector<T>& vecA, const std::vector<T>& vecB) {
-        if (vecA.size() != vecB.size()) {
-            throw std::logic_error("cosine similarity can't be called for the vectors of different lengths: "
-                                   "vecA size = " + std::to_string(vecA.size()) +
-                                   "vecB size = " + std::to_string(vecB.size()));
-        }
-
-        T mul, denomA, denomB, A, B;
-        mul = denomA = denomB = A = B = 0;
-        for (size_t i = 0; i < vecA.size(); ++i) {
-            A = vecA[i];
-            B = vecB[i];
-            mul += A * B;
-            denomA += A * A;
-            denomB += B * B;
-        }
-        if (denomA == 0 || denomB == 0) {
-            throw std::logic_error("cosine similarity is not defined whenever one or both "
-                                   "input vectors are zero-vectors.");
-        }
-        return mul / (sqrt(denomA) * sqrt(denomB));
-    }
-
     std::shared_ptr<ov::Model> read(const ov::Core& core) override {
         // Read network model
         slog::info << "Reading model: " << FLAGS_m_reid << slog::endl;
@@ -56,6 +56,10 @@ int main(int argc, char* argv[]) {
         if (!ParseAndCheckCommandLine(argc, argv)) {
             return 0;
         }
+        if (FLAGS_r) {
+            // Raw results are logged for every person, so the lines are written by a background thread
+            slog::setAsync(true);
+        }
 
         std::unique_ptr<ImagesCapture> cap = openImagesCapture(FLAGS_i, FLAGS_loop);
 
@@ -91,24 +95,34 @@ int main(int argc, char* argv[]) {
 
         bool shouldHandleTopBottomColors = personAttribs.HasTopBottomColor();
 
-        do {
+        auto submitDetection = [&](const cv::Mat& img, ov::Tensor& imgTensor) {
             if (FLAGS_auto_resize) {
                 // just wrap Mat object with Tensor without additional memory allocation
-                frameTensor = wrapMat2Tensor(frame);
-                personDetection.setRoiTensor(frameTensor);
+                imgTensor = wrapMat2Tensor(img);
+                personDetection.setRoiTensor(imgTensor);
             } else {
                 // resize Mat and copy data into OpenVINO allocated Tensor
-                personDetection.enqueue(frame);
+                personDetection.enqueue(img);
             }
-            // Run Person detection inference
-            auto t0 = std::chrono::high_resolution_clock::now();
             personDetection.submitRequest();
+        };
+        submitDetection(frame, frameTensor);
+
+        do {
             personDetection.wait();
-            auto t1 = std::chrono::high_resolution_clock::now();
-            ms detection = std::chrono::duration_cast<ms>(t1 - t0);
+            ms detection = std::chrono::duration_cast<ms>(personDetection.latency());
             // parse inference results internally (e.g. apply a threshold, etc)
             personDetection.fetchResults();
 
+            // Person detection of the next frame runs while the persons of this frame are processed, so the frame
+            // rate is limited by the slowest stage rather than by the sum of the networks latencies
+            auto nextStartTime = std::chrono::steady_clock::now();
+            cv::Mat nextFrame = cap->read();
+            ov::Tensor nextFrameTensor;
+            if (nextFrame.data) {
+                submitDetection(nextFrame, nextFrameTensor);
+            }
+
             // Process the results down to the pipeline
             ms personAttribsNetworkTime(0), personReIdNetworktime(0);
             int personAttribsInferred = 0,  personReIdInferred = 0;
@@ -129,20 +143,28 @@ int main(int argc, char* argv[]) {
                         person = frame(clippedRect);
                     }
 
-                    PersonAttribsDetection::AttributesAndColorPoints resPersAttrAndColor;
+                    // Person Attributes Recognition and Person Reidentification run in parallel
                     if (personAttribs.enabled()) {
-                        // Run Person Attributes Recognition
                         if (FLAGS_auto_resize) {
                             personAttribs.setRoiTensor(roiTensor);
                         } else {
                             personAttribs.enqueue(person);
                         }
-
-                        t0 = std::chrono::high_resolution_clock::now();
                         personAttribs.submitRequest();
+                    }
+                    if (personReId.enabled()) {
+                        if (FLAGS_auto_resize) {
+                            personReId.setRoiTensor(roiTensor);
+                        } else {
+                            personReId.enqueue(person);
+                        }
+                        personReId.submitRequest();
+                    }
+
+                    PersonAttribsDetection::AttributesAndColorPoints resPersAttrAndColor;
+                    if (personAttribs.enabled()) {
                         personAttribs.wait();
-                        t1 = std::chrono::high_resolution_clock::now();
-                        personAttribsNetworkTime += std::chrono::duration_cast<ms>(t1 - t0);
+                        personAttribsNetworkTime += std::chrono::duration_cast<ms>(personAttribs.latency());
                         personAttribsInferred++;
                         // Process outputs
 
@@ -188,27 +210,16 @@ int main(int argc, char* argv[]) {
 
                     std::string resPersReid = "";
                     if (personReId.enabled()) {
-                        // Run Person Reidentification
-                        if (FLAGS_auto_resize) {
-                            personReId.setRoiTensor(roiTensor);
-                        } else {
-                            personReId.enqueue(person);
-                        }
-
-                        t0 = std::chrono::high_resolution_clock::now();
-                        personReId.submitRequest();
                         personReId.wait();
-                        t1 = std::chrono::high_resolution_clock::now();
-
-                        personReIdNetworktime += std::chrono::duration_cast<ms>(t1 - t0);
+                        personReIdNetworktime += std::chrono::duration_cast<ms>(personReId.latency());
                         personReIdInferred++;
 
                         auto reIdVector = personReId.getReidVec();
 
                         // Check cosine similarity with all previously detected persons.
-                        //   If it's new person it is added to the global Reid vector and
+                        //   If it's new person it is added to the gallery and
                         //   new global ID is assigned to the person. Otherwise, ID of
-                        //   matched person is assigned to it.
+                        //   the best matched person is assigned to it.
                         auto foundId = personReId.findMatchingPerson(reIdVector);
                         resPersReid = "REID: " + std::to_string(foundId);
                     }
@@ -310,14 +321,19 @@ int main(int argc, char* argv[]) {
                     break;
                 presenter.handleKey(key);
             }
-            startTime = std::chrono::steady_clock::now();
-
-            // get next frame
-            frame = cap->read();
+            startTime = nextStartTime;
+            frame = nextFrame;
+            frameTensor = nextFrameTensor;
         } while (frame.data);
+        personDetection.wait();  // the next frame may be still inferred after Esc
 
         slog::info << "Metrics report:" << slog::endl;
         metrics.logTotal();
+        if (personReId.enabled()) {
+            slog::info << "\tReidentification gallery: " << personReId.galleryIds.size() << " persons, "
+                       << personReId.hits << " matches, " << personReId.misses << " new persons, "
+                       << personReId.evictions << " forgotten" << slog::endl;
+        }
         slog::info << presenter.reportMeans() << slog::endl;
     }
     catch (const std::exception& error) {
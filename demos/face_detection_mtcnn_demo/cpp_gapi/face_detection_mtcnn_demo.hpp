@@ -9,6 +9,7 @@
 #include <gflags/gflags.h>
 
 #include <utils/default_flags.hpp>
+#include <utils_gapi/kernel_package.hpp>
 
 DEFINE_INPUT_FLAGS
 DEFINE_OUTPUT_FLAGS
@@ -34,6 +35,10 @@ static const char thresh_output_message[] = "Optional. MTCNN confidence threshol
 static const char queue_capacity_message[] =
     "Optional. Streaming executor queue capacity. Calculated automaticaly if 0.";
 static const char half_scale_message[] = "Optional. MTCNN P use half scale pyramid.";
+static const char tiled_pyramid_message[] =
+    "Optional. Tile all pyramid levels into one image to infer MTCNN P network once per frame.";
+static const char num_infer_requests_message[] =
+    "Optional. Number of infer requests for MTCNN R and O networks, which run on every face candidate.";
 static const char no_show_message[] = "Optional. Don't show output.";
 static const char utilization_monitors_message[] = "Optional. List of monitors to show initially.";
 
@@ -47,6 +52,9 @@ DEFINE_string(d_r, "CPU", target_device_message_r);
 DEFINE_string(d_o, "CPU", target_device_message_o);
 DEFINE_uint32(qc, 1, queue_capacity_message);
 DEFINE_bool(hs, false, half_scale_message);
+DEFINE_bool(tiled, false, tiled_pyramid_message);
+DEFINE_uint32(nireq, 1, num_infer_requests_message);
+DEFINE_string(kernel_package, "opencv", kernel_package_message);
 DEFINE_double(th, 0.7, thresh_output_message);
 DEFINE_bool(no_show, false, no_show_message);
 DEFINE_string(u, "", utilization_monitors_message);
@@ -75,6 +83,9 @@ static void showUsage() {
     std::cout << "    -d_o \"<device>\"         " << target_device_message_o << std::endl;
     std::cout << "    -qc                      " << queue_capacity_message << std::endl;
     std::cout << "    -hs                      " << half_scale_message << std::endl;
+    std::cout << "    -tiled                   " << tiled_pyramid_message << std::endl;
+    std::cout << "    -nireq \"<integer>\"       " << num_infer_requests_message << std::endl;
+    std::cout << "    -kernel_package \"<string>\" " << kernel_package_message << std::endl;
     std::cout << "    -no_show                 " << no_show_message << std::endl;
     std::cout << "    -th                      " << thresh_output_message << std::endl;
     std::cout << "    -u                       " << utilization_monitors_message << std::endl;
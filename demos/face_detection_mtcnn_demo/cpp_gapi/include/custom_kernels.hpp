@@ -16,14 +16,10 @@
 #include <opencv2/core.hpp>
 #include <opencv2/gapi/garray.hpp>
 #include <opencv2/gapi/gkernel.hpp>
+#include <opencv2/gapi/gmat.hpp>
 #include <opencv2/gapi/gopaque.hpp>
 #include <opencv2/gapi/render/render_types.hpp>
 
-namespace cv {
-class GMat;
-struct GMatDesc;
-}  // namespace cv
-
 #define NUM_PTS         5
 #define NUM_REGRESSIONS 4
 
@@ -123,6 +119,13 @@ struct Face {
     }
 };
 
+/// Place of a P-Net pyramid level on the canvas, which all the levels are tiled into to be inferred at once.
+/// The canvas and the rectangles are in the coordinates of the transposed frame.
+struct PyramidLevel {
+    cv::Rect rect;
+    float scale;
+};
+
 // Define networks for this sample
 using GMat2 = std::tuple<cv::GMat, cv::GMat>;
 using GMat3 = std::tuple<cv::GMat, cv::GMat, cv::GMat>;
@@ -144,6 +147,27 @@ using GFaces = cv::GArray<custom::Face>;
         }
     };
 
+    G_API_OP(BuildPyramidCanvas,
+             <cv::GMat(cv::GMat, std::vector<PyramidLevel>, cv::Size)>,
+             "custom.mtcnn.build_pyramid_canvas") {
+        static cv::GMatDesc outMeta(const cv::GMatDesc& in,
+                                    const std::vector<PyramidLevel>&,
+                                    const cv::Size& canvas_size) {
+            return in.withSize(canvas_size);
+        }
+    };
+
+    G_API_OP(BuildPyramidFaces,
+             <GFaces(cv::GMat, cv::GMat, std::vector<PyramidLevel>, float)>,
+             "custom.mtcnn.build_pyramid_faces") {
+        static cv::GArrayDesc outMeta(const cv::GMatDesc&,
+                                      const cv::GMatDesc&,
+                                      const std::vector<PyramidLevel>&,
+                                      const float) {
+            return cv::empty_array_desc();
+        }
+    };
+
     G_API_OP(RunNMS,
              <GFaces(GFaces, float, bool)>,
              "custom.mtcnn.run_nms") {
@@ -11,6 +11,8 @@
 
 #include <opencv2/gapi.hpp>
 
+#include "custom_kernels.hpp"
+
 // Infer helper function
 namespace {
 static inline std::tuple<cv::GMat, cv::GMat> run_mtcnn_p(cv::GMat& in, const std::string& id) {
@@ -83,4 +85,40 @@ int calculate_half_scales(const cv::Size& input_size,
     return factor_count;
 }
 
+// Tiles the pyramid levels into one canvas for a single P-Net inference and returns the canvas size.
+// Levels are put on shelves left to right. They are placed at even coordinates, so that the P-Net cells of
+// a level start at half of them, and are separated by gaps, which keep the windows of the border cells of
+// a level off its neighbours.
+cv::Size tile_pyramid(const std::vector<cv::Size>& level_sizes,
+                      const std::vector<double>& scales,
+                      std::vector<custom::PyramidLevel>& out_levels) {
+    const int gap = 2;
+    const auto align_even = [](int value) {
+        return (value + 1) / 2 * 2;
+    };
+    out_levels.clear();
+    if (level_sizes.empty()) {
+        return cv::Size();
+    }
+    // P-Net works on the transposed frame
+    const int canvas_width = level_sizes[0].height;
+    int canvas_height = 0;
+    int x = 0;
+    int y = 0;
+    int shelf_height = 0;
+    for (size_t i = 0; i < level_sizes.size(); ++i) {
+        const cv::Size size(level_sizes[i].height, level_sizes[i].width);
+        if (x > 0 && x + size.width > canvas_width) {
+            x = 0;
+            y += align_even(shelf_height + gap);
+            shelf_height = 0;
+        }
+        out_levels.push_back({cv::Rect(cv::Point(x, y), size), static_cast<float>(scales[i])});
+        x += align_even(size.width + gap);
+        shelf_height = std::max(shelf_height, size.height);
+        canvas_height = std::max(canvas_height, y + size.height);
+    }
+    return cv::Size(canvas_width, canvas_height);
+}
+
 }  // anonymous namespace
@@ -41,6 +41,7 @@
 #include <utils/ocv_common.hpp>
 #include <utils/performance_metrics.hpp>
 #include <utils/slog.hpp>
+#include <utils_gapi/kernel_package.hpp>
 #include <utils_gapi/stream_source.hpp>
 
 #include "custom_kernels.hpp"
@@ -125,31 +126,51 @@ int main(int argc, char* argv[]) {
         cv::GArray<custom::Face> nms_p_faces[MAX_PYRAMID_LEVELS];
         cv::GArray<custom::Face> total_faces[MAX_PYRAMID_LEVELS];
 
-        /** The very first PNet pyramid layer to init total_faces[0] **/
-        std::tie(regressions[0], scores[0]) = run_mtcnn_p(in_transposedRGB, get_pnet_level_name(level_size[0]));
-        cv::GArray<custom::Face> faces0 = custom::BuildFaces::on(scores[0],
-                                                                 regressions[0],
-                                                                 static_cast<float>(scales[0]),
-                                                                 static_cast<float>(FLAGS_th));
-        cv::GArray<custom::Face> final_p_faces_for_bb2squares = custom::ApplyRegression::on(faces0, true);
-        cv::GArray<custom::Face> final_faces_pnet0 = custom::BBoxesToSquares::on(final_p_faces_for_bb2squares);
-        total_faces[0] = custom::RunNMS::on(final_faces_pnet0, 0.5f, false);
-
-        /** The rest PNet pyramid layers to accumlate all layers result in total_faces[PYRAMID_LEVELS - 1]] **/
-        for (int i = 1; i < pyramid_levels; ++i) {
-            std::tie(regressions[i], scores[i]) = run_mtcnn_p(in_transposedRGB, get_pnet_level_name(level_size[i]));
-            cv::GArray<custom::Face> faces = custom::BuildFaces::on(scores[i],
-                                                                    regressions[i],
-                                                                    static_cast<float>(scales[i]),
-                                                                    static_cast<float>(FLAGS_th));
-            cv::GArray<custom::Face> final_p_faces_for_bb2squares_i = custom::ApplyRegression::on(faces, true);
-            cv::GArray<custom::Face> final_faces_pnet_i = custom::BBoxesToSquares::on(final_p_faces_for_bb2squares_i);
-            nms_p_faces[i] = custom::RunNMS::on(final_faces_pnet_i, 0.5f, false);
-            total_faces[i] = custom::AccumulatePyramidOutputs::on(total_faces[i - 1], nms_p_faces[i]);
+        std::vector<custom::PyramidLevel> tiled_levels;
+        const cv::Size canvas_size = tile_pyramid(level_size, scales, tiled_levels);
+        cv::GArray<custom::Face> pyramid_faces;
+        if (FLAGS_tiled) {
+            /** All PNet pyramid layers are tiled into one canvas and inferred at once **/
+            cv::GMat canvas = custom::BuildPyramidCanvas::on(in_transposedRGB, tiled_levels, canvas_size);
+            cv::GMat tiled_regressions, tiled_scores;
+            std::tie(tiled_regressions, tiled_scores) =
+                run_mtcnn_p(canvas, get_pnet_level_name(canvas_size));
+            pyramid_faces = custom::BuildPyramidFaces::on(tiled_scores,
+                                                          tiled_regressions,
+                                                          tiled_levels,
+                                                          static_cast<float>(FLAGS_th));
+        } else {
+            /** The very first PNet pyramid layer to init total_faces[0] **/
+            std::tie(regressions[0], scores[0]) =
+                run_mtcnn_p(in_transposedRGB, get_pnet_level_name(level_size[0]));
+            cv::GArray<custom::Face> faces0 = custom::BuildFaces::on(scores[0],
+                                                                     regressions[0],
+                                                                     static_cast<float>(scales[0]),
+                                                                     static_cast<float>(FLAGS_th));
+            cv::GArray<custom::Face> final_p_faces_for_bb2squares = custom::ApplyRegression::on(faces0, true);
+            cv::GArray<custom::Face> final_faces_pnet0 =
+                custom::BBoxesToSquares::on(final_p_faces_for_bb2squares);
+            total_faces[0] = custom::RunNMS::on(final_faces_pnet0, 0.5f, false);
+
+            /** The rest PNet pyramid layers to accumlate all layers result in total_faces[PYRAMID_LEVELS - 1]] **/
+            for (int i = 1; i < pyramid_levels; ++i) {
+                std::tie(regressions[i], scores[i]) =
+                    run_mtcnn_p(in_transposedRGB, get_pnet_level_name(level_size[i]));
+                cv::GArray<custom::Face> faces = custom::BuildFaces::on(scores[i],
+                                                                        regressions[i],
+                                                                        static_cast<float>(scales[i]),
+                                                                        static_cast<float>(FLAGS_th));
+                cv::GArray<custom::Face> final_p_faces_for_bb2squares_i = custom::ApplyRegression::on(faces, true);
+                cv::GArray<custom::Face> final_faces_pnet_i =
+                    custom::BBoxesToSquares::on(final_p_faces_for_bb2squares_i);
+                nms_p_faces[i] = custom::RunNMS::on(final_faces_pnet_i, 0.5f, false);
+                total_faces[i] = custom::AccumulatePyramidOutputs::on(total_faces[i - 1], nms_p_faces[i]);
+            }
+            pyramid_faces = total_faces[pyramid_levels - 1];
         }
 
         /** Proposal post-processing **/
-        cv::GArray<custom::Face> final_faces_pnet = custom::RunNMS::on(total_faces[pyramid_levels - 1], 0.7f, true);
+        cv::GArray<custom::Face> final_faces_pnet = custom::RunNMS::on(pyramid_faces, 0.7f, true);
 
         /** Refinement part of MTCNN graph **/
         cv::GArray<cv::Rect> faces_roi_pnet = custom::R_O_NetPreProcGetROIs::on(final_faces_pnet, in_sz);
@@ -196,7 +217,8 @@ int main(int argc, char* argv[]) {
                 fileNameNoExt(FLAGS_m_r) + ".bin",  // path to weights
                 FLAGS_d_r,  // device specifier
             }.cfgOutputLayers({"conv5-2", "prob1"})
-             .cfgInputLayers({"data"});
+             .cfgInputLayers({"data"})
+             .cfgNumRequests(FLAGS_nireq);
 
         // MTCNN Output detection network
         auto mtcnno_net =
@@ -205,14 +227,13 @@ int main(int argc, char* argv[]) {
                 fileNameNoExt(FLAGS_m_o) + ".bin",  // path to weights
                 FLAGS_d_o,  // device specifier
             }.cfgOutputLayers({"conv6-2", "conv6-3", "prob1"})
-             .cfgInputLayers({"data"});
+             .cfgInputLayers({"data"})
+             .cfgNumRequests(FLAGS_nireq);
         // clang-format on
         auto networks_mtcnn = cv::gapi::networks(mtcnnr_net, mtcnno_net);
 
         // MTCNN Proposal detection network
-        for (int i = 0; i < pyramid_levels; ++i) {
-            std::string net_id = get_pnet_level_name(level_size[i]);
-            std::vector<size_t> reshape_dims = {1, 3, size_t(level_size[i].width), size_t(level_size[i].height)};
+        auto add_pnet = [&](const std::string& net_id, const std::vector<size_t>& reshape_dims) {
             cv::gapi::ie::Params<cv::gapi::Generic> mtcnnp_net{
                 net_id,  // tag
                 FLAGS_m_p,  // path to topology IR
@@ -221,24 +242,34 @@ int main(int argc, char* argv[]) {
             };
             mtcnnp_net.cfgInputReshape("data", reshape_dims);
             networks_mtcnn += cv::gapi::networks(mtcnnp_net);
+        };
+        if (FLAGS_tiled) {
+            /** The canvas is already transposed, so its rows and columns are the network height and width **/
+            add_pnet(get_pnet_level_name(canvas_size),
+                     {1, 3, size_t(canvas_size.height), size_t(canvas_size.width)});
+        } else {
+            for (int i = 0; i < pyramid_levels; ++i) {
+                add_pnet(get_pnet_level_name(level_size[i]),
+                         {1, 3, size_t(level_size[i].width), size_t(level_size[i].height)});
+            }
         }
 
         /** Custom kernels **/
-        auto kernels_mtcnn = custom::kernels();
+        auto kernels_mtcnn = cv::gapi::combine(custom::kernels(), custom::getKernelPackage(FLAGS_kernel_package));
         auto mtcnn_args = cv::compile_args(networks_mtcnn, kernels_mtcnn);
         if (FLAGS_qc != 0) {
             mtcnn_args += cv::compile_args(cv::gapi::streaming::queue_capacity{FLAGS_qc});
         }
         auto pipeline_mtcnn = graph_mtcnn.compileStreaming(std::move(mtcnn_args));
 
+        LazyVideoWriter videoWriter{FLAGS_o, cap->fps(), FLAGS_limit};
+
         /** ---------------- The execution part ---------------- **/
-        pipeline_mtcnn.setSource<custom::CommonCapSrc>(cap);
+        pipeline_mtcnn.setSource<custom::PrefetchingCapSrc>(cap);
 
         cv::Size graphSize{static_cast<int>(frame_size.width / 4), 60};
         Presenter presenter(FLAGS_u, frame_size.height - graphSize.height - 10, graphSize);
 
-        LazyVideoWriter videoWriter{FLAGS_o, cap->fps(), FLAGS_limit};
-
         /** Output Mat for result **/
         cv::Mat out_image;
         bool isStart = true;
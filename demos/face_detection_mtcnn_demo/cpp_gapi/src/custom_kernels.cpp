@@ -12,20 +12,21 @@
 namespace {
 const float P_NET_WINDOW_SIZE = 12.0f;
 
+// Builds the faces of a pyramid level, whose P-Net outputs are the cells region of the output maps
 std::vector<custom::Face> buildFaces(const cv::Mat& scores,
                                      const cv::Mat& regressions,
                                      const float scaleFactor,
-                                     const float threshold) {
-    const auto w = scores.size[3];
-    const auto h = scores.size[2];
-    const auto size = w * h;
+                                     const float threshold,
+                                     const cv::Rect& cells) {
+    const auto map_w = scores.size[3];
+    const auto size = map_w * scores.size[2];
 
     const float* scores_data = scores.ptr<float>();
     scores_data += size;
 
     const float* reg_data = regressions.ptr<float>();
 
-    const auto out_side = std::max(h, w);
+    const auto out_side = std::max(cells.height, cells.width);
     const auto in_side = 2 * out_side + 11;
     float stride = 0.0f;
     if (out_side != 1) {
@@ -34,29 +35,37 @@ std::vector<custom::Face> buildFaces(const cv::Mat& scores,
 
     std::vector<custom::Face> boxes;
 
-    for (int i = 0; i < size; i++) {
-        if (scores_data[i] >= (threshold)) {
-            const float y = static_cast<float>(i / w);
-            const float x = static_cast<float>(i - w * y);
-
-            custom::Face faceInfo;
-            custom::BBox& faceBox = faceInfo.bbox;
-
-            faceBox.x1 = std::max(0, static_cast<int>((x * stride) / scaleFactor));
-            faceBox.y1 = std::max(0, static_cast<int>((y * stride) / scaleFactor));
-            faceBox.x2 = static_cast<int>((x * stride + P_NET_WINDOW_SIZE - 1.0f) / scaleFactor);
-            faceBox.y2 = static_cast<int>((y * stride + P_NET_WINDOW_SIZE - 1.0f) / scaleFactor);
-            faceInfo.regression[0] = reg_data[i];
-            faceInfo.regression[1] = reg_data[i + size];
-            faceInfo.regression[2] = reg_data[i + 2 * size];
-            faceInfo.regression[3] = reg_data[i + 3 * size];
-            faceInfo.score = scores_data[i];
-            boxes.push_back(faceInfo);
+    for (int row = 0; row < cells.height; row++) {
+        for (int col = 0; col < cells.width; col++) {
+            const int i = (cells.y + row) * map_w + cells.x + col;
+            if (scores_data[i] >= (threshold)) {
+                const float y = static_cast<float>(row);
+                const float x = static_cast<float>(col);
+
+                custom::Face faceInfo;
+                custom::BBox& faceBox = faceInfo.bbox;
+
+                faceBox.x1 = std::max(0, static_cast<int>((x * stride) / scaleFactor));
+                faceBox.y1 = std::max(0, static_cast<int>((y * stride) / scaleFactor));
+                faceBox.x2 = static_cast<int>((x * stride + P_NET_WINDOW_SIZE - 1.0f) / scaleFactor);
+                faceBox.y2 = static_cast<int>((y * stride + P_NET_WINDOW_SIZE - 1.0f) / scaleFactor);
+                faceInfo.regression[0] = reg_data[i];
+                faceInfo.regression[1] = reg_data[i + size];
+                faceInfo.regression[2] = reg_data[i + 2 * size];
+                faceInfo.regression[3] = reg_data[i + 3 * size];
+                faceInfo.score = scores_data[i];
+                boxes.push_back(faceInfo);
+            }
         }
     }
 
     return boxes;
 }
+
+// Size of the P-Net output for the input of the given size: conv 3x3, max pool 2x2 with ceil rounding, 2 conv 3x3
+int pNetOutputSide(int input_side) {
+    return (input_side - 3) / 2 - 3;
+}
 }  // anonymous namespace
 
 // clang-format off
@@ -67,10 +76,47 @@ GAPI_OCV_KERNEL(OCVBuildFaces, custom::BuildFaces) {
                     const float scaleFactor,
                     const float threshold,
         std::vector<custom::Face> &out_faces) {
-        out_faces = buildFaces(in_scores, in_regresssions, scaleFactor, threshold);
+        const cv::Rect cells(0, 0, in_scores.size[3], in_scores.size[2]);
+        out_faces = buildFaces(in_scores, in_regresssions, scaleFactor, threshold, cells);
     }
 };  // GAPI_OCV_KERNEL(BuildFaces)
 
+GAPI_OCV_KERNEL(OCVBuildPyramidCanvas, custom::BuildPyramidCanvas) {
+    static void run(const cv::Mat & in,
+                    const std::vector<custom::PyramidLevel> &levels,
+                    const cv::Size &,
+                          cv::Mat &out_canvas) {
+        // Gaps between levels stay black
+        out_canvas.setTo(cv::Scalar::all(0));
+        for (const auto& level : levels) {
+            cv::Mat level_roi = out_canvas(level.rect);
+            cv::resize(in, level_roi, level.rect.size());
+        }
+    }
+};  // GAPI_OCV_KERNEL(BuildPyramidCanvas)
+
+GAPI_OCV_KERNEL(OCVBuildPyramidFaces, custom::BuildPyramidFaces) {
+    static void run(const cv::Mat & in_scores,
+                    const cv::Mat & in_regresssions,
+                    const std::vector<custom::PyramidLevel> &levels,
+                    const float threshold,
+                          std::vector<custom::Face> &out_faces) {
+        // Same as BuildFaces, ApplyRegression, BBoxesToSquares and RunNMS per level
+        // followed by AccumulatePyramidOutputs in the graph with a P-Net per level
+        out_faces.clear();
+        for (const auto& level : levels) {
+            // Levels are placed at even coordinates, so their cells start exactly at half of them
+            const cv::Rect cells(level.rect.x / 2, level.rect.y / 2,
+                                 pNetOutputSide(level.rect.width), pNetOutputSide(level.rect.height));
+            std::vector<custom::Face> faces = buildFaces(in_scores, in_regresssions, level.scale, threshold, cells);
+            custom::Face::applyRegression(faces, true);
+            custom::Face::bboxes2Squares(faces);
+            const std::vector<custom::Face> nms_faces = custom::Face::runNMS(faces, 0.5f, false);
+            out_faces.insert(out_faces.end(), nms_faces.begin(), nms_faces.end());
+        }
+    }
+};  // GAPI_OCV_KERNEL(BuildPyramidFaces)
+
 GAPI_OCV_KERNEL(OCVRunNMS, custom::RunNMS) {
     static void run(const std::vector<custom::Face> &in_faces,
                     const float threshold,
@@ -243,6 +289,8 @@ GAPI_OCV_KERNEL(OCVBoxesAndMarks, custom::BoxesAndMarks) {
 
 cv::gapi::GKernelPackage custom::kernels() {
     return cv::gapi::kernels<OCVBuildFaces,
+                             OCVBuildPyramidCanvas,
+                             OCVBuildPyramidFaces,
                              OCVRunNMS,
                              OCVAccumulatePyramidOutputs,
                              OCVApplyRegression,
@@ -0,0 +1,117 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <chrono>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <gflags/gflags.h>
+#include <opencv2/core.hpp>
+
+#include <utils/default_flags.hpp>
+#include <utils/frame_bus.hpp>
+#include <utils/images_capture.h>
+#include <utils/performance_metrics.hpp>
+#include <utils/slog.hpp>
+
+DEFINE_INPUT_FLAGS
+
+static const char help_message[] = "Print a usage message.";
+static const char bus_message[] = "Required. Name of the frame bus to publish frames to. Consumers read them with "
+                                  "-i shm://<name>.";
+static const char slots_message[] = "Optional. Number of frames kept by the bus for slow consumers. Default is 8.";
+static const char as_fast_as_possible_message[] = "Optional. Publish frames of video files and images as fast as they "
+                                                  "are decoded instead of at the frame rate of the input.";
+
+DEFINE_bool(h, false, help_message);
+DEFINE_string(bus, "", bus_message);
+DEFINE_uint32(slots, 8, slots_message);
+DEFINE_bool(as_fast_as_possible, false, as_fast_as_possible_message);
+
+static void showUsage() {
+    std::cout << std::endl;
+    std::cout << "frame_bus_demo [OPTION]" << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << std::endl;
+    std::cout << "    -h                        " << help_message << std::endl;
+    std::cout << "    -i                        " << input_message << std::endl;
+    std::cout << "    -loop                     " << loop_message << std::endl;
+    std::cout << "    -bus \"<name>\"             " << bus_message << std::endl;
+    std::cout << "    -slots \"<integer>\"        " << slots_message << std::endl;
+    std::cout << "    -as_fast_as_possible      " << as_fast_as_possible_message << std::endl;
+}
+
+bool ParseAndCheckCommandLine(int argc, char* argv[]) {
+    gflags::ParseCommandLineNonHelpFlags(&argc, &argv, true);
+    if (FLAGS_h) {
+        showUsage();
+        return false;
+    }
+    if (FLAGS_i.empty()) {
+        throw std::logic_error("Parameter -i is not set");
+    }
+    if (FLAGS_bus.empty()) {
+        throw std::logic_error("Parameter -bus is not set");
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        if (!ParseAndCheckCommandLine(argc, argv)) {
+            return 0;
+        }
+
+        // Frames are copied into the bus right away, so the capture may reuse its buffers
+        std::unique_ptr<ImagesCapture> cap = openImagesCapture(FLAGS_i, FLAGS_loop, read_type::efficient);
+        cv::Mat frame = cap->read();
+        if (frame.empty()) {
+            throw std::runtime_error("Can't read an image from " + FLAGS_i);
+        }
+        const double fps = cap->fps() > 0 ? cap->fps() : 30;
+        FrameBusWriter bus(FLAGS_bus, frame.size(), frame.type(), FLAGS_slots, fps);
+        slog::info << "Publishing " << frame.cols << "x" << frame.rows << " frames of " << FLAGS_i << " to shm://"
+                   << FLAGS_bus << slog::endl;
+
+        // Cameras deliver frames in real time, other inputs are paced to their frame rate unless asked otherwise
+        const bool isPaced = !FLAGS_as_fast_as_possible && cap->getType() != "CAMERA";
+        const auto framePeriod = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(1.0 / fps));
+        auto nextPublishTime = std::chrono::steady_clock::now();
+        PerformanceMetrics metrics;
+        uint64_t framesNum = 0;
+        do {
+            if (isPaced) {
+                std::this_thread::sleep_until(nextPublishTime);
+                nextPublishTime += framePeriod;
+            }
+            const auto startTime = std::chrono::steady_clock::now();
+            bus.publish(frame);
+            metrics.update(startTime);
+            ++framesNum;
+        } while (cap->readInto(frame));
+
+        slog::info << "Published " << framesNum << " frames" << slog::endl;
+        slog::info << "Metrics report:" << slog::endl;
+        metrics.logTotal();
+        slog::info << "\tDecoding:\t" << std::fixed << std::setprecision(1) << cap->getMetrics().getTotal().latency
+                   << " ms" << slog::endl;
+    } catch (const std::exception& error) {
+        slog::err << error.what() << slog::endl;
+        return 1;
+    } catch (...) {
+        slog::err << "Unknown/internal exception happened." << slog::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,16 +1,27 @@
-// Copyright (C) 2018 Intel Corporation
+// Copyright (C) 2018-2022 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
 //
 
 #pragma once
 
+#include <vector>
+
 #include "face_inference_results.hpp"
 
 namespace gaze_estimation {
 class BaseEstimator {
 public:
-    void virtual estimate(const cv::Mat& image,
-                          FaceInferenceResults& outputResults) = 0;
+    // Starts asynchronous inference for all faces of the image, using one infer request per network input.
+    // Results that do not need inference, like the eye bounding boxes, may be written right away
+    void virtual submit(const cv::Mat& image,
+                        std::vector<FaceInferenceResults>& inferenceResults) = 0;
+    // Waits for the requests started by submit() and writes their results
+    void virtual wait(std::vector<FaceInferenceResults>& outputResults) = 0;
+
+    void estimate(const cv::Mat& image, std::vector<FaceInferenceResults>& outputResults) {
+        submit(image, outputResults);
+        wait(outputResults);
+    }
     virtual ~BaseEstimator() = default;
 };
 }  // namespace gaze_estimation
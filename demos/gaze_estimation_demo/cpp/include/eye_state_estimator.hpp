@@ -6,6 +6,7 @@
 
 #include <cstdio>
 #include <string>
+#include <vector>
 
 #include "base_estimator.hpp"
 
@@ -17,8 +18,10 @@ class EyeStateEstimator: public BaseEstimator {
 public:
     EyeStateEstimator(ov::Core& core,
                       const std::string& modelPath,
-                      const std::string& deviceName);
-    void estimate(const cv::Mat& image, FaceInferenceResults& outputResults) override;
+                      const std::string& deviceName,
+                      const ov::AnyMap& compileConfig = {});
+    void submit(const cv::Mat& image, std::vector<FaceInferenceResults>& inferenceResults) override;
+    void wait(std::vector<FaceInferenceResults>& outputResults) override;
     ~EyeStateEstimator() override;
 
     const std::string modelType = "Eye State Estimation";
@@ -26,6 +29,8 @@ public:
 private:
     cv::Rect createEyeBoundingBox(const cv::Point2i& p1, const cv::Point2i& p2, float scale = 1.8) const;
     void rotateImageAroundCenter(const cv::Mat& srcImage, cv::Mat& dstImage, float angle) const;
+    void submitEye(const cv::Mat& image, const cv::Rect& eyeBoundingBox, float roll, size_t requestId);
+    bool waitEye(const cv::Rect& eyeBoundingBox, size_t requestId);
 
     IEWrapper ieWrapper;
     std::string inputTensorName, outputTensorName;
@@ -22,6 +22,10 @@ public:
                  double detectionConfidenceThreshold,
                  bool enableReshape);
     std::vector<FaceInferenceResults> detect(const cv::Mat& image);
+    // Starts asynchronous detection, so that the caller can process the previous image meanwhile
+    void submit(const cv::Mat& image);
+    // Waits for the detection started by submit()
+    std::vector<FaceInferenceResults> wait();
     ~FaceDetector();
 
     const std::string modelType = "Face Detection";
@@ -35,6 +39,7 @@ private:
 
     double detectionThreshold;
     bool enableReshape;
+    cv::Size submittedImageSize;
 
     void adjustBoundingBox(cv::Rect& boundingBox) const;
 };
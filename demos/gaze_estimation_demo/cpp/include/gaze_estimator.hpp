@@ -6,6 +6,7 @@
 
 #include <cstdio>
 #include <string>
+#include <vector>
 
 #include "face_inference_results.hpp"
 #include "base_estimator.hpp"
@@ -18,9 +19,11 @@ public:
     GazeEstimator(ov::Core& core,
                   const std::string& modelPath,
                   const std::string& deviceName,
-                  bool doRollAlign = true);
-    void estimate(const cv::Mat& image,
-                  FaceInferenceResults& outputResults) override;
+                  bool doRollAlign = true,
+                  const ov::AnyMap& compileConfig = {});
+    void submit(const cv::Mat& image,
+                std::vector<FaceInferenceResults>& inferenceResults) override;
+    void wait(std::vector<FaceInferenceResults>& outputResults) override;
     ~GazeEstimator() override;
 
     const std::string modelType = "Gaze Estimation";
@@ -6,6 +6,7 @@
 
 #include <cstdio>
 #include <string>
+#include <vector>
 
 #include "face_inference_results.hpp"
 #include "base_estimator.hpp"
@@ -17,9 +18,11 @@ class HeadPoseEstimator: public BaseEstimator {
 public:
     HeadPoseEstimator(ov::Core& core,
                       const std::string& modelPath,
-                      const std::string& deviceName);
-    void estimate(const cv::Mat& image,
-                  FaceInferenceResults& outputResults) override;
+                      const std::string& deviceName,
+                      const ov::AnyMap& compileConfig = {});
+    void submit(const cv::Mat& image,
+                std::vector<FaceInferenceResults>& inferenceResults) override;
+    void wait(std::vector<FaceInferenceResults>& outputResults) override;
     ~HeadPoseEstimator() override;
 
     const std::string modelType = "Head Pose Estimation";
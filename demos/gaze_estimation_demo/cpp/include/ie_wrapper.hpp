@@ -19,14 +19,18 @@ public:
     IEWrapper(ov::Core& core,
               const std::string& modelPath,
               const std::string& modelType,
-              const std::string& deviceName);
+              const std::string& deviceName,
+              const ov::AnyMap& compileConfig = {});
+    // The methods below take the index of the infer request to use. Requests are created on first use
+    // and kept between frames, so that several faces or eyes can be in flight at once.
+
     // For setting input tensors containing images
-    void setInputTensor(const std::string& tensorName, const cv::Mat& image);
+    void setInputTensor(const std::string& tensorName, const cv::Mat& image, size_t requestId = 0);
     // For setting input tensors containing vectors of data
-    void setInputTensor(const std::string& tensorName, const std::vector<float>& data);
+    void setInputTensor(const std::string& tensorName, const std::vector<float>& data, size_t requestId = 0);
 
     // Get output tensor content as a vector given its name
-    void getOutputTensor(const std::string& tensorName, std::vector<float>& output);
+    void getOutputTensor(const std::string& tensorName, std::vector<float>& output, size_t requestId = 0);
 
     const std::map<std::string, ov::Shape>& getInputTensorDimsInfo() const;
     const std::map<std::string, ov::Shape>& getOutputTensorDimsInfo() const;
@@ -38,19 +42,23 @@ public:
 
     void reshape(const std::map<std::string, ov::Shape>& newTensorsDimsInfo);
 
-    void infer();
+    void infer(size_t requestId = 0);
+    void startAsync(size_t requestId);
+    void wait(size_t requestId);
 
 private:
     std::string modelPath;
     std::string modelType;
     std::string deviceName;
     ov::Core core;
+    ov::AnyMap compileConfig;
     std::shared_ptr<ov::Model> model;
     ov::CompiledModel compiled_model;
-    ov::InferRequest infer_request;
+    std::vector<ov::InferRequest> infer_requests;
     std::map<std::string, ov::Shape> input_tensors_dims_info;
     std::map<std::string, ov::Shape> output_tensors_dims_info;
 
     void setExecPart();
+    ov::InferRequest& getRequest(size_t requestId);
 };
 }  // namespace gaze_estimation
@@ -6,6 +6,7 @@
 
 #include <cstdio>
 #include <string>
+#include <vector>
 
 #include "face_inference_results.hpp"
 #include "base_estimator.hpp"
@@ -17,9 +18,11 @@ class LandmarksEstimator: public BaseEstimator {
 public:
     LandmarksEstimator(ov::Core& core,
                        const std::string& modelPath,
-                       const std::string& deviceName);
-    void estimate(const cv::Mat& image,
-                  FaceInferenceResults& outputResults) override;
+                       const std::string& deviceName,
+                       const ov::AnyMap& compileConfig = {});
+    void submit(const cv::Mat& image,
+                std::vector<FaceInferenceResults>& inferenceResults) override;
+    void wait(std::vector<FaceInferenceResults>& outputResults) override;
     ~LandmarksEstimator() override;
 
     const std::string modelType = "Facial Landmarks Estimation";
@@ -28,8 +31,8 @@ private:
     IEWrapper ieWrapper;
     std::string inputTensorName, outputTensorName;
     size_t numberLandmarks;
-    std::vector<cv::Point2i> simplePostprocess(cv::Rect faceBoundingBox, cv::Mat faceCrop);
-    std::vector<cv::Point2i> heatMapPostprocess(cv::Rect faceBoundingBox, cv::Mat faceCrop);
+    std::vector<cv::Point2i> simplePostprocess(cv::Rect faceBoundingBox, size_t requestId);
+    std::vector<cv::Point2i> heatMapPostprocess(cv::Rect faceBoundingBox, size_t requestId);
     std::vector<cv::Mat> split(std::vector<float>& data, const ov::Shape& shape);
     std::vector<cv::Point2f> getMaxPreds(std::vector<cv::Mat> heatMaps);
     int sign(float number);
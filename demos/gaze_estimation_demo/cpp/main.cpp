@@ -89,13 +89,13 @@ int main(int argc, char* argv[]) {
 
         // Set up face detector and estimators
         FaceDetector faceDetector(core, FLAGS_m_fd, FLAGS_d_fd, FLAGS_t, FLAGS_fd_reshape);
-        HeadPoseEstimator headPoseEstimator(core, FLAGS_m_hp, FLAGS_d_hp);
-        LandmarksEstimator landmarksEstimator(core, FLAGS_m_lm, FLAGS_d_lm);
-        EyeStateEstimator eyeStateEstimator(core, FLAGS_m_es, FLAGS_d_es);
-        GazeEstimator gazeEstimator(core, FLAGS_m, FLAGS_d);
+        // The estimators run one request per face (or eye) at once, so they are compiled for throughput
+        const ov::AnyMap perFaceConfig{ov::hint::performance_mode(ov::hint::PerformanceMode::THROUGHPUT)};
+        HeadPoseEstimator headPoseEstimator(core, FLAGS_m_hp, FLAGS_d_hp, perFaceConfig);
+        LandmarksEstimator landmarksEstimator(core, FLAGS_m_lm, FLAGS_d_lm, perFaceConfig);
+        EyeStateEstimator eyeStateEstimator(core, FLAGS_m_es, FLAGS_d_es, perFaceConfig);
+        GazeEstimator gazeEstimator(core, FLAGS_m, FLAGS_d, true, perFaceConfig);
 
-        // Put pointers to all estimators in an array so that they could be processed uniformly in a loop
-        BaseEstimator* estimators[] = {&headPoseEstimator, &landmarksEstimator, &eyeStateEstimator, &gazeEstimator};
         // Each element of the vector contains inference results on one face
         std::vector<FaceInferenceResults> inferenceResults;
         bool flipImage = false;
@@ -104,7 +104,7 @@ int main(int argc, char* argv[]) {
         std::string windowName = "Gaze estimation demo";
 
         std::unique_ptr<ImagesCapture> cap = openImagesCapture(
-            FLAGS_i, FLAGS_loop, read_type::efficient, 0, std::numeric_limits<size_t>::max(), stringToSize(FLAGS_res));
+            FLAGS_i, FLAGS_loop, read_type::safe, 0, std::numeric_limits<size_t>::max(), stringToSize(FLAGS_res));
 
         auto startTime = std::chrono::steady_clock::now();
         cv::Mat frame = cap->read();
@@ -113,17 +113,29 @@ int main(int argc, char* argv[]) {
         cv::Size graphSize{frame.cols / 4, 60};
         Presenter presenter(FLAGS_u, frame.rows - graphSize.height - 10, graphSize);
 
+        // Frames are processed in a pipeline: the detection of a frame is started before the gaze stage of
+        // the previous one, which is why the frames are read safe - the previous frame is still drawn on
+        faceDetector.submit(frame);
         do {
-            if (flipImage) {
-                cv::flip(frame, frame, 1);
-            }
             // Infer results
-            auto inferenceResults = faceDetector.detect(frame);
-            for (auto& inferenceResult : inferenceResults) {
-                for (auto estimator : estimators) {
-                    estimator->estimate(frame, inferenceResult);
+            auto inferenceResults = faceDetector.wait();
+            // Head pose and landmarks only need the face bounding boxes, so they are estimated at the same time
+            headPoseEstimator.submit(frame, inferenceResults);
+            landmarksEstimator.submit(frame, inferenceResults);
+            headPoseEstimator.wait(inferenceResults);
+            landmarksEstimator.wait(inferenceResults);
+            eyeStateEstimator.estimate(frame, inferenceResults);
+            gazeEstimator.submit(frame, inferenceResults);
+
+            auto nextStartTime = std::chrono::steady_clock::now();
+            cv::Mat nextFrame = cap->read();
+            if (nextFrame.data) {
+                if (flipImage) {
+                    cv::flip(nextFrame, nextFrame, 1);
                 }
+                faceDetector.submit(nextFrame);
             }
+            gazeEstimator.wait(inferenceResults);
 
             // Display the results
             for (auto const& inferenceResult : inferenceResults) {
@@ -148,15 +160,19 @@ int main(int argc, char* argv[]) {
                 resultsMarker.toggle(key);
 
                 // Press 'Esc' to quit, 'f' to flip the video horizontally
-                if (key == 27)
+                if (key == 27) {
+                    if (nextFrame.data) {
+                        faceDetector.wait();
+                    }
                     break;
+                }
                 if (key == 'f')
                     flipImage = !flipImage;
                 else
                     presenter.handleKey(key);
             }
-            startTime = std::chrono::steady_clock::now();
-            frame = cap->read();
+            startTime = nextStartTime;
+            frame = nextFrame;
         } while (frame.data);
 
         slog::info << "Metrics report:" << slog::endl;
@@ -10,8 +10,8 @@
 namespace gaze_estimation {
 
 EyeStateEstimator::EyeStateEstimator(
-    ov::Core& ie, const std::string& modelPath, const std::string& deviceName) :
-        ieWrapper(ie, modelPath, modelType, deviceName)
+    ov::Core& ie, const std::string& modelPath, const std::string& deviceName, const ov::AnyMap& compileConfig) :
+        ieWrapper(ie, modelPath, modelType, deviceName, compileConfig)
 {
     inputTensorName = ieWrapper.expectSingleInput();
     ieWrapper.expectImageInput(inputTensorName);
@@ -47,45 +47,50 @@ void EyeStateEstimator::rotateImageAroundCenter(
     cv::warpAffine(srcImage, dstImage, rotMatrix, size, 1, cv::BORDER_REPLICATE);
 }
 
-void EyeStateEstimator::estimate(
-    const cv::Mat& image, FaceInferenceResults& outputResults) {
-    auto roll = outputResults.headPoseAngles.z;
-    std::vector<cv::Point2f> eyeLandmarks = outputResults.getEyeLandmarks();
-
-    outputResults.leftEyeMidpoint = (eyeLandmarks[0] + eyeLandmarks[1]) / 2;
-    auto leftEyeBoundingBox = createEyeBoundingBox(eyeLandmarks[0], eyeLandmarks[1]);
-    outputResults.leftEyeBoundingBox = leftEyeBoundingBox;
-    if (leftEyeBoundingBox.area()) {
-        auto leftEyeImage(cv::Mat(image, leftEyeBoundingBox));
-        cv::Mat leftEyeImageRotated;
-        rotateImageAroundCenter(leftEyeImage, leftEyeImageRotated, roll);
-        leftEyeImage = leftEyeImageRotated;
-        std::vector<float> outputValue;
-        ieWrapper.setInputTensor(inputTensorName, leftEyeImage);
-        ieWrapper.infer();
-        ieWrapper.getOutputTensor(outputTensorName, outputValue);
-        outputResults.leftEyeState = outputValue[0] < outputValue[1];
-    } else {
-        // Landmarks collapsed and the eye takes no area on image, pretend it's closed
-        outputResults.leftEyeState = false;
+void EyeStateEstimator::submitEye(
+    const cv::Mat& image, const cv::Rect& eyeBoundingBox, float roll, size_t requestId) {
+    // Landmarks collapsed and the eye takes no area on image, it is treated as closed in waitEye()
+    if (!eyeBoundingBox.area())
+        return;
+    auto eyeImage(cv::Mat(image, eyeBoundingBox));
+    cv::Mat eyeImageRotated;
+    rotateImageAroundCenter(eyeImage, eyeImageRotated, roll);
+    ieWrapper.setInputTensor(inputTensorName, eyeImageRotated, requestId);
+    ieWrapper.startAsync(requestId);
+}
+
+bool EyeStateEstimator::waitEye(const cv::Rect& eyeBoundingBox, size_t requestId) {
+    if (!eyeBoundingBox.area())
+        return false;
+    std::vector<float> outputValue;
+    ieWrapper.wait(requestId);
+    ieWrapper.getOutputTensor(outputTensorName, outputValue, requestId);
+    return outputValue[0] < outputValue[1];
+}
+
+void EyeStateEstimator::submit(
+    const cv::Mat& image, std::vector<FaceInferenceResults>& inferenceResults) {
+    // Both eyes of all faces go to separate requests: 2 * i for the left eye of face i, 2 * i + 1 for the right one
+    for (size_t i = 0; i < inferenceResults.size(); ++i) {
+        auto& faceResults = inferenceResults[i];
+        auto roll = faceResults.headPoseAngles.z;
+        std::vector<cv::Point2f> eyeLandmarks = faceResults.getEyeLandmarks();
+
+        faceResults.leftEyeMidpoint = (eyeLandmarks[0] + eyeLandmarks[1]) / 2;
+        faceResults.leftEyeBoundingBox = createEyeBoundingBox(eyeLandmarks[0], eyeLandmarks[1]);
+        submitEye(image, faceResults.leftEyeBoundingBox, roll, 2 * i);
+
+        faceResults.rightEyeMidpoint = (eyeLandmarks[2] + eyeLandmarks[3]) / 2;
+        faceResults.rightEyeBoundingBox = createEyeBoundingBox(eyeLandmarks[2], eyeLandmarks[3]);
+        submitEye(image, faceResults.rightEyeBoundingBox, roll, 2 * i + 1);
     }
+}
 
-    outputResults.rightEyeMidpoint = (eyeLandmarks[2] + eyeLandmarks[3]) / 2;
-    auto rightEyeBoundingBox = createEyeBoundingBox(eyeLandmarks[2], eyeLandmarks[3]);
-    outputResults.rightEyeBoundingBox = rightEyeBoundingBox;
-    if (rightEyeBoundingBox.area()) {
-        auto rightEyeImage(cv::Mat(image, rightEyeBoundingBox));
-        cv::Mat rightEyeImageRotated;
-        rotateImageAroundCenter(rightEyeImage, rightEyeImageRotated, roll);
-        rightEyeImage = rightEyeImageRotated;
-        std::vector<float> outputValue;
-        ieWrapper.setInputTensor(inputTensorName, rightEyeImage);
-        ieWrapper.infer();
-        ieWrapper.getOutputTensor(outputTensorName, outputValue);
-        outputResults.rightEyeState = outputValue[0] < outputValue[1];
-    } else {
-        // Landmarks collapsed and the eye takes no area on image, pretend it's closed
-        outputResults.rightEyeState = false;
+void EyeStateEstimator::wait(std::vector<FaceInferenceResults>& outputResults) {
+    for (size_t i = 0; i < outputResults.size(); ++i) {
+        auto& faceResults = outputResults[i];
+        faceResults.leftEyeState = waitEye(faceResults.leftEyeBoundingBox, 2 * i);
+        faceResults.rightEyeState = waitEye(faceResults.rightEyeBoundingBox, 2 * i + 1);
     }
 }
 
@@ -60,8 +60,11 @@ void FaceDetector::adjustBoundingBox(cv::Rect& boundingBox) const {
 }
 
 std::vector<FaceInferenceResults> FaceDetector::detect(const cv::Mat& image) {
-    std::vector<FaceInferenceResults> detectionResult;
+    submit(image);
+    return wait();
+}
 
+void FaceDetector::submit(const cv::Mat& image) {
     if (enableReshape) {
         double imageAspectRatio = std::round(100. * image.cols / image.rows) / 100.;
         double networkAspectRatio = std::round(100. * inputTensorDims[3] / inputTensorDims[2]) / 100.;
@@ -77,14 +80,20 @@ std::vector<FaceInferenceResults> FaceDetector::detect(const cv::Mat& image) {
     }
 
     ieWrapper.setInputTensor(inputTensorName, image);
-    ieWrapper.infer();
+    ieWrapper.startAsync(0);
+    submittedImageSize = image.size();
+}
+
+std::vector<FaceInferenceResults> FaceDetector::wait() {
+    std::vector<FaceInferenceResults> detectionResult;
 
+    ieWrapper.wait(0);
     std::vector<float> rawDetectionResults;
     ieWrapper.getOutputTensor(outputTensorName, rawDetectionResults);
     FaceInferenceResults tmp;
 
-    cv::Size imageSize(image.size());
-    cv::Rect imageRect(0, 0, image.cols, image.rows);
+    cv::Size imageSize(submittedImageSize);
+    cv::Rect imageRect(0, 0, imageSize.width, imageSize.height);
 
     for (unsigned long detectionID = 0; detectionID < numTotalDetections; ++detectionID) {
         float confidence = rawDetectionResults[detectionID * 7 + 2];
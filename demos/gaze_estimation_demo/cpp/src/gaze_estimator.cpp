@@ -15,8 +15,9 @@ const char TENSOR_LEFT_EYE_IMAGE[] = "left_eye_image";
 const char TENSOR_RIGHT_EYE_IMAGE[] = "right_eye_image";
 
 GazeEstimator::GazeEstimator(
-    ov::Core& ie, const std::string& modelPath, const std::string& deviceName, bool doRollAlign) :
-        ieWrapper(ie, modelPath, modelType, deviceName), rollAlign(doRollAlign)
+    ov::Core& ie, const std::string& modelPath, const std::string& deviceName, bool doRollAlign,
+    const ov::AnyMap& compileConfig) :
+        ieWrapper(ie, modelPath, modelType, deviceName, compileConfig), rollAlign(doRollAlign)
 {
     const auto& inputInfo = ieWrapper.getInputTensorDimsInfo();
 
@@ -58,57 +59,70 @@ void GazeEstimator::rotateImageAroundCenter(const cv::Mat& srcImage, cv::Mat& ds
     cv::warpAffine(srcImage, dstImage, rotMatrix, size, 1, cv::BORDER_REPLICATE);
 }
 
-void GazeEstimator::estimate(const cv::Mat& image, FaceInferenceResults& outputResults) {
-    if (!outputResults.leftEyeState || !outputResults.rightEyeState)
-        return;
-    std::vector<float> headPoseAngles(3);
-    auto roll = outputResults.headPoseAngles.z;
-    headPoseAngles[0] = outputResults.headPoseAngles.x;
-    headPoseAngles[1] = outputResults.headPoseAngles.y;
-    headPoseAngles[2] = roll;
-
-    cv::Mat leftEyeImage(image, outputResults.leftEyeBoundingBox);
-    cv::Mat rightEyeImage(image, outputResults.rightEyeBoundingBox);
-
-    if (rollAlign) {
-        headPoseAngles[2] = 0;
-        cv::Mat leftEyeImageRotated, rightEyeImageRotated;
-        rotateImageAroundCenter(leftEyeImage, leftEyeImageRotated, roll);
-        rotateImageAroundCenter(rightEyeImage, rightEyeImageRotated, roll);
-        leftEyeImage = leftEyeImageRotated;
-        rightEyeImage = rightEyeImageRotated;
-    }
+void GazeEstimator::submit(const cv::Mat& image, std::vector<FaceInferenceResults>& inferenceResults) {
+    for (size_t i = 0; i < inferenceResults.size(); ++i) {
+        const auto& faceResults = inferenceResults[i];
+        if (!faceResults.leftEyeState || !faceResults.rightEyeState)
+            continue;
+        std::vector<float> headPoseAngles(3);
+        auto roll = faceResults.headPoseAngles.z;
+        headPoseAngles[0] = faceResults.headPoseAngles.x;
+        headPoseAngles[1] = faceResults.headPoseAngles.y;
+        headPoseAngles[2] = roll;
+
+        cv::Mat leftEyeImage(image, faceResults.leftEyeBoundingBox);
+        cv::Mat rightEyeImage(image, faceResults.rightEyeBoundingBox);
+
+        if (rollAlign) {
+            headPoseAngles[2] = 0;
+            cv::Mat leftEyeImageRotated, rightEyeImageRotated;
+            rotateImageAroundCenter(leftEyeImage, leftEyeImageRotated, roll);
+            rotateImageAroundCenter(rightEyeImage, rightEyeImageRotated, roll);
+            leftEyeImage = leftEyeImageRotated;
+            rightEyeImage = rightEyeImageRotated;
+        }
 
-    ieWrapper.setInputTensor(TENSOR_HEAD_POSE_ANGLES, headPoseAngles);
-    ieWrapper.setInputTensor(TENSOR_LEFT_EYE_IMAGE, leftEyeImage);
-    ieWrapper.setInputTensor(TENSOR_RIGHT_EYE_IMAGE, rightEyeImage);
+        ieWrapper.setInputTensor(TENSOR_HEAD_POSE_ANGLES, headPoseAngles, i);
+        ieWrapper.setInputTensor(TENSOR_LEFT_EYE_IMAGE, leftEyeImage, i);
+        ieWrapper.setInputTensor(TENSOR_RIGHT_EYE_IMAGE, rightEyeImage, i);
 
-    ieWrapper.infer();
+        ieWrapper.startAsync(i);
+    }
+}
 
+void GazeEstimator::wait(std::vector<FaceInferenceResults>& outputResults) {
     std::vector<float> rawResults;
 
-    ieWrapper.getOutputTensor(outputTensorName, rawResults);
+    for (size_t i = 0; i < outputResults.size(); ++i) {
+        auto& faceResults = outputResults[i];
+        if (!faceResults.leftEyeState || !faceResults.rightEyeState)
+            continue;
 
-    cv::Point3f gazeVector;
-    gazeVector.x = rawResults[0];
-    gazeVector.y = rawResults[1];
-    gazeVector.z = rawResults[2];
+        ieWrapper.wait(i);
+        ieWrapper.getOutputTensor(outputTensorName, rawResults, i);
 
-    gazeVector = gazeVector / cv::norm(gazeVector);
+        cv::Point3f gazeVector;
+        gazeVector.x = rawResults[0];
+        gazeVector.y = rawResults[1];
+        gazeVector.z = rawResults[2];
 
-    if (rollAlign) {
-        // rotate gaze vector to compensate for the alignment
-        float cs = static_cast<float>(std::cos(static_cast<double>(roll) * CV_PI / 180.0));
-        float sn = static_cast<float>(std::sin(static_cast<double>(roll) * CV_PI / 180.0));
+        gazeVector = gazeVector / cv::norm(gazeVector);
 
-        auto tmpX = gazeVector.x * cs + gazeVector.y * sn;
-        auto tmpY = -gazeVector.x * sn + gazeVector.y * cs;
+        if (rollAlign) {
+            // rotate gaze vector to compensate for the alignment
+            auto roll = faceResults.headPoseAngles.z;
+            float cs = static_cast<float>(std::cos(static_cast<double>(roll) * CV_PI / 180.0));
+            float sn = static_cast<float>(std::sin(static_cast<double>(roll) * CV_PI / 180.0));
 
-        gazeVector.x = tmpX;
-        gazeVector.y = tmpY;
-    }
+            auto tmpX = gazeVector.x * cs + gazeVector.y * sn;
+            auto tmpY = -gazeVector.x * sn + gazeVector.y * cs;
+
+            gazeVector.x = tmpX;
+            gazeVector.y = tmpY;
+        }
 
-    outputResults.gazeVector = gazeVector;
+        faceResults.gazeVector = gazeVector;
+    }
 }
 
 GazeEstimator::~GazeEstimator() {
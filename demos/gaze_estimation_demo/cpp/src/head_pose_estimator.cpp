@@ -16,8 +16,8 @@ const std::pair<const char*, float cv::Point3f::*> OUTPUTS[] = {
 };
 
 HeadPoseEstimator::HeadPoseEstimator(
-    ov::Core& ie, const std::string& modelPath, const std::string& deviceName) :
-        ieWrapper(ie, modelPath, modelType, deviceName)
+    ov::Core& ie, const std::string& modelPath, const std::string& deviceName, const ov::AnyMap& compileConfig) :
+        ieWrapper(ie, modelPath, modelType, deviceName, compileConfig)
 {
     inputTensorName = ieWrapper.expectSingleInput();
     ieWrapper.expectImageInput(inputTensorName);
@@ -39,18 +39,24 @@ HeadPoseEstimator::HeadPoseEstimator(
     }
 }
 
-void HeadPoseEstimator::estimate(const cv::Mat& image, FaceInferenceResults& outputResults) {
-    auto faceBoundingBox = outputResults.faceBoundingBox;
-    auto faceCrop(cv::Mat(image, faceBoundingBox));
+void HeadPoseEstimator::submit(const cv::Mat& image, std::vector<FaceInferenceResults>& inferenceResults) {
+    for (size_t i = 0; i < inferenceResults.size(); ++i) {
+        auto faceCrop(cv::Mat(image, inferenceResults[i].faceBoundingBox));
 
-    ieWrapper.setInputTensor(inputTensorName, faceCrop);
-    ieWrapper.infer();
+        ieWrapper.setInputTensor(inputTensorName, faceCrop, i);
+        ieWrapper.startAsync(i);
+    }
+}
 
+void HeadPoseEstimator::wait(std::vector<FaceInferenceResults>& outputResults) {
     std::vector<float> outputValue;
 
-    for (const auto &output: OUTPUTS) {
-        ieWrapper.getOutputTensor(output.first, outputValue);
-        outputResults.headPoseAngles.*output.second = outputValue[0];
+    for (size_t i = 0; i < outputResults.size(); ++i) {
+        ieWrapper.wait(i);
+        for (const auto &output: OUTPUTS) {
+            ieWrapper.getOutputTensor(output.first, outputValue, i);
+            outputResults[i].headPoseAngles.*output.second = outputValue[0];
+        }
     }
 }
 
@@ -15,8 +15,9 @@
 namespace gaze_estimation {
 
 IEWrapper::IEWrapper(
-    ov::Core& core, const std::string& modelPath, const std::string& modelType, const std::string& deviceName) :
-        modelPath(modelPath), modelType(modelType), deviceName(deviceName), core(core)
+    ov::Core& core, const std::string& modelPath, const std::string& modelType, const std::string& deviceName,
+    const ov::AnyMap& compileConfig) :
+        modelPath(modelPath), modelType(modelType), deviceName(deviceName), core(core), compileConfig(compileConfig)
 {
     slog::info << "Reading model: " << modelPath << slog::endl;
     model = core.read_model(modelPath);
@@ -57,12 +58,20 @@ void IEWrapper::setExecPart() {
     }
     model = ppp.build();
 
-    compiled_model = core.compile_model(model, deviceName);
+    compiled_model = core.compile_model(model, deviceName, compileConfig);
     logCompiledModelInfo(compiled_model, modelPath, deviceName);
-    infer_request = compiled_model.create_infer_request();
+    infer_requests.clear();
+    infer_requests.push_back(compiled_model.create_infer_request());
 }
 
-void IEWrapper::setInputTensor(const std::string& tensorName, const cv::Mat& image) {
+ov::InferRequest& IEWrapper::getRequest(size_t requestId) {
+    while (infer_requests.size() <= requestId) {
+        infer_requests.push_back(compiled_model.create_infer_request());
+    }
+    return infer_requests[requestId];
+}
+
+void IEWrapper::setInputTensor(const std::string& tensorName, const cv::Mat& image, size_t requestId) {
     auto tensorDims = input_tensors_dims_info[tensorName];
 
     if (tensorDims.size() != 4) {
@@ -73,28 +82,28 @@ void IEWrapper::setInputTensor(const std::string& tensorName, const cv::Mat& ima
     cv::Mat resizedImage;
     cv::resize(image, resizedImage, scaledSize, 0, 0, cv::INTER_CUBIC);
 
-    ov::Tensor input_tensor = infer_request.get_tensor(tensorName);
+    ov::Tensor input_tensor = getRequest(requestId).get_tensor(tensorName);
     matToTensor(resizedImage, input_tensor);
 }
 
-void IEWrapper::setInputTensor(const std::string& tensorName, const std::vector<float>& data) {
+void IEWrapper::setInputTensor(const std::string& tensorName, const std::vector<float>& data, size_t requestId) {
     auto tensorDims = input_tensors_dims_info[tensorName];
     size_t dimsProduct = std::accumulate(tensorDims.begin(), tensorDims.end(), 1, std::multiplies<size_t>());
     if (dimsProduct != data.size()) {
         throw std::runtime_error("Input data does not match size of the tensor");
     }
 
-    float* buffer = infer_request.get_tensor(tensorName).data<float>();
+    float* buffer = getRequest(requestId).get_tensor(tensorName).data<float>();
     for (size_t i = 0; i < data.size(); ++i) {
         buffer[i] = data[i];
     }
 }
 
-void IEWrapper::getOutputTensor(const std::string& tensorName, std::vector<float>& output) {
+void IEWrapper::getOutputTensor(const std::string& tensorName, std::vector<float>& output, size_t requestId) {
     output.clear();
     auto tensorDims = output_tensors_dims_info[tensorName];
     size_t dataSize = std::accumulate(tensorDims.begin(), tensorDims.end(), 1, std::multiplies<size_t>());
-    float* buffer = infer_request.get_tensor(tensorName).data<float>();
+    float* buffer = getRequest(requestId).get_tensor(tensorName).data<float>();
 
     for (size_t i = 0; i < dataSize; ++i) {
         output.push_back(buffer[i]);
@@ -132,8 +141,16 @@ void IEWrapper::expectImageInput(const std::string& tensorName) const {
     }
 }
 
-void IEWrapper::infer() {
-    infer_request.infer();
+void IEWrapper::infer(size_t requestId) {
+    getRequest(requestId).infer();
+}
+
+void IEWrapper::startAsync(size_t requestId) {
+    getRequest(requestId).start_async();
+}
+
+void IEWrapper::wait(size_t requestId) {
+    getRequest(requestId).wait();
 }
 
 void IEWrapper::reshape(const std::map<std::string, ov::Shape>& newTensorsDimsInfo) {
@@ -10,8 +10,8 @@
 namespace gaze_estimation {
 
 LandmarksEstimator::LandmarksEstimator(
-    ov::Core& ie, const std::string& modelPath, const std::string& deviceName) :
-        ieWrapper(ie, modelPath, modelType, deviceName), numberLandmarks(0) {
+    ov::Core& ie, const std::string& modelPath, const std::string& deviceName, const ov::AnyMap& compileConfig) :
+        ieWrapper(ie, modelPath, modelType, deviceName, compileConfig), numberLandmarks(0) {
     inputTensorName = ieWrapper.expectSingleInput();
     ieWrapper.expectImageInput(inputTensorName);
 
@@ -25,38 +25,43 @@ LandmarksEstimator::LandmarksEstimator(
     }
 }
 
-void LandmarksEstimator::estimate(const cv::Mat& image, FaceInferenceResults& outputResults) {
-    auto faceBoundingBox = outputResults.faceBoundingBox;
-    auto faceCrop(cv::Mat(image, faceBoundingBox));
+void LandmarksEstimator::submit(const cv::Mat& image, std::vector<FaceInferenceResults>& inferenceResults) {
+    for (size_t i = 0; i < inferenceResults.size(); ++i) {
+        auto faceCrop(cv::Mat(image, inferenceResults[i].faceBoundingBox));
 
-    ieWrapper.setInputTensor(inputTensorName, faceCrop);
-    ieWrapper.infer();
+        ieWrapper.setInputTensor(inputTensorName, faceCrop, i);
+        ieWrapper.startAsync(i);
+    }
+}
 
+void LandmarksEstimator::wait(std::vector<FaceInferenceResults>& outputResults) {
     const auto& outputInfo = ieWrapper.getOutputTensorDimsInfo();
     const auto& outputTensorDims = outputInfo.at(outputTensorName);
-    if (outputTensorDims.size() == 2) {
-        outputResults.faceLandmarks=simplePostprocess(faceBoundingBox, faceCrop);
-
-    } else {
-        outputResults.faceLandmarks = heatMapPostprocess(faceBoundingBox, faceCrop);
+    for (size_t i = 0; i < outputResults.size(); ++i) {
+        ieWrapper.wait(i);
+        if (outputTensorDims.size() == 2) {
+            outputResults[i].faceLandmarks = simplePostprocess(outputResults[i].faceBoundingBox, i);
+        } else {
+            outputResults[i].faceLandmarks = heatMapPostprocess(outputResults[i].faceBoundingBox, i);
+        }
     }
 }
 
-std::vector<cv::Point2i> LandmarksEstimator::simplePostprocess(cv::Rect faceBoundingBox, cv::Mat faceCrop) {
+std::vector<cv::Point2i> LandmarksEstimator::simplePostprocess(cv::Rect faceBoundingBox, size_t requestId) {
     std::vector<float> rawLandmarks;
-    ieWrapper.getOutputTensor(outputTensorName, rawLandmarks);
+    ieWrapper.getOutputTensor(outputTensorName, rawLandmarks, requestId);
     std::vector<cv::Point2i> normedLandmarks;
     for (unsigned long i = 0; i < rawLandmarks.size() / 2; ++i) {
-        int x = static_cast<int>(rawLandmarks[2 * i] * faceCrop.cols + faceBoundingBox.tl().x);
-        int y = static_cast<int>(rawLandmarks[2 * i + 1] * faceCrop.rows + faceBoundingBox.tl().y);
+        int x = static_cast<int>(rawLandmarks[2 * i] * faceBoundingBox.width + faceBoundingBox.tl().x);
+        int y = static_cast<int>(rawLandmarks[2 * i + 1] * faceBoundingBox.height + faceBoundingBox.tl().y);
         normedLandmarks.push_back(cv::Point2i(x, y));
     }
     return normedLandmarks;
 }
 
-std::vector<cv::Point2i> LandmarksEstimator::heatMapPostprocess(cv::Rect faceBoundingBox, cv::Mat faceCrop) {
+std::vector<cv::Point2i> LandmarksEstimator::heatMapPostprocess(cv::Rect faceBoundingBox, size_t requestId) {
     std::vector<float> rawLandmarks;
-    ieWrapper.getOutputTensor(outputTensorName, rawLandmarks);
+    ieWrapper.getOutputTensor(outputTensorName, rawLandmarks, requestId);
     const auto& outputInfo = ieWrapper.getOutputTensorDimsInfo();
     const auto& heatMapsDims = outputInfo.at(outputTensorName);
     numberLandmarks = heatMapsDims[1];
@@ -9,9 +9,11 @@
 #include <gflags/gflags.h>
 
 #include <utils/default_flags.hpp>
+#include <utils_gapi/streaming.hpp>
 
 DEFINE_INPUT_FLAGS
 DEFINE_OUTPUT_FLAGS
+DEFINE_STREAMING_FLAGS
 
 static const char help_message[] = "Print a usage message.";
 static const char camera_resolution_message[] = "Optional. Set camera resolution in format WxH.";
@@ -49,6 +51,9 @@ static const char thresh_output_message[] =
 static const char raw_output_message[] = "Optional. Output inference results as raw values.";
 static const char fd_reshape_message[] = "Optional. Reshape Face Detector network so that its input resolution has the "
                                          "same aspect ratio as the input frame.";
+static const char desync_message[] = "Optional. Run the networks desynchronized from the frames: every frame is shown "
+                                     "with the latest results available, the networks skip the frames coming while "
+                                     "they are busy. -latest has no effect in this mode.";
 static const char no_show_message[] = "Optional. Don't show output.";
 static const char utilization_monitors_message[] = "Optional. List of monitors to show initially.";
 
@@ -67,6 +72,7 @@ DEFINE_string(d_es, "CPU", target_device_message_es);
 DEFINE_bool(fd_reshape, false, fd_reshape_message);
 DEFINE_bool(r, false, raw_output_message);
 DEFINE_double(t, 0.5, thresh_output_message);
+DEFINE_bool(desync, false, desync_message);
 DEFINE_bool(no_show, false, no_show_message);
 DEFINE_string(u, "", utilization_monitors_message);
 
@@ -96,6 +102,9 @@ static void showUsage() {
     std::cout << "    -d_lm \"<device>\"         " << target_device_message_lm << std::endl;
     std::cout << "    -d_es \"<device>\"         " << target_device_message_es << std::endl;
     std::cout << "    -fd_reshape              " << fd_reshape_message << std::endl;
+    std::cout << "    -qc \"<integer>\"          " << queue_capacity_message << std::endl;
+    std::cout << "    -latest                  " << latest_result_message << std::endl;
+    std::cout << "    -desync                  " << desync_message << std::endl;
     std::cout << "    -no_show                 " << no_show_message << std::endl;
     std::cout << "    -r                       " << raw_output_message << std::endl;
     std::cout << "    -t                       " << thresh_output_message << std::endl;
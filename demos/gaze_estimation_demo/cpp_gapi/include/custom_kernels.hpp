@@ -24,20 +24,6 @@ using GRects = cv::GArray<cv::Rect>;
 using GSize = cv::GOpaque<cv::Size>;
 
 // clang-format off
-G_API_OP(PrepareEyes,
-         <std::tuple<GMats,
-                     GMats>(cv::GMat, GRects, GRects, GMats, cv::Size)>,
-         "custom.gapi.prepareEyes") {
-    static std::tuple<cv::GArrayDesc, cv::GArrayDesc> outMeta(const cv::GMatDesc&,
-                                                              const cv::GArrayDesc&,
-                                                              const cv::GArrayDesc&,
-                                                              const cv::GArrayDesc&,
-                                                              const cv::Size&) {
-        return std::make_tuple(cv::empty_array_desc(),
-                               cv::empty_array_desc());
-    }
-};
-
 G_API_OP(ParseSSD,
          <std::tuple<GRects, cv::GArray<float>>(cv::GMat, GSize, float)>,
          "custom.gaze_estimation.parseSSD") {
@@ -49,56 +35,63 @@ G_API_OP(ParseSSD,
     }
 };
 
-G_API_OP(ProcessPoses,
-         <std::tuple<cv::GArray<cv::Point3f>, GMats>(GMats, GMats, GMats)>,
-         "custom.gaze_estimation.processPoses") {
-    static std::tuple<cv::GArrayDesc, cv::GArrayDesc> outMeta(const cv::GArrayDesc&,
-                                                              const cv::GArrayDesc&,
-                                                              const cv::GArrayDesc&) {
-        return std::make_tuple(cv::empty_array_desc(),
-                               cv::empty_array_desc());
-    }
-};
-
-G_API_OP(ProcessEyes,
-         <std::tuple<cv::GArray<int>,
-                     cv::GArray<int>>(cv::GMat, GMats, GMats)>,
-         "custom.gaze_estimation.processEyes") {
+/** Parses the head poses and the landmarks of all faces and prepares the inputs of the eye networks.
+ *  Both eyes of all faces are packed into one list for the open-closed-eye network: left eyes go first, then the
+ *  right ones. The input tensors of every kind share a buffer allocated for all faces. **/
+G_API_OP(ProcessFaces,
+         <std::tuple<cv::GArray<cv::Point3f>,
+                     GMats,
+                     GRects,
+                     GRects,
+                     cv::GArray<cv::Point2f>,
+                     cv::GArray<cv::Point2f>,
+                     cv::GArray<std::vector<cv::Point>>,
+                     GMats,
+                     GMats,
+                     GMats>(cv::GMat, GMats, GMats, GMats, GMats, GRects, cv::Size, cv::Size)>,
+         "custom.gaze_estimation.processFaces") {
     static std::tuple<cv::GArrayDesc,
+                      cv::GArrayDesc,
+                      cv::GArrayDesc,
+                      cv::GArrayDesc,
+                      cv::GArrayDesc,
+                      cv::GArrayDesc,
+                      cv::GArrayDesc,
+                      cv::GArrayDesc,
+                      cv::GArrayDesc,
                       cv::GArrayDesc> outMeta(const cv::GMatDesc&,
                                               const cv::GArrayDesc&,
-                                              const cv::GArrayDesc&) {
+                                              const cv::GArrayDesc&,
+                                              const cv::GArrayDesc&,
+                                              const cv::GArrayDesc&,
+                                              const cv::GArrayDesc&,
+                                              const cv::Size&,
+                                              const cv::Size&) {
         return std::make_tuple(cv::empty_array_desc(),
+                               cv::empty_array_desc(),
+                               cv::empty_array_desc(),
+                               cv::empty_array_desc(),
+                               cv::empty_array_desc(),
+                               cv::empty_array_desc(),
+                               cv::empty_array_desc(),
+                               cv::empty_array_desc(),
+                               cv::empty_array_desc(),
                                cv::empty_array_desc());
     }
 };
 
-G_API_OP(ProcessGazes,
-         <cv::GArray<cv::Point3f>(GMats, GMats)>,
-         "custom.gaze_estimation.processGazes") {
-    static cv::GArrayDesc outMeta(const cv::GArrayDesc&,
-                                  const cv::GArrayDesc&) {
-        return cv::empty_array_desc();
-    }
-};
-
-G_API_OP(ProcessLandmarks,
-         <std::tuple<GRects,
-                     GRects,
-                     cv::GArray<cv::Point2f>,
-                     cv::GArray<cv::Point2f>,
-                     cv::GArray<std::vector<cv::Point>>>(cv::GMat, GMats, GRects)>,
-         "custom.gaze_estimation.processLandmarks") {
+/** Gets the states of the eyes packed by ProcessFaces and the gaze vectors compensated for the head roll **/
+G_API_OP(ProcessEyesAndGazes,
+         <std::tuple<cv::GArray<int>,
+                     cv::GArray<int>,
+                     cv::GArray<cv::Point3f>>(GMats, GMats, cv::GArray<cv::Point3f>)>,
+         "custom.gaze_estimation.processEyesAndGazes") {
     static std::tuple<cv::GArrayDesc,
                       cv::GArrayDesc,
-                      cv::GArrayDesc,
-                      cv::GArrayDesc,
-                      cv::GArrayDesc> outMeta(const cv::GMatDesc&,
+                      cv::GArrayDesc> outMeta(const cv::GArrayDesc&,
                                               const cv::GArrayDesc&,
                                               const cv::GArrayDesc&) {
         return std::make_tuple(cv::empty_array_desc(),
-                               cv::empty_array_desc(),
-                               cv::empty_array_desc(),
                                cv::empty_array_desc(),
                                cv::empty_array_desc());
     }
@@ -35,7 +35,9 @@
 #include <opencv2/gapi/gstreaming.hpp>
 #include <opencv2/gapi/infer.hpp>
 #include <opencv2/gapi/infer/ie.hpp>
+#include <opencv2/gapi/streaming/desync.hpp>
 #include <opencv2/gapi/streaming/format.hpp>
+#include <opencv2/gapi/util/optional.hpp>
 #include <opencv2/highgui.hpp>
 #include <opencv2/imgproc.hpp>
 #include <openvino/openvino.hpp>
@@ -48,6 +50,7 @@
 #include <utils/performance_metrics.hpp>
 #include <utils/slog.hpp>
 #include <utils_gapi/stream_source.hpp>
+#include <utils_gapi/streaming.hpp>
 
 #include "custom_kernels.hpp"
 #include "face_inference_results.hpp"
@@ -102,7 +105,9 @@ int main(int argc, char* argv[]) {
 
         /** ---------------- Main graph of demo ---------------- **/
         /** Graph input **/
-        cv::GMat in;
+        cv::GMat in_frame;
+        /** With -desync the networks take the latest frame when they are free and the frames pass through at once **/
+        cv::GMat in = FLAGS_desync ? cv::gapi::streaming::desync(in_frame) : in_frame;
 
         /** Face detection **/
         cv::GMat faces = cv::gapi::infer<nets::Faces>(in);
@@ -120,52 +125,53 @@ int main(int argc, char* argv[]) {
                  angles_r)  // roll
             = cv::gapi::infer<nets::HeadPose>(faces_rc, in);
 
-        cv::GArray<cv::GMat> heads_pos_without_roll;
-        cv::GArray<cv::Point3f> heads_pos;
-        /** Get heads poses and poses without roll part **/
-        std::tie(heads_pos, heads_pos_without_roll) = custom::ProcessPoses::on(angles_y, angles_p, angles_r);
-
         /** Landmarks detector **/
         cv::GArray<cv::GMat> landmarks = cv::gapi::infer<nets::Landmarks>(faces_rc, in);
+
+        cv::GArray<cv::Point3f> heads_pos;
+        cv::GArray<cv::GMat> heads_pos_without_roll;
         cv::GArray<cv::Rect> left_eyes_rc, right_eyes_rc;
         cv::GArray<cv::Point2f> leftEyeMidpoint, rightEyeMidpoint;
         cv::GArray<std::vector<cv::Point>> faces_landmarks;
-        /** Get information about eyes by landmarks **/
-        std::tie(left_eyes_rc,  // ROIs for left eyes
+        cv::GArray<cv::GMat> state_processed_eyes, left_processed_eyes, right_processed_eyes;
+        /** Get heads poses and eyes of all faces, and prepare the eyes for both networks at once **/
+        std::tie(heads_pos,  // heads poses
+                 heads_pos_without_roll,  // poses without roll part
+                 left_eyes_rc,  // ROIs for left eyes
                  right_eyes_rc,  // ROIs for right eyes
                  leftEyeMidpoint,  // left eyes midpoints
                  rightEyeMidpoint,  // right eyes midpoints
-                 faces_landmarks)  // processed landmarks
-            = custom::ProcessLandmarks::on(in, landmarks, faces_rc);
-
-        /** Prepare eyes for open-closed-eye network **/
-        cv::GArray<cv::GMat> left_processed_eyes, right_processed_eyes;
-        std::tie(left_processed_eyes, right_processed_eyes) =
-            custom::PrepareEyes::on(in, left_eyes_rc, right_eyes_rc, angles_r, cv::Size{32, 32});
-
-        /** Detect states of left eyes **/
-        cv::GArray<cv::GMat> left_state_eyes = cv::gapi::infer2<nets::Eyes>(in, left_processed_eyes);
-        /** Detect states of right eyes **/
-        cv::GArray<cv::GMat> right_state_eyes = cv::gapi::infer2<nets::Eyes>(in, right_processed_eyes);
-        /** Recognize states of eyes **/
-        cv::GArray<int> state_left_eyes, state_right_eyes;
-        std::tie(state_left_eyes,  // open/closed
-                 state_right_eyes)  // 1   /0
-            = custom::ProcessEyes::on(in, left_state_eyes, right_state_eyes);
-
-        /** Prepare eyes for gaze-estimation network **/
-        std::tie(left_processed_eyes, right_processed_eyes) =
-            custom::PrepareEyes::on(in, left_eyes_rc, right_eyes_rc, angles_r, cv::Size{60, 60});
+                 faces_landmarks,  // processed landmarks
+                 state_processed_eyes,  // left eyes, then right eyes for open-closed-eye network
+                 left_processed_eyes,  // left eyes for gaze-estimation network
+                 right_processed_eyes)  // right eyes for gaze-estimation network
+            = custom::ProcessFaces::on(in,
+                                       angles_y,
+                                       angles_p,
+                                       angles_r,
+                                       landmarks,
+                                       faces_rc,
+                                       cv::Size{32, 32},
+                                       cv::Size{60, 60});
+
+        /** Detect states of both eyes of all faces in one list **/
+        cv::GArray<cv::GMat> state_eyes = cv::gapi::infer2<nets::Eyes>(in, state_processed_eyes);
 
         /** Gaze estimation **/
         cv::GArray<cv::GMat> gaze_vectors =
             cv::gapi::infer2<nets::Gaze>(in, left_processed_eyes, right_processed_eyes, heads_pos_without_roll);
-        /** Processing gaze estimation results **/
-        cv::GArray<cv::Point3f> processed_gaze_vectors = custom::ProcessGazes::on(gaze_vectors, angles_r);
+
+        /** Recognize states of eyes and process gaze estimation results **/
+        cv::GArray<int> state_left_eyes, state_right_eyes;
+        cv::GArray<cv::Point3f> processed_gaze_vectors;
+        std::tie(state_left_eyes,  // open/closed
+                 state_right_eyes,  // 1   /0
+                 processed_gaze_vectors)
+            = custom::ProcessEyesAndGazes::on(state_eyes, gaze_vectors, heads_pos);
 
         /** Inputs and outputs of graph **/
-        cv::GComputation graph(cv::GIn(in),
-                               cv::GOut(cv::gapi::copy(in),
+        cv::GComputation graph(cv::GIn(in_frame),
+                               cv::GOut(cv::gapi::copy(in_frame),
                                         faces_conf,
                                         faces_rc,
                                         faces_landmarks,
@@ -260,7 +266,9 @@ int main(int argc, char* argv[]) {
         /** Custom kernels **/
         auto kernels = custom::kernels();
         auto networks = cv::gapi::networks(face_net, head_net, landmarks_net, gaze_net, eyes_net);
-        auto pipeline = graph.compileStreaming(cv::compile_args(networks, kernels));
+        auto compile_args = cv::compile_args(networks, kernels);
+        custom::addQueueCapacity(compile_args, FLAGS_qc);
+        auto pipeline = graph.compileStreaming(std::move(compile_args));
 
         /** Output containers for results **/
         cv::Mat frame;
@@ -271,9 +279,68 @@ int main(int argc, char* argv[]) {
         std::vector<cv::Point3f> out_poses;
         std::vector<int> out_left_state, out_right_state;
         std::vector<cv::Point3f> out_gazes;
+        /** The desynchronized graph gives a frame and the results of the networks apart **/
+        cv::util::optional<cv::Mat> opt_frame;
+        cv::util::optional<std::vector<float>> opt_cofidence;
+        cv::util::optional<std::vector<cv::Rect>> opt_faces, opt_left_eyes, opt_right_eyes;
+        cv::util::optional<std::vector<std::vector<cv::Point>>> opt_landmarks;
+        cv::util::optional<std::vector<cv::Point3f>> opt_poses;
+        cv::util::optional<std::vector<cv::Point2f>> opt_left_midpoint, opt_right_midpoint;
+        cv::util::optional<std::vector<int>> opt_left_state, opt_right_state;
+        cv::util::optional<std::vector<cv::Point3f>> opt_gazes;
+        /** Returns false when the stream is over, newFrame tells if the frame is pulled **/
+        auto pullResults = [&](bool& newFrame) {
+            newFrame = true;
+            if (!FLAGS_desync) {
+                return custom::pull(pipeline,
+                                    cv::gout(frame,
+                                             out_cofidence,
+                                             out_faces,
+                                             out_landmarks,
+                                             out_poses,
+                                             out_left_eyes,
+                                             out_right_eyes,
+                                             out_left_midpoint,
+                                             out_right_midpoint,
+                                             out_left_state,
+                                             out_right_state,
+                                             out_gazes),
+                                    FLAGS_latest);
+            }
+            if (!pipeline.pull(cv::gout(opt_frame,
+                                        opt_cofidence,
+                                        opt_faces,
+                                        opt_landmarks,
+                                        opt_poses,
+                                        opt_left_eyes,
+                                        opt_right_eyes,
+                                        opt_left_midpoint,
+                                        opt_right_midpoint,
+                                        opt_left_state,
+                                        opt_right_state,
+                                        opt_gazes))) {
+                return false;
+            }
+            newFrame = opt_frame.has_value();
+            custom::updateLatest(frame, opt_frame);
+            custom::updateLatest(out_cofidence, opt_cofidence);
+            custom::updateLatest(out_faces, opt_faces);
+            custom::updateLatest(out_landmarks, opt_landmarks);
+            custom::updateLatest(out_poses, opt_poses);
+            custom::updateLatest(out_left_eyes, opt_left_eyes);
+            custom::updateLatest(out_right_eyes, opt_right_eyes);
+            custom::updateLatest(out_left_midpoint, opt_left_midpoint);
+            custom::updateLatest(out_right_midpoint, opt_right_midpoint);
+            custom::updateLatest(out_left_state, opt_left_state);
+            custom::updateLatest(out_right_state, opt_right_state);
+            custom::updateLatest(out_gazes, opt_gazes);
+            return true;
+        };
+
+        LazyVideoWriter videoWriter{FLAGS_o, cap->fps(), FLAGS_limit};
 
         /** ---------------- The execution part ---------------- **/
-        pipeline.setSource<custom::CommonCapSrc>(cap);
+        pipeline.setSource<custom::PrefetchingCapSrc>(cap);
         ResultsMarker resultsMarker(false, false, false, true, true);
         int delay = 1;
         bool flipImage = false;
@@ -282,23 +349,14 @@ int main(int argc, char* argv[]) {
         cv::Size graphSize{static_cast<int>(frame_size.width / 4), 60};
         Presenter presenter(FLAGS_u, frame_size.height - graphSize.height - 10, graphSize);
 
-        LazyVideoWriter videoWriter{FLAGS_o, cap->fps(), FLAGS_limit};
-
         bool isStart = true;
         const auto startTime = std::chrono::steady_clock::now();
         pipeline.start();
-        while (pipeline.pull(cv::gout(frame,
-                                      out_cofidence,
-                                      out_faces,
-                                      out_landmarks,
-                                      out_poses,
-                                      out_left_eyes,
-                                      out_right_eyes,
-                                      out_left_midpoint,
-                                      out_right_midpoint,
-                                      out_left_state,
-                                      out_right_state,
-                                      out_gazes))) {
+        bool newFrame = false;
+        while (pullResults(newFrame)) {
+            if (!newFrame) {
+                continue;
+            }
             /** Results **/
             std::vector<FaceInferenceResults> inferenceResults;
             /** Pack results from graph for universal drawing **/
@@ -8,6 +8,8 @@
 #include <algorithm>
 #include <cmath>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include <opencv2/gapi/cpu/gcpukernel.hpp>
 #include <opencv2/imgproc.hpp>
@@ -15,34 +17,35 @@
 #include "kernel_packages.hpp"
 
 namespace {
-void rotateImageAroundCenter(const cv::Mat& srcImage, const float angle, cv::Mat& dstImage) {
-    const auto width = srcImage.cols;
-    const auto height = srcImage.rows;
+/** Rotates the eye around its center and resizes it to the input of the network in a single warp, then writes it to
+ *  the NCHW tensor of the input **/
+void preprocessing(const cv::Mat& src, const float roll, cv::Mat& dst, cv::Mat& warped, cv::Mat& cvt) {
+    const cv::Size new_size(dst.size[3], dst.size[2]);
+    const cv::Point2f center(static_cast<float>(src.cols / 2), static_cast<float>(src.rows / 2));
+    const cv::Mat rot = cv::getRotationMatrix2D(center, static_cast<double>(roll), 1);
+    const double sx = static_cast<double>(new_size.width) / src.cols;
+    const double sy = static_cast<double>(new_size.height) / src.rows;
+    const cv::Matx23d rot_rsz(sx * rot.at<double>(0, 0),
+                              sx * rot.at<double>(0, 1),
+                              sx * (rot.at<double>(0, 2) + 0.5) - 0.5,
+                              sy * rot.at<double>(1, 0),
+                              sy * rot.at<double>(1, 1),
+                              sy * (rot.at<double>(1, 2) + 0.5) - 0.5);
+    cv::warpAffine(src, warped, rot_rsz, new_size, cv::INTER_LINEAR, cv::BORDER_REPLICATE);
+    warped.convertTo(cvt, CV_32F);  // convert to F32
 
-    const cv::Size size(width, height);
-
-    const cv::Point2f center(static_cast<float>(width / 2), static_cast<float>(height / 2));
-
-    const auto rotMatrix = cv::getRotationMatrix2D(center, static_cast<double>(angle), 1);
-    cv::warpAffine(srcImage, dstImage, rotMatrix, size, 1, cv::BORDER_REPLICATE);
-}
-
-void toCHW(const cv::Mat& src, cv::Mat& dst) {
-    dst.create(cv::Size(src.cols, src.rows * src.channels()), CV_32F);
     std::vector<cv::Mat> planes;
-    for (int i = 0; i < src.channels(); ++i) {
-        planes.push_back(dst.rowRange(i * src.rows, (i + 1) * src.rows));
+    for (int i = 0; i < cvt.channels(); ++i) {
+        planes.emplace_back(new_size, CV_32F, dst.ptr<float>() + i * new_size.area());
     }
-    cv::split(src, planes);
+    cv::split(cvt, planes);  // HWC to CHW
 }
 
-void preprocessing(const cv::Mat& src, const cv::Size& new_size, const float roll, cv::Mat& dst) {
-    cv::Mat rot, cvt, rsz;
-    rotateImageAroundCenter(src, roll, rot);  // rotate
-    cv::resize(rot, rsz, new_size);  // resize
-    rsz.convertTo(cvt, CV_32F);  // convert to F32
-    toCHW(cvt, dst);  // HWC to CHW
-    dst = dst.reshape(1, {1, 3, new_size.height, new_size.width});  // reshape to CNN input
+/** Tensor of the index in the batch of the tensors **/
+cv::Mat batchItem(const cv::Mat& tensors, int idx) {
+    std::vector<cv::Range> ranges(tensors.dims, cv::Range::all());
+    ranges[0] = cv::Range(idx, idx + 1);
+    return tensors(ranges);
 }
 
 void adjustBoundingBox(cv::Rect& boundingBox) {
@@ -83,32 +86,6 @@ cv::Rect createEyeBoundingBox(const cv::Point2i& p1, const cv::Point2i& p2, floa
 }  // anonymous namespace
 
 // clang-format off
-GAPI_OCV_KERNEL(OCVPrepareEyes, custom::PrepareEyes) {
-    static void run(const cv::Mat& in,
-                    const std::vector<cv::Rect>& left_rc,
-                    const std::vector<cv::Rect>& right_rc,
-                    const std::vector<cv::Mat>& rolls,
-                    const cv::Size& new_size,
-                          std::vector<cv::Mat>& left_eyes,
-                          std::vector<cv::Mat>& right_eyes) {
-        left_eyes.clear();
-        right_eyes.clear();
-        const auto size = left_rc.size();
-        for (size_t j = 0; j < size; ++j) {
-            auto roll = rolls.at(j).ptr<float>()[0];
-
-            cv::Mat l_dst, r_dst;
-            auto leftEyeImage(cv::Mat(in, left_rc.at(j)));
-            preprocessing(leftEyeImage, new_size, roll, l_dst);
-            left_eyes.push_back(l_dst);
-
-            auto rightEyeImage(cv::Mat(in, right_rc.at(j)));
-            preprocessing(rightEyeImage, new_size, roll, r_dst);
-            right_eyes.push_back(r_dst);
-        }
-    }
-};
-
 /** FIXME: This kernel should become part of G-API kernels in future **/
 GAPI_OCV_KERNEL(OCVParseSSD, custom::ParseSSD) {
     static void run(const cv::Mat& in_ssd_result,
@@ -158,51 +135,67 @@ GAPI_OCV_KERNEL(OCVParseSSD, custom::ParseSSD) {
     }
 };
 
-GAPI_OCV_KERNEL(OCVProcessPoses, custom::ProcessPoses) {
-    static void run(const std::vector<cv::Mat>& in_ys,
+GAPI_OCV_KERNEL(OCVProcessFaces, custom::ProcessFaces) {
+    static void run(const cv::Mat& in,
+                    const std::vector<cv::Mat>& in_ys,
                     const std::vector<cv::Mat>& in_ps,
                     const std::vector<cv::Mat>& in_rs,
+                    const std::vector<cv::Mat>& landmarks,
+                    const std::vector<cv::Rect>& face_rois,
+                    const cv::Size& state_size,
+                    const cv::Size& gaze_size,
                           std::vector<cv::Point3f>& out_poses,
-                          std::vector<cv::Mat>& out_poses_wr) {
+                          std::vector<cv::Mat>& out_poses_wr,
+                          std::vector<cv::Rect>& left_eyes_rc,
+                          std::vector<cv::Rect>& right_eyes_rc,
+                          std::vector<cv::Point2f>& leftEyeMidpoint,
+                          std::vector<cv::Point2f>& rightEyeMidpoint,
+                          std::vector<std::vector<cv::Point>>& out_lanmarks,
+                          std::vector<cv::Mat>& state_eyes,
+                          std::vector<cv::Mat>& left_gaze_eyes,
+                          std::vector<cv::Mat>& right_gaze_eyes) {
+        out_poses.clear();
+        out_poses_wr.clear();
+        left_eyes_rc.clear();
+        right_eyes_rc.clear();
+        leftEyeMidpoint.clear();
+        rightEyeMidpoint.clear();
+        out_lanmarks.clear();
+        state_eyes.clear();
+        left_gaze_eyes.clear();
+        right_gaze_eyes.clear();
         CV_Assert(in_ys.size() == in_ps.size() && in_ys.size() == in_rs.size());
-        const size_t sz = in_ys.size();
-        for (size_t idx = 0u; idx < sz; ++idx) {
+        CV_Assert(landmarks.size() == face_rois.size() && in_ys.size() == face_rois.size());
+        const int size = static_cast<int>(face_rois.size());
+        if (size == 0) {
+            return;
+        }
+        /** Inputs of the networks for all faces **/
+        cv::Mat poses_wr(size, 3, CV_32FC1);
+        cv::Mat state_tensors(std::vector<int>{2 * size, 3, state_size.height, state_size.width}, CV_32F);
+        cv::Mat left_tensors(std::vector<int>{size, 3, gaze_size.height, gaze_size.width}, CV_32F);
+        cv::Mat right_tensors(std::vector<int>{size, 3, gaze_size.height, gaze_size.width}, CV_32F);
+        cv::Mat warped, cvt;
+        for (int idx = 0; idx < size; ++idx) {
             cv::Point3f pose;
             pose.x = in_ys[idx].ptr<float>()[0];
             pose.y = in_ps[idx].ptr<float>()[0];
             pose.z = in_rs[idx].ptr<float>()[0];
             out_poses.push_back(pose);
 
-            cv::Mat pose_wr(1, 3, CV_32FC1);
-            float* ptr = pose_wr.ptr<float>();
+            float* ptr = poses_wr.ptr<float>(idx);
             ptr[0] = pose.x;
             ptr[1] = pose.y;
             ptr[2] = 0;
-            out_poses_wr.push_back(pose_wr);
-        }
-    }
-};
+            out_poses_wr.push_back(poses_wr.row(idx));
 
-GAPI_OCV_KERNEL(OCVProcessLandmarks, custom::ProcessLandmarks) {
-    static void run(const cv::Mat& in,
-                    const std::vector<cv::Mat>& landmarks,
-                    const std::vector<cv::Rect>& face_rois,
-                          std::vector<cv::Rect>& left_eyes_rc,
-                          std::vector<cv::Rect>& right_eyes_rc,
-                          std::vector<cv::Point2f>& leftEyeMidpoint,
-                          std::vector<cv::Point2f>& rightEyeMidpoint,
-                          std::vector<std::vector<cv::Point>>& out_lanmarks) {
-        CV_Assert(landmarks.size() == face_rois.size());
-        const auto size = landmarks.size();
-        for (size_t idx = 0u; idx < size; ++idx) {
-            const float* rawLandmarks = landmarks.at(idx).ptr<float>();
+            const float* rawLandmarks = landmarks[idx].ptr<float>();
+            const cv::Rect& face_roi = face_rois[idx];
             std::vector<cv::Point2i> faceLandmarks;
-
-            for (unsigned long i = 0; i < landmarks.at(idx).total() / 2; ++i) {
-                const int x = static_cast<int>(rawLandmarks[2 * i] *
-                    face_rois.at(idx).width + face_rois.at(idx).x);
-                const int y = static_cast<int>(rawLandmarks[2 * i + 1] *
-                    face_rois.at(idx).height + face_rois.at(idx).y);
+            faceLandmarks.reserve(landmarks[idx].total() / 2);
+            for (size_t i = 0; i < landmarks[idx].total() / 2; ++i) {
+                const int x = static_cast<int>(rawLandmarks[2 * i] * face_roi.width + face_roi.x);
+                const int y = static_cast<int>(rawLandmarks[2 * i + 1] * face_roi.height + face_roi.y);
                 faceLandmarks.emplace_back(x, y);
             }
             leftEyeMidpoint.push_back((faceLandmarks[0] + faceLandmarks[1]) / 2);
@@ -211,40 +204,44 @@ GAPI_OCV_KERNEL(OCVProcessLandmarks, custom::ProcessLandmarks) {
             rightEyeMidpoint.push_back((faceLandmarks[2] + faceLandmarks[3]) / 2);
             right_eyes_rc.push_back(createEyeBoundingBox(faceLandmarks[2], faceLandmarks[3]));
 
-            out_lanmarks.push_back(faceLandmarks);
-        }
-    }
-};
+            out_lanmarks.push_back(std::move(faceLandmarks));
 
-GAPI_OCV_KERNEL(OCVProcessEyes, custom::ProcessEyes) {
-    static void run(const cv::Mat& in,
-                    const std::vector<cv::Mat>& left_eyes_state,
-                    const std::vector<cv::Mat>& right_eyes_state,
-                          std::vector<int>& left_states,
-                          std::vector<int>& right_states) {
-        CV_Assert(left_eyes_state.size() == right_eyes_state.size());
-        for (const auto& state : left_eyes_state) {
-            const auto left_outputValue = state.ptr<float>();
-            const auto left = left_outputValue[0] < left_outputValue[1] ? 1 : 0;
-            left_states.push_back(left);
+            const cv::Mat leftEyeImage(in, left_eyes_rc.back());
+            const cv::Mat rightEyeImage(in, right_eyes_rc.back());
+            state_eyes.push_back(batchItem(state_tensors, idx));
+            preprocessing(leftEyeImage, pose.z, state_eyes.back(), warped, cvt);
+            left_gaze_eyes.push_back(batchItem(left_tensors, idx));
+            preprocessing(leftEyeImage, pose.z, left_gaze_eyes.back(), warped, cvt);
+            right_gaze_eyes.push_back(batchItem(right_tensors, idx));
+            preprocessing(rightEyeImage, pose.z, right_gaze_eyes.back(), warped, cvt);
         }
-
-        for (const auto& state : right_eyes_state) {
-            const auto right_outputValue = state.ptr<float>();
-            const auto right = right_outputValue[0] < right_outputValue[1] ? 1 : 0;
-            right_states.push_back(right);
+        /** Right eyes go after all left ones **/
+        for (int idx = 0; idx < size; ++idx) {
+            state_eyes.push_back(batchItem(state_tensors, size + idx));
+            preprocessing(cv::Mat(in, right_eyes_rc[idx]), out_poses[idx].z, state_eyes.back(), warped, cvt);
         }
     }
 };
 
-GAPI_OCV_KERNEL(OCVProcessGazes, custom::ProcessGazes) {
-    static void run(const std::vector<cv::Mat>& gaze_vectors,
-                    const std::vector<cv::Mat>& rolls,
+GAPI_OCV_KERNEL(OCVProcessEyesAndGazes, custom::ProcessEyesAndGazes) {
+    static void run(const std::vector<cv::Mat>& eyes_state,
+                    const std::vector<cv::Mat>& gaze_vectors,
+                    const std::vector<cv::Point3f>& heads_pos,
+                          std::vector<int>& left_states,
+                          std::vector<int>& right_states,
                           std::vector<cv::Point3f>& out_gazes) {
-        CV_Assert(gaze_vectors.size() == rolls.size());
+        left_states.clear();
+        right_states.clear();
+        out_gazes.clear();
+        CV_Assert(gaze_vectors.size() == heads_pos.size() && eyes_state.size() == 2 * heads_pos.size());
         const auto size = gaze_vectors.size();
         for (size_t i = 0; i < size; ++i) {
-            const auto rawResults = gaze_vectors.at(i).ptr<float>();
+            const float* left_outputValue = eyes_state[i].ptr<float>();
+            left_states.push_back(left_outputValue[0] < left_outputValue[1] ? 1 : 0);
+            const float* right_outputValue = eyes_state[size + i].ptr<float>();
+            right_states.push_back(right_outputValue[0] < right_outputValue[1] ? 1 : 0);
+
+            const auto rawResults = gaze_vectors[i].ptr<float>();
             cv::Point3f gazeVector;
             gazeVector.x = rawResults[0];
             gazeVector.y = rawResults[1];
@@ -253,7 +250,7 @@ GAPI_OCV_KERNEL(OCVProcessGazes, custom::ProcessGazes) {
             gazeVector = gazeVector / cv::norm(gazeVector);
 
             /** rotate gaze vector to compensate for the alignment **/
-            auto roll = rolls.at(i).ptr<float>()[0];
+            const float roll = heads_pos[i].z;
             float cs = static_cast<float>(std::cos(static_cast<double>(roll) * CV_PI / 180.0));
             float sn = static_cast<float>(std::sin(static_cast<double>(roll) * CV_PI / 180.0));
             auto tmpX = gazeVector.x * cs + gazeVector.y * sn;
@@ -268,6 +265,5 @@ GAPI_OCV_KERNEL(OCVProcessGazes, custom::ProcessGazes) {
 // clang-format on
 
 cv::gapi::GKernelPackage custom::kernels() {
-    return cv::gapi::
-        kernels<OCVPrepareEyes, OCVParseSSD, OCVProcessLandmarks, OCVProcessEyes, OCVProcessGazes, OCVProcessPoses>();
+    return cv::gapi::kernels<OCVParseSSD, OCVProcessFaces, OCVProcessEyesAndGazes>();
 }
@@ -9,9 +9,11 @@
 #include <gflags/gflags.h>
 
 #include <utils/default_flags.hpp>
+#include <utils_gapi/streaming.hpp>
 
 DEFINE_INPUT_FLAGS
 DEFINE_OUTPUT_FLAGS
+DEFINE_STREAMING_FLAGS
 
 static const char help_message[] = "Print a usage message.";
 static const char camera_resolution_message[] = "Optional. Set camera resolution in format WxH.";
@@ -63,6 +65,8 @@ static void showUsage() {
     std::cout << "    -m_a \"<path>\"            " << action_recognition_model_message << std::endl;
     std::cout << "    -d_d \"<device>\"          " << target_device_message_d << std::endl;
     std::cout << "    -d_a \"<device>\"          " << target_device_message_a << std::endl;
+    std::cout << "    -qc \"<integer>\"          " << queue_capacity_message << std::endl;
+    std::cout << "    -latest                  " << latest_result_message << std::endl;
     std::cout << "    -no_show                 " << no_show_message << std::endl;
     std::cout << "    -c                       " << class_map_message << std::endl;
     std::cout << "    -s                       " << samples_dir_message << std::endl;
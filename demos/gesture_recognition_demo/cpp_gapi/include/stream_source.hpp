@@ -19,6 +19,9 @@
 namespace custom {
 class BatchProducer {
 public:
+    /** Positions of the fields in the batch description, the last Mat of the batch **/
+    enum BatchInfo { FIRST_ELEMENT = 0, IS_FILLED, FRAMES_ADDED, BATCH_INFO_SIZE };
+
     BatchProducer(const int batch_size, const float batch_fps, const std::shared_ptr<bool>& drop_batch)
         : batch_fps(batch_fps),
           drop_batch(drop_batch) {
@@ -28,34 +31,44 @@ public:
          **/
         batch =
             std::vector<cv::Mat>(batch_size + 1 + 1);  // 16(8) 15FPS-batch imgaes + one fast image +  batch description
-        batch[batch_size + 1].create(cv::Size{1, 2},
-                                     CV_8U);  // 1x2 Mat for first element position and is_filled batch state
-        auto ptr = batch[batch.size() - 1].ptr<uint8_t>();
-        ptr[1] = 0;  // set is_filled to NO
+        batch[batch_size + 1] = cv::Mat::zeros(cv::Size{BATCH_INFO_SIZE, 1}, CV_32S);  // is_filled is NO
     }
     std::vector<cv::Mat> getBatch() {
-        batch_lock.lock();
+        /** Frames are never overwritten in place, so copying of the headers is enough for them.
+         *  The description is the only Mat which is updated **/
+        std::lock_guard<std::mutex> lock(batch_lock);
         std::vector<cv::Mat> temp_batch = batch;
-        batch_lock.unlock();
+        temp_batch.back() = batch.back().clone();
         return temp_batch;
     }
 
     void fillFastFrame(const cv::Mat& frame) {
-        /** Copy fast frame from VideoCapture to batch memory as 17th (9) image **/
-        frame.copyTo(batch[batch.size() - 2]);  // 16th (from 0)
+        /** Put fast frame from VideoCapture to batch as 17th (9) image, the caller doesn't reuse it **/
+        std::lock_guard<std::mutex> lock(batch_lock);
+        batch[batch.size() - 2] = frame;  // 16th (from 0)
     }
 
-    void fillBatch(const cv::Mat& frame, std::chrono::steady_clock::time_point time) {
-        if (*drop_batch) {
-            DropBatchInfo();
+    void fillBatch(const cv::Mat& frame, std::mutex& frame_lock, std::chrono::steady_clock::time_point time) {
+        /** Every read frame is a new Mat, so the batch shares it with the source instead of copying **/
+        cv::Mat new_frame;
+        {
+            std::lock_guard<std::mutex> lock(frame_lock);
+            new_frame = frame;
+        }
+        {
+            std::lock_guard<std::mutex> lock(batch_lock);
+            if (*drop_batch) {
+                DropBatchInfo();
+            }
+            /** Place of new frame in batch **/
+            const int step = updateStep(batch.size() - 2);
+            /** Adding of new image to batch. **/
+            batch[step] = new_frame;
+            /** Putting of info about batch to additional element **/
+            auto ptr = batch[batch.size() - 1].ptr<int>();
+            ptr[FIRST_ELEMENT] = static_cast<int>(first_el);  // position of start of batch in cyclic buffer
+            ptr[FRAMES_ADDED] = ++frames_added;
         }
-        /** Place of new frame in batch **/
-        const int step = updateStep(batch.size() - 2);
-        /** Adding of new image to batch. **/
-        frame.copyTo(batch[step]);
-        /** Putting of info about batch to additional element **/
-        auto ptr = batch[batch.size() - 1].ptr<uint8_t>();
-        ptr[0] = first_el;  // position of start of batch in cyclic buffer
         const auto cur_step = std::chrono::steady_clock::now() - time;
         const auto gap = std::chrono::duration_cast<std::chrono::milliseconds>(cur_step);
         const auto time_step = std::chrono::milliseconds(static_cast<int>(1000.f / batch_fps));  // 1/15 sec
@@ -68,24 +81,24 @@ private:
     float batch_fps = 0;  // constant FPS for batch
     const std::shared_ptr<bool> drop_batch;  // drop parameters of batch
     std::vector<cv::Mat> batch;  // pack of images for graph
-    size_t first_el = 0;  // place of first image in batch
+    size_t first_el = 0;  // place of the oldest image in batch
     size_t images_in_batch_count = 0;  // number of images in batch
-    bool is_filled = false;  // is batch filled
+    int frames_added = 0;  // number of images put to batch, lets the consumer find the new ones
     std::mutex batch_lock;  // batch frames filling will be locked
 
     int updateStep(const size_t batch_size) {
+        auto ptr = batch[batch.size() - 1].ptr<int>();
         if (images_in_batch_count < batch_size) {
             /** case when batch isn't filled **/
-            return images_in_batch_count++;
-        } else {
-            if (!is_filled) {
-                auto ptr = batch[batch.size() - 1].ptr<uint8_t>();
-                ptr[1] = 1;
-                is_filled = true;
+            if (images_in_batch_count + 1 == batch_size) {
+                ptr[IS_FILLED] = 1;
             }
-            /** Cyclic buffer if filled. Counting of step for next image **/
+            return static_cast<int>(images_in_batch_count++);
+        } else {
+            /** Cyclic buffer if filled. The oldest image is replaced and the next one becomes the first **/
+            const size_t step = first_el;
             first_el = (first_el + 1) % batch_size;
-            return first_el;
+            return static_cast<int>(step);
         }
     }
 
@@ -93,21 +106,21 @@ private:
         /** Drop batch information.
          * Processing will continue when the batch will be filled
          * Data of the batch will be overwritten */
-        auto ptr = batch[batch.size() - 1].ptr<uint8_t>();
-        ptr[0] = 0;  // first position
-        ptr[1] = 0;  // batch if filled
+        auto ptr = batch[batch.size() - 1].ptr<int>();
+        ptr[FIRST_ELEMENT] = 0;  // first position
+        ptr[IS_FILLED] = 0;  // batch if filled
         first_el = 0;
         images_in_batch_count = 0;
-        is_filled = false;
     }
 };
 
 static void runBatchFill(const cv::Mat& frame,
+                         std::mutex& frame_lock,
                          BatchProducer& producer,
                          std::chrono::steady_clock::time_point& time,
                          bool& is_filling_possible) {
     while (is_filling_possible) {
-        producer.fillBatch(frame, time);
+        producer.fillBatch(frame, frame_lock, time);
     }
 }
 
@@ -141,10 +154,11 @@ public:
             throw std::runtime_error("Couldn't grab the frame");
         }
         producer.fillFastFrame(fast_frame);
-        fast_frame.copyTo(thread_frame);
+        thread_frame = fast_frame;
         /** Batch filling with constant time step **/
         std::thread fill_bath_thr(runBatchFill,
                                   std::cref(thread_frame),
+                                  std::ref(thread_frame_lock),
                                   std::ref(producer),
                                   std::ref(read_time),
                                   std::ref(is_filling_possible));
@@ -186,7 +200,7 @@ protected:
         }
 
         thread_frame_lock.lock();
-        fast_frame.copyTo(thread_frame);
+        thread_frame = fast_frame;
         thread_frame_lock.unlock();
 
         /** Put fast frame to the batch **/
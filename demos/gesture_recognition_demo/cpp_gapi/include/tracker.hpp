@@ -12,6 +12,7 @@
 #include <vector>
 
 #include <opencv2/core.hpp>
+#include <utils/track_association.hpp>
 
 struct TrackedObject {
     cv::Rect rect;
@@ -131,7 +132,7 @@ struct Track {
 };
 
 ///
-/// \brief Simple Hungarian algorithm-based tracker.
+/// \brief Simple assignment-based tracker.
 ///
 class Tracker {
 public:
@@ -199,20 +200,12 @@ private:
         return active_track_ids_;
     }
 
-    float shapeAffinity(const cv::Rect& trk, const cv::Rect& det);
-    float motionAffinity(const cv::Rect& trk, const cv::Rect& det);
-
     void solveAssignmentProblem(const std::set<size_t>& track_ids,
                                 const TrackedObjects& detections,
                                 std::set<size_t>* unmatched_tracks,
                                 std::set<size_t>* unmatched_detections,
                                 std::set<std::tuple<size_t, size_t, float>>* matches);
 
-    void computeDissimilarityMatrix(const std::set<size_t>& active_track_ids,
-                                    const TrackedObjects& detections,
-                                    cv::Mat* dissimilarity_matrix);
-
-    float distance(const TrackedObject& obj1, const TrackedObject& obj2);
 
     void addNewTrack(const TrackedObject& detection);
 
@@ -245,4 +238,6 @@ private:
     cv::Size frame_size_;
 
     size_t frame_idx_ = 0;
+
+    TrackAssociator associator_;
 };
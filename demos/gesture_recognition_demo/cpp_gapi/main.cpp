@@ -37,6 +37,7 @@
 #include <utils/ocv_common.hpp>
 #include <utils/performance_metrics.hpp>
 #include <utils/slog.hpp>
+#include <utils_gapi/streaming.hpp>
 
 #include "custom_kernels.hpp"
 #include "gesture_recognition_demo_gapi.hpp"
@@ -163,6 +164,7 @@ int main(int argc, char* argv[]) {
         auto kernels = custom::kernels();
         auto networks = cv::gapi::networks(person_detection, action_recognition);
         auto comp = cv::compile_args(kernels, networks);
+        custom::addQueueCapacity(comp, FLAGS_qc);
         auto pipeline = graph.compileStreaming(std::move(comp));
 
         /** Output containers for results **/
@@ -199,7 +201,7 @@ int main(int argc, char* argv[]) {
         bool isStart = true;
         const auto startTime = std::chrono::steady_clock::now();
         pipeline.start();
-        while (pipeline.pull(cv::gout(out_frame, out_detections, out_label_number))) {
+        while (custom::pull(pipeline, cv::gout(out_frame, out_detections, out_label_number), FLAGS_latest)) {
             /** Put FPS to frame**/
             if (isStart) {
                 metrics.update(startTime,
@@ -114,16 +114,25 @@ struct Params {
     cv::Mat current_frame;
     cv::Mat prepared_mat;
     std::atomic<size_t> last_id;
+    int last_frames_added = 0;  // number of frames in the batch when the clip was constructed last time
+    cv::Rect last_roi;  // crop of the frames in the clip
+    bool is_valid = false;  // the clip can be updated only with the new frames
     Params() {}
     Params(const Params& params) {
         current_frame = params.current_frame;
         prepared_mat = params.prepared_mat;
         last_id.fetch_add(params.last_id);
+        last_frames_added = params.last_frames_added;
+        last_roi = params.last_roi;
+        is_valid = params.is_valid;
     }
     Params& operator=(const Params& params) {
         current_frame = params.current_frame;
         prepared_mat = params.prepared_mat;
         last_id.fetch_add(params.last_id);
+        last_frames_added = params.last_frames_added;
+        last_roi = params.last_roi;
+        is_valid = params.is_valid;
         return *this;
     }
 };
@@ -156,46 +165,51 @@ GAPI_OCV_KERNEL_ST(OCVConstructClip, custom::ConstructClip, BatchState::Params)
         const int duration = static_cast<int>(net_size[1]);
         const int height = static_cast<int>(net_size[2]);
         const int width = static_cast<int>(net_size[3]);
-        const auto ptr = batch[batch.size() - 1].ptr<uint8_t>();
+        const int plane_size = height * width;
+        const auto ptr = batch[batch.size() - 1].ptr<int>();
         auto p_pm = state.prepared_mat.ptr<float>();
 
-        if (ptr[1] > 0) {  // is filled and updated
-            int step = ptr[0];  // first
+        if (ptr[1] > 0 && tracked_persons.size() > 0) {  // is filled and there is a person to crop
+            const int first = ptr[0];  // the oldest frame
             size_t& person_id = *current_person_id;
             if (person_id < tracked_persons.size()) {  // wrong number protection
                 state.last_id = person_id;
             }
-            for (int i = 0; i < duration; ++i) {
-                cv::Mat current_frame = batch[step];
-                if (++step > (duration - 1)) {
-                    step = 0;
+            const cv::Rect crop_roi = convert_to_central_roi(tracked_persons.at(state.last_id).rect,
+                                                             cv::Size(height, width),
+                                                             ACTION_IMAGE_SCALE);
+            /** The frames which are in the clip already are only moved, if they are cropped the same way **/
+            int new_frames = duration;
+            if (state.is_valid && crop_roi == state.last_roi) {
+                new_frames = std::min(ptr[2] - state.last_frames_added, duration);  // frames added since the last run
+            }
+            state.last_frames_added = ptr[2];
+            state.last_roi = crop_roi;
+            state.is_valid = true;
+
+            const int kept_frames = duration - new_frames;
+            if (kept_frames > 0 && new_frames > 0) {
+                for (int ch = 0; ch < 3; ++ch) {
+                    float* p_ch = p_pm + ch * duration * plane_size;
+                    std::copy(p_ch + new_frames * plane_size, p_ch + duration * plane_size, p_ch);
                 }
-
-                if (tracked_persons.size() > 0) {
-                    cv::Mat crop, cvt, resized;
-                    cv::Rect roi = tracked_persons.at(state.last_id).rect;
-
-                    crop = current_frame(convert_to_central_roi(roi,
-                                                                cv::Size(height, width),
-                                                                ACTION_IMAGE_SCALE));
-
-                    crop.convertTo(cvt, CV_32F);
-                    cv::resize(cvt, resized, cv::Size{height, width});
-
-                    cv::Mat different_channels[3];
-                    cv::split(resized, different_channels);
-
-                    std::vector<float*> rgb = {different_channels[2].ptr<float>(),
-                                               different_channels[1].ptr<float>(),
-                                               different_channels[0].ptr<float>()};
-
-                    for (int ch = 0; ch < 3; ++ch) {
-                        std::copy(rgb[ch], rgb[ch] + height * width,
-                                  p_pm + ch * duration * height * width
-                                      + i * height * width);
-                    }
+            }
+            cv::Mat crop, cvt, resized;
+            for (int i = kept_frames; i < duration; ++i) {
+                const cv::Mat& current_frame = batch[(first + i) % duration];
+                crop = current_frame(crop_roi);
+                crop.convertTo(cvt, CV_32F);
+                cv::resize(cvt, resized, cv::Size{height, width});
+
+                /** Channels are split right into the planes of the clip in RGB order **/
+                std::vector<cv::Mat> planes;
+                for (int ch = 2; ch >= 0; --ch) {
+                    planes.emplace_back(cv::Size{height, width}, CV_32F, p_pm + (ch * duration + i) * plane_size);
                 }
+                cv::split(resized, planes);
             }
+        } else {
+            state.is_valid = false;
         }
         wrapped_mat.push_back(state.prepared_mat);
     }
@@ -76,6 +76,9 @@ if __name__ == '__main__':
                       type=Path, default=None)
     args.add_argument('--fx', type=np.float32, default=-1, help='Optional. Camera focal length.')
     args.add_argument('--no_show', help='Optional. Do not display output.', action='store_true')
+    args.add_argument('--native_decode', action='store_true',
+                      help='Optional. Find keypoints on feature maps of network output resolution with '
+                           'sub-pixel refinement instead of upsampling them.')
     args.add_argument("-u", "--utilization_monitors", default='', type=str,
                       help="Optional. List of monitors to show initially.")
     args = parser.parse_args()
@@ -131,7 +134,7 @@ if __name__ == '__main__':
             fx = np.float32(0.8 * frame.shape[1])
 
         inference_result = inference_engine.infer(scaled_img)
-        poses_3d, poses_2d = parse_poses(inference_result, input_scale, stride, fx, is_video)
+        poses_3d, poses_2d = parse_poses(inference_result, input_scale, stride, fx, is_video, args.native_decode)
         edges = []
         if len(poses_3d) > 0:
             poses_3d = rotate_poses(poses_3d, R, t)
@@ -34,11 +34,11 @@ limbs = [[18, 17, 1],
          [14, 13, 12]]
 
 
-def get_root_relative_poses(inference_results):
+def get_root_relative_poses(inference_results, native_decode=False):
     features, heatmap, paf_map = inference_results
 
     upsample_ratio = 4
-    found_poses = extract_poses(heatmap[0:-1], paf_map, upsample_ratio)
+    found_poses = extract_poses(heatmap[0:-1], paf_map, upsample_ratio, native_decode)
     # scale coordinates to features space
     found_poses[:, 0:-1:3] /= upsample_ratio
     found_poses[:, 1:-1:3] /= upsample_ratio
@@ -97,10 +97,10 @@ def get_root_relative_poses(inference_results):
 previous_poses_2d = []
 
 
-def parse_poses(inference_results, input_scale, stride, fx, is_video=False):
+def parse_poses(inference_results, input_scale, stride, fx, is_video=False, native_decode=False):
     global previous_poses_2d
     features = inference_results[0]
-    poses_3d, poses_2d = get_root_relative_poses(inference_results)
+    poses_3d, poses_2d = get_root_relative_poses(inference_results, native_decode)
     poses_2d_scaled = []
     for pose_2d in poses_2d:
         num_kpt = (pose_2d.shape[0] - 1) // 3
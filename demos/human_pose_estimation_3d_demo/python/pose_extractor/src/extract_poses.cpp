@@ -18,14 +18,18 @@ static void resizeFeatureMaps(std::vector<cv::Mat>& featureMaps, int upsampleRat
 class FindPeaksBody: public cv::ParallelLoopBody {
 public:
     FindPeaksBody(const std::vector<cv::Mat>& heatMaps, float minPeaksDistance,
-                  std::vector<std::vector<Peak> >& peaksFromHeatMap)
+                  std::vector<std::vector<Peak> >& peaksFromHeatMap, bool refine)
         : heatMaps(heatMaps),
           minPeaksDistance(minPeaksDistance),
-          peaksFromHeatMap(peaksFromHeatMap) {}
+          peaksFromHeatMap(peaksFromHeatMap),
+          refine(refine) {}
 
     virtual void operator()(const cv::Range& range) const {
         for (int i = range.start; i < range.end; i++) {
             findPeaks(heatMaps, minPeaksDistance, peaksFromHeatMap, i);
+            if (refine) {
+                refinePeaks(heatMaps[i], peaksFromHeatMap[i]);
+            }
         }
     }
 
@@ -33,17 +37,23 @@ private:
     const std::vector<cv::Mat>& heatMaps;
     float minPeaksDistance;
     std::vector<std::vector<Peak> >& peaksFromHeatMap;
+    bool refine;
 };
 
 std::vector<HumanPose> extractPoses(
         std::vector<cv::Mat>& heatMaps,
         std::vector<cv::Mat>& pafs,
-        int upsampleRatio) {
-    resizeFeatureMaps(heatMaps, upsampleRatio);
-    resizeFeatureMaps(pafs, upsampleRatio);
-    std::vector<std::vector<Peak> > peaksFromHeatMap(heatMaps.size());
+        int upsampleRatio,
+        bool decodeAtNativeResolution) {
     float minPeaksDistance = 3.0f;
-    FindPeaksBody findPeaksBody(heatMaps, minPeaksDistance, peaksFromHeatMap);
+    if (decodeAtNativeResolution) {
+        minPeaksDistance /= upsampleRatio;
+    } else {
+        resizeFeatureMaps(heatMaps, upsampleRatio);
+        resizeFeatureMaps(pafs, upsampleRatio);
+    }
+    std::vector<std::vector<Peak> > peaksFromHeatMap(heatMaps.size());
+    FindPeaksBody findPeaksBody(heatMaps, minPeaksDistance, peaksFromHeatMap, decodeAtNativeResolution);
     cv::parallel_for_(cv::Range(0, static_cast<int>(heatMaps.size())),
                       findPeaksBody);
     int peaksBefore = 0;
@@ -61,6 +71,17 @@ std::vector<HumanPose> extractPoses(
     std::vector<HumanPose> poses = groupPeaksToPoses(
                 peaksFromHeatMap, pafs, keypointsNumber, midPointsScoreThreshold,
                 foundMidPointsRatioThreshold, minJointsNumber, minSubsetScore);
+    if (decodeAtNativeResolution) {
+        // keypoints are centers of pixels, which are scaled in the same way as cv::resize() scales them
+        for (auto& pose : poses) {
+            for (auto& keypoint : pose.keypoints) {
+                if (keypoint.x != -1.0f) {
+                    keypoint.x *= upsampleRatio;
+                    keypoint.y *= upsampleRatio;
+                }
+            }
+        }
+    }
     return poses;
 }
 } // namespace human_pose_estimation
@@ -9,8 +9,12 @@
 #include "human_pose.hpp"
 
 namespace human_pose_estimation {
+// Keypoints are returned in coordinates of the feature maps upsampled by upsampleRatio. If decodeAtNativeResolution
+// is true, the maps aren't upsampled: peaks and limbs are found on them as is, and the peaks are refined to sub-pixel
+// positions before the keypoints are scaled.
 std::vector<HumanPose> extractPoses(
         std::vector<cv::Mat>& heatMaps,
         std::vector<cv::Mat>& pafs,
-        int upsampleRatio);
+        int upsampleRatio,
+        bool decodeAtNativeResolution = false);
 } // namespace human_pose_estimation
@@ -105,6 +105,28 @@ void findPeaks(const std::vector<cv::Mat>& heatMaps,
     }
 }
 
+namespace {
+// Offset of the vertex of the parabola through (-1, prev), (0, val) and (1, next), it is within 0.5 for a peak
+float parabolaVertexOffset(float prev, float val, float next) {
+    const float curvature = prev - 2 * val + next;
+    return curvature < 0 ? std::max(-0.5f, std::min(0.5f, 0.5f * (prev - next) / curvature)) : 0.0f;
+}
+}  // namespace
+
+void refinePeaks(const cv::Mat& heatMap, std::vector<Peak>& peaks) {
+    for (Peak& peak : peaks) {
+        const int x = static_cast<int>(peak.pos.x);
+        const int y = static_cast<int>(peak.pos.y);
+        const float val = heatMap.at<float>(y, x);
+        if (x > 0 && x < heatMap.cols - 1) {
+            peak.pos.x += parabolaVertexOffset(heatMap.at<float>(y, x - 1), val, heatMap.at<float>(y, x + 1));
+        }
+        if (y > 0 && y < heatMap.rows - 1) {
+            peak.pos.y += parabolaVertexOffset(heatMap.at<float>(y - 1, x), val, heatMap.at<float>(y + 1, x));
+        }
+    }
+}
+
 std::vector<HumanPose> groupPeaksToPoses(const std::vector<std::vector<Peak> >& allPeaks,
                                          const std::vector<cv::Mat>& pafs,
                                          const size_t keypointsNumber,
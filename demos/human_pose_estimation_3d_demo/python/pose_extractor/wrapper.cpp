@@ -34,14 +34,15 @@ static PyObject* extract_poses(PyObject* self, PyObject* args) {
     PyArrayObject* py_heatmaps;
     PyArrayObject* py_pafs;
     int ratio;
-    if (!PyArg_ParseTuple(args, "OOi", &py_heatmaps, &py_pafs, &ratio)) {
+    int native_resolution = 0;
+    if (!PyArg_ParseTuple(args, "OOi|p", &py_heatmaps, &py_pafs, &ratio, &native_resolution)) {
         return nullptr;
     }
     std::vector<cv::Mat> heatmaps = wrap_feature_maps(py_heatmaps);
     std::vector<cv::Mat> pafs = wrap_feature_maps(py_pafs);
 
     std::vector<human_pose_estimation::HumanPose> poses = human_pose_estimation::extractPoses(
-                heatmaps, pafs, ratio);
+                heatmaps, pafs, ratio, native_resolution != 0);
 
     size_t num_persons = poses.size();
     size_t num_keypoints = 0;
@@ -19,6 +19,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <exception>
 #include <iostream>
 #include <iterator>
@@ -36,23 +37,41 @@
 
 #include <models/hpe_model_associative_embedding.h>
 #include <models/hpe_model_openpose.h>
+#include <models/image_model.h>
 #include <models/input_data.h>
 #include <models/model_base.h>
 #include <models/results.h>
 #include <monitors/presenter.h>
 #include <pipelines/async_pipeline.h>
 #include <pipelines/metadata.h>
+#include <pipelines/results_publisher.h>
 #include <utils/common.hpp>
 #include <utils/config_factory.h>
 #include <utils/default_flags.hpp>
+#include <utils/frame_pool.hpp>
 #include <utils/image_utils.h>
 #include <utils/images_capture.h>
+#include <utils/itt.hpp>
+#include <utils/memory_accounting.hpp>
+#include <utils/metrics_sink.hpp>
 #include <utils/ocv_common.hpp>
 #include <utils/performance_metrics.hpp>
+#include <utils/pooled_mat_allocator.hpp>
+#include <utils/render_thread.hpp>
 #include <utils/slog.hpp>
 
 DEFINE_INPUT_FLAGS
 DEFINE_OUTPUT_FLAGS
+DEFINE_OUTPUT_ENCODER_FLAGS
+DEFINE_METRICS_FLAGS
+DEFINE_TUNING_FLAGS
+DEFINE_WARMUP_FLAGS
+DEFINE_LAYERS_PROFILE_FLAGS
+DEFINE_REMOTE_FLAGS
+DEFINE_RESULTS_FLAGS
+DEFINE_MAT_ALLOCATOR_FLAGS
+DEFINE_HALF_PRECISION_OUTPUTS_FLAGS
+DEFINE_DEVICE_PEAKS_FLAGS
 
 static const char help_message[] = "Print a usage message.";
 static const char at_message[] = "Required. Type of the model, either 'ae' for Associative Embedding, 'higherhrnet' "
@@ -75,6 +94,9 @@ static const char num_streams_message[] = "Optional. Number of streams to use fo
                                           "<device1>:<nstreams1>,<device2>:<nstreams2> or just <nstreams>)";
 static const char no_show_message[] = "Optional. Don't show output.";
 static const char utilization_monitors_message[] = "Optional. List of monitors to show initially.";
+static const char native_decode_message[] =
+    "Optional. Decode OpenPose poses on the output feature maps with sub-pixel refinement of keypoints instead of "
+    "upsampling the maps, which is several times faster.";
 static const char output_resolution_message[] =
     "Optional. Specify the maximum output window resolution "
     "in (width x height) format. Example: 1280x720. Input frame size used by default.";
@@ -92,6 +114,7 @@ DEFINE_string(nstreams, "", num_streams_message);
 DEFINE_bool(no_show, false, no_show_message);
 DEFINE_string(u, "", utilization_monitors_message);
 DEFINE_string(output_resolution, "", output_resolution_message);
+DEFINE_bool(native_decode, false, native_decode_message);
 
 /**
  * \brief This function shows a help message
@@ -108,6 +131,7 @@ static void showUsage() {
     std::cout << "    -layout \"<string>\"        " << layout_message << std::endl;
     std::cout << "    -o \"<path>\"               " << output_message << std::endl;
     std::cout << "    -limit \"<num>\"            " << limit_message << std::endl;
+    std::cout << "    -o_encoder \"<string>\"     " << o_encoder_message << std::endl;
     std::cout << "    -tsize                    " << target_size_message << std::endl;
     std::cout << "    -d \"<device>\"             " << target_device_message << std::endl;
     std::cout << "    -t                        " << thresh_output_message << std::endl;
@@ -117,7 +141,20 @@ static void showUsage() {
     std::cout << "    -loop                     " << loop_message << std::endl;
     std::cout << "    -no_show                  " << no_show_message << std::endl;
     std::cout << "    -output_resolution        " << output_resolution_message << std::endl;
+    std::cout << "    -native_decode            " << native_decode_message << std::endl;
     std::cout << "    -u                        " << utilization_monitors_message << std::endl;
+    std::cout << "    -metrics_file \"<path>\"    " << metrics_file_message << std::endl;
+    std::cout << "    -tune \"<objective>\"       " << tune_message << std::endl;
+    std::cout << "    -tune_latency \"<double>\"  " << tune_latency_message << std::endl;
+    std::cout << "    -tune_cache \"<path>\"      " << tune_cache_message << std::endl;
+    std::cout << "    -warmup \"<integer>\"     " << warmup_message << std::endl;
+    std::cout << "    -profile_layers \"<integer>\" " << profile_layers_message << std::endl;
+    std::cout << "    -remote \"<host:port>\"   " << remote_message << std::endl;
+    std::cout << "    -results \"<host:port>\"  " << results_message << std::endl;
+    std::cout << "    -mat_pool \"<MB>\"          " << mat_pool_message << std::endl;
+    std::cout << "    -mat_pool_huge_pages      " << mat_pool_huge_pages_message << std::endl;
+    std::cout << "    -fp16_outputs             " << fp16_outputs_message << std::endl;
+    std::cout << "    -peaks_on_device          " << peaks_on_device_message << std::endl;
 }
 
 bool ParseAndCheckCommandLine(int argc, char* argv[]) {
@@ -147,17 +184,19 @@ bool ParseAndCheckCommandLine(int argc, char* argv[]) {
     return true;
 }
 
-cv::Mat renderHumanPose(HumanPoseResult& result, OutputTransform& outputTransform) {
+// The input image stored inside metadata is resized into outputImg, which is reused by next frames, and the poses are
+// drawn over it in the output coordinates
+cv::Mat renderHumanPose(HumanPoseResult& result, OutputTransform& outputTransform, cv::Mat& outputImg) {
     if (!result.metaData) {
         throw std::invalid_argument("Renderer: metadata is null");
     }
 
-    auto outputImg = result.metaData->asRef<ImageMetaData>().img;
+    const cv::Mat& inputImg = result.metaData->asRef<ImageMetaData>().img;
 
-    if (outputImg.empty()) {
+    if (inputImg.empty()) {
         throw std::invalid_argument("Renderer: image provided in metadata is empty");
     }
-    outputTransform.resize(outputImg);
+    outputTransform.resize(inputImg, outputImg);
     static const cv::Scalar colors[HPEOpenPose::keypointsNumber] = {cv::Scalar(255, 0, 0),
                                                                     cv::Scalar(255, 85, 0),
                                                                     cv::Scalar(255, 170, 0),
@@ -230,8 +269,11 @@ cv::Mat renderHumanPose(HumanPoseResult& result, OutputTransform& outputTransfor
             limbKeypointsIds.insert(limbKeypointsIds.begin(), std::begin(keypointsAE), std::end(keypointsAE));
         }
     }
-    cv::Mat pane = outputImg.clone();
-    for (auto pose : result.poses) {
+    // Limbs are blended with the image only inside the region they cover, the rest of the image wouldn't change
+    std::vector<std::vector<cv::Point>> limbPolygons;
+    std::vector<cv::Scalar> limbColors;
+    cv::Rect limbsRect;
+    for (const auto& pose : result.poses) {
         for (const auto& limbKeypointsId : limbKeypointsIds) {
             std::pair<cv::Point2f, cv::Point2f> limbKeypoints(pose.keypoints[limbKeypointsId.first],
                                                               pose.keypoints[limbKeypointsId.second]);
@@ -246,13 +288,32 @@ cv::Mat renderHumanPose(HumanPoseResult& result, OutputTransform& outputTransfor
             int angle = static_cast<int>(std::atan2(difference.y, difference.x) * 180 / CV_PI);
             std::vector<cv::Point> polygon;
             cv::ellipse2Poly(cv::Point2d(meanX, meanY), cv::Size2d(length / 2, stickWidth), angle, 0, 360, 1, polygon);
-            cv::fillConvexPoly(pane, polygon, colors[limbKeypointsId.second]);
+            limbsRect |= cv::boundingRect(polygon);
+            limbPolygons.push_back(std::move(polygon));
+            limbColors.push_back(colors[limbKeypointsId.second]);
         }
     }
-    cv::addWeighted(outputImg, 0.4, pane, 0.6, 0, outputImg);
+    limbsRect &= cv::Rect(cv::Point(0, 0), outputImg.size());
+    if (limbsRect.empty()) {
+        return outputImg;
+    }
+    cv::Mat limbsImg = outputImg(limbsRect);
+    cv::Mat pane = limbsImg.clone();
+    for (size_t i = 0; i < limbPolygons.size(); ++i) {
+        for (cv::Point& point : limbPolygons[i]) {
+            point -= limbsRect.tl();
+        }
+        cv::fillConvexPoly(pane, limbPolygons[i], limbColors[i]);
+    }
+    cv::addWeighted(limbsImg, 0.4, pane, 0.6, 0, limbsImg);
     return outputImg;
 }
 
+struct RenderItem {
+    std::unique_ptr<ResultBase> result;
+    PerformanceMetrics::Metrics metrics;  ///< metrics at the moment the result was received
+};
+
 int main(int argc, char* argv[]) {
     try {
         PerformanceMetrics metrics, renderMetrics;
@@ -262,12 +323,28 @@ int main(int argc, char* argv[]) {
             return 0;
         }
 
+        // Installed before anything allocates frames, so every frame buffer comes from the pool
+        PooledMatAllocator* matAllocator = nullptr;
+        if (FLAGS_mat_pool > 0) {
+            PooledMatAllocator::Config matAllocatorConfig;
+            matAllocatorConfig.capacity = size_t(FLAGS_mat_pool) << 20;
+            matAllocatorConfig.hugePages = FLAGS_mat_pool_huge_pages;
+            matAllocator = &PooledMatAllocator::install(matAllocatorConfig);
+        }
+
+        // Results are rendered on a separate thread only if they are shown or written
+        const bool needsRendering = !FLAGS_no_show || !FLAGS_o.empty();
+
         //------------------------------- Preparing Input ------------------------------------------------------
-        auto cap = openImagesCapture(FLAGS_i, FLAGS_loop, FLAGS_nireq == 1 ? read_type::efficient : read_type::safe);
+        // Frames are read into buffers leased from framePool, so the capture doesn't need to copy them. The capacity of
+        // the pool is set when the number of infer requests is known.
+        auto cap = openImagesCapture(FLAGS_i, FLAGS_loop, read_type::efficient);
+        FramePool framePool(1);
         auto startTime = std::chrono::steady_clock::now();
-        cv::Mat curr_frame = cap->read();
+        cv::Mat curr_frame = framePool.read(*cap);
 
         LazyVideoWriter videoWriter{FLAGS_o, cap->fps(), FLAGS_limit};
+        videoWriter.setEncoder(LazyVideoWriter::parseEncoder(FLAGS_o_encoder));
 
         OutputTransform outputTransform = OutputTransform();
         cv::Size outputResolution = curr_frame.size();
@@ -284,9 +361,16 @@ int main(int argc, char* argv[]) {
         //----------------------------------------------
 
         double aspectRatio = curr_frame.cols / static_cast<double>(curr_frame.rows);
-        std::unique_ptr<ModelBase> model;
+        std::unique_ptr<ImageModel> model;
         if (FLAGS_at == "openpose") {
-            model.reset(new HPEOpenPose(FLAGS_m, aspectRatio, FLAGS_tsize, static_cast<float>(FLAGS_t), FLAGS_layout));
+            HPEOpenPose* openPose = new HPEOpenPose(FLAGS_m,
+                                                    aspectRatio,
+                                                    FLAGS_tsize,
+                                                    static_cast<float>(FLAGS_t),
+                                                    FLAGS_layout,
+                                                    FLAGS_native_decode);
+            openPose->setHalfPrecisionOutputs(FLAGS_fp16_outputs);
+            model.reset(openPose);
         } else if (FLAGS_at == "ae") {
             model.reset(new HpeAssociativeEmbedding(FLAGS_m,
                                                     aspectRatio,
@@ -306,14 +390,57 @@ int main(int argc, char* argv[]) {
             slog::err << "No model type or invalid model type (-at) provided: " + FLAGS_at << slog::endl;
             return -1;
         }
+        model->setDevicePostprocessing(FLAGS_peaks_on_device);
 
         slog::info << ov::get_openvino_version() << slog::endl;
         ov::Core core;
 
+        ModelConfig config = ConfigFactory::getUserConfig(FLAGS_d, FLAGS_nireq, FLAGS_nstreams, FLAGS_nthreads);
+        config.tuning = ConfigFactory::getTuningConfig(FLAGS_tune, FLAGS_tune_latency, FLAGS_tune_cache);
+        config.warmupInferences = FLAGS_warmup;
+        config.profiledLayers = FLAGS_profile_layers;
+        config.remoteWorker = FLAGS_remote;
         AsyncPipeline pipeline(std::move(model),
-                               ConfigFactory::getUserConfig(FLAGS_d, FLAGS_nireq, FLAGS_nstreams, FLAGS_nthreads),
+                               config,
                                core);
+        // A frame is held by its infer request, by its result waiting for rendering or being rendered, other frames
+        // are read into buffers of their own
+        framePool.setCapacity(pipeline.getRequestsNum() + 4);
         Presenter presenter(FLAGS_u);
+        std::unique_ptr<MetricsSink> metricsSink;
+        if (!FLAGS_metrics_file.empty()) {
+            metricsSink.reset(new MetricsSink(FLAGS_metrics_file));
+        }
+        std::unique_ptr<ResultsPublisher> resultsPublisher;
+        if (!FLAGS_results.empty()) {
+            resultsPublisher.reset(new ResultsPublisher(FLAGS_results));
+        }
+
+        cv::Mat outputBuffer;
+        std::unique_ptr<RenderThread<RenderItem>> renderThread;
+        if (needsRendering) {
+            auto render = [&](RenderItem& item) -> bool {
+                ITT_SCOPED_FRAME_TASK("render", item.result->frameId);
+                cv::Mat outFrame =
+                    renderHumanPose(item.result->asRef<HumanPoseResult>(), outputTransform, outputBuffer);
+                //--- Showing results and device information
+                presenter.drawGraphs(outFrame);
+                PerformanceMetrics::paintMetrics(item.metrics, outFrame, {10, 22}, cv::FONT_HERSHEY_COMPLEX, 0.65);
+                videoWriter.write(outFrame);
+                if (!FLAGS_no_show) {
+                    cv::imshow("Human Pose Estimation Results", outFrame);
+                    //--- Processing keyboard events
+                    int key = cv::waitKey(1);
+                    if (27 == key || 'q' == key || 'Q' == key) {  // Esc
+                        return false;
+                    }
+                    presenter.handleKey(key);
+                }
+                return true;
+            };
+            // Only the latest results are shown, unless every frame is written
+            renderThread.reset(new RenderThread<RenderItem>(render, 2, FLAGS_o.empty()));
+        }
 
         int64_t frameNum =
             pipeline.submitData(ImageInputData(curr_frame), std::make_shared<ImageMetaData>(curr_frame, startTime));
@@ -326,7 +453,7 @@ int main(int argc, char* argv[]) {
             if (pipeline.isReadyToProcess()) {
                 //--- Capturing frame
                 startTime = std::chrono::steady_clock::now();
-                curr_frame = cap->read();
+                curr_frame = framePool.read(*cap);
                 if (curr_frame.empty()) {
                     // Input stream is over
                     break;
@@ -343,28 +470,35 @@ int main(int argc, char* argv[]) {
             //--- If you need just plain data without rendering - cast result's underlying pointer to HumanPoseResult*
             //    and use your own processing instead of calling renderHumanPose().
             while (keepRunning && (result = pipeline.getResult())) {
-                auto renderingStart = std::chrono::steady_clock::now();
-                cv::Mat outFrame = renderHumanPose(result->asRef<HumanPoseResult>(), outputTransform);
-                //--- Showing results and device information
-                presenter.drawGraphs(outFrame);
-                renderMetrics.update(renderingStart);
-                metrics.update(result->metaData->asRef<ImageMetaData>().timeStamp,
-                               outFrame,
-                               {10, 22},
-                               cv::FONT_HERSHEY_COMPLEX,
-                               0.65);
-                videoWriter.write(outFrame);
+                metrics.update(result->metaData->asRef<ImageMetaData>().timeStamp);
                 framesProcessed++;
-                if (!FLAGS_no_show) {
-                    cv::imshow("Human Pose Estimation Results", outFrame);
-                    //--- Processing keyboard events
-                    int key = cv::waitKey(1);
-                    if (27 == key || 'q' == key || 'Q' == key) {  // Esc
-                        keepRunning = false;
-                    } else {
-                        presenter.handleKey(key);
-                    }
+                if (resultsPublisher) {
+                    resultsPublisher->publish(*result);
+                }
+                if (renderThread) {
+                    keepRunning = renderThread->push(RenderItem{std::move(result), metrics.getLast()});
+                }
+            }
+
+            if (metricsSink && metricsSink->isDue()) {
+                if (renderThread) {
+                    renderMetrics = renderThread->getMetrics();
                 }
+                metricsSink->stage("decoding", cap->getMetrics().getLast());
+                pipeline.reportMetrics(*metricsSink);
+                const std::pair<double, double> memSwapUsage = presenter.getLastMemSwapUsage();
+                const std::pair<double, double> gpuUsage = presenter.getLastGpuUsage();
+                const double power = presenter.getLastPower();
+                metricsSink->stage("rendering", renderMetrics.getLast())
+                    .stage("total", metrics.getLast())
+                    .value("cpu_load", presenter.getLastCpuLoad())
+                    .value("memory_gib", memSwapUsage.first)
+                    .value("swap_gib", memSwapUsage.second)
+                    .value("power_w", power)
+                    .value("fps_per_watt", metrics.getLast().fps / power)
+                    .value("gpu_utilization", gpuUsage.first)
+                    .value("gpu_frequency_mhz", gpuUsage.second);
+                metricsSink->publish();
             }
         }
 
@@ -372,33 +506,41 @@ int main(int argc, char* argv[]) {
         pipeline.waitForTotalCompletion();
         for (; framesProcessed <= frameNum; framesProcessed++) {
             while (!(result = pipeline.getResult())) {}
-            auto renderingStart = std::chrono::steady_clock::now();
-            cv::Mat outFrame = renderHumanPose(result->asRef<HumanPoseResult>(), outputTransform);
-            //--- Showing results and device information
-            presenter.drawGraphs(outFrame);
-            renderMetrics.update(renderingStart);
-            metrics.update(result->metaData->asRef<ImageMetaData>().timeStamp,
-                           outFrame,
-                           {10, 22},
-                           cv::FONT_HERSHEY_COMPLEX,
-                           0.65);
-            videoWriter.write(outFrame);
-            if (!FLAGS_no_show) {
-                cv::imshow("Human Pose Estimation Results", outFrame);
-                //--- Updating output window
-                cv::waitKey(1);
+            metrics.update(result->metaData->asRef<ImageMetaData>().timeStamp);
+            if (resultsPublisher) {
+                resultsPublisher->publish(*result);
+            }
+            if (renderThread) {
+                renderThread->push(RenderItem{std::move(result), metrics.getLast()});
+            }
+        }
+        if (renderThread) {
+            renderThread->finish();
+            renderMetrics = renderThread->getMetrics();
+            if (renderThread->getDroppedNum() > 0) {
+                slog::info << "\t" << renderThread->getDroppedNum()
+                           << " results weren't shown to keep up with inference" << slog::endl;
             }
         }
 
         slog::info << "Metrics report:" << slog::endl;
         metrics.logTotal();
-        logLatencyPerStage(cap->getMetrics().getTotal().latency,
-                           pipeline.getPreprocessMetrics().getTotal().latency,
-                           pipeline.getInferenceMetircs().getTotal().latency,
-                           pipeline.getPostprocessMetrics().getTotal().latency,
-                           renderMetrics.getTotal().latency);
+        logLatencyPerStage(cap->getMetrics().getTotal(),
+                           pipeline.getPreprocessMetrics().getTotal(),
+                           pipeline.getInferenceMetircs().getTotal(),
+                           pipeline.getPostprocessMetrics().getTotal(),
+                           renderMetrics.getTotal());
+        pipeline.logLayersProfile();
 
         slog::info << presenter.reportMeans() << slog::endl;
+        const double meanPower = presenter.getMeanPower();
+        if (!std::isnan(meanPower)) {
+            slog::info << "\tFPS/W: " << metrics.getTotal().fps / meanPower << slog::endl;
+        }
+        if (matAllocator) {
+            matAllocator->logStats();
+        }
+        logMemoryUsage();
     } catch (const std::exception& error) {
         slog::err << error.what() << slog::endl;
         return 1;
@@ -0,0 +1,114 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "images_writer.hpp"
+
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#include <opencv2/imgcodecs.hpp>
+
+ImagesWriter::ImagesWriter(const std::string& dir, size_t queueSize) : dir(dir), queueSize(queueSize) {
+    if (queueSize == 0) {
+        throw std::invalid_argument("Queue size of images writer must be positive");
+    }
+    encoderThread = std::thread(&ImagesWriter::encoderThreadFunc, this);
+}
+
+ImagesWriter::~ImagesWriter() {
+    {
+        const std::lock_guard<std::mutex> lock(mtx);
+        stopEncoding = true;
+    }
+    condVar.notify_all();
+    encoderThread.join();
+}
+
+void ImagesWriter::write(int64_t id, const cv::Mat& image) {
+    std::unique_lock<std::mutex> lock(mtx);
+    condVar.wait(lock, [&]() {
+        return queuedImages.size() < queueSize || encoderException;
+    });
+    if (encoderException) {
+        std::rethrow_exception(encoderException);
+    }
+    queuedImages.emplace_back(id, image);
+    condVar.notify_all();
+}
+
+void ImagesWriter::flush() {
+    std::unique_lock<std::mutex> lock(mtx);
+    condVar.wait(lock, [&]() {
+        return (queuedImages.empty() && !isEncoding) || encoderException;
+    });
+    if (encoderException) {
+        std::rethrow_exception(encoderException);
+    }
+}
+
+std::chrono::steady_clock::duration ImagesWriter::getEncodingTime() {
+    const std::lock_guard<std::mutex> lock(mtx);
+    return encodingTime;
+}
+
+size_t ImagesWriter::getWrittenNum() {
+    const std::lock_guard<std::mutex> lock(mtx);
+    return writtenNum;
+}
+
+void ImagesWriter::encoderThreadFunc() {
+    std::unique_lock<std::mutex> lock(mtx);
+    for (;;) {
+        condVar.wait(lock, [&]() {
+            return stopEncoding || !queuedImages.empty();
+        });
+        if (queuedImages.empty()) {
+            return;  // stopEncoding is set and all images are written
+        }
+        std::pair<int64_t, cv::Mat> image = std::move(queuedImages.front());
+        queuedImages.pop_front();
+        isEncoding = true;
+        condVar.notify_all();
+        lock.unlock();
+
+        const auto startTime = std::chrono::steady_clock::now();
+        std::ostringstream path;
+        path << dir << '/' << std::setw(6) << std::setfill('0') << image.first << ".png";
+        bool written = false;
+        std::exception_ptr exception;
+        try {
+            written = cv::imwrite(path.str(), image.second);
+        } catch (...) {
+            exception = std::current_exception();
+        }
+        const auto endTime = std::chrono::steady_clock::now();
+
+        lock.lock();
+        isEncoding = false;
+        if (!written && !exception) {
+            exception = std::make_exception_ptr(std::runtime_error("Can't write " + path.str()));
+        }
+        if (exception) {
+            encoderException = exception;
+            condVar.notify_all();
+            return;
+        }
+        encodingTime += endTime - startTime;
+        ++writtenNum;
+        condVar.notify_all();
+    }
+}
@@ -0,0 +1,71 @@
+/*
+// Copyright (C) 2022 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <opencv2/core.hpp>
+
+/// Saves images to a directory on a background thread, so encoding doesn't stall submission of next images to the
+/// pipeline. write() only queues an image, it waits if queueSize images are already queued, which bounds the memory
+/// held by the queue.
+class ImagesWriter {
+public:
+    /// @param dir - existing directory to save the images to
+    ImagesWriter(const std::string& dir, size_t queueSize);
+    ImagesWriter(const ImagesWriter&) = delete;
+    ImagesWriter& operator=(const ImagesWriter&) = delete;
+    ~ImagesWriter();
+
+    /// Queues the image to be saved as <dir>/<id>.png, the id is padded by zeros to 6 digits. The image is shared with
+    /// the queue and must not be modified after the call. Rethrows exceptions of the encoder thread.
+    void write(int64_t id, const cv::Mat& image);
+
+    /// Waits for all queued images to be saved. Rethrows exceptions of the encoder thread.
+    void flush();
+
+    /// @returns total time spent on encoding and writing
+    std::chrono::steady_clock::duration getEncodingTime();
+
+    /// @returns number of saved images
+    size_t getWrittenNum();
+
+private:
+    void encoderThreadFunc();
+
+    const std::string dir;
+    const size_t queueSize;
+
+    std::mutex mtx;
+    std::condition_variable condVar;
+    std::deque<std::pair<int64_t, cv::Mat>> queuedImages;
+    bool isEncoding = false;
+    bool stopEncoding = false;
+    size_t writtenNum = 0;
+    std::chrono::steady_clock::duration encodingTime = std::chrono::steady_clock::duration::zero();
+    std::exception_ptr encoderException;
+    std::thread encoderThread;
+};
@@ -18,8 +18,11 @@
 #include <stdint.h>
 
 #include <chrono>
+#include <cmath>
 #include <exception>
+#include <iomanip>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -43,18 +46,28 @@
 #include <monitors/presenter.h>
 #include <pipelines/async_pipeline.h>
 #include <pipelines/metadata.h>
+#include <pipelines/tiled_image_pipeline.h>
 #include <utils/common.hpp>
 #include <utils/config_factory.h>
 #include <utils/default_flags.hpp>
 #include <utils/images_capture.h>
+#include <utils/itt.hpp>
+#include <utils/memory_accounting.hpp>
+#include <utils/metrics_sink.hpp>
 #include <utils/ocv_common.hpp>
 #include <utils/performance_metrics.hpp>
 #include <utils/slog.hpp>
 
+#include "images_writer.hpp"
 #include "visualizer.hpp"
 
 DEFINE_INPUT_FLAGS
 DEFINE_OUTPUT_FLAGS
+DEFINE_METRICS_FLAGS
+DEFINE_TUNING_FLAGS
+DEFINE_WARMUP_FLAGS
+DEFINE_LAYERS_PROFILE_FLAGS
+DEFINE_REMOTE_FLAGS
 
 static const char help_message[] = "Print a usage message.";
 static const char at_message[] = "Required. Type of the model, either 'sr' for Super Resolution task, 'deblur' for "
@@ -79,6 +92,17 @@ static const char output_resolution_message[] =
     "in (width x height) format. Example: 1280x720. Input frame size used by default.";
 static const char jc_message[] = "Optional. Flag of using compression for jpeg images. "
                                  "Default value if false. Only for jr architecture type.";
+static const char tile_size_message[] =
+    "Optional. Process images by tiles of the given size in (width x height) format, tiles are inferred in parallel. "
+    "Example: 512x512. By default the model input is reshaped to the size of the first frame.";
+static const char tile_overlap_message[] = "Optional. Number of pixels shared by neighbour tiles. Default value is 16.";
+static const char output_dir_message[] =
+    "Optional. Batch mode: save every processed image to the given existing directory as <frame number>.png. Images "
+    "are decoded and encoded on background threads, so the pipeline is kept full. Combine with -no_show to skip "
+    "building of the views and with -tile_size to infer every big image by tiles on all the streams.";
+static const char postprocess_on_device_message[] =
+    "Optional. Convert the model output to u8 image on the inference device, so a 4 times smaller output is "
+    "transferred and less work is done by CPU.";
 
 DEFINE_bool(h, false, help_message);
 DEFINE_string(at, "", at_message);
@@ -92,6 +116,10 @@ DEFINE_bool(no_show, false, no_show_processed_video);
 DEFINE_string(u, "", utilization_monitors_message);
 DEFINE_string(output_resolution, "", output_resolution_message);
 DEFINE_bool(jc, false, jc_message);
+DEFINE_string(tile_size, "", tile_size_message);
+DEFINE_uint32(tile_overlap, 16, tile_overlap_message);
+DEFINE_string(output_dir, "", output_dir_message);
+DEFINE_bool(postprocess_on_device, false, postprocess_on_device_message);
 
 /**
  * \brief This function shows a help message
@@ -116,7 +144,18 @@ static void showUsage() {
     std::cout << "    -no_show                  " << no_show_processed_video << std::endl;
     std::cout << "    -output_resolution        " << output_resolution_message << std::endl;
     std::cout << "    -u                        " << utilization_monitors_message << std::endl;
+    std::cout << "    -metrics_file \"<path>\"    " << metrics_file_message << std::endl;
+    std::cout << "    -tune \"<objective>\"       " << tune_message << std::endl;
+    std::cout << "    -tune_latency \"<double>\"  " << tune_latency_message << std::endl;
+    std::cout << "    -tune_cache \"<path>\"      " << tune_cache_message << std::endl;
+    std::cout << "    -warmup \"<integer>\"     " << warmup_message << std::endl;
+    std::cout << "    -profile_layers \"<integer>\" " << profile_layers_message << std::endl;
+    std::cout << "    -remote \"<host:port>\"   " << remote_message << std::endl;
     std::cout << "    -jc                       " << jc_message << std::endl;
+    std::cout << "    -tile_size                " << tile_size_message << std::endl;
+    std::cout << "    -tile_overlap \"<integer>\" " << tile_overlap_message << std::endl;
+    std::cout << "    -output_dir \"<path>\"      " << output_dir_message << std::endl;
+    std::cout << "    -postprocess_on_device    " << postprocess_on_device_message << std::endl;
 }
 
 bool ParseAndCheckCommandLine(int argc, char* argv[]) {
@@ -142,6 +181,10 @@ bool ParseAndCheckCommandLine(int argc, char* argv[]) {
     if (!FLAGS_output_resolution.empty() && FLAGS_output_resolution.find("x") == std::string::npos) {
         throw std::logic_error("Correct format of -output_resolution parameter is \"width\"x\"height\".");
     }
+
+    if (!FLAGS_tile_size.empty() && FLAGS_tile_size.find("x") == std::string::npos) {
+        throw std::logic_error("Correct format of -tile_size parameter is \"width\"x\"height\".");
+    }
     return true;
 }
 
@@ -171,7 +214,22 @@ int main(int argc, char* argv[]) {
         }
 
         //------------------------------- Preparing Input ------------------------------------------------------
-        auto cap = openImagesCapture(FLAGS_i, FLAGS_loop, FLAGS_nireq == 1 ? read_type::efficient : read_type::safe);
+        // In the batch mode images are decoded ahead on a background thread and saved on another one
+        const bool batchMode = !FLAGS_output_dir.empty();
+        const size_t batchQueueSize = 4;
+        auto cap = openImagesCapture(FLAGS_i,
+                                     FLAGS_loop,
+                                     FLAGS_nireq == 1 && !batchMode ? read_type::efficient : read_type::safe,
+                                     0,
+                                     std::numeric_limits<size_t>::max(),
+                                     {1280, 720},
+                                     batchMode ? batchQueueSize : 0);
+        std::unique_ptr<ImagesWriter> imagesWriter;
+        if (batchMode) {
+            imagesWriter.reset(new ImagesWriter(FLAGS_output_dir, batchQueueSize));
+        }
+        // Results are rendered only to be shown or written to the video
+        const bool needsRendering = !FLAGS_no_show || !FLAGS_o.empty();
         cv::Mat curr_frame;
 
         auto startTime = std::chrono::steady_clock::now();
@@ -181,11 +239,33 @@ int main(int argc, char* argv[]) {
         slog::info << ov::get_openvino_version() << slog::endl;
         ov::Core core;
 
-        std::unique_ptr<ImageModel> model = getModel(cv::Size(curr_frame.cols, curr_frame.rows), FLAGS_at, FLAGS_jc);
-        AsyncPipeline pipeline(std::move(model),
-                               ConfigFactory::getUserConfig(FLAGS_d, FLAGS_nireq, FLAGS_nstreams, FLAGS_nthreads),
-                               core);
+        // Without tiling every image is a single tile and the model is reshaped to the size of the first frame
+        cv::Size modelInputSize(curr_frame.cols, curr_frame.rows);
+        cv::Size tileSize(std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
+        if (!FLAGS_tile_size.empty()) {
+            size_t x = FLAGS_tile_size.find("x");
+            tileSize = cv::Size{std::stoi(FLAGS_tile_size.substr(0, x)), std::stoi(FLAGS_tile_size.substr(x + 1))};
+            modelInputSize = tileSize;
+        }
+        std::unique_ptr<ImageModel> model = getModel(modelInputSize, FLAGS_at, FLAGS_jc);
+        model->setDevicePostprocessing(FLAGS_postprocess_on_device);
+        ModelConfig config = ConfigFactory::getUserConfig(FLAGS_d, FLAGS_nireq, FLAGS_nstreams, FLAGS_nthreads);
+        config.tuning = ConfigFactory::getTuningConfig(FLAGS_tune, FLAGS_tune_latency, FLAGS_tune_cache);
+        config.warmupInferences = FLAGS_warmup;
+        config.profiledLayers = FLAGS_profile_layers;
+        config.remoteWorker = FLAGS_remote;
+        TiledImagePipeline pipeline(
+            std::unique_ptr<AsyncPipeline>(new AsyncPipeline(
+                std::move(model),
+                config,
+                core)),
+            tileSize,
+            FLAGS_tile_size.empty() ? 0 : FLAGS_tile_overlap);
         Presenter presenter(FLAGS_u);
+        std::unique_ptr<MetricsSink> metricsSink;
+        if (!FLAGS_metrics_file.empty()) {
+            metricsSink.reset(new MetricsSink(FLAGS_metrics_file));
+        }
 
         int64_t frameNum =
             pipeline.submitData(ImageInputData(curr_frame), std::make_shared<ImageMetaData>(curr_frame, startTime));
@@ -201,11 +281,12 @@ int main(int argc, char* argv[]) {
         Visualizer view(FLAGS_at);
 
         // interactive mode for single image
-        if (cap->getType() == "IMAGE" && !FLAGS_loop && !FLAGS_no_show) {
+        if (cap->getType() == "IMAGE" && !FLAGS_loop && !FLAGS_no_show && !batchMode) {
             pipeline.waitForTotalCompletion();
             result = pipeline.getResult();
             metrics.update(result->metaData->asRef<ImageMetaData>().timeStamp);
             auto renderingStart = std::chrono::steady_clock::now();
+            ITT_SCOPED_FRAME_TASK("render", result->frameId);
             if (found == std::string::npos) {
                 outputResolution = result->asRef<ImageResult>().resultImage.size();
                 cv::Size viewSize = view.getSize();
@@ -253,7 +334,16 @@ int main(int argc, char* argv[]) {
             //--- If you need just plain data without rendering - cast result's underlying pointer to ImageResult*
             //    and use your own processing instead of calling renderResultData().
             while ((result = pipeline.getResult()) && keepRunning) {
+                if (imagesWriter) {
+                    imagesWriter->write(result->frameId, result->asRef<ImageResult>().resultImage);
+                }
+                if (!needsRendering) {
+                    metrics.update(result->metaData->asRef<ImageMetaData>().timeStamp);
+                    framesProcessed++;
+                    continue;
+                }
                 auto renderingStart = std::chrono::steady_clock::now();
+                ITT_SCOPED_FRAME_TASK("render", result->frameId);
                 if (framesProcessed == 0) {
                     if (found == std::string::npos) {
                         outputResolution = result->asRef<ImageResult>().resultImage.size();
@@ -295,6 +385,24 @@ int main(int argc, char* argv[]) {
                 }
                 framesProcessed++;
             }
+
+            if (metricsSink && metricsSink->isDue()) {
+                metricsSink->stage("decoding", cap->getMetrics().getLast());
+                pipeline.getTilesPipeline().reportMetrics(*metricsSink);
+                const std::pair<double, double> memSwapUsage = presenter.getLastMemSwapUsage();
+                const std::pair<double, double> gpuUsage = presenter.getLastGpuUsage();
+                const double power = presenter.getLastPower();
+                metricsSink->stage("rendering", renderMetrics.getLast())
+                    .stage("total", metrics.getLast())
+                    .value("cpu_load", presenter.getLastCpuLoad())
+                    .value("memory_gib", memSwapUsage.first)
+                    .value("swap_gib", memSwapUsage.second)
+                    .value("power_w", power)
+                    .value("fps_per_watt", metrics.getLast().fps / power)
+                    .value("gpu_utilization", gpuUsage.first)
+                    .value("gpu_frequency_mhz", gpuUsage.second);
+                metricsSink->publish();
+            }
         }  // while(keepRunning)
 
         // ------------ Waiting for completion of data processing and rendering the rest of results ---------
@@ -302,7 +410,12 @@ int main(int argc, char* argv[]) {
 
         for (; framesProcessed <= frameNum; framesProcessed++) {
             result = pipeline.getResult();
-            if (result != nullptr) {
+            if (result != nullptr && imagesWriter) {
+                imagesWriter->write(result->frameId, result->asRef<ImageResult>().resultImage);
+            }
+            if (result != nullptr && !needsRendering) {
+                metrics.update(result->metaData->asRef<ImageMetaData>().timeStamp);
+            } else if (result != nullptr) {
                 if (framesProcessed == 0) {
                     if (found == std::string::npos) {
                         outputResolution = result->asRef<ImageResult>().resultImage.size();
@@ -337,14 +450,31 @@ int main(int argc, char* argv[]) {
             }
         }
 
+        if (imagesWriter) {
+            imagesWriter->flush();
+        }
+
         slog::info << "Metrics report:" << slog::endl;
         metrics.logTotal();
-        logLatencyPerStage(cap->getMetrics().getTotal().latency,
-                           pipeline.getPreprocessMetrics().getTotal().latency,
-                           pipeline.getInferenceMetircs().getTotal().latency,
-                           pipeline.getPostprocessMetrics().getTotal().latency,
-                           renderMetrics.getTotal().latency);
+        logLatencyPerStage(cap->getMetrics().getTotal(),
+                           pipeline.getTilesPipeline().getPreprocessMetrics().getTotal(),
+                           pipeline.getTilesPipeline().getInferenceMetircs().getTotal(),
+                           pipeline.getTilesPipeline().getPostprocessMetrics().getTotal(),
+                           renderMetrics.getTotal());
+        pipeline.getTilesPipeline().logLayersProfile();
+        if (imagesWriter && imagesWriter->getWrittenNum() > 0) {
+            slog::info << "\tImages saved: " << imagesWriter->getWrittenNum() << ", encoding: " << std::fixed
+                       << std::setprecision(1)
+                       << std::chrono::duration_cast<PerformanceMetrics::Ms>(imagesWriter->getEncodingTime()).count() /
+                              imagesWriter->getWrittenNum()
+                       << " ms per image" << slog::endl;
+        }
         slog::info << presenter.reportMeans() << slog::endl;
+        const double meanPower = presenter.getMeanPower();
+        if (!std::isnan(meanPower)) {
+            slog::info << "\tFPS/W: " << metrics.getTotal().fps / meanPower << slog::endl;
+        }
+        logMemoryUsage();
     } catch (const std::exception& error) {
         slog::err << error.what() << slog::endl;
         return 1;
@@ -0,0 +1,70 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <stdint.h>
+
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include <gflags/gflags.h>
+#include <openvino/openvino.hpp>
+
+#include <utils/remote_inference.hpp>
+#include <utils/slog.hpp>
+
+static const char help_message[] = "Print a usage message.";
+static const char port_message[] = "Optional. TCP port to accept demos started with -remote on. Default is 9090.";
+static const char nireq_message[] = "Optional. Number of infer requests of every connected demo. Default is 0, the "
+                                    "optimal number for the device.";
+
+DEFINE_bool(h, false, help_message);
+DEFINE_uint32(port, 9090, port_message);
+DEFINE_uint32(nireq, 0, nireq_message);
+
+static void showUsage() {
+    std::cout << std::endl;
+    std::cout << "inference_worker_demo [OPTION]" << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << std::endl;
+    std::cout << "    -h                        " << help_message << std::endl;
+    std::cout << "    -port \"<integer>\"         " << port_message << std::endl;
+    std::cout << "    -nireq \"<integer>\"        " << nireq_message << std::endl;
+}
+
+bool ParseAndCheckCommandLine(int argc, char* argv[]) {
+    gflags::ParseCommandLineNonHelpFlags(&argc, &argv, true);
+    if (FLAGS_h) {
+        showUsage();
+        return false;
+    }
+    if (FLAGS_port == 0 || FLAGS_port > std::numeric_limits<uint16_t>::max()) {
+        throw std::logic_error("Parameter -port should be in range [1, 65535]");
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        if (!ParseAndCheckCommandLine(argc, argv)) {
+            return 0;
+        }
+
+        slog::info << ov::get_openvino_version() << slog::endl;
+        ov::Core core;
+        RemoteInferenceWorker worker(core, static_cast<uint16_t>(FLAGS_port), FLAGS_nireq);
+        slog::info << "Waiting for demos on port " << FLAGS_port << slog::endl;
+        worker.run();
+    } catch (const std::exception& error) {
+        slog::err << error.what() << slog::endl;
+        return 1;
+    } catch (...) {
+        slog::err << "Unknown/internal exception happened." << slog::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -13,10 +13,58 @@ BaseDetection::BaseDetection(const std::string &pathToModel, bool doRawOutputMes
     : pathToModel(pathToModel), doRawOutputMessages(doRawOutputMessages) {
 }
 
+void BaseDetection::createRequests(ov::CompiledModel& compiledModel, size_t) {
+    request = compiledModel.create_infer_request();
+}
+
 bool BaseDetection::enabled() const  {
     return bool(request);
 }
 
+FaceAttributesDetection::FaceAttributesDetection(const std::string &pathToModel, bool doRawOutputMessages)
+    : BaseDetection(pathToModel, doRawOutputMessages), facesPerRequest(0) {
+}
+
+void FaceAttributesDetection::createRequests(ov::CompiledModel& compiledModel, size_t numRequests) {
+    BaseDetection::createRequests(compiledModel, numRequests);
+    requests.push_back(request);
+    for (size_t i = 1; i < numRequests; i++) {
+        requests.push_back(compiledModel.create_infer_request());
+    }
+}
+
+void FaceAttributesDetection::enqueue(const cv::Mat &face) {
+    if (!enabled()) {
+        return;
+    }
+    enquedFaces.push_back(face);
+}
+
+void FaceAttributesDetection::submitRequest() {
+    if (enquedFaces.empty())
+        return;
+    // there are at most ndetections faces, so every batch fits into the input tensor
+    facesPerRequest = (enquedFaces.size() + requests.size() - 1) / requests.size();
+    for (size_t begin = 0, r = 0; begin < enquedFaces.size(); begin += facesPerRequest, r++) {
+        size_t end = std::min(begin + facesPerRequest, enquedFaces.size());
+        ov::Tensor batch = requests[r].get_input_tensor();
+        batch.set_shape(inShape);
+        for (size_t i = begin; i < end; i++) {
+            resize2tensor(enquedFaces[i], ov::Tensor{batch, {i - begin, 0, 0, 0}, {i - begin + 1, inShape[1], inShape[2], inShape[3]}});
+        }
+        requests[r].set_input_tensor(ov::Tensor{batch, {0, 0, 0, 0}, {end - begin, inShape[1], inShape[2], inShape[3]}});
+        requests[r].start_async();
+    }
+    enquedFaces.clear();
+}
+
+ov::InferRequest& FaceAttributesDetection::resultRequest(int& idx) {
+    ov::InferRequest& faceRequest = requests[idx / facesPerRequest];
+    faceRequest.wait();
+    idx %= facesPerRequest;
+    return faceRequest;
+}
+
 FaceDetection::FaceDetection(const std::string &pathToModel,
                              double detectionThreshold, bool doRawOutputMessages,
                              float bb_enlarge_coefficient, float bb_dx_coefficient, float bb_dy_coefficient)
@@ -186,31 +234,13 @@ std::vector<FaceDetection::Result> FaceDetection::fetchResults() {
 }
 
 AntispoofingClassifier::AntispoofingClassifier(const std::string& pathToModel, bool doRawOutputMessages)
-    : BaseDetection(pathToModel, doRawOutputMessages),
-    enquedFaces(0) {
-}
-
-void AntispoofingClassifier::submitRequest() {
-    if (!enquedFaces)
-        return;
-    request.set_input_tensor(ov::Tensor{request.get_input_tensor(), {0, 0, 0, 0}, {enquedFaces, inShape[1], inShape[2], inShape[3]}});
-    request.start_async();
-    enquedFaces = 0;
-}
-
-void AntispoofingClassifier::enqueue(const cv::Mat& face) {
-    if (!enabled()) {
-        return;
-    }
-    ov::Tensor batch = request.get_input_tensor();
-    batch.set_shape(inShape);
-    resize2tensor(face, ov::Tensor{batch, {enquedFaces, 0, 0, 0}, {enquedFaces + 1, inShape[1], inShape[2], inShape[3]}});
-    enquedFaces++;
+    : FaceAttributesDetection(pathToModel, doRawOutputMessages) {
 }
 
 float AntispoofingClassifier::operator[](int idx) {
-    request.wait();
-    float r = request.get_output_tensor().data<float>()[2 * idx] * 100;
+    int batchIdx = idx;
+    ov::InferRequest& faceRequest = resultRequest(batchIdx);
+    float r = faceRequest.get_output_tensor().data<float>()[2 * batchIdx] * 100;
     if (doRawOutputMessages) {
         slog::debug << "[" << idx << "] element, real face probability = " << r << slog::endl;
     }
@@ -238,32 +268,14 @@ std::shared_ptr<ov::Model> AntispoofingClassifier::read(const ov::Core& core) {
 
 AgeGenderDetection::AgeGenderDetection(const std::string &pathToModel,
                                        bool doRawOutputMessages)
-    : BaseDetection(pathToModel, doRawOutputMessages),
-      enquedFaces(0) {
-}
-
-void AgeGenderDetection::submitRequest() {
-    if (!enquedFaces)
-        return;
-    request.set_input_tensor(ov::Tensor{request.get_input_tensor(), {0, 0, 0, 0}, {enquedFaces, inShape[1], inShape[2], inShape[3]}});
-    request.start_async();
-    enquedFaces = 0;
-}
-
-void AgeGenderDetection::enqueue(const cv::Mat &face) {
-    if (!enabled()) {
-        return;
-    }
-    ov::Tensor batch = request.get_input_tensor();
-    batch.set_shape(inShape);
-    resize2tensor(face, ov::Tensor{batch, {enquedFaces, 0, 0, 0}, {enquedFaces + 1, inShape[1], inShape[2], inShape[3]}});
-    enquedFaces++;
+    : FaceAttributesDetection(pathToModel, doRawOutputMessages) {
 }
 
 AgeGenderDetection::Result AgeGenderDetection::operator[](int idx) {
-    request.wait();
-    AgeGenderDetection::Result r = {request.get_tensor(outputAge).data<float>()[idx] * 100,
-                                    request.get_tensor(outputGender).data<float>()[idx * 2 + 1]};
+    int batchIdx = idx;
+    ov::InferRequest& faceRequest = resultRequest(batchIdx);
+    AgeGenderDetection::Result r = {faceRequest.get_tensor(outputAge).data<float>()[batchIdx] * 100,
+                                    faceRequest.get_tensor(outputGender).data<float>()[batchIdx * 2 + 1]};
     if (doRawOutputMessages) {
         slog::debug << "[" << idx << "] element, male prob = " << r.maleProb << ", age = " << r.age << slog::endl;
     }
@@ -297,32 +309,16 @@ std::shared_ptr<ov::Model> AgeGenderDetection::read(const ov::Core& core) {
 
 HeadPoseDetection::HeadPoseDetection(const std::string &pathToModel,
                                      bool doRawOutputMessages)
-    : BaseDetection(pathToModel, doRawOutputMessages),
-      outputAngleR("angle_r_fc"), outputAngleP("angle_p_fc"), outputAngleY("angle_y_fc"), enquedFaces(0) {
-}
-
-void HeadPoseDetection::submitRequest()  {
-    if (!enquedFaces) return;
-    request.set_input_tensor(ov::Tensor{request.get_input_tensor(), {0, 0, 0, 0}, {enquedFaces, inShape[1], inShape[2], inShape[3]}});
-    request.start_async();
-    enquedFaces = 0;
-}
-
-void HeadPoseDetection::enqueue(const cv::Mat &face) {
-    if (!enabled()) {
-        return;
-    }
-    ov::Tensor batch = request.get_input_tensor();
-    batch.set_shape(inShape);
-    resize2tensor(face, ov::Tensor{batch, {enquedFaces, 0, 0, 0}, {enquedFaces + 1, inShape[1], inShape[2], inShape[3]}});
-    enquedFaces++;
+    : FaceAttributesDetection(pathToModel, doRawOutputMessages),
+      outputAngleR("angle_r_fc"), outputAngleP("angle_p_fc"), outputAngleY("angle_y_fc") {
 }
 
 HeadPoseDetection::Results HeadPoseDetection::operator[](int idx) {
-    request.wait();
-    HeadPoseDetection::Results r = {request.get_tensor(outputAngleR).data<float>()[idx],
-                                    request.get_tensor(outputAngleP).data<float>()[idx],
-                                    request.get_tensor(outputAngleY).data<float>()[idx]};
+    int batchIdx = idx;
+    ov::InferRequest& faceRequest = resultRequest(batchIdx);
+    HeadPoseDetection::Results r = {faceRequest.get_tensor(outputAngleR).data<float>()[batchIdx],
+                                    faceRequest.get_tensor(outputAngleP).data<float>()[batchIdx],
+                                    faceRequest.get_tensor(outputAngleY).data<float>()[batchIdx]};
     if (doRawOutputMessages) {
         slog::debug << "[" << idx << "] element, yaw = " << r.angle_y <<
                      ", pitch = " << r.angle_p <<
@@ -354,30 +350,13 @@ std::shared_ptr<ov::Model> HeadPoseDetection::read(const ov::Core& core) {
 
 EmotionsDetection::EmotionsDetection(const std::string &pathToModel,
                                      bool doRawOutputMessages)
-              : BaseDetection(pathToModel, doRawOutputMessages),
-                enquedFaces(0) {
-}
-
-void EmotionsDetection::submitRequest() {
-    if (!enquedFaces) return;
-    request.set_input_tensor(ov::Tensor{request.get_input_tensor(), {0, 0, 0, 0}, {enquedFaces, inShape[1], inShape[2], inShape[3]}});
-    request.start_async();
-    enquedFaces = 0;
-}
-
-void EmotionsDetection::enqueue(const cv::Mat &face) {
-    if (!enabled()) {
-        return;
-    }
-    ov::Tensor batch = request.get_input_tensor();
-    batch.set_shape(inShape);
-    resize2tensor(face, ov::Tensor{batch, {enquedFaces, 0, 0, 0}, {enquedFaces + 1, inShape[1], inShape[2], inShape[3]}});
-    enquedFaces++;
+              : FaceAttributesDetection(pathToModel, doRawOutputMessages) {
 }
 
 std::map<std::string, float> EmotionsDetection::operator[](int idx) {
-    request.wait();
-    const ov::Tensor& tensor = request.get_output_tensor();
+    int batchIdx = idx;
+    ov::InferRequest& faceRequest = resultRequest(batchIdx);
+    const ov::Tensor& tensor = faceRequest.get_output_tensor();
     auto emotionsVecSize = emotionsVec.size();
     /* emotions vector must have the same size as number of channels
      * in model output. Default output format is NCHW, so index 1 is checked */
@@ -389,7 +368,7 @@ std::map<std::string, float> EmotionsDetection::operator[](int idx) {
                                std::to_string(emotionsVecSize) + ")");
     }
     float* emotionsValues = tensor.data<float>();
-    auto outputIdxPos = emotionsValues + idx * emotionsVecSize;
+    auto outputIdxPos = emotionsValues + batchIdx * emotionsVecSize;
     std::map<std::string, float> emotions;
 
     if (doRawOutputMessages) {
@@ -433,39 +412,23 @@ std::shared_ptr<ov::Model> EmotionsDetection::read(const ov::Core& core) {
 
 FacialLandmarksDetection::FacialLandmarksDetection(const std::string &pathToModel,
                                                    bool doRawOutputMessages)
-    : BaseDetection(pathToModel, doRawOutputMessages), enquedFaces(0) {
-}
-
-void FacialLandmarksDetection::submitRequest() {
-    if (!enquedFaces) return;
-    request.set_input_tensor(ov::Tensor{request.get_input_tensor(), {0, 0, 0, 0}, {enquedFaces, inShape[1], inShape[2], inShape[3]}});
-    request.start_async();
-    enquedFaces = 0;
-}
-
-void FacialLandmarksDetection::enqueue(const cv::Mat &face) {
-    if (!enabled()) {
-        return;
-    }
-    ov::Tensor batch = request.get_input_tensor();
-    batch.set_shape(inShape);
-    resize2tensor(face, ov::Tensor{batch, {enquedFaces, 0, 0, 0}, {enquedFaces + 1, inShape[1], inShape[2], inShape[3]}});
-    enquedFaces++;
+    : FaceAttributesDetection(pathToModel, doRawOutputMessages) {
 }
 
 std::vector<float> FacialLandmarksDetection::operator[](int idx) {
     std::vector<float> normedLandmarks;
 
-    request.wait();
-    const ov::Tensor& tensor = request.get_output_tensor();
+    int batchIdx = idx;
+    ov::InferRequest& faceRequest = resultRequest(batchIdx);
+    const ov::Tensor& tensor = faceRequest.get_output_tensor();
     size_t n_lm = tensor.get_shape().at(1);
-    const float *normed_coordinates = request.get_output_tensor().data<float>();
+    const float *normed_coordinates = faceRequest.get_output_tensor().data<float>();
 
     if (doRawOutputMessages) {
         slog::debug << "[" << idx << "] element, normed facial landmarks coordinates (x, y):" << slog::endl;
     }
 
-    auto begin = n_lm / 2 * idx;
+    auto begin = n_lm / 2 * batchIdx;
     auto end = begin + n_lm / 2;
     for (auto i_lm = begin; i_lm < end; ++i_lm) {
         float normed_x = normed_coordinates[2 * i_lm];
@@ -509,12 +472,19 @@ std::shared_ptr<ov::Model> FacialLandmarksDetection::read(const ov::Core& core)
 Load::Load(BaseDetection& detector) : detector(detector) {
 }
 
-void Load::into(ov::Core& core, const std::string & deviceName) const {
-    if (!detector.pathToModel.empty()) {
-        ov::CompiledModel cml = core.compile_model(detector.read(core), deviceName);
-        logCompiledModelInfo(cml, detector.pathToModel, deviceName);
-        detector.request = cml.create_infer_request();
+ov::CompiledModel Load::compile(ov::Core& core, const std::shared_ptr<ov::Model>& model,
+                                const std::string & deviceName, size_t numRequests) const {
+    ov::AnyMap config;
+    if (numRequests > 1) {
+        config = {ov::hint::performance_mode(ov::hint::PerformanceMode::THROUGHPUT),
+                  ov::hint::num_requests(static_cast<uint32_t>(numRequests))};
     }
+    return core.compile_model(model, deviceName, config);
+}
+
+void Load::attach(ov::CompiledModel& compiledModel, const std::string & deviceName, size_t numRequests) const {
+    logCompiledModelInfo(compiledModel, detector.pathToModel, deviceName);
+    detector.createRequests(compiledModel, numRequests);
 }
 
 
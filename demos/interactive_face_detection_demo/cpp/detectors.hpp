@@ -18,9 +18,27 @@ struct BaseDetection {
     BaseDetection(const std::string &pathToModel, bool doRawOutputMessages);
     virtual ~BaseDetection() = default;
     virtual std::shared_ptr<ov::Model> read(const ov::Core& core) = 0;
+    virtual void createRequests(ov::CompiledModel& compiledModel, size_t numRequests);
     bool enabled() const;
 };
 
+// Base of the face analytics networks. The crops enqueued for a frame are split evenly among the requests,
+// every request infers its part as a dynamic batch and all of them run at once.
+struct FaceAttributesDetection : BaseDetection {
+    std::vector<ov::InferRequest> requests;  // requests[0] is request
+    std::vector<cv::Mat> enquedFaces;
+    size_t facesPerRequest;
+
+    FaceAttributesDetection(const std::string &pathToModel, bool doRawOutputMessages);
+
+    void createRequests(ov::CompiledModel& compiledModel, size_t numRequests) override;
+    void submitRequest();
+
+    void enqueue(const cv::Mat &face);
+    // Waits for the request which infers the face idx, idx becomes the index of the face in the batch of the request
+    ov::InferRequest& resultRequest(int& idx);
+};
+
 struct FaceDetection : BaseDetection {
     struct Result {
         int label;
@@ -50,7 +68,7 @@ struct FaceDetection : BaseDetection {
     std::vector<Result> fetchResults();
 };
 
-struct AgeGenderDetection : BaseDetection {
+struct AgeGenderDetection : FaceAttributesDetection {
     struct Result {
         float age;
         float maleProb;
@@ -58,19 +76,15 @@ struct AgeGenderDetection : BaseDetection {
 
     std::string outputAge;
     std::string outputGender;
-    size_t enquedFaces;
 
     AgeGenderDetection(const std::string &pathToModel,
                        bool doRawOutputMessages);
 
     std::shared_ptr<ov::Model> read(const ov::Core& core) override;
-    void submitRequest();
-
-    void enqueue(const cv::Mat &face);
     Result operator[](int idx);
 };
 
-struct HeadPoseDetection : BaseDetection {
+struct HeadPoseDetection : FaceAttributesDetection {
     struct Results {
         float angle_r;
         float angle_p;
@@ -80,36 +94,26 @@ struct HeadPoseDetection : BaseDetection {
     std::string outputAngleR;
     std::string outputAngleP;
     std::string outputAngleY;
-    size_t enquedFaces;
     cv::Mat cameraMatrix;
 
     HeadPoseDetection(const std::string &pathToModel,
                       bool doRawOutputMessages);
 
     std::shared_ptr<ov::Model> read(const ov::Core& core) override;
-    void submitRequest();
-
-    void enqueue(const cv::Mat &face);
     Results operator[](int idx);
 };
 
-struct EmotionsDetection : BaseDetection {
-    size_t enquedFaces;
-
+struct EmotionsDetection : FaceAttributesDetection {
     EmotionsDetection(const std::string &pathToModel,
                       bool doRawOutputMessages);
 
     std::shared_ptr<ov::Model> read(const ov::Core& core) override;
-    void submitRequest();
-
-    void enqueue(const cv::Mat &face);
     std::map<std::string, float> operator[](int idx);
 
     const std::vector<std::string> emotionsVec = {"neutral", "happy", "sad", "surprise", "anger"};
 };
 
-struct FacialLandmarksDetection : BaseDetection {
-    size_t enquedFaces;
+struct FacialLandmarksDetection : FaceAttributesDetection {
     std::vector<std::vector<float>> landmarks_results;
     std::vector<cv::Rect> faces_bounding_boxes;
 
@@ -117,22 +121,14 @@ struct FacialLandmarksDetection : BaseDetection {
                              bool doRawOutputMessages);
 
     std::shared_ptr<ov::Model> read(const ov::Core& core) override;
-    void submitRequest();
-
-    void enqueue(const cv::Mat &face);
     std::vector<float> operator[](int idx);
 };
 
-struct AntispoofingClassifier : BaseDetection {
-    size_t enquedFaces;
-
+struct AntispoofingClassifier : FaceAttributesDetection {
     AntispoofingClassifier(const std::string &pathToModel,
         bool doRawOutputMessages);
 
     std::shared_ptr<ov::Model> read(const ov::Core& core) override;
-    void submitRequest();
-
-    void enqueue(const cv::Mat& frame);
     float operator[](int idx);
 };
 
@@ -141,7 +137,11 @@ struct Load {
 
     explicit Load(BaseDetection& detector);
 
-    void into(ov::Core& core, const std::string & deviceName) const;
+    // Compiles the model read by the detector. It doesn't log or change the detector, so it can run on a thread
+    // while other models are compiled. The detector stays disabled until the compiled model is attached
+    ov::CompiledModel compile(ov::Core& core, const std::shared_ptr<ov::Model>& model,
+                              const std::string & deviceName, size_t numRequests = 1) const;
+    void attach(ov::CompiledModel& compiledModel, const std::string & deviceName, size_t numRequests = 1) const;
 };
 
 class CallStat {
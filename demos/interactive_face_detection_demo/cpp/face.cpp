@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: Apache-2.0
 //
 
+#include <algorithm>
 #include <string>
 #include <map>
 #include <utility>
@@ -15,6 +16,7 @@ Face::Face(size_t id, cv::Rect& location):
     _maleScore(0), _femaleScore(0), _headPose({0.f, 0.f, 0.f}), _realFaceConfidence(0),
     _isAgeGenderEnabled(false), _isEmotionsEnabled(false),
     _isHeadPoseEnabled(false), _isLandmarksEnabled(false), _isAntispoofingEnabled(false) {
+    _refreshes.fill(Refresh{false, 0, cv::Rect()});
 }
 
 void Face::updateAge(float value) {
@@ -122,6 +124,27 @@ bool Face::isAntispoofingEnabled() {
     return _isAntispoofingEnabled;
 }
 
+bool Face::needsUpdate(Attribute attribute, size_t frame, size_t refreshInterval) const {
+    const Refresh& refresh = _refreshes[attribute];
+    if (refreshInterval == 0 || !refresh.done || refresh.location.area() == 0) {
+        return true;
+    }
+
+    size_t framesPassed = frame - refresh.frame;
+    cv::Rect location = _location;
+    cv::Rect refreshLocation = refresh.location;
+    if (attribute == AGE_GENDER || attribute == ANTISPOOFING) {
+        float scale = static_cast<float>(location.area()) / static_cast<float>(refreshLocation.area());
+        // the side of the face changed by more than 25%
+        return framesPassed >= refreshInterval || scale > 1.5625f || scale < 0.5625f;
+    }
+    return framesPassed >= std::max<size_t>(1, refreshInterval / 4) || calcIoU(location, refreshLocation) < 0.9f;
+}
+
+void Face::markUpdated(Attribute attribute, size_t frame) {
+    _refreshes[attribute] = Refresh{true, frame, _location};
+}
+
 float calcIoU(cv::Rect& src, cv::Rect& dst) {
     cv::Rect i = src & dst;
     cv::Rect u = src | dst;
@@ -3,6 +3,7 @@
 //
 
 # pragma once
+#include <array>
 #include <string>
 #include <map>
 #include <memory>
@@ -19,6 +20,8 @@ struct Face {
 public:
     using Ptr = std::shared_ptr<Face>;
 
+    enum Attribute { AGE_GENDER, EMOTIONS, HEAD_POSE, LANDMARKS, ANTISPOOFING, ATTRIBUTES_COUNT };
+
     explicit Face(size_t id, cv::Rect& location);
 
     void updateAge(float value);
@@ -49,6 +52,12 @@ public:
     bool isLandmarksEnabled();
     bool isAntispoofingEnabled();
 
+    // The attributes of a tracked face are cached. Age/gender and antispoofing are inferred again every
+    // refreshInterval frames or when the face size changes a lot, the others every refreshInterval / 4 frames
+    // or when the face moves. refreshInterval 0 means inferring all of them on every frame.
+    bool needsUpdate(Attribute attribute, size_t frame, size_t refreshInterval) const;
+    void markUpdated(Attribute attribute, size_t frame);
+
 public:
     cv::Rect _location;
     float _intensity_mean;
@@ -68,6 +77,13 @@ private:
     bool _isHeadPoseEnabled;
     bool _isLandmarksEnabled;
     bool _isAntispoofingEnabled;
+
+    struct Refresh {
+        bool done;
+        size_t frame;
+        cv::Rect location;
+    };
+    std::array<Refresh, ATTRIBUTES_COUNT> _refreshes;
 };
 
 // ----------------------------------- Utils -----------------------------------------------------------------
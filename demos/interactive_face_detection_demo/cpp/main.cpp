@@ -2,11 +2,14 @@
 // SPDX-License-Identifier: Apache-2.0
 //
 
+#include <functional>
+#include <future>
 #include <iostream>
 #include <limits>
 
 #include <gflags/gflags.h>
 #include <utils/images_capture.h>
+#include <utils/startup_profiler.hpp>
 #include <monitors/presenter.h>
 
 #include "detectors.hpp"
@@ -26,6 +29,10 @@ DEFINE_string(i, "0", i_msg);
 constexpr char bb_enlarge_coef_msg[] = "coefficient to enlarge/reduce the size of the bounding box around the detected face. Default is 1.2";
 DEFINE_double(bb_enlarge_coef, 1.2, bb_enlarge_coef_msg);
 
+constexpr char compile_threads_msg[] = "number of threads compiling the models and opening the input at startup. "
+    "0 uses a thread for each of them, 1 prepares them one by one. Default is 0";
+DEFINE_uint32(compile_threads, 0, compile_threads_msg);
+
 constexpr char d_msg[] =
     "specify a device to infer on (the list of available devices is shown below). "
     "Use '-d HETERO:<comma-separated_devices_list>' format to specify HETERO plugin. "
@@ -39,9 +46,19 @@ DEFINE_double(dx_coef, 1, dx_coef_msg);
 constexpr char dy_coef_msg[] = "coefficient to shift the bounding box around the detected face along the Oy axis";
 DEFINE_double(dy_coef, 1, dy_coef_msg);
 
+constexpr char attr_refresh_msg[] = "number of frames the attributes of a tracked face are reused for. "
+    "Age/gender and antispoofing are inferred again after that many frames or when the face size changes a lot, "
+    "emotions, head pose and landmarks after a quarter of it or when the face moves. "
+    "0 infers all attributes on every frame. Default is 15";
+DEFINE_uint32(attr_refresh, 15, attr_refresh_msg);
+
 constexpr char fps_msg[] = "maximum FPS for playing video";
 DEFINE_double(fps, -std::numeric_limits<double>::infinity(), fps_msg);
 
+constexpr char lazy_init_msg[] = "compile the face analytics models in background while the first frames are processed. "
+    "Every analytics model is used from the first frame after it is compiled";
+DEFINE_bool(lazy_init, false, lazy_init_msg);
+
 constexpr char lim_msg[] = "number of frames to store in output. If 0 is set, all frames are stored. Default is 1000";
 DEFINE_uint32(lim, 1000, lim_msg);
 
@@ -63,6 +80,10 @@ DEFINE_string(mhp, "", mhp_msg);
 constexpr char mlm_msg[] = "path to an .xml file with a trained Facial Landmarks Estimation model";
 DEFINE_string(mlm, "", mlm_msg);
 
+constexpr char nireq_msg[] = "number of infer requests for each of the face analytics networks. "
+    "The faces of a frame are split among them and inferred in parallel. Default is 1";
+DEFINE_uint32(nireq, 1, nireq_msg);
+
 constexpr char o_msg[] = "name of the output file(s) to save";
 DEFINE_string(o, "", o_msg);
 
@@ -92,11 +113,14 @@ void parse(int argc, char *argv[]) {
                   << "\n\t[--help]                                      print help on all arguments"
                   << "\n\t  -m <MODEL FILE>                             " << m_msg
                   << "\n\t[ -i <INPUT>]                                 " << i_msg
+                  << "\n\t[--attr_refresh <NUMBER>]                     " << attr_refresh_msg
                   << "\n\t[--bb_enlarge_coef <NUMBER>]                  " << bb_enlarge_coef_msg
+                  << "\n\t[--compile_threads <NUMBER>]                  " << compile_threads_msg
                   << "\n\t[ -d <DEVICE>]                                " << d_msg
                   << "\n\t[--dx_coef <NUMBER>]                          " << dx_coef_msg
                   << "\n\t[--dy_coef <NUMBER>]                          " << dy_coef_msg
                   << "\n\t[--fps <NUMBER>]                              " << fps_msg
+                  << "\n\t[--lazy_init]                                 " << lazy_init_msg
                   << "\n\t[--lim <NUMBER>]                              " << lim_msg
                   << "\n\t[--loop]                                      " << loop_msg
                   << "\n\t[--mag <MODEL FILE>]                          " << mag_msg
@@ -104,6 +128,7 @@ void parse(int argc, char *argv[]) {
                   << "\n\t[--mem <MODEL FILE>]                          " << mem_msg
                   << "\n\t[--mhp <MODEL FILE>]                          " << mhp_msg
                   << "\n\t[--mlm <MODEL FILE>]                          " << mlm_msg
+                  << "\n\t[--nireq <NUMBER>]                            " << nireq_msg
                   << "\n\t[ -o <OUTPUT>]                                " << o_msg
                   << "\n\t[ -r]                                         " << r_msg
                   << "\n\t[--show] ([--noshow])                         " << show_msg
@@ -128,6 +153,7 @@ void parse(int argc, char *argv[]) {
 } // namespace
 
 int main(int argc, char *argv[]) {
+    StartupProfiler startupProfiler;
     std::set_terminate(catcher);
     parse(argc, argv);
     PerformanceMetrics metrics;
@@ -145,12 +171,56 @@ int main(int argc, char *argv[]) {
     // ---------------------------------------------------------------------------------------------------
 
     // --------------------------- 2. Reading IR models and loading them to plugins ----------------------
-    Load(faceDetector).into(core, FLAGS_d);
-    Load(ageGenderDetector).into(core, FLAGS_d);
-    Load(headPoseDetector).into(core, FLAGS_d);
-    Load(emotionsDetector).into(core, FLAGS_d);
-    Load(facialLandmarksDetector).into(core, FLAGS_d);
-    Load(antispoofingClassifier).into(core, FLAGS_d);
+    // The models are read one by one because reading logs their info. Their compilation and opening of the input don't
+    // depend on each other and run in parallel. With -lazy_init the face analytics models are compiled in background
+    // and attached between frames once they are ready, until then their attributes aren't shown
+    struct ModelToLoad {
+        BaseDetection& detector;
+        size_t numRequests;
+        std::shared_ptr<ov::Model> model;
+        ov::CompiledModel compiledModel;
+    };
+    std::vector<ModelToLoad> models{{faceDetector, 1, nullptr, {}},
+                                    {ageGenderDetector, FLAGS_nireq, nullptr, {}},
+                                    {headPoseDetector, FLAGS_nireq, nullptr, {}},
+                                    {emotionsDetector, FLAGS_nireq, nullptr, {}},
+                                    {facialLandmarksDetector, FLAGS_nireq, nullptr, {}},
+                                    {antispoofingClassifier, FLAGS_nireq, nullptr, {}}};
+    const size_t startupModelsNum = FLAGS_lazy_init ? 1 : models.size();
+    for (ModelToLoad& toLoad : models) {
+        if (!toLoad.detector.pathToModel.empty()) {
+            StartupProfiler::Phase phase(startupProfiler, "Reading " + toLoad.detector.pathToModel);
+            toLoad.model = toLoad.detector.read(core);
+        }
+    }
+    auto compileTask = [&](ModelToLoad& toLoad) {
+        StartupProfiler::Phase phase(startupProfiler, "Compiling " + toLoad.detector.pathToModel);
+        toLoad.compiledModel = Load(toLoad.detector).compile(core, toLoad.model, FLAGS_d, toLoad.numRequests);
+    };
+
+    std::unique_ptr<ImagesCapture> cap;
+    std::vector<std::function<void()>> startupTasks{[&]() {
+        StartupProfiler::Phase phase(startupProfiler, "Opening the input");
+        cap = openImagesCapture(FLAGS_i, FLAGS_loop);
+    }};
+    for (size_t i = 0; i < startupModelsNum; i++) {
+        if (models[i].model) {
+            startupTasks.push_back([&, i]() { compileTask(models[i]); });
+        }
+    }
+    runInParallel(startupTasks, FLAGS_compile_threads);
+    for (size_t i = 0; i < startupModelsNum; i++) {
+        if (models[i].model) {
+            Load(models[i].detector).attach(models[i].compiledModel, FLAGS_d, models[i].numRequests);
+        }
+    }
+    // Destroyed before the models their tasks refer to, the destructors wait for the tasks
+    std::vector<std::future<void>> lazyCompilations(models.size());
+    for (size_t i = startupModelsNum; i < models.size(); i++) {
+        if (models[i].model) {
+            lazyCompilations[i] = std::async(std::launch::async, compileTask, std::ref(models[i]));
+        }
+    }
     // ----------------------------------------------------------------------------------------------------
 
     Timer timer;
@@ -160,8 +230,6 @@ int main(int argc, char *argv[]) {
     std::list<Face::Ptr> faces;
     size_t id = 0;
 
-    std::unique_ptr<ImagesCapture> cap = openImagesCapture(FLAGS_i, FLAGS_loop);
-
     auto startTime = std::chrono::steady_clock::now();
     cv::Mat frame = cap->read();
     if (!frame.data) {
@@ -184,6 +252,17 @@ int main(int argc, char *argv[]) {
     cv::Mat nextFrame = cap->read();
     while (frame.data) {
         timer.start("total");
+        // The analytics networks are idle between frames, so the models compiled in background are attached here
+        for (size_t i = startupModelsNum; i < models.size(); i++) {
+            if (lazyCompilations[i].valid()
+                    && lazyCompilations[i].wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+                lazyCompilations[i].get();
+                Load(models[i].detector).attach(models[i].compiledModel, FLAGS_d, models[i].numRequests);
+                if (FLAGS_show_emotion_bar && &models[i].detector == &emotionsDetector) {
+                    visualizer.enableEmotionBar(emotionsDetector.emotionsVec);
+                }
+            }
+        }
         const auto startTimePrevFrame = startTime;
         cv::Mat prevFrame = std::move(frame);
         startTime = startTimeNextFrame;
@@ -201,40 +280,17 @@ int main(int argc, char *argv[]) {
             faceDetector.submitRequest(frame);
         }
 
-        // Filling inputs of face analytics networks
-        for (auto &&face : prev_detection_results) {
-            cv::Rect clippedRect = face.location & cv::Rect({0, 0}, prevFrame.size());
-            const cv::Mat& crop = prevFrame(clippedRect);
-            ageGenderDetector.enqueue(crop);
-            headPoseDetector.enqueue(crop);
-            emotionsDetector.enqueue(crop);
-            facialLandmarksDetector.enqueue(crop);
-            antispoofingClassifier.enqueue(crop);
-        }
-
-        // Running Age/Gender Recognition, Head Pose Estimation, Emotions Recognition, Facial Landmarks Estimation and Antispoofing Classifier networks simultaneously
-        ageGenderDetector.submitRequest();
-        headPoseDetector.submitRequest();
-        emotionsDetector.submitRequest();
-        facialLandmarksDetector.submitRequest();
-        antispoofingClassifier.submitRequest();
-
-        // Read the next frame while waiting for inference results
-        startTimeNextFrame = std::chrono::steady_clock::now();
-        nextFrame = cap->read();
-
-        //  Postprocessing
+        //  Matching the detected faces with the faces of the previous frame
         std::list<Face::Ptr> prev_faces;
 
-        if (!FLAGS_smooth) {
+        if (FLAGS_smooth) {
             prev_faces.insert(prev_faces.begin(), faces.begin(), faces.end());
         }
 
         faces.clear();
 
-        // For every detected face
-        for (size_t i = 0; i < prev_detection_results.size(); i++) {
-            auto& result = prev_detection_results[i];
+        std::vector<Face::Ptr> detected_faces;
+        for (auto& result : prev_detection_results) {
             cv::Rect rect = result.location & cv::Rect({0, 0}, prevFrame.size());
 
             Face::Ptr face;
@@ -256,30 +312,83 @@ int main(int argc, char *argv[]) {
             }
 
             face->ageGenderEnable(ageGenderDetector.enabled());
-            if (face->isAgeGenderEnabled()) {
-                AgeGenderDetection::Result ageGenderResult = ageGenderDetector[i];
+            face->emotionsEnable(emotionsDetector.enabled());
+            face->headPoseEnable(headPoseDetector.enabled());
+            face->landmarksEnable(facialLandmarksDetector.enabled());
+            face->antispoofingEnable(antispoofingClassifier.enabled());
+            detected_faces.push_back(face);
+        }
+
+        // Filling inputs of face analytics networks with the faces whose cached attributes are outdated,
+        // batch_idxs[attribute][i] is the index of the face i in the batch of the network or -1
+        FaceAttributesDetection* attribute_detectors[Face::ATTRIBUTES_COUNT] = {};
+        attribute_detectors[Face::AGE_GENDER] = &ageGenderDetector;
+        attribute_detectors[Face::EMOTIONS] = &emotionsDetector;
+        attribute_detectors[Face::HEAD_POSE] = &headPoseDetector;
+        attribute_detectors[Face::LANDMARKS] = &facialLandmarksDetector;
+        attribute_detectors[Face::ANTISPOOFING] = &antispoofingClassifier;
+        std::vector<int> batch_idxs[Face::ATTRIBUTES_COUNT];
+        for (int attribute = 0; attribute < Face::ATTRIBUTES_COUNT; attribute++) {
+            FaceAttributesDetection& detector = *attribute_detectors[attribute];
+            batch_idxs[attribute].assign(detected_faces.size(), -1);
+            if (!detector.enabled()) {
+                continue;
+            }
+            int batch_size = 0;
+            for (size_t i = 0; i < detected_faces.size(); i++) {
+                const Face::Ptr& face = detected_faces[i];
+                if (face->needsUpdate(static_cast<Face::Attribute>(attribute), framesCounter, FLAGS_attr_refresh)) {
+                    detector.enqueue(prevFrame(face->_location));
+                    batch_idxs[attribute][i] = batch_size++;
+                }
+            }
+        }
+
+        // Running Age/Gender Recognition, Head Pose Estimation, Emotions Recognition, Facial Landmarks Estimation and Antispoofing Classifier networks simultaneously
+        ageGenderDetector.submitRequest();
+        headPoseDetector.submitRequest();
+        emotionsDetector.submitRequest();
+        facialLandmarksDetector.submitRequest();
+        antispoofingClassifier.submitRequest();
+
+        // Read the next frame while waiting for inference results
+        startTimeNextFrame = std::chrono::steady_clock::now();
+        nextFrame = cap->read();
+
+        //  Postprocessing
+        for (size_t i = 0; i < detected_faces.size(); i++) {
+            const Face::Ptr& face = detected_faces[i];
+
+            int idx = batch_idxs[Face::AGE_GENDER][i];
+            if (idx >= 0) {
+                AgeGenderDetection::Result ageGenderResult = ageGenderDetector[idx];
                 face->updateGender(ageGenderResult.maleProb);
                 face->updateAge(ageGenderResult.age);
+                face->markUpdated(Face::AGE_GENDER, framesCounter);
             }
 
-            face->emotionsEnable(emotionsDetector.enabled());
-            if (face->isEmotionsEnabled()) {
-                face->updateEmotions(emotionsDetector[i]);
+            idx = batch_idxs[Face::EMOTIONS][i];
+            if (idx >= 0) {
+                face->updateEmotions(emotionsDetector[idx]);
+                face->markUpdated(Face::EMOTIONS, framesCounter);
             }
 
-            face->headPoseEnable(headPoseDetector.enabled());
-            if (face->isHeadPoseEnabled()) {
-                face->updateHeadPose(headPoseDetector[i]);
+            idx = batch_idxs[Face::HEAD_POSE][i];
+            if (idx >= 0) {
+                face->updateHeadPose(headPoseDetector[idx]);
+                face->markUpdated(Face::HEAD_POSE, framesCounter);
             }
 
-            face->landmarksEnable(facialLandmarksDetector.enabled());
-            if (face->isLandmarksEnabled()) {
-                face->updateLandmarks(facialLandmarksDetector[i]);
+            idx = batch_idxs[Face::LANDMARKS][i];
+            if (idx >= 0) {
+                face->updateLandmarks(facialLandmarksDetector[idx]);
+                face->markUpdated(Face::LANDMARKS, framesCounter);
             }
 
-            face->antispoofingEnable(antispoofingClassifier.enabled());
-            if (face->isAntispoofingEnabled()) {
-                face->updateRealFaceConfidence(antispoofingClassifier[i]);
+            idx = batch_idxs[Face::ANTISPOOFING][i];
+            if (idx >= 0) {
+                face->updateRealFaceConfidence(antispoofingClassifier[idx]);
+                face->markUpdated(Face::ANTISPOOFING, framesCounter);
             }
 
             faces.push_back(face);
@@ -294,6 +403,7 @@ int main(int argc, char *argv[]) {
         timer.finish("total");
 
         videoWriter.write(prevFrame);
+        startupProfiler.markFirstResult();
 
         int delay = std::max(1, static_cast<int>(msrate - timer["total"].getLastCallDuration()));
         if (FLAGS_show) {
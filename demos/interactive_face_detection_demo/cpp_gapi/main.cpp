@@ -7,6 +7,7 @@
  * \file interactive_face_detection_demo_gapi/main.cpp
  * \example interactive_face_detection_demo_gapi/main.cpp
  */
+#include <stdint.h>
 #include <stdlib.h>
 
 #include <algorithm>
@@ -41,6 +42,7 @@
 #include <opencv2/gapi/infer/ie.hpp>
 #include <opencv2/gapi/infer/parsers.hpp>
 #include <opencv2/gapi/streaming/format.hpp>
+#include <opencv2/gapi/streaming/meta.hpp>
 #include <opencv2/highgui.hpp>
 #include <opencv2/imgproc.hpp>
 #include <openvino/openvino.hpp>
@@ -51,7 +53,10 @@
 #include <utils/ocv_common.hpp>
 #include <utils/performance_metrics.hpp>
 #include <utils/slog.hpp>
+#include <utils_gapi/batched_infer.hpp>
+#include <utils_gapi/stage_metrics.hpp>
 #include <utils_gapi/stream_source.hpp>
+#include <utils_gapi/streaming.hpp>
 
 #include "face.hpp"
 #include "visualizer.hpp"
@@ -67,6 +72,10 @@ constexpr char i_msg[] =
     "an input to process. The input must be a single image, a folder of images, video file or camera id. Default is 0";
 DEFINE_string(i, "0", i_msg);
 
+constexpr char bs_msg[] = "batch size of the networks inferred on the faces. The faces are packed into the batches, "
+                         "so that N faces take ceil(N / bs) inferences. Default is 1";
+DEFINE_uint32(bs, 1, bs_msg);
+
 constexpr char bb_enlarge_coef_msg[] =
     "coefficient to enlarge/reduce the size of the bounding box around the detected face. Default is 1.2";
 DEFINE_double(bb_enlarge_coef, 1.2, bb_enlarge_coef_msg);
@@ -107,6 +116,10 @@ DEFINE_double(dx_coef, 1, dx_coef_msg);
 constexpr char dy_coef_msg[] = "coefficient to shift the bounding box around the detected face along the Oy axis";
 DEFINE_double(dy_coef, 1, dy_coef_msg);
 
+constexpr char latest_msg[] = "take only the newest result of the graph, dropping the older ones which are ready, "
+                              "if the results are shown slower than they are produced";
+DEFINE_bool(latest, false, latest_msg);
+
 constexpr char lim_msg[] = "number of frames to store in output. If 0 is set, all frames are stored. Default is 1000";
 DEFINE_uint32(lim, 1000, lim_msg);
 
@@ -129,9 +142,28 @@ DEFINE_string(mhp, "", mhp_msg);
 constexpr char mlm_msg[] = "path to an .xml file with a trained Facial Landmarks Estimation model";
 DEFINE_string(mlm, "", mlm_msg);
 
+constexpr char nag_msg[] = "number of infer requests for Age/Gender Recognition network. Default is 1";
+DEFINE_uint32(nag, 1, nag_msg);
+
+constexpr char nam_msg[] = "number of infer requests for Antispoofing Classification network. Default is 1";
+DEFINE_uint32(nam, 1, nam_msg);
+
+constexpr char nem_msg[] = "number of infer requests for Emotions Recognition network. Default is 1";
+DEFINE_uint32(nem, 1, nem_msg);
+
+constexpr char nhp_msg[] = "number of infer requests for Head Pose Estimation network. Default is 1";
+DEFINE_uint32(nhp, 1, nhp_msg);
+
+constexpr char nlm_msg[] = "number of infer requests for Facial Landmarks Estimation network. Default is 1";
+DEFINE_uint32(nlm, 1, nlm_msg);
+
 constexpr char o_msg[] = "name of the output file(s) to save";
 DEFINE_string(o, "", o_msg);
 
+constexpr char qc_msg[] = "capacity of the queues between the nodes of the streaming graph. "
+                          "If 0 is set, the G-API default is used. Default is 0";
+DEFINE_uint32(qc, 0, qc_msg);
+
 constexpr char r_msg[] = "output inference results as raw values";
 DEFINE_bool(r, false, r_msg);
 
@@ -144,6 +176,10 @@ DEFINE_bool(show_emotion_bar, true, show_emotion_bar_msg);
 constexpr char smooth_msg[] = "(don't) smooth person attributes";
 DEFINE_bool(smooth, true, smooth_msg);
 
+constexpr char stage_metrics_msg[] = "report the latencies of the stages of the graph: of the custom kernels and "
+                                     "since the frame was read till every inference is done";
+DEFINE_bool(stage_metrics, false, stage_metrics_msg);
+
 constexpr char t_msg[] = "probability threshold for detections. Default is 0.5";
 DEFINE_double(t, 0.5, t_msg);
 
@@ -159,6 +195,7 @@ void parse(int argc, char* argv[]) {
                   << "\n\t  -m <MODEL FILE>                             " << m_msg
                   << "\n\t[ -i <INPUT>]                                 " << i_msg
                   << "\n\t[--bb_enlarge_coef <NUMBER>]                  " << bb_enlarge_coef_msg
+                  << "\n\t[--bs <NUMBER>]                               " << bs_msg
                   << "\n\t[ -d <DEVICE>]                                " << d_msg
                   << "\n\t[--dag <DEVICE>]                              " << dag_msg
                   << "\n\t[--dam <DEVICE>]                              " << dam_msg
@@ -167,6 +204,7 @@ void parse(int argc, char* argv[]) {
                   << "\n\t[--dlm <DEVICE>]                              " << dlm_msg
                   << "\n\t[--dx_coef <NUMBER>]                          " << dx_coef_msg
                   << "\n\t[--dy_coef <NUMBER>]                          " << dy_coef_msg
+                  << "\n\t[--latest]                                    " << latest_msg
                   << "\n\t[--lim <NUMBER>]                              " << lim_msg
                   << "\n\t[--loop]                                      " << loop_msg
                   << "\n\t[--mag <MODEL FILE>]                          " << mag_msg
@@ -174,11 +212,18 @@ void parse(int argc, char* argv[]) {
                   << "\n\t[--mem <MODEL FILE>]                          " << mem_msg
                   << "\n\t[--mhp <MODEL FILE>]                          " << mhp_msg
                   << "\n\t[--mlm <MODEL FILE>]                          " << mlm_msg
+                  << "\n\t[--nag <NUMBER>]                              " << nag_msg
+                  << "\n\t[--nam <NUMBER>]                              " << nam_msg
+                  << "\n\t[--nem <NUMBER>]                              " << nem_msg
+                  << "\n\t[--nhp <NUMBER>]                              " << nhp_msg
+                  << "\n\t[--nlm <NUMBER>]                              " << nlm_msg
                   << "\n\t[ -o <OUTPUT>]                                " << o_msg
+                  << "\n\t[--qc <NUMBER>]                               " << qc_msg
                   << "\n\t[ -r]                                         " << r_msg
                   << "\n\t[--show] ([--noshow])                         " << show_msg
                   << "\n\t[--show_emotion_bar] ([--noshow_emotion_bar]) " << show_emotion_bar_msg
                   << "\n\t[--smooth] ([--nosmooth])                     " << smooth_msg
+                  << "\n\t[--stage_metrics]                             " << stage_metrics_msg
                   << "\n\t[ -t <NUMBER>]                                " << t_msg
                   << "\n\t[ -u <DEVICE>]                                " << u_msg
                   << "\n\tKey bindings:"
@@ -195,6 +240,12 @@ void parse(int argc, char* argv[]) {
     if (FLAGS_m.empty()) {
         throw std::invalid_argument{"-m <MODEL FILE> can't be empty"};
     }
+    if (FLAGS_bs == 0) {
+        throw std::invalid_argument{"--bs <NUMBER> must be positive"};
+    }
+    if (FLAGS_nag == 0 || FLAGS_nam == 0 || FLAGS_nem == 0 || FLAGS_nhp == 0 || FLAGS_nlm == 0) {
+        throw std::invalid_argument{"number of infer requests must be positive"};
+    }
     slog::info << ov::get_openvino_version() << slog::endl;
 }
 
@@ -224,6 +275,7 @@ GAPI_OCV_KERNEL(OCVPostProc, PostProc) {
                     double bb_dx_coefficient,
                     double bb_dy_coefficient,
                     std::vector<cv::Rect> &out_faces) {
+        custom::ScopedStageTimer timer("Face Detection postprocessing");
         out_faces.clear();
         const cv::Rect surface({0, 0}, frame_size);
         for (const auto& rc : rois) {
@@ -421,6 +473,27 @@ void ASpoofDataUpdate(const Face::Ptr& face, const cv::Mat& out_a_spoof) {
     const auto real_face_conf = as_data[0] * 100;
     face->updateRealFaceConfidence(real_face_conf);
 }
+
+custom::NetInput readFaceNetInput(const std::string& model_path) {
+    return FLAGS_bs > 1 && !model_path.empty() ? custom::readNetInput(model_path) : custom::NetInput{};
+}
+
+template <typename Net>
+typename Net::ResultL inferFaces(const cv::GMat& in, const cv::GArray<cv::Rect>& faces, const custom::NetInput& input) {
+    if (FLAGS_bs > 1) {
+        return custom::inferBatched<Net>(in, faces, input, static_cast<int>(FLAGS_bs));
+    }
+    return cv::gapi::infer<Net>(faces, in);
+}
+
+template <typename Params>
+Params& cfgFaceNet(Params& params, const custom::NetInput& input, uint32_t nireq) {
+    params.cfgNumRequests(nireq);
+    if (FLAGS_bs > 1) {
+        custom::cfgBatch(params, input, FLAGS_bs);
+    }
+    return params;
+}
 }  // namespace
 
 int main(int argc, char* argv[]) {
@@ -437,34 +510,64 @@ int main(int argc, char* argv[]) {
     cv::GArray<cv::Rect> faces = PostProc::on(faces_rects, sz, FLAGS_bb_enlarge_coef, FLAGS_dx_coef, FLAGS_dy_coef);
     auto outs = GOut(cv::gapi::copy(in), detections, faces);
 
+    /** Latencies since the frame was read are the last outputs of the graph, they are computed on request **/
+    cv::GOpaque<int64_t> timestamp = cv::gapi::streaming::timestamp(in);
+    std::vector<std::string> stage_names;
+    std::vector<cv::GOpaque<int64_t>> stage_latencies;
+    auto addStage = [&](const std::string& name, const cv::GOpaque<int64_t>& latency) {
+        if (FLAGS_stage_metrics) {
+            stage_names.push_back(name);
+            stage_latencies.push_back(latency);
+        }
+    };
+    addStage("Face Detection", custom::sourceLatency(detections, timestamp));
+
+    /** Inputs of the networks inferred on the faces are needed to pack the faces into the batches **/
+    const custom::NetInput ag_input = readFaceNetInput(FLAGS_mag);
+    const custom::NetInput hp_input = readFaceNetInput(FLAGS_mhp);
+    const custom::NetInput em_input = readFaceNetInput(FLAGS_mem);
+    const custom::NetInput lm_input = readFaceNetInput(FLAGS_mlm);
+    const custom::NetInput am_input = readFaceNetInput(FLAGS_mam);
+
     cv::GArray<cv::GMat> ages, genders;
     if (!FLAGS_mag.empty()) {
-        std::tie(ages, genders) = cv::gapi::infer<AgeGender>(faces, in);
+        std::tie(ages, genders) = inferFaces<AgeGender>(in, faces, ag_input);
         outs += GOut(ages, genders);
+        addStage("Age/Gender Recognition", custom::sourceLatency(ages, timestamp));
     }
 
     cv::GArray<cv::GMat> y_fc, p_fc, r_fc;
     if (!FLAGS_mhp.empty()) {
-        std::tie(y_fc, p_fc, r_fc) = cv::gapi::infer<HeadPose>(faces, in);
+        std::tie(y_fc, p_fc, r_fc) = inferFaces<HeadPose>(in, faces, hp_input);
         outs += GOut(y_fc, p_fc, r_fc);
+        addStage("Head Pose Estimation", custom::sourceLatency(y_fc, timestamp));
     }
 
     cv::GArray<cv::GMat> emotions;
     if (!FLAGS_mem.empty()) {
-        emotions = cv::gapi::infer<Emotions>(faces, in);
+        emotions = inferFaces<Emotions>(in, faces, em_input);
         outs += GOut(emotions);
+        addStage("Emotions Recognition", custom::sourceLatency(emotions, timestamp));
     }
 
     cv::GArray<cv::GMat> landmarks;
     if (!FLAGS_mlm.empty()) {
-        landmarks = cv::gapi::infer<FacialLandmark>(faces, in);
+        landmarks = inferFaces<FacialLandmark>(in, faces, lm_input);
         outs += GOut(landmarks);
+        addStage("Facial Landmarks Estimation", custom::sourceLatency(landmarks, timestamp));
     }
 
     cv::GArray<cv::GMat> a_spoof;
     if (!FLAGS_mam.empty()) {
-        a_spoof = cv::gapi::infer<ASpoof>(faces, in);
+        a_spoof = inferFaces<ASpoof>(in, faces, am_input);
         outs += GOut(a_spoof);
+        addStage("Antispoofing Classification", custom::sourceLatency(a_spoof, timestamp));
+    }
+    for (const auto& latency : stage_latencies) {
+        outs += GOut(latency);
+    }
+    if (FLAGS_stage_metrics) {
+        outs += GOut(timestamp);
     }
     auto pipeline = cv::GComputation(cv::GIn(in), std::move(outs));
     /** ---------------- End of graph ---------------- **/
@@ -484,6 +587,7 @@ int main(int argc, char* argv[]) {
             FLAGS_dag  // device to use
         }.cfgOutputLayers({"age_conv3", "prob"});
     // clang-format on
+    cfgFaceNet(age_net, ag_input, FLAGS_nag);
 
     if (!FLAGS_mag.empty()) {
         slog::info << "The Age/Gender Recognition model " << FLAGS_mag << " is loaded to " << FLAGS_dag << " device."
@@ -500,6 +604,7 @@ int main(int argc, char* argv[]) {
             FLAGS_dhp  // device to use
         }.cfgOutputLayers({"angle_y_fc", "angle_p_fc", "angle_r_fc"});
     // clang-format on
+    cfgFaceNet(hp_net, hp_input, FLAGS_nhp);
 
     if (!FLAGS_mhp.empty()) {
         slog::info << "The Head Pose Estimation model " << FLAGS_mhp << " is loaded to " << FLAGS_dhp << " device."
@@ -516,6 +621,7 @@ int main(int argc, char* argv[]) {
             FLAGS_dlm  // device to use
         }.cfgOutputLayers({"align_fc3"});
     // clang-format on
+    cfgFaceNet(lm_net, lm_input, FLAGS_nlm);
 
     if (!FLAGS_mlm.empty()) {
         slog::info << "The Facial Landmarks Estimation model " << FLAGS_mlm << " is loaded to " << FLAGS_dlm
@@ -529,6 +635,7 @@ int main(int argc, char* argv[]) {
         fileNameNoExt(FLAGS_mam) + ".bin",  // path to weights
         FLAGS_dam  // device to use
     };
+    cfgFaceNet(am_net, am_input, FLAGS_nam);
     if (!FLAGS_mam.empty()) {
         slog::info << "The Anti Spoof model " << FLAGS_mam << " is loaded to " << FLAGS_dam << " device." << slog::endl;
     } else {
@@ -540,6 +647,7 @@ int main(int argc, char* argv[]) {
         fileNameNoExt(FLAGS_mem) + ".bin",  // path to weights
         FLAGS_dem  // device to use
     };
+    cfgFaceNet(emo_net, em_input, FLAGS_nem);
     if (!FLAGS_mem.empty()) {
         slog::info << "The Emotions Recognition model " << FLAGS_mem << " is loaded to " << FLAGS_dem << " device."
                    << slog::endl;
@@ -548,9 +656,13 @@ int main(int argc, char* argv[]) {
     }
 
     /** Custom kernels **/
-    auto kernels = cv::gapi::kernels<OCVPostProc>();
+    auto kernels = cv::gapi::combine(cv::gapi::kernels<OCVPostProc>(),
+                                     custom::batchedInferKernels(),
+                                     custom::stageMetricsKernels());
     auto networks = cv::gapi::networks(det_net, age_net, hp_net, lm_net, emo_net, am_net);
-    auto stream = pipeline.compileStreaming(cv::compile_args(kernels, networks));
+    auto compile_args = cv::compile_args(kernels, networks);
+    custom::addQueueCapacity(compile_args, FLAGS_qc);
+    auto stream = pipeline.compileStreaming(std::move(compile_args));
 
     /** Output containers for results **/
     cv::Mat frame, ssd_res;
@@ -577,6 +689,15 @@ int main(int argc, char* argv[]) {
     if (!FLAGS_mam.empty())
         out_vector += cv::gout(out_a_spoof);
 
+    std::vector<int64_t> out_stage_latencies(stage_latencies.size());
+    for (auto& latency : out_stage_latencies) {
+        out_vector += cv::gout(latency);
+    }
+    int64_t out_timestamp = 0;
+    if (FLAGS_stage_metrics) {
+        out_vector += cv::gout(out_timestamp);
+    }
+
     Visualizer::Ptr visualizer = std::make_shared<Visualizer>(!FLAGS_mag.empty(),
                                                               !FLAGS_mem.empty(),
                                                               !FLAGS_mhp.empty(),
@@ -598,16 +719,22 @@ int main(int argc, char* argv[]) {
         throw std::runtime_error("Couldn't grab first frame");
     }
     cap = openImagesCapture(FLAGS_i, FLAGS_loop, read_type::safe, 0, FLAGS_lim);
-    /** ---------------- The execution part ---------------- **/
-    stream.setSource<custom::CommonCapSrc>(cap);
-
     /** Save output result **/
     LazyVideoWriter videoWriter{FLAGS_o, cap->fps(), FLAGS_lim};
+    /** ---------------- The execution part ---------------- **/
+    stream.setSource<custom::PrefetchingCapSrc>(cap);
 
     bool isStart = true;
     const auto startTime = std::chrono::steady_clock::now();
     stream.start();
-    while (stream.pull(cv::GRunArgsP(out_vector))) {
+    while (custom::pull(stream, cv::GRunArgsP(out_vector), FLAGS_latest)) {
+        if (FLAGS_stage_metrics) {
+            for (size_t i = 0; i < stage_names.size(); ++i) {
+                custom::stageMetrics().record(stage_names[i], std::chrono::microseconds(out_stage_latencies[i]));
+            }
+            custom::stageMetrics().record("Source to output",
+                                          std::chrono::microseconds(custom::sourceLatency(out_timestamp)));
+        }
         if (!FLAGS_mem.empty() && FLAGS_show_emotion_bar) {
             visualizer->enableEmotionBar(frame.size(), EMOTION_VECTOR);
         }
@@ -719,6 +846,10 @@ int main(int argc, char* argv[]) {
     slog::info << "Metrics report:" << slog::endl;
     slog::info << "\tFPS: " << std::fixed << std::setprecision(1) << metrics.getTotal().fps << slog::endl;
     slog::info << presenter->reportMeans() << slog::endl;
+    if (FLAGS_stage_metrics) {
+        slog::info << "Latencies of the stages:" << slog::endl;
+        custom::stageMetrics().logTotal();
+    }
 
     return 0;
 }
@@ -45,6 +45,10 @@ bool ParseAndCheckCommandLine(int argc, char* argv[]) {
         throw std::logic_error("Parameter -m is not set");
     }
 
+    if (FLAGS_nireq == 0) {
+        throw std::logic_error("Parameter -nireq must be positive");
+    }
+
     return true;
 }
 
@@ -153,18 +157,41 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    auto startTime = std::chrono::steady_clock::now();
+
     // Collect images
     std::vector<cv::Mat> images;
+    for (const std::string& imagePath : imagePaths) {
+        cv::Mat image = cv::imread(imagePath, cv::IMREAD_COLOR);
+
+        if (image.empty()) {
+            slog::warn << "Image " + imagePath + " cannot be read!" << slog::endl;
+            continue;
+        }
 
-    if (modelBatchSize > imagePaths.size()) {
-        slog::warn << "Model batch size is greater than number of images (" << imagePaths.size() <<
+        images.push_back(image);
+    }
+    if (images.empty())
+        throw std::logic_error("Valid input images were not found!");
+
+    // Each infer request processes its part of the images as a batch
+    size_t nireq = FLAGS_nireq;
+    const size_t requestImages = (images.size() + nireq - 1) / nireq;
+    if (modelBatchSize > requestImages) {
+        slog::warn << "Model batch size is greater than number of images per infer request (" << requestImages <<
             "), some input files will be duplicated" << slog::endl;
     }
-    else if (modelBatchSize < imagePaths.size()) {
-        modelBatchSize = imagePaths.size();
-        slog::warn << "Model batch size is less than number of images (" << imagePaths.size() <<
+    else if (modelBatchSize < requestImages) {
+        modelBatchSize = requestImages;
+        slog::warn << "Model batch size is less than number of images per infer request (" << requestImages <<
             "), model will be reshaped" << slog::endl;
     }
+    nireq = (images.size() + modelBatchSize - 1) / modelBatchSize;
+
+    const size_t uniqueImages = images.size();
+    for (size_t i = uniqueImages; i < nireq * modelBatchSize; i++) {
+        images.push_back(images[i % uniqueImages]);
+    }
 
     ov::preprocess::PrePostProcessor ppp(model);
 
@@ -187,96 +214,58 @@ int main(int argc, char* argv[]) {
     ov::set_batch(model, modelBatchSize);
     slog::info << "\tBatch size is set to " << modelBatchSize << slog::endl;
 
-    auto startTime = std::chrono::steady_clock::now();
-    for (size_t i = 0, inputIndex = 0; i < modelBatchSize; i++, inputIndex++) {
-        if (inputIndex >= imagePaths.size()) {
-            inputIndex = 0;
-        }
-
-        cv::Mat image = cv::imread(imagePaths[inputIndex], cv::IMREAD_COLOR);
-
-        if (image.empty()) {
-            slog::warn << "Image " + imagePaths[inputIndex] + " cannot be read!" << slog::endl;
-            continue;
-        }
-
-        images.push_back(image);
-    }
-    if (images.empty())
-        throw std::logic_error("Valid input images were not found!");
-
     // Load model to the device
-    ov::CompiledModel compiled_model = core.compile_model(model, FLAGS_d);
+    ov::AnyMap compileConfig;
+    if (nireq > 1) {
+        compileConfig = {ov::hint::performance_mode(ov::hint::PerformanceMode::THROUGHPUT),
+                         ov::hint::num_requests(static_cast<uint32_t>(nireq))};
+    }
+    ov::CompiledModel compiled_model = core.compile_model(model, FLAGS_d, compileConfig);
     logCompiledModelInfo(compiled_model, FLAGS_m, FLAGS_d);
 
-    // Create Infer Request
-    ov::InferRequest infer_request = compiled_model.create_infer_request();
-
-    // Set image input data
-    for (size_t idx = 0; idx < inputs.size(); idx++) {
-        ov::Tensor tensor = infer_request.get_input_tensor(idx);
-        ov::Shape shape = tensor.get_shape();
-
-        if (shape.size() == 4) {
-            for (size_t batchId = 0; batchId < modelBatchSize; ++batchId) {
-                cv::Size size = {
-                    int(image_tensor_width),
-                    int(image_tensor_height)
-                };
-                unsigned char* data = tensor.data<unsigned char>() + batchId * image_tensor_width * image_tensor_height * 3;
-                cv::Mat image_resized(size, CV_8UC3, data);
-                cv::resize(images[batchId], image_resized, size);
-            }
-        }
-
-        if (shape.size() == 2) {
-            float* data = tensor.data<float>();
-            data[0] = static_cast<float>(image_tensor_height); // height
-            data[1] = static_cast<float>(image_tensor_width); // width
-            data[2] = 1;
-        }
+    // Create Infer Requests
+    std::vector<ov::InferRequest> infer_requests;
+    for (size_t requestId = 0; requestId < nireq; requestId++) {
+        infer_requests.push_back(compiled_model.create_infer_request());
     }
 
     slog::info << "Start inference..." << slog::endl;
-    // Do inference
-    infer_request.infer();
-
-    // Postprocess output data
-    float* boxes_data = nullptr;
-    float* masks_data = nullptr;
-
-    size_t BOX_DESCRIPTION_SIZE = 0;
-
-    size_t BOXES = 0;
-    size_t C = 0;
-    size_t H = 0;
-    size_t W = 0;
+    for (size_t requestId = 0; requestId < nireq; requestId++) {
+        ov::InferRequest& infer_request = infer_requests[requestId];
+        // Set image input data
+        for (size_t idx = 0; idx < inputs.size(); idx++) {
+            ov::Tensor tensor = infer_request.get_input_tensor(idx);
+            ov::Shape shape = tensor.get_shape();
+
+            if (shape.size() == 4) {
+                for (size_t batchId = 0; batchId < modelBatchSize; ++batchId) {
+                    cv::Size size = {
+                        int(image_tensor_width),
+                        int(image_tensor_height)
+                    };
+                    unsigned char* data =
+                        tensor.data<unsigned char>() + batchId * image_tensor_width * image_tensor_height * 3;
+                    cv::Mat image_resized(size, CV_8UC3, data);
+                    cv::resize(images[requestId * modelBatchSize + batchId], image_resized, size);
+                }
+            }
 
-    slog::info << "Processing results..." << slog::endl;
-    for (size_t idx = 0; idx < outputs.size(); idx++) {
-        ov::Tensor tensor = infer_request.get_output_tensor(idx);
-        ov::Shape shape = tensor.get_shape();
-        size_t dims = shape.size();
-        if (dims == 2) {
-            boxes_data = tensor.data<float>();
-            // amount of elements in each detected box description (batch, label, prob, x1, y1, x2, y2)
-            BOX_DESCRIPTION_SIZE = shape[1];
-        }
-        if (dims == 4) {
-            masks_data = tensor.data<float>();
-            BOXES = shape[ov::layout::batch_idx(masks_tensor_layout)];
-            C = shape[ov::layout::channels_idx(masks_tensor_layout)];
-            H = shape[ov::layout::height_idx(masks_tensor_layout)];
-            W = shape[ov::layout::width_idx(masks_tensor_layout)];
+            if (shape.size() == 2) {
+                float* data = tensor.data<float>();
+                data[0] = static_cast<float>(image_tensor_height); // height
+                data[1] = static_cast<float>(image_tensor_width); // width
+                data[2] = 1;
+            }
         }
+
+        // Do inference, the results of the previous requests are processed meanwhile
+        infer_request.start_async();
     }
 
     const float PROBABILITY_THRESHOLD = 0.2f;
     // threshold used to determine whether mask pixel corresponds to object or to background
     const float MASK_THRESHOLD = 0.5f;
 
-    size_t box_stride = W * H * C;
-
     std::map<size_t, size_t> class_color;
 
     std::vector<cv::Mat> output_images;
@@ -284,49 +273,93 @@ int main(int argc, char* argv[]) {
         output_images.push_back(img.clone());
     }
 
-    // Iterating over all boxes
-    for (size_t box = 0; box < BOXES; ++box) {
-        float* box_info = boxes_data + box * BOX_DESCRIPTION_SIZE;
-        auto batch = static_cast<int>(box_info[0]);
+    slog::info << "Processing results..." << slog::endl;
+    for (size_t requestId = 0; requestId < nireq; requestId++) {
+        ov::InferRequest& infer_request = infer_requests[requestId];
+        infer_request.wait();
+
+        // Postprocess output data
+        float* boxes_data = nullptr;
+        float* masks_data = nullptr;
+
+        size_t BOX_DESCRIPTION_SIZE = 0;
+
+        size_t BOXES = 0;
+        size_t C = 0;
+        size_t H = 0;
+        size_t W = 0;
+
+        for (size_t idx = 0; idx < outputs.size(); idx++) {
+            ov::Tensor tensor = infer_request.get_output_tensor(idx);
+            ov::Shape shape = tensor.get_shape();
+            size_t dims = shape.size();
+            if (dims == 2) {
+                boxes_data = tensor.data<float>();
+                // amount of elements in each detected box description (batch, label, prob, x1, y1, x2, y2)
+                BOX_DESCRIPTION_SIZE = shape[1];
+            }
+            if (dims == 4) {
+                masks_data = tensor.data<float>();
+                BOXES = shape[ov::layout::batch_idx(masks_tensor_layout)];
+                C = shape[ov::layout::channels_idx(masks_tensor_layout)];
+                H = shape[ov::layout::height_idx(masks_tensor_layout)];
+                W = shape[ov::layout::width_idx(masks_tensor_layout)];
+            }
+        }
+
+        size_t box_stride = W * H * C;
 
-        if (batch < 0)
-            break;
-        if (batch >= static_cast<int>(modelBatchSize))
-            throw std::logic_error("Invalid batch ID within detection output box");
+        // Iterating over all boxes
+        for (size_t box = 0; box < BOXES; ++box) {
+            float* box_info = boxes_data + box * BOX_DESCRIPTION_SIZE;
+            auto batch = static_cast<int>(box_info[0]);
 
-        float prob = box_info[2];
+            if (batch < 0)
+                break;
+            if (batch >= static_cast<int>(modelBatchSize))
+                throw std::logic_error("Invalid batch ID within detection output box");
 
-        float x1 = clamp(static_cast<float>(images[batch].cols), .0f, box_info[3] * images[batch].cols);
-        float y1 = clamp(static_cast<float>(images[batch].rows), .0f, box_info[4] * images[batch].rows);
-        float x2 = clamp(static_cast<float>(images[batch].cols), .0f, box_info[5] * images[batch].cols);
-        float y2 = clamp(static_cast<float>(images[batch].rows), .0f, box_info[6] * images[batch].rows);
+            float prob = box_info[2];
+            // only the kept detections get their masks resized
+            if (prob <= PROBABILITY_THRESHOLD)
+                continue;
 
-        int box_width = static_cast<int>(x2 - x1);
-        int box_height = static_cast<int>(y2 - y1);
+            const size_t imageId = requestId * modelBatchSize + batch;
+            const cv::Mat& image = images[imageId];
 
-        size_t class_id = static_cast<size_t>(box_info[1] + 1e-6);
+            float x1 = clamp(static_cast<float>(image.cols), .0f, box_info[3] * image.cols);
+            float y1 = clamp(static_cast<float>(image.rows), .0f, box_info[4] * image.rows);
+            float x2 = clamp(static_cast<float>(image.cols), .0f, box_info[5] * image.cols);
+            float y2 = clamp(static_cast<float>(image.rows), .0f, box_info[6] * image.rows);
 
-        if (prob > PROBABILITY_THRESHOLD && box_width > 0 && box_height > 0) {
-            size_t color_index = class_color.emplace(class_id, class_color.size()).first->second;
-            auto& color = CITYSCAPES_COLORS[color_index % arraySize(CITYSCAPES_COLORS)];
-            float* mask_arr = masks_data + box_stride * box + H * W * (class_id - 1);
-            slog::info << "Detected class " << class_id << " with probability " << prob << " from batch " << batch
-                       << ": [" << x1 << ", " << y1 << "], [" << x2 << ", " << y2 << "]" << slog::endl;
-            cv::Mat mask_mat(H, W, CV_32FC1, mask_arr);
+            int box_width = static_cast<int>(x2 - x1);
+            int box_height = static_cast<int>(y2 - y1);
 
-            cv::Rect roi = cv::Rect(static_cast<int>(x1), static_cast<int>(y1), box_width, box_height);
-            cv::Mat roi_input_img = output_images[batch](roi);
-            const float alpha = 0.7f;
+            size_t class_id = static_cast<size_t>(box_info[1] + 1e-6);
 
-            cv::Mat resized_mask_mat(box_height, box_width, CV_32FC1);
-            cv::resize(mask_mat, resized_mask_mat, cv::Size(box_width, box_height));
+            if (box_width > 0 && box_height > 0) {
+                size_t color_index = class_color.emplace(class_id, class_color.size()).first->second;
+                auto& color = CITYSCAPES_COLORS[color_index % arraySize(CITYSCAPES_COLORS)];
+                float* mask_arr = masks_data + box_stride * box + H * W * (class_id - 1);
+                slog::info << "Detected class " << class_id << " with probability " << prob << " from batch " << imageId
+                           << ": [" << x1 << ", " << y1 << "], [" << x2 << ", " << y2 << "]" << slog::endl;
+                cv::Mat mask_mat(H, W, CV_32FC1, mask_arr);
 
-            cv::Mat uchar_resized_mask(box_height, box_width, CV_8UC3,
-                cv::Scalar(color.blue(), color.green(), color.red()));
-            roi_input_img.copyTo(uchar_resized_mask, resized_mask_mat <= MASK_THRESHOLD);
+                cv::Rect roi = cv::Rect(static_cast<int>(x1), static_cast<int>(y1), box_width, box_height);
+                cv::Mat roi_input_img = output_images[imageId](roi);
+                const float alpha = 0.7f;
 
-            cv::addWeighted(uchar_resized_mask, alpha, roi_input_img, 1.0 - alpha, 0.0f, roi_input_img);
-            cv::rectangle(output_images[batch], roi, cv::Scalar(0, 0, 255), 1);
+                cv::Mat resized_mask_mat(box_height, box_width, CV_32FC1);
+                cv::resize(mask_mat, resized_mask_mat, cv::Size(box_width, box_height));
+
+                // blend the ROI with the class color and copy back only the object pixels
+                cv::Mat blended_roi(box_height, box_width, CV_8UC3,
+                    cv::Scalar(color.blue(), color.green(), color.red()));
+                cv::addWeighted(blended_roi, alpha, roi_input_img, 1.0 - alpha, 0.0f, blended_roi);
+                blended_roi.copyTo(roi_input_img, resized_mask_mat > MASK_THRESHOLD);
+
+                cv::rectangle(output_images[imageId], roi, cv::Scalar(0, 0, 255), 1);
+            }
         }
     }
 
@@ -15,6 +15,8 @@ static const char target_device_message[] = "Optional. Specify the target device
                                             "The demo will look for a suitable plugin for a specified device (CPU by default)";
 static const char detection_output_layer_name_message[] = "Optional. The name of detection output layer. Default value is \"reshape_do_2d\"";
 static const char masks_layer_name_message[] = "Optional. The name of masks layer. Default value is \"masks\"";
+static const char num_infer_requests_message[] = "Optional. Number of infer requests. The images are split among them "
+                                                 "and each request infers its part as a batch. Default value is 1";
 
 DEFINE_bool(h, false, help_message);
 DEFINE_string(i, "", image_message);
@@ -22,6 +24,7 @@ DEFINE_string(m, "", model_message);
 DEFINE_string(d, "CPU", target_device_message);
 DEFINE_string(detection_output_name, "reshape_do_2d", detection_output_layer_name_message);
 DEFINE_string(masks_name, "masks", masks_layer_name_message);
+DEFINE_uint32(nireq, 1, num_infer_requests_message);
 
 /**
 * @brief This function show a help message
@@ -37,4 +40,5 @@ static void showUsage() {
     std::cout << "    -d \"<device>\"                     " << target_device_message << std::endl;
     std::cout << "    -detection_output_name \"<string>\" " << detection_output_layer_name_message << std::endl;
     std::cout << "    -masks_name \"<string>\"            " << masks_layer_name_message << std::endl;
+    std::cout << "    -nireq \"<integer>\"                " << num_infer_requests_message << std::endl;
 }
@@ -15,7 +15,7 @@ bool ParseAndCheckCommandLine(int argc, char *argv[]);
 static cv::Mat tensorToMat(const ov::Tensor& tensor);
 
 struct MRIData {
-    cv::Mat data;
+    NpyReader* data;
     cv::Mat samplingMask;
     cv::Mat reconstructed;
     // Hybrid-CS-Model-MRI/Data/stats_fs_unet_norm_20.npy
@@ -60,45 +60,75 @@ int main(int argc, char** argv) {
     ppp.input().model().set_layout("NHWC");
     model = ppp.build();
 
-    ov::CompiledModel compiledModel = core.compile_model(model, FLAGS_d);
+    ov::AnyMap compileConfig;
+    if (FLAGS_nireq > 1) {
+        compileConfig = {ov::hint::performance_mode(ov::hint::PerformanceMode::THROUGHPUT),
+                         ov::hint::num_requests(FLAGS_nireq)};
+    }
+    ov::CompiledModel compiledModel = core.compile_model(model, FLAGS_d, compileConfig);
     logCompiledModelInfo(compiledModel, FLAGS_m, FLAGS_d);
 
-    ov::InferRequest infReq = compiledModel.create_infer_request();
-
     // Hybrid-CS-Model-MRI/Data/sampling_mask_20perc.npy
     MRIData mri;
     mri.samplingMask = blobFromNPY(FLAGS_p);
     slog::info << "Sampling ratio: " << 1.0 - cv::mean(mri.samplingMask)[0] << slog::endl;
 
-    mri.data = blobFromNPY(FLAGS_i);
-    CV_Assert(mri.data.depth() == CV_64F);
-    const int numSlices = mri.data.size[0];
-    const int height = mri.data.size[1];
-    const int width = mri.data.size[2];
-    mri.data /= sqrt(height * width);
+    // The scan is read by slices, only the reconstruction is kept for the whole volume
+    NpyReader scan(FLAGS_i);
+    mri.data = &scan;
+    CV_Assert(scan.getDepth() == CV_64F && scan.getShape().size() == 4);
+    const int numSlices = scan.getShape()[0];
+    const int height = scan.getShape()[1];
+    const int width = scan.getShape()[2];
+    // Slices are normalized by sqrt(height * width) and then by the dataset stats in a single conversion
+    const double inputScale = 1.0 / (sqrt(height * width) * mri.stats[1]);
+    const double inputShift = -mri.stats[0] / mri.stats[1];
 
     mri.reconstructed.create({ numSlices, height, width }, CV_8U);
 
     slog::info << "Compute..." << slog::endl;
 
-    cv::Mat inputBlob = tensorToMat(infReq.get_input_tensor());
-    cv::Mat outputBlob = tensorToMat(infReq.get_tensor(outputTensorName));
-    outputBlob = outputBlob.reshape(1, height);
+    const size_t nireq = std::min<size_t>(FLAGS_nireq, numSlices);
+    std::vector<ov::InferRequest> infReqs;
+    std::vector<cv::Mat> inputBlobs;
+    std::vector<cv::Mat> outputBlobs;
+    for (size_t r = 0; r < nireq; ++r) {
+        infReqs.push_back(compiledModel.create_infer_request());
+        inputBlobs.push_back(tensorToMat(infReqs.back().get_input_tensor()));
+        outputBlobs.push_back(tensorToMat(infReqs.back().get_tensor(outputTensorName)).reshape(1, height));
+    }
+    // Slice inferred by each request, -1 for an idle one
+    std::vector<int> requestSlices(nireq, -1);
+
+    auto savePrediction = [&](size_t r) {
+        infReqs[r].wait();
+        cv::Mat slice(height, width, CV_8UC1, mri.reconstructed.ptr<uint8_t>(requestSlices[r]));
+        cv::normalize(outputBlobs[r], slice, 255, 0, cv::NORM_MINMAX, CV_8U);
+        requestSlices[r] = -1;
+    };
 
     const auto startTime = std::chrono::steady_clock::now();
+    cv::Mat sliceData;
     for (int i = 0; i < numSlices; ++i) {
+        const size_t r = i % nireq;
+        if (requestSlices[r] != -1) {
+            savePrediction(r);
+        }
+
         // Prepare input
-        cv::Mat kspace = cv::Mat(height, width, CV_64FC2, mri.data.ptr<double>(i)).clone();
+        scan.readSlice(i, sliceData);
+        cv::Mat kspace(height, width, CV_64FC2, sliceData.data);
 
         kspace.setTo(0, mri.samplingMask);
-        kspace = (kspace - cv::Scalar(mri.stats[0], mri.stats[0])) / cv::Scalar(mri.stats[1], mri.stats[1]);
-        kspace.reshape(1, 1).convertTo(inputBlob.reshape(1, 1), CV_32F);
+        kspace.reshape(1, 1).convertTo(inputBlobs[r].reshape(1, 1), CV_32F, inputScale, inputShift);
         // Forward pass
-        infReq.infer();
-
-        // Save prediction
-        cv::Mat slice(height, width, CV_8UC1, mri.reconstructed.ptr<uint8_t>(i));
-        cv::normalize(outputBlob, slice, 255, 0, cv::NORM_MINMAX, CV_8U);
+        infReqs[r].start_async();
+        requestSlices[r] = i;
+    }
+    for (size_t r = 0; r < nireq; ++r) {
+        if (requestSlices[r] != -1) {
+            savePrediction(r);
+        }
     }
 
     metrics.update(startTime);
@@ -129,10 +159,13 @@ cv::Mat tensorToMat(const ov::Tensor& tensor) {
 
 void callback(int sliceId, void* userdata) {
     MRIData* mri = reinterpret_cast<MRIData*>(userdata);
-    const int height = mri->data.size[1];
-    const int width = mri->data.size[2];
+    const int height = mri->data->getShape()[1];
+    const int width = mri->data->getShape()[2];
 
-    cv::Mat kspace = cv::Mat(height, width, CV_64FC2, mri->data.ptr<double>(sliceId)).clone();
+    // The images are normalized to [0, 255], so the slice is taken as stored in the file
+    cv::Mat sliceData;
+    mri->data->readSlice(sliceId, sliceData);
+    cv::Mat kspace(height, width, CV_64FC2, sliceData.data);
     cv::Mat img = kspaceToImage(kspace);
 
     kspace.setTo(0, mri->samplingMask);
@@ -189,5 +222,9 @@ bool ParseAndCheckCommandLine(int argc, char *argv[]) {
         throw std::logic_error("Parameter -p is not set");
     }
 
+    if (FLAGS_nireq == 0) {
+        throw std::logic_error("Parameter -nireq must be positive");
+    }
+
     return true;
 }
@@ -16,6 +16,8 @@ static const char target_device_message[] = "Optional. Specify the target device
                                             "GPU, HDDL or MYRIAD is acceptable (CPU by default).";
 static const char pattern_message[] = "Required. Path to sampling mask in .npy format.";
 static const char no_show_message[] = "Optional. Disable results visualization.";
+static const char num_infer_requests_message[] = "Optional. Number of infer requests. The slices are prepared and "
+                                                 "saved while the other requests are inferred. Default value is 1.";
 
 DEFINE_bool(h, false, help_message);
 DEFINE_string(i, "", input_message);
@@ -23,6 +25,7 @@ DEFINE_string(m, "", model_message);
 DEFINE_string(d, "CPU", target_device_message);
 DEFINE_string(p, "", pattern_message);
 DEFINE_bool(no_show, false, no_show_message);
+DEFINE_uint32(nireq, 1, num_infer_requests_message);
 
 /**
 * @brief This function show a help message
@@ -37,5 +40,6 @@ static void showUsage() {
     std::cout << "    -p \"<path>\"                       " << pattern_message << std::endl;
     std::cout << "    -m \"<path>\"                       " << model_message << std::endl;
     std::cout << "    -d \"<device>\"                     " << target_device_message << std::endl;
+    std::cout << "    -nireq \"<integer>\"                " << num_infer_requests_message << std::endl;
     std::cout << "    --no_show                         " << no_show_message << std::endl;
 }
@@ -4,6 +4,8 @@
 #pragma once
 
 #include <fstream>
+#include <string>
+#include <vector>
 
 #include <opencv2/opencv.hpp>
 
@@ -53,40 +55,80 @@ static std::vector<int> getShape(const std::string& header) {
     return shape;
 }
 
-cv::Mat blobFromNPY(const std::string& path) {
-    std::ifstream ifs(path.c_str(), std::ios::binary);
-    CV_Assert(ifs.is_open());
+// Reads a C-ordered .npy file by parts along its first axis, so that large arrays are not held in memory at once
+class NpyReader {
+public:
+    explicit NpyReader(const std::string& path) : ifs(path.c_str(), std::ios::binary) {
+        CV_Assert(ifs.is_open());
+
+        std::string magic(6, '*');
+        ifs.read(&magic[0], magic.size());
+        CV_Assert(magic == "\x93NUMPY");
+
+        ifs.ignore(1);  // Skip major version byte.
+        ifs.ignore(1);  // Skip minor version byte.
+
+        unsigned short headerSize;
+        ifs.read((char*)&headerSize, sizeof(headerSize));
 
-    std::string magic(6, '*');
-    ifs.read(&magic[0], magic.size());
-    CV_Assert(magic == "\x93NUMPY");
+        std::string header(headerSize, '*');
+        ifs.read(&header[0], header.size());
 
-    ifs.ignore(1);  // Skip major version byte.
-    ifs.ignore(1);  // Skip minor version byte.
+        // Extract data type.
+        CV_Assert(getFortranOrder(header) == "False");
+        shape = ::getShape(header);
+
+        std::string dataType = getType(header);
+        if (dataType == "<f4")
+            depth = CV_32F;
+        else if (dataType == "|b1")
+            depth = CV_8U;
+        else if (dataType == "<f8")
+            depth = CV_64F;
+        else
+            throw std::logic_error("Unexpected numpy data type: " + dataType);
+
+        dataOffset = ifs.tellg();
+    }
 
-    unsigned short headerSize;
-    ifs.read((char*)&headerSize, sizeof(headerSize));
+    const std::vector<int>& getShape() const {
+        return shape;
+    }
 
-    std::string header(headerSize, '*');
-    ifs.read(&header[0], header.size());
+    int getDepth() const {
+        return depth;
+    }
 
-    // Extract data type.
-    CV_Assert(getFortranOrder(header) == "False");
-    std::vector<int> shape = getShape(header);
+    // Reads the subarray with the given index along the first axis, reusing the memory of slice if it fits
+    void readSlice(int index, cv::Mat& slice) {
+        CV_Assert(index >= 0 && index < shape[0]);
+        std::vector<int> sliceShape(shape.begin() + 1, shape.end());
+        if (sliceShape.empty())
+            sliceShape.push_back(1);
+        slice.create(sliceShape, depth);
+        read(dataOffset + std::streamoff(index) * std::streamoff(slice.total() * slice.elemSize()), slice);
+    }
 
-    std::string dataType = getType(header);
-    cv::Mat blob;
-    if (dataType == "<f4")
-        blob.create(shape, CV_32F);
-    else if (dataType == "|b1")
-        blob.create(shape, CV_8U);
-    else if (dataType == "<f8")
-        blob.create(shape, CV_64F);
-    else
-        throw std::logic_error("Unexpected numpy data type: " + dataType);
+    cv::Mat readAll() {
+        cv::Mat blob(shape, depth);
+        read(dataOffset, blob);
+        return blob;
+    }
 
-    ifs.read((char*)blob.data, blob.total() * blob.elemSize());
-    CV_Assert((size_t)ifs.gcount() == blob.total() * blob.elemSize());
+private:
+    std::ifstream ifs;
+    std::vector<int> shape;
+    int depth;
+    std::streamoff dataOffset;
+
+    void read(std::streamoff offset, cv::Mat& blob) {
+        ifs.clear();
+        ifs.seekg(offset);
+        ifs.read((char*)blob.data, blob.total() * blob.elemSize());
+        CV_Assert((size_t)ifs.gcount() == blob.total() * blob.elemSize());
+    }
+};
 
-    return blob;
+cv::Mat blobFromNPY(const std::string& path) {
+    return NpyReader(path).readAll();
 }
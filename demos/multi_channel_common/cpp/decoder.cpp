@@ -6,6 +6,8 @@
 
 #include "perf_timer.hpp"
 
+#include <utils/itt.hpp>
+
 #include <atomic>
 #include <algorithm>
 #include <array>
@@ -329,7 +331,8 @@ struct Decoder::HwContext {
     struct Context {
         VAContextID decode_context = InvalidId;
         VAContextID convert_context = InvalidId;
-        FreeSurfQueue available_surfaces;
+        // Shared with kept surfaces, which may outlive the decoder
+        std::shared_ptr<FreeSurfQueue> available_surfaces = std::make_shared<FreeSurfQueue>();
     };
 
     tbb::concurrent_unordered_map<unsigned, Context> contexts;
@@ -338,7 +341,7 @@ struct Decoder::HwContext {
         VASurfaceID decode_surface = InvalidId;
         VASurfaceID convert_surface = InvalidId;
         callback_t callback;
-        FreeSurfQueue* available_surfaces = nullptr;
+        std::shared_ptr<FreeSurfQueue> available_surfaces;
         clock::time_point start_time = {};
     };
     tbb::concurrent_bounded_queue<BusySurfDesc> busy_surfaces;
@@ -432,10 +435,21 @@ struct Decoder::HwContext {
                     perf_timer_decode.addValue(duration);
                 }
 
-                desc.available_surfaces->push(FreeSurfDesc{
-                                                  desc.decode_surface,
-                                                  desc.convert_surface});
-                desc.callback(std::move(mat));
+                const FreeSurfDesc freeSurf{desc.decode_surface, desc.convert_surface};
+                Decoder::SurfacePtr surface;
+                if (settings.keep_surfaces) {
+                    auto available_surfaces = std::move(desc.available_surfaces);
+                    surface.reset(new Decoder::Surface{va_display.get(), desc.convert_surface,
+                                                       static_cast<unsigned>(image.width),
+                                                       static_cast<unsigned>(image.height)},
+                                  [available_surfaces, freeSurf](const Decoder::Surface* s) {
+                                      available_surfaces->push(freeSurf);
+                                      delete s;
+                                  });
+                } else {
+                    desc.available_surfaces->push(freeSurf);
+                }
+                desc.callback(std::move(mat), std::move(surface));
             }
         });
     }
@@ -452,7 +466,7 @@ struct Decoder::HwContext {
         convert_surf_attrib.type  = VASurfaceAttribPixelFormat;
         convert_surf_attrib.flags = VA_SURFACE_ATTRIB_SETTABLE;
         convert_surf_attrib.value.type = VAGenericValueTypeInteger;
-        convert_surf_attrib.value.value.i = VA_FOURCC_422H;
+        convert_surf_attrib.value.value.i = settings.keep_surfaces ? VA_FOURCC_NV12 : VA_FOURCC_422H;
 
         std::vector<VASurfaceID> decode_surfaces;
         std::vector<VASurfaceID> convert_surfaces;
@@ -462,16 +476,18 @@ struct Decoder::HwContext {
                                   width, height,
                                   decode_surfaces.data(), settings.num_buffers,
                                   &decode_surf_attrib, 1));
-        CHECK_VA(vaCreateSurfaces(va_display.get(), VA_RT_FORMAT_RGB32,
+        // GPU plugin reads NV12 surfaces
+        CHECK_VA(vaCreateSurfaces(va_display.get(),
+                                  settings.keep_surfaces ? VA_RT_FORMAT_YUV420 : VA_RT_FORMAT_RGB32,
                                   settings.output_width, settings.output_height,
                                   convert_surfaces.data(), settings.num_buffers,
-                                  &convert_surf_attrib, 0));
+                                  &convert_surf_attrib, settings.keep_surfaces ? 1 : 0));
 
         for (unsigned i = 0; i < settings.num_buffers; ++i) {
             FreeSurfDesc freeSurf = {};
             freeSurf.decode_surface  = decode_surfaces[i];
             freeSurf.convert_surface = convert_surfaces[i];
-            ret.available_surfaces.push(std::move(freeSurf));
+            ret.available_surfaces->push(std::move(freeSurf));
         }
 
         auto createConfig = [this](
@@ -834,7 +850,7 @@ struct Decoder::HwContext {
         }
         Context& ctx = it->second;
 
-        auto available_surfaces = &ctx.available_surfaces;
+        auto available_surfaces = ctx.available_surfaces;
 
         std::array<VABufferID, MaxBuffers> buffers;
         std::fill_n(buffers.begin(), buffers.size(), InvalidId);
@@ -879,7 +895,8 @@ struct Decoder::HwContext {
 #endif
 
 Decoder::Decoder(const Settings& s):
-    settings(s) {
+    settings(s),
+    decode_timer(s.collect_stats ? PerfTimer::DefaultIterationsCount : 0) {
     if (Mode::Hw == settings.mode) {
 #ifdef USE_LIBVA
         hw_context.reset(new HwContext(settings));
@@ -887,6 +904,11 @@ Decoder::Decoder(const Settings& s):
         throw std::logic_error("Hardware decoding is not supported");
 #endif
     }
+#ifndef USE_TBB
+    if (Mode::Async == settings.mode) {
+        thread_pool.reset(new ThreadPool(settings.num_threads, settings.thread_affinity));
+    }
+#endif
 }
 
 Decoder::~Decoder() {
@@ -898,12 +920,38 @@ Decoder::Stats Decoder::getStats() const {
         return {hw_context->getLatency()};
     }
 #endif
-    return {};
+    Stats stats;
+    stats.decoding_latency = decode_timer.getValue();
+    return stats;
+}
+
+void* Decoder::getVaDisplay() const {
+#ifdef USE_LIBVA
+    if (nullptr != hw_context && settings.keep_surfaces) {
+        return hw_context->va_display.get();
+    }
+#endif
+    return nullptr;
+}
+
+cv::Mat Decoder::decode_image(const void* data, size_t size) {
+    ITT_SCOPED_TASK("Decoder::decode");
+    const auto start = std::chrono::high_resolution_clock::now();
+    auto img = cv::imdecode(
+    {static_cast<const char*>(data),
+     static_cast<int>(size)},
+                   cv::IMREAD_COLOR);
+    if (decode_timer.enabled()) {
+        std::unique_lock<std::mutex> lock(stats_mutex);
+        decode_timer.addValue(std::chrono::high_resolution_clock::now() - start);
+    }
+    return img;
 }
 
 #ifdef USE_LIBVA
 void Decoder::decode_hw(const void* data, size_t size, unsigned width,
                         unsigned height, callback_t callback) {
+    ITT_SCOPED_TASK("Decoder::decode");
     assert(nullptr != hw_context);
     hw_context->decode(data, size, width, height, std::move(callback));
 }
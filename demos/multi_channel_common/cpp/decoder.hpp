@@ -7,14 +7,15 @@
 #include <cassert>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <opencv2/opencv.hpp>
 
-#ifdef USE_TBB
+#include "perf_timer.hpp"
 #include "threading.hpp"
-#endif
 
 class Decoder final {
 public:
@@ -30,8 +31,24 @@ public:
         unsigned output_height = 0;
         unsigned num_buffers = 1;
         bool collect_stats = false;
+        // Async mode without TBB decodes on a thread pool of num_threads (0 - number of cores) threads pinned to
+        // thread_affinity cores (empty - not pinned)
+        unsigned num_threads = 0;
+        std::vector<int> thread_affinity;
+        // Hw mode converts frames to NV12 and passes their VA surfaces along with cv::Mat, so inference can read frames
+        // on the device
+        bool keep_surfaces = false;
     };
 
+    // Decoded frame on the device. The decoder reuses the surface after the last reference is released.
+    struct Surface {
+        void* display;  // VADisplay
+        unsigned id;  // VASurfaceID
+        unsigned width;
+        unsigned height;
+    };
+    using SurfacePtr = std::shared_ptr<const Surface>;
+
     explicit Decoder(const Settings& s);
     Decoder(const Decoder&) = delete;
     Decoder& operator =(const Decoder&) = delete;
@@ -43,6 +60,9 @@ public:
 
     Stats getStats() const;
 
+    // Returns VADisplay the surfaces belong to if they are kept, otherwise nullptr
+    void* getVaDisplay() const;
+
     template<typename F>
     void decode(const void* data, size_t size, unsigned width, unsigned height,
                 F&& callback) {
@@ -53,30 +73,21 @@ public:
 
         auto mode = settings.mode;
         if (Mode::Immediate == mode) {
-            auto img = cv::imdecode(
-            {static_cast<const char*>(data),
-             static_cast<int>(size)},
-                           cv::IMREAD_COLOR);
-            callback(std::move(img));
+            callback(decode_image(data, size), nullptr);
         } else if (Mode::Async == mode) {
+            DecodeTask<typename std::decay<F>::type> decode{this, data, size, std::forward<F>(callback)};
 #ifdef USE_TBB
-            auto decode = [data, size, c = std::move(callback), this]() mutable {
-                auto img = cv::imdecode(
-                {static_cast<const char*>(data),
-                 static_cast<int>(size)},
-                            cv::IMREAD_COLOR);
-                c(std::move(img));
-            };
             auto& arena = get_tbb_arena();
             arena.enqueue(std::move(decode));
 #else
-            throw std::logic_error("Async decoding is not supported");
+            assert(nullptr != thread_pool);
+            thread_pool->submit(make_copyable(std::move(decode)));
 #endif
         } else if (Mode::Hw == mode) {
 #ifdef USE_LIBVA
             auto decode = [data, size, c = std::move(callback), this]
-                          (cv::Mat&& img) mutable {
-                c(std::move(img));
+                          (cv::Mat&& img, SurfacePtr surface) mutable {
+                c(std::move(img), std::move(surface));
             };
             decode_hw(data, size, width, height,
                       make_copyable(std::move(decode)));
@@ -90,8 +101,29 @@ public:
 
 private:
     const Settings settings;
-#ifdef USE_LIBVA
-    struct HwContext;
+
+    std::mutex stats_mutex;
+    PerfTimer decode_timer;
+
+    cv::Mat decode_image(const void* data, size_t size);
+
+    template<typename F>
+    struct DecodeTask {
+        Decoder* decoder;
+        const void* data;
+        size_t size;
+        F callback;
+
+        void operator()() {
+            callback(decoder->decode_image(data, size), nullptr);
+        }
+    };
+
+#ifndef USE_TBB
+    std::unique_ptr<ThreadPool> thread_pool;
+#endif
+
+    // Wraps move-only functors into std::function
     template<typename T>
     struct MoveHack {
         union {
@@ -119,7 +151,10 @@ private:
         return MoveHack<typename std::remove_reference<T>::type>{std::move(val)};
     }
 
-    using callback_t = std::function<void(cv::Mat&&)>;
+#ifdef USE_LIBVA
+    struct HwContext;
+
+    using callback_t = std::function<void(cv::Mat&&, SurfacePtr)>;
 
     std::unique_ptr<HwContext> hw_context;
 
@@ -0,0 +1,165 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "fanout.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <utility>
+#include <vector>
+
+FrameFanOut::FrameFanOut(VideoSources& sources, size_t duplicateNum):
+    sources(sources),
+    channelsNum(sources.numberOfInputs() * duplicateNum),
+    duplicateNum(duplicateNum) {
+    assert(duplicateNum > 0);
+}
+
+FrameFanOut::~FrameFanOut() {
+    stop();
+}
+
+size_t FrameFanOut::subscribe(size_t queueSize, DropPolicy policy) {
+    assert(queueSize > 0);
+    assert(!readingThread.joinable());
+    Consumer consumer;
+    consumer.queueSize = queueSize;
+    consumer.policy = policy;
+    consumers.push_back(std::move(consumer));
+    return consumers.size() - 1;
+}
+
+void FrameFanOut::start() {
+    assert(!consumers.empty());
+    readingThread = std::thread(&FrameFanOut::readingThreadFunc, this);
+}
+
+void FrameFanOut::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+    hasSpace.notify_one();
+    hasFrames.notify_all();
+    if (readingThread.joinable()) {
+        readingThread.join();
+    }
+}
+
+bool FrameFanOut::canPush() const {
+    // Blocking consumers should have space, the others drop frames. Without blocking consumers the reading is paced
+    // by the fastest consumer, because live sources repeat the last frame instead of waiting for a new one.
+    bool hasFreeQueue = false;
+    for (const Consumer& consumer : consumers) {
+        const bool isFull = consumer.frames.size() >= consumer.queueSize;
+        if (isFull && DropPolicy::Block == consumer.policy) {
+            return false;
+        }
+        hasFreeQueue = hasFreeQueue || !isFull;
+    }
+    return hasFreeQueue;
+}
+
+void FrameFanOut::readingThreadFunc() {
+    size_t frameId = 0;
+    size_t channel = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            hasSpace.wait(lock, [&]() {
+                return canPush() || stopped;
+            });
+            if (stopped) {
+                break;
+            }
+        }
+
+        std::shared_ptr<VideoFrame> frame = std::make_shared<VideoFrame>();
+        const bool success = sources.getFrame(channel / duplicateNum, *frame);
+        frame->sourceIdx = channel;
+        frame->frameId = frameId++;
+        channel = (channel + 1) % channelsNum;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!success) {
+            break;
+        }
+        for (Consumer& consumer : consumers) {
+            if (consumer.frames.size() >= consumer.queueSize) {
+                assert(DropPolicy::DropOldest == consumer.policy);
+                consumer.frames.pop_front();
+                ++consumer.droppedFrames;
+            }
+            consumer.frames.push_back(frame);
+        }
+        hasFrames.notify_all();
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    finished = true;
+    hasFrames.notify_all();
+}
+
+bool FrameFanOut::getFrame(size_t consumerIdx, VideoFrame& frame) {
+    assert(consumerIdx < consumers.size());
+    Consumer& consumer = consumers[consumerIdx];
+    std::shared_ptr<const VideoFrame> sharedFrame;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        hasFrames.wait(lock, [&]() {
+            return !consumer.frames.empty() || finished || stopped;
+        });
+        if (consumer.frames.empty()) {
+            return false;
+        }
+        sharedFrame = std::move(consumer.frames.front());
+        consumer.frames.pop_front();
+    }
+    hasSpace.notify_one();
+    // Consumers set their own detections, the image data is shared
+    frame.frame = sharedFrame->frame;
+    frame.timestamp = sharedFrame->timestamp;
+    frame.surface = sharedFrame->surface;
+    frame.sourceIdx = sharedFrame->sourceIdx;
+    frame.frameId = sharedFrame->frameId;
+    return true;
+}
+
+size_t FrameFanOut::getDroppedFramesNum(size_t consumer) {
+    assert(consumer < consumers.size());
+    std::lock_guard<std::mutex> lock(mutex);
+    return consumers[consumer].droppedFrames;
+}
+
+bool FrameFanOut::isRunning() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return !finished || std::any_of(consumers.begin(), consumers.end(), [](const Consumer& consumer) {
+        return !consumer.frames.empty();
+    });
+}
+
+ResultsMerger::ResultsMerger(size_t consumersNum):
+    nextFrameIds(consumersNum, 0) {
+    assert(consumersNum > 0);
+}
+
+std::vector<std::vector<std::shared_ptr<VideoFrame>>> ResultsMerger::push(size_t consumer,
+                                                                          const std::shared_ptr<VideoFrame>& frame) {
+    assert(consumer < nextFrameIds.size());
+    std::lock_guard<std::mutex> lock(mutex);
+    assert(frame->frameId >= nextFrameIds[consumer]);
+    auto& frames = pendingFrames[frame->frameId];
+    frames.resize(nextFrameIds.size());
+    frames[consumer] = frame;
+    nextFrameIds[consumer] = frame->frameId + 1;
+
+    // Frames before the slowest consumer are complete, the consumers which don't have them dropped them
+    const size_t completeFrameId = *std::min_element(nextFrameIds.begin(), nextFrameIds.end());
+    std::vector<std::vector<std::shared_ptr<VideoFrame>>> completeFrames;
+    while (!pendingFrames.empty() && pendingFrames.begin()->first < completeFrameId) {
+        completeFrames.push_back(std::move(pendingFrames.begin()->second));
+        pendingFrames.erase(pendingFrames.begin());
+    }
+    return completeFrames;
+}
@@ -0,0 +1,88 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "input.hpp"
+
+// Distributes frames of VideoSources to several consumers, e.g. IEGraphs of different models, so every input is
+// decoded once. Every consumer receives its own VideoFrame, frames of consumers share the image data and frameId.
+class FrameFanOut {
+public:
+    enum class DropPolicy {
+        Block,  // the reading waits until the consumer takes frames out of its queue
+        DropOldest  // the oldest frame in the full queue of the consumer is dropped
+    };
+
+    // duplicateNum - number of channels every input is distributed to, channel i reads input i / duplicateNum
+    FrameFanOut(VideoSources& sources, size_t duplicateNum);
+    FrameFanOut(const FrameFanOut&) = delete;
+    FrameFanOut& operator =(const FrameFanOut&) = delete;
+    ~FrameFanOut();
+
+    // Adds a consumer and returns its index. Should be called before start().
+    size_t subscribe(size_t queueSize, DropPolicy policy);
+
+    // Starts reading the sources in a round robin
+    void start();
+
+    // Getter for IEGraph::start() of the consumer. Returns false if the sources are out of frames.
+    bool getFrame(size_t consumer, VideoFrame& frame);
+
+    bool isRunning();
+
+    // Returns number of frames dropped from the queue of the consumer
+    size_t getDroppedFramesNum(size_t consumer);
+
+private:
+    struct Consumer {
+        size_t queueSize;
+        DropPolicy policy;
+        std::deque<std::shared_ptr<const VideoFrame>> frames;
+        size_t droppedFrames = 0;
+    };
+
+    bool canPush() const;
+    void readingThreadFunc();
+    void stop();
+
+    VideoSources& sources;
+    const size_t channelsNum;
+    const size_t duplicateNum;
+    std::vector<Consumer> consumers;
+
+    std::mutex mutex;
+    std::condition_variable hasSpace;
+    std::condition_variable hasFrames;
+    bool finished = false;
+    bool stopped = false;
+    std::thread readingThread;
+};
+
+// Gathers frames inferred by consumers of FrameFanOut, so results of all models for a frame are output together
+class ResultsMerger {
+public:
+    explicit ResultsMerger(size_t consumersNum);
+
+    // Adds a frame inferred by the consumer, consumers should add frames in the order they got them from FrameFanOut.
+    // Returns frames whose results are gathered, in the frameId order. Every returned element has a frame of every
+    // consumer, it is nullptr if the consumer dropped the frame.
+    std::vector<std::vector<std::shared_ptr<VideoFrame>>> push(size_t consumer,
+                                                               const std::shared_ptr<VideoFrame>& frame);
+
+private:
+    std::mutex mutex;
+    std::map<size_t, std::vector<std::shared_ptr<VideoFrame>>> pendingFrames;
+    // Frames are complete if every consumer has passed them
+    std::vector<size_t> nextFrameIds;
+};
@@ -4,7 +4,13 @@
 
 #include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
@@ -12,23 +18,195 @@
 #include "graph.hpp"
 #include "threading.hpp"
 
+#include <utils/itt.hpp>
+
+#ifdef USE_TBB
+#include <tbb/parallel_for.h>
+#include <tbb/task_group.h>
+#endif
+
+#ifdef USE_LIBVA
+#include <openvino/runtime/intel_gpu/ocl/va.hpp>
+#include <openvino/runtime/intel_gpu/properties.hpp>
+#endif
+
 namespace {
-void framesToTensor(const std::vector<std::shared_ptr<VideoFrame>>& frames, const ov::Tensor& tensor) {
+#ifdef USE_LIBVA
+// Sets surfaces of frames as Y and UV inputs of the request created by compileForVaSurfaces()
+void surfacesToTensors(const std::vector<std::shared_ptr<VideoFrame>>& frames, ov::InferRequest& req) {
+    ov::CompiledModel compiled = req.get_compiled_model();
+    auto context = compiled.get_context().as<ov::intel_gpu::ocl::VAContext>();
+    const std::vector<ov::Output<const ov::Node>> inputs = compiled.inputs();
+    assert(2 == inputs.size());
+    std::vector<ov::Tensor> yTensors;
+    std::vector<ov::Tensor> uvTensors;
+    for (const auto& frame : frames) {
+        assert(nullptr != frame->surface);
+        const Decoder::Surface& surface = *frame->surface;
+        auto nv12 = context.create_tensor_nv12(surface.height, surface.width, static_cast<VASurfaceID>(surface.id));
+        yTensors.push_back(nv12.first);
+        uvTensors.push_back(nv12.second);
+    }
+    if (1 == frames.size()) {
+        req.set_tensor(inputs[0], yTensors.front());
+        req.set_tensor(inputs[1], uvTensors.front());
+    } else {
+        req.set_tensors(inputs[0], yTensors);
+        req.set_tensors(inputs[1], uvTensors);
+    }
+}
+#endif
+}  // namespace
+
+void IEGraph::setInputs(const std::vector<std::shared_ptr<VideoFrame>>& frames, ov::InferRequest& req) {
+#ifdef USE_LIBVA
+    if (nullptr != frames.front()->surface) {
+        surfacesToTensors(frames, req);
+        return;
+    }
+#endif
+    framesToTensor(frames, req.get_input_tensor());
+}
+
+void IEGraph::framesToTensor(const std::vector<std::shared_ptr<VideoFrame>>& frames, const ov::Tensor& tensor) {
     static const ov::Layout layout{"NHWC"};
-    static const ov::Shape shape = tensor.get_shape();
-    static const size_t batchSize = shape[ov::layout::batch_idx(layout)];
-    static const cv::Size inSize{int(shape[ov::layout::width_idx(layout)]), int(shape[ov::layout::height_idx(layout)])};
-    static const size_t channels = shape[ov::layout::channels_idx(layout)];
-    static const size_t batchOffset = inSize.area() * channels;
+    const ov::Shape shape = tensor.get_shape();
+    const size_t batchSize = shape[ov::layout::batch_idx(layout)];
+    const cv::Size inSize{int(shape[ov::layout::width_idx(layout)]), int(shape[ov::layout::height_idx(layout)])};
+    const size_t channels = shape[ov::layout::channels_idx(layout)];
+    const size_t batchOffset = inSize.area() * channels;
     assert(batchSize == frames.size());
     assert(channels == 3);
     uint8_t* data = tensor.data<uint8_t>();
+    auto packFrame = [&](size_t i) {
+        const cv::Mat& frame = frames[i]->frame;
+        assert(frame.channels() == channels);
+        cv::Mat slot{inSize, CV_8UC3, static_cast<void*>(data + batchOffset * i)};
+        if (frame.size() == inSize) {
+            frame.copyTo(slot);
+        } else {
+            cv::resize(frame, slot, inSize);
+        }
+    };
+    if (1 == batchSize) {
+        packFrame(0);
+        return;
+    }
+    auto groupOf = [&](size_t i) -> size_t {
+        return nullptr == placement ? 0 : placement->groupOf(frames[i]->sourceIdx);
+    };
+#ifdef USE_TBB
+    if (nullptr == placement) {
+        run_in_arena([&]() {
+            tbb::parallel_for<size_t>(0, batchSize, packFrame);
+        });
+        return;
+    }
+    std::vector<std::vector<size_t>> groupFrames(packingArenas.size());
     for (size_t i = 0; i < batchSize; ++i) {
-        assert(frames[i]->frame.channels() == channels);
-        cv::resize(frames[i]->frame, cv::Mat{inSize, CV_8UC3, static_cast<void*>(data + batchOffset * i)}, inSize);
+        groupFrames[groupOf(i)].push_back(i);
+    }
+    // Groups are packed concurrently, each in the arena of its node
+    std::vector<tbb::task_group> groupTasks(packingArenas.size());
+    for (size_t g = 0; g < packingArenas.size(); ++g) {
+        packingArenas[g]->execute([&, g]() {
+            groupTasks[g].run([&, g]() {
+                tbb::parallel_for<size_t>(0, groupFrames[g].size(), [&, g](size_t j) {
+                    packFrame(groupFrames[g][j]);
+                });
+            });
+        });
+    }
+    for (size_t g = 0; g < packingArenas.size(); ++g) {
+        packingArenas[g]->execute([&, g]() {
+            groupTasks[g].wait();
+        });
     }
+#else
+    assert(!packingPools.empty());
+    parallelFor(batchSize, [&](size_t i) -> ThreadPool& {
+        return *packingPools[groupOf(i)];
+    }, packFrame);
+#endif
+}
+
+DeviceBudget::DeviceBudget(std::vector<float> weights):
+    weights(std::move(weights)),
+    weightsSum(std::accumulate(this->weights.begin(), this->weights.end(), 0.0f)) {
+    assert(!this->weights.empty());
+    assert(std::all_of(this->weights.begin(), this->weights.end(), [](float weight) {return weight > 0.0f;}));
+}
+
+ov::AnyMap DeviceBudget::next(const std::string& device) {
+    if (nextModel >= weights.size()) {
+        throw std::logic_error("DeviceBudget has no share for model " + std::to_string(nextModel));
+    }
+    const float weight = weights[nextModel++];
+    if (device != "CPU") {
+        slog::info << "	The model doesn't share threads on " << device << slog::endl;
+        return {};
+    }
+    // Bounds of shares are rounded, so shares of all models sum up to the number of threads
+    const int threadsNum = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+    const int first = static_cast<int>(threadsNum * reservedWeights / weightsSum);
+    reservedWeights += weight;
+    const int last = static_cast<int>(threadsNum * reservedWeights / weightsSum);
+    const int modelThreads = std::max(last - first, 1);
+    slog::info << "	The model gets " << modelThreads << " of " << threadsNum << " CPU threads" << slog::endl;
+    return {ov::inference_num_threads(modelThreads)};
+}
+
+std::queue<ov::InferRequest> compileForVaSurfaces(std::shared_ptr<ov::Model>&& model, const std::string& modelPath,
+        const std::string& device, size_t performanceHintNumRequests, ov::Core& core, void* vaDisplay) {
+#ifdef USE_LIBVA
+    assert(nullptr != vaDisplay);
+    if (device.find("GPU") != 0) {
+        throw std::logic_error("Inference on VA surfaces requires GPU device");
+    }
+    // The model input is BGR NHWC after the preprocessing set by the demo
+    ov::preprocess::PrePostProcessor ppp(model);
+    ppp.input().tensor().set_element_type(ov::element::u8)
+        .set_color_format(ov::preprocess::ColorFormat::NV12_TWO_PLANES, {"y", "uv"})
+        .set_memory_type(ov::intel_gpu::memory_type::surface);
+    ppp.input().preprocess().convert_color(ov::preprocess::ColorFormat::BGR);
+    ppp.input().model().set_layout("NHWC");
+    model = ppp.build();
+
+    auto context = ov::intel_gpu::ocl::VAContext(core, static_cast<VADisplay>(vaDisplay));
+    ov::CompiledModel compiled = core.compile_model(model, context, {
+        {ov::hint::performance_mode(ov::hint::PerformanceMode::THROUGHPUT)},
+        {ov::hint::num_requests(performanceHintNumRequests)}});
+    unsigned maxRequests = compiled.get_property(ov::optimal_number_of_infer_requests) + 1;
+    logCompiledModelInfo(compiled, modelPath, device);
+    slog::info << "\tNumber of network inference requests: " << std::to_string(maxRequests) << slog::endl;
+    slog::info << "\tFrames are inferred on VA surfaces" << slog::endl;
+    std::queue<ov::InferRequest> reqQueue;
+    for (unsigned i = 0; i < maxRequests; ++i) {
+        reqQueue.push(compiled.create_infer_request());
+    }
+    return reqQueue;
+#else
+    (void)model;
+    (void)modelPath;
+    (void)device;
+    (void)performanceHintNumRequests;
+    (void)core;
+    (void)vaDisplay;
+    throw std::logic_error("Inference on VA surfaces requires building with libva");
+#endif
+}
+
+void IEGraph::setBatchTimeout(std::chrono::milliseconds timeout, ReadyFunc readyFunc) {
+    assert(nullptr != readyFunc);
+    assert(nullptr == getter);
+    batchTimeout = timeout;
+    isReady = std::move(readyFunc);
+}
+
+void IEGraph::setPlacement(const ChannelPlacement& channelPlacement) {
+    assert(nullptr == getter);
+    placement.reset(new ChannelPlacement(channelPlacement));
 }
-}  // namespace
 
 void IEGraph::start(size_t batchSize, GetterFunc getterFunc, PostprocessingFunc postprocessingFunc) {
     assert(batchSize > 0);
@@ -37,15 +215,50 @@ void IEGraph::start(size_t batchSize, GetterFunc getterFunc, PostprocessingFunc
     assert(nullptr == getter);
     getter = std::move(getterFunc);
     postprocessing = std::move(postprocessingFunc);
+    if (batchSize > 1) {
+        const size_t groupsNum = nullptr == placement ? 1 : placement->groupsNum();
+        for (size_t g = 0; g < groupsNum; ++g) {
+            const std::vector<int> cores = nullptr == placement ? std::vector<int>{} : placement->node(g).cores;
+            // One worker per frame of a batch, ThreadPool treats 0 reported by hardware_concurrency() as its default
+            const size_t coresNum = cores.empty() ? std::thread::hardware_concurrency() : cores.size();
+            const auto workersNum = static_cast<unsigned>(std::min(batchSize, coresNum));
+#ifdef USE_TBB
+            if (nullptr != placement) {
+#if TBB_INTERFACE_VERSION >= 12000
+                packingArenas.emplace_back(new tbb::task_arena(tbb::task_arena::constraints{}
+                    .set_numa_id(placement->node(g).id)
+                    .set_max_concurrency(static_cast<int>(workersNum))));
+#else
+                // NUMA constraints of arenas require oneTBB, the arenas only separate the groups' workers
+                packingArenas.emplace_back(new tbb::task_arena(static_cast<int>(workersNum)));
+#endif
+            }
+#else
+            packingPools.emplace_back(new ThreadPool(workersNum, cores));
+#endif
+        }
+    }
     getterThread = std::thread([&, batchSize]() {
         std::vector<std::shared_ptr<VideoFrame>> vframes;
+        std::vector<std::shared_ptr<VideoFrame>> inputFrames;
         while (!terminate) {
             vframes.clear();
             size_t b = 0;
-            while (b != batchSize) {
+            auto deadline = std::chrono::steady_clock::now() + batchTimeout;
+            while (b != batchSize && !terminate) {
+                if (nullptr != isReady && !isReady()) {
+                    if (std::chrono::steady_clock::now() < deadline) {
+                        std::this_thread::sleep_for(std::chrono::microseconds(100));
+                    } else if (b > 0) {
+                        break;  // infer the frames collected so far
+                    } else {
+                        deadline = std::chrono::steady_clock::now() + batchTimeout;
+                    }
+                    continue;
+                }
                 VideoFrame vframe;
                 if (getter(vframe)) {
-                    vframes.push_back(std::make_shared<VideoFrame>(vframe));
+                    vframes.push_back(std::make_shared<VideoFrame>(std::move(vframe)));
                     ++b;
                 } else {
                     terminate = true;
@@ -66,21 +279,37 @@ void IEGraph::start(size_t batchSize, GetterFunc getterFunc, PostprocessingFunc
                 availableRequests.pop();
             }
 
+            // Padding slots repeat the last frame, their results are ignored by getBatchData()
+            inputFrames = vframes;
+            inputFrames.resize(batchSize, vframes.back());
+
             if (perfTimerInfer.enabled()) {
+                const auto packingTime = std::chrono::steady_clock::now();
+                for (const auto& vframe : vframes) {
+                    perfTimerQueueWait.addValue(packingTime - vframe->timestamp);
+                }
                 {
                     ScopedTimer st(perfTimerPreprocess);
-                    framesToTensor(vframes, req.get_input_tensor());
+                    ITT_SCOPED_FRAME_TASK("IEGraph::preprocess", vframes.front()->frameId);
+                    setInputs(inputFrames, req);
                 }
                 auto startTime = std::chrono::high_resolution_clock::now();
+                ITT_BEGIN_FRAME_TASK("IEGraph::infer", vframes.front().get(), vframes.front()->frameId);
                 req.start_async();
                 std::unique_lock<std::mutex> lock(mtxBusyRequests);
                 busyBatchRequests.push({std::move(vframes), std::move(req), startTime});
+                ++busyRequestsNum;
             } else {
-                framesToTensor(vframes, req.get_input_tensor());
+                {
+                    ITT_SCOPED_FRAME_TASK("IEGraph::preprocess", vframes.front()->frameId);
+                    setInputs(inputFrames, req);
+                }
+                ITT_BEGIN_FRAME_TASK("IEGraph::infer", vframes.front().get(), vframes.front()->frameId);
                 req.start_async();
                 std::unique_lock<std::mutex> lock(mtxBusyRequests);
                 busyBatchRequests.push({std::move(vframes), std::move(req),
                                     std::chrono::high_resolution_clock::time_point()});
+                ++busyRequestsNum;
             }
             condVarBusyRequests.notify_one();
         }
@@ -113,19 +342,45 @@ std::vector<std::shared_ptr<VideoFrame>> IEGraph::getBatchData(cv::Size frameSiz
     }
 
     req.wait();
-    auto detections = postprocessing(req, frameSize);
-    for (decltype(detections.size()) i = 0; i < detections.size(); i ++) {
+    // the task of the batch is identified by its first frame, which is kept alive by vframes until now
+    ITT_END_FRAME_TASK(vframes.front().get(), vframes.front()->frameId);
+    ITT_SCOPED_FRAME_TASK("IEGraph::postprocess", vframes.front()->frameId);
+    std::vector<Detections> detections;
+    if (perfTimerPostprocess.enabled()) {
+        ScopedTimer st(perfTimerPostprocess);
+        detections = postprocessing(req, frameSize);
+    } else {
+        detections = postprocessing(req, frameSize);
+    }
+    assert(detections.size() >= vframes.size());
+    for (decltype(vframes.size()) i = 0; i < vframes.size(); i ++) {
         vframes[i]->detections = std::move(detections[i]);
     }
     if (perfTimerInfer.enabled()) {
         auto endTime = std::chrono::high_resolution_clock::now();
         perfTimerInfer.addValue(endTime - startTime);
     }
+    if (collectStats) {
+        const auto now = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> lock(mtxChannelRates);
+        for (const auto& vframe : vframes) {
+            while (channelRates.size() <= vframe->sourceIdx) {
+                channelRates.emplace_back(new ChannelRate);
+            }
+            ChannelRate& rate = *channelRates[vframe->sourceIdx];
+            if (decltype(now)::duration::zero() != rate.lastFrameTime.time_since_epoch()) {
+                rate.perfTimer.addValue(now - rate.lastFrameTime);
+            }
+            rate.lastFrameTime = now;
+            rate.latency.addValue(now - vframe->timestamp);
+        }
+    }
 
     {
         std::unique_lock<std::mutex> lock(mtxAvalableRequests);
         availableRequests.push(std::move(req));
     }
+    --busyRequestsNum;
     condVarAvailableRequests.notify_one();
 
     return vframes;
@@ -152,5 +407,17 @@ IEGraph::~IEGraph() {
 }
 
 IEGraph::Stats IEGraph::getStats() const {
-    return Stats{perfTimerPreprocess.getValue(), perfTimerInfer.getValue()};
+    Stats stats;
+    stats.preprocessTime = perfTimerPreprocess.getValue();
+    stats.inferTime = perfTimerInfer.getValue();
+    stats.queueWaitTime = perfTimerQueueWait.getValue();
+    stats.postprocessTime = perfTimerPostprocess.getValue();
+    stats.inferQueueDepth = busyRequestsNum;
+    std::unique_lock<std::mutex> lock(mtxChannelRates);
+    for (const auto& rate : channelRates) {
+        const float interval = rate->perfTimer.getValue();
+        stats.channelFps.push_back(interval > 0.0f ? 1000.0f / interval : 0.0f);
+        stats.channelLatency.push_back(rate->latency.getValue());
+    }
+    return stats;
 }
@@ -20,6 +20,8 @@
 #include <utils/slog.hpp>
 #include "perf_timer.hpp"
 #include "input.hpp"
+#include "placement.hpp"
+#include "threading.hpp"
 
 static inline size_t roundUp(size_t enumerator, size_t denominator) {
     assert(enumerator > 0);
@@ -27,12 +29,35 @@ static inline size_t roundUp(size_t enumerator, size_t denominator) {
     return 1 + (enumerator - 1) / denominator;
 }
 
+// Splits CPU threads between models compiled in the process, so models inferred concurrently don't oversubscribe the
+// CPU and thrash each other. The THROUGHPUT hint derives streams and the optimal number of requests of every model
+// from its threads. Models on other devices are compiled as usual.
+class DeviceBudget {
+public:
+    // weights - relative shares of the CPU of the models, in the order they are compiled
+    explicit DeviceBudget(std::vector<float> weights);
+
+    // Returns properties of the next model to compile on the device and logs its share
+    ov::AnyMap next(const std::string& device);
+
+private:
+    const std::vector<float> weights;
+    const float weightsSum;
+    size_t nextModel = 0;
+    float reservedWeights = 0.0f;
+};
+
+// numaAffinity pins CPU inference streams to NUMA nodes, otherwise the streams aren't pinned. budgetProperties are
+// returned by DeviceBudget::next() if several models share the device.
 static inline std::queue<ov::InferRequest> compile(std::shared_ptr<ov::Model>&& model, const std::string& modelPath,
-        const std::string& device, size_t performanceHintNumRequests, ov::Core& core) {
-    core.set_property("CPU", ov::affinity(ov::Affinity::NONE));
-    ov::CompiledModel compiled = core.compile_model(model, device, {
+        const std::string& device, size_t performanceHintNumRequests, ov::Core& core, bool numaAffinity = false,
+        const ov::AnyMap& budgetProperties = {}) {
+    core.set_property("CPU", ov::affinity(numaAffinity ? ov::Affinity::NUMA : ov::Affinity::NONE));
+    ov::AnyMap config{
         {ov::hint::performance_mode(ov::hint::PerformanceMode::THROUGHPUT)},
-        {ov::hint::num_requests(performanceHintNumRequests)}});
+        {ov::hint::num_requests(performanceHintNumRequests)}};
+    config.insert(budgetProperties.begin(), budgetProperties.end());
+    ov::CompiledModel compiled = core.compile_model(model, device, config);
     unsigned maxRequests = compiled.get_property(ov::optimal_number_of_infer_requests) + 1;
     logCompiledModelInfo(compiled, modelPath, device);
     slog::info << "\tNumber of network inference requests: " << std::to_string(maxRequests) << slog::endl;
@@ -43,10 +68,18 @@ static inline std::queue<ov::InferRequest> compile(std::shared_ptr<ov::Model>&&
     return reqQueue;
 }
 
+// Compiles the model for GPU in the VA context of decoded frames (see VideoSources::getVaDisplay()). The model input is
+// replaced by NV12 surfaces, which GPU converts to the input colour format, so frames aren't copied from the device and
+// back. Requires USE_LIBVA.
+std::queue<ov::InferRequest> compileForVaSurfaces(std::shared_ptr<ov::Model>&& model, const std::string& modelPath,
+        const std::string& device, size_t performanceHintNumRequests, ov::Core& core, void* vaDisplay);
+
 class IEGraph{
 private:
     PerfTimer perfTimerPreprocess;
     PerfTimer perfTimerInfer;
+    PerfTimer perfTimerQueueWait;
+    PerfTimer perfTimerPostprocess;
     std::queue<ov::InferRequest> availableRequests;
 
     struct BatchRequestDesc {
@@ -55,6 +88,7 @@ private:
         std::chrono::high_resolution_clock::time_point startTime;
     };
     std::queue<BatchRequestDesc> busyBatchRequests;
+    std::atomic<size_t> busyRequestsNum = {0};
 
     std::size_t maxRequests;
 
@@ -68,13 +102,49 @@ private:
     GetterFunc getter;
     using PostprocessingFunc = std::function<std::vector<Detections>(ov::InferRequest, cv::Size)>;
     PostprocessingFunc postprocessing;
+    using ReadyFunc = std::function<bool()>;
+    ReadyFunc isReady;
+    std::chrono::milliseconds batchTimeout = std::chrono::milliseconds::zero();
+    const bool collectStats;
+    // Intervals between inferred frames of every channel and their latencies, VideoFrame::sourceIdx is the channel
+    struct ChannelRate {
+        PerfTimer perfTimer{PerfTimer::DefaultIterationsCount};
+        PerfTimer latency{PerfTimer::DefaultIterationsCount};
+        std::chrono::steady_clock::time_point lastFrameTime;
+    };
+    mutable std::mutex mtxChannelRates;
+    std::vector<std::unique_ptr<ChannelRate>> channelRates;
     std::thread getterThread;
+    // Frames of a channel group are packed on the cores of its node, a single group covers all channels by default
+    std::unique_ptr<ChannelPlacement> placement;
+#ifdef USE_TBB
+    std::vector<std::unique_ptr<tbb::task_arena>> packingArenas;
+#else
+    // Pack frames of a batch in parallel, one pool per channel group
+    std::vector<std::unique_ptr<ThreadPool>> packingPools;
+#endif
+
+    void setInputs(const std::vector<std::shared_ptr<VideoFrame>>& frames, ov::InferRequest& req);
+    void framesToTensor(const std::vector<std::shared_ptr<VideoFrame>>& frames, const ov::Tensor& tensor);
 public:
     IEGraph(std::queue<ov::InferRequest>&& availableRequests, bool collectStats):
         perfTimerPreprocess(collectStats ? PerfTimer::DefaultIterationsCount : 0),
         perfTimerInfer(collectStats ? PerfTimer::DefaultIterationsCount : 0),
+        perfTimerQueueWait(collectStats ? PerfTimer::DefaultIterationsCount : 0),
+        perfTimerPostprocess(collectStats ? PerfTimer::DefaultIterationsCount : 0),
         availableRequests(std::move(availableRequests)),
-        maxRequests(this->availableRequests.size()) {}
+        maxRequests(this->availableRequests.size()),
+        collectStats(collectStats) {}
+
+    // Lets the graph infer incomplete batches. readyFunc checks if the getter returns the next frame without waiting.
+    // If it doesn't, readyFunc should move the getter to the next input, so a stalled input doesn't delay others.
+    // Frames collected when timeout since the batch start expires are inferred, the rest of the batch is padded.
+    // Should be called before start().
+    void setBatchTimeout(std::chrono::milliseconds timeout, ReadyFunc readyFunc);
+
+    // Packs frames of every channel group (VideoFrame::sourceIdx is the channel) on the cores of the group's node.
+    // Should be called before start().
+    void setPlacement(const ChannelPlacement& channelPlacement);
 
     void start(size_t batchSize, GetterFunc getterFunc, PostprocessingFunc postprocessingFunc);
 
@@ -87,6 +157,11 @@ public:
     struct Stats {
         float preprocessTime;
         float inferTime;
+        std::vector<float> channelFps;  // achieved FPS of every channel
+        std::vector<float> channelLatency;  // time from reading a frame of the channel to its inference results
+        float queueWaitTime;  // time from reading a frame to packing it into a batch
+        float postprocessTime;
+        size_t inferQueueDepth;  // batches being inferred
     };
 
     Stats getStats() const;
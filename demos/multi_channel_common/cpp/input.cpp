@@ -4,6 +4,7 @@
 
 #include "input.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <memory>
@@ -11,14 +12,17 @@
 #include <queue>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <utils/args_helper.hpp>
+#include <utils/frame_pool.hpp>
 #include <utils/images_capture.h>
 #include <utils/performance_metrics.hpp>
 
 #include "perf_timer.hpp"
 
 #include "decoder.hpp"
+#include "spsc_queue.hpp"
 #include "threading.hpp"
 
 #ifdef USE_NATIVE_CAMERA_API
@@ -44,9 +48,26 @@ public:
 
     virtual bool read(VideoFrame& frame) = 0;
 
+    virtual bool isFrameReady() = 0;
+
     virtual float getAvgReadTime() const = 0;
 
+    virtual size_t getQueueDepth() = 0;
+
+    // Sources block when their queue is full, except cameras which can't be paused
+    virtual size_t getDroppedFramesNum() const {
+        return 0;
+    }
+
+    // Cores to pin the thread reading frames to, should be set before start()
+    void setAffinity(std::vector<int> cores) {
+        affinity = std::move(cores);
+    }
+
     virtual ~VideoSource();
+
+protected:
+    std::vector<int> affinity;
 };
 
 VideoSource::~VideoSource() {}
@@ -180,6 +201,7 @@ public:
     void start() override {
         running = true;
         workThread = std::thread([&]() {
+            pinCurrentThread(affinity);
             while (running) {
                 {
                     cv::Mat frame;
@@ -188,9 +210,11 @@ public:
                         is_decoding = true;
                         std::unique_lock<std::mutex> lock(parent.decode_mutex);
                         parent.decoder.decode(stream.frame.ptr, stream.frame.length, stream.frame.width, stream.frame.height,
-                            [this, timestamp](cv::Mat&& img) mutable {
+                            [this, timestamp](cv::Mat&& img, Decoder::SurfacePtr surface) mutable {
+                            // Called by decoder threads in the async mode
+                            std::unique_lock<std::mutex> queueLock(mutex);
                             bool success = !img.empty();
-                            frameQueue.push({ success, {std::move(img), timestamp} });
+                            frameQueue.push({ success, {std::move(img), timestamp, std::move(surface)} });
                             if (perfTimer.enabled()) {
                                 auto prev = lastFrameTime;
                                 auto current = clock::now();
@@ -241,9 +265,20 @@ public:
         condVar.notify_one();
         frame.frame = std::move(elem.second.mat);
         frame.timestamp = elem.second.timestamp;
+        frame.surface = std::move(elem.second.surface);
         return elem.first && running;
     }
 
+    bool isFrameReady() override {
+        std::unique_lock<std::mutex> lock(mutex);
+        return !frameQueue.empty() || !running;
+    }
+
+    size_t getQueueDepth() override {
+        std::unique_lock<std::mutex> lock(mutex);
+        return frameQueue.size();
+    }
+
     float getAvgReadTime() const override {
         return perfTimer.getValue();
     }
@@ -257,12 +292,15 @@ class GeneralCaptureSource : public VideoSource {
     const bool isAsync;
     std::atomic_bool running = {true};
 
-    std::mutex mutex;
-    std::condition_variable condVar;
-    std::condition_variable hasFrame;
-    std::queue<std::pair<bool, MatWithTimestamp>> queue;
+    // Frames go from the capturing thread to the reading one without locks, the threads sleep only if the queue is
+    // full or empty and are woken up as soon as it changes
+    SpscQueue<std::pair<bool, MatWithTimestamp>> queue;
+    EventNotifier hasSpace;
+    EventNotifier hasFrame;
 
     std::unique_ptr<ImagesCapture> cap;
+    // Used by the capturing thread, or by the reading one for synchronous sources
+    FramePool framePool;
 
     bool realFps;
 
@@ -276,7 +314,7 @@ class GeneralCaptureSource : public VideoSource {
 
 public:
     GeneralCaptureSource(bool async, bool collectStats_, const std::string& name, bool loopVideo,
-                size_t queueSize_, bool realFps_);
+                size_t queueSize_, bool realFps_, size_t framePoolSize);
 
     ~GeneralCaptureSource() override;
 
@@ -289,6 +327,12 @@ public:
     bool read(cv::Mat& frame, PerformanceMetrics::TimePoint& timestamp);
     bool read(VideoFrame& frame) override;
 
+    bool isFrameReady() override;
+
+    size_t getQueueDepth() override {
+        return queue.size();
+    }
+
     float getAvgReadTime() const override {
         return perfTimer.getValue();
     }
@@ -312,6 +356,7 @@ class VideoSourceNative : public VideoSource {
     cv::Mat dummyFrame;
     std::size_t frameIdx = 0;
     queue_t frameQueue;
+    std::atomic<size_t> droppedFrames = {0};
     mcam::camera camera;
     PerfTimer perfTimer;
 
@@ -335,6 +380,16 @@ public:
 
     bool read(VideoFrame& frame) override;
 
+    bool isFrameReady() override;
+
+    size_t getQueueDepth() override {
+        return static_cast<size_t>(frameQueue.size());
+    }
+
+    size_t getDroppedFramesNum() const override {
+        return droppedFrames;
+    }
+
     float getAvgReadTime() const override {
         return perfTimer.getValue();
     }
@@ -385,10 +440,10 @@ void VideoSourceNative::frameHandler(mcam::camera::frame_status status,
 
             parent.decoder.decode(
                         data, size, settings.width, settings.height,
-            [this, fr = std::move(frame), timestamp](cv::Mat&& img) mutable {
+            [this, fr = std::move(frame), timestamp](cv::Mat&& img, Decoder::SurfacePtr surface) mutable {
                 fr = {};
                 bool success = !img.empty();
-                frameQueue.push({ success, {std::move(img), timestamp} });
+                frameQueue.push({ success, {std::move(img), timestamp, std::move(surface)} });
                 if (perfTimer.enabled()) {
                     auto prev = lastFrameTime;
                     auto current = clock::now();
@@ -400,10 +455,17 @@ void VideoSourceNative::frameHandler(mcam::camera::frame_status status,
                     lastFrameTime = current;
                 }
             });
+        } else {
+            ++droppedFrames;
         }
     }
 }
 
+bool VideoSourceNative::isFrameReady() {
+    // Without realFps the last frame is repeated until a new one arrives
+    return !realFps || !frameQueue.empty();
+}
+
 bool VideoSourceNative::read(VideoFrame& frame) {
     queue_elem_t elem;
     if (realFps) {
@@ -431,6 +493,7 @@ bool VideoSourceNative::read(VideoFrame& frame) {
     }
     frame.frame = std::move(elem.second.mat);
     fame.timestamp = elem.second.timestamp;
+    frame.surface = std::move(elem.second.surface);
     return elem.first;
 }
 #endif  // USE_NATIVE_CAMERA_API
@@ -439,25 +502,48 @@ namespace {
 bool isNumeric(const std::string& str) {
     return std::strspn(str.c_str(), "0123456789") == str.length();
 }
+
+bool isMjpegFile(const std::string& str) {
+    const std::string extension = ".mjpeg";
+    return str.size() > extension.size() && std::equal(extension.rbegin(), extension.rend(), str.rbegin());
+}
+
+// Checks if frames of the input are decoded by Decoder, other inputs are read by OpenCV
+bool isDecodedByDecoder(const std::string& input) {
+#ifdef USE_NATIVE_CAMERA_API
+    if (isNumeric(input)) {
+        return true;
+    }
+#endif
+#ifdef USE_LIBVA
+    return isMjpegFile(input);
+#else
+    return false;
+#endif
+}
 }  // namespace
 
 template<bool CollectStats>
 MatWithTimestamp GeneralCaptureSource::readFrame() {
     const auto timestamp = std::chrono::steady_clock::now();
+    cv::Mat& buffer = framePool.acquire();
     if (CollectStats) {
         ScopedTimer st(perfTimer);
-        return { cap->read(), timestamp };
+        cap->readInto(buffer);
     } else {
-        return { cap->read(), timestamp };
+        cap->readInto(buffer);
     }
+    return { buffer, timestamp };
 }
 
 GeneralCaptureSource::GeneralCaptureSource(bool async, bool collectStats_,
                          const std::string& name, bool loopVideo, size_t queueSize_,
-                         bool realFps_):
+                         bool realFps_, size_t framePoolSize):
     perfTimer(collectStats_ ? PerfTimer::DefaultIterationsCount : 0),
     isAsync(async),
+    queue(queueSize_),
     cap(openImagesCapture(name, loopVideo)),
+    framePool(framePoolSize),
     realFps(realFps_),
     queueSize(queueSize_) {}
 
@@ -471,19 +557,23 @@ bool GeneralCaptureSource::isRunning() const {
 
 template<bool CollectStats>
 void GeneralCaptureSource::thread_fn(GeneralCaptureSource *vs) {
+    // OpenCV decodes frames in this thread, so the frames are allocated on the node of the pinned cores
+    pinCurrentThread(vs->affinity);
     while (vs->running) {
         MatWithTimestamp frame = vs->readFrame<CollectStats>();
         const bool result = frame.mat.data;
         if (!result) {
             vs->running = false; // stop() also affects running, so override it only when out of frames
         }
-        std::unique_lock<std::mutex> lock(vs->mutex);
-        vs->condVar.wait(lock, [&]() {
-            return vs->queue.size() < vs->queueSize || !vs->running; // queue has space or source ran out of frames
+        vs->hasSpace.wait([&]() {
+            return !vs->queue.full() || !vs->running; // queue has space or source ran out of frames
         });
-        vs->queue.push({result, frame});
-        vs->hasFrame.notify_one();
+        if (!vs->queue.tryPush({result, std::move(frame)})) {
+            break;  // stopped while the queue is full
+        }
+        vs->hasFrame.notify();
     }
+    vs->hasFrame.notify();
 }
 
 template<bool CollectStats>
@@ -505,7 +595,8 @@ void GeneralCaptureSource::start() {
 void GeneralCaptureSource::stop() {
     if (isAsync) {
         running = false;
-        condVar.notify_one();
+        hasSpace.notify();
+        hasFrame.notify();
         if (workThread.joinable()) {
             workThread.join();
         }
@@ -514,24 +605,26 @@ void GeneralCaptureSource::stop() {
 
 bool GeneralCaptureSource::read(cv::Mat& frame, PerformanceMetrics::TimePoint& timestamp) {
     if (isAsync) {
-        bool res;
-        {
-            std::unique_lock<std::mutex> lock(mutex);
-            hasFrame.wait(lock, [&]() {
-                return !queue.empty() || !running;
-            });
-            res = queue.front().first;
-            frame = queue.front().second.mat;
-            timestamp = queue.front().second.timestamp;
-            if (realFps || queue.size() > 1 || queueSize == 1) {
-                queue.pop();
-            }
+        hasFrame.wait([&]() {
+            return !queue.empty() || !running;
+        });
+        auto elem = queue.front();
+        if (!elem) {
+            return false;  // stopped
+        }
+        const bool res = elem->first;
+        frame = elem->second.mat;
+        timestamp = elem->second.timestamp;
+        if (realFps || queue.size() > 1 || queueSize == 1) {
+            queue.pop();
+            hasSpace.notify();
         }
-        condVar.notify_one();
         return res;
     } else {
         timestamp = std::chrono::steady_clock::now();
-        frame = cap->read();
+        cv::Mat& buffer = framePool.acquire();
+        cap->readInto(buffer);
+        frame = buffer;
         return frame.data;
     }
 }
@@ -540,19 +633,31 @@ bool GeneralCaptureSource::read(VideoFrame& frame) {
     return read(frame.frame, frame.timestamp);
 }
 
+bool GeneralCaptureSource::isFrameReady() {
+    // Synchronous sources decode frames in read()
+    return !isAsync || !queue.empty() || !running;
+}
+
 namespace {
 Decoder::Settings makeDecoderSettings(bool collectStats, std::size_t queueSize,
-                                      unsigned width, unsigned height) {
+                                      unsigned width, unsigned height,
+                                      std::size_t numInputs, bool deviceFrames) {
     Decoder::Settings ret = {};
 #if defined(USE_LIBVA)
     ret.mode = Decoder::Mode::Hw;
     ret.num_buffers = static_cast<unsigned>(queueSize);
     ret.output_width = width;
     ret.output_height = height;
-#elif defined(USE_TBB)
-    ret.mode = Decoder::Mode::Async;
+    if (deviceFrames) {
+        // Surfaces are held by frames until they are inferred and shown, so the pool should cover queues of all
+        // inputs and frames in flight
+        ret.keep_surfaces = true;
+        ret.num_buffers = static_cast<unsigned>(queueSize * (numInputs + 2));
+    }
 #else
-    ret.mode = Decoder::Mode::Immediate;
+    (void)numInputs;
+    (void)deviceFrames;
+    ret.mode = Decoder::Mode::Async;
 #endif
     ret.collect_stats = collectStats;
     return ret;
@@ -561,13 +666,22 @@ Decoder::Settings makeDecoderSettings(bool collectStats, std::size_t queueSize,
 
 VideoSources::VideoSources(const InitParams& p):
     decoder(makeDecoderSettings(p.collectStats, p.queueSize, p.expectedWidth,
-                                p.expectedHeight)),
+                                p.expectedHeight, p.inputs.size(),
+                                // Frames of the same batch should all be either on the device or in cv::Mat
+                                p.deviceFrames && std::all_of(p.inputs.begin(), p.inputs.end(), isDecodedByDecoder))),
     isAsync(p.isAsync),
     collectStats(p.collectStats),
     realFps(p.realFps),
-    queueSize(p.queueSize) {
+    queueSize(p.queueSize),
+    framePoolSize(p.framePoolSize),
+    priorities(p.priorities),
+    targetFps(p.targetFps) {
         for (const std::string& input : p.inputs)
             openVideo(input, isNumeric(input), p.loop);
+        assert(p.affinity.empty() || p.affinity.size() == inputs.size());
+        for (size_t i = 0; i < p.affinity.size(); ++i) {
+            inputs[i]->setAffinity(p.affinity[i]);
+        }
     }
 
 VideoSources::~VideoSources() {
@@ -595,6 +709,8 @@ void VideoSources::openVideo(const std::string& source, bool native, bool loopVi
         camSettings.width = 640;
         camSettings.height = 480;
         camSettings.num_buffers = static_cast<unsigned>(queueSize);
+        // Frames are decoded straight from the driver's buffers
+        camSettings.memory = mcam::camera::io_method::mmap;
 
         std::unique_ptr<VideoSource> newSrc(new VideoSourceNative(*this, controller, dev, camSettings,
                                                                      queueSize, realFps, collectStats));
@@ -604,19 +720,19 @@ void VideoSources::openVideo(const std::string& source, bool native, bool loopVi
     {
 #endif
 #if defined(USE_LIBVA)
-        const std::string extension = ".mjpeg";
         std::unique_ptr<VideoSource> newSrc;
-        if (source.size() > extension.size() && std::equal(extension.rbegin(), extension.rend(), source.rbegin()))
+        if (isMjpegFile(source)) {
             if (loopVideo)
                 throw std::runtime_error("Looping video is not supported for .mjpeg when built with USE_LIBVA");
             newSrc.reset(new VideoSourceStreamFile(*this, isAsync, collectStats, source,
                                             queueSize, realFps));
-        else
+        } else {
             newSrc.reset(new GeneralCaptureSource(isAsync, collectStats, source, loopVideo,
-                                            queueSize, realFps));
+                                            queueSize, realFps, framePoolSize));
+        }
 #else
         std::unique_ptr<VideoSource> newSrc(new GeneralCaptureSource(isAsync, collectStats, source, loopVideo,
-                                            queueSize, realFps));
+                                            queueSize, realFps, framePoolSize));
 #endif
         inputs.emplace_back(std::move(newSrc));
     }
@@ -637,12 +753,29 @@ bool VideoSources::getFrame(size_t index, VideoFrame& frame) {
     return false;
 }
 
+bool VideoSources::isFrameReady(size_t index) {
+    assert(index < inputs.size());
+    return inputs[index]->isFrameReady();
+}
+
+float VideoSources::getPriority(size_t index) const {
+    assert(index < inputs.size());
+    return index < priorities.size() ? priorities[index] : 1.0f;
+}
+
+float VideoSources::getTargetFps(size_t index) const {
+    assert(index < inputs.size());
+    return index < targetFps.size() ? targetFps[index] : 0.0f;
+}
+
 VideoSources::Stats VideoSources::getStats() const {
     Stats ret;
     if (collectStats) {
         ret.readTimes.reserve(inputs.size());
         for (auto& input : inputs) {
             ret.readTimes.push_back(input->getAvgReadTime());
+            ret.queueDepths.push_back(input->getQueueDepth());
+            ret.droppedFrames.push_back(input->getDroppedFramesNum());
         }
         ret.decodingLatency = decoder.getStats().decoding_latency;
     }
@@ -37,16 +37,24 @@ private:
 struct MatWithTimestamp {
     cv::Mat mat;
     PerformanceMetrics::TimePoint timestamp;
+    Decoder::SurfacePtr surface;
 };
 
 class VideoFrame final {
 public:
     cv::Mat frame;
     PerformanceMetrics::TimePoint timestamp;
+    // The frame on the device, set by hardware decoding if InitParams::deviceFrames is enabled
+    Decoder::SurfacePtr surface;
 
     std::size_t sourceIdx = 0;
+    // Sequence number of the frame, set by FrameFanOut
+    std::size_t frameId = 0;
     Detections detections;
     VideoFrame() = default;
+    VideoFrame(const VideoFrame&) = default;
+    // Moving doesn't touch reference counters of the frame and the surface
+    VideoFrame(VideoFrame&&) = default;
 
     VideoFrame& operator =(VideoFrame const& vf) = delete;
 };
@@ -70,6 +78,10 @@ private:
 
     const size_t queueSize = 1;
     const size_t pollingTimeMSec = 1000;
+    const size_t framePoolSize;
+
+    std::vector<float> priorities;
+    std::vector<float> targetFps;
 
     void openVideo(const std::string& source, bool native, bool loopVideo);
     void stop();
@@ -80,11 +92,23 @@ public:
         bool loop;
         std::size_t queueSize = 5;
         std::size_t pollingTimeMSec = 1000;
+        // Frame buffers recycled by every input read by OpenCV. It should cover the input queue and frames being
+        // inferred and shown, otherwise the rest of frames are allocated. 0 disables recycling.
+        std::size_t framePoolSize = 16;
         bool isAsync = true;
         bool collectStats = false;
         bool realFps = false;
         unsigned expectedWidth = 0;
         unsigned expectedHeight = 0;
+        // Keeps hardware decoded frames on the device for inference on GPU, see getVaDisplay()
+        bool deviceFrames = false;
+        // Cores to pin the reading thread of every input to (empty - not pinned). The thread decodes frames of the
+        // input unless the input is decoded by Decoder.
+        std::vector<std::vector<int>> affinity;
+        // Scheduling weights of the inputs, see ChannelScheduler. Inputs without a value get priority 1 and no FPS
+        // limit (0).
+        std::vector<float> priorities;
+        std::vector<float> targetFps;
     };
 
     explicit VideoSources(const InitParams& p);
@@ -96,12 +120,23 @@ public:
 
     bool getFrame(size_t index, VideoFrame& frame);
 
+    // Checks if getFrame() for the input returns without waiting for a frame
+    bool isFrameReady(size_t index);
+
     struct Stats {
         std::vector<float> readTimes;
+        std::vector<size_t> queueDepths;  // decoded frames waiting to be read
+        std::vector<size_t> droppedFrames;  // frames dropped because the queue was full
         float decodingLatency = 0.0f;
     };
 
     Stats getStats() const;
 
     size_t numberOfInputs() const {return inputs.size();}
+
+    float getPriority(size_t index) const;
+    float getTargetFps(size_t index) const;
+
+    // Returns VADisplay of frames surfaces if frames are kept on the device, otherwise nullptr
+    void* getVaDisplay() const {return decoder.getVaDisplay();}
 };
@@ -14,6 +14,7 @@
 #include <fcntl.h>
 #include <linux/videodev2.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -128,6 +129,63 @@ void camera::alloc_buffers() {
     assert(frame_buffer_size > 0);
     assert(params.num_buffers > 0);
     assert(dev.valid());
+    if (io_method::mmap == params.memory) {
+        alloc_mmap_buffers();
+    } else {
+        alloc_userptr_buffers();
+    }
+}
+
+unsigned camera::v4l2_memory() const {
+    return io_method::mmap == params.memory ? V4L2_MEMORY_MMAP
+                                            : V4L2_MEMORY_USERPTR;
+}
+
+void camera::alloc_mmap_buffers() {
+    v4l2_requestbuffers req = {};
+
+    req.count  = params.num_buffers;
+    req.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    req.memory = V4L2_MEMORY_MMAP;
+
+    if (-1 == xioctl(dev.get(), VIDIOC_REQBUFS, &req)) {
+        if (EINVAL == errno) {
+            throw_error("Memory mapping i/o not supported");
+        } else {
+            throw_errno_error("Unable to setup memory mapping i/o mode:", errno);
+        }
+    }
+    if (0 == req.count) {
+        throw_error("No capture buffers are allocated by the driver");
+    }
+    params.num_buffers = req.count;
+
+    mapped_buffers.clear();
+    const auto count = params.num_buffers;
+    mapped_buffers.reserve(count);
+    for (unsigned i = 0 ; i < count; ++i) {
+        v4l2_buffer buf = {};
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        buf.index = i;
+
+        if (-1 == xioctl(dev.get(), VIDIOC_QUERYBUF, &buf)) {
+            throw_errno_error("Unable to query frame buffer:", errno);
+        }
+        void* ptr = mmap(nullptr, buf.length, PROT_READ | PROT_WRITE,
+                         MAP_SHARED, dev.get(), buf.m.offset);
+        if (MAP_FAILED == ptr) {
+            throw_errno_error("Unable to map frame buffer:", errno);
+        }
+        mapped_buffers.emplace_back(ptr, buf.length);
+
+        if (-1 == xioctl(dev.get(), VIDIOC_QBUF, &buf)) {
+            throw_errno_error("Unable to enqueue frame buffer:", errno);
+        }
+    }
+}
+
+void camera::alloc_userptr_buffers() {
     v4l2_requestbuffers req = {};
 
     req.count  = params.num_buffers;
@@ -179,7 +237,7 @@ void camera::read_frame() {
     while (true) {
         v4l2_buffer buf = {};
         buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-        buf.memory = V4L2_MEMORY_USERPTR;
+        buf.memory = v4l2_memory();
         if (-1 == xioctl(dev.get(), VIDIOC_DQBUF, &buf)) {
             switch (errno) {
             case EAGAIN:
@@ -194,7 +252,9 @@ void camera::read_frame() {
                 throw_errno_error("Unable to get frame buffer ptr:", errno);
             }
         }
-        auto ptr = reinterpret_cast<void*>(buf.m.userptr);
+        auto ptr = io_method::mmap == params.memory
+                ? mapped_buffers[buf.index].ptr
+                : reinterpret_cast<void*>(buf.m.userptr);
         assert(nullptr != ptr);
         auto len = buf.bytesused;
         assert(len > 0);
@@ -205,16 +265,34 @@ void camera::read_frame() {
 void camera::reclaim_frame(frame& f) {
     v4l2_buffer buf = {};
     buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    buf.memory = V4L2_MEMORY_USERPTR;
+    buf.memory = v4l2_memory();
     buf.index = f.index;
-    buf.m.userptr = reinterpret_cast<unsigned long>(f.ptr);
-    buf.length = static_cast<__u32>(frame_buffer_size);
+    if (io_method::userptr == params.memory) {
+        buf.m.userptr = reinterpret_cast<unsigned long>(f.ptr);
+        buf.length = static_cast<__u32>(frame_buffer_size);
+    }
 
     if (-1 == xioctl(dev.get(), VIDIOC_QBUF, &buf)) {
         throw_errno_error("Unable to enqueue frame buffer ptr:", errno);
     }
 }
 
+camera::mapped_buffer::mapped_buffer(void* p, std::size_t l):
+    ptr(p), len(l) {
+    assert(nullptr != ptr);
+}
+
+camera::mapped_buffer::mapped_buffer(camera::mapped_buffer&& rhs) {
+    std::swap(ptr, rhs.ptr);
+    std::swap(len, rhs.len);
+}
+
+camera::mapped_buffer::~mapped_buffer() {
+    if (nullptr != ptr) {
+        munmap(ptr, len);
+    }
+}
+
 camera::frame::frame(camera& c, unsigned i, void* p, std::size_t l):
     cam(&c), index(i), ptr(p), len(l) {
     assert(nullptr != ptr);
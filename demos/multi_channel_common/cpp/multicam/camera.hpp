@@ -19,6 +19,11 @@ class controller;
 class camera final {
 public:
     friend class ::mcam::controller;
+    enum class io_method {
+        userptr,
+        mmap
+    };
+
     struct settings final {
         unsigned width = 0;
         unsigned height = 0;
@@ -29,6 +34,12 @@ public:
         unsigned frametime_denominator = 0;
 
         unsigned num_buffers = 1;
+
+        /// How capture buffers are allocated: by the application (userptr)
+        /// or by the driver and mapped into the process (mmap). Frames
+        /// point to the capture buffers in both cases, mmap avoids
+        /// drivers copying from their internal buffers.
+        io_method memory = io_method::userptr;
     };
 
     class frame final {
@@ -74,7 +85,20 @@ private:
         int fd = -1;
     };
 
+    struct mapped_buffer final {
+        void* ptr = nullptr;
+        std::size_t len = 0;
+
+        mapped_buffer(void* p, std::size_t l);
+        mapped_buffer(const mapped_buffer&) = delete;
+        mapped_buffer(mapped_buffer&& rhs);
+        ~mapped_buffer();
+    };
+
     void alloc_buffers();
+    void alloc_userptr_buffers();
+    void alloc_mmap_buffers();
+    unsigned v4l2_memory() const;
     void start_capture();
     void read_frame();
     void reclaim_frame(frame& f);
@@ -84,6 +108,7 @@ private:
     file_descriptor dev;
     std::size_t frame_buffer_size = 0;
     std::vector<std::unique_ptr<char[]>> buffers;
+    std::vector<mapped_buffer> mapped_buffers;
     callback_t callback;
 
     boost::intrusive::list_member_hook<> list_node;
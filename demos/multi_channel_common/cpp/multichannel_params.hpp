@@ -38,6 +38,10 @@ DEFINE_bool(no_show, false, no_show_message);
 static const char batch_size[] = "Batch size for processing (the number of frames processed per infer request)";
 DEFINE_uint32(bs, 1, batch_size);
 
+static const char batch_timeout_message[] = "Time in msec to wait for frames of a batch. When it expires, inputs"
+    " without ready frames are skipped and collected frames are inferred. 0 means waiting for all frames of the batch";
+DEFINE_uint32(batch_timeout, 0, batch_timeout_message);
+
 static const char input_queue_size[] = "Frame queue size for input channels";
 DEFINE_uint32(n_iqs, 5, input_queue_size);
 
@@ -50,8 +54,29 @@ DEFINE_uint32(n_sp, 10, num_sampling_periods);
 static const char show_statistics[] = "Enable statistics report";
 DEFINE_bool(show_stats, false, show_statistics);
 
+static const char stats_json_message[] = "Path to a file to append statistics of all stages and channels to as JSON"
+    " lines, every -fps_sp milliseconds";
+DEFINE_string(stats_json, "", stats_json_message);
+
 static const char real_input_fps[] = "Disable input frames caching, for maximum throughput pipeline";
 DEFINE_bool(real_input_fps, false, real_input_fps);
 
+static const char display_fps_message[] = "Maximum display refresh rate. Frames inferred between refreshes replace"
+    " earlier frames of their channels. 0 means refreshing on every result";
+DEFINE_uint32(display_fps, 0, display_fps_message);
+
+static const char numa_message[] = "Split channels into groups, one per NUMA node, and pin decoding, packing and CPU"
+    " inference streams of every group to its node";
+DEFINE_bool(numa, false, numa_message);
+
+static const char priorities_message[] = "Comma separated scheduling priorities of the inputs, e.g. 4,1,1. When"
+    " inference can't keep up with all inputs, channels get frames in proportion to their priorities. Inputs without a"
+    " value get 1";
+DEFINE_string(priorities, "", priorities_message);
+
+static const char target_fps_message[] = "Comma separated maximum FPS of the inputs' channels, 0 means no limit. Inputs"
+    " without a value aren't limited";
+DEFINE_string(target_fps, "", target_fps_message);
+
 static const char utilization_monitors_message[] = "List of monitors to show initially.";
 DEFINE_string(u, "", utilization_monitors_message);
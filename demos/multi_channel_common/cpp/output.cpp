@@ -8,10 +8,22 @@
 
 #include "output.hpp"
 
+#include <utils/itt.hpp>
+
 AsyncOutput::AsyncOutput(bool collectStats, size_t queueSize,
                          DrawFunc drawFunc):
     queueSize(queueSize),
     drawFunc(std::move(drawFunc)),
+    incremental(false),
+    minDrawPeriod(0),
+    perfTimer(collectStats ? PerfTimer::DefaultIterationsCount : 0) {}
+
+AsyncOutput::AsyncOutput(bool collectStats, DrawFunc drawFunc,
+                         std::chrono::milliseconds minDrawPeriod):
+    queueSize(0),
+    drawFunc(std::move(drawFunc)),
+    incremental(true),
+    minDrawPeriod(minDrawPeriod),
     perfTimer(collectStats ? PerfTimer::DefaultIterationsCount : 0) {}
 
 AsyncOutput::~AsyncOutput() {
@@ -24,10 +36,21 @@ AsyncOutput::~AsyncOutput() {
 
 void AsyncOutput::push(std::vector<std::shared_ptr<VideoFrame>>&& item) {
     std::unique_lock<std::mutex> lock(mutex);
-    while (queue.size() >= queueSize) {
-        queue.pop();
+    if (incremental) {
+        for (auto& frame : item) {
+            auto& channel = updatedChannels[frame->sourceIdx];
+            if (nullptr != channel) {
+                ++droppedFrames;
+            }
+            channel = std::move(frame);
+        }
+    } else {
+        while (queue.size() >= queueSize) {
+            droppedFrames += queue.front().size();
+            queue.pop();
+        }
+        queue.push(std::move(item));
     }
-    queue.push(std::move(item));
     lock.unlock();
     condVar.notify_one();
 }
@@ -35,18 +58,36 @@ void AsyncOutput::push(std::vector<std::shared_ptr<VideoFrame>>&& item) {
 void AsyncOutput::start() {
     thread = std::thread([&]() {
         std::vector<std::shared_ptr<VideoFrame>> elem;
+        auto nextDrawTime = std::chrono::steady_clock::now();
         while (!terminate) {
             std::unique_lock<std::mutex> lock(mutex);
+            if (minDrawPeriod > std::chrono::milliseconds::zero()) {
+                // Frames pushed meanwhile are merged into updatedChannels
+                condVar.wait_until(lock, nextDrawTime, [&]() {
+                    return terminate.load();
+                });
+            }
             condVar.wait(lock, [&]() {
-                return !queue.empty() || terminate;
+                return !queue.empty() || !updatedChannels.empty() || terminate;
             });
-            if (queue.empty()) {
+            if (queue.empty() && updatedChannels.empty()) {
                 break;
             }
 
-            elem = std::move(queue.front());
-            queue.pop();
+            if (incremental) {
+                elem.clear();
+                for (auto& channel : updatedChannels) {
+                    elem.push_back(std::move(channel.second));
+                }
+                updatedChannels.clear();
+            } else {
+                elem = std::move(queue.front());
+                queue.pop();
+            }
             lock.unlock();
+            nextDrawTime = std::chrono::steady_clock::now() + minDrawPeriod;
+
+            ITT_SCOPED_TASK("AsyncOutput::draw");
 
             if (perfTimer.enabled()) {
                 ScopedTimer sc(perfTimer);
@@ -66,6 +107,12 @@ bool AsyncOutput::isAlive() const {
     return !terminate;
 }
 
+bool AsyncOutput::isRenderPending() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return !queue.empty() || !updatedChannels.empty();
+}
+
 AsyncOutput::Stats AsyncOutput::getStats() const {
-    return Stats{perfTimer.getValue()};
+    std::lock_guard<std::mutex> lock(mutex);
+    return Stats{perfTimer.getValue(), incremental ? updatedChannels.size() : queue.size(), droppedFrames};
 }
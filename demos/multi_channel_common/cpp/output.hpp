@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <chrono>
+#include <map>
 #include <queue>
 #include <vector>
 #include <thread>
@@ -21,22 +23,35 @@ public:
     using DrawFunc = std::function<bool(const std::vector<std::shared_ptr<VideoFrame>>&)>;
 
     AsyncOutput(bool collectStats, size_t queueSize, DrawFunc drawFunc);
+    // Incremental mode: frames pushed before they are drawn are merged per channel (VideoFrame::sourceIdx), drawFunc
+    // receives the latest frame of every channel updated since its previous call. drawFunc is called at most once per
+    // minDrawPeriod, so the display rate is capped independently of the inference rate.
+    AsyncOutput(bool collectStats, DrawFunc drawFunc, std::chrono::milliseconds minDrawPeriod);
     ~AsyncOutput();
     void push(std::vector<std::shared_ptr<VideoFrame>>&& item);
     void start();
     bool isAlive() const;
+    // Returns true if pushed frames are waiting to be drawn, so frames pushed now may replace them without being
+    // shown. Producers may skip preparing frames for rendering meanwhile.
+    bool isRenderPending();
     struct Stats {
         float renderTime;
+        size_t queueDepth;  // results waiting to be drawn
+        size_t droppedFrames;  // results replaced by newer ones before they were drawn
     };
     Stats getStats() const;
 
 private:
     const size_t queueSize;
     DrawFunc drawFunc;
+    const bool incremental;
+    const std::chrono::milliseconds minDrawPeriod;
     std::queue<std::vector<std::shared_ptr<VideoFrame>>> queue;
+    std::map<size_t, std::shared_ptr<VideoFrame>> updatedChannels;
+    size_t droppedFrames = 0;
     std::atomic_bool terminate = {false};
     std::thread thread;
-    std::mutex mutex;
+    mutable std::mutex mutex;
     std::condition_variable condVar;
 
     PerfTimer perfTimer;
@@ -63,6 +78,47 @@ void writeStats(StreamType& stream, EndlType endl, const VideoSources::Stats& in
     stream << "Inference: "
         << inferStat.inferTime << " ms";
     stream << endl;
+    stream << "Channels FPS: ";
+    for (size_t i = 0; i < inferStat.channelFps.size(); ++i) {
+        if (0 == (i % 4) && i != 0) {
+            stream << endl;
+        }
+        stream << inferStat.channelFps[i] << " ";
+    }
+    stream << endl;
     stream << "Rendering: " << outputStat.renderTime
         << " ms" << endl;
 }
+
+// Writes the statistics as a JSON object on a single line, so snapshots taken at a fixed interval form a JSON lines
+// stream. Times are in milliseconds.
+template<class StreamType>
+void writeStatsJson(StreamType& stream, const VideoSources::Stats& inputStat,
+    const IEGraph::Stats& inferStat, const AsyncOutput::Stats& outputStat) {
+    const auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch());
+    stream << std::fixed << std::setprecision(2);
+    stream << "{\"timestamp\": " << timestamp.count();
+    stream << ", \"inputs\": [";
+    for (size_t i = 0; i < inputStat.readTimes.size(); ++i) {
+        stream << (0 == i ? "" : ", ")
+            << "{\"read\": " << inputStat.readTimes[i]
+            << ", \"queue_depth\": " << inputStat.queueDepths[i]
+            << ", \"dropped\": " << inputStat.droppedFrames[i] << "}";
+    }
+    stream << "], \"decode\": " << inputStat.decodingLatency;
+    stream << ", \"channels\": [";
+    for (size_t i = 0; i < inferStat.channelFps.size(); ++i) {
+        stream << (0 == i ? "" : ", ")
+            << "{\"fps\": " << inferStat.channelFps[i]
+            << ", \"latency\": " << inferStat.channelLatency[i] << "}";
+    }
+    stream << "], \"queue_wait\": " << inferStat.queueWaitTime
+        << ", \"pack\": " << inferStat.preprocessTime
+        << ", \"infer\": " << inferStat.inferTime
+        << ", \"postprocess\": " << inferStat.postprocessTime
+        << ", \"infer_queue_depth\": " << inferStat.inferQueueDepth
+        << ", \"render\": " << outputStat.renderTime
+        << ", \"render_queue_depth\": " << outputStat.queueDepth
+        << ", \"render_dropped\": " << outputStat.droppedFrames << "}" << std::endl;
+}
@@ -0,0 +1,85 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "placement.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+// Parses the kernel's CPU list format, e.g. "0-15,32-47"
+std::vector<int> parseCpuList(const std::string& list) {
+    std::vector<int> cores;
+    std::istringstream stream(list);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        if (range.empty() || range == "\n") {
+            continue;
+        }
+        const size_t dash = range.find('-');
+        const int first = std::stoi(range.substr(0, dash));
+        const int last = std::string::npos == dash ? first : std::stoi(range.substr(dash + 1));
+        for (int core = first; core <= last; ++core) {
+            cores.push_back(core);
+        }
+    }
+    return cores;
+}
+}  // namespace
+
+std::vector<NumaNode> getNumaNodes() {
+    std::vector<NumaNode> nodes;
+#if defined(__linux__)
+    // Node ids may be sparse, so ids are probed up to the kernel's default limit
+    const int maxNodes = 1024;
+    for (int id = 0; id < maxNodes; ++id) {
+        std::ifstream cpuList("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist");
+        if (!cpuList) {
+            continue;
+        }
+        std::string list;
+        std::getline(cpuList, list);
+        std::vector<int> cores = parseCpuList(list);
+        if (!cores.empty()) {  // memory-only nodes don't run threads
+            nodes.push_back({id, std::move(cores)});
+        }
+    }
+#endif
+    if (nodes.empty()) {
+        NumaNode node{0, {}};
+        const int coresNum = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+        for (int core = 0; core < coresNum; ++core) {
+            node.cores.push_back(core);
+        }
+        nodes.push_back(std::move(node));
+    }
+    return nodes;
+}
+
+ChannelPlacement::ChannelPlacement(size_t channelsNum, std::vector<NumaNode> nodes):
+    channelsNum(channelsNum),
+    nodes(std::move(nodes)) {
+    assert(channelsNum > 0);
+    assert(!this->nodes.empty());
+    // Every group should have at least one channel
+    if (this->nodes.size() > channelsNum) {
+        this->nodes.resize(channelsNum);
+    }
+}
+
+size_t ChannelPlacement::groupOf(size_t channel) const {
+    assert(channel < channelsNum);
+    return channel * nodes.size() / channelsNum;
+}
+
+const NumaNode& ChannelPlacement::node(size_t group) const {
+    assert(group < nodes.size());
+    return nodes[group];
+}
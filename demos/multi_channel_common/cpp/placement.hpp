@@ -0,0 +1,33 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+struct NumaNode {
+    int id;
+    std::vector<int> cores;
+};
+
+// Returns NUMA nodes having CPU cores. If the topology isn't known, returns a single node with all cores.
+std::vector<NumaNode> getNumaNodes();
+
+// Splits channels into contiguous groups, one group per NUMA node. Decoding, packing and inference of a group run on
+// the cores of its node, so frames don't cross sockets on their way from the decoder to the inference.
+class ChannelPlacement {
+public:
+    ChannelPlacement(size_t channelsNum, std::vector<NumaNode> nodes);
+
+    size_t groupsNum() const {return nodes.size();}
+
+    size_t groupOf(size_t channel) const;
+
+    const NumaNode& node(size_t group) const;
+
+private:
+    size_t channelsNum;
+    std::vector<NumaNode> nodes;
+};
@@ -0,0 +1,74 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "scheduler.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+ChannelScheduler::ChannelScheduler(const std::vector<Channel>& channelsQos) {
+    assert(!channelsQos.empty());
+    const auto now = Clock::now();
+    for (const Channel& qos : channelsQos) {
+        assert(qos.priority > 0.0f);
+        assert(qos.targetFps >= 0.0f);
+        ChannelState state;
+        state.stride = 1.0f / qos.priority;
+        state.period = qos.targetFps > 0.0f
+            ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(1.0f / qos.targetFps))
+            : Clock::duration::zero();
+        state.nextTime = now;
+        channels.push_back(state);
+    }
+}
+
+size_t ChannelScheduler::current() {
+    if (!isChosen) {
+        chosen = choose();
+        isChosen = true;
+    }
+    return chosen;
+}
+
+void ChannelScheduler::advance() {
+    ChannelState& state = channels[current()];
+    // Start-time fair queueing: a channel idle for a while starts from the current virtual time, so it doesn't take
+    // a burst of frames to catch up
+    const double startTag = std::max(state.finishTag, virtualTime);
+    virtualTime = startTag;
+    state.finishTag = startTag + state.stride;
+    if (Clock::duration::zero() != state.period) {
+        // One frame late by jitter may be caught up, longer delays aren't
+        state.nextTime = std::max(state.nextTime, Clock::now() - state.period) + state.period;
+    }
+    isChosen = false;
+}
+
+size_t ChannelScheduler::choose() {
+    for (;;) {
+        const auto now = Clock::now();
+        size_t best = channels.size();
+        double bestTag = 0.0;
+        Clock::time_point earliestTime = Clock::time_point::max();
+        for (size_t i = 0; i < channels.size(); ++i) {
+            const ChannelState& state = channels[i];
+            if (state.nextTime > now) {
+                earliestTime = std::min(earliestTime, state.nextTime);
+                continue;
+            }
+            const double startTag = std::max(state.finishTag, virtualTime);
+            if (best == channels.size() || startTag < bestTag) {
+                best = i;
+                bestTag = startTag;
+            }
+        }
+        if (best != channels.size()) {
+            return best;
+        }
+        std::this_thread::sleep_until(earliestTime);
+    }
+}
@@ -0,0 +1,46 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+// Chooses the channel the IEGraph getter reads the next frame from. Channels are served in the weighted-fair order,
+// so every channel gets a share of the inferred frames proportional to its priority, and a channel with a target FPS
+// isn't served more often than the target. When inference can't keep up with all channels, low priority channels are
+// decimated first. Should be used by the getter thread only.
+class ChannelScheduler {
+public:
+    struct Channel {
+        float priority;  // positive weight of the channel
+        float targetFps;  // 0 - no limit
+    };
+
+    explicit ChannelScheduler(const std::vector<Channel>& channels);
+
+    // Returns the channel to read from, waits if every channel has reached its target FPS
+    size_t current();
+
+    // Moves to the next channel, the current channel is charged as served even if its frame wasn't read
+    void advance();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct ChannelState {
+        float stride;  // virtual time a frame costs
+        Clock::duration period;  // zero without a target FPS
+        double finishTag = 0.0;
+        Clock::time_point nextTime;  // the channel isn't served before it to stay within its target FPS
+    };
+
+    size_t choose();
+
+    std::vector<ChannelState> channels;
+    double virtualTime = 0.0;
+    size_t chosen;
+    bool isChosen = false;
+};
@@ -0,0 +1,106 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Bounded lock-free queue for one producer thread and one consumer thread. Elements are stored in a ring of slots
+// allocated once, so pushing and popping don't allocate memory.
+template<typename T>
+class SpscQueue final {
+public:
+    explicit SpscQueue(size_t capacity):
+        slots(capacity + 1) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator =(const SpscQueue&) = delete;
+
+    // Producer only. Returns false if the queue is full.
+    bool tryPush(T&& value) {
+        const size_t currentTail = tail.load(std::memory_order_relaxed);
+        const size_t nextTail = increment(currentTail);
+        if (nextTail == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        slots[currentTail] = std::move(value);
+        tail.store(nextTail, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only. Returns nullptr if the queue is empty.
+    T* front() {
+        const size_t currentHead = head.load(std::memory_order_relaxed);
+        if (currentHead == tail.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &slots[currentHead];
+    }
+
+    // Consumer only, the queue must not be empty
+    void pop() {
+        const size_t currentHead = head.load(std::memory_order_relaxed);
+        slots[currentHead] = T();  // release the element's resources in the consumer thread
+        head.store(increment(currentHead), std::memory_order_release);
+    }
+
+    size_t size() const {
+        const size_t currentHead = head.load(std::memory_order_acquire);
+        const size_t currentTail = tail.load(std::memory_order_acquire);
+        return currentTail >= currentHead ? currentTail - currentHead : currentTail + slots.size() - currentHead;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    bool full() const {
+        return size() == slots.size() - 1;
+    }
+
+private:
+    size_t increment(size_t idx) const {
+        return idx + 1 == slots.size() ? 0 : idx + 1;
+    }
+
+    std::vector<T> slots;
+    std::atomic<size_t> head = {0};  // next element to pop
+    std::atomic<size_t> tail = {0};  // next slot to push to
+};
+
+// Lets a thread sleep until a condition changed by another thread holds. The notifying thread takes the lock only if
+// someone is waiting, so notifications are cheap when the waiting thread is busy.
+class EventNotifier final {
+public:
+    template<typename Predicate>
+    void wait(Predicate pred) {
+        if (pred()) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        waiters.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        condVar.wait(lock, pred);
+        waiters.fetch_sub(1);
+    }
+
+    // Should be called after the condition is changed
+    void notify() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters.load() > 0) {
+            std::unique_lock<std::mutex> lock(mutex);
+            condVar.notify_all();
+        }
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable condVar;
+    std::atomic<int> waiters = {0};
+};
@@ -4,6 +4,173 @@
 
 #include "threading.hpp"
 
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+namespace {
+void setAffinity(std::thread& thread, int core) {
+#if defined(__linux__)
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(core, &cpuSet);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(cpuSet), &cpuSet);
+#elif defined(_WIN32)
+    SetThreadAffinityMask(thread.native_handle(), DWORD_PTR(1) << core);
+#else
+    (void)thread;
+    (void)core;
+#endif
+}
+}  // namespace
+
+void pinCurrentThread(const std::vector<int>& cores) {
+    if (cores.empty()) {
+        return;
+    }
+#if defined(__linux__)
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (int core : cores) {
+        CPU_SET(core, &cpuSet);
+    }
+    pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+#elif defined(_WIN32)
+    DWORD_PTR mask = 0;
+    for (int core : cores) {
+        mask |= DWORD_PTR(1) << core;
+    }
+    SetThreadAffinityMask(GetCurrentThread(), mask);
+#endif
+}
+
+void parallelFor(size_t count, const std::function<ThreadPool&(size_t)>& poolOf,
+                 const std::function<void(size_t)>& func) {
+    std::mutex mutex;
+    std::condition_variable done;
+    size_t remaining = count;
+    std::exception_ptr error;
+    for (size_t i = 0; i < count; ++i) {
+        poolOf(i).submit([&, i]() {
+            std::exception_ptr taskError;
+            try {
+                func(i);
+            } catch (...) {
+                taskError = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            if (taskError && !error) {
+                error = taskError;
+            }
+            if (0 == --remaining) {
+                done.notify_one();
+            }
+        });
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&]() {
+        return 0 == remaining;
+    });
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void parallelFor(ThreadPool& pool, size_t count, const std::function<void(size_t)>& func) {
+    parallelFor(count, [&pool](size_t) -> ThreadPool& {
+        return pool;
+    }, func);
+}
+
+ThreadPool::ThreadPool(unsigned threadsNum, const std::vector<int>& affinity) {
+    if (0 == threadsNum) {
+        threadsNum = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    for (unsigned i = 0; i < threadsNum; ++i) {
+        queues.emplace_back(new TaskQueue);
+    }
+    for (unsigned i = 0; i < threadsNum; ++i) {
+        workers.emplace_back(&ThreadPool::workerFunc, this, i);
+        if (!affinity.empty()) {
+            setAffinity(workers.back(), affinity[i % affinity.size()]);
+        }
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    hasTasks.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    auto& queue = *queues[nextQueue++ % queues.size()];
+    {
+        std::unique_lock<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ++pendingTasks;
+    }
+    hasTasks.notify_one();
+}
+
+bool ThreadPool::tryPop(size_t queueIdx, std::function<void()>& task) {
+    auto& queue = *queues[queueIdx];
+    std::unique_lock<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    return true;
+}
+
+void ThreadPool::workerFunc(size_t workerIdx) {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            hasTasks.wait(lock, [&]() {
+                return pendingTasks > 0 || stopping;
+            });
+            if (0 == pendingTasks) {
+                return;  // stopping and all tasks are done
+            }
+        }
+        // Own queue first, then steal from the others
+        std::function<void()> task;
+        for (size_t i = 0; i < queues.size() && !task; ++i) {
+            tryPop((workerIdx + i) % queues.size(), task);
+        }
+        if (!task) {
+            // Another worker took the task, pendingTasks is decremented by it
+            std::this_thread::yield();
+            continue;
+        }
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            --pendingTasks;
+        }
+        task();
+    }
+}
+
 #ifdef USE_TBB
 #include <cassert>
 
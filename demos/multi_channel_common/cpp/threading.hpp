@@ -4,6 +4,59 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing thread pool used when TBB isn't available. Every worker has its own task queue, tasks are distributed
+// over the queues round-robin and idle workers steal tasks from the queues of the others.
+class ThreadPool final {
+public:
+    // threadsNum - number of workers, 0 means std::thread::hardware_concurrency()
+    // affinity - CPU cores to pin workers to, worker i is pinned to affinity[i % affinity.size()]. Workers aren't
+    // pinned if it is empty.
+    explicit ThreadPool(unsigned threadsNum = 0, const std::vector<int>& affinity = {});
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator =(const ThreadPool&) = delete;
+    // Waits for all submitted tasks to complete
+    ~ThreadPool();
+
+    void submit(std::function<void()> task);
+
+private:
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool tryPop(size_t queueIdx, std::function<void()>& task);
+    void workerFunc(size_t workerIdx);
+
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    std::atomic<size_t> nextQueue = {0};
+
+    std::mutex mutex;
+    std::condition_variable hasTasks;
+    size_t pendingTasks = 0;
+    bool stopping = false;
+
+    std::vector<std::thread> workers;
+};
+
+// Runs func(i) for every i in [0, count) on the pool returned by poolOf(i) and waits for all of them. Rethrows the
+// first exception thrown by func.
+void parallelFor(size_t count, const std::function<ThreadPool&(size_t)>& poolOf,
+                 const std::function<void(size_t)>& func);
+void parallelFor(ThreadPool& pool, size_t count, const std::function<void(size_t)>& func);
+
+// Restricts the calling thread to the CPU cores, does nothing if cores is empty
+void pinCurrentThread(const std::vector<int>& cores);
+
 #ifdef USE_TBB
 #include <utility>
 
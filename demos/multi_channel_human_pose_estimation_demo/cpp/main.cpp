@@ -22,12 +22,15 @@
 #include <vector>
 #include <utility>
 
+#include <algorithm>
 #include <mutex>
 #include <queue>
 #include <chrono>
+#include <fstream>
 #include <sstream>
 #include <memory>
 #include <string>
+#include <thread>
 
 #ifdef USE_TBB
 #include <tbb/parallel_for.h>
@@ -43,6 +46,8 @@
 #include "input.hpp"
 #include "multichannel_params.hpp"
 #include "output.hpp"
+#include "placement.hpp"
+#include "scheduler.hpp"
 #include "threading.hpp"
 #include "graph.hpp"
 
@@ -53,6 +58,10 @@
 #include "postprocess.hpp"
 
 namespace {
+constexpr char native_decode_message[] = "Decode poses on the output feature maps with sub-pixel refinement of keypoints "
+    "instead of upsampling the maps, which is several times faster";
+DEFINE_bool(native_decode, false, native_decode_message);
+
 void parse(int argc, char *argv[]) {
     gflags::ParseCommandLineFlags(&argc, &argv, false);
     slog::info << ov::get_openvino_version() << slog::endl;
@@ -64,12 +73,19 @@ void parse(int argc, char *argv[]) {
                   << "\n     -m <path>        " << model_path_message
                   << "\n    [-d <device>]     " << target_device_message
                   << "\n    [-bs]             " << batch_size
+                  << "\n    [-batch_timeout]  " << batch_timeout_message
                   << "\n    [-n_iqs]          " << input_queue_size
                   << "\n    [-fps_sp]         " << fps_sampling_period
                   << "\n    [-n_sp]           " << num_sampling_periods
                   << "\n    [-no_show]        " << no_show_message
                   << "\n    [-show_stats]     " << show_statistics
+                  << "\n    [-stats_json]     " << stats_json_message
                   << "\n    [-real_input_fps] " << real_input_fps
+                  << "\n    [-display_fps]    " << display_fps_message
+                  << "\n    [-numa]           " << numa_message
+                  << "\n    [-priorities]     " << priorities_message
+                  << "\n    [-target_fps]     " << target_fps_message
+                  << "\n    [-native_decode]  " << native_decode_message
                   << "\n    [-u]              " << utilization_monitors_message << '\n';
         showAvailableDevices();
         std::exit(0);
@@ -119,15 +135,20 @@ DisplayParams prepareDisplayParams(size_t count) {
 void displayNSources(const std::vector<std::shared_ptr<VideoFrame>>& data,
                      const std::string& stats,
                      DisplayParams params,
+                     cv::Mat& gridImage,
                      Presenter& presenter,
                      PerformanceMetrics& metrics,
                      bool no_show) {
-    cv::Mat windowImage = cv::Mat::zeros(params.windowSize, CV_8UC3);
+    // Cells persist between calls, only the channels with new frames are redrawn
+    if (gridImage.empty()) {
+        gridImage = cv::Mat::zeros(params.windowSize, CV_8UC3);
+    }
+    cv::Mat windowImage;
     auto loopBody = [&](size_t i) {
         auto& elem = data[i];
         if (!elem->frame.empty()) {
-            cv::Rect rectFrame = cv::Rect(params.points[i], params.frameSize);
-            cv::Mat windowPart = windowImage(rectFrame);
+            cv::Rect rectFrame = cv::Rect(params.points[elem->sourceIdx], params.frameSize);
+            cv::Mat windowPart = gridImage(rectFrame);
             cv::resize(elem->frame, windowPart, params.frameSize);
             renderHumanPose(elem->detections.get<std::vector<HumanPose>>(), windowPart);
         }
@@ -162,6 +183,8 @@ void displayNSources(const std::vector<std::shared_ptr<VideoFrame>>& data,
         loopBody(i);
     }
 #endif
+    // Overlays are drawn over a copy, so they don't stay in the cells
+    gridImage.copyTo(windowImage);
     presenter.drawGraphs(windowImage);
     drawStats();
     for (size_t i = 0; i < data.size() - 1; ++i) {
@@ -211,37 +234,89 @@ int main(int argc, char* argv[]) {
         postParams.heatMapsHeight = postParams.heatMapsOut.get_shape()[ov::layout::height_idx(outLayout)];
         postParams.heatMapsChannels = postParams.heatMapsOut.get_shape()[ov::layout::channels_idx(outLayout)];
 
-        std::queue<ov::InferRequest> reqQueue = compile(std::move(model),
-            FLAGS_m, FLAGS_d, roundUp(params.count, FLAGS_bs), core);
-        ov::Shape inputShape = reqQueue.front().get_input_tensor().get_shape();
+        const ov::Layout inputLayout{"NHWC"};
+        ov::Shape inputShape = model->input().get_shape();
         if (4 != inputShape.size()) {
             throw std::runtime_error("Invalid model input dimensions");
         }
-        IEGraph graph{std::move(reqQueue), FLAGS_show_stats};
 
+        const bool collectStats = FLAGS_show_stats || !FLAGS_stats_json.empty();
         VideoSources::InitParams vsParams;
         vsParams.inputs               = inputs;
         vsParams.loop                 = FLAGS_loop;
         vsParams.queueSize            = FLAGS_n_iqs;
-        vsParams.collectStats         = FLAGS_show_stats;
+        vsParams.collectStats         = collectStats;
         vsParams.realFps              = FLAGS_real_input_fps;
-        vsParams.expectedHeight = static_cast<unsigned>(inputShape[2]);
-        vsParams.expectedWidth  = static_cast<unsigned>(inputShape[3]);
+        vsParams.expectedHeight = static_cast<unsigned>(inputShape[ov::layout::height_idx(inputLayout)]);
+        vsParams.expectedWidth  = static_cast<unsigned>(inputShape[ov::layout::width_idx(inputLayout)]);
+        vsParams.deviceFrames         = FLAGS_d.find("GPU") == 0;
+        for (const std::string& priority : split(FLAGS_priorities, ',')) {
+            vsParams.priorities.push_back(std::stof(priority));
+            if (vsParams.priorities.back() <= 0.0f) {
+                throw std::runtime_error("Parameter -priorities must be positive");
+            }
+        }
+        for (const std::string& fps : split(FLAGS_target_fps, ',')) {
+            vsParams.targetFps.push_back(std::stof(fps));
+            if (vsParams.targetFps.back() < 0.0f) {
+                throw std::runtime_error("Parameter -target_fps can't be negative");
+            }
+        }
 
+        std::unique_ptr<ChannelPlacement> placement;
+        if (FLAGS_numa) {
+            placement.reset(new ChannelPlacement(params.count, getNumaNodes()));
+            for (size_t i = 0; i < inputs.size(); ++i) {
+                // Channels of an input are contiguous, the input is read on the node of its first channel
+                vsParams.affinity.push_back(placement->node(placement->groupOf(i * FLAGS_duplicate_num)).cores);
+            }
+            slog::info << "Channels are split into " << placement->groupsNum() << " NUMA node groups" << slog::endl;
+        }
+
+        // Sources are created before the model is compiled, because GPU may share the VA display of their frames
         VideoSources sources(vsParams);
+        void* vaDisplay = sources.getVaDisplay();
+        std::queue<ov::InferRequest> reqQueue = nullptr != vaDisplay
+            ? compileForVaSurfaces(std::move(model), FLAGS_m, FLAGS_d, roundUp(params.count, FLAGS_bs), core, vaDisplay)
+            : compile(std::move(model), FLAGS_m, FLAGS_d, roundUp(params.count, FLAGS_bs), core, FLAGS_numa);
+        IEGraph graph{std::move(reqQueue), collectStats};
+        if (nullptr != placement) {
+            graph.setPlacement(*placement);
+        }
+
         sources.start();
 
-        size_t currentFrame = 0;
+        std::vector<ChannelScheduler::Channel> channelsQos;
+        for (size_t i = 0; i < params.count; ++i) {
+            const size_t input = i / FLAGS_duplicate_num;
+            channelsQos.push_back({sources.getPriority(input), sources.getTargetFps(input)});
+        }
+        ChannelScheduler scheduler(channelsQos);
+        if (FLAGS_batch_timeout > 0) {
+            graph.setBatchTimeout(std::chrono::milliseconds(FLAGS_batch_timeout), [&]() {
+                if (sources.isFrameReady(scheduler.current() / FLAGS_duplicate_num)) {
+                    return true;
+                }
+                scheduler.advance();
+                return false;
+            });
+        }
+#ifndef USE_TBB
+        // One worker per batch slot, ThreadPool treats 0 reported by hardware_concurrency() as its default
+        ThreadPool postprocessingPool(
+            static_cast<unsigned>(std::min<size_t>(FLAGS_bs, std::thread::hardware_concurrency())));
+#endif
         graph.start(FLAGS_bs, [&](VideoFrame& img) {
-            img.sourceIdx = currentFrame;
-            size_t camIdx = currentFrame / FLAGS_duplicate_num;
-            currentFrame = (currentFrame + 1) % (sources.numberOfInputs() * FLAGS_duplicate_num);
+            img.sourceIdx = scheduler.current();
+            size_t camIdx = img.sourceIdx / FLAGS_duplicate_num;
+            scheduler.advance();
             return sources.getFrame(camIdx, img);
-        }, [&postParams](ov::InferRequest req, cv::Size frameSize) {
+        }, [&](ov::InferRequest req, cv::Size frameSize) {
             std::vector<Detections> detections(FLAGS_bs);
             float* heatMapsData = req.get_tensor(postParams.heatMapsOut).data<float>();
             float* pafsData = req.get_tensor(postParams.pafsOut).data<float>();
-            for (size_t i = 0; i < FLAGS_bs; i++) {
+            // Poses of every batch slot are extracted by a separate task
+            auto postprocessSlot = [&](size_t i) {
                 std::vector<HumanPose> poses = postprocess(
                     heatMapsData + i * postParams.heatMapsWidth * postParams.heatMapsHeight * postParams.heatMapsChannels,
                     postParams.heatMapsWidth * postParams.heatMapsHeight,
@@ -249,12 +324,23 @@ int main(int argc, char* argv[]) {
                     pafsData + i * postParams.pafsWidth * postParams.pafsHeight * postParams.pafsChannels,
                     postParams.pafsWidth * postParams.pafsHeight,
                     postParams.pafsChannels,
-                    postParams.heatMapsWidth, postParams.heatMapsHeight, frameSize);
+                    postParams.heatMapsWidth, postParams.heatMapsHeight, frameSize, FLAGS_native_decode);
 
                 detections[i].set(new std::vector<HumanPose>(poses.size()));
                 for (decltype(poses.size()) j = 0; j < poses.size(); j++) {
                     detections[i].get<std::vector<HumanPose>>()[j] = std::move(poses[j]);
                 }
+            };
+            if (1 == FLAGS_bs) {
+                postprocessSlot(0);
+            } else {
+#ifdef USE_TBB
+                run_in_arena([&]() {
+                    tbb::parallel_for<size_t>(0, FLAGS_bs, postprocessSlot);
+                });
+#else
+                parallelFor(postprocessingPool, FLAGS_bs, postprocessSlot);
+#endif
             }
             return detections;
         });
@@ -267,50 +353,45 @@ int main(int argc, char* argv[]) {
         Presenter presenter(FLAGS_u, params.windowSize.height - graphSize.height - 10, graphSize);
         PerformanceMetrics metrics;
 
-        const size_t outputQueueSize = 1;
-        AsyncOutput output(FLAGS_show_stats, outputQueueSize,
+        cv::Mat gridImage;
+        const std::chrono::milliseconds displayPeriod{FLAGS_display_fps > 0 ? 1000 / FLAGS_display_fps : 0};
+        AsyncOutput output(collectStats,
         [&](const std::vector<std::shared_ptr<VideoFrame>>& result) {
             std::string str;
             if (FLAGS_show_stats) {
                 std::unique_lock<std::mutex> lock(statMutex);
                 str = statStream.str();
             }
-            displayNSources(result, str, params, presenter, metrics, FLAGS_no_show);
+            displayNSources(result, str, params, gridImage, presenter, metrics, FLAGS_no_show);
             int key = cv::waitKey(1);
             presenter.handleKey(key);
 
             return (key != 27);
-        });
+        }, displayPeriod);
 
         output.start();
 
-        std::vector<std::shared_ptr<VideoFrame>> batchRes;
         using timer = std::chrono::high_resolution_clock;
         using duration = std::chrono::duration<float, std::milli>;
         timer::time_point lastTime = timer::now();
         duration samplingTimeout(FLAGS_fps_sp);
 
+        std::ofstream statsJson;
+        if (!FLAGS_stats_json.empty()) {
+            statsJson.open(FLAGS_stats_json, std::ios::app);
+            if (!statsJson) {
+                throw std::runtime_error("Can't open " + FLAGS_stats_json);
+            }
+        }
+
         size_t perfItersCounter = 0;
 
         while (sources.isRunning() || graph.isRunning()) {
-            bool readData = true;
-            while (readData) {
-                auto br = graph.getBatchData(params.frameSize);
-                if (br.empty()) {
-                    break;  // IEGraph::getBatchData had nothing to process and returned. That means it was stopped
-                }
-                for (size_t i = 0; i < br.size(); i++) {
-                    // this approach waits for the next input image for sourceIdx. If provided a single image,
-                    // it may not show results, especially if -real_input_fps is enabled
-                    auto val = static_cast<unsigned int>(br[i]->sourceIdx);
-                    auto it = find_if(batchRes.begin(), batchRes.end(), [val] (const std::shared_ptr<VideoFrame>& vf) { return vf->sourceIdx == val; } );
-                    if (it != batchRes.end()) {
-                        output.push(std::move(batchRes));
-                        batchRes.clear();
-                        readData = false;
-                    }
-                    batchRes.push_back(std::move(br[i]));
-                }
+            // The output redraws channels incrementally, so results are passed as soon as they are ready. br is
+            // empty if IEGraph::getBatchData had nothing to process and returned. That means it was stopped.
+            auto br = graph.getBatchData(params.frameSize);
+            if (!br.empty()) {
+                output.push(std::move(br));
             }
 
             if (!output.isAlive()) {
@@ -334,6 +415,9 @@ int main(int argc, char* argv[]) {
                     statStream.str(std::string());
                     writeStats(statStream, '\n', sources.getStats(), graph.getStats(), output.getStats());
                 }
+                if (statsJson.is_open()) {
+                    writeStatsJson(statsJson, sources.getStats(), graph.getStats(), output.getStats());
+                }
             }
         }
         slog::info << "Metrics report:" << slog::endl;
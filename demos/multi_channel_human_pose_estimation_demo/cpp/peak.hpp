@@ -55,6 +55,10 @@ void findPeaks(const std::vector<cv::Mat>& heatMaps,
                std::vector<std::vector<Peak> >& allPeaks,
                int heatMapId);
 
+// Moves every peak to the vertex of the parabolas fitted to the heat map values at the peak and its neighbours along
+// both axes, which restores sub-pixel positions of the peaks found on a heat map of low resolution
+void refinePeaks(const cv::Mat& heatMap, std::vector<Peak>& peaks);
+
 std::vector<HumanPose> groupPeaksToPoses(
         const std::vector<std::vector<Peak> >& allPeaks,
         const std::vector<cv::Mat>& pafs,
@@ -24,14 +24,18 @@ namespace {
 class FindPeaksBody: public cv::ParallelLoopBody {
 public:
     FindPeaksBody(const std::vector<cv::Mat>& heatMaps, float minPeaksDistance,
-                  std::vector<std::vector<Peak> >& peaksFromHeatMap)
+                  std::vector<std::vector<Peak> >& peaksFromHeatMap, bool refine)
         : heatMaps(heatMaps),
           minPeaksDistance(minPeaksDistance),
-          peaksFromHeatMap(peaksFromHeatMap) {}
+          peaksFromHeatMap(peaksFromHeatMap),
+          refine(refine) {}
 
     void operator()(const cv::Range& range) const override {
         for (int i = range.start; i < range.end; i++) {
             findPeaks(heatMaps, minPeaksDistance, peaksFromHeatMap, i);
+            if (refine) {
+                refinePeaks(heatMaps[i], peaksFromHeatMap[i]);
+            }
         }
     }
 
@@ -39,12 +43,16 @@ private:
     const std::vector<cv::Mat>& heatMaps;
     float minPeaksDistance;
     std::vector<std::vector<Peak> >& peaksFromHeatMap;
+    bool refine;
 };
 
 int upsampleRatio = 4;
 int stride = 8;
 float minPeaksDistance = 6.0f / (stride / upsampleRatio);
 Postprocessor postprocessor(upsampleRatio, stride);
+// Keypoints found on the feature maps of the network are in the same units as keypoints of maps upsampled by 1
+float nativeMinPeaksDistance = 6.0f / stride;
+Postprocessor nativePostprocessor(1, stride);
 
 float const midPointsScoreThreshold = 0.05f;
 float const foundMidPointsRatioThreshold = 0.8f;
@@ -53,9 +61,11 @@ float minSubsetScore = 0.2f;
 
 std::vector<HumanPose> extractPoses(
         const std::vector<cv::Mat>& heatMaps,
-        const std::vector<cv::Mat>& pafs) {
+        const std::vector<cv::Mat>& pafs,
+        bool decodeAtNativeResolution) {
     std::vector<std::vector<Peak> > peaksFromHeatMap(heatMaps.size());
-    FindPeaksBody findPeaksBody(heatMaps, minPeaksDistance, peaksFromHeatMap);
+    FindPeaksBody findPeaksBody(heatMaps, decodeAtNativeResolution ? nativeMinPeaksDistance : minPeaksDistance,
+                                peaksFromHeatMap, decodeAtNativeResolution);
     cv::parallel_for_(cv::Range(0, static_cast<int>(heatMaps.size())),
                       findPeaksBody);
     int peaksBefore = 0;
@@ -76,7 +86,9 @@ std::vector<HumanPose> postprocess(
         const float* heatMapsData, const int heatMapOffset, const int nHeatMaps,
         const float* pafsData, const int pafOffset, const int nPafs,
         const int featureMapWidth, const int featureMapHeight,
-        const cv::Size& imageSize) {
+        const cv::Size& imageSize,
+        bool decodeAtNativeResolution) {
+    const Postprocessor& featureMapsPostprocessor = decodeAtNativeResolution ? nativePostprocessor : postprocessor;
     std::vector<cv::Mat> heatMaps(nHeatMaps);
     for (size_t i = 0; i < heatMaps.size(); i++) {
         heatMaps[i] = cv::Mat(featureMapHeight, featureMapWidth, CV_32FC1,
@@ -84,7 +96,7 @@ std::vector<HumanPose> postprocess(
                                   const_cast<float*>(
                                       heatMapsData + i * heatMapOffset)));
     }
-    postprocessor.resizeFeatureMaps(heatMaps);
+    featureMapsPostprocessor.resizeFeatureMaps(heatMaps);
 
     std::vector<cv::Mat> pafs(nPafs);
     for (size_t i = 0; i < pafs.size(); i++) {
@@ -93,9 +105,9 @@ std::vector<HumanPose> postprocess(
                               const_cast<float*>(
                                   pafsData + i * pafOffset)));
     }
-    postprocessor.resizeFeatureMaps(pafs);
+    featureMapsPostprocessor.resizeFeatureMaps(pafs);
 
-    std::vector<HumanPose> poses = extractPoses(heatMaps, pafs);
-    postprocessor.correctCoordinates(poses, heatMaps[0].size(), imageSize);
+    std::vector<HumanPose> poses = extractPoses(heatMaps, pafs, decodeAtNativeResolution);
+    featureMapsPostprocessor.correctCoordinates(poses, heatMaps[0].size(), imageSize);
     return poses;
 }
@@ -28,4 +28,5 @@ std::vector<HumanPose> postprocess(
         float const* heatMapsData, int const heatMapOffset, int const nHeatMaps,
         float const* pafsData, int const pafOffset, int const nPafs,
         int const featureMapWidth, int const featureMapHeight,
-        cv::Size const& imageSize);
+        cv::Size const& imageSize,
+        bool decodeAtNativeResolution = false);
@@ -27,6 +27,9 @@ Postprocessor::Postprocessor(int const upsampleRatio, int const stride, cv::Vec4
       pad(pad) {}
 
 void Postprocessor::resizeFeatureMaps(std::vector<cv::Mat>& featureMaps) const {
+    if (upsampleRatio == 1) {
+        return;
+    }
     for (auto& featureMap : featureMaps) {
         cv::resize(featureMap, featureMap, cv::Size(),
                    upsampleRatio, upsampleRatio, cv::INTER_CUBIC);
@@ -2,12 +2,20 @@
 // SPDX-License-Identifier: Apache-2.0
 //
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <functional>
 #include <iomanip>
+#include <memory>
+#include <numeric>
 #include <openvino/openvino.hpp>
 #include <gflags/gflags.h>
+#include <utils/args_helper.hpp>
 #include <utils/common.hpp>
+#include <utils/performance_metrics.hpp>
 #include <utils/slog.hpp>
+#include <utils/startup_profiler.hpp>
 
 namespace {
 constexpr char h_msg[] = "show this help message and exit";
@@ -16,15 +24,20 @@ DEFINE_bool(h, false, h_msg);
 constexpr char m_msg[] = "path to an .xml file with a trained model";
 DEFINE_string(m, "", m_msg);
 
-constexpr char i_msg[] = "path to an input WAV file";
+constexpr char i_msg[] = "comma separated list of input WAV files, \"-\" reads a WAV stream from stdin, e.g. from arecord. "
+    "Every input is an independent stream denoised concurrently on its own infer requests";
 DEFINE_string(i, "", i_msg);
 
 constexpr char d_msg[] = "specify a device to infer on (the list of available devices is shown below). Default is CPU";
 DEFINE_string(d, "CPU", d_msg);
 
-constexpr char o_msg[] = "path to an output WAV file. Default is noise_suppression_demo_out.wav";
+constexpr char o_msg[] = "comma separated list of output WAV files, one for every input, \"-\" writes a WAV stream to stdout "
+    "and moves the logs to stderr. Default is noise_suppression_demo_out.wav";
 DEFINE_string(o, "noise_suppression_demo_out.wav", o_msg);
 
+// the logs are written to std::cout, so its buffer is kept here for the output stream when stdout is an output
+std::streambuf* const stdout_buffer = std::cout.rdbuf();
+
 void parse(int argc, char *argv[]) {
     gflags::ParseCommandLineFlags(&argc, &argv, false);
     if (FLAGS_h || 1 == argc) {
@@ -44,6 +57,16 @@ void parse(int argc, char *argv[]) {
     } if (FLAGS_o.empty()) {
         throw std::invalid_argument{"-o <WAV> can't be empty"};
     }
+    const std::vector<std::string> inputs = split(FLAGS_i, ',');
+    const std::vector<std::string> outputs = split(FLAGS_o, ',');
+    if (inputs.size() != outputs.size()) {
+        throw std::invalid_argument{"-i and -o must have the same number of WAV files"};
+    } if (std::count(inputs.begin(), inputs.end(), "-") > 1 || std::count(outputs.begin(), outputs.end(), "-") > 1) {
+        throw std::invalid_argument{"only one stream can be read from stdin or written to stdout"};
+    }
+    if (std::count(outputs.begin(), outputs.end(), "-") > 0) {
+        std::cout.rdbuf(std::cerr.rdbuf());
+    }
     slog::info << ov::get_openvino_version() << slog::endl;
 }
 
@@ -67,48 +90,200 @@ const unsigned int fourcc(const char c[4]) {
     return (c[3] << 24) | (c[2] << 16) | (c[1] << 8) | (c[0]);
 }
 
-void read_wav(const std::string& file_name, RiffWaveHeader& wave_header, std::vector<int16_t>& wave) {
-    std::ifstream inp_wave(file_name, std::ios::in|std::ios::binary);
-    if(!inp_wave.is_open())
-        throw std::runtime_error("fail to open " + file_name);
-
-    inp_wave.read((char*)&wave_header, sizeof(RiffWaveHeader));
-
-    std::string error_msg = "";
-    #define CHECK_IF(cond) if(cond){ error_msg = error_msg + #cond + ", "; }
-
-    // make sure it is actually a RIFF file with WAVE
-    CHECK_IF(wave_header.riff_tag != fourcc("RIFF"));
-    CHECK_IF(wave_header.wave_tag != fourcc("WAVE"));
-    CHECK_IF(wave_header.fmt_tag != fourcc("fmt "));
-    // only PCM
-    CHECK_IF(wave_header.data_format != 1);
-    // only mono
-    CHECK_IF(wave_header.num_of_channels != 1);
-    // only 16 bit
-    CHECK_IF(wave_header.bits_per_sample != 16);
-    // make sure that data chunk follows file header
-    CHECK_IF(wave_header.data_tag != fourcc("data"));
-    #undef CHECK_IF
-
-    if (!error_msg.empty()) {
-        throw std::runtime_error(error_msg + "for '" + file_name + "' file.");
+// Reads samples of a mono 16 bit PCM WAV file chunk by chunk, so a stream from a pipe is processed while it arrives
+class WavReader {
+public:
+    explicit WavReader(const std::string& file_name) : stream(&std::cin) {
+        if (file_name != "-") {
+            file.open(file_name, std::ios::in|std::ios::binary);
+            if (!file.is_open())
+                throw std::runtime_error("fail to open " + file_name);
+            stream = &file;
+        }
+
+        stream->read((char*)&wave_header, sizeof(RiffWaveHeader));
+
+        std::string error_msg = "";
+        #define CHECK_IF(cond) if(cond){ error_msg = error_msg + #cond + ", "; }
+
+        // make sure it is actually a RIFF file with WAVE
+        CHECK_IF(wave_header.riff_tag != fourcc("RIFF"));
+        CHECK_IF(wave_header.wave_tag != fourcc("WAVE"));
+        CHECK_IF(wave_header.fmt_tag != fourcc("fmt "));
+        // only PCM
+        CHECK_IF(wave_header.data_format != 1);
+        // only mono
+        CHECK_IF(wave_header.num_of_channels != 1);
+        // only 16 bit
+        CHECK_IF(wave_header.bits_per_sample != 16);
+        // make sure that data chunk follows file header
+        CHECK_IF(wave_header.data_tag != fourcc("data"));
+        #undef CHECK_IF
+
+        if (!error_msg.empty()) {
+            throw std::runtime_error(error_msg + "for '" + file_name + "' file.");
+        }
+        // streams of unknown length, e.g. from arecord, have the maximal length in the header
+        samples_left = static_cast<unsigned int>(wave_header.data_length) / sizeof(int16_t);
     }
 
-    size_t wave_size = wave_header.data_length / sizeof(int16_t);
-    wave.resize(wave_size);
+    const RiffWaveHeader& header() const {
+        return wave_header;
+    }
 
-    inp_wave.read((char*)&(wave.front()), wave_size * sizeof(int16_t));
-}
+    // Blocks until count samples are read or the data ends
+    // @returns number of read samples, it is less than count at the end of the data
+    size_t read(int16_t* samples, size_t count) {
+        count = std::min(count, samples_left);
+        stream->read((char*)samples, count * sizeof(int16_t));
+        size_t read_count = static_cast<size_t>(stream->gcount()) / sizeof(int16_t);
+        samples_left = read_count < count ? 0 : samples_left - read_count;
+        return read_count;
+    }
 
-void write_wav(const std::string& file_name, const RiffWaveHeader& wave_header, const std::vector<int16_t>& wave) {
-    std::ofstream out_wave(file_name, std::ios::out|std::ios::binary);
-    if(!out_wave.is_open())
-        throw std::runtime_error("fail to open " + file_name);
+private:
+    std::ifstream file;
+    std::istream* stream;
+    RiffWaveHeader wave_header;
+    size_t samples_left;
+};
 
-    out_wave.write((char*)&wave_header, sizeof(RiffWaveHeader));
-    out_wave.write((char*)&(wave.front()), wave.size() * sizeof(int16_t));
-}
+// Writes a WAV file chunk by chunk. The header is copied from the input, and its lengths are corrected at the end if
+// the output is a file, a stream to stdout keeps the lengths of the input
+class WavWriter {
+public:
+    WavWriter(const std::string& file_name, const RiffWaveHeader& wave_header)
+            : stdout_stream(stdout_buffer), stream(&stdout_stream), wave_header(wave_header), samples_count(0) {
+        if (file_name != "-") {
+            file.open(file_name, std::ios::out|std::ios::binary);
+            if (!file.is_open())
+                throw std::runtime_error("fail to open " + file_name);
+            stream = &file;
+        }
+        stream->write((const char*)&wave_header, sizeof(RiffWaveHeader));
+    }
+
+    void write(const int16_t* samples, size_t count) {
+        stream->write((const char*)samples, count * sizeof(int16_t));
+        if (stream == &stdout_stream) {
+            stream->flush();  // a player on the other end of the pipe shouldn't wait for the buffer to fill
+        }
+        samples_count += count;
+    }
+
+    void close() {
+        if (file.is_open()) {
+            wave_header.data_length = static_cast<int>(samples_count * sizeof(int16_t));
+            wave_header.riff_length = static_cast<int>(sizeof(RiffWaveHeader) - 8 + wave_header.data_length);
+            file.seekp(0);
+            file.write((const char*)&wave_header, sizeof(RiffWaveHeader));
+            file.close();
+        }
+        if (!*stream) {
+            throw std::runtime_error("fail to write the output WAV");
+        }
+    }
+
+private:
+    std::ofstream file;
+    std::ostream stdout_stream;
+    std::ostream* stream;
+    RiffWaveHeader wave_header;
+    size_t samples_count;
+};
+
+// Denoises one audio stream patch by patch, so its latency is bounded by one patch and the delay of the model. The
+// states are kept in two preallocated sets of tensors, which are bound to two infer requests crosswise: output states
+// of one request are input states of the other, so the requests alternate and no tensor is created or rebound per
+// patch. The input and the output tensors are shared by both requests too.
+class StreamDenoiser {
+public:
+    StreamDenoiser(ov::CompiledModel& compiled_model,
+                   const std::vector<std::pair<std::string, std::string>>& state_names,
+                   size_t patch_size, size_t delay)
+            : patch_size(patch_size), delay(delay), infer_time(0), patches_count(0), samples_count(0) {
+        requests[0] = compiled_model.create_infer_request();
+        requests[1] = compiled_model.create_infer_request();
+        input_tensor = requests[0].get_tensor("input");
+        output_tensor = requests[0].get_tensor("output");
+        requests[1].set_tensor("input", input_tensor);
+        requests[1].set_tensor("output", output_tensor);
+        for (const auto& state_name : state_names) {
+            // the first request starts from the zero state
+            ov::Tensor state_tensor = requests[0].get_tensor(state_name.first);
+            std::memset(state_tensor.data(), 0, state_tensor.get_byte_size());
+            requests[1].set_tensor(state_name.second, state_tensor);
+            requests[0].set_tensor(state_name.second, requests[1].get_tensor(state_name.first));
+        }
+    }
+
+    void run(WavReader& reader, WavWriter& writer) {
+        std::vector<int16_t> inp_patch(patch_size);
+        std::vector<int16_t> out_patch(patch_size);
+        const float scale = 1.0f / std::numeric_limits<int16_t>::max();
+        float* inp = input_tensor.data<float>();
+        const float* out = output_tensor.data<float>();
+
+        // output samples are shifted by the delay of the model, so the first delay samples are skipped and the end of
+        // the input is padded with zeros until all its samples are out
+        size_t read_count = 0;
+        size_t written_count = 0;
+        size_t skip_count = delay;
+        bool end_of_input = false;
+        while (!end_of_input || written_count < read_count) {
+            size_t count = end_of_input ? 0 : reader.read(inp_patch.data(), patch_size);
+            end_of_input = count < patch_size;
+            read_count += count;
+            for (size_t i = 0; i < count; ++i) {
+                inp[i] = (float)inp_patch[i] * scale;
+            }
+            std::fill(inp + count, inp + patch_size, 0.0f);
+
+            auto start_time = std::chrono::steady_clock::now();
+            requests[patches_count % 2].infer();
+            auto latency = std::chrono::steady_clock::now() - start_time;
+            latency_histogram.record(latency);
+            infer_time += latency;
+            ++patches_count;
+
+            size_t begin = std::min(skip_count, patch_size);
+            skip_count -= begin;
+            size_t end = begin + std::min(patch_size - begin, read_count - written_count);
+            for (size_t i = begin; i < end; ++i) {
+                float v = clamp(out[i], -1.0f, +1.0f);
+                out_patch[i - begin] = (int16_t)(v * std::numeric_limits<int16_t>::max());
+            }
+            writer.write(out_patch.data(), end - begin);
+            written_count += end - begin;
+        }
+        samples_count = read_count;
+        writer.close();
+    }
+
+    void log_metrics(int freq_data) const {
+        using ms = std::chrono::duration<double, std::ratio<1, 1000>>;
+        double infer_ms = std::chrono::duration_cast<ms>(infer_time).count();
+        double sample_ms = samples_count / (freq_data * 1e-3);
+        slog::info << "\tLatency: " << std::fixed << std::setprecision(1) << infer_ms << " ms" << slog::endl;
+        slog::info << "\tPatch latency: mean " << (patches_count ? infer_ms / patches_count : 0.0) << " ms, p99 "
+                   << latency_histogram.getPercentile(99) << " ms, patch length "
+                   << patch_size / (freq_data * 1e-3) << " ms" << slog::endl;
+        slog::info << "\tSample length: " << sample_ms << " ms" << slog::endl;
+        slog::info << "\tReal-time factor: " << std::setprecision(3) << (sample_ms > 0 ? infer_ms / sample_ms : 0.0)
+                   << slog::endl;
+    }
+
+private:
+    size_t patch_size;
+    size_t delay;
+    ov::InferRequest requests[2];
+    ov::Tensor input_tensor;
+    ov::Tensor output_tensor;
+    LatencyHistogram latency_histogram;
+    std::chrono::steady_clock::duration infer_time;
+    size_t patches_count;
+    size_t samples_count;
+};
 }  // namespace
 
 int main(int argc, char* argv[]) {
@@ -119,14 +294,14 @@ int main(int argc, char* argv[]) {
     std::shared_ptr<ov::Model> model = core.read_model(FLAGS_m);
     logBasicModelInfo(model);
 
-    ov::OutputVector inputs = model->inputs();
-    ov::OutputVector outputs = model->outputs();
+    ov::OutputVector inputs_info = model->inputs();
+    ov::OutputVector outputs_info = model->outputs();
 
     // get state names pairs (inp,out) and compute overall states size
     size_t state_size = 0;
     std::vector<std::pair<std::string, std::string>> state_names;
-    for (size_t i = 0; i < inputs.size(); i++) {
-        std::string inp_state_name = inputs[i].get_any_name();
+    for (size_t i = 0; i < inputs_info.size(); i++) {
+        std::string inp_state_name = inputs_info[i].get_any_name();
         if (inp_state_name.find("inp_state_") == std::string::npos)
             continue;
 
@@ -134,14 +309,14 @@ int main(int argc, char* argv[]) {
         out_state_name.replace(0, 3, "out");
 
         // find corresponding output state
-        if (outputs.end() == std::find_if(outputs.begin(), outputs.end(), [&out_state_name](const ov::Output<ov::Node>& output) {
+        if (outputs_info.end() == std::find_if(outputs_info.begin(), outputs_info.end(), [&out_state_name](const ov::Output<ov::Node>& output) {
             return output.get_any_name() == out_state_name;
         }))
             throw std::runtime_error("model output state name does not correspond input state name");
 
         state_names.emplace_back(inp_state_name, out_state_name);
 
-        ov::Shape shape = inputs[i].get_shape();
+        ov::Shape shape = inputs_info[i].get_shape();
         size_t tensor_size = std::accumulate(shape.begin(), shape.end(), 1, std::multiplies<size_t>());
 
         state_size += tensor_size;
@@ -152,23 +327,28 @@ int main(int argc, char* argv[]) {
 
     slog::info << "State_param_num = " << state_size << " (" << std::setprecision(4) << state_size * sizeof(float) * 1e-6f << "Mb)" << slog::endl;
 
-    ov::CompiledModel compiled_model = core.compile_model(model, FLAGS_d, {});
+    const std::vector<std::string> inputs = split(FLAGS_i, ',');
+    const std::vector<std::string> outputs = split(FLAGS_o, ',');
+    ov::AnyMap config;
+    if (inputs.size() > 1) {
+        // every stream keeps two requests, but they are inferred one after another
+        config = {ov::hint::performance_mode(ov::hint::PerformanceMode::THROUGHPUT),
+                  ov::hint::num_requests(static_cast<uint32_t>(inputs.size()))};
+    }
+    ov::CompiledModel compiled_model = core.compile_model(model, FLAGS_d, config);
     logCompiledModelInfo(compiled_model, FLAGS_m, FLAGS_d);
 
-    ov::InferRequest infer_request = compiled_model.create_infer_request();
-
-    // Prepare input
     // get size of network input (patch_size)
-    std::string input_name("input");
-    ov::Shape inp_shape = model->input(input_name).get_shape();
+    ov::Shape inp_shape = model->input("input").get_shape();
     size_t patch_size = inp_shape[1];
 
     // try to get delay output and freq output for model
     int delay = 0;
     int freq_model = 16000; // default sampling rate for model
+    ov::InferRequest infer_request = compiled_model.create_infer_request();
     infer_request.infer();
-    for (size_t i = 0; i < outputs.size(); i++) {
-        std::string out_name = outputs[i].get_any_name();
+    for (size_t i = 0; i < outputs_info.size(); i++) {
+        std::string out_name = outputs_info[i].get_any_name();
         if (out_name == "delay") {
             delay = infer_request.get_tensor("delay").data<int>()[0];
         }
@@ -179,79 +359,36 @@ int main(int argc, char* argv[]) {
     slog::info << "\tDelay: " << delay << " samples" << slog::endl;
     slog::info << "\tFreq: " << freq_model << " Hz" << slog::endl;
 
-    // read input wav file
-    RiffWaveHeader wave_header;
-    std::vector<int16_t> inp_wave_s16;
-    read_wav(FLAGS_i, wave_header, inp_wave_s16);
-    int freq_data = wave_header.sampling_freq;
-
-    if (freq_data != freq_model) {
-        slog::err << "Wav file " << FLAGS_i << " sampling rate " << freq_data << " does not match model sampling rate " << freq_model << slog::endl;
-        throw std::runtime_error("data sampling rate does not match model sampling rate");
+    // open the streams, the input headers are read here so a wrong input fails before any processing
+    std::vector<std::unique_ptr<WavReader>> readers;
+    std::vector<std::unique_ptr<WavWriter>> writers;
+    std::vector<std::unique_ptr<StreamDenoiser>> denoisers;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        readers.emplace_back(new WavReader(inputs[i]));
+        int freq_data = readers[i]->header().sampling_freq;
+        if (freq_data != freq_model) {
+            slog::err << "Wav file " << inputs[i] << " sampling rate " << freq_data << " does not match model sampling rate " << freq_model << slog::endl;
+            throw std::runtime_error("data sampling rate does not match model sampling rate");
+        }
+        writers.emplace_back(new WavWriter(outputs[i], readers[i]->header()));
+        denoisers.emplace_back(new StreamDenoiser(compiled_model, state_names, patch_size, static_cast<size_t>(delay)));
     }
 
-    std::vector<int16_t> out_wave_s16;
-    out_wave_s16.resize(inp_wave_s16.size());
-
-    std::vector<float> inp_wave_fp32;
-    std::vector<float> out_wave_fp32;
-
-    // fp32 input wave will be expanded to be divisible by patch_size
-    size_t iter = 1 + ((inp_wave_s16.size() + delay) / patch_size);
-    size_t inp_size = patch_size * iter;
-    inp_wave_fp32.resize(inp_size, 0);
-    out_wave_fp32.resize(inp_size, 0);
-
-    // convert sint16_t to float
-    float scale = 1.0f / std::numeric_limits<int16_t>::max();
-    for(size_t i = 0; i < inp_wave_s16.size(); ++i) {
-        inp_wave_fp32[i] = (float)inp_wave_s16[i] * scale;
+    std::vector<std::function<void()>> streams;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        streams.push_back([&, i]() {
+            denoisers[i]->run(*readers[i], *writers[i]);
+        });
     }
+    runInParallel(streams);
 
-    auto start_time = std::chrono::steady_clock::now();
-    for(size_t i = 0; i < iter; ++i) {
-        ov::Tensor input_tensor(ov::element::f32, inp_shape, &inp_wave_fp32[i * patch_size]);
-        infer_request.set_tensor(input_name, input_tensor);
-
-        for (auto& state_name: state_names) {
-            const std::string& inp_state_name = state_name.first;
-            const std::string& out_state_name = state_name.second;
-            ov::Tensor state_tensor;
-            if (i > 0) {
-                // set input state by coresponding output state from prev infer
-                state_tensor = infer_request.get_tensor(out_state_name);
-            } else {
-                // first iteration. set input state to zero tensor.
-                ov::Shape state_shape = model->input(inp_state_name).get_shape();
-                state_tensor = ov::Tensor(ov::element::f32, state_shape);
-                std::memset(state_tensor.data<float>(), 0, state_tensor.get_byte_size());
-            }
-            infer_request.set_tensor(inp_state_name, state_tensor);
-        }
-
-        infer_request.infer();
-
-        {
-            // process output
-            float* src = infer_request.get_tensor("output").data<float>();
-            float* dst = &out_wave_fp32[i * patch_size];
-            std::memcpy(dst, src, patch_size * sizeof(float));
-        }
-    } // for iter
-
-    using ms = std::chrono::duration<double, std::ratio<1, 1000>>;
-    double total_latency = std::chrono::duration_cast<ms>(std::chrono::steady_clock::now() - start_time).count();
     slog::info << "Metrics report:" << slog::endl;
-    slog::info << "\tLatency: " << std::fixed << std::setprecision(1) << total_latency << " ms" << slog::endl;
-    slog::info << "\tSample length: " << std::fixed << std::setprecision(1) << patch_size * iter / (freq_data * 1e-3) << " ms" << slog::endl;
-    slog::info << "\tSampling freq: " << freq_data << " Hz" << slog::endl;
-
-    // convert fp32 to int16_t and save to wav
-    for(size_t i = 0; i < out_wave_s16.size(); ++i) {
-        float v = out_wave_fp32[i+delay];
-        v = clamp(v, -1.0f, +1.0f);
-        out_wave_s16[i] = (int16_t)(v * std::numeric_limits<int16_t>::max());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if (inputs.size() > 1) {
+            slog::info << "\tStream " << inputs[i] << ":" << slog::endl;
+        }
+        denoisers[i]->log_metrics(freq_model);
     }
-    write_wav(FLAGS_o, wave_header, out_wave_s16);
+    slog::info << "\tSampling freq: " << freq_model << " Hz" << slog::endl;
     return 0;
 }
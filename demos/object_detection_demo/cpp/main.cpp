@@ -51,18 +51,40 @@
 #include <models/results.h>
 #include <monitors/presenter.h>
 #include <pipelines/async_pipeline.h>
+#include <pipelines/keyframe_pipeline.h>
 #include <pipelines/metadata.h>
+#include <pipelines/results_publisher.h>
+#include <pipelines/tiled_detection_pipeline.h>
 #include <utils/args_helper.hpp>
 #include <utils/common.hpp>
 #include <utils/config_factory.h>
 #include <utils/default_flags.hpp>
+#include <utils/frame_pool.hpp>
 #include <utils/images_capture.h>
+#include <utils/itt.hpp>
+#include <utils/memory_accounting.hpp>
+#include <utils/metrics_sink.hpp>
 #include <utils/ocv_common.hpp>
 #include <utils/performance_metrics.hpp>
+#include <utils/pooled_mat_allocator.hpp>
+#include <utils/render_thread.hpp>
 #include <utils/slog.hpp>
 
 DEFINE_INPUT_FLAGS
 DEFINE_OUTPUT_FLAGS
+DEFINE_OUTPUT_ENCODER_FLAGS
+DEFINE_METRICS_FLAGS
+DEFINE_INPUTS_MEMORY_FLAGS
+DEFINE_DEVICE_PREPROCESSING_FLAGS
+DEFINE_MOTION_GATE_FLAGS
+DEFINE_TUNING_FLAGS
+DEFINE_WARMUP_FLAGS
+DEFINE_LAYERS_PROFILE_FLAGS
+DEFINE_REMOTE_FLAGS
+DEFINE_RESULTS_FLAGS
+DEFINE_MAT_ALLOCATOR_FLAGS
+DEFINE_HALF_PRECISION_OUTPUTS_FLAGS
+DEFINE_DEVICE_PEAKS_FLAGS
 
 static const char help_message[] = "Print a usage message.";
 static const char at_message[] =
@@ -85,6 +107,8 @@ static const char num_threads_message[] = "Optional. Number of threads.";
 static const char num_streams_message[] = "Optional. Number of streams to use for inference on the CPU or/and GPU in "
                                           "throughput mode (for HETERO and MULTI device cases use format "
                                           "<device1>:<nstreams1>,<device2>:<nstreams2> or just <nstreams>)";
+static const char cache_dir_message[] = "Optional. Directory for the model cache. Compiled model is imported from the "
+                                       "cache on next runs instead of being compiled again.";
 static const char no_show_message[] = "Optional. Don't show output.";
 static const char utilization_monitors_message[] = "Optional. List of monitors to show initially.";
 static const char iou_thresh_output_message[] =
@@ -102,6 +126,25 @@ static const char mean_values_message[] =
     "Optional. Normalize input by subtracting the mean values per channel. Example: \"255.0 255.0 255.0\"";
 static const char scale_values_message[] = "Optional. Divide input by scale values per channel. Division is applied "
                                            "after mean values subtraction. Example: \"255.0 255.0 255.0\"";
+static const char tile_size_message[] = "Optional. Detect objects on overlapping tiles of the given size in "
+                                        "(width x height) format instead of the whole downscaled frame, so small "
+                                        "objects of high resolution frames are found. Usually it's the model input "
+                                        "size. Example: 640x640.";
+static const char tile_overlap_message[] = "Optional. Number of pixels shared by neighbour tiles. Default value is 64.";
+static const char tile_global_message[] = "Optional. Also detect objects on the whole downscaled frame, so objects "
+                                          "larger than tiles are found.";
+static const char aspect_buckets_message[] = "Optional. A comma separated list of aspect ratios (width:height) of "
+                                             "model inputs. Every frame is inferred in the one closest to the frame's "
+                                             "aspect ratio at the area of the model input, so less of the input is "
+                                             "padding. The device should support dynamic shapes. Only for CenterNet "
+                                             "architecture type. Example: 16:9,4:3,1:1,9:16.";
+static const char keyframe_interval_message[] = "Optional. Run the detector at least on every N-th frame, boxes of "
+                                                "other frames are predicted from the latest detections. Default is 1, "
+                                                "the detector runs on every frame.";
+static const char keyframe_motion_message[] = "Optional. Run the detector earlier than -keyframe_interval once the "
+                                              "scene motion since the previous detection reaches this budget. Motion "
+                                              "of a frame is the mean absolute difference from the previous frame, "
+                                              "in range [0, 1]. Default is 0, the interval is fixed.";
 
 DEFINE_bool(h, false, help_message);
 DEFINE_string(at, "", at_message);
@@ -116,6 +159,7 @@ DEFINE_bool(auto_resize, false, input_resizable_message);
 DEFINE_uint32(nireq, 0, nireq_message);
 DEFINE_uint32(nthreads, 0, num_threads_message);
 DEFINE_string(nstreams, "", num_streams_message);
+DEFINE_string(cache_dir, "", cache_dir_message);
 DEFINE_bool(no_show, false, no_show_message);
 DEFINE_string(u, "", utilization_monitors_message);
 DEFINE_bool(yolo_af, true, yolo_af_message);
@@ -125,6 +169,12 @@ DEFINE_string(masks, "", masks_message);
 DEFINE_bool(reverse_input_channels, false, reverse_input_channels_message);
 DEFINE_string(mean_values, "", mean_values_message);
 DEFINE_string(scale_values, "", scale_values_message);
+DEFINE_string(tile_size, "", tile_size_message);
+DEFINE_uint32(tile_overlap, 64, tile_overlap_message);
+DEFINE_bool(tile_global, false, tile_global_message);
+DEFINE_string(aspect_buckets, "", aspect_buckets_message);
+DEFINE_uint32(keyframe_interval, 1, keyframe_interval_message);
+DEFINE_double(keyframe_motion, 0, keyframe_motion_message);
 
 /**
  * \brief This function shows a help message
@@ -140,6 +190,7 @@ static void showUsage() {
     std::cout << "    -m \"<path>\"               " << model_message << std::endl;
     std::cout << "    -o \"<path>\"               " << output_message << std::endl;
     std::cout << "    -limit \"<num>\"            " << limit_message << std::endl;
+    std::cout << "    -o_encoder \"<string>\"     " << o_encoder_message << std::endl;
     std::cout << "    -d \"<device>\"             " << target_device_message << std::endl;
     std::cout << "    -labels \"<path>\"          " << labels_message << std::endl;
     std::cout << "    -layout \"<string>\"        " << layout_message << std::endl;
@@ -147,19 +198,42 @@ static void showUsage() {
     std::cout << "    -t                        " << thresh_output_message << std::endl;
     std::cout << "    -iou_t                    " << iou_thresh_output_message << std::endl;
     std::cout << "    -auto_resize              " << input_resizable_message << std::endl;
+    std::cout << "    -inputs_memory \"<string>\" " << inputs_memory_message << std::endl;
+    std::cout << "    -preprocess_on_device     " << preprocess_on_device_message << std::endl;
     std::cout << "    -nireq \"<integer>\"        " << nireq_message << std::endl;
     std::cout << "    -nthreads \"<integer>\"     " << num_threads_message << std::endl;
     std::cout << "    -nstreams                 " << num_streams_message << std::endl;
+    std::cout << "    -cache_dir \"<path>\"       " << cache_dir_message << std::endl;
     std::cout << "    -loop                     " << loop_message << std::endl;
     std::cout << "    -no_show                  " << no_show_message << std::endl;
     std::cout << "    -output_resolution        " << output_resolution_message << std::endl;
     std::cout << "    -u                        " << utilization_monitors_message << std::endl;
+    std::cout << "    -metrics_file \"<path>\"    " << metrics_file_message << std::endl;
+    std::cout << "    -motion_gate \"<double>\"   " << motion_gate_message << std::endl;
+    std::cout << "    -motion_gate_max_skip     " << motion_gate_max_skip_message << std::endl;
+    std::cout << "    -tune \"<objective>\"       " << tune_message << std::endl;
+    std::cout << "    -tune_latency \"<double>\"  " << tune_latency_message << std::endl;
+    std::cout << "    -tune_cache \"<path>\"      " << tune_cache_message << std::endl;
+    std::cout << "    -warmup \"<integer>\"     " << warmup_message << std::endl;
+    std::cout << "    -profile_layers \"<integer>\" " << profile_layers_message << std::endl;
+    std::cout << "    -remote \"<host:port>\"   " << remote_message << std::endl;
+    std::cout << "    -results \"<host:port>\"  " << results_message << std::endl;
+    std::cout << "    -mat_pool \"<MB>\"          " << mat_pool_message << std::endl;
+    std::cout << "    -mat_pool_huge_pages      " << mat_pool_huge_pages_message << std::endl;
+    std::cout << "    -fp16_outputs             " << fp16_outputs_message << std::endl;
+    std::cout << "    -peaks_on_device          " << peaks_on_device_message << std::endl;
     std::cout << "    -yolo_af                  " << yolo_af_message << std::endl;
     std::cout << "    -anchors                  " << anchors_message << std::endl;
     std::cout << "    -masks                    " << masks_message << std::endl;
     std::cout << "    -reverse_input_channels   " << reverse_input_channels_message << std::endl;
     std::cout << "    -mean_values              " << mean_values_message << std::endl;
     std::cout << "    -scale_values             " << scale_values_message << std::endl;
+    std::cout << "    -tile_size                " << tile_size_message << std::endl;
+    std::cout << "    -tile_overlap \"<integer>\" " << tile_overlap_message << std::endl;
+    std::cout << "    -tile_global              " << tile_global_message << std::endl;
+    std::cout << "    -aspect_buckets           " << aspect_buckets_message << std::endl;
+    std::cout << "    -keyframe_interval        " << keyframe_interval_message << std::endl;
+    std::cout << "    -keyframe_motion          " << keyframe_motion_message << std::endl;
 }
 
 class ColorPalette {
@@ -257,21 +331,33 @@ bool ParseAndCheckCommandLine(int argc, char* argv[]) {
     if (!FLAGS_output_resolution.empty() && FLAGS_output_resolution.find("x") == std::string::npos) {
         throw std::logic_error("Correct format of -output_resolution parameter is \"width\"x\"height\".");
     }
+
+    if (!FLAGS_tile_size.empty() && FLAGS_tile_size.find("x") == std::string::npos) {
+        throw std::logic_error("Correct format of -tile_size parameter is \"width\"x\"height\".");
+    }
+
+    if (!FLAGS_aspect_buckets.empty() && FLAGS_at != "centernet") {
+        throw std::logic_error("-aspect_buckets is supported only for CenterNet architecture type");
+    }
     return true;
 }
 
-// Input image is stored inside metadata, as we put it there during submission stage
-cv::Mat renderDetectionData(DetectionResult& result, const ColorPalette& palette, OutputTransform& outputTransform) {
+// Input image is stored inside metadata, as we put it there during submission stage. The image is resized into
+// outputImg, which is reused by next frames, and the results are drawn over it in the output coordinates.
+cv::Mat renderDetectionData(DetectionResult& result,
+                            const ColorPalette& palette,
+                            OutputTransform& outputTransform,
+                            cv::Mat& outputImg) {
     if (!result.metaData) {
         throw std::invalid_argument("Renderer: metadata is null");
     }
 
-    auto outputImg = result.metaData->asRef<ImageMetaData>().img;
+    const cv::Mat& inputImg = result.metaData->asRef<ImageMetaData>().img;
 
-    if (outputImg.empty()) {
+    if (inputImg.empty()) {
         throw std::invalid_argument("Renderer: image provided in metadata is empty");
     }
-    outputTransform.resize(outputImg);
+    outputTransform.resize(inputImg, outputImg);
     // Visualizing result data over source image
     if (FLAGS_r) {
         slog::debug << " -------------------- Frame # " << result.frameId << "--------------------" << slog::endl;
@@ -279,8 +365,9 @@ cv::Mat renderDetectionData(DetectionResult& result, const ColorPalette& palette
     }
 
     for (auto& obj : result.objects) {
+        const std::string label = result.getLabelName(obj.labelID);
         if (FLAGS_r) {
-            slog::debug << " " << std::left << std::setw(9) << obj.label << " | " << std::setw(10) << obj.confidence
+            slog::debug << " " << std::left << std::setw(9) << label << " | " << std::setw(10) << obj.confidence
                         << " | " << std::setw(4) << int(obj.x) << " | " << std::setw(4) << int(obj.y) << " | "
                         << std::setw(4) << int(obj.x + obj.width) << " | " << std::setw(4) << int(obj.y + obj.height)
                         << slog::endl;
@@ -290,7 +377,7 @@ cv::Mat renderDetectionData(DetectionResult& result, const ColorPalette& palette
         conf << ":" << std::fixed << std::setprecision(1) << obj.confidence * 100 << '%';
         const auto& color = palette[obj.labelID];
         putHighlightedText(outputImg,
-                           obj.label + conf.str(),
+                           label + conf.str(),
                            cv::Point2f(obj.x, obj.y - 5),
                            cv::FONT_HERSHEY_COMPLEX_SMALL,
                            1,
@@ -309,6 +396,11 @@ cv::Mat renderDetectionData(DetectionResult& result, const ColorPalette& palette
     return outputImg;
 }
 
+struct RenderItem {
+    std::unique_ptr<ResultBase> result;
+    PerformanceMetrics::Metrics metrics;  ///< metrics at the moment the result was received
+};
+
 int main(int argc, char* argv[]) {
     try {
         PerformanceMetrics metrics;
@@ -318,6 +410,15 @@ int main(int argc, char* argv[]) {
             return 0;
         }
 
+        // Installed before anything allocates frames, so every frame buffer comes from the pool
+        PooledMatAllocator* matAllocator = nullptr;
+        if (FLAGS_mat_pool > 0) {
+            PooledMatAllocator::Config matAllocatorConfig;
+            matAllocatorConfig.capacity = size_t(FLAGS_mat_pool) << 20;
+            matAllocatorConfig.hugePages = FLAGS_mat_pool_huge_pages;
+            matAllocator = &PooledMatAllocator::install(matAllocatorConfig);
+        }
+
         const auto& strAnchors = split(FLAGS_anchors, ',');
         const auto& strMasks = split(FLAGS_masks, ',');
 
@@ -335,8 +436,12 @@ int main(int argc, char* argv[]) {
             }
         } catch (...) { throw std::runtime_error("Invalid masks list is provided."); }
 
+        // Results are rendered on a separate thread only if they are shown, written or printed
+        const bool needsRendering = !FLAGS_no_show || !FLAGS_o.empty() || FLAGS_r;
+
         //------------------------------- Preparing Input ------------------------------------------------------
-        auto cap = openImagesCapture(FLAGS_i, FLAGS_loop, FLAGS_nireq == 1 ? read_type::efficient : read_type::safe);
+        // Frames are read into buffers leased from framePool, so the capture doesn't need to copy them
+        auto cap = openImagesCapture(FLAGS_i, FLAGS_loop, read_type::efficient);
         cv::Mat curr_frame;
 
         //------------------------------ Running Detection routines ----------------------------------------------
@@ -345,9 +450,21 @@ int main(int argc, char* argv[]) {
             labels = DetectionModel::loadLabels(FLAGS_labels);
         ColorPalette palette(labels.size() > 0 ? labels.size() : 100);
 
-        std::unique_ptr<ModelBase> model;
+        std::unique_ptr<DetectionModel> model;
         if (FLAGS_at == "centernet") {
-            model.reset(new ModelCenterNet(FLAGS_m, static_cast<float>(FLAGS_t), labels, FLAGS_layout));
+            auto centerNet = new ModelCenterNet(FLAGS_m, static_cast<float>(FLAGS_t), labels, FLAGS_layout);
+            model.reset(centerNet);
+            if (!FLAGS_aspect_buckets.empty()) {
+                std::vector<double> aspectRatios;
+                for (const std::string& bucket : split(FLAGS_aspect_buckets, ',')) {
+                    const size_t colon = bucket.find(":");
+                    if (colon == std::string::npos) {
+                        throw std::logic_error("Correct format of -aspect_buckets items is \"width\":\"height\".");
+                    }
+                    aspectRatios.push_back(std::stod(bucket.substr(0, colon)) / std::stod(bucket.substr(colon + 1)));
+                }
+                centerNet->setAspectBuckets(aspectRatios);
+            }
         } else if (FLAGS_at == "faceboxes") {
             model.reset(new ModelFaceBoxes(FLAGS_m,
                                            static_cast<float>(FLAGS_t),
@@ -383,21 +500,58 @@ int main(int argc, char* argv[]) {
             return -1;
         }
         model->setInputsPreprocessing(FLAGS_reverse_input_channels, FLAGS_mean_values, FLAGS_scale_values);
+        model->setInputsMemory(FLAGS_inputs_memory);
+        model->setDevicePreprocessing(FLAGS_preprocess_on_device);
+        model->setHalfPrecisionOutputs(FLAGS_fp16_outputs);
+        model->setDevicePostprocessing(FLAGS_peaks_on_device);
+        model->setLabelsInterning(true);
         slog::info << ov::get_openvino_version() << slog::endl;
 
         ov::Core core;
 
-        AsyncPipeline pipeline(std::move(model),
-                               ConfigFactory::getUserConfig(FLAGS_d, FLAGS_nireq, FLAGS_nstreams, FLAGS_nthreads),
-                               core);
+        ModelConfig config =
+            ConfigFactory::getUserConfig(FLAGS_d, FLAGS_nireq, FLAGS_nstreams, FLAGS_nthreads, FLAGS_cache_dir);
+        config.tuning = ConfigFactory::getTuningConfig(FLAGS_tune, FLAGS_tune_latency, FLAGS_tune_cache);
+        config.warmupInferences = FLAGS_warmup;
+        config.profiledLayers = FLAGS_profile_layers;
+        config.remoteWorker = FLAGS_remote;
+        std::unique_ptr<AsyncPipeline> tilesPipeline;
+        if (FLAGS_tile_size.empty()) {
+            tilesPipeline.reset(new AsyncPipeline(std::move(model), config, core));
+        } else {
+            size_t x = FLAGS_tile_size.find("x");
+            const cv::Size tileSize{std::stoi(FLAGS_tile_size.substr(0, x)), std::stoi(FLAGS_tile_size.substr(x + 1))};
+            tilesPipeline.reset(new TiledDetectionPipeline(
+                std::move(model),
+                config,
+                core,
+                TilingConfig(tileSize, FLAGS_tile_overlap, FLAGS_tile_global, static_cast<float>(FLAGS_iou_t))));
+        }
+        KeyframePipeline pipeline(std::move(tilesPipeline),
+                                  KeyframeConfig(FLAGS_keyframe_interval, FLAGS_keyframe_motion));
+        AsyncPipeline& detectionPipeline = pipeline.getDetectionPipeline();
+        detectionPipeline.setMotionGate(MotionGateConfig(FLAGS_motion_gate, FLAGS_motion_gate_max_skip));
+        // A frame is held by its infer request, by its result waiting for rendering or being rendered, other frames
+        // are read into buffers of their own
+        FramePool framePool(detectionPipeline.getRequestsNum() + 4);
         Presenter presenter(FLAGS_u);
+        std::unique_ptr<MetricsSink> metricsSink;
+        if (!FLAGS_metrics_file.empty()) {
+            metricsSink.reset(new MetricsSink(FLAGS_metrics_file));
+        }
+        std::unique_ptr<ResultsPublisher> resultsPublisher;
+        if (!FLAGS_results.empty()) {
+            resultsPublisher.reset(new ResultsPublisher(FLAGS_results));
+        }
 
         bool keepRunning = true;
         int64_t frameNum = -1;
         std::unique_ptr<ResultBase> result;
         uint32_t framesProcessed = 0;
 
-        LazyVideoWriter videoWriter{FLAGS_o, cap->fps(), FLAGS_limit};
+        // Frames are encoded by a separate thread, so writing the output doesn't slow down processing
+        LazyVideoWriter videoWriter{FLAGS_o, cap->fps(), FLAGS_limit, 4};
+        videoWriter.setEncoder(LazyVideoWriter::parseEncoder(FLAGS_o_encoder));
 
         PerformanceMetrics renderMetrics;
 
@@ -405,12 +559,36 @@ int main(int argc, char* argv[]) {
         OutputTransform outputTransform = OutputTransform();
         size_t found = FLAGS_output_resolution.find("x");
 
+        std::unique_ptr<RenderThread<RenderItem>> renderThread;
+        cv::Mat outputBuffer;
+        auto render = [&](RenderItem& item) -> bool {
+            ITT_SCOPED_FRAME_TASK("render", item.result->frameId);
+            cv::Mat outFrame =
+                renderDetectionData(item.result->asRef<DetectionResult>(), palette, outputTransform, outputBuffer);
+
+            //--- Showing results and device information
+            presenter.drawGraphs(outFrame);
+            PerformanceMetrics::paintMetrics(item.metrics, outFrame, {10, 22}, cv::FONT_HERSHEY_COMPLEX, 0.65);
+
+            videoWriter.write(outFrame);
+            if (!FLAGS_no_show) {
+                cv::imshow("Detection Results", outFrame);
+                //--- Processing keyboard events
+                int key = cv::waitKey(1);
+                if (27 == key || 'q' == key || 'Q' == key) {  // Esc
+                    return false;
+                }
+                presenter.handleKey(key);
+            }
+            return true;
+        };
+
         while (keepRunning) {
             if (pipeline.isReadyToProcess()) {
                 auto startTime = std::chrono::steady_clock::now();
 
                 //--- Capturing frame
-                curr_frame = cap->read();
+                curr_frame = framePool.read(*cap);
 
                 if (curr_frame.empty()) {
                     // Input stream is over
@@ -421,7 +599,8 @@ int main(int argc, char* argv[]) {
                                                std::make_shared<ImageMetaData>(curr_frame, startTime));
             }
 
-            if (frameNum == 0) {
+            // The transform is set once before the render thread, which uses it, is started
+            if (frameNum == 0 && needsRendering && !renderThread) {
                 if (found == std::string::npos) {
                     outputResolution = curr_frame.size();
                 } else {
@@ -431,6 +610,8 @@ int main(int argc, char* argv[]) {
                     outputTransform = OutputTransform(curr_frame.size(), outputResolution);
                     outputResolution = outputTransform.computeResolution();
                 }
+                // Only the latest results are shown, unless every frame is written or printed
+                renderThread.reset(new RenderThread<RenderItem>(render, 2, FLAGS_o.empty() && !FLAGS_r));
             }
 
             //--- Waiting for free input slot or output data available. Function will return immediately if any of them
@@ -441,31 +622,35 @@ int main(int argc, char* argv[]) {
             //--- If you need just plain data without rendering - cast result's underlying pointer to DetectionResult*
             //    and use your own processing instead of calling renderDetectionData().
             while (keepRunning && (result = pipeline.getResult())) {
-                auto renderingStart = std::chrono::steady_clock::now();
-                cv::Mat outFrame = renderDetectionData(result->asRef<DetectionResult>(), palette, outputTransform);
-
-                //--- Showing results and device information
-                presenter.drawGraphs(outFrame);
-                renderMetrics.update(renderingStart);
-                metrics.update(result->metaData->asRef<ImageMetaData>().timeStamp,
-                               outFrame,
-                               {10, 22},
-                               cv::FONT_HERSHEY_COMPLEX,
-                               0.65);
-
-                videoWriter.write(outFrame);
+                metrics.update(result->metaData->asRef<ImageMetaData>().timeStamp);
                 framesProcessed++;
+                if (resultsPublisher) {
+                    resultsPublisher->publish(*result);
+                }
+                if (renderThread) {
+                    keepRunning = renderThread->push(RenderItem{std::move(result), metrics.getLast()});
+                }
+            }
 
-                if (!FLAGS_no_show) {
-                    cv::imshow("Detection Results", outFrame);
-                    //--- Processing keyboard events
-                    int key = cv::waitKey(1);
-                    if (27 == key || 'q' == key || 'Q' == key) {  // Esc
-                        keepRunning = false;
-                    } else {
-                        presenter.handleKey(key);
-                    }
+            if (metricsSink && metricsSink->isDue()) {
+                if (renderThread) {
+                    renderMetrics = renderThread->getMetrics();
                 }
+                metricsSink->stage("decoding", cap->getMetrics().getLast());
+                detectionPipeline.reportMetrics(*metricsSink);
+                const std::pair<double, double> memSwapUsage = presenter.getLastMemSwapUsage();
+                const std::pair<double, double> gpuUsage = presenter.getLastGpuUsage();
+                const double power = presenter.getLastPower();
+                metricsSink->stage("rendering", renderMetrics.getLast())
+                    .stage("total", metrics.getLast())
+                    .value("cpu_load", presenter.getLastCpuLoad())
+                    .value("memory_gib", memSwapUsage.first)
+                    .value("swap_gib", memSwapUsage.second)
+                    .value("power_w", power)
+                    .value("fps_per_watt", metrics.getLast().fps / power)
+                    .value("gpu_utilization", gpuUsage.first)
+                    .value("gpu_frequency_mhz", gpuUsage.second);
+                metricsSink->publish();
             }
         }  // while(keepRunning)
 
@@ -475,33 +660,50 @@ int main(int argc, char* argv[]) {
         for (; framesProcessed <= frameNum; framesProcessed++) {
             result = pipeline.getResult();
             if (result != nullptr) {
-                auto renderingStart = std::chrono::steady_clock::now();
-                cv::Mat outFrame = renderDetectionData(result->asRef<DetectionResult>(), palette, outputTransform);
-                //--- Showing results and device information
-                presenter.drawGraphs(outFrame);
-                renderMetrics.update(renderingStart);
-                metrics.update(result->metaData->asRef<ImageMetaData>().timeStamp,
-                               outFrame,
-                               {10, 22},
-                               cv::FONT_HERSHEY_COMPLEX,
-                               0.65);
-                videoWriter.write(outFrame);
-                if (!FLAGS_no_show) {
-                    cv::imshow("Detection Results", outFrame);
-                    //--- Updating output window
-                    cv::waitKey(1);
+                metrics.update(result->metaData->asRef<ImageMetaData>().timeStamp);
+                if (resultsPublisher) {
+                    resultsPublisher->publish(*result);
                 }
+                if (renderThread) {
+                    renderThread->push(RenderItem{std::move(result), metrics.getLast()});
+                }
+            }
+        }
+        if (renderThread) {
+            renderThread->finish();
+            renderMetrics = renderThread->getMetrics();
+            if (renderThread->getDroppedNum() > 0) {
+                slog::info << "\t" << renderThread->getDroppedNum()
+                           << " results weren't shown to keep up with inference" << slog::endl;
             }
         }
 
+        if (FLAGS_keyframe_interval > 1) {
+            slog::info << "\t" << pipeline.getPropagatedNum() << " of " << framesProcessed
+                       << " results were propagated from keyframes" << slog::endl;
+        }
+        const int skippedFrames = detectionPipeline.getPreprocessMetrics().getTotal().skippedFrames;
+        if (skippedFrames > 0) {
+            slog::info << "\t" << skippedFrames << " frames weren't inferred, results of previous frames were reused"
+                       << slog::endl;
+        }
         slog::info << "Metrics report:" << slog::endl;
         metrics.logTotal();
-        logLatencyPerStage(cap->getMetrics().getTotal().latency,
-                           pipeline.getPreprocessMetrics().getTotal().latency,
-                           pipeline.getInferenceMetircs().getTotal().latency,
-                           pipeline.getPostprocessMetrics().getTotal().latency,
-                           renderMetrics.getTotal().latency);
+        logLatencyPerStage(cap->getMetrics().getTotal(),
+                           detectionPipeline.getPreprocessMetrics().getTotal(),
+                           detectionPipeline.getInferenceMetircs().getTotal(),
+                           detectionPipeline.getPostprocessMetrics().getTotal(),
+                           renderMetrics.getTotal());
+        detectionPipeline.logLayersProfile();
         slog::info << presenter.reportMeans() << slog::endl;
+        const double meanPower = presenter.getMeanPower();
+        if (!std::isnan(meanPower)) {
+            slog::info << "\tFPS/W: " << metrics.getTotal().fps / meanPower << slog::endl;
+        }
+        if (matAllocator) {
+            matAllocator->logStats();
+        }
+        logMemoryUsage();
     } catch (const std::exception& error) {
         slog::err << error.what() << slog::endl;
         return 1;
@@ -0,0 +1,310 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Replays recorded or synthetic detections into PedestrianTracker without running the detector, so the cost of
+// tracking alone is measured
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <new>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include "core.hpp"
+#include "descriptor.hpp"
+#include "distance.hpp"
+#include "tracker.hpp"
+
+namespace {
+std::atomic<size_t> allocationsNum{0};
+}  // namespace
+
+void* operator new(size_t size) {
+    ++allocationsNum;
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+static const char help_message[] = "Print a usage message.";
+static const char detections_message[] = "Optional. Path to recorded detections in the MOTChallenge det.txt format: "
+                                         "<frame>,<id>,<x>,<y>,<w>,<h>,<confidence>[,...]. "
+                                         "Synthetic crowds are generated if it isn't set.";
+static const char objects_message[] = "Optional. Comma-separated numbers of objects in synthetic crowds, "
+                                      "a scaling curve is measured over them.";
+static const char frames_message[] = "Optional. Number of frames of a synthetic crowd.";
+static const char frame_size_message[] = "Optional. Frame size <width>x<height>.";
+static const char fps_message[] = "Optional. Frame rate the timestamps of the frames are computed with.";
+static const char seed_message[] = "Optional. Seed of the synthetic crowds generator.";
+
+DEFINE_bool(h, false, help_message);
+DEFINE_string(i, "", detections_message);
+DEFINE_string(objects, "10,50,100,200,500", objects_message);
+DEFINE_uint32(frames, 500, frames_message);
+DEFINE_string(frame_size, "1920x1080", frame_size_message);
+DEFINE_double(fps, 30.0, fps_message);
+DEFINE_uint32(seed, 0, seed_message);
+
+static void showUsage() {
+    std::cout << std::endl;
+    std::cout << "pedestrian_tracker_benchmark [OPTION]" << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << std::endl;
+    std::cout << "    -h                             " << help_message << std::endl;
+    std::cout << "    -i \"<path>\"                    " << detections_message << std::endl;
+    std::cout << "    -objects \"<list>\"              " << objects_message << std::endl;
+    std::cout << "    -frames                        " << frames_message << std::endl;
+    std::cout << "    -frame_size                    " << frame_size_message << std::endl;
+    std::cout << "    -fps                           " << fps_message << std::endl;
+    std::cout << "    -seed                          " << seed_message << std::endl;
+}
+
+namespace {
+using Sequence = std::vector<TrackedObjects>;
+
+Sequence readDetections(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Can't open " + path);
+    }
+    std::map<int64_t, TrackedObjects> frames;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream fields(line);
+        int64_t frame;
+        int id;
+        float x, y, w, h, confidence = 1.0f;
+        if (!(fields >> frame >> id >> x >> y >> w >> h)) {
+            throw std::runtime_error("Can't parse the line of " + path + ": " + line);
+        }
+        fields >> confidence;
+        TrackedObject object(cv::Rect(cvRound(x), cvRound(y), cvRound(w), cvRound(h)), confidence, frame, -1);
+        frames[frame].push_back(object);
+    }
+    if (frames.empty()) {
+        return {};
+    }
+    // Frames without detections are replayed too
+    Sequence sequence(static_cast<size_t>(frames.rbegin()->first - frames.begin()->first + 1));
+    for (auto& frame : frames) {
+        sequence[static_cast<size_t>(frame.first - frames.begin()->first)] = std::move(frame.second);
+    }
+    return sequence;
+}
+
+// Pedestrians walking with constant velocities and bouncing off the frame borders. Detections are jittered and
+// 5% of them are missed.
+Sequence generateCrowd(size_t objectsNum, size_t framesNum, const cv::Size& frameSize, std::mt19937& rng) {
+    std::uniform_real_distribution<float> height(0.1f * frameSize.height, 0.3f * frameSize.height);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::normal_distribution<float> jitter(0.0f, 1.0f);
+    std::normal_distribution<float> speed(0.0f, 2.0f);
+
+    struct Pedestrian {
+        cv::Point2f position;
+        cv::Point2f velocity;
+        cv::Size2f size;
+    };
+    std::vector<Pedestrian> crowd(objectsNum);
+    for (auto& pedestrian : crowd) {
+        const float h = height(rng);
+        pedestrian.size = cv::Size2f(0.4f * h, h);
+        pedestrian.position = cv::Point2f(unit(rng) * (frameSize.width - pedestrian.size.width),
+                                          unit(rng) * (frameSize.height - pedestrian.size.height));
+        pedestrian.velocity = cv::Point2f(speed(rng), speed(rng) * 0.25f);
+    }
+
+    const cv::Rect frameRect(cv::Point(), frameSize);
+    Sequence sequence(framesNum);
+    for (size_t frame = 0; frame < framesNum; frame++) {
+        for (auto& pedestrian : crowd) {
+            pedestrian.position += pedestrian.velocity;
+            if (pedestrian.position.x < 0 || pedestrian.position.x + pedestrian.size.width > frameSize.width) {
+                pedestrian.velocity.x = -pedestrian.velocity.x;
+            }
+            if (pedestrian.position.y < 0 || pedestrian.position.y + pedestrian.size.height > frameSize.height) {
+                pedestrian.velocity.y = -pedestrian.velocity.y;
+            }
+            if (unit(rng) < 0.05f) {
+                continue;
+            }
+            const float noise = 0.01f * pedestrian.size.height;
+            const cv::Rect rect(cvRound(pedestrian.position.x + noise * jitter(rng)),
+                                cvRound(pedestrian.position.y + noise * jitter(rng)),
+                                cvRound(pedestrian.size.width + noise * jitter(rng)),
+                                cvRound(pedestrian.size.height + noise * jitter(rng)));
+            const cv::Rect clipped = rect & frameRect;
+            if (clipped.area() > 0) {
+                sequence[frame].emplace_back(clipped, 0.5f + 0.5f * unit(rng), static_cast<int64_t>(frame), -1);
+            }
+        }
+    }
+    return sequence;
+}
+
+// The fast descriptors are resized crops, so every detection is drawn with its own color over a noisy background
+cv::Mat drawFrame(const cv::Mat& background, const TrackedObjects& detections) {
+    cv::Mat frame = background.clone();
+    for (const auto& detection : detections) {
+        const cv::Rect& rect = detection.rect;
+        const cv::Scalar color((rect.height * 37) % 256, (rect.width * 91) % 256, (rect.height * 53) % 256);
+        cv::rectangle(frame, rect, color, cv::FILLED);
+    }
+    return frame;
+}
+
+std::unique_ptr<PedestrianTracker> createTracker() {
+    std::unique_ptr<PedestrianTracker> tracker(new PedestrianTracker(TrackerParams()));
+    tracker->set_descriptor_fast(
+        std::make_shared<ResizedImageDescriptor>(cv::Size(16, 32), cv::InterpolationFlags::INTER_LINEAR));
+    tracker->set_distance_fast(std::make_shared<MatchTemplateDistance>());
+    return tracker;
+}
+
+size_t peakMemoryKb() {
+#if defined(__linux__)
+    rusage usage;
+    if (0 == getrusage(RUSAGE_SELF, &usage)) {
+        return static_cast<size_t>(usage.ru_maxrss);
+    }
+#endif
+    return 0;
+}
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    const size_t idx = std::min(values.size() - 1, static_cast<size_t>(p / 100.0 * values.size()));
+    std::nth_element(values.begin(), values.begin() + idx, values.end());
+    return values[idx];
+}
+
+void replay(const std::string& name, const Sequence& sequence, const cv::Size& frameSize) {
+    cv::Mat background(frameSize, CV_8UC3);
+    cv::randu(background, cv::Scalar::all(0), cv::Scalar::all(255));
+    std::unique_ptr<PedestrianTracker> tracker = createTracker();
+
+    std::vector<double> latencies;
+    latencies.reserve(sequence.size());
+    size_t detectionsNum = 0, tracksNum = 0, allocations = 0;
+    for (size_t frameIdx = 0; frameIdx < sequence.size(); frameIdx++) {
+        TrackedObjects detections = sequence[frameIdx];
+        for (auto& detection : detections) {
+            detection.frame_idx = static_cast<int64_t>(frameIdx);
+        }
+        const cv::Mat frame = drawFrame(background, detections);
+        const uint64_t timestamp = static_cast<uint64_t>(1000.0 / FLAGS_fps * frameIdx);
+
+        const size_t allocationsBefore = allocationsNum;
+        const auto start = std::chrono::steady_clock::now();
+        tracker->Process(frame, detections, timestamp);
+        const auto end = std::chrono::steady_clock::now();
+        allocations += allocationsNum - allocationsBefore;
+
+        latencies.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        detectionsNum += detections.size();
+        tracksNum += tracker->TrackedDetections().size();
+    }
+
+    const double framesNum = static_cast<double>(std::max<size_t>(sequence.size(), 1));
+    std::cout << std::left << std::setw(12) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(8) << sequence.size()
+              << std::setw(10) << detectionsNum / framesNum
+              << std::setw(10) << tracksNum / framesNum
+              << std::setw(10) << percentile(latencies, 50)
+              << std::setw(10) << percentile(latencies, 90)
+              << std::setw(10) << percentile(latencies, 99)
+              << std::setw(10) << *std::max_element(latencies.begin(), latencies.end())
+              << std::setw(12) << allocations / framesNum
+              << std::setw(12) << peakMemoryKb() << std::endl;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        gflags::ParseCommandLineNonHelpFlags(&argc, &argv, true);
+        if (FLAGS_h) {
+            showUsage();
+            return 0;
+        }
+
+        cv::Size frameSize;
+        char separator = 0;
+        std::istringstream sizeStream(FLAGS_frame_size);
+        if (!(sizeStream >> frameSize.width >> separator >> frameSize.height) || separator != 'x'
+            || frameSize.area() <= 0) {
+            throw std::logic_error("Parameter -frame_size must be <width>x<height>");
+        }
+        if (FLAGS_fps <= 0) {
+            throw std::logic_error("Parameter -fps must be positive");
+        }
+
+        std::mt19937 rng(FLAGS_seed);
+        std::cout << std::left << std::setw(12) << "sequence" << std::right
+                  << std::setw(8) << "frames"
+                  << std::setw(10) << "dets"
+                  << std::setw(10) << "tracks"
+                  << std::setw(10) << "p50 ms"
+                  << std::setw(10) << "p90 ms"
+                  << std::setw(10) << "p99 ms"
+                  << std::setw(10) << "max ms"
+                  << std::setw(12) << "allocs"
+                  << std::setw(12) << "peak KB" << std::endl;
+
+        if (!FLAGS_i.empty()) {
+            const Sequence sequence = readDetections(FLAGS_i);
+            if (sequence.empty()) {
+                throw std::runtime_error("No detections in " + FLAGS_i);
+            }
+            replay("recorded", sequence, frameSize);
+            return 0;
+        }
+
+        std::istringstream objectsStream(FLAGS_objects);
+        std::string objects;
+        while (std::getline(objectsStream, objects, ',')) {
+            const size_t objectsNum = static_cast<size_t>(std::stoul(objects));
+            replay(objects + " objects", generateCrowd(objectsNum, FLAGS_frames, frameSize, rng), frameSize);
+        }
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
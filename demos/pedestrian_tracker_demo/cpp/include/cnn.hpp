@@ -7,12 +7,15 @@
 #include <stddef.h>
 
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include <opencv2/core.hpp>
 #include <openvino/openvino.hpp>
 
+#include <utils/batch_infer_engine.hpp>
+
 /**
  * @brief Base class of config for model
  */
@@ -23,6 +26,8 @@ struct ModelConfigTracker {
     std::string path_to_model;
     /** @brief Maximal size of batch */
     int max_batch_size{1};
+    /** @brief Number of infer requests, up to this number of batches are in flight */
+    int max_num_requests{1};
 };
 
 /**
@@ -51,7 +56,7 @@ public:
 
 protected:
     /**
-     * @brief Run model in batch mode
+     * @brief Run model in batch mode. A batch is filled while the previous ones are inferred
      *
      * @param frames Vector of input images
      * @param results_fetcher Callback to fetch inference results
@@ -69,14 +74,10 @@ protected:
     ov::Layout input_layout;
     /** @brief Compiled model */
     ov::CompiledModel compiled_model;
-    /** @brief Inference Request */
-    mutable ov::InferRequest infer_request;
-    /** @brief Input tensor */
-    mutable ov::Tensor input_tensor;
+    /** @brief Inference requests the batches are spread over */
+    mutable std::unique_ptr<BatchInferEngine> infer_engine;
     /** @brief Input tensor shape */
     ov::Shape input_shape;
-    /** @brief Output tensor */
-    ov::Tensor output_tensor;
     /** @brief Input tensor shape */
     ov::Shape output_shape;
 };
@@ -31,6 +31,14 @@ public:
     ///
     virtual std::vector<float> Compute(const std::vector<cv::Mat>& descrs1, const std::vector<cv::Mat>& descrs2) = 0;
 
+    ///
+    /// \brief Computes distances between all pairs of descriptors.
+    /// \param[in] descrs1 First descriptors.
+    /// \param[in] descrs2 Second descriptors.
+    /// \return descrs1.size() x descrs2.size() CV_32F matrix of distances.
+    ///
+    virtual cv::Mat ComputeMatrix(const std::vector<cv::Mat>& descrs1, const std::vector<cv::Mat>& descrs2);
+
     virtual ~IDescriptorDistance() {}
 };
 
@@ -62,6 +70,14 @@ public:
     ///
     std::vector<float> Compute(const std::vector<cv::Mat>& descrs1, const std::vector<cv::Mat>& descrs2) override;
 
+    ///
+    /// \brief Computes distances between all pairs of descriptors by one matrix product.
+    /// \param[in] descrs1 First descriptors.
+    /// \param[in] descrs2 Second descriptors.
+    /// \return descrs1.size() x descrs2.size() CV_32F matrix of distances.
+    ///
+    cv::Mat ComputeMatrix(const std::vector<cv::Mat>& descrs1, const std::vector<cv::Mat>& descrs2) override;
+
 private:
     cv::Size descriptor_size_;
 };
@@ -102,6 +118,15 @@ public:
     /// \return Distances between descriptors.
     ///
     std::vector<float> Compute(const std::vector<cv::Mat>& descrs1, const std::vector<cv::Mat>& descrs2) override;
+    ///
+    /// \brief Computes distances between all pairs of descriptors. The normed
+    ///        cross-correlation of equally sized images is their cosine
+    ///        similarity, so it is computed by one matrix product.
+    /// \param[in] descrs1 First image descriptors.
+    /// \param[in] descrs2 Second image descriptors.
+    /// \return descrs1.size() x descrs2.size() CV_32F matrix of distances.
+    ///
+    cv::Mat ComputeMatrix(const std::vector<cv::Mat>& descrs1, const std::vector<cv::Mat>& descrs2) override;
     virtual ~MatchTemplateDistance() {}
 
 private:
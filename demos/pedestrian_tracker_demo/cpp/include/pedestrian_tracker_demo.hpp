@@ -15,6 +15,7 @@
 
 DEFINE_INPUT_FLAGS
 DEFINE_OUTPUT_FLAGS
+DEFINE_RESULTS_FLAGS
 
 static const char help_message[] = "Print a usage message.";
 static const char first_frame_message[] = "Optional. The index of the first frame of the input to process. "
@@ -122,4 +123,5 @@ static void showUsage() {
     std::cout << "    -nstreams                   " << num_streams_message << std::endl;
     std::cout << "    -nthreads \"<integer>\"     " << num_threads_message << std::endl;
     std::cout << "    -person_label               " << person_label_message << std::endl;
+    std::cout << "    -results \"<host:port>\"      " << results_message << std::endl;
 }
@@ -17,6 +17,8 @@
 
 #include <opencv2/core.hpp>
 
+#include <utils/memory_accounting.hpp>
+
 #include "core.hpp"
 #include "logging.hpp"
 #include "utils.hpp"
@@ -385,11 +387,6 @@ private:
     std::vector<std::pair<size_t, size_t>> GetTrackToDetectionIds(
         const std::set<std::tuple<size_t, size_t, float>>& matches);
 
-    float AffinityFast(const cv::Mat& descriptor1,
-                       const TrackedObject& obj1,
-                       const cv::Mat& descriptor2,
-                       const TrackedObject& obj2);
-
     float Affinity(const TrackedObject& obj1, const TrackedObject& obj2);
 
     void AddNewTrack(const cv::Mat& frame,
@@ -425,6 +422,9 @@ private:
     TrackedObjects FilterDetections(const TrackedObjects& detections) const;
     bool IsTrackForgotten(const Track& track) const;
 
+    // Estimates memory of the tracks and updates the memory counter with it.
+    void UpdateMemoryUsage();
+
     // Parameters of the pipeline.
     TrackerParams params_;
 
@@ -467,4 +467,7 @@ private:
     std::vector<cv::Scalar> colors_;
 
     uint64_t prev_timestamp_;
+
+    // Memory of the tracks, objects and images of which are kept until the tracks are forgotten.
+    MemoryCounter tracks_memory_{"PedestrianTracker.tracks"};
 };
@@ -27,16 +27,20 @@
 #include <models/detection_model_ssd.h>
 #include <models/detection_model_yolo.h>
 #include <models/input_data.h>
-#include <models/internal_model_data.h>
 #include <models/model_base.h>
 #include <models/results.h>
 #include <monitors/presenter.h>
+#include <pipelines/async_pipeline.h>
 #include <pipelines/metadata.h>
+#include <pipelines/results_publisher.h>
 #include <utils/common.hpp>
 #include <utils/config_factory.h>
+#include <utils/frame_pool.hpp>
 #include <utils/images_capture.h>
+#include <utils/memory_accounting.hpp>
 #include <utils/ocv_common.hpp>
 #include <utils/performance_metrics.hpp>
+#include <utils/render_thread.hpp>
 #include <utils/slog.hpp>
 
 #include "cnn.hpp"
@@ -47,8 +51,6 @@
 #include "tracker.hpp"
 #include "utils.hpp"
 
-using ImageWithFrameIndex = std::pair<cv::Mat, int>;
-
 std::unique_ptr<PedestrianTracker> CreatePedestrianTracker(const std::string& reid_model,
                                                            const ov::Core& core,
                                                            const std::string& deviceName,
@@ -73,6 +75,7 @@ std::unique_ptr<PedestrianTracker> CreatePedestrianTracker(const std::string& re
     if (!reid_model.empty()) {
         ModelConfigTracker reid_config(reid_model);
         reid_config.max_batch_size = 16;  // defaulting to 16
+        reid_config.max_num_requests = 2;  // the next batch is filled while the previous one is inferred
         std::shared_ptr<IImageDescriptor> descriptor_strong =
             std::make_shared<Descriptor>(reid_config, core, deviceName);
 
@@ -92,6 +95,39 @@ std::unique_ptr<PedestrianTracker> CreatePedestrianTracker(const std::string& re
     return tracker;
 }
 
+TrackedObjects ToTrackedObjects(const DetectionResult& result, const cv::Size& frameSize) {
+    TrackedObjects detections;
+
+    for (size_t i = 0; i < result.objects.size(); i++) {
+        TrackedObject object;
+        object.confidence = result.objects[i].confidence;
+
+        const float frame_width_ = static_cast<float>(frameSize.width);
+        const float frame_height_ = static_cast<float>(frameSize.height);
+        object.frame_idx = static_cast<int>(result.frameId);
+
+        const float x0 = std::min(std::max(0.0f, result.objects[i].x / frame_width_), 1.0f) * frame_width_;
+        const float y0 = std::min(std::max(0.0f, result.objects[i].y / frame_height_), 1.0f) * frame_height_;
+        const float x1 =
+            std::min(std::max(0.0f, (result.objects[i].x + result.objects[i].width) / frame_width_), 1.0f) *
+            frame_width_;
+        const float y1 =
+            std::min(std::max(0.0f, (result.objects[i].y + result.objects[i].height) / frame_height_), 1.0f) *
+            frame_height_;
+
+        object.rect = cv::Rect2f(cv::Point(static_cast<int>(round(static_cast<double>(x0))),
+                                           static_cast<int>(round(static_cast<double>(y0)))),
+                                 cv::Point(static_cast<int>(round(static_cast<double>(x1))),
+                                           static_cast<int>(round(static_cast<double>(y1)))));
+
+        if (object.rect.area() > 0 &&
+            (static_cast<int>(result.objects[i].labelID) == FLAGS_person_label || FLAGS_person_label == -1)) {
+            detections.emplace_back(object);
+        }
+    }
+    return detections;
+}
+
 bool ParseAndCheckCommandLine(int argc, char* argv[]) {
     // ---------------------------Parsing and validation of input args--------------------------------------
 
@@ -178,106 +214,73 @@ int main(int argc, char** argv) {
         slog::info << ov::get_openvino_version() << slog::endl;
         ov::Core core;
 
-        auto model = detectionModel->compileModel(
-            ConfigFactory::getUserConfig(FLAGS_d_det, FLAGS_nireq, FLAGS_nstreams, FLAGS_nthreads),
-            core);
-        auto req = model.create_infer_request();
+        AsyncPipeline pipeline(std::move(detectionModel),
+                               ConfigFactory::getUserConfig(FLAGS_d_det, FLAGS_nireq, FLAGS_nstreams, FLAGS_nthreads),
+                               core);
         bool should_keep_tracking_info = should_save_det_log || should_print_out;
         std::unique_ptr<PedestrianTracker> tracker =
             CreatePedestrianTracker(reid_model, core, reid_mode, should_keep_tracking_info);
 
         std::unique_ptr<ImagesCapture> cap =
-            openImagesCapture(FLAGS_i,
-                              FLAGS_loop,
-                              FLAGS_nireq == 1 ? read_type::efficient : read_type::safe,
-                              FLAGS_first,
-                              FLAGS_read_limit);
+            openImagesCapture(FLAGS_i, FLAGS_loop, read_type::efficient, FLAGS_first, FLAGS_read_limit);
         double video_fps = cap->fps();
         if (0.0 == video_fps) {
             // the default frame rate for DukeMTMC dataset
             video_fps = 60.0;
         }
 
+        // A frame is held by its infer request, by its result waiting for tracking or being tracked, other frames are
+        // read into buffers of their own
+        FramePool framePool(pipeline.getRequestsNum() + 4);
         auto startTime = std::chrono::steady_clock::now();
-        cv::Mat frame = cap->read();
+        cv::Mat frame = framePool.read(*cap);
         cv::Size firstFrameSize = frame.size();
 
         LazyVideoWriter videoWriter{FLAGS_o, cap->fps(), FLAGS_limit};
         cv::Size graphSize{static_cast<int>(frame.cols / 4), 60};
         Presenter presenter(FLAGS_u, 10, graphSize);
+        std::unique_ptr<ResultsPublisher> resultsPublisher;
+        if (!FLAGS_results.empty()) {
+            resultsPublisher.reset(new ResultsPublisher(FLAGS_results));
+        }
+        // Tracked objects don't keep their classes, so they are published with the class of -person_label
+        const unsigned int trackedLabel = static_cast<unsigned int>(std::max(FLAGS_person_label, 0));
+        std::vector<TrackedBox> trackedBoxes;
 
-        for (unsigned frameIdx = 0;; ++frameIdx) {
-            detectionModel->preprocess(ImageInputData(frame), req);
-
-            req.infer();
-
-            InferenceResult res;
-
-            res.internalModelData = std::make_shared<InternalImageModelData>(frame.cols, frame.rows);
-
-            res.metaData = std::make_shared<ImageMetaData>(frame, std::chrono::steady_clock::now());
-
-            for (const auto& outName : detectionModel->getOutputsNames()) {
-                const auto& outTensor = req.get_tensor(outName);
-
-                if (ov::element::i32 == outTensor.get_element_type()) {
-                    res.outputsData.emplace(outName, outTensor);
-                } else {
-                    res.outputsData.emplace(outName, outTensor);
-                }
-            }
-
-            auto result = (detectionModel->postprocess(res))->asRef<DetectionResult>();
-
-            TrackedObjects detections;
-
-            for (size_t i = 0; i < result.objects.size(); i++) {
-                TrackedObject object;
-                object.confidence = result.objects[i].confidence;
-
-                const float frame_width_ = static_cast<float>(frame.cols);
-                const float frame_height_ = static_cast<float>(frame.rows);
-                object.frame_idx = result.frameId;
-
-                const float x0 = std::min(std::max(0.0f, result.objects[i].x / frame_width_), 1.0f) * frame_width_;
-                const float y0 = std::min(std::max(0.0f, result.objects[i].y / frame_height_), 1.0f) * frame_height_;
-                const float x1 =
-                    std::min(std::max(0.0f, (result.objects[i].x + result.objects[i].width) / frame_width_), 1.0f) *
-                    frame_width_;
-                const float y1 =
-                    std::min(std::max(0.0f, (result.objects[i].y + result.objects[i].height) / frame_height_), 1.0f) *
-                    frame_height_;
-
-                object.rect = cv::Rect2f(cv::Point(static_cast<int>(round(static_cast<double>(x0))),
-                                                   static_cast<int>(round(static_cast<double>(y0)))),
-                                         cv::Point(static_cast<int>(round(static_cast<double>(x1))),
-                                                   static_cast<int>(round(static_cast<double>(y1)))));
+        // Tracking, reidentification and drawing of a frame run on the tracker thread, while next frames are detected
+        auto track = [&](std::unique_ptr<ResultBase>& item) -> bool {
+            cv::Mat image = item->metaData->asRef<ImageMetaData>().img;
+            TrackedObjects detections = ToTrackedObjects(item->asRef<DetectionResult>(), image.size());
 
-                if (object.rect.area() > 0 &&
-                    (static_cast<int>(result.objects[i].labelID) == FLAGS_person_label || FLAGS_person_label == -1)) {
-                    detections.emplace_back(object);
+            // timestamp in milliseconds
+            uint64_t cur_timestamp = static_cast<uint64_t>(1000.0 / video_fps * item->frameId);
+            tracker->Process(image, detections, cur_timestamp);
+            if (resultsPublisher) {
+                trackedBoxes.clear();
+                for (const auto& detection : tracker->TrackedDetections()) {
+                    trackedBoxes.push_back(TrackedBox{detection.object_id,
+                                                      cv::Rect2f(detection.rect),
+                                                      trackedLabel,
+                                                      static_cast<float>(detection.confidence)});
                 }
+                resultsPublisher->publishTracks(item->frameId, trackedBoxes);
             }
 
-            // timestamp in milliseconds
-            uint64_t cur_timestamp = static_cast<uint64_t>(1000.0 / video_fps * frameIdx);
-            tracker->Process(frame, detections, cur_timestamp);
-
             // Drawing colored "worms" (tracks).
-            frame = tracker->DrawActiveTracks(frame);
+            image = tracker->DrawActiveTracks(image);
 
             // Drawing all detected objects on a frame by BLUE COLOR
             for (const auto& detection : detections) {
-                cv::rectangle(frame, detection.rect, cv::Scalar(255, 0, 0), 3);
+                cv::rectangle(image, detection.rect, cv::Scalar(255, 0, 0), 3);
             }
 
             // Drawing tracked detections only by RED color and print ID and detection
             // confidence level.
             for (const auto& detection : tracker->TrackedDetections()) {
-                cv::rectangle(frame, detection.rect, cv::Scalar(0, 0, 255), 3);
+                cv::rectangle(image, detection.rect, cv::Scalar(0, 0, 255), 3);
                 std::string text =
                     std::to_string(detection.object_id) + " conf: " + std::to_string(detection.confidence);
-                putHighlightedText(frame,
+                putHighlightedText(image,
                                    text,
                                    detection.rect.tl() - cv::Point{10, 10},
                                    cv::FONT_HERSHEY_COMPLEX,
@@ -285,29 +288,72 @@ int main(int argc, char** argv) {
                                    cv::Scalar(0, 0, 255),
                                    2);
             }
-            presenter.drawGraphs(frame);
-            metrics.update(startTime, frame, {10, 22}, cv::FONT_HERSHEY_COMPLEX, 0.65);
-
-            videoWriter.write(frame);
+            presenter.drawGraphs(image);
+            metrics.update(item->metaData->asRef<ImageMetaData>().timeStamp,
+                           image,
+                           {10, 22},
+                           cv::FONT_HERSHEY_COMPLEX,
+                           0.65);
+
+            videoWriter.write(image);
             if (should_show) {
-                cv::imshow("dbg", frame);
+                cv::imshow("dbg", image);
                 char k = cv::waitKey(delay);
                 if (k == 27)
-                    break;
+                    return false;
                 presenter.handleKey(k);
             }
 
-            if (should_save_det_log && (frameIdx % 100 == 0)) {
+            if (should_save_det_log && (item->frameId % 100 == 0)) {
                 DetectionLog log = tracker->GetDetectionLog(true);
                 SaveDetectionLogToTrajFile(detlog_out, log);
             }
-            startTime = std::chrono::steady_clock::now();
-            frame = cap->read();
-            if (!frame.data)
-                break;
-            if (frame.size() != firstFrameSize)
-                throw std::runtime_error("Can't track objects on images of different size");
+            return true;
+        };
+        // The tracker needs every frame, so the detection waits for it instead of dropping results
+        RenderThread<std::unique_ptr<ResultBase>> trackerThread(track, 2, false);
+
+        bool keepRunning = true;
+        int64_t frameNum = -1;
+        int64_t framesTracked = 0;
+        std::unique_ptr<ResultBase> result;
+        while (keepRunning) {
+            if (pipeline.isReadyToProcess()) {
+                if (frame.empty()) {
+                    startTime = std::chrono::steady_clock::now();
+                    frame = framePool.read(*cap);
+                    if (frame.empty()) {
+                        // Input stream is over
+                        break;
+                    }
+                    if (frame.size() != firstFrameSize)
+                        throw std::runtime_error("Can't track objects on images of different size");
+                }
+                const int64_t frameId =
+                    pipeline.submitData(ImageInputData(frame), std::make_shared<ImageMetaData>(frame, startTime));
+                if (frameId >= 0) {
+                    frameNum = frameId;
+                    frame.release();
+                }
+            }
+
+            pipeline.waitForData();
+
+            // Results come in the order of frames, as the tracker expects
+            while (keepRunning && (result = pipeline.getResult())) {
+                ++framesTracked;
+                keepRunning = trackerThread.push(std::move(result));
+            }
+        }
+
+        pipeline.waitForTotalCompletion();
+        for (; keepRunning && framesTracked <= frameNum; ++framesTracked) {
+            result = pipeline.getResult();
+            if (result != nullptr) {
+                keepRunning = trackerThread.push(std::move(result));
+            }
         }
+        trackerThread.finish();
 
         if (should_keep_tracking_info) {
             DetectionLog log = tracker->GetDetectionLog(true);
@@ -321,6 +367,7 @@ int main(int argc, char** argv) {
         slog::info << "Metrics report:" << slog::endl;
         metrics.logTotal();
         slog::info << presenter.reportMeans() << slog::endl;
+        logMemoryUsage();
     } catch (const std::exception& error) {
         slog::err << error.what() << slog::endl;
         return 1;
@@ -54,30 +54,22 @@ void BaseModel::Load() {
     compiled_model = core.compile_model(model, device_name);
     logCompiledModelInfo(compiled_model, config.path_to_model, device_name, modelType);
 
-    infer_request = compiled_model.create_infer_request();
-    input_tensor = infer_request.get_input_tensor();
-    output_tensor = infer_request.get_output_tensor();
+    infer_engine.reset(new BatchInferEngine(compiled_model,
+                                            static_cast<size_t>(std::max(config.max_num_requests, 1)),
+                                            input_shape,
+                                            input_layout));
 }
 
 void BaseModel::InferBatch(const std::vector<cv::Mat>& frames,
                            const std::function<void(const ov::Tensor&, size_t)>& fetch_results) const {
-    size_t num_imgs = frames.size();
-    input_tensor.set_shape(input_shape);
-    for (size_t batch_i = 0; batch_i < num_imgs;) {
-        size_t batch_size = std::min(num_imgs - batch_i, (size_t)config.max_batch_size);
-        for (size_t b = 0; b < batch_size; ++b) {
-            matToTensor(frames[batch_i + b], input_tensor, b);
-        }
-        infer_request.set_input_tensor(ov::Tensor(input_tensor,
-                                                  {0, 0, 0, 0},
-                                                  {batch_size,
-                                                   input_shape[ov::layout::channels_idx(input_layout)],
-                                                   input_shape[ov::layout::height_idx(input_layout)],
-                                                   input_shape[ov::layout::width_idx(input_layout)]}));
-        infer_request.infer();
-        fetch_results(infer_request.get_output_tensor(), batch_size);
-        batch_i += batch_size;
-    }
+    infer_engine->infer(
+        frames,
+        [](const cv::Mat& frame, const ov::Tensor& item_tensor) {
+            matToTensor(frame, item_tensor);
+        },
+        [&fetch_results](ov::InferRequest& infer_request, size_t batch_size) {
+            fetch_results(infer_request.get_output_tensor(), batch_size);
+        });
 }
 
 VectorCNN::VectorCNN(const Config& config, const ov::Core& core, const std::string& deviceName)
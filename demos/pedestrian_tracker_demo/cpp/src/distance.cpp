@@ -11,6 +11,54 @@
 
 #include "logging.hpp"
 
+namespace {
+// Stacks the descriptors as CV_32F rows of unit length, so cosine similarities are dot products of the rows
+cv::Mat StackNormalizedDescriptors(const std::vector<cv::Mat>& descrs, double eps) {
+    PT_CHECK(!descrs.empty());
+    const int length = static_cast<int>(descrs.front().total() * descrs.front().channels());
+    cv::Mat stacked(static_cast<int>(descrs.size()), length, CV_32F);
+    for (size_t i = 0; i < descrs.size(); i++) {
+        PT_CHECK_EQ(static_cast<int>(descrs[i].total() * descrs[i].channels()), length);
+        const cv::Mat continuous = descrs[i].isContinuous() ? descrs[i] : descrs[i].clone();
+        cv::Mat row = stacked.row(static_cast<int>(i));
+        continuous.reshape(1, 1).convertTo(row, CV_32F);
+        row *= 1.0 / (cv::norm(row) + eps);
+    }
+    return stacked;
+}
+
+// Returns descrs1.size() x descrs2.size() matrix of cosine similarities of the descriptors
+cv::Mat CosineSimilarities(const std::vector<cv::Mat>& descrs1, const std::vector<cv::Mat>& descrs2, double eps) {
+    const cv::Mat stacked1 = StackNormalizedDescriptors(descrs1, eps);
+    const cv::Mat stacked2 = StackNormalizedDescriptors(descrs2, eps);
+    cv::Mat similarities;
+    cv::gemm(stacked1, stacked2, 1.0, cv::noArray(), 0.0, similarities, cv::GEMM_2_T);
+    return similarities;
+}
+
+// Returns descrs1.size() x 1 matrix of cosine similarities of the descriptor pairs
+cv::Mat PairwiseCosineSimilarities(const std::vector<cv::Mat>& descrs1, const std::vector<cv::Mat>& descrs2,
+                                   double eps) {
+    PT_CHECK_EQ(descrs1.size(), descrs2.size());
+    const cv::Mat stacked1 = StackNormalizedDescriptors(descrs1, eps);
+    const cv::Mat stacked2 = StackNormalizedDescriptors(descrs2, eps);
+    cv::Mat similarities;
+    cv::reduce(stacked1.mul(stacked2), similarities, 1, cv::REDUCE_SUM, CV_32F);
+    return similarities;
+}
+}  // namespace
+
+cv::Mat IDescriptorDistance::ComputeMatrix(const std::vector<cv::Mat>& descrs1, const std::vector<cv::Mat>& descrs2) {
+    cv::Mat distances(static_cast<int>(descrs1.size()), static_cast<int>(descrs2.size()), CV_32F);
+    for (size_t i = 0; i < descrs1.size(); i++) {
+        float* row = distances.ptr<float>(static_cast<int>(i));
+        for (size_t j = 0; j < descrs2.size(); j++) {
+            row[j] = Compute(descrs1[i], descrs2[j]);
+        }
+    }
+    return distances;
+}
+
 CosDistance::CosDistance(const cv::Size& descriptor_size) : descriptor_size_(descriptor_size) {
     PT_CHECK(descriptor_size.area() != 0);
 }
@@ -31,12 +79,22 @@ float CosDistance::Compute(const cv::Mat& descr1, const cv::Mat& descr2) {
 std::vector<float> CosDistance::Compute(const std::vector<cv::Mat>& descrs1, const std::vector<cv::Mat>& descrs2) {
     PT_CHECK(descrs1.size() != 0);
     PT_CHECK(descrs1.size() == descrs2.size());
+    PT_CHECK(descrs1.front().size() == descriptor_size_);
+    PT_CHECK(descrs2.front().size() == descriptor_size_);
 
-    std::vector<float> distances(descrs1.size(), 1.f);
-    for (size_t i = 0; i < descrs1.size(); i++) {
-        distances.at(i) = Compute(descrs1.at(i), descrs2.at(i));
-    }
+    cv::Mat distances = PairwiseCosineSimilarities(descrs1, descrs2, 1e-6);
+    distances = 0.5f * (1.0f - distances);
+    return std::vector<float>(distances.begin<float>(), distances.end<float>());
+}
 
+cv::Mat CosDistance::ComputeMatrix(const std::vector<cv::Mat>& descrs1, const std::vector<cv::Mat>& descrs2) {
+    if (descrs1.empty() || descrs2.empty()) {
+        return cv::Mat(static_cast<int>(descrs1.size()), static_cast<int>(descrs2.size()), CV_32F);
+    }
+    PT_CHECK(descrs1.front().size() == descriptor_size_);
+    PT_CHECK(descrs2.front().size() == descriptor_size_);
+    cv::Mat distances = CosineSimilarities(descrs1, descrs2, 1e-6);
+    distances = 0.5f * (1.0f - distances);
     return distances;
 }
 
@@ -53,9 +111,22 @@ float MatchTemplateDistance::Compute(const cv::Mat& descr1, const cv::Mat& descr
 
 std::vector<float> MatchTemplateDistance::Compute(const std::vector<cv::Mat>& descrs1,
                                                   const std::vector<cv::Mat>& descrs2) {
+    if (type_ == cv::TemplateMatchModes::TM_CCORR_NORMED && !descrs1.empty()) {
+        cv::Mat distances = scale_ * cv::min(PairwiseCosineSimilarities(descrs1, descrs2, 1e-6), 1.0f) + offset_;
+        return std::vector<float>(distances.begin<float>(), distances.end<float>());
+    }
     std::vector<float> result;
     for (size_t i = 0; i < descrs1.size(); i++) {
         result.push_back(Compute(descrs1[i], descrs2[i]));
     }
     return result;
 }
+
+cv::Mat MatchTemplateDistance::ComputeMatrix(const std::vector<cv::Mat>& descrs1, const std::vector<cv::Mat>& descrs2) {
+    if (type_ != cv::TemplateMatchModes::TM_CCORR_NORMED || descrs1.empty() || descrs2.empty()) {
+        return IDescriptorDistance::ComputeMatrix(descrs1, descrs2);
+    }
+    cv::Mat similarities = CosineSimilarities(descrs1, descrs2, 1e-6);
+    cv::Mat distances = scale_ * cv::min(similarities, 1.0f) + offset_;
+    return distances;
+}
@@ -474,6 +474,17 @@ void PedestrianTracker::Process(const cv::Mat& frame, const TrackedObjects& inpu
 
     tracks_dists_.clear();
     prev_timestamp_ = timestamp;
+    UpdateMemoryUsage();
+}
+
+void PedestrianTracker::UpdateMemoryUsage() {
+    size_t bytes = 0;
+    for (const auto& pair : tracks_) {
+        const Track& track = pair.second;
+        bytes += sizeof(Track) + track.objects.size() * sizeof(TrackedObject) + getMatBytes(track.last_image) +
+                 getMatBytes(track.descriptor_fast) + getMatBytes(track.descriptor_strong);
+    }
+    tracks_memory_.set(bytes);
 }
 
 void PedestrianTracker::DropForgottenTracks() {
@@ -522,7 +533,8 @@ void PedestrianTracker::ComputeFastDesciptors(const cv::Mat& frame,
                                               std::vector<cv::Mat>* descriptors) {
     *descriptors = std::vector<cv::Mat>(detections.size(), cv::Mat());
     for (size_t i = 0; i < detections.size(); i++) {
-        descriptor_fast_->Compute(frame(detections[i].rect).clone(), &((*descriptors)[i]));
+        // resizing reads the crop from the frame, so there is no need to copy it
+        descriptor_fast_->Compute(frame(detections[i].rect), &((*descriptors)[i]));
     }
 }
 
@@ -530,17 +542,56 @@ void PedestrianTracker::ComputeDissimilarityMatrix(const std::set<size_t>& activ
                                                    const TrackedObjects& detections,
                                                    const std::vector<cv::Mat>& descriptors_fast,
                                                    cv::Mat* dissimilarity_matrix) {
-    cv::Mat am(active_tracks.size(), detections.size(), CV_32F, cv::Scalar(0));
-    size_t i = 0;
+    // Appearance distances of all pairs are computed at once. Shape, motion and time affinities are exponents of
+    // weighted distances, so their product is one exponent of the sum of the distances
+    std::vector<cv::Mat> track_descriptors;
+    std::vector<cv::Rect> track_rects;
+    std::vector<float> track_times;
     for (auto id : active_tracks) {
-        auto ptr = am.ptr<float>(i);
-        for (size_t j = 0; j < descriptors_fast.size(); j++) {
-            auto last_det = tracks_.at(id).objects.back();
-            last_det.rect = tracks_.at(id).predicted_rect;
-            ptr[j] = AffinityFast(tracks_.at(id).descriptor_fast, last_det, descriptors_fast[j], detections[j]);
+        const auto& track = tracks_.at(id);
+        track_descriptors.push_back(track.descriptor_fast);
+        track_rects.push_back(track.predicted_rect);
+        track_times.push_back(static_cast<float>(track.objects.back().frame_idx));
+    }
+    std::vector<int> det_x, det_y, det_width, det_height;
+    std::vector<float> det_times;
+    for (const auto& detection : detections) {
+        det_x.push_back(detection.rect.x);
+        det_y.push_back(detection.rect.y);
+        det_width.push_back(detection.rect.width);
+        det_height.push_back(detection.rect.height);
+        det_times.push_back(static_cast<float>(detection.frame_idx));
+    }
+    const cv::Mat app_dist = distance_fast_->ComputeMatrix(track_descriptors, descriptors_fast);
+
+    // A pair is not matched if any of its affinities is less than eps
+    const float eps = 1e-6f;
+    const float max_exponent = -std::log(eps);
+    const int tracks_num = static_cast<int>(track_rects.size());
+    const int dets_num = static_cast<int>(det_x.size());
+    cv::Mat exponents(tracks_num, dets_num, CV_32F);
+    cv::Mat dropped(tracks_num, dets_num, CV_8U);
+    for (int i = 0; i < tracks_num; i++) {
+        const cv::Rect& trk = track_rects[i];
+        float* exponents_row = exponents.ptr<float>(i);
+        uchar* dropped_row = dropped.ptr<uchar>(i);
+        for (int j = 0; j < dets_num; j++) {
+            // the same as ShapeAffinity(), MotionAffinity() and TimeAffinity()
+            const float w_dist = static_cast<float>(std::abs(trk.width - det_width[j]) / (trk.width + det_width[j]));
+            const float h_dist = static_cast<float>(std::abs(trk.height - det_height[j]) / (trk.height + det_height[j]));
+            const float x_dist = static_cast<float>(trk.x - det_x[j]) * (trk.x - det_x[j]) / (det_width[j] * det_width[j]);
+            const float y_dist = static_cast<float>(trk.y - det_y[j]) * (trk.y - det_y[j]) / (det_height[j] * det_height[j]);
+            const float shp = params_.shape_affinity_w * (w_dist + h_dist);
+            const float mot = params_.motion_affinity_w * (x_dist + y_dist);
+            const float time = params_.time_affinity_w * std::fabs(track_times[i] - det_times[j]);
+            exponents_row[j] = -(shp + mot + time);
+            dropped_row[j] = shp > max_exponent || mot > max_exponent || time > max_exponent;
         }
-        i++;
     }
+    cv::Mat am;
+    cv::exp(exponents, am);
+    am = am.mul(1.0f - app_dist);
+    am.setTo(0, dropped);
     *dissimilarity_matrix = 1.0 - am;
 }
 
@@ -551,21 +602,24 @@ std::vector<float> PedestrianTracker::ComputeDistances(const cv::Mat& frame,
     std::map<size_t, size_t> det_to_batch_ids;
     std::map<size_t, size_t> track_to_batch_ids;
 
+    // A track or a detection may be in several pairs, but it is embedded once
     std::vector<cv::Mat> images;
     std::vector<cv::Mat> descriptors;
     for (size_t i = 0; i < track_and_det_ids.size(); i++) {
         size_t track_id = track_and_det_ids[i].first;
         size_t det_id = track_and_det_ids[i].second;
 
-        if (tracks_.at(track_id).descriptor_strong.empty()) {
+        if (tracks_.at(track_id).descriptor_strong.empty() && track_to_batch_ids.count(track_id) == 0) {
             images.push_back(tracks_.at(track_id).last_image);
             descriptors.push_back(cv::Mat());
             track_to_batch_ids[track_id] = descriptors.size() - 1;
         }
 
-        images.push_back(frame(detections[det_id].rect));
-        descriptors.push_back(cv::Mat());
-        det_to_batch_ids[det_id] = descriptors.size() - 1;
+        if (det_to_batch_ids.count(det_id) == 0) {
+            images.push_back(frame(detections[det_id].rect));
+            descriptors.push_back(cv::Mat());
+            det_to_batch_ids[det_id] = descriptors.size() - 1;
+        }
     }
 
     descriptor_strong_->Compute(images, &descriptors);
@@ -703,34 +757,11 @@ void PedestrianTracker::AppendToTrack(const cv::Mat& frame,
 
     if (params_.max_num_objects_in_track > 0) {
         while (cur_track.size() > static_cast<size_t>(params_.max_num_objects_in_track)) {
-            cur_track.objects.erase(cur_track.objects.begin());
+            cur_track.objects.pop_front();
         }
     }
 }
 
-float PedestrianTracker::AffinityFast(const cv::Mat& descriptor1,
-                                      const TrackedObject& obj1,
-                                      const cv::Mat& descriptor2,
-                                      const TrackedObject& obj2) {
-    const float eps = 1e-6f;
-    float shp_aff = ShapeAffinity(params_.shape_affinity_w, obj1.rect, obj2.rect);
-    if (shp_aff < eps)
-        return 0.0f;
-
-    float mot_aff = MotionAffinity(params_.motion_affinity_w, obj1.rect, obj2.rect);
-    if (mot_aff < eps)
-        return 0.0f;
-    float time_aff =
-        TimeAffinity(params_.time_affinity_w, static_cast<float>(obj1.frame_idx), static_cast<float>(obj2.frame_idx));
-
-    if (time_aff < eps)
-        return 0.0f;
-
-    float app_aff = 1.0f - distance_fast_->Compute(descriptor1, descriptor2);
-
-    return shp_aff * mot_aff * app_aff * time_aff;
-}
-
 float PedestrianTracker::Affinity(const TrackedObject& obj1, const TrackedObject& obj2) {
     float shp_aff = ShapeAffinity(params_.shape_affinity_w, obj1.rect, obj2.rect);
     float mot_aff = MotionAffinity(params_.motion_affinity_w, obj1.rect, obj2.rect);
@@ -4,7 +4,9 @@
 
 #include <algorithm>
 #include <chrono>
+#include <fstream>
 #include <iomanip>
+#include <limits>
 #include <list>
 #include <map>
 #include <memory>
@@ -24,6 +26,7 @@
 #include "utils/input_wrappers.hpp"
 #include "utils/ocv_common.hpp"
 #include "utils/slog.hpp"
+#include "utils/startup_profiler.hpp"
 #include "utils/threads_common.hpp"
 
 #include "net_wrappers.hpp"
@@ -51,9 +54,42 @@ bool ParseAndCheckCommandLine(int argc, char* argv[]) {
     if (FLAGS_n_wt == 0) {
         throw std::logic_error("-n_wt can not be zero");
     }
+    if (FLAGS_bs == 0) {
+        throw std::logic_error("-bs can not be zero");
+    }
+    if (FLAGS_bs > 1 && FLAGS_auto_resize) {
+        throw std::logic_error("-bs can not be used with -auto_resize because crops of different sizes can't be batched");
+    }
+    if (FLAGS_motion_thr < 0) {
+        throw std::logic_error("-motion_thr can not be negative");
+    }
     return true;
 }
 
+std::vector<cv::Rect> parseRois(const std::string& roisStr, size_t channelsNum) {
+    std::vector<cv::Rect> rois;
+    if (roisStr.empty()) {
+        return std::vector<cv::Rect>(channelsNum);
+    }
+    for (const std::string& roiStr : split(roisStr, ';')) {
+        const std::vector<std::string> coords = split(roiStr, ',');
+        if (coords.size() != 4) {
+            throw std::logic_error("Incorrect format of -roi region \"" + roiStr + "\". Correct format is \"x,y,width,height\"");
+        }
+        cv::Rect roi{std::stoi(coords[0]), std::stoi(coords[1]), std::stoi(coords[2]), std::stoi(coords[3])};
+        if (roi.x < 0 || roi.y < 0 || roi.width <= 0 || roi.height <= 0) {
+            throw std::logic_error("-roi region \"" + roiStr + "\" is empty or out of the frame");
+        }
+        rois.push_back(roi);
+    }
+    if (1 == rois.size()) {
+        rois.resize(channelsNum, rois.front());
+    } else if (rois.size() != channelsNum) {
+        throw std::logic_error("-roi should have one region or a region for each of " + std::to_string(channelsNum) + " channels");
+    }
+    return rois;
+}
+
 struct BboxAndDescr {
     enum class ObjectType {
         NONE,
@@ -64,6 +100,27 @@ struct BboxAndDescr {
     std::string descr;
 };
 
+// a vehicle or a plate tracked across the frames of a channel, its recognition results are reused until they change
+struct Track {
+    cv::Rect rect;
+    int64_t lastFrameId;
+    std::string descr;  // drawn for the track, empty until the first recognition finishes
+    std::string candidate;  // the description read candidateReads times in a row
+    unsigned candidateReads;
+    bool stable;  // candidate was read enough times, so the track isn't recognized again
+    bool pending;  // a recognition of the track is in flight
+    double bestArea, bestSharpness;  // of the recognized crops
+};
+
+struct ChannelTracks {
+    std::map<uint64_t, Track> vehicles;
+    std::map<uint64_t, Track> plates;
+    uint64_t nextTrackId = 0;
+};
+
+// the id of detections which aren't tracked
+constexpr uint64_t NO_TRACK = std::numeric_limits<uint64_t>::max();
+
 struct InferRequestsContainer {
     InferRequestsContainer() = default;
     InferRequestsContainer(const InferRequestsContainer&) = delete;
@@ -71,14 +128,14 @@ struct InferRequestsContainer {
 
     void assign(const std::vector<ov::InferRequest>& inferRequests) {
         actualInferRequests = inferRequests;
-        this->inferRequests.container.clear();
+        this->inferRequests.reset(actualInferRequests.size());
 
         for (auto& ir : this->actualInferRequests) {
-            this->inferRequests.container.push_back(ir);
+            this->inferRequests.tryPush(&ir);
         }
     }
 
-    ConcurrentContainer<std::vector<std::reference_wrapper<ov::InferRequest>>> inferRequests;
+    ConcurrentPool<ov::InferRequest*> inferRequests;
 
 private:
     std::vector<ov::InferRequest> actualInferRequests;
@@ -94,18 +151,30 @@ struct Context {
             uint64_t lastFrameId,
             uint64_t nireq,
             bool isVideo,
-            std::size_t nclassifiersireq, std::size_t nrecognizersireq) :
+            std::size_t nclassifiersireq, std::size_t nrecognizersireq,
+            const std::vector<cv::Rect>& rois, double motionThreshold, unsigned stableReads,
+            StartupProfiler& startupProfiler) :
         readersContext{inputChannels, std::vector<int64_t>(inputChannels.size(), -1), std::vector<std::mutex>(inputChannels.size())},
-        inferTasksContext{detector},
+        inferTasksContext{detector, rois},
+        motionContext{motionThreshold, std::vector<cv::Mat>(inputChannels.size()),
+            std::vector<std::list<BboxAndDescr>>(inputChannels.size()), std::vector<std::mutex>(inputChannels.size())},
         detectionsProcessorsContext{vehicleAttributesClassifier, lpr},
+        tracksContext{stableReads, std::vector<ChannelTracks>(inputChannels.size()), std::vector<std::mutex>(inputChannels.size()),
+            {0}, {0}},
         drawersContext{pause, gridParam, displayResolution, showPeriod, monitorsStr},
-        videoFramesContext{std::vector<uint64_t>(inputChannels.size(), lastFrameId), std::vector<std::mutex>(inputChannels.size())},
+        videoFramesContext{std::vector<std::atomic<uint64_t>>(inputChannels.size())},
+        framesPool{(lastFrameId + 1) * inputChannels.size()},
+        readersPool{(lastFrameId + 1) * inputChannels.size()},
         nireq{nireq},
         isVideo{isVideo},
         freeDetectionInfersCount{0},
-        frameCounter{0}
+        frameCounter{0},
+        startupProfiler(startupProfiler)
     {
         assert(inputChannels.size() == gridParam.size());
+        for (std::atomic<uint64_t>& lastframeId : videoFramesContext.lastframeIds) {
+            lastframeId = lastFrameId;
+        }
         std::vector<ov::InferRequest> detectorInferRequests;
         std::vector<ov::InferRequest> attributesInferRequests;
         std::vector<ov::InferRequest> lprInferRequests;
@@ -132,15 +201,33 @@ struct Context {
 
     struct {
         Detector detector;
+        std::vector<cv::Rect> rois;  // empty for the whole frame
         std::weak_ptr<Worker> inferTasksWorker;
     } inferTasksContext;
 
+    // the detector is skipped for the frames whose region of interest didn't change since the last detected frame
+    struct {
+        double threshold;  // 0 disables the skipping
+        std::vector<cv::Mat> prevSamples;  // downscaled gray regions of the last detected frames
+        std::vector<std::list<BboxAndDescr>> lastResults;
+        std::vector<std::mutex> lastResultsMutexes;
+    } motionContext;
+
     struct {
         VehicleAttributesClassifier vehicleAttributesClassifier;
         Lpr lpr;
         std::weak_ptr<Worker> detectionsProcessorsWorker;
     } detectionsProcessorsContext;
 
+    // recognition results are reused for the tracks of the channels whose results are stable
+    struct {
+        unsigned stableReads;  // 0 disables the tracking
+        std::vector<ChannelTracks> tracks;
+        std::vector<std::mutex> tracksMutexes;
+        std::atomic<uint64_t> recognized;
+        std::atomic<uint64_t> reused;
+    } tracksContext;
+
     struct DrawersContext {
         DrawersContext(int pause, const std::vector<cv::Size>& gridParam, cv::Size displayResolution, std::chrono::steady_clock::duration showPeriod,
                        const std::string& monitorsStr):
@@ -162,10 +249,13 @@ struct Context {
     } drawersContext;
 
     struct {
-        std::vector<uint64_t> lastframeIds;
-        std::vector<std::mutex> lastFrameIdsMutexes;
+        std::vector<std::atomic<uint64_t>> lastframeIds;
     } videoFramesContext;
 
+    // every frame slot is reborn with a new Reader task, so their memory is recycled instead of the heap allocations
+    BlockPool framesPool;
+    BlockPool readersPool;
+
     std::weak_ptr<Worker> resAggregatorsWorker;
     std::mutex classifiersAggregatorPrintMutex;
     uint64_t nireq;
@@ -174,6 +264,7 @@ struct Context {
     std::atomic<uint32_t> frameCounter;
     InferRequestsContainer detectorsInfers, attributesInfers, platesInfers;
     PerformanceMetrics metrics;
+    StartupProfiler& startupProfiler;
 };
 
 class ReborningVideoFrame: public VideoFrame {
@@ -184,12 +275,54 @@ public:
     Context& context;
 };
 
+// returns the part of the frame the detector runs on
+cv::Rect detectionRoi(const Context& context, const VideoFrame& videoFrame) {
+    const cv::Rect frameRect{cv::Point(0, 0), videoFrame.frame.size()};
+    const cv::Rect roi = context.inferTasksContext.rois[videoFrame.sourceID] & frameRect;
+    return roi.empty() ? frameRect : roi;
+}
+
+// returns true if the region of interest of the frame is almost the same as of the last detected frame of the channel.
+// Otherwise the frame becomes the last detected one. Should be called in the order of the frames of a channel
+bool isStatic(Context& context, const VideoFrame& videoFrame) {
+    constexpr int sampleSize = 64;
+    cv::Mat sample;
+    cv::resize(videoFrame.frame(detectionRoi(context, videoFrame)), sample, {sampleSize, sampleSize}, 0, 0, cv::INTER_AREA);
+    cv::cvtColor(sample, sample, cv::COLOR_BGR2GRAY);
+    cv::Mat& prevSample = context.motionContext.prevSamples[videoFrame.sourceID];
+    if (!prevSample.empty()) {
+        cv::Mat diff;
+        cv::absdiff(sample, prevSample, diff);
+        if (cv::mean(diff)[0] < context.motionContext.threshold) {
+            return true;
+        }
+    }
+    prevSample = sample;
+    return false;
+}
+
+double intersectionOverUnion(const cv::Rect& lhs, const cv::Rect& rhs) {
+    const int intersection = (lhs & rhs).area();
+    return intersection > 0 ? static_cast<double>(intersection) / (lhs.area() + rhs.area() - intersection) : 0.0;
+}
+
+// variance of the Laplacian, it grows with the contrast of edges
+double sharpness(const cv::Mat& crop) {
+    cv::Mat gray, laplacian;
+    cv::cvtColor(crop, gray, cv::COLOR_BGR2GRAY);
+    cv::Laplacian(gray, laplacian, CV_32F);
+    cv::Scalar mean, stddev;
+    cv::meanStdDev(laplacian, mean, stddev);
+    return stddev[0] * stddev[0];
+}
+
 // accumulates and shows processed frames
 class Drawer : public Task {
 public:
     explicit Drawer(VideoFrame::Ptr sharedVideoFrame) :
         Task{ sharedVideoFrame, 1.0 } {}
     bool isReady() override;
+    std::chrono::steady_clock::time_point readyTime() override;
     void process() override;
 };
 
@@ -252,18 +385,25 @@ public:
         Task{sharedVideoFrame, 1.0}, inferRequest{inferRequest}, requireGettingNumberOfDetections{true} {}
 
     DetectionsProcessor(VideoFrame::Ptr sharedVideoFrame, std::shared_ptr<ClassifiersAggregator>&& classifiersAggregator, std::list<cv::Rect>&& vehicleRects,
-        std::list<cv::Rect>&& plateRects) :
+        std::list<cv::Rect>&& plateRects, std::list<uint64_t>&& vehicleTrackIds, std::list<uint64_t>&& plateTrackIds) :
             Task{sharedVideoFrame, 1.0}, classifiersAggregator{std::move(classifiersAggregator)}, inferRequest{nullptr},
-            vehicleRects{std::move(vehicleRects)}, plateRects{std::move(plateRects)}, requireGettingNumberOfDetections{false} {}
+            vehicleRects{std::move(vehicleRects)}, plateRects{std::move(plateRects)}, vehicleTrackIds{std::move(vehicleTrackIds)},
+            plateTrackIds{std::move(plateTrackIds)}, requireGettingNumberOfDetections{false} {}
 
     bool isReady() override;
     void process() override;
 
 private:
+    // matches the rects to the tracks of the channel. The rects of the tracks with stable results are pushed to
+    // classifiersAggregator with the results and removed, the track ids of the other rects are appended to trackIds
+    void reuseStableResults(bool isPlate, std::list<cv::Rect>& rects, std::list<uint64_t>& trackIds);
+
     std::shared_ptr<ClassifiersAggregator> classifiersAggregator; // when no one stores this object we will draw
     ov::InferRequest* inferRequest;
     std::list<cv::Rect> vehicleRects;
     std::list<cv::Rect> plateRects;
+    std::list<uint64_t> vehicleTrackIds;  // parallel to vehicleRects
+    std::list<uint64_t> plateTrackIds;
     std::vector<std::reference_wrapper<ov::InferRequest>> reservedAttributesRequests;
     std::vector<std::reference_wrapper<ov::InferRequest>> reservedLprRequests;
     bool requireGettingNumberOfDetections;
@@ -276,6 +416,9 @@ public:
         Task{sharedVideoFrame, 5.0} {}
     bool isReady() override;
     void process() override;
+
+private:
+    ov::InferRequest* reservedRequest = nullptr;
 };
 
 class Reader: public Task {
@@ -289,11 +432,10 @@ public:
 ReborningVideoFrame::~ReborningVideoFrame() {
     try {
         const std::shared_ptr<Worker>& worker = std::shared_ptr<Worker>(context.readersContext.readersWorker);
-        context.videoFramesContext.lastFrameIdsMutexes[sourceID].lock();
         const auto frameId = ++context.videoFramesContext.lastframeIds[sourceID];
-        context.videoFramesContext.lastFrameIdsMutexes[sourceID].unlock();
-        std::shared_ptr<ReborningVideoFrame> reborn = std::make_shared<ReborningVideoFrame>(context, sourceID, frameId, frame);
-        worker->push(std::make_shared<Reader>(reborn));
+        std::shared_ptr<ReborningVideoFrame> reborn = std::allocate_shared<ReborningVideoFrame>(
+            PoolAllocator<ReborningVideoFrame>(context.framesPool), context, sourceID, frameId, frame);
+        worker->push(std::allocate_shared<Reader>(PoolAllocator<Reader>(context.readersPool), reborn));
     } catch (const std::bad_weak_ptr&) {}
 }
 
@@ -331,6 +473,11 @@ bool Drawer::isReady() {
     }
 }
 
+std::chrono::steady_clock::time_point Drawer::readyTime() {
+    const Context& context = static_cast<ReborningVideoFrame*>(sharedVideoFrame.get())->context;
+    return context.drawersContext.prevShow + context.drawersContext.showPeriod;
+}
+
 void Drawer::process() {
     const int64_t frameId = sharedVideoFrame->frameId;
     Context& context = static_cast<ReborningVideoFrame*>(sharedVideoFrame.get())->context;
@@ -361,6 +508,7 @@ void Drawer::process() {
 
         context.drawersContext.presenter.drawGraphs(mat);
         context.metrics.update(sharedVideoFrame->timestamp, mat, { 15, 35 }, cv::FONT_HERSHEY_TRIPLEX, 0.7, cv::Scalar{ 255, 255, 255 }, 0);
+        context.startupProfiler.markFirstResult();
         if (!FLAGS_no_show) {
             cv::imshow("Detection results", firstGridIt->second.getMat());
             context.drawersContext.prevShow = std::chrono::steady_clock::now();
@@ -393,8 +541,15 @@ void Drawer::process() {
 
 void ResAggregator::process() {
     Context& context = static_cast<ReborningVideoFrame*>(sharedVideoFrame.get())->context;
-    context.freeDetectionInfersCount += context.detectorsInfers.inferRequests.lockedSize();
+    context.freeDetectionInfersCount += context.detectorsInfers.inferRequests.size();
     context.frameCounter++;
+    if (0 != context.motionContext.threshold) {
+        std::lock_guard<std::mutex> lock{context.motionContext.lastResultsMutexes[sharedVideoFrame->sourceID]};
+        context.motionContext.lastResults[sharedVideoFrame->sourceID] = boxesAndDescrs;
+    }
+    if (!context.inferTasksContext.rois[sharedVideoFrame->sourceID].empty()) {
+        cv::rectangle(sharedVideoFrame->frame, detectionRoi(context, *sharedVideoFrame), {0, 255, 255}, 1);
+    }
     for (const BboxAndDescr& bboxAndDescr : boxesAndDescrs) {
         switch (bboxAndDescr.objectType) {
             case BboxAndDescr::ObjectType::NONE:
@@ -423,12 +578,101 @@ void ResAggregator::process() {
     tryPush(context.drawersContext.drawersWorker, std::make_shared<Drawer>(sharedVideoFrame));
 }
 
+// records the recognition result of the track, @returns the description to draw
+std::string updateTrack(Context& context, unsigned sourceID, bool isPlate, uint64_t trackId, std::string&& result) {
+    ++context.tracksContext.recognized;
+    if (NO_TRACK == trackId) {
+        return std::move(result);
+    }
+    std::lock_guard<std::mutex> lock{context.tracksContext.tracksMutexes[sourceID]};
+    ChannelTracks& channelTracks = context.tracksContext.tracks[sourceID];
+    std::map<uint64_t, Track>& tracks = isPlate ? channelTracks.plates : channelTracks.vehicles;
+    auto trackIt = tracks.find(trackId);
+    if (tracks.end() == trackIt) {  // the track was lost while it was recognized
+        return std::move(result);
+    }
+    Track& track = trackIt->second;
+    track.pending = false;
+    if (result == track.candidate) {
+        ++track.candidateReads;
+    } else {
+        // a better crop which reads differently restarts counting
+        track.candidate = result;
+        track.candidateReads = 1;
+        track.stable = false;
+    }
+    track.stable = track.stable || track.candidateReads >= context.tracksContext.stableReads;
+    track.descr = result;
+    return std::move(result);
+}
+
+void DetectionsProcessor::reuseStableResults(bool isPlate, std::list<cv::Rect>& rects, std::list<uint64_t>& trackIds) {
+    Context& context = static_cast<ReborningVideoFrame*>(sharedVideoFrame.get())->context;
+    if (0 == context.tracksContext.stableReads) {
+        trackIds.resize(rects.size(), NO_TRACK);
+        return;
+    }
+    // a result is refreshed if the crop gets this much larger or sharper than the recognized ones
+    constexpr double REFRESH_RATIO = 1.2;
+    constexpr double MIN_IOU = 0.3;
+    constexpr int64_t MAX_TRACK_AGE = 30;  // frames without detection after which a track is lost
+    const int64_t frameId = sharedVideoFrame->frameId;
+    std::lock_guard<std::mutex> lock{context.tracksContext.tracksMutexes[sharedVideoFrame->sourceID]};
+    ChannelTracks& channelTracks = context.tracksContext.tracks[sharedVideoFrame->sourceID];
+    std::map<uint64_t, Track>& tracks = isPlate ? channelTracks.plates : channelTracks.vehicles;
+    std::set<uint64_t> matchedTrackIds;
+    for (auto rectIt = rects.begin(); rects.end() != rectIt;) {
+        auto bestTrackIt = tracks.end();
+        double bestIou = MIN_IOU;
+        for (auto trackIt = tracks.begin(); tracks.end() != trackIt; ++trackIt) {
+            const double iou = intersectionOverUnion(*rectIt, trackIt->second.rect);
+            if (iou >= bestIou && 0 == matchedTrackIds.count(trackIt->first)) {
+                bestIou = iou;
+                bestTrackIt = trackIt;
+            }
+        }
+        if (tracks.end() == bestTrackIt) {
+            bestTrackIt = tracks.emplace(channelTracks.nextTrackId++,
+                Track{*rectIt, frameId, "", "", 0, false, false, 0.0, 0.0}).first;
+        }
+        matchedTrackIds.insert(bestTrackIt->first);
+        Track& track = bestTrackIt->second;
+        if (frameId >= track.lastFrameId) {  // frames of a channel may be detected out of order
+            track.rect = *rectIt;
+            track.lastFrameId = frameId;
+        }
+        const double area = rectIt->area();
+        const double cropSharpness = isPlate && !rectIt->empty() ? sharpness(sharedVideoFrame->frame(*rectIt)) : 0.0;
+        const bool isBetterCrop = area > track.bestArea * REFRESH_RATIO || cropSharpness > track.bestSharpness * REFRESH_RATIO;
+        if (!track.descr.empty() && (track.pending || (track.stable && !isBetterCrop))) {
+            ++context.tracksContext.reused;
+            classifiersAggregator->push(BboxAndDescr{isPlate ? BboxAndDescr::ObjectType::PLATE : BboxAndDescr::ObjectType::VEHICLE,
+                *rectIt, track.descr});
+            rectIt = rects.erase(rectIt);
+        } else {
+            track.pending = true;
+            track.bestArea = std::max(track.bestArea, area);
+            track.bestSharpness = std::max(track.bestSharpness, cropSharpness);
+            trackIds.push_back(bestTrackIt->first);
+            ++rectIt;
+        }
+    }
+    for (auto trackIt = tracks.begin(); tracks.end() != trackIt;) {
+        if (frameId - trackIt->second.lastFrameId > MAX_TRACK_AGE) {
+            trackIt = tracks.erase(trackIt);
+        } else {
+            ++trackIt;
+        }
+    }
+}
+
 bool DetectionsProcessor::isReady() {
     Context& context = static_cast<ReborningVideoFrame*>(sharedVideoFrame.get())->context;
     if (requireGettingNumberOfDetections) {
         classifiersAggregator = std::make_shared<ClassifiersAggregator>(sharedVideoFrame);
         std::list<Detector::Result> results;
-        results = context.inferTasksContext.detector.getResults(*inferRequest, sharedVideoFrame->frame.size(), classifiersAggregator->rawDetections);
+        results = context.inferTasksContext.detector.getResults(*inferRequest, detectionRoi(context, *sharedVideoFrame),
+            classifiersAggregator->rawDetections);
         for (Detector::Result result : results) {
             switch (result.label) {
                 case 1:
@@ -451,142 +695,155 @@ bool DetectionsProcessor::isReady() {
                     break;
             }
         }
-        context.detectorsInfers.inferRequests.lockedPushBack(*inferRequest);
+        context.detectorsInfers.inferRequests.tryPush(inferRequest);
+        if (!FLAGS_m_va.empty()) {
+            reuseStableResults(false, vehicleRects, vehicleTrackIds);
+        }
+        if (!FLAGS_m_lpr.empty()) {
+            reuseStableResults(true, plateRects, plateTrackIds);
+        }
         requireGettingNumberOfDetections = false;
     }
 
     if ((vehicleRects.empty() || FLAGS_m_va.empty()) && (plateRects.empty() || FLAGS_m_lpr.empty())) {
         return true;
     } else {
-        // isReady() is called under mutexes so it is assured that available InferRequests will not be taken, but new InferRequests can come in
-        // acquire as many InferRequests as it is possible or needed
-        InferRequestsContainer& attributesInfers = context.attributesInfers;
-        attributesInfers.inferRequests.mutex.lock();
-        const std::size_t numberOfAttributesInferRequestsAcquired = std::min(vehicleRects.size(), attributesInfers.inferRequests.container.size());
-        reservedAttributesRequests.assign(attributesInfers.inferRequests.container.end() - numberOfAttributesInferRequestsAcquired,
-                                          attributesInfers.inferRequests.container.end());
-        attributesInfers.inferRequests.container.erase(attributesInfers.inferRequests.container.end() - numberOfAttributesInferRequestsAcquired,
-                                                       attributesInfers.inferRequests.container.end());
-        attributesInfers.inferRequests.mutex.unlock();
-
-        InferRequestsContainer& platesInfers = context.platesInfers;
-        platesInfers.inferRequests.mutex.lock();
-        const std::size_t numberOfLprInferRequestsAcquired = std::min(plateRects.size(), platesInfers.inferRequests.container.size());
-        reservedLprRequests.assign(platesInfers.inferRequests.container.end() - numberOfLprInferRequestsAcquired, platesInfers.inferRequests.container.end());
-        platesInfers.inferRequests.container.erase(platesInfers.inferRequests.container.end() - numberOfLprInferRequestsAcquired,
-                                                   platesInfers.inferRequests.container.end());
-        platesInfers.inferRequests.mutex.unlock();
-        return numberOfAttributesInferRequestsAcquired || numberOfLprInferRequestsAcquired;
+        // acquire as many InferRequests as it is possible or needed, a request classifies a batch of rects
+        const std::size_t attributesBatchSize = context.detectionsProcessorsContext.vehicleAttributesClassifier.getBatchSize();
+        const std::size_t lprBatchSize = context.detectionsProcessorsContext.lpr.getBatchSize();
+        ov::InferRequest* request;
+        while (reservedAttributesRequests.size() * attributesBatchSize < vehicleRects.size()
+                && context.attributesInfers.inferRequests.tryPop(request)) {
+            reservedAttributesRequests.emplace_back(*request);
+        }
+        while (reservedLprRequests.size() * lprBatchSize < plateRects.size() && context.platesInfers.inferRequests.tryPop(request)) {
+            reservedLprRequests.emplace_back(*request);
+        }
+        return !reservedAttributesRequests.empty() || !reservedLprRequests.empty();
     }
 }
 
 void DetectionsProcessor::process() {
     Context& context = static_cast<ReborningVideoFrame*>(sharedVideoFrame.get())->context;
     if (!FLAGS_m_va.empty()) {
+        VehicleAttributesClassifier& vehicleAttributesClassifier = context.detectionsProcessorsContext.vehicleAttributesClassifier;
         auto vehicleRectsIt = vehicleRects.begin();
-        for (auto attributesRequestIt = reservedAttributesRequests.begin(); attributesRequestIt != reservedAttributesRequests.end();
-                vehicleRectsIt++, attributesRequestIt++) {
-            const cv::Rect vehicleRect = *vehicleRectsIt;
-            ov::InferRequest& attributesRequest = *attributesRequestIt;
-            context.detectionsProcessorsContext.vehicleAttributesClassifier.setImage(attributesRequest, sharedVideoFrame->frame, vehicleRect);
+        auto vehicleTrackIdsIt = vehicleTrackIds.begin();
+        for (ov::InferRequest& attributesRequest : reservedAttributesRequests) {
+            std::vector<cv::Rect> batchRects;
+            std::vector<uint64_t> batchTrackIds;
+            for (; vehicleRects.end() != vehicleRectsIt && batchRects.size() < vehicleAttributesClassifier.getBatchSize();
+                    vehicleRectsIt++, vehicleTrackIdsIt++) {
+                vehicleAttributesClassifier.setImage(attributesRequest, sharedVideoFrame->frame, *vehicleRectsIt, batchRects.size());
+                batchRects.push_back(*vehicleRectsIt);
+                batchTrackIds.push_back(*vehicleTrackIdsIt);
+            }
 
             attributesRequest.set_callback(
                 std::bind(
                     [](std::shared_ptr<ClassifiersAggregator> classifiersAggregator,
                         ov::InferRequest& attributesRequest,
-                        cv::Rect rect,
+                        const std::vector<cv::Rect>& batchRects,
+                        const std::vector<uint64_t>& batchTrackIds,
                         Context& context) {
-                            attributesRequest.set_callback([](std::exception_ptr) {}); // destroy the stored bind object
-
-                            const std::pair<std::string, std::string>& attributes =
-                                context.detectionsProcessorsContext.vehicleAttributesClassifier.getResults(attributesRequest);
-
-                            if (FLAGS_r && ((classifiersAggregator->sharedVideoFrame->frameId == 0 && !context.isVideo) || context.isVideo)) {
-                                classifiersAggregator->rawAttributes.lockedPushBack(
-                                    "Vehicle Attributes results:" + attributes.first + ';' + attributes.second);
+                            // scatter the results of the batch back to the rects
+                            for (std::size_t i = 0; i < batchRects.size(); i++) {
+                                const std::pair<std::string, std::string>& attributes =
+                                    context.detectionsProcessorsContext.vehicleAttributesClassifier.getResults(attributesRequest, i);
+
+                                if (FLAGS_r && ((classifiersAggregator->sharedVideoFrame->frameId == 0 && !context.isVideo) || context.isVideo)) {
+                                    classifiersAggregator->rawAttributes.lockedPushBack(
+                                        "Vehicle Attributes results:" + attributes.first + ';' + attributes.second);
+                                }
+                                classifiersAggregator->push(BboxAndDescr{BboxAndDescr::ObjectType::VEHICLE, batchRects[i],
+                                    updateTrack(context, classifiersAggregator->sharedVideoFrame->sourceID, false, batchTrackIds[i],
+                                        attributes.first + ' ' + attributes.second)});
                             }
-                            classifiersAggregator->push(
-                                BboxAndDescr{BboxAndDescr::ObjectType::VEHICLE, rect, attributes.first + ' ' + attributes.second});
-                            context.attributesInfers.inferRequests.lockedPushBack(attributesRequest);
+                            attributesRequest.set_callback([](std::exception_ptr) {}); // destroy the stored bind object
+                            context.attributesInfers.inferRequests.tryPush(&attributesRequest);
                         }, classifiersAggregator,
                            std::ref(attributesRequest),
-                           vehicleRect,
+                           std::move(batchRects),
+                           std::move(batchTrackIds),
                            std::ref(context)));
             attributesRequest.start_async();
         }
         vehicleRects.erase(vehicleRects.begin(), vehicleRectsIt);
+        vehicleTrackIds.erase(vehicleTrackIds.begin(), vehicleTrackIdsIt);
     } else {
         for (const cv::Rect vehicleRect : vehicleRects) {
             classifiersAggregator->push(BboxAndDescr{BboxAndDescr::ObjectType::NONE, vehicleRect, ""});
         }
         vehicleRects.clear();
+        vehicleTrackIds.clear();
     }
 
     if (!FLAGS_m_lpr.empty()) {
+        Lpr& lpr = context.detectionsProcessorsContext.lpr;
         auto plateRectsIt = plateRects.begin();
-        for (auto lprRequestsIt = reservedLprRequests.begin(); lprRequestsIt != reservedLprRequests.end(); plateRectsIt++, lprRequestsIt++) {
-            const cv::Rect plateRect = *plateRectsIt;
-            ov::InferRequest& lprRequest = *lprRequestsIt;
-            context.detectionsProcessorsContext.lpr.setImage(lprRequest, sharedVideoFrame->frame, plateRect);
+        auto plateTrackIdsIt = plateTrackIds.begin();
+        for (ov::InferRequest& lprRequest : reservedLprRequests) {
+            std::vector<cv::Rect> batchRects;
+            std::vector<uint64_t> batchTrackIds;
+            for (; plateRects.end() != plateRectsIt && batchRects.size() < lpr.getBatchSize(); plateRectsIt++, plateTrackIdsIt++) {
+                lpr.setImage(lprRequest, sharedVideoFrame->frame, *plateRectsIt, batchRects.size());
+                batchRects.push_back(*plateRectsIt);
+                batchTrackIds.push_back(*plateTrackIdsIt);
+            }
 
             lprRequest.set_callback(
                 std::bind(
                     [](std::shared_ptr<ClassifiersAggregator> classifiersAggregator,
                         ov::InferRequest& lprRequest,
-                        cv::Rect rect,
+                        const std::vector<cv::Rect>& batchRects,
+                        const std::vector<uint64_t>& batchTrackIds,
                         Context& context) {
-                            lprRequest.set_callback([](std::exception_ptr) {}); // destroy the stored bind object
-
-                            std::string result = context.detectionsProcessorsContext.lpr.getResults(lprRequest);
-
-                            if (FLAGS_r && ((classifiersAggregator->sharedVideoFrame->frameId == 0 && !context.isVideo) || context.isVideo)) {
-                                classifiersAggregator->rawDecodedPlates.lockedPushBack("License Plate Recognition results:" + result);
+                            for (std::size_t i = 0; i < batchRects.size(); i++) {
+                                std::string result = context.detectionsProcessorsContext.lpr.getResults(lprRequest, i);
+
+                                if (FLAGS_r && ((classifiersAggregator->sharedVideoFrame->frameId == 0 && !context.isVideo) || context.isVideo)) {
+                                    classifiersAggregator->rawDecodedPlates.lockedPushBack("License Plate Recognition results:" + result);
+                                }
+                                classifiersAggregator->push(BboxAndDescr{BboxAndDescr::ObjectType::PLATE, batchRects[i],
+                                    updateTrack(context, classifiersAggregator->sharedVideoFrame->sourceID, true, batchTrackIds[i],
+                                        std::move(result))});
                             }
-                            classifiersAggregator->push(BboxAndDescr{BboxAndDescr::ObjectType::PLATE, rect, std::move(result)});
-                            context.platesInfers.inferRequests.lockedPushBack(lprRequest);
+                            lprRequest.set_callback([](std::exception_ptr) {}); // destroy the stored bind object
+                            context.platesInfers.inferRequests.tryPush(&lprRequest);
                         }, classifiersAggregator,
                            std::ref(lprRequest),
-                           plateRect,
+                           std::move(batchRects),
+                           std::move(batchTrackIds),
                            std::ref(context)));
 
             lprRequest.start_async();
         }
         plateRects.erase(plateRects.begin(), plateRectsIt);
+        plateTrackIds.erase(plateTrackIds.begin(), plateTrackIdsIt);
     } else {
         for (const cv::Rect& plateRect : plateRects) {
             classifiersAggregator->push(BboxAndDescr{BboxAndDescr::ObjectType::NONE, plateRect, ""});
         }
         plateRects.clear();
+        plateTrackIds.clear();
     }
     if (!vehicleRects.empty() || !plateRects.empty()) {
         tryPush(context.detectionsProcessorsContext.detectionsProcessorsWorker,
-            std::make_shared<DetectionsProcessor>(sharedVideoFrame, std::move(classifiersAggregator), std::move(vehicleRects), std::move(plateRects)));
+            std::make_shared<DetectionsProcessor>(sharedVideoFrame, std::move(classifiersAggregator), std::move(vehicleRects), std::move(plateRects),
+                std::move(vehicleTrackIds), std::move(plateTrackIds)));
     }
 }
 
 bool InferTask::isReady() {
     InferRequestsContainer& detectorsInfers = static_cast<ReborningVideoFrame*>(sharedVideoFrame.get())->context.detectorsInfers;
-    if (detectorsInfers.inferRequests.container.empty()) {
-        return false;
-    } else {
-        detectorsInfers.inferRequests.mutex.lock();
-        if (detectorsInfers.inferRequests.container.empty()) {
-            detectorsInfers.inferRequests.mutex.unlock();
-            return false;
-        } else {
-            return true;  // process() will unlock the mutex
-        }
-    }
+    return detectorsInfers.inferRequests.tryPop(reservedRequest);  // process() starts the reserved InferRequest
 }
 
 void InferTask::process() {
     Context& context = static_cast<ReborningVideoFrame*>(sharedVideoFrame.get())->context;
-    InferRequestsContainer& detectorsInfers = context.detectorsInfers;
-    std::reference_wrapper<ov::InferRequest> inferRequest = detectorsInfers.inferRequests.container.back();
-    detectorsInfers.inferRequests.container.pop_back();
-    detectorsInfers.inferRequests.mutex.unlock();
+    std::reference_wrapper<ov::InferRequest> inferRequest = *reservedRequest;
 
-    context.inferTasksContext.detector.setImage(inferRequest, sharedVideoFrame->frame);
+    context.inferTasksContext.detector.setImage(inferRequest, sharedVideoFrame->frame, detectionRoi(context, *sharedVideoFrame));
 
     inferRequest.get().set_callback(
         std::bind(
@@ -621,9 +878,20 @@ void Reader::process() {
     Context& context = static_cast<ReborningVideoFrame*>(sharedVideoFrame.get())->context;
     const std::vector<std::shared_ptr<InputChannel>>& inputChannels = context.readersContext.inputChannels;
     if (inputChannels[sourceID]->read(sharedVideoFrame->frame)) {
+        // the frames of the channel are compared in order because the next frame can't be read yet
+        const bool skipDetection = 0 != context.motionContext.threshold && isStatic(context, *sharedVideoFrame);
         context.readersContext.lastCapturedFrameIds[sourceID]++;
         context.readersContext.lastCapturedFrameIdsMutexes[sourceID].unlock();
-        tryPush(context.inferTasksContext.inferTasksWorker, std::make_shared<InferTask>(sharedVideoFrame));
+        if (skipDetection) {
+            std::list<BboxAndDescr> lastResults;
+            {
+                std::lock_guard<std::mutex> lock{context.motionContext.lastResultsMutexes[sourceID]};
+                lastResults = context.motionContext.lastResults[sourceID];
+            }
+            tryPush(context.resAggregatorsWorker, std::make_shared<ResAggregator>(sharedVideoFrame, std::move(lastResults)));
+        } else {
+            tryPush(context.inferTasksContext.inferTasksWorker, std::make_shared<InferTask>(sharedVideoFrame));
+        }
     } else {
         context.readersContext.lastCapturedFrameIds[sourceID]++;
         context.readersContext.lastCapturedFrameIdsMutexes[sourceID].unlock();
@@ -635,6 +903,7 @@ void Reader::process() {
 
 int main(int argc, char* argv[]) {
     try {
+        StartupProfiler startupProfiler;
         // Parsing and validation of input args
         try {
             if (!ParseAndCheckCommandLine(argc, argv)) {
@@ -650,6 +919,7 @@ int main(int argc, char* argv[]) {
         if (files.empty() && 0 == FLAGS_nc)
             throw std::logic_error("No inputs were found");
 
+        std::unique_ptr<StartupProfiler::Phase> phase(new StartupProfiler::Phase(startupProfiler, "Opening the inputs"));
         std::vector<std::shared_ptr<VideoCaptureSource>> videoCapturSourcess;
         std::vector<std::shared_ptr<ImageSource>> imageSourcess;
 
@@ -699,6 +969,8 @@ int main(int argc, char* argv[]) {
             inputChannels.push_back(InputChannel::create(inputSources[channelI]));
         }
 
+        phase.reset();
+
         // Load OpenVINO Runtime
         slog::info << ov::get_openvino_version() << slog::endl;
         ov::Core core;
@@ -748,6 +1020,7 @@ int main(int argc, char* argv[]) {
 
         unsigned nireq = FLAGS_nireq == 0 ? inputChannels.size() : FLAGS_nireq;
 
+        phase.reset(new StartupProfiler::Phase(startupProfiler, "Loading Vehicle and License Plate Detection"));
         Detector detector(core, FLAGS_d, FLAGS_m,
             {static_cast<float>(FLAGS_t), static_cast<float>(FLAGS_t)}, FLAGS_auto_resize, makeTagConfig(FLAGS_d, "Detect"));
         slog::info << "\tNumber of network inference requests: " << nireq << slog::endl;
@@ -759,7 +1032,9 @@ int main(int argc, char* argv[]) {
         std::size_t nrecognizersireq{0};
 
         if (!FLAGS_m_va.empty()) {
-            vehicleAttributesClassifier = VehicleAttributesClassifier(core, FLAGS_d_va, FLAGS_m_va, FLAGS_auto_resize, makeTagConfig(FLAGS_d_va, "Attr"));
+            phase.reset(new StartupProfiler::Phase(startupProfiler, "Loading Vehicle Attributes Recognition"));
+            vehicleAttributesClassifier = VehicleAttributesClassifier(core, FLAGS_d_va, FLAGS_m_va, FLAGS_auto_resize, makeTagConfig(FLAGS_d_va, "Attr"),
+                FLAGS_bs);
             nclassifiersireq = nireq * 3;
             slog::info << "\tNumber of network inference requests: " << nclassifiersireq << slog::endl;
         } else {
@@ -767,12 +1042,14 @@ int main(int argc, char* argv[]) {
         }
 
         if (!FLAGS_m_lpr.empty()) {
-            lpr = Lpr(core, FLAGS_d_lpr, FLAGS_m_lpr, FLAGS_auto_resize, makeTagConfig(FLAGS_d_lpr, "LPR"));
+            phase.reset(new StartupProfiler::Phase(startupProfiler, "Loading License Plate Recognition"));
+            lpr = Lpr(core, FLAGS_d_lpr, FLAGS_m_lpr, FLAGS_auto_resize, makeTagConfig(FLAGS_d_lpr, "LPR"), FLAGS_bs);
             nrecognizersireq = nireq * 3;
             slog::info << "\tNumber of network inference requests: " << nrecognizersireq << slog::endl;
         } else {
             slog::info << "License Plate Recognition DISABLED." << slog::endl;
         }
+        phase.reset();
 
         bool isVideo = imageSourcess.empty() ? true : false;
         int pause = imageSourcess.empty() ? 1 : 0;
@@ -794,7 +1071,9 @@ int main(int argc, char* argv[]) {
                         FLAGS_n_iqs - 1,
                         nireq,
                         isVideo,
-                        nclassifiersireq, nrecognizersireq};
+                        nclassifiersireq, nrecognizersireq,
+                        parseRois(FLAGS_roi, inputChannels.size()), FLAGS_motion_thr, FLAGS_stable_reads,
+                        startupProfiler};
         // Create a worker after a context because the context has only weak_ptr<Worker>, but the worker is going to
         // indirectly store ReborningVideoFrames which have a reference to the context. So there won't be a situation
         // when the context is destroyed and the worker still lives with its ReborningVideoFrames referring to the
@@ -805,18 +1084,38 @@ int main(int argc, char* argv[]) {
         context.detectionsProcessorsContext.detectionsProcessorsWorker = worker;
         context.drawersContext.drawersWorker = worker;
         context.resAggregatorsWorker = worker;
+        context.detectorsInfers.inferRequests.setWorker(worker);
+        context.attributesInfers.inferRequests.setWorker(worker);
+        context.platesInfers.inferRequests.setWorker(worker);
 
         for (uint64_t i = 0; i < FLAGS_n_iqs; i++) {
             for (unsigned sourceID = 0; sourceID < inputChannels.size(); sourceID++) {
-                VideoFrame::Ptr sharedVideoFrame = std::make_shared<ReborningVideoFrame>(context, sourceID, i);
-                worker->push(std::make_shared<Reader>(sharedVideoFrame));
+                VideoFrame::Ptr sharedVideoFrame = std::allocate_shared<ReborningVideoFrame>(
+                    PoolAllocator<ReborningVideoFrame>(context.framesPool), context, sourceID, i);
+                worker->push(std::allocate_shared<Reader>(PoolAllocator<Reader>(context.readersPool), sharedVideoFrame));
             }
         }
 
+        if (0 != FLAGS_max_queued) {
+            worker->setLimits(typeid(InferTask), {0, FLAGS_max_queued});
+            worker->setLimits(typeid(DetectionsProcessor), {0, FLAGS_max_queued});
+            worker->setProducer(typeid(Reader));
+        }
+
         // Running
+        if (!FLAGS_trace.empty()) {
+            worker->enableTracing(1 << 16);
+        }
         worker->runThreads();
         worker->threadFunc();
         worker->join();
+        if (!FLAGS_trace.empty()) {
+            std::ofstream traceFile(FLAGS_trace);
+            worker->writeTrace(traceFile);
+            if (!traceFile) {
+                throw std::runtime_error("Can't write the trace to " + FLAGS_trace);
+            }
+        }
 
         uint32_t frameCounter = context.frameCounter;
         double detectionsInfersUsage = 0;
@@ -828,6 +1127,16 @@ int main(int argc, char* argv[]) {
         slog::info << "Metrics report:" << slog::endl;
         context.metrics.logTotal();
         slog::info << "\tDetection InferRequests usage: " << detectionsInfersUsage << "%" << slog::endl;
+        if (0 != FLAGS_stable_reads && (!FLAGS_m_va.empty() || !FLAGS_m_lpr.empty())) {
+            slog::info << "\tRecognitions: " << context.tracksContext.recognized << " run, "
+                << context.tracksContext.reused << " reused from tracks" << slog::endl;
+        }
+        for (const Worker::TaskClassStats& taskStats : worker->getStats()) {
+            slog::info << "\t" << taskStats.name << " tasks: " << taskStats.processed << " processed, max queue depth "
+                << taskStats.maxQueued << ", mean wait time: " << std::fixed << std::setprecision(1)
+                << std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(taskStats.meanWaitTime).count()
+                << " ms" << slog::endl;
+        }
         slog::info << context.drawersContext.presenter.reportMeans() << slog::endl;
     } catch (const std::exception& error) {
         slog::err << error.what() << slog::endl;
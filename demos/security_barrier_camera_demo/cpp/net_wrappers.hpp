@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <cassert>
 #include <list>
 #include <map>
 #include <string>
@@ -15,6 +16,12 @@
 #include "utils/common.hpp"
 #include "utils/ocv_common.hpp"
 
+// Returns the view of the batchIdx-th image of NHWC tensor
+static inline ov::Tensor batchItem(const ov::Tensor& tensor, size_t batchIdx) {
+    const ov::Shape& shape = tensor.get_shape();
+    return ov::Tensor(tensor, {batchIdx, 0, 0, 0}, {batchIdx + 1, shape[1], shape[2], shape[3]});
+}
+
 class Detector {
 public:
     struct Result {
@@ -104,24 +111,30 @@ public:
         return m_compiled_model.create_infer_request();
     }
 
-    void setImage(ov::InferRequest& inferRequest, const cv::Mat& img) {
+    // Only the roi part of img is detected, the results are mapped back to img by getResults()
+    void setImage(ov::InferRequest& inferRequest, const cv::Mat& img, const cv::Rect& roi) {
         ov::Tensor inputTensor = inferRequest.get_tensor(m_detectorInputName);
         ov::Shape shape = inputTensor.get_shape();
+        const cv::Mat crop = img(roi);
         if (m_autoResize) {
-            if (!img.isSubmatrix()) {
+            if (!crop.isSubmatrix()) {
                 // just wrap Mat object with Tensor without additional memory allocation
-                ov::Tensor frameTensor = wrapMat2Tensor(img);
+                ov::Tensor frameTensor = wrapMat2Tensor(crop);
                 inferRequest.set_tensor(m_detectorInputName, frameTensor);
             } else {
-                throw std::logic_error("Sparse matrix are not supported");
+                // the crop isn't continuous, so it is copied to a tensor owning its memory
+                ov::Tensor roiTensor{ov::element::u8, {1, static_cast<size_t>(crop.rows), static_cast<size_t>(crop.cols),
+                    static_cast<size_t>(crop.channels())}};
+                crop.copyTo(cv::Mat{crop.size(), crop.type(), roiTensor.data()});
+                inferRequest.set_tensor(m_detectorInputName, roiTensor);
             }
         } else {
             // resize and copy data from image to tensor using OpenCV
-            resize2tensor(img, inputTensor);
+            resize2tensor(crop, inputTensor);
         }
     }
 
-    std::list<Result> getResults(ov::InferRequest& inferRequest, cv::Size upscale, std::vector<std::string>& rawResults) {
+    std::list<Result> getResults(ov::InferRequest& inferRequest, const cv::Rect& roi, std::vector<std::string>& rawResults) {
         // there is no big difference if InferReq of detector from another device is passed
         // because the processing is the same for the same topology
         std::list<Result> results;
@@ -140,10 +153,11 @@ public:
             }
 
             cv::Rect rect;
-            rect.x = static_cast<int>(detections[i * objectSize + 3] * upscale.width);
-            rect.y = static_cast<int>(detections[i * objectSize + 4] * upscale.height);
-            rect.width = static_cast<int>(detections[i * objectSize + 5] * upscale.width) - rect.x;
-            rect.height = static_cast<int>(detections[i * objectSize + 6] * upscale.height) - rect.y;
+            rect.x = static_cast<int>(detections[i * objectSize + 3] * roi.width);
+            rect.y = static_cast<int>(detections[i * objectSize + 4] * roi.height);
+            rect.width = static_cast<int>(detections[i * objectSize + 5] * roi.width) - rect.x;
+            rect.height = static_cast<int>(detections[i * objectSize + 6] * roi.height) - rect.y;
+            rect += roi.tl();
             results.push_back(Result{label, confidence, rect});
             std::ostringstream rawResultsStream;
             rawResultsStream << "[" << i << "," << label << "] element, prob = " << confidence
@@ -165,8 +179,8 @@ class VehicleAttributesClassifier {
 public:
     VehicleAttributesClassifier() = default;
     VehicleAttributesClassifier(ov::Core& core, const std::string& deviceName,
-        const std::string& xmlPath, const bool autoResize, const ov::AnyMap& pluginConfig) :
-        m_autoResize(autoResize) {
+        const std::string& xmlPath, const bool autoResize, const ov::AnyMap& pluginConfig, size_t batchSize = 1) :
+        m_autoResize(autoResize), m_batchSize(batchSize) {
         slog::info << "Reading model: " << xmlPath << slog::endl;
         std::shared_ptr<ov::Model> model = core.read_model(xmlPath);
         logBasicModelInfo(model);
@@ -216,6 +230,10 @@ public:
         inputModelInfo.set_layout(modelLayout);
 
         model = ppp.build();
+        if (m_batchSize > 1) {
+            // every crop is resized to the input size, so crops of a frame are classified by one request
+            ov::set_batch(model, m_batchSize);
+        }
 
         slog::info << "Preprocessor configuration: " << slog::endl;
         slog::info << ppp << slog::endl;
@@ -228,9 +246,14 @@ public:
         return m_compiled_model.create_infer_request();
     }
 
-    void setImage(ov::InferRequest& inferRequest, const cv::Mat& img, const cv::Rect vehicleRect) {
+    size_t getBatchSize() const {
+        return m_batchSize;
+    }
+
+    void setImage(ov::InferRequest& inferRequest, const cv::Mat& img, const cv::Rect vehicleRect, size_t batchIdx = 0) {
         ov::Tensor inputTensor = inferRequest.get_tensor(m_attributesInputName);
         ov::Shape shape = inputTensor.get_shape();
+        assert(batchIdx < m_batchSize);
         if (m_autoResize) {
             ov::Tensor frameTensor = wrapMat2Tensor(img);
             ov::Coordinate p00({ 0, (size_t)vehicleRect.y, (size_t)vehicleRect.x, 0 });
@@ -240,11 +263,11 @@ public:
             inferRequest.set_tensor(m_attributesInputName, roiTensor);
         } else {
             const cv::Mat& vehicleImage = img(vehicleRect);
-            resize2tensor(vehicleImage, inputTensor);
+            resize2tensor(vehicleImage, batchItem(inputTensor, batchIdx));
         }
     }
 
-    std::pair<std::string, std::string> getResults(ov::InferRequest& inferRequest) {
+    std::pair<std::string, std::string> getResults(ov::InferRequest& inferRequest, size_t batchIdx = 0) {
         static const std::string colors[] = {
             "white", "gray", "yellow", "red", "green", "blue", "black"
         };
@@ -254,11 +277,11 @@ public:
 
         // 7 possible colors for each vehicle and we should select the one with the maximum probability
         ov::Tensor colorsTensor = inferRequest.get_tensor(m_outputNameForColor);
-        const float* colorsValues = colorsTensor.data<float>();
+        const float* colorsValues = colorsTensor.data<float>() + batchIdx * 7;
 
         // 4 possible types for each vehicle and we should select the one with the maximum probability
         ov::Tensor typesTensor = inferRequest.get_tensor(m_outputNameForType);
-        const float* typesValues = typesTensor.data<float>();
+        const float* typesValues = typesTensor.data<float>() + batchIdx * 4;
 
         const auto color_id = std::max_element(colorsValues, colorsValues + 7) - colorsValues;
         const auto  type_id = std::max_element(typesValues,  typesValues  + 4) - typesValues;
@@ -268,6 +291,7 @@ public:
 
 private:
     bool m_autoResize;
+    size_t m_batchSize = 1;
     std::string m_attributesInputName;
     std::string m_outputNameForColor;
     std::string m_outputNameForType;
@@ -278,8 +302,8 @@ class Lpr {
 public:
     Lpr() = default;
     Lpr(ov::Core& core, const std::string& deviceName, const std::string& xmlPath, const bool autoResize,
-        const ov::AnyMap& pluginConfig) :
-        m_autoResize(autoResize) {
+        const ov::AnyMap& pluginConfig, size_t batchSize = 1) :
+        m_autoResize(autoResize), m_batchSize(batchSize) {
         slog::info << "Reading model: " << xmlPath << slog::endl;
         std::shared_ptr<ov::Model> model = core.read_model(xmlPath);
         logBasicModelInfo(model);
@@ -350,6 +374,13 @@ public:
         inputModelInfo.set_layout(m_modelLayout);
 
         model = ppp.build();
+        if (m_batchSize > 1 && !m_LprInputSeqName.empty()) {
+            slog::warn << "License Plate Recognition model with the sequence input doesn't support batching" << slog::endl;
+            m_batchSize = 1;
+        }
+        if (m_batchSize > 1) {
+            ov::set_batch(model, m_batchSize);
+        }
 
         slog::info << "Preprocessor configuration: " << slog::endl;
         slog::info << ppp << slog::endl;
@@ -362,9 +393,14 @@ public:
         return m_compiled_model.create_infer_request();
     }
 
-    void setImage(ov::InferRequest& inferRequest, const cv::Mat& img, const cv::Rect plateRect) {
+    size_t getBatchSize() const {
+        return m_batchSize;
+    }
+
+    void setImage(ov::InferRequest& inferRequest, const cv::Mat& img, const cv::Rect plateRect, size_t batchIdx = 0) {
         ov::Tensor inputTensor = inferRequest.get_tensor(m_LprInputName);
         ov::Shape shape = inputTensor.get_shape();
+        assert(batchIdx < m_batchSize);
         if ((shape.size() == 4) && m_autoResize) {
             // autoResize is set
             ov::Tensor frameTensor = wrapMat2Tensor(img);
@@ -374,7 +410,7 @@ public:
             inferRequest.set_tensor(m_LprInputName, roiTensor);
         } else {
             const cv::Mat& vehicleImage = img(plateRect);
-            resize2tensor(vehicleImage, inputTensor);
+            resize2tensor(vehicleImage, batchItem(inputTensor, batchIdx));
         }
 
         if (m_LprInputSeqName != "") {
@@ -384,7 +420,7 @@ public:
         }
     }
 
-    std::string getResults(ov::InferRequest& inferRequest) {
+    std::string getResults(ov::InferRequest& inferRequest, size_t batchIdx = 0) {
         static const char* const items[] = {
                 "0", "1", "2", "3", "4", "5", "6", "7", "8", "9",
                 "<Anhui>", "<Beijing>", "<Chongqing>", "<Fujian>",
@@ -410,7 +446,7 @@ public:
         switch (precision) {
             case ov::element::i32:
             {
-                const auto data = lprOutputTensor.data<int32_t>();
+                const auto data = lprOutputTensor.data<int32_t>() + batchIdx * m_maxSequenceSizePerPlate;
                 for (int i = 0; i < m_maxSequenceSizePerPlate; i++) {
                     int32_t val = data[i];
                     if (val == -1) {
@@ -423,7 +459,7 @@ public:
 
             case ov::element::f32:
             {
-                const auto data = lprOutputTensor.data<float>();
+                const auto data = lprOutputTensor.data<float>() + batchIdx * m_maxSequenceSizePerPlate;
                 for (int i = 0; i < m_maxSequenceSizePerPlate; i++) {
                     int32_t val = int32_t(data[i]);
                     if (val == -1) {
@@ -443,6 +479,7 @@ public:
 
 private:
     bool m_autoResize;
+    size_t m_batchSize = 1;
     int m_maxSequenceSizePerPlate = 0;
     std::string m_LprInputName;
     std::string m_LprInputSeqName;
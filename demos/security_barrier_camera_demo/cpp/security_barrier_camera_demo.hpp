@@ -49,7 +49,22 @@ static const char infer_num_threads_message[] = "Optional. Number of threads to
                                                 "(including HETERO and MULTI cases).";
 static const char infer_num_streams_message[] = "Optional. Number of streams to use for inference on the CPU or/and GPU in throughput mode "
                                                 "(for HETERO and MULTI device cases use format <device1>:<nstreams1>,<device2>:<nstreams2> or just <nstreams>)";
+static const char batch_size_message[] = "Optional. Batch size of Vehicle Attributes and License Plate Recognition infer requests. "
+                                         "Up to this number of crops of a frame are classified by one infer request.";
 static const char utilization_monitors_message[] = "Optional. List of monitors to show initially.";
+static const char max_queued_message[] = "Optional. Maximum number of queued inference tasks of each kind. Frames aren't read while a queue "
+                                         "is full. 0 removes the limit.";
+static const char roi_message[] = "Optional. Regions of interest of the channels in pixels, \"<x>,<y>,<width>,<height>\" separated by "
+                                  "';'. The detector runs on the region only. One region applies to every channel. Not set "
+                                  "means the whole frame.";
+static const char motion_thr_message[] = "Optional. Mean absolute difference in gray levels between the region of interest of a frame "
+                                         "and of the last detected frame of the channel below which the detector is skipped and the "
+                                         "previous results are drawn. 0 runs the detector on every frame.";
+static const char stable_reads_message[] = "Optional. Number of equal reads in a row after which the plate and the attributes "
+                                           "of a vehicle tracked across frames are reused instead of being recognized again. They are "
+                                           "recognized again once the crop gets notably larger or sharper. 0 recognizes every detection.";
+static const char trace_message[] = "Optional. Path to a file to write the timeline of the Worker tasks to at exit. "
+                                    "The file is in Chrome Trace Event format which chrome://tracing and Perfetto open.";
 
 DEFINE_bool(h, false, help_message);
 DEFINE_string(i, "", video_message);
@@ -74,7 +89,13 @@ DEFINE_string(display_resolution, "1920x1080", display_resolution_message);
 DEFINE_bool(tag, false, use_tag_scheduler_message);
 DEFINE_uint32(nthreads, 0, infer_num_threads_message);
 DEFINE_string(nstreams, "", infer_num_streams_message);
+DEFINE_uint32(bs, 1, batch_size_message);
 DEFINE_string(u, "", utilization_monitors_message);
+DEFINE_uint32(max_queued, 0, max_queued_message);
+DEFINE_string(roi, "", roi_message);
+DEFINE_double(motion_thr, 0.0, motion_thr_message);
+DEFINE_uint32(stable_reads, 3, stable_reads_message);
+DEFINE_string(trace, "", trace_message);
 
 /**
 * \brief This function show a help message
@@ -107,5 +128,11 @@ void showUsage() {
     std::cout << "    -tag                       " << use_tag_scheduler_message << std::endl;
     std::cout << "    -nstreams \"<integer>\"      " << infer_num_streams_message << std::endl;
     std::cout << "    -nthreads \"<integer>\"      " << infer_num_threads_message << std::endl;
+    std::cout << "    -bs                        " << batch_size_message << std::endl;
     std::cout << "    -u                         " << utilization_monitors_message << std::endl;
+    std::cout << "    -max_queued                " << max_queued_message << std::endl;
+    std::cout << "    -roi \"<regions>\"           " << roi_message << std::endl;
+    std::cout << "    -motion_thr                " << motion_thr_message << std::endl;
+    std::cout << "    -stable_reads              " << stable_reads_message << std::endl;
+    std::cout << "    -trace \"<path>\"            " << trace_message << std::endl;
 }
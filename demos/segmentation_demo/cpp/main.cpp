@@ -18,6 +18,7 @@
 #include <stdint.h>
 
 #include <chrono>
+#include <cmath>
 #include <exception>
 #include <initializer_list>
 #include <iomanip>
@@ -26,6 +27,7 @@
 #include <random>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <gflags/gflags.h>
@@ -45,12 +47,24 @@
 #include <utils/config_factory.h>
 #include <utils/default_flags.hpp>
 #include <utils/images_capture.h>
+#include <utils/itt.hpp>
+#include <utils/memory_accounting.hpp>
+#include <utils/metrics_sink.hpp>
 #include <utils/ocv_common.hpp>
 #include <utils/performance_metrics.hpp>
 #include <utils/slog.hpp>
 
 DEFINE_INPUT_FLAGS
 DEFINE_OUTPUT_FLAGS
+DEFINE_METRICS_FLAGS
+DEFINE_INPUTS_MEMORY_FLAGS
+DEFINE_DEVICE_PREPROCESSING_FLAGS
+DEFINE_MOTION_GATE_FLAGS
+DEFINE_TUNING_FLAGS
+DEFINE_WARMUP_FLAGS
+DEFINE_LAYERS_PROFILE_FLAGS
+DEFINE_REMOTE_FLAGS
+DEFINE_HALF_PRECISION_OUTPUTS_FLAGS
 
 static const char help_message[] = "Print a usage message.";
 static const char model_message[] = "Required. Path to an .xml file with a trained model.";
@@ -76,6 +90,8 @@ static const char output_resolution_message[] =
     "Optional. Specify the maximum output window resolution "
     "in (width x height) format. Example: 1280x720. Input frame size used by default.";
 static const char only_masks_message[] = "Optional. Display only masks. Could be switched by TAB key.";
+static const char postprocess_on_device_message[] = "Optional. Compute the class map on the inference device, so a "
+    "single u8 channel is transferred instead of probabilities of all classes.";
 
 DEFINE_bool(h, false, help_message);
 DEFINE_string(m, "", model_message);
@@ -91,6 +107,7 @@ DEFINE_bool(no_show, false, no_show_message);
 DEFINE_string(u, "", utilization_monitors_message);
 DEFINE_string(output_resolution, "", output_resolution_message);
 DEFINE_bool(only_masks, false, only_masks_message);
+DEFINE_bool(postprocess_on_device, false, postprocess_on_device_message);
 
 /**
  * \brief This function shows a help message
@@ -111,13 +128,26 @@ static void showUsage() {
     std::cout << "    -r                        " << raw_output_message << std::endl;
     std::cout << "    -nireq \"<integer>\"        " << nireq_message << std::endl;
     std::cout << "    -auto_resize              " << input_resizable_message << std::endl;
+    std::cout << "    -inputs_memory \"<string>\" " << inputs_memory_message << std::endl;
+    std::cout << "    -preprocess_on_device     " << preprocess_on_device_message << std::endl;
     std::cout << "    -nthreads \"<integer>\"     " << num_threads_message << std::endl;
     std::cout << "    -nstreams                 " << num_streams_message << std::endl;
     std::cout << "    -loop                     " << loop_message << std::endl;
     std::cout << "    -no_show                  " << no_show_message << std::endl;
     std::cout << "    -output_resolution        " << output_resolution_message << std::endl;
     std::cout << "    -u                        " << utilization_monitors_message << std::endl;
+    std::cout << "    -metrics_file \"<path>\"    " << metrics_file_message << std::endl;
+    std::cout << "    -motion_gate \"<double>\"   " << motion_gate_message << std::endl;
+    std::cout << "    -motion_gate_max_skip     " << motion_gate_max_skip_message << std::endl;
+    std::cout << "    -tune \"<objective>\"       " << tune_message << std::endl;
+    std::cout << "    -tune_latency \"<double>\"  " << tune_latency_message << std::endl;
+    std::cout << "    -tune_cache \"<path>\"      " << tune_cache_message << std::endl;
+    std::cout << "    -warmup \"<integer>\"     " << warmup_message << std::endl;
+    std::cout << "    -profile_layers \"<integer>\" " << profile_layers_message << std::endl;
+    std::cout << "    -remote \"<host:port>\"   " << remote_message << std::endl;
     std::cout << "    -only_masks               " << only_masks_message << std::endl;
+    std::cout << "    -postprocess_on_device    " << postprocess_on_device_message << std::endl;
+    std::cout << "    -fp16_outputs             " << fp16_outputs_message << std::endl;
 }
 
 bool ParseAndCheckCommandLine(int argc, char* argv[]) {
@@ -173,38 +203,50 @@ cv::Mat applyColorMap(cv::Mat input) {
     return out;
 }
 
-cv::Mat renderSegmentationData(const ImageResult& result, OutputTransform& outputTransform, bool masks_only) {
+// The class map at the model output resolution is resized straight to the output resolution and blended with the
+// input image resized into outputImg, which is reused by next frames
+cv::Mat renderSegmentationData(const SegmentationResult& result,
+                               OutputTransform& outputTransform,
+                               bool masks_only,
+                               cv::Mat& outputImg) {
     if (!result.metaData) {
         throw std::invalid_argument("Renderer: metadata is null");
     }
 
     // Input image is stored inside metadata, as we put it there during submission stage
-    auto inputImg = result.metaData->asRef<ImageMetaData>().img;
+    const cv::Mat& inputImg = result.metaData->asRef<ImageMetaData>().img;
 
     if (inputImg.empty()) {
         throw std::invalid_argument("Renderer: image provided in metadata is empty");
     }
 
     // Visualizing result data over source image
-    cv::Mat output =
-        masks_only ? applyColorMap(result.resultImage) : inputImg / 2 + applyColorMap(result.resultImage) / 2;
-    outputTransform.resize(output);
-    return output;
+    cv::Mat classMap;
+    cv::resize(result.classMap, classMap, outputTransform.getOutputSize(inputImg.size()), 0, 0, cv::INTER_NEAREST);
+    const cv::Mat masks = applyColorMap(classMap);
+    if (masks_only) {
+        return masks;
+    }
+    outputTransform.resize(inputImg, outputImg);
+    cv::addWeighted(outputImg, 0.5, masks, 0.5, 0, outputImg);
+    return outputImg;
 }
 
-void printRawResults(const ImageResult& result, std::vector<std::string> labels) {
+void printRawResults(const SegmentationResult& result, std::vector<std::string> labels) {
+    // Pixels are counted at the input image resolution
+    const cv::Mat classMap = result.upscaleClassMap();
     slog::debug << " --------------- Frame # " << result.frameId << " ---------------" << slog::endl;
     slog::debug << "     Class ID     | Pixels | Percentage " << slog::endl;
 
     double min_val, max_val;
-    cv::minMaxLoc(result.resultImage, &min_val, &max_val);
+    cv::minMaxLoc(classMap, &min_val, &max_val);
     int max_classes = static_cast<int>(max_val) + 1;  // We use +1 for only background case
     const float range[] = {0, static_cast<float>(max_classes)};
     const float* ranges[] = {range};
     cv::Mat histogram;
-    cv::calcHist(&result.resultImage, 1, 0, cv::Mat(), histogram, 1, &max_classes, ranges);
+    cv::calcHist(&classMap, 1, 0, cv::Mat(), histogram, 1, &max_classes, ranges);
 
-    const double all = result.resultImage.cols * result.resultImage.rows;
+    const double all = classMap.cols * classMap.rows;
     for (int i = 0; i < max_classes; ++i) {
         const int value = static_cast<int>(histogram.at<float>(i));
         if (value > 0) {
@@ -233,11 +275,25 @@ int main(int argc, char* argv[]) {
         slog::info << ov::get_openvino_version() << slog::endl;
 
         ov::Core core;
-        AsyncPipeline pipeline(
-            std::unique_ptr<SegmentationModel>(new SegmentationModel(FLAGS_m, FLAGS_auto_resize, FLAGS_layout)),
-            ConfigFactory::getUserConfig(FLAGS_d, FLAGS_nireq, FLAGS_nstreams, FLAGS_nthreads),
-            core);
+        ModelConfig config = ConfigFactory::getUserConfig(FLAGS_d, FLAGS_nireq, FLAGS_nstreams, FLAGS_nthreads);
+        config.tuning = ConfigFactory::getTuningConfig(FLAGS_tune, FLAGS_tune_latency, FLAGS_tune_cache);
+        config.warmupInferences = FLAGS_warmup;
+        config.profiledLayers = FLAGS_profile_layers;
+        config.remoteWorker = FLAGS_remote;
+        std::unique_ptr<SegmentationModel> model(new SegmentationModel(FLAGS_m, FLAGS_auto_resize, FLAGS_layout));
+        model->setDevicePostprocessing(FLAGS_postprocess_on_device);
+        model->setHalfPrecisionOutputs(FLAGS_fp16_outputs);
+        model->setInputsMemory(FLAGS_inputs_memory);
+        model->setDevicePreprocessing(FLAGS_preprocess_on_device);
+        // The class map is resized once by the renderer straight to the output resolution
+        model->setLazyUpscale(true);
+        AsyncPipeline pipeline(std::move(model), config, core);
+        pipeline.setMotionGate(MotionGateConfig(FLAGS_motion_gate, FLAGS_motion_gate_max_skip));
         Presenter presenter(FLAGS_u);
+        std::unique_ptr<MetricsSink> metricsSink;
+        if (!FLAGS_metrics_file.empty()) {
+            metricsSink.reset(new MetricsSink(FLAGS_metrics_file));
+        }
 
         std::vector<std::string> labels;
         if (!FLAGS_labels.empty()) {
@@ -253,6 +309,9 @@ int main(int argc, char* argv[]) {
         cv::Size outputResolution;
         OutputTransform outputTransform = OutputTransform();
         size_t found = FLAGS_output_resolution.find("x");
+        // Results are rendered only if they are shown or written
+        const bool needsRendering = !FLAGS_no_show || !FLAGS_o.empty();
+        cv::Mat outputBuffer;
 
         bool only_masks = FLAGS_only_masks;
 
@@ -292,12 +351,21 @@ int main(int argc, char* argv[]) {
             //--- If you need just plain data without rendering - cast result's underlying pointer to ImageResult*
             //    and use your own processing instead of calling renderSegmentationData().
             while (keepRunning && (result = pipeline.getResult())) {
-                auto renderingStart = std::chrono::steady_clock::now();
-                cv::Mat outFrame = renderSegmentationData(result->asRef<ImageResult>(), outputTransform, only_masks);
-                //--- Showing results and device information
                 if (FLAGS_r) {
-                    printRawResults(result->asRef<ImageResult>(), labels);
+                    printRawResults(result->asRef<SegmentationResult>(), labels);
                 }
+                if (!needsRendering) {
+                    metrics.update(result->metaData->asRef<ImageMetaData>().timeStamp);
+                    framesProcessed++;
+                    continue;
+                }
+                auto renderingStart = std::chrono::steady_clock::now();
+                ITT_SCOPED_FRAME_TASK("render", result->frameId);
+                cv::Mat outFrame = renderSegmentationData(result->asRef<SegmentationResult>(),
+                                                          outputTransform,
+                                                          only_masks,
+                                                          outputBuffer);
+                //--- Showing results and device information
                 presenter.drawGraphs(outFrame);
                 renderMetrics.update(renderingStart);
                 metrics.update(result->metaData->asRef<ImageMetaData>().timeStamp,
@@ -321,6 +389,24 @@ int main(int argc, char* argv[]) {
                     }
                 }
             }
+
+            if (metricsSink && metricsSink->isDue()) {
+                metricsSink->stage("decoding", cap->getMetrics().getLast());
+                pipeline.reportMetrics(*metricsSink);
+                const std::pair<double, double> memSwapUsage = presenter.getLastMemSwapUsage();
+                const std::pair<double, double> gpuUsage = presenter.getLastGpuUsage();
+                const double power = presenter.getLastPower();
+                metricsSink->stage("rendering", renderMetrics.getLast())
+                    .stage("total", metrics.getLast())
+                    .value("cpu_load", presenter.getLastCpuLoad())
+                    .value("memory_gib", memSwapUsage.first)
+                    .value("swap_gib", memSwapUsage.second)
+                    .value("power_w", power)
+                    .value("fps_per_watt", metrics.getLast().fps / power)
+                    .value("gpu_utilization", gpuUsage.first)
+                    .value("gpu_frequency_mhz", gpuUsage.second);
+                metricsSink->publish();
+            }
         }  // while(keepRunning)
 
         // ------------ Waiting for completion of data processing and rendering the rest of results ---------
@@ -329,11 +415,18 @@ int main(int argc, char* argv[]) {
         for (; framesProcessed <= frameNum; framesProcessed++) {
             result = pipeline.getResult();
             if (result != nullptr) {
-                cv::Mat outFrame = renderSegmentationData(result->asRef<ImageResult>(), outputTransform, only_masks);
-                //--- Showing results and device information
                 if (FLAGS_r) {
-                    printRawResults(result->asRef<ImageResult>(), labels);
+                    printRawResults(result->asRef<SegmentationResult>(), labels);
+                }
+                if (!needsRendering) {
+                    metrics.update(result->metaData->asRef<ImageMetaData>().timeStamp);
+                    continue;
                 }
+                cv::Mat outFrame = renderSegmentationData(result->asRef<SegmentationResult>(),
+                                                          outputTransform,
+                                                          only_masks,
+                                                          outputBuffer);
+                //--- Showing results and device information
                 presenter.drawGraphs(outFrame);
                 metrics.update(result->metaData->asRef<ImageMetaData>().timeStamp,
                                outFrame,
@@ -349,14 +442,25 @@ int main(int argc, char* argv[]) {
             }
         }
 
+        const int skippedFrames = pipeline.getPreprocessMetrics().getTotal().skippedFrames;
+        if (skippedFrames > 0) {
+            slog::info << "\t" << skippedFrames << " frames weren't inferred, results of previous frames were reused"
+                       << slog::endl;
+        }
         slog::info << "Metrics report:" << slog::endl;
         metrics.logTotal();
-        logLatencyPerStage(cap->getMetrics().getTotal().latency,
-                           pipeline.getPreprocessMetrics().getTotal().latency,
-                           pipeline.getInferenceMetircs().getTotal().latency,
-                           pipeline.getPostprocessMetrics().getTotal().latency,
-                           renderMetrics.getTotal().latency);
+        logLatencyPerStage(cap->getMetrics().getTotal(),
+                           pipeline.getPreprocessMetrics().getTotal(),
+                           pipeline.getInferenceMetircs().getTotal(),
+                           pipeline.getPostprocessMetrics().getTotal(),
+                           renderMetrics.getTotal());
+        pipeline.logLayersProfile();
         slog::info << presenter.reportMeans() << slog::endl;
+        const double meanPower = presenter.getMeanPower();
+        if (!std::isnan(meanPower)) {
+            slog::info << "\tFPS/W: " << metrics.getTotal().fps / meanPower << slog::endl;
+        }
+        logMemoryUsage();
     } catch (const std::exception& error) {
         slog::err << error.what() << slog::endl;
         return 1;
@@ -4,12 +4,16 @@
 
 #pragma once
 
+#include <stdint.h>
+
 #include <map>
 #include <string>
 #include <vector>
 
 #include <opencv2/core/core.hpp>
 
+#include "utils/nms.hpp"
+
 #include "cnn.hpp"
 
 #include "openvino/openvino.hpp"
@@ -140,6 +144,11 @@ private:
     int m_num_candidates;
     bool m_binary_task;
 
+    // Scratch buffers of GetDetections(), kept between frames to avoid reallocations
+    mutable std::vector<uint8_t> m_passed_mask;
+    mutable DetectedActions m_valid_detections;
+    mutable NmsBoxes m_nms_boxes;
+
     /**
     * @brief BBox in normalized form (each coordinate is in range [0;1]).
     */
@@ -199,19 +208,4 @@ private:
                            const NormalizedBBox& variances,
                            const NormalizedBBox& encoded_bbox,
                            const cv::Size& frame_size) const;
-
-     /**
-    * @brief Carry out Soft Non-Maximum Suppression algorithm under detected actions
-    *
-    * @param detections Detected actions
-    * @param sigma Scale parameter
-    * @param top_k Number of top-score bboxes
-    * @param min_det_conf Minimum detection confidence
-    * @param out_indices Out indices of valid detections
-    */
-    void SoftNonMaxSuppression(const DetectedActions& detections,
-                               const float sigma,
-                               size_t top_k,
-                               const float min_det_conf,
-                               std::vector<int>* out_indices) const;
 };
@@ -12,6 +12,7 @@
 
 #include "openvino/openvino.hpp"
 
+#include "utils/batch_infer_engine.hpp"
 #include "utils/ocv_common.hpp"
 
 /**
@@ -26,6 +27,8 @@ struct CnnConfig {
     std::string m_model_type;
     /** @brief Maximal size of batch */
     int m_max_batch_size{1};
+    /** @brief Number of infer requests the batches of one call are spread over */
+    int m_num_requests{1};
 
     /** @brief OpenVINO Core instance */
     ov::Core m_core;
@@ -55,10 +58,18 @@ public:
    */
     void Load();
 
+    /**
+   * @brief Returns path to the model
+   */
+    const std::string& modelPath() const { return m_config.m_path_to_model; }
+
 protected:
     /**
    * @brief Run model in batch mode
    *
+   * Frames are split into batches of at most m_max_batch_size, which are inferred
+   * asynchronously on m_num_requests requests; results are fetched in frame order
+   *
    * @param frames Vector of input images
    * @param results_fetcher Callback to fetch inference results
    */
@@ -77,8 +88,8 @@ protected:
     ov::Shape m_modelShape;
     /** @brief Compled model */
     ov::CompiledModel m_compiled_model;
-    /** @brief Inference request */
-    mutable ov::InferRequest m_infer_request;
+    /** @brief Inference requests the batches are spread over */
+    mutable std::unique_ptr<BatchInferEngine> m_infer_engine;
     /** @brief Name of the input tensor */
     std::string m_input_tensor_name;
     /** @brief Names of output tensors */
@@ -49,12 +49,25 @@ private:
     int m_enqueued_frames = 0;
     float m_width = 0;
     float m_height = 0;
+    // Mosaic of person crops enqueued by enqueueRois(): places of the crops in it and the crops in the frame
+    bool m_roi_mode = false;
+    cv::Mat m_mosaic;
+    std::vector<cv::Rect> m_tiles;
+    std::vector<cv::Rect> m_tile_rois;
+    float m_tile_scale = 1.0f;
+
+    bool MapFromTiles(const cv::Rect2f& box, cv::Rect* rect) const;
 
 public:
     explicit FaceDetection(const DetectorConfig& config);
 
     void submitRequest() override;
     void enqueue(const cv::Mat& frame) override;
+    /// Enqueues only the given regions of the frame (e.g. upper bodies of persons): they are scaled by a common
+    /// factor not above 1, packed into a single image of the network input size and inferred with one request.
+    /// fetchResults() returns faces found inside the regions in frame coordinates. If there are no regions,
+    /// nothing is submitted and no faces are returned.
+    void enqueueRois(const cv::Mat& frame, const std::vector<cv::Rect>& rois);
     void wait() override { BaseCnnDetection::wait(); }
 
     DetectedObjects fetchResults() override;
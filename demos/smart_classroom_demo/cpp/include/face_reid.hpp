@@ -6,6 +6,7 @@
 
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <opencv2/core/core.hpp>
@@ -37,7 +38,9 @@ public:
                       bool crop_gallery, const detection::DetectorConfig& detector_config,
                       const VectorCNN& landmarks_det,
                       const VectorCNN& image_reid,
-                      bool use_greedy_matcher=false);
+                      bool use_greedy_matcher=false,
+                      int index_lists_num=0, int index_probes_num=1,
+                      const std::string& cache_path="");
     size_t size() const;
     std::vector<int> GetIDsByEmbeddings(const std::vector<cv::Mat>& embeddings) const;
     std::string GetLabelByID(int id) const;
@@ -53,10 +56,22 @@ private:
                                         const VectorCNN& landmarks_det,
                                         const VectorCNN& image_reid,
                                         cv::Mat& embedding);
+    void BuildIndex(int lists_num);
+    // Returns the distances to the nearest gallery embeddings and their rows
+    std::vector<std::pair<float, int>> FindCandidates(const cv::Mat& query,
+                                                      const cv::Mat& centroid_similarities) const;
+
     std::vector<int> idx_to_id;
     double reid_threshold;
     std::vector<GalleryObject> identities;
     bool use_greedy_matcher;
+    // Normalized embeddings, a row per idx_to_id element
+    cv::Mat gallery_embeddings;
+    // Inverted file index: normalized centroids of the clusters of
+    // gallery_embeddings and the rows of every cluster. Empty for exact search
+    cv::Mat index_centroids;
+    std::vector<std::vector<int>> index_lists;
+    int index_probes_num;
 };
 
 void AlignFaces(std::vector<cv::Mat>* face_images,
@@ -4,9 +4,13 @@
 
 #pragma once
 
+#include <condition_variable>
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
 #include <opencv2/opencv.hpp>
@@ -16,16 +20,56 @@
 
 class DetectionsLogger {
 private:
+    struct ObjectRecord {
+        bool is_face;
+        cv::Rect rect;
+        std::string id;
+        std::string action;
+    };
+
+    struct ActionDetectionRecord {
+        int frame_idx;
+        float confidence;
+        int label;
+        cv::Rect rect;
+    };
+
+    // Objects of a frame queued for the writing thread
+    struct FrameRecord {
+        int frame_idx = 0;
+        size_t width = 0;
+        size_t height = 0;
+        std::vector<ObjectRecord> objects;
+        std::vector<ActionDetectionRecord> action_detections;
+    };
+
     bool m_write_logs;
     std::ofstream m_act_stat_log_stream;
     cv::FileStorage m_act_det_log_stream;
     slog::LogStream& m_log_stream;
 
+    // If the frames log is enabled, frame records are formatted and written by a separate thread, which also owns
+    // m_act_det_log_stream then. The processing thread only moves finished records to the queue.
+    std::ofstream m_frames_log_stream;
+    FrameRecord m_frame;
+    std::vector<FrameRecord> m_queued_frames;
+    std::mutex m_mutex;
+    std::condition_variable m_cond_var;
+    bool m_stop_writing = false;
+    std::thread m_writing_thread;
+
+    void WritingThreadFunc();
+    void LogFace(const cv::Rect& rect, const std::string& id, const std::string& action);
+    void LogFrame(const std::string& path, const int frame_idx, const size_t width, const size_t height);
+    void WriteActionDetection(const ActionDetectionRecord& record);
 
 public:
+    /// @param frames_log_file - file to write records of every frame to in JSON Lines format by a separate thread,
+    /// it has no effect if empty
     explicit DetectionsLogger(slog::LogStream& stream, bool enabled,
                               const std::string& act_stat_log_file,
-                              const std::string& act_det_log_file);
+                              const std::string& act_det_log_file,
+                              const std::string& frames_log_file = "");
 
     ~DetectionsLogger();
     void CreateNextFrameRecord(const std::string& path, const int frame_idx,
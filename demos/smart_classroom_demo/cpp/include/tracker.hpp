@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 #include <set>
 #include <string>
@@ -12,7 +13,7 @@
 #include <utility>
 #include <vector>
 
-#include "utils/kuhn_munkres.hpp"
+#include "utils/track_association.hpp"
 #include "cnn.hpp"
 
 struct TrackedObject {
@@ -68,12 +69,50 @@ struct TrackerParams {
     std::string objects_type;  ///< The type of boxes which will be grabbed from
     /// detector. Boxes with other types are ignored.
 
+    bool motion_first_matching;  ///< Match tracks to detections by IoU with the
+    /// Kalman-predicted boxes first. Only the rest is matched by affinity.
+
+    float motion_match_iou_thr;  ///< Min IoU of a predicted box and a detection
+    /// to be matched without computing affinities.
+
+    float motion_ambiguous_iou_thr;  ///< A motion match is rejected if the track
+    /// or the detection has another pair with IoU above this threshold.
+
     ///
     /// Default constructor.
     ///
     TrackerParams();
 };
 
+///
+/// \brief Constant velocity Kalman filter of a bounding box. The center and the
+/// size of the box are filtered independently, the noise is relative to the
+/// box height.
+///
+class BoxKalmanFilter {
+public:
+    explicit BoxKalmanFilter(const cv::Rect& rect = cv::Rect());
+
+    ///
+    /// \brief Predict advances the filter by one frame.
+    /// \return Predicted bounding box.
+    ///
+    cv::Rect Predict();
+
+    ///
+    /// \brief Correct updates the filter with a detected bounding box.
+    /// \param rect Detected bounding box.
+    ///
+    void Correct(const cv::Rect& rect);
+
+private:
+    cv::Vec4f m_value;  ///< Center x, center y, width, height.
+    cv::Vec4f m_velocity;
+    cv::Vec4f m_value_var;
+    cv::Vec4f m_covar;
+    cv::Vec4f m_velocity_var;
+};
+
 ///
 /// \brief The Track struct describes tracks.
 ///
@@ -82,9 +121,14 @@ struct Track {
     /// \brief Track constructor.
     /// \param objs Detected objects sequence.
     ///
-    explicit Track(const TrackedObjects& objs) : objects(objs), lost(0), length(1) {
+    explicit Track(const TrackedObjects& objs) : objects(objs.begin(), objs.end()), lost(0), length(1) {
         CV_Assert(!objs.empty());
+        filter = BoxKalmanFilter(objs.back().rect);
+        predicted_rect = objs.back().rect;
         first_object = objs[0];
+        for (const auto& obj : objs) {
+            label_counts[obj.label]++;
+        }
     }
 
     ///
@@ -133,16 +177,21 @@ struct Track {
         return objects.back();
     }
 
-    TrackedObjects objects;  ///< Detected objects;
+    std::deque<TrackedObject> objects;  ///< Recent detected objects, the oldest ones are
+                                        /// removed after max_num_objects_in_track.
     size_t lost;             ///< How many frames ago track has been lost.
 
     TrackedObject first_object;  ///< First object in track.
     size_t length;  ///< Length of a track including number of objects that were
                     /// removed from track in order to avoid memory usage growth.
+    std::unordered_map<int, size_t> label_counts;  ///< Number of objects of each label
+                                                   /// including the removed ones.
+    BoxKalmanFilter filter;  ///< Motion model of the track.
+    cv::Rect predicted_rect;  ///< Box predicted for the current frame.
 };
 
 ///
-/// \brief Simple Hungarian algorithm-based tracker.
+/// \brief Simple assignment-based tracker.
 ///
 class Tracker {
 public:
@@ -241,8 +290,9 @@ public:
 private:
     const std::set<size_t>& active_track_ids() const { return m_active_track_ids; }
 
-    float ShapeAffinity(const cv::Rect& trk, const cv::Rect& det);
-    float MotionAffinity(const cv::Rect& trk, const cv::Rect& det);
+    void MatchByMotion(const std::set<size_t>& track_ids, const TrackedObjects& detections,
+                       std::set<size_t>* unmatched_tracks,
+                       std::set<size_t>* unmatched_detections);
 
     void SolveAssignmentProblem(
             const std::set<size_t>& track_ids, const TrackedObjects& detections,
@@ -251,15 +301,9 @@ private:
             std::set<std::tuple<size_t, size_t, float>>* matches);
     void FilterDetectionsAndStore(const TrackedObjects& detected_objects);
 
-    void ComputeDissimilarityMatrix(const std::set<size_t>& active_track_ids,
-                                    const TrackedObjects& detections,
-                                    cv::Mat* dissimilarity_matrix);
-
     std::vector<std::pair<size_t, size_t>> GetTrackToDetectionIds(
             const std::set<std::tuple<size_t, size_t, float>>& matches);
 
-    float Distance(const TrackedObject& obj1, const TrackedObject& obj2);
-
     void AddNewTrack(const TrackedObject& detection);
 
     void AddNewTracks(const TrackedObjects& detections);
@@ -294,6 +338,8 @@ private:
     size_t m_tracks_counter;
 
     cv::Size m_frame_size;
+
+    TrackAssociator m_associator;
 };
 
 int LabelWithMaxFrequencyInTrack(const Track& track, int window_size);
@@ -6,6 +6,8 @@
 
 #include <algorithm>
 #include <deque>
+#include <future>
+#include <iomanip>
 #include <map>
 #include <memory>
 #include <limits>
@@ -22,6 +24,7 @@
 #include "utils/images_capture.h"
 #include "utils/ocv_common.hpp"
 #include "utils/slog.hpp"
+#include "utils/startup_profiler.hpp"
 #include "cnn.hpp"
 #include "actions.hpp"
 #include "action_detector.hpp"
@@ -370,6 +373,41 @@ int GetIndexOfTheNearestPerson(const TrackedObject& face, const std::vector<Trac
     return argmax;
 }
 
+// Faces of persons are searched in the top of their boxes, widened a bit for heads turned aside or bowed
+cv::Rect GetUpperBodyRect(const cv::Rect& person, const cv::Size& frame_size) {
+    const int margin = person.width / 10;
+    cv::Rect upper_body(person.x - margin, person.y - margin,
+                        person.width + 2 * margin, person.height / 2 + margin);
+    return upper_body & cv::Rect(cv::Point(0, 0), frame_size);
+}
+
+// Index of the track of the previous frame the person detection belongs to, or -1
+int GetIndexOfTheSamePerson(const cv::Rect& person, const std::vector<TrackedObject>& tracked_persons) {
+    int argmax = -1;
+    float max_iou = 0.5f;
+    for (size_t i = 0; i < tracked_persons.size(); i++) {
+        const float area_intersect = static_cast<float>((person & tracked_persons[i].rect).area());
+        const float iou = area_intersect / (person.area() + tracked_persons[i].rect.area() - area_intersect);
+        if (iou > max_iou) {
+            max_iou = iou;
+            argmax = i;
+        }
+    }
+    return argmax;
+}
+
+// The last face detected inside a person track and how many times in a row its identity was recognized
+struct ConfirmedFace {
+    cv::Rect2f relative_rect;  // relative to the person box
+    float confidence = 0.0f;
+    int label = EmbeddingsGallery::unknown_id;
+    int confirmations = 0;
+    int skipped_frames = 0;
+};
+
+// Detections of the same recognized identity needed to reuse the face instead of detecting it
+const int face_confirmations_to_skip = 3;
+
 std::map<int, int> GetMapFaceTrackIdToLabel(const std::vector<Track>& face_tracks) {
     std::map<int, int> face_track_id_to_label;
     for (const auto& track : face_tracks) {
@@ -426,12 +464,15 @@ public:
             double reid_threshold,
             int min_size_fr,
             bool crop_gallery,
-            bool greedy_reid_matching) :
+            bool greedy_reid_matching,
+            int index_lists_num,
+            int index_probes_num,
+            const std::string& gallery_cache_path) :
         landmarks_detector(landmarks_detector_config),
         face_reid(reid_config),
         face_gallery(face_gallery_path, reid_threshold, min_size_fr, crop_gallery,
                      face_registration_det_config, landmarks_detector, face_reid,
-                     greedy_reid_matching)
+                     greedy_reid_matching, index_lists_num, index_probes_num, gallery_cache_path)
     {
         if (face_gallery.size() == 0) {
             slog::warn << "Face reid gallery is empty!" << slog::endl;
@@ -453,9 +494,6 @@ public:
     }
 
     std::vector<int> Recognize(const cv::Mat& frame, const detection::DetectedObjects& faces) override {
-        const int maxLandmarksBatch = landmarks_detector.maxBatchSize();
-        int numFaces = (int)faces.size();
-
         std::vector<cv::Mat> landmarks;
         std::vector<cv::Mat> embeddings;
         std::vector<cv::Mat> face_rois;
@@ -463,29 +501,11 @@ public:
         auto face_roi = [&](const detection::DetectedObject& face) {
             return frame(face.rect);
         };
-        if (numFaces < maxLandmarksBatch) {
-            std::transform(faces.begin(), faces.end(), std::back_inserter(face_rois), face_roi);
-            landmarks_detector.Compute(face_rois, &landmarks, cv::Size(2, 5));
-            AlignFaces(&face_rois, &landmarks);
-            face_reid.Compute(face_rois, &embeddings);
-        } else {
-            auto embedding = [&](cv::Mat& emb) { return emb; };
-            for (int n = numFaces; n > 0; n -= maxLandmarksBatch) {
-                landmarks.clear();
-                face_rois.clear();
-                size_t start_idx = size_t(numFaces) - n;
-                size_t end_idx = start_idx + std::min(numFaces, maxLandmarksBatch);
-                std::transform(faces.begin() + start_idx, faces.begin() + end_idx, std::back_inserter(face_rois), face_roi);
-
-                landmarks_detector.Compute(face_rois, &landmarks, cv::Size(2, 5));
-
-                AlignFaces(&face_rois, &landmarks);
-
-                std::vector<cv::Mat> batch_embeddings;
-                face_reid.Compute(face_rois, &batch_embeddings);
-                std::transform(batch_embeddings.begin(), batch_embeddings.end(), std::back_inserter(embeddings), embedding);
-            }
-        }
+        // VectorCNN splits the faces into batches itself and keeps several of them in flight
+        std::transform(faces.begin(), faces.end(), std::back_inserter(face_rois), face_roi);
+        landmarks_detector.Compute(face_rois, &landmarks, cv::Size(2, 5));
+        AlignFaces(&face_rois, &landmarks);
+        face_reid.Compute(face_rois, &embeddings);
 
         return face_gallery.GetIDsByEmbeddings(embeddings);
     }
@@ -512,6 +532,21 @@ bool ParseAndCheckCommandLine(int argc, char* argv[]) {
     if (FLAGS_m_act.empty() && FLAGS_m_fd.empty()) {
         throw std::logic_error("At least one parameter -m_act or -m_fd must be set");
     }
+    if (FLAGS_fg_index_lists < 0) {
+        throw std::logic_error("Parameter -fg_index_lists must be non-negative");
+    }
+    if (FLAGS_fg_index_probes <= 0) {
+        throw std::logic_error("Parameter -fg_index_probes must be positive");
+    }
+    if (FLAGS_fd_person_rois && (FLAGS_m_act.empty() || FLAGS_m_fd.empty())) {
+        throw std::logic_error("Parameter -fd_person_rois requires both -m_act and -m_fd");
+    }
+    if (FLAGS_fd_skip_confirmed < 0) {
+        throw std::logic_error("Parameter -fd_skip_confirmed must be non-negative");
+    }
+    if (FLAGS_fd_skip_confirmed > 0 && !FLAGS_fd_person_rois) {
+        throw std::logic_error("Parameter -fd_skip_confirmed works with -fd_person_rois only");
+    }
 
     return true;
 }
@@ -520,6 +555,7 @@ bool ParseAndCheckCommandLine(int argc, char* argv[]) {
 
 int main(int argc, char* argv[]) {
     try {
+        StartupProfiler startup_profiler;
         PerformanceMetrics metrics;
 
         // This demo covers 4 certain topologies and cannot be generalized
@@ -557,9 +593,16 @@ int main(int argc, char* argv[]) {
         slog::info << ov::get_openvino_version() << slog::endl;
         ov::Core core;
 
+        // The models log while they are loaded, so they are loaded one by one, but the input is opened meanwhile
+        std::future<std::unique_ptr<ImagesCapture>> cap_opening = std::async(std::launch::async, [&startup_profiler]() {
+            StartupProfiler::Phase phase(startup_profiler, "Opening the input");
+            return openImagesCapture(FLAGS_i, FLAGS_loop, read_type::safe, 0, FLAGS_read_limit);
+        });
+
         std::unique_ptr<AsyncDetection<DetectedAction>> action_detector;
         if (!ad_model_path.empty()) {
             // Load action detector
+            StartupProfiler::Phase phase(startup_profiler, "Loading Person/Action Detection");
             ActionDetectorConfig action_config(ad_model_path, "Person/Action Detection");
             action_config.m_deviceName = FLAGS_d_act;
             action_config.m_core = core;
@@ -574,8 +617,11 @@ int main(int argc, char* argv[]) {
         }
 
         std::unique_ptr<AsyncDetection<detection::DetectedObject>> face_detector;
+        // Set if faces are detected in upper bodies of detected persons instead of whole frames
+        detection::FaceDetection* person_rois_face_detector = nullptr;
         if (!fd_model_path.empty()) {
             // Load face detector
+            StartupProfiler::Phase phase(startup_profiler, "Loading Face Detection");
             detection::DetectorConfig face_config(fd_model_path);
             face_config.m_deviceName = FLAGS_d_fd;
             face_config.m_core = core;
@@ -585,7 +631,11 @@ int main(int argc, char* argv[]) {
             face_config.input_w = FLAGS_inw_fd;
             face_config.increase_scale_x = static_cast<float>(FLAGS_exp_r_fd);
             face_config.increase_scale_y = static_cast<float>(FLAGS_exp_r_fd);
-            face_detector.reset(new detection::FaceDetection(face_config));
+            detection::FaceDetection* frame_face_detector = new detection::FaceDetection(face_config);
+            face_detector.reset(frame_face_detector);
+            if (FLAGS_fd_person_rois) {
+                person_rois_face_detector = frame_face_detector;
+            }
         } else {
             face_detector.reset(new NullDetection<detection::DetectedObject>);
         }
@@ -594,6 +644,7 @@ int main(int argc, char* argv[]) {
 
         if (!fd_model_path.empty() && !fr_model_path.empty() && !lm_model_path.empty()) {
             // Create face recognizer
+            StartupProfiler::Phase phase(startup_profiler, "Loading Face Recognition and the gallery");
             detection::DetectorConfig face_registration_det_config(fd_model_path);
             face_registration_det_config.m_deviceName = FLAGS_d_fd;
             face_registration_det_config.m_core = core;
@@ -605,16 +656,19 @@ int main(int argc, char* argv[]) {
             CnnConfig reid_config(fr_model_path, "Face Re-Identification");
             reid_config.m_deviceName = FLAGS_d_reid;
             reid_config.m_max_batch_size = 16;
+            reid_config.m_num_requests = static_cast<int>(FLAGS_nireq);
             reid_config.m_core = core;
 
             CnnConfig landmarks_config(lm_model_path, "Facial Landmarks Regression");
             landmarks_config.m_deviceName = FLAGS_d_lm;
             landmarks_config.m_max_batch_size = 16;
+            landmarks_config.m_num_requests = static_cast<int>(FLAGS_nireq);
             landmarks_config.m_core = core;
             face_recognizer.reset(new FaceRecognizerDefault(
                 landmarks_config, reid_config,
                 face_registration_det_config,
-                FLAGS_fg, FLAGS_t_reid, FLAGS_min_size_fr, FLAGS_crop_gallery, FLAGS_greedy_reid_matching));
+                FLAGS_fg, FLAGS_t_reid, FLAGS_min_size_fr, FLAGS_crop_gallery, FLAGS_greedy_reid_matching,
+                FLAGS_fg_index_lists, FLAGS_fg_index_probes, FLAGS_fg_cache));
 
             if (actions_type == TEACHER && !face_recognizer->LabelExists(teacher_id)) {
                 slog::err << "Teacher id does not exist in the gallery!" << slog::endl;
@@ -638,9 +692,13 @@ int main(int argc, char* argv[]) {
         tracker_reid_params.averaging_window_size_for_rects = 1;
         tracker_reid_params.averaging_window_size_for_labels = std::numeric_limits<int>::max();
         tracker_reid_params.bbox_heights_range = cv::Vec2f(10, 1080);
-        tracker_reid_params.drop_forgotten_tracks = false;
-        tracker_reid_params.max_num_objects_in_track = std::numeric_limits<int>::max();
+        // Face tracks are needed for the final report of students actions only, and their whole history is needed for
+        // its per-frame part only. Otherwise the last object and the label summary of a track are enough
+        const bool keep_face_tracks_history = actions_type == STUDENT && (FLAGS_r || !FLAGS_ad.empty() || !FLAGS_al.empty());
+        tracker_reid_params.drop_forgotten_tracks = actions_type != STUDENT;
+        tracker_reid_params.max_num_objects_in_track = keep_face_tracks_history ? std::numeric_limits<int>::max() : 1;
         tracker_reid_params.objects_type = "face";
+        tracker_reid_params.motion_first_matching = true;
 
         Tracker tracker_reid(tracker_reid_params);
 
@@ -654,8 +712,11 @@ int main(int argc, char* argv[]) {
             FLAGS_ss_t : actions_type == TOP_K ? 5 : 1;
         tracker_action_params.bbox_heights_range = cv::Vec2f(10, 2160);
         tracker_action_params.drop_forgotten_tracks = false;
-        tracker_action_params.max_num_objects_in_track = std::numeric_limits<int>::max();
+        // Only the averaging windows of action tracks are used
+        tracker_action_params.max_num_objects_in_track = std::max(tracker_action_params.averaging_window_size_for_rects,
+                                                                  tracker_action_params.averaging_window_size_for_labels);
         tracker_action_params.objects_type = "action";
+        tracker_action_params.motion_first_matching = true;
 
         Tracker tracker_action(tracker_action_params);
 
@@ -669,10 +730,14 @@ int main(int argc, char* argv[]) {
         const cv::Scalar white_color(255, 255, 255);
         std::vector<std::map<int, int>> face_obj_id_to_action_maps;
         std::map<int, int> top_k_obj_ids;
+        // Faces reused for persons instead of their detection, by ids of the person tracks
+        std::map<int, ConfirmedFace> confirmed_faces;
+        TrackedObjects prev_tracked_actions;
+        size_t skipped_face_detections = 0;
 
         int teacher_track_id = -1;
 
-        std::unique_ptr<ImagesCapture> cap = openImagesCapture(FLAGS_i, FLAGS_loop, read_type::safe, 0, FLAGS_read_limit);
+        std::unique_ptr<ImagesCapture> cap = cap_opening.get();
         cv::Mat frame = cap->read();
 
         cv::Size graphSize{static_cast<int>(frame.cols / 4), 60};
@@ -680,15 +745,21 @@ int main(int argc, char* argv[]) {
 
         LazyVideoWriter videoWriter{FLAGS_o, cap->fps(), FLAGS_limit};
         Visualizer sc_visualizer(!FLAGS_no_show, videoWriter, num_top_persons);
-        DetectionsLogger logger(slog::debug, FLAGS_r, FLAGS_ad, FLAGS_al);
+        DetectionsLogger logger(slog::debug, FLAGS_r, FLAGS_ad, FLAGS_al, FLAGS_fl);
         if (actions_type != TOP_K) {
             action_detector->enqueue(frame);
             action_detector->submitRequest();
-            face_detector->enqueue(frame);
-            face_detector->submitRequest();
+            // Otherwise faces of a frame are detected once its persons are
+            if (!person_rois_face_detector) {
+                face_detector->enqueue(frame);
+                face_detector->submitRequest();
+            }
         }
 
         bool is_monitoring_enabled = false;
+        // Per-stage latencies of the face and action recognition. Detection runs on the next frame during recognition,
+        // so its stage only covers waiting for the results
+        PerformanceMetrics detection_metrics, recognition_metrics, tracking_metrics;
 
         bool is_last_frame = false;
         while (!is_last_frame) {
@@ -780,17 +851,72 @@ int main(int argc, char* argv[]) {
                     metrics.update(startTime, frame, { 10, 22 }, cv::FONT_HERSHEY_COMPLEX, 0.65);
                 }
             } else {
-                face_detector->wait();
-                detection::DetectedObjects faces = face_detector->fetchResults();
-                action_detector->wait();
-                DetectedActions actions = action_detector->fetchResults();
-                if (!is_last_frame) {
-                    face_detector->enqueue(frame);
-                    face_detector->submitRequest();
-                    action_detector->enqueue(frame);
-                    action_detector->submitRequest();
+                auto stage_start = std::chrono::steady_clock::now();
+                detection::DetectedObjects faces;
+                DetectedActions actions;
+                detection::DetectedObjects reused_faces;
+                std::vector<int> reused_ids;
+                if (person_rois_face_detector) {
+                    action_detector->wait();
+                    actions = action_detector->fetchResults();
+                    // Persons of the next frame are detected while faces of this one are detected and recognized
+                    if (!is_last_frame) {
+                        action_detector->enqueue(frame);
+                        action_detector->submitRequest();
+                    }
+                    std::vector<cv::Rect> upper_bodies;
+                    for (const auto& action : actions) {
+                        const int track_ind = FLAGS_fd_skip_confirmed > 0
+                            ? GetIndexOfTheSamePerson(action.rect, prev_tracked_actions) : -1;
+                        auto confirmed = confirmed_faces.end();
+                        if (track_ind >= 0) {
+                            confirmed = confirmed_faces.find(prev_tracked_actions[track_ind].object_id);
+                        }
+                        if (confirmed != confirmed_faces.end()
+                            && confirmed->second.confirmations >= face_confirmations_to_skip
+                            && confirmed->second.skipped_frames < FLAGS_fd_skip_confirmed) {
+                            const cv::Rect2f& rel = confirmed->second.relative_rect;
+                            const cv::Rect2f person = action.rect;
+                            const cv::Rect face = cv::Rect2f(person.x + rel.x * person.width,
+                                                             person.y + rel.y * person.height,
+                                                             rel.width * person.width, rel.height * person.height);
+                            reused_faces.emplace_back(face & cv::Rect(cv::Point(0, 0), prev_frame.size()),
+                                                      confirmed->second.confidence);
+                            reused_ids.push_back(confirmed->second.label);
+                            ++confirmed->second.skipped_frames;
+                            continue;
+                        }
+                        if (confirmed != confirmed_faces.end()) {
+                            confirmed->second.skipped_frames = 0;
+                        }
+                        upper_bodies.push_back(GetUpperBodyRect(action.rect, prev_frame.size()));
+                    }
+                    skipped_face_detections += reused_faces.size();
+                    person_rois_face_detector->enqueueRois(prev_frame, upper_bodies);
+                    person_rois_face_detector->submitRequest();
+                    person_rois_face_detector->wait();
+                    faces = person_rois_face_detector->fetchResults();
+                } else {
+                    face_detector->wait();
+                    faces = face_detector->fetchResults();
+                    action_detector->wait();
+                    actions = action_detector->fetchResults();
+                    // The detectors work on the next frame while the faces of this one are recognized
+                    if (!is_last_frame) {
+                        face_detector->enqueue(frame);
+                        face_detector->submitRequest();
+                        action_detector->enqueue(frame);
+                        action_detector->submitRequest();
+                    }
                 }
+                detection_metrics.update(stage_start);
+                stage_start = std::chrono::steady_clock::now();
                 auto ids = face_recognizer->Recognize(prev_frame, faces);
+                recognition_metrics.update(stage_start);
+                const size_t detected_faces_num = faces.size();
+                faces.insert(faces.end(), reused_faces.begin(), reused_faces.end());
+                ids.insert(ids.end(), reused_ids.begin(), reused_ids.end());
+                stage_start = std::chrono::steady_clock::now();
                 TrackedObjects tracked_face_objects;
 
                 for (size_t i = 0; i < faces.size(); i++) {
@@ -805,6 +931,41 @@ int main(int argc, char* argv[]) {
                 }
                 tracker_action.Process(prev_frame, tracked_action_objects, work_num_frames);
                 const auto tracked_actions = tracker_action.TrackedDetectionsWithLabels();
+                tracking_metrics.update(stage_start);
+
+                if (FLAGS_fd_skip_confirmed > 0) {
+                    std::map<int, ConfirmedFace> tracked_confirmed_faces;
+                    for (const auto& action : tracked_actions) {
+                        auto confirmed = confirmed_faces.find(action.object_id);
+                        if (confirmed != confirmed_faces.end()) {
+                            tracked_confirmed_faces.insert(*confirmed);
+                        }
+                    }
+                    for (size_t i = 0; i < detected_faces_num; i++) {
+                        const int person_ind =
+                            GetIndexOfTheNearestPerson(TrackedObject(faces[i].rect), tracked_actions);
+                        if (person_ind < 0) {
+                            continue;
+                        }
+                        const cv::Rect2f person = tracked_actions[person_ind].rect;
+                        ConfirmedFace& confirmed = tracked_confirmed_faces[tracked_actions[person_ind].object_id];
+                        if (ids[i] == EmbeddingsGallery::unknown_id) {
+                            confirmed.confirmations = 0;
+                        } else if (ids[i] == confirmed.label) {
+                            ++confirmed.confirmations;
+                        } else {
+                            confirmed.confirmations = 1;
+                        }
+                        confirmed.label = ids[i];
+                        confirmed.confidence = faces[i].confidence;
+                        confirmed.relative_rect = cv::Rect2f((faces[i].rect.x - person.x) / person.width,
+                                                             (faces[i].rect.y - person.y) / person.height,
+                                                             faces[i].rect.width / person.width,
+                                                             faces[i].rect.height / person.height);
+                    }
+                    confirmed_faces.swap(tracked_confirmed_faces);
+                    prev_tracked_actions = tracked_actions;
+                }
 
                 std::map<int, int> frame_face_obj_id_to_action;
                 for (size_t j = 0; j < tracked_faces.size(); j++) {
@@ -866,6 +1027,7 @@ int main(int argc, char* argv[]) {
             ++total_num_frames;
 
             sc_visualizer.Show();
+            startup_profiler.markFirstResult();
 
             logger.FinalizeFrameRecord();
         }
@@ -914,6 +1076,15 @@ int main(int argc, char* argv[]) {
 
         slog::info << "Metrics report:" << slog::endl;
         metrics.logTotal();
+        if (actions_type != TOP_K) {
+            slog::info << "\tFace and action detection wait: " << std::fixed << std::setprecision(1)
+                       << detection_metrics.getTotal().latency << " ms" << slog::endl;
+            slog::info << "\tFace recognition: " << recognition_metrics.getTotal().latency << " ms" << slog::endl;
+            slog::info << "\tTracking: " << tracking_metrics.getTotal().latency << " ms" << slog::endl;
+            if (FLAGS_fd_skip_confirmed > 0) {
+                slog::info << "\tFaces reused instead of detection: " << skipped_face_detections << slog::endl;
+            }
+        }
         slog::info << presenter.reportMeans() << slog::endl;
     }
     catch (const std::exception& error) {
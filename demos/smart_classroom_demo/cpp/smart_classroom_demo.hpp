@@ -36,18 +36,31 @@ static const char target_device_message_face_reid[] = "Optional. Specify the tar
                                                       "(the list of available devices is shown below). Default value is CPU. "
                                                       "Use \"-d HETERO:<comma-separated_devices_list>\" format to specify HETERO plugin. "
                                                       "The application looks for a suitable plugin for the specified device.";
+static const char num_infer_requests_message[] = "Optional. Number of infer requests the batches of faces are spread over "
+                                                 "for Landmarks Regression and Face Reidentification. Default value is 1.";
 static const char greedy_reid_matching_message[] = "Optional. Use faster greedy matching algorithm in face reid.";
 static const char face_threshold_output_message[] = "Optional. Probability threshold for face detections.";
 static const char person_threshold_output_message[] = "Optional. Probability threshold for person/action detection.";
 static const char action_threshold_output_message[] = "Optional. Probability threshold for action recognition.";
 static const char threshold_output_message_face_reid[] = "Optional. Cosine distance threshold between two vectors for face reidentification.";
 static const char reid_gallery_path_message[] = "Optional. Path to a faces gallery in .json format.";
+static const char fg_cache_message[] = "Optional. Path to a cache file of the faces gallery embeddings. "
+                                       "Only new or changed gallery images are processed on start if it is set.";
+static const char fg_index_lists_message[] = "Optional. Number of clusters of the approximate nearest neighbour index of the faces gallery. "
+                                             "0 means exact search over the whole gallery. Default value is 0.";
+static const char fg_index_probes_message[] = "Optional. Number of the nearest clusters of the faces gallery index to search in. "
+                                              "Default value is 1.";
 static const char act_stat_output_message[] = "Optional. Output file name to save per-person action statistics in.";
 static const char raw_output_message[] = "Optional. Output Inference results as raw values.";
 static const char no_show_message[] = "Optional. Don't show output.";
 static const char input_image_height_output_message[] = "Optional. Input image height for face detector.";
 static const char input_image_width_output_message[] = "Optional. Input image width for face detector.";
 static const char expand_ratio_output_message[] = "Optional. Expand ratio for bbox before face recognition.";
+static const char fd_person_rois_message[] = "Optional. Detect faces only in upper parts of detected persons, packed into a single "
+                                             "face detector input, instead of the whole frame. Requires -m_act.";
+static const char fd_skip_confirmed_message[] = "Optional. Maximum number of consecutive frames faces aren't detected for persons whose "
+                                                "identity is recognized in several detections in a row, the last face is reused "
+                                                "instead. Works with -fd_person_rois only. Default value is 0, faces are always detected.";
 static const char teacher_id_message[] = "Optional. ID of a teacher. You must also set a faces gallery parameter (-fg) to use it.";
 static const char min_action_duration_message[] = "Optional. Minimum action duration in seconds.";
 static const char same_action_time_delta_message[] = "Optional. Maximum time difference between actions in seconds.";
@@ -61,6 +74,9 @@ static const char crop_gallery_message[] = "Optional. Crop images during faces g
 static const char face_threshold_registration_output_message[] = "Optional. Probability threshold for face detections during database registration.";
 static const char min_size_fr_reg_output_message[] = "Optional. Minimum input size for faces during database registration.";
 static const char act_det_output_message[] = "Optional. Output file name to save per-person action detections in.";
+static const char frames_log_output_message[] = "Optional. Output file name to save per-frame face and person records in "
+                                                "JSON Lines format. Unlike -r, the records are written by a background "
+                                                "thread, which also writes -al detections then.";
 static const char tracker_smooth_size_message[] = "Optional. Number of frames to smooth actions.";
 static const char utilization_monitors_message[] = "Optional. List of monitors to show initially.";
 
@@ -74,6 +90,7 @@ DEFINE_string(d_act, "CPU", target_device_message_action_detection);
 DEFINE_string(d_fd, "CPU", target_device_message_face_detection);
 DEFINE_string(d_lm, "CPU", target_device_message_landmarks_regression);
 DEFINE_string(d_reid, "CPU", target_device_message_face_reid);
+DEFINE_uint32(nireq, 1, num_infer_requests_message);
 DEFINE_bool(greedy_reid_matching, false, greedy_reid_matching_message);
 DEFINE_string(ad, "", act_stat_output_message);
 DEFINE_bool(r, false, raw_output_message);
@@ -82,10 +99,15 @@ DEFINE_double(t_ar, 0.75, action_threshold_output_message);
 DEFINE_double(t_fd, 0.6, face_threshold_output_message);
 DEFINE_double(t_reid, 0.7, threshold_output_message_face_reid);
 DEFINE_string(fg, "", reid_gallery_path_message);
+DEFINE_string(fg_cache, "", fg_cache_message);
+DEFINE_int32(fg_index_lists, 0, fg_index_lists_message);
+DEFINE_int32(fg_index_probes, 1, fg_index_probes_message);
 DEFINE_bool(no_show, false, no_show_message);
 DEFINE_int32(inh_fd, 600, input_image_height_output_message);
 DEFINE_int32(inw_fd, 600, input_image_width_output_message);
 DEFINE_double(exp_r_fd, 1.15, face_threshold_output_message);
+DEFINE_bool(fd_person_rois, false, fd_person_rois_message);
+DEFINE_int32(fd_skip_confirmed, 0, fd_skip_confirmed_message);
 DEFINE_string(teacher_id, "", teacher_id_message);
 DEFINE_double(min_ad, 1.0, min_action_duration_message);
 DEFINE_double(d_ad, 1.0, same_action_time_delta_message);
@@ -98,6 +120,7 @@ DEFINE_bool(crop_gallery, false, crop_gallery_message);
 DEFINE_double(t_reg_fd, 0.9, face_threshold_registration_output_message);
 DEFINE_int32(min_size_fr, 128, min_size_fr_reg_output_message);
 DEFINE_string(al, "", act_det_output_message);
+DEFINE_string(fl, "", frames_log_output_message);
 DEFINE_int32(ss_t, -1, tracker_smooth_size_message);
 DEFINE_string(u, "", utilization_monitors_message);
 
@@ -123,6 +146,7 @@ static void showUsage() {
     std::cout << "    -d_fd '<device>'               " << target_device_message_face_detection << std::endl;
     std::cout << "    -d_lm '<device>'               " << target_device_message_landmarks_regression << std::endl;
     std::cout << "    -d_reid '<device>'             " << target_device_message_face_reid << std::endl;
+    std::cout << "    -nireq \"<integer>\"             " << num_infer_requests_message << std::endl;
     std::cout << "    -greedy_reid_matching          " << greedy_reid_matching_message << std::endl;
     std::cout << "    -r                             " << raw_output_message << std::endl;
     std::cout << "    -ad                            " << act_stat_output_message << std::endl;
@@ -132,8 +156,13 @@ static void showUsage() {
     std::cout << "    -inh_fd                        " << input_image_height_output_message << std::endl;
     std::cout << "    -inw_fd                        " << input_image_width_output_message << std::endl;
     std::cout << "    -exp_r_fd                      " << expand_ratio_output_message << std::endl;
+    std::cout << "    -fd_person_rois                " << fd_person_rois_message << std::endl;
+    std::cout << "    -fd_skip_confirmed             " << fd_skip_confirmed_message << std::endl;
     std::cout << "    -t_reid                        " << threshold_output_message_face_reid << std::endl;
     std::cout << "    -fg                            " << reid_gallery_path_message << std::endl;
+    std::cout << "    -fg_cache '<path>'             " << fg_cache_message << std::endl;
+    std::cout << "    -fg_index_lists                " << fg_index_lists_message << std::endl;
+    std::cout << "    -fg_index_probes               " << fg_index_probes_message << std::endl;
     std::cout << "    -teacher_id                    " << teacher_id_message << std::endl;
     std::cout << "    -no_show                       " << no_show_message << std::endl;
     std::cout << "    -min_ad                        " << min_action_duration_message << std::endl;
@@ -147,6 +176,7 @@ static void showUsage() {
     std::cout << "    -t_reg_fd                      " << face_threshold_registration_output_message << std::endl;
     std::cout << "    -min_size_fr                   " << min_size_fr_reg_output_message << std::endl;
     std::cout << "    -al                            " << act_det_output_message << std::endl;
+    std::cout << "    -fl                            " << frames_log_output_message << std::endl;
     std::cout << "    -ss_t                          " << tracker_smooth_size_message << std::endl;
     std::cout << "    -u                             " << utilization_monitors_message << std::endl;
 }
@@ -2,6 +2,9 @@
 // SPDX-License-Identifier: Apache-2.0
 //
 
+#include <stdint.h>
+#include <string.h>
+
 #include <algorithm>
 #include <limits>
 #include <numeric>
@@ -12,6 +15,8 @@
 
 #include "openvino/openvino.hpp"
 
+#include "utils/nms.hpp"
+
 #include "action_detector.hpp"
 
 #define SSD_LOCATION_RECORD_SIZE 4
@@ -265,22 +270,41 @@ DetectedActions ActionDetection::GetDetections(const cv::Mat& loc, const cv::Mat
         action_conf_data[i] = reinterpret_cast<float*>(add_conf[i].data);
     }
 
+    // Threshold the detection confidence of all candidates first. The loop has no branches, so it is vectorized,
+    // and as few candidates pass, the mask is then scanned 8 bytes at a time.
+    const size_t mask_size = (m_num_candidates + 7) / 8 * 8;
+    m_passed_mask.resize(mask_size);
+    uint8_t* passed = m_passed_mask.data();
+    const float det_threshold = m_config.detection_confidence_threshold;
+    for (int p = 0; p < m_num_candidates; ++p) {
+        passed[p] = det_conf_data[p * NUM_DETECTION_CLASSES + POSITIVE_DETECTION_IDX] >= det_threshold;
+    }
+    std::fill(passed + m_num_candidates, passed + mask_size, 0);
+
     // Variable to store all detection candidates
-    DetectedActions valid_detections;
+    m_valid_detections.clear();
 
-    // Iterate over all candidate bboxes
+    // Iterate over the candidate bboxes passing the threshold, in increasing order, so the head ID only grows
+    int head_id = 0;
     for (int p = 0; p < m_num_candidates; ++p) {
+        // Skip low-confidence detections, whole blocks of 8 at once
+        if (p % 8 == 0) {
+            uint64_t block_mask;
+            memcpy(&block_mask, passed + p, sizeof(block_mask));
+            if (block_mask == 0) {
+                p += 7;
+                continue;
+            }
+        }
+        if (!passed[p]) {
+            continue;
+        }
+
         // Parse detection confidence from the SSD Detection output
         const float detection_conf =
                 det_conf_data[p * NUM_DETECTION_CLASSES + POSITIVE_DETECTION_IDX];
 
-        // Skip low-confidence detections
-        if (detection_conf < m_config.detection_confidence_threshold) {
-            continue;
-        }
-
         // Estimate the action head ID
-        int head_id = 0;
         while (p >= m_head_ranges[head_id + 1]) {
             ++head_id;
         }
@@ -341,78 +365,28 @@ DetectedActions ActionDetection::GetDetections(const cv::Mat& loc, const cv::Mat
         const auto det_rect = ConvertToRect(priorbox, variance, encoded_bbox, frame_size);
 
         // Store detected action
-        valid_detections.emplace_back(det_rect, action_label, detection_conf, action_conf);
+        m_valid_detections.emplace_back(det_rect, action_label, detection_conf, action_conf);
     }
 
     // Merge most overlapped detections
-    std::vector<int> out_det_indices;
-    SoftNonMaxSuppression(valid_detections, m_config.nms_sigma, m_config.keep_top_k,
-                          m_config.detection_confidence_threshold, &out_det_indices);
+    m_nms_boxes.clear();
+    for (const auto& detection : m_valid_detections) {
+        const cv::Rect& rect = detection.rect;
+        m_nms_boxes.add(static_cast<float>(rect.x), static_cast<float>(rect.y),
+                        static_cast<float>(rect.x + rect.width), static_cast<float>(rect.y + rect.height),
+                        detection.detection_conf);
+    }
+    NmsParams nms_params;
+    nms_params.method = NmsMethod::Soft;
+    nms_params.softNmsSigma = m_config.nms_sigma;
+    nms_params.topK = m_config.keep_top_k;
+    nms_params.scoreThreshold = m_config.detection_confidence_threshold;
+    const std::vector<int> out_det_indices = nms(m_nms_boxes, nms_params);
 
     DetectedActions detections;
+    detections.reserve(out_det_indices.size());
     for (size_t i = 0; i < out_det_indices.size(); ++i) {
-        detections.emplace_back(valid_detections[out_det_indices[i]]);
+        detections.emplace_back(m_valid_detections[out_det_indices[i]]);
     }
     return detections;
 }
-
-void ActionDetection::SoftNonMaxSuppression(const DetectedActions& detections,
-        const float sigma, size_t top_k, const float min_det_conf,
-        std::vector<int>* out_indices) const {
-    // Store input bbox scores
-    std::vector<float> scores(detections.size());
-    for (size_t i = 0; i < detections.size(); ++i) {
-        scores[i] = detections[i].detection_conf;
-    }
-
-    top_k = std::min(top_k, scores.size());
-
-    // Select top-k score indices
-    std::vector<size_t> score_idx(scores.size());
-    std::iota(score_idx.begin(), score_idx.end(), 0);
-    std::nth_element(score_idx.begin(), score_idx.begin() + top_k, score_idx.end(),
-        [&scores](size_t i1, size_t i2) {return scores[i1] > scores[i2];});
-
-    // Extract top-k score values
-    std::vector<float> top_scores(top_k);
-    for (size_t i = 0; i < top_scores.size(); ++i) {
-        top_scores[i] = scores[score_idx[i]];
-    }
-
-    // Carry out Soft Non-Maximum Suppression algorithm
-    out_indices->clear();
-    for (size_t step = 0; step < top_scores.size(); ++step) {
-        auto best_score_itr = std::max_element(top_scores.begin(), top_scores.end());
-        if (*best_score_itr < min_det_conf) {
-            break;
-        }
-
-        // Add current bbox to output list
-        const size_t local_anchor_idx = std::distance(top_scores.begin(), best_score_itr);
-        const int anchor_idx = score_idx[local_anchor_idx];
-        out_indices->emplace_back(anchor_idx);
-        *best_score_itr = 0.f;
-
-        // Update top_scores of the rest bboxes
-        for (size_t local_reference_idx = 0; local_reference_idx < top_scores.size(); ++local_reference_idx) {
-            // Skip updating step for the low-confidence bbox
-            if (top_scores[local_reference_idx] < min_det_conf) {
-                continue;
-            }
-
-            // Calculate the Intersection over Union metric between two bboxes
-            const size_t reference_idx = score_idx[local_reference_idx];
-            const auto& rect1 = detections[anchor_idx].rect;
-            const auto& rect2 = detections[reference_idx].rect;
-            const auto intersection = rect1 & rect2;
-            float overlap = 0.f;
-            if (intersection.width > 0 && intersection.height > 0) {
-                const int intersection_area = intersection.area();
-                overlap = static_cast<float>(intersection_area) / static_cast<float>(rect1.area() + rect2.area() - intersection_area);
-            }
-
-            // Scale bbox score using the exponential rule
-            top_scores[local_reference_idx] *= std::exp(-overlap * overlap / sigma);
-        }
-    }
-}
@@ -62,40 +62,35 @@ void CnnDLSDKBase::Load() {
 
     m_modelShape[ov::layout::batch_idx(m_modelLayout)] = m_config.m_max_batch_size;
 
-    m_compiled_model = m_config.m_core.compile_model(model, m_config.m_deviceName);
+    ov::AnyMap config;
+    if (m_config.m_num_requests > 1) {
+        config = {ov::hint::performance_mode(ov::hint::PerformanceMode::THROUGHPUT),
+                  ov::hint::num_requests(m_config.m_num_requests)};
+    }
+    m_compiled_model = m_config.m_core.compile_model(model, m_config.m_deviceName, config);
     logCompiledModelInfo(m_compiled_model, m_config.m_path_to_model, m_config.m_deviceName, m_config.m_model_type);
 
-    m_infer_request = m_compiled_model.create_infer_request();
+    const ov::Shape tensorShape{m_modelShape[ov::layout::batch_idx(m_modelLayout)],
+                                m_modelShape[ov::layout::height_idx(m_modelLayout)],
+                                m_modelShape[ov::layout::width_idx(m_modelLayout)],
+                                m_modelShape[ov::layout::channels_idx(m_modelLayout)]};
+    m_infer_engine.reset(new BatchInferEngine(m_compiled_model,
+                                              static_cast<size_t>(std::max(m_config.m_num_requests, 1)),
+                                              tensorShape,
+                                              desiredLayout));
 }
 
 void CnnDLSDKBase::InferBatch(
         const std::vector<cv::Mat>& frames,
         const std::function<void(const std::map<std::string, ov::Tensor>&, size_t)>& fetch_results) const {
-    ov::Tensor input_tensor = m_infer_request.get_tensor(m_input_tensor_name);
-
-    size_t num_imgs = frames.size();
-
-    size_t h = m_modelShape[ov::layout::height_idx(m_modelLayout)];
-    size_t w = m_modelShape[ov::layout::width_idx(m_modelLayout)];
-    size_t c = m_modelShape[ov::layout::channels_idx(m_modelLayout)];
-
-    // shrink tensor from default m_config.m_max_batch_size to actual num of images;
-    input_tensor.set_shape({ num_imgs, h, w, c });
-
-    for (size_t i = 0; i < num_imgs; i++) {
-        resize2tensor(frames[i], ov::Tensor{ input_tensor, {i, 0, 0, 0}, {i + 1, h, w, c} });
-    }
-
-    m_infer_request.set_input_tensor(ov::Tensor{ input_tensor, { 0, 0, 0, 0 }, {num_imgs, h, w, c} });
-
-    m_infer_request.infer();
-
-    std::map<std::string, ov::Tensor> output_tensors;
-    for (const auto& output_tensor_name : m_output_tensors_names) {
-        output_tensors[output_tensor_name] = m_infer_request.get_tensor(output_tensor_name);
-    }
-
-    fetch_results(output_tensors, num_imgs);
+    auto fetch = [&](ov::InferRequest& request, size_t batch_size) {
+        std::map<std::string, ov::Tensor> output_tensors;
+        for (const auto& output_tensor_name : m_output_tensors_names) {
+            output_tensors[output_tensor_name] = request.get_tensor(output_tensor_name);
+        }
+        fetch_results(output_tensors, batch_size);
+    };
+    m_infer_engine->infer(frames, resize2tensor, fetch);
 }
 
 VectorCNN::VectorCNN(const Config& config) : CnnDLSDKBase(config) {
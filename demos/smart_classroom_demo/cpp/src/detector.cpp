@@ -3,8 +3,10 @@
 //
 
 #include <algorithm>
+#include <cmath>
 #include <string>
 #include <map>
+#include <vector>
 
 #include <opencv2/core/core.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
@@ -43,6 +45,37 @@ cv::Rect IncreaseRect(const cv::Rect& r, float coeff_x, float coeff_y) {
 
     return cv::Rect(new_tl_int, new_br_int);
 }
+
+// Black gap between crops of the mosaic, so a detection doesn't span two persons
+const int kTilesGap = 4;
+// Crops aren't shrunk further to fit the mosaic, ones which don't fit at this scale are skipped
+const float kMinTileScale = 0.05f;
+
+// Places the scaled sizes in rows, from the tallest one. Sizes which don't fit get empty tiles.
+// Returns true if every size fits into the canvas.
+bool PackTiles(const std::vector<cv::Rect>& rois, const std::vector<size_t>& order, float scale,
+               const cv::Size& canvas, std::vector<cv::Rect>* tiles) {
+    tiles->assign(rois.size(), cv::Rect());
+    bool all_fit = true;
+    cv::Point pos(0, 0);
+    int row_height = 0;
+    for (size_t idx : order) {
+        cv::Size size(std::max(1, static_cast<int>(std::ceil(rois[idx].width * scale))),
+                      std::max(1, static_cast<int>(std::ceil(rois[idx].height * scale))));
+        if (pos.x + size.width > canvas.width) {
+            pos = cv::Point(0, pos.y + row_height + kTilesGap);
+            row_height = 0;
+        }
+        if (pos.x + size.width > canvas.width || pos.y + size.height > canvas.height) {
+            all_fit = false;
+            continue;
+        }
+        (*tiles)[idx] = cv::Rect(pos, size);
+        pos.x += size.width + kTilesGap;
+        row_height = std::max(row_height, size.height);
+    }
+    return all_fit;
+}
 }  // namespace
 
 FaceDetection::FaceDetection(const DetectorConfig& config) :
@@ -128,6 +161,7 @@ void FaceDetection::enqueue(const cv::Mat& frame) {
 
     m_width = static_cast<float>(frame.cols);
     m_height = static_cast<float>(frame.rows);
+    m_roi_mode = false;
 
     ov::Tensor inputTensor = m_request->get_tensor(m_input_name);
 
@@ -136,8 +170,88 @@ void FaceDetection::enqueue(const cv::Mat& frame) {
     m_enqueued_frames = 1;
 }
 
+void FaceDetection::enqueueRois(const cv::Mat& frame, const std::vector<cv::Rect>& rois) {
+    if (m_request == nullptr) {
+        m_request = std::make_shared<ov::InferRequest>(m_model.create_infer_request());
+    }
+
+    m_width = static_cast<float>(frame.cols);
+    m_height = static_cast<float>(frame.rows);
+    m_roi_mode = true;
+    m_enqueued_frames = 0;
+
+    m_tile_rois.clear();
+    for (const auto& roi : rois) {
+        cv::Rect valid_roi = roi & cv::Rect(0, 0, frame.cols, frame.rows);
+        if (valid_roi.area() > 0) {
+            m_tile_rois.push_back(valid_roi);
+        }
+    }
+    m_tiles.clear();
+    if (m_tile_rois.empty()) {
+        return;
+    }
+
+    std::vector<size_t> order(m_tile_rois.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        return m_tile_rois[a].height > m_tile_rois[b].height;
+    });
+
+    // Crops are never upscaled, the largest scale at which all of them fit is used
+    const cv::Size canvas(m_config.input_w, m_config.input_h);
+    m_tile_scale = 1.0f;
+    while (!PackTiles(m_tile_rois, order, m_tile_scale, canvas, &m_tiles) && m_tile_scale * 0.9f >= kMinTileScale) {
+        m_tile_scale *= 0.9f;
+    }
+
+    m_mosaic.create(canvas, frame.type());
+    m_mosaic.setTo(cv::Scalar::all(0));
+    bool has_tiles = false;
+    for (size_t i = 0; i < m_tiles.size(); ++i) {
+        if (m_tiles[i].area() > 0) {
+            cv::Mat tile = m_mosaic(m_tiles[i]);
+            cv::resize(frame(m_tile_rois[i]), tile, tile.size());
+            has_tiles = true;
+        }
+    }
+    if (!has_tiles) {
+        m_tiles.clear();
+        return;
+    }
+
+    ov::Tensor inputTensor = m_request->get_tensor(m_input_name);
+
+    resize2tensor(m_mosaic, inputTensor);
+
+    m_enqueued_frames = 1;
+}
+
+bool FaceDetection::MapFromTiles(const cv::Rect2f& box, cv::Rect* rect) const {
+    const cv::Point2f center = (box.tl() + box.br()) * 0.5f;
+    for (size_t i = 0; i < m_tiles.size(); ++i) {
+        const cv::Rect2f tile = m_tiles[i];
+        if (!tile.contains(center)) {
+            continue;
+        }
+        const cv::Rect2f clipped = box & tile;
+        const cv::Point2f roi_tl = m_tile_rois[i].tl();
+        const cv::Point2f tl = roi_tl + (clipped.tl() - tile.tl()) * (1.0f / m_tile_scale);
+        const cv::Point2f br = roi_tl + (clipped.br() - tile.tl()) * (1.0f / m_tile_scale);
+        *rect = cv::Rect(cv::Point(static_cast<int>(std::round(tl.x)), static_cast<int>(std::round(tl.y))),
+                         cv::Point(static_cast<int>(std::round(br.x)), static_cast<int>(std::round(br.y))));
+        return true;
+    }
+    return false;
+}
+
 DetectedObjects FaceDetection::fetchResults() {
     DetectedObjects results;
+    if (m_roi_mode && m_tiles.empty()) {
+        return results;
+    }
     const float* data = m_request->get_tensor(m_output_name).data<float>();
 
     for (int det_id = 0; det_id < m_max_detections_count; ++det_id) {
@@ -148,19 +262,27 @@ DetectedObjects FaceDetection::fetchResults() {
             break;
         }
 
+        // Detections of the mosaic are in its coordinates and are mapped to the frame through their crops
+        const float width = m_roi_mode ? static_cast<float>(m_mosaic.cols) : m_width;
+        const float height = m_roi_mode ? static_cast<float>(m_mosaic.rows) : m_height;
         const float score = std::min(std::max(0.0f, data[start_pos + 2]), 1.0f);
-        const float x0 = std::min(std::max(0.0f, data[start_pos + 3]), 1.0f) * m_width;
-        const float y0 = std::min(std::max(0.0f, data[start_pos + 4]), 1.0f) * m_height;
-        const float x1 = std::min(std::max(0.0f, data[start_pos + 5]), 1.0f) * m_width;
-        const float y1 = std::min(std::max(0.0f, data[start_pos + 6]), 1.0f) * m_height;
+        const float x0 = std::min(std::max(0.0f, data[start_pos + 3]), 1.0f) * width;
+        const float y0 = std::min(std::max(0.0f, data[start_pos + 4]), 1.0f) * height;
+        const float x1 = std::min(std::max(0.0f, data[start_pos + 5]), 1.0f) * width;
+        const float y1 = std::min(std::max(0.0f, data[start_pos + 6]), 1.0f) * height;
 
         DetectedObject object;
         object.confidence = score;
-        object.rect = cv::Rect(cv::Point(static_cast<int>(round(static_cast<double>(x0))),
-                                         static_cast<int>(round(static_cast<double>(y0)))),
-                               cv::Point(static_cast<int>(round(static_cast<double>(x1))),
-                                         static_cast<int>(round(static_cast<double>(y1)))));
-
+        if (m_roi_mode) {
+            if (!MapFromTiles(cv::Rect2f(cv::Point2f(x0, y0), cv::Point2f(x1, y1)), &object.rect)) {
+                continue;
+            }
+        } else {
+            object.rect = cv::Rect(cv::Point(static_cast<int>(round(static_cast<double>(x0))),
+                                             static_cast<int>(round(static_cast<double>(y0)))),
+                                   cv::Point(static_cast<int>(round(static_cast<double>(x1))),
+                                             static_cast<int>(round(static_cast<double>(y1)))));
+        }
 
         object.rect = TruncateToValidRect(IncreaseRect(object.rect,
                                                        m_config.increase_scale_x,
@@ -6,6 +6,8 @@
 #include <string>
 #include <map>
 #include <set>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 #include <fstream>
 
@@ -19,16 +21,43 @@ std::string GetUnknownOrLabel(const std::vector<std::string>& labels, int idx)
     return idx >= 0 ? labels.at(idx) : unknown_label;
 }
 
+// Formatted records are written in chunks of this size
+const size_t frames_log_chunk_size = 1 << 20;
+
 std::string FrameIdxToString(const std::string& path, int frame_idx) {
     std::stringstream ss;
     ss << std::setw(6) << std::setfill('0') << frame_idx;
     return path.substr(path.rfind("/") + 1) + "@" + ss.str();
 }
+
+void AppendJsonString(std::string& out, const std::string& str) {
+    out += '"';
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+    out += '"';
+}
+
+void AppendJsonRect(std::string& out, const cv::Rect& rect) {
+    out += '[';
+    out += std::to_string(rect.x);
+    out += ", ";
+    out += std::to_string(rect.y);
+    out += ", ";
+    out += std::to_string(rect.width);
+    out += ", ";
+    out += std::to_string(rect.height);
+    out += ']';
+}
 }  // anonymous namespace
 
 DetectionsLogger::DetectionsLogger(slog::LogStream& stream, bool enabled,
                                    const std::string& act_stat_log_file,
-                                   const std::string& act_det_log_file) :
+                                   const std::string& act_det_log_file,
+                                   const std::string& frames_log_file) :
     m_log_stream(stream) {
     m_write_logs = enabled;
     m_act_stat_log_stream.open(act_stat_log_file, std::fstream::out);
@@ -38,22 +67,49 @@ DetectionsLogger::DetectionsLogger(slog::LogStream& stream, bool enabled,
 
         m_act_det_log_stream << "data" << "[";
     }
+
+    if (!frames_log_file.empty()) {
+        m_frames_log_stream.open(frames_log_file, std::fstream::out);
+        if (!m_frames_log_stream) {
+            throw std::runtime_error("Can't open " + frames_log_file);
+        }
+        m_writing_thread = std::thread(&DetectionsLogger::WritingThreadFunc, this);
+    }
+}
+
+void DetectionsLogger::LogFrame(
+    const std::string& path, const int frame_idx, const size_t width, const size_t height) {
+    m_log_stream << "Frame_name: " << path << "@" << frame_idx << " width: "
+                 << width << " height: " << height << slog::endl;
+}
+
+void DetectionsLogger::LogFace(const cv::Rect& rect, const std::string& id, const std::string& action) {
+    m_log_stream << "Object type: face. Box: " << rect << " id: " << id;
+    if (!action.empty()) {
+        m_log_stream << " action: " << action;
+    }
+    m_log_stream << slog::endl;
 }
 
 void DetectionsLogger::CreateNextFrameRecord(
     const std::string& path, const int frame_idx, const size_t width, const size_t height) {
     if (m_write_logs)
-        m_log_stream << "Frame_name: " << path << "@" << frame_idx << " width: "
-                     << width << " height: " << height << slog::endl;
+        LogFrame(path, frame_idx, width, height);
+    if (m_writing_thread.joinable()) {
+        m_frame.frame_idx = frame_idx;
+        m_frame.width = width;
+        m_frame.height = height;
+        m_frame.objects.clear();
+        m_frame.action_detections.clear();
+    }
 }
 
 void DetectionsLogger::AddFaceToFrame(const cv::Rect& rect, const std::string& id, const std::string& action) {
     if (m_write_logs) {
-        m_log_stream << "Object type: face. Box: " << rect << " id: " << id;
-        if (!action.empty()) {
-            m_log_stream << " action: " << action;
-        }
-        m_log_stream << slog::endl;
+        LogFace(rect, id, action);
+    }
+    if (m_writing_thread.joinable()) {
+        m_frame.objects.push_back({true, rect, id, action});
     }
 }
 
@@ -65,21 +121,92 @@ void DetectionsLogger::AddPersonToFrame(const cv::Rect& rect, const std::string&
         }
         m_log_stream << slog::endl;
     }
+    if (m_writing_thread.joinable()) {
+        m_frame.objects.push_back({false, rect, id, action});
+    }
 }
 
 void DetectionsLogger::AddDetectionToFrame(const TrackedObject& object, const int frame_idx) {
     if (m_act_det_log_stream.isOpened()) {
-        m_act_det_log_stream << "{" << "frame_id" << frame_idx
-                             << "det_conf" << object.confidence
-                             << "label" << object.label
-                             << "rect" << object.rect << "}";
+        const ActionDetectionRecord record{frame_idx, object.confidence, object.label, object.rect};
+        if (m_writing_thread.joinable()) {
+            m_frame.action_detections.push_back(record);
+        } else {
+            WriteActionDetection(record);
+        }
     }
 }
 
+void DetectionsLogger::WriteActionDetection(const ActionDetectionRecord& record) {
+    m_act_det_log_stream << "{" << "frame_id" << record.frame_idx
+                         << "det_conf" << record.confidence
+                         << "label" << record.label
+                         << "rect" << record.rect << "}";
+}
+
 void DetectionsLogger::FinalizeFrameRecord() {
     if (m_write_logs) {
         m_log_stream << slog::endl;
     }
+    if (m_writing_thread.joinable()) {
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            m_queued_frames.push_back(std::move(m_frame));
+        }
+        m_cond_var.notify_one();
+        m_frame = FrameRecord();
+    }
+}
+
+void DetectionsLogger::WritingThreadFunc() {
+    std::vector<FrameRecord> frames;
+    std::string buffer;
+    buffer.reserve(2 * frames_log_chunk_size);
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cond_var.wait(lock, [&]() {
+                return !m_queued_frames.empty() || m_stop_writing;
+            });
+            if (m_queued_frames.empty()) {
+                break;
+            }
+            // The queue keeps the capacity of the processed vector
+            frames.swap(m_queued_frames);
+        }
+        for (const FrameRecord& frame : frames) {
+            buffer += "{\"frame_idx\": ";
+            buffer += std::to_string(frame.frame_idx);
+            buffer += ", \"width\": ";
+            buffer += std::to_string(frame.width);
+            buffer += ", \"height\": ";
+            buffer += std::to_string(frame.height);
+            buffer += ", \"objects\": [";
+            for (size_t i = 0; i < frame.objects.size(); ++i) {
+                const ObjectRecord& object = frame.objects[i];
+                buffer += i ? ", {\"type\": " : "{\"type\": ";
+                buffer += object.is_face ? "\"face\"" : "\"person\"";
+                buffer += ", \"box\": ";
+                AppendJsonRect(buffer, object.rect);
+                buffer += ", \"id\": ";
+                AppendJsonString(buffer, object.id);
+                buffer += ", \"action\": ";
+                AppendJsonString(buffer, object.action);
+                buffer += '}';
+            }
+            buffer += "]}\n";
+            for (const ActionDetectionRecord& record : frame.action_detections) {
+                WriteActionDetection(record);
+            }
+        }
+        frames.clear();
+        if (buffer.size() >= frames_log_chunk_size) {
+            m_frames_log_stream.write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    }
+    m_frames_log_stream.write(buffer.data(), buffer.size());
+    m_frames_log_stream.flush();
 }
 
 void DetectionsLogger::DumpDetections(const std::string& video_path,
@@ -109,7 +236,8 @@ void DetectionsLogger::DumpDetections(const std::string& video_path,
     m_act_stat_log_stream << std::endl;
 
     for (size_t i = 0; i < num_frames; i++)  {
-        CreateNextFrameRecord(video_path, i, frame_size.width, frame_size.height);
+        if (m_write_logs)
+            LogFrame(video_path, i, frame_size.width, frame_size.height);
         const auto& frame_face_obj_id_to_action = frame_face_obj_id_to_action_maps.at(i);
         for (auto& kv : face_label_to_action) {
             kv.second = unknown_label;
@@ -123,7 +251,8 @@ void DetectionsLogger::DumpDetections(const std::string& video_path,
             }
             std::string face_label = GetUnknownOrLabel(person_id_to_label, track_id_to_label_faces.at(obj.object_id));
             face_label_to_action[face_label] = action_label;
-            AddFaceToFrame(obj.rect, face_label, action_label);
+            if (m_write_logs)
+                LogFace(obj.rect, face_label, action_label);
         }
 
         m_act_stat_log_stream << FrameIdxToString(video_path, i);
@@ -132,7 +261,8 @@ void DetectionsLogger::DumpDetections(const std::string& video_path,
         }
         m_act_stat_log_stream << std::endl;
 
-        FinalizeFrameRecord();
+        if (m_write_logs)
+            m_log_stream << slog::endl;
     }
 }
 
@@ -160,6 +290,14 @@ void DetectionsLogger::DumpTracks(const std::map<int, RangeEventsTrack>& obj_id_
 }
 
 DetectionsLogger::~DetectionsLogger() {
+    if (m_writing_thread.joinable()) {
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop_writing = true;
+        }
+        m_cond_var.notify_one();
+        m_writing_thread.join();
+    }
     if (m_act_det_log_stream.isOpened()) {
         m_act_det_log_stream << "]";
     }
@@ -2,24 +2,44 @@
 // SPDX-License-Identifier: Apache-2.0
 //
 
+#include <algorithm>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <memory>
 #include <vector>
 #include <string>
 #include <limits>
+#include <utility>
 
 #include <opencv2/opencv.hpp>
+#include <utils/kuhn_munkres.hpp>
+#include <utils/linear_assignment.hpp>
+#include <utils/slog.hpp>
 
 #include "face_reid.hpp"
 #include "tracker.hpp"
 
 namespace {
-    float ComputeReidDistance(const cv::Mat& descr1, const cv::Mat& descr2) {
-        float xy = static_cast<float>(descr1.dot(descr2));
-        float xx = static_cast<float>(descr1.dot(descr1));
-        float yy = static_cast<float>(descr2.dot(descr2));
-        float norm = sqrt(xx * yy) + 1e-6f;
-        return 1.0f - xy / norm;
+    // The number of the nearest gallery embeddings an embedding may be matched
+    // with if the index is used
+    constexpr int kIndexCandidatesNum = 10;
+
+    // Returns a CV_32F row of unit length, so the cosine distance between two
+    // rows is one minus their dot product
+    cv::Mat NormalizeEmbedding(const cv::Mat& embedding) {
+        cv::Mat row;
+        embedding.reshape(1, 1).convertTo(row, CV_32F);
+        row /= cv::norm(row) + 1e-6;
+        return row;
+    }
+
+    cv::Mat StackEmbeddings(const std::vector<cv::Mat>& embeddings) {
+        cv::Mat stacked;
+        for (const auto& embedding : embeddings)
+            stacked.push_back(NormalizeEmbedding(embedding));
+        return stacked;
     }
 
     bool file_exists(const std::string& name) {
@@ -43,6 +63,135 @@ namespace {
         return std::string(".") + separator();
     }
 
+    std::vector<char> read_file(const std::string& path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.good())
+            return {};
+        std::vector<char> content(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(content.data(), content.size());
+        return content;
+    }
+
+    // 64-bit FNV-1a
+    uint64_t hash_bytes(const char* data, size_t size, uint64_t hash = 14695981039346656037ull) {
+        for (size_t i = 0; i < size; i++) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    uint64_t hash_model(const std::string& path_to_model, uint64_t hash) {
+        std::vector<char> model = read_file(path_to_model);
+        hash = hash_bytes(model.data(), model.size(), hash);
+        const size_t ext_pos = path_to_model.rfind(".xml");
+        if (ext_pos != std::string::npos && ext_pos + 4 == path_to_model.size()) {
+            std::vector<char> weights = read_file(path_to_model.substr(0, ext_pos) + ".bin");
+            hash = hash_bytes(weights.data(), weights.size(), hash);
+        }
+        return hash;
+    }
+
+    // The gallery cache keeps the registration result of every gallery image,
+    // so only new or changed images are processed by the networks on start.
+    // It is a native-endian binary file:
+    //   header: magic, the key of the models and settings, number of images,
+    //           size of embeddings (rows and cols)
+    //   images: path length, path, content hash, registration status
+    //   embeddings: contiguous floats, an embedding per image
+    struct CachedImage {
+        uint64_t hash;
+        RegistrationStatus status;
+        cv::Mat embedding;
+    };
+
+    const char kCacheMagic[8] = {'O', 'M', 'Z', 'G', 'A', 'L', '0', '1'};
+
+    template <typename T>
+    bool read_value(std::ifstream& file, T& value) {
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    }
+
+    template <typename T>
+    void write_value(std::ofstream& file, const T& value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    std::map<std::string, CachedImage> load_gallery_cache(const std::string& path, uint64_t key) {
+        std::ifstream file(path, std::ios::binary);
+        char magic[sizeof(kCacheMagic)];
+        uint64_t cache_key;
+        uint32_t images_num, rows, cols;
+        if (!file.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), kCacheMagic)
+            || !read_value(file, cache_key) || cache_key != key
+            || !read_value(file, images_num) || !read_value(file, rows) || !read_value(file, cols))
+            return {};
+
+        std::vector<std::pair<std::string, CachedImage>> images(images_num);
+        for (auto& image : images) {
+            uint32_t path_size;
+            int32_t status;
+            if (!read_value(file, path_size))
+                return {};
+            image.first.resize(path_size);
+            if (!file.read(&image.first[0], path_size) || !read_value(file, image.second.hash)
+                || !read_value(file, status))
+                return {};
+            image.second.status = static_cast<RegistrationStatus>(status);
+        }
+        cv::Mat embeddings(static_cast<int>(images_num), static_cast<int>(rows * cols), CV_32F);
+        if (!embeddings.empty() && !file.read(embeddings.ptr<char>(), embeddings.total() * embeddings.elemSize()))
+            return {};
+
+        std::map<std::string, CachedImage> cache;
+        for (size_t i = 0; i < images.size(); i++) {
+            CachedImage& image = images[i].second;
+            if (image.status == RegistrationStatus::SUCCESS)
+                image.embedding = embeddings.row(static_cast<int>(i)).reshape(1, static_cast<int>(rows)).clone();
+            cache.emplace(images[i].first, image);
+        }
+        return cache;
+    }
+
+    void save_gallery_cache(const std::string& path, uint64_t key, const std::map<std::string, CachedImage>& cache) {
+        cv::Size embedding_size;
+        for (const auto& image : cache) {
+            if (image.second.status == RegistrationStatus::SUCCESS) {
+                embedding_size = image.second.embedding.size();
+                break;
+            }
+        }
+
+        std::ofstream file(path, std::ios::binary);
+        if (!file.good()) {
+            slog::warn << "Can't write the faces gallery cache to " << path << slog::endl;
+            return;
+        }
+        file.write(kCacheMagic, sizeof(kCacheMagic));
+        write_value(file, key);
+        write_value(file, static_cast<uint32_t>(cache.size()));
+        write_value(file, static_cast<uint32_t>(embedding_size.height));
+        write_value(file, static_cast<uint32_t>(embedding_size.width));
+        for (const auto& image : cache) {
+            write_value(file, static_cast<uint32_t>(image.first.size()));
+            file.write(image.first.data(), image.first.size());
+            write_value(file, image.second.hash);
+            write_value(file, static_cast<int32_t>(image.second.status));
+        }
+        std::vector<float> zeros(embedding_size.area(), 0.0f);
+        for (const auto& image : cache) {
+            if (image.second.status == RegistrationStatus::SUCCESS) {
+                cv::Mat embedding;
+                image.second.embedding.convertTo(embedding, CV_32F);
+                CV_Assert(embedding.size() == embedding_size && embedding.isContinuous());
+                file.write(embedding.ptr<char>(), embedding.total() * embedding.elemSize());
+            } else {
+                file.write(reinterpret_cast<const char*>(zeros.data()), zeros.size() * sizeof(float));
+            }
+        }
+    }
+
 }  // namespace
 
 const char EmbeddingsGallery::unknown_label[] = "Unknown";
@@ -53,13 +202,31 @@ EmbeddingsGallery::EmbeddingsGallery(const std::string& ids_list,
                                      bool crop_gallery, const detection::DetectorConfig& detector_config,
                                      const VectorCNN& landmarks_det,
                                      const VectorCNN& image_reid,
-                                     bool use_greedy_matcher) :
-    reid_threshold(threshold), use_greedy_matcher(use_greedy_matcher) {
+                                     bool use_greedy_matcher,
+                                     int index_lists_num, int index_probes_num,
+                                     const std::string& cache_path) :
+    reid_threshold(threshold), use_greedy_matcher(use_greedy_matcher), index_probes_num(index_probes_num) {
     if (ids_list.empty()) {
         return;
     }
 
-    detection::FaceDetection detector(detector_config);
+    // The networks and the settings the registration depends on
+    uint64_t cache_key = 0;
+    std::map<std::string, CachedImage> cache;
+    if (!cache_path.empty()) {
+        cache_key = hash_model(landmarks_det.modelPath(), hash_bytes(nullptr, 0));
+        cache_key = hash_model(image_reid.modelPath(), cache_key);
+        if (crop_gallery)
+            cache_key = hash_model(detector_config.m_path_to_model, cache_key);
+        cache_key = hash_bytes(reinterpret_cast<const char*>(&min_size_fr), sizeof(min_size_fr), cache_key);
+        cache_key = hash_bytes(reinterpret_cast<const char*>(&crop_gallery), sizeof(crop_gallery), cache_key);
+        cache = load_gallery_cache(cache_path, cache_key);
+    }
+    std::map<std::string, CachedImage> used_cache;
+    size_t registered_num = 0;
+
+    // The detector is loaded only if there are images to register
+    std::unique_ptr<detection::FaceDetection> detector;
 
     cv::FileStorage fs(ids_list, cv::FileStorage::Mode::READ);
     cv::FileNode fn = fs.root();
@@ -83,10 +250,24 @@ EmbeddingsGallery::EmbeddingsGallery(const std::string& ids_list,
                 path = folder_name(ids_list) + separator() + item[i].string();
             }
 
-            cv::Mat image = cv::imread(path);
-            CV_Assert(!image.empty());
-            cv::Mat emb;
-            RegistrationStatus status = RegisterIdentity(label, image, min_size_fr, crop_gallery,  detector, landmarks_det, image_reid, emb);
+            std::vector<char> content = read_file(path);
+            const uint64_t hash = hash_bytes(content.data(), content.size());
+            auto cached = cache.find(path);
+            if (cached == cache.end() || cached->second.hash != hash) {
+                cv::Mat image = cv::imdecode(content, cv::IMREAD_COLOR);
+                CV_Assert(!image.empty());
+                if (!detector)
+                    detector.reset(new detection::FaceDetection(detector_config));
+                CachedImage registered{hash, RegistrationStatus::SUCCESS, cv::Mat()};
+                registered.status = RegisterIdentity(label, image, min_size_fr, crop_gallery, *detector,
+                                                     landmarks_det, image_reid, registered.embedding);
+                cache[path] = registered;
+                cached = cache.find(path);
+                ++registered_num;
+            }
+            used_cache[path] = cached->second;
+            cv::Mat emb = cached->second.embedding;
+            RegistrationStatus status = cached->second.status;
             if (status == RegistrationStatus::SUCCESS) {
                 embeddings.push_back(emb);
                 idx_to_id.push_back(id);
@@ -95,36 +276,121 @@ EmbeddingsGallery::EmbeddingsGallery(const std::string& ids_list,
             }
         }
     }
+
+    // Images removed from the gallery are dropped from the cache too
+    if (!cache_path.empty() && (registered_num > 0 || used_cache.size() != cache.size())) {
+        slog::info << "Faces gallery: " << registered_num << " of " << used_cache.size()
+                   << " images are registered, the cache is updated" << slog::endl;
+        save_gallery_cache(cache_path, cache_key, used_cache);
+    }
+
+    for (const auto& identity : identities) {
+        for (const auto& embedding : identity.embeddings)
+            gallery_embeddings.push_back(NormalizeEmbedding(embedding));
+    }
+    if (index_lists_num > 0)
+        BuildIndex(index_lists_num);
+}
+
+void EmbeddingsGallery::BuildIndex(int lists_num) {
+    if (gallery_embeddings.rows <= kIndexCandidatesNum)
+        return;
+    lists_num = std::min(lists_num, gallery_embeddings.rows);
+
+    cv::Mat labels;
+    cv::kmeans(gallery_embeddings, lists_num, labels,
+               cv::TermCriteria(cv::TermCriteria::COUNT + cv::TermCriteria::EPS, 20, 1e-4),
+               1, cv::KMEANS_PP_CENTERS, index_centroids);
+    for (int i = 0; i < index_centroids.rows; i++) {
+        cv::Mat centroid = index_centroids.row(i);
+        centroid /= cv::norm(centroid) + 1e-6;
+    }
+
+    index_lists.assign(lists_num, {});
+    for (int i = 0; i < labels.rows; i++)
+        index_lists[labels.at<int>(i)].push_back(i);
+}
+
+std::vector<std::pair<float, int>> EmbeddingsGallery::FindCandidates(const cv::Mat& query,
+                                                                     const cv::Mat& centroid_similarities) const {
+    std::vector<int> lists(index_lists.size());
+    for (size_t i = 0; i < lists.size(); i++)
+        lists[i] = static_cast<int>(i);
+    const int probes_num = std::min(index_probes_num, static_cast<int>(lists.size()));
+    const float* list_similarities = centroid_similarities.ptr<float>();
+    std::partial_sort(lists.begin(), lists.begin() + probes_num, lists.end(),
+                      [list_similarities](int a, int b) { return list_similarities[a] > list_similarities[b]; });
+
+    std::vector<std::pair<float, int>> candidates;
+    for (int i = 0; i < probes_num; i++) {
+        for (int row : index_lists[lists[i]]) {
+            const float distance = 1.0f - static_cast<float>(query.dot(gallery_embeddings.row(row)));
+            if (distance <= reid_threshold)
+                candidates.emplace_back(distance, row);
+        }
+    }
+    const size_t candidates_num = std::min(candidates.size(), static_cast<size_t>(kIndexCandidatesNum));
+    std::partial_sort(candidates.begin(), candidates.begin() + candidates_num, candidates.end());
+    candidates.resize(candidates_num);
+    return candidates;
 }
 
 std::vector<int> EmbeddingsGallery::GetIDsByEmbeddings(const std::vector<cv::Mat>& embeddings) const {
     if (embeddings.empty() || idx_to_id.empty())
         return std::vector<int>(embeddings.size(), unknown_id);
 
-    cv::Mat distances(static_cast<int>(embeddings.size()), static_cast<int>(idx_to_id.size()), CV_32F);
+    cv::Mat queries = StackEmbeddings(embeddings);
+    const int rows = queries.rows;
+    const int cols = gallery_embeddings.rows;
+
+    // Pairs farther than the threshold are never matched, so only the gated
+    // pairs are passed to the solver
+    std::vector<LinearAssignment::Edge> edges;
+    if (!index_centroids.empty()) {
+        // Only the nearest embeddings of the probed clusters become candidates
+        cv::Mat centroid_similarities;
+        cv::gemm(queries, index_centroids, 1, cv::noArray(), 0, centroid_similarities, cv::GEMM_2_T);
+        for (int i = 0; i < rows; i++) {
+            for (const auto& candidate : FindCandidates(queries.row(i), centroid_similarities.row(i)))
+                edges.push_back({i, candidate.second, candidate.first});
+        }
+    } else {
+        // Cosine distances to every gallery embedding
+        cv::Mat distances;
+        cv::gemm(queries, gallery_embeddings, -1, cv::noArray(), 0, distances, cv::GEMM_2_T);
+        distances += 1.0f;
 
-    for (int i = 0; i < distances.rows; i++) {
-        int k = 0;
-        for (size_t j = 0; j < identities.size(); j++) {
-            for (const auto& reference_emb : identities[j].embeddings) {
-                distances.at<float>(i, k) = ComputeReidDistance(embeddings[i], reference_emb);
-                k++;
+        if (use_greedy_matcher) {
+            KuhnMunkres matcher(use_greedy_matcher);
+            auto matched_idx = matcher.Solve(distances);
+            std::vector<int> output_ids;
+            for (auto col_idx : matched_idx) {
+                if (int(col_idx) == -1) {
+                    output_ids.push_back(unknown_id);
+                    continue;
+                }
+                if (distances.at<float>(output_ids.size(), col_idx) > reid_threshold)
+                    output_ids.push_back(unknown_id);
+                else
+                    output_ids.push_back(idx_to_id[col_idx]);
             }
+            return output_ids;
         }
-    }
-    KuhnMunkres matcher(use_greedy_matcher);
-    auto matched_idx = matcher.Solve(distances);
-    std::vector<int> output_ids;
-    for (auto col_idx : matched_idx) {
-        if (int(col_idx) == -1) {
-            output_ids.push_back(unknown_id);
-            continue;
+
+        for (int i = 0; i < rows; i++) {
+            const float* distances_ptr = distances.ptr<float>(i);
+            for (int k = 0; k < cols; k++) {
+                if (distances_ptr[k] <= reid_threshold)
+                    edges.push_back({i, k, distances_ptr[k]});
+            }
         }
-        if (distances.at<float>(output_ids.size(), col_idx) > reid_threshold)
-            output_ids.push_back(unknown_id);
-        else
-            output_ids.push_back(idx_to_id[col_idx]);
     }
+
+    LinearAssignment matcher;
+    auto matched_idx = matcher.Solve(rows, cols, edges, static_cast<float>(reid_threshold));
+    std::vector<int> output_ids;
+    for (auto col_idx : matched_idx)
+        output_ids.push_back(int(col_idx) == -1 ? unknown_id : idx_to_id[col_idx]);
     return output_ids;
 }
 
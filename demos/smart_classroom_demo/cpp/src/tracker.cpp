@@ -33,7 +33,60 @@ TrackerParams::TrackerParams() :
     drop_forgotten_tracks(true),
     max_num_objects_in_track(300),
     averaging_window_size_for_rects(1),
-    averaging_window_size_for_labels(1) {}
+    averaging_window_size_for_labels(1),
+    motion_first_matching(false),
+    motion_match_iou_thr(0.7f),
+    motion_ambiguous_iou_thr(0.3f) {}
+
+namespace {
+// Noise of the box filter relative to the box height
+const float kPositionNoise = 1.0f / 20;
+const float kVelocityNoise = 1.0f / 160;
+const float kMeasurementNoise = 1.0f / 20;
+}  // namespace
+
+BoxKalmanFilter::BoxKalmanFilter(const cv::Rect& rect) :
+    m_value(rect.x + rect.width * 0.5f, rect.y + rect.height * 0.5f,
+            static_cast<float>(rect.width), static_cast<float>(rect.height)) {
+    const float h = static_cast<float>(rect.height);
+    const float value_std = 2 * kPositionNoise * h;
+    const float velocity_std = 10 * kVelocityNoise * h;
+    for (int i = 0; i < 4; i++) {
+        m_value_var[i] = value_std * value_std;
+        m_velocity_var[i] = velocity_std * velocity_std;
+    }
+}
+
+cv::Rect BoxKalmanFilter::Predict() {
+    const float h = m_value[3];
+    const float q_value = kPositionNoise * h * kPositionNoise * h;
+    const float q_velocity = kVelocityNoise * h * kVelocityNoise * h;
+    for (int i = 0; i < 4; i++) {
+        m_value[i] += m_velocity[i];
+        m_value_var[i] += 2 * m_covar[i] + m_velocity_var[i] + q_value;
+        m_covar[i] += m_velocity_var[i];
+        m_velocity_var[i] += q_velocity;
+    }
+    return cv::Rect(cvRound(m_value[0] - m_value[2] * 0.5f), cvRound(m_value[1] - m_value[3] * 0.5f),
+                    cvRound(m_value[2]), cvRound(m_value[3]));
+}
+
+void BoxKalmanFilter::Correct(const cv::Rect& rect) {
+    const cv::Vec4f measurement(rect.x + rect.width * 0.5f, rect.y + rect.height * 0.5f,
+                                static_cast<float>(rect.width), static_cast<float>(rect.height));
+    const float r = kMeasurementNoise * rect.height * kMeasurementNoise * rect.height;
+    for (int i = 0; i < 4; i++) {
+        const float innovation_var = m_value_var[i] + r;
+        const float value_gain = m_value_var[i] / innovation_var;
+        const float velocity_gain = m_covar[i] / innovation_var;
+        const float innovation = measurement[i] - m_value[i];
+        m_value[i] += value_gain * innovation;
+        m_velocity[i] += velocity_gain * innovation;
+        m_velocity_var[i] -= velocity_gain * m_covar[i];
+        m_value_var[i] *= 1 - value_gain;
+        m_covar[i] *= 1 - value_gain;
+    }
+}
 
 bool IsInRange(float x, const cv::Vec2f& v) { return v[0] <= x && x <= v[1]; }
 bool IsInRange(float x, float a, float b) { return a <= x && x <= b; }
@@ -50,6 +103,41 @@ void Tracker::FilterDetectionsAndStore(const TrackedObjects& detections) {
     }
 }
 
+void Tracker::MatchByMotion(const std::set<size_t>& track_ids, const TrackedObjects& detections,
+                            std::set<size_t>* unmatched_tracks, std::set<size_t>* unmatched_detections) {
+    const std::vector<size_t> ids(track_ids.begin(), track_ids.end());
+    cv::Mat iou(static_cast<int>(ids.size()), static_cast<int>(detections.size()), CV_32F);
+    for (size_t i = 0; i < ids.size(); i++) {
+        const cv::Rect& predicted = m_tracks.at(ids[i]).predicted_rect;
+        auto ptr = iou.ptr<float>(static_cast<int>(i));
+        for (size_t j = 0; j < detections.size(); j++) {
+            ptr[j] = IoU(predicted, detections[j].rect);
+        }
+    }
+
+    // A pair is matched if neither the track nor the detection has another
+    // close pair, so such matches never conflict
+    for (int i = 0; i < iou.rows; i++) {
+        auto ptr = iou.ptr<float>(i);
+        int best = static_cast<int>(std::max_element(ptr, ptr + iou.cols) - ptr);
+        if (ptr[best] < m_params.motion_match_iou_thr)
+            continue;
+        bool ambiguous = false;
+        for (int j = 0; j < iou.cols && !ambiguous; j++) {
+            ambiguous = j != best && ptr[j] > m_params.motion_ambiguous_iou_thr;
+        }
+        for (int k = 0; k < iou.rows && !ambiguous; k++) {
+            ambiguous = k != i && iou.at<float>(k, best) > m_params.motion_ambiguous_iou_thr;
+        }
+        if (ambiguous)
+            continue;
+
+        AppendToTrack(ids[i], detections[best]);
+        unmatched_tracks->erase(ids[i]);
+        unmatched_detections->erase(best);
+    }
+}
+
 void Tracker::SolveAssignmentProblem(
     const std::set<size_t>& track_ids, const TrackedObjects& detections,
     std::set<size_t>* unmatched_tracks, std::set<size_t>* unmatched_detections,
@@ -64,23 +152,24 @@ void Tracker::SolveAssignmentProblem(
     CV_Assert(matches);
     matches->clear();
 
-    cv::Mat dissimilarity;
-    ComputeDissimilarityMatrix(track_ids, detections, &dissimilarity);
-
-    auto res = KuhnMunkres().Solve(dissimilarity);
+    const std::vector<size_t> ids(track_ids.begin(), track_ids.end());
+    const std::vector<TrackAssociator::Affinity> affinities = {
+        [&](size_t i, size_t j) {
+            return ShapeAffinity(m_params.shape_affinity_w, m_tracks.at(ids[i]).back().rect, detections[j].rect);
+        },
+        [&](size_t i, size_t j) {
+            return MotionAffinity(m_params.motion_affinity_w, m_tracks.at(ids[i]).back().rect, detections[j].rect);
+        }};
+    const auto& res = m_associator.Associate(ids.size(), detections.size(), affinities, m_params.affinity_thr);
 
     for (size_t i = 0; i < detections.size(); i++) {
         unmatched_detections->insert(i);
     }
 
-    size_t i = 0;
-    for (size_t id : track_ids) {
-        if (res[i] < detections.size()) {
-            matches->emplace(id, res[i], 1 - dissimilarity.at<float>(i, res[i]));
-        } else {
-            unmatched_tracks->insert(id);
-        }
-        i++;
+    unmatched_tracks->insert(track_ids.begin(), track_ids.end());
+    for (const auto& match : res) {
+        matches->emplace(ids[match.track], match.detection, match.affinity);
+        unmatched_tracks->erase(ids[match.track]);
     }
 }
 
@@ -134,23 +223,50 @@ void Tracker::Process(const cv::Mat& frame, const TrackedObjects& detections, in
     }
 
     auto active_tracks = m_active_track_ids;
+    for (size_t id : active_tracks) {
+        auto& track = m_tracks.at(id);
+        track.predicted_rect = track.filter.Predict();
+    }
 
     if (!active_tracks.empty() && !m_detections.empty()) {
-        std::set<size_t> unmatched_tracks, unmatched_detections;
-        std::set<std::tuple<size_t, size_t, float>> matches;
-
-        SolveAssignmentProblem(active_tracks, m_detections, &unmatched_tracks,
-                               &unmatched_detections, &matches);
-
-        for (const auto& match : matches) {
-            size_t track_id = std::get<0>(match);
-            size_t det_id = std::get<1>(match);
-            float conf = std::get<2>(match);
-            if (conf > m_params.affinity_thr) {
-                AppendToTrack(track_id, m_detections[det_id]);
-                unmatched_detections.erase(det_id);
-            } else {
-                unmatched_tracks.insert(track_id);
+        std::set<size_t> unmatched_tracks = active_tracks, unmatched_detections;
+        for (size_t i = 0; i < m_detections.size(); i++) {
+            unmatched_detections.insert(i);
+        }
+
+        if (m_params.motion_first_matching)
+            MatchByMotion(active_tracks, m_detections, &unmatched_tracks, &unmatched_detections);
+
+        if (!unmatched_tracks.empty() && !unmatched_detections.empty()) {
+            // Affinities are computed only for the pairs left by motion matching
+            const std::vector<size_t> rest_ids(unmatched_detections.begin(), unmatched_detections.end());
+            TrackedObjects rest_detections;
+            for (size_t id : rest_ids) {
+                rest_detections.push_back(m_detections[id]);
+            }
+
+            std::set<size_t> rest_unmatched_tracks, rest_unmatched_detections;
+            std::set<std::tuple<size_t, size_t, float>> matches;
+
+            SolveAssignmentProblem(unmatched_tracks, rest_detections, &rest_unmatched_tracks,
+                                   &rest_unmatched_detections, &matches);
+
+            for (const auto& match : matches) {
+                size_t track_id = std::get<0>(match);
+                size_t det_id = std::get<1>(match);
+                float conf = std::get<2>(match);
+                if (conf > m_params.affinity_thr) {
+                    AppendToTrack(track_id, rest_detections[det_id]);
+                    rest_unmatched_detections.erase(det_id);
+                } else {
+                    rest_unmatched_tracks.insert(track_id);
+                }
+            }
+
+            unmatched_tracks.swap(rest_unmatched_tracks);
+            unmatched_detections.clear();
+            for (size_t det_id : rest_unmatched_detections) {
+                unmatched_detections.insert(rest_ids[det_id]);
             }
         }
 
@@ -194,32 +310,6 @@ void Tracker::DropForgottenTracks() {
     m_tracks_counter = reassign_id ? counter : m_tracks_counter;
 }
 
-float Tracker::ShapeAffinity(const cv::Rect& trk, const cv::Rect& det) {
-    float w_dist = static_cast<float>(std::fabs(trk.width - det.width)) / static_cast<float>(trk.width + det.width);
-    float h_dist = static_cast<float>(std::fabs(trk.height - det.height)) / static_cast<float>(trk.height + det.height);
-    return exp(-m_params.shape_affinity_w * (w_dist + h_dist));
-}
-
-float Tracker::MotionAffinity(const cv::Rect& trk, const cv::Rect& det) {
-    float x_dist = static_cast<float>(trk.x - det.x) * (trk.x - det.x) / (det.width * det.width);
-    float y_dist = static_cast<float>(trk.y - det.y) * (trk.y - det.y) / (det.height * det.height);
-    return exp(-m_params.motion_affinity_w * (x_dist + y_dist));
-}
-
-void Tracker::ComputeDissimilarityMatrix(
-    const std::set<size_t>& active_tracks, const TrackedObjects& detections, cv::Mat* dissimilarity_matrix) {
-    dissimilarity_matrix->create(active_tracks.size(), detections.size(), CV_32F);
-    size_t i = 0;
-    for (auto id : active_tracks) {
-        auto ptr = dissimilarity_matrix->ptr<float>(i);
-        for (size_t j = 0; j < detections.size(); j++) {
-            auto last_det = m_tracks.at(id).objects.back();
-            ptr[j] = Distance(last_det, detections[j]);
-        }
-        i++;
-    }
-}
-
 void Tracker::AddNewTracks(const TrackedObjects& detections) {
     for (size_t i = 0; i < detections.size(); i++) {
         AddNewTrack(detections[i]);
@@ -251,27 +341,18 @@ void Tracker::AppendToTrack(size_t track_id, const TrackedObject& detection) {
     auto& track = m_tracks.at(track_id);
 
     track.objects.emplace_back(detection_with_id);
+    track.filter.Correct(detection_with_id.rect);
     track.lost = 0;
     track.length++;
+    track.label_counts[detection_with_id.label]++;
 
     if (m_params.max_num_objects_in_track > 0) {
         while (track.size() > static_cast<size_t>(m_params.max_num_objects_in_track)) {
-            track.objects.erase(track.objects.begin());
+            track.objects.pop_front();
         }
     }
 }
 
-float Tracker::Distance(const TrackedObject& obj1, const TrackedObject& obj2) {
-    const float eps = 1e-6f;
-    float shp_aff = ShapeAffinity(obj1.rect, obj2.rect);
-    if (shp_aff < eps) return 1.0;
-
-    float mot_aff = MotionAffinity(obj1.rect, obj2.rect);
-    if (mot_aff < eps) return 1.0;
-
-    return 1.0f - shp_aff * mot_aff;
-}
-
 bool Tracker::IsTrackValid(size_t id) const {
     const auto& track = m_tracks.at(id);
     const auto& objects = track.objects;
@@ -346,6 +427,18 @@ int LabelWithMaxFrequencyInTrack(const Track& track, int window_size) {
     int max_frequent_count = 0;
     int max_frequent_id = TrackedObject::UNKNOWN_LABEL_IDX;
 
+    // The window covers the whole track, but a part of it is removed, so the summary is used
+    if (static_cast<size_t>(window_size) >= track.length && track.length > track.objects.size()) {
+        size_t max_count = 0;
+        for (const auto& label_count : track.label_counts) {
+            if (label_count.first != TrackedObject::UNKNOWN_LABEL_IDX && label_count.second > max_count) {
+                max_count = label_count.second;
+                max_frequent_id = label_count.first;
+            }
+        }
+        return max_frequent_id;
+    }
+
     int start = static_cast<int>(track.objects.size()) >= window_size ?
         static_cast<int>(track.objects.size()) - window_size : 0;
 
@@ -375,6 +468,7 @@ std::vector<Track> UpdateTrackLabelsToBestAndFilterOutUnknowns(const std::vector
             obj.label = best_label;
         }
         new_track.first_object.label = best_label;
+        new_track.label_counts = {{best_label, new_track.length}};
 
         new_tracks.emplace_back(std::move(new_track));
     }
@@ -5,12 +5,15 @@
 #pragma once
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <string>
 #include <vector>
 
 #include <opencv2/core.hpp>
 
+#include <utils/nms.hpp>
+
 /**
  * @brief Class for detection with action info
  */
@@ -108,6 +111,11 @@ private:
     int num_candidates_;
     bool binary_task_;
 
+    /** Scratch buffers of GetDetections(), kept between frames to avoid reallocations **/
+    mutable std::vector<uint8_t> passed_mask_;
+    mutable DetectedActions valid_detections_;
+    mutable NmsBoxes nms_boxes_;
+
     /**
      * @brief BBox in normalized form (each coordinate is in range [0;1]).
      */
@@ -167,19 +175,4 @@ private:
                            const NormalizedBBox& variances,
                            const NormalizedBBox& encoded_bbox,
                            const cv::Size& frame_size) const;
-
-    /**
-     * @brief Carry out Soft Non-Maximum Suppression algorithm under detected actions
-     *
-     * @param detections Detected actions
-     * @param sigma Scale paramter
-     * @param top_k Number of top-score bboxes
-     * @param min_det_conf Minimum detection confidence
-     * @param out_indices Out indices of valid detections
-     */
-    void SoftNonMaxSuppression(const DetectedActions& detections,
-                               const float sigma,
-                               size_t top_k,
-                               const float min_det_conf,
-                               std::vector<int>* out_indices) const;
 };
@@ -53,4 +53,10 @@ private:
     std::vector<int> idx_to_id;
 };
 
-void AlignFaces(std::vector<cv::Mat>* face_images, std::vector<cv::Mat>* landmarks_vec);
+/// Aligns the faces of the frame by their 5 landmarks (normalized to the face ROIs) and writes them to network input
+/// tensors of the net_input_size (NCHW, FP32), which share a single buffer allocated for all the faces.
+void AlignFaces(const cv::Mat& frame,
+                const std::vector<cv::Rect>& face_rois,
+                const std::vector<cv::Mat>& landmarks_vec,
+                const cv::Scalar_<int>& net_input_size,
+                std::vector<cv::Mat>& out_tensors);
@@ -14,6 +14,7 @@
 #include <vector>
 
 #include <opencv2/core.hpp>
+#include <utils/track_association.hpp>
 
 struct TrackedObject {
     cv::Rect rect;
@@ -182,7 +183,7 @@ struct Track {
 };
 
 ///
-/// \brief Simple Hungarian algorithm-based tracker.
+/// \brief Simple assignment-based tracker.
 ///
 class Tracker {
 public:
@@ -253,9 +254,6 @@ private:
         return active_track_ids_;
     }
 
-    float ShapeAffinity(const cv::Rect& trk, const cv::Rect& det);
-    float MotionAffinity(const cv::Rect& trk, const cv::Rect& det);
-
     void SolveAssignmentProblem(const std::set<size_t>& track_ids,
                                 const TrackedObjects& detections,
                                 std::set<size_t>* unmatched_tracks,
@@ -263,12 +261,6 @@ private:
                                 std::set<std::tuple<size_t, size_t, float>>* matches);
     void FilterDetectionsAndStore(const TrackedObjects& detected_objects);
 
-    void ComputeDissimilarityMatrix(const std::set<size_t>& active_track_ids,
-                                    const TrackedObjects& detections,
-                                    cv::Mat* dissimilarity_matrix);
-
-    float Distance(const TrackedObject& obj1, const TrackedObject& obj2);
-
     void AddNewTrack(const TrackedObject& detection);
 
     void AddNewTracks(const TrackedObjects& detections);
@@ -301,6 +293,8 @@ private:
     size_t tracks_counter_;
 
     cv::Size frame_size_;
+
+    TrackAssociator associator_;
 };
 
 int LabelWithMaxFrequencyInTrack(const Track& track, int window_size);
@@ -32,6 +32,7 @@
 #include <opencv2/gapi/infer/parsers.hpp>
 #include <opencv2/gapi/render/render.hpp>
 #include <opencv2/gapi/streaming/format.hpp>
+#include <opencv2/gapi/streaming/source.hpp>
 #include <opencv2/highgui.hpp>
 #include <opencv2/imgproc.hpp>
 
@@ -41,7 +42,9 @@
 #include <utils/ocv_common.hpp>
 #include <utils/performance_metrics.hpp>
 #include <utils/slog.hpp>
+#include <utils_gapi/pipeline_cache.hpp>
 #include <utils_gapi/stream_source.hpp>
+#include <utils_gapi/streaming.hpp>
 
 #include "action_detector.hpp"
 #include "actions.hpp"
@@ -280,14 +283,17 @@ int main(int argc, char* argv[]) {
         /** Pipeline's input and outputs**/
         cv::GComputation pipeline(cv::GIn(in), std::move(outs));
 
-        cv::GStreamingCompiled stream =
-            pipeline.compileStreaming(cv::compile_args(custom::kernels(),
-                                                       networks,
-                                                       TrackerParamsPack{tracker_reid_params, tracker_action_params},
-                                                       FLAGS_r));
+        auto compile_args = cv::compile_args(custom::kernels(),
+                                             networks,
+                                             TrackerParamsPack{tracker_reid_params, tracker_action_params},
+                                             FLAGS_r);
+        custom::addQueueCapacity(compile_args, FLAGS_qc);
+        /** The graph is compiled for the size of the frames, and is reused when the source is set again **/
+        custom::PipelineCache pipelines(std::move(pipeline), std::move(compile_args));
 
         /** ---------------- The execution part ---------------- **/
-        stream.setSource<custom::CommonCapSrc>(cap);
+        cv::GStreamingCompiled* stream =
+            &pipelines.setSource(cv::gin(cv::gapi::wip::make_src<custom::CommonCapSrc>(cap)));
 
         /** Service constants **/
         size_t work_num_frames = 0;
@@ -313,7 +319,7 @@ int main(int argc, char* argv[]) {
 
         /** TOP_K case starts without processing **/
         if (const_params.actions_type != TOP_K)
-            stream.start();
+            stream->start();
 
         bool isStart = true;
         const auto startTime = std::chrono::steady_clock::now();
@@ -333,20 +339,20 @@ int main(int argc, char* argv[]) {
                 }
             }
             if (monitoring_enabled) {
-                if (!stream.running()) {
+                if (!stream->running()) {
                     /** TOP_K part. SPACE_KEY is pressed, monitoring enabled
                      *  Compile and start graph **/
-                    stream.setSource<custom::CommonCapSrc>(cap);
-                    stream.start();
+                    stream = &pipelines.setSource(cv::gin(cv::gapi::wip::make_src<custom::CommonCapSrc>(cap)));
+                    stream->start();
                 }
-                if (!stream.pull(std::move(out_vector))) {
+                if (!custom::pull(*stream, std::move(out_vector), FLAGS_latest)) {
                     /** Main part. Processing is always on **/
                     break;
                 }
             } else {
                 /** TOP_K part. monitoring isn't enabled **/
-                if (stream.running())
-                    stream.stop();
+                if (stream->running())
+                    stream->stop();
                 /** Get clear frame **/
                 out_frame = cap->read();
                 if (!out_frame.data)
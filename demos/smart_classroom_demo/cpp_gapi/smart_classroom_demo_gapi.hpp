@@ -10,9 +10,11 @@
 #include <gflags/gflags.h>
 
 #include <utils/default_flags.hpp>
+#include <utils_gapi/streaming.hpp>
 
 DEFINE_INPUT_FLAGS
 DEFINE_OUTPUT_FLAGS
+DEFINE_STREAMING_FLAGS
 
 static const char help_message[] = "Print a usage message.";
 static const char read_limit_message[] = "Optional. Read length limit before stopping or restarting reading the input.";
@@ -144,6 +146,8 @@ static void showUsage() {
     std::cout << "    -fg                            " << reid_gallery_path_message << std::endl;
     std::cout << "    -teacher_id                    " << teacher_id_message << std::endl;
     std::cout << "    -no_show                       " << no_show_message << std::endl;
+    std::cout << "    -qc \"<integer>\"                " << queue_capacity_message << std::endl;
+    std::cout << "    -latest                        " << latest_result_message << std::endl;
     std::cout << "    -min_ad                        " << min_action_duration_message << std::endl;
     std::cout << "    -d_ad                          " << same_action_time_delta_message << std::endl;
     std::cout << "    -student_ac                    " << student_actions_message << std::endl;
@@ -4,6 +4,9 @@
 
 #include "action_detector.hpp"
 
+#include <stdint.h>
+#include <string.h>
+
 #include <algorithm>
 #include <cmath>
 #include <iterator>
@@ -12,6 +15,8 @@
 #include <numeric>
 #include <stdexcept>
 
+#include <utils/nms.hpp>
+
 #define SSD_LOCATION_RECORD_SIZE 4
 #define SSD_PRIORBOX_RECORD_SIZE 4
 #define NUM_DETECTION_CLASSES    2
@@ -147,21 +152,40 @@ DetectedActions ActionDetection::GetDetections(const cv::Mat& loc,
         action_conf_data[i] = reinterpret_cast<float*>(add_conf[i].data);
     }
 
+    /** Threshold the detection confidence of all candidates first. The loop has no branches, so it is vectorized,
+     *  and as few candidates pass, the mask is then scanned 8 bytes at a time. **/
+    const size_t mask_size = (num_candidates_ + 7) / 8 * 8;
+    passed_mask_.resize(mask_size);
+    uint8_t* passed = passed_mask_.data();
+    const float det_threshold = config_.detection_confidence_threshold;
+    for (int p = 0; p < num_candidates_; ++p) {
+        passed[p] = det_conf_data[p * NUM_DETECTION_CLASSES + POSITIVE_DETECTION_IDX] >= det_threshold;
+    }
+    std::fill(passed + num_candidates_, passed + mask_size, 0);
+
     /** Variable to store all detection candidates**/
-    DetectedActions valid_detections;
+    valid_detections_.clear();
 
-    /** Iterate over all candidate bboxes**/
+    /** Iterate over the candidate bboxes passing the threshold, in increasing order, so the head ID only grows **/
+    int head_id = 0;
     for (int p = 0; p < num_candidates_; ++p) {
-        /** Parse detection confidence from the SSD Detection output **/
-        const float detection_conf = det_conf_data[p * NUM_DETECTION_CLASSES + POSITIVE_DETECTION_IDX];
-
-        /** Skip low-confidence detections **/
-        if (detection_conf < config_.detection_confidence_threshold) {
+        /** Skip low-confidence detections, whole blocks of 8 at once **/
+        if (p % 8 == 0) {
+            uint64_t block_mask;
+            memcpy(&block_mask, passed + p, sizeof(block_mask));
+            if (block_mask == 0) {
+                p += 7;
+                continue;
+            }
+        }
+        if (!passed[p]) {
             continue;
         }
 
+        /** Parse detection confidence from the SSD Detection output **/
+        const float detection_conf = det_conf_data[p * NUM_DETECTION_CLASSES + POSITIVE_DETECTION_IDX];
+
         /** Estimate the action head ID **/
-        int head_id = 0;
         while (p >= head_ranges_[head_id + 1]) {
             ++head_id;
         }
@@ -214,84 +238,30 @@ DetectedActions ActionDetection::GetDetections(const cv::Mat& loc,
 
         const auto det_rect = ConvertToRect(priorbox, variance, encoded_bbox, frame_size);
         /** Store detected action **/
-        valid_detections.emplace_back(det_rect, action_label, detection_conf, action_conf);
+        valid_detections_.emplace_back(det_rect, action_label, detection_conf, action_conf);
     }
 
     /** Merge most overlapped detections **/
-    std::vector<int> out_det_indices;
-    SoftNonMaxSuppression(valid_detections,
-                          config_.nms_sigma,
-                          config_.keep_top_k,
-                          config_.detection_confidence_threshold,
-                          &out_det_indices);
+    nms_boxes_.clear();
+    for (const auto& detection : valid_detections_) {
+        const cv::Rect& rect = detection.rect;
+        nms_boxes_.add(static_cast<float>(rect.x),
+                       static_cast<float>(rect.y),
+                       static_cast<float>(rect.x + rect.width),
+                       static_cast<float>(rect.y + rect.height),
+                       detection.detection_conf);
+    }
+    NmsParams nms_params;
+    nms_params.method = NmsMethod::Soft;
+    nms_params.softNmsSigma = config_.nms_sigma;
+    nms_params.topK = config_.keep_top_k;
+    nms_params.scoreThreshold = config_.detection_confidence_threshold;
+    const std::vector<int> out_det_indices = nms(nms_boxes_, nms_params);
+
     DetectedActions detections;
+    detections.reserve(out_det_indices.size());
     for (size_t i = 0; i < out_det_indices.size(); ++i) {
-        detections.emplace_back(valid_detections[out_det_indices[i]]);
+        detections.emplace_back(valid_detections_[out_det_indices[i]]);
     }
     return detections;
 }
-
-void ActionDetection::SoftNonMaxSuppression(const DetectedActions& detections,
-                                            const float sigma,
-                                            size_t top_k,
-                                            const float min_det_conf,
-                                            std::vector<int>* out_indices) const {
-    /** Store input bbox scores **/
-    std::vector<float> scores(detections.size());
-    for (size_t i = 0; i < detections.size(); ++i) {
-        scores[i] = detections[i].detection_conf;
-    }
-
-    top_k = std::min(top_k, scores.size());
-
-    /** Select top-k score indices **/
-    std::vector<size_t> score_idx(scores.size());
-    std::iota(score_idx.begin(), score_idx.end(), 0);
-    std::nth_element(score_idx.begin(), score_idx.begin() + top_k, score_idx.end(), [&scores](size_t i1, size_t i2) {
-        return scores[i1] > scores[i2];
-    });
-
-    /** Extract top-k score values **/
-    std::vector<float> top_scores(top_k);
-    for (size_t i = 0; i < top_scores.size(); ++i) {
-        top_scores[i] = scores[score_idx[i]];
-    }
-
-    /** Carry out Soft Non-Maximum Suppression algorithm **/
-    out_indices->clear();
-    for (size_t step = 0; step < top_scores.size(); ++step) {
-        auto best_score_itr = std::max_element(top_scores.begin(), top_scores.end());
-        if (*best_score_itr < min_det_conf) {
-            break;
-        }
-
-        /** Add current bbox to output list **/
-        const size_t local_anchor_idx = std::distance(top_scores.begin(), best_score_itr);
-        const int anchor_idx = score_idx[local_anchor_idx];
-        out_indices->emplace_back(anchor_idx);
-        *best_score_itr = 0.f;
-
-        /** Update top_scores of the rest bboxes **/
-        for (size_t local_reference_idx = 0; local_reference_idx < top_scores.size(); ++local_reference_idx) {
-            /** Skip updating step for the low-confidence bbox **/
-            if (top_scores[local_reference_idx] < min_det_conf) {
-                continue;
-            }
-
-            /** Calculate the Intersection over Union metric between two bboxes**/
-            const size_t reference_idx = score_idx[local_reference_idx];
-            const auto& rect1 = detections[anchor_idx].rect;
-            const auto& rect2 = detections[reference_idx].rect;
-            const auto intersection = rect1 & rect2;
-            float overlap = 0.f;
-            if (intersection.width > 0 && intersection.height > 0) {
-                const int intersection_area = intersection.area();
-                overlap = static_cast<float>(intersection_area) /
-                          static_cast<float>(rect1.area() + rect2.area() - intersection_area);
-            }
-
-            /** Scale bbox score using the exponential rule **/
-            top_scores[local_reference_idx] *= std::exp(-overlap * overlap / sigma);
-        }
-    }
-}
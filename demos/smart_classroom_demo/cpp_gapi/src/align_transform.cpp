@@ -5,6 +5,7 @@
 #include <stddef.h>
 
 #include <algorithm>
+#include <cmath>
 #include <limits>
 #include <memory>
 #include <vector>
@@ -28,54 +29,85 @@ static const float ref_landmarks_normalized[] = {30.2946f / w,
                                                  62.7299f / w,
                                                  92.2041f / h};
 
-cv::Mat GetTransform(cv::Mat* src, cv::Mat* dst) {
-    cv::Mat col_mean_src;
-    reduce(*src, col_mean_src, 0, cv::REDUCE_AVG);
-    for (int i = 0; i < src->rows; i++) {
-        src->row(i) -= col_mean_src;
+namespace {
+/// Similarity transform which maps the reference landmarks to the landmarks of the face. Rotation is found in the
+/// closed form for 2D points, scale is the ratio of the deviations of the landmarks.
+cv::Matx23f GetTransform(const cv::Point2f* src, const cv::Point2f* dst, int count) {
+    cv::Point2f mean_src, mean_dst;
+    for (int i = 0; i < count; i++) {
+        mean_src += src[i];
+        mean_dst += dst[i];
     }
+    mean_src *= 1.f / count;
+    mean_dst *= 1.f / count;
 
-    cv::Mat col_mean_dst;
-    reduce(*dst, col_mean_dst, 0, cv::REDUCE_AVG);
-    for (int i = 0; i < dst->rows; i++) {
-        dst->row(i) -= col_mean_dst;
+    float dot = 0.f, cross = 0.f, norm_src = 0.f, norm_dst = 0.f;
+    for (int i = 0; i < count; i++) {
+        const cv::Point2f a = src[i] - mean_src;
+        const cv::Point2f b = dst[i] - mean_dst;
+        dot += a.dot(b);
+        cross += a.cross(b);
+        norm_src += a.dot(a);
+        norm_dst += b.dot(b);
     }
+    const float eps = std::numeric_limits<float>::epsilon();
+    const float dev_src = std::max(eps, std::sqrt(norm_src / (2 * count)));
+    const float dev_dst = std::max(eps, std::sqrt(norm_dst / (2 * count)));
+    const float scale = dev_dst / dev_src;
+    const float len = std::sqrt(dot * dot + cross * cross);
+    const float cos_a = len > eps ? scale * dot / len : scale;
+    const float sin_a = len > eps ? scale * cross / len : 0.f;
 
-    cv::Scalar mean, dev_src, dev_dst;
-    cv::meanStdDev(*src, mean, dev_src);
-    dev_src(0) = std::max(static_cast<double>(std::numeric_limits<float>::epsilon()), dev_src(0));
-    *src /= dev_src(0);
-    cv::meanStdDev(*dst, mean, dev_dst);
-    dev_dst(0) = std::max(static_cast<double>(std::numeric_limits<float>::epsilon()), dev_dst(0));
-    *dst /= dev_dst(0);
-
-    cv::Mat w, u, vt;
-    cv::SVD::compute((*src).t() * (*dst), w, u, vt);
-    cv::Mat r = (u * vt).t();
-    cv::Mat m(2, 3, CV_32F);
-    m.colRange(0, 2) = r * (dev_dst(0) / dev_src(0));
-    m.col(2) = (col_mean_dst.t() - m.colRange(0, 2) * col_mean_src.t());
-    return m;
+    return cv::Matx23f(cos_a, -sin_a, mean_dst.x - (cos_a * mean_src.x - sin_a * mean_src.y),
+                       sin_a,  cos_a, mean_dst.y - (sin_a * mean_src.x + cos_a * mean_src.y));
 }
+}  // namespace
 
-void AlignFaces(std::vector<cv::Mat>* face_images, std::vector<cv::Mat>* landmarks_vec) {
-    if (landmarks_vec->size() == 0) {
+void AlignFaces(const cv::Mat& frame,
+                const std::vector<cv::Rect>& face_rois,
+                const std::vector<cv::Mat>& landmarks_vec,
+                const cv::Scalar_<int>& net_input_size,
+                std::vector<cv::Mat>& out_tensors) {
+    out_tensors.clear();
+    CV_Assert(face_rois.size() == landmarks_vec.size());
+    if (face_rois.empty()) {
         return;
     }
-    for (auto& el : *landmarks_vec) {
-        el = el.reshape(1, {5, 2});
-    }
-    CV_Assert(face_images->size() == landmarks_vec->size());
-    cv::Mat ref_landmarks = cv::Mat(5, 2, CV_32F);
+    const int channels = net_input_size[1];
+    const cv::Size net_size(net_input_size[3], net_input_size[2]);
+    const size_t plane_size = net_size.area();
+    /** One buffer for the tensors of all faces **/
+    cv::Mat tensors(std::vector<int>{static_cast<int>(face_rois.size()), channels, net_size.height, net_size.width},
+                    CV_32F);
+    std::vector<cv::Range> ranges(tensors.dims, cv::Range::all());
+    cv::Mat warped, cvt;
+    std::vector<cv::Mat> planes(channels);
+    cv::Point2f ref_landmarks[5], landmarks[5];
+    for (size_t j = 0; j < face_rois.size(); j++) {
+        const cv::Mat face = frame(face_rois[j]);
+        const float* normed_landmarks = landmarks_vec[j].ptr<float>();
+        for (int i = 0; i < 5; i++) {
+            ref_landmarks[i] = {ref_landmarks_normalized[2 * i] * face.cols,
+                                ref_landmarks_normalized[2 * i + 1] * face.rows};
+            landmarks[i] = {normed_landmarks[2 * i] * face.cols, normed_landmarks[2 * i + 1] * face.rows};
+        }
+        /** The aligned face of the ROI size is resized to the network input, so the pixels of the input are mapped
+         *  to the aligned face first, and the face is warped right into the input size **/
+        const cv::Matx23f m = GetTransform(ref_landmarks, landmarks, 5);
+        const float sx = static_cast<float>(face.cols) / net_size.width;
+        const float sy = static_cast<float>(face.rows) / net_size.height;
+        const float ox = 0.5f * sx - 0.5f, oy = 0.5f * sy - 0.5f;
+        const cv::Matx23f input_to_face(m(0, 0) * sx, m(0, 1) * sy, m(0, 0) * ox + m(0, 1) * oy + m(0, 2),
+                                        m(1, 0) * sx, m(1, 1) * sy, m(1, 0) * ox + m(1, 1) * oy + m(1, 2));
+        cv::warpAffine(face, warped, input_to_face, net_size, cv::INTER_LINEAR | cv::WARP_INVERSE_MAP);
+        warped.convertTo(cvt, CV_32F);
 
-    for (size_t j = 0; j < face_images->size(); j++) {
-        for (int i = 0; i < ref_landmarks.rows; i++) {
-            ref_landmarks.at<float>(i, 0) = ref_landmarks_normalized[2 * i] * face_images->at(j).cols;
-            ref_landmarks.at<float>(i, 1) = ref_landmarks_normalized[2 * i + 1] * face_images->at(j).rows;
-            landmarks_vec->at(j).at<float>(i, 0) *= face_images->at(j).cols;
-            landmarks_vec->at(j).at<float>(i, 1) *= face_images->at(j).rows;
+        ranges[0] = cv::Range(static_cast<int>(j), static_cast<int>(j) + 1);
+        out_tensors.push_back(tensors(ranges));
+        float* slot = out_tensors.back().ptr<float>();
+        for (int ch = 0; ch < channels; ++ch) {
+            planes[ch] = cv::Mat(net_size, CV_32F, slot + ch * plane_size);
         }
-        cv::Mat m = GetTransform(&ref_landmarks, &landmarks_vec->at(j));
-        cv::warpAffine(face_images->at(j), face_images->at(j), m, face_images->at(j).size(), cv::WARP_INVERSE_MAP);
+        cv::split(cvt, planes);  // to NCHW
     }
 }
@@ -74,31 +74,8 @@ GAPI_OCV_KERNEL(OCVAlignFacesForReidentification,
                     const std::vector<cv::Rect>& face_rois,
                     const cv::Scalar_<int>& net_input_size,
                           std::vector<cv::Mat>& out_images) {
-        cv::Mat out_image = in.clone();
-        out_images.clear();
-        for (const auto& rect : face_rois) {
-            out_images.emplace_back(out_image(rect));
-        }
-        AlignFaces(&out_images, &const_cast<std::vector<cv::Mat>&>(landmarks));
-        /** Preprocessing for CNN input **/
-        for (auto& image : out_images) {
-            cv::Mat rsz, cvt;
-            cv::resize(image, rsz, cv::Size(static_cast<int>(net_input_size[2]),
-                static_cast<int>(net_input_size[3])));  // resize
-            rsz.convertTo(cvt, CV_32F);                // to F32 type
-            image.create(cv::Size(cvt.cols, cvt.rows * cvt.channels()), CV_32F);
-            std::vector<cv::Mat> planes;
-            for (int i = 0; i < cvt.channels(); ++i) {
-                planes.push_back(image.rowRange(i * cvt.rows, (i + 1) * cvt.rows));
-            }
-            cv::split(cvt, planes);                     // to NCHW
-            std::vector<int> new_dims =
-                { static_cast<int>(net_input_size[0]),
-                static_cast<int>(net_input_size[1]),
-                static_cast<int>(net_input_size[2]),
-                static_cast<int>(net_input_size[3]) };
-            image = image.reshape(1, new_dims);  // reshape to CNN input
-        }
+        /** Faces are warped right into the network input tensors **/
+        AlignFaces(in, face_rois, landmarks, net_input_size, out_images);
     }
 };
 
@@ -253,23 +253,24 @@ void Tracker::SolveAssignmentProblem(const std::set<size_t>& track_ids,
     CV_Assert(matches);
     matches->clear();
 
-    cv::Mat dissimilarity;
-    ComputeDissimilarityMatrix(track_ids, detections, &dissimilarity);
-
-    auto res = KuhnMunkres().Solve(dissimilarity);
+    const std::vector<size_t> ids(track_ids.begin(), track_ids.end());
+    const std::vector<TrackAssociator::Affinity> affinities = {
+        [&](size_t i, size_t j) {
+            return ShapeAffinity(params_.shape_affinity_w, tracks_.at(ids[i]).objects.back().rect, detections[j].rect);
+        },
+        [&](size_t i, size_t j) {
+            return MotionAffinity(params_.motion_affinity_w, tracks_.at(ids[i]).objects.back().rect, detections[j].rect);
+        }};
+    const auto& res = associator_.Associate(ids.size(), detections.size(), affinities, params_.affinity_thr);
 
     for (size_t i = 0; i < detections.size(); i++) {
         unmatched_detections->insert(i);
     }
 
-    size_t i = 0;
-    for (auto id : track_ids) {
-        if (res[i] < detections.size()) {
-            matches->emplace(id, res[i], 1 - dissimilarity.at<float>(i, res[i]));
-        } else {
-            unmatched_tracks->insert(id);
-        }
-        i++;
+    unmatched_tracks->insert(track_ids.begin(), track_ids.end());
+    for (const auto& match : res) {
+        matches->emplace(ids[match.track], match.detection, match.affinity);
+        unmatched_tracks->erase(ids[match.track]);
     }
 }
 
@@ -381,33 +382,6 @@ void Tracker::DropForgottenTracks() {
     tracks_counter_ = reassign_id ? counter : tracks_counter_;
 }
 
-float Tracker::ShapeAffinity(const cv::Rect& trk, const cv::Rect& det) {
-    float w_dist = static_cast<float>(std::fabs(trk.width - det.width)) / static_cast<float>(trk.width + det.width);
-    float h_dist = static_cast<float>(std::fabs(trk.height - det.height)) / static_cast<float>(trk.height + det.height);
-    return exp(-params_.shape_affinity_w * (w_dist + h_dist));
-}
-
-float Tracker::MotionAffinity(const cv::Rect& trk, const cv::Rect& det) {
-    float x_dist = static_cast<float>(trk.x - det.x) * (trk.x - det.x) / (det.width * det.width);
-    float y_dist = static_cast<float>(trk.y - det.y) * (trk.y - det.y) / (det.height * det.height);
-    return exp(-params_.motion_affinity_w * (x_dist + y_dist));
-}
-
-void Tracker::ComputeDissimilarityMatrix(const std::set<size_t>& active_tracks,
-                                         const TrackedObjects& detections,
-                                         cv::Mat* dissimilarity_matrix) {
-    dissimilarity_matrix->create(active_tracks.size(), detections.size(), CV_32F);
-    size_t i = 0;
-    for (auto id : active_tracks) {
-        auto ptr = dissimilarity_matrix->ptr<float>(i);
-        for (size_t j = 0; j < detections.size(); j++) {
-            auto last_det = tracks_.at(id).objects.back();
-            ptr[j] = Distance(last_det, detections[j]);
-        }
-        i++;
-    }
-}
-
 void Tracker::AddNewTracks(const TrackedObjects& detections) {
     for (size_t i = 0; i < detections.size(); i++) {
         AddNewTrack(detections[i]);
@@ -449,19 +423,6 @@ void Tracker::AppendToTrack(size_t track_id, const TrackedObject& detection) {
     }
 }
 
-float Tracker::Distance(const TrackedObject& obj1, const TrackedObject& obj2) {
-    const float eps = 1e-6f;
-    float shp_aff = ShapeAffinity(obj1.rect, obj2.rect);
-    if (shp_aff < eps)
-        return 1.0;
-
-    float mot_aff = MotionAffinity(obj1.rect, obj2.rect);
-    if (mot_aff < eps)
-        return 1.0;
-
-    return 1.0f - shp_aff * mot_aff;
-}
-
 bool Tracker::IsTrackValid(size_t id) const {
     const auto& track = tracks_.at(id);
     const auto& objects = track.objects;
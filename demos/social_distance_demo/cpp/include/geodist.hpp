@@ -3,10 +3,19 @@
 //
 
 #pragma once
+#include <cstddef>
+#include <functional>
 #include <tuple>
+#include <vector>
 #include <opencv2/core.hpp>
 
 std::tuple<bool, bool, double> socialDistance(std::tuple<int, int>& frameShape,
                                                cv::Point2d& A, cv::Point2d& B,
                                                cv::Point2d& C, cv::Point2d& D,
                                                unsigned minIter = 3, double minW = 0, double maxW = 0);
+
+// Calls func(i, j), i < j, for every pair of person boxes which socialDistance() may report as too close. A sweep over
+// the boxes sorted by their bottoms skips the pairs standing too far apart in depth: both the euclidean and the
+// perspective estimations need the bottoms closer than minIter widths of the wider person.
+void forCloseCandidates(const std::vector<cv::Rect2d>& boxes, unsigned minIter,
+                        const std::function<void(size_t, size_t)>& func);
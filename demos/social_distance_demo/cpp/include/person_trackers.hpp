@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include <cmath>
+#include <list>
+#include <mutex>
 #include <vector>
 #include <unordered_map>
 #include <tuple>
@@ -13,7 +16,7 @@
 
 struct TrackableObject {
     TrackableObject(cv::Rect2i bb, const std::vector<float>& r, cv::Point centroid)
-            : bbox{bb}, reid{r}, updated{false}, disappeared(0) {
+            : bbox{bb}, reid{r}, updated{false}, disappeared(0), reidAge(0) {
         centroids.push_back(centroid);
     }
 
@@ -22,6 +25,7 @@ struct TrackableObject {
     std::vector<cv::Point> centroids;
     bool updated;
     int disappeared;
+    int reidAge;  // number of frames the descriptor was reused for
 };
 
 class PersonTrackers {
@@ -29,16 +33,37 @@ public:
     PersonTrackers() : trackIdGenerator{0}, similarityThreshold{0.7f}, maxDisappeared{10} {}
 
     void similarity(std::list<TrackableObject>& tos) {
+        std::lock_guard<std::mutex> lock{mutex};
+        // All descriptors are compared by one matrix product of the normalized descriptors
+        std::vector<int> trackIds;
+        cv::Mat trackReids;
+        for (const auto& tracker : trackables) {
+            trackIds.push_back(tracker.first);
+            trackReids.push_back(normalized(tracker.second.reid));
+        }
+        cv::Mat newReids;
+        for (const auto& to : tos) {
+            newReids.push_back(normalized(to.reid));
+        }
+        cv::Mat cosines;
+        if (!trackReids.empty() && !newReids.empty()) {
+            cv::gemm(newReids, trackReids, 1.0, cv::noArray(), 0.0, cosines, cv::GEMM_2_T);
+        }
+
+        int toIdx = 0;
         for (const auto& to : tos) {
             std::deque<std::pair<int, float>> sim;
-            for (auto& tracker : trackables) {
-                if (!tracker.second.updated) {
-                    float cosine = cosineSimilarity(to.reid, tracker.second.reid);
+            for (size_t trackIdx = 0; trackIdx < trackIds.size(); ++trackIdx) {
+                TrackableObject& tracker = trackables.at(trackIds[trackIdx]);
+                // a person can't get far from its track, so only the tracks around are candidates
+                if (!tracker.updated && isWithinReach(tracker, to)) {
+                    float cosine = cosines.at<float>(toIdx, static_cast<int>(trackIdx));
                     if (cosine > similarityThreshold) {
-                        sim.push_back(std::make_pair(tracker.first, cosine));
+                        sim.push_back(std::make_pair(trackIds[trackIdx], cosine));
                     }
                 }
             }
+            ++toIdx;
 
             if (sim.empty()) {
                 trackables.insert({ trackIdGenerator, to });
@@ -68,6 +93,29 @@ public:
         }
     }
 
+    // Finds the descriptor of the person in bbox without running ReId: the person has to overlap the only track which
+    // is seen in the last frame and whose descriptor was computed less than maxAge frames ago. Returns false if the
+    // match is ambiguous and ReId should be run.
+    bool reuseReid(const cv::Rect& bbox, int maxAge, std::vector<float>& reid, int& reidAge) {
+        std::lock_guard<std::mutex> lock{mutex};
+        const TrackableObject* match = nullptr;
+        for (const auto& tracker : trackables) {
+            const float overlap = iou(bbox, tracker.second.bbox);
+            if (overlap >= ambiguousIou) {
+                if (nullptr != match || overlap < matchIou) {
+                    return false;
+                }
+                match = &tracker.second;
+            }
+        }
+        if (nullptr == match || match->disappeared > 0 || match->reidAge + 1 >= maxAge) {
+            return false;
+        }
+        reid = match->reid;
+        reidAge = match->reidAge + 1;
+        return true;
+    }
+
     float cosineSimilarity(const std::vector<float>& a, const std::vector<float>& b) {
         if (a.size() != b.size()) {
             throw "Vector sizes don't match!";
@@ -86,6 +134,27 @@ public:
     std::unordered_map<int, TrackableObject> trackables;
 
 private:
+    static constexpr float matchIou = 0.5f;
+    static constexpr float ambiguousIou = 0.2f;
+
+    static cv::Mat normalized(const std::vector<float>& reid) {
+        cv::Mat row(1, static_cast<int>(reid.size()), CV_32F, const_cast<float*>(reid.data()));
+        return row / (cv::norm(row) + 1e-6);
+    }
+
+    static float iou(const cv::Rect& a, const cv::Rect& b) {
+        const float intersection = static_cast<float>((a & b).area());
+        return intersection / (a.area() + b.area() - intersection + 1e-6f);
+    }
+
+    // A person walks less than its height per frame
+    static bool isWithinReach(const TrackableObject& tracker, const TrackableObject& to) {
+        const cv::Point shift = to.centroids.back() - tracker.centroids.back();
+        const double reach = static_cast<double>(tracker.bbox.height) * (1 + tracker.disappeared);
+        return std::hypot(shift.x, shift.y) <= reach;
+    }
+
+    std::mutex mutex;
     int trackIdGenerator;
     float similarityThreshold;
     int maxDisappeared;
@@ -46,6 +46,13 @@ static const char infer_num_threads_message[] = "Optional. Number of threads to
 static const char infer_num_streams_message[] = "Optional. Number of streams to use for inference on the CPU or/and GPU in throughput mode "
                                                 "(for HETERO and MULTI device cases use format <device1>:<nstreams1>,<device2>:<nstreams2> or just <nstreams>)";
 static const char utilization_monitors_message[] = "Optional. List of monitors to show initially.";
+static const char max_queued_message[] = "Optional. Maximum number of queued inference tasks of each kind. Frames aren't read while a queue "
+                                         "is full. 0 removes the limit.";
+static const char reid_period_message[] = "Optional. Maximum number of frames a ReId descriptor of a person is reused for. "
+                                          "A person who unambiguously overlaps a track of the previous frame takes over its "
+                                          "descriptor instead of running ReId. 1 runs ReId for every person on every frame.";
+static const char trace_message[] = "Optional. Path to a file to write the timeline of the Worker tasks to at exit. "
+                                    "The file is in Chrome Trace Event format which chrome://tracing and Perfetto open.";
 
 DEFINE_bool(h, false, help_message);
 DEFINE_string(i, "", video_message);
@@ -69,6 +76,9 @@ DEFINE_bool(tag, false, use_tag_scheduler_message);
 DEFINE_uint32(nthreads, 0, infer_num_threads_message);
 DEFINE_string(nstreams, "", infer_num_streams_message);
 DEFINE_string(u, "", utilization_monitors_message);
+DEFINE_uint32(max_queued, 0, max_queued_message);
+DEFINE_uint32(reid_period, 1, reid_period_message);
+DEFINE_string(trace, "", trace_message);
 
 /**
 * \brief This function show a help message
@@ -100,4 +110,7 @@ void showUsage() {
     std::cout << "    -nstreams \"<integer>\"    " << infer_num_streams_message << std::endl;
     std::cout << "    -nthreads \"<integer>\"    " << infer_num_threads_message << std::endl;
     std::cout << "    -u                         " << utilization_monitors_message << std::endl;
+    std::cout << "    -max_queued                " << max_queued_message << std::endl;
+    std::cout << "    -reid_period               " << reid_period_message << std::endl;
+    std::cout << "    -trace \"<path>\"            " << trace_message << std::endl;
 }
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <fstream>
 #include <iomanip>
 #include <list>
 #include <map>
@@ -54,6 +55,9 @@ bool ParseAndCheckCommandLine(int argc, char* argv[]) {
     if (FLAGS_n_wt == 0) {
         throw std::logic_error("-n_wt can not be zero");
     }
+    if (FLAGS_reid_period == 0) {
+        throw std::logic_error("-reid_period can not be zero");
+    }
     return true;
 }
 
@@ -64,17 +68,17 @@ struct InferRequestsContainer {
 
     void assign(const std::vector<ov::InferRequest>& inferRequests) {
         actualInferRequests = inferRequests;
-        this->inferRequests.container.clear();
+        this->inferRequests.reset(actualInferRequests.size());
 
         for (auto& ir : this->actualInferRequests) {
-            this->inferRequests.container.push_back(ir);
+            this->inferRequests.tryPush(&ir);
         }
     }
 
     std::vector<ov::InferRequest> getActualInferRequests() {
         return actualInferRequests;
     }
-    ConcurrentContainer<std::vector<std::reference_wrapper<ov::InferRequest>>> inferRequests;
+    ConcurrentPool<ov::InferRequest*> inferRequests;
 
 private:
     std::vector<ov::InferRequest> actualInferRequests;
@@ -94,7 +98,9 @@ struct Context {  // stores all global data for tasks
         inferTasksContext{detector},
         detectionsProcessorsContext{reid},
         drawersContext{pause, gridParam, displayResolution, showPeriod, monitorsStr},
-        videoFramesContext{std::vector<uint64_t>(inputChannels.size(), lastFrameId), std::vector<std::mutex>(inputChannels.size())},
+        videoFramesContext{std::vector<std::atomic<uint64_t>>(inputChannels.size())},
+        framesPool{(lastFrameId + 1) * inputChannels.size()},
+        readersPool{(lastFrameId + 1) * inputChannels.size()},
         trackersContext{std::vector<PersonTrackers>(inputChannels.size()), std::vector<int>(inputChannels.size(), 9999),
             std::vector<int>(inputChannels.size(), 1)},
         nireq{nireq},
@@ -103,6 +109,9 @@ struct Context {  // stores all global data for tasks
         frameCounter{0}
     {
         assert(inputChannels.size() == gridParam.size());
+        for (std::atomic<uint64_t>& lastframeId : videoFramesContext.lastframeIds) {
+            lastframeId = lastFrameId;
+        }
         std::vector<ov::InferRequest> detectorInferRequests;
         std::vector<ov::InferRequest> reidInferRequests;
         detectorInferRequests.reserve(nireq);
@@ -153,10 +162,13 @@ struct Context {  // stores all global data for tasks
     } drawersContext;
 
     struct {
-        std::vector<uint64_t> lastframeIds;
-        std::vector<std::mutex> lastFrameIdsMutexes;
+        std::vector<std::atomic<uint64_t>> lastframeIds;
     } videoFramesContext;
 
+    // every frame slot is reborn with a new Reader task, so their memory is recycled instead of the heap allocations
+    BlockPool framesPool;
+    BlockPool readersPool;
+
     struct TrackersContext {
         std::vector<PersonTrackers> personTracker;
         std::vector<int> minW;
@@ -165,7 +177,7 @@ struct Context {  // stores all global data for tasks
 
         //manual definition of constructor is needed only for creating vector<std::atomic<int32_t>>
         TrackersContext(std::vector<PersonTrackers>&& personTracker, std::vector<int>&& minW, std::vector<int>&& maxW)
-            : personTracker(personTracker), minW(minW), maxW(maxW), lastProcessedIds(personTracker.size()) {
+            : personTracker(std::move(personTracker)), minW(minW), maxW(maxW), lastProcessedIds(this->personTracker.size()) {
             for (size_t i = 0; i < lastProcessedIds.size(); ++i) {
                 lastProcessedIds[i] = 0;
             }
@@ -197,6 +209,7 @@ public:
     explicit Drawer(VideoFrame::Ptr sharedVideoFrame) :
         Task{sharedVideoFrame, 1.0} {}
     bool isReady() override;
+    std::chrono::steady_clock::time_point readyTime() override;
     void process() override;
 
 private:
@@ -293,6 +306,9 @@ public:
 
     bool isReady() override;
     void process() override;
+
+private:
+    ov::InferRequest* reservedRequest = nullptr;
 };
 
 class Reader : public Task {
@@ -306,11 +322,10 @@ public:
 ReborningVideoFrame::~ReborningVideoFrame() {
     try {
         const std::shared_ptr<Worker>& worker = std::shared_ptr<Worker>(context.readersContext.readersWorker);
-        context.videoFramesContext.lastFrameIdsMutexes[sourceID].lock();
         const auto frameId = ++context.videoFramesContext.lastframeIds[sourceID];
-        context.videoFramesContext.lastFrameIdsMutexes[sourceID].unlock();
-        std::shared_ptr<ReborningVideoFrame> reborn = std::make_shared<ReborningVideoFrame>(context, sourceID, frameId, frame);
-        worker->push(std::make_shared<Reader>(reborn));
+        std::shared_ptr<ReborningVideoFrame> reborn = std::allocate_shared<ReborningVideoFrame>(
+            PoolAllocator<ReborningVideoFrame>(context.framesPool), context, sourceID, frameId, frame);
+        worker->push(std::allocate_shared<Reader>(PoolAllocator<Reader>(context.readersPool), reborn));
     } catch (const std::bad_weak_ptr&) {}
 }
 
@@ -348,6 +363,11 @@ bool Drawer::isReady() {
     }
 }
 
+std::chrono::steady_clock::time_point Drawer::readyTime() {
+    const Context& context = static_cast<ReborningVideoFrame*>(sharedVideoFrame.get())->context;
+    return context.drawersContext.prevShow + context.drawersContext.showPeriod;
+}
+
 void Drawer::process() {
     const int64_t frameId = sharedVideoFrame->frameId;
     Context& context = static_cast<ReborningVideoFrame*>(sharedVideoFrame.get())->context;
@@ -408,7 +428,7 @@ void Drawer::process() {
 
 void ResAggregator::process() {
     Context& context = static_cast<ReborningVideoFrame*>(sharedVideoFrame.get())->context;
-    context.freeDetectionInfersCount += context.detectorsInfers.inferRequests.lockedSize();
+    context.freeDetectionInfersCount += context.detectorsInfers.inferRequests.size();
     context.frameCounter++;
     unsigned sourceID = sharedVideoFrame->sourceID;
     auto& personTracker = context.trackersContext.personTracker[sourceID];
@@ -426,40 +446,42 @@ void ResAggregator::process() {
 
     int w = sharedVideoFrame->frame.size().width;
     int h = sharedVideoFrame->frame.size().height;
-    for (auto it1 = personTracker.trackables.begin(); it1 != personTracker.trackables.end(); ++it1) {
-        cv::Rect2d  l1 = it1->second.bbox;
-        auto it2 = it1;
-        ++it2;
-        for (; it2 != personTracker.trackables.end(); ++it2) {
-            cv::Rect2d  l2 = it2->second.bbox;
-            cv::Point2d a, b, c, d;
-            if (l1.y + l1.height < l2.y + l2.height) {
-                a = { l1.x, l1.y + l1.height };
-                b = { l1.x + l1.width, l1.y + l1.height };
-                c = { l2.x, l2.y + l2.height };
-                d = { l2.x + l2.width, l2.y + l2.height };
-            }
-            else {
-                c = { l1.x, l1.y + l1.height };
-                d = { l1.x + l1.width, l1.y + l1.height };
-                a = { l2.x, l2.y + l2.height };
-                b = { l2.x + l2.width, l2.y + l2.height };
-            }
+    constexpr unsigned minIter = 4;  // ~ 5 feets
+    std::vector<cv::Rect2d> personBoxes;
+    personBoxes.reserve(personTracker.trackables.size());
+    for (const auto& trackable : personTracker.trackables) {
+        personBoxes.emplace_back(trackable.second.bbox);
+    }
+    forCloseCandidates(personBoxes, minIter, [&](size_t i, size_t j) {
+        const cv::Rect2d& l1 = personBoxes[i];
+        const cv::Rect2d& l2 = personBoxes[j];
+        cv::Point2d a, b, c, d;
+        if (l1.y + l1.height < l2.y + l2.height) {
+            a = { l1.x, l1.y + l1.height };
+            b = { l1.x + l1.width, l1.y + l1.height };
+            c = { l2.x, l2.y + l2.height };
+            d = { l2.x + l2.width, l2.y + l2.height };
+        }
+        else {
+            c = { l1.x, l1.y + l1.height };
+            d = { l1.x + l1.width, l1.y + l1.height };
+            a = { l2.x, l2.y + l2.height };
+            b = { l2.x + l2.width, l2.y + l2.height };
+        }
 
-            std::tuple<int, int> frame_shape(h, w);
-            auto result = socialDistance(frame_shape, a, b, c, d, 4 /* ~ 5 feets */,
-                context.trackersContext.minW[sourceID],
-                context.trackersContext.maxW[sourceID]);
-
-            if (std::get<1>(result)) {
-                cv::rectangle(sharedVideoFrame->frame, l1, { 0, 255, 255 }, 2);
-                cv::rectangle(sharedVideoFrame->frame, l2, { 0, 255, 255 }, 2);
-                cv::Point2d rect1center = { l1.x + l1.width / 2, l1.y + l1.height / 2 };
-                cv::Point2d rect2center = { l2.x + l2.width / 2, l2.y + l2.height / 2 };
-                cv::line(sharedVideoFrame->frame, rect1center, rect2center, { 0, 0, 255 }, 3);
-            }
+        std::tuple<int, int> frame_shape(h, w);
+        auto result = socialDistance(frame_shape, a, b, c, d, minIter,
+            context.trackersContext.minW[sourceID],
+            context.trackersContext.maxW[sourceID]);
+
+        if (std::get<1>(result)) {
+            cv::rectangle(sharedVideoFrame->frame, l1, { 0, 255, 255 }, 2);
+            cv::rectangle(sharedVideoFrame->frame, l2, { 0, 255, 255 }, 2);
+            cv::Point2d rect1center = { l1.x + l1.width / 2, l1.y + l1.height / 2 };
+            cv::Point2d rect2center = { l2.x + l2.width / 2, l2.y + l2.height / 2 };
+            cv::line(sharedVideoFrame->frame, rect1center, rect2center, { 0, 0, 255 }, 3);
         }
-    }
+    });
 
     tryPush(context.drawersContext.drawersWorker, std::make_shared<Drawer>(sharedVideoFrame));
     ++context.trackersContext.lastProcessedIds[sourceID];
@@ -476,23 +498,38 @@ bool DetectionsProcessor::isReady() {
             personRects.emplace_back(result.location & cv::Rect{ cv::Point(0, 0), sharedVideoFrame->frame.size() });
         }
 
-        context.detectorsInfers.inferRequests.lockedPushBack(*inferRequest);
+        context.detectorsInfers.inferRequests.tryPush(inferRequest);
         requireGettingNumberOfDetections = false;
+
+        if (!FLAGS_m_reid.empty() && FLAGS_reid_period > 1) {
+            // Persons who keep their tracks take the descriptors over, ReId runs for the rest only
+            PersonTrackers& personTracker = context.trackersContext.personTracker[sharedVideoFrame->sourceID];
+            for (auto it = personRects.begin(); it != personRects.end(); ) {
+                std::vector<float> reid;
+                int reidAge;
+                if (personTracker.reuseReid(*it, static_cast<int>(FLAGS_reid_period), reid, reidAge)) {
+                    const cv::Rect rect = *it;
+                    classifiersAggregator->push(cv::Rect(rect));
+                    TrackableObject trackable{rect, reid, {rect.x + rect.width / 2, rect.y + rect.height}};
+                    trackable.reidAge = reidAge;
+                    classifiersAggregator->push(std::move(trackable));
+                    it = personRects.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
     }
 
     if (personRects.empty() || FLAGS_m_reid.empty()) {
         return true;
     } else {
-        // isReady() is called under mutexes so it is assured that available InferRequests will not be taken, but new InferRequests can come in
         // acquire as many InferRequests as it is possible or needed
-        InferRequestsContainer& reidInfers = context.reidInfers;
-        reidInfers.inferRequests.mutex.lock();
-        const std::size_t numberOfReIdInferRequestsAcquired = std::min(personRects.size(), reidInfers.inferRequests.container.size());
-        reservedReIdRequests.assign(reidInfers.inferRequests.container.end() - numberOfReIdInferRequestsAcquired, reidInfers.inferRequests.container.end());
-        reidInfers.inferRequests.container.erase(reidInfers.inferRequests.container.end() - numberOfReIdInferRequestsAcquired,
-                                                 reidInfers.inferRequests.container.end());
-        reidInfers.inferRequests.mutex.unlock();
-        return numberOfReIdInferRequestsAcquired;
+        ov::InferRequest* request;
+        while (reservedReIdRequests.size() < personRects.size() && context.reidInfers.inferRequests.tryPop(request)) {
+            reservedReIdRequests.emplace_back(*request);
+        }
+        return !reservedReIdRequests.empty();
     }
 }
 
@@ -517,7 +554,7 @@ void DetectionsProcessor::process() {
                                     classifiersAggregator->push(cv::Rect(rect));
                                     classifiersAggregator->push(TrackableObject{rect,
                                             std::move(result), {rect.x + rect.width / 2, rect.y + rect.height } });
-                                    context.reidInfers.inferRequests.lockedPushBack(reidRequest);
+                                    context.reidInfers.inferRequests.tryPush(&reidRequest);
                             },
                             classifiersAggregator, std::ref(reidRequest), personRect, std::ref(context)));
 
@@ -541,25 +578,12 @@ void DetectionsProcessor::process() {
 
 bool InferTask::isReady() {
     InferRequestsContainer& detectorsInfers = static_cast<ReborningVideoFrame*>(sharedVideoFrame.get())->context.detectorsInfers;
-    if (detectorsInfers.inferRequests.container.empty()) {
-        return false;
-    } else {
-        detectorsInfers.inferRequests.mutex.lock();
-        if (detectorsInfers.inferRequests.container.empty()) {
-            detectorsInfers.inferRequests.mutex.unlock();
-            return false;
-        } else {
-            return true;  // process() will unlock the mutex
-        }
-    }
+    return detectorsInfers.inferRequests.tryPop(reservedRequest);  // process() starts the reserved InferRequest
 }
 
 void InferTask::process() {
     Context& context = static_cast<ReborningVideoFrame*>(sharedVideoFrame.get())->context;
-    InferRequestsContainer& detectorsInfers = context.detectorsInfers;
-    std::reference_wrapper<ov::InferRequest> inferRequest = detectorsInfers.inferRequests.container.back();
-    detectorsInfers.inferRequests.container.pop_back();
-    detectorsInfers.inferRequests.mutex.unlock();
+    std::reference_wrapper<ov::InferRequest> inferRequest = *reservedRequest;
 
     context.inferTasksContext.detector.setImage(inferRequest, sharedVideoFrame->frame);
 
@@ -764,18 +788,37 @@ int main(int argc, char* argv[]) {
         context.readersContext.readersWorker = context.inferTasksContext.inferTasksWorker
             = context.detectionsProcessorsContext.reidTasksWorker = context.drawersContext.drawersWorker
             = context.resAggregatorsWorker = worker;
+        context.detectorsInfers.inferRequests.setWorker(worker);
+        context.reidInfers.inferRequests.setWorker(worker);
 
         for (uint64_t i = 0; i < FLAGS_n_iqs; i++) {
             for (unsigned sourceID = 0; sourceID < inputChannels.size(); sourceID++) {
-                VideoFrame::Ptr sharedVideoFrame = std::make_shared<ReborningVideoFrame>(context, sourceID, i);
-                worker->push(std::make_shared<Reader>(sharedVideoFrame));
+                VideoFrame::Ptr sharedVideoFrame = std::allocate_shared<ReborningVideoFrame>(
+                    PoolAllocator<ReborningVideoFrame>(context.framesPool), context, sourceID, i);
+                worker->push(std::allocate_shared<Reader>(PoolAllocator<Reader>(context.readersPool), sharedVideoFrame));
             }
         }
 
+        if (0 != FLAGS_max_queued) {
+            worker->setLimits(typeid(InferTask), {0, FLAGS_max_queued});
+            worker->setLimits(typeid(DetectionsProcessor), {0, FLAGS_max_queued});
+            worker->setProducer(typeid(Reader));
+        }
+
         // Running
+        if (!FLAGS_trace.empty()) {
+            worker->enableTracing(1 << 16);
+        }
         worker->runThreads();
         worker->threadFunc();
         worker->join();
+        if (!FLAGS_trace.empty()) {
+            std::ofstream traceFile(FLAGS_trace);
+            worker->writeTrace(traceFile);
+            if (!traceFile) {
+                throw std::runtime_error("Can't write the trace to " + FLAGS_trace);
+            }
+        }
 
         uint32_t frameCounter = context.frameCounter;
         double detectionsInfersUsage = 0;
@@ -787,6 +830,12 @@ int main(int argc, char* argv[]) {
         slog::info << "Metrics report:" << slog::endl;
         context.metrics.logTotal();
         slog::info << "\tDetection InferRequests usage: " << detectionsInfersUsage << "%" << slog::endl;
+        for (const Worker::TaskClassStats& taskStats : worker->getStats()) {
+            slog::info << "\t" << taskStats.name << " tasks: " << taskStats.processed << " processed, max queue depth "
+                << taskStats.maxQueued << ", mean wait time: " << std::fixed << std::setprecision(1)
+                << std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(taskStats.meanWaitTime).count()
+                << " ms" << slog::endl;
+        }
         slog::info << context.drawersContext.presenter.reportMeans() << slog::endl;
     } catch (const std::exception& error) {
         slog::err << error.what() << slog::endl;
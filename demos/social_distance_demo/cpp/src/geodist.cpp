@@ -2,7 +2,10 @@
 // SPDX-License-Identifier: Apache-2.0
 //
 
+#include <algorithm>
 #include <cmath>
+#include <functional>
+#include <numeric>
 #include <tuple>
 #include <vector>
 #include "geodist.hpp"
@@ -305,3 +308,34 @@ std::tuple<bool, bool, double> socialDistance(std::tuple<int, int>& frameShape,
     bool alert = cnt >= minIter ? false : true;
     return std::make_tuple(false, alert, cnt);
 }
+
+void forCloseCandidates(const std::vector<cv::Rect2d>& boxes, unsigned minIter,
+                        const std::function<void(size_t, size_t)>& func) {
+    // The perspective walk advances by about a person width per iteration and depth foreshortening makes the vertical
+    // step shorter than that, 2 covers the estimation's slack
+    const double depthFactor = 2.0 * minIter;
+    std::vector<size_t> order(boxes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&boxes](size_t lhs, size_t rhs) {
+        return boxes[lhs].br().y < boxes[rhs].br().y;
+    });
+    double maxWidth = 0;
+    for (const cv::Rect2d& box : boxes) {
+        maxWidth = std::max(maxWidth, box.width);
+    }
+
+    for (size_t first = 0; first < order.size(); ++first) {
+        const cv::Rect2d& box1 = boxes[order[first]];
+        for (size_t second = first + 1; second < order.size(); ++second) {
+            const cv::Rect2d& box2 = boxes[order[second]];
+            const double depthDiff = box2.br().y - box1.br().y;
+            if (depthDiff > depthFactor * maxWidth) {
+                break;  // the further boxes are even lower
+            }
+            if (depthDiff > depthFactor * std::max(box1.width, box2.width)) {
+                continue;
+            }
+            func(std::min(order[first], order[second]), std::max(order[first], order[second]));
+        }
+    }
+}
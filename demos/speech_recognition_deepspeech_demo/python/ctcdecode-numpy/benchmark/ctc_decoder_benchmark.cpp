@@ -0,0 +1,387 @@
+/*********************************************************************
+* Copyright (c) 2021 Intel Corporation
+* SPDX-License-Identifier: Apache-2.0
+**********************************************************************/
+
+// Standalone benchmark of the native CTC decoder, without Python and SWIG in the way.
+//
+// Replays recorded probability matrices (.npy files of float32, shape [frames, alphabet+1]
+// with the blank last, as produced by the DeepSpeech model) through:
+//  * CtcDecoderState, in chunks as the streaming demo does: reports real-time factor (RTF),
+//    per-frame latency percentiles, memory allocations and LM state cache hit rates;
+//  * ctc_beam_search_decoder_batch() with different numbers of threads: reports RTF and
+//    speedup against one thread.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ctc_beam_search_decoder.h"
+#include "scorer_yoklm.h"
+
+
+// Count heap allocations of the process while count_allocations is set.
+// It is off in the multi-threaded runs, not to add contention on the counters.
+static std::atomic<bool> count_allocations(false);
+static std::atomic<size_t> allocation_count(0);
+static std::atomic<size_t> allocation_bytes(0);
+
+void* operator new(size_t size) {
+  if (count_allocations.load(std::memory_order_relaxed)) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+  }
+  if (void* ptr = std::malloc(size == 0 ? 1 : size))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double seconds_since(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+struct Options {
+  std::string alphabet_file;
+  std::string lm_file;
+  std::vector<std::string> probs_files;
+  size_t beam_size = 500;
+  double cutoff_prob = 1.0;
+  size_t cutoff_top_n = 40;
+  double alpha = 0.75;
+  double beta = 1.85;
+  bool log_probs = false;
+  double frame_seconds = 20e-3;
+  size_t chunk_frames = 16;
+  size_t repeat = 3;
+  std::vector<size_t> threads;
+  size_t batch_copies = 1;
+};
+
+struct Utterance {
+  std::string name;
+  size_t frames;
+  size_t alphabet_size;  // including blank
+  std::vector<float> probs;  // frames x alphabet_size
+};
+
+void print_usage(const char* program) {
+  std::cout <<
+    "Usage: " << program << " --alphabet FILE [options] PROBS.npy [PROBS.npy ...]\n"
+    "\n"
+    "  --alphabet FILE      alphabet in the demo format (without the blank, which is the last column of probs)\n"
+    "  --lm FILE            KenLM binary (v5) language model; no LM if omitted\n"
+    "  --beam-size N        beam width (default 500)\n"
+    "  --cutoff-prob P      cumulative probability cutoff (default 1.0)\n"
+    "  --cutoff-top-n N     at most N symbols per frame (default 40)\n"
+    "  --alpha A            LM weight (default 0.75)\n"
+    "  --beta B             word insertion weight (default 1.85)\n"
+    "  --log-probs          the matrices contain natural logarithms of probabilities\n"
+    "  --frame-seconds S    duration of one frame of probs for RTF (default 0.02)\n"
+    "  --chunk N            frames per append() in the streaming run (default 16)\n"
+    "  --repeat N           repeat the streaming run N times (default 3)\n"
+    "  --threads N,N,...    thread counts for the batch run (default 1,2,4,... up to the number of cores)\n"
+    "  --batch-copies N     decode every utterance N times in the batch run (default 1)\n";
+}
+
+std::vector<size_t> parse_size_list(const std::string& text) {
+  std::vector<size_t> values;
+  std::stringstream stream(text);
+  std::string item;
+  while (std::getline(stream, item, ','))
+    values.push_back(std::stoul(item));
+  return values;
+}
+
+Options parse_options(int argc, char* argv[]) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    auto value = [&]() -> std::string {
+      if (i + 1 >= argc)
+        throw std::invalid_argument("Missing value for " + arg);
+      return argv[++i];
+    };
+    if (arg == "-h" || arg == "--help") {
+      print_usage(argv[0]);
+      std::exit(0);
+    } else if (arg == "--alphabet") {
+      options.alphabet_file = value();
+    } else if (arg == "--lm") {
+      options.lm_file = value();
+    } else if (arg == "--beam-size") {
+      options.beam_size = std::stoul(value());
+    } else if (arg == "--cutoff-prob") {
+      options.cutoff_prob = std::stod(value());
+    } else if (arg == "--cutoff-top-n") {
+      options.cutoff_top_n = std::stoul(value());
+    } else if (arg == "--alpha") {
+      options.alpha = std::stod(value());
+    } else if (arg == "--beta") {
+      options.beta = std::stod(value());
+    } else if (arg == "--log-probs") {
+      options.log_probs = true;
+    } else if (arg == "--frame-seconds") {
+      options.frame_seconds = std::stod(value());
+    } else if (arg == "--chunk") {
+      options.chunk_frames = std::max<size_t>(std::stoul(value()), 1);
+    } else if (arg == "--repeat") {
+      options.repeat = std::max<size_t>(std::stoul(value()), 1);
+    } else if (arg == "--threads") {
+      options.threads = parse_size_list(value());
+    } else if (arg == "--batch-copies") {
+      options.batch_copies = std::max<size_t>(std::stoul(value()), 1);
+    } else if (!arg.empty() && arg[0] == '-') {
+      throw std::invalid_argument("Unknown option " + arg);
+    } else {
+      options.probs_files.push_back(arg);
+    }
+  }
+  if (options.alphabet_file.empty() || options.probs_files.empty()) {
+    print_usage(argv[0]);
+    throw std::invalid_argument("--alphabet and at least one probs file are required");
+  }
+  if (options.threads.empty()) {
+    const size_t cores = std::max(std::thread::hardware_concurrency(), 1u);
+    for (size_t threads = 1; threads < cores; threads *= 2)
+      options.threads.push_back(threads);
+    options.threads.push_back(cores);
+  }
+  return options;
+}
+
+// Same format as load_alphabet() in asr_utils/ctc_decoder_seq_pipeline.py
+std::vector<std::string> load_alphabet(const std::string& filename) {
+  std::ifstream file(filename);
+  if (!file)
+    throw std::runtime_error("Cannot open alphabet file " + filename);
+  std::vector<std::string> alphabet;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    if (line.empty())  // empty line ends the alphabet
+      break;
+    if (line[0] == '#')  // comment
+      continue;
+    if (line.compare(0, 2, "\\s") == 0)
+      line = " " + line.substr(2);
+    else if (line[0] == '\\')
+      line = line.substr(1);
+    alphabet.push_back(line);
+  }
+  return alphabet;
+}
+
+// Minimal reader for C-ordered little-endian float32 .npy files of shape [frames, symbols],
+// unit dimensions (e.g. the batch dimension of [frames, 1, symbols]) are ignored
+Utterance load_npy(const std::string& filename) {
+  std::ifstream file(filename, std::ios::binary);
+  if (!file)
+    throw std::runtime_error("Cannot open " + filename);
+  char magic[8];
+  if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, "\x93NUMPY", 6) != 0)
+    throw std::runtime_error(filename + ": not an .npy file");
+  size_t header_len = 0;
+  if (magic[6] == 1) {
+    unsigned char len[2];
+    file.read(reinterpret_cast<char*>(len), 2);
+    header_len = len[0] | (len[1] << 8);
+  } else {
+    unsigned char len[4];
+    file.read(reinterpret_cast<char*>(len), 4);
+    header_len = len[0] | (len[1] << 8) | (len[2] << 16) | (size_t(len[3]) << 24);
+  }
+  std::string header(header_len, '\0');
+  if (!file.read(&header[0], header_len))
+    throw std::runtime_error(filename + ": truncated header");
+
+  if (header.find("'descr': '<f4'") == std::string::npos)
+    throw std::runtime_error(filename + ": only float32 (<f4) arrays are supported");
+  if (header.find("'fortran_order': False") == std::string::npos)
+    throw std::runtime_error(filename + ": only C-ordered arrays are supported");
+  const size_t shape_begin = header.find('(', header.find("'shape'"));
+  const size_t shape_end = header.find(')', shape_begin);
+  if (shape_begin == std::string::npos || shape_end == std::string::npos)
+    throw std::runtime_error(filename + ": no shape in header");
+  std::vector<size_t> dims;
+  for (size_t dim : parse_size_list(header.substr(shape_begin + 1, shape_end - shape_begin - 1)))
+    if (dim != 1)
+      dims.push_back(dim);
+  if (dims.size() != 2)
+    throw std::runtime_error(filename + ": expected a 2-D array [frames, symbols]");
+
+  Utterance utterance;
+  utterance.name = filename;
+  utterance.frames = dims[0];
+  utterance.alphabet_size = dims[1];
+  utterance.probs.resize(dims[0] * dims[1]);
+  if (!file.read(reinterpret_cast<char*>(utterance.probs.data()), utterance.probs.size() * sizeof(float)))
+    throw std::runtime_error(filename + ": truncated data");
+  return utterance;
+}
+
+double percentile(std::vector<double> values, double p) {
+  if (values.empty())
+    return 0;
+  const size_t k = std::min(values.size() - 1, size_t(p / 100. * values.size()));
+  std::nth_element(values.begin(), values.begin() + k, values.end());
+  return values[k];
+}
+
+void run_streaming(const Options& options,
+                   const std::vector<Utterance>& utterances,
+                   const std::vector<std::string>& alphabet,
+                   ScorerBase* scorer) {
+  CtcDecoderState decoder;
+  decoder.init(alphabet, alphabet.size() - 1, options.beam_size, scorer);
+  decoder.set_config("cutoff_prob", options.cutoff_prob, true);
+  decoder.set_config("cutoff_top_n", options.cutoff_top_n, true);
+
+  const size_t alphabet_size = alphabet.size();
+  std::vector<double> frame_latencies;
+  double decode_seconds = 0, audio_seconds = 0;
+  size_t frames = 0, allocations = 0, allocated_bytes = 0, lm_lookups = 0, lm_hits = 0;
+  count_allocations = true;
+  for (size_t run = 0; run < options.repeat; run++) {
+    for (const auto& utterance : utterances) {
+      decoder.new_sequence();
+      const size_t lookups_before = decoder.lm_states().lookups();
+      const size_t hits_before = decoder.lm_states().hits();
+      const size_t allocations_before = allocation_count.load();
+      const size_t bytes_before = allocation_bytes.load();
+
+      for (size_t frame = 0; frame < utterance.frames; frame += options.chunk_frames) {
+        const size_t chunk = std::min(options.chunk_frames, utterance.frames - frame);
+        const auto start = Clock::now();
+        decoder.append(&utterance.probs[frame * alphabet_size], chunk, alphabet_size, 1, options.log_probs);
+        const double seconds = seconds_since(start);
+        decode_seconds += seconds;
+        frame_latencies.insert(frame_latencies.end(), chunk, seconds / chunk);
+      }
+      const auto start = Clock::now();
+      auto candidates = decoder.decode(1);
+      decode_seconds += seconds_since(start);
+
+      allocations += allocation_count.load() - allocations_before;
+      allocated_bytes += allocation_bytes.load() - bytes_before;
+      lm_lookups += decoder.lm_states().lookups() - lookups_before;
+      lm_hits += decoder.lm_states().hits() - hits_before;
+      frames += utterance.frames;
+      audio_seconds += utterance.frames * options.frame_seconds;
+    }
+  }
+  count_allocations = false;
+
+  std::printf("Streaming (CtcDecoderState, %zu frames per append, %zu runs):\n", options.chunk_frames, options.repeat);
+  std::printf("  RTF                 %.4f  (%.3f s for %.1f s of audio)\n",
+              decode_seconds / audio_seconds, decode_seconds, audio_seconds);
+  std::printf("  frame latency, us   p50 %.1f  p90 %.1f  p99 %.1f  max %.1f\n",
+              1e6 * percentile(frame_latencies, 50), 1e6 * percentile(frame_latencies, 90),
+              1e6 * percentile(frame_latencies, 99), 1e6 * percentile(frame_latencies, 100));
+  std::printf("  allocations         %.1f per frame, %.1f KiB per frame\n",
+              double(allocations) / frames, allocated_bytes / 1024. / frames);
+  if (scorer != nullptr)
+    std::printf("  LM cache            %zu lookups, %.2f%% hits\n",
+                lm_lookups, lm_lookups ? 100. * lm_hits / lm_lookups : 0.);
+}
+
+void run_batch(const Options& options,
+               const std::vector<Utterance>& utterances,
+               const std::vector<std::string>& alphabet,
+               ScorerBase* scorer) {
+  // Pad all utterances to the longest one, as the Python BatchedCtcLmDecoder does
+  const size_t alphabet_size = alphabet.size();
+  size_t max_frames = 0;
+  for (const auto& utterance : utterances)
+    max_frames = std::max(max_frames, utterance.frames);
+  const size_t batch_size = utterances.size() * options.batch_copies;
+  std::vector<float> probs(batch_size * max_frames * alphabet_size, 0.f);
+  std::vector<size_t> frame_nums;
+  double audio_seconds = 0;
+  for (size_t i = 0; i < batch_size; i++) {
+    const Utterance& utterance = utterances[i % utterances.size()];
+    std::copy(utterance.probs.begin(), utterance.probs.end(), probs.begin() + i * max_frames * alphabet_size);
+    frame_nums.push_back(utterance.frames);
+    audio_seconds += utterance.frames * options.frame_seconds;
+  }
+
+  std::printf("Batch (ctc_beam_search_decoder_batch, %zu utterances):\n", batch_size);
+  std::printf("  threads      RTF  speedup\n");
+  double single_thread_seconds = 0;
+  for (size_t threads : options.threads) {
+    double best_seconds = 0;
+    for (size_t run = 0; run < options.repeat; run++) {
+      const auto start = Clock::now();
+      ctc_beam_search_decoder_batch(probs.data(), batch_size, frame_nums,
+                                    max_frames * alphabet_size, alphabet_size, 1,
+                                    alphabet, options.beam_size, threads,
+                                    options.cutoff_prob, options.cutoff_top_n,
+                                    alphabet_size - 1, options.log_probs, scorer);
+      const double seconds = seconds_since(start);
+      if (run == 0 || seconds < best_seconds)
+        best_seconds = seconds;
+    }
+    if (single_thread_seconds == 0)
+      single_thread_seconds = best_seconds * threads;  // ideal scaling if the list doesn't start with 1
+    std::printf("  %7zu  %7.4f  %7.2f\n", threads, best_seconds / audio_seconds, single_thread_seconds / best_seconds);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  try {
+    const Options options = parse_options(argc, argv);
+
+    std::vector<std::string> alphabet = load_alphabet(options.alphabet_file);
+    std::vector<Utterance> utterances;
+    for (const auto& filename : options.probs_files) {
+      utterances.push_back(load_npy(filename));
+      if (utterances.back().alphabet_size != alphabet.size() + 1)
+        throw std::runtime_error(filename + ": the number of symbols doesn't match the alphabet size + blank");
+    }
+
+    std::unique_ptr<ScorerYoklm> scorer;
+    if (!options.lm_file.empty()) {
+      const auto start = Clock::now();
+      scorer.reset(new ScorerYoklm(options.alpha, options.beta, options.lm_file, alphabet));
+      std::printf("LM loaded in %.3f s: order %zu, %s-based, %zu words in dictionary\n",
+                  seconds_since(start), scorer->get_max_order(),
+                  scorer->is_character_based() ? "character" : "word", scorer->get_dict_size());
+    }
+
+    // The decoder takes the blank as an extra symbol
+    alphabet.push_back("");
+
+    run_streaming(options, utterances, alphabet, scorer.get());
+    run_batch(options, utterances, alphabet, scorer.get());
+  } catch (const std::exception& error) {
+    std::cerr << "Error: " << error.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
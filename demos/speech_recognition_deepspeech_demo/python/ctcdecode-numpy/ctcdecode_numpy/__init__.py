@@ -15,10 +15,14 @@ from . import impl
 class SeqCtcLmDecoder:
     """
     Non-batched sequential CTC + n-gram LM beam search decoder
+
+    With commit_horizon > 0 the prefix shared by all candidates which is older than commit_horizon frames is
+    committed and dropped from the beam search, so that memory stays bounded in long streams.
+    decode() returns candidates starting with the committed text which wasn't taken by take_committed() yet.
     """
     def __init__(self, alphabet, beam_size, max_candidates=None,
             cutoff_prob=1.0, cutoff_top_n=40,
-            scorer_lm_fname=None, alpha=None, beta=None):
+            scorer_lm_fname=None, alpha=None, beta=None, commit_horizon=0):
         self.alphabet = alphabet
         self.beam_size = beam_size
         self.max_candidates = max_candidates or 0
@@ -39,6 +43,7 @@ class SeqCtcLmDecoder:
         )
         self.decoder_state.set_config("cutoff_top_n", cutoff_top_n, required=True)
         self.decoder_state.set_config("cutoff_prob", cutoff_prob, required=True)
+        self.decoder_state.set_config("commit_horizon", commit_horizon, required=True)
 
     def append_data(self, probs, log_probs):
         """
@@ -51,6 +56,16 @@ class SeqCtcLmDecoder:
             self.decoder_state.new_sequence()
         self.decoder_state.append_numpy(probs, log_probs)
 
+    def take_committed(self):
+        """
+        Return the text committed since the previous call, it is removed from the candidates returned by decode()
+        """
+        symbols, timesteps = self.decoder_state.take_committed_numpy()
+        return namespace(
+            text=''.join(self.alphabet[idx] for idx in symbols),
+            ts=list(timesteps),
+        )
+
     def decode(self, probs=None, log_probs=None, finalize=True):
         if probs is not None:
             assert log_probs is not None, "When 'probs' argument is provided, 'log_probs' argument must be provided as well"
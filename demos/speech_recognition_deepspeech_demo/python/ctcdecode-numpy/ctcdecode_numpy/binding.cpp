@@ -92,12 +92,35 @@ void CtcDecoderStateNumpy::decode_numpy(
   }
 }
 
+void CtcDecoderStateNumpy::take_committed_numpy(
+    int ** symbols, size_t * symbols_dim,
+    int ** timesteps, size_t * timesteps_dim
+) {
+  Output committed = take_committed();
+  if (committed.tokens.size() != committed.timesteps.size())
+    throw std::logic_error("CtcDecoder::take_committed() returned mismatching lengths of tokens and timesteps");
+
+  // malloc(0) may return NULL, so allocate at least one element
+  *symbols_dim = *timesteps_dim = committed.tokens.size();
+  *symbols = (int *)malloc(sizeof(**symbols) * std::max(*symbols_dim, size_t(1)));
+  if (*symbols == 0)
+    throw std::runtime_error("take_committed_numpy: cannot malloc() symbols");
+
+  *timesteps = (int *)malloc(sizeof(**timesteps) * std::max(*timesteps_dim, size_t(1)));
+  if (*timesteps == 0)
+    throw std::runtime_error("take_committed_numpy: cannot malloc() timesteps");
+
+  std::copy(committed.tokens.begin(), committed.tokens.end(), *symbols);
+  std::copy(committed.timesteps.begin(), committed.timesteps.end(), *timesteps);
+}
+
 size_t index_3d(size_t i1, size_t i2, size_t i3, size_t dim1, size_t dim2, size_t dim3) {
   return i3 + dim3 * (i2 + dim2 * i1);
 }
 
 void batched_ctc_lm_decoder(
         const float * probs,  size_t batch_size, size_t max_frames, size_t num_classes,
+        size_t batch_stride, size_t frame_stride, size_t class_stride,  // strides of probs, in elements
         const int * seq_lens,  size_t seq_lens_dim_batch,
         const std::vector<std::string> labels,
         size_t beam_size,                 // limits candidates maintained inside beam search
@@ -135,7 +158,7 @@ void batched_ctc_lm_decoder(
     }
 
     std::vector<std::vector<std::pair<float, Output> > > batch_results =
-        ctc_beam_search_decoder_batch(probs, batch_size, seq_lens_vec, max_frames*num_classes, num_classes, 1,
+        ctc_beam_search_decoder_batch(probs, batch_size, seq_lens_vec, batch_stride, frame_stride, class_stride,
             labels, beam_size, num_processes,
             cutoff_prob, cutoff_top_n, blank_id, log_probs, lm_scorer);
 
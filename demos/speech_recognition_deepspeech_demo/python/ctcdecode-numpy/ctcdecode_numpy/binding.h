@@ -9,7 +9,9 @@
 #include "ctc_beam_search_decoder.h"
 
 
-// Simple wrapper class to accept numpy arrays in SWIG in append_numpy() method
+// Simple wrapper class to accept numpy arrays in SWIG in append_numpy() method.
+// The GIL is released in append_numpy() and decode_numpy(), so one object must not be
+// used from several Python threads at the same time.
 class CtcDecoderStateNumpy : public CtcDecoderState {
 public:
   CtcDecoderStateNumpy() : CtcDecoderState() {}
@@ -18,10 +20,14 @@ public:
   CtcDecoderStateNumpy& operator=(const CtcDecoderStateNumpy& src) = delete;
   CtcDecoderStateNumpy& operator=(CtcDecoderStateNumpy&& src) = default;
 
+  // probs is read in place with the strides (in elements) of the numpy array
   void append_numpy(
-    const float * probs,  size_t num_frames, size_t num_classes,
+    const float * probs,  size_t num_frames, size_t num_classes, size_t frame_stride, size_t class_stride,
     bool log_probs
-  ) { append(probs, num_frames, num_classes, 1, log_probs); }
+  ) {
+    (void)num_classes;  // the alphabet is given to init()
+    append(probs, num_frames, frame_stride, class_stride, log_probs);
+  }
   void decode_numpy(
     int limit_candidates,  // limits candidates returned from beam search; use -1 to not limit
     bool finalize,  // normally (by default) set to "true" to finalize when getting the final decoding result
@@ -33,11 +39,18 @@ public:
     float ** scores, size_t * scores_dim,  // shape (cand_size,)
     int ** symbols_lengths, size_t * symbols_lengths_dim  // shape (cand_size,)
   );
+  // Tokens committed since the previous call, see "commit_horizon" config parameter
+  void take_committed_numpy(
+    // Output arrays (SWIG memory managed argout, malloc() allocator):
+    int ** symbols, size_t * symbols_dim,
+    int ** timesteps, size_t * timesteps_dim
+  );
 };
 
 // Interface to provide functionality of Parlance decoder
 void batched_ctc_lm_decoder(
     const float * probs,  size_t batch_size, size_t max_frames, size_t num_classes,
+    size_t batch_stride, size_t frame_stride, size_t class_stride,  // strides of probs, in elements
     const int * seq_lens,  size_t seq_lens_dim_batch,
     const std::vector<std::string> labels,
     size_t beam_size,                 // limits candidates maintained inside beam search
@@ -13,11 +13,30 @@
 #include <iostream>
 #include <limits>
 #include <map>
+#include <mutex>
 #include <utility>
 
 #include "decoder_utils.h"
 #include "ThreadPool.h"
 
+// LM states kept by a decoder between sequences before its cache is dropped
+const size_t MAX_LM_STATES = 1 << 20;
+
+namespace {
+// Persistent pool for ctc_beam_search_decoder_batch() calls with the given number of threads.
+// Pools are never destroyed, so that no threads are joined at exit or on library unload.
+ThreadPool& batch_thread_pool(size_t num_threads) {
+  static std::mutex mutex;
+  static std::map<size_t, ThreadPool *> * pools = new std::map<size_t, ThreadPool *>;
+
+  std::unique_lock<std::mutex> lock(mutex);
+  ThreadPool *& pool = (*pools)[num_threads];
+  if (pool == nullptr)
+    pool = new ThreadPool(num_threads);
+  return *pool;
+}
+}  // namespace
+
 
 CtcDecoderState::CtcDecoderState() :
   is_finalized_(false),
@@ -27,8 +46,13 @@ CtcDecoderState::CtcDecoderState() :
   blank_idx_(-1),
   beam_size_(0),
   lm_scorer_(nullptr),
+  lm_states_(),
   cutoff_prob_(0.),
   cutoff_top_n_(0),
+  log_blank_skip_prob_(0.),
+  commit_horizon_(0),
+  committed_(),
+  committed_score_(0.),
   candidates_trie_(),
   candidates_()  // empty candidates_ will flag uninitialized object
 {}
@@ -54,9 +78,12 @@ void CtcDecoderState::init(
   blank_idx_ = blank_idx;
   beam_size_ = beam_size;
   lm_scorer_ = lm_scorer;
+  lm_states_.reset(lm_scorer_);
 
   cutoff_prob_ = 1.0;
   cutoff_top_n_ = 40;
+  log_blank_skip_prob_ = 0.;  // never skip
+  commit_horizon_ = 0;  // never commit
 
   candidates_.clear();
   candidates_trie_.reset();
@@ -65,6 +92,7 @@ void CtcDecoderState::init(
 
 void CtcDecoderState::deinit() {
   lm_scorer_ = nullptr;
+  lm_states_.reset(nullptr);
   alphabet_.clear();
   candidates_.clear();
   candidates_trie_.reset();
@@ -77,6 +105,8 @@ bool CtcDecoderState::set_config(const std::string& name, double value, bool req
   else if (name == "cutoff_prob")  cutoff_prob_ = value;
   else if (name == "cutoff_top_n")  cutoff_top_n_ = size_t(value);
   else if (name == "next_timestep")  next_timestep_ = size_t(value);
+  else if (name == "blank_skip_prob")  log_blank_skip_prob_ = std::log(value);
+  else if (name == "commit_horizon")  commit_horizon_ = size_t(value);
   else {
     if (required)
       throw std::invalid_argument("CtcDecoderState::set_config(): unknown configuration parameter: " + name);
@@ -91,6 +121,8 @@ double CtcDecoderState::get_config(const std::string& name, bool required, doubl
   else if (name == "cutoff_prob")  return cutoff_prob_;
   else if (name == "cutoff_top_n")  return cutoff_top_n_;
   else if (name == "next_timestep")  return next_timestep_;
+  else if (name == "blank_skip_prob")  return std::exp(log_blank_skip_prob_);
+  else if (name == "commit_horizon")  return commit_horizon_;
 
   if (required)
     throw std::invalid_argument("CtcDecoderState::get_config(): unknown configuration parameter: " + name);
@@ -98,16 +130,28 @@ double CtcDecoderState::get_config(const std::string& name, bool required, doubl
 }
 
 void CtcDecoderState::new_sequence() {
-  // The root of PathTrie (candidates_trie_) owns the whole trie.
+  // The arena (candidates_trie_) owns the whole trie, the previous sequence is freed at once
+  // and its memory is reused.
+  if (!candidates_trie_)
+    candidates_trie_ = std::unique_ptr<PathTrieArena>(new PathTrieArena);
   // init prefixes' root
-  candidates_trie_ = std::unique_ptr<PathTrie>(new PathTrie);
-  candidates_trie_->score = candidates_trie_->log_prob_b_prev = 0.0;
+  PathTrie * root = candidates_trie_->reset();
+  root->score = root->log_prob_b_prev = 0.0;
   candidates_.clear();
-  candidates_.push_back(candidates_trie_.get());
+  candidates_.push_back(root);
+  committed_ = Output();
+  committed_score_ = 0.;
+
+  if (lm_scorer_ != nullptr) {
+    // The cache grows with the number of distinct n-grams seen
+    if (lm_states_.size() > MAX_LM_STATES)
+      lm_states_.reset(lm_scorer_);
+    root->lm_state = lm_states_.start_state();
+  }
 
   if (lm_scorer_ != nullptr && !lm_scorer_->is_character_based()) {
     WordPrefixSet * dict_ptr = lm_scorer_->dictionary.get();
-    candidates_trie_->set_dictionary(dict_ptr);
+    root->set_dictionary(dict_ptr);
   }
 
   is_finalized_ = false;
@@ -130,29 +174,30 @@ void CtcDecoderState::append(
   for (size_t time_step = 0; time_step < probs_frame_num; ++time_step) {
     const float * prob = &probs[time_step * probs_frame_stride];
 
+    float blank_prob = log_probs ? prob[blank_idx_ * probs_alph_stride] : std::log(prob[blank_idx_ * probs_alph_stride]);
     float min_cutoff = -NUM_FLT_INF;
     bool full_beam = false;
     if (lm_scorer_ != nullptr) {
+      // the candidates are not sorted, the cutoff only needs the worst one
       size_t num_candidates = std::min(candidates_.size(), beam_size_);
-      std::sort(
+      PathTrie * worst = *std::max_element(
           candidates_.begin(), candidates_.begin() + num_candidates, prefix_compare);
-      float blank_prob = log_probs ? prob[blank_idx_ * probs_alph_stride] : std::log(prob[blank_idx_ * probs_alph_stride]);
-      min_cutoff = candidates_[num_candidates - 1]->score +
-                   blank_prob - std::max(0.0, lm_scorer_->beta);
+      min_cutoff = worst->score + blank_prob - std::max(0.0, lm_scorer_->beta);
       full_beam = (num_candidates == beam_size_);
     }
+    // blank-dominated frame: keep the prefixes as they are, don't extend them
+    const bool blank_frame = blank_prob > log_blank_skip_prob_;
 
-    std::vector<std::pair<size_t, float>> log_prob_idx =
-        get_pruned_log_probs(prob, alphabet_.size(), probs_alph_stride, cutoff_prob_, cutoff_top_n_, log_probs);
+    get_pruned_log_probs(prob, alphabet_.size(), probs_alph_stride, cutoff_prob_, cutoff_top_n_, log_probs, log_prob_idx_);
     // loop over chars
-    for (size_t index = 0; index < alphabet_.size(); index++) {
-      auto c = log_prob_idx[index].first;
-      auto log_prob_c = log_prob_idx[index].second;
+    for (size_t index = 0; index < log_prob_idx_.size(); index++) {
+      auto c = log_prob_idx_[index].first;
+      auto log_prob_c = log_prob_idx_[index].second;
 
       for (size_t i = 0; i < candidates_.size() && i < beam_size_; ++i) {
         auto prefix = candidates_[i];
         if (full_beam && log_prob_c + prefix->score < min_cutoff) {
-          break;
+          continue;
         }
         // blank
         if (c == blank_idx_) {
@@ -165,6 +210,9 @@ void CtcDecoderState::append(
           prefix->log_prob_nb_cur = log_sum_exp(
               prefix->log_prob_nb_cur, log_prob_c + prefix->log_prob_nb_prev);
         }
+        if (blank_frame) {
+          continue;
+        }
         // get/create new prefix; returns null if the new prefix was pruned by a dictionary
         auto prefix_new = prefix->get_path_trie(c, time_step + next_timestep_, log_prob_c);
 
@@ -189,10 +237,10 @@ void CtcDecoderState::append(
               prefix_to_score = prefix;
             }
 
+            // prefix->lm_state is the context of the scored word
             float score = 0.0;
-            std::vector<std::string> ngram;
-            ngram = lm_scorer_->make_ngram(prefix_to_score);
-            score = lm_scorer_->get_log_cond_prob(ngram) * lm_scorer_->alpha;
+            std::string word = lm_scorer_->make_word(prefix_to_score);
+            score = lm_states_.get_log_cond_prob(prefix->lm_state, word, prefix_new->lm_state) * lm_scorer_->alpha;
             log_p += score;
             log_p += lm_scorer_->beta;
           }
@@ -204,7 +252,7 @@ void CtcDecoderState::append(
 
     candidates_.clear();
     // update log probs
-    candidates_trie_->iterate_to_vec(candidates_);
+    candidates_trie_->root()->iterate_to_vec(candidates_);
 
     // only preserve top beam_size prefixes
     if (candidates_.size() >= beam_size_) {
@@ -216,11 +264,75 @@ void CtcDecoderState::append(
         candidates_[i]->remove();
       }
     }
+
+    // the prefix is committed once in commit_horizon_ frames, so tokens are committed
+    // commit_horizon_ to 2 * commit_horizon_ frames after they are decoded
+    size_t timestep = time_step + next_timestep_ + 1;
+    if (commit_horizon_ > 0 && timestep % commit_horizon_ == 0)
+      commit_prefix(timestep);
   }  // end of loop over time
 
   next_timestep_ += probs_frame_num;
 }
 
+void CtcDecoderState::commit_prefix(size_t timestep) {
+  size_t num_candidates = std::min(candidates_.size(), beam_size_);
+  if (num_candidates == 0)
+    return;
+  PathTrie * best = *std::min_element(candidates_.begin(), candidates_.begin() + num_candidates, prefix_compare);
+
+  // A word LM scores words from the trie, so a word-based LM can only be cut between words.
+  // The new root keeps its character, so that repetitions of it are still merged.
+  bool word_boundary_only = lm_scorer_ != nullptr && !lm_scorer_->is_character_based();
+  PathTrie * new_root = best;
+  while (new_root->parent != nullptr &&
+         (size_t(new_root->timestep) + commit_horizon_ > timestep ||
+          (word_boundary_only && new_root->character != space_idx_)))
+    new_root = new_root->parent;
+  if (new_root->parent == nullptr)
+    return;
+
+  // Candidates which diverged from the best one before the new root have been behind it for commit_horizon_
+  // frames at least. Near ties may survive for arbitrarily long, so they are dropped instead of waiting
+  // for all candidates to share the prefix.
+  auto is_descendant = [new_root](PathTrie * node) {
+    for (; node != nullptr; node = node->parent)
+      if (node == new_root)
+        return true;
+    return false;
+  };
+  auto kept_end = std::partition(candidates_.begin(), candidates_.begin() + num_candidates, is_descendant);
+  for (auto it = kept_end; it != candidates_.begin() + num_candidates; ++it)
+    (*it)->remove();
+  candidates_.erase(kept_end, candidates_.end());
+
+  std::vector<int> tokens;
+  std::vector<int> timesteps;
+  new_root->get_path_vec(tokens, timesteps);
+  committed_.tokens.insert(committed_.tokens.end(), tokens.begin(), tokens.end());
+  committed_.timesteps.insert(committed_.timesteps.end(), timesteps.begin(), timesteps.end());
+  candidates_trie_->reroot(new_root);
+
+  // float scores lose precision as they decrease over a long stream, keep the best one at 0
+  float best_score = best->score;
+  if (best_score > -NUM_FLT_INF) {
+    for (auto candidate : candidates_) {
+      candidate->log_prob_b_prev -= best_score;
+      candidate->log_prob_nb_prev -= best_score;
+      candidate->score -= best_score;
+    }
+    committed_score_ += best_score;
+  }
+}
+
+Output CtcDecoderState::take_committed() {
+  Output committed;
+  committed.audio_score = 0.;
+  std::swap(committed.tokens, committed_.tokens);
+  std::swap(committed.timesteps, committed_.timesteps);
+  return committed;
+}
+
 void CtcDecoderState::finalize() {
   if (!candidates_trie_)
     throw std::runtime_error("CtcDecoderState::finalize(): uninitialized state");
@@ -235,8 +347,9 @@ void CtcDecoderState::finalize() {
       auto prefix = candidates_[i];
       if (!prefix->is_empty() && prefix->character != space_idx_) {
         float score = 0.0;
-        std::vector<std::string> ngram = lm_scorer_->make_ngram(prefix);
-        score = lm_scorer_->get_log_cond_prob(ngram) * lm_scorer_->alpha;
+        int next_state;
+        std::string word = lm_scorer_->make_word(prefix);
+        score = lm_states_.get_log_cond_prob(prefix->lm_state, word, next_state) * lm_scorer_->alpha;
         score += lm_scorer_->beta;
         prefix->score += score;
       }
@@ -260,8 +373,9 @@ std::vector<std::pair<float, Output>> CtcDecoderState::decode(
 
   // Compute approximate ctc (audio model) score, without affecting the
   // return order of decoding result.
+  // (With committed tokens, only the LM scores of the tokens after the trie root are removed.)
   for (size_t i = 0; i < num_candidates; ++i) {
-    float approx_ctc = candidates_[i]->score;
+    float approx_ctc = candidates_[i]->score + committed_score_;
     if (lm_scorer_ != nullptr && _finalize) {
       std::vector<int> output;
       std::vector<int> timesteps;
@@ -276,7 +390,16 @@ std::vector<std::pair<float, Output>> CtcDecoderState::decode(
     candidates_[i]->approx_ctc = approx_ctc;
   }
 
-  return get_beam_search_result(candidates_, num_candidates);
+  std::vector<std::pair<float, Output>> results = get_beam_search_result(candidates_, num_candidates);
+  if (committed_score_ != 0. || !committed_.tokens.empty()) {
+    for (auto& result : results) {
+      result.first -= committed_score_;
+      result.second.tokens.insert(result.second.tokens.begin(), committed_.tokens.begin(), committed_.tokens.end());
+      result.second.timesteps.insert(
+          result.second.timesteps.begin(), committed_.timesteps.begin(), committed_.timesteps.end());
+    }
+  }
+  return results;
 };
 
 std::vector<std::pair<float, Output>> ctc_beam_search_decoder(
@@ -319,8 +442,8 @@ ctc_beam_search_decoder_batch(
     bool log_probs,
     ScorerBase * lm_scorer) {
   VALID_CHECK_GT(num_processes, 0, "num_processes must be nonnegative!");
-  // thread pool
-  ThreadPool pool(num_processes);
+  // thread pool, shared with other calls
+  ThreadPool& pool = batch_thread_pool(num_processes);
 
   if (probs_frame_nums.size() != probs_batch_num)
     throw std::runtime_error("ctc_beam_search_decoder_batch(): sizes of probs and probs_frame_nums arguments don't match");
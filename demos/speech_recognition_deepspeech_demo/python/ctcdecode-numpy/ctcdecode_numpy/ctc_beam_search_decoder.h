@@ -15,6 +15,7 @@
 #include <vector>
 
 #include "scorer_base.h"
+#include "lm_state_cache.h"
 #include "output.h"
 #include "path_trie.h"
 
@@ -48,12 +49,20 @@ public:
   );
   void finalize();
   bool is_finalized() { return is_finalized_; }
+  const LmStateCache& lm_states() const { return lm_states_; }  // for statistics
+  // The candidates start with the committed tokens not taken by take_committed() yet
   std::vector<std::pair<float, Output>> decode(
     size_t limit_candidates = 0,  // use 0 to return all candidates
     bool finalize = true
   );
+  // Return and forget the tokens committed since the previous call, see "commit_horizon" config parameter
+  Output take_committed();
 
 private:
+  // Commit the prefix of the best candidate up to the node older than commit_horizon_ frames,
+  // make that node the root of the trie and drop the candidates which don't descend from it
+  void commit_prefix(size_t timestep);
+
   bool is_finalized_;
   size_t next_timestep_;
 
@@ -62,10 +71,18 @@ private:
   size_t blank_idx_;
   size_t beam_size_;
   ScorerBase * lm_scorer_;
+  LmStateCache lm_states_;  // kept between sequences to reuse the scored n-grams
   float cutoff_prob_;
   size_t cutoff_top_n_;
-
-  std::unique_ptr<PathTrie> candidates_trie_;
+  // frames with blank probability above blank_skip_prob don't extend prefixes; 1 = never skip
+  float log_blank_skip_prob_;
+  std::vector<std::pair<size_t, float>> log_prob_idx_;  // pruned log-probabilities of the current frame
+  // frames after which the prefix of the best candidate is committed; 0 = never commit
+  size_t commit_horizon_;
+  Output committed_;  // committed tokens not taken yet
+  double committed_score_;  // subtracted from the scores of the candidates to keep them near 0 in long streams
+
+  std::unique_ptr<PathTrieArena> candidates_trie_;  // owns all nodes of the prefix trie
   std::vector<PathTrie *> candidates_;  // non-owning pointers, to cache data
 };
 
@@ -0,0 +1,161 @@
+/*********************************************************************
+* Copyright (c) 2021 Intel Corporation
+* SPDX-License-Identifier: Apache-2.0
+**********************************************************************/
+
+#include "ctc_decoder_service.h"
+
+#include <stdexcept>
+
+#include "decoder_utils.h"
+#include "ThreadPool.h"
+
+CtcDecoderService::CtcDecoderService(size_t num_threads) :
+  mutex_(),
+  sessions_(),
+  next_session_id_(0),
+  scheduled_sessions_(0),
+  all_idle_(),
+  pool_() {
+  VALID_CHECK_GT(num_threads, 0, "num_threads must be positive!");
+  pool_.reset(new ThreadPool(num_threads));
+}
+
+CtcDecoderService::~CtcDecoderService() {
+  // Workers reschedule sessions with pending requests, which ThreadPool forbids once it is stopping
+  wait_all();
+}
+
+CtcDecoderService::SessionId CtcDecoderService::open_session(
+    const std::vector<std::string>& alphabet,
+    size_t blank_idx,
+    size_t beam_size,
+    ScorerBase * lm_scorer) {
+  std::shared_ptr<Session> session = std::make_shared<Session>();
+  session->state.init(alphabet, blank_idx, beam_size, lm_scorer);
+  session->alphabet_size = alphabet.size();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  SessionId id = next_session_id_++;
+  sessions_.emplace(id, std::move(session));
+  return id;
+}
+
+void CtcDecoderService::close_session(SessionId session) {
+  std::shared_ptr<Session> closed;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = sessions_.find(session);
+    if (it == sessions_.end())
+      throw std::invalid_argument("CtcDecoderService::close_session(): unknown session");
+    closed = std::move(it->second);
+    sessions_.erase(it);
+  }
+  // The pending requests hold the session, the last one releases it
+  schedule(closed, [](){});
+}
+
+std::future<bool> CtcDecoderService::set_config(SessionId session, const std::string& name, double value, bool required) {
+  return schedule<bool>(find_session(session), [name, value, required](CtcDecoderState& state) {
+    return state.set_config(name, value, required);
+  });
+}
+
+std::future<void> CtcDecoderService::new_sequence(SessionId session) {
+  return schedule<void>(find_session(session), [](CtcDecoderState& state) {
+    state.new_sequence();
+  });
+}
+
+std::future<void> CtcDecoderService::append(
+    SessionId session,
+    const float * probs,
+    size_t probs_frame_num,
+    size_t probs_frame_stride,
+    size_t probs_alph_stride,
+    bool log_probs) {
+  std::shared_ptr<Session> s = find_session(session);
+  const size_t alphabet_size = s->alphabet_size;
+  // Copy only the used elements, packed into frames of alphabet_size
+  std::shared_ptr<std::vector<float>> chunk = std::make_shared<std::vector<float>>(probs_frame_num * alphabet_size);
+  for (size_t t = 0; t < probs_frame_num; ++t)
+    for (size_t i = 0; i < alphabet_size; ++i)
+      (*chunk)[t * alphabet_size + i] = probs[t * probs_frame_stride + i * probs_alph_stride];
+
+  return schedule<void>(s, [chunk, probs_frame_num, alphabet_size, log_probs](CtcDecoderState& state) {
+    state.append(chunk->data(), probs_frame_num, alphabet_size, 1, log_probs);
+  });
+}
+
+std::future<CtcDecoderService::Result> CtcDecoderService::decode(
+    SessionId session, size_t limit_candidates, bool finalize) {
+  return schedule<Result>(find_session(session), [limit_candidates, finalize](CtcDecoderState& state) {
+    return state.decode(limit_candidates, finalize);
+  });
+}
+
+void CtcDecoderService::wait_all() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  all_idle_.wait(lock, [this]() { return scheduled_sessions_ == 0; });
+}
+
+std::shared_ptr<CtcDecoderService::Session> CtcDecoderService::find_session(SessionId session) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = sessions_.find(session);
+  if (it == sessions_.end())
+    throw std::invalid_argument("CtcDecoderService: unknown session");
+  return it->second;
+}
+
+template <class R>
+std::future<R> CtcDecoderService::schedule(
+    const std::shared_ptr<Session>& session, std::function<R(CtcDecoderState&)> request) {
+  Session * raw = session.get();  // the request is owned by the session
+  std::shared_ptr<std::packaged_task<R()>> task =
+    std::make_shared<std::packaged_task<R()>>([raw, request]() { return request(raw->state); });
+  std::future<R> result = task->get_future();
+  schedule(session, [task]() { (*task)(); });
+  return result;
+}
+
+void CtcDecoderService::schedule(const std::shared_ptr<Session>& session, std::function<void()> request) {
+  bool start;
+  {
+    std::unique_lock<std::mutex> lock(session->mutex);
+    session->requests.push_back(std::move(request));
+    start = !session->scheduled;
+    session->scheduled = true;
+  }
+  if (start) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      ++scheduled_sessions_;
+    }
+    pool_->enqueue([this, session]() { run_next(session); });
+  }
+}
+
+void CtcDecoderService::run_next(const std::shared_ptr<Session>& session) {
+  std::function<void()> request;
+  {
+    std::unique_lock<std::mutex> lock(session->mutex);
+    request = std::move(session->requests.front());
+    session->requests.pop_front();
+  }
+  request();  // exceptions are stored in the future of the request
+
+  bool more;
+  {
+    std::unique_lock<std::mutex> lock(session->mutex);
+    more = !session->requests.empty();
+    session->scheduled = more;
+  }
+  if (more) {
+    // Go to the end of the queue to let other sessions run
+    pool_->enqueue([this, session]() { run_next(session); });
+  } else {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (--scheduled_sessions_ == 0)
+      all_idle_.notify_all();
+  }
+}
@@ -0,0 +1,103 @@
+/*********************************************************************
+* Copyright (c) 2021 Intel Corporation
+* SPDX-License-Identifier: Apache-2.0
+**********************************************************************/
+
+#ifndef CTC_DECODER_SERVICE_H_
+#define CTC_DECODER_SERVICE_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ctc_beam_search_decoder.h"
+#include "output.h"
+#include "scorer_base.h"
+
+class ThreadPool;
+
+/* Long-lived decoder for many concurrent streams.
+ *
+ * Each stream is a session with its own CtcDecoderState. Requests of all
+ * sessions run on one persistent thread pool; the requests of a session run
+ * one at a time in the order they were made, and a session with pending data
+ * gives the worker up after each request, so that busy streams don't starve
+ * the others. All methods are thread-safe and return without waiting for the
+ * decoding, results come through std::future.
+ *
+ * Example:
+ *     CtcDecoderService service(4);
+ *     auto id = service.open_session(alphabet, blank_idx, beam_size, scorer);
+ *     for each chunk:  service.append(id, chunk, frames, frame_stride, 1, log_probs);
+ *     auto result = service.decode(id).get();
+ *     service.close_session(id);
+ */
+class CtcDecoderService {
+public:
+  typedef size_t SessionId;
+  typedef std::vector<std::pair<float, Output>> Result;
+
+  explicit CtcDecoderService(size_t num_threads);
+  CtcDecoderService(const CtcDecoderService&) = delete;
+  CtcDecoderService& operator=(const CtcDecoderService&) = delete;
+  ~CtcDecoderService();  // completes all requests
+
+  // see CtcDecoderState::init(); lm_scorer must outlive the session
+  SessionId open_session(
+    const std::vector<std::string>& alphabet,
+    size_t blank_idx,
+    size_t beam_size,
+    ScorerBase * lm_scorer = nullptr
+  );
+  // the session is destroyed after its pending requests; its id becomes invalid at once
+  void close_session(SessionId session);
+
+  std::future<bool> set_config(SessionId session, const std::string& name, double value, bool required = false);
+  std::future<void> new_sequence(SessionId session);
+  // probs are copied, so the buffer can be reused right after the call
+  std::future<void> append(
+    SessionId session,
+    const float * probs,
+    size_t probs_frame_num,
+    size_t probs_frame_stride,
+    size_t probs_alph_stride,
+    bool log_probs
+  );
+  std::future<Result> decode(SessionId session, size_t limit_candidates = 0, bool finalize = true);
+
+  // wait until all requests made so far are completed
+  void wait_all();
+
+private:
+  struct Session {
+    CtcDecoderState state;
+    size_t alphabet_size = 0;
+    std::mutex mutex;
+    std::deque<std::function<void()>> requests;
+    bool scheduled = false;  // a worker is running or is going to run the requests
+  };
+
+  std::shared_ptr<Session> find_session(SessionId session);
+  template <class R>
+  std::future<R> schedule(const std::shared_ptr<Session>& session, std::function<R(CtcDecoderState&)> request);
+  void schedule(const std::shared_ptr<Session>& session, std::function<void()> request);
+  void run_next(const std::shared_ptr<Session>& session);
+
+  std::mutex mutex_;
+  std::map<SessionId, std::shared_ptr<Session>> sessions_;
+  SessionId next_session_id_;
+  size_t scheduled_sessions_;
+  std::condition_variable all_idle_;
+
+  std::unique_ptr<ThreadPool> pool_;
+};
+
+#endif  // CTC_DECODER_SERVICE_H_
@@ -12,43 +12,42 @@
 #include <cmath>
 #include <limits>
 
-std::vector<std::pair<size_t, float>> get_pruned_log_probs(
+void get_pruned_log_probs(
     const float * prob_step,
     size_t alphabet_len,
     size_t prob_stride,
     float cutoff_prob,
     size_t cutoff_top_n,
-    bool log_probs) {
-  std::vector<std::pair<int, float>> prob_idx;
-  float log_cutoff_prob = log(cutoff_prob);
+    bool log_probs,
+    std::vector<std::pair<size_t, float>>& log_prob_idx) {
+  log_prob_idx.resize(alphabet_len);
   for (size_t i = 0; i < alphabet_len; ++i) {
-    prob_idx.push_back(std::pair<int, float>(i, prob_step[i * prob_stride]));
+    log_prob_idx[i] = std::pair<size_t, float>(i, prob_step[i * prob_stride]);
   }
-  // pruning of vocabulary
+  // pruning of vocabulary: only the kept symbols are ordered
+  float log_cutoff_prob = log(cutoff_prob);
   size_t cutoff_len = alphabet_len;
   if (log_cutoff_prob < 0.0 || cutoff_top_n < cutoff_len) {
-    std::sort(
-        prob_idx.begin(), prob_idx.end(), pair_comp_second_rev<int, float>);
+    size_t sorted_len = std::min(cutoff_top_n, alphabet_len);
+    std::partial_sort(log_prob_idx.begin(), log_prob_idx.begin() + sorted_len, log_prob_idx.end(),
+                      pair_comp_second_rev<size_t, float>);
     if (log_cutoff_prob < 0.0) {
       float cum_prob = 0.0;
       cutoff_len = 0;
-      for (size_t i = 0; i < prob_idx.size(); ++i) {
-        cum_prob = log_sum_exp<float>(cum_prob, log_probs ? prob_idx[i].second : log(prob_idx[i].second) );
+      for (size_t i = 0; i < sorted_len; ++i) {
+        cum_prob = log_sum_exp<float>(cum_prob, log_probs ? log_prob_idx[i].second : log(log_prob_idx[i].second) );
         cutoff_len += 1;
         if (cum_prob >= cutoff_prob || cutoff_len >= cutoff_top_n) break;
       }
     }else{
       cutoff_len = cutoff_top_n;
     }
-    prob_idx = std::vector<std::pair<int, float>>(
-        prob_idx.begin(), prob_idx.begin() + cutoff_len);
+    log_prob_idx.resize(cutoff_len);
   }
-  std::vector<std::pair<size_t, float>> log_prob_idx;
-  for (size_t i = 0; i < cutoff_len; ++i) {
-    log_prob_idx.push_back(std::pair<int, float>(
-        prob_idx[i].first, log_probs ? prob_idx[i].second : log(prob_idx[i].second + NUM_FLT_MIN)));
+  if (!log_probs) {
+    for (auto& prob_idx : log_prob_idx)
+      prob_idx.second = log(prob_idx.second + NUM_FLT_MIN);
   }
-  return log_prob_idx;
 }
 
 
@@ -66,14 +66,16 @@ T log_sum_exp(const T &x, const T &y) {
   return std::log(std::exp(x - xmax) + std::exp(y - xmax)) + xmax;
 }
 
-// Get pruned probability vector for each time step's beam search
-std::vector<std::pair<size_t, float>> get_pruned_log_probs(
+// Get pruned log-probability vector for each time step's beam search;
+// the kept (index, log-probability) pairs go to log_prob_idx in descending order when pruning happens
+void get_pruned_log_probs(
     const float * prob_step,
     size_t alphabet_len,
     size_t prob_stride,
     float cutoff_prob,
     size_t cutoff_top_n,
-    bool log_probs);
+    bool log_probs,
+    std::vector<std::pair<size_t, float>>& log_prob_idx);
 
 // Get beam search result from prefixes in trie tree
 std::vector<std::pair<float, Output>> get_beam_search_result(
@@ -19,6 +19,28 @@
   }
 }
 
+// Release the GIL during decoding, so that other Python threads run meanwhile.
+// The arguments are converted before and the results after, with the GIL held.
+%define %release_gil(function)
+%exception function {
+  try {
+    PyThreadState * thread_state = PyEval_SaveThread();
+    try {
+      $action
+    } catch (...) {
+      PyEval_RestoreThread(thread_state);
+      throw;
+    }
+    PyEval_RestoreThread(thread_state);
+  } catch (const std::exception& e) {
+    SWIG_exception(SWIG_RuntimeError, e.what());
+  }
+}
+%enddef
+%release_gil(CtcDecoderStateNumpy::append_numpy)
+%release_gil(CtcDecoderStateNumpy::decode_numpy)
+%release_gil(batched_ctc_lm_decoder)
+
 %{
 #define SWIG_FILE_WITH_INIT
 %}
@@ -45,8 +67,61 @@ namespace std {
     %template(StringVector) std::vector<std::string>;
 }
 
-%apply (float * IN_ARRAY3, size_t DIM1, size_t DIM2, size_t DIM3) {(const float * probs, size_t batch_size, size_t max_frames, size_t num_classes)}
-%apply (float * IN_ARRAY2, size_t DIM1, size_t DIM2) {(const float * probs, size_t num_frames, size_t num_classes)}
+// Strided input arrays of probabilities: the data of float32 arrays is read in place with its strides,
+// other arrays (other dtype, byte-swapped, misaligned, negative strides) are converted to a copy.
+%fragment("Strided_Float_Array", "header", fragment="NumPy_Fragments")
+%{
+// Return a new reference to the array to read, or NULL with a Python exception set.
+// dims[ndim] and strides[ndim] (in elements) receive the shape of the array.
+static PyArrayObject * strided_float_array(PyObject * input, int ndim, float ** data, size_t * dims, size_t * strides) {
+  PyArrayObject * array = (PyArrayObject *)PyArray_FROM_OTF(input, NPY_FLOAT, NPY_ARRAY_ALIGNED | NPY_ARRAY_NOTSWAPPED);
+  if (!array || !require_dimensions(array, ndim)) {
+    Py_XDECREF(array);
+    return NULL;
+  }
+  for (int i = 0; i < ndim; i++) {
+    const npy_intp stride = PyArray_STRIDES(array)[i];
+    if (stride < 0 || stride % sizeof(float) != 0) {
+      PyArrayObject * contiguous = (PyArrayObject *)PyArray_GETCONTIGUOUS(array);
+      Py_DECREF(array);
+      array = contiguous;
+      if (!array)
+        return NULL;
+      break;
+    }
+  }
+  *data = (float *)array_data(array);
+  for (int i = 0; i < ndim; i++) {
+    dims[i] = (size_t)array_size(array, i);
+    strides[i] = (size_t)(PyArray_STRIDES(array)[i] / sizeof(float));
+  }
+  return array;
+}
+%}
+
+%typemap(in, fragment="Strided_Float_Array") (const float * probs, size_t batch_size, size_t max_frames, size_t num_classes,
+              size_t batch_stride, size_t frame_stride, size_t class_stride)
+    (PyArrayObject * probs_array = NULL, size_t dims[3], size_t strides[3])
+{
+  probs_array = strided_float_array($input, 3, &$1, dims, strides);
+  if (!probs_array) SWIG_fail;
+  $2 = dims[0];  $3 = dims[1];  $4 = dims[2];
+  $5 = strides[0];  $6 = strides[1];  $7 = strides[2];
+}
+%typemap(in, fragment="Strided_Float_Array") (const float * probs, size_t num_frames, size_t num_classes, size_t frame_stride, size_t class_stride)
+    (PyArrayObject * probs_array = NULL, size_t dims[2], size_t strides[2])
+{
+  probs_array = strided_float_array($input, 2, &$1, dims, strides);
+  if (!probs_array) SWIG_fail;
+  $2 = dims[0];  $3 = dims[1];
+  $4 = strides[0];  $5 = strides[1];
+}
+%typemap(freearg) (const float * probs, size_t batch_size, size_t max_frames, size_t num_classes,
+                   size_t batch_stride, size_t frame_stride, size_t class_stride),
+                  (const float * probs, size_t num_frames, size_t num_classes, size_t frame_stride, size_t class_stride)
+{
+  Py_XDECREF(probs_array$argnum);
+}
 %apply (int * IN_ARRAY1, size_t DIM1) {(const int * seq_lens, size_t seq_lens_dim_batch)}
 %apply (int ** ARGOUTVIEWM_ARRAY1, size_t * DIM1) {(int ** symbols, size_t * symbols_dim)}
 %apply (int ** ARGOUTVIEWM_ARRAY1, size_t * DIM1) {(int ** timesteps, size_t * timesteps_dim)}
@@ -55,6 +130,8 @@ namespace std {
 
 // Workaround for the absent support of std::unique_ptr<...>.
 %ignore ScorerBase::dictionary;
+// Output isn't wrapped, CtcDecoderStateNumpy::take_committed_numpy() returns numpy arrays instead
+%ignore CtcDecoderState::take_committed;
 
 %include "scorer_base.h"
 %include "scorer_yoklm.h"
@@ -5709,6 +5709,34 @@ SWIG_AsVal_bool (PyObject *obj, bool *val)
   }
 
 
+// Return a new reference to the array to read, or NULL with a Python exception set.
+// dims[ndim] and strides[ndim] (in elements) receive the shape of the array.
+static PyArrayObject * strided_float_array(PyObject * input, int ndim, float ** data, size_t * dims, size_t * strides) {
+  PyArrayObject * array = (PyArrayObject *)PyArray_FROM_OTF(input, NPY_FLOAT, NPY_ARRAY_ALIGNED | NPY_ARRAY_NOTSWAPPED);
+  if (!array || !require_dimensions(array, ndim)) {
+    Py_XDECREF(array);
+    return NULL;
+  }
+  for (int i = 0; i < ndim; i++) {
+    const npy_intp stride = PyArray_STRIDES(array)[i];
+    if (stride < 0 || stride % sizeof(float) != 0) {
+      PyArrayObject * contiguous = (PyArrayObject *)PyArray_GETCONTIGUOUS(array);
+      Py_DECREF(array);
+      array = contiguous;
+      if (!array)
+        return NULL;
+      break;
+    }
+  }
+  *data = (float *)array_data(array);
+  for (int i = 0; i < ndim; i++) {
+    dims[i] = (size_t)array_size(array, i);
+    strides[i] = (size_t)(PyArray_STRIDES(array)[i] / sizeof(float));
+  }
+  return array;
+}
+
+
 
 
 SWIGINTERN int
@@ -12922,13 +12950,16 @@ SWIGINTERN PyObject *_wrap_CtcDecoderStateNumpy_append_numpy(PyObject *SWIGUNUSE
   float *arg2 = (float *) 0 ;
   size_t arg3 ;
   size_t arg4 ;
-  bool arg5 ;
+  size_t arg5 ;
+  size_t arg6 ;
+  bool arg7 ;
   void *argp1 = 0 ;
   int res1 = 0 ;
-  PyArrayObject *array2 = NULL ;
-  int is_new_object2 = 0 ;
-  bool val5 ;
-  int ecode5 = 0 ;
+  PyArrayObject *probs_array2 = NULL ;
+  size_t dims2[2] ;
+  size_t strides2[2] ;
+  bool val7 ;
+  int ecode7 = 0 ;
   PyObject * obj0 = 0 ;
   PyObject * obj1 = 0 ;
   PyObject * obj2 = 0 ;
@@ -12940,43 +12971,38 @@ SWIGINTERN PyObject *_wrap_CtcDecoderStateNumpy_append_numpy(PyObject *SWIGUNUSE
   }
   arg1 = reinterpret_cast< CtcDecoderStateNumpy * >(argp1);
   {
-    npy_intp size[2] = {
-      -1, -1 
-    };
-    array2 = obj_to_array_contiguous_allow_conversion(obj1, NPY_FLOAT,
-      &is_new_object2);
-    if (!array2 || !require_dimensions(array2, 2) ||
-      !require_size(array2, size, 2)) SWIG_fail;
-    arg2 = (float*) array_data(array2);
-    arg3 = (size_t) array_size(array2,0);
-    arg4 = (size_t) array_size(array2,1);
-  }
-  ecode5 = SWIG_AsVal_bool(obj2, &val5);
-  if (!SWIG_IsOK(ecode5)) {
-    SWIG_exception_fail(SWIG_ArgError(ecode5), "in method '" "CtcDecoderStateNumpy_append_numpy" "', argument " "5"" of type '" "bool""'");
+    probs_array2 = strided_float_array(obj1, 2, &arg2, dims2, strides2);
+    if (!probs_array2) SWIG_fail;
+    arg3 = dims2[0];  arg4 = dims2[1];
+    arg5 = strides2[0];  arg6 = strides2[1];
+  }
+  ecode7 = SWIG_AsVal_bool(obj2, &val7);
+  if (!SWIG_IsOK(ecode7)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode7), "in method '" "CtcDecoderStateNumpy_append_numpy" "', argument " "7"" of type '" "bool""'");
   } 
-  arg5 = static_cast< bool >(val5);
+  arg7 = static_cast< bool >(val7);
   {
     try {
-      (arg1)->append_numpy((float const *)arg2,arg3,arg4,arg5);
+      PyThreadState * thread_state = PyEval_SaveThread();
+      try {
+        (arg1)->append_numpy((float const *)arg2,arg3,arg4,arg5,arg6,arg7);
+      } catch (...) {
+        PyEval_RestoreThread(thread_state);
+        throw;
+      }
+      PyEval_RestoreThread(thread_state);
     } catch (const std::exception& e) {
       SWIG_exception(SWIG_RuntimeError, e.what());
     }
   }
   resultobj = SWIG_Py_Void();
   {
-    if (is_new_object2 && array2)
-    {
-      Py_DECREF(array2); 
-    }
+    Py_XDECREF(probs_array2);
   }
   return resultobj;
 fail:
   {
-    if (is_new_object2 && array2)
-    {
-      Py_DECREF(array2); 
-    }
+    Py_XDECREF(probs_array2);
   }
   return NULL;
 }
@@ -13047,7 +13073,14 @@ SWIGINTERN PyObject *_wrap_CtcDecoderStateNumpy_decode_numpy(PyObject *SWIGUNUSE
   arg3 = static_cast< bool >(val3);
   {
     try {
-      (arg1)->decode_numpy(arg2,arg3,arg4,arg5,arg6,arg7,arg8,arg9,arg10,arg11);
+      PyThreadState * thread_state = PyEval_SaveThread();
+      try {
+        (arg1)->decode_numpy(arg2,arg3,arg4,arg5,arg6,arg7,arg8,arg9,arg10,arg11);
+      } catch (...) {
+        PyEval_RestoreThread(thread_state);
+        throw;
+      }
+      PyEval_RestoreThread(thread_state);
     } catch (const std::exception& e) {
       SWIG_exception(SWIG_RuntimeError, e.what());
     }
@@ -13151,6 +13184,95 @@ fail:
 }
 
 
+SWIGINTERN PyObject *_wrap_CtcDecoderStateNumpy_take_committed_numpy(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  CtcDecoderStateNumpy *arg1 = (CtcDecoderStateNumpy *) 0 ;
+  int **arg2 = (int **) 0 ;
+  size_t *arg3 = (size_t *) 0 ;
+  int **arg4 = (int **) 0 ;
+  size_t *arg5 = (size_t *) 0 ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  int *data_temp2 = NULL ;
+  size_t dim_temp2 ;
+  int *data_temp4 = NULL ;
+  size_t dim_temp4 ;
+  PyObject * obj0 = 0 ;
+  
+  {
+    arg2 = &data_temp2;
+    arg3 = &dim_temp2;
+  }
+  {
+    arg4 = &data_temp4;
+    arg5 = &dim_temp4;
+  }
+  if (!PyArg_ParseTuple(args,(char *)"O:CtcDecoderStateNumpy_take_committed_numpy",&obj0)) SWIG_fail;
+  res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_CtcDecoderStateNumpy, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "CtcDecoderStateNumpy_take_committed_numpy" "', argument " "1"" of type '" "CtcDecoderStateNumpy *""'"); 
+  }
+  arg1 = reinterpret_cast< CtcDecoderStateNumpy * >(argp1);
+  {
+    try {
+      (arg1)->take_committed_numpy(arg2,arg3,arg4,arg5);
+    } catch (const std::exception& e) {
+      SWIG_exception(SWIG_RuntimeError, e.what());
+    }
+  }
+  resultobj = SWIG_Py_Void();
+  {
+    npy_intp dims[1] = {
+      *arg3 
+    };
+    PyObject* obj = PyArray_SimpleNewFromData(1, dims, NPY_INT, (void*)(*arg2));
+    PyArrayObject* array = (PyArrayObject*) obj;
+    
+    if (!array) SWIG_fail;
+    
+#ifdef SWIGPY_USE_CAPSULE
+    PyObject* cap = PyCapsule_New((void*)(*arg2), SWIGPY_CAPSULE_NAME, free_cap);
+#else
+    PyObject* cap = PyCObject_FromVoidPtr((void*)(*arg2), free);
+#endif
+    
+#if NPY_API_VERSION < 0x00000007
+    PyArray_BASE(array) = cap;
+#else
+    PyArray_SetBaseObject(array,cap);
+#endif
+    
+    resultobj = SWIG_Python_AppendOutput(resultobj,obj);
+  }
+  {
+    npy_intp dims[1] = {
+      *arg5 
+    };
+    PyObject* obj = PyArray_SimpleNewFromData(1, dims, NPY_INT, (void*)(*arg4));
+    PyArrayObject* array = (PyArrayObject*) obj;
+    
+    if (!array) SWIG_fail;
+    
+#ifdef SWIGPY_USE_CAPSULE
+    PyObject* cap = PyCapsule_New((void*)(*arg4), SWIGPY_CAPSULE_NAME, free_cap);
+#else
+    PyObject* cap = PyCObject_FromVoidPtr((void*)(*arg4), free);
+#endif
+    
+#if NPY_API_VERSION < 0x00000007
+    PyArray_BASE(array) = cap;
+#else
+    PyArray_SetBaseObject(array,cap);
+#endif
+    
+    resultobj = SWIG_Python_AppendOutput(resultobj,obj);
+  }
+  return resultobj;
+fail:
+  return NULL;
+}
+
+
 SWIGINTERN PyObject *_wrap_delete_CtcDecoderStateNumpy(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
   PyObject *resultobj = 0;
   CtcDecoderStateNumpy *arg1 = (CtcDecoderStateNumpy *) 0 ;
@@ -13191,53 +13313,57 @@ SWIGINTERN PyObject *_wrap_batched_ctc_lm_decoder(PyObject *SWIGUNUSEDPARM(self)
   size_t arg2 ;
   size_t arg3 ;
   size_t arg4 ;
-  int *arg5 = (int *) 0 ;
+  size_t arg5 ;
   size_t arg6 ;
-  std::vector< std::string,std::allocator< std::string > > arg7 ;
-  size_t arg8 ;
+  size_t arg7 ;
+  int *arg8 = (int *) 0 ;
   size_t arg9 ;
-  size_t arg10 ;
-  float arg11 ;
+  std::vector< std::string,std::allocator< std::string > > arg10 ;
+  size_t arg11 ;
   size_t arg12 ;
   size_t arg13 ;
-  bool arg14 ;
-  ScorerBase *arg15 = (ScorerBase *) 0 ;
-  int **arg16 = (int **) 0 ;
-  size_t *arg17 = (size_t *) 0 ;
-  int **arg18 = (int **) 0 ;
-  size_t *arg19 = (size_t *) 0 ;
-  float **arg20 = (float **) 0 ;
-  size_t *arg21 = (size_t *) 0 ;
-  int **arg22 = (int **) 0 ;
-  size_t *arg23 = (size_t *) 0 ;
-  PyArrayObject *array1 = NULL ;
-  int is_new_object1 = 0 ;
-  PyArrayObject *array5 = NULL ;
-  int is_new_object5 = 0 ;
-  size_t val8 ;
-  int ecode8 = 0 ;
-  size_t val9 ;
-  int ecode9 = 0 ;
-  size_t val10 ;
-  int ecode10 = 0 ;
-  float val11 ;
+  float arg14 ;
+  size_t arg15 ;
+  size_t arg16 ;
+  bool arg17 ;
+  ScorerBase *arg18 = (ScorerBase *) 0 ;
+  int **arg19 = (int **) 0 ;
+  size_t *arg20 = (size_t *) 0 ;
+  int **arg21 = (int **) 0 ;
+  size_t *arg22 = (size_t *) 0 ;
+  float **arg23 = (float **) 0 ;
+  size_t *arg24 = (size_t *) 0 ;
+  int **arg25 = (int **) 0 ;
+  size_t *arg26 = (size_t *) 0 ;
+  PyArrayObject *probs_array1 = NULL ;
+  size_t dims1[3] ;
+  size_t strides1[3] ;
+  PyArrayObject *array8 = NULL ;
+  int is_new_object8 = 0 ;
+  size_t val11 ;
   int ecode11 = 0 ;
   size_t val12 ;
   int ecode12 = 0 ;
   size_t val13 ;
   int ecode13 = 0 ;
-  bool val14 ;
+  float val14 ;
   int ecode14 = 0 ;
-  void *argp15 = 0 ;
-  int res15 = 0 ;
-  int *data_temp16 = NULL ;
-  size_t dim_temp16 ;
-  int *data_temp18 = NULL ;
-  size_t dim_temp18 ;
-  float *data_temp20 = NULL ;
-  size_t dim_temp20 ;
-  int *data_temp22 = NULL ;
-  size_t dim_temp22 ;
+  size_t val15 ;
+  int ecode15 = 0 ;
+  size_t val16 ;
+  int ecode16 = 0 ;
+  bool val17 ;
+  int ecode17 = 0 ;
+  void *argp18 = 0 ;
+  int res18 = 0 ;
+  int *data_temp19 = NULL ;
+  size_t dim_temp19 ;
+  int *data_temp21 = NULL ;
+  size_t dim_temp21 ;
+  float *data_temp23 = NULL ;
+  size_t dim_temp23 ;
+  int *data_temp25 = NULL ;
+  size_t dim_temp25 ;
   PyObject * obj0 = 0 ;
   PyObject * obj1 = 0 ;
   PyObject * obj2 = 0 ;
@@ -13251,99 +13377,99 @@ SWIGINTERN PyObject *_wrap_batched_ctc_lm_decoder(PyObject *SWIGUNUSEDPARM(self)
   PyObject * obj10 = 0 ;
   
   {
-    arg16 = &data_temp16;
-    arg17 = &dim_temp16;
+    arg19 = &data_temp19;
+    arg20 = &dim_temp19;
   }
   {
-    arg18 = &data_temp18;
-    arg19 = &dim_temp18;
+    arg21 = &data_temp21;
+    arg22 = &dim_temp21;
   }
   {
-    arg20 = &data_temp20;
-    arg21 = &dim_temp20;
+    arg23 = &data_temp23;
+    arg24 = &dim_temp23;
   }
   {
-    arg22 = &data_temp22;
-    arg23 = &dim_temp22;
+    arg25 = &data_temp25;
+    arg26 = &dim_temp25;
   }
   if (!PyArg_ParseTuple(args,(char *)"OOOOOOOOOOO:batched_ctc_lm_decoder",&obj0,&obj1,&obj2,&obj3,&obj4,&obj5,&obj6,&obj7,&obj8,&obj9,&obj10)) SWIG_fail;
   {
-    npy_intp size[3] = {
-      -1, -1, -1 
-    };
-    array1 = obj_to_array_contiguous_allow_conversion(obj0, NPY_FLOAT,
-      &is_new_object1);
-    if (!array1 || !require_dimensions(array1, 3) ||
-      !require_size(array1, size, 3)) SWIG_fail;
-    arg1 = (float*) array_data(array1);
-    arg2 = (size_t) array_size(array1,0);
-    arg3 = (size_t) array_size(array1,1);
-    arg4 = (size_t) array_size(array1,2);
+    probs_array1 = strided_float_array(obj0, 3, &arg1, dims1, strides1);
+    if (!probs_array1) SWIG_fail;
+    arg2 = dims1[0];  arg3 = dims1[1];  arg4 = dims1[2];
+    arg5 = strides1[0];  arg6 = strides1[1];  arg7 = strides1[2];
   }
   {
     npy_intp size[1] = {
       -1 
     };
-    array5 = obj_to_array_contiguous_allow_conversion(obj1,
+    array8 = obj_to_array_contiguous_allow_conversion(obj1,
       NPY_INT,
-      &is_new_object5);
-    if (!array5 || !require_dimensions(array5, 1) ||
-      !require_size(array5, size, 1)) SWIG_fail;
-    arg5 = (int*) array_data(array5);
-    arg6 = (size_t) array_size(array5,0);
+      &is_new_object8);
+    if (!array8 || !require_dimensions(array8, 1) ||
+      !require_size(array8, size, 1)) SWIG_fail;
+    arg8 = (int*) array_data(array8);
+    arg9 = (size_t) array_size(array8,0);
   }
   {
     std::vector< std::string,std::allocator< std::string > > *ptr = (std::vector< std::string,std::allocator< std::string > > *)0;
     int res = swig::asptr(obj2, &ptr);
     if (!SWIG_IsOK(res) || !ptr) {
-      SWIG_exception_fail(SWIG_ArgError((ptr ? res : SWIG_TypeError)), "in method '" "batched_ctc_lm_decoder" "', argument " "7"" of type '" "std::vector< std::string,std::allocator< std::string > > const""'"); 
+      SWIG_exception_fail(SWIG_ArgError((ptr ? res : SWIG_TypeError)), "in method '" "batched_ctc_lm_decoder" "', argument " "10"" of type '" "std::vector< std::string,std::allocator< std::string > > const""'"); 
     }
-    arg7 = *ptr;
+    arg10 = *ptr;
     if (SWIG_IsNewObj(res)) delete ptr;
   }
-  ecode8 = SWIG_AsVal_size_t(obj3, &val8);
-  if (!SWIG_IsOK(ecode8)) {
-    SWIG_exception_fail(SWIG_ArgError(ecode8), "in method '" "batched_ctc_lm_decoder" "', argument " "8"" of type '" "size_t""'");
-  } 
-  arg8 = static_cast< size_t >(val8);
-  ecode9 = SWIG_AsVal_size_t(obj4, &val9);
-  if (!SWIG_IsOK(ecode9)) {
-    SWIG_exception_fail(SWIG_ArgError(ecode9), "in method '" "batched_ctc_lm_decoder" "', argument " "9"" of type '" "size_t""'");
-  } 
-  arg9 = static_cast< size_t >(val9);
-  ecode10 = SWIG_AsVal_size_t(obj5, &val10);
-  if (!SWIG_IsOK(ecode10)) {
-    SWIG_exception_fail(SWIG_ArgError(ecode10), "in method '" "batched_ctc_lm_decoder" "', argument " "10"" of type '" "size_t""'");
-  } 
-  arg10 = static_cast< size_t >(val10);
-  ecode11 = SWIG_AsVal_float(obj6, &val11);
+  ecode11 = SWIG_AsVal_size_t(obj3, &val11);
   if (!SWIG_IsOK(ecode11)) {
-    SWIG_exception_fail(SWIG_ArgError(ecode11), "in method '" "batched_ctc_lm_decoder" "', argument " "11"" of type '" "float""'");
+    SWIG_exception_fail(SWIG_ArgError(ecode11), "in method '" "batched_ctc_lm_decoder" "', argument " "11"" of type '" "size_t""'");
   } 
-  arg11 = static_cast< float >(val11);
-  ecode12 = SWIG_AsVal_size_t(obj7, &val12);
+  arg11 = static_cast< size_t >(val11);
+  ecode12 = SWIG_AsVal_size_t(obj4, &val12);
   if (!SWIG_IsOK(ecode12)) {
     SWIG_exception_fail(SWIG_ArgError(ecode12), "in method '" "batched_ctc_lm_decoder" "', argument " "12"" of type '" "size_t""'");
   } 
   arg12 = static_cast< size_t >(val12);
-  ecode13 = SWIG_AsVal_size_t(obj8, &val13);
+  ecode13 = SWIG_AsVal_size_t(obj5, &val13);
   if (!SWIG_IsOK(ecode13)) {
     SWIG_exception_fail(SWIG_ArgError(ecode13), "in method '" "batched_ctc_lm_decoder" "', argument " "13"" of type '" "size_t""'");
   } 
   arg13 = static_cast< size_t >(val13);
-  ecode14 = SWIG_AsVal_bool(obj9, &val14);
+  ecode14 = SWIG_AsVal_float(obj6, &val14);
   if (!SWIG_IsOK(ecode14)) {
-    SWIG_exception_fail(SWIG_ArgError(ecode14), "in method '" "batched_ctc_lm_decoder" "', argument " "14"" of type '" "bool""'");
+    SWIG_exception_fail(SWIG_ArgError(ecode14), "in method '" "batched_ctc_lm_decoder" "', argument " "14"" of type '" "float""'");
+  } 
+  arg14 = static_cast< float >(val14);
+  ecode15 = SWIG_AsVal_size_t(obj7, &val15);
+  if (!SWIG_IsOK(ecode15)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode15), "in method '" "batched_ctc_lm_decoder" "', argument " "15"" of type '" "size_t""'");
   } 
-  arg14 = static_cast< bool >(val14);
-  res15 = SWIG_ConvertPtr(obj10, &argp15,SWIGTYPE_p_ScorerBase, 0 |  0 );
-  if (!SWIG_IsOK(res15)) {
-    SWIG_exception_fail(SWIG_ArgError(res15), "in method '" "batched_ctc_lm_decoder" "', argument " "15"" of type '" "ScorerBase *""'"); 
+  arg15 = static_cast< size_t >(val15);
+  ecode16 = SWIG_AsVal_size_t(obj8, &val16);
+  if (!SWIG_IsOK(ecode16)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode16), "in method '" "batched_ctc_lm_decoder" "', argument " "16"" of type '" "size_t""'");
+  } 
+  arg16 = static_cast< size_t >(val16);
+  ecode17 = SWIG_AsVal_bool(obj9, &val17);
+  if (!SWIG_IsOK(ecode17)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode17), "in method '" "batched_ctc_lm_decoder" "', argument " "17"" of type '" "bool""'");
+  } 
+  arg17 = static_cast< bool >(val17);
+  res18 = SWIG_ConvertPtr(obj10, &argp18,SWIGTYPE_p_ScorerBase, 0 |  0 );
+  if (!SWIG_IsOK(res18)) {
+    SWIG_exception_fail(SWIG_ArgError(res18), "in method '" "batched_ctc_lm_decoder" "', argument " "18"" of type '" "ScorerBase *""'"); 
   }
-  arg15 = reinterpret_cast< ScorerBase * >(argp15);
+  arg18 = reinterpret_cast< ScorerBase * >(argp18);
   {
     try {
-      batched_ctc_lm_decoder((float const *)arg1,arg2,arg3,arg4,(int const *)arg5,arg6,arg7,arg8,arg9,arg10,arg11,arg12,arg13,arg14,arg15,arg16,arg17,arg18,arg19,arg20,arg21,arg22,arg23);
+      PyThreadState * thread_state = PyEval_SaveThread();
+      try {
+        batched_ctc_lm_decoder((float const *)arg1,arg2,arg3,arg4,arg5,arg6,arg7,(int const *)arg8,arg9,arg10,arg11,arg12,arg13,arg14,arg15,arg16,arg17,arg18,arg19,arg20,arg21,arg22,arg23,arg24,arg25,arg26);
+      } catch (...) {
+        PyEval_RestoreThread(thread_state);
+        throw;
+      }
+      PyEval_RestoreThread(thread_state);
     } catch (const std::exception& e) {
       SWIG_exception(SWIG_RuntimeError, e.what());
     }
@@ -13351,17 +13477,17 @@ SWIGINTERN PyObject *_wrap_batched_ctc_lm_decoder(PyObject *SWIGUNUSEDPARM(self)
   resultobj = SWIG_Py_Void();
   {
     npy_intp dims[1] = {
-      *arg17 
+      *arg20 
     };
-    PyObject* obj = PyArray_SimpleNewFromData(1, dims, NPY_INT, (void*)(*arg16));
+    PyObject* obj = PyArray_SimpleNewFromData(1, dims, NPY_INT, (void*)(*arg19));
     PyArrayObject* array = (PyArrayObject*) obj;
     
     if (!array) SWIG_fail;
     
 #ifdef SWIGPY_USE_CAPSULE
-    PyObject* cap = PyCapsule_New((void*)(*arg16), SWIGPY_CAPSULE_NAME, free_cap);
+    PyObject* cap = PyCapsule_New((void*)(*arg19), SWIGPY_CAPSULE_NAME, free_cap);
 #else
-    PyObject* cap = PyCObject_FromVoidPtr((void*)(*arg16), free);
+    PyObject* cap = PyCObject_FromVoidPtr((void*)(*arg19), free);
 #endif
     
 #if NPY_API_VERSION < 0x00000007
@@ -13374,17 +13500,17 @@ SWIGINTERN PyObject *_wrap_batched_ctc_lm_decoder(PyObject *SWIGUNUSEDPARM(self)
   }
   {
     npy_intp dims[1] = {
-      *arg19 
+      *arg22 
     };
-    PyObject* obj = PyArray_SimpleNewFromData(1, dims, NPY_INT, (void*)(*arg18));
+    PyObject* obj = PyArray_SimpleNewFromData(1, dims, NPY_INT, (void*)(*arg21));
     PyArrayObject* array = (PyArrayObject*) obj;
     
     if (!array) SWIG_fail;
     
 #ifdef SWIGPY_USE_CAPSULE
-    PyObject* cap = PyCapsule_New((void*)(*arg18), SWIGPY_CAPSULE_NAME, free_cap);
+    PyObject* cap = PyCapsule_New((void*)(*arg21), SWIGPY_CAPSULE_NAME, free_cap);
 #else
-    PyObject* cap = PyCObject_FromVoidPtr((void*)(*arg18), free);
+    PyObject* cap = PyCObject_FromVoidPtr((void*)(*arg21), free);
 #endif
     
 #if NPY_API_VERSION < 0x00000007
@@ -13397,17 +13523,17 @@ SWIGINTERN PyObject *_wrap_batched_ctc_lm_decoder(PyObject *SWIGUNUSEDPARM(self)
   }
   {
     npy_intp dims[1] = {
-      *arg21 
+      *arg24 
     };
-    PyObject* obj = PyArray_SimpleNewFromData(1, dims, NPY_FLOAT, (void*)(*arg20));
+    PyObject* obj = PyArray_SimpleNewFromData(1, dims, NPY_FLOAT, (void*)(*arg23));
     PyArrayObject* array = (PyArrayObject*) obj;
     
     if (!array) SWIG_fail;
     
 #ifdef SWIGPY_USE_CAPSULE
-    PyObject* cap = PyCapsule_New((void*)(*arg20), SWIGPY_CAPSULE_NAME, free_cap);
+    PyObject* cap = PyCapsule_New((void*)(*arg23), SWIGPY_CAPSULE_NAME, free_cap);
 #else
-    PyObject* cap = PyCObject_FromVoidPtr((void*)(*arg20), free);
+    PyObject* cap = PyCObject_FromVoidPtr((void*)(*arg23), free);
 #endif
     
 #if NPY_API_VERSION < 0x00000007
@@ -13420,17 +13546,17 @@ SWIGINTERN PyObject *_wrap_batched_ctc_lm_decoder(PyObject *SWIGUNUSEDPARM(self)
   }
   {
     npy_intp dims[1] = {
-      *arg23 
+      *arg26 
     };
-    PyObject* obj = PyArray_SimpleNewFromData(1, dims, NPY_INT, (void*)(*arg22));
+    PyObject* obj = PyArray_SimpleNewFromData(1, dims, NPY_INT, (void*)(*arg25));
     PyArrayObject* array = (PyArrayObject*) obj;
     
     if (!array) SWIG_fail;
     
 #ifdef SWIGPY_USE_CAPSULE
-    PyObject* cap = PyCapsule_New((void*)(*arg22), SWIGPY_CAPSULE_NAME, free_cap);
+    PyObject* cap = PyCapsule_New((void*)(*arg25), SWIGPY_CAPSULE_NAME, free_cap);
 #else
-    PyObject* cap = PyCObject_FromVoidPtr((void*)(*arg22), free);
+    PyObject* cap = PyCObject_FromVoidPtr((void*)(*arg25), free);
 #endif
     
 #if NPY_API_VERSION < 0x00000007
@@ -13442,29 +13568,23 @@ SWIGINTERN PyObject *_wrap_batched_ctc_lm_decoder(PyObject *SWIGUNUSEDPARM(self)
     resultobj = SWIG_Python_AppendOutput(resultobj,obj);
   }
   {
-    if (is_new_object1 && array1)
-    {
-      Py_DECREF(array1); 
-    }
+    Py_XDECREF(probs_array1);
   }
   {
-    if (is_new_object5 && array5)
+    if (is_new_object8 && array8)
     {
-      Py_DECREF(array5); 
+      Py_DECREF(array8); 
     }
   }
   return resultobj;
 fail:
   {
-    if (is_new_object1 && array1)
-    {
-      Py_DECREF(array1); 
-    }
+    Py_XDECREF(probs_array1);
   }
   {
-    if (is_new_object5 && array5)
+    if (is_new_object8 && array8)
     {
-      Py_DECREF(array5); 
+      Py_DECREF(array8); 
     }
   }
   return NULL;
@@ -13560,6 +13680,7 @@ static PyMethodDef SwigMethods[] = {
 	 { (char *)"new_CtcDecoderStateNumpy", _wrap_new_CtcDecoderStateNumpy, METH_VARARGS, NULL},
 	 { (char *)"CtcDecoderStateNumpy_append_numpy", _wrap_CtcDecoderStateNumpy_append_numpy, METH_VARARGS, NULL},
 	 { (char *)"CtcDecoderStateNumpy_decode_numpy", _wrap_CtcDecoderStateNumpy_decode_numpy, METH_VARARGS, NULL},
+	 { (char *)"CtcDecoderStateNumpy_take_committed_numpy", _wrap_CtcDecoderStateNumpy_take_committed_numpy, METH_VARARGS, NULL},
 	 { (char *)"delete_CtcDecoderStateNumpy", _wrap_delete_CtcDecoderStateNumpy, METH_VARARGS, NULL},
 	 { (char *)"CtcDecoderStateNumpy_swigregister", CtcDecoderStateNumpy_swigregister, METH_VARARGS, NULL},
 	 { (char *)"batched_ctc_lm_decoder", _wrap_batched_ctc_lm_decoder, METH_VARARGS, NULL},
@@ -424,6 +424,9 @@ class CtcDecoderStateNumpy(CtcDecoderState):
 
     def decode_numpy(self, limit_candidates, finalize):
         return _impl.CtcDecoderStateNumpy_decode_numpy(self, limit_candidates, finalize)
+
+    def take_committed_numpy(self):
+        return _impl.CtcDecoderStateNumpy_take_committed_numpy(self)
     __swig_destroy__ = _impl.delete_CtcDecoderStateNumpy
     __del__ = lambda self: None
 CtcDecoderStateNumpy_swigregister = _impl.CtcDecoderStateNumpy_swigregister
@@ -0,0 +1,75 @@
+/*********************************************************************
+* Copyright (c) 2021 Intel Corporation
+* SPDX-License-Identifier: Apache-2.0
+**********************************************************************/
+
+#include "lm_state_cache.h"
+
+#include <utility>
+
+void LmStateCache::reset(const ScorerBase * scorer) {
+  scorer_ = scorer;
+  states_.clear();
+  state_ids_.clear();
+  word_ids_.clear();
+  start_state_ = -1;
+  lookups_ = hits_ = 0;
+  if (scorer_ == nullptr)
+    return;
+
+  // ScorerBase::make_ngram() pads the n-grams of the first words with START_TOKEN's
+  start_state_ = add_state(LmContext(), 0);
+  for (size_t i = 0; i + 1 < scorer_->get_max_order(); ++i)
+    get_log_cond_prob(start_state_, START_TOKEN, start_state_);
+  lookups_ = hits_ = 0;  // not counting the above
+}
+
+double LmStateCache::get_log_cond_prob(int state, const std::string& word, int& next_state) {
+  ++lookups_;
+  LmWordId word_id = find_word(word);
+  auto cached = states_[state].next.find(word_id);
+  if (cached != states_[state].next.end()) {
+    ++hits_;
+    next_state = cached->second.second;
+    return cached->second.first;
+  }
+
+  LmContext context = states_[state].context;
+  double log_prob = scorer_->get_log_cond_prob(word_id, context);
+  size_t oov_words = states_[state].oov_words;
+  if (word_id == scorer_->unk_word()) {
+    log_prob = OOV_SCORE;
+    oov_words = scorer_->get_max_order() - 1;
+  } else if (oov_words > 0) {
+    log_prob = OOV_SCORE;
+    --oov_words;
+  }
+
+  next_state = add_state(std::move(context), oov_words);
+  // add_state() may reallocate states_
+  states_[state].next.emplace(word_id, std::make_pair(log_prob, next_state));
+  return log_prob;
+}
+
+LmWordId LmStateCache::find_word(const std::string& word) {
+  auto it = word_ids_.find(word);
+  if (it != word_ids_.end())
+    return it->second;
+  LmWordId word_id = scorer_->find_word(word);
+  word_ids_.emplace(word, word_id);
+  return word_id;
+}
+
+int LmStateCache::add_state(LmContext&& context, size_t oov_words) {
+  StateKey key(oov_words, context.words);
+  auto it = state_ids_.find(key);
+  if (it != state_ids_.end())
+    return it->second;
+
+  int id = int(states_.size());
+  states_.push_back(State());
+  states_.back().context = std::move(context);
+  states_.back().oov_words = oov_words;
+  state_ids_.emplace(std::move(key), id);
+  return id;
+}
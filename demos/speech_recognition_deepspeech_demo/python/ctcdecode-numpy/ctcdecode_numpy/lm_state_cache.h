@@ -0,0 +1,68 @@
+/*********************************************************************
+* Copyright (c) 2021 Intel Corporation
+* SPDX-License-Identifier: Apache-2.0
+**********************************************************************/
+
+#ifndef LM_STATE_CACHE_H_
+#define LM_STATE_CACHE_H_
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "scorer_base.h"
+
+/* Language model states of one decoder with memoized word transitions.
+ *
+ * A state is the LM context after a sequence of words; states with the same
+ * context are shared by all prefixes. Scoring a word from a state gives the
+ * same result as ScorerBase::get_log_cond_prob() for the n-gram made of the
+ * last words of the sequence, but it is a single lookup from the state, and
+ * repeated queries hit the per-state cache.
+ *
+ * The cache belongs to a decoder and is not thread-safe, while the scorer is
+ * only read and may be shared.
+ */
+class LmStateCache {
+public:
+  LmStateCache() : scorer_(nullptr), start_state_(-1), lookups_(0), hits_(0) {}
+
+  // drop all states and start caching for the scorer (nullptr for no scorer)
+  void reset(const ScorerBase * scorer);
+  size_t size() const { return states_.size(); }
+
+  // the state before the first word, i.e. after (max_order - 1) START_TOKEN's
+  int start_state() const { return start_state_; }
+
+  // log-probability of the word following the state; next_state is set to the state after the word
+  double get_log_cond_prob(int state, const std::string& word, int& next_state);
+
+  // statistics since the last reset(): the number of get_log_cond_prob() calls and
+  // how many of them were answered from the cache without querying the scorer
+  size_t lookups() const { return lookups_; }
+  size_t hits() const { return hits_; }
+
+private:
+  struct State {
+    LmContext context;
+    // the number of the next words whose n-grams contain an OOV word; they all get OOV_SCORE
+    size_t oov_words;
+    // word -> (log-probability, next state)
+    std::unordered_map<LmWordId, std::pair<double, int>> next;
+  };
+  typedef std::pair<size_t, std::vector<LmWordId>> StateKey;  // (oov_words, context.words)
+
+  LmWordId find_word(const std::string& word);
+  int add_state(LmContext&& context, size_t oov_words);
+
+  const ScorerBase * scorer_;
+  int start_state_;
+  std::vector<State> states_;
+  std::map<StateKey, int> state_ids_;
+  std::unordered_map<std::string, LmWordId> word_ids_;
+  size_t lookups_, hits_;
+};
+
+#endif  // LM_STATE_CACHE_H_
@@ -16,7 +16,99 @@
 
 #include "decoder_utils.h"
 
+namespace {
+bool child_less(const PathTrieChildren::Child& a, const PathTrieChildren::Child& b) {
+  return a.first < b.first;
+}
+}  // namespace
+
+PathTrie* PathTrieChildren::find(int character) const {
+  if (spilled_.empty()) {
+    for (size_t i = 0; i < inline_size_; ++i) {
+      if (inline_[i].first == character)
+        return inline_[i].second;
+    }
+    return nullptr;
+  }
+  auto it = std::lower_bound(spilled_.begin(), spilled_.end(), Child(character, nullptr), child_less);
+  return it != spilled_.end() && it->first == character ? it->second : nullptr;
+}
+
+void PathTrieChildren::insert(int character, PathTrie* node) {
+  if (spilled_.empty()) {
+    if (inline_size_ < kInlineSize) {
+      inline_[inline_size_++] = Child(character, node);
+      return;
+    }
+    spilled_.assign(inline_, inline_ + inline_size_);
+    std::sort(spilled_.begin(), spilled_.end(), child_less);
+    inline_size_ = 0;
+  }
+  auto it = std::lower_bound(spilled_.begin(), spilled_.end(), Child(character, nullptr), child_less);
+  spilled_.insert(it, Child(character, node));
+}
+
+void PathTrieChildren::erase(int character) {
+  if (spilled_.empty()) {
+    for (size_t i = 0; i < inline_size_; ++i) {
+      if (inline_[i].first == character) {
+        std::copy(inline_ + i + 1, inline_ + inline_size_, inline_ + i);
+        --inline_size_;
+        return;
+      }
+    }
+    return;
+  }
+  auto it = std::lower_bound(spilled_.begin(), spilled_.end(), Child(character, nullptr), child_less);
+  if (it != spilled_.end() && it->first == character)
+    spilled_.erase(it);
+}
+
+PathTrie* PathTrieArena::reset() {
+  slabs_used_ = 0;
+  slab_pos_ = kSlabSize;
+  free_list_.clear();
+  root_ = allocate();
+  return root_;
+}
+
+void PathTrieArena::reroot(PathTrie* node) {
+  // the other branches of the ancestors hold no existing prefixes, so they are already removed
+  PathTrie* ancestor = node->parent;
+  node->parent = nullptr;
+  while (ancestor != nullptr) {
+    PathTrie* next = ancestor->parent;
+    release(ancestor);
+    ancestor = next;
+  }
+  root_ = node;
+}
+
+PathTrie* PathTrieArena::allocate() {
+  PathTrie* node;
+  if (!free_list_.empty()) {
+    node = free_list_.back();
+    free_list_.pop_back();
+  } else {
+    if (slab_pos_ == kSlabSize) {
+      if (slabs_used_ == slabs_.size())
+        slabs_.emplace_back(new PathTrie[kSlabSize]);
+      ++slabs_used_;
+      slab_pos_ = 0;
+    }
+    node = &slabs_[slabs_used_ - 1][slab_pos_++];
+  }
+  node->clear();
+  node->arena_ = this;
+  return node;
+}
+
 PathTrie::PathTrie() {
+  arena_ = nullptr;
+  clear();
+}
+
+void PathTrie::clear() {
   log_prob_b_prev = -NUM_FLT_INF;
   log_prob_nb_prev = -NUM_FLT_INF;
   log_prob_b_cur = -NUM_FLT_INF;
@@ -30,38 +122,30 @@ PathTrie::PathTrie() {
   timestep = 0;
   exists_ = true;
   parent = nullptr;
+  lm_state = -1;
 
   dictionary_ = nullptr;
   has_dictionary_ = false;
   dictionary_state_ = {};
-}
 
-PathTrie::~PathTrie() {
-  for (auto child : children_) {
-    delete child.second;
-  }
+  children_.clear();
 }
 
 PathTrie* PathTrie::get_path_trie(int new_char, int new_timestep, float cur_log_prob_c, bool reset) {
-  auto child = children_.begin();
-  for (child = children_.begin(); child != children_.end(); ++child) {
-    if (child->first == new_char) {
-      if (child->second->log_prob_c < cur_log_prob_c) {
-	child->second->log_prob_c = cur_log_prob_c;
-	child->second->timestep = new_timestep;
-      }
-      break;
+  PathTrie* child = children_.find(new_char);
+  if (child != nullptr) {
+    if (child->log_prob_c < cur_log_prob_c) {
+      child->log_prob_c = cur_log_prob_c;
+      child->timestep = new_timestep;
     }
-  }
-  if (child != children_.end()) {
-    if (!child->second->exists_) {
-      child->second->exists_ = true;
-      child->second->log_prob_b_prev = -NUM_FLT_INF;
-      child->second->log_prob_nb_prev = -NUM_FLT_INF;
-      child->second->log_prob_b_cur = -NUM_FLT_INF;
-      child->second->log_prob_nb_cur = -NUM_FLT_INF;
+    if (!child->exists_) {
+      child->exists_ = true;
+      child->log_prob_b_prev = -NUM_FLT_INF;
+      child->log_prob_nb_prev = -NUM_FLT_INF;
+      child->log_prob_b_cur = -NUM_FLT_INF;
+      child->log_prob_nb_cur = -NUM_FLT_INF;
     }
-    return (child->second);
+    return child;
   } else {
     if (has_dictionary_) {
       WordPrefixSetState new_state = dictionary_state_;
@@ -74,35 +158,37 @@ PathTrie* PathTrie::get_path_trie(int new_char, int new_timestep, float cur_log_
         }
         return nullptr;
       } else {
-        PathTrie* new_path = new PathTrie;
+        PathTrie* new_path = arena_->allocate();
         new_path->character = new_char;
         new_path->timestep = new_timestep;
         new_path->parent = this;
+        new_path->lm_state = lm_state;
         new_path->dictionary_ = dictionary_;
         new_path->has_dictionary_ = true;
-	new_path->log_prob_c = cur_log_prob_c;
+        new_path->log_prob_c = cur_log_prob_c;
 
         // set spell checker state
         // check to see if next state is final
         bool is_final = new_state.weight;
         if (is_final && reset) {
-	  // restart spell checker at the start state
+          // restart spell checker at the start state
           new_path->dictionary_state_ = dictionary_->empty_state();
         } else {
-	  // go to next state
+          // go to next state
           new_path->dictionary_state_ = new_state;
         }
 
-        children_.push_back(std::make_pair(new_char, new_path));
+        children_.insert(new_char, new_path);
         return new_path;
       }
     } else {
-      PathTrie* new_path = new PathTrie;
+      PathTrie* new_path = arena_->allocate();
       new_path->character = new_char;
       new_path->timestep = new_timestep;
       new_path->parent = this;
+      new_path->lm_state = lm_state;
       new_path->log_prob_c = cur_log_prob_c;
-      children_.push_back(std::make_pair(new_char, new_path));
+      children_.insert(new_char, new_path);
       return new_path;
     }
   }
@@ -116,7 +202,7 @@ PathTrie* PathTrie::get_path_vec(std::vector<int>& output,
                                  std::vector<int>& timesteps,
                                  int stop,
                                  size_t max_steps) {
-  if (character == stop || character == ROOT_ || output.size() == max_steps) {
+  if (character == stop || parent == nullptr || output.size() == max_steps) {
     std::reverse(output.begin(), output.end());
     std::reverse(timesteps.begin(), timesteps.end());
     return this;
@@ -138,7 +224,7 @@ void PathTrie::iterate_to_vec(std::vector<PathTrie*>& output) {
     score = log_sum_exp(log_prob_b_prev, log_prob_nb_prev);
     output.push_back(this);
   }
-  for (auto child : children_) {
+  for (const auto& child : children_) {
     child.second->iterate_to_vec(output);
   }
 }
@@ -146,21 +232,14 @@ void PathTrie::iterate_to_vec(std::vector<PathTrie*>& output) {
 void PathTrie::remove() {
   exists_ = false;
 
-  if (children_.size() == 0) {
-    auto child = parent->children_.begin();
-    for (child = parent->children_.begin(); child != parent->children_.end();
-         ++child) {
-      if (child->first == character) {
-        parent->children_.erase(child);
-        break;
-      }
-    }
+  if (children_.empty()) {
+    parent->children_.erase(character);
 
-    if (parent->children_.size() == 0 && !parent->exists_) {
+    if (parent->children_.empty() && !parent->exists_) {
       parent->remove();
     }
 
-    delete this;
+    arena_->release(this);
   }
 }
 
@@ -17,18 +17,49 @@
 
 #include "word_prefix_set.h"
 
+class PathTrie;
+class PathTrieArena;
+
+/* Children of a PathTrie node keyed by character.
+ * The first kInlineSize children live inside the node in insertion order,
+ * more children spill to an array sorted by character.
+ */
+class PathTrieChildren {
+public:
+  typedef std::pair<int, PathTrie*> Child;
+
+  PathTrieChildren() : inline_size_(0) {}
+
+  PathTrie* find(int character) const;
+  void insert(int character, PathTrie* node);
+  void erase(int character);
+  void clear() { inline_size_ = 0; spilled_.clear(); }
+
+  size_t size() const { return spilled_.empty() ? inline_size_ : spilled_.size(); }
+  bool empty() const { return size() == 0; }
+  const Child* begin() const { return spilled_.empty() ? inline_ : spilled_.data(); }
+  const Child* end() const { return begin() + size(); }
+
+private:
+  static const size_t kInlineSize = 4;
+
+  Child inline_[kInlineSize];
+  size_t inline_size_;
+  std::vector<Child> spilled_;  // sorted by character; keeps its capacity when the node is recycled
+};
+
 /* Trie tree for prefix storing and manipulating, with a dictionary in
  * finite-state transducer for spelling correction.
  */
 class PathTrie {
 public:
+  // nodes are created by PathTrieArena
   PathTrie();
-  ~PathTrie();
 
   // get new prefix after appending new char
   PathTrie* get_path_trie(int new_char, int new_timestep, float log_prob_c, bool reset = true);
 
-  // get the prefix in index from root to current node
+  // get the prefix in index from root to current node (the root's own character is not included)
   PathTrie* get_path_vec(std::vector<int>& output, std::vector<int>& timesteps);
 
   // get the prefix in index from some stop node to current node
@@ -43,7 +74,8 @@ public:
   // set word prefix dictionary
   void set_dictionary(WordPrefixSet* dictionary);
 
-  bool is_empty() { return ROOT_ == character; }
+  // the root may keep the character of a committed prefix, see PathTrieArena::reroot()
+  bool is_empty() { return parent == nullptr; }
 
   // remove current path from root
   void remove();
@@ -58,17 +90,55 @@ public:
   int character;
   int timestep;
   PathTrie* parent;
+  int lm_state;  // LmStateCache state after the last scored word, inherited by the children
 
 private:
+  friend class PathTrieArena;
+
+  // restore the state of a freshly constructed node
+  void clear();
+
   int ROOT_;
   bool exists_;
   bool has_dictionary_;
+  PathTrieArena* arena_;  // owner of this node and of all its descendants
 
-  std::vector<std::pair<int, PathTrie*>> children_;
+  PathTrieChildren children_;
 
   // pointer to word prefix dictionary
   WordPrefixSet* dictionary_;
   WordPrefixSetState dictionary_state_;
 };
 
+/* Slab allocator owning all nodes of a PathTrie tree.
+ * Nodes removed from the tree are recycled through a free list, reset() frees all
+ * nodes at once while keeping the slabs for the next sequence.
+ */
+class PathTrieArena {
+public:
+  PathTrieArena() : root_(nullptr), slabs_used_(0), slab_pos_(kSlabSize) {}
+  PathTrieArena(const PathTrieArena&) = delete;
+  PathTrieArena& operator=(const PathTrieArena&) = delete;
+
+  // free all nodes and start a new tree, returns its root
+  PathTrie* reset();
+  PathTrie* root() { return root_; }
+  // make the node the root of the tree, freeing its ancestors; all nodes in use must descend from it
+  void reroot(PathTrie* node);
+
+private:
+  friend class PathTrie;
+
+  PathTrie* allocate();
+  void release(PathTrie* node) { free_list_.push_back(node); }
+
+  static const size_t kSlabSize = 1024;
+
+  PathTrie* root_;
+  std::vector<std::unique_ptr<PathTrie[]>> slabs_;
+  size_t slabs_used_;  // slabs_[slabs_used_ - 1] is the one being allocated from
+  size_t slab_pos_;  // next unused node in it
+  std::vector<PathTrie*> free_list_;
+};
+
 #endif  // PATH_TRIE_H
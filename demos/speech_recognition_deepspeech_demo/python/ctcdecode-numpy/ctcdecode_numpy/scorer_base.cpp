@@ -12,6 +12,9 @@
 
 #include "decoder_utils.h"
 
+// The word prefix dictionary is cached next to the language model file
+static const char DICTIONARY_CACHE_SUFFIX[] = ".prefixes";
+
 ScorerBase::ScorerBase(double alpha,
                        double beta)
       : alpha(alpha), beta(beta), dictionary(nullptr),
@@ -32,7 +35,7 @@ void ScorerBase::setup(const std::string& lm_path,
   set_char_map(vocab_list);
   // fill word prefix dictionary
   if (!is_character_based()) {
-    fill_dictionary(true);
+    fill_dictionary(true, lm_path.empty() ? "" : lm_path + DICTIONARY_CACHE_SUFFIX);
   }
 }
 
@@ -126,7 +129,7 @@ std::vector<std::string> ScorerBase::make_ngram(PathTrie* prefix) {
     std::string word = vec2str(prefix_vec);
     ngram.push_back(word);
 
-    if (new_node->character == -1) {
+    if (new_node->parent == nullptr) {
       // No more spaces, but still need order
       for (size_t i = 0; i < max_order_ - order - 1; i++) {
         ngram.push_back(START_TOKEN);
@@ -138,7 +141,18 @@ std::vector<std::string> ScorerBase::make_ngram(PathTrie* prefix) {
   return ngram;
 }
 
-void ScorerBase::fill_dictionary(bool add_space) {
+std::string ScorerBase::make_word(PathTrie* prefix) {
+  std::vector<int> prefix_vec;
+  std::vector<int> prefix_steps;
+  if (is_character_based_) {
+    prefix->get_path_vec(prefix_vec, prefix_steps, -1, 1);
+  } else {
+    prefix->get_path_vec(prefix_vec, prefix_steps, space_id_);
+  }
+  return vec2str(prefix_vec);
+}
+
+void ScorerBase::fill_dictionary(bool add_space, const std::string& cache_path) {
   // For each unigram convert to ints and store
   std::vector<std::vector<int> > int_vocabulary;
   for (const auto& word : vocabulary_) {
@@ -147,5 +161,14 @@ void ScorerBase::fill_dictionary(bool add_space) {
 
   // Add the converted vocabulary to WordPrefixSet
   this->dictionary.reset(new WordPrefixSet);
+  uint64_t key = WordPrefixSet::words_key(int_vocabulary);
+  if (!cache_path.empty() && this->dictionary->load(cache_path, key)) {
+    dict_size_ = this->dictionary->num_words();
+    return;
+  }
   dict_size_ = this->dictionary->add_words(int_vocabulary);
+  if (!cache_path.empty()) {
+    // The cache is an optimization only: a read-only model directory is not an error
+    this->dictionary->save(cache_path, key);
+  }
 }
@@ -9,6 +9,7 @@
 #ifndef SCORER_BASE_H_
 #define SCORER_BASE_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -22,6 +23,15 @@ const std::string START_TOKEN = "<s>";
 const std::string UNK_TOKEN = "<unk>";
 const std::string END_TOKEN = "</s>";
 
+// Index of a word in the language model vocabulary
+typedef uint64_t LmWordId;
+
+// Language model context: the last words of a prefix with the data the model needs to continue it
+struct LmContext {
+  std::vector<LmWordId> words;  // up to (max_order - 1) last words in reverse order
+  std::vector<float> backoffs;  // model specific
+};
+
 /* External scorer to query score for n-gram or sentence, including language
  * model scoring and word insertion score.
  *
@@ -39,6 +49,13 @@ public:
 
   virtual double get_log_cond_prob(const std::vector<std::string> &words) = 0;
 
+  // Incremental scoring, see LmStateCache.
+  // Return the index of the word, or unk_word() if it is out of vocabulary
+  virtual LmWordId find_word(const std::string &word) const = 0;
+  virtual LmWordId unk_word() const = 0;
+  // Return the log-probability of the word following the context and append the word to the context
+  virtual double get_log_cond_prob(LmWordId word, LmContext &context) const = 0;
+
   double get_sent_log_prob(const std::vector<std::string> &words);
 
   // return the max order
@@ -56,6 +73,9 @@ public:
   // make ngram for a given prefix
   std::vector<std::string> make_ngram(PathTrie *prefix);
 
+  // return the last word (word based lm) or character (character based lm) of a given prefix
+  std::string make_word(PathTrie *prefix);
+
   // transform the labels in index to the vector of words (word based lm) or
   // the vector of characters (character based lm)
   std::vector<std::string> split_labels(const std::vector<int> &labels);
@@ -80,8 +100,10 @@ protected:
   //  * setting vocabulary_
   virtual void load_lm(const std::string &lm_path) = 0;
 
-  // fill word prefix dictionary
-  void fill_dictionary(bool add_space);
+  // fill word prefix dictionary.
+  // If cache_path is not empty, the dictionary is loaded from there when the file
+  // was built from the same vocabulary and alphabet, and is saved there otherwise.
+  void fill_dictionary(bool add_space, const std::string &cache_path = "");
 
   // set char map
   void set_char_map(const std::vector<std::string> &char_list);
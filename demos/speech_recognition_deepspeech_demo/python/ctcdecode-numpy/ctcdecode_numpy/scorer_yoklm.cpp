@@ -61,3 +61,22 @@ double ScorerYoklm::get_log_cond_prob(const std::vector<std::string>& words) {
   // return log_e(prob)
   return cond_prob * (1./NUM_FLT_LOGE);
 }
+
+LmWordId ScorerYoklm::find_word(const std::string& word) const {
+  return lm_vocabulary_->find(word);
+}
+
+LmWordId ScorerYoklm::unk_word() const {
+  return lm_vocabulary_->unk();
+}
+
+double ScorerYoklm::get_log_cond_prob(LmWordId word, LmContext& context) const {
+  yoklm::LmState state;
+  state.context_words = std::move(context.words);
+  state.backoffs = std::move(context.backoffs);
+  float cond_prob = language_model_->log10_p_cond(word, state);
+  context.words = std::move(state.context_words);
+  context.backoffs = std::move(state.backoffs);
+  // return log_e(prob)
+  return cond_prob * (1./NUM_FLT_LOGE);
+}
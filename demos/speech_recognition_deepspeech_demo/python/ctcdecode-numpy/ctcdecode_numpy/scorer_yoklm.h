@@ -39,6 +39,10 @@ public:
 
   virtual double get_log_cond_prob(const std::vector<std::string> &words);
 
+  virtual LmWordId find_word(const std::string &word) const;
+  virtual LmWordId unk_word() const;
+  virtual double get_log_cond_prob(LmWordId word, LmContext &context) const;
+
 protected:
   // Load language model from given path
   // This method is responsible for:
@@ -1,12 +1,17 @@
 /*********************************************************************
-* Copyright (c) 2020 Intel Corporation
+* Copyright (c) 2020-2021 Intel Corporation
 * SPDX-License-Identifier: Apache-2.0
 **********************************************************************/
 
 #include "word_prefix_set.h"
 
 #include <vector>
+#include <deque>
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
 
 typedef std::vector<int> IntWord;
 
@@ -18,12 +23,41 @@ bool int_word_equal(const IntWord* a, const IntWord* b) {
   return *a == *b;
 }
 
+namespace {
+
+// Trie node waiting for its children to be placed: the node is the common
+// prefix of length "depth" of the sorted words [begin, end).
+struct PendingNode {
+  int32_t node;
+  size_t begin, end;
+  size_t depth;
+};
+
+const char SERIALIZATION_MAGIC[8] = {'W', 'P', 'S', 'D', 'A', 'T', '0', '1'};
+
+template <typename T>
+void put(std::vector<char>& buffer, T value) {
+  const char* bytes = reinterpret_cast<const char*>(&value);
+  buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+bool get(std::istream& stream, T& value) {
+  return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+}  // namespace
+
 size_t WordPrefixSet::add_words(const std::vector<std::vector<int> >& words) {
   // Copy pointers to words
   std::vector<const IntWord*> word_ptrs;
   word_ptrs.reserve(words.size());
-  for (const auto& word : words)
+  for (const auto& word : words) {
+    for (int character : word)
+      if (character <= 0)
+        throw std::invalid_argument("WordPrefixSet: characters must be positive");
     word_ptrs.push_back(&word);
+  }
 
   // Sort pointers to word lexicographically
   std::sort(word_ptrs.begin(), word_ptrs.end(), lex_less);
@@ -32,72 +66,153 @@ size_t WordPrefixSet::add_words(const std::vector<std::vector<int> >& words) {
   auto last_it = std::unique(word_ptrs.begin(), word_ptrs.end(), int_word_equal);
   word_ptrs.erase(last_it, word_ptrs.end());
 
-  trie_chars_.clear();
-  trie_starts_.clear();
-  trie_weights_.clear();
-
-  // Go through the sorted list, and update children lists at every layer of trie.
-  // The new child may only be the last child in each list.
-  for (auto word : word_ptrs) {
-    size_t char_index;
-    // Skip the prefixes of the new word that are already present in the trie
-    for (char_index = 0; char_index < word->size() && char_index < trie_chars_.size(); char_index++) {
-      if (trie_chars_[char_index].back() != (*word)[char_index])
-        break;
-      // For our particular arc weight (char_index + 1 == word->size()), the following
-      // line would never change trie_weights_, since we process words in lexicographic order.
-      // To use this algo with other arc weights, the following line needs to be uncommented:
-      //trie_weights_[char_index].back() |= (char_index + 1 == word->size());
-    }
-    // Add the new prefixes
-    for (; char_index < word->size() && char_index + 1 < trie_chars_.size(); char_index++) {
-      trie_chars_[char_index].push_back((*word)[char_index]);
-      trie_starts_[char_index].push_back(trie_chars_[char_index + 1].size());
-      trie_weights_[char_index].push_back(char_index + 1 == word->size());
+  units_.assign(1, Unit{0, -1, false});
+  units_[0].check = 0;  // the root is never free
+  // All units below first_free are taken
+  size_t first_free = 1;
+
+  // Place the trie breadth first.  The children of every node are the distinct
+  // characters at position "depth" of its range of sorted words, so they come
+  // already grouped and in increasing order.
+  std::deque<PendingNode> pending;
+  pending.push_back(PendingNode{0, 0, word_ptrs.size(), 0});
+  std::vector<int> labels;
+  std::vector<size_t> bounds;
+  while (!pending.empty()) {
+    PendingNode parent = pending.front();
+    pending.pop_front();
+
+    labels.clear();
+    bounds.clear();
+    for (size_t i = parent.begin; i < parent.end; i++) {
+      const IntWord& word = *word_ptrs[i];
+      // The shorter words come first in the range, they end in this node
+      if (word.size() <= parent.depth)
+        continue;
+      if (labels.empty() || labels.back() != word[parent.depth]) {
+        labels.push_back(word[parent.depth]);
+        bounds.push_back(i);
+      }
     }
-    for (; char_index < word->size() && char_index + 1 == trie_chars_.size(); char_index++) {
-      trie_chars_[char_index].push_back((*word)[char_index]);
-      trie_starts_[char_index].push_back(0);
-      trie_weights_[char_index].push_back(char_index + 1 == word->size());
+    if (labels.empty())
+      continue;
+    bounds.push_back(parent.end);
+
+    // First fit: the lowest base at which all the children units are free
+    while (first_free < units_.size() && units_[first_free].check >= 0)
+      first_free++;
+    size_t position = std::max(first_free, static_cast<size_t>(labels.front()));
+    int64_t base;
+    for (;; position++) {
+      if (position < units_.size() && units_[position].check >= 0)
+        continue;
+      base = static_cast<int64_t>(position) - labels.front();
+      bool fits = true;
+      for (size_t j = 1; j < labels.size() && fits; j++) {
+        size_t unit = base + labels[j];
+        fits = unit >= units_.size() || units_[unit].check < 0;
+      }
+      if (fits)
+        break;
     }
-    for (; char_index < word->size(); char_index++) {
-      trie_chars_.emplace_back(1, (*word)[char_index]);
-      trie_starts_.emplace_back(1, 0);
-      trie_weights_.emplace_back(1, char_index + 1 == word->size());
+    if (base + labels.back() >= INT32_MAX)
+      throw std::length_error("WordPrefixSet: vocabulary is too large");
+    if (static_cast<size_t>(base + labels.back()) >= units_.size())
+      units_.resize(base + labels.back() + 1, Unit{0, -1, false});
+
+    units_[parent.node].base = static_cast<int32_t>(base);
+    for (size_t j = 0; j < labels.size(); j++) {
+      int32_t child = static_cast<int32_t>(base + labels[j]);
+      units_[child].check = parent.node;
+      // Words are sorted, so the one ending at the child comes first in its range
+      units_[child].final = word_ptrs[bounds[j]]->size() == parent.depth + 1;
+      pending.push_back(PendingNode{child, bounds[j], bounds[j + 1], parent.depth + 1});
     }
   }
+  units_.shrink_to_fit();
 
-  // Finalize trie_starts_ by appending the size of the next layer
-  size_t prefix_length;
-  for (prefix_length = 0; prefix_length + 1 < trie_chars_.size(); prefix_length++)
-    trie_starts_[prefix_length].push_back(trie_chars_[prefix_length + 1].size());
-  for (; prefix_length < trie_starts_.size(); prefix_length++)
-    trie_starts_[prefix_length].push_back(0);
-
-  return word_ptrs.size();
+  num_words_ = word_ptrs.size();
+  return num_words_;
 }
 
 WordPrefixSetState WordPrefixSet::empty_state() {
   WordPrefixSetState empty;
-  empty.length = 0;
-  empty.start = 0;
-  empty.end = (trie_chars_.size() != 0) ? trie_chars_[0].size() : 0;
+  empty.node = 0;
   empty.weight = false;
   return empty;
 }
 
-bool WordPrefixSet::append_character(int character, WordPrefixSetState& state) {
-  for (size_t next_index = state.start; next_index < state.end; next_index++)
-    if (trie_chars_[state.length][next_index] == character) {
-      state.start = trie_starts_[state.length][next_index];
-      state.end = trie_starts_[state.length][next_index + 1];
-      state.weight |= trie_weights_[state.length][next_index];
-      state.length++;
-      return true;
+uint64_t WordPrefixSet::words_key(const std::vector<std::vector<int> >& words) {
+  // FNV-1a over the words and their lengths
+  uint64_t hash = 14695981039346656037ULL;
+  auto mix = [&hash](uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+      hash ^= (value >> (8 * i)) & 0xff;
+      hash *= 1099511628211ULL;
     }
-  state.length = 0;
-  state.start = 0;
-  state.end = (trie_chars_.size() != 0) ? trie_chars_[0].size() : 0;
-  state.weight = false;
-  return false;
+  };
+  mix(words.size());
+  for (const auto& word : words) {
+    mix(word.size());
+    for (int character : word)
+      mix(static_cast<uint32_t>(character));
+  }
+  return hash;
+}
+
+// File layout (native byte order):
+//   magic[8], key u64, num_words u64, num_units u64,
+//   then num_units records of (base i32, check i32, final u8).
+bool WordPrefixSet::save(const std::string& filename, uint64_t key) const {
+  std::vector<char> buffer(SERIALIZATION_MAGIC, SERIALIZATION_MAGIC + sizeof(SERIALIZATION_MAGIC));
+  buffer.reserve(buffer.size() + 3 * sizeof(uint64_t) + units_.size() * 9);
+  put<uint64_t>(buffer, key);
+  put<uint64_t>(buffer, num_words_);
+  put<uint64_t>(buffer, units_.size());
+  for (const auto& unit : units_) {
+    put<int32_t>(buffer, unit.base);
+    put<int32_t>(buffer, unit.check);
+    put<uint8_t>(buffer, unit.final);
+  }
+
+  // Write to a temporary file and rename it, so that a concurrent reader
+  // never sees a partially written trie
+  const std::string tmp_filename = filename + ".tmp";
+  {
+    std::ofstream stream(tmp_filename, std::ios::binary | std::ios::trunc);
+    if (!stream || !stream.write(buffer.data(), buffer.size()))
+      return false;
+  }
+  if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+    std::remove(tmp_filename.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool WordPrefixSet::load(const std::string& filename, uint64_t key) {
+  std::ifstream stream(filename, std::ios::binary);
+  if (!stream)
+    return false;
+
+  char magic[sizeof(SERIALIZATION_MAGIC)];
+  uint64_t file_key, num_words, num_units;
+  if (!stream.read(magic, sizeof(magic)) ||
+      std::memcmp(magic, SERIALIZATION_MAGIC, sizeof(magic)) != 0 ||
+      !get(stream, file_key) || file_key != key ||
+      !get(stream, num_words) || !get(stream, num_units) ||
+      num_units == 0 || num_units > static_cast<uint64_t>(INT32_MAX))
+    return false;
+
+  std::vector<Unit> units(num_units);
+  for (auto& unit : units) {
+    uint8_t final;
+    if (!get(stream, unit.base) || !get(stream, unit.check) || !get(stream, final))
+      return false;
+    unit.final = final != 0;
+  }
+
+  units_.swap(units);
+  num_words_ = num_words;
+  return true;
 }
@@ -1,26 +1,29 @@
 /*********************************************************************
-* Copyright (c) 2020 Intel Corporation
+* Copyright (c) 2020-2021 Intel Corporation
 * SPDX-License-Identifier: Apache-2.0
 **********************************************************************/
 
 // This data structure stores the set of all prefixes of vocabulary words,
 // and supports quick checking of inclusion after appending a character
 // to a prefix.
+//
+// The prefixes are kept in a double-array trie: a trie node is an index into
+// one flat array of units, and the child of node s on character c is the unit
+// t = units_[s].base + c, valid only if units_[t].check == s.  So a transition
+// costs two array reads whatever the branching factor is.
 
 #ifndef WORD_PREFIX_SET_H
 #define WORD_PREFIX_SET_H
 
+#include <string>
 #include <vector>
 #include <cstdint>
 // cstddef is required to get size_t definition on GCC 6
 #include <cstddef>
 
 struct WordPrefixSetState {
-  // Length of the current prefix
-  size_t length;
-  // Starting and ending indices in the arrays for the next trie layer, that is in trie_*[length] if it exists
-  // When trie_*[length] do not exist, we have start==end==0.
-  size_t start, end;
+  // Index of the trie node of the current prefix, 0 is the root (empty prefix)
+  int32_t node;
   // Weight of the current prefix defines as the logical OR of the weights of all its trie arcs.
   // "weight" must be public.
   bool weight;
@@ -33,9 +36,13 @@ public:
   WordPrefixSet& operator=(const WordPrefixSet&) = default;
 
   // Fill (replace) prefix set with all prefixes of the provided words.
+  // Characters must be positive.
   // Return the number of unique full words.
   size_t add_words(const std::vector<std::vector<int> >& words);
 
+  // Number of unique full words
+  size_t num_words() const { return num_words_; }
+
   // Get a new state corresponding to an empty string
   WordPrefixSetState empty_state();
 
@@ -44,19 +51,44 @@ public:
   // and reset to an empty state.
   // Return true if the new prefix exists (that is, it is a prefix of a word in
   // the vocabulary).
-  bool append_character(int character, WordPrefixSetState& state);
+  bool append_character(int character, WordPrefixSetState& state) {
+    if (character > 0 && state.node < static_cast<int32_t>(units_.size())) {
+      int64_t next = static_cast<int64_t>(units_[state.node].base) + character;
+      if (next < static_cast<int64_t>(units_.size()) && units_[next].check == state.node) {
+        state.node = static_cast<int32_t>(next);
+        state.weight |= units_[next].final;
+        return true;
+      }
+    }
+    state = empty_state();
+    return false;
+  }
+
+  // Hash of a word list to tag serialized prefix sets with, so that a stale
+  // file is not loaded after the vocabulary or the alphabet has changed.
+  static uint64_t words_key(const std::vector<std::vector<int> >& words);
+
+  // Write the trie to a file.  Return false on I/O error.
+  bool save(const std::string& filename, uint64_t key) const;
+
+  // Replace the trie with the one from a file written by save() with the same key.
+  // Return false and leave the set unchanged if the file is missing, malformed
+  // or has a different key.
+  bool load(const std::string& filename, uint64_t key);
 
 private:
-  // Each trie node is a triple (len, start, end), that is accessible from the root (0,0,len(trie_chars_[0])).
-  // Node's children arc labels are trie_chars_[len][index] for index in [begin, end).
-  // If trie_chars_[len] exists, then it has at least one element.
-  std::vector<std::vector<int>> trie_chars_;
-  // Node's children nodes ranges (begin,end) = (trie_starts_[len][index], trie_starts_[len][index+1]).
-  // trie_starts_[len] is always one element longer than trie_chars_[len].
-  std::vector<std::vector<size_t>> trie_starts_;
-  // Weights of the children arcs. Weight of the prefix is logical OR of its arcs.
-  // It is ad-hoc initialized to true for the final arcs in the words.
-  std::vector<std::vector<bool>> trie_weights_;
+  struct Unit {
+    // Children of this node are at base + character
+    int32_t base;
+    // Parent node of this unit, -1 if the unit is free
+    int32_t check;
+    // Weight of the arc leading to this node.
+    // It is ad-hoc initialized to true for the final arcs in the words.
+    bool final;
+  };
+
+  std::vector<Unit> units_;
+  size_t num_words_ = 0;
 };
 
 #endif  // WORD_PREFIX_SET_H
@@ -60,8 +60,8 @@ KenlmV5Loader::KenlmV5Loader() : lm_config_(), vocabulary_config_(),
     throw std::logic_error("yoklm requires little-endian byte order.");
 }
 
-void KenlmV5Loader::parse(const std::string& filename) {
-  parse(load_file(filename));
+void KenlmV5Loader::parse(const std::string& filename, const LoadFileOptions& options) {
+  parse(load_file(filename, options));
 }
 
 void KenlmV5Loader::parse(MemorySection mem) {
@@ -27,7 +27,7 @@ class KenlmV5Loader {
     ~KenlmV5Loader() = default;  // ensure non-POD class for POD fields initialization
 
     // Throw in case of invalid format / cannot read file
-    void parse(const std::string& filename);
+    void parse(const std::string& filename, const LoadFileOptions& options = LoadFileOptions());
     // Check format by checking magic number
     bool is_our_format(const MemorySection& mem);
     // Throw in case of invalid format
@@ -12,6 +12,25 @@
 
 namespace yoklm {
 
+// Layers with fewer bhiksha_highs fit in cache, so plain binary search is as fast
+static const size_t MIN_INDEXED_BHIKSHA_HIGHS = 4096;
+// One 64-byte cache line of uint64_t per index leaf
+static const size_t BHIKSHA_INDEX_STRIDE = 8;
+
+void LanguageModel::load(LmConfig config, bool build_search_index) {
+  config_ = config;
+  bhiksha_indices_.clear();
+  bhiksha_indices_.resize(config_.medium_layers.size());
+  if (!build_search_index)
+    return;
+  for (size_t i = 0; i < config_.medium_layers.size(); i++) {
+    const MediumLayer& layer = config_.medium_layers[i];
+    // The leaves layer (the last one) has no bhiksha_highs
+    if (i + 1 < config_.medium_layers.size() && layer.bhiksha_highs_count >= MIN_INDEXED_BHIKSHA_HIGHS)
+      bhiksha_indices_[i].build(layer.bhiksha_highs, layer.bhiksha_highs_count, BHIKSHA_INDEX_STRIDE);
+  }
+}
+
 float LanguageModel::log10_p_cond(WordIndex new_word, LmState& state) const {
   LmState new_state(config_.order);
   std::vector<WordIndex>& words = new_state.context_words;  // a shorthand
@@ -34,6 +53,33 @@ float LanguageModel::log10_p_cond(WordIndex new_word, LmState& state) const {
   return log10_p;
 }
 
+void LanguageModel::log10_p_cond_batch(const WordIndex* new_words, LmState* states, float* log10_p, size_t count) const {
+  // A query is a chain of dependent reads: unigram node, then its subtrie in the 2-gram layer, etc.
+  // Issue the first two reads of all queries before doing any, so their cache misses overlap.
+  for (size_t i = 0; i < count; i++)
+    YOKLM_PREFETCH(&config_.unigram_layer[new_words[i]]);
+  if (config_.order >= 2) {
+    const MediumLayer& layer = config_.medium_layers[0];
+    const double num_words = (double)config_.ngram_counts[0];
+    for (size_t i = 0; i < count; i++) {
+      if (states[i].context_words.empty())
+        continue;
+      const uint64_t l = config_.unigram_layer[new_words[i]].start_index;
+      const uint64_t r = config_.unigram_layer[new_words[i] + 1].start_index;
+      if (l >= r)
+        continue;
+      // The first probe of secant_search() for the previous word; word indices are roughly uniform
+      uint64_t m = l + (uint64_t)((r - l) * (states[i].context_words[0] / num_words));
+      if (m >= r)
+        m = r - 1;
+      YOKLM_PREFETCH(layer.bit_array.record_ptr(m));
+    }
+  }
+
+  for (size_t i = 0; i < count; i++)
+    log10_p[i] = log10_p_cond(new_words[i], states[i]);
+}
+
 //   Preconditions:
 // bhiksha_highs is non-decreasing array, bhiksha_highs[0] = 0
 // bhiksha_highs_count > 0 is the number of elements in bhiksha_highs
@@ -43,15 +89,22 @@ float LanguageModel::log10_p_cond(WordIndex new_word, LmState& state) const {
 // pair (l,r), where
 //   l is the highest index sush that bhiksha_highs[l] <= index
 //   r is the highest index sush that bhiksha_highs[r] <= index + 1
+// bhiksha_index is an EytzingerIndex over bhiksha_highs, or an empty one
 std::pair<uint64_t, uint64_t> bhiksha_lookup(
     const MemorySectionArray<uint64_t>& bhiksha_highs,
     size_t bhiksha_highs_count,
+    const EytzingerIndex<uint64_t>& bhiksha_index,
     uint64_t index)
 {
+  // kenlm files have bhiksha_highs[0] = 0
+  std::pair<size_t, size_t> search_range(0, bhiksha_highs_count);
+  if (!bhiksha_index.empty())
+    search_range = bhiksha_index.range(index);
+
   // Find l = the last index with bhiksha_highs[l] <= index
   const uint64_t l = binary_search<MemorySectionArray<uint64_t>, uint64_t, uint64_t>(
     bhiksha_highs,
-    0, bhiksha_highs_count,  // kenlm files have bhiksha_highs[0] = 0
+    search_range.first, search_range.second,
     index
   );
 
@@ -109,7 +162,7 @@ float LanguageModel::find_ngram(LmState& words_backoffs) const {
     const uint64_t next_l_low = layer.bit_array(index, layer.bhiksha_low_field);
     const uint64_t next_r_low = layer.bit_array(index + 1, layer.bhiksha_low_field);
     const std::pair<uint64_t, uint64_t> next_high_lr =
-      bhiksha_lookup(layer.bhiksha_highs, layer.bhiksha_highs_count, index);
+      bhiksha_lookup(layer.bhiksha_highs, layer.bhiksha_highs_count, bhiksha_indices_[k-2], index);
     l = (next_high_lr.first << layer.bhiksha_low_bits) + next_l_low;
     r = (next_high_lr.second << layer.bhiksha_low_bits) + next_r_low;
 
@@ -12,6 +12,7 @@
 
 #include "word_index.hpp"
 #include "memory_section.hpp"
+#include "sorted_search.hpp"
 
 
 namespace yoklm {
@@ -64,15 +65,24 @@ struct LmState {
 class LanguageModel {
   public:
     LanguageModel() : config_() {}
-    void load(LmConfig config) { config_ = config; }
+    // With build_search_index, build small in-memory indices over the large sorted arrays of
+    // the LM that speed up the lookups (at the cost of ~1/8 of the size of those arrays)
+    void load(LmConfig config, bool build_search_index = true);
 
     float log10_p_cond(WordIndex new_word, LmState& state) const;
 
+    // Same as log10_p_cond() for count independent queries: log10_p[i] for new_words[i] and states[i].
+    // The memory accesses of the queries are overlapped by prefetching, so this is faster than
+    // calling log10_p_cond() in a loop.
+    void log10_p_cond_batch(const WordIndex* new_words, LmState* states, float* log10_p, size_t count) const;
+
     size_t order() const { return config_.order; }
     uint64_t num_words() const { return config_.ngram_counts[0]; }
 
   private:
     LmConfig config_;
+    // bhiksha_indices_[k-2] for medium_layers[k-2], empty if the layer is too small to benefit
+    std::vector<EytzingerIndex<uint64_t> > bhiksha_indices_;
 
     // Accepts n-gram in state.words (as const, reverse order: the last word in state.words[0])
     // Returns:
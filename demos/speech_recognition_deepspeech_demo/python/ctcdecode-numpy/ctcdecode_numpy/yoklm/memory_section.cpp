@@ -8,6 +8,14 @@
 #include <fstream>
 #include <stdexcept>
 
+#if defined(__unix__) || defined(__APPLE__)
+#define YOKLM_HAVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "memory_section.hpp"
 
 
@@ -118,7 +126,64 @@ void MemorySectionBitArray::set_stride(int stride) {
     index_limit_ = 0;
 }
 
-MemorySection load_file(const std::string& filename) {
+#ifdef YOKLM_HAVE_MMAP
+namespace {
+
+// Read-only private mapping of a whole file
+class MappedMemory : public ManagedMemory {
+  public:
+    MappedMemory(void * ptr, size_t size) : ptr_(static_cast<uint8_t *>(ptr)), size_(size) {}
+    virtual ~MappedMemory() { munmap(ptr_, size_); }
+
+    virtual uint8_t * ptr() const { return ptr_; }
+    virtual size_t size() const { return size_; }
+
+  private:
+    uint8_t * ptr_;
+    size_t size_;
+}; // class MappedMemory
+
+// Return nullptr if the file cannot be mapped, the caller falls back to reading it then
+std::shared_ptr<ManagedMemory> map_file(const std::string& filename, const LoadFileOptions& options) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::runtime_error("Cannot open file: " + filename);
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0 || uintmax_t(st.st_size) >= std::numeric_limits<size_t>::max()) {
+    close(fd);
+    return nullptr;
+  }
+  const size_t file_length = size_t(st.st_size);
+
+  void * ptr = mmap(nullptr, file_length, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);  // the mapping keeps the file referenced
+  if (ptr == MAP_FAILED)
+    return nullptr;
+
+  // Hints only, errors are ignored
+  if (options.prefetch)
+    madvise(ptr, file_length, MADV_WILLNEED);
+#ifdef MADV_HUGEPAGE
+  if (options.huge_pages)
+    madvise(ptr, file_length, MADV_HUGEPAGE);
+#endif
+
+  return std::make_shared<MappedMemory>(ptr, file_length);
+}
+
+} // namespace
+#endif  // YOKLM_HAVE_MMAP
+
+MemorySection load_file(const std::string& filename, const LoadFileOptions& options) {
+#ifdef YOKLM_HAVE_MMAP
+  if (options.use_mmap) {
+    std::shared_ptr<ManagedMemory> mm = map_file(filename, options);
+    if (mm)
+      return MemorySection(mm);
+  }
+#endif
+
   std::ifstream is;
   is.open(filename, std::ios::in | std::ios::binary);
   if (!is)
@@ -22,12 +22,14 @@ namespace yoklm {
 // This class provides a virtual interface to manage a section of memory.
 class ManagedMemory {
   public:
-    ManagedMemory() = delete;
     ManagedMemory(const ManagedMemory& mm) = delete;
     ManagedMemory& operator=(const ManagedMemory& mm) = delete;
     virtual ~ManagedMemory() { delete[] ptr_; }
 
     ManagedMemory(size_t size) : ptr_(new uint8_t[size]), size_(size) {}
+  protected:
+    // For derived classes that own memory obtained in other ways (and override ptr() and size())
+    ManagedMemory() : ptr_(nullptr), size_(0) {}
   private:
     // The caller transfers ownership of *ptr.
     // ptr must have been created with new uint8_t[...] in case of the default destructor.
@@ -140,6 +142,8 @@ class MemorySectionBitArray : public MemorySection {
       return data & bf.mask;
     }
     uint64_t operator[](size_t index) const { return operator()(index, bit_field_); }
+    // Address of the first byte of the record, for prefetching.  Not bounds-checked.
+    const uint8_t * record_ptr(size_t index) const { return &ptr()[index * stride_ / 8]; }
 
     void set_stride(int stride);
     void set_bit_field(const BitField& bf) { bit_field_ = bf; }
@@ -151,8 +155,18 @@ class MemorySectionBitArray : public MemorySection {
     size_t index_limit_;
 }; // class MemorySectionBitArray
 
+struct LoadFileOptions {
+  // Map the file into memory instead of reading it, so that the pages are loaded on demand and
+  // shared by all processes using the same file. Falls back to reading if mmap is not available.
+  bool use_mmap = true;
+  // Hints for the mapped memory: start reading the whole file ahead (MADV_WILLNEED),
+  // back the mapping with huge pages where supported (MADV_HUGEPAGE)
+  bool prefetch = false;
+  bool huge_pages = false;
+};
+
 // Throws an exception if cannot.
-MemorySection load_file(const std::string& filename);
+MemorySection load_file(const std::string& filename, const LoadFileOptions& options = LoadFileOptions());
 
 } // namespace yoklm
 
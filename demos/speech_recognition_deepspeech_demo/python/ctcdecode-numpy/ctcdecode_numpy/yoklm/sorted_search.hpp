@@ -1,5 +1,5 @@
 /*********************************************************************
-* Copyright (c) 2020 Intel Corporation
+* Copyright (c) 2020-2021 Intel Corporation
 * SPDX-License-Identifier: Apache-2.0
 **********************************************************************/
 
@@ -8,6 +8,17 @@
 
 #include <limits>
 #include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <xmmintrin.h>
+#define YOKLM_PREFETCH(ptr) _mm_prefetch(reinterpret_cast<const char*>(ptr), _MM_HINT_T0)
+#elif defined(__GNUC__)
+#define YOKLM_PREFETCH(ptr) __builtin_prefetch(ptr)
+#else
+#define YOKLM_PREFETCH(ptr) ((void)(ptr))
+#endif
 
 
 namespace yoklm {
@@ -72,6 +83,85 @@ IndexT binary_search(const ArrayT& array, IndexT l, IndexT r, const ValueT value
   return l;
 }
 
+// Eytzinger (breadth-first) layout of every stride-th element of a sorted array.
+// Used to narrow down binary_search() over a large array: the top levels of the search
+// are taken in this small, contiguous copy, where the next two levels are prefetched
+// while the current one is compared.
+template <typename ValueT>
+class EytzingerIndex {
+  public:
+    EytzingerIndex() : size_(0), stride_(0) {}
+
+    // Build from array[0..size) sampled with the given stride.  Array must be non-decreasing.
+    template <typename ArrayT>
+    void build(const ArrayT& array, size_t size, size_t stride);
+
+    bool empty() const { return tree_.size() <= 1; }
+
+    // Return (l, r), such that binary_search(array, l, r, value) gives the same result as
+    // binary_search(array, 0, size, value).  Same precondition: value >= array[0].
+    std::pair<size_t, size_t> range(const ValueT value) const;
+
+  private:
+    template <typename ArrayT>
+    void fill(const ArrayT& array, size_t node, size_t& sample);
+
+    // 1-based tree, tree_[0] is unused. Node k has children 2k and 2k+1.
+    std::vector<ValueT> tree_;
+    // Sample number (in sorted order) of every tree node
+    std::vector<size_t> sample_;
+    size_t size_, stride_;
+};
+
+template <typename ValueT>
+template <typename ArrayT>
+void EytzingerIndex<ValueT>::build(const ArrayT& array, size_t size, size_t stride) {
+  if (stride == 0)
+    throw std::invalid_argument("yoklm::EytzingerIndex: stride must be positive");
+  size_ = size;
+  stride_ = stride;
+  const size_t num_samples = (size + stride - 1) / stride;
+  tree_.assign(num_samples + 1, ValueT());
+  sample_.assign(num_samples + 1, num_samples);
+  size_t sample = 0;
+  fill(array, 1, sample);
+}
+
+// In-order traversal of the implicit tree visits the samples in sorted order
+template <typename ValueT>
+template <typename ArrayT>
+void EytzingerIndex<ValueT>::fill(const ArrayT& array, size_t node, size_t& sample) {
+  if (node >= tree_.size())
+    return;
+  fill(array, 2 * node, sample);
+  tree_[node] = array[sample * stride_];
+  sample_[node] = sample;
+  sample++;
+  fill(array, 2 * node + 1, sample);
+}
+
+template <typename ValueT>
+std::pair<size_t, size_t> EytzingerIndex<ValueT>::range(const ValueT value) const {
+  const size_t n = tree_.size();
+  size_t k = 1;
+  while (k < n) {
+    // Grandchildren of k are 4k..4k+3, which are adjacent in tree_
+    if (4 * k < n)
+      YOKLM_PREFETCH(&tree_[4 * k]);
+    k = 2 * k + (tree_[k] <= value);
+  }
+  // Drop the trailing right turns and the last left turn: k becomes the first node greater than value (or 0)
+  while (k & 1)
+    k >>= 1;
+  k >>= 1;
+
+  // Samples [0, upper) are <= value; sample 0 is array[0] <= value by precondition
+  const size_t upper = (k == 0) ? n - 1 : sample_[k];
+  const size_t l = (upper > 0) ? (upper - 1) * stride_ : 0;
+  const size_t r = (upper * stride_ < size_) ? upper * stride_ : size_;
+  return std::make_pair(l, r);
+}
+
 } // namespace yoklm
 
 
@@ -16,7 +16,8 @@
 class Cnn {
 public:
     Cnn(const std::string& modelPath, const std::string& modelType, const std::string& deviceName,
-        ov::Core& core, const cv::Size& new_input_resolution = cv::Size(), bool use_auto_resize = false);
+        ov::Core& core, const cv::Size& new_input_resolution = cv::Size(), bool use_auto_resize = false,
+        const ov::AnyMap& compile_config = {});
     virtual ~Cnn() = default;
 
     virtual std::map<std::string, ov::Tensor> Infer(const cv::Mat& frame) = 0;
@@ -37,6 +38,7 @@ protected:
     std::string m_input_name;
     std::vector<std::string> m_output_names;
     ov::Layout m_modelLayout;
+    ov::CompiledModel m_compiled_model;
     ov::InferRequest m_infer_request;
     std::shared_ptr<ov::Model> m_model;
 
@@ -25,9 +25,4 @@ public:
     std::vector<cv::RotatedRect> postProcess(
         const std::map<std::string, ov::runtime::Tensor>& output_tensors, const cv::Size& image_size,
         const cv::Size& image_shape, float cls_conf_threshold, float link_conf_threshold);
-private:
-    cv::Mat decodeImageByJoin(
-        const std::vector<float>& cls_data, const ov::Shape& cls_data_shape,
-        const std::vector<float>& link_data, const ov::Shape& link_data_shape,
-        float cls_conf_threshold, float link_conf_threshold);
 };
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <functional>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -28,13 +30,23 @@ public:
         const std::string& out_dec_symbol_name,
         const std::string& logits_name,
         size_t end_token,
-        bool use_auto_resize = false);
+        bool use_auto_resize = false,
+        size_t num_requests = 1);
 
     std::map<std::string, ov::runtime::Tensor> Infer(const cv::Mat& frame) override;
 
+    using OutputCallback = std::function<void(size_t, const std::map<std::string, ov::runtime::Tensor>&)>;
+
+    /// Infers the frames on all the requests of the recognizer at once and passes the outputs to process()
+    /// in the order of the frames, the output tensors are valid only during the call.
+    /// The frames of a composite model are inferred one by one.
+    /// The inference time and the number of calls are accounted once for the whole batch.
+    void InferBatch(const std::vector<cv::Mat>& frames, const OutputCallback& process);
+
     const cv::Size& input_size() const { return m_input_size; }
 
 private:
+    cv::Mat preprocess(const cv::Mat& frame) const;
     void check_model_names(
         const ov::OutputVector& input_info_decoder, const ov::OutputVector& output_info_decoder) const;
 
@@ -48,4 +60,5 @@ private:
     std::string m_out_dec_symbol_name;
     std::string m_logits_name;
     size_t m_end_token;
+    std::vector<ov::InferRequest> m_infer_requests;  // m_infer_request and the extra ones for InferBatch()
 };
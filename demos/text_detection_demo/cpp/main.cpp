@@ -236,7 +236,7 @@ int main(int argc, char* argv[]) {
                     FLAGS_m_tr, "Composite Text Recognition", FLAGS_d_tr, core,
                     FLAGS_out_enc_hidden_name, FLAGS_out_dec_hidden_name,
                     FLAGS_in_dec_hidden_name, FLAGS_features_name, FLAGS_in_dec_symbol_name,
-                    FLAGS_out_dec_symbol_name, FLAGS_tr_o_blb_nm, kAlphabet.find(kPadSymbol, 2), FLAGS_auto_resize));
+                    FLAGS_out_dec_symbol_name, FLAGS_tr_o_blb_nm, kAlphabet.find(kPadSymbol, 2), FLAGS_auto_resize, FLAGS_nireq_tr));
         }
         const double min_text_recognition_confidence = FLAGS_thr;
 
@@ -273,41 +273,50 @@ int main(int argc, char* argv[]) {
 
             int num_found = text_recognition != nullptr ? 0 : static_cast<int>(rects.size());
 
-            for (const auto& rect : rects) {
-                cv::Mat cropped_text;
-                std::vector<cv::Point2f> points;
-                int top_left_point_idx = 0;
-
-                if (rect.size != cv::Size2f(0, 0) && text_detector != nullptr) {
-                    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
-                    points = floatPointsFromRotatedRect(rect);
-                    topLeftPoint(points, &top_left_point_idx);
-                    auto size = text_recognition == nullptr ? cv::Size(rect.size) : text_recognition->input_size();
-                    cropped_text = cropImage(image, points, size, top_left_point_idx);
-                    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
-                    text_crop_time += std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
-                } else {
-                    if (FLAGS_cc) {
-                        int w = static_cast<int>(image.cols * 0.05f);
-                        int h = static_cast<int>(w * 0.5f);
-                        cv::Rect r(static_cast<int>(image.cols * 0.5f - w * 0.5f), static_cast<int>(image.rows * 0.5f - h * 0.5f), w, h);
-                        cropped_text = image(r).clone();
-                        cv::rectangle(demoImage, r, cv::Scalar(0, 0, 255), 2);
-                        points.emplace_back(r.tl());
+            // All the crops of the frame are warped in parallel, then recognized together
+            std::vector<cv::Mat> cropped_texts(rects.size());
+            std::vector<std::vector<cv::Point2f>> rect_points(rects.size());
+            std::vector<int> top_left_point_idxs(rects.size(), 0);
+            std::chrono::steady_clock::time_point begin_crop = std::chrono::steady_clock::now();
+            cv::parallel_for_(cv::Range(0, static_cast<int>(rects.size())), [&](const cv::Range& range) {
+                for (int r = range.start; r < range.end; r++) {
+                    const cv::RotatedRect& rect = rects[r];
+                    cv::Mat& cropped_text = cropped_texts[r];
+                    std::vector<cv::Point2f>& points = rect_points[r];
+
+                    if (rect.size != cv::Size2f(0, 0) && text_detector != nullptr) {
+                        points = floatPointsFromRotatedRect(rect);
+                        topLeftPoint(points, &top_left_point_idxs[r]);
+                        auto size = text_recognition == nullptr ? cv::Size(rect.size) : text_recognition->input_size();
+                        cropped_text = cropImage(image, points, size, top_left_point_idxs[r]);
                     } else {
-                        cropped_text = image;
-                        points.emplace_back(0.0f, 0.0f);
-                        points.emplace_back(static_cast<float>(image.cols - 1), 0.0f);
-                        points.emplace_back(static_cast<float>(image.cols - 1), static_cast<float>(image.rows - 1));
-                        points.emplace_back(0.0f, static_cast<float>(image.rows - 1));
+                        // there is the only whole frame "rect" without the text detector
+                        if (FLAGS_cc) {
+                            int w = static_cast<int>(image.cols * 0.05f);
+                            int h = static_cast<int>(w * 0.5f);
+                            cv::Rect central(static_cast<int>(image.cols * 0.5f - w * 0.5f), static_cast<int>(image.rows * 0.5f - h * 0.5f), w, h);
+                            cropped_text = image(central).clone();
+                            cv::rectangle(demoImage, central, cv::Scalar(0, 0, 255), 2);
+                            points.emplace_back(central.tl());
+                        } else {
+                            cropped_text = image;
+                            points.emplace_back(0.0f, 0.0f);
+                            points.emplace_back(static_cast<float>(image.cols - 1), 0.0f);
+                            points.emplace_back(static_cast<float>(image.cols - 1), static_cast<float>(image.rows - 1));
+                            points.emplace_back(0.0f, static_cast<float>(image.rows - 1));
+                        }
                     }
                 }
+            });
+            if (text_detector != nullptr) {
+                std::chrono::steady_clock::time_point end_crop = std::chrono::steady_clock::now();
+                text_crop_time += std::chrono::duration_cast<std::chrono::microseconds>(end_crop - begin_crop).count();
+            }
 
-                std::string res = "";
-                double conf = 1.0;
-                if (text_recognition != nullptr) {
-                    std::map<std::string, ov::runtime::Tensor> output_tensors = text_recognition->Infer(cropped_text);
-
+            std::vector<std::string> results(rects.size());
+            if (text_recognition != nullptr) {
+                text_recognition->InferBatch(cropped_texts,
+                    [&](size_t r, const std::map<std::string, ov::runtime::Tensor>& output_tensors) {
                     ov::runtime::Tensor out_tensor = output_tensors.begin()->second;
                     if (FLAGS_tr_o_blb_nm != "") {
                         const auto& it = output_tensors.find(FLAGS_tr_o_blb_nm);
@@ -326,6 +335,8 @@ int main(int argc, char* argv[]) {
                     std::vector<float> output_data(output_data_pointer, output_data_pointer + output_shape[0] * output_shape[1] * output_shape[2]);
 
                     std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+                    std::string res = "";
+                    double conf = 1.0;
                     if (decoder_type == "simple") {
                         res = SimpleDecoder(output_data, kAlphabet, kPadSymbol, &conf, decoder_start_index);
                     } else if (decoder_type == "ctc") {
@@ -335,8 +346,7 @@ int main(int argc, char* argv[]) {
                             res = CTCBeamSearchDecoder(output_data, kAlphabet, kPadSymbol, &conf, decoder_bandwidth);
                         }
                     } else {
-                        slog::err << "No decoder type or invalid decoder type (-dt) provided: " + decoder_type << slog::endl;
-                        return -1;
+                        throw std::logic_error("No decoder type or invalid decoder type (-dt) provided: " + decoder_type);
                     }
                     std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
                     text_recognition_postproc_time += std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
@@ -344,9 +354,14 @@ int main(int argc, char* argv[]) {
                     if (FLAGS_lower)
                         res = str_tolower(res);
 
-                    res = conf >= min_text_recognition_confidence ? res : "";
-                    num_found += !res.empty() ? 1 : 0;
-                }
+                    results[r] = conf >= min_text_recognition_confidence ? res : "";
+                    num_found += !results[r].empty() ? 1 : 0;
+                });
+            }
+
+            for (size_t r = 0; r < rects.size(); r++) {
+                const std::vector<cv::Point2f>& points = rect_points[r];
+                const std::string& res = results[r];
 
                 if (FLAGS_r) {
                     for (size_t i = 0; i < points.size(); i++) {
@@ -371,7 +386,7 @@ int main(int argc, char* argv[]) {
                     }
 
                     if (!points.empty() && !res.empty()) {
-                        setLabel(demoImage, res, points[static_cast<size_t>(top_left_point_idx)]);
+                        setLabel(demoImage, res, points[static_cast<size_t>(top_left_point_idxs[r])]);
                     }
                 }
             }
@@ -13,7 +13,7 @@
 
 Cnn::Cnn(
     const std::string& modelPath, const std::string& modelType, const std::string& deviceName,
-    ov::Core& core, const cv::Size& new_input_resolution, bool use_auto_resize) :
+    ov::Core& core, const cv::Size& new_input_resolution, bool use_auto_resize, const ov::AnyMap& compile_config) :
     m_modelPath(modelPath), m_modelType(modelType), m_deviceName(deviceName),
     m_core(core), m_new_input_resolution(new_input_resolution), use_auto_resize(use_auto_resize),
     m_channels(0), m_time_elapsed(0), m_ncalls(0)
@@ -86,9 +86,9 @@ Cnn::Cnn(
     slog::info << ppp << slog::endl;
 
     // Loading model to the device
-    ov::CompiledModel compiled_model = m_core.compile_model(m_model, m_deviceName);
-    logCompiledModelInfo(compiled_model, m_modelPath, m_deviceName, m_modelType);
+    m_compiled_model = m_core.compile_model(m_model, m_deviceName, compile_config);
+    logCompiledModelInfo(m_compiled_model, m_modelPath, m_deviceName, m_modelType);
 
     // Creating infer request
-    m_infer_request = compiled_model.create_infer_request();
+    m_infer_request = m_compiled_model.create_infer_request();
 }
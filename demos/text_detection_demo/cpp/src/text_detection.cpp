@@ -3,8 +3,8 @@
 //
 
 #include <algorithm>
+#include <cmath>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include "utils/image_utils.h"
@@ -13,62 +13,115 @@
 
 namespace {
 
-void softmax(std::vector<float>* data) {
-    auto& rdata = *data;
-    const size_t last_dim = 2;
-    for (size_t i = 0; i < rdata.size(); i += last_dim) {
-       float m = std::max(rdata[i], rdata[i+1]);
-       rdata[i] = std::exp(rdata[i] - m);
-       rdata[i + 1] = std::exp(rdata[i + 1] - m);
-       float s = rdata[i] + rdata[i + 1];
-       rdata[i] /= s;
-       rdata[i + 1] /= s;
+// Channel pairs of a PixelLink output, the second channel of a pair is the positive class.
+// The softmax is computed in place of the tensor element which is asked for.
+struct ChannelPairs {
+    ChannelPairs(const ov::Tensor& tensor, const ov::Layout& layout) : data(tensor.data<float>()) {
+        const ov::Shape& shape = tensor.get_shape();
+        if (layout == ov::Layout("NCHW")) {
+            pixel_step = 1;
+            channel_step = shape[ov::layout::height_idx(layout)] * shape[ov::layout::width_idx(layout)];
+        } else {
+            pixel_step = shape[ov::layout::channels_idx(layout)];
+            channel_step = 1;
+        }
     }
-}
 
-std::vector<float> transpose4d(
-    const std::vector<float>& data, const std::vector<size_t>& shape, const std::vector<size_t>& axes)
-{
-    if (shape.size() != axes.size())
-        throw std::runtime_error("Shape and axes must have the same dimension.");
+    bool isPositive(size_t pixel, size_t pair, float threshold) const {
+        const float* p = data + pixel * pixel_step + 2 * pair * channel_step;
+        float negative = p[0];
+        float positive = p[channel_step];
+        float m = std::max(negative, positive);
+        negative = std::exp(negative - m);
+        positive = std::exp(positive - m);
+        return positive / (negative + positive) >= threshold;
+    }
+
+    const float* data;
+    size_t pixel_step;
+    size_t channel_step;
+};
 
-    for (size_t a : axes) {
-        if (a >= shape.size())
-            throw std::runtime_error("Axis must be less than dimension of shape.");
+// Union-find over the pixels of an image: parent[i] is -1 for the background pixels
+int findRoot(int point, std::vector<int>& parent) {
+    while (parent[point] != point) {
+        parent[point] = parent[parent[point]];  // path halving
+        point = parent[point];
     }
+    return point;
+}
 
-    size_t total_size = shape[0] * shape[1] * shape[2] * shape[3];
-
-    std::vector<size_t> steps = {
-        shape[axes[1]] * shape[axes[2]] * shape[axes[3]],
-        shape[axes[2]] * shape[axes[3]], shape[axes[3]],
-        1
-    };
-
-    size_t source_data_idx = 0;
-    std::vector<float> new_data(total_size, 0);
-
-    std::vector<size_t> ids(shape.size());
-    for (ids[0] = 0; ids[0] < shape[0]; ids[0]++) {
-        for (ids[1] = 0; ids[1] < shape[1]; ids[1]++) {
-            for (ids[2] = 0; ids[2] < shape[2]; ids[2]++) {
-                for (ids[3]= 0; ids[3] < shape[3]; ids[3]++) {
-                    size_t new_data_idx = ids[axes[0]] * steps[0] + ids[axes[1]] * steps[1] +
-                                          ids[axes[2]] * steps[2] + ids[axes[3]] * steps[3];
-                    new_data[new_data_idx] = data[source_data_idx++];
+void join(int p1, int p2, std::vector<int>& parent) {
+    int root1 = findRoot(p1, parent);
+    int root2 = findRoot(p2, parent);
+    if (root1 != root2) {
+        parent[std::max(root1, root2)] = std::min(root1, root2);
+    }
+}
+
+// Joins the pixels of rows [begin_row, end_row) with their linked neighbours in rows [min_row, max_row)
+void joinRows(const ChannelPairs& links, float link_conf_threshold, int w, int begin_row, int end_row,
+              int min_row, int max_row, std::vector<int>& parent) {
+    for (int y = begin_row; y < end_row; y++) {
+        for (int x = 0; x < w; x++) {
+            int point = x + y * w;
+            if (parent[point] < 0)
+                continue;
+
+            size_t neighbour = 0;
+            for (int ny = y - 1; ny <= y + 1; ny++) {
+                for (int nx = x - 1; nx <= x + 1; nx++) {
+                    if (nx == x && ny == y)
+                        continue;
+
+                    if (nx >= 0 && nx < w && ny >= min_row && ny < max_row && parent[nx + ny * w] >= 0
+                            && links.isPositive(point, neighbour, link_conf_threshold)) {
+                        join(point, nx + ny * w, parent);
+                    }
+                    neighbour++;
                 }
             }
         }
     }
-    return new_data;
 }
 
-std::vector<float> sliceAndGetSecondChannel(const std::vector<float>& data) {
-    std::vector<float> new_data(data.size() / 2, 0);
-    for (size_t i = 0; i < data.size() / 2; i++) {
-      new_data[i] = data[2 * i + 1];
+cv::Mat decodeImageByJoin(const ChannelPairs& cls, const ChannelPairs& links, int h, int w,
+                          float cls_conf_threshold, float link_conf_threshold) {
+    std::vector<int> parent(size_t(h) * size_t(w));
+
+    // Connected components of each block of rows are found in parallel,
+    // then the links crossing the block borders are joined
+    const int num_blocks = std::max(1, std::min(cv::getNumThreads(), h / 16));
+    const int block_rows = (h + num_blocks - 1) / num_blocks;
+    cv::parallel_for_(cv::Range(0, num_blocks), [&](const cv::Range& range) {
+        for (int block = range.start; block < range.end; block++) {
+            int begin_row = std::min(h, block * block_rows);
+            int end_row = std::min(h, begin_row + block_rows);
+            for (int i = begin_row * w; i < end_row * w; i++) {
+                parent[i] = cls.isPositive(i, 0, cls_conf_threshold) ? i : -1;
+            }
+            joinRows(links, link_conf_threshold, w, begin_row, end_row, begin_row, end_row, parent);
+        }
+    });
+    for (int border = block_rows; border < h; border += block_rows) {
+        joinRows(links, link_conf_threshold, w, border - 1, border + 1, border - 1, border + 1, parent);
     }
-    return new_data;
+
+    // Components are numbered in the order of their first pixels
+    cv::Mat mask(h, w, CV_32S, cv::Scalar(0));
+    int* labels = mask.ptr<int>();
+    int num_labels = 0;
+    for (int i = 0; i < h * w; i++) {
+        if (parent[i] < 0)
+            continue;
+        int root = findRoot(i, parent);
+        if (root == i)
+            labels[i] = ++num_labels;
+        else
+            labels[i] = labels[root];
+    }
+
+    return mask;
 }
 
 std::vector<cv::RotatedRect> maskToBoxes(const cv::Mat& mask, float min_area, float min_height, const cv::Size& image_size)
@@ -131,43 +184,6 @@ std::vector<cv::RotatedRect> coordToBoxes(
     return bboxes;
 }
 
-int findRoot(int point, std::unordered_map<int, int>* group_mask) {
-    int root = point;
-    bool update_parent = false;
-    while (group_mask->at(root) != -1) {
-        root = group_mask->at(root);
-        update_parent = true;
-    }
-    if (update_parent) {
-       (*group_mask)[point] = root;
-    }
-    return root;
-}
-
-void join(int p1, int p2, std::unordered_map<int, int>* group_mask) {
-    int root1 = findRoot(p1, group_mask);
-    int root2 = findRoot(p2, group_mask);
-    if (root1 != root2) {
-        (*group_mask)[root1] = root2;
-    }
-}
-
-cv::Mat get_all(const std::vector<cv::Point>& points, int w, int h, std::unordered_map<int, int>* group_mask)
-{
-    std::unordered_map<int, int> root_map;
-
-    cv::Mat mask(h, w, CV_32S, cv::Scalar(0));
-    for (const auto& point : points) {
-        int point_root = findRoot(point.x + point.y * w, group_mask);
-        if (root_map.find(point_root) == root_map.end()) {
-            root_map.emplace(point_root, static_cast<int>(root_map.size() + 1));
-        }
-        mask.at<int>(point.x + point.y * w) = root_map[point_root];
-    }
-
-    return mask;
-}
-
 } // namespace
 
 
@@ -220,48 +236,14 @@ std::vector<cv::RotatedRect> TextDetector::postProcess(
     std::vector<cv::RotatedRect> rects;
     if (!kLocOutputName.empty() && !kClsOutputName.empty()) {
         // PostProcessing for PixelLink Text Detection model
-        ov::Shape link_shape = output_tensors.at(kLocOutputName).get_shape();
-        size_t link_data_size = link_shape[0] * link_shape[1] * link_shape[2] * link_shape[3];
-
-        float* link_data_pointer = output_tensors.at(kLocOutputName).data<float>();
-
-        std::vector<float> link_data(link_data_pointer, link_data_pointer + link_data_size);;
-        if (m_modelLayout == ov::Layout("NCHW")) {
-            link_data = transpose4d(link_data, link_shape, { 0, 2, 3, 1 });
-        }
-
-        softmax(&link_data);
-
-        link_data = sliceAndGetSecondChannel(link_data);
-
-        ov::Shape new_link_data_shape(link_shape.size());
-        new_link_data_shape[0] = static_cast<int>(link_shape[ov::layout::batch_idx(m_modelLayout)]);
-        new_link_data_shape[1] = static_cast<int>(link_shape[ov::layout::height_idx(m_modelLayout)]);
-        new_link_data_shape[2] = static_cast<int>(link_shape[ov::layout::width_idx(m_modelLayout)]);
-        new_link_data_shape[3] = static_cast<int>(link_shape[ov::layout::channels_idx(m_modelLayout)]) / 2;
-
-        ov::Shape cls_shape = output_tensors.at(kClsOutputName).get_shape();
-        size_t cls_data_size = cls_shape[0] * cls_shape[1] * cls_shape[2] * cls_shape[3];
-
-        float* cls_data_pointer = output_tensors.at(kClsOutputName).data<float>();
-
-        std::vector<float> cls_data(cls_data_pointer, cls_data_pointer + cls_data_size);
-        if (m_modelLayout == ov::Layout("NCHW")) {
-            cls_data = transpose4d(cls_data, cls_shape, { 0, 2, 3, 1 });
-        }
-
-        softmax(&cls_data);
+        const ov::Tensor& cls_tensor = output_tensors.at(kClsOutputName);
+        ov::Shape cls_shape = cls_tensor.get_shape();
+        int h = static_cast<int>(cls_shape[ov::layout::height_idx(m_modelLayout)]);
+        int w = static_cast<int>(cls_shape[ov::layout::width_idx(m_modelLayout)]);
 
-        cls_data = sliceAndGetSecondChannel(cls_data);
-
-        ov::Shape new_cls_data_shape(cls_shape.size());
-        new_cls_data_shape[0] = static_cast<int>(cls_shape[ov::layout::batch_idx(m_modelLayout)]);
-        new_cls_data_shape[1] = static_cast<int>(cls_shape[ov::layout::height_idx(m_modelLayout)]);
-        new_cls_data_shape[2] = static_cast<int>(cls_shape[ov::layout::width_idx(m_modelLayout)]);
-        new_cls_data_shape[3] = static_cast<int>(cls_shape[ov::layout::channels_idx(m_modelLayout)]) / 2;
-
-        cv::Mat mask = decodeImageByJoin(
-            cls_data, new_cls_data_shape, link_data, new_link_data_shape, cls_conf_threshold, link_conf_threshold);
+        cv::Mat mask = decodeImageByJoin(ChannelPairs(cls_tensor, m_modelLayout),
+            ChannelPairs(output_tensors.at(kLocOutputName), m_modelLayout), h, w,
+            cls_conf_threshold, link_conf_threshold);
 
         rects = maskToBoxes(
             mask, static_cast<float>(kMinArea), static_cast<float>(kMinHeight), image_size);
@@ -292,50 +274,3 @@ std::vector<cv::RotatedRect> TextDetector::postProcess(
 
     return rects;
 }
-
-cv::Mat TextDetector::decodeImageByJoin(
-    const std::vector<float>& cls_data, const ov::Shape& cls_data_shape,
-    const std::vector<float>& link_data, const ov::Shape& link_data_shape,
-    float cls_conf_threshold, float link_conf_threshold) {
-    int h = cls_data_shape[ov::layout::height_idx({"NHWC"})];
-    int w = cls_data_shape[ov::layout::width_idx({"NHWC"})];
-
-    std::vector<uchar> pixel_mask(h * w, 0);
-    std::unordered_map<int, int> group_mask;
-    std::vector<cv::Point> points;
-    for (size_t i = 0; i < pixel_mask.size(); i++) {
-        pixel_mask[i] = cls_data[i] >= cls_conf_threshold;
-        if (pixel_mask[i]) {
-            points.emplace_back(i % w, i / w);
-            group_mask[i] = -1;
-        }
-    }
-
-    std::vector<uchar> link_mask(link_data.size(), 0);
-    for (size_t i = 0; i < link_mask.size(); i++) {
-        link_mask[i] = link_data[i] >= link_conf_threshold;
-    }
-
-    size_t neighbours = size_t(link_data_shape[ov::layout::channels_idx({"NHWC"})]);
-    for (const auto& point : points) {
-        size_t neighbour = 0;
-        for (int ny = point.y - 1; ny <= point.y + 1; ny++) {
-            for (int nx = point.x - 1; nx <= point.x + 1; nx++) {
-                if (nx == point.x && ny == point.y)
-                    continue;
-
-                if (nx >= 0 && nx < w && ny >= 0 && ny < h) {
-                    uchar pixel_value = pixel_mask[size_t(ny) * size_t(w) + size_t(nx)];
-                    uchar link_value = link_mask[
-                        (size_t(point.y) * size_t(w) + size_t(point.x)) * neighbours + neighbour];
-                    if (pixel_value && link_value) {
-                        join(point.x + point.y * w, nx + ny * w, &group_mask);
-                    }
-                }
-                neighbour++;
-            }
-        }
-    }
-
-    return get_all(points, w, h, &group_mask);
-}
@@ -3,14 +3,18 @@
 //
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <map>
 #include <string>
 #include <vector>
 #include <limits>
 #include <stdexcept>
 #include <numeric>
 #include <iostream>
+#include <memory>
 
+#include "ctc_decoder/ctc_decoder.hpp"
 #include "utils/image_utils.h"
 #include "utils/ocv_common.hpp"
 #include "text_recognition.hpp"
@@ -37,26 +41,26 @@ namespace  {
         *prob = 1.0f / static_cast<float>(sum);
     }
 
-    std::vector<float> softmax(const std::vector<float>::const_iterator& begin, const std::vector<float>::const_iterator& end) {
-        std::vector<float> prob(end - begin, 0.f);
-        std::transform(begin, end, prob.begin(), [](float x) { return std::exp(x); });
-        float sum = std::accumulate(prob.begin(), prob.end(), 0.0f);
-        for (int i = 0; i < static_cast<int>(prob.size()); i++)
-            prob[i] /= sum;
-        return prob;
+    std::vector<std::string> ToSymbols(const std::string& alphabet) {
+        std::vector<std::string> symbols;
+        for (char c : alphabet) {
+            symbols.emplace_back(1, c);
+        }
+        return symbols;
     }
 
-    struct BeamElement {
-        std::vector<int> sentence;   //!< The sequence of chars that will be a result of the beam element
-        float prob_blank;            //!< The probability that the last char in CTC sequence
-                                     //!< for the beam element is the special blank char
-        float prob_not_blank;        //!< The probability that the last char in CTC sequence
-                                     //!< for the beam element is NOT the special blank char
-
-        float prob() const {         //!< The probability of the beam element.
-            return prob_blank + prob_not_blank;
+    // The decoder keeps its prefix trie and buffers between the text lines, it is rebuilt only if the alphabet or
+    // the decoding parameters change
+    CtcDecoder& GetCtcDecoder(const std::string& alphabet, size_t blank_index, int bandwidth) {
+        thread_local std::unique_ptr<CtcDecoder> decoder;
+        thread_local std::string decoder_alphabet;
+        if (!decoder || decoder_alphabet != alphabet || decoder->getBlankIndex() != blank_index
+                || decoder->getBeamSize() != static_cast<size_t>(bandwidth)) {
+            decoder.reset(new CtcDecoder(ToSymbols(alphabet), blank_index, bandwidth));
+            decoder_alphabet = alphabet;
         }
-    };
+        return *decoder;
+    }
 }  // namespace
 
 std::string SimpleDecoder(const std::vector<float> &data, const std::string& alphabet, char pad_symbol, double* conf, int start_index) {
@@ -81,109 +85,17 @@ std::string SimpleDecoder(const std::vector<float> &data, const std::string& alp
 }
 
 std::string CTCGreedyDecoder(const std::vector<float> &data, const std::string& alphabet, char pad_symbol, double* conf) {
-    std::string result = "";
-    bool prev_pad = false;
-    *conf = 1;
-
-    const int num_classes = alphabet.length();
-    for (std::vector<float>::const_iterator it = data.begin(); it != data.end(); it += num_classes) {
-      int argmax;
-      float prob;
-
-      softmax_and_choose(it, it + num_classes, &argmax, &prob);
-
-      (*conf) *= prob;
-
-      auto symbol = alphabet[argmax];
-      if (symbol != pad_symbol) {
-          if (result.empty() || prev_pad || (!result.empty() && symbol != result.back())) {
-            prev_pad = false;
-            result += symbol;
-          }
-      } else {
-        prev_pad = true;
-      }
-    }
-
+    CtcDecoder& decoder = GetCtcDecoder(alphabet, alphabet.find(pad_symbol), 1);
+    std::string result = decoder.toString(decoder.greedyDecode(data.data(), data.size() / alphabet.length(), conf));
+    // the alphabet may have several pad symbols, all of them separate the repeated symbols like the blank does
+    result.erase(std::remove(result.begin(), result.end(), pad_symbol), result.end());
     return result;
 }
 
 std::string CTCBeamSearchDecoder(const std::vector<float>& data, const std::string& alphabet, char pad_symbol, double* conf, int bandwidth) {
-    const int num_classes = alphabet.length();
-
-    std::vector<BeamElement> curr;
-    std::vector<BeamElement> last;
-
-    last.push_back(BeamElement{std::vector<int>(), 1.f, 0.f});
-
-    for (std::vector<float>::const_iterator it = data.begin(); it != data.end(); it += num_classes) {
-        curr.clear();
-
-        std::vector<float> prob = softmax(it, it + num_classes);
-
-        for(const auto& candidate: last) {
-            float prob_not_blank = 0.f;
-            const std::vector<int>& candidate_sentence = candidate.sentence;
-            if (!candidate_sentence.empty()) {
-                int n = candidate_sentence.back();
-                prob_not_blank = candidate.prob_not_blank * prob[n];
-            }
-            float prob_blank = candidate.prob() * prob[num_classes - 1];
-
-            auto cmp = [&candidate_sentence](const BeamElement& n) {
-                return n.sentence == candidate_sentence;
-            };
-            auto check_res = std::find_if(curr.begin(), curr.end(), cmp);
-            if (check_res == std::end(curr)) {
-                curr.push_back(BeamElement{candidate.sentence, prob_blank, prob_not_blank});
-            } else {
-                check_res->prob_not_blank  += prob_not_blank;
-                if (check_res->prob_blank != 0.f) {
-                    throw std::logic_error("Probability that the last char in CTC-sequence is the special blank char must be zero here");
-                }
-                check_res->prob_blank = prob_blank;
-            }
-
-            for (int i = 0; i < num_classes - 1; i++) {
-                auto extend = candidate_sentence;
-                extend.push_back(i);
-
-                if (candidate_sentence.size() > 0 && candidate.sentence.back() == i) {
-                    prob_not_blank = prob[i] * candidate.prob_blank;
-                } else {
-                    prob_not_blank = prob[i] * candidate.prob();
-                }
-
-                auto check_res = std::find_if(curr.begin(), curr.end(), [&extend](const BeamElement &n) {
-                    return n.sentence == extend;
-                });
-
-                if (check_res == std::end(curr)) {
-                    curr.push_back(BeamElement{extend, 0.f, prob_not_blank});
-                } else {
-                    check_res->prob_not_blank += prob_not_blank;
-                }
-            }
-        }
-
-        sort(curr.begin(), curr.end(), [](const BeamElement &a, const BeamElement &b) -> bool {
-            return a.prob() > b.prob();
-        });
-
-        last.clear();
-        int num_to_copy = std::min(bandwidth, static_cast<int>(curr.size()));
-        for (int b = 0; b < num_to_copy; b++) {
-            last.push_back(curr[b]);
-        }
-    }
-
-    *conf = last[0].prob();
-    std::string result = "";
-    for (const auto& idx: last[0].sentence) {
-        result += alphabet[idx];
-    }
-
-    return result;
+    // the last class is the CTC blank
+    CtcDecoder& decoder = GetCtcDecoder(alphabet, alphabet.length() - 1, bandwidth);
+    return decoder.toString(decoder.beamSearchDecode(data.data(), data.size() / alphabet.length(), conf));
 }
 
 TextRecognizer::TextRecognizer(
@@ -192,8 +104,11 @@ TextRecognizer::TextRecognizer(
     const std::string& out_enc_hidden_name, const std::string& out_dec_hidden_name,
     const std::string& in_dec_hidden_name, const std::string& features_name,
     const std::string& in_dec_symbol_name, const std::string& out_dec_symbol_name,
-    const std::string& logits_name, size_t end_token, bool use_auto_resize) :
-    Cnn(model_path, model_type, deviceName, core, {}, use_auto_resize),
+    const std::string& logits_name, size_t end_token, bool use_auto_resize, size_t num_requests) :
+    Cnn(model_path, model_type, deviceName, core, {}, use_auto_resize,
+        num_requests > 1 ? ov::AnyMap{ov::hint::performance_mode(ov::hint::PerformanceMode::THROUGHPUT),
+                                      ov::hint::num_requests(static_cast<uint32_t>(num_requests))}
+                         : ov::AnyMap{}),
     m_isCompositeModel(false),
     m_features_name(features_name), m_out_enc_hidden_name(out_enc_hidden_name),
     m_out_dec_hidden_name(out_dec_hidden_name), m_in_dec_hidden_name(in_dec_hidden_name),
@@ -201,8 +116,12 @@ TextRecognizer::TextRecognizer(
     m_logits_name(logits_name), m_end_token(end_token)
 {
     // text-recognition-0015/0016 consist from encoder and decoder models, both have to be read
-    if (model_path.find("encoder") == std::string::npos)
+    if (model_path.find("encoder") == std::string::npos) {
+        m_infer_requests.push_back(m_infer_request);
+        for (size_t i = 1; i < num_requests; i++)
+            m_infer_requests.push_back(m_compiled_model.create_infer_request());
         return;
+    }
 
     std::string model_decoder_path(model_path);
     while (model_decoder_path.find("encoder") != std::string::npos)
@@ -224,9 +143,7 @@ TextRecognizer::TextRecognizer(
     m_infer_request_decoder = compiled_model_decoder.create_infer_request();
 }
 
-std::map<std::string, ov::runtime::Tensor> TextRecognizer::Infer(const cv::Mat& frame) {
-    std::chrono::steady_clock::time_point begin_enc = std::chrono::steady_clock::now();
-
+cv::Mat TextRecognizer::preprocess(const cv::Mat& frame) const {
     cv::Mat image;
     if (m_channels == 1) {
         cv::cvtColor(frame, image, cv::COLOR_BGR2GRAY);
@@ -234,10 +151,16 @@ std::map<std::string, ov::runtime::Tensor> TextRecognizer::Infer(const cv::Mat&
         image = frame;
     }
 
-    ov::Tensor tensor = m_infer_request.get_tensor(m_input_name);
     if (!use_auto_resize) {
         image = resizeImageExt(image, m_input_size.width, m_input_size.height);
     }
+    return image;
+}
+
+std::map<std::string, ov::runtime::Tensor> TextRecognizer::Infer(const cv::Mat& frame) {
+    std::chrono::steady_clock::time_point begin_enc = std::chrono::steady_clock::now();
+
+    cv::Mat image = preprocess(frame);
     m_infer_request.set_tensor(m_input_name, wrapMat2Tensor(image));
 
     m_infer_request.infer();
@@ -300,6 +223,53 @@ std::map<std::string, ov::runtime::Tensor> TextRecognizer::Infer(const cv::Mat&
     return { {m_logits_name, targets} };
 }
 
+void TextRecognizer::InferBatch(const std::vector<cv::Mat>& frames, const OutputCallback& process) {
+    if (m_isCompositeModel) {
+        for (size_t i = 0; i < frames.size(); i++)
+            process(i, Infer(frames[i]));
+        return;
+    }
+    if (frames.empty())
+        return;
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::duration process_time(0);
+
+    // frame i is inferred on the request i % num_requests, the wrapped input images must outlive the inference
+    const size_t num_requests = std::min(m_infer_requests.size(), frames.size());
+    std::vector<cv::Mat> images(num_requests);
+    auto start = [&](size_t i) {
+        size_t slot = i % num_requests;
+        images[slot] = preprocess(frames[i]);
+        m_infer_requests[slot].set_tensor(m_input_name, wrapMat2Tensor(images[slot]));
+        m_infer_requests[slot].start_async();
+    };
+
+    for (size_t i = 0; i < num_requests; i++)
+        start(i);
+
+    std::map<std::string, ov::runtime::Tensor> output_tensors;
+    for (size_t i = 0; i < frames.size(); i++) {
+        ov::InferRequest& request = m_infer_requests[i % num_requests];
+        request.wait();
+        for (const auto& output_name : m_output_names) {
+            output_tensors[output_name] = request.get_tensor(output_name);
+        }
+
+        // the other requests are inferred while this output is processed
+        std::chrono::steady_clock::time_point begin_process = std::chrono::steady_clock::now();
+        process(i, output_tensors);
+        process_time += std::chrono::steady_clock::now() - begin_process;
+
+        if (i + num_requests < frames.size())
+            start(i + num_requests);
+    }
+
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    m_time_elapsed += std::chrono::duration_cast<std::chrono::milliseconds>(end - begin - process_time).count();
+    m_ncalls++;
+}
+
 void TextRecognizer::check_model_names(
     const ov::OutputVector& input_info_decoder,
     const ov::OutputVector& output_info_decoder) const
@@ -50,6 +50,9 @@ static const char text_detection_target_device_message[] = "Optional. Specify th
 static const char text_recognition_target_device_message[] = "Optional. Specify the target device for the Text Recognition model to infer on "
                                                              "(the list of available devices is shown below). "
                                                              "The demo will look for a suitable plugin for a specified device. By default, it is CPU.";
+static const char text_recognition_num_requests_message[] = "Optional. Number of infer requests for the Text Recognition model. "
+                                                           "If it is greater than 1, the text crops of a frame are inferred on that many "
+                                                           "requests at once. Default value is 1.";
 static const char input_resizable_message[] = "Optional. Enables resizable input with support of ROI crop & auto resize.";
 static const char no_show_message[] = "Optional. If it is true, then detected text will not be shown on image frame. By default, it is false.";
 static const char raw_output_message[] = "Optional. Output Inference results as raw values.";
@@ -85,6 +88,7 @@ DEFINE_double(link_pixel_thr, 0.8, pixel_linkage_threshold_message);
 DEFINE_int32(max_rect_num, -1, text_max_rectangles_number_message);
 DEFINE_string(d_td, "CPU", text_detection_target_device_message);
 DEFINE_string(d_tr, "CPU", text_recognition_target_device_message);
+DEFINE_uint32(nireq_tr, 1, text_recognition_num_requests_message);
 DEFINE_bool(auto_resize, false, input_resizable_message);
 DEFINE_bool(no_show, false, no_show_message);
 DEFINE_bool(r, false, raw_output_message);
@@ -128,6 +132,7 @@ static void showUsage() {
     std::cout << "    -max_rect_num \"<value>\"        " << text_max_rectangles_number_message << std::endl;
     std::cout << "    -d_td \"<device>\"               " << text_detection_target_device_message << std::endl;
     std::cout << "    -d_tr \"<device>\"               " << text_recognition_target_device_message << std::endl;
+    std::cout << "    -nireq_tr \"<integer>\"          " << text_recognition_num_requests_message << std::endl;
     std::cout << "    -auto_resize                   " << input_resizable_message << std::endl;
     std::cout << "    -no_show                       " << no_show_message << std::endl;
     std::cout << "    -r                             " << raw_output_message << std::endl;